@@ -0,0 +1,82 @@
+// Plays back capture.c --archive (video_archive.h): each stream's directory holds a ring of segment files, the frames
+// back to back in them, and an index with a record per frame in time order. A time is found by binary search over the
+// records still on disk, one small read each, so a seek costs the same few reads however much is archived. The frames
+// are then fetched from the segment files with HTTP range requests: a frame is the JPEG's bytes as they are, so its
+// range is the picture.
+//
+// capture.c keeps writing while this reads. A record is only read between the index's first and head, which the writer
+// moves past a segment's records before writing over it; a frame fetched just as its segment comes round again can
+// still be torn, and then is simply not a JPEG.
+const fs = require('fs');
+const path = require('path');
+
+const ARCHIVE_MAGIC = 0x43524146;
+const ARCHIVE_VERSION = 1;
+const HEADER_SIZE = 64;
+const RECORD_SIZE = 24;
+const MAX_FRAMES = 100;
+
+function readAt(file, length, position) {
+const buffer = Buffer.alloc(length);
+return file.read(buffer, 0, length, position).then(() => buffer);
+}
+
+function readHeader(file) {
+return readAt(file, HEADER_SIZE, 0).then((buffer) => {
+if (buffer.readUInt32LE(0) !== ARCHIVE_MAGIC || buffer.readUInt32LE(4) !== ARCHIVE_VERSION ||
+buffer.readUInt32LE(8) !== RECORD_SIZE) {
+throw new Error('not an archive index');
+}
+return {
+capacity: buffer.readUInt32LE(12),
+segments: buffer.readUInt32LE(16),
+head: Number(buffer.readBigUInt64LE(24)),
+first: Number(buffer.readBigUInt64LE(32)),
+};
+});
+}
+
+function readRecord(file, header, n) {
+return readAt(file, RECORD_SIZE, HEADER_SIZE + (n % header.capacity) * RECORD_SIZE).then((buffer) => ({
+timeMs: Number(buffer.readBigInt64LE(0)),
+segment: `seg-${String(Number(buffer.readBigUInt64LE(8)) % header.segments).padStart(3, '0')}.mjpg`,
+offset: buffer.readUInt32LE(16),
+size: buffer.readUInt32LE(20),
+}));
+}
+
+// the last record at or before timeMs, or the first record if timeMs is older than the archive; low has to qualify
+function search(file, header, timeMs, low, high) {
+if (high - low <= 1) {
+return Promise.resolve(low);
+}
+const middle = Math.floor((low + high) / 2);
+return readRecord(file, header, middle).then((record) => (record.timeMs <= timeMs ?
+search(file, header, timeMs, middle, high) : search(file, header, timeMs, low, middle)));
+}
+
+// Resolves to { oldestMs, newestMs, frames: [{ timeMs, segment, offset, size }] }: up to count frames of the stream
+// archived in dir, from the one showing at timeMs on; no frames if the archive is empty
+function seekArchive(dir, timeMs, count) {
+let file = null;
+let header = null;
+return fs.promises.open(path.join(dir, 'index'), 'r').then((opened) => {
+file = opened;
+return readHeader(file);
+}).then((read) => {
+header = read;
+if (header.head <= header.first) {
+return { oldestMs: null, newestMs: null, frames: [] };
+}
+return Promise.all([readRecord(file, header, header.first), readRecord(file, header, header.head - 1),
+search(file, header, timeMs, header.first, header.head)]).then(([oldest, newest, from]) => {
+const reads = [];
+for (let n = from; n < Math.min(from + Math.min(count, MAX_FRAMES), header.head); n++) {
+reads.push(readRecord(file, header, n));
+}
+return Promise.all(reads).then((frames) => ({ oldestMs: oldest.timeMs, newestMs: newest.timeMs, frames }));
+});
+}).finally(() => file && file.close());
+}
+
+module.exports = { seekArchive };
@@ -10,11 +10,17 @@
  *      This program is provided with the V4L2 API
  * see http://linuxtv.org/docs.php for more information
  */
+#define _GNU_SOURCE             /* sendmmsg() */
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <stdbool.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,8 +37,31 @@
 #include <sys/time.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 
 #include <linux/videodev2.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include "frame_pool.h"
+#include "jpeg_activity.h"
+#include "jpeg_thumbnail.h"
+#include "pellet_watch.h"
+#include "video_archive.h"
+#ifdef FISHFEEDER_UNIFIED
+#include "board_link.h"
+#include "metrics.h"
+#endif
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
 
 #define CLEAR(x) memset(&(x), 0, sizeof(x))
 
@@ -70,6 +99,843 @@ void closeConnectionT()
 close(socketDescriptorT);
 }
 
+/*
+ * Framed transport: each frame goes out as MTU-sized datagrams, each with a
+ * header so the receiver (frameReceiver.js) can put the frame back together
+ * and drop it if a chunk is lost. All header fields are big-endian.
+ */
+#define FRAME_MAGIC 0x464d /* "FM" */
+/*
+ * A header alone, frame_id holding how often the stream's device has stalled
+ * so far; its first byte is clear of --header-cache's magics below.
+ */
+#define FRAME_MAGIC_STALL 0x4453 /* "DS" */
+#define FRAME_MTU 1500
+#define FRAME_HEADER_SIZE 32
+/* less the IPv4 and UDP headers, so no datagram is IP-fragmented */
+#define FRAME_CHUNK_PAYLOAD (FRAME_MTU - 20 - 8 - FRAME_HEADER_SIZE)
+
+struct frame_header {
+        uint16_t magic;
+        uint16_t chunk_index;
+        uint16_t chunk_count;
+        uint16_t stream_id;     /* which camera, see struct device */
+        uint32_t frame_id;
+        uint32_t timestamp_ms;  /* CLOCK_MONOTONIC, when the frame was sent */
+        uint32_t frame_size;
+        uint32_t chunk_offset;
+        uint32_t capture_sequence;      /* the driver's, so its gaps are frames never sent */
+        uint16_t queue_ms;              /* from the driver's timestamp until read_frame */
+        uint16_t board_ms;              /* from read_frame until sent */
+};
+
+/*
+ * Where a frame's time went on the board: the driver stamps when it was
+ * captured, and read_frame when capture.c got it. The relay (videoStats.js)
+ * takes it from there.
+ */
+struct frame_stamp {
+        uint32_t sequence;
+        uint32_t captured_ms;   /* CLOCK_MONOTONIC, as monotonic_ms() */
+        uint32_t read_ms;
+};
+
+#define MAX_STREAMS 4
+/* stream s's thumbnails (--thumbnails) go out as stream THUMBNAIL_STREAM_BASE + s */
+#define THUMBNAIL_STREAM_BASE 0x100
+
+/* frame ids count per stream, and per thumbnail stream */
+static uint32_t next_frame_id[MAX_STREAMS];
+static uint32_t next_thumbnail_id[MAX_STREAMS];
+
+static uint32_t monotonic_ms(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+/*
+ * Datagrams of a frame are queued here and sent with one sendmmsg() per
+ * BATCH_PACKETS, instead of one syscall each. Headers are copied into the
+ * batch; payloads are only pointed at.
+ */
+#define BATCH_PACKETS 256
+#define BATCH_IOVS 4
+#define BATCH_HEADER_SIZE 32
+
+static struct mmsghdr batch_msgs[BATCH_PACKETS];
+static struct iovec batch_iovs[BATCH_PACKETS][BATCH_IOVS];
+static unsigned char batch_headers[BATCH_PACKETS][BATCH_HEADER_SIZE];
+static unsigned int batch_count;
+
+/*
+ * Where headers are written. Normally the batch's own slots, reused after
+ * every flush; zero-copy sends point this at storage that lives as long as
+ * the capture buffer is in flight, since the kernel reads headers late too.
+ */
+static unsigned char (*header_store)[BATCH_HEADER_SIZE] = batch_headers;
+static unsigned int header_store_size = BATCH_PACKETS;
+static unsigned int header_used;
+static int send_flags;
+/* datagrams sent with MSG_ZEROCOPY so far: the next completion id */
+static uint32_t zerocopy_sent;
+
+/* Sends everything queued; returns -1 if a datagram could not be sent. */
+static int flush_batch(void)
+{
+        unsigned int sent = 0;
+
+        while (sent < batch_count) {
+                int r = sendmmsg(socketDescriptorT, batch_msgs + sent, batch_count - sent, send_flags);
+
+                if (-1 == r) {
+                        if (EINTR == errno)
+                                continue;
+                        fprintf(stderr, "sendmmsg error %d, %s\n", errno, strerror(errno));
+                        batch_count = 0;
+                        return -1;
+                }
+                if (send_flags & MSG_ZEROCOPY)
+                        zerocopy_sent += r;
+                sent += r;
+        }
+        batch_count = 0;
+        if (header_store == batch_headers)
+                header_used = 0;
+        return 0;
+}
+
+/*
+ * Starts a datagram and returns BATCH_HEADER_SIZE bytes of header space for
+ * it, or NULL if there is none left; the caller adds that with batch_add like
+ * any other part.
+ */
+static unsigned char *batch_begin(void)
+{
+        struct msghdr *msg = &batch_msgs[batch_count].msg_hdr;
+
+        if (header_used == header_store_size) {
+                fprintf(stderr, "frame has too many packets\n");
+                batch_count = 0;
+                return NULL;
+        }
+        CLEAR(*msg);
+        msg->msg_name = &sinRemoteT;
+        msg->msg_namelen = sizeof(sinRemoteT);
+        msg->msg_iov = batch_iovs[batch_count];
+        return header_store[header_used++];
+}
+
+static void batch_add(const void *data, size_t length)
+{
+        struct msghdr *msg = &batch_msgs[batch_count].msg_hdr;
+
+        msg->msg_iov[msg->msg_iovlen].iov_base = (void *)data;
+        msg->msg_iov[msg->msg_iovlen].iov_len = length;
+        msg->msg_iovlen++;
+}
+
+/* Finishes the datagram; returns -1 if a full batch failed to send. */
+static int batch_end(void)
+{
+        if (++batch_count == BATCH_PACKETS)
+                return flush_batch();
+        return 0;
+}
+
+/*
+ * Forward error correction (--fec k+m): Wi-Fi loses packets in bursts, and a
+ * frame with any chunk missing is dropped. The chunks of a frame are dealt
+ * out round-robin into groups of at most k, so a burst hits many groups once
+ * rather than one group many times, and each group gets m parity datagrams
+ * after the frame's own. Any m losses in a group are rebuilt by the receiver
+ * without asking for anything again; the cost is m/k more bandwidth.
+ *
+ * The parity is a systematic Reed-Solomon code over GF(2^8) with a Cauchy
+ * matrix: parity j of a group is the sum of coeff(j, r) * chunk r, with
+ * coeff(j, r) = 1 / ((k + j) ^ r), shorter chunks padded with zeros. Parity
+ * datagrams carry the frame's header with chunk_index counting on from
+ * chunk_count (group * m + j more), which older receivers ignore, and with
+ * chunk_offset holding k << 16 | m.
+ */
+#define FEC_MAX_DATA 64
+#define FEC_MAX_PARITY 16
+
+static unsigned int fec_data;           /* k, 0 for no FEC */
+static unsigned int fec_parity;         /* m */
+static unsigned char gf_exp[512];
+static unsigned char gf_log[256];
+static unsigned char *parity_store;
+static size_t parity_store_size;
+
+static void init_fec(void)
+{
+        unsigned int i, x = 1;
+
+        for (i = 0; i < 255; i++) {
+                gf_exp[i] = gf_exp[i + 255] = (unsigned char)x;
+                gf_log[x] = (unsigned char)i;
+                x <<= 1;
+                if (x & 0x100)
+                        x ^= 0x11d;
+        }
+}
+
+/* 1 / ((k + j) ^ r) as a logarithm; the two never meet, so it is never 1 / 0 */
+static unsigned int fec_coeff_log(unsigned int j, unsigned int r)
+{
+        return (255 - gf_log[(fec_data + j) ^ r]) % 255;
+}
+
+/* dst += c * src, c given as its logarithm */
+static void gf_mul_add(unsigned char *dst, const unsigned char *src, int length, unsigned int c_log)
+{
+        int i;
+
+        for (i = 0; i < length; i++)
+                if (src[i])
+                        dst[i] ^= gf_exp[c_log + gf_log[src[i]]];
+}
+
+/*
+ * Sends the parity of a frame whose chunks have just gone out. They are
+ * computed into storage of their own and always copied by the kernel, so a
+ * zero-copy send of the frame is not held up by them.
+ */
+static int send_parity(struct frame_header *header, const unsigned char *bytes, int size, int chunk_count)
+{
+        unsigned int groups = (chunk_count + fec_data - 1) / fec_data;
+        size_t needed = (size_t)groups * fec_parity * FRAME_CHUNK_PAYLOAD;
+        unsigned char (*saved_store)[BATCH_HEADER_SIZE] = header_store;
+        unsigned int saved_store_size = header_store_size, saved_used = header_used;
+        int saved_flags = send_flags;
+        unsigned int g, j;
+        int i, r = 0;
+
+        if (chunk_count + groups * fec_parity > UINT16_MAX)
+                return -1;
+        if (needed > parity_store_size) {
+                unsigned char *grown = realloc(parity_store, needed);
+
+                if (!grown)
+                        return -1;
+                parity_store = grown;
+                parity_store_size = needed;
+        }
+        memset(parity_store, 0, needed);
+        for (i = 0; i < chunk_count; i++) {
+                int offset = i * FRAME_CHUNK_PAYLOAD;
+                int length = size - offset < FRAME_CHUNK_PAYLOAD ?
+                             size - offset : FRAME_CHUNK_PAYLOAD;
+
+                g = i % groups;
+                for (j = 0; j < fec_parity; j++)
+                        gf_mul_add(parity_store + (g * fec_parity + j) * FRAME_CHUNK_PAYLOAD,
+                                   bytes + offset, length, fec_coeff_log(j, i / groups));
+        }
+
+        header_store = batch_headers;
+        header_store_size = BATCH_PACKETS;
+        header_used = 0;
+        send_flags &= ~MSG_ZEROCOPY;
+        header->chunk_offset = htonl(fec_data << 16 | fec_parity);
+        for (g = 0; g < groups && 0 == r; g++) {
+                for (j = 0; j < fec_parity && 0 == r; j++) {
+                        unsigned int p = g * fec_parity + j;
+                        unsigned char *h = batch_begin();
+
+                        if (!h) {
+                                r = -1;
+                                break;
+                        }
+                        header->chunk_index = htons((uint16_t)(chunk_count + p));
+                        memcpy(h, header, sizeof(*header));
+                        batch_add(h, sizeof(*header));
+                        batch_add(parity_store + p * FRAME_CHUNK_PAYLOAD,
+                                  chunk_count > 1 ? FRAME_CHUNK_PAYLOAD : size);
+                        r = batch_end();
+                }
+        }
+        if (0 == r)
+                r = flush_batch();
+        header_store = saved_store;
+        header_store_size = saved_store_size;
+        header_used = saved_used;
+        send_flags = saved_flags;
+        return r;
+}
+
+static uint16_t elapsed_ms(uint32_t from, uint32_t to)
+{
+        uint32_t ms = to - from;
+
+        /* a clock that isn't monotonic_ms()'s could be ahead */
+        if (ms > UINT16_MAX)
+                return ms > UINT32_MAX / 2 ? 0 : UINT16_MAX;
+        return (uint16_t)ms;
+}
+
+/* Returns the number of chunks sent, or -1 if a send failed. */
+static int send_frame_as(unsigned int stream, uint16_t magic, const void *frame, int size,
+                         const struct frame_stamp *stamp)
+{
+        const unsigned char *bytes = frame;
+        struct frame_header header;
+        int chunk_count = (size + FRAME_CHUNK_PAYLOAD - 1) / FRAME_CHUNK_PAYLOAD;
+        int i;
+
+        if (size <= 0 || chunk_count > UINT16_MAX)
+                return -1;
+
+        CLEAR(header);
+        header.magic = htons(magic);
+        header.chunk_count = htons((uint16_t)chunk_count);
+        header.stream_id = htons((uint16_t)stream);
+        header.frame_id = htonl(stream >= THUMBNAIL_STREAM_BASE ?
+                                next_thumbnail_id[stream - THUMBNAIL_STREAM_BASE]++ :
+                                next_frame_id[stream]++);
+        header.timestamp_ms = htonl(monotonic_ms());
+        header.frame_size = htonl((uint32_t)size);
+        header.capture_sequence = htonl(stamp->sequence);
+        header.queue_ms = htons(elapsed_ms(stamp->captured_ms, stamp->read_ms));
+        header.board_ms = htons(elapsed_ms(stamp->read_ms, ntohl(header.timestamp_ms)));
+
+        for (i = 0; i < chunk_count; i++) {
+                int offset = i * FRAME_CHUNK_PAYLOAD;
+                int length = size - offset < FRAME_CHUNK_PAYLOAD ?
+                             size - offset : FRAME_CHUNK_PAYLOAD;
+                unsigned char *h = batch_begin();
+
+                if (!h)
+                        return -1;
+                header.chunk_index = htons((uint16_t)i);
+                header.chunk_offset = htonl((uint32_t)offset);
+                memcpy(h, &header, sizeof(header));
+                batch_add(h, sizeof(header));
+                batch_add(bytes + offset, length);
+                /* the rest of the frame is useless once a chunk is lost */
+                if (batch_end() < 0)
+                        return -1;
+        }
+        if (flush_batch() < 0)
+                return -1;
+        if (fec_data && send_parity(&header, bytes, size, chunk_count) < 0)
+                return -1;
+        return chunk_count;
+}
+
+int sendFrameT(unsigned int stream, const void *frame, int size, const struct frame_stamp *stamp)
+{
+        return send_frame_as(stream, FRAME_MAGIC, frame, size, stamp);
+}
+
+/*
+ * Header caching (--header-cache): a UVC camera's JPEG header, everything
+ * up to the scan data, is the same frame after frame. It goes out with a
+ * frame (magic 'H') only when it changes and every HEADER_REFRESH_MS, so a
+ * receiver that starts late has it soon; every other frame is its scan data
+ * alone (magic 'S'), and the receiver puts the header it kept back in front.
+ * The magic's low byte is the header's generation, so a scan is never put
+ * behind a header it wasn't encoded with. A camera that leaves DHT out gets
+ * the standard tables spliced into the header it sends, so the receiver
+ * rebuilds complete JPEGs and nothing downstream has to patch them.
+ */
+#define FRAME_MAGIC_HEADER 0x48 /* "H", then the generation */
+#define FRAME_MAGIC_SCAN 0x53   /* "S", then the generation */
+#define HEADER_REFRESH_MS 1000
+#define HEADER_MAX_SIZE 4096
+
+struct header_cache {
+        unsigned char header[HEADER_MAX_SIZE];  /* as the camera sent it */
+        int size;
+        uint8_t generation;
+        int sent_any;
+        uint32_t sent_ms;
+};
+
+static int header_cache;
+/* per stream, then per thumbnail stream */
+static struct header_cache header_caches[2 * MAX_STREAMS];
+/* DHT with the four tables of ITU T.81 K.3 */
+static unsigned char std_dht[4 + 4 * 17 + 2 * 12 + 2 * 162];
+static unsigned char *spliced;
+static size_t spliced_capacity;
+
+static unsigned char *put_dht_table(unsigned char *p, int class_id, const unsigned char *bits,
+                                    const unsigned char *values)
+{
+        int i, count = 0;
+
+        *p++ = class_id;
+        for (i = 0; i < 16; i++)
+                count += *p++ = bits[i];
+        memcpy(p, values, count);
+        return p + count;
+}
+
+static void init_header_cache(void)
+{
+        unsigned char *p = std_dht;
+
+        *p++ = 0xff;
+        *p++ = 0xc4;
+        *p++ = (sizeof(std_dht) - 2) >> 8;
+        *p++ = (sizeof(std_dht) - 2) & 0xff;
+        p = put_dht_table(p, 0x00, jpeg_std_dc_luma_bits, jpeg_std_dc_values);
+        p = put_dht_table(p, 0x10, jpeg_std_ac_luma_bits, jpeg_std_ac_luma_values);
+        p = put_dht_table(p, 0x01, jpeg_std_dc_chroma_bits, jpeg_std_dc_values);
+        put_dht_table(p, 0x11, jpeg_std_ac_chroma_bits, jpeg_std_ac_chroma_values);
+}
+
+/*
+ * Walks the markers up to the scan data. Returns where it starts, just past
+ * SOS, or -1 if this isn't a JPEG; *sos is where SOS itself starts.
+ */
+static int find_scan(const unsigned char *jpeg, int size, int *sos, int *has_dht)
+{
+        int i = 2;
+
+        *has_dht = 0;
+        if (size < 4 || jpeg[0] != 0xff || jpeg[1] != 0xd8)
+                return -1;
+        while (i + 4 <= size) {
+                int marker, end;
+
+                if (jpeg[i] != 0xff)
+                        return -1;
+                marker = jpeg[i + 1];
+                if (marker == 0xff) {
+                        i++;
+                        continue;
+                }
+                end = i + 2 + (jpeg[i + 2] << 8 | jpeg[i + 3]);
+                if (end > size)
+                        return -1;
+                if (marker == 0xc4)
+                        *has_dht = 1;
+                if (marker == 0xda) {
+                        *sos = i;
+                        return end;
+                }
+                i = end;
+        }
+        return -1;
+}
+
+/*
+ * Sends from memory that is written again by the next frame: copied by the
+ * kernel even while a zero-copy send is going on, as send_parity does.
+ */
+static int send_copied(unsigned int stream, uint16_t magic, const void *frame, int size,
+                       const struct frame_stamp *stamp)
+{
+        unsigned char (*saved_store)[BATCH_HEADER_SIZE] = header_store;
+        unsigned int saved_store_size = header_store_size, saved_used = header_used;
+        int saved_flags = send_flags;
+        int r;
+
+        header_store = batch_headers;
+        header_store_size = BATCH_PACKETS;
+        header_used = 0;
+        send_flags &= ~MSG_ZEROCOPY;
+        r = send_frame_as(stream, magic, frame, size, stamp);
+        header_store = saved_store;
+        header_store_size = saved_store_size;
+        header_used = saved_used;
+        send_flags = saved_flags;
+        return r;
+}
+
+/* Returns the frame bytes sent, which a cached header isn't, or -1. */
+static int send_header_cached(unsigned int stream, const void *frame, int size,
+                              const struct frame_stamp *stamp)
+{
+        const unsigned char *bytes = frame;
+        struct header_cache *cache = &header_caches[stream >= THUMBNAIL_STREAM_BASE ?
+                                                    MAX_STREAMS + stream - THUMBNAIL_STREAM_BASE : stream];
+        uint32_t now = monotonic_ms();
+        int sos, has_dht, scan;
+        size_t needed;
+
+        scan = find_scan(bytes, size, &sos, &has_dht);
+        if (scan < 0 || scan > HEADER_MAX_SIZE)         /* sent whole, as it is */
+                return sendFrameT(stream, frame, size, stamp) < 0 ? -1 : size;
+        if (scan != cache->size || memcmp(cache->header, bytes, scan)) {
+                memcpy(cache->header, bytes, scan);
+                cache->size = scan;
+                cache->generation++;
+                cache->sent_any = 0;
+        }
+        if (cache->sent_any && now - cache->sent_ms < HEADER_REFRESH_MS)
+                return send_frame_as(stream, FRAME_MAGIC_SCAN << 8 | cache->generation,
+                                     bytes + scan, size - scan, stamp) < 0 ? -1 : size - scan;
+
+        cache->sent_any = 1;
+        cache->sent_ms = now;
+        if (has_dht)
+                return send_frame_as(stream, FRAME_MAGIC_HEADER << 8 | cache->generation,
+                                     frame, size, stamp) < 0 ? -1 : size;
+        needed = (size_t)size + sizeof(std_dht);
+        if (needed > spliced_capacity) {
+                unsigned char *grown = realloc(spliced, needed);
+
+                if (!grown)
+                        return -1;
+                spliced = grown;
+                spliced_capacity = needed;
+        }
+        memcpy(spliced, bytes, sos);
+        memcpy(spliced + sos, std_dht, sizeof(std_dht));
+        memcpy(spliced + sos + sizeof(std_dht), bytes + sos, size - sos);
+        return send_copied(stream, FRAME_MAGIC_HEADER << 8 | cache->generation,
+                           spliced, (int)needed, stamp) < 0 ? -1 : (int)needed;
+}
+
+/*
+ * RTP/JPEG output (RFC 2435): the scan data of each frame is carried after
+ * RTP and JPEG headers, and the quantization tables go in-band (Q = 255) in
+ * the first packet of the frame. A standard receiver can then rebuild the
+ * JPEG without probing the stream; writeSdpT describes the session.
+ */
+#define RTP_HEADER_SIZE 12
+#define RTP_JPEG_HEADER_SIZE 8
+#define RTP_RESTART_HEADER_SIZE 4
+#define RTP_QTABLE_HEADER_SIZE 4
+#define RTP_PAYLOAD_TYPE_JPEG 26
+#define RTP_CLOCK_RATE 90000
+#define RTP_MAX_PACKET (FRAME_MTU - 20 - 8)
+#define RTP_SDP_PATH "capture.sdp"
+
+struct jpeg_info {
+        int type;                       /* 0: 4:2:2, 1: 4:2:0; +64 with restart markers */
+        int width;
+        int height;
+        int restart_interval;
+        const unsigned char *qtables[2];        /* luma, chroma */
+        const unsigned char *scan;
+        int scan_size;
+};
+
+static int rtp_output;
+static uint16_t rtp_sequence;
+static uint32_t rtp_ssrc;
+
+/* CLOCK_MONOTONIC at the RTP clock rate */
+static uint32_t rtp_timestamp(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint32_t)((uint64_t)now.tv_sec * RTP_CLOCK_RATE +
+                          (uint64_t)now.tv_nsec * RTP_CLOCK_RATE / 1000000000);
+}
+
+/* RTP: version 2, marker on the last packet of the frame. Returns its size. */
+static int rtp_header(unsigned char *h, int marker, int payload_type, uint32_t timestamp)
+{
+        h[0] = 0x80;
+        h[1] = (marker ? 0x80 : 0) | payload_type;
+        h[2] = rtp_sequence >> 8;
+        h[3] = rtp_sequence & 0xff;
+        h[4] = timestamp >> 24;
+        h[5] = timestamp >> 16;
+        h[6] = timestamp >> 8;
+        h[7] = timestamp & 0xff;
+        h[8] = rtp_ssrc >> 24;
+        h[9] = rtp_ssrc >> 16;
+        h[10] = rtp_ssrc >> 8;
+        h[11] = rtp_ssrc & 0xff;
+        return RTP_HEADER_SIZE;
+}
+
+static int read_be16(const unsigned char *p)
+{
+        return (p[0] << 8) | p[1];
+}
+
+/*
+ * Finds what RTP/JPEG needs in a baseline JPEG. Returns -1 for anything
+ * RFC 2435 can't carry (progressive, 16-bit tables, odd sampling).
+ */
+static int parse_jpeg(const unsigned char *data, int size, struct jpeg_info *info)
+{
+        const unsigned char *tables[4] = { NULL, NULL, NULL, NULL };
+        int table_ids[2] = { -1, -1 };
+        int i = 2;
+
+        CLEAR(*info);
+        if (size < 4 || data[0] != 0xff || data[1] != 0xd8)
+                return -1;
+
+        while (i + 4 <= size) {
+                int marker, length;
+
+                if (data[i] != 0xff)
+                        return -1;
+                marker = data[i + 1];
+                if (marker == 0xff) {           /* fill byte */
+                        i++;
+                        continue;
+                }
+                length = read_be16(data + i + 2);
+                if (length < 2 || i + 2 + length > size)
+                        return -1;
+
+                switch (marker) {
+                case 0xdb: {                    /* DQT, possibly several tables */
+                        int j = i + 4;
+
+                        while (j < i + 2 + length) {
+                                if ((data[j] >> 4) != 0 || j + 65 > i + 2 + length)
+                                        return -1;
+                                tables[data[j] & 3] = data + j + 1;
+                                j += 65;
+                        }
+                        break;
+                }
+                case 0xc0:                      /* SOF0, baseline */
+                        if (length < 17 || data[i + 9] != 3)
+                                return -1;
+                        info->height = read_be16(data + i + 5);
+                        info->width = read_be16(data + i + 7);
+                        if (data[i + 11] == 0x21)
+                                info->type = 0;
+                        else if (data[i + 11] == 0x22)
+                                info->type = 1;
+                        else
+                                return -1;
+                        if (data[i + 14] != 0x11 || data[i + 17] != 0x11)
+                                return -1;
+                        table_ids[0] = data[i + 12] & 3;
+                        table_ids[1] = data[i + 15] & 3;
+                        break;
+                case 0xc1: case 0xc2: case 0xc3:
+                case 0xc5: case 0xc6: case 0xc7:
+                case 0xc9: case 0xca: case 0xcb:
+                case 0xcd: case 0xce: case 0xcf:
+                        return -1;              /* not baseline */
+                case 0xdd:                      /* DRI */
+                        info->restart_interval = read_be16(data + i + 4);
+                        break;
+                case 0xda: {                    /* SOS: entropy-coded data follows */
+                        int end = size;
+
+                        if (table_ids[0] < 0 || !tables[table_ids[0]] || !tables[table_ids[1]])
+                                return -1;
+                        if (info->width > 2040 || info->height > 2040)
+                                return -1;
+                        if (end >= 2 && data[end - 2] == 0xff && data[end - 1] == 0xd9)
+                                end -= 2;
+                        info->qtables[0] = tables[table_ids[0]];
+                        info->qtables[1] = tables[table_ids[1]];
+                        info->scan = data + i + 2 + length;
+                        info->scan_size = end - (i + 2 + length);
+                        if (info->restart_interval)
+                                info->type += 64;
+                        return info->scan_size > 0 ? 0 : -1;
+                }
+                default:
+                        break;
+                }
+                i += 2 + length;
+        }
+        return -1;
+}
+
+/* Returns the number of packets sent, or -1 if the frame can't be sent. */
+int sendRtpJpegT(const void *frame, int size)
+{
+        struct jpeg_info info;
+        uint32_t timestamp;
+        int offset = 0;
+        int packets = 0;
+
+        if (parse_jpeg(frame, size, &info) < 0) {
+                fprintf(stderr, "frame is not a baseline JPEG RTP can carry\n");
+                return -1;
+        }
+
+        timestamp = rtp_timestamp();
+
+        while (offset < info.scan_size) {
+                unsigned char *headers = batch_begin();
+                unsigned char *h = headers;
+                int room = RTP_MAX_PACKET - RTP_HEADER_SIZE - RTP_JPEG_HEADER_SIZE;
+                int length;
+                int last;
+
+                if (info.restart_interval)
+                        room -= RTP_RESTART_HEADER_SIZE;
+                if (offset == 0)
+                        room -= RTP_QTABLE_HEADER_SIZE + 128;
+                length = info.scan_size - offset < room ? info.scan_size - offset : room;
+                last = offset + length == info.scan_size;
+
+                if (!headers)
+                        return -1;
+
+                h += rtp_header(h, last, RTP_PAYLOAD_TYPE_JPEG, timestamp);
+
+                /* JPEG: type-specific, 24-bit fragment offset, type, Q, size in 8-pixel blocks */
+                h[0] = 0;
+                h[1] = offset >> 16;
+                h[2] = offset >> 8;
+                h[3] = offset & 0xff;
+                h[4] = info.type;
+                h[5] = 255;
+                h[6] = info.width / 8;
+                h[7] = info.height / 8;
+                h += RTP_JPEG_HEADER_SIZE;
+
+                if (info.restart_interval) {
+                        /* whole frame in one go: first and last bits set, count 0x3fff */
+                        h[0] = info.restart_interval >> 8;
+                        h[1] = info.restart_interval & 0xff;
+                        h[2] = 0xff;
+                        h[3] = 0xff;
+                        h += RTP_RESTART_HEADER_SIZE;
+                }
+
+                if (offset == 0) {
+                        /* MBZ, 8-bit precision, 128 bytes of tables */
+                        h[0] = 0;
+                        h[1] = 0;
+                        h[2] = 0;
+                        h[3] = 128;
+                        h += RTP_QTABLE_HEADER_SIZE;
+                        batch_add(headers, h - headers);
+                        batch_add(info.qtables[0], 64);
+                        batch_add(info.qtables[1], 64);
+                } else {
+                        batch_add(headers, h - headers);
+                }
+                batch_add(info.scan + offset, length);
+                if (batch_end() < 0)
+                        return -1;
+                rtp_sequence++;
+                packets++;
+                offset += length;
+        }
+        return flush_batch() < 0 ? -1 : packets;
+}
+
+/*
+ * RTP/H.264 output (RFC 6184, packetization mode 1) for -F: each NAL unit of
+ * an access unit goes in a packet of its own, or as FU-A fragments when it
+ * doesn't fit, and the marker ends the access unit. Unlike RTP/JPEG this is
+ * something a WebRTC gateway can hand to browsers as it is.
+ */
+#define RTP_PAYLOAD_TYPE_H264 96
+#define RTP_NAL_FU_A 28
+
+static int rtp_h264;
+
+/* Returns just past the next Annex-B start code, or end if there is none. */
+static const unsigned char *next_nal(const unsigned char *p, const unsigned char *end)
+{
+        for (; p + 3 <= end; p++)
+                if (0 == p[0] && 0 == p[1] && 1 == p[2])
+                        return p + 3;
+        return end;
+}
+
+static int send_nal(const unsigned char *nal, int size, int last, uint32_t timestamp)
+{
+        int room = RTP_MAX_PACKET - RTP_HEADER_SIZE;
+        int packets = 0;
+        int offset = 1;
+
+        if (size <= room) {
+                unsigned char *h = batch_begin();
+
+                if (!h)
+                        return -1;
+                batch_add(h, rtp_header(h, last, RTP_PAYLOAD_TYPE_H264, timestamp));
+                batch_add(nal, size);
+                rtp_sequence++;
+                return batch_end() < 0 ? -1 : 1;
+        }
+
+        /* FU-A: the NAL header is split over the indicator and each fragment's header */
+        room -= 2;
+        while (offset < size) {
+                unsigned char *h = batch_begin();
+                int length = size - offset < room ? size - offset : room;
+                int final = offset + length == size;
+
+                if (!h)
+                        return -1;
+                rtp_header(h, last && final, RTP_PAYLOAD_TYPE_H264, timestamp);
+                h[RTP_HEADER_SIZE] = (nal[0] & 0xe0) | RTP_NAL_FU_A;
+                h[RTP_HEADER_SIZE + 1] = (offset == 1 ? 0x80 : 0) | (final ? 0x40 : 0) | (nal[0] & 0x1f);
+                batch_add(h, RTP_HEADER_SIZE + 2);
+                batch_add(nal + offset, length);
+                if (batch_end() < 0)
+                        return -1;
+                rtp_sequence++;
+                packets++;
+                offset += length;
+        }
+        return packets;
+}
+
+/* Returns the number of packets sent, or -1 if the frame can't be sent. */
+int sendRtpH264T(const void *frame, int size)
+{
+        const unsigned char *end = (const unsigned char *)frame + size;
+        const unsigned char *nal = next_nal(frame, end);
+        uint32_t timestamp = rtp_timestamp();
+        int packets = 0;
+
+        if (nal == end) {
+                fprintf(stderr, "frame is not an H264 access unit\n");
+                return -1;
+        }
+        while (nal < end) {
+                const unsigned char *next = next_nal(nal, end);
+                const unsigned char *nal_end = next == end ? end : next - 3;
+                int sent;
+
+                /* a four-byte start code's leading zero, and trailing zero bytes */
+                while (nal_end > nal && 0 == nal_end[-1])
+                        nal_end--;
+                if (nal_end > nal) {
+                        sent = send_nal(nal, nal_end - nal, next == end, timestamp);
+                        if (sent < 0)
+                                return -1;
+                        packets += sent;
+                }
+                nal = next;
+        }
+        return flush_batch() < 0 ? -1 : packets;
+}
+
+/* The session description a receiver needs, e.g. ffmpeg -i capture.sdp. */
+int writeSdpT(const char *path)
+{
+        FILE *f = fopen(path, "w");
+
+        if (!f)
+                return -1;
+        fprintf(f, "v=0\r\n");
+        fprintf(f, "o=- %u 0 IN IP4 0.0.0.0\r\n", (unsigned)rtp_ssrc);
+        fprintf(f, "s=capture\r\n");
+        fprintf(f, "c=IN IP4 %s\r\n", inet_ntoa(sinRemoteT.sin_addr));
+        fprintf(f, "t=0 0\r\n");
+        if (rtp_h264) {
+                fprintf(f, "m=video %d RTP/AVP %d\r\n", ntohs(sinRemoteT.sin_port), RTP_PAYLOAD_TYPE_H264);
+                fprintf(f, "a=rtpmap:%d H264/%d\r\n", RTP_PAYLOAD_TYPE_H264, RTP_CLOCK_RATE);
+                fprintf(f, "a=fmtp:%d packetization-mode=1\r\n", RTP_PAYLOAD_TYPE_H264);
+        } else {
+                fprintf(f, "m=video %d RTP/AVP %d\r\n", ntohs(sinRemoteT.sin_port), RTP_PAYLOAD_TYPE_JPEG);
+                fprintf(f, "a=rtpmap:%d JPEG/%d\r\n", RTP_PAYLOAD_TYPE_JPEG, RTP_CLOCK_RATE);
+        }
+        fclose(f);
+        return 0;
+}
+
 
 
 
@@ -77,21 +943,60 @@ enum io_method {
         IO_METHOD_READ,
         IO_METHOD_MMAP,
         IO_METHOD_USERPTR,
+        IO_METHOD_DMABUF,       /* mmap, and exported for other devices and processes */
 };
 
 struct buffer {
         void   *start;
         size_t  length;
+        int     dmabuf;         /* exported fd, with IO_METHOD_DMABUF */
 };
 
-static char            *dev_name;
+struct in_flight;
+
+/*
+ * One capture device. Several can be given (-d, repeated); each one's
+ * frames carry its position on the command line as their stream id.
+ */
+struct device {
+        const char             *name;
+        int                     fd;
+        struct buffer          *buffers;
+        unsigned int            n_buffers;
+        struct frame_pool      *pool;           /* USERPTR buffers, and frames kept past process_image() */
+        struct pool_frame     **queued;         /* per buffer, the pool frame it is, with USERPTR */
+        unsigned int            stream;
+        unsigned int            frames;         /* captured so far */
+        int                     paused;         /* out of the epoll set: every buffer in flight */
+        struct in_flight       *in_flight;      /* per buffer, with --zerocopy */
+        unsigned char          *lent;           /* per buffer, to the --dmabuf consumer */
+        struct v4l2_pix_format  format;         /* as the driver settled it */
+        uint32_t                last_frame_ms;  /* CLOCK_MONOTONIC, of the last frame or (re)start */
+        int                     quality;        /* its own JPEG quality, for --adapt */
+        int                     failed;         /* errno of a failed DQBUF or QBUF, until recovered */
+        int                     restarted;      /* streaming restarted in place, and no frame since */
+        uint32_t                stalls;         /* stalls and failures so far */
+};
+
+/* a device with no frame for this long is reopened, retrying every RECOVER_MIN_MS doubling up to RECOVER_MAX_MS */
+#define STALL_MS        3000
+#define RECOVER_MIN_MS  100
+#define RECOVER_MAX_MS  5000
+
+static struct device    devices[MAX_STREAMS];
+static unsigned int     n_devices;
+static int              epoll_fd = -1;
 static enum io_method   io = IO_METHOD_MMAP;
-static int              fd = -1;
-struct buffer          *buffers;
-static unsigned int     n_buffers;
 static int              out_buf;
-static int              force_format = 0;
-static int              frame_count = 100;
+static int              force_format = 1;
+static int              frame_count = 0;    /* 0: until killed */
+static unsigned int     width = 720;
+static unsigned int     height = 720;
+static unsigned int     pixelformat = V4L2_PIX_FMT_MJPEG;
+static unsigned int     fps;                /* 0: whatever the driver picks */
+static unsigned int     adapt_fps_div = 1;  /* --adapt's current step down */
+static unsigned int     adapt_size_div = 1;
+static unsigned int     buffer_count;       /* 0: 4, or ZEROCOPY_BUFFERS with --zerocopy */
 
 static void errno_exit(const char *s)
 {
@@ -99,160 +1004,3442 @@ static void errno_exit(const char *s)
         exit(EXIT_FAILURE);
 }
 
-static int xioctl(int fh, int request, void *arg)
+static int xioctl(int fh, int request, void *arg)
+{
+        int r;
+
+        do {
+                r = ioctl(fh, request, arg);
+        } while (-1 == r && EINTR == errno);
+
+        return r;
+}
+
+/* frame bytes handed to the socket, for --adapt; the --latest sender adds to it too */
+static uint32_t bytes_sent;
+
+static void send_frame(unsigned int stream, const void *p, int size, const struct frame_stamp *stamp)
+{
+int sent = size;
+
+if (rtp_h264)
+sendRtpH264T(p, size);
+else if (rtp_output)
+sendRtpJpegT(p, size);
+else if (header_cache)
+sent = send_header_cached(stream, p, size, stamp);
+else
+sendFrameT(stream, p, size, stamp);
+if (sent > 0)
+__atomic_fetch_add(&bytes_sent, (uint32_t)sent, __ATOMIC_RELAXED);
+}
+
+/*
+ * Latest-frame-wins (--latest): the capture loop puts a reference to each
+ * frame in a one-frame mailbox and re-queues the buffer straight away, and a
+ * sender thread always takes whatever is newest. If the network stalls,
+ * frames captured meanwhile replace each other instead of queueing up, so
+ * the stream resumes at real time. Three slots rotate between the capture
+ * loop, the mailbox and the sender, so neither side waits for the other's
+ * send; a frame goes back to its pool once it is sent or skipped.
+ */
+struct frame_slot {
+        struct pool_frame *frame;
+        unsigned int stream;
+        struct frame_stamp stamp;
+};
+
+static int latest_frame;
+static struct frame_slot slots[3];
+static int capture_slot = 0, mailbox_slot = 1, sender_slot = 2;
+static int mailbox_fresh;
+static int sender_stop;
+static unsigned long frames_skipped;
+static pthread_mutex_t mailbox_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mailbox_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t sender_thread;
+
+static void *run_sender(void *arg)
+{
+        (void)arg;
+        for (;;) {
+                int tmp;
+
+                pthread_mutex_lock(&mailbox_lock);
+                while (!mailbox_fresh && !sender_stop)
+                        pthread_cond_wait(&mailbox_ready, &mailbox_lock);
+                if (!mailbox_fresh) {
+                        pthread_mutex_unlock(&mailbox_lock);
+                        break;
+                }
+                tmp = sender_slot;
+                sender_slot = mailbox_slot;
+                mailbox_slot = tmp;
+                mailbox_fresh = 0;
+                pthread_mutex_unlock(&mailbox_lock);
+
+                send_frame(slots[sender_slot].stream, slots[sender_slot].frame->data,
+                           slots[sender_slot].frame->size, &slots[sender_slot].stamp);
+                frame_release(slots[sender_slot].frame);
+                slots[sender_slot].frame = NULL;
+        }
+        return NULL;
+}
+
+/* Takes over a reference to frame; NULL is ignored. */
+static void mailbox_put(unsigned int stream, struct pool_frame *frame, const struct frame_stamp *stamp)
+{
+        struct frame_slot *slot = &slots[capture_slot];
+        int tmp;
+
+        if (!frame)
+                return;
+        /* this slot belongs to the capture loop until it is swapped in; its frame was skipped */
+        frame_release(slot->frame);
+        slot->frame = frame;
+        slot->stream = stream;
+        slot->stamp = *stamp;
+
+        pthread_mutex_lock(&mailbox_lock);
+        tmp = mailbox_slot;
+        mailbox_slot = capture_slot;
+        capture_slot = tmp;
+        if (mailbox_fresh)
+                frames_skipped++;
+        mailbox_fresh = 1;
+        pthread_cond_signal(&mailbox_ready);
+        pthread_mutex_unlock(&mailbox_lock);
+}
+
+static void start_sender(void)
+{
+        if (pthread_create(&sender_thread, NULL, run_sender, NULL))
+                errno_exit("pthread_create");
+}
+
+/* Sends whatever is still in the mailbox, then joins the sender. */
+static void stop_sender(void)
+{
+        int i;
+
+        pthread_mutex_lock(&mailbox_lock);
+        sender_stop = 1;
+        pthread_cond_signal(&mailbox_ready);
+        pthread_mutex_unlock(&mailbox_lock);
+        pthread_join(sender_thread, NULL);
+
+        fprintf(stderr, "%lu stale frames skipped\n", frames_skipped);
+        for (i = 0; i < 3; i++) {
+                frame_release(slots[i].frame);
+                slots[i].frame = NULL;
+        }
+}
+
+/*
+ * Feed events: the feeder sends a datagram to FEED_EVENT_PATH when a feed
+ * starts (feed_notifier.c in the voice demo), "feed <mode> <journal time>",
+ * and SIGUSR1 does the same by hand, with no journal time. Both are picked
+ * up once per frame. In fishfeeder, where SIGUSR1 is the feeder's own, the
+ * notice comes over board_link.c instead and read_board_link keeps it here.
+ */
+#define FEED_EVENT_PATH "/tmp/fishfeeder-feed.sock"
+
+static volatile sig_atomic_t feed_signalled;
+static int feed_socket = -1;
+#ifdef FISHFEEDER_UNIFIED
+static int linked_feed;
+static int64_t linked_feed_time_us;
+#endif
+
+static void on_feed_signal(int sig)
+{
+        (void)sig;
+        feed_signalled = 1;
+}
+
+static void open_feed_events(void)
+{
+        struct sigaction sa;
+        struct sockaddr_un addr;
+
+        if (feed_socket >= 0)
+                return;
+#ifdef FISHFEEDER_UNIFIED
+        return;
+#endif
+
+        CLEAR(sa);
+        sa.sa_handler = on_feed_signal;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        if (-1 == sigaction(SIGUSR1, &sa, NULL))
+                errno_exit("sigaction");
+
+        feed_socket = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (-1 == feed_socket)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, FEED_EVENT_PATH, sizeof(addr.sun_path) - 1);
+        unlink(FEED_EVENT_PATH);        /* left over from an earlier run */
+        if (-1 == bind(feed_socket, (struct sockaddr *)&addr, sizeof(addr)))
+                errno_exit(FEED_EVENT_PATH);
+}
+
+static void close_feed_events(void)
+{
+        if (feed_socket < 0)
+                return;
+        close(feed_socket);
+        feed_socket = -1;
+        unlink(FEED_EVENT_PATH);
+}
+
+/*
+ * Returns whether a feed started since the last frame, and the feed journal's
+ * time of the newest one in *time_us, 0 if it has none.
+ */
+static int take_feed_event(int64_t *time_us)
+{
+        char message[64];
+        ssize_t length;
+        int fed = 0;
+
+        *time_us = 0;
+        if (feed_signalled) {
+                feed_signalled = 0;
+                fed = 1;
+        }
+#ifdef FISHFEEDER_UNIFIED
+        if (linked_feed) {
+                linked_feed = 0;
+                *time_us = linked_feed_time_us;
+                fed = 1;
+        }
+#endif
+        while (feed_socket >= 0 &&
+               (length = recv(feed_socket, message, sizeof(message) - 1, 0)) >= 0) {
+                long long t = 0;
+                int mode;
+
+                message[length] = '\0';
+                *time_us = 2 == sscanf(message, "feed %d %lld", &mode, &t) ? t : 0;
+                fed = 1;
+        }
+        return fed;
+}
+
+/*
+ * Pellet watch (--pellets): after each feed, how long the fish take to eat
+ * it (pellet_watch.c). The outcome goes back to the feeder on its control
+ * socket, which keeps it in the feed's journal record.
+ */
+#define CONTROL_PATH "/tmp/fishfeeder-control.sock"
+#define CONTROL_TIMEOUT_MS 200
+
+static int pellets;
+
+/*
+ * One short request on the feeder's control socket. It is answered from the
+ * feeder's event loop, so the wait for the reply is short and bounded.
+ */
+static void report_consumption(const struct pellet_result *result)
+{
+        struct sockaddr_un addr;
+        struct pollfd pfd;
+        char body[96], request[256], reply[64];
+        int fd, length;
+        ssize_t n;
+
+        if (result->eaten)
+                fprintf(stderr, "pellets: eaten in %us (peak %u blocks in %u pieces)\n",
+                        result->seconds, result->peak_blocks, result->peak_blobs);
+        else
+                fprintf(stderr, "pellets: %u%% left after %us (peak %u blocks in %u pieces)\n",
+                        result->left_percent, result->seconds, result->peak_blocks, result->peak_blobs);
+        if (!result->feed_time_us)
+                return;         /* SIGUSR1: no journal record to put it in */
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (-1 == fd) {
+                perror("pellets: socket");
+                return;
+        }
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, CONTROL_PATH, sizeof(addr.sun_path) - 1);
+        snprintf(body, sizeof(body), "feed=%lld&seconds=%u&eaten=%d",
+                 (long long)result->feed_time_us, result->seconds, result->eaten);
+        length = snprintf(request, sizeof(request),
+                          "POST /consumption HTTP/1.0\r\n"
+                          "Content-Type: application/x-www-form-urlencoded\r\n"
+                          "Content-Length: %d\r\n\r\n%s",
+                          (int)strlen(body), body);
+        if (-1 == connect(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+            send(fd, request, length, MSG_NOSIGNAL) != length) {
+                perror("pellets: " CONTROL_PATH);
+                close(fd);
+                return;
+        }
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, CONTROL_TIMEOUT_MS) > 0 &&
+            (n = recv(fd, reply, sizeof(reply) - 1, 0)) > 0) {
+                reply[n] = '\0';
+                if (!strstr(reply, " 200 "))
+                        fprintf(stderr, "pellets: feeder refused the report: %.*s\n",
+                                (int)strcspn(reply, "\r\n"), reply);
+        }
+        close(fd);
+}
+
+/*
+ * Activity: frames are compared by the mean luma of each 8x8 block
+ * (jpeg_activity.c), at most ACTIVITY_MEASURE_FPS of them a second so that
+ * a fast camera streams at its full rate. --motion gates on the share of
+ * blocks that changed. --activity file appends a line a second, the
+ * fish activity index: "<unix time> <energy> <changed> <frames>", energy
+ * being the mean squared change of a block's luma between measured frames
+ * and changed the mean per mille of blocks that moved, over that second.
+ */
+#define ACTIVITY_LUMA_DELTA 12  /* mean luma change that counts a block as changed */
+#define ACTIVITY_MEASURE_FPS 10
+#define ACTIVITY_REPORT_MS 1000
+
+static FILE *activity_file;
+static int activity = -1;               /* of the last frame measured, -1 if it couldn't be */
+static uint32_t last_measured_ms;
+static int measured_any;
+static uint32_t report_since_ms;
+static uint64_t energy_sum, changed_sum;
+static unsigned int measured_frames;
+
+static void report_activity(uint32_t now)
+{
+        if (measured_frames) {
+                fprintf(activity_file, "%lld %llu %llu %u\n", (long long)time(NULL),
+                        (unsigned long long)(energy_sum / measured_frames),
+                        (unsigned long long)(changed_sum / measured_frames), measured_frames);
+                fflush(activity_file);
+        }
+        report_since_ms = now;
+        energy_sum = 0;
+        changed_sum = 0;
+        measured_frames = 0;
+}
+
+static void measure_activity(const void *p, int size)
+{
+        uint32_t now = monotonic_ms();
+        unsigned int energy;
+
+        if (measured_any && now - last_measured_ms < 1000 / ACTIVITY_MEASURE_FPS)
+                return;
+        if (!measured_any)
+                report_since_ms = now;
+        measured_any = 1;
+        last_measured_ms = now;
+        activity = jpeg_activity_measure(p, size, ACTIVITY_LUMA_DELTA, &energy);
+        /* the first frame, or one of a new size, has nothing to be compared with */
+        if (activity >= 0 && activity < 1000) {
+                energy_sum += energy;
+                changed_sum += activity;
+                measured_frames++;
+        }
+        if (activity_file && now - report_since_ms >= ACTIVITY_REPORT_MS)
+                report_activity(now);
+}
+
+/*
+ * Motion gating (--motion): while nothing in view changes, only one frame
+ * every --idle seconds goes out, so the page still shows a current picture.
+ * Motion, or a feed event, brings back every frame for a while.
+ */
+#define MOTION_HOLD_MS 2000
+#define FEED_HOLD_MS 30000
+
+static int motion_threshold = -1;       /* per mille of blocks, -1: send everything */
+static unsigned int idle_interval = 10;
+static uint32_t full_rate_until;
+static uint32_t last_sent_ms;
+static int sent_any;
+static unsigned long frames_gated;
+
+static void hold_full_rate(uint32_t now, uint32_t ms)
+{
+        if ((int32_t)(now + ms - full_rate_until) > 0)
+                full_rate_until = now + ms;
+}
+
+/* Returns whether this frame should go out, by the latest activity. */
+static int motion_gate(int fed)
+{
+        uint32_t now = monotonic_ms();
+
+        if (fed)
+                hold_full_rate(now, FEED_HOLD_MS);
+        /* a frame that can't be measured is never held back */
+        if (activity < 0 || activity >= motion_threshold)
+                hold_full_rate(now, MOTION_HOLD_MS);
+
+        if (!sent_any || (int32_t)(full_rate_until - now) > 0 ||
+            now - last_sent_ms >= idle_interval * 1000) {
+                sent_any = 1;
+                last_sent_ms = now;
+                return 1;
+        }
+        frames_gated++;
+        return 0;
+}
+
+/*
+ * Thumbnails (--thumbnails fps): a second, tiny stream of every camera, so
+ * a page showing many tanks at once can fetch and decode the full frames of
+ * only the one in focus. Each thumbnail is the frame at 1/8 scale, taken
+ * from its DC coefficients and encoded again (jpeg_thumbnail.c), a few
+ * kilobytes and a datagram or three. They go out at their own rate whether
+ * or not --motion holds the frames back, so every tile stays current.
+ */
+#define THUMBNAIL_MAX_FPS 30
+#define THUMBNAIL_MAX_SIZE 65536
+
+static unsigned int thumbnail_fps;      /* 0: no thumbnails */
+static uint32_t thumbnail_sent_ms[MAX_STREAMS];
+static int thumbnail_sent[MAX_STREAMS];
+static unsigned char thumbnail[THUMBNAIL_MAX_SIZE];
+
+static void send_thumbnail(unsigned int stream, const void *p, int size,
+                           const struct frame_stamp *stamp)
+{
+        uint32_t now = monotonic_ms();
+        int n;
+
+        if (thumbnail_sent[stream] && now - thumbnail_sent_ms[stream] < 1000 / thumbnail_fps)
+                return;
+        thumbnail_sent[stream] = 1;
+        thumbnail_sent_ms[stream] = now;
+        n = jpeg_thumbnail(p, size, thumbnail, sizeof(thumbnail));
+        if (n < 0)
+                return;         /* not a frame that can be scaled down; the next one may be */
+        send_frame(THUMBNAIL_STREAM_BASE + stream, thumbnail, n, stamp);
+}
+
+/*
+ * Thermal shedding (--thermal): the feeder (thermal_monitor.c in the
+ * microphone demo) reads the SoC's temperature and sends "thermal <level>"
+ * from this board as it climbs towards the point where the SoC throttles
+ * itself. Each level sheds one more of the optional workloads, least
+ * missed first: 1 stops the time-lapse, 2 the activity index and motion
+ * gating, which then lets every frame through, 3 the thumbnails, and 4
+ * sends every other frame of the streams themselves. The pellet watch goes
+ * on, as a feed can't be timed again later. A lower level takes effect at
+ * once, so the feeder's hysteresis is the only one.
+ */
+#define THERMAL_LEVELS 5
+
+static int thermal;
+static unsigned int thermal_level;
+static unsigned int thermal_frames[MAX_STREAMS];
+
+static void set_thermal_level(unsigned int level)
+{
+        static const char *const shed[THERMAL_LEVELS] = {
+                "nothing", "the time-lapse", "the time-lapse and analytics",
+                "the time-lapse, analytics and thumbnails", "all of those and half the frames",
+        };
+
+        if (level >= THERMAL_LEVELS)
+                level = THERMAL_LEVELS - 1;
+        if (level == thermal_level)
+                return;
+        fprintf(stderr, "feeder reports thermal level %u, shedding %s\n", level, shed[level]);
+        /* the motion gate lets everything through without a measurement */
+        if (level >= 2 && thermal_level < 2)
+                activity = -1;
+        thermal_level = level;
+}
+
+/*
+ * Feed clips (--clips dir): the last CLIP_PRE_MS of frames are kept in a
+ * preallocated ring, already laid out as AVI '00dc' chunks. When a feed
+ * starts, recording goes on until CLIP_POST_MS after it; then the arena is
+ * handed to a writer thread, which saves it as an MJPEG AVI with a single
+ * writev(), and capture carries on in the other arena. Capture only ever
+ * copies the frame in; a clip that ends while the last one is still being
+ * written is dropped.
+ *
+ * The microphone daemon sends its audio frames to CLIP_AUDIO_PATH as it
+ * records them (audio_tap.h on its side), each stamped with the
+ * CLOCK_MONOTONIC time of its first sample. They are kept in a ring next to
+ * each arena's frames, and a clip they overlap gets a PCM stream too, one
+ * '01wb' chunk after each frame holding the sound from that frame to the
+ * next, so the spoken command and the feed play in sync with no
+ * transcoding. Lost datagrams become silence, as does whatever part of the
+ * clip the audio doesn't reach.
+ */
+#define CLIP_PRE_MS 5000
+#define CLIP_POST_MS 10000
+#define CLIP_ARENA_BYTES (32u << 20)
+#define CLIP_MAX_FRAMES 1024
+#define CLIP_AUDIO_PATH "/tmp/fishfeeder-audio.sock"
+#define CLIP_AUDIO_MAGIC 0x31445541u   /* "AUD1" in memory */
+#define CLIP_AUDIO_MAX_RATE 48000
+/* a clip's worth at the highest rate, and two seconds to spare */
+#define CLIP_AUDIO_SAMPLES ((CLIP_PRE_MS + CLIP_POST_MS + 2000) / 1000 * CLIP_AUDIO_MAX_RATE)
+#define CLIP_AUDIO_SLACK_US 20000       /* later than that is a gap, not jitter */
+#define CLIP_AUDIO_DATAGRAM 65536
+#define CLIP_SILENCE_SAMPLES (CLIP_AUDIO_MAX_RATE / 10)
+#define CLIP_IOV_BATCH 1024
+#define AVI_HEADER_SIZE 224
+#define AVI_AUDIO_STRL_SIZE 100
+#define AVIF_HASINDEX 0x10
+#define AVIIF_KEYFRAME 0x10
+
+struct clip_frame {
+        uint32_t offset;        /* of the chunk in the arena */
+        uint32_t size;          /* JPEG bytes */
+        uint32_t ms;
+};
+
+struct clip_arena {
+        unsigned char *data;
+        struct clip_frame frames[CLIP_MAX_FRAMES];
+        unsigned int first, count;
+        uint32_t tail;          /* end of the newest chunk */
+        time_t feed_time;
+        int16_t *audio;         /* ring of CLIP_AUDIO_SAMPLES */
+        uint32_t audio_first, audio_count, audio_rate;
+        uint64_t audio_origin_us;       /* when the first sample since the ring started was recorded */
+        uint64_t audio_dropped;         /* samples evicted since */
+};
+
+/* the microphone's datagrams: this, then 16-bit mono samples */
+struct clip_audio_header {
+        uint32_t magic;
+        uint32_t sample_rate;
+        uint64_t start_us;      /* CLOCK_MONOTONIC */
+};
+
+/* Where a clip's audio lies in its arena's ring; rate 0 if there is none to go with the frames. */
+struct clip_sound {
+        unsigned int rate;
+        int64_t at;             /* ring index at the first frame's time, maybe outside the ring */
+        int64_t total;          /* samples from the first frame to one frame past the last */
+};
+
+static const char *clip_dir;
+static struct clip_arena arenas[2];
+static struct clip_arena *recording = &arenas[0];
+static int clip_recording;
+static uint32_t clip_end_ms;
+static unsigned long clips_dropped;
+
+/* owned by the writer while set */
+static struct clip_arena *clip_pending;
+static int clip_writer_stop;
+static pthread_mutex_t clip_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clip_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t clip_writer;
+static unsigned char avi_header[AVI_HEADER_SIZE + AVI_AUDIO_STRL_SIZE];
+static unsigned char avi_index[8 + 2 * 16 * CLIP_MAX_FRAMES];
+static unsigned char clip_audio_chunks[CLIP_MAX_FRAMES][8];
+static const int16_t clip_silence[CLIP_SILENCE_SAMPLES];
+static struct iovec clip_iov[CLIP_IOV_BATCH];
+static int clip_iovs, clip_out, clip_failed;
+
+static int clip_audio_socket = -1;
+static union {
+        struct clip_audio_header header;
+        unsigned char bytes[CLIP_AUDIO_DATAGRAM];
+} clip_audio_in;
+
+static unsigned char *put_le16(unsigned char *p, unsigned int v)
+{
+        p[0] = v;
+        p[1] = v >> 8;
+        return p + 2;
+}
+
+static unsigned char *put_le32(unsigned char *p, uint32_t v)
+{
+        p[0] = v;
+        p[1] = v >> 8;
+        p[2] = v >> 16;
+        p[3] = v >> 24;
+        return p + 4;
+}
+
+static unsigned char *put_fourcc(unsigned char *p, const char *fourcc)
+{
+        memcpy(p, fourcc, 4);
+        return p + 4;
+}
+
+static void clip_evict(struct clip_arena *a)
+{
+        a->first = (a->first + 1) % CLIP_MAX_FRAMES;
+        a->count--;
+}
+
+/* Finds room for a chunk, evicting the oldest frames as needed. */
+static uint32_t clip_make_room(struct clip_arena *a, uint32_t need)
+{
+        for (;;) {
+                uint32_t head;
+
+                if (0 == a->count)
+                        return 0;
+                head = a->frames[a->first].offset;
+                if (a->tail > head) {
+                        /* in use: [head, tail) */
+                        if (a->tail + need <= CLIP_ARENA_BYTES)
+                                return a->tail;
+                        if (need <= head)
+                                return 0;
+                } else if (a->tail + need <= head) {
+                        /* in use: [head, end of the last lap) and [0, tail) */
+                        return a->tail;
+                }
+                clip_evict(a);
+        }
+}
+
+/*
+ * The header up to the 'movi' list's fourcc, for an idx1 of frames entries
+ * after it, and as many again for audio_samples of PCM at audio_rate if that
+ * isn't 0. Returns its size.
+ */
+static uint32_t put_avi_header(unsigned char *header, unsigned int frames, uint32_t us_per_frame,
+                               uint32_t largest, unsigned int w, unsigned int h, uint32_t movi_bytes,
+                               unsigned int audio_rate, uint32_t audio_samples)
+{
+        const uint32_t audio_strl = audio_rate ? AVI_AUDIO_STRL_SIZE : 0;
+        const unsigned int entries = audio_rate ? 2 * frames : frames;
+        unsigned char *p;
+
+        p = put_fourcc(header, "RIFF");
+        p = put_le32(p, AVI_HEADER_SIZE + audio_strl - 8 + movi_bytes + 8 + 16 * entries);
+        p = put_fourcc(p, "AVI ");
+        p = put_fourcc(p, "LIST");
+        p = put_le32(p, 192 + audio_strl);
+        p = put_fourcc(p, "hdrl");
+
+        p = put_fourcc(p, "avih");
+        p = put_le32(p, 56);
+        p = put_le32(p, us_per_frame);
+        p = put_le32(p, 0);                     /* max bytes per second */
+        p = put_le32(p, 0);                     /* padding granularity */
+        p = put_le32(p, AVIF_HASINDEX);
+        p = put_le32(p, frames);
+        p = put_le32(p, 0);                     /* initial frames */
+        p = put_le32(p, audio_rate ? 2 : 1);    /* streams */
+        p = put_le32(p, largest);
+        p = put_le32(p, w);
+        p = put_le32(p, h);
+        memset(p, 0, 16);
+        p += 16;
+
+        p = put_fourcc(p, "LIST");
+        p = put_le32(p, 116);
+        p = put_fourcc(p, "strl");
+        p = put_fourcc(p, "strh");
+        p = put_le32(p, 56);
+        p = put_fourcc(p, "vids");
+        p = put_fourcc(p, "MJPG");
+        p = put_le32(p, 0);                     /* flags */
+        p = put_le16(p, 0);                     /* priority */
+        p = put_le16(p, 0);                     /* language */
+        p = put_le32(p, 0);                     /* initial frames */
+        p = put_le32(p, us_per_frame);          /* scale / rate = seconds per frame */
+        p = put_le32(p, 1000000);
+        p = put_le32(p, 0);                     /* start */
+        p = put_le32(p, frames);
+        p = put_le32(p, largest);
+        p = put_le32(p, 0xffffffff);            /* quality: default */
+        p = put_le32(p, 0);                     /* sample size: varies */
+        p = put_le16(p, 0);
+        p = put_le16(p, 0);
+        p = put_le16(p, w);
+        p = put_le16(p, h);
+
+        p = put_fourcc(p, "strf");
+        p = put_le32(p, 40);
+        p = put_le32(p, 40);                    /* BITMAPINFOHEADER */
+        p = put_le32(p, w);
+        p = put_le32(p, h);
+        p = put_le16(p, 1);
+        p = put_le16(p, 24);
+        p = put_fourcc(p, "MJPG");
+        p = put_le32(p, w * h * 3);
+        memset(p, 0, 16);
+        p += 16;
+
+        if (audio_rate) {
+                p = put_fourcc(p, "LIST");
+                p = put_le32(p, AVI_AUDIO_STRL_SIZE - 8);
+                p = put_fourcc(p, "strl");
+                p = put_fourcc(p, "strh");
+                p = put_le32(p, 56);
+                p = put_fourcc(p, "auds");
+                p = put_le32(p, 0);             /* handler: none for PCM */
+                p = put_le32(p, 0);
+                p = put_le16(p, 0);
+                p = put_le16(p, 0);
+                p = put_le32(p, 0);
+                p = put_le32(p, 1);             /* scale / rate = seconds per sample */
+                p = put_le32(p, audio_rate);
+                p = put_le32(p, 0);
+                p = put_le32(p, audio_samples);
+                p = put_le32(p, audio_rate * 2);
+                p = put_le32(p, 0xffffffff);
+                p = put_le32(p, 2);             /* sample size */
+                memset(p, 0, 8);
+                p += 8;
+
+                p = put_fourcc(p, "strf");
+                p = put_le32(p, 16);
+                p = put_le16(p, 1);             /* WAVEFORMATEX: PCM */
+                p = put_le16(p, 1);             /* mono */
+                p = put_le32(p, audio_rate);
+                p = put_le32(p, audio_rate * 2);
+                p = put_le16(p, 2);             /* block align */
+                p = put_le16(p, 16);
+        }
+
+        p = put_fourcc(p, "LIST");
+        p = put_le32(p, 4 + movi_bytes);
+        put_fourcc(p, "movi");
+        return AVI_HEADER_SIZE + audio_strl;
+}
+
+/* Seconds per frame, as the clip will play back. */
+static uint32_t clip_us_per_frame(const struct clip_arena *a)
+{
+        const struct clip_frame *oldest = &a->frames[a->first];
+        const struct clip_frame *newest = &a->frames[(a->first + a->count - 1) % CLIP_MAX_FRAMES];
+
+        if (a->count < 2)
+                return 1000000;
+        return (newest->ms - oldest->ms) * 1000 / (a->count - 1);
+}
+
+/* Lines the arena's audio up with its frames; both were stamped on CLOCK_MONOTONIC. */
+static void clip_sound(const struct clip_arena *a, uint32_t us_per_frame, struct clip_sound *s)
+{
+        const struct clip_frame *oldest = &a->frames[a->first];
+        uint64_t start_us;
+        int64_t lead_us;
+
+        s->rate = 0;
+        s->at = 0;
+        s->total = 0;
+        if (0 == a->audio_count)
+                return;
+        start_us = a->audio_origin_us + a->audio_dropped * 1000000 / a->audio_rate;
+        lead_us = (int64_t)(int32_t)(oldest->ms - (uint32_t)(start_us / 1000)) * 1000 -
+                  (int64_t)(start_us % 1000);
+        s->at = lead_us * a->audio_rate / 1000000;
+        s->total = (int64_t)a->count * us_per_frame * a->audio_rate / 1000000;
+        if (s->at < (int64_t)a->audio_count && s->at + s->total > 0)
+                s->rate = a->audio_rate;
+}
+
+/* The ring indices of the sound that goes with frame i: from it to the next, or to the end. */
+static void clip_audio_range(const struct clip_arena *a, const struct clip_sound *s,
+                             unsigned int i, int64_t *from, int64_t *to)
+{
+        const uint32_t t0 = a->frames[a->first].ms;
+
+        *from = s->at + (int64_t)(a->frames[(a->first + i) % CLIP_MAX_FRAMES].ms - t0) * s->rate / 1000;
+        if (i + 1 < a->count)
+                *to = s->at + (int64_t)(a->frames[(a->first + i + 1) % CLIP_MAX_FRAMES].ms - t0) *
+                      s->rate / 1000;
+        else
+                *to = s->at + s->total;
+        if (*to < *from)
+                *to = *from;
+}
+
+/* Builds the header and index; returns the header's size. */
+static uint32_t build_avi(const struct clip_arena *a, uint32_t us_per_frame,
+                          const struct clip_sound *s, uint32_t movi_bytes)
+{
+        unsigned char *p = avi_header;
+        const struct clip_frame *oldest = &a->frames[a->first];
+        uint32_t largest = 0, offset = 4, samples = 0;
+        struct jpeg_info info;
+        unsigned int w = width, h = height, i;
+
+        if (0 == parse_jpeg(a->data + oldest->offset + 8, oldest->size, &info)) {
+                w = info.width;
+                h = info.height;
+        }
+
+        /* idx1 offsets count from the 'movi' fourcc */
+        p = put_fourcc(avi_index, "idx1");
+        p = put_le32(p, 16 * (s->rate ? 2 * a->count : a->count));
+        for (i = 0; i < a->count; i++) {
+                const struct clip_frame *f = &a->frames[(a->first + i) % CLIP_MAX_FRAMES];
+
+                p = put_fourcc(p, "00dc");
+                p = put_le32(p, AVIIF_KEYFRAME);
+                p = put_le32(p, offset);
+                p = put_le32(p, f->size);
+                offset += 8 + f->size + (f->size & 1);
+                if (f->size > largest)
+                        largest = f->size;
+                if (s->rate) {
+                        int64_t from, to;
+
+                        clip_audio_range(a, s, i, &from, &to);
+                        p = put_fourcc(p, "01wb");
+                        p = put_le32(p, AVIIF_KEYFRAME);
+                        p = put_le32(p, offset);
+                        p = put_le32(p, 2 * (to - from));
+                        offset += 8 + 2 * (to - from);
+                        samples += to - from;
+                }
+        }
+
+        return put_avi_header(avi_header, a->count, us_per_frame, largest, w, h, movi_bytes,
+                              s->rate, samples);
+}
+
+static int writev_all(int out, struct iovec *iov, int count)
+{
+        while (count > 0) {
+                ssize_t n = writev(out, iov, count);
+
+                if (n < 0) {
+                        if (EINTR == errno)
+                                continue;
+                        return -1;
+                }
+                while (count > 0 && (size_t)n >= iov->iov_len) {
+                        n -= iov->iov_len;
+                        iov++;
+                        count--;
+                }
+                if (count > 0) {
+                        iov->iov_base = (char *)iov->iov_base + n;
+                        iov->iov_len -= n;
+                }
+        }
+        return 0;
+}
+
+/*
+ * Queues bytes for the clip being written, running on from the last ones
+ * where they can; the queue is written out when it fills. A video-only clip
+ * is no more than the header, two runs of chunks (the ring wraps once) and
+ * the index, so it still goes in a single writev().
+ */
+static void clip_emit(const void *base, size_t length)
+{
+        if (clip_failed || 0 == length)
+                return;
+        if (clip_iovs) {
+                struct iovec *last = &clip_iov[clip_iovs - 1];
+
+                if ((const char *)last->iov_base + last->iov_len == (const char *)base) {
+                        last->iov_len += length;
+                        return;
+                }
+        }
+        if (CLIP_IOV_BATCH == clip_iovs) {
+                if (-1 == writev_all(clip_out, clip_iov, clip_iovs))
+                        clip_failed = 1;
+                clip_iovs = 0;
+        }
+        clip_iov[clip_iovs].iov_base = (void *)base;
+        clip_iov[clip_iovs].iov_len = length;
+        clip_iovs++;
+}
+
+/* The '01wb' chunk after frame i: the ring where it has the sound, silence where it doesn't. */
+static void clip_emit_audio(const struct clip_arena *a, const struct clip_sound *s, unsigned int i)
+{
+        unsigned char *chunk = clip_audio_chunks[i];
+        const int64_t held = a->audio_count;
+        int64_t from, to, n;
+
+        clip_audio_range(a, s, i, &from, &to);
+        put_le32(put_fourcc(chunk, "01wb"), 2 * (to - from));
+        clip_emit(chunk, 8);
+        for (; from < to; from += n) {
+                if (from < 0 || from >= held) {
+                        n = (from < 0 && to > 0 ? 0 : to) - from;
+                        if (n > CLIP_SILENCE_SAMPLES)
+                                n = CLIP_SILENCE_SAMPLES;
+                        clip_emit(clip_silence, 2 * n);
+                } else {
+                        uint32_t at = (a->audio_first + from) % CLIP_AUDIO_SAMPLES;
+
+                        n = (to < held ? to : held) - from;
+                        if (n > CLIP_AUDIO_SAMPLES - at)
+                                n = CLIP_AUDIO_SAMPLES - at;
+                        clip_emit(a->audio + at, 2 * n);
+                }
+        }
+}
+
+static void write_clip(const struct clip_arena *a)
+{
+        char path[PATH_MAX], stamp[32];
+        struct clip_sound sound;
+        uint32_t us_per_frame, header_size, movi_bytes = 0;
+        unsigned int i;
+
+        if (0 == a->count)
+                return;
+        us_per_frame = clip_us_per_frame(a);
+        clip_sound(a, us_per_frame, &sound);
+        for (i = 0; i < a->count; i++) {
+                const struct clip_frame *f = &a->frames[(a->first + i) % CLIP_MAX_FRAMES];
+
+                movi_bytes += 8 + f->size + (f->size & 1);
+                if (sound.rate) {
+                        int64_t from, to;
+
+                        clip_audio_range(a, &sound, i, &from, &to);
+                        movi_bytes += 8 + 2 * (to - from);
+                }
+        }
+        header_size = build_avi(a, us_per_frame, &sound, movi_bytes);
+
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&a->feed_time));
+        snprintf(path, sizeof(path), "%s/feed-%s.avi", clip_dir, stamp);
+        clip_out = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        clip_iovs = 0;
+        clip_failed = -1 == clip_out;
+        clip_emit(avi_header, header_size);
+        for (i = 0; i < a->count; i++) {
+                const struct clip_frame *f = &a->frames[(a->first + i) % CLIP_MAX_FRAMES];
+
+                clip_emit(a->data + f->offset, 8 + f->size + (f->size & 1));
+                if (sound.rate)
+                        clip_emit_audio(a, &sound, i);
+        }
+        clip_emit(avi_index, 8 + 16 * (sound.rate ? 2 * a->count : a->count));
+        if (!clip_failed && -1 == writev_all(clip_out, clip_iov, clip_iovs))
+                clip_failed = 1;
+
+        if (clip_failed) {
+                fprintf(stderr, "Cannot write clip '%s': %d, %s\n",
+                        path, errno, strerror(errno));
+        } else if (sound.rate) {
+                fprintf(stderr, "Saved %u frames and %u Hz audio to %s\n",
+                        a->count, sound.rate, path);
+        } else {
+                fprintf(stderr, "Saved %u frames to %s\n", a->count, path);
+        }
+        if (-1 != clip_out)
+                close(clip_out);
+}
+
+static void *run_clip_writer(void *arg)
+{
+        (void)arg;
+        pthread_mutex_lock(&clip_lock);
+        for (;;) {
+                struct clip_arena *a;
+
+                while (!clip_pending && !clip_writer_stop)
+                        pthread_cond_wait(&clip_ready, &clip_lock);
+                if (!clip_pending)
+                        break;
+                a = clip_pending;
+                pthread_mutex_unlock(&clip_lock);
+
+                write_clip(a);
+
+                pthread_mutex_lock(&clip_lock);
+                clip_pending = NULL;
+        }
+        pthread_mutex_unlock(&clip_lock);
+        return NULL;
+}
+
+/* Hands the recording to the writer and starts over in the other arena. */
+static void clip_finish(void)
+{
+        struct clip_arena *a = recording;
+
+        clip_recording = 0;
+        pthread_mutex_lock(&clip_lock);
+        if (clip_pending) {
+                clips_dropped++;
+        } else {
+                clip_pending = a;
+                recording = a == &arenas[0] ? &arenas[1] : &arenas[0];
+                pthread_cond_signal(&clip_ready);
+        }
+        pthread_mutex_unlock(&clip_lock);
+        recording->first = 0;
+        recording->count = 0;
+        recording->tail = 0;
+        recording->audio_count = 0;
+}
+
+/* Appends n samples to the ring, or n of silence if pcm is NULL, evicting the oldest. */
+static void clip_audio_put(struct clip_arena *a, const int16_t *pcm, uint32_t n)
+{
+        while (n > 0) {
+                uint32_t at = (a->audio_first + a->audio_count) % CLIP_AUDIO_SAMPLES;
+                uint32_t run = CLIP_AUDIO_SAMPLES - at;
+
+                if (run > n)
+                        run = n;
+                if (pcm) {
+                        memcpy(a->audio + at, pcm, run * sizeof(*pcm));
+                        pcm += run;
+                } else {
+                        memset(a->audio + at, 0, run * sizeof(*a->audio));
+                }
+                a->audio_count += run;
+                if (a->audio_count > CLIP_AUDIO_SAMPLES) {
+                        uint32_t over = a->audio_count - CLIP_AUDIO_SAMPLES;
+
+                        a->audio_first = (a->audio_first + over) % CLIP_AUDIO_SAMPLES;
+                        a->audio_count = CLIP_AUDIO_SAMPLES;
+                        a->audio_dropped += over;
+                }
+                n -= run;
+        }
+}
+
+static void clip_audio_restart(struct clip_arena *a, uint32_t rate, uint64_t start_us)
+{
+        a->audio_first = 0;
+        a->audio_count = 0;
+        a->audio_rate = rate;
+        a->audio_origin_us = start_us;
+        a->audio_dropped = 0;
+}
+
+/*
+ * Takes every audio frame the microphone has sent since the last video
+ * frame. The ring counts samples rather than trusting each stamp, which
+ * jitters with the daemon's scheduling; only a frame that starts well after
+ * the last one ended, having lost some in between, is placed by its stamp.
+ */
+static void clip_take_audio(struct clip_arena *a)
+{
+        const struct clip_audio_header *h = &clip_audio_in.header;
+        ssize_t n;
+
+        if (clip_audio_socket < 0)
+                return;
+        while ((n = recv(clip_audio_socket, clip_audio_in.bytes, sizeof(clip_audio_in.bytes), 0)) >= 0) {
+                uint64_t end_us;
+
+                if ((size_t)n < sizeof(*h) || CLIP_AUDIO_MAGIC != h->magic ||
+                    0 == h->sample_rate || h->sample_rate > CLIP_AUDIO_MAX_RATE)
+                        continue;
+                if (h->sample_rate != a->audio_rate || 0 == a->audio_count)
+                        clip_audio_restart(a, h->sample_rate, h->start_us);
+                end_us = a->audio_origin_us +
+                         (a->audio_dropped + a->audio_count) * 1000000 / a->audio_rate;
+                if (h->start_us > end_us + CLIP_AUDIO_SLACK_US) {
+                        uint64_t gap = (h->start_us - end_us) * a->audio_rate / 1000000;
+
+                        if (gap > CLIP_AUDIO_SAMPLES)
+                                clip_audio_restart(a, h->sample_rate, h->start_us);
+                        else
+                                clip_audio_put(a, NULL, gap);
+                }
+                clip_audio_put(a, (const int16_t *)(clip_audio_in.bytes + sizeof(*h)),
+                               (n - sizeof(*h)) / 2);
+        }
+}
+
+static void clip_add(const void *p, int size, int fed, uint32_t captured_ms)
+{
+        struct clip_arena *a = recording;
+        uint32_t now = monotonic_ms();
+        uint32_t need = 8 + size + (size & 1);
+        struct clip_frame *f;
+        uint32_t at;
+
+        if (fed) {
+                if (!clip_recording)
+                        a->feed_time = time(NULL);
+                clip_recording = 1;
+                clip_end_ms = now + CLIP_POST_MS;
+        }
+        clip_take_audio(a);
+        if (need > CLIP_ARENA_BYTES)
+                return;
+
+        /* between feeds only the pre-roll is kept */
+        while (!clip_recording && a->count &&
+               (int32_t)(now - a->frames[a->first].ms) > CLIP_PRE_MS)
+                clip_evict(a);
+        if (CLIP_MAX_FRAMES == a->count)
+                clip_evict(a);
+        at = clip_make_room(a, need);
+
+        put_le32(put_fourcc(a->data + at, "00dc"), size);
+        memcpy(a->data + at + 8, p, size);
+        if (size & 1)
+                a->data[at + 8 + size] = 0;
+        f = &a->frames[(a->first + a->count) % CLIP_MAX_FRAMES];
+        f->offset = at;
+        f->size = size;
+        f->ms = captured_ms;
+        a->count++;
+        a->tail = at + need;
+
+        if (clip_recording && (int32_t)(now - clip_end_ms) >= 0)
+                clip_finish();
+}
+
+static void start_clips(void)
+{
+        int i;
+
+        struct sockaddr_un addr;
+
+        for (i = 0; i < 2; i++) {
+                arenas[i].data = malloc(CLIP_ARENA_BYTES);
+                arenas[i].audio = malloc(CLIP_AUDIO_SAMPLES * sizeof(*arenas[i].audio));
+                if (!arenas[i].data || !arenas[i].audio)
+                        errno_exit("malloc");
+        }
+        if (pthread_create(&clip_writer, NULL, run_clip_writer, NULL))
+                errno_exit("pthread_create");
+
+        clip_audio_socket = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (-1 == clip_audio_socket)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, CLIP_AUDIO_PATH, sizeof(addr.sun_path) - 1);
+        unlink(CLIP_AUDIO_PATH);        /* left over from an earlier run */
+        if (-1 == bind(clip_audio_socket, (struct sockaddr *)&addr, sizeof(addr)))
+                errno_exit(CLIP_AUDIO_PATH);
+}
+
+/* Saves a clip still being recorded, then waits for the writer. */
+static void stop_clips(void)
+{
+        int i;
+
+        if (clip_recording)
+                clip_finish();
+        close(clip_audio_socket);
+        clip_audio_socket = -1;
+        unlink(CLIP_AUDIO_PATH);
+        pthread_mutex_lock(&clip_lock);
+        clip_writer_stop = 1;
+        pthread_cond_signal(&clip_ready);
+        pthread_mutex_unlock(&clip_lock);
+        pthread_join(clip_writer, NULL);
+
+        if (clips_dropped)
+                fprintf(stderr, "%lu clips dropped while another was being written\n",
+                        clips_dropped);
+        for (i = 0; i < 2; i++) {
+                free(arenas[i].data);
+                free(arenas[i].audio);
+                arenas[i].data = NULL;
+                arenas[i].audio = NULL;
+        }
+}
+
+/*
+ * Time-lapse (--timelapse dir): one frame every --lapse-every seconds from
+ * each stream is appended to that day's MJPEG AVI as it comes, so frames are
+ * never held in memory. The idx1 entries go into an index allocated for a
+ * whole day up front; at local midnight the file is handed, with its index,
+ * to a low-priority thread, which writes the index and the final header and
+ * renames it from .part to .avi. Capture carries on in a new file.
+ */
+#define LAPSE_PLAYBACK_FPS 25
+#define LAPSE_MAX_BYTES (1u << 30)      /* the RIFF sizes are 32 bits; players like it small */
+
+struct lapse {
+        int fd;                 /* -1: free */
+        char path[PATH_MAX];    /* being written, ".part" */
+        unsigned char *index;   /* idx1 header and entries */
+        unsigned int count, capacity;
+        uint32_t movi_bytes, largest;
+        unsigned int w, h;
+        int day;                /* local yyyymmdd */
+        int full;
+};
+
+static const char *lapse_dir;
+static unsigned int lapse_interval = 60;
+static struct lapse lapses[MAX_STREAMS][2];
+static struct lapse *lapse_current[MAX_STREAMS];
+static uint32_t lapse_last_ms[MAX_STREAMS];
+static int lapse_kept[MAX_STREAMS];
+
+/* owned by the finisher while set */
+static struct lapse *lapse_pending[MAX_STREAMS];
+static int lapse_finisher_stop;
+static pthread_mutex_t lapse_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lapse_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t lapse_finisher;
+
+static int local_day(time_t t)
+{
+        struct tm tm;
+
+        localtime_r(&t, &tm);
+        return (tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday;
+}
+
+/* Starts the day's file with a header that says it is empty. */
+static int lapse_open(struct lapse *l, unsigned int stream, time_t now)
+{
+        unsigned char header[AVI_HEADER_SIZE];
+        char stamp[32];
+        struct tm tm;
+
+        localtime_r(&now, &tm);
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+        snprintf(l->path, sizeof(l->path), "%s/lapse-%u-%s.avi.part", lapse_dir, stream, stamp);
+        l->fd = open(l->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (-1 == l->fd) {
+                fprintf(stderr, "Cannot create '%s': %d, %s\n", l->path, errno, strerror(errno));
+                return -1;
+        }
+        put_avi_header(header, 0, 1000000 / LAPSE_PLAYBACK_FPS, 0, width, height, 0, 0, 0);
+        if (write(l->fd, header, sizeof(header)) != sizeof(header)) {
+                fprintf(stderr, "Cannot write '%s': %d, %s\n", l->path, errno, strerror(errno));
+                close(l->fd);
+                l->fd = -1;
+                return -1;
+        }
+        l->count = 0;
+        l->movi_bytes = 0;
+        l->largest = 0;
+        l->w = width;
+        l->h = height;
+        l->day = local_day(now);
+        l->full = 0;
+        return 0;
+}
+
+/* Writes the index and the real header, and gives the file its name. */
+static void lapse_finish(struct lapse *l)
+{
+        unsigned char header[AVI_HEADER_SIZE];
+        char path[PATH_MAX];
+        size_t index_bytes = 8 + 16 * (size_t)l->count;
+
+        put_le32(put_fourcc(l->index, "idx1"), 16 * l->count);
+        put_avi_header(header, l->count, 1000000 / LAPSE_PLAYBACK_FPS, l->largest, l->w, l->h,
+                       l->movi_bytes, 0, 0);
+        snprintf(path, sizeof(path), "%.*s", (int)(strlen(l->path) - strlen(".part")), l->path);
+        if (write(l->fd, l->index, index_bytes) != (ssize_t)index_bytes ||
+            pwrite(l->fd, header, sizeof(header), 0) != sizeof(header) ||
+            -1 == fdatasync(l->fd) || -1 == rename(l->path, path))
+                fprintf(stderr, "Cannot finish '%s': %d, %s\n", l->path, errno, strerror(errno));
+        else
+                fprintf(stderr, "Saved a %u frame time-lapse to %s\n", l->count, path);
+        close(l->fd);
+        l->fd = -1;
+}
+
+static void *run_lapse_finisher(void *arg)
+{
+        unsigned int s;
+
+        (void)arg;
+        /* nice applies to the calling thread alone on Linux */
+        setpriority(PRIO_PROCESS, 0, 19);
+        pthread_mutex_lock(&lapse_lock);
+        for (;;) {
+                struct lapse *l = NULL;
+
+                for (s = 0; s < MAX_STREAMS && !l; s++)
+                        l = lapse_pending[s];
+                if (!l) {
+                        if (lapse_finisher_stop)
+                                break;
+                        pthread_cond_wait(&lapse_ready, &lapse_lock);
+                        continue;
+                }
+                pthread_mutex_unlock(&lapse_lock);
+
+                lapse_finish(l);
+
+                pthread_mutex_lock(&lapse_lock);
+                lapse_pending[s - 1] = NULL;
+        }
+        pthread_mutex_unlock(&lapse_lock);
+        return NULL;
+}
+
+/* Hands the day's file to the finisher, if it is done with yesterday's. */
+static void lapse_next_day(unsigned int stream)
+{
+        struct lapse *l = lapse_current[stream];
+        struct lapse *other = l == &lapses[stream][0] ? &lapses[stream][1] : &lapses[stream][0];
+
+        pthread_mutex_lock(&lapse_lock);
+        if (!lapse_pending[stream] && -1 == other->fd) {
+                lapse_pending[stream] = l;
+                lapse_current[stream] = other;
+                pthread_cond_signal(&lapse_ready);
+        }
+        pthread_mutex_unlock(&lapse_lock);
+}
+
+static void lapse_add(unsigned int stream, const void *p, int size)
+{
+        struct lapse *l = lapse_current[stream];
+        uint32_t now = monotonic_ms();
+        uint32_t need = 8 + size + (size & 1);
+        unsigned char chunk_header[8], pad = 0;
+        struct iovec iov[3];
+        time_t t;
+
+        if (lapse_kept[stream] && now - lapse_last_ms[stream] < lapse_interval * 1000)
+                return;
+        lapse_kept[stream] = 1;
+        lapse_last_ms[stream] = now;
+        t = time(NULL);
+        if (-1 != l->fd && local_day(t) != l->day) {
+                lapse_next_day(stream);
+                l = lapse_current[stream];
+        }
+        if (-1 == l->fd && -1 == lapse_open(l, stream, t))
+                return;
+        if (l->count == l->capacity || l->movi_bytes + need > LAPSE_MAX_BYTES) {
+                if (!l->full)
+                        fprintf(stderr, "%s is full until midnight\n", l->path);
+                l->full = 1;
+                return;
+        }
+
+        if (0 == l->count) {
+                struct jpeg_info info;
+
+                if (0 == parse_jpeg(p, size, &info)) {
+                        l->w = info.width;
+                        l->h = info.height;
+                }
+        }
+        put_le32(put_fourcc(chunk_header, "00dc"), size);
+        iov[0].iov_base = chunk_header;
+        iov[0].iov_len = sizeof(chunk_header);
+        iov[1].iov_base = (void *)p;
+        iov[1].iov_len = size;
+        iov[2].iov_base = &pad;
+        iov[2].iov_len = size & 1;
+        if (-1 == writev_all(l->fd, iov, 3)) {
+                /* the file ends in a torn chunk now; it stays a .part */
+                fprintf(stderr, "Cannot write '%s': %d, %s\n", l->path, errno, strerror(errno));
+                close(l->fd);
+                l->fd = -1;
+                return;
+        }
+        /* idx1 offsets count from the 'movi' fourcc */
+        put_le32(put_le32(put_le32(put_fourcc(l->index + 8 + 16 * l->count, "00dc"),
+                                   AVIIF_KEYFRAME), 4 + l->movi_bytes), size);
+        l->count++;
+        l->movi_bytes += need;
+        if ((uint32_t)size > l->largest)
+                l->largest = size;
+}
+
+static void start_lapses(unsigned int streams)
+{
+        unsigned int s, i;
+
+        for (s = 0; s < streams; s++) {
+                for (i = 0; i < 2; i++) {
+                        struct lapse *l = &lapses[s][i];
+
+                        l->fd = -1;
+                        l->capacity = 24 * 60 * 60 / lapse_interval + 1;
+                        l->index = malloc(8 + 16 * (size_t)l->capacity);
+                        if (!l->index)
+                                errno_exit("malloc");
+                }
+                lapse_current[s] = &lapses[s][0];
+        }
+        if (pthread_create(&lapse_finisher, NULL, run_lapse_finisher, NULL))
+                errno_exit("pthread_create");
+}
+
+/* Lets the finisher catch up, then finishes today's files as they are. */
+static void stop_lapses(unsigned int streams)
+{
+        unsigned int s, i;
+
+        pthread_mutex_lock(&lapse_lock);
+        lapse_finisher_stop = 1;
+        pthread_cond_signal(&lapse_ready);
+        pthread_mutex_unlock(&lapse_lock);
+        pthread_join(lapse_finisher, NULL);
+
+        for (s = 0; s < streams; s++) {
+                if (-1 != lapse_current[s]->fd)
+                        lapse_finish(lapse_current[s]);
+                for (i = 0; i < 2; i++)
+                        free(lapses[s][i].index);
+        }
+}
+
+/*
+ * Archive (--archive dir): up to --archive-fps frames a second of each
+ * stream go to dir/stream-N, a rolling archive (video_archive.c) of
+ * --archive-gb gigabytes, for the relay to play back from. At one 60 kB
+ * frame a second the default keeps about three days. The index has room for
+ * a week of frames at the chosen rate, so the disk always runs out first.
+ */
+#define ARCHIVE_MAX_FPS 30
+#define ARCHIVE_INDEX_HOURS (7 * 24)
+
+static const char *archive_dir;
+static unsigned int archive_gb = 16;
+static unsigned int archive_fps = 1;
+static struct video_archive archives[MAX_STREAMS];
+static uint32_t archive_last_ms[MAX_STREAMS];
+static int archive_kept[MAX_STREAMS];
+
+static void archive_add(unsigned int stream, const void *p, int size)
+{
+        uint32_t now = monotonic_ms();
+        struct timespec t;
+
+        if (archive_kept[stream] && now - archive_last_ms[stream] < 1000 / archive_fps)
+                return;
+        archive_kept[stream] = 1;
+        archive_last_ms[stream] = now;
+        clock_gettime(CLOCK_REALTIME, &t);
+        video_archive_add(&archives[stream], p, size, (int64_t)t.tv_sec * 1000 + t.tv_nsec / 1000000);
+}
+
+static void start_archives(unsigned int streams)
+{
+        char dir[PATH_MAX];
+        unsigned int s;
+
+        for (s = 0; s < streams; s++) {
+                snprintf(dir, sizeof(dir), "%s/stream-%u", archive_dir, s);
+                if (-1 == video_archive_open(&archives[s], dir, archive_gb * (1024u / (ARCHIVE_SEGMENT_BYTES >> 20)),
+                                             archive_fps * ARCHIVE_INDEX_HOURS * 3600))
+                        exit(EXIT_FAILURE);
+        }
+}
+
+static void stop_archives(unsigned int streams)
+{
+        unsigned int s;
+
+        for (s = 0; s < streams; s++)
+                video_archive_close(&archives[s]);
+}
+
+/*
+ * Snapshots (--snapshot): a reference to the newest frame is kept, and every
+ * connection to SNAPSHOT_PATH gets those JPEG bytes, followed by end of
+ * file. Capture swaps in a new frame each time; a client being served holds
+ * its own reference, so it never sees a buffer being refilled and never
+ * holds up capture.
+ */
+#define SNAPSHOT_PATH "/tmp/fishfeeder-snapshot.sock"
+#define SNAPSHOT_TIMEOUT_S 2
+
+static int snapshots;
+static int snapshot_socket = -1;
+static struct pool_frame *snapshot_latest;
+static pthread_mutex_t snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t snapshot_server;
+
+/* Takes over a reference to frame; NULL is ignored. */
+static void snapshot_publish(struct pool_frame *frame)
+{
+        struct pool_frame *old;
+
+        if (!frame)
+                return;
+        pthread_mutex_lock(&snapshot_lock);
+        old = snapshot_latest;
+        snapshot_latest = frame;
+        pthread_mutex_unlock(&snapshot_lock);
+        frame_release(old);
+}
+
+static void serve_snapshot(int client)
+{
+        struct timeval timeout = { SNAPSHOT_TIMEOUT_S, 0 };
+        struct pool_frame *snap;
+        int sent = 0;
+
+        /* held under the lock, so the frame can't be released in between */
+        pthread_mutex_lock(&snapshot_lock);
+        snap = snapshot_latest;
+        if (snap)
+                frame_hold(snap);
+        pthread_mutex_unlock(&snapshot_lock);
+
+        /* a stuck client only delays the next one */
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        while (snap && sent < snap->size) {
+                ssize_t n = send(client, snap->data + sent, snap->size - sent, MSG_NOSIGNAL);
+
+                if (n < 0) {
+                        if (EINTR == errno)
+                                continue;
+                        break;
+                }
+                sent += n;
+        }
+        frame_release(snap);
+        close(client);
+}
+
+static void *run_snapshot_server(void *arg)
+{
+        (void)arg;
+        for (;;) {
+                int client = accept4(snapshot_socket, NULL, NULL, SOCK_CLOEXEC);
+
+                if (-1 == client) {
+                        if (EINTR == errno || ECONNABORTED == errno)
+                                continue;
+                        break;          /* the socket was shut down */
+                }
+                serve_snapshot(client);
+        }
+        return NULL;
+}
+
+static void start_snapshots(void)
+{
+        struct sockaddr_un addr;
+
+        snapshot_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (-1 == snapshot_socket)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, SNAPSHOT_PATH, sizeof(addr.sun_path) - 1);
+        unlink(SNAPSHOT_PATH);
+        if (-1 == bind(snapshot_socket, (struct sockaddr *)&addr, sizeof(addr)) ||
+            -1 == listen(snapshot_socket, 4))
+                errno_exit(SNAPSHOT_PATH);
+        if (pthread_create(&snapshot_server, NULL, run_snapshot_server, NULL))
+                errno_exit("pthread_create");
+}
+
+static void stop_snapshots(void)
+{
+        /* wakes the blocked accept() */
+        shutdown(snapshot_socket, SHUT_RDWR);
+        pthread_join(snapshot_server, NULL);
+        close(snapshot_socket);
+        snapshot_socket = -1;
+        unlink(SNAPSHOT_PATH);
+
+        frame_release(snapshot_latest);
+        snapshot_latest = NULL;
+}
+
+/* the frame each stream's read_frame() has just dequeued */
+static struct frame_stamp frame_stamps[MAX_STREAMS];
+
+/*
+ * A reference to the frame for a consumer that keeps it past process_image():
+ * the USERPTR buffer itself, or else a pool copy, made for the first consumer
+ * that asks and shared by the rest. NULL if there is no memory for one.
+ */
+static struct pool_frame *keep_frame(unsigned int stream, const void *p, int size,
+                                     struct pool_frame **frame, struct pool_frame **copy)
+{
+        if (!*frame) {
+                struct pool_frame *f = frame_pool_get(devices[stream].pool);
+
+                if (!f) {
+                        fprintf(stderr, "Out of memory\n");
+                        return NULL;
+                }
+                if ((size_t)size > f->capacity) {
+                        frame_release(f);
+                        return NULL;
+                }
+                memcpy(f->data, p, size);
+                f->size = size;
+                *frame = *copy = f;
+        }
+        frame_hold(*frame);
+        return *frame;
+}
+
+/*
+ * UVC cameras now and then hand over a frame cut short: the transfer lost
+ * a packet, or bytesused stops before the end. Such a frame is dropped here
+ * rather than sent, clipped and archived, and decoded by every viewer into
+ * a smeared picture. The check is cheap: the headers up to the start of
+ * scan are walked, which is a few hundred bytes, and EOI is looked for only
+ * among the last JPEG_EOI_SCAN bytes, after any zero padding the driver
+ * left, never through the scan data itself.
+ */
+#define JPEG_EOI_SCAN 64
+
+static unsigned long frames_truncated;
+
+static int jpeg_intact(const unsigned char *data, int size)
+{
+        int i = 2, end = size, stop;
+
+        if (size < 4 || data[0] != 0xff || data[1] != 0xd8)
+                return 0;
+
+        while (end > 0 && data[end - 1] == 0)
+                end--;
+        stop = end > JPEG_EOI_SCAN ? end - JPEG_EOI_SCAN : 2;
+        while (end - 2 >= stop && !(data[end - 2] == 0xff && data[end - 1] == 0xd9))
+                end--;
+        if (end - 2 < stop)
+                return 0;
+
+        while (i + 4 <= end - 2) {
+                int length;
+
+                if (data[i] != 0xff)
+                        return 0;
+                if (data[i + 1] == 0xff) {      /* fill byte */
+                        i++;
+                        continue;
+                }
+                length = read_be16(data + i + 2);
+                if (length < 2 || i + 2 + length > end - 2)
+                        return 0;
+                if (data[i + 1] == 0xda)        /* SOS: scan data follows, up to EOI */
+                        return i + 2 + length < end - 2;
+                i += 2 + length;
+        }
+        return 0;
+}
+
+/* frame is the pool frame p is in, with USERPTR, or NULL */
+static void process_image(unsigned int stream, const void *p, int size, struct pool_frame *frame)
+{
+struct pool_frame *copy = NULL;
+int64_t feed_time_us;
+int fed;
+const struct frame_stamp *stamp = &frame_stamps[stream];
+struct pellet_result pellet_result;
+
+if (force_format && V4L2_PIX_FMT_MJPEG == pixelformat && !jpeg_intact(p, size)) {
+        if (!frames_truncated++)
+                fprintf(stderr, "%s: truncated MJPEG frame dropped\n", devices[stream].name);
+        return;
+}
+
+fed = take_feed_event(&feed_time_us);
+if (pellets) {
+        uint32_t now = monotonic_ms();
+
+        if (fed)
+                pellet_watch_feed(now, feed_time_us);
+        if (pellet_watch_frame(now, p, size, &pellet_result))
+                report_consumption(&pellet_result);
+}
+
+if ((motion_threshold >= 0 || activity_file) && thermal_level < 2)
+        measure_activity(p, size);
+if (snapshots)
+        snapshot_publish(keep_frame(stream, p, size, &frame, &copy));
+if (clip_dir)
+        clip_add(p, size, fed, stamp->captured_ms);
+if (lapse_dir && thermal_level < 1)
+        lapse_add(stream, p, size);
+if (archive_dir)
+        archive_add(stream, p, size);
+if (thumbnail_fps && out_buf && thermal_level < 3)
+        send_thumbnail(stream, p, size, stamp);
+if (out_buf && (motion_threshold < 0 || motion_gate(fed)) &&
+    (thermal_level < 4 || !(thermal_frames[stream]++ & 1))) {
+if (latest_frame)
+mailbox_put(stream, keep_frame(stream, p, size, &frame, &copy), stamp);
+else
+send_frame(stream, p, size, stamp);
+}
+frame_release(copy);
+fflush(stderr);
+}
+
+/*
+ * Zero-copy transmit (--zerocopy, mmap only): frames are sent straight out
+ * of the capture buffer with MSG_ZEROCOPY, and the buffer goes back to the
+ * driver only when the socket's error queue reports that the kernel is done
+ * with every datagram of it. More buffers are requested so capture can go on
+ * while some are in flight.
+ */
+#define ZEROCOPY_BUFFERS 8
+#define ZEROCOPY_MAX_PACKETS 512
+
+struct in_flight {
+        int busy;
+        uint32_t first_id;      /* completion ids [first_id, end_id) */
+        uint32_t end_id;
+        uint32_t completed;
+        unsigned char headers[ZEROCOPY_MAX_PACKETS][BATCH_HEADER_SIZE];
+};
+
+static int zerocopy;
+static int zerocopy_requeue = 1;        /* cleared once streaming stops */
+static int on_demand;                   /* --on-demand: the socket also carries viewer counts */
+static int adapt;                       /* --adapt: and link reports */
+static int yield_cpu;                   /* --yield-cpu: and the feeder's CPU reports, from this board */
+static unsigned int n_profiles;         /* --profiles: and picks of a profile */
+
+static void enable_zerocopy(void)
+{
+        int one = 1;
+
+        if (-1 == setsockopt(socketDescriptorT, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one))) {
+                fprintf(stderr, "SO_ZEROCOPY not supported, copying frames\n");
+                zerocopy = 0;
+        }
+}
+
+static void watch_device(struct device *dev)
+{
+        struct epoll_event ev;
+
+        CLEAR(ev);
+        ev.events = EPOLLIN;
+        ev.data.u32 = dev->stream;
+        if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, dev->fd, &ev))
+                errno_exit("epoll_ctl");
+        dev->paused = 0;
+}
+
+/*
+ * With no buffer queued, a V4L2 device polls as an error, so it leaves the
+ * epoll set until one comes back.
+ */
+static void pause_device(struct device *dev)
+{
+        if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_DEL, dev->fd, NULL))
+                errno_exit("epoll_ctl");
+        dev->paused = 1;
+}
+
+/* Leaves the device to recover_stalled(), and returns 0. */
+static int device_failed(struct device *dev, const char *what)
+{
+        fprintf(stderr, "%s: %s error %d, %s\n", dev->name, what, errno, strerror(errno));
+        dev->failed = errno ? errno : EIO;
+        return 0;
+}
+
+static void requeue_buffer(struct device *dev, unsigned int index)
+{
+        struct v4l2_buffer buf;
+
+        if (!zerocopy_requeue)
+                return;
+        CLEAR(buf);
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = index;
+        if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf)) {
+                device_failed(dev, "VIDIOC_QBUF");
+                return;
+        }
+        if (dev->paused && (!frame_count || dev->frames < (unsigned int)frame_count))
+                watch_device(dev);
+}
+
+static unsigned int buffers_in_flight(const struct device *dev)
+{
+        unsigned int i, busy = 0;
+
+        for (i = 0; dev->in_flight && i < dev->n_buffers; i++)
+                busy += dev->in_flight[i].busy;
+        return busy;
+}
+
+/* [lo, hi] ids are complete: credit every buffer they overlap */
+static void complete_range(uint32_t lo, uint32_t hi)
+{
+        unsigned int d, i;
+
+        for (d = 0; d < n_devices; d++) {
+                struct device *dev = &devices[d];
+
+                for (i = 0; dev->in_flight && i < dev->n_buffers; i++) {
+                        struct in_flight *f = &dev->in_flight[i];
+                        uint32_t start, end;
+
+                        if (!f->busy)
+                                continue;
+                        /* signed differences, so the ids may wrap */
+                        start = (int32_t)(lo - f->first_id) > 0 ? lo : f->first_id;
+                        end = (int32_t)(hi + 1 - f->end_id) < 0 ? hi + 1 : f->end_id;
+                        if ((int32_t)(end - start) <= 0)
+                                continue;       /* no overlap */
+                        f->completed += end - start;
+                        if (f->completed == f->end_id - f->first_id) {
+                                f->busy = 0;
+                                requeue_buffer(dev, i);
+                        }
+                }
+        }
+}
+
+/* Drains the error queue without blocking, re-queueing finished buffers. */
+static void read_completions(void)
+{
+        for (;;) {
+                char control[128];
+                struct msghdr msg;
+                struct cmsghdr *cm;
+
+                CLEAR(msg);
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+                if (-1 == recvmsg(socketDescriptorT, &msg, MSG_ERRQUEUE | MSG_DONTWAIT))
+                        break;
+
+                for (cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+                        struct sock_extended_err *err;
+
+                        if (cm->cmsg_level != SOL_IP || cm->cmsg_type != IP_RECVERR)
+                                continue;
+                        err = (struct sock_extended_err *)CMSG_DATA(cm);
+                        if (err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+                                complete_range(err->ee_info, err->ee_data);
+                }
+        }
+        /* nothing else is expected on the socket; don't let it keep epoll awake */
+        while (!on_demand && !adapt && !n_profiles && recv(socketDescriptorT, NULL, 0, MSG_DONTWAIT) >= 0)
+                ;
+}
+
+static void send_zerocopy(struct device *dev, const struct v4l2_buffer *buf)
+{
+        struct in_flight *f = &dev->in_flight[buf->index];
+
+        header_store = f->headers;
+        header_store_size = ZEROCOPY_MAX_PACKETS;
+        header_used = 0;
+        send_flags = MSG_ZEROCOPY;
+        f->first_id = zerocopy_sent;
+
+        process_image(dev->stream, dev->buffers[buf->index].start, buf->bytesused, NULL);
+
+        f->end_id = zerocopy_sent;
+        f->completed = 0;
+        header_store = batch_headers;
+        header_store_size = BATCH_PACKETS;
+        header_used = 0;
+        send_flags = 0;
+
+        if (f->end_id == f->first_id) {
+                requeue_buffer(dev, buf->index);        /* nothing went out */
+        } else {
+                f->busy = 1;
+                if (buffers_in_flight(dev) == dev->n_buffers)
+                        pause_device(dev);
+        }
+        read_completions();
+}
+
+static unsigned int all_in_flight(void)
+{
+        unsigned int d, busy = 0;
+
+        for (d = 0; d < n_devices; d++)
+                busy += buffers_in_flight(&devices[d]);
+        return busy;
+}
+
+/* Waits (up to about a second) until the kernel has let go of every buffer. */
+static void drain_zerocopy(void)
+{
+        struct pollfd pfd = { .fd = socketDescriptorT, .events = 0 };
+        int tries = 10;
+
+        zerocopy_requeue = 0;
+        while (all_in_flight() > 0 && tries-- > 0) {
+                poll(&pfd, 1, 100);
+                read_completions();
+        }
+}
+
+/* buf is NULL for read() i/o, which has no timestamp or sequence to go by */
+static void stamp_frame(struct device *dev, const struct v4l2_buffer *buf)
+{
+        struct frame_stamp *stamp = &frame_stamps[dev->stream];
+
+        stamp->read_ms = monotonic_ms();
+        stamp->captured_ms = stamp->read_ms;
+        stamp->sequence = dev->frames;
+        if (!buf)
+                return;
+        stamp->sequence = buf->sequence;
+        if (V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC == (buf->flags & V4L2_BUF_FLAG_TIMESTAMP_MASK))
+                stamp->captured_ms = (uint32_t)(buf->timestamp.tv_sec * 1000 +
+                                                buf->timestamp.tv_usec / 1000);
+}
+
+/*
+ * DMABUF export (--dmabuf): the mmap buffers are also exported with
+ * VIDIOC_EXPBUF, for a hardware encoder or another process to read frames
+ * with no copy. A consumer connecting to DMABUF_PATH gets each device's
+ * buffers once, as a struct dmabuf_buffers with their fds (SCM_RIGHTS), then
+ * a struct dmabuf_frame per frame. That buffer is lent: it goes back to the
+ * driver only when the consumer sends the same struct dmabuf_frame back, so
+ * a consumer that keeps too many stalls capture, as --zerocopy's completions
+ * do. One consumer at a time; a device that is reopened drops it, and it
+ * connects again for the new buffers.
+ */
+#define DMABUF_PATH "/tmp/fishfeeder-dmabuf.sock"
+#define DMABUF_MAX_BUFFERS 32
+
+/* epoll tokens, after EPOLL_SOCKET */
+#define EPOLL_DMABUF_LISTEN (MAX_STREAMS + 1)
+#define EPOLL_DMABUF        (MAX_STREAMS + 2)
+
+struct dmabuf_buffers {
+        uint32_t stream;
+        uint32_t count;                 /* fds that come with it, by index */
+        uint32_t length;                /* bytes of each buffer */
+        uint32_t width;
+        uint32_t height;
+        uint32_t pixelformat;           /* fourcc */
+};
+
+struct dmabuf_frame {
+        uint32_t stream;
+        uint32_t index;
+        uint32_t size;                  /* bytes of the frame at the start of the buffer */
+        uint32_t sequence;
+        uint32_t captured_ms;           /* CLOCK_MONOTONIC */
+};
+
+static int dmabuf_socket = -1;
+static int dmabuf_consumer = -1;
+
+static void export_buffers(struct device *dev)
+{
+        unsigned int i;
+
+        if (dev->n_buffers > DMABUF_MAX_BUFFERS) {
+                fprintf(stderr, "--dmabuf takes at most %d buffers\n", DMABUF_MAX_BUFFERS);
+                exit(EXIT_FAILURE);
+        }
+        dev->lent = calloc(dev->n_buffers, sizeof(*dev->lent));
+        if (!dev->lent) {
+                fprintf(stderr, "Out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        for (i = 0; i < dev->n_buffers; i++) {
+                struct v4l2_exportbuffer exp;
+
+                CLEAR(exp);
+                exp.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                exp.index = i;
+                exp.flags = O_RDONLY | O_CLOEXEC;
+                if (-1 == xioctl(dev->fd, VIDIOC_EXPBUF, &exp)) {
+                        if (EINVAL == errno || ENOTTY == errno) {
+                                fprintf(stderr, "%s can't export dmabufs\n", dev->name);
+                                exit(EXIT_FAILURE);
+                        }
+                        errno_exit("VIDIOC_EXPBUF");
+                }
+                dev->buffers[i].dmabuf = exp.fd;
+        }
+}
+
+static unsigned int lent_buffers(const struct device *dev)
+{
+        unsigned int i, lent = 0;
+
+        for (i = 0; dev->lent && i < dev->n_buffers; i++)
+                lent += dev->lent[i];
+        return lent;
+}
+
+/* Hands every lent buffer back to its driver and closes the consumer. */
+static void drop_dmabuf_consumer(void)
+{
+        unsigned int d, i;
+
+        if (-1 == dmabuf_consumer)
+                return;
+        close(dmabuf_consumer);         /* which also takes it out of the epoll set */
+        dmabuf_consumer = -1;
+        for (d = 0; d < n_devices; d++) {
+                struct device *dev = &devices[d];
+
+                for (i = 0; dev->lent && i < dev->n_buffers; i++) {
+                        if (!dev->lent[i])
+                                continue;
+                        dev->lent[i] = 0;
+                        requeue_buffer(dev, i);
+                }
+        }
+        fprintf(stderr, "dmabuf consumer gone\n");
+}
+
+static int send_buffers(int fd, const struct device *dev)
+{
+        struct dmabuf_buffers msg = {
+                .stream = dev->stream, .count = dev->n_buffers, .length = dev->buffers[0].length,
+                .width = dev->format.width, .height = dev->format.height,
+                .pixelformat = dev->format.pixelformat,
+        };
+        char control[CMSG_SPACE(DMABUF_MAX_BUFFERS * sizeof(int))];
+        struct iovec iov = { &msg, sizeof(msg) };
+        struct msghdr mh;
+        struct cmsghdr *cm;
+        unsigned int i;
+
+        CLEAR(mh);
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control;
+        mh.msg_controllen = CMSG_SPACE(dev->n_buffers * sizeof(int));
+        cm = CMSG_FIRSTHDR(&mh);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type = SCM_RIGHTS;
+        cm->cmsg_len = CMSG_LEN(dev->n_buffers * sizeof(int));
+        for (i = 0; i < dev->n_buffers; i++)
+                memcpy(CMSG_DATA(cm) + i * sizeof(int), &dev->buffers[i].dmabuf, sizeof(int));
+        return sendmsg(fd, &mh, MSG_NOSIGNAL) == (ssize_t)sizeof(msg) ? 0 : -1;
+}
+
+static void accept_dmabuf_consumer(void)
+{
+        struct epoll_event ev;
+        unsigned int d;
+        int fd = accept4(dmabuf_socket, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (-1 == fd)
+                return;
+        if (-1 != dmabuf_consumer) {
+                close(fd);              /* busy */
+                return;
+        }
+        /* a fresh socket's buffer takes these few messages without blocking */
+        for (d = 0; d < n_devices; d++) {
+                if (-1 == send_buffers(fd, &devices[d])) {
+                        close(fd);
+                        return;
+                }
+        }
+        CLEAR(ev);
+        ev.events = EPOLLIN;
+        ev.data.u32 = EPOLL_DMABUF;
+        if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev))
+                errno_exit("epoll_ctl");
+        dmabuf_consumer = fd;
+        fprintf(stderr, "dmabuf consumer connected\n");
+}
+
+/* Re-queues the buffers the consumer is done with. */
+static void read_dmabuf_returns(void)
+{
+        for (;;) {
+                struct dmabuf_frame msg;
+                ssize_t n = recv(dmabuf_consumer, &msg, sizeof(msg), 0);
+                struct device *dev;
+
+                if (n < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno))
+                        return;
+                if (n != (ssize_t)sizeof(msg)) {
+                        drop_dmabuf_consumer();         /* hung up, or talking nonsense */
+                        return;
+                }
+                if (msg.stream >= n_devices)
+                        continue;
+                dev = &devices[msg.stream];
+                if (!dev->lent || msg.index >= dev->n_buffers || !dev->lent[msg.index])
+                        continue;
+                dev->lent[msg.index] = 0;
+                requeue_buffer(dev, msg.index);
+        }
+}
+
+/*
+ * Lends the buffer just processed to the consumer. Returns 0 if there is
+ * none, or it isn't keeping up, and the buffer should be re-queued now.
+ */
+static int lend_buffer(struct device *dev, const struct v4l2_buffer *buf)
+{
+        const struct frame_stamp *stamp = &frame_stamps[dev->stream];
+        struct dmabuf_frame msg = {
+                .stream = dev->stream, .index = buf->index, .size = buf->bytesused,
+                .sequence = stamp->sequence, .captured_ms = stamp->captured_ms,
+        };
+
+        if (-1 == dmabuf_consumer)
+                return 0;
+        if (send(dmabuf_consumer, &msg, sizeof(msg), MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t)sizeof(msg)) {
+                if (EAGAIN != errno && EWOULDBLOCK != errno)
+                        drop_dmabuf_consumer();
+                return 0;
+        }
+        dev->lent[buf->index] = 1;
+        if (!dev->paused && lent_buffers(dev) == dev->n_buffers)
+                pause_device(dev);
+        return 1;
+}
+
+static void start_dmabuf(void)
+{
+        struct sockaddr_un addr;
+
+        dmabuf_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (-1 == dmabuf_socket)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, DMABUF_PATH, sizeof(addr.sun_path) - 1);
+        unlink(DMABUF_PATH);
+        if (-1 == bind(dmabuf_socket, (struct sockaddr *)&addr, sizeof(addr)) ||
+            -1 == listen(dmabuf_socket, 1))
+                errno_exit(DMABUF_PATH);
+}
+
+/* Before capture stops: buffers still lent are simply not re-queued. */
+static void stop_dmabuf(void)
+{
+        if (-1 != dmabuf_consumer)
+                close(dmabuf_consumer);
+        dmabuf_consumer = -1;
+        close(dmabuf_socket);
+        dmabuf_socket = -1;
+        unlink(DMABUF_PATH);
+}
+
+static int read_frame(struct device *dev)
+{
+        struct v4l2_buffer buf;
+        struct pool_frame *frame;
+
+        switch (io) {
+        case IO_METHOD_READ:
+                if (-1 == read(dev->fd, dev->buffers[0].start, dev->buffers[0].length)) {
+                        switch (errno) {
+                        case EAGAIN:
+                                return 0;
+
+                        case EIO:
+                                /* Could ignore EIO, see spec. */
+
+                                /* fall through */
+
+                        default:
+                                return device_failed(dev, "read");
+                        }
+                }
+
+                stamp_frame(dev, NULL);
+                process_image(dev->stream, dev->buffers[0].start, dev->buffers[0].length, NULL);
+                break;
+
+        case IO_METHOD_MMAP:
+        case IO_METHOD_DMABUF:
+                CLEAR(buf);
+
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.memory = V4L2_MEMORY_MMAP;
+
+                if (-1 == xioctl(dev->fd, VIDIOC_DQBUF, &buf)) {
+                        switch (errno) {
+                        case EAGAIN:
+                                return 0;
+
+                        case EIO:
+                                /* Could ignore EIO, see spec. */
+
+                                /* fall through */
+
+                        default:
+                                /* a glitch or an unplug: the stall recovery takes it from here */
+                                return device_failed(dev, "VIDIOC_DQBUF");
+                        }
+                }
+
+                assert(buf.index < dev->n_buffers);
+                if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+                        /* corrupted on the way from the camera; nothing to send */
+                        if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
+                                return device_failed(dev, "VIDIOC_QBUF");
+                        return 0;
+                }
+                stamp_frame(dev, &buf);
+
+                if (zerocopy) {
+                        /* re-queued once the send completes */
+                        send_zerocopy(dev, &buf);
+                        break;
+                }
+
+                process_image(dev->stream, dev->buffers[buf.index].start, buf.bytesused, NULL);
+
+                /* re-queued once the consumer returns it */
+                if (IO_METHOD_DMABUF == io && lend_buffer(dev, &buf))
+                        break;
+
+                if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
+                        return device_failed(dev, "VIDIOC_QBUF");
+                break;
+
+        case IO_METHOD_USERPTR:
+                CLEAR(buf);
+
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.memory = V4L2_MEMORY_USERPTR;
+
+                if (-1 == xioctl(dev->fd, VIDIOC_DQBUF, &buf)) {
+                        switch (errno) {
+                        case EAGAIN:
+                                return 0;
+
+                        case EIO:
+                                /* Could ignore EIO, see spec. */
+
+                                /* fall through */
+
+                        default:
+                                /* a glitch or an unplug: the stall recovery takes it from here */
+                                return device_failed(dev, "VIDIOC_DQBUF");
+                        }
+                }
+
+                assert(buf.index < dev->n_buffers);
+                frame = dev->queued[buf.index];
+                assert(buf.m.userptr == (unsigned long)frame->data);
+                if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+                        if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
+                                return device_failed(dev, "VIDIOC_QBUF");
+                        return 0;
+                }
+                stamp_frame(dev, &buf);
+
+                frame->size = buf.bytesused;
+                process_image(dev->stream, frame->data, frame->size, frame);
+
+                /* whoever kept the frame has it now; the driver gets a free one */
+                frame_release(frame);
+                frame = frame_pool_get(dev->pool);
+                if (!frame) {
+                        fprintf(stderr, "Out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+                dev->queued[buf.index] = frame;
+                dev->buffers[buf.index].start = frame->data;
+                buf.m.userptr = (unsigned long)frame->data;
+                buf.length = frame->capacity;
+
+                if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
+                        return device_failed(dev, "VIDIOC_QBUF");
+                break;
+        }
+
+        return 1;
+}
+
+/*
+ * Camera control profiles (--profiles file): auto exposure chasing the tank
+ * lights' flicker makes JPEG sizes swing, and the bit rate with them. A
+ * profile pins exposure, gain, white balance and the power line frequency.
+ * Controls are set one at a time with VIDIOC_S_CTRL, in the order given, so
+ * an auto mode is off before the manual value it unlocks is set. The file
+ * has a profile per line, a name then name=value controls, and, after the
+ * profiles they name, "at HH:MM name" lines that switch by local time:
+ *
+ *      day   exposure_auto=1 exposure_absolute=250 white_balance_auto=0 power_line_frequency=1
+ *      night exposure_auto=3 white_balance_auto=1
+ *      at 08:00 day
+ *      at 21:30 night
+ *
+ * With no schedule the first profile applies. The relay can pick one by hand,
+ * "profile <name>" to the port frames are sent from (POST /camera/profile in
+ * index.js), which holds until the schedule's next switch. A device that is
+ * reopened gets the current profile again.
+ */
+#define PROFILE_MAX 8
+#define PROFILE_MAX_CONTROLS 16
+#define PROFILE_MAX_SWITCHES 16
+#define PROFILE_NAME_SIZE 32
+
+static const struct {
+        const char *name;
+        uint32_t id;
+} profile_controls[] = {
+        { "exposure_auto", V4L2_CID_EXPOSURE_AUTO },
+        { "exposure_absolute", V4L2_CID_EXPOSURE_ABSOLUTE },
+        { "exposure_auto_priority", V4L2_CID_EXPOSURE_AUTO_PRIORITY },
+        { "gain", V4L2_CID_GAIN },
+        { "autogain", V4L2_CID_AUTOGAIN },
+        { "white_balance_auto", V4L2_CID_AUTO_WHITE_BALANCE },
+        { "white_balance_temperature", V4L2_CID_WHITE_BALANCE_TEMPERATURE },
+        { "power_line_frequency", V4L2_CID_POWER_LINE_FREQUENCY },
+        { "backlight_compensation", V4L2_CID_BACKLIGHT_COMPENSATION },
+        { "brightness", V4L2_CID_BRIGHTNESS },
+};
+#define PROFILE_CONTROLS (sizeof(profile_controls) / sizeof(profile_controls[0]))
+
+struct profile {
+        char name[PROFILE_NAME_SIZE];
+        unsigned int n_controls;
+        struct {
+                unsigned int control;   /* in profile_controls */
+                int value;
+        } controls[PROFILE_MAX_CONTROLS];
+};
+
+struct profile_switch {
+        unsigned int minute;            /* of the day */
+        unsigned int profile;
+};
+
+static const char *profiles_file;
+static struct profile profiles[PROFILE_MAX];
+static struct profile_switch profile_switches[PROFILE_MAX_SWITCHES];
+static unsigned int n_profile_switches;
+static int current_profile = -1;
+static int last_switch = -1;            /* the schedule's, last acted on */
+
+static int find_profile(const char *name)
+{
+        unsigned int p;
+
+        for (p = 0; p < n_profiles; p++)
+                if (0 == strcmp(profiles[p].name, name))
+                        return (int)p;
+        return -1;
+}
+
+static void profile_error(const char *path, unsigned int line)
+{
+        fprintf(stderr, "%s:%u: not a profile or an \"at HH:MM profile\"\n", path, line);
+        exit(EXIT_FAILURE);
+}
+
+static int parse_profile_control(struct profile *profile, char *word)
+{
+        char *value = strchr(word, '=');
+        char *end;
+        unsigned int c;
+        long v;
+
+        if (!value || PROFILE_MAX_CONTROLS == profile->n_controls)
+                return -1;
+        *value++ = '\0';
+        for (c = 0; c < PROFILE_CONTROLS; c++)
+                if (0 == strcmp(profile_controls[c].name, word))
+                        break;
+        errno = 0;
+        v = strtol(value, &end, 0);
+        if (PROFILE_CONTROLS == c || errno || end == value || *end != '\0' || v < INT_MIN || v > INT_MAX)
+                return -1;
+        profile->controls[profile->n_controls].control = c;
+        profile->controls[profile->n_controls].value = (int)v;
+        profile->n_controls++;
+        return 0;
+}
+
+static void load_profiles(const char *path)
+{
+        FILE *f = fopen(path, "r");
+        char line[512];
+        unsigned int number = 0, i, j;
+
+        if (!f)
+                errno_exit(path);
+        while (fgets(line, sizeof(line), f)) {
+                char *save, *word = strtok_r(line, " \t\r\n", &save);
+                struct profile *profile;
+
+                number++;
+                if (!word || '#' == word[0])
+                        continue;
+                if (0 == strcmp(word, "at")) {
+                        char *time = strtok_r(NULL, " \t\r\n", &save);
+                        char *name = strtok_r(NULL, " \t\r\n", &save);
+                        unsigned int hours, minutes;
+                        int p = name ? find_profile(name) : -1;
+
+                        if (!time || 2 != sscanf(time, "%u:%u", &hours, &minutes) ||
+                            hours > 23 || minutes > 59 || p < 0 ||
+                            PROFILE_MAX_SWITCHES == n_profile_switches)
+                                profile_error(path, number);
+                        profile_switches[n_profile_switches].minute = hours * 60 + minutes;
+                        profile_switches[n_profile_switches].profile = (unsigned int)p;
+                        n_profile_switches++;
+                        continue;
+                }
+                if (PROFILE_MAX == n_profiles || strlen(word) >= PROFILE_NAME_SIZE || find_profile(word) >= 0)
+                        profile_error(path, number);
+                profile = &profiles[n_profiles++];
+                strcpy(profile->name, word);
+                while ((word = strtok_r(NULL, " \t\r\n", &save)))
+                        if (-1 == parse_profile_control(profile, word))
+                                profile_error(path, number);
+        }
+        fclose(f);
+        if (!n_profiles) {
+                fprintf(stderr, "%s has no profiles\n", path);
+                exit(EXIT_FAILURE);
+        }
+
+        /* in time of day order */
+        for (i = 1; i < n_profile_switches; i++) {
+                struct profile_switch s = profile_switches[i];
+
+                for (j = i; j > 0 && profile_switches[j - 1].minute > s.minute; j--)
+                        profile_switches[j] = profile_switches[j - 1];
+                profile_switches[j] = s;
+        }
+}
+
+/* Not fatal: a camera without one of the controls still takes the rest. */
+static void apply_profile_to(struct device *dev)
+{
+        const struct profile *profile = &profiles[current_profile];
+        unsigned int i;
+
+        for (i = 0; i < profile->n_controls; i++) {
+                struct v4l2_control control;
+
+                CLEAR(control);
+                control.id = profile_controls[profile->controls[i].control].id;
+                control.value = profile->controls[i].value;
+                if (-1 == xioctl(dev->fd, VIDIOC_S_CTRL, &control))
+                        fprintf(stderr, "%s: can't set %s to %d: %s\n", dev->name,
+                                profile_controls[profile->controls[i].control].name,
+                                control.value, strerror(errno));
+        }
+}
+
+static void apply_profile(unsigned int p)
+{
+        unsigned int d;
+
+        current_profile = (int)p;
+        fprintf(stderr, "camera profile %s\n", profiles[p].name);
+        for (d = 0; d < n_devices; d++)
+                if (-1 != devices[d].fd)
+                        apply_profile_to(&devices[d]);
+}
+
+/* Checked from the main loop; acts once a minute at most. */
+static void follow_profile_schedule(void)
+{
+        static time_t checked;
+        time_t now = time(NULL);
+        unsigned int minute, i;
+        struct tm tm;
+        int due;
+
+        if (!n_profile_switches || now / 60 == checked / 60)
+                return;
+        checked = now;
+        localtime_r(&now, &tm);
+        minute = tm.tm_hour * 60 + tm.tm_min;
+        /* the last switch at or before now, or else yesterday's last */
+        due = n_profile_switches - 1;
+        for (i = 0; i < n_profile_switches; i++)
+                if (profile_switches[i].minute <= minute)
+                        due = i;
+        if (due != last_switch) {
+                last_switch = due;
+                apply_profile(profile_switches[due].profile);
+        }
+}
+
+/* Before the devices are opened; init_device() applies the profile. */
+static void start_profiles(void)
+{
+        load_profiles(profiles_file);
+        current_profile = 0;
+        follow_profile_schedule();
+}
+
+/*
+ * On-demand capture (--on-demand): the relay (viewerHub.js) reports how many
+ * viewers it has, as "viewers N" datagrams to the port frames are sent from.
+ * With none, every device stops streaming, which spares the CPU, the USB bus
+ * and the camera; the first viewer starts them again straight away. Until a
+ * report comes, capture streams as usual.
+ */
+static int idle;
+
+static void stop_capturing(struct device *dev);
+static void start_capturing(struct device *dev);
+
+static void go_idle(void)
+{
+        unsigned int d, i;
+
+        if (zerocopy)
+                drain_zerocopy();
+        for (d = 0; d < n_devices; d++) {
+                struct device *dev = &devices[d];
+
+                if (!dev->paused)
+                        pause_device(dev);
+                stop_capturing(dev);
+                /* STREAMOFF took back every buffer, sent or not */
+                for (i = 0; dev->in_flight && i < dev->n_buffers; i++)
+                        dev->in_flight[i].busy = 0;
+        }
+        zerocopy_requeue = 1;
+        idle = 1;
+        fprintf(stderr, "no viewers, capture stopped\n");
+}
+
+static void resume_capture(void)
+{
+        unsigned int d;
+
+        for (d = 0; d < n_devices; d++) {
+                struct device *dev = &devices[d];
+
+                if (frame_count && dev->frames >= (unsigned int)frame_count)
+                        continue;
+                start_capturing(dev);
+                watch_device(dev);
+        }
+        idle = 0;
+        fprintf(stderr, "viewers back, capture resumed\n");
+}
+
+static void adapt_to_link(unsigned int loss_permille, unsigned int jitter_ms, unsigned int kbps);
+static void yield_to_voice(unsigned int level);
+
+/*
+ * Acts on the newest viewer count (--on-demand) and link report (--adapt)
+ * the relay sent, and the feeder's newest CPU (--yield-cpu) and thermal
+ * (--thermal) reports; anything else is dropped.
+ */
+static void read_relay_reports(void)
+{
+        char message[64];
+        struct sockaddr_in from;
+        socklen_t from_size = sizeof(from);
+        ssize_t n;
+        int viewers = -1, link = 0, cpu = -1, heat = -1;
+        unsigned int loss_permille = 0, jitter_ms = 0, kbps = 0;
+        char profile[PROFILE_NAME_SIZE];
+
+        while ((n = recvfrom(socketDescriptorT, message, sizeof(message) - 1, MSG_DONTWAIT,
+                             (struct sockaddr *)&from, &from_size)) >= 0) {
+                unsigned int count;
+
+                message[n] = '\0';
+                from_size = sizeof(from);
+                /* the feeder runs on this board */
+                if (yield_cpu && htonl(INADDR_LOOPBACK) == from.sin_addr.s_addr &&
+                    1 == sscanf(message, "cpu %u", &count)) {
+                        cpu = (int)count;
+                        continue;
+                }
+                if (thermal && htonl(INADDR_LOOPBACK) == from.sin_addr.s_addr &&
+                    1 == sscanf(message, "thermal %u", &count)) {
+                        heat = (int)count;
+                        continue;
+                }
+                /* only the host frames go to may turn the camera off or down */
+                if (from.sin_addr.s_addr != sinRemoteT.sin_addr.s_addr)
+                        continue;
+                if (1 == sscanf(message, "viewers %u", &count))
+                        viewers = (int)count;
+                else if (3 == sscanf(message, "link %u %u %u", &loss_permille, &jitter_ms, &kbps))
+                        link = 1;
+                else if (n_profiles && 1 == sscanf(message, "profile %31s", profile)) {
+                        int p = find_profile(profile);
+
+                        if (p >= 0)
+                                apply_profile((unsigned int)p);
+                        else
+                                fprintf(stderr, "no camera profile %s\n", profile);
+                }
+        }
+        if (on_demand && 0 == viewers && !idle)
+                go_idle();
+        else if (on_demand && viewers > 0 && idle)
+                resume_capture();
+        if (yield_cpu && cpu >= 0 && !idle)
+                yield_to_voice((unsigned int)cpu);
+        if (thermal && heat >= 0)
+                set_thermal_level((unsigned int)heat);
+        if (adapt && link && !idle)
+                adapt_to_link(loss_permille, jitter_ms, kbps);
+}
+
+#ifdef FISHFEEDER_UNIFIED
+/*
+ * The feeder's notices in fishfeeder, as read_relay_reports and
+ * take_feed_event would have them from their sockets.
+ */
+static void read_board_link(void)
+{
+        char line[BOARD_LINK_LINE_SIZE];
+        int cpu = -1, heat = -1;
+
+        while (boardLink_take(line, sizeof(line))) {
+                unsigned int level;
+                long long t;
+                int mode;
+
+                if (2 == sscanf(line, "feed %d %lld", &mode, &t)) {
+                        linked_feed = 1;
+                        linked_feed_time_us = t;
+                } else if (1 == sscanf(line, "cpu %u", &level))
+                        cpu = (int)level;
+                else if (1 == sscanf(line, "thermal %u", &level))
+                        heat = (int)level;
+        }
+        if (yield_cpu && cpu >= 0 && !idle)
+                yield_to_voice((unsigned int)cpu);
+        if (thermal && heat >= 0)
+                set_thermal_level((unsigned int)heat);
+}
+
+/*
+ * Capture's counts among the feeder's metrics, which have one registry and
+ * one /metrics for the whole process.
+ */
+static metrics_id frames_metric = -1, truncated_metric = -1, gated_metric = -1;
+
+static void register_capture_metrics(void)
+{
+        frames_metric = metrics_addCounter("camera_frames_total", "Frames captured, all devices together");
+        truncated_metric = metrics_addCounter("camera_frames_truncated_total",
+                                              "MJPEG frames dropped for being cut short");
+        gated_metric = metrics_addCounter("camera_frames_gated_total", "Static frames held back by --motion");
+}
+
+static void publish_capture_metrics(void)
+{
+        unsigned long frames = 0;
+        unsigned int d;
+
+        for (d = 0; d < n_devices; d++)
+                frames += devices[d].frames;
+        metrics_store(frames_metric, (long long)frames);
+        metrics_store(truncated_metric, (long long)frames_truncated);
+        metrics_store(gated_metric, (long long)frames_gated);
+}
+#endif
+
+/*
+ * Where the frames go and how they are queued. --dest replaces the relay's
+ * fixed address; a multicast group there lets several receivers share one
+ * stream, each joining it (FRAME_GROUP in index.js). --dscp marks the
+ * datagrams for the network's switches and access points, and --priority
+ * for the board's own qdisc, so a backlog of other traffic doesn't hold the
+ * video up. --sndbuf sizes the socket's buffer for the bursts a whole frame
+ * makes.
+ */
+#define MULTICAST_TTL 1                 /* the tank room's own network */
+
+static const char *dest_host;           /* --dest host[:port] */
+static int send_buffer;                 /* --sndbuf, 0 for the kernel's */
+static int dscp = -1;                   /* --dscp, -1 to leave IP_TOS alone */
+static int priority = -1;               /* --priority, -1 for the default */
+static int multicast_ttl = MULTICAST_TTL;
+
+/* host[:port], the port defaulting to RPORT_T */
+static void set_destination(const char *arg)
+{
+        char host[256], default_port[8];
+        const char *colon = strrchr(arg, ':');
+        const char *port = colon ? colon + 1 : default_port;
+        size_t length = colon ? (size_t)(colon - arg) : strlen(arg);
+        struct addrinfo hints, *found;
+        int r;
+
+        if (length >= sizeof(host)) {
+                fprintf(stderr, "host name too long\n");
+                exit(EXIT_FAILURE);
+        }
+        memcpy(host, arg, length);
+        host[length] = '\0';
+        snprintf(default_port, sizeof(default_port), "%d", RPORT_T);
+        CLEAR(hints);
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        r = getaddrinfo(host, port, &hints, &found);
+        if (r) {
+                fprintf(stderr, "%s: %s\n", arg, gai_strerror(r));
+                exit(EXIT_FAILURE);
+        }
+        memcpy(&sinRemoteT, found->ai_addr, sizeof(sinRemoteT));
+        freeaddrinfo(found);
+}
+
+static int is_multicast(void)
+{
+        return IN_MULTICAST(ntohl(sinRemoteT.sin_addr.s_addr));
+}
+
+static void configure_socket(void)
+{
+        int value;
+        socklen_t size = sizeof(value);
+
+        if (send_buffer) {
+                if (-1 == setsockopt(socketDescriptorT, SOL_SOCKET, SO_SNDBUF,
+                                     &send_buffer, sizeof(send_buffer)))
+                        errno_exit("SO_SNDBUF");
+                /* the kernel doubles the request, capped at net.core.wmem_max */
+                if (0 == getsockopt(socketDescriptorT, SOL_SOCKET, SO_SNDBUF, &value, &size))
+                        printf("send buffer %d bytes\n", value);
+        }
+        if (dscp >= 0) {
+                /* DSCP is the top six bits of the TOS byte, ECN the bottom two */
+                value = dscp << 2;
+                if (-1 == setsockopt(socketDescriptorT, IPPROTO_IP, IP_TOS, &value, sizeof(value)))
+                        errno_exit("IP_TOS");
+        }
+        /* above 6 needs CAP_NET_ADMIN */
+        if (priority >= 0 &&
+            -1 == setsockopt(socketDescriptorT, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority)))
+                errno_exit("SO_PRIORITY");
+        if (is_multicast()) {
+                unsigned char ttl = (unsigned char)multicast_ttl;
+
+                if (-1 == setsockopt(socketDescriptorT, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)))
+                        errno_exit("IP_MULTICAST_TTL");
+        }
+}
+
+/*
+ * Fleet mode (--fleet, --discover): many boards stream to one fleet gateway
+ * (fleetGateway.js) instead of each to a relay of its own. Every few seconds
+ * the board registers from the socket its frames go out of, so the gateway
+ * tells boards apart by source address and knows which metrics endpoint to
+ * scrape; a board that stops registering is forgotten. --discover finds the
+ * gateway by broadcasting until one answers, so boards need no address.
+ */
+#define FLEET_DISCOVERY_PORT 1235
+#define FLEET_REGISTER_MS 5000
+#define FLEET_DISCOVER_MAX_MS 8000
+#define FLEET_METRICS_PORT 9469         /* the microphone demo's --metrics_port */
+
+static int fleet;
+static const char *fleet_host;          /* --fleet host[:port] */
+static int discover;
+static char board_id[64];
+static unsigned int metrics_port = FLEET_METRICS_PORT;
+static uint32_t last_register_ms;
+
+/* Broadcasts until a gateway answers "gateway <port>", backing off up to FLEET_DISCOVER_MAX_MS. */
+static void discover_gateway(void)
+{
+        static const char query[] = "discover fishfeeder";
+        struct sockaddr_in everyone;
+        unsigned int wait_ms = 500;
+        int on = 1;
+
+        if (-1 == setsockopt(socketDescriptorT, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)))
+                errno_exit("SO_BROADCAST");
+        CLEAR(everyone);
+        everyone.sin_family = AF_INET;
+        everyone.sin_port = htons(FLEET_DISCOVERY_PORT);
+        everyone.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+        for (;;) {
+                struct pollfd pfd = { socketDescriptorT, POLLIN, 0 };
+                char reply[64];
+                struct sockaddr_in from;
+                socklen_t from_size = sizeof(from);
+                unsigned int port;
+                ssize_t n;
+
+                if (-1 == sendto(socketDescriptorT, query, sizeof(query) - 1, 0,
+                                 (struct sockaddr *)&everyone, sizeof(everyone)))
+                        fprintf(stderr, "discovery: %s\n", strerror(errno));
+                if (poll(&pfd, 1, wait_ms) > 0) {
+                        n = recvfrom(socketDescriptorT, reply, sizeof(reply) - 1, MSG_DONTWAIT,
+                                     (struct sockaddr *)&from, &from_size);
+                        if (n > 0) {
+                                reply[n] = '\0';
+                                if (1 == sscanf(reply, "gateway %u", &port) && port && port < 65536) {
+                                        sinRemoteT = from;
+                                        sinRemoteT.sin_port = htons((uint16_t)port);
+                                        printf("gateway found at %s:%u\n", inet_ntoa(from.sin_addr), port);
+                                        return;
+                                }
+                        }
+                }
+                if (wait_ms < FLEET_DISCOVER_MAX_MS)
+                        wait_ms *= 2;
+        }
+}
+
+/* From the main loop: "register <board> <streams> <metrics port>" every FLEET_REGISTER_MS. */
+static void register_board(void)
+{
+        char message[128];
+        uint32_t now = monotonic_ms();
+        int length;
+
+        if (last_register_ms && now - last_register_ms < FLEET_REGISTER_MS)
+                return;
+        last_register_ms = now ? now : 1;
+        length = snprintf(message, sizeof(message), "register %s %u %u", board_id, n_devices, metrics_port);
+        sendResponseT(message, length);
+}
+
+static void open_device(struct device *dev);
+static void init_device(struct device *dev);
+static void uninit_device(struct device *dev);
+
+/* Whether the node is back, without the exits of open_device(). */
+static int device_present(const struct device *dev)
+{
+        struct stat st;
+        int fd;
+
+        if (-1 == stat(dev->name, &st) || !S_ISCHR(st.st_mode))
+                return 0;
+        fd = open(dev->name, O_RDWR | O_NONBLOCK, 0);
+        if (-1 == fd)
+                return 0;
+        close(fd);
+        return 1;
+}
+
+/*
+ * Closes a device that stopped delivering (unplugged, or a wedged driver) and
+ * sets it up again from scratch, retrying with backoff until the node is back.
+ * The other devices, the socket and the worker threads carry on as they are.
+ */
+/* Stops a device and closes it, for recover_device() or a new format to open again. */
+static void shut_device(struct device *dev)
+{
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        unsigned int i;
+
+        /* the fd may be dead already, so none of this is fatal */
+        if (!dev->paused)
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, dev->fd, NULL);
+        if (IO_METHOD_READ != io)
+                xioctl(dev->fd, VIDIOC_STREAMOFF, &type);
+        /* nothing recent is in flight; late completions find no busy buffer */
+        for (i = 0; dev->in_flight && i < dev->n_buffers; i++)
+                dev->in_flight[i].busy = 0;
+        uninit_device(dev);
+        close(dev->fd);
+        dev->fd = -1;
+}
+
+static void recover_device(struct device *dev)
+{
+        uint32_t start = monotonic_ms();
+        unsigned int delay_ms = RECOVER_MIN_MS;
+
+        fprintf(stderr, "%s: reopening\n", dev->name);
+        shut_device(dev);
+
+        while (!device_present(dev)) {
+                struct timespec pause = { delay_ms / 1000, (delay_ms % 1000) * 1000000L };
+
+                nanosleep(&pause, NULL);
+                delay_ms = delay_ms * 2 > RECOVER_MAX_MS ? RECOVER_MAX_MS : delay_ms * 2;
+        }
+        open_device(dev);
+        init_device(dev);
+        start_capturing(dev);
+        watch_device(dev);
+        dev->failed = 0;
+        dev->restarted = 0;
+        fprintf(stderr, "%s: capturing again after %u ms\n", dev->name, monotonic_ms() - start);
+}
+
+/*
+ * The cheap fix first: STREAMOFF takes every buffer back from the driver,
+ * and they are all queued again and streaming restarted, with the device
+ * left open and in the epoll set. Only while capture.c holds every buffer
+ * itself: one in flight or lent would be queued twice. -1 if the driver
+ * refuses any of it.
+ */
+static int restart_device(struct device *dev)
+{
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        unsigned int i;
+
+        if (IO_METHOD_READ == io || dev->paused || buffers_in_flight(dev) || lent_buffers(dev))
+                return -1;
+        if (-1 == xioctl(dev->fd, VIDIOC_STREAMOFF, &type))
+                return -1;
+        for (i = 0; i < dev->n_buffers; i++) {
+                struct v4l2_buffer buf;
+
+                CLEAR(buf);
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.index = i;
+                if (IO_METHOD_USERPTR == io) {
+                        buf.memory = V4L2_MEMORY_USERPTR;
+                        buf.m.userptr = (unsigned long)dev->buffers[i].start;
+                        buf.length = dev->buffers[i].length;
+                } else {
+                        buf.memory = V4L2_MEMORY_MMAP;
+                }
+                if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
+                        return -1;
+        }
+        if (-1 == xioctl(dev->fd, VIDIOC_STREAMON, &type))
+                return -1;
+        dev->last_frame_ms = monotonic_ms();
+        return 0;
+}
+
+/*
+ * Tells the relay, which counts stalls in its metrics (videoStats.js). Sent
+ * on its own, outside the batch, which the --latest sender may be filling.
+ */
+static void send_stall_notice(const struct device *dev)
+{
+        struct frame_header header;
+
+        if (rtp_output)
+                return;
+        CLEAR(header);
+        header.magic = htons(FRAME_MAGIC_STALL);
+        header.stream_id = htons((uint16_t)dev->stream);
+        header.frame_id = htonl(dev->stalls);
+        header.timestamp_ms = htonl(monotonic_ms());
+        sendto(socketDescriptorT, &header, sizeof(header), MSG_DONTWAIT | MSG_NOSIGNAL,
+               (struct sockaddr *)&sinRemoteT, sizeof(sinRemoteT));
+}
+
+/*
+ * A device with no frame for STALL_MS, or a failed DQBUF or QBUF: streaming
+ * is restarted in place, and only if that doesn't bring a frame (or the
+ * device is gone) is it reopened. Either way the socket, the other devices
+ * and the relay's viewers carry on.
+ */
+static void handle_stall(struct device *dev)
+{
+        dev->stalls++;
+        send_stall_notice(dev);
+        if (ENODEV != dev->failed && !dev->restarted && 0 == restart_device(dev)) {
+                fprintf(stderr, "%s: %s, streaming restarted\n", dev->name,
+                        dev->failed ? "capture failed" : "no frame for a while");
+                dev->failed = 0;
+                dev->restarted = 1;
+                return;
+        }
+        recover_device(dev);
+}
+
+static void recover_stalled(void)
+{
+        uint32_t now = monotonic_ms();
+        unsigned int d;
+
+        for (d = 0; d < n_devices; d++) {
+                struct device *dev = &devices[d];
+
+                if (frame_count && dev->frames >= (unsigned int)frame_count)
+                        continue;
+                /* paused: waiting for the socket to hand buffers back rather than for the device */
+                if (dev->failed || (!dev->paused && now - dev->last_frame_ms > STALL_MS))
+                        handle_stall(dev);
+        }
+}
+
+/*
+ * Adaptive quality (--adapt): the relay reports what actually arrives, once
+ * a second, as "link <loss per mille> <jitter ms> <kbit/s>" (see
+ * frameReceiver.js). While chunks are being lost, delivery jitters, or less
+ * arrives than is being sent, the stream steps down a ladder: JPEG quality
+ * first, where the camera has V4L2_CID_JPEG_COMPRESSION_QUALITY, which
+ * changes on the fly, then frame rate, then resolution. Changing either of
+ * those needs the device reopened, so there is a hold between steps for the
+ * reports to show what the last one did. After a long enough run of clean
+ * reports it steps back up.
+ *
+ * With --yield-cpu the feeder (camera_governor.c in the microphone demo)
+ * sends "cpu <level>" from this board while voice inference falls behind:
+ * the stream stays at least that far down the same ladder, so a single
+ * core has time left for the wake word. Without --adapt, a lower level
+ * takes effect at once; with it, the link's clean reports step back up.
+ */
+#define ADAPT_LOSS_PERMILLE 20
+#define ADAPT_JITTER_MS 80
+/* what arrives may be this far below what is sent before it counts as a bottleneck, in per cent */
+#define ADAPT_RATE_SLACK 20
+#define ADAPT_HOLD_MS 3000
+#define ADAPT_CLEAN_MS 15000
+
+struct adapt_level {
+        int quality;                    /* 0: the camera's own */
+        unsigned int fps_div;
+        unsigned int size_div;
+};
+
+static const struct adapt_level adapt_ladder[] = {
+        { 0, 1, 1 },
+        { 70, 1, 1 },
+        { 50, 1, 1 },
+        { 50, 2, 1 },
+        { 50, 2, 2 },
+        { 30, 4, 2 },
+};
+#define ADAPT_LEVELS (sizeof(adapt_ladder) / sizeof(adapt_ladder[0]))
+
+static unsigned int adapt_level;
+static unsigned int adapt_cpu_level;    /* the feeder's floor, --yield-cpu */
+static int adapt_quality_ok = 1;        /* cleared once a device refuses the control */
+static uint32_t adapt_changed_ms;
+static uint32_t adapt_clean_ms;
+static uint32_t adapt_report_ms;
+static uint32_t adapt_bytes;
+
+static void set_quality(int quality)
+{
+        struct v4l2_control control;
+        unsigned int d;
+
+        for (d = 0; d < n_devices && adapt_quality_ok; d++) {
+                struct device *dev = &devices[d];
+
+                CLEAR(control);
+                control.id = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+                if (!quality) {
+                        /* back to what it was when we started */
+                        control.value = dev->quality;
+                } else {
+                        control.value = quality;
+                }
+                if (-1 == xioctl(dev->fd, VIDIOC_S_CTRL, &control)) {
+                        fprintf(stderr, "%s has no JPEG quality control, adapting rate and size only\n",
+                                dev->name);
+                        adapt_quality_ok = 0;
+                }
+        }
+}
+
+/* Remembers each camera's own quality, to return to at the top of the ladder. */
+static void start_adapting(void)
 {
-        int r;
-
-        do {
-                r = ioctl(fh, request, arg);
-        } while (-1 == r && EINTR == errno);
+        struct v4l2_streamparm parm;
+        struct v4l2_control control;
+        unsigned int d;
 
-        return r;
+        for (d = 0; d < n_devices; d++) {
+                CLEAR(control);
+                control.id = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+                if (-1 == xioctl(devices[d].fd, VIDIOC_G_CTRL, &control))
+                        adapt_quality_ok = 0;
+                devices[d].quality = control.value;
+        }
+        if (!fps) {
+                /* the rate steps divide whatever the driver picked */
+                CLEAR(parm);
+                parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                if (0 == xioctl(devices[0].fd, VIDIOC_G_PARM, &parm) &&
+                    parm.parm.capture.timeperframe.numerator)
+                        fps = parm.parm.capture.timeperframe.denominator /
+                              parm.parm.capture.timeperframe.numerator;
+        }
+        adapt_changed_ms = adapt_clean_ms = adapt_report_ms = monotonic_ms();
+        adapt_bytes = __atomic_load_n(&bytes_sent, __ATOMIC_RELAXED);
 }
 
-static void process_image(const void *p, int size)
+/* Whether two levels differ in anything this camera can change. */
+static int levels_differ(unsigned int a, unsigned int b)
 {
-if (out_buf) {
-sendResponseT(p, size);
-}
-fflush(stderr);
+        return adapt_ladder[a].fps_div != adapt_ladder[b].fps_div ||
+               adapt_ladder[a].size_div != adapt_ladder[b].size_div ||
+               (adapt_quality_ok && adapt_ladder[a].quality != adapt_ladder[b].quality);
 }
 
-
-static int read_frame(void)
+static void set_level(unsigned int level)
 {
-        struct v4l2_buffer buf;
-        unsigned int i;
+        const struct adapt_level *to = &adapt_ladder[level];
+        unsigned int d;
 
-        switch (io) {
-        case IO_METHOD_READ:
-                if (-1 == read(fd, buffers[0].start, buffers[0].length)) {
-                        switch (errno) {
-                        case EAGAIN:
-                                return 0;
-
-                        case EIO:
-                                /* Could ignore EIO, see spec. */
+        if (to->fps_div != adapt_fps_div || to->size_div != adapt_size_div) {
+                adapt_fps_div = to->fps_div;
+                adapt_size_div = to->size_div;
+                for (d = 0; d < n_devices; d++) {
+                        struct device *dev = &devices[d];
 
-                                /* fall through */
-
-                        default:
-                                errno_exit("read");
-                        }
+                        if (frame_count && dev->frames >= (unsigned int)frame_count)
+                                continue;
+                        shut_device(dev);
+                        open_device(dev);
+                        init_device(dev);
+                        start_capturing(dev);
+                        watch_device(dev);
                 }
+        }
+        adapt_level = level;
+        set_quality(to->quality);
+        adapt_changed_ms = monotonic_ms();
+}
 
-                process_image(buffers[0].start, buffers[0].length);
-                break;
-
-        case IO_METHOD_MMAP:
-                CLEAR(buf);
+/* Takes one step of the ladder, down (+1) or up (-1), skipping levels this camera can't tell apart. */
+static void step_level(int direction)
+{
+        unsigned int level = adapt_level;
 
-                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                buf.memory = V4L2_MEMORY_MMAP;
+        do {
+                if ((direction > 0 && level + 1 == ADAPT_LEVELS) ||
+                    (direction < 0 && level <= adapt_cpu_level))
+                        return;
+                level += direction;
+        } while (!levels_differ(level, adapt_level));
+        set_level(level);
+        fprintf(stderr, "%s to level %u: quality %d, %u fps, %ux%u\n",
+                direction > 0 ? "stepped down" : "stepped up", level, adapt_ladder[level].quality,
+                fps / adapt_fps_div, width / adapt_size_div, height / adapt_size_div);
+}
 
-                if (-1 == xioctl(fd, VIDIOC_DQBUF, &buf)) {
-                        switch (errno) {
-                        case EAGAIN:
-                                return 0;
+static void adapt_to_link(unsigned int loss_permille, unsigned int jitter_ms, unsigned int kbps)
+{
+        uint32_t now = monotonic_ms();
+        uint32_t bytes = __atomic_load_n(&bytes_sent, __ATOMIC_RELAXED);
+        uint32_t elapsed = now - adapt_report_ms;
+        /* bytes over ms is kbit/s over 8 */
+        unsigned int sent_kbps = elapsed ? (unsigned int)((uint64_t)(bytes - adapt_bytes) * 8 / elapsed) : 0;
+        int congested = loss_permille > ADAPT_LOSS_PERMILLE || jitter_ms > ADAPT_JITTER_MS ||
+                        (uint64_t)kbps * 100 < (uint64_t)sent_kbps * (100 - ADAPT_RATE_SLACK);
 
-                        case EIO:
-                                /* Could ignore EIO, see spec. */
+        adapt_report_ms = now;
+        adapt_bytes = bytes;
+        if (congested) {
+                adapt_clean_ms = now;
+                if (now - adapt_changed_ms >= ADAPT_HOLD_MS) {
+                        fprintf(stderr, "link: %u/1000 lost, %u ms jitter, %u of %u kbit/s arriving\n",
+                                loss_permille, jitter_ms, kbps, sent_kbps);
+                        step_level(1);
+                }
+        } else if (now - adapt_clean_ms >= ADAPT_CLEAN_MS && now - adapt_changed_ms >= ADAPT_CLEAN_MS) {
+                adapt_clean_ms = now;
+                step_level(-1);
+        }
+}
 
-                                /* fall through */
+static void yield_to_voice(unsigned int level)
+{
+        if (level >= ADAPT_LEVELS)
+                level = ADAPT_LEVELS - 1;
+        if (level == adapt_cpu_level)
+                return;
+        adapt_cpu_level = level;
+        if (level > adapt_level || (!adapt && level < adapt_level)) {
+                set_level(level);
+                fprintf(stderr, "feeder asked for level %u: quality %d, %u fps, %ux%u\n", level,
+                        adapt_ladder[level].quality, fps / adapt_fps_div, width / adapt_size_div,
+                        height / adapt_size_div);
+        }
+}
 
-                        default:
-                                errno_exit("VIDIOC_DQBUF");
-                        }
-                }
+/*
+ * Handover (--handover): a new build takes the devices over from the capture
+ * already running, while they stream, so the video doesn't stop for the
+ * seconds opening, setting up and starting them again would take. A capture
+ * with --handover listens on HANDOVER_PATH. A new one connects before it
+ * opens anything and is sent, with SCM_RIGHTS, the frame socket and every
+ * device's fd, with how many buffers each has. The buffers stay queued in the
+ * driver, so the new capture maps them and reads on, and the old one leaves
+ * its loop without turning the streams off. With nobody listening it starts
+ * cold. Only plain mmap streaming is handed over: the other modes keep
+ * buffers outside the driver, or stop and restart the streams.
+ */
+#define HANDOVER_PATH "/tmp/fishfeeder-capture-handover.sock"
+#define HANDOVER_TIMEOUT_MS 2000
 
-                assert(buf.index < n_buffers);
+static int handover;                    /* --handover */
+static int handover_socket = -1;
+static int handed_over;                 /* this capture gave its devices away */
+static int taken_over;                  /* this capture took them */
 
-                process_image(buffers[buf.index].start, buf.bytesused);
+union handover_fds {
+        struct cmsghdr header;
+        char space[CMSG_SPACE((MAX_STREAMS + 1) * sizeof(int))];
+};
 
-                if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-                        errno_exit("VIDIOC_QBUF");
-                break;
+static void listen_for_handover(void)
+{
+        struct sockaddr_un addr;
 
-        case IO_METHOD_USERPTR:
-                CLEAR(buf);
+        handover_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (-1 == handover_socket)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, HANDOVER_PATH, sizeof(addr.sun_path) - 1);
+        unlink(HANDOVER_PATH);          /* the capture this one took over from, or an earlier run */
+        if (-1 == bind(handover_socket, (struct sockaddr *)&addr, sizeof(addr)) ||
+            -1 == listen(handover_socket, 1))
+                errno_exit(HANDOVER_PATH);
+}
 
-                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                buf.memory = V4L2_MEMORY_USERPTR;
+static void stop_handover(void)
+{
+        if (-1 == handover_socket)
+                return;
+        close(handover_socket);
+        handover_socket = -1;
+        unlink(HANDOVER_PATH);
+}
 
-                if (-1 == xioctl(fd, VIDIOC_DQBUF, &buf)) {
-                        switch (errno) {
-                        case EAGAIN:
-                                return 0;
+/* "handover <devices> <buffers>...", with the frame socket's fd and then each device's */
+static void hand_over(void)
+{
+        char message[64];
+        int fds[MAX_STREAMS + 1];
+        union handover_fds control;
+        struct msghdr msg;
+        struct iovec part;
+        struct cmsghdr *header;
+        unsigned int d;
+        int peer, length;
 
-                        case EIO:
-                                /* Could ignore EIO, see spec. */
+        peer = accept4(handover_socket, NULL, NULL, SOCK_CLOEXEC);
+        if (-1 == peer)
+                return;
+        length = snprintf(message, sizeof(message), "handover %u", n_devices);
+        fds[0] = socketDescriptorT;
+        for (d = 0; d < n_devices; d++) {
+                length += snprintf(message + length, sizeof(message) - length, " %u", devices[d].n_buffers);
+                fds[d + 1] = devices[d].fd;
+        }
+        part.iov_base = message;
+        part.iov_len = length;
+        CLEAR(msg);
+        CLEAR(control);
+        msg.msg_iov = &part;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.space;
+        msg.msg_controllen = CMSG_SPACE((n_devices + 1) * sizeof(int));
+        header = CMSG_FIRSTHDR(&msg);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN((n_devices + 1) * sizeof(int));
+        memcpy(CMSG_DATA(header), fds, (n_devices + 1) * sizeof(int));
+        if (sendmsg(peer, &msg, MSG_NOSIGNAL) != length) {
+                /* this one streams on, and the new one starts cold */
+                perror("handover");
+                close(peer);
+                return;
+        }
+        close(peer);
+        close(handover_socket);
+        handover_socket = -1;
+        handed_over = 1;
+        fprintf(stderr, "devices handed over\n");
+}
 
-                                /* fall through */
+/* Returns whether a running capture handed its devices over. */
+static int take_over(void)
+{
+        char message[64];
+        int fds[MAX_STREAMS + 1];
+        union handover_fds control;
+        struct sockaddr_un addr;
+        struct msghdr msg;
+        struct iovec part;
+        struct cmsghdr *header;
+        struct pollfd answer;
+        ssize_t length = -1;
+        unsigned int d, count, buffers;
+        int peer, offset, consumed;
+        size_t n_fds;
 
-                        default:
-                                errno_exit("VIDIOC_DQBUF");
-                        }
+        peer = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (-1 == peer)
+                errno_exit("socket");
+        CLEAR(addr);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, HANDOVER_PATH, sizeof(addr.sun_path) - 1);
+        if (-1 == connect(peer, (struct sockaddr *)&addr, sizeof(addr))) {
+                close(peer);
+                fprintf(stderr, "no capture to take over from, starting cold\n");
+                return 0;
+        }
+        part.iov_base = message;
+        part.iov_len = sizeof(message) - 1;
+        CLEAR(msg);
+        msg.msg_iov = &part;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.space;
+        msg.msg_controllen = sizeof(control.space);
+        answer.fd = peer;
+        answer.events = POLLIN;
+        if (1 == poll(&answer, 1, HANDOVER_TIMEOUT_MS))
+                length = recvmsg(peer, &msg, MSG_CMSG_CLOEXEC);
+        close(peer);
+        header = length > 0 ? CMSG_FIRSTHDR(&msg) : NULL;
+        if (!header || SOL_SOCKET != header->cmsg_level || SCM_RIGHTS != header->cmsg_type) {
+                fprintf(stderr, "the running capture didn't hand over, starting cold\n");
+                return 0;
+        }
+        message[length] = '\0';
+        n_fds = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        memcpy(fds, CMSG_DATA(header), n_fds * sizeof(int));
+        if (1 != sscanf(message, "handover %u%n", &count, &consumed) || count != n_devices ||
+            n_fds != count + 1) {
+                fprintf(stderr, "the running capture has other devices than these\n");
+                exit(EXIT_FAILURE);
+        }
+        offset = consumed;
+        for (d = 0; d < n_devices; d++) {
+                if (1 != sscanf(message + offset, " %u%n", &buffers, &consumed) || buffers < 2) {
+                        fprintf(stderr, "bad handover: %s\n", message);
+                        exit(EXIT_FAILURE);
                 }
+                offset += consumed;
+                devices[d].fd = fds[d + 1];
+                devices[d].n_buffers = buffers;
+        }
+        /* bound to the port the relay's reports come to, which the old one still holds */
+        close(socketDescriptorT);
+        socketDescriptorT = fds[0];
+        fprintf(stderr, "devices taken over\n");
+        return 1;
+}
 
-                for (i = 0; i < n_buffers; ++i)
-                        if (buf.m.userptr == (unsigned long)buffers[i].start
-                            && buf.length == buffers[i].length)
-                                break;
+/* The socket's token in the epoll set; devices use their stream id. */
+#define EPOLL_SOCKET MAX_STREAMS
+/* board_link.c's eventfd, in fishfeeder */
+#define EPOLL_LINK (MAX_STREAMS + 3)
+#define EPOLL_HANDOVER (MAX_STREAMS + 4)
 
-                assert(i < n_buffers);
+/*
+ * Serves every device from one epoll set until each has captured
+ * frame_count frames (or forever, with 0).
+ */
+static void mainloop(void)
+{
+        struct epoll_event events[MAX_STREAMS + 5];
+        unsigned int d, active = n_devices;
 
-                process_image((void *)buf.m.userptr, buf.bytesused);
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (-1 == epoll_fd)
+                errno_exit("epoll_create1");
+        for (d = 0; d < n_devices; d++)
+                watch_device(&devices[d]);
+        if (zerocopy || on_demand || adapt || yield_cpu || thermal || n_profiles) {
+                /* completions show up as an error on the socket, relay reports as datagrams */
+                struct epoll_event ev;
 
-                if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-                        errno_exit("VIDIOC_QBUF");
-                break;
+                CLEAR(ev);
+                ev.events = (on_demand || adapt || yield_cpu || thermal || n_profiles) ? EPOLLIN : 0;
+                ev.data.u32 = EPOLL_SOCKET;
+                if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, socketDescriptorT, &ev))
+                        errno_exit("epoll_ctl");
         }
+        if (-1 != dmabuf_socket) {
+                struct epoll_event ev;
 
-        return 1;
-}
+                CLEAR(ev);
+                ev.events = EPOLLIN;
+                ev.data.u32 = EPOLL_DMABUF_LISTEN;
+                if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, dmabuf_socket, &ev))
+                        errno_exit("epoll_ctl");
+        }
+        if (-1 != handover_socket) {
+                struct epoll_event ev;
 
-static void mainloop(void)
-{
-        unsigned int count;
-	unsigned int loopIsInfinite = 0;
+                CLEAR(ev);
+                ev.events = EPOLLIN;
+                ev.data.u32 = EPOLL_HANDOVER;
+                if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, handover_socket, &ev))
+                        errno_exit("epoll_ctl");
+        }
+#ifdef FISHFEEDER_UNIFIED
+        if (-1 != boardLink_fd()) {
+                struct epoll_event ev;
 
-        if (frame_count == 0) loopIsInfinite = 1; //infinite loop
-	count = frame_count;
+                CLEAR(ev);
+                ev.events = EPOLLIN;
+                ev.data.u32 = EPOLL_LINK;
+                if (-1 == epoll_ctl(epoll_fd, EPOLL_CTL_ADD, boardLink_fd(), &ev))
+                        errno_exit("epoll_ctl");
+        }
+#endif
 
-        while ((count-- > 0) || loopIsInfinite) {
-                for (;;) {
-                        fd_set fds;
-                        struct timeval tv;
-                        int r;
+        while (active > 0) {
+                int i, r;
 
-                        FD_ZERO(&fds);
-                        FD_SET(fd, &fds);
+                /* often enough to notice a stall on a device while the others keep epoll busy */
+                r = epoll_wait(epoll_fd, events, MAX_STREAMS + 5, STALL_MS / 2);
 
-                        /* Timeout. */
-                        tv.tv_sec = 2;
-                        tv.tv_usec = 0;
+                if (-1 == r) {
+                        if (EINTR == errno)
+                                continue;
+                        errno_exit("epoll_wait");
+                }
 
-                        r = select(fd + 1, &fds, NULL, NULL, &tv);
+                /* a board registers whether or not anyone is watching */
+                if (fleet)
+                        register_board();
+                follow_profile_schedule();
+#ifdef FISHFEEDER_UNIFIED
+                publish_capture_metrics();
+#endif
+                if (0 == r && idle)
+                        continue;
 
-                        if (-1 == r) {
-                                if (EINTR == errno)
-                                        continue;
-                                errno_exit("select");
-                        }
+                for (i = 0; i < r; i++) {
+                        struct device *dev;
 
-                        if (0 == r) {
-                                fprintf(stderr, "select timeout\n");
-                                exit(EXIT_FAILURE);
+                        if (EPOLL_SOCKET == events[i].data.u32) {
+                                if (zerocopy)
+                                        read_completions();
+                                if (on_demand || adapt || yield_cpu || thermal || n_profiles)
+                                        read_relay_reports();
+                                continue;
+                        }
+#ifdef FISHFEEDER_UNIFIED
+                        if (EPOLL_LINK == events[i].data.u32) {
+                                read_board_link();
+                                continue;
+                        }
+#endif
+                        if (EPOLL_DMABUF_LISTEN == events[i].data.u32) {
+                                accept_dmabuf_consumer();
+                                continue;
+                        }
+                        if (EPOLL_HANDOVER == events[i].data.u32) {
+                                hand_over();
+                                continue;
+                        }
+                        if (EPOLL_DMABUF == events[i].data.u32) {
+                                if (-1 != dmabuf_consumer)
+                                        read_dmabuf_returns();
+                                continue;
+                        }
+                        dev = &devices[events[i].data.u32];
+                        /* EAGAIN, or paused by an earlier event of this round */
+                        if (dev->paused || !read_frame(dev))
+                                continue;
+                        dev->last_frame_ms = monotonic_ms();
+                        dev->restarted = 0;
+                        dev->frames++;
+                        if (frame_count && dev->frames == (unsigned int)frame_count) {
+                                if (!dev->paused)
+                                        pause_device(dev);
+                                active--;
                         }
-
-                        if (read_frame())
-                                break;
-                        /* EAGAIN - continue select loop. */
                 }
+                /* the new capture reads the devices from here */
+                if (handed_over)
+                        break;
+                if (!idle)
+                        recover_stalled();
         }
+
+        close(epoll_fd);
+        epoll_fd = -1;
 }
 
-static void stop_capturing(void)
+static void stop_capturing(struct device *dev)
 {
         enum v4l2_buf_type type;
 
@@ -262,26 +4449,30 @@ static void stop_capturing(void)
                 break;
 
         case IO_METHOD_MMAP:
+        case IO_METHOD_DMABUF:
         case IO_METHOD_USERPTR:
                 type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                if (-1 == xioctl(fd, VIDIOC_STREAMOFF, &type))
+                if (-1 == xioctl(dev->fd, VIDIOC_STREAMOFF, &type))
                         errno_exit("VIDIOC_STREAMOFF");
                 break;
         }
 }
 
-static void start_capturing(void)
+static void start_capturing(struct device *dev)
 {
         unsigned int i;
         enum v4l2_buf_type type;
 
+        dev->last_frame_ms = monotonic_ms();
+
         switch (io) {
         case IO_METHOD_READ:
                 /* Nothing to do. */
                 break;
 
         case IO_METHOD_MMAP:
-                for (i = 0; i < n_buffers; ++i) {
+        case IO_METHOD_DMABUF:
+                for (i = 0; i < dev->n_buffers; ++i) {
                         struct v4l2_buffer buf;
 
                         CLEAR(buf);
@@ -289,91 +4480,131 @@ static void start_capturing(void)
                         buf.memory = V4L2_MEMORY_MMAP;
                         buf.index = i;
 
-                        if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
+                        if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
                                 errno_exit("VIDIOC_QBUF");
                 }
                 type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                if (-1 == xioctl(fd, VIDIOC_STREAMON, &type))
+                if (-1 == xioctl(dev->fd, VIDIOC_STREAMON, &type))
                         errno_exit("VIDIOC_STREAMON");
                 break;
 
         case IO_METHOD_USERPTR:
-                for (i = 0; i < n_buffers; ++i) {
+                for (i = 0; i < dev->n_buffers; ++i) {
                         struct v4l2_buffer buf;
 
                         CLEAR(buf);
                         buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
                         buf.memory = V4L2_MEMORY_USERPTR;
                         buf.index = i;
-                        buf.m.userptr = (unsigned long)buffers[i].start;
-                        buf.length = buffers[i].length;
+                        buf.m.userptr = (unsigned long)dev->buffers[i].start;
+                        buf.length = dev->buffers[i].length;
 
-                        if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
+                        if (-1 == xioctl(dev->fd, VIDIOC_QBUF, &buf))
                                 errno_exit("VIDIOC_QBUF");
                 }
                 type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                if (-1 == xioctl(fd, VIDIOC_STREAMON, &type))
+                if (-1 == xioctl(dev->fd, VIDIOC_STREAMON, &type))
                         errno_exit("VIDIOC_STREAMON");
                 break;
         }
 }
 
-static void uninit_device(void)
+static void uninit_device(struct device *dev)
 {
         unsigned int i;
 
         switch (io) {
         case IO_METHOD_READ:
-                free(buffers[0].start);
+                free(dev->buffers[0].start);
                 break;
 
+        case IO_METHOD_DMABUF:
+                for (i = 0; i < dev->n_buffers; ++i)
+                        close(dev->buffers[i].dmabuf);
+                /* nothing of this device is re-queued; the consumer connects again for the new buffers */
+                free(dev->lent);
+                dev->lent = NULL;
+                drop_dmabuf_consumer();
+                /* fall through */
+
         case IO_METHOD_MMAP:
-                for (i = 0; i < n_buffers; ++i)
-                        if (-1 == munmap(buffers[i].start, buffers[i].length))
+                for (i = 0; i < dev->n_buffers; ++i)
+                        if (-1 == munmap(dev->buffers[i].start, dev->buffers[i].length))
                                 errno_exit("munmap");
                 break;
 
         case IO_METHOD_USERPTR:
-                for (i = 0; i < n_buffers; ++i)
-                        free(buffers[i].start);
+                for (i = 0; i < dev->n_buffers; ++i)
+                        frame_release(dev->queued[i]);
+                free(dev->queued);
+                dev->queued = NULL;
                 break;
         }
 
-        free(buffers);
+        /* frames still kept elsewhere outlive it */
+        frame_pool_destroy(dev->pool);
+        dev->pool = NULL;
+        free(dev->buffers);
+        free(dev->in_flight);
+        dev->in_flight = NULL;
+}
+
+/*
+ * Frames beyond the capture buffers: the --latest mailbox's three slots, the
+ * newest snapshot and one being served, and process_image()'s own copy.
+ * Past that the pool allocates, so this only sets what is kept hot.
+ */
+#define FRAME_POOL_SPARE 6
+
+static void init_pool(struct device *dev, unsigned int frame_size, unsigned int frames)
+{
+        dev->pool = frame_pool_create(frame_size, frames);
+        if (!dev->pool) {
+                fprintf(stderr, "Out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        fprintf(stderr, "%s: %u pool frames on %s pages\n", dev->name, frames,
+                 frame_pool_hugepages(dev->pool) ? "huge" : "normal");
 }
 
-static void init_read(unsigned int buffer_size)
+static void init_read(struct device *dev, unsigned int buffer_size)
 {
-        buffers = calloc(1, sizeof(*buffers));
+        dev->buffers = calloc(1, sizeof(*dev->buffers));
 
-        if (!buffers) {
+        if (!dev->buffers) {
                 fprintf(stderr, "Out of memory\n");
                 exit(EXIT_FAILURE);
         }
 
-        buffers[0].length = buffer_size;
-        buffers[0].start = malloc(buffer_size);
+        dev->buffers[0].length = buffer_size;
+        dev->buffers[0].start = malloc(buffer_size);
 
-        if (!buffers[0].start) {
+        if (!dev->buffers[0].start) {
                 fprintf(stderr, "Out of memory\n");
                 exit(EXIT_FAILURE);
         }
 }
 
-static void init_mmap(void)
+static void init_mmap(struct device *dev)
 {
         struct v4l2_requestbuffers req;
 
         CLEAR(req);
 
-        req.count = 4;
+        if (buffer_count)
+                req.count = buffer_count;
+        else
+                req.count = zerocopy ? ZEROCOPY_BUFFERS : 4;
         req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         req.memory = V4L2_MEMORY_MMAP;
 
-        if (-1 == xioctl(fd, VIDIOC_REQBUFS, &req)) {
+        /* taken over, the buffers exist and are queued; only the mappings are new */
+        if (taken_over)
+                req.count = dev->n_buffers;
+        else if (-1 == xioctl(dev->fd, VIDIOC_REQBUFS, &req)) {
                 if (EINVAL == errno) {
                         fprintf(stderr, "%s does not support "
-                                 "memory mapping\n", dev_name);
+                                 "memory mapping\n", dev->name);
                         exit(EXIT_FAILURE);
                 } else {
                         errno_exit("VIDIOC_REQBUFS");
@@ -382,81 +4613,116 @@ static void init_mmap(void)
 
         if (req.count < 2) {
                 fprintf(stderr, "Insufficient buffer memory on %s\n",
-                         dev_name);
+                         dev->name);
                 exit(EXIT_FAILURE);
         }
 
-        buffers = calloc(req.count, sizeof(*buffers));
+        dev->buffers = calloc(req.count, sizeof(*dev->buffers));
 
-        if (!buffers) {
+        if (!dev->buffers) {
                 fprintf(stderr, "Out of memory\n");
                 exit(EXIT_FAILURE);
         }
 
-        for (n_buffers = 0; n_buffers < req.count; ++n_buffers) {
+        if (zerocopy) {
+                dev->in_flight = calloc(req.count, sizeof(*dev->in_flight));
+                if (!dev->in_flight) {
+                        fprintf(stderr, "Out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        for (dev->n_buffers = 0; dev->n_buffers < req.count; ++dev->n_buffers) {
                 struct v4l2_buffer buf;
 
                 CLEAR(buf);
 
                 buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
                 buf.memory      = V4L2_MEMORY_MMAP;
-                buf.index       = n_buffers;
+                buf.index       = dev->n_buffers;
 
-                if (-1 == xioctl(fd, VIDIOC_QUERYBUF, &buf))
+                if (-1 == xioctl(dev->fd, VIDIOC_QUERYBUF, &buf))
                         errno_exit("VIDIOC_QUERYBUF");
 
-                buffers[n_buffers].length = buf.length;
-                buffers[n_buffers].start =
+                dev->buffers[dev->n_buffers].length = buf.length;
+                dev->buffers[dev->n_buffers].start =
                         mmap(NULL /* start anywhere */,
                               buf.length,
                               PROT_READ | PROT_WRITE /* required */,
                               MAP_SHARED /* recommended */,
-                              fd, buf.m.offset);
+                              dev->fd, buf.m.offset);
 
-                if (MAP_FAILED == buffers[n_buffers].start)
+                if (MAP_FAILED == dev->buffers[dev->n_buffers].start)
                         errno_exit("mmap");
         }
 }
 
-static void init_userp(unsigned int buffer_size)
+static void init_userp(struct device *dev, unsigned int buffer_size)
 {
         struct v4l2_requestbuffers req;
 
         CLEAR(req);
 
-        req.count  = 4;
+        req.count  = buffer_count ? buffer_count : 4;
         req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         req.memory = V4L2_MEMORY_USERPTR;
 
-        if (-1 == xioctl(fd, VIDIOC_REQBUFS, &req)) {
+        if (-1 == xioctl(dev->fd, VIDIOC_REQBUFS, &req)) {
                 if (EINVAL == errno) {
                         fprintf(stderr, "%s does not support "
-                                 "user pointer i/o\n", dev_name);
+                                 "user pointer i/o\n", dev->name);
                         exit(EXIT_FAILURE);
                 } else {
                         errno_exit("VIDIOC_REQBUFS");
                 }
         }
 
-        buffers = calloc(4, sizeof(*buffers));
+        init_pool(dev, buffer_size, req.count + FRAME_POOL_SPARE);
+        dev->buffers = calloc(req.count, sizeof(*dev->buffers));
+        dev->queued = calloc(req.count, sizeof(*dev->queued));
 
-        if (!buffers) {
+        if (!dev->buffers || !dev->queued) {
                 fprintf(stderr, "Out of memory\n");
                 exit(EXIT_FAILURE);
         }
 
-        for (n_buffers = 0; n_buffers < 4; ++n_buffers) {
-                buffers[n_buffers].length = buffer_size;
-                buffers[n_buffers].start = malloc(buffer_size);
+        for (dev->n_buffers = 0; dev->n_buffers < req.count; ++dev->n_buffers) {
+                struct pool_frame *frame = frame_pool_get(dev->pool);
 
-                if (!buffers[n_buffers].start) {
+                if (!frame) {
                         fprintf(stderr, "Out of memory\n");
                         exit(EXIT_FAILURE);
                 }
+                dev->queued[dev->n_buffers] = frame;
+                dev->buffers[dev->n_buffers].start = frame->data;
+                dev->buffers[dev->n_buffers].length = frame->capacity;
         }
 }
 
-static void init_device(void)
+static void set_framerate(struct device *dev, unsigned int rate)
+{
+        struct v4l2_streamparm parm;
+
+        CLEAR(parm);
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (-1 == xioctl(dev->fd, VIDIOC_G_PARM, &parm) ||
+            !(parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME)) {
+                fprintf(stderr, "%s can't set the frame rate\n", dev->name);
+                return;
+        }
+
+        parm.parm.capture.timeperframe.numerator = 1;
+        parm.parm.capture.timeperframe.denominator = rate;
+        if (-1 == xioctl(dev->fd, VIDIOC_S_PARM, &parm))
+                errno_exit("VIDIOC_S_PARM");
+
+        /* the driver picks the nearest rate it supports */
+        fprintf(stderr, "Frame rate %u/%u\n",
+                 parm.parm.capture.timeperframe.denominator,
+                 parm.parm.capture.timeperframe.numerator);
+}
+
+static void init_device(struct device *dev)
 {
         struct v4l2_capability cap;
         struct v4l2_cropcap cropcap;
@@ -464,10 +4730,10 @@ static void init_device(void)
         struct v4l2_format fmt;
         unsigned int min;
 
-        if (-1 == xioctl(fd, VIDIOC_QUERYCAP, &cap)) {
+        if (-1 == xioctl(dev->fd, VIDIOC_QUERYCAP, &cap)) {
                 if (EINVAL == errno) {
                         fprintf(stderr, "%s is no V4L2 device\n",
-                                 dev_name);
+                                 dev->name);
                         exit(EXIT_FAILURE);
                 } else {
                         errno_exit("VIDIOC_QUERYCAP");
@@ -476,7 +4742,7 @@ static void init_device(void)
 
         if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE)) {
                 fprintf(stderr, "%s is no video capture device\n",
-                         dev_name);
+                         dev->name);
                 exit(EXIT_FAILURE);
         }
 
@@ -484,16 +4750,17 @@ static void init_device(void)
         case IO_METHOD_READ:
                 if (!(cap.capabilities & V4L2_CAP_READWRITE)) {
                         fprintf(stderr, "%s does not support read i/o\n",
-                                 dev_name);
+                                 dev->name);
                         exit(EXIT_FAILURE);
                 }
                 break;
 
         case IO_METHOD_MMAP:
+        case IO_METHOD_DMABUF:
         case IO_METHOD_USERPTR:
                 if (!(cap.capabilities & V4L2_CAP_STREAMING)) {
                         fprintf(stderr, "%s does not support streaming i/o\n",
-                                 dev_name);
+                                 dev->name);
                         exit(EXIT_FAILURE);
                 }
                 break;
@@ -507,11 +4774,11 @@ static void init_device(void)
 
         cropcap.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
-        if (0 == xioctl(fd, VIDIOC_CROPCAP, &cropcap)) {
+        if (0 == xioctl(dev->fd, VIDIOC_CROPCAP, &cropcap)) {
                 crop.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
                 crop.c = cropcap.defrect; /* reset to default */
 
-                if (-1 == xioctl(fd, VIDIOC_S_CROP, &crop)) {
+                if (-1 == xioctl(dev->fd, VIDIOC_S_CROP, &crop)) {
                         switch (errno) {
                         case EINVAL:
                                 /* Cropping not supported. */
@@ -529,29 +4796,27 @@ static void init_device(void)
         CLEAR(fmt);
 
         fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-	fprintf(stderr, "Force Format %d\n", force_format);
-        if (force_format) {
-if (force_format==2){
-fmt.fmt.pix.width = 720;
-fmt.fmt.pix.height = 720;
-fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_MJPEG;
-fmt.fmt.pix.field = V4L2_FIELD_NONE;
-}
-else if(force_format==1){
-fmt.fmt.pix.width = 640;
-fmt.fmt.pix.height = 480;
-fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_MJPEG;
-fmt.fmt.pix.field = V4L2_FIELD_NONE;
-}
-if (-1 == xioctl(fd, VIDIOC_S_FMT, &fmt))
-errno_exit("VIDIOC_S_FMT");
-/* Note VIDIOC_S_FMT may change width and height. */
-} else {
-/* Preserve original settings as set by v4l2-ctl for example */
-if (-1 == xioctl(fd, VIDIOC_G_FMT, &fmt))
-errno_exit("VIDIOC_G_FMT");
-}
+        /* taken over, the stream goes on in the format it has */
+        if (force_format && !taken_over) {
+                fmt.fmt.pix.width       = width / adapt_size_div;
+                fmt.fmt.pix.height      = height / adapt_size_div;
+                fmt.fmt.pix.pixelformat = pixelformat;
+                fmt.fmt.pix.field       = V4L2_FIELD_NONE;
 
+                if (-1 == xioctl(dev->fd, VIDIOC_S_FMT, &fmt))
+                        errno_exit("VIDIOC_S_FMT");
+
+                /* Note VIDIOC_S_FMT may change width and height. */
+        } else {
+                /* Preserve original settings as set by v4l2-ctl for example */
+                if (-1 == xioctl(dev->fd, VIDIOC_G_FMT, &fmt))
+                        errno_exit("VIDIOC_G_FMT");
+        }
+        fprintf(stderr, "Format %ux%u %.4s\n", fmt.fmt.pix.width,
+                 fmt.fmt.pix.height, (char *)&fmt.fmt.pix.pixelformat);
+
+        if (fps && !taken_over)
+                set_framerate(dev, fps / adapt_fps_div ? fps / adapt_fps_div : 1);
 
         /* Buggy driver paranoia. */
         min = fmt.fmt.pix.width * 2;
@@ -560,73 +4825,576 @@ errno_exit("VIDIOC_G_FMT");
         min = fmt.fmt.pix.bytesperline * fmt.fmt.pix.height;
         if (fmt.fmt.pix.sizeimage < min)
                 fmt.fmt.pix.sizeimage = min;
+        dev->format = fmt.fmt.pix;
+        if (current_profile >= 0)
+                apply_profile_to(dev);
+
+        /* with mmap or read() only frames kept past process_image() need one */
+        if (IO_METHOD_USERPTR != io && (latest_frame || snapshots))
+                init_pool(dev, fmt.fmt.pix.sizeimage, FRAME_POOL_SPARE);
 
         switch (io) {
         case IO_METHOD_READ:
-                init_read(fmt.fmt.pix.sizeimage);
+                init_read(dev, fmt.fmt.pix.sizeimage);
                 break;
 
         case IO_METHOD_MMAP:
-                init_mmap();
+                init_mmap(dev);
+                break;
+
+        case IO_METHOD_DMABUF:
+                init_mmap(dev);
+                export_buffers(dev);
                 break;
 
         case IO_METHOD_USERPTR:
-                init_userp(fmt.fmt.pix.sizeimage);
+                init_userp(dev, fmt.fmt.pix.sizeimage);
                 break;
         }
 }
 
-static void close_device(void)
+static void close_device(struct device *dev)
 {
-        if (-1 == close(fd))
+        if (-1 == close(dev->fd))
                 errno_exit("close");
 
-        fd = -1;
+        dev->fd = -1;
 }
 
-static void open_device(void)
+static void open_device(struct device *dev)
 {
         struct stat st;
 
-        if (-1 == stat(dev_name, &st)) {
+        if (-1 == stat(dev->name, &st)) {
                 fprintf(stderr, "Cannot identify '%s': %d, %s\n",
-                         dev_name, errno, strerror(errno));
+                         dev->name, errno, strerror(errno));
                 exit(EXIT_FAILURE);
         }
 
         if (!S_ISCHR(st.st_mode)) {
-                fprintf(stderr, "%s is no device\n", dev_name);
+                fprintf(stderr, "%s is no device\n", dev->name);
                 exit(EXIT_FAILURE);
         }
 
-        fd = open(dev_name, O_RDWR /* required */ | O_NONBLOCK, 0);
+        dev->fd = open(dev->name, O_RDWR /* required */ | O_NONBLOCK, 0);
 
-        if (-1 == fd) {
+        if (-1 == dev->fd) {
                 fprintf(stderr, "Cannot open '%s': %d, %s\n",
-                         dev_name, errno, strerror(errno));
+                         dev->name, errno, strerror(errno));
                 exit(EXIT_FAILURE);
         }
 }
 
 
-int main()
+static void usage(FILE *fp, char **argv)
 {
+        fprintf(fp,
+                 "Usage: %s [options]\n\n"
+                 "Options:\n"
+                 "-d | --device name   Video device name, repeated for up to %d streams\n"
+                 "                     [/dev/video0]\n"
+                 "-s | --size WxH      Frame size [%ux%u]\n"
+                 "-p | --fps rate      Frames per second [driver default]\n"
+                 "-b | --buffers n     Capture buffers [4, %d with --zerocopy]\n"
+                 "-f | --format fourcc Pixel format, e.g. MJPG or YUYV [MJPG]\n"
+                 "-F | --h264          Capture the camera's own H264 stream, same as -f H264\n"
+                 "-k | --keep-format   Keep the format set by v4l2-ctl, ignore -s and -f\n"
+                 "-c | --count n       Frames to send, 0 for no limit [%d]\n"
+                 "-r | --rtp           Send RTP/JPEG (RFC 2435), or RTP/H264 (RFC 6184)\n"
+                 "                     with -F, and write " RTP_SDP_PATH "\n"
+                 "-E | --fec k+m       Add m parity datagrams to every k of a frame, e.g. 10+1\n"
+                 "-H | --header-cache  Send each stream's JPEG header only when it changes\n"
+                 "                     and once a second, the scan data alone otherwise\n"
+                 "-z | --zerocopy      Send from the capture buffers with MSG_ZEROCOPY\n"
+                 "-U | --userptr       Capture into page-aligned pool frames (USERPTR) that\n"
+                 "                     are sent and kept with no copy\n"
+                 "-X | --dmabuf        Also lend the capture buffers as dmabuf fds to a\n"
+                 "                     consumer on " DMABUF_PATH "\n"
+                 "-G | --profiles file Camera control profiles (exposure, gain, white\n"
+                 "                     balance), by time of day or picked by the relay\n"
+                 "-l | --latest        Send from a thread that skips to the newest frame\n"
+                 "-m | --motion n      Hold back frames while less than n/1000 of the\n"
+                 "                     picture changes; a feed resumes full rate [off]\n"
+                 "-i | --idle s        With --motion, send a frame every s seconds [%u]\n"
+                 "-a | --activity file Append the fish activity index to file every second\n"
+                 "-C | --clips dir     Save an AVI of every feed, from %ds before to %ds after\n"
+                 "-L | --timelapse dir Save a time-lapse AVI of every stream, one a day\n"
+                 "-N | --lapse-every s With --timelapse, keep a frame every s seconds [%u]\n"
+                 "-R | --archive dir   Keep a rolling archive of every stream to play back\n"
+                 "-W | --archive-gb n  With --archive, the disk each stream may use [%u]\n"
+                 "-Y | --archive-fps n With --archive, frames kept a second [%u]\n"
+                 "-t | --thumbnails n  Also send every stream at 1/8 scale, n frames a second,\n"
+                 "                     as stream %d and up\n"
+                 "-A | --adapt         Lower quality, frame rate, then size while the relay\n"
+                 "                     reports loss, jitter or a bottleneck\n"
+                 "-O | --yield-cpu     Step down the same way while the feeder on this board\n"
+                 "                     reports its voice inference falling behind\n"
+                 "-K | --thermal       Shed the time-lapse, analytics, thumbnails, then half\n"
+                 "                     the frames as the feeder reports the board heating up\n"
+                 "-V | --on-demand     Stop capturing while the relay reports no viewers\n"
+                 "-u | --handover      Take the devices over from the capture running, and\n"
+                 "                     hand them to the next on " HANDOVER_PATH "\n"
+                 "-S | --snapshot      Serve the newest frame to anyone connecting to\n"
+                 "                     " SNAPSHOT_PATH "\n"
+                 "-e | --pellets       Time how long each feed takes to eat and report it\n"
+                 "                     to the feeder on " CONTROL_PATH "\n"
+                 "-o | --dest h[:p]    Send to this host or multicast group [192.168.7.1:%d]\n"
+                 "-T | --ttl n         Hops a multicast stream may take [%d]\n"
+                 "-B | --sndbuf bytes  Socket send buffer [kernel default]\n"
+                 "-Q | --dscp n        Mark the datagrams with DSCP n, e.g. 34 for AF41 [off]\n"
+                 "-P | --priority n    SO_PRIORITY for the board's own queueing [off]\n"
+                 "-g | --fleet h[:p]   Stream to a fleet gateway and register with it\n"
+                 "-D | --discover      Find the fleet gateway by broadcasting on port %d\n"
+                 "-I | --board-id id   Name this board registers as [host name]\n"
+                 "-M | --metrics-port n Port of this board's metrics for the gateway [%d]\n"
+                 "-h | --help          Print this message\n"
+                 "Feeds are signalled on " FEED_EVENT_PATH " or with SIGUSR1.\n"
+                 "",
+                 argv[0], MAX_STREAMS, width, height, ZEROCOPY_BUFFERS, frame_count,
+                 idle_interval, CLIP_PRE_MS / 1000, CLIP_POST_MS / 1000, lapse_interval,
+                 archive_gb, archive_fps,
+                 THUMBNAIL_STREAM_BASE, RPORT_T,
+                 MULTICAST_TTL, FLEET_DISCOVERY_PORT, FLEET_METRICS_PORT);
+}
+
+static const char short_options[] = "d:s:p:b:f:Fkc:rE:HzUXG:lm:i:a:C:L:N:R:W:Y:t:AOKVuSeo:T:B:Q:P:g:DI:M:h";
+
+static const struct option
+long_options[] = {
+        { "device",  required_argument, NULL, 'd' },
+        { "size",    required_argument, NULL, 's' },
+        { "fps",     required_argument, NULL, 'p' },
+        { "buffers", required_argument, NULL, 'b' },
+        { "format",  required_argument, NULL, 'f' },
+        { "h264",    no_argument,       NULL, 'F' },
+        { "keep-format", no_argument,   NULL, 'k' },
+        { "count",   required_argument, NULL, 'c' },
+        { "rtp",  no_argument, NULL, 'r' },
+        { "fec", required_argument, NULL, 'E' },
+        { "header-cache", no_argument, NULL, 'H' },
+        { "zerocopy", no_argument, NULL, 'z' },
+        { "userptr", no_argument, NULL, 'U' },
+        { "dmabuf", no_argument, NULL, 'X' },
+        { "profiles", required_argument, NULL, 'G' },
+        { "latest", no_argument, NULL, 'l' },
+        { "motion", required_argument, NULL, 'm' },
+        { "idle", required_argument, NULL, 'i' },
+        { "activity", required_argument, NULL, 'a' },
+        { "clips", required_argument, NULL, 'C' },
+        { "timelapse", required_argument, NULL, 'L' },
+        { "lapse-every", required_argument, NULL, 'N' },
+        { "archive", required_argument, NULL, 'R' },
+        { "archive-gb", required_argument, NULL, 'W' },
+        { "archive-fps", required_argument, NULL, 'Y' },
+        { "thumbnails", required_argument, NULL, 't' },
+        { "adapt", no_argument, NULL, 'A' },
+        { "yield-cpu", no_argument, NULL, 'O' },
+        { "thermal", no_argument, NULL, 'K' },
+        { "on-demand", no_argument, NULL, 'V' },
+        { "handover", no_argument, NULL, 'u' },
+        { "snapshot", no_argument, NULL, 'S' },
+        { "pellets", no_argument, NULL, 'e' },
+        { "dest", required_argument, NULL, 'o' },
+        { "ttl", required_argument, NULL, 'T' },
+        { "sndbuf", required_argument, NULL, 'B' },
+        { "dscp", required_argument, NULL, 'Q' },
+        { "priority", required_argument, NULL, 'P' },
+        { "fleet", required_argument, NULL, 'g' },
+        { "discover", no_argument, NULL, 'D' },
+        { "board-id", required_argument, NULL, 'I' },
+        { "metrics-port", required_argument, NULL, 'M' },
+        { "help", no_argument, NULL, 'h' },
+        { 0, 0, 0, 0 }
+};
+
+static unsigned int parse_count(const char *arg)
+{
+        char *end;
+        long value;
+
+        errno = 0;
+        value = strtol(arg, &end, 0);
+        if (errno || *end != '\0' || value < 0)
+                errno_exit(arg);
+        return (unsigned int)value;
+}
+
+#ifdef FISHFEEDER_UNIFIED
+/* fishfeeder.c runs this on a thread of its own, beside the feeder */
+int capture_main(int argc, char **argv)
+#else
+int main(int argc, char **argv)
+#endif
+{
+unsigned int d;
+
+for (;;) {
+        int idx;
+        int c = getopt_long(argc, argv, short_options, long_options, &idx);
+
+        if (-1 == c)
+                break;
+        switch (c) {
+        case 'd':
+                if (MAX_STREAMS == n_devices) {
+                        fprintf(stderr, "at most %d devices\n", MAX_STREAMS);
+                        exit(EXIT_FAILURE);
+                }
+                devices[n_devices++].name = optarg;
+                break;
+        case 's':
+                if (2 != sscanf(optarg, "%ux%u", &width, &height) || !width || !height) {
+                        fprintf(stderr, "size should look like 720x720\n");
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'p':
+                fps = parse_count(optarg);
+                break;
+        case 'b':
+                buffer_count = parse_count(optarg);
+                break;
+        case 'f':
+                if (4 != strlen(optarg)) {
+                        fprintf(stderr, "format should be a fourcc, e.g. MJPG\n");
+                        exit(EXIT_FAILURE);
+                }
+                pixelformat = v4l2_fourcc(optarg[0], optarg[1], optarg[2], optarg[3]);
+                break;
+        case 'F':
+                pixelformat = V4L2_PIX_FMT_H264;
+                break;
+        case 'k':
+                force_format = 0;
+                break;
+        case 'c':
+                frame_count = parse_count(optarg);
+                break;
+        case 'r':
+                rtp_output = 1;
+                break;
+        case 'E':
+                if (2 != sscanf(optarg, "%u+%u", &fec_data, &fec_parity) ||
+                    !fec_data || fec_data > FEC_MAX_DATA || !fec_parity || fec_parity > FEC_MAX_PARITY) {
+                        fprintf(stderr, "fec should look like 10+1, k up to %d and m up to %d\n",
+                                FEC_MAX_DATA, FEC_MAX_PARITY);
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'H':
+                header_cache = 1;
+                break;
+        case 'z':
+                zerocopy = 1;
+                break;
+        case 'U':
+                io = IO_METHOD_USERPTR;
+                break;
+        case 'X':
+                io = IO_METHOD_DMABUF;
+                break;
+        case 'G':
+                profiles_file = optarg;
+                break;
+        case 'l':
+                latest_frame = 1;
+                break;
+        case 'm':
+                motion_threshold = parse_count(optarg);
+                break;
+        case 'i':
+                idle_interval = parse_count(optarg);
+                break;
+        case 'a':
+                activity_file = fopen(optarg, "a");
+                if (!activity_file)
+                        errno_exit(optarg);
+                break;
+        case 'C':
+                clip_dir = optarg;
+                break;
+        case 'L':
+                lapse_dir = optarg;
+                break;
+        case 'N':
+                lapse_interval = parse_count(optarg);
+                if (0 == lapse_interval) {
+                        fprintf(stderr, "--lapse-every needs at least a second\n");
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'R':
+                archive_dir = optarg;
+                break;
+        case 'W':
+                archive_gb = parse_count(optarg);
+                if (0 == archive_gb || archive_gb > 1024) {
+                        fprintf(stderr, "--archive-gb takes 1 to 1024 gigabytes\n");
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'Y':
+                archive_fps = parse_count(optarg);
+                if (0 == archive_fps || archive_fps > ARCHIVE_MAX_FPS) {
+                        fprintf(stderr, "--archive-fps takes 1 to %d frames a second\n", ARCHIVE_MAX_FPS);
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 't':
+                thumbnail_fps = parse_count(optarg);
+                if (0 == thumbnail_fps || thumbnail_fps > THUMBNAIL_MAX_FPS) {
+                        fprintf(stderr, "--thumbnails takes 1 to %d frames a second\n", THUMBNAIL_MAX_FPS);
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'A':
+                adapt = 1;
+                break;
+        case 'O':
+                yield_cpu = 1;
+                break;
+        case 'K':
+                thermal = 1;
+                break;
+        case 'V':
+                on_demand = 1;
+                break;
+        case 'u':
+                handover = 1;
+                break;
+        case 'S':
+                snapshots = 1;
+                break;
+        case 'e':
+                pellets = 1;
+                break;
+        case 'o':
+                dest_host = optarg;
+                break;
+        case 'T':
+                multicast_ttl = (int)parse_count(optarg);
+                if (multicast_ttl > 255) {
+                        fprintf(stderr, "ttl is at most 255\n");
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'B':
+                send_buffer = (int)parse_count(optarg);
+                break;
+        case 'Q':
+                dscp = (int)parse_count(optarg);
+                if (dscp > 63) {
+                        fprintf(stderr, "dscp is at most 63\n");
+                        exit(EXIT_FAILURE);
+                }
+                break;
+        case 'P':
+                priority = (int)parse_count(optarg);
+                break;
+        case 'g':
+                fleet_host = optarg;
+                fleet = 1;
+                break;
+        case 'D':
+                discover = 1;
+                fleet = 1;
+                break;
+        case 'I':
+                snprintf(board_id, sizeof(board_id), "%s", optarg);
+                break;
+        case 'M':
+                metrics_port = parse_count(optarg);
+                break;
+        case 'h':
+                usage(stdout, argv);
+                exit(EXIT_SUCCESS);
+        default:
+                usage(stderr, argv);
+                exit(EXIT_FAILURE);
+        }
+}
+if (0 == n_devices)
+        devices[n_devices++].name = "/dev/video0";
+for (d = 0; d < n_devices; d++) {
+        devices[d].fd = -1;
+        devices[d].stream = d;
+}
+if (n_devices > 1 &&
+    (rtp_output || latest_frame || motion_threshold >= 0 || activity_file || clip_dir || snapshots ||
+     pellets)) {
+        /* each of these keeps the state of a single stream */
+        fprintf(stderr, "--rtp, --latest, --motion, --activity, --clips, --snapshot and --pellets "
+                "take one device\n");
+        exit(EXIT_FAILURE);
+}
+if (force_format && V4L2_PIX_FMT_MJPEG != pixelformat &&
+    (motion_threshold >= 0 || activity_file || clip_dir || lapse_dir || archive_dir || snapshots || pellets ||
+     thumbnail_fps || header_cache)) {
+        /* these read or repackage the JPEGs themselves */
+        fprintf(stderr, "--motion, --activity, --clips, --timelapse, --archive, --snapshot, --pellets, "
+                "--thumbnails and --header-cache need MJPG frames\n");
+        exit(EXIT_FAILURE);
+}
+if (rtp_output && force_format && V4L2_PIX_FMT_H264 == pixelformat)
+        rtp_h264 = 1;
+else if (rtp_output && force_format && V4L2_PIX_FMT_MJPEG != pixelformat) {
+        fprintf(stderr, "--rtp needs MJPG or H264 frames\n");
+        exit(EXIT_FAILURE);
+}
+if (on_demand && (clip_dir || lapse_dir || archive_dir || snapshots || pellets)) {
+        /* these need frames whether anyone watches or not */
+        fprintf(stderr, "--on-demand can't be combined with --clips, --timelapse, --archive, "
+                "--snapshot or --pellets\n");
+        exit(EXIT_FAILURE);
+}
+if (rtp_output && fec_data) {
+        fprintf(stderr, "--fec is for the framed transport, not --rtp\n");
+        exit(EXIT_FAILURE);
+}
+if (rtp_output && header_cache) {
+        /* RTP/JPEG leaves the header out anyway */
+        fprintf(stderr, "--header-cache is for the framed transport, not --rtp\n");
+        exit(EXIT_FAILURE);
+}
+if (adapt && (rtp_output || !force_format || clip_dir || lapse_dir)) {
+        /* link reports come from the framed receiver; an AVI keeps the size it started with */
+        fprintf(stderr, "--adapt can't be combined with --rtp, --keep-format, --clips or --timelapse\n");
+        exit(EXIT_FAILURE);
+}
+if (yield_cpu && (!force_format || clip_dir || lapse_dir)) {
+        fprintf(stderr, "--yield-cpu can't be combined with --keep-format, --clips or --timelapse\n");
+        exit(EXIT_FAILURE);
+}
+if (thumbnail_fps && (rtp_output || latest_frame || zerocopy)) {
+        /*
+         * a thumbnail is a stream of its own, which RTP has no room for, and
+         * is sent from one buffer by the capture loop
+         */
+        fprintf(stderr, "--thumbnails can't be combined with --rtp, --latest or --zerocopy\n");
+        exit(EXIT_FAILURE);
+}
+if (zerocopy && IO_METHOD_MMAP != io) {
+        /* completions are tracked per mmap buffer, which a dmabuf consumer may hold too */
+        fprintf(stderr, "--zerocopy can't be combined with --userptr or --dmabuf\n");
+        exit(EXIT_FAILURE);
+}
+if (zerocopy && latest_frame) {
+        /* the mailbox copies frames out, so there is nothing to send zero-copy */
+        fprintf(stderr, "--zerocopy and --latest can't be combined\n");
+        exit(EXIT_FAILURE);
+}
+if (handover && (IO_METHOD_MMAP != io || on_demand || zerocopy || latest_frame || adapt || yield_cpu)) {
+        /* each of these holds buffers outside the driver, or restarts the streams */
+        fprintf(stderr, "--handover can't be combined with --userptr, --dmabuf, --on-demand, --zerocopy, "
+                "--latest, --adapt or --yield-cpu\n");
+        exit(EXIT_FAILURE);
+}
+if (!!dest_host + !!fleet_host + discover > 1) {
+        /* each of them picks the destination */
+        fprintf(stderr, "--dest, --fleet and --discover can't be combined\n");
+        exit(EXIT_FAILURE);
+}
+if (fleet && !board_id[0] && -1 == gethostname(board_id, sizeof(board_id) - 1))
+        errno_exit("gethostname");
+if (strpbrk(board_id, " \t\n")) {
+        fprintf(stderr, "board id can't contain spaces\n");
+        exit(EXIT_FAILURE);
+}
+#ifdef FISHFEEDER_UNIFIED
+boardLink_optionsParsed();
+register_capture_metrics();
+#endif
 printf("Starting streaming\n");
 openConnectionT();
-dev_name = "/dev/video0";
-force_format=2;
+if (handover)
+        taken_over = take_over();
+if (dest_host || fleet_host)
+        set_destination(dest_host ? dest_host : fleet_host);
+else if (discover)
+        discover_gateway();
+if ((on_demand || adapt) && is_multicast()) {
+        /* any one receiver's reports would turn the camera off or down for the others */
+        fprintf(stderr, "--on-demand and --adapt need a unicast destination\n");
+        exit(EXIT_FAILURE);
+}
+configure_socket();
+if (fec_data)
+        init_fec();
+if (header_cache)
+        init_header_cache();
+if (zerocopy)
+        enable_zerocopy();
+if (rtp_output) {
+        rtp_ssrc = (uint32_t)time(NULL) ^ ((uint32_t)getpid() << 16);
+        if (writeSdpT(RTP_SDP_PATH) < 0)
+                errno_exit(RTP_SDP_PATH);
+        printf("%s session described in %s\n", rtp_h264 ? "RTP/H264" : "RTP/JPEG", RTP_SDP_PATH);
+}
+if (motion_threshold >= 0 || clip_dir || pellets)
+        open_feed_events();
+if (clip_dir)
+        start_clips();
+if (lapse_dir)
+        start_lapses(n_devices);
+if (archive_dir)
+        start_archives(n_devices);
+if (snapshots)
+        start_snapshots();
+if (profiles_file)
+        start_profiles();
+if (IO_METHOD_DMABUF == io)
+        start_dmabuf();
 out_buf++;
-// errno = 0;
-char opt = '0';
-frame_count = strtol(&opt, NULL, 0);
-if(errno) errno_exit(&opt);
-open_device();
-init_device();
-start_capturing();
+for (d = 0; d < n_devices; d++) {
+        if (!taken_over)
+                open_device(&devices[d]);
+        init_device(&devices[d]);
+}
+/* taken over, they are streaming already */
+for (d = 0; d < n_devices; d++)
+        if (taken_over)
+                devices[d].last_frame_ms = monotonic_ms();
+        else
+                start_capturing(&devices[d]);
+if (handover)
+        listen_for_handover();
+if (adapt || yield_cpu)
+        start_adapting();
+if (latest_frame)
+        start_sender();
 mainloop();
-stop_capturing();
-uninit_device();
-close_device();
+if (latest_frame)
+        stop_sender();
+if (IO_METHOD_DMABUF == io)
+        stop_dmabuf();
+/* handed over, the streams are the new capture's */
+if (!handed_over)
+        for (d = 0; d < n_devices; d++)
+                stop_capturing(&devices[d]);
+stop_handover();
+if (zerocopy)
+        drain_zerocopy();
+for (d = 0; d < n_devices; d++) {
+        uninit_device(&devices[d]);
+        close_device(&devices[d]);
+}
+if (snapshots)
+        stop_snapshots();
+if (clip_dir)
+        stop_clips();
+if (lapse_dir)
+        stop_lapses(n_devices);
+if (archive_dir)
+        stop_archives(n_devices);
+if (motion_threshold >= 0)
+        fprintf(stderr, "%lu static frames held back\n", frames_gated);
+if (frames_truncated)
+        fprintf(stderr, "%lu truncated frames dropped\n", frames_truncated);
+if (motion_threshold >= 0 || activity_file)
+        jpeg_activity_reset();
+if (activity_file)
+        fclose(activity_file);
+close_feed_events();
 fprintf(stderr, "\n");
 
 closeConnectionT();
@@ -0,0 +1,81 @@
+// Talks to the feeder daemon's control socket (control_server.c in the microphone demo): plain HTTP/1.0
+// over a Unix socket, one request per connection, JSON back. GET /events instead stays open and carries one
+// JSON event per line.
+const http = require('http');
+
+const CONTROL_PATH = '/tmp/fishfeeder-control.sock';
+const CONTROL_TIMEOUT_MS = 2000;
+// the daemon not running yet, or restarting, is waited out
+const RECONNECT_MS = 2000;
+
+function requestFeeder(method, path, params, callback, socketPath = CONTROL_PATH) {
+const form = new URLSearchParams(params || {}).toString();
+const request = http.request({
+socketPath,
+method,
+path,
+headers: { 'Content-Type': 'application/x-www-form-urlencoded', 'Content-Length': Buffer.byteLength(form) },
+timeout: CONTROL_TIMEOUT_MS,
+}, (response) => {
+const chunks = [];
+response.on('data', (data) => chunks.push(data));
+response.on('end', () => callback(null, response.statusCode, Buffer.concat(chunks).toString()));
+});
+// the daemon not running is reported like any other failure
+request.on('timeout', () => request.destroy(new Error('feeder timed out')));
+request.on('error', (err) => callback(err));
+request.end(form);
+}
+
+// onEvent(event) hears every event from the daemon for as long as the relay runs
+function subscribeFeederEvents(onEvent, socketPath = CONTROL_PATH) {
+let retry = null;
+function reconnect() {
+if (!retry) {
+retry = setTimeout(connect, RECONNECT_MS);
+retry.unref();
+}
+}
+function connect() {
+retry = null;
+const request = http.get({ socketPath, path: '/events' }, (response) => {
+let partial = '';
+response.setEncoding('utf8');
+response.on('data', (data) => {
+const lines = (partial + data).split('\n');
+partial = lines.pop();
+for (const line of lines) {
+try {
+onEvent(JSON.parse(line));
+} catch (err) {
+// a line cut short by a restart is skipped
+}
+}
+});
+response.on('end', reconnect);
+response.on('error', reconnect);
+});
+request.on('error', reconnect);
+}
+connect();
+}
+
+// Tells the daemon how many are watching, so it keeps the board's CPUs at full speed while anyone is (cpu_frequency.c
+// in the microphone demo): on every change, and every few seconds besides, so a daemon restarted meanwhile hears it too
+const VIEWERS_REPORT_MS = 10000;
+function createFeederViewerReporter(socketPath = CONTROL_PATH) {
+let viewers = 0;
+function report() {
+// the daemon not running is not an error
+requestFeeder('POST', '/viewers', { count: viewers }, () => {}, socketPath);
+}
+setInterval(report, VIEWERS_REPORT_MS).unref();
+return (count) => {
+if (count !== viewers) {
+viewers = count;
+report();
+}
+};
+}
+
+module.exports = { requestFeeder, subscribeFeederEvents, createFeederViewerReporter, CONTROL_PATH };
@@ -0,0 +1,248 @@
+// Fleet mode (FLEET=1): one relay for many boards. Every board's capture.c --fleet or --discover streams to the
+// same UDP port, and registers from it every few seconds ("register <board> <streams> <metrics port>"), so frames are
+// told apart by their source address and each board gets its own frame assembler. Stream n of board b is the channel
+// "b/n", its thumbnails (capture.c --thumbnails) "b/<THUMBNAIL_STREAM_BASE + n>", and viewers subscribe to the channels
+// they open (see viewerHub.js). Each board hears back how many viewers
+// it has, which capture.c --on-demand acts on, and how its stream arrives, for --adapt. Boards that stop registering
+// are forgotten.
+//
+// Boards find the gateway by broadcasting "discover fishfeeder" to DISCOVERY_PORT; the answer is the stream port.
+// The boards' metrics (the microphone demo's --metrics_port) are scraped on demand and served as one exposition, each
+// series labelled with its board. They are also scraped every historyMs and kept as history, see metricsHistory.js.
+const dgram = require('dgram');
+const http = require('http');
+const { createFrameAssembler, RECV_BUFFER_SIZE, LINK_REPORT_MS, THUMBNAIL_STREAM_BASE } = require('./frameReceiver.js');
+const { createMetricsHistory } = require('./metricsHistory.js');
+
+const DISCOVERY_PORT = 1235;
+const DISCOVERY_QUERY = 'discover fishfeeder';
+// three registrations missed
+const REGISTER_TIMEOUT_MS = 15000;
+const REPORT_INTERVAL_MS = 5000;
+const SCRAPE_TIMEOUT_MS = 2000;
+const BOARD_ID = /^[A-Za-z0-9_.-]{1,63}$/;
+
+// historyMs is how often the boards' metrics are scraped for history, 0 for none
+function createFleetGateway(port, historyMs = 1000) {
+const socket = dgram.createSocket({ type: 'udp4', recvBufferSize: RECV_BUFFER_SIZE });
+const discovery = dgram.createSocket({ type: 'udp4', reuseAddr: true });
+const boards = new Map(); // "address:port" -> { id, address, port, streams, metricsPort, lastSeen, push }
+let onFrame = null;
+let channelViewers = new Map();
+const history = createMetricsHistory();
+let isRecording = false;
+
+function register(key, rinfo, text) {
+const [, id, streams, metricsPort] = text.trim().split(' ');
+if (!BOARD_ID.test(id || '')) {
+return;
+}
+let board = boards.get(key);
+if (!board || board.id !== id) {
+// a board that rebooted comes back from another port
+for (const [otherKey, other] of boards) {
+if (other.id === id) {
+boards.delete(otherKey);
+}
+}
+board = { id, address: rinfo.address, port: rinfo.port,
+push: createFrameAssembler((frame, timestampMs, streamId, sequence, timing) => {
+if (onFrame) {
+onFrame(frame, timestampMs, `${id}/${streamId}`, sequence, timing);
+}
+}) };
+boards.set(key, board);
+console.log(`board ${id} registered from ${key}`);
+}
+board.streams = Math.max(1, Number(streams) || 1);
+board.metricsPort = Number(metricsPort) || 0;
+board.lastSeen = Date.now();
+}
+
+socket.on('message', (msg, rinfo) => {
+const key = `${rinfo.address}:${rinfo.port}`;
+if (msg.length < 128 && msg.toString('latin1', 0, 9) === 'register ') {
+register(key, rinfo, msg.toString('latin1'));
+return;
+}
+// frames from a board that hasn't registered yet are dropped until it does
+const board = boards.get(key);
+if (board) {
+board.push(msg);
+}
+});
+discovery.on('message', (msg, rinfo) => {
+if (msg.toString('latin1') === DISCOVERY_QUERY) {
+discovery.send(`gateway ${port}`, rinfo.port, rinfo.address);
+}
+});
+socket.on('error', (err) => console.log(`fleet gateway: ${err.message}`));
+discovery.on('error', (err) => console.log(`fleet discovery: ${err.message}`));
+socket.bind(port);
+discovery.bind(DISCOVERY_PORT);
+
+// a viewer with two channels of a board open counts twice; capture.c only cares whether there are none, and a
+// thumbnail needs the camera as much as the full frames do
+function reportViewers() {
+for (const board of boards.values()) {
+let viewers = 0;
+for (let stream = 0; stream < board.streams; stream++) {
+viewers += channelViewers.get(`${board.id}/${stream}`) || 0;
+viewers += channelViewers.get(`${board.id}/${THUMBNAIL_STREAM_BASE + stream}`) || 0;
+}
+socket.send(`viewers ${viewers}\n`, board.port, board.address);
+}
+}
+
+setInterval(() => {
+const now = Date.now();
+for (const [key, board] of boards) {
+if (now - board.lastSeen > REGISTER_TIMEOUT_MS) {
+boards.delete(key);
+console.log(`board ${board.id} gone`);
+}
+}
+reportViewers();
+}, REPORT_INTERVAL_MS).unref();
+
+// each board's link, for capture.c --adapt
+setInterval(() => {
+for (const board of boards.values()) {
+const { lossPermille, jitterMs, kbps } = board.push.takeLinkStats();
+socket.send(`link ${lossPermille} ${jitterMs} ${kbps}\n`, board.port, board.address);
+}
+}, LINK_REPORT_MS).unref();
+
+function list() {
+const now = Date.now();
+return [...boards.values()].map((board) => ({
+id: board.id,
+address: board.address,
+channels: Array.from({ length: board.streams }, (_, stream) => `${board.id}/${stream}`),
+// thumbnails[n] is channels[n]'s, if the board sends them
+thumbnails: Array.from({ length: board.streams }, (_, stream) => `${board.id}/${THUMBNAIL_STREAM_BASE + stream}`),
+metrics: board.metricsPort > 0,
+lastSeenMs: now - board.lastSeen,
+}));
+}
+
+function scrape(board) {
+return new Promise((resolve) => {
+const request = http.get({ host: board.address, port: board.metricsPort, path: '/metrics', timeout: SCRAPE_TIMEOUT_MS },
+(response) => {
+let text = '';
+response.setEncoding('utf8');
+response.on('data', (data) => { text += data; });
+response.on('end', () => resolve({ board: board.id, text: response.statusCode === 200 ? text : '' }));
+response.on('error', () => resolve({ board: board.id, text: '' }));
+});
+request.on('timeout', () => request.destroy());
+request.on('error', () => resolve({ board: board.id, text: '' }));
+});
+}
+
+// a scrape still out when the next is due, from a board slow to answer, holds the next one back
+if (historyMs > 0) {
+setInterval(() => {
+if (isRecording) {
+return;
+}
+isRecording = true;
+// the time the scrape was due, so each lands on its own second however long the boards take
+const nowMs = Date.now();
+Promise.all([...boards.values()].filter((board) => board.metricsPort > 0).map(scrape)).then((scrapes) => {
+for (const { board, text } of scrapes) {
+if (text) {
+history.ingest(board, text, nowMs);
+}
+}
+isRecording = false;
+});
+}, historyMs).unref();
+}
+
+// every board's exposition as one, series grouped by family and labelled board="<id>"; a board that doesn't answer
+// in time is left out and shows as fleet_board_up 0
+function metrics(callback) {
+const targets = [...boards.values()].filter((board) => board.metricsPort > 0);
+Promise.all(targets.map(scrape)).then((scrapes) => {
+const families = new Map(); // name -> { help, type, samples }
+function familyFor(name) {
+let family = families.get(name);
+if (!family) {
+family = { help: null, type: null, samples: [] };
+families.set(name, family);
+}
+return family;
+}
+const up = familyFor('fleet_board_up');
+up.help = 'Whether the board answered the last scrape.';
+up.type = 'gauge';
+const stored = history.stats();
+for (const [name, type, help, value] of [
+['fleet_history_series', 'gauge', 'Series kept as history.', stored.series],
+['fleet_history_bytes', 'gauge', 'Compressed size of the history.', stored.bytes],
+['fleet_history_dropped_series_total', 'counter', 'Series left out of a full history.', stored.droppedSeries],
+]) {
+const family = familyFor(name);
+family.help = help;
+family.type = type;
+family.samples.push(`${name} ${value}`);
+}
+for (const { board, text } of scrapes) {
+up.samples.push(`fleet_board_up{board="${board}"} ${text ? 1 : 0}`);
+let current = null;
+for (const line of text.split('\n')) {
+const comment = /^# (HELP|TYPE) (\S+) (.*)$/.exec(line);
+if (comment) {
+current = familyFor(comment[2]);
+current.name = comment[2];
+if (comment[1] === 'HELP' && current.help === null) {
+current.help = comment[3];
+} else if (comment[1] === 'TYPE' && current.type === null) {
+current.type = comment[3];
+}
+continue;
+}
+if (!line || line[0] === '#') {
+continue;
+}
+const name = /^[^{\s]+/.exec(line)[0];
+// a histogram's _bucket, _sum and _count belong to the family declared above them
+const family = (current && name.startsWith(current.name)) ? current : familyFor(name);
+const rest = line.slice(name.length);
+family.samples.push(rest[0] === '{' ? `${name}{board="${board}",${rest.slice(1)}` : `${name}{board="${board}"}${rest}`);
+}
+}
+let out = '';
+for (const [name, family] of families) {
+if (family.help !== null) {
+out += `# HELP ${name} ${family.help}\n`;
+}
+if (family.type !== null) {
+out += `# TYPE ${name} ${family.type}\n`;
+}
+out += family.samples.map((sample) => sample + '\n').join('');
+}
+callback(out);
+});
+}
+
+return {
+// the hub's ingest: frames flow to onFrame until close(); registrations carry on regardless
+startIngest(sink) {
+onFrame = sink;
+return { close() { onFrame = null; } };
+},
+// channel -> viewer count, as viewerHub's channelViewers() gives it
+setViewers(counts) {
+channelViewers = counts;
+reportViewers();
+},
+list,
+metrics,
+history,
+};
+}
+
+module.exports = { createFleetGateway, DISCOVERY_PORT };
@@ -0,0 +1,353 @@
+// Reassembles the framed MJPEG transport sent by capture.c (sendFrameT).
+// Every datagram carries a 32-byte big-endian header:
+//   magic u16, chunkIndex u16, chunkCount u16, streamId u16,
+//   frameId u32, timestampMs u32, frameSize u32, chunkOffset u32,
+//   captureSequence u32, queueMs u16, boardMs u16
+// followed by up to one MTU of frame data. Each camera is its own stream, with its own frame ids, and so is each
+// camera's thumbnail stream (capture.c --thumbnails), THUMBNAIL_STREAM_BASE up. The last three say where the frame's
+// time went on the board (see struct frame_stamp in capture.c).
+//
+// capture.c --header-cache sends a stream's JPEG header, everything up to the scan data, only now and then: a frame
+// whose magic is 'H' is whole and its header is kept, one whose magic is 'S' is the scan data alone and gets the header
+// put back in front. The magic's low byte is the header's generation; a scan whose header hasn't arrived is dropped.
+//
+// A datagram with magic 'DS' is a header alone: capture.c telling that the stream's camera stalled, and was restarted
+// or reopened, frameId times so far.
+const dgram = require('dgram');
+
+const FRAME_MAGIC = 0x464d;
+const MAGIC_HEADER = 0x48;
+const MAGIC_SCAN = 0x53;
+const STALL_MAGIC = 0x4453;
+const HEADER_SIZE = 32;
+// frames arrive in order, so anything older than this many frames, or this old, will not complete
+const MAX_PENDING_FRAMES = 2;
+const FRAME_TIMEOUT_MS = 200;
+// a whole frame arrives as one burst of datagrams; the default socket buffer drops the tail of big frames
+const RECV_BUFFER_SIZE = 4 * 1024 * 1024;
+// capture.c's FRAME_CHUNK_PAYLOAD: every chunk but a frame's last is this long
+const CHUNK_PAYLOAD = 1500 - 20 - 8 - HEADER_SIZE;
+// the lowest transit time of the last two windows this long stands in for the link's own delay
+const TRANSIT_WINDOW_MS = 10000;
+// a jump in frame ids further than this is capture.c restarting, not loss
+const MAX_MISSED_FRAMES = 30;
+const LINK_REPORT_MS = 1000;
+// camera n's thumbnails are stream THUMBNAIL_STREAM_BASE + n
+const THUMBNAIL_STREAM_BASE = 0x100;
+
+// capture.c --fec k+m adds m parity datagrams per group of k chunks after a frame's own: chunkIndex counts on from
+// chunkCount, chunkOffset is k << 16 | m, and chunk i is in group i % groups. A group's parity is a Reed-Solomon code
+// over GF(2^8) with coefficient 1 / ((k + j) ^ r) for parity j and the group's r-th chunk, so any m of its chunks that
+// went missing can be solved for from the rest.
+const GF_EXP = new Uint8Array(512);
+const GF_LOG = new Uint8Array(256);
+for (let i = 0, x = 1; i < 255; i++) {
+GF_EXP[i] = GF_EXP[i + 255] = x;
+GF_LOG[x] = i;
+x <<= 1;
+if (x & 0x100) {
+x ^= 0x11d;
+}
+}
+
+function gfMul(a, b) {
+return (a && b) ? GF_EXP[GF_LOG[a] + GF_LOG[b]] : 0;
+}
+
+function gfInverse(a) {
+return GF_EXP[255 - GF_LOG[a]];
+}
+
+// dst ^= c * src
+function gfMulAdd(dst, src, c) {
+if (!c) {
+return;
+}
+const cLog = GF_LOG[c];
+for (let i = 0; i < src.length; i++) {
+if (src[i]) {
+dst[i] ^= GF_EXP[cLog + GF_LOG[src[i]]];
+}
+}
+}
+
+// Inverts a small square matrix in place by Gauss-Jordan elimination; a Cauchy submatrix always has an inverse.
+function gfInvert(matrix) {
+const n = matrix.length;
+const inverse = matrix.map((row, i) => row.map((_, j) => (i === j ? 1 : 0)));
+for (let col = 0; col < n; col++) {
+let pivot = col;
+while (!matrix[pivot][col]) {
+pivot++;
+}
+[matrix[col], matrix[pivot]] = [matrix[pivot], matrix[col]];
+[inverse[col], inverse[pivot]] = [inverse[pivot], inverse[col]];
+const scale = gfInverse(matrix[col][col]);
+for (let j = 0; j < n; j++) {
+matrix[col][j] = gfMul(matrix[col][j], scale);
+inverse[col][j] = gfMul(inverse[col][j], scale);
+}
+for (let row = 0; row < n; row++) {
+const factor = matrix[row][col];
+if (row !== col && factor) {
+for (let j = 0; j < n; j++) {
+matrix[row][j] ^= gfMul(factor, matrix[col][j]);
+inverse[row][j] ^= gfMul(factor, inverse[col][j]);
+}
+}
+}
+}
+return inverse;
+}
+
+// Rebuilds the missing chunks of group g of frame once enough of its parity is in.
+function recoverGroup(frame, g, chunkCount, frameSize) {
+const { k, m, groups, parity } = frame.fec;
+const members = [];
+for (let i = g; i < chunkCount; i += groups) {
+members.push(i);
+}
+const lost = members.filter((i) => !frame.chunks[i]);
+const rows = [];
+for (let j = 0; j < m && rows.length < lost.length; j++) {
+if (parity.has(g * m + j)) {
+rows.push(j);
+}
+}
+if (!lost.length || rows.length < lost.length) {
+return;
+}
+const coeff = (j, r) => gfInverse((k + j) ^ r);
+// what the parity holds of the lost chunks alone, once the received ones are taken out
+const sums = rows.map((j) => {
+const sum = Buffer.from(parity.get(g * m + j));
+members.forEach((i, r) => {
+if (frame.chunks[i]) {
+const offset = i * CHUNK_PAYLOAD;
+gfMulAdd(sum, frame.data.subarray(offset, Math.min(offset + CHUNK_PAYLOAD, frameSize)), coeff(j, r));
+}
+});
+return sum;
+});
+const inverse = gfInvert(rows.map((j) => lost.map((i) => coeff(j, members.indexOf(i)))));
+lost.forEach((i, l) => {
+const chunk = Buffer.alloc(sums[0].length);
+rows.forEach((_, row) => gfMulAdd(chunk, sums[row], inverse[l][row]));
+const offset = i * CHUNK_PAYLOAD;
+chunk.copy(frame.data, offset, 0, Math.min(CHUNK_PAYLOAD, frameSize - offset));
+frame.chunks[i] = 1;
+frame.received++;
+});
+}
+
+// just past SOS, where the scan data starts, or -1
+function scanStart(jpeg) {
+let i = 2;
+while (i + 4 <= jpeg.length && jpeg[i] === 0xff) {
+const marker = jpeg[i + 1];
+if (marker === 0xff) {
+i++;
+continue;
+}
+const end = i + 2 + jpeg.readUInt16BE(i + 2);
+if (marker === 0xda) {
+return end <= jpeg.length ? end : -1;
+}
+i = end;
+}
+return -1;
+}
+
+// Returns push(datagram) for the datagrams of one sender; onFrame(jpeg, timestampMs, streamId, sequence) gets exactly one
+// whole frame at a time, sequence being capture.c's frame id. Anything that isn't a frame chunk is ignored.
+// push.takeLinkStats() tells how the link did since it was last called, for capture.c --adapt: the share of chunks lost
+// before any FEC, whole frames that never showed up counted at the size of the frame after them; the RFC 3550 jitter of
+// the frames' arrival against their capture.c timestamps; and the frame data that arrived, in kbit/s.
+//
+// Each frame's onFrame also gets a timing: { captureSequence, queueMs, boardMs, captureStalls, networkMs, assemblyMs }.
+// captureStalls is the stream's latest 'DS' count, 0 before any. The board and this host don't share a clock, so
+// networkMs is the frame's transit time above the lowest seen lately: the queueing a congested link adds, not its fixed
+// delay. assemblyMs is from the frame's first datagram to its last, FEC included.
+function createFrameAssembler(onFrame) {
+const streams = new Map(); // streamId -> { pending: frameId -> { whole, data, received, chunks, firstSeen }, lastDelivered, newest, header, stalls }
+const link = { expected: 0, received: 0, bytes: 0, jitter: 0, lastTransit: null, since: Date.now() };
+
+function streamFor(streamId) {
+let stream = streams.get(streamId);
+if (!stream) {
+stream = { pending: new Map(), lastDelivered: -1, newest: -1, minTransit: Infinity, lastMinTransit: Infinity,
+transitSince: Date.now(), header: null, stalls: 0 };
+streams.set(streamId, stream);
+}
+return stream;
+}
+
+function dropStale(pending, now) {
+for (const [id, frame] of pending) {
+if (pending.size > MAX_PENDING_FRAMES || now - frame.firstSeen > FRAME_TIMEOUT_MS) {
+pending.delete(id);
+}
+}
+}
+
+function push(msg) {
+if (msg.length < HEADER_SIZE) {
+return;
+}
+const magic = msg.readUInt16BE(0);
+if (magic === STALL_MAGIC) {
+streamFor(msg.readUInt16BE(6)).stalls = msg.readUInt32BE(8);
+return;
+}
+if (magic !== FRAME_MAGIC && magic >> 8 !== MAGIC_HEADER && magic >> 8 !== MAGIC_SCAN) {
+return;
+}
+const chunkIndex = msg.readUInt16BE(2);
+const chunkCount = msg.readUInt16BE(4);
+const streamId = msg.readUInt16BE(6);
+const frameId = msg.readUInt32BE(8);
+const timestampMs = msg.readUInt32BE(12);
+const frameSize = msg.readUInt32BE(16);
+const chunkOffset = msg.readUInt32BE(20);
+const payload = msg.subarray(HEADER_SIZE);
+const stream = streamFor(streamId);
+const { pending } = stream;
+if (frameId <= stream.lastDelivered && stream.lastDelivered - frameId < 0x80000000) {
+return; // late chunk of a frame already shown or dropped
+}
+const isParity = chunkIndex >= chunkCount;
+if (isParity ? !(chunkOffset >>> 16) || !(chunkOffset & 0xffff) :
+chunkOffset !== chunkIndex * CHUNK_PAYLOAD || chunkOffset + payload.length > frameSize) {
+return;
+}
+
+const now = Date.now();
+if (stream.newest < 0 || (frameId - stream.newest) >>> 0 < 0x80000000 && frameId !== stream.newest) {
+// the first datagram of a new frame
+const missed = stream.newest < 0 ? 0 : Math.min((frameId - stream.newest - 1) >>> 0, MAX_MISSED_FRAMES);
+stream.newest = frameId;
+link.expected += chunkCount * (1 + missed);
+// timestamps are capture.c's clock and now is ours; only the change in their difference matters
+const transit = (now - timestampMs) | 0;
+if (now - stream.transitSince > TRANSIT_WINDOW_MS) {
+stream.lastMinTransit = stream.minTransit;
+stream.minTransit = Infinity;
+stream.transitSince = now;
+}
+stream.minTransit = Math.min(stream.minTransit, transit);
+if (link.lastTransit !== null) {
+link.jitter += (Math.abs((transit - link.lastTransit) | 0) - link.jitter) / 16;
+}
+link.lastTransit = transit;
+}
+if (!isParity) {
+link.received++;
+link.bytes += payload.length;
+}
+let frame = pending.get(frameId);
+if (!frame) {
+// a scan is assembled straight behind its header, in the Buffer that is handed on
+let header = null;
+if (magic >> 8 === MAGIC_SCAN) {
+if (!stream.header || stream.header.generation !== (magic & 0xff)) {
+return; // the next header comes within a second
+}
+header = stream.header.bytes;
+}
+const whole = Buffer.alloc((header ? header.length : 0) + frameSize);
+if (header) {
+header.copy(whole);
+}
+frame = { whole, data: whole.subarray(header ? header.length : 0), received: 0, chunks: new Uint8Array(chunkCount),
+firstSeen: now, fec: null, transit: (now - timestampMs) | 0 };
+pending.set(frameId, frame);
+dropStale(pending, now);
+}
+let group;
+if (isParity) {
+if (!frame.fec) {
+const k = chunkOffset >>> 16;
+frame.fec = { k, m: chunkOffset & 0xffff, groups: Math.ceil(chunkCount / k), parity: new Map() };
+}
+const p = chunkIndex - chunkCount;
+if (frame.fec.parity.has(p) || p >= frame.fec.groups * frame.fec.m) {
+return;
+}
+frame.fec.parity.set(p, payload);
+group = Math.floor(p / frame.fec.m);
+} else {
+if (frame.chunks[chunkIndex]) {
+return;
+}
+frame.chunks[chunkIndex] = 1;
+frame.received++;
+payload.copy(frame.data, chunkOffset);
+group = frame.fec ? chunkIndex % frame.fec.groups : -1;
+}
+if (frame.fec && frame.received < chunkCount) {
+recoverGroup(frame, group, chunkCount, frameSize);
+}
+
+if (frame.received === chunkCount) {
+// older frames still pending can only be shown out of order; give up on them
+for (const id of pending.keys()) {
+if ((frameId - id) >>> 0 < 0x80000000) {
+pending.delete(id);
+}
+}
+stream.lastDelivered = frameId;
+if (magic >> 8 === MAGIC_HEADER) {
+const scan = scanStart(frame.data);
+if (scan > 0) {
+// a copy: the frame itself is handed on, possibly to another thread
+stream.header = { generation: magic & 0xff, bytes: Buffer.from(frame.data.subarray(0, scan)) };
+}
+}
+onFrame(frame.whole, timestampMs, streamId, frameId, {
+captureSequence: msg.readUInt32BE(24),
+queueMs: msg.readUInt16BE(28),
+boardMs: msg.readUInt16BE(30),
+captureStalls: stream.stalls,
+networkMs: Math.max(0, frame.transit - Math.min(stream.minTransit, stream.lastMinTransit)),
+assemblyMs: now - frame.firstSeen,
+});
+}
+}
+
+push.takeLinkStats = () => {
+const now = Date.now();
+const lost = Math.max(0, link.expected - link.received);
+const stats = {
+lossPermille: link.expected ? Math.round(lost * 1000 / link.expected) : 0,
+jitterMs: Math.round(link.jitter),
+kbps: Math.round(link.bytes * 8 / Math.max(1, now - link.since)),
+};
+link.expected = link.received = link.bytes = 0;
+link.since = now;
+return stats;
+};
+return push;
+}
+
+// capture.c --dest with a multicast group: every receiver of the stream joins it
+function joinGroup(socket, group) {
+if (group) {
+socket.addMembership(group);
+}
+}
+
+// onLink(stats), if given, hears push.takeLinkStats() every LINK_REPORT_MS while the socket is open
+function createFrameReceiver(port, onFrame, group, onLink) {
+const socket = dgram.createSocket({ type: 'udp4', recvBufferSize: RECV_BUFFER_SIZE, reuseAddr: Boolean(group) });
+const push = createFrameAssembler(onFrame);
+socket.on('message', push);
+if (onLink) {
+const timer = setInterval(() => onLink(push.takeLinkStats()), LINK_REPORT_MS);
+socket.on('close', () => clearInterval(timer));
+}
+socket.bind(port, () => joinGroup(socket, group));
+return socket;
+}
+
+module.exports = { createFrameReceiver, createFrameAssembler, joinGroup, RECV_BUFFER_SIZE, LINK_REPORT_MS,
+THUMBNAIL_STREAM_BASE };
@@ -0,0 +1,210 @@
+// A plain WebSocket (RFC 6455) for the frames, taken over from the relay's HTTP server by its upgrade event, with none
+// of socket.io's framing, engine.io packets or attachment placeholders on each frame. Only what the relay needs is
+// here: binary and text messages out, unfragmented messages of a few bytes in (the page's acknowledgements), ping,
+// pong and close. permessage-deflate is never offered, so JPEGs, which don't compress, aren't run through zlib either
+// way.
+//
+// Each frame is one binary message: a FRAME_HEADER_BYTES header, the streamId's UTF-8 bytes, then the frame's own.
+// The header, big-endian:
+//   0  kind: FRAME_KIND_JPEG or FRAME_KIND_H264
+//   1  length of the streamId
+//   2  ack id, which the page's acknowledgement gives back
+//   4  sequence
+//   8  capture timestamp, ms since 1970, as a double
+// An acknowledgement is ACK_BYTES: ACK_TYPE, 1 if the frame was dropped rather than drawn, the ack id, and the ms it
+// took to draw, all big-endian.
+const crypto = require('crypto');
+
+const WEBSOCKET_GUID = '258EAFA5-E914-47DA-95CA-C5AB0DC85B11';
+const OPCODE_TEXT = 0x1;
+const OPCODE_BINARY = 0x2;
+const OPCODE_CLOSE = 0x8;
+const OPCODE_PING = 0x9;
+const OPCODE_PONG = 0xa;
+const FRAME_HEADER_BYTES = 16;
+const FRAME_KIND_JPEG = 0;
+const FRAME_KIND_H264 = 1;
+const ACK_TYPE = 1;
+const ACK_BYTES = 6;
+// bigger than any message the page sends
+const MAX_MESSAGE_BYTES = 1024;
+// a page that answers nothing, not even a ping, for this long is gone
+const PING_INTERVAL_MS = 25000;
+
+// the message header for a payload this long, unmasked, as a server sends
+function messageHeader(opcode, length) {
+if (length < 126) {
+return Buffer.from([0x80 | opcode, length]);
+}
+if (length < 0x10000) {
+const header = Buffer.alloc(4);
+header[0] = 0x80 | opcode;
+header[1] = 126;
+header.writeUInt16BE(length, 2);
+return header;
+}
+const header = Buffer.alloc(10);
+header[0] = 0x80 | opcode;
+header[1] = 127;
+header.writeBigUInt64BE(BigInt(length), 2);
+return header;
+}
+
+// { send(parts), sendText(text), close(), onmessage(buffer), onclose() } over an upgraded socket; head is what came in
+// after the upgrade request
+function createFrameSocket(socket, head) {
+let received = head.length ? Buffer.from(head) : Buffer.alloc(0);
+let heard = true;
+let closed = false;
+const frameSocket = { send, sendText, close, onmessage: () => {}, onclose: () => {} };
+
+function write(opcode, parts) {
+if (closed) {
+return;
+}
+const length = parts.reduce((sum, part) => sum + part.length, 0);
+// one write to the kernel for the lot, and the frame's bytes are never copied
+socket.cork();
+socket.write(messageHeader(opcode, length));
+for (const part of parts) {
+socket.write(part);
+}
+socket.uncork();
+}
+
+// parts are Buffers sent back to back as one binary message
+function send(parts) {
+write(OPCODE_BINARY, parts);
+}
+
+function sendText(text) {
+write(OPCODE_TEXT, [Buffer.from(text)]);
+}
+
+function close(code = 1000) {
+if (!closed) {
+const payload = Buffer.alloc(2);
+payload.writeUInt16BE(code);
+write(OPCODE_CLOSE, [payload]);
+socket.end();
+}
+finish();
+}
+
+function finish() {
+if (closed) {
+return;
+}
+closed = true;
+clearInterval(pinger);
+socket.destroy();
+frameSocket.onclose();
+}
+
+// whole messages off the front of what has come in
+function parse() {
+while (received.length >= 2) {
+const fin = received[0] & 0x80;
+const opcode = received[0] & 0x0f;
+const masked = received[1] & 0x80;
+let length = received[1] & 0x7f;
+let offset = 2;
+if (length === 126) {
+if (received.length < 4) {
+return;
+}
+length = received.readUInt16BE(2);
+offset = 4;
+} else if (length === 127) {
+close(1009); // far beyond an acknowledgement
+return;
+}
+// a page always masks, and has no reason to split a message of a few bytes
+if (!masked || !fin || length > MAX_MESSAGE_BYTES) {
+close(masked ? 1009 : 1002);
+return;
+}
+if (received.length < offset + 4 + length) {
+return;
+}
+const mask = received.subarray(offset, offset + 4);
+const payload = Buffer.from(received.subarray(offset + 4, offset + 4 + length));
+for (let i = 0; i < payload.length; i++) {
+payload[i] ^= mask[i & 3];
+}
+received = received.subarray(offset + 4 + length);
+heard = true;
+if (opcode === OPCODE_CLOSE) {
+close();
+return;
+}
+if (opcode === OPCODE_PING) {
+write(OPCODE_PONG, [payload]);
+} else if (opcode === OPCODE_BINARY || opcode === OPCODE_TEXT) {
+frameSocket.onmessage(payload);
+}
+}
+}
+
+const pinger = setInterval(() => {
+if (!heard) {
+finish();
+return;
+}
+heard = false;
+write(OPCODE_PING, []);
+}, PING_INTERVAL_MS);
+socket.setNoDelay(true);
+socket.on('data', (data) => {
+received = received.length ? Buffer.concat([received, data]) : data;
+parse();
+});
+socket.on('close', finish);
+socket.on('error', finish);
+if (received.length) {
+process.nextTick(parse);
+}
+return frameSocket;
+}
+
+// Answers WebSocket upgrades to path on server with onSocket(frameSocket, searchParams); every other upgrade, e.g.
+// socket.io's, is left to its own listener.
+function acceptFrameSockets(server, path, onSocket) {
+server.on('upgrade', (req, socket, head) => {
+const url = new URL(req.url, 'http://relay');
+if (url.pathname !== path) {
+return;
+}
+const key = req.headers['sec-websocket-key'];
+if (String(req.headers.upgrade).toLowerCase() !== 'websocket' || !key) {
+socket.end('HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n');
+return;
+}
+const accept = crypto.createHash('sha1').update(key + WEBSOCKET_GUID).digest('base64');
+// no Sec-WebSocket-Extensions, whatever the browser offered: permessage-deflate stays off
+socket.write('HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n' +
+`Sec-WebSocket-Accept: ${accept}\r\n\r\n`);
+onSocket(createFrameSocket(socket, head), url.searchParams);
+});
+}
+
+// the header in front of a frame's streamId and bytes
+function frameHeader(kind, streamIdBytes, ackId, sequence, timestampMs) {
+const header = Buffer.alloc(FRAME_HEADER_BYTES);
+header[0] = kind;
+header[1] = streamIdBytes;
+header.writeUInt16BE(ackId & 0xffff, 2);
+header.writeUInt32BE(sequence >>> 0, 4);
+header.writeDoubleBE(Number(timestampMs) || 0, 8);
+return header;
+}
+
+// { ackId, report: { drawMs, dropped } } of an acknowledgement, or null for anything else
+function parseAck(message) {
+if (message.length !== ACK_BYTES || message[0] !== ACK_TYPE) {
+return null;
+}
+return { ackId: message.readUInt16BE(2), report: { drawMs: message.readUInt16BE(4), dropped: message[1] === 1 } };
+}
+
+module.exports = { acceptFrameSockets, frameHeader, parseAck, FRAME_KIND_JPEG, FRAME_KIND_H264 };
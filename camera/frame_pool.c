@@ -0,0 +1,174 @@
+/*
+ * Frame buffer pool, see frame_pool.h.
+ */
+#define _GNU_SOURCE             /* MAP_HUGETLB, MADV_HUGEPAGE */
+#include "frame_pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define HUGE_PAGE_BYTES (2u << 20)
+
+struct frame_pool {
+        unsigned char *region;
+        size_t region_bytes;
+        int hugepages;
+        size_t frame_bytes;             /* a whole number of pages */
+        struct pool_frame *frames;
+        unsigned int count;
+        struct pool_frame *free;
+        unsigned int out;               /* held, the pool's own frames and extra ones */
+        int destroyed;
+        int warned;
+        pthread_mutex_t lock;
+};
+
+static void free_pool(struct frame_pool *pool)
+{
+        munmap(pool->region, pool->region_bytes);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool->frames);
+        free(pool);
+}
+
+struct frame_pool *frame_pool_create(size_t frame_bytes, unsigned int frames)
+{
+        const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        struct frame_pool *pool = calloc(1, sizeof(*pool));
+        size_t bytes;
+        unsigned int i;
+
+        if (!pool)
+                return NULL;
+        pool->frames = calloc(frames, sizeof(*pool->frames));
+        if (!pool->frames) {
+                free(pool);
+                return NULL;
+        }
+        pool->count = frames;
+        pool->frame_bytes = (frame_bytes + page - 1) / page * page;
+        bytes = pool->frame_bytes * frames;
+
+        pool->region_bytes = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        pool->region = mmap(NULL, pool->region_bytes, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (MAP_FAILED == pool->region) {
+                /* none reserved: plain pages, which transparent huge pages may still back */
+                pool->region_bytes = bytes;
+                pool->region = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (MAP_FAILED == pool->region) {
+                        free(pool->frames);
+                        free(pool);
+                        return NULL;
+                }
+                madvise(pool->region, bytes, MADV_HUGEPAGE);
+        } else {
+                pool->hugepages = 1;
+        }
+
+        pthread_mutex_init(&pool->lock, NULL);
+        for (i = frames; i-- > 0; ) {
+                struct pool_frame *f = &pool->frames[i];
+
+                f->data = pool->region + i * pool->frame_bytes;
+                f->capacity = pool->frame_bytes;
+                f->pool = pool;
+                f->next = pool->free;
+                pool->free = f;
+        }
+        return pool;
+}
+
+static int own_frame(const struct frame_pool *pool, const struct pool_frame *frame)
+{
+        return frame >= pool->frames && frame < pool->frames + pool->count;
+}
+
+struct pool_frame *frame_pool_get(struct frame_pool *pool)
+{
+        struct pool_frame *f;
+        int warn = 0;
+
+        pthread_mutex_lock(&pool->lock);
+        f = pool->free;
+        if (f)
+                pool->free = f->next;
+        else if (!pool->warned)
+                warn = pool->warned = 1;
+        pool->out++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (!f) {
+                void *data = NULL;
+
+                if (warn)
+                        fprintf(stderr, "frame pool used up, allocating more frames\n");
+                f = calloc(1, sizeof(*f));
+                if (!f || posix_memalign(&data, (size_t)sysconf(_SC_PAGESIZE), pool->frame_bytes)) {
+                        free(f);
+                        pthread_mutex_lock(&pool->lock);
+                        pool->out--;
+                        pthread_mutex_unlock(&pool->lock);
+                        return NULL;
+                }
+                f->data = data;
+                f->capacity = pool->frame_bytes;
+                f->pool = pool;
+        }
+        f->refs = 1;
+        f->size = 0;
+        f->next = NULL;
+        return f;
+}
+
+void frame_hold(struct pool_frame *frame)
+{
+        __atomic_add_fetch(&frame->refs, 1, __ATOMIC_RELAXED);
+}
+
+void frame_release(struct pool_frame *frame)
+{
+        struct frame_pool *pool;
+        int own, done;
+
+        if (!frame || __atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL))
+                return;
+        pool = frame->pool;
+        own = own_frame(pool, frame);
+        pthread_mutex_lock(&pool->lock);
+        if (own) {
+                frame->next = pool->free;
+                pool->free = frame;
+        }
+        done = 0 == --pool->out && pool->destroyed;
+        pthread_mutex_unlock(&pool->lock);
+        if (!own) {
+                free(frame->data);
+                free(frame);
+        }
+        if (done)
+                free_pool(pool);
+}
+
+int frame_pool_hugepages(const struct frame_pool *pool)
+{
+        return pool->hugepages;
+}
+
+void frame_pool_destroy(struct frame_pool *pool)
+{
+        int done;
+
+        if (!pool)
+                return;
+        pthread_mutex_lock(&pool->lock);
+        pool->destroyed = 1;
+        done = 0 == pool->out;
+        pthread_mutex_unlock(&pool->lock);
+        if (done)
+                free_pool(pool);
+}
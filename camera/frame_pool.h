@@ -0,0 +1,51 @@
+/*
+ * Reference-counted frame buffers, all carved out of one mapping per pool:
+ * each frame page-aligned, as V4L2 USERPTR capture wants, and the mapping
+ * backed by huge pages when the system has some reserved, so the frames
+ * don't each cost a run of TLB entries. A frame is taken with a reference,
+ * everyone who keeps it takes another, and it is back in the pool once the
+ * last is dropped.
+ */
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <stddef.h>
+
+struct frame_pool;
+
+struct pool_frame {
+        unsigned char *data;
+        size_t capacity;
+        int size;                       /* bytes of the frame in data */
+        int refs;
+        struct frame_pool *pool;
+        struct pool_frame *next;        /* on the free list */
+};
+
+/*
+ * A pool of frames of at least frame_bytes each. Returns NULL if even plain
+ * pages can't be mapped.
+ */
+struct frame_pool *frame_pool_create(size_t frame_bytes, unsigned int frames);
+
+/*
+ * A free frame, with one reference. Once every frame of the pool is held,
+ * one is allocated on its own and freed again when released, so a slow
+ * holder costs memory, not frames. NULL only if that fails.
+ */
+struct pool_frame *frame_pool_get(struct frame_pool *pool);
+
+void frame_hold(struct pool_frame *frame);
+/* Drops a reference; NULL is ignored. Any thread can hold and release. */
+void frame_release(struct pool_frame *frame);
+
+/* Whether the pool got huge pages. */
+int frame_pool_hugepages(const struct frame_pool *pool);
+
+/*
+ * Gives up the creator's use of the pool. It is unmapped once no frame of
+ * it is held any more, so holders can outlive the device they came from.
+ */
+void frame_pool_destroy(struct frame_pool *pool);
+
+#endif
@@ -1,42 +1,223 @@
 const express = require('express');
 const app = express();
 const http = require('http');
+const path = require('path');
 const server = http.createServer(app);
 const { Server } = require("socket.io");
 const io = new Server(server);
 const startRouter = require('./routers/page.js');
 const {SERVER_PORT: port = 3000} = process.env;
-const child = require('child_process');
-app.use('/', startRouter);
-io.on('connection', (socket) => {
-console.log('a user connected');
-let ffmpeg = child.spawn("ffmpeg", [
-"-re",
-"-y",
-"-i",
-"udp://192.168.7.1:1234",
-"-preset",
-"ultrafast",
-"-f",
-"mjpeg",
-"pipe:1"
-]);
-ffmpeg.on('error', function (err) {
-console.log(err);
-throw err;
-});
-ffmpeg.on('close', function (code) {
-console.log('ffmpeg exited with code ' + code);
-});
-ffmpeg.stderr.on('data', function(data) {
-// Don't remove this
-// Child Process hangs when stderr exceed certain memory
-});
-ffmpeg.stdout.on('data', function (data) {
-var frame = Buffer.from(data).toString('base64'); //convert raw data to string
-io.sockets.emit('canvas',frame); //send data to client
+const { startWorkerIngest } = require('./ingestWorker.js');
+const { fetchSnapshot } = require('./snapshotClient.js');
+const { createViewerHub } = require('./viewerHub.js');
+const { acceptFrameSockets } = require('./frameSocket.js');
+const { relayWhepOffer } = require('./whepRelay.js');
+const { createViewerReporter, createLinkReporter, createProfileSender } = require('./viewerReporter.js');
+const { requestFeeder, subscribeFeederEvents, createFeederViewerReporter } = require('./feederClient.js');
+const { createFleetGateway } = require('./fleetGateway.js');
+const { seekArchive } = require('./archiveReader.js');
+const { createThumbnailCache } = require('./thumbnailCache.js');
+const { isRelayPrimary, startRelayPrimary, startClusterIngest, reportClusterViewers,
+subscribeClusterEvents } = require('./relayCluster.js');
+const {FRAME_PORT: framePort = 1234, STREAM_MODE: streamMode = 'framed', WHEP_URL: whepUrl} = process.env;
+// FLEET=1: the framed streams of many boards come in on FRAME_PORT, see fleetGateway.js
+const {FLEET: fleetMode} = process.env;
+// the multicast group capture.c --dest sends to, if any, for several relays to share one stream
+const {FRAME_GROUP: frameGroup} = process.env;
+// FLEET_HISTORY_MS: how often the fleet's metrics are scraped for /fleet/history, 0 for never
+const {FLEET_HISTORY_MS: fleetHistoryMs = 1000} = process.env;
+const fleet = fleetMode ? createFleetGateway(Number(framePort), Number(fleetHistoryMs)) : null;
+// where capture.c runs, for the viewer counts capture.c --on-demand acts on
+const {CAPTURE_HOST: captureHost = '192.168.7.2', CAPTURE_PORT: capturePort = 3000} = process.env;
+// capture.c sends each MJPEG frame as framed UDP chunks (complete frames are already JPEGs),
+// or as RTP/JPEG when started with --rtp and STREAM_MODE=rtp here;
+// with STREAM_MODE=webrtc it sends to the gateway instead and nothing comes through here
+// the receivers run on a worker thread, see ingestWorker.js
+const linkReporter = createLinkReporter(captureHost, Number(capturePort));
+function startIngest(onFrame) {
+return startWorkerIngest({ mode: streamMode, port: Number(framePort), group: frameGroup }, onFrame,
+streamMode === 'rtp' ? undefined : linkReporter);
+}
+// RELAY_WORKERS=n: n processes share SERVER_PORT, all fed by the one ingest in this one, see relayCluster.js;
+// the fleet gateway always runs as one
+const {RELAY_WORKERS: relayWorkers = 1} = process.env;
+const clustered = !fleet && Number(relayWorkers) > 1;
+// the viewer count goes to capture.c --on-demand and to the feeder daemon on the same board
+function createBoardViewerReporter() {
+const toCamera = createViewerReporter(captureHost, Number(capturePort));
+const toFeeder = createFeederViewerReporter();
+return (count) => {
+toCamera(count);
+toFeeder(count);
+};
+}
+if (clustered && isRelayPrimary(Number(relayWorkers))) {
+startRelayPrimary(Number(relayWorkers), (streamMode !== 'webrtc') ? startIngest : () => ({ close() {} }),
+(streamMode !== 'webrtc') ? createBoardViewerReporter() : () => {}, subscribeFeederEvents);
+return; // the workers serve the viewers
+}
+// a still straight from the camera's MJPEG stream (capture.c --snapshot)
+app.get('/snapshot.jpg', (req, res) => {
+fetchSnapshot((err, jpeg) => {
+if (err) {
+res.sendStatus(503);
+return;
+}
+res.set('Cache-Control', 'no-store');
+res.type('jpeg').send(jpeg);
+});
+});
+// the camera as multipart MJPEG, for an <img> on a device too slow for the page's canvas; ?stream= picks the camera
+app.get('/stream.mjpg', (req, res) => {
+if (!fleet && streamMode === 'webrtc') {
+res.sendStatus(404); // no frames come through here
+return;
+}
+if (fleet && !req.query.stream) {
+res.sendStatus(400);
+return;
+}
+hub.streamMjpeg(req, res, req.query.stream || 0);
+});
+// a small picture of one camera for dashboards that poll, cached, see thumbnailCache.js; ?stream= picks the camera
+const thumbnail = createThumbnailCache((streamId) => hub.poll(streamId));
+app.get('/thumb', (req, res) => {
+if (!fleet && streamMode === 'webrtc') {
+res.sendStatus(404); // no frames come through here
+return;
+}
+if (fleet ? !/^[\w.-]+\/\d+$/.test(req.query.stream || '') : !/^\d*$/.test(req.query.stream || '')) {
+res.sendStatus(400);
+return;
+}
+const picture = thumbnail(req.query.stream || 0);
+if (!picture) {
+res.sendStatus(503);
+return;
+}
+// express answers 304 itself when the request's If-None-Match is this
+res.set({ 'ETag': picture.etag, 'Cache-Control': 'no-cache' });
+res.type('jpeg').send(picture.jpeg);
+});
+// WebRTC signalling: the page posts its offer here and gets the gateway's answer (see whepRelay.js)
+app.post('/whep', express.text({ type: 'application/sdp' }), (req, res) => {
+if (streamMode !== 'webrtc' || !whepUrl) {
+res.sendStatus(404);
+return;
+}
+relayWhepOffer(whepUrl, req.body, (err, status, answer) => {
+if (err) {
+res.sendStatus(502);
+return;
+}
+res.status(status).type('application/sdp').send(answer);
+});
+});
+// the feeder daemon's control socket, passed through as is (see feederClient.js)
+function relayToFeeder(method, path) {
+return (req, res) => {
+requestFeeder(method, path, req.body, (err, status, body) => {
+if (err) {
+res.sendStatus(502);
+return;
+}
+res.set('Cache-Control', 'no-store');
+res.status(status).type('json').send(body);
+});
+};
+}
+app.get('/feeder/status', relayToFeeder('GET', '/status'));
+app.get('/feeder/stats', relayToFeeder('GET', '/stats'));
+app.get('/feeder/plan', relayToFeeder('GET', '/plan'));
+app.post('/feeder/feed', express.urlencoded({ extended: false }), relayToFeeder('POST', '/feed'));
+app.post('/feeder/mode', express.urlencoded({ extended: false }), relayToFeeder('POST', '/mode'));
+// switches capture.c --profiles to the named camera profile, until its schedule next switches; capture.c doesn't answer
+const sendProfile = createProfileSender(captureHost, Number(capturePort));
+app.post('/camera/profile', express.urlencoded({ extended: false }), (req, res) => {
+if (fleet) {
+res.sendStatus(404); // each board has a capture.c of its own
+return;
+}
+const { name } = req.body;
+if (typeof name !== 'string' || !/^[\w-]{1,31}$/.test(name)) {
+res.sendStatus(400);
+return;
+}
+sendProfile(name);
+res.sendStatus(202);
 });
+if (fleet) {
+app.get('/fleet', (req, res) => {
+res.set('Cache-Control', 'no-store');
+res.json(fleet.list());
 });
+app.get('/fleet/metrics', (req, res) => {
+fleet.metrics((text) => res.type('text/plain; version=0.0.4').send(text));
+});
+// the history the gateway keeps of the boards' metrics, see metricsHistory.js: /fleet/history lists what there is,
+// /fleet/history/<name>?start=&end=&step= (ms since 1970, ms) gives one metric's series, and any other parameter, e.g.
+// board=, picks the series with that label
+app.get('/fleet/history', (req, res) => {
+res.set('Cache-Control', 'no-store');
+res.json({ ...fleet.history.stats(), names: fleet.history.names() });
+});
+app.get('/fleet/history/:name', (req, res) => {
+const { start, end, step, ...matchers } = req.query;
+const endMs = end === undefined ? Date.now() : Number(end);
+const startMs = start === undefined ? endMs - 3600000 : Number(start);
+if (!/^[A-Za-z_:][\w:]*$/.test(req.params.name) || !Number.isFinite(startMs) || !Number.isFinite(endMs) ||
+Object.values(matchers).some((value) => typeof value !== 'string')) {
+res.sendStatus(400);
+return;
+}
+res.set('Cache-Control', 'no-store');
+res.json(fleet.history.query(req.params.name, matchers, startMs, endMs, Number(step) || 0));
+});
+}
+// capture.c --archive played back, where it runs on this host: /archive/0/seek?t=<ms since 1970>&count=n lists the
+// frames from then on, and each is a byte range of /archive/0/<its segment>, see archiveReader.js
+const {ARCHIVE_DIR: archiveDir} = process.env;
+if (archiveDir) {
+app.get('/archive/:stream/seek', (req, res) => {
+const timeMs = Number(req.query.t);
+if (!/^\d{1,3}$/.test(req.params.stream) || !Number.isFinite(timeMs)) {
+res.sendStatus(400);
+return;
+}
+seekArchive(path.join(archiveDir, `stream-${req.params.stream}`), timeMs, Number(req.query.count) || 1)
+.then((result) => {
+res.set('Cache-Control', 'no-store');
+res.json(result);
+}, () => res.sendStatus(404));
+});
+// a segment is written over as the ring comes round, so nothing of it is cached
+app.get('/archive/:stream/:segment', (req, res) => {
+if (!/^\d{1,3}$/.test(req.params.stream) || !/^seg-\d{3,}\.mjpg$/.test(req.params.segment)) {
+res.sendStatus(404);
+return;
+}
+res.sendFile(path.join(`stream-${req.params.stream}`, req.params.segment),
+{ root: archiveDir, cacheControl: false, lastModified: false, etag: false,
+headers: { 'Cache-Control': 'no-store', 'Content-Type': 'application/octet-stream' } },
+(err) => err && !res.headersSent && res.sendStatus(404));
+});
+}
+// the video path's per-hop latency and drops, see videoStats.js
+app.get('/metrics', (req, res) => {
+res.type('text/plain; version=0.0.4').send(hub.videoMetrics());
+});
+app.use('/', startRouter);
+// with WebRTC the hub has no frames to send and only passes on the feeder's events
+// a cluster worker has its frames, events and viewer count go through the primary
+const hub = fleet ?
+createViewerHub(io, fleet.startIngest, () => fleet.setViewers(hub.channelViewers()), { subscriptions: true }) :
+(streamMode !== 'webrtc') ?
+createViewerHub(io, clustered ? startClusterIngest : startIngest,
+clustered ? reportClusterViewers : createBoardViewerReporter()) :
+createViewerHub(io, () => ({ close() {} }));
+(clustered ? subscribeClusterEvents : subscribeFeederEvents)(hub.publish);
+// the page's frames over a WebSocket of their own, socket.io keeping the events (see frameSocket.js)
+acceptFrameSockets(server, '/frames', hub.acceptFrames);
 server.listen({ port }, () => {
 console.log(`🚀 Server ready at http://0.0.0.0:${port}`);
 });
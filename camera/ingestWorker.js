@@ -0,0 +1,54 @@
+// Runs the UDP receiver, and with it every datagram's parsing and each frame's assembly, on a worker thread, so a burst
+// of video never holds up HTTP or socket.io on the main thread, and a slow request never holds up the video. Each
+// finished frame comes back as its ArrayBuffer, transferred rather than copied: the receivers give every frame a
+// Buffer of its own, which the worker has no more use for once it is sent.
+//
+// startWorkerIngest({ mode, port, group }, onFrame, onLink) takes the place of createFrameReceiver or
+// createRtpReceiver (mode 'rtp'), with the same callbacks, and returns something with close().
+const { Worker, isMainThread, parentPort, workerData } = require('worker_threads');
+
+// a frame's own ArrayBuffer can go as it is; one sharing a pooled slab is copied out first
+function ownArrayBuffer(buffer) {
+if (buffer.byteOffset === 0 && buffer.byteLength === buffer.buffer.byteLength) {
+return buffer.buffer;
+}
+return buffer.buffer.slice(buffer.byteOffset, buffer.byteOffset + buffer.byteLength);
+}
+
+function runWorker() {
+const { createFrameReceiver } = require('./frameReceiver.js');
+const { createRtpReceiver } = require('./rtpReceiver.js');
+const { mode, port, group, link } = workerData;
+function onFrame(frame, timestampMs, streamId, sequence, timing) {
+const data = ownArrayBuffer(frame);
+parentPort.postMessage({ frame: data, timestampMs, streamId, sequence, timing }, [data]);
+}
+if (mode === 'rtp') {
+createRtpReceiver(port, onFrame, group);
+} else {
+createFrameReceiver(port, onFrame, group, link ? (stats) => parentPort.postMessage({ link: stats }) : undefined);
+}
+}
+
+function startWorkerIngest({ mode, port, group }, onFrame, onLink) {
+const worker = new Worker(__filename, { workerData: { mode, port, group, link: Boolean(onLink) } });
+worker.on('message', (message) => {
+if (message.link) {
+onLink(message.link);
+return;
+}
+onFrame(Buffer.from(message.frame), message.timestampMs, message.streamId, message.sequence, message.timing);
+});
+worker.on('error', (err) => console.error('ingest worker:', err));
+return {
+close() {
+worker.terminate();
+},
+};
+}
+
+if (!isMainThread) {
+runWorker();
+}
+
+module.exports = { startWorkerIngest };
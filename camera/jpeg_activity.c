@@ -0,0 +1,603 @@
+/*
+ * DC-only baseline JPEG decoding, see jpeg_activity.h.
+ */
+#include "jpeg_activity.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+#define MAX_COMPONENTS 3
+#define LOOKAHEAD_BITS 9
+
+struct huffman {
+        int present;
+        /* canonical decoding per code length, as in ITU T.81 F.2.2.3 */
+        int32_t maxcode[18];
+        int32_t valptr[17];
+        int32_t mincode[17];
+        unsigned char values[256];
+        /* codes up to LOOKAHEAD_BITS long: length << 8 | value, 0 if longer */
+        uint16_t lookahead[1 << LOOKAHEAD_BITS];
+};
+
+struct component {
+        int id;
+        int h, v;               /* sampling factors */
+        int dc_table, ac_table;
+        int qtable, q0;         /* q0: the table's DC step */
+        int pred;
+};
+
+struct bit_reader {
+        const unsigned char *p;
+        const unsigned char *end;
+        uint32_t bits;
+        int count;
+        int marker;             /* hit a marker: feed zeros from here on */
+};
+
+/*
+ * UVC cameras usually leave DHT out of each MJPEG frame and rely on the
+ * example tables of ITU T.81 K.3.
+ */
+const unsigned char jpeg_std_dc_luma_bits[16] = {
+        0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0
+};
+const unsigned char jpeg_std_dc_chroma_bits[16] = {
+        0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0
+};
+const unsigned char jpeg_std_dc_values[12] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+};
+const unsigned char jpeg_std_ac_luma_bits[16] = {
+        0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d
+};
+const unsigned char jpeg_std_ac_luma_values[162] = {
+        0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+        0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+        0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+        0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+        0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+        0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+        0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+        0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+        0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+        0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+        0xf9, 0xfa
+};
+const unsigned char jpeg_std_ac_chroma_bits[16] = {
+        0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77
+};
+const unsigned char jpeg_std_ac_chroma_values[162] = {
+        0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+        0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+        0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+        0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+        0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+        0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+        0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+        0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+        0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+        0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+        0xf9, 0xfa
+};
+
+/* mean luma per 8x8 luma block, this frame and the last */
+static unsigned char *grid, *previous_grid;
+static int grid_width, grid_height;
+
+static int build_huffman(struct huffman *h, const unsigned char *bits,
+                         const unsigned char *values)
+{
+        int length, k = 0, code = 0;
+
+        memset(h->lookahead, 0, sizeof(h->lookahead));
+        for (length = 1; length <= 16; length++) {
+                int n = bits[length - 1];
+                int i;
+
+                h->valptr[length] = k;
+                h->mincode[length] = code;
+                code += n;
+                k += n;
+                h->maxcode[length] = n ? code - 1 : -1;
+                if (k > 256 || code > (1 << length))
+                        return -1;
+                for (i = 0; length <= LOOKAHEAD_BITS && i < n; i++) {
+                        int shift = LOOKAHEAD_BITS - length;
+                        int first = (h->mincode[length] + i) << shift;
+                        int j;
+
+                        for (j = 0; j < 1 << shift; j++)
+                                h->lookahead[first + j] = length << 8 | values[k - n + i];
+                }
+                code <<= 1;
+        }
+        h->maxcode[17] = INT32_MAX;     /* stops a corrupt stream */
+        memcpy(h->values, values, k);
+        h->present = 1;
+        return 0;
+}
+
+static void fill_bits(struct bit_reader *br)
+{
+        while (br->count <= 24) {
+                unsigned int byte = 0;
+
+                if (!br->marker && br->p < br->end) {
+                        byte = *br->p++;
+                        if (byte == 0xff) {
+                                unsigned int next = br->p < br->end ? *br->p : 0xd9;
+
+                                if (next == 0x00) {
+                                        br->p++;        /* stuffed */
+                                } else {
+                                        br->p--;        /* a marker: leave it for the caller */
+                                        br->marker = 1;
+                                        byte = 0;
+                                }
+                        }
+                }
+                br->bits |= byte << (24 - br->count);
+                br->count += 8;
+        }
+}
+
+static int get_bits(struct bit_reader *br, int n)
+{
+        int value;
+
+        if (n == 0)
+                return 0;
+        fill_bits(br);
+        value = br->bits >> (32 - n);
+        br->bits <<= n;
+        br->count -= n;
+        return value;
+}
+
+static int decode_symbol(struct bit_reader *br, const struct huffman *h)
+{
+        int length, entry;
+        int32_t code;
+
+        fill_bits(br);
+        entry = h->lookahead[br->bits >> (32 - LOOKAHEAD_BITS)];
+        if (entry) {
+                br->bits <<= entry >> 8;
+                br->count -= entry >> 8;
+                return entry & 0xff;
+        }
+
+        length = 1;
+        code = get_bits(br, 1);
+
+        while (code > h->maxcode[length]) {
+                code = (code << 1) | get_bits(br, 1);
+                if (++length > 16)
+                        return -1;
+        }
+        return h->values[h->valptr[length] + code - h->mincode[length]];
+}
+
+/* T.81 F.2.2.1: s bits of magnitude, ones' complement for negatives */
+static int receive_extend(struct bit_reader *br, int s)
+{
+        int value = get_bits(br, s);
+
+        if (s && value < (1 << (s - 1)))
+                value -= (1 << s) - 1;
+        return value;
+}
+
+/* state of one decode, gathered from the headers */
+struct jpeg_headers {
+        int width, height;
+        int components;
+        struct component component[MAX_COMPONENTS];
+        int hmax, vmax;
+        int restart_interval;
+        struct huffman dc[4], ac[4];
+        int scan_order[MAX_COMPONENTS];
+        int scan_components;
+};
+
+static int parse_headers(const unsigned char *data, int size,
+                         struct jpeg_headers *jh, int *scan_start)
+{
+        int qtables[4] = { 0, 0, 0, 0 };
+        int i = 2;
+
+        memset(jh, 0, sizeof(*jh));
+        if (size < 4 || data[0] != 0xff || data[1] != 0xd8)
+                return -1;
+
+        while (i + 4 <= size) {
+                int marker, length, end;
+
+                if (data[i] != 0xff)
+                        return -1;
+                marker = data[i + 1];
+                if (marker == 0xff) {
+                        i++;
+                        continue;
+                }
+                length = (data[i + 2] << 8) | data[i + 3];
+                end = i + 2 + length;
+                if (length < 2 || end > size)
+                        return -1;
+
+                switch (marker) {
+                case 0xdb: {                    /* DQT: keep each table's DC step */
+                        int j = i + 4;
+
+                        while (j < end) {
+                                int precision = data[j] >> 4;
+
+                                if (j + 1 + (precision ? 128 : 64) > end)
+                                        return -1;
+                                qtables[data[j] & 3] = precision ?
+                                        (data[j + 1] << 8) | data[j + 2] : data[j + 1];
+                                j += 1 + (precision ? 128 : 64);
+                        }
+                        break;
+                }
+                case 0xc4: {                    /* DHT */
+                        int j = i + 4;
+
+                        while (j + 17 <= end) {
+                                int table_class = data[j] >> 4;
+                                int id = data[j] & 3;
+                                int count = 0, k;
+
+                                for (k = 0; k < 16; k++)
+                                        count += data[j + 1 + k];
+                                if (j + 17 + count > end)
+                                        return -1;
+                                if (build_huffman(table_class ? &jh->ac[id] : &jh->dc[id],
+                                                  data + j + 1, data + j + 17) < 0)
+                                        return -1;
+                                j += 17 + count;
+                        }
+                        break;
+                }
+                case 0xc0:                      /* SOF0 */
+                case 0xc1: {                    /* SOF1, extended sequential, also Huffman */
+                        int k;
+
+                        if (length < 8)
+                                return -1;
+                        jh->height = (data[i + 5] << 8) | data[i + 6];
+                        jh->width = (data[i + 7] << 8) | data[i + 8];
+                        jh->components = data[i + 9];
+                        if (jh->components < 1 || jh->components > MAX_COMPONENTS ||
+                            length < 8 + 3 * jh->components || !jh->width || !jh->height)
+                                return -1;
+                        for (k = 0; k < jh->components; k++) {
+                                struct component *c = &jh->component[k];
+
+                                c->id = data[i + 10 + 3 * k];
+                                c->h = data[i + 11 + 3 * k] >> 4;
+                                c->v = data[i + 11 + 3 * k] & 15;
+                                c->qtable = data[i + 12 + 3 * k] & 3;
+                                if (c->h < 1 || c->h > 2 || c->v < 1 || c->v > 2)
+                                        return -1;
+                                if (c->h > jh->hmax)
+                                        jh->hmax = c->h;
+                                if (c->v > jh->vmax)
+                                        jh->vmax = c->v;
+                        }
+                        /* a single-component scan is coded in plain 8x8 blocks */
+                        if (jh->components == 1)
+                                jh->component[0].h = jh->component[0].v = jh->hmax = jh->vmax = 1;
+                        break;
+                }
+                case 0xc2: case 0xc3: case 0xc5: case 0xc6: case 0xc7:
+                case 0xc9: case 0xca: case 0xcb: case 0xcd: case 0xce: case 0xcf:
+                        return -1;              /* progressive, lossless or arithmetic */
+                case 0xdd:
+                        if (length < 4)
+                                return -1;
+                        jh->restart_interval = (data[i + 4] << 8) | data[i + 5];
+                        break;
+                case 0xda: {                    /* SOS */
+                        int n = data[i + 4], k, m;
+
+                        if (!jh->components || n != jh->components || length < 6 + 2 * n)
+                                return -1;      /* only interleaved single-scan images */
+                        for (k = 0; k < n; k++) {
+                                int id = data[i + 5 + 2 * k];
+                                int tables = data[i + 6 + 2 * k];
+
+                                for (m = 0; m < jh->components; m++)
+                                        if (jh->component[m].id == id)
+                                                break;
+                                if (m == jh->components)
+                                        return -1;
+                                jh->component[m].dc_table = tables >> 4 & 3;
+                                jh->component[m].ac_table = tables & 3;
+                                jh->scan_order[k] = m;
+                        }
+                        jh->scan_components = n;
+                        /* DQT may come after SOF */
+                        for (k = 0; k < jh->components; k++)
+                                jh->component[k].q0 = qtables[jh->component[k].qtable];
+                        *scan_start = end;
+                        return 0;
+                }
+                default:
+                        break;
+                }
+                i = end;
+        }
+        return -1;
+}
+
+static void use_standard_tables(struct jpeg_headers *jh)
+{
+        if (!jh->dc[0].present)
+                build_huffman(&jh->dc[0], jpeg_std_dc_luma_bits, jpeg_std_dc_values);
+        if (!jh->dc[1].present)
+                build_huffman(&jh->dc[1], jpeg_std_dc_chroma_bits, jpeg_std_dc_values);
+        if (!jh->ac[0].present)
+                build_huffman(&jh->ac[0], jpeg_std_ac_luma_bits, jpeg_std_ac_luma_values);
+        if (!jh->ac[1].present)
+                build_huffman(&jh->ac[1], jpeg_std_ac_chroma_bits, jpeg_std_ac_chroma_values);
+}
+
+/* Skips to just past the next RSTn marker and restarts prediction. */
+static void restart(struct bit_reader *br, struct jpeg_headers *jh)
+{
+        int k;
+
+        while (br->p + 1 < br->end && !(br->p[0] == 0xff && br->p[1] >= 0xd0 && br->p[1] <= 0xd7))
+                br->p++;
+        if (br->p + 1 < br->end)
+                br->p += 2;
+        br->bits = 0;
+        br->count = 0;
+        br->marker = 0;
+        for (k = 0; k < jh->components; k++)
+                jh->component[k].pred = 0;
+}
+
+static int ensure_grid(int width, int height)
+{
+        if (grid && width == grid_width && height == grid_height)
+                return 0;
+        free(grid);
+        free(previous_grid);
+        grid = calloc((size_t)width * height, 1);
+        previous_grid = calloc((size_t)width * height, 1);
+        grid_width = width;
+        grid_height = height;
+        if (!grid || !previous_grid) {
+                jpeg_activity_reset();
+                return -1;
+        }
+        return 1;
+}
+
+/*
+ * Fills planes[k] with the mean of each block of component k, widths[k] to
+ * a row; a NULL plane is decoded past but not kept.
+ */
+static int decode_dc(const unsigned char *data, int size,
+                     struct jpeg_headers *jh, int scan_start,
+                     unsigned char *const planes[], const int widths[])
+{
+        const int mcus_x = (jh->width + 8 * jh->hmax - 1) / (8 * jh->hmax);
+        const int mcus_y = (jh->height + 8 * jh->vmax - 1) / (8 * jh->vmax);
+        struct bit_reader br;
+        int mcu, k;
+
+        for (k = 0; k < jh->scan_components; k++) {
+                const struct component *c = &jh->component[jh->scan_order[k]];
+
+                if (!jh->dc[c->dc_table].present || !jh->ac[c->ac_table].present)
+                        return -1;
+        }
+
+        br.p = data + scan_start;
+        br.end = data + size;
+        br.bits = 0;
+        br.count = 0;
+        br.marker = 0;
+
+        for (mcu = 0; mcu < mcus_x * mcus_y; mcu++) {
+                if (jh->restart_interval && mcu && mcu % jh->restart_interval == 0)
+                        restart(&br, jh);
+
+                for (k = 0; k < jh->scan_components; k++) {
+                        const int m = jh->scan_order[k];
+                        struct component *c = &jh->component[m];
+                        const struct huffman *dc = &jh->dc[c->dc_table];
+                        const struct huffman *ac = &jh->ac[c->ac_table];
+                        int block;
+
+                        for (block = 0; block < c->h * c->v; block++) {
+                                int s = decode_symbol(&br, dc);
+                                int coefficient;
+
+                                if (s < 0 || s > 11)
+                                        return -1;
+                                c->pred += receive_extend(&br, s);
+
+                                /* the AC coefficients are only skipped over */
+                                for (coefficient = 1; coefficient < 64; coefficient++) {
+                                        int rs = decode_symbol(&br, ac);
+
+                                        if (rs < 0)
+                                                return -1;
+                                        if ((rs & 15) == 0) {
+                                                if (rs != 0xf0)
+                                                        break;  /* end of block */
+                                                coefficient += 15;
+                                                continue;
+                                        }
+                                        coefficient += rs >> 4;
+                                        get_bits(&br, rs & 15);
+                                }
+                                if (planes[m]) {
+                                        int x = mcu % mcus_x * c->h + block % c->h;
+                                        int y = mcu / mcus_x * c->v + block / c->h;
+                                        /* DC is 8x the block mean, level-shifted by 128 */
+                                        int mean = c->pred * c->q0 / 8 + 128;
+
+                                        planes[m][y * widths[m] + x] = mean < 0 ? 0 : mean > 255 ? 255 : mean;
+                                }
+                        }
+                }
+        }
+        return 0;
+}
+
+/*
+ * Compares two block pictures: returns how many blocks moved by more than
+ * threshold, and adds up the squared differences in *energy. Sixteen
+ * blocks at a time with NEON.
+ */
+static int compare_blocks(const unsigned char *a, const unsigned char *b, int n,
+                          int threshold, uint64_t *energy)
+{
+        uint64_t sum = 0;
+        int changed = 0, i = 0;
+
+#ifdef __ARM_NEON
+        const uint8x16_t limit = vdupq_n_u8((uint8_t)threshold);
+
+        while (i + 16 <= n) {
+                /* at most 255 rounds before the 8-bit counts and 32-bit sums could overflow */
+                int end = i + 16 * 255 < n ? i + 16 * 255 : n;
+                uint8x16_t count = vdupq_n_u8(0);
+                uint32x4_t squares = vdupq_n_u32(0);
+
+                for (; i + 16 <= end; i += 16) {
+                        uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+
+                        /* a lane over the limit is all ones, i.e. -1 */
+                        count = vsubq_u8(count, vcgtq_u8(diff, limit));
+                        squares = vpadalq_u16(squares, vmull_u8(vget_low_u8(diff), vget_low_u8(diff)));
+                        squares = vpadalq_u16(squares, vmull_u8(vget_high_u8(diff), vget_high_u8(diff)));
+                }
+                uint64x2_t counts = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(count)));
+                uint64x2_t sums = vpaddlq_u32(squares);
+
+                changed += (int)(vgetq_lane_u64(counts, 0) + vgetq_lane_u64(counts, 1));
+                sum += vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+        }
+#endif
+        for (; i < n; i++) {
+                int diff = a[i] - b[i];
+
+                if (diff > threshold || diff < -threshold)
+                        changed++;
+                sum += (uint64_t)(diff * diff);
+        }
+        *energy += sum;
+        return changed;
+}
+
+int jpeg_activity_measure(const unsigned char *jpeg, int size, int luma_threshold,
+                          unsigned int *energy)
+{
+        struct jpeg_headers jh;
+        unsigned char *planes[MAX_COMPONENTS] = { NULL, NULL, NULL };
+        int widths[MAX_COMPONENTS] = { 0, 0, 0 };
+        unsigned char *swap;
+        uint64_t squares = 0;
+        int scan_start, fresh, changed, cells;
+
+        if (energy)
+                *energy = 0;
+        if (parse_headers(jpeg, size, &jh, &scan_start) < 0)
+                return -1;
+        use_standard_tables(&jh);
+
+        fresh = ensure_grid((jh.width + 8 * jh.hmax - 1) / (8 * jh.hmax) * jh.component[0].h,
+                            (jh.height + 8 * jh.vmax - 1) / (8 * jh.vmax) * jh.component[0].v);
+        if (fresh < 0)
+                return -1;
+        planes[0] = grid;
+        widths[0] = grid_width;
+        if (decode_dc(jpeg, size, &jh, scan_start, planes, widths) < 0)
+                return -1;
+
+        cells = grid_width * grid_height;
+        changed = compare_blocks(grid, previous_grid, cells, luma_threshold, &squares);
+        swap = previous_grid;
+        previous_grid = grid;
+        grid = swap;
+        if (fresh)
+                return 1000;
+        if (energy)
+                *energy = (unsigned int)(squares / cells);
+        return (int)((long)changed * 1000 / cells);
+}
+
+void jpeg_activity_reset(void)
+{
+        free(grid);
+        free(previous_grid);
+        grid = NULL;
+        previous_grid = NULL;
+        grid_width = 0;
+        grid_height = 0;
+}
+
+int jpeg_luma_blocks(const unsigned char *jpeg, int size, unsigned char *blocks,
+                     int max_blocks, int *width, int *height)
+{
+        struct jpeg_headers jh;
+        unsigned char *planes[MAX_COMPONENTS] = { blocks, NULL, NULL };
+        int widths[MAX_COMPONENTS] = { 0, 0, 0 };
+        int scan_start, mcus_x, mcus_y;
+
+        if (parse_headers(jpeg, size, &jh, &scan_start) < 0)
+                return -1;
+        use_standard_tables(&jh);
+
+        mcus_x = (jh.width + 8 * jh.hmax - 1) / (8 * jh.hmax);
+        mcus_y = (jh.height + 8 * jh.vmax - 1) / (8 * jh.vmax);
+        *width = mcus_x * jh.component[0].h;
+        *height = mcus_y * jh.component[0].v;
+        if (*width * *height > max_blocks)
+                return -1;
+        widths[0] = *width;
+        return decode_dc(jpeg, size, &jh, scan_start, planes, widths);
+}
+
+int jpeg_dc_picture(const unsigned char *jpeg, int size, struct jpeg_dc_picture *picture,
+                    unsigned char *buffer, int buffer_size)
+{
+        struct jpeg_headers jh;
+        int scan_start, mcus_x, mcus_y, k, used = 0;
+
+        if (parse_headers(jpeg, size, &jh, &scan_start) < 0)
+                return -1;
+        use_standard_tables(&jh);
+
+        mcus_x = (jh.width + 8 * jh.hmax - 1) / (8 * jh.hmax);
+        mcus_y = (jh.height + 8 * jh.vmax - 1) / (8 * jh.vmax);
+        memset(picture, 0, sizeof(*picture));
+        picture->components = jh.components;
+        picture->image_width = (jh.width + 7) / 8;
+        picture->image_height = (jh.height + 7) / 8;
+        for (k = 0; k < jh.components; k++) {
+                const struct component *c = &jh.component[k];
+
+                picture->h[k] = c->h;
+                picture->v[k] = c->v;
+                picture->width[k] = mcus_x * c->h;
+                picture->height[k] = mcus_y * c->v;
+                if (picture->width[k] * picture->height[k] > buffer_size - used)
+                        return -1;
+                picture->plane[k] = buffer + used;
+                used += picture->width[k] * picture->height[k];
+        }
+        return decode_dc(jpeg, size, &jh, scan_start, picture->plane, picture->width);
+}
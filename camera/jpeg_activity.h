@@ -0,0 +1,63 @@
+/*
+ * Cheap scene-change measure for an MJPEG stream. Only the entropy-coded
+ * data is walked, to recover the DC coefficient (the 8x8 block's mean) of
+ * every luma block; no IDCT is done. The result is a 1/8 scale luma
+ * picture, compared block by block with the previous frame's.
+ */
+#ifndef JPEG_ACTIVITY_H
+#define JPEG_ACTIVITY_H
+
+/*
+ * Returns how much of the picture changed since the previous frame, in
+ * parts per thousand of luma blocks whose mean moved by more than
+ * luma_threshold (0-255), or -1 if the frame is not a baseline JPEG. The
+ * first frame, and a frame of a different size, count as 1000. energy, if
+ * given, gets the mean squared change of a block's luma, 0 when there is
+ * no previous frame to compare with.
+ */
+int jpeg_activity_measure(const unsigned char *jpeg, int size, int luma_threshold,
+                          unsigned int *energy);
+
+void jpeg_activity_reset(void);
+
+/*
+ * Decodes a 1/8 scale picture from the DC coefficients alone: the mean luma
+ * of every 8x8 luma block, width to a row, at most max_blocks of them.
+ * Returns 0, or -1 if the frame is not a baseline JPEG or doesn't fit. Keeps
+ * no state, so it can be used alongside jpeg_activity_measure.
+ */
+int jpeg_luma_blocks(const unsigned char *jpeg, int size, unsigned char *blocks,
+                     int max_blocks, int *width, int *height);
+
+/*
+ * The whole 1/8 scale picture, every component: plane[k] holds the mean of
+ * each 8x8 block of component k, width[k] to a row, padded out to whole
+ * MCUs as the JPEG is. image_width and image_height are the picture's own
+ * size at that scale.
+ */
+struct jpeg_dc_picture {
+        int components;
+        int h[3], v[3];                 /* sampling factors */
+        int width[3], height[3];        /* of each plane, in blocks */
+        int image_width, image_height;
+        unsigned char *plane[3];
+};
+
+/*
+ * Decodes it into buffer, which the planes then point into. Returns 0, or -1
+ * if the frame is not a baseline JPEG or the planes don't fit in buffer_size.
+ * Keeps no state either.
+ */
+int jpeg_dc_picture(const unsigned char *jpeg, int size, struct jpeg_dc_picture *picture,
+                    unsigned char *buffer, int buffer_size);
+
+/* The example Huffman tables of ITU T.81 K.3, bits per code length and values. */
+extern const unsigned char jpeg_std_dc_luma_bits[16];
+extern const unsigned char jpeg_std_dc_chroma_bits[16];
+extern const unsigned char jpeg_std_dc_values[12];
+extern const unsigned char jpeg_std_ac_luma_bits[16];
+extern const unsigned char jpeg_std_ac_luma_values[162];
+extern const unsigned char jpeg_std_ac_chroma_bits[16];
+extern const unsigned char jpeg_std_ac_chroma_values[162];
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * Baseline JPEG encoding of the DC picture, see jpeg_thumbnail.h.
+ *
+ * The thumbnail keeps the frame's components and sampling factors, so the
+ * planes are encoded as they were decoded. Quantization is the example
+ * tables of ITU T.81 K.1 scaled to THUMBNAIL_QUALITY, Huffman coding the
+ * example tables of K.3, written out in DHT since a thumbnail is a JPEG of
+ * its own, not a UVC frame.
+ */
+#include "jpeg_thumbnail.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "jpeg_activity.h"
+
+#define THUMBNAIL_QUALITY 80
+#define THUMBNAIL_MAX_BLOCKS 98304      /* 1920x1080 4:2:0 is 48960 */
+#define PI 3.14159265358979323846
+
+struct huffman_code {
+        unsigned short code[256];
+        unsigned char size[256];
+};
+
+struct bit_writer {
+        unsigned char *p;
+        unsigned char *end;
+        uint32_t bits;
+        int count;
+        int full;
+};
+
+/* zigzag order to natural order */
+static const unsigned char zigzag[64] = {
+         0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+/* ITU T.81 K.1, in natural order */
+static const unsigned char std_luma_quant[64] = {
+        16, 11, 10, 16,  24,  40,  51,  61,
+        12, 12, 14, 19,  26,  58,  60,  55,
+        14, 13, 16, 24,  40,  57,  69,  56,
+        14, 17, 22, 29,  51,  87,  80,  62,
+        18, 22, 37, 56,  68, 109, 103,  77,
+        24, 35, 55, 64,  81, 104, 113,  92,
+        49, 64, 78, 87, 103, 121, 120, 101,
+        72, 92, 95, 98, 112, 100, 103,  99
+};
+static const unsigned char std_chroma_quant[64] = {
+        17, 18, 24, 47, 99, 99, 99, 99,
+        18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99,
+        47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99
+};
+
+static unsigned char planes[THUMBNAIL_MAX_BLOCKS];
+static unsigned char quant[2][64];
+static struct huffman_code dc_codes[2], ac_codes[2];
+static float dct[8][8];                 /* dct[u][x], with the 1/2 C(u) factor */
+static int ready;
+
+static void build_codes(struct huffman_code *h, const unsigned char *bits,
+                        const unsigned char *values)
+{
+        int length, i, k = 0, code = 0;
+
+        for (length = 1; length <= 16; length++) {
+                for (i = 0; i < bits[length - 1]; i++, k++) {
+                        h->code[values[k]] = (unsigned short)code++;
+                        h->size[values[k]] = (unsigned char)length;
+                }
+                code <<= 1;
+        }
+}
+
+/* scaled as the IJG's quality setting does, which viewers are used to */
+static void scale_quant(unsigned char *table, const unsigned char *base, int quality)
+{
+        int scale = quality < 50 ? 5000 / quality : 200 - 2 * quality;
+        int i;
+
+        for (i = 0; i < 64; i++) {
+                int q = (base[i] * scale + 50) / 100;
+
+                table[i] = q < 1 ? 1 : q > 255 ? 255 : q;
+        }
+}
+
+static void init_tables(void)
+{
+        int u, x;
+
+        scale_quant(quant[0], std_luma_quant, THUMBNAIL_QUALITY);
+        scale_quant(quant[1], std_chroma_quant, THUMBNAIL_QUALITY);
+        build_codes(&dc_codes[0], jpeg_std_dc_luma_bits, jpeg_std_dc_values);
+        build_codes(&dc_codes[1], jpeg_std_dc_chroma_bits, jpeg_std_dc_values);
+        build_codes(&ac_codes[0], jpeg_std_ac_luma_bits, jpeg_std_ac_luma_values);
+        build_codes(&ac_codes[1], jpeg_std_ac_chroma_bits, jpeg_std_ac_chroma_values);
+        for (u = 0; u < 8; u++)
+                for (x = 0; x < 8; x++)
+                        dct[u][x] = (float)((u ? 0.5 : 0.5 / sqrt(2.0)) *
+                                            cos((2 * x + 1) * u * PI / 16));
+        ready = 1;
+}
+
+static void put_byte(struct bit_writer *bw, unsigned int byte)
+{
+        if (bw->p >= bw->end) {
+                bw->full = 1;
+                return;
+        }
+        *bw->p++ = (unsigned char)byte;
+}
+
+static void put_bits(struct bit_writer *bw, unsigned int value, int n)
+{
+        bw->bits = bw->bits << n | (value & ((1u << n) - 1));
+        bw->count += n;
+        while (bw->count >= 8) {
+                unsigned int byte = bw->bits >> (bw->count - 8) & 0xff;
+
+                put_byte(bw, byte);
+                if (byte == 0xff)
+                        put_byte(bw, 0x00);     /* stuffed */
+                bw->count -= 8;
+        }
+}
+
+/* T.81 F.1.2.1: a value's magnitude category, and its bits */
+static void put_value(struct bit_writer *bw, const struct huffman_code *h, int run, int value)
+{
+        int magnitude = value < 0 ? -value : value;
+        int s = 0;
+
+        while (magnitude >> s)
+                s++;
+        put_bits(bw, h->code[run << 4 | s], h->size[run << 4 | s]);
+        if (s)
+                put_bits(bw, value < 0 ? value - 1 : value, s);
+}
+
+/* Forward DCT, quantization and entropy coding of one 8x8 block. */
+static void encode_block(struct bit_writer *bw, const float *pixels, const unsigned char *table,
+                         const struct huffman_code *dc, const struct huffman_code *ac, int *pred)
+{
+        float rows[8][8];
+        int coefficients[64];
+        int u, v, x, y, k, run = 0;
+
+        for (y = 0; y < 8; y++)
+                for (u = 0; u < 8; u++) {
+                        float sum = 0;
+
+                        for (x = 0; x < 8; x++)
+                                sum += dct[u][x] * pixels[y * 8 + x];
+                        rows[y][u] = sum;
+                }
+        for (v = 0; v < 8; v++)
+                for (u = 0; u < 8; u++) {
+                        float sum = 0;
+
+                        for (y = 0; y < 8; y++)
+                                sum += dct[v][y] * rows[y][u];
+                        coefficients[v * 8 + u] = (int)lrintf(sum / table[v * 8 + u]);
+                }
+
+        put_value(bw, dc, 0, coefficients[0] - *pred);
+        *pred = coefficients[0];
+        for (k = 1; k < 64; k++) {
+                int value = coefficients[zigzag[k]];
+
+                if (!value) {
+                        run++;
+                        continue;
+                }
+                for (; run > 15; run -= 16)
+                        put_bits(bw, ac->code[0xf0], ac->size[0xf0]);
+                put_value(bw, ac, run, value);
+                run = 0;
+        }
+        if (run)
+                put_bits(bw, ac->code[0x00], ac->size[0x00]);   /* end of block */
+}
+
+static void put_marker(struct bit_writer *bw, int marker, int length)
+{
+        put_byte(bw, 0xff);
+        put_byte(bw, marker);
+        put_byte(bw, length >> 8);
+        put_byte(bw, length & 0xff);
+}
+
+static void put_huffman_table(struct bit_writer *bw, int class_id, const unsigned char *bits,
+                              const unsigned char *values)
+{
+        int i, count = 0;
+
+        put_byte(bw, class_id);
+        for (i = 0; i < 16; i++) {
+                put_byte(bw, bits[i]);
+                count += bits[i];
+        }
+        for (i = 0; i < count; i++)
+                put_byte(bw, values[i]);
+}
+
+static void put_headers(struct bit_writer *bw, const struct jpeg_dc_picture *picture)
+{
+        const int tables = picture->components > 1 ? 2 : 1;
+        int t, i, k;
+
+        put_byte(bw, 0xff);
+        put_byte(bw, 0xd8);
+        put_marker(bw, 0xdb, 2 + tables * 65);
+        for (t = 0; t < tables; t++) {
+                put_byte(bw, t);
+                for (i = 0; i < 64; i++)
+                        put_byte(bw, quant[t][zigzag[i]]);
+        }
+        put_marker(bw, 0xc0, 8 + 3 * picture->components);
+        put_byte(bw, 8);
+        put_byte(bw, picture->image_height >> 8);
+        put_byte(bw, picture->image_height & 0xff);
+        put_byte(bw, picture->image_width >> 8);
+        put_byte(bw, picture->image_width & 0xff);
+        put_byte(bw, picture->components);
+        for (k = 0; k < picture->components; k++) {
+                put_byte(bw, k + 1);
+                put_byte(bw, picture->h[k] << 4 | picture->v[k]);
+                put_byte(bw, k ? 1 : 0);
+        }
+        put_marker(bw, 0xc4, 2 + tables * 2 * 17 + 12 + 162 +
+                   (tables > 1 ? 12 + 162 : 0));
+        put_huffman_table(bw, 0x00, jpeg_std_dc_luma_bits, jpeg_std_dc_values);
+        put_huffman_table(bw, 0x10, jpeg_std_ac_luma_bits, jpeg_std_ac_luma_values);
+        if (tables > 1) {
+                put_huffman_table(bw, 0x01, jpeg_std_dc_chroma_bits, jpeg_std_dc_values);
+                put_huffman_table(bw, 0x11, jpeg_std_ac_chroma_bits, jpeg_std_ac_chroma_values);
+        }
+        put_marker(bw, 0xda, 6 + 2 * picture->components);
+        put_byte(bw, picture->components);
+        for (k = 0; k < picture->components; k++) {
+                put_byte(bw, k + 1);
+                put_byte(bw, k ? 0x11 : 0x00);
+        }
+        put_byte(bw, 0);        /* spectral selection 0-63, no approximation */
+        put_byte(bw, 63);
+        put_byte(bw, 0);
+}
+
+int jpeg_thumbnail(const unsigned char *jpeg, int size, unsigned char *out, int out_size)
+{
+        struct jpeg_dc_picture picture;
+        struct bit_writer bw;
+        int hmax = 1, vmax = 1, mcus_x, mcus_y, mcu, k;
+        int used_width[3], used_height[3], pred[3] = { 0, 0, 0 };
+
+        if (!ready)
+                init_tables();
+        if (jpeg_dc_picture(jpeg, size, &picture, planes, sizeof(planes)) < 0)
+                return -1;
+
+        for (k = 0; k < picture.components; k++) {
+                if (picture.h[k] > hmax)
+                        hmax = picture.h[k];
+                if (picture.v[k] > vmax)
+                        vmax = picture.v[k];
+        }
+        /* past the picture's edge, the last row and column are repeated */
+        for (k = 0; k < picture.components; k++) {
+                used_width[k] = (picture.image_width * picture.h[k] + hmax - 1) / hmax;
+                used_height[k] = (picture.image_height * picture.v[k] + vmax - 1) / vmax;
+                if (used_width[k] > picture.width[k])
+                        used_width[k] = picture.width[k];
+                if (used_height[k] > picture.height[k])
+                        used_height[k] = picture.height[k];
+        }
+        mcus_x = (picture.image_width + 8 * hmax - 1) / (8 * hmax);
+        mcus_y = (picture.image_height + 8 * vmax - 1) / (8 * vmax);
+
+        bw.p = out;
+        bw.end = out + out_size;
+        bw.bits = 0;
+        bw.count = 0;
+        bw.full = 0;
+        put_headers(&bw, &picture);
+
+        for (mcu = 0; mcu < mcus_x * mcus_y && !bw.full; mcu++) {
+                for (k = 0; k < picture.components; k++) {
+                        const int table = k ? 1 : 0;
+                        int block;
+
+                        for (block = 0; block < picture.h[k] * picture.v[k]; block++) {
+                                int left = (mcu % mcus_x * picture.h[k] + block % picture.h[k]) * 8;
+                                int top = (mcu / mcus_x * picture.v[k] + block / picture.h[k]) * 8;
+                                float pixels[64];
+                                int x, y;
+
+                                for (y = 0; y < 8; y++) {
+                                        int row = top + y < used_height[k] ? top + y : used_height[k] - 1;
+
+                                        for (x = 0; x < 8; x++) {
+                                                int column = left + x < used_width[k] ?
+                                                             left + x : used_width[k] - 1;
+
+                                                pixels[y * 8 + x] = picture.plane[k][row * picture.width[k] + column] - 128.0f;
+                                        }
+                                }
+                                encode_block(&bw, pixels, quant[table], &dc_codes[table],
+                                             &ac_codes[table], &pred[k]);
+                        }
+                }
+        }
+        if (bw.count)
+                put_bits(&bw, 0x7f, 8 - bw.count);     /* padded with ones */
+        put_byte(&bw, 0xff);
+        put_byte(&bw, 0xd9);
+        if (bw.full)
+                return -1;
+        return (int)(bw.p - out);
+}
@@ -0,0 +1,18 @@
+/*
+ * Thumbnails of an MJPEG stream at 1/8 scale, straight from the DCT domain:
+ * each 8x8 block's DC coefficient is its mean, so the DC picture
+ * (jpeg_dc_picture) is the frame scaled down with no IDCT, and only that
+ * small picture is encoded again as a baseline JPEG. A 720x720 frame gives
+ * a 90x90 thumbnail of a couple of kilobytes.
+ */
+#ifndef JPEG_THUMBNAIL_H
+#define JPEG_THUMBNAIL_H
+
+/*
+ * Writes the thumbnail of jpeg to out. Returns its size, or -1 if the frame
+ * is not a baseline JPEG or the thumbnail doesn't fit in out_size. Not
+ * reentrant: the DC picture is decoded into a buffer of its own.
+ */
+int jpeg_thumbnail(const unsigned char *jpeg, int size, unsigned char *out, int out_size);
+
+#endif
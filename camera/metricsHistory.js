@@ -0,0 +1,406 @@
+// The fleet's metrics over time, kept in the gateway's memory, so a dashboard can draw the last hour, day or month
+// of any board's series without a database next to the relay. Every series has a ring of chunks at each resolution of
+// TIERS: each scrape goes into the 1 s ring as it is, and the 1 min and 1 h rings get one point per period, the mean
+// of the scrapes in it, or the last of them for counters, which only make sense as they were. A ring keeps a fixed
+// number of chunks and drops its oldest when a new one is sealed, so each series takes a bounded amount of memory, and
+// the store holds at most MAX_SERIES of them.
+//
+// A chunk is compressed as Gorilla (Pelkonen et al., VLDB 2015) does it. Timestamps count the ring's periods and are
+// stored as the change in the gap between points, which for a steady scrape is 0, one bit. Values are stored as the
+// XOR of their bits with the previous value's: a repeat is one bit, and a value that changes in a few low bits of its
+// mantissa only those bits. A gauge that holds still costs 2 bits a point; one that moves, a few bytes.
+//
+// query() answers a range from the finest ring that still reaches back to its start, decoding only the chunks that
+// overlap the range.
+const TIERS = [
+// an hour of seconds, a day of minutes, a month of hours, on top of each ring's open chunk
+{ name: '1s', resolutionMs: 1000, chunkPoints: 120, chunks: 30 },
+{ name: '1m', resolutionMs: 60000, chunkPoints: 60, chunks: 24 },
+{ name: '1h', resolutionMs: 3600000, chunkPoints: 24, chunks: 30 },
+];
+const MAX_SERIES = 10000;
+// an open chunk starts this big and doubles as it fills; it is cut to size when sealed
+const CHUNK_START_BYTES = 32;
+// series nothing has been heard of for longer than the coarsest ring reaches back are forgotten, checked this often
+const PRUNE_INTERVAL_MS = 3600000;
+
+const float = new DataView(new ArrayBuffer(8));
+
+function retentionMs(tier) {
+return tier.resolutionMs * tier.chunkPoints * tier.chunks;
+}
+
+// { bytes, bits } the chunk is written into
+function writeBits(writer, value, count) {
+for (let i = count - 1; i >= 0; i--) {
+if ((writer.bits >> 3) === writer.bytes.length) {
+const grown = new Uint8Array(writer.bytes.length * 2);
+grown.set(writer.bytes);
+writer.bytes = grown;
+}
+if ((value >>> i) & 1) {
+writer.bytes[writer.bits >> 3] |= 0x80 >> (writer.bits & 7);
+}
+writer.bits++;
+}
+}
+
+// { bytes, bit } read from; up to 32 bits, unsigned
+function readBits(reader, count) {
+let value = 0;
+for (let i = 0; i < count; i++) {
+value = ((value << 1) | ((reader.bytes[reader.bit >> 3] >> (7 - (reader.bit & 7))) & 1)) >>> 0;
+reader.bit++;
+}
+return value;
+}
+
+function readSigned(reader, count) {
+const value = readBits(reader, count);
+return count === 32 ? value | 0 : (value >= 2 ** (count - 1) ? value - 2 ** count : value);
+}
+
+// a 64-bit pair shifted right by 0 to 63
+function shiftRight(hi, lo, shift) {
+if (shift === 0) {
+return [hi, lo];
+}
+if (shift < 32) {
+return [hi >>> shift, ((lo >>> shift) | (hi << (32 - shift))) >>> 0];
+}
+return [0, hi >>> (shift - 32)];
+}
+
+function shiftLeft(hi, lo, shift) {
+if (shift === 0) {
+return [hi, lo];
+}
+if (shift < 32) {
+return [((hi << shift) | (lo >>> (32 - shift))) >>> 0, (lo << shift) >>> 0];
+}
+return [(lo << (shift - 32)) >>> 0, 0];
+}
+
+function trailingZeros(x) {
+return 31 - Math.clz32(x & -x);
+}
+
+function startChunk(time, value) {
+const chunk = { writer: { bytes: new Uint8Array(CHUNK_START_BYTES), bits: 0 }, count: 1, firstTime: time,
+lastTime: time, delta: 0, hi: 0, lo: 0, leading: -1, trailing: 0 };
+float.setFloat64(0, value);
+chunk.hi = float.getUint32(0);
+chunk.lo = float.getUint32(4);
+writeBits(chunk.writer, time, 32);
+writeBits(chunk.writer, chunk.hi, 32);
+writeBits(chunk.writer, chunk.lo, 32);
+return chunk;
+}
+
+function appendPoint(chunk, time, value) {
+const writer = chunk.writer;
+const delta = time - chunk.lastTime;
+const deltaOfDelta = delta - chunk.delta;
+if (deltaOfDelta === 0) {
+writeBits(writer, 0, 1);
+} else if (deltaOfDelta >= -64 && deltaOfDelta < 64) {
+writeBits(writer, 0b10, 2);
+writeBits(writer, deltaOfDelta & 0x7f, 7);
+} else if (deltaOfDelta >= -256 && deltaOfDelta < 256) {
+writeBits(writer, 0b110, 3);
+writeBits(writer, deltaOfDelta & 0x1ff, 9);
+} else if (deltaOfDelta >= -2048 && deltaOfDelta < 2048) {
+writeBits(writer, 0b1110, 4);
+writeBits(writer, deltaOfDelta & 0xfff, 12);
+} else {
+writeBits(writer, 0b1111, 4);
+writeBits(writer, deltaOfDelta >>> 0, 32);
+}
+chunk.delta = delta;
+chunk.lastTime = time;
+chunk.count++;
+
+float.setFloat64(0, value);
+const hi = float.getUint32(0);
+const lo = float.getUint32(4);
+const xorHi = (hi ^ chunk.hi) >>> 0;
+const xorLo = (lo ^ chunk.lo) >>> 0;
+chunk.hi = hi;
+chunk.lo = lo;
+if (xorHi === 0 && xorLo === 0) {
+writeBits(writer, 0, 1);
+return;
+}
+// 5 bits hold a leading count up to 31
+const leading = Math.min(31, xorHi ? Math.clz32(xorHi) : 32 + Math.clz32(xorLo));
+const trailing = xorLo ? trailingZeros(xorLo) : 32 + trailingZeros(xorHi);
+if (chunk.leading >= 0 && leading >= chunk.leading && trailing >= chunk.trailing) {
+// inside the previous value's window: only the bits in it
+writeBits(writer, 0b10, 2);
+} else {
+writeBits(writer, 0b11, 2);
+writeBits(writer, leading, 5);
+// 64 bits goes in as 0
+writeBits(writer, (64 - leading - trailing) & 0x3f, 6);
+chunk.leading = leading;
+chunk.trailing = trailing;
+}
+const length = 64 - chunk.leading - chunk.trailing;
+const [meaningfulHi, meaningfulLo] = shiftRight(xorHi, xorLo, chunk.trailing);
+if (length > 32) {
+writeBits(writer, meaningfulHi, length - 32);
+writeBits(writer, meaningfulLo, 32);
+} else {
+writeBits(writer, meaningfulLo, length);
+}
+}
+
+// the open chunk's bytes, cut to what it holds, and what a query needs of it
+function sealChunk(chunk) {
+return { bytes: chunk.writer.bytes.slice(0, (chunk.writer.bits + 7) >> 3), count: chunk.count,
+firstTime: chunk.firstTime, lastTime: chunk.lastTime };
+}
+
+// the chunk's points from time `from` to `to`, in the ring's periods, as [ms since 1970, value]
+function decodeChunk(chunk, resolutionMs, from, to, points) {
+const reader = { bytes: chunk.writer ? chunk.writer.bytes : chunk.bytes, bit: 0 };
+let time = readBits(reader, 32);
+let hi = readBits(reader, 32);
+let lo = readBits(reader, 32);
+let delta = 0;
+let leading = 0;
+let trailing = 0;
+for (let i = 0; ; i++) {
+if (time > to) {
+return;
+}
+if (time >= from) {
+float.setUint32(0, hi);
+float.setUint32(4, lo);
+points.push([time * resolutionMs, float.getFloat64(0)]);
+}
+if (i + 1 === chunk.count) {
+return;
+}
+let deltaOfDelta = 0;
+if (readBits(reader, 1)) {
+if (!readBits(reader, 1)) {
+deltaOfDelta = readSigned(reader, 7);
+} else if (!readBits(reader, 1)) {
+deltaOfDelta = readSigned(reader, 9);
+} else if (!readBits(reader, 1)) {
+deltaOfDelta = readSigned(reader, 12);
+} else {
+deltaOfDelta = readSigned(reader, 32);
+}
+}
+delta += deltaOfDelta;
+time += delta;
+if (readBits(reader, 1)) {
+if (readBits(reader, 1)) {
+leading = readBits(reader, 5);
+trailing = 64 - leading - (readBits(reader, 6) || 64);
+}
+const length = 64 - leading - trailing;
+let meaningfulHi = 0;
+let meaningfulLo = 0;
+if (length > 32) {
+meaningfulHi = readBits(reader, length - 32);
+meaningfulLo = readBits(reader, 32);
+} else {
+meaningfulLo = readBits(reader, length);
+}
+const [xorHi, xorLo] = shiftLeft(meaningfulHi, meaningfulLo, trailing);
+hi = (hi ^ xorHi) >>> 0;
+lo = (lo ^ xorLo) >>> 0;
+}
+}
+}
+
+// { ring, head, size, open } of one tier; the coarser tiers also hold the period being gathered
+function createRing(tier) {
+return { ring: new Array(tier.chunks), head: 0, size: 0, open: null, bytes: 0, period: -1, sum: 0, count: 0,
+last: 0 };
+}
+
+function appendToRing(ring, tier, time, value) {
+if (!ring.open) {
+ring.open = startChunk(time, value);
+return;
+}
+// a scrape that finished in the same second as the one before it
+if (time <= ring.open.lastTime) {
+return;
+}
+appendPoint(ring.open, time, value);
+if (ring.open.count < tier.chunkPoints) {
+return;
+}
+const sealed = sealChunk(ring.open);
+ring.open = null;
+if (ring.size === tier.chunks) {
+ring.bytes -= ring.ring[ring.head].bytes.length;
+ring.ring[ring.head] = sealed;
+ring.head = (ring.head + 1) % tier.chunks;
+} else {
+ring.ring[(ring.head + ring.size) % tier.chunks] = sealed;
+ring.size++;
+}
+ring.bytes += sealed.bytes.length;
+}
+
+// Prometheus' own spellings of the values that aren't numbers
+function parseValue(text) {
+if (text === '+Inf') {
+return Infinity;
+}
+if (text === '-Inf') {
+return -Infinity;
+}
+return Number(text);
+}
+
+function parseLabels(text) {
+const labels = {};
+const label = /([A-Za-z_][A-Za-z0-9_]*)="((?:[^"\\]|\\.)*)"/g;
+let match;
+while ((match = label.exec(text)) !== null) {
+labels[match[1]] = match[2].replace(/\\(.)/g, (_, escaped) => (escaped === 'n' ? '\n' : escaped));
+}
+return labels;
+}
+
+function createMetricsHistory() {
+const series = new Map(); // name + labels as scraped -> { name, labels, isCounter, lastMs, rings }
+let droppedSeries = 0;
+let prunedAt = 0;
+
+function record(entry, nowMs, value) {
+entry.lastMs = nowMs;
+appendToRing(entry.rings[0], TIERS[0], Math.round(nowMs / TIERS[0].resolutionMs), value);
+for (let i = 1; i < TIERS.length; i++) {
+const ring = entry.rings[i];
+const period = Math.floor(nowMs / TIERS[i].resolutionMs);
+if (period !== ring.period) {
+if (ring.count > 0) {
+appendToRing(ring, TIERS[i], ring.period, entry.isCounter ? ring.last : ring.sum / ring.count);
+}
+ring.period = period;
+ring.sum = 0;
+ring.count = 0;
+}
+ring.sum += value;
+ring.count++;
+ring.last = value;
+}
+}
+
+function prune(nowMs) {
+const oldestMs = nowMs - retentionMs(TIERS[TIERS.length - 1]);
+for (const [key, entry] of series) {
+if (entry.lastMs < oldestMs) {
+series.delete(key);
+}
+}
+prunedAt = nowMs;
+}
+
+// one board's scrape, in the exposition format, taken at nowMs
+function ingest(board, text, nowMs) {
+if (nowMs - prunedAt >= PRUNE_INTERVAL_MS) {
+prune(nowMs);
+}
+let family = null; // { name, type } of the last TYPE line
+for (const line of text.split('\n')) {
+const type = /^# TYPE (\S+) (\S+)/.exec(line);
+if (type) {
+family = { name: type[1], type: type[2] };
+continue;
+}
+if (!line || line[0] === '#') {
+continue;
+}
+const sample = /^([^{\s]+)(\{.*\})?\s+(\S+)/.exec(line);
+if (!sample) {
+continue;
+}
+const [, name, labelText = '', valueText] = sample;
+const value = parseValue(valueText);
+const key = `${board}\u0000${name}${labelText}`;
+let entry = series.get(key);
+if (!entry) {
+if (series.size >= MAX_SERIES) {
+droppedSeries++;
+continue;
+}
+// a histogram's buckets, sum and count only ever grow, as does a summary's count and sum
+const ofFamily = family && name.startsWith(family.name);
+const isCounter = ofFamily && (family.type === 'counter' || family.type === 'histogram' ||
+(family.type === 'summary' && /_(sum|count)$/.test(name)));
+entry = { name, labels: { board, ...parseLabels(labelText) }, isCounter: Boolean(isCounter), lastMs: nowMs,
+rings: TIERS.map(createRing) };
+series.set(key, entry);
+}
+record(entry, nowMs, value);
+}
+}
+
+// { resolutionMs, series: [{ labels, points: [[ms since 1970, value], ...] }] } of every series called `name` whose
+// labels include all of `matchers`, from startMs to endMs, from the finest ring at least stepMs apart that reaches
+// back to startMs
+function query(name, matchers, startMs, endMs, stepMs = 0) {
+const nowMs = Date.now();
+let tierIndex = TIERS.findIndex((tier) => tier.resolutionMs >= stepMs && nowMs - retentionMs(tier) <= startMs);
+if (tierIndex < 0) {
+tierIndex = TIERS.length - 1;
+}
+const tier = TIERS[tierIndex];
+const from = Math.ceil(startMs / tier.resolutionMs);
+const to = Math.floor(endMs / tier.resolutionMs);
+const result = [];
+for (const entry of series.values()) {
+if (entry.name !== name || !Object.keys(matchers).every((label) => entry.labels[label] === matchers[label])) {
+continue;
+}
+const ring = entry.rings[tierIndex];
+const points = [];
+for (let i = 0; i < ring.size; i++) {
+const chunk = ring.ring[(ring.head + i) % tier.chunks];
+if (chunk.lastTime >= from && chunk.firstTime <= to) {
+decodeChunk(chunk, tier.resolutionMs, from, to, points);
+}
+}
+if (ring.open && ring.open.lastTime >= from && ring.open.firstTime <= to) {
+decodeChunk(ring.open, tier.resolutionMs, from, to, points);
+}
+if (points.length) {
+result.push({ labels: entry.labels, points });
+}
+}
+return { resolutionMs: tier.resolutionMs, series: result };
+}
+
+// the names there is history of, with how many series each
+function names() {
+const counts = new Map();
+for (const entry of series.values()) {
+counts.set(entry.name, (counts.get(entry.name) || 0) + 1);
+}
+return [...counts].map(([name, count]) => ({ name, series: count })).sort((a, b) => (a.name < b.name ? -1 : 1));
+}
+
+// bytes counts the compressed chunks, open ones at their current size
+function stats() {
+let bytes = 0;
+for (const entry of series.values()) {
+for (const ring of entry.rings) {
+bytes += ring.bytes + (ring.open ? ring.open.writer.bytes.length : 0);
+}
+}
+return { series: series.size, bytes, droppedSeries };
+}
+
+return { ingest, query, names, stats };
+}
+
+module.exports = { createMetricsHistory, TIERS };
@@ -1,11 +1,53 @@
 const express = require('express');
 const router = express.Router();
 const path = require('path');
+const fs = require('fs');
+const zlib = require('zlib');
+const crypto = require('crypto');
 const filePath = "/../public/";
-router.get('/', function(req, res) {
-res.sendFile(path.join(__dirname + filePath + "homepage.html"));
-});
-router.get('/script.js', function(req, res) {
-res.sendFile(path.join(__dirname + filePath + "script.js"));
-});
-module.exports = router;
\ No newline at end of file
+
+// The pages are read, hashed and compressed once at startup, so a request costs no disk access or compression.
+// script.js is linked by its hash and cached for good; the page and the worker are revalidated by ETag (a 304).
+const IMMUTABLE = 'public, max-age=31536000, immutable';
+const REVALIDATE = 'no-cache';
+
+function loadAsset(name, type, transform = (body) => body) {
+const body = transform(fs.readFileSync(path.join(__dirname + filePath + name)));
+return {
+type,
+body,
+hash: crypto.createHash('sha1').update(body).digest('hex').slice(0, 16),
+gzip: zlib.gzipSync(body, { level: zlib.constants.Z_BEST_COMPRESSION }),
+br: zlib.brotliCompressSync(body, { params: { [zlib.constants.BROTLI_PARAM_QUALITY]: zlib.constants.BROTLI_MAX_QUALITY } }),
+};
+}
+
+function serve(asset, cacheControl) {
+return function(req, res) {
+res.set('Cache-Control', cacheControl);
+res.set('ETag', '"' + asset.hash + '"');
+res.set('Vary', 'Accept-Encoding');
+res.type(asset.type);
+if (req.fresh) {
+res.status(304).end();
+return;
+}
+const encoding = req.acceptsEncodings('br', 'gzip');
+if (encoding === 'br' || encoding === 'gzip') {
+res.set('Content-Encoding', encoding);
+res.send(encoding === 'br' ? asset.br : asset.gzip);
+} else {
+res.send(asset.body);
+}
+};
+}
+
+const script = loadAsset("script.js", 'js');
+const worker = loadAsset("renderWorker.js", 'js');
+const homepage = loadAsset("homepage.html", 'html',
+(body) => Buffer.from(body.toString().replace('src="script.js"', `src="script.js?v=${script.hash}"`)));
+
+router.get('/', serve(homepage, REVALIDATE));
+router.get('/script.js', serve(script, IMMUTABLE));
+router.get('/renderWorker.js', serve(worker, REVALIDATE));
+module.exports = router;
@@ -0,0 +1,248 @@
+/*
+ * Pellet consumption after a feed, see pellet_watch.h.
+ *
+ * The blocks that count as pellets are kept as a bit mask, 64 blocks to a
+ * word, so the area is a popcount per word and the blobs are found from the
+ * runs of set bits in each row, joined to the runs they touch in the row
+ * above; a pixel-by-pixel flood fill is never needed.
+ */
+#include "pellet_watch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "jpeg_activity.h"
+
+#define PELLET_WINDOW_MS 480000         /* after this the rest is left over */
+#define PELLET_SAMPLE_MS 250
+#define PELLET_REFERENCE_SAMPLES 3      /* the median of these is the picture before the pellets */
+#define PELLET_LUMA_DELTA 10            /* change from the feed's picture that marks a block */
+#define PELLET_PERSIST 4                /* samples a block stays changed to be a pellet, not a fish */
+#define PELLET_MIN_BLOCKS 4             /* a smaller peak is no feed seen */
+#define PELLET_EATEN_PERCENT 10
+#define PELLET_CONFIRM_MS 5000          /* eaten only if it stays that low this long */
+
+#define PELLET_MAX_BLOCKS 32768         /* 1920x1080 is 32400 */
+#define PELLET_MAX_WORDS (PELLET_MAX_BLOCKS / 64 + 256)
+#define PELLET_MAX_RUNS (PELLET_MAX_BLOCKS / 2 + 256)
+
+struct run {
+        int start, end;                 /* [start, end) in blocks */
+        int label;
+};
+
+static int active;
+static int64_t feed_time_us;
+static uint32_t feed_ms, last_sample_ms, below_since_ms;
+static int reference_samples;
+static int width, height, words_per_row;
+static unsigned char reference[PELLET_MAX_BLOCKS];
+static unsigned char earlier[PELLET_REFERENCE_SAMPLES - 1][PELLET_MAX_BLOCKS];
+static unsigned char current[PELLET_MAX_BLOCKS];
+static unsigned char persist[PELLET_MAX_BLOCKS];
+static uint64_t mask[PELLET_MAX_WORDS];
+static struct run runs[PELLET_MAX_RUNS];
+static int parent[PELLET_MAX_RUNS];
+static unsigned int peak_blocks, peak_blobs;
+
+void pellet_watch_feed(uint32_t now_ms, int64_t time_us)
+{
+        /* a feed on top of one still being watched starts over */
+        active = 1;
+        feed_time_us = time_us;
+        feed_ms = now_ms;
+        last_sample_ms = now_ms - PELLET_SAMPLE_MS;
+        below_since_ms = 0;
+        reference_samples = 0;
+        peak_blocks = 0;
+        peak_blobs = 0;
+}
+
+static int find(int label)
+{
+        while (parent[label] != label)
+                label = parent[label] = parent[parent[label]];
+        return label;
+}
+
+static unsigned char median3(unsigned char a, unsigned char b, unsigned char c)
+{
+        if (a > b) {
+                unsigned char t = a;
+
+                a = b;
+                b = t;
+        }
+        return c <= a ? a : c >= b ? b : c;
+}
+
+/*
+ * Takes the picture at the feed from its first samples, before many pellets
+ * are in it. Block by block, the median leaves out a fish passing through
+ * one of them, which would otherwise be left behind as a pellet.
+ */
+static void add_reference(void)
+{
+        int i;
+
+        if (reference_samples < PELLET_REFERENCE_SAMPLES - 1) {
+                memcpy(earlier[reference_samples++], current, (size_t)width * height);
+                return;
+        }
+        for (i = 0; i < width * height; i++)
+                reference[i] = median3(earlier[0][i], earlier[1][i], current[i]);
+        memset(persist, 0, (size_t)width * height);
+        reference_samples++;
+}
+
+/* The first block at or after x whose bit is want, or width. */
+static int next_bit(const uint64_t *row, int x, int want)
+{
+        while (x < width) {
+                uint64_t word = row[x / 64];
+
+                if (!want)
+                        word = ~word;
+                word >>= x % 64;
+                if (word) {
+                        x += __builtin_ctzll(word);
+                        return x < width ? x : width;
+                }
+                x = (x / 64 + 1) * 64;
+        }
+        return width;
+}
+
+/* Marks the pellets of this sample in mask; returns how many blocks. */
+static unsigned int mark_pellets(void)
+{
+        unsigned int area = 0;
+        int y, x, i;
+
+        memset(mask, 0, (size_t)words_per_row * height * sizeof(mask[0]));
+        for (y = 0; y < height; y++) {
+                uint64_t *row = mask + (size_t)y * words_per_row;
+
+                for (x = 0; x < width; x++) {
+                        int diff;
+
+                        i = y * width + x;
+                        diff = current[i] - reference[i];
+                        if (diff > PELLET_LUMA_DELTA || diff < -PELLET_LUMA_DELTA) {
+                                if (persist[i] < PELLET_PERSIST)
+                                        persist[i]++;
+                        } else {
+                                persist[i] = 0;
+                        }
+                        if (persist[i] >= PELLET_PERSIST)
+                                row[x / 64] |= (uint64_t)1 << (x % 64);
+                }
+        }
+        for (i = 0; i < words_per_row * height; i++)
+                area += (unsigned int)__builtin_popcountll(mask[i]);
+        return area;
+}
+
+/* Counts the 4-connected blobs in mask. */
+static unsigned int count_blobs(void)
+{
+        int n = 0, previous_first = 0, previous_end = 0;
+        unsigned int blobs = 0;
+        int y, i;
+
+        for (y = 0; y < height; y++) {
+                const uint64_t *row = mask + (size_t)y * words_per_row;
+                int first = n, x = 0, p = previous_first;
+
+                while (n < PELLET_MAX_RUNS) {
+                        int start = next_bit(row, x, 1);
+
+                        if (start == width)
+                                break;
+                        x = next_bit(row, start, 0);
+                        runs[n].start = start;
+                        runs[n].end = x;
+                        runs[n].label = n;
+                        parent[n] = n;
+                        /* the runs above are in order too, so one pass joins them */
+                        while (p < previous_end && runs[p].end <= start)
+                                p++;
+                        for (i = p; i < previous_end && runs[i].start < x; i++) {
+                                int a = find(n), b = find(runs[i].label);
+
+                                if (a != b)
+                                        parent[a] = b;
+                        }
+                        n++;
+                }
+                previous_first = first;
+                previous_end = n;
+        }
+        for (i = 0; i < n; i++)
+                if (find(i) == i)
+                        blobs++;
+        return blobs;
+}
+
+int pellet_watch_frame(uint32_t now_ms, const unsigned char *jpeg, int size,
+                       struct pellet_result *result)
+{
+        int w, h;
+        unsigned int area, blobs;
+
+        if (!active || now_ms - last_sample_ms < PELLET_SAMPLE_MS)
+                return 0;
+        last_sample_ms = now_ms;
+        if (jpeg_luma_blocks(jpeg, size, current, PELLET_MAX_BLOCKS, &w, &h) < 0)
+                return 0;
+        if (w != width || h != height) {
+                width = w;
+                height = h;
+                words_per_row = (w + 63) / 64;
+                reference_samples = 0;
+                if ((size_t)words_per_row * h > PELLET_MAX_WORDS) {
+                        active = 0;
+                        return 0;
+                }
+        }
+        if (reference_samples < PELLET_REFERENCE_SAMPLES) {
+                add_reference();
+                return 0;
+        }
+
+        area = mark_pellets();
+        blobs = count_blobs();
+        if (area > peak_blocks) {
+                peak_blocks = area;
+                peak_blobs = blobs;
+        }
+
+        memset(result, 0, sizeof(*result));
+        result->feed_time_us = feed_time_us;
+        result->peak_blocks = peak_blocks;
+        result->peak_blobs = peak_blobs;
+        if (peak_blocks >= PELLET_MIN_BLOCKS && area * 100 <= peak_blocks * PELLET_EATEN_PERCENT) {
+                if (!below_since_ms)
+                        below_since_ms = now_ms;
+                if (now_ms - below_since_ms >= PELLET_CONFIRM_MS) {
+                        active = 0;
+                        result->eaten = 1;
+                        result->seconds = (below_since_ms - feed_ms) / 1000;
+                        result->left_percent = peak_blocks ? area * 100 / peak_blocks : 0;
+                        return 1;
+                }
+        } else {
+                below_since_ms = 0;
+        }
+        if (now_ms - feed_ms >= PELLET_WINDOW_MS) {
+                active = 0;
+                if (peak_blocks < PELLET_MIN_BLOCKS) {
+                        fprintf(stderr, "pellets: none seen after the feed\n");
+                        return 0;
+                }
+                result->seconds = PELLET_WINDOW_MS / 1000;
+                result->left_percent = area * 100 / peak_blocks;
+                return 1;
+        }
+        return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * Pellet consumption: after each feed, how long the fish take to eat what
+ * floats. Only runs in a window after a feed, on a few frames a second,
+ * from a 1/8 scale luma picture decoded from the DC coefficients alone
+ * (jpeg_luma_blocks). Blocks that have changed from the picture at the
+ * feed, and stay changed, are pellets; a fish only passes through. Once
+ * their area falls to a tenth of its peak, the feed counts as eaten.
+ */
+#ifndef PELLET_WATCH_H
+#define PELLET_WATCH_H
+
+#include <stdint.h>
+
+/*
+ * What became of a feed. seconds is from the feed until the pellets were
+ * eaten, or until the window closed with left_percent of the peak still
+ * there.
+ */
+struct pellet_result {
+        int64_t feed_time_us;   /* the feed journal's time of the feed */
+        int eaten;
+        unsigned int seconds;
+        unsigned int left_percent;
+        unsigned int peak_blocks;
+        unsigned int peak_blobs;
+};
+
+/* Starts watching: now_ms is CLOCK_MONOTONIC, feed_time_us names the feed. */
+void pellet_watch_feed(uint32_t now_ms, int64_t feed_time_us);
+
+/*
+ * Looks at a frame if one is due. Returns 1 and fills result once the feed's
+ * outcome is known, 0 otherwise.
+ */
+int pellet_watch_frame(uint32_t now_ms, const unsigned char *jpeg, int size,
+                       struct pellet_result *result);
+
+#endif
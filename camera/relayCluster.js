@@ -0,0 +1,124 @@
+// RELAY_WORKERS=n: n processes share SERVER_PORT (node's cluster module hands each new connection to one of them) and
+// serve the viewers, each with a viewerHub.js of its own, so the socket.io and HTTP work spreads over the cores. The
+// stream still comes in only once: the primary process runs the ingest (ingestWorker.js) and passes every frame on to
+// the workers that have viewers, over their IPC channels with structured clone, so a frame goes as its bytes rather
+// than as JSON. It also runs what there is only one of: the feeder's event stream, whose events go to every worker,
+// and capture.c's viewer count, the sum of the workers' own.
+//
+// A worker whose channel is backed up is skipped for a frame, as a viewer is in viewerHub.js, so one busy worker
+// neither queues frames without bound nor holds up the others. A worker that dies is started again.
+//
+// Viewers connect over WebSocket only (script.js), since socket.io's HTTP long-polling would need every request of a
+// session to reach the same worker.
+const cluster = require('cluster');
+
+// frames sent to a worker that it hasn't taken off its channel yet
+const MAX_QUEUED = 4;
+
+// the primary of a cluster, which serves nothing itself and runs startRelayPrimary instead of the relay
+function isRelayPrimary(workers) {
+return workers > 1 && cluster.isPrimary;
+}
+
+// startIngest(onFrame, onLink) and subscribeEvents(onEvent) as in index.js; onViewers(count) hears the total
+function startRelayPrimary(workers, startIngest, onViewers, subscribeEvents) {
+cluster.setupPrimary({ serialization: 'advanced' });
+const viewers = new Map(); // worker -> its viewer count
+const watching = new Map(); // worker -> frames queued on its channel, for workers whose hub runs the ingest
+let ingest = null;
+
+function onFrame(frame, timestampMs, streamId, sequence, timing) {
+for (const [worker, queued] of watching) {
+if (queued >= MAX_QUEUED) {
+continue;
+}
+watching.set(worker, queued + 1);
+worker.send({ frame, timestampMs, streamId, sequence, timing }, (err) => {
+if (!err && watching.has(worker)) {
+watching.set(worker, watching.get(worker) - 1);
+}
+});
+}
+}
+
+function update() {
+if (watching.size > 0 && !ingest) {
+ingest = startIngest(onFrame);
+} else if (watching.size === 0 && ingest) {
+ingest.close();
+ingest = null;
+}
+let total = 0;
+for (const count of viewers.values()) {
+total += count;
+}
+onViewers(total);
+}
+
+function fork() {
+const worker = cluster.fork();
+worker.on('message', (message) => {
+if (message.ingest !== undefined) {
+if (message.ingest) {
+watching.set(worker, 0);
+} else {
+watching.delete(worker);
+}
+update();
+} else if (message.viewers !== undefined) {
+viewers.set(worker, message.viewers);
+update();
+}
+});
+}
+
+cluster.on('exit', (worker, code, signal) => {
+console.error(`relay worker ${worker.process.pid} exited (${signal || code}), starting another`);
+viewers.delete(worker);
+watching.delete(worker);
+update();
+fork();
+});
+subscribeEvents((event) => {
+for (const worker of Object.values(cluster.workers)) {
+worker.send({ feeder: event });
+}
+});
+for (let i = 0; i < workers; i++) {
+fork();
+}
+}
+
+// In a worker, in place of startWorkerIngest: the primary's frames, while this worker's hub wants them
+function startClusterIngest(onFrame) {
+function onMessage(message) {
+if (message.frame) {
+onFrame(message.frame, message.timestampMs, message.streamId, message.sequence, message.timing);
+}
+}
+process.on('message', onMessage);
+process.send({ ingest: true });
+return {
+close() {
+process.off('message', onMessage);
+process.send({ ingest: false });
+},
+};
+}
+
+// In a worker: this worker's viewer count, for the primary to add up
+function reportClusterViewers(count) {
+process.send({ viewers: count });
+}
+
+// In a worker, in place of subscribeFeederEvents
+function subscribeClusterEvents(onEvent) {
+process.on('message', (message) => {
+if (message.feeder) {
+onEvent(message.feeder);
+}
+});
+}
+
+module.exports = { isRelayPrimary, startRelayPrimary, startClusterIngest, reportClusterViewers,
+subscribeClusterEvents };
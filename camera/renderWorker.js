@@ -0,0 +1,122 @@
+// Decodes and draws the camera frames off the page's main thread. script.js hands over each camera's canvas once, as
+// an OffscreenCanvas, then sends one JPEG at a time per camera and waits for the reply before sending the next.
+// H.264 access units (capture.c -F) all have to be decoded, in order, so those are sent as they come and replied to
+// one by one as WebCodecs puts each picture out. JPEGs are drawn on the worker's next animation frame, where it has
+// one, and H.264 pictures aren't drawn at all while the page is hidden.
+const contexts = {};
+const decoders = {}; // streamId -> { decoder, waiting }
+const pictures = new Map(); // streamId -> the decoded JPEG waiting for the next animation frame
+let isDrawScheduled = false;
+let hidden = false;
+
+const NAL_SLICE = 1;
+const NAL_IDR = 5;
+const NAL_SPS = 7;
+
+// the NAL unit types of an Annex-B access unit, up to its first slice
+function nalTypes(data) {
+    const types = [];
+    for (let i = 0; i + 3 < data.length; i++) {
+    if (data[i] === 0 && data[i + 1] === 0 && data[i + 2] === 1) {
+    const type = data[i + 3] & 0x1f;
+    types.push({ type, at: i + 3 });
+    if (type >= NAL_SLICE && type <= NAL_IDR) {
+    break;
+    }
+    i += 2;
+    }
+    }
+    return types;
+}
+
+// avc1.PPCCLL: profile, constraint flags and level, the three bytes after the SPS header
+function codecString(data, sps) {
+    const hex = (byte) => byte.toString(16).padStart(2, "0");
+    return "avc1." + hex(data[sps + 1]) + hex(data[sps + 2]) + hex(data[sps + 3]);
+}
+
+function decodeH264(message) {
+    const data = new Uint8Array(message.data);
+    const types = nalTypes(data);
+    const key = types.some((nal) => nal.type === NAL_IDR);
+    let stream = decoders[message.streamId];
+    if (!stream) {
+    const sps = types.find((nal) => nal.type === NAL_SPS);
+    if (!key || !sps || sps.at + 3 >= data.length) {
+    postMessage({ streamId: message.streamId, h264: true }); // nothing to start from yet
+    return;
+    }
+    stream = { decoder: null, waiting: 0 };
+    stream.decoder = new VideoDecoder({
+    output: function(frame) {
+    if (!hidden) {
+    const context = contexts[message.streamId];
+    context.drawImage(frame, 0, 0, context.canvas.width, context.canvas.height);
+    }
+    frame.close();
+    stream.waiting--;
+    postMessage({ streamId: message.streamId, h264: true, hidden });
+    },
+    error: function() {
+    // start over at the next IDR picture
+    delete decoders[message.streamId];
+    for (; stream.waiting > 0; stream.waiting--) {
+    postMessage({ streamId: message.streamId, h264: true });
+    }
+    }
+    });
+    // no description: the chunks stay in Annex-B form, parameter sets in band
+    stream.decoder.configure({ codec: codecString(data, sps.at), optimizeForLatency: true });
+    decoders[message.streamId] = stream;
+    }
+    stream.waiting++;
+    stream.decoder.decode(new EncodedVideoChunk({ type: key ? "key" : "delta", timestamp: message.timestampMs * 1000, data }));
+}
+
+function drawPictures() {
+    isDrawScheduled = false;
+    for (const [streamId, image] of pictures) {
+    // scaled to the canvas, as script.js does
+    const context = contexts[streamId];
+    context.drawImage(image, 0, 0, context.canvas.width, context.canvas.height);
+    image.close();
+    postMessage({ streamId });
+    }
+    pictures.clear();
+}
+
+function scheduleDraw() {
+    if (isDrawScheduled) {
+    return;
+    }
+    isDrawScheduled = true;
+    if (typeof requestAnimationFrame === "function") {
+    requestAnimationFrame(drawPictures);
+    } else {
+    setTimeout(drawPictures, 0);
+    }
+}
+
+onmessage = function(event) {
+    const message = event.data;
+    if (message.hidden !== undefined) {
+    hidden = message.hidden;
+    return;
+    }
+    if (message.canvas) {
+    contexts[message.streamId] = message.canvas.getContext('2d');
+    return;
+    }
+    if (message.h264) {
+    decodeH264(message);
+    return;
+    }
+    createImageBitmap(new Blob([message.data], { type: "image/jpeg" })).then(function(image){
+    // script.js sends a camera's next JPEG only after the reply, so nothing here is replaced before it's drawn
+    pictures.set(message.streamId, image);
+    scheduleDraw();
+}, function(){
+    // a frame that can't be decoded is simply not drawn
+    postMessage({ streamId: message.streamId });
+});
+};
@@ -0,0 +1,209 @@
+// Receives the RTP/JPEG stream capture.c sends with --rtp and rebuilds each frame's JPEG in Node (RFC 2435,
+// Appendix B): the scan data is passed through as sent, and only the headers RTP/JPEG leaves out are put back,
+// so nothing is decoded or re-encoded and no ffmpeg is needed.
+const dgram = require('dgram');
+const { joinGroup } = require('./frameReceiver.js');
+
+const RTP_HEADER_SIZE = 12;
+const JPEG_HEADER_SIZE = 8;
+const RESTART_HEADER_SIZE = 4;
+const QTABLE_HEADER_SIZE = 4;
+const PAYLOAD_TYPE_JPEG = 26;
+const RECV_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// natural order index of each zigzag position
+const ZIGZAG = [
+0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63];
+
+// ITU T.81 K.1, natural order; scaled by Q for Q < 128 (RFC 2435 Appendix A)
+const LUMA_QUANT = [
+16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99];
+const CHROMA_QUANT = [
+17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99];
+
+// ITU T.81 K.3: RTP/JPEG always uses these Huffman tables
+const DC_LUMA_BITS = [0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0];
+const DC_CHROMA_BITS = [0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0];
+const DC_VALUES = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11];
+const AC_LUMA_BITS = [0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d];
+const AC_LUMA_VALUES = [
+0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+0xf9, 0xfa];
+const AC_CHROMA_BITS = [0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77];
+const AC_CHROMA_VALUES = [
+0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+0xf9, 0xfa];
+
+function segment(marker, body) {
+const header = Buffer.from([0xff, marker, (body.length + 2) >> 8, (body.length + 2) & 0xff]);
+return Buffer.concat([header, body]);
+}
+
+function huffmanSegment(tableClass, id, bits, values) {
+return segment(0xc4, Buffer.from([tableClass << 4 | id, ...bits, ...values]));
+}
+
+// the DHT never changes, so it is built once
+const HUFFMAN_TABLES = Buffer.concat([
+huffmanSegment(0, 0, DC_LUMA_BITS, DC_VALUES),
+huffmanSegment(1, 0, AC_LUMA_BITS, AC_LUMA_VALUES),
+huffmanSegment(0, 1, DC_CHROMA_BITS, DC_VALUES),
+huffmanSegment(1, 1, AC_CHROMA_BITS, AC_CHROMA_VALUES)]);
+
+// luma then chroma, 64 bytes each in zigzag order
+function scaledTables(q) {
+const factor = Math.min(Math.max(q, 1), 99);
+const scale = factor < 50 ? Math.floor(5000 / factor) : 200 - factor * 2;
+const tables = Buffer.alloc(128);
+for (let i = 0; i < 64; i++) {
+tables[i] = Math.min(Math.max(Math.floor((LUMA_QUANT[ZIGZAG[i]] * scale + 50) / 100), 1), 255);
+tables[64 + i] = Math.min(Math.max(Math.floor((CHROMA_QUANT[ZIGZAG[i]] * scale + 50) / 100), 1), 255);
+}
+return tables;
+}
+
+// RFC 2435 Appendix B: everything before the scan
+function makeHeaders(type, width, height, tables, restartInterval) {
+const parts = [Buffer.from([0xff, 0xd8])];
+// in-band tables may be 16-bit, one precision bit per table
+const precision = tables.precision || 0;
+let offset = 0;
+for (let id = 0; id < 2; id++) {
+const size = precision & (1 << id) ? 128 : 64;
+parts.push(segment(0xdb, Buffer.concat([Buffer.from([(size === 128 ? 0x10 : 0) | id]),
+tables.data.subarray(offset, offset + size)])));
+offset += size;
+}
+if (restartInterval) {
+parts.push(segment(0xdd, Buffer.from([restartInterval >> 8, restartInterval & 0xff])));
+}
+// type 0 is 4:2:2, type 1 is 4:2:0; the luma sampling says which
+parts.push(segment(0xc0, Buffer.from([8, height >> 8, height & 0xff, width >> 8, width & 0xff, 3,
+0, (type & 63) === 0 ? 0x21 : 0x22, 0,
+1, 0x11, 1,
+2, 0x11, 1])));
+parts.push(HUFFMAN_TABLES);
+parts.push(segment(0xda, Buffer.from([3, 0, 0x00, 1, 0x11, 2, 0x11, 0, 63, 0])));
+return Buffer.concat(parts);
+}
+
+// onFrame(jpeg, timestampMs, streamId, sequence) as for the framed transport: the RTP timestamp is capture.c's
+// monotonic clock at 90 kHz, and the sequence counts the frames rebuilt here
+function createRtpReceiver(port, onFrame, group) {
+const socket = dgram.createSocket({ type: 'udp4', recvBufferSize: RECV_BUFFER_SIZE, reuseAddr: Boolean(group) });
+// tables for Q 128-254 stay the same once sent; Q 255 sends them with every frame
+const cachedTables = new Map();
+let frame = null; // { timestamp, fragments: offset -> data, end, header }
+let sequence = 0;
+
+socket.on('message', (msg) => {
+if (msg.length < RTP_HEADER_SIZE + JPEG_HEADER_SIZE || msg[0] >> 6 !== 2 || (msg[1] & 0x7f) !== PAYLOAD_TYPE_JPEG) {
+return;
+}
+let p = RTP_HEADER_SIZE + (msg[0] & 0x0f) * 4;
+if (msg[0] & 0x10) {
+// header extension
+p += 4 + msg.readUInt16BE(p + 2) * 4;
+}
+const marker = msg[1] & 0x80;
+const timestamp = msg.readUInt32BE(4);
+if (p + JPEG_HEADER_SIZE > msg.length) {
+return;
+}
+const fragmentOffset = msg.readUIntBE(p + 1, 3);
+const type = msg[p + 4];
+const q = msg[p + 5];
+const width = msg[p + 6] * 8;
+const height = msg[p + 7] * 8;
+p += JPEG_HEADER_SIZE;
+let restartInterval = 0;
+if (type >= 64 && type < 128) {
+restartInterval = msg.readUInt16BE(p);
+p += RESTART_HEADER_SIZE;
+}
+if ((type & 63) > 1) {
+return; // only the types capture.c sends
+}
+
+if (!frame || frame.timestamp !== timestamp) {
+// a newer frame began: whatever was left of the last one is lost
+frame = { timestamp, fragments: new Map(), end: -1, received: 0, header: null };
+}
+if (fragmentOffset === 0) {
+let tables = null;
+if (q >= 128) {
+if (p + QTABLE_HEADER_SIZE <= msg.length && msg.readUInt16BE(p + 2) > 0) {
+const length = msg.readUInt16BE(p + 2);
+tables = { precision: msg[p + 1], data: Buffer.from(msg.subarray(p + QTABLE_HEADER_SIZE, p + QTABLE_HEADER_SIZE + length)) };
+if (q < 255) {
+cachedTables.set(q, tables);
+}
+} else {
+tables = cachedTables.get(q);
+}
+if (p + QTABLE_HEADER_SIZE <= msg.length) {
+p += QTABLE_HEADER_SIZE + msg.readUInt16BE(p + 2);
+}
+} else {
+tables = { precision: 0, data: scaledTables(q) };
+}
+if (!tables) {
+frame = null; // no tables yet for this Q
+return;
+}
+frame.header = makeHeaders(type, width, height, tables, restartInterval);
+}
+const data = msg.subarray(p);
+if (!frame.fragments.has(fragmentOffset)) {
+frame.fragments.set(fragmentOffset, Buffer.from(data));
+frame.received += data.length;
+}
+if (marker) {
+frame.end = fragmentOffset + data.length;
+}
+
+if (frame.header && frame.end >= 0 && frame.received === frame.end) {
+const offsets = [...frame.fragments.keys()].sort((a, b) => a - b);
+const scan = Buffer.concat(offsets.map((o) => frame.fragments.get(o)));
+const parts = [frame.header, scan];
+if (scan.length < 2 || scan[scan.length - 2] !== 0xff || scan[scan.length - 1] !== 0xd9) {
+parts.push(Buffer.from([0xff, 0xd9]));
+}
+const timestampMs = Math.floor(frame.timestamp / 90);
+frame = null;
+onFrame(Buffer.concat(parts), timestampMs, 0, sequence++);
+}
+});
+
+socket.bind(port, () => joinGroup(socket, group));
+return socket;
+}
+
+module.exports = { createRtpReceiver };
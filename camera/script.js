@@ -1,17 +1,518 @@
-const socket = io();
-socket.on("connect", (socket) => { //confirm connection with NodeJS server
-console.log("Connected");
+// newest sequence seen per camera
+const newest = {};
+// a sequence this far behind means capture.c or the relay restarted, not a late frame
+const SEQUENCE_RESTART = 1000;
+function isNewer(sequence, than) {
+    return than === undefined || sequence > than || than - sequence > SEQUENCE_RESTART;
+}
+// frames are decoded and drawn in renderWorker.js, off the main thread, where the browser can;
+// each camera has at most one frame there and keeps only the newest one waiting behind it. Either way a frame is drawn
+// on the next animation frame, so no more are decoded than the display shows, and none while the tab is hidden.
+const offscreen = typeof OffscreenCanvas !== "undefined" && typeof Worker !== "undefined";
+const worker = offscreen ? new Worker("renderWorker.js") : null;
+const streams = {}; // streamId -> { canvas, busy, done, next, decoding }
+
+function canvasFor(streamId) {
+    // the first camera draws on #videostream, every further one on a copy of it
+    let canvas = document.getElementById(streamId ? "videostream" + streamId : "videostream");
+    if (!canvas) {
+    const canvases = document.getElementsByTagName("canvas");
+    canvas = document.getElementById("videostream").cloneNode(false);
+    canvas.id = "videostream" + streamId;
+    canvas.hidden = false; // #videostream itself is hidden in fleet mode
+    canvases[canvases.length - 1].after(canvas);
+    }
+    if (!offscreen) {
+    return canvas.getContext('2d');
+    }
+    const target = canvas.transferControlToOffscreen();
+    worker.postMessage({ streamId, canvas: target }, [target]);
+    return null;
+}
+
+function drawn(streamId) {
+    const stream = streams[streamId];
+    stream.done(true);
+    // a hidden tab keeps the newest frame waiting, undecoded, until it's shown again
+    if (stream.next && !document.hidden) {
+    const next = stream.next;
+    stream.next = null;
+    render(streamId, next.data, next.done);
+    } else {
+    stream.busy = false;
+    }
+}
+
+function render(streamId, data, done) {
+    const stream = streams[streamId];
+    stream.busy = true;
+    stream.done = done;
+    if (worker) {
+    worker.postMessage({ streamId, data }, [data]);
+    return;
+    }
+    // the frame arrives as the JPEG's bytes, decoded straight from memory
+    createImageBitmap(new Blob([data], { type: "image/jpeg" })).then(function(image){
+    requestAnimationFrame(function() {
+    // scaled to the canvas, which for a thumbnail or a stepped-down --adapt frame isn't the frame's size
+    stream.canvas.drawImage(image, 0, 0, stream.canvas.canvas.width, stream.canvas.canvas.height);
+    image.close();
+    drawn(streamId);
+    });
+}, function(){
+    // a frame the browser can't decode is simply not drawn
+    drawn(streamId);
+});
+}
+
+function streamFor(streamId) {
+    if (!streams[streamId]) {
+    streams[streamId] = { canvas: canvasFor(streamId), busy: false, done: null, next: null, decoding: [] };
+    }
+    return streams[streamId];
+}
+
+if (worker) {
+    worker.onmessage = function(event) {
+    if (event.data.h264) {
+    // H.264 frames are answered in the order they were sent
+    streams[event.data.streamId].decoding.shift()(!event.data.hidden);
+    return;
+    }
+    drawn(event.data.streamId);
+    };
+}
+document.addEventListener("visibilitychange", function() {
+    if (worker) {
+    // H.264 still has to be decoded frame by frame, but needn't be drawn
+    worker.postMessage({ hidden: document.hidden });
+    }
+    if (document.hidden) {
+    return;
+    }
+    for (const streamId of Object.keys(streams)) {
+    const stream = streams[streamId];
+    if (!stream.busy && stream.next) {
+    const next = stream.next;
+    stream.next = null;
+    render(streamId, next.data, next.done);
+    }
+    }
 });
-    $( document ).ready(function() {
-    socket.on('canvas', function(data) {
-    const canvas = $("#videostream");
-    const context = canvas[0].getContext('2d');
-    const image = new Image();
-    image.src = "data:image/jpeg;base64,"+data;
-    image.onload = function(){
-    context.height = image.height;
-    context.width = image.width;
-    context.drawImage(image,0,0,context.width, context.height);
+// Feeder events, e.g. {event: "feed_start", mode: 0, ...}, come with the frames or on their own as 'feeder'
+const OVERLAY_MS = 3000;
+let overlayTimer = null;
+function overlayText(event) {
+    switch (event.event) {
+    case "wake": return "Listening...";
+    case "intent": return event.understood ? "Heard: " + event.intent : "Didn't catch that";
+    case "feed_start": return "Feeding (mode " + event.mode + ")";
+    case "feed_end": return "Fed";
+    case "mode": return "Mode " + event.mode;
+    default: return null;
+    }
 }
+function showFeederEvents(events) {
+    const overlay = document.getElementById("feederoverlay");
+    for (const event of events || []) {
+    const text = overlayText(event);
+    if (!text) {
+    continue;
+    }
+    overlay.textContent = text;
+    overlay.hidden = false;
+    clearTimeout(overlayTimer);
+    // a feed stays up until it ends
+    overlayTimer = event.event === "feed_start" ? null : setTimeout(function() { overlay.hidden = true; }, OVERLAY_MS);
+    if (event.event === "feed_end" || event.event === "mode") {
+    showFeederStatus();
+    }
+    }
+}
+// where each frame's time went, camera to screen, as the relay and this page measured it (see videoStats.js)
+const HOP_NAMES = ["camera", "board", "network", "assembly", "socket", "display"];
+let displayMs = null;
+function showLatency(timing) {
+    const overlay = document.getElementById("latency");
+    if (!timing) {
+    return;
+    }
+    // this viewer's own socket and display times, rather than every viewer's average
+    const hops = Object.assign({}, timing.hops);
+    if (typeof timing.socketMs === "number") {
+    hops.socket = timing.socketMs;
+    }
+    if (displayMs !== null) {
+    hops.display = Math.round(displayMs);
+    }
+    const parts = HOP_NAMES.filter(function(hop) { return hops[hop] !== undefined; })
+        .map(function(hop) { return hop + " " + hops[hop]; });
+    const drops = timing.drops || {};
+    overlay.textContent = parts.join(" + ") + " ms; dropped: " +
+        Object.keys(drops).map(function(place) { return place + " " + drops[place]; }).join(", ");
+    overlay.hidden = false;
+}
+// done(shown) for a frame that arrived now: the relay hears how long drawing took, or that it was dropped
+function acknowledger(ack) {
+    const received = performance.now();
+    return function(shown) {
+    if (shown) {
+    const drawMs = performance.now() - received;
+    displayMs = displayMs === null ? drawMs : displayMs + (drawMs - displayMs) / 16;
+    }
+    if (ack) {
+    ack({ drawMs: Math.round(performance.now() - received), dropped: !shown });
+    }
+    };
+}
+
+// the frames come over a WebSocket of their own (see frameSocket.js), and socket.io only carries the feeder's events
+// and subscriptions; ?socketio has socket.io carry the frames too, as it did before
+const rawFrames = typeof WebSocket !== "undefined" && !new URLSearchParams(location.search).has("socketio");
+
+// one connection to the relay, for the feeder's events, and for the frames without rawFrames
+let relay = null;
+function relaySocket() {
+    if (!relay) {
+    // WebSocket from the start: a relay running several workers (RELAY_WORKERS) can't follow a long-polling session
+    relay = io({ transports: ["websocket"], query: rawFrames ? { frames: "raw" } : {} });
+    relay.on("feeder", showFeederEvents);
+    }
+    return relay;
+}
+
+// a JPEG, shown unless a newer frame of its camera has come already; done is called once it is drawn or dropped
+function showFrame(data, streamId, sequence, done) {
+    if (!isNewer(sequence, newest[streamId])) {
+    done();
+    return; // a newer frame is already on its way to the canvas
+    }
+    newest[streamId] = sequence;
+    const stream = streamFor(streamId);
+    if (stream.busy || document.hidden) {
+    // still decoding or waiting to be drawn, or not shown at all: this frame waits, and any frame that was already
+    // waiting is dropped
+    if (stream.next) {
+    stream.next.done();
+    }
+    stream.next = { data, done };
+    return;
+    }
+    render(streamId, data, done);
+}
+
+// capture.c -F: every access unit goes to the worker's VideoDecoder, none can be skipped here
+function decodeFrame(data, streamId, timestampMs, done) {
+    if (!worker || typeof VideoDecoder === "undefined") {
+    done();
+    return; // this browser can only show the MJPEG stream
+    }
+    const stream = streamFor(streamId);
+    stream.decoding.push(done);
+    worker.postMessage({ streamId, data, timestampMs, h264: true }, [data]);
+}
+
+// the relay's socket.io stream, when WebRTC isn't set up
+function startSocketView() {
+    if (rawFrames) {
+    startFrameSocketView();
+    return;
+    }
+    const socket = relaySocket();
+    socket.on("connect", (socket) => { //confirm connection with NodeJS server
+    console.log("Connected");
+    });
+    socket.on('canvas', function(data, streamId, sequence, timestampMs, timing, events, ack) {
+    showFeederEvents(events);
+    showLatency(timing);
+    // the server sends more once this frame is done with, drawn or not
+    showFrame(data, streamId, sequence, acknowledger(ack));
 });
+    socket.on('h264', function(data, streamId, sequence, timestampMs, timing, events, ack) {
+    showFeederEvents(events);
+    showLatency(timing);
+    decodeFrame(data, streamId, timestampMs, acknowledger(ack));
 });
+}
+
+// The frame socket: each binary message a frame behind a FRAME_HEADER_BYTES header, and now and then a text message
+// with the timing. It is opened again whenever socket.io connects, with socket.io's id, which the relay goes by to
+// send it the channels subscribed to over socket.io.
+const FRAME_HEADER_BYTES = 16;
+const FRAME_KIND_H264 = 1;
+const ACK_TYPE = 1;
+const FRAME_SOCKET_RETRY_MS = 2000;
+const streamIdDecoder = typeof TextDecoder !== "undefined" ? new TextDecoder() : null;
+let frameSocket = null;
+// the relay sends more once a frame is acknowledged, with the ack id it came with
+function frameAck(socket, ackId) {
+    return function(report) {
+    if (socket.readyState !== WebSocket.OPEN) {
+    return;
+    }
+    const ack = new DataView(new ArrayBuffer(6));
+    ack.setUint8(0, ACK_TYPE);
+    ack.setUint8(1, report.dropped ? 1 : 0);
+    ack.setUint16(2, ackId);
+    ack.setUint16(4, Math.min(report.drawMs, 0xffff));
+    socket.send(ack.buffer);
+    };
+}
+function openFrameSocket(id) {
+    if (frameSocket) {
+    frameSocket.onclose = null;
+    frameSocket.close();
+    }
+    const socket = new WebSocket((location.protocol === "https:" ? "wss://" : "ws://") + location.host + "/frames?id=" +
+        encodeURIComponent(id));
+    socket.binaryType = "arraybuffer";
+    socket.onmessage = function(event) {
+    if (typeof event.data === "string") {
+    showLatency(JSON.parse(event.data));
+    return;
+    }
+    const header = new DataView(event.data, 0, FRAME_HEADER_BYTES);
+    const idLength = header.getUint8(1);
+    const sequence = header.getUint32(4);
+    const timestampMs = header.getFloat64(8);
+    const idBytes = new Uint8Array(event.data, FRAME_HEADER_BYTES, idLength);
+    let streamId = streamIdDecoder ? streamIdDecoder.decode(idBytes) : String.fromCharCode.apply(null, idBytes);
+    // a camera of this board is a number, as it is over socket.io; a fleet channel is "board/stream"
+    if (/^\d+$/.test(streamId)) {
+    streamId = Number(streamId);
+    }
+    // a buffer of its own, to hand over to the render worker
+    const data = event.data.slice(FRAME_HEADER_BYTES + idLength);
+    const done = acknowledger(frameAck(socket, header.getUint16(2)));
+    if (header.getUint8(0) === FRAME_KIND_H264) {
+    decodeFrame(data, streamId, timestampMs, done);
+    } else {
+    showFrame(data, streamId, sequence, done);
+    }
+    };
+    socket.onclose = function() {
+    frameSocket = null;
+    // a frame socket dropped on its own; one dropped with socket.io is opened again when socket.io reconnects
+    setTimeout(function() {
+    if (!frameSocket && relay.connected) {
+    openFrameSocket(relay.id);
+    }
+    }, FRAME_SOCKET_RETRY_MS);
+    };
+    frameSocket = socket;
+}
+function startFrameSocketView() {
+    const socket = relaySocket();
+    socket.on("connect", function() {
+    openFrameSocket(socket.id);
+    });
+    if (socket.connected) {
+    openFrameSocket(socket.id);
+    }
+}
+
+// STREAM_MODE=webrtc: the camera's H.264 comes straight from the gateway, see whepRelay.js
+const ICE_GATHERING_MS = 1000;
+function startWebRtcView() {
+    if (typeof RTCPeerConnection === "undefined") {
+    return Promise.reject(new Error("no WebRTC"));
+    }
+    const peer = new RTCPeerConnection();
+    peer.addTransceiver("video", { direction: "recvonly" });
+    peer.ontrack = function(event) {
+    const video = document.getElementById("webrtcstream");
+    video.srcObject = new MediaStream([event.track]);
+    video.hidden = false;
+    for (const canvas of document.getElementsByTagName("canvas")) {
+    canvas.hidden = true;
+    }
+    };
+    return peer.createOffer().then(function(offer) {
+    return peer.setLocalDescription(offer);
+    }).then(function() {
+    // the offer goes out whole, with whatever candidates turned up by then
+    return new Promise(function(resolve) {
+    if (peer.iceGatheringState === "complete") {
+    resolve();
+    return;
+    }
+    peer.onicegatheringstatechange = function() {
+    if (peer.iceGatheringState === "complete") {
+    resolve();
+    }
+    };
+    setTimeout(resolve, ICE_GATHERING_MS);
+    });
+    }).then(function() {
+    return fetch("/whep", { method: "POST", headers: { "Content-Type": "application/sdp" }, body: peer.localDescription.sdp });
+    }).then(function(response) {
+    if (!response.ok) {
+    throw new Error("WHEP " + response.status);
+    }
+    return response.text();
+    }).then(function(answer) {
+    return peer.setRemoteDescription({ type: "answer", sdp: answer });
+    }).catch(function(err) {
+    peer.close();
+    throw err;
+    });
+}
+
+// ?mjpeg: the relay's /stream.mjpg in an <img>, which the browser decodes by itself, for a tablet too slow for the canvas
+function startMjpegView() {
+    const img = document.getElementById("mjpegstream");
+    img.src = "/stream.mjpg";
+    img.hidden = false;
+    document.getElementById("videostream").hidden = true;
+}
+
+// the feeder's mode, last feed and temperatures, from its control socket through the relay
+const STATUS_INTERVAL_MS = 5000;
+function showFeederStatus() {
+    const line = document.getElementById("feederstatus");
+    fetch("/feeder/status").then(function(response) {
+    return response.ok ? response.json() : Promise.reject(new Error("status " + response.status));
+    }).then(function(status) {
+    const lastFeed = status.last_feed ? new Date(status.last_feed * 1000).toLocaleTimeString() : "not yet";
+    const water = status.water_c !== null && status.water_c !== undefined ? ", water " + status.water_c + " \u00b0C" : "";
+    const air = status.air_c !== null && status.air_c !== undefined ? ", air " + status.air_c + " \u00b0C" : "";
+    line.textContent = "Feeder: mode " + status.mode + (status.feeding ? ", feeding" : "") + ", last fed " + lastFeed +
+        water + air + (status.audio_ok ? "" : ", microphone down");
+    }, function() {
+    line.textContent = "Feeder: not reachable";
+    });
+}
+function startFeederControls() {
+    const button = document.getElementById("feednow");
+    button.onclick = function() {
+    button.disabled = true;
+    // mode 0, a feed right away; the daemon's feed limit still applies
+    fetch("/feeder/feed", { method: "POST", headers: { "Content-Type": "application/x-www-form-urlencoded" }, body: "mode=0" })
+    .then(function(response) {
+    if (!response.ok) {
+    document.getElementById("feederstatus").textContent = "Feeder: feed refused (" + response.status + ")";
+    }
+    }, function() {}).then(function() {
+    button.disabled = false;
+    });
+    };
+    showFeederStatus();
+    setInterval(showFeederStatus, STATUS_INTERVAL_MS);
+}
+
+// FLEET=1: a grid of tiles, one per board's camera, each with its thumbnail (capture.c --thumbnails) and a checkbox
+// that focuses it. The relay sends a viewer only the channels it subscribes to (see viewerHub.js), so a tile scrolled
+// out of sight asks for nothing, one in sight for its thumbnail, and a focused one for its camera's full frames in
+// place of the thumbnail; a page of many tanks costs the relay and the boards no more than the few on screen.
+const FLEET_INTERVAL_MS = 10000;
+// capture.c's 720x720 at 1/8 scale
+const THUMBNAIL_SIZE = 90;
+// a tile this close to the edge of the grid is subscribed already, so its picture is there once it scrolls in
+const TILE_MARGIN = "100px";
+// channel -> its tile, kept across refreshes since a canvas handed to the render worker can't be made again
+const tiles = {};
+// channels whose tiles are in sight; every tile is without IntersectionObserver
+const visibleChannels = new Set();
+const tileObserver = typeof IntersectionObserver !== "undefined" ? new IntersectionObserver(function(entries) {
+    for (const entry of entries) {
+    if (entry.isIntersecting) {
+    visibleChannels.add(entry.target.dataset.channel);
+    } else {
+    visibleChannels.delete(entry.target.dataset.channel);
+    }
+    }
+    subscribe();
+}, { rootMargin: TILE_MARGIN }) : null;
+// what the relay was last asked for, so scrolling within the grid doesn't send the same list again
+let subscribed = null;
+function focusedChannels() {
+    const boxes = document.querySelectorAll("#fleet input:checked");
+    return Array.prototype.map.call(boxes, function(box) { return box.value; });
+}
+function subscribe() {
+    const channels = focusedChannels();
+    const thumbnails = [];
+    for (const tile of document.querySelectorAll("#fleet label")) {
+    const channel = tile.dataset.channel;
+    if (!channels.includes(channel) && (!tileObserver || visibleChannels.has(channel))) {
+    thumbnails.push(tile.dataset.thumbnail);
+    }
+    }
+    const list = channels.concat(thumbnails);
+    if (subscribed !== list.join(" ")) {
+    subscribed = list.join(" ");
+    relaySocket().emit("subscribe", list);
+    }
+    // a channel's canvas stays once made, hidden while it isn't focused
+    for (const canvas of document.querySelectorAll("canvas[id^='videostream']:not(.thumbnail)")) {
+    if (canvas.id !== "videostream") {
+    canvas.hidden = !channels.includes(canvas.id.slice("videostream".length));
+    }
+    }
+}
+function tileFor(channel, thumbnail) {
+    if (!tiles[channel]) {
+    const label = document.createElement("label");
+    label.dataset.channel = channel;
+    label.dataset.thumbnail = thumbnail;
+    const canvas = document.createElement("canvas");
+    // streamFor() finds it by its id, as it does the full-size ones
+    canvas.id = "videostream" + thumbnail;
+    canvas.className = "thumbnail";
+    canvas.width = THUMBNAIL_SIZE;
+    canvas.height = THUMBNAIL_SIZE;
+    const box = document.createElement("input");
+    box.type = "checkbox";
+    box.value = channel;
+    box.onchange = subscribe;
+    label.append(canvas, box, " " + channel + " ");
+    tiles[channel] = label;
+    if (tileObserver) {
+    tileObserver.observe(label);
+    }
+    }
+    return tiles[channel];
+}
+function showFleet(boards) {
+    const list = document.getElementById("fleet");
+    list.textContent = "";
+    for (const board of boards) {
+    board.channels.forEach(function(channel, i) {
+    list.append(tileFor(channel, board.thumbnails[i]));
+    });
+    }
+    if (!boards.length) {
+    list.textContent = "No boards registered";
+    }
+    // a tank whose board went away is no longer asked for
+    subscribe();
+}
+function refreshFleet() {
+    return fetch("/fleet").then(function(response) {
+    return response.ok ? response.json() : Promise.reject(new Error("fleet " + response.status));
+    }).then(showFleet);
+}
+function startFleetView() {
+    refreshFleet().then(function() {
+    document.getElementById("videostream").hidden = true;
+    document.getElementById("fleet").hidden = false;
+    // the relay forgets a viewer's channels when it reconnects
+    relaySocket().on("connect", function() {
+    subscribed = null;
+    subscribe();
+    });
+    setInterval(function() { refreshFleet().catch(function() {}); }, FLEET_INTERVAL_MS);
+    }, function() {
+    // not a fleet gateway
+    });
+}
+
+// the script is loaded after the page's elements
+relaySocket();
+startFeederControls();
+startFleetView();
+if (new URLSearchParams(location.search).has("mjpeg")) {
+    startMjpegView();
+} else {
+    startWebRtcView().catch(startSocketView);
+}
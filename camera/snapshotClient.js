@@ -0,0 +1,28 @@
+// Fetches the newest frame from capture.c --snapshot: connecting to its Unix socket
+// returns that frame's JPEG bytes, then end of file. Nothing is decoded or re-encoded.
+const net = require('net');
+
+const SNAPSHOT_PATH = '/tmp/fishfeeder-snapshot.sock';
+const SNAPSHOT_TIMEOUT_MS = 2000;
+
+function fetchSnapshot(callback, path = SNAPSHOT_PATH) {
+const socket = net.createConnection(path);
+const chunks = [];
+let done = false;
+function finish(err) {
+if (done) {
+return;
+}
+done = true;
+socket.destroy();
+const jpeg = Buffer.concat(chunks);
+// capture hangs up without sending anything until it has a frame
+callback(err || (jpeg.length ? null : new Error('no frame yet')), jpeg);
+}
+socket.setTimeout(SNAPSHOT_TIMEOUT_MS, () => finish(new Error('snapshot timed out')));
+socket.on('data', (data) => chunks.push(data));
+socket.on('end', () => finish(null));
+socket.on('error', finish);
+}
+
+module.exports = { fetchSnapshot, SNAPSHOT_PATH };
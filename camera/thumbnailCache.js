@@ -0,0 +1,47 @@
+// /thumb: one camera's picture for a dashboard that polls every tank. The picture is the newest of capture.c
+// --thumbnails' 1/8 scale JPEGs of that camera, already made small on the board, or the camera's own frame when it
+// sends none; the relay decodes nothing. It is taken from the hub at most once every THUMB_INTERVAL_MS per camera, and
+// until then every poll gets the same bytes from memory and the same ETag, which a dashboard that already has the
+// picture sends back to get a 304 and no body. The cache holds THUMB_MAX_ENTRIES cameras; the one polled least
+// recently goes first.
+const { THUMBNAIL_STREAM_BASE } = require('./frameReceiver.js');
+
+const THUMB_INTERVAL_MS = 2000;
+const THUMB_MAX_ENTRIES = 64;
+
+// camera 1's thumbnails are stream 257, board b's "b/257"
+function thumbnailStream(streamId) {
+const parts = String(streamId).split('/');
+parts.push(String(THUMBNAIL_STREAM_BASE + Number(parts.pop())));
+return parts.join('/');
+}
+
+// poll(streamId) as viewerHub.js has it; the returned function gives { jpeg, etag } of streamId, or null while there
+// is no picture of it yet
+function createThumbnailCache(poll) {
+const entries = new Map(); // streamId as a string -> { jpeg, etag, takenAt }, least recently polled first
+return function thumbnail(streamId) {
+const key = String(streamId);
+const now = Date.now();
+let entry = entries.get(key);
+entries.delete(key); // back in at the end
+if (!entry || now - entry.takenAt >= THUMB_INTERVAL_MS) {
+const newest = poll(thumbnailStream(key)) || poll(key);
+if (newest) {
+entry = { jpeg: newest.frame, etag: `"${newest.receivedAt.toString(36)}-${newest.sequence}"`, takenAt: now };
+} else if (entry) {
+entry.takenAt = now;
+}
+}
+if (!entry) {
+return null;
+}
+entries.set(key, entry);
+if (entries.size > THUMB_MAX_ENTRIES) {
+entries.delete(entries.keys().next().value);
+}
+return entry;
+};
+}
+
+module.exports = { createThumbnailCache };
@@ -0,0 +1,107 @@
+// Where a frame's time goes between the camera and the screen, hop by hop, and where frames are lost on the way:
+//   camera    in the driver's queue until capture.c read it
+//   board     capture.c, from reading the frame until sending it
+//   network   transit above the link's lowest lately, the queueing a congested link adds (see frameReceiver.js)
+//   assembly  from a frame's first datagram to its last, FEC included
+//   socket    relay to browser: half the acknowledgement's round trip, less the browser's own time
+//   display   the browser's decode and draw
+// Frames are lost on the board (gaps in the driver's sequence the frame ids don't account for: camera drops, the
+// motion gate, --latest skipping), on the network (gaps in the frame ids), at the relay (a congested viewer's frame
+// replaced by a newer one) and in the browser (replaced while it was still drawing another). Camera stalls that
+// capture.c recovered from, by restarting or reopening the device, are counted too.
+//
+// Served at /metrics for Prometheus, and sent with every frame for the page's overlay.
+const HOPS = ['camera', 'board', 'network', 'assembly', 'socket', 'display'];
+const DROP_PLACES = ['board', 'network', 'relay', 'browser'];
+// the overlay's figures follow about the last 16 frames
+const SMOOTHING = 1 / 16;
+// a gap this big is capture.c or the camera restarting, not frames lost
+const MAX_GAP = 1000;
+
+function createVideoStats() {
+const hops = new Map(HOPS.map((hop) => [hop, { sum: 0, count: 0, recent: null }]));
+const drops = new Map(DROP_PLACES.map((place) => [place, 0]));
+const streams = new Map(); // streamId -> { sequence, captureSequence, captureStalls } of its last frame
+let stalls = 0;
+
+function record(hop, ms) {
+const stats = hops.get(hop);
+stats.sum += ms;
+stats.count++;
+stats.recent = stats.recent === null ? ms : stats.recent + (ms - stats.recent) * SMOOTHING;
+}
+
+function drop(place, count = 1) {
+drops.set(place, drops.get(place) + count);
+}
+
+// timing as frameReceiver.js gives it; the RTP receiver has none
+function frame(streamId, sequence, timing) {
+if (!timing) {
+return;
+}
+record('camera', timing.queueMs);
+record('board', timing.boardMs);
+record('network', timing.networkMs);
+record('assembly', timing.assemblyMs);
+const last = streams.get(streamId);
+if (last) {
+const sent = (sequence - last.sequence) >>> 0;
+const captured = (timing.captureSequence - last.captureSequence) >>> 0;
+if (sent > 0 && sent < MAX_GAP && captured >= sent && captured < MAX_GAP) {
+drop('network', sent - 1);
+drop('board', captured - sent);
+}
+}
+// capture.c's count only goes back to 0 when it restarts
+const captureStalls = timing.captureStalls || 0;
+const lastStalls = last ? last.captureStalls : 0;
+stalls += captureStalls >= lastStalls ? captureStalls - lastStalls : captureStalls;
+streams.set(streamId, { sequence, captureSequence: timing.captureSequence, captureStalls });
+}
+
+// what the browser said when it acknowledged a frame sent roundTripMs ago
+function acknowledged(roundTripMs, { drawMs = 0, dropped = false } = {}) {
+if (dropped) {
+drop('browser');
+return null;
+}
+const socketMs = Math.max(0, (roundTripMs - drawMs) / 2);
+record('socket', socketMs);
+record('display', drawMs);
+return socketMs;
+}
+
+// { hops: { camera: ms, ... }, drops: { board: n, ... } }, for the overlay
+function recent() {
+const recentHops = {};
+for (const [hop, stats] of hops) {
+if (stats.recent !== null) {
+recentHops[hop] = Math.round(stats.recent);
+}
+}
+return { hops: recentHops, drops: Object.fromEntries(drops) };
+}
+
+function metrics() {
+let out = '# HELP video_hop_latency_milliseconds Time frames spent in each hop from camera to screen.\n';
+out += '# TYPE video_hop_latency_milliseconds summary\n';
+for (const [hop, stats] of hops) {
+out += `video_hop_latency_milliseconds_sum{hop="${hop}"} ${stats.sum}\n`;
+out += `video_hop_latency_milliseconds_count{hop="${hop}"} ${stats.count}\n`;
+}
+out += '# HELP video_frames_dropped_total Frames lost, by where.\n';
+out += '# TYPE video_frames_dropped_total counter\n';
+for (const [place, count] of drops) {
+out += `video_frames_dropped_total{where="${place}"} ${count}\n`;
+}
+out += '# HELP video_capture_stalls_total Times a camera stalled or failed and capture.c restarted it.\n';
+out += '# TYPE video_capture_stalls_total counter\n';
+out += `video_capture_stalls_total ${stalls}\n`;
+return out;
+}
+
+return { frame, drop, acknowledged, recent, metrics };
+}
+
+module.exports = { createVideoStats };
@@ -0,0 +1,195 @@
+/*
+ * Rolling MJPEG archive, see video_archive.h.
+ *
+ * The writer is the capture loop alone. A reader (archiveReader.js) may look
+ * at the index at any time, so a record is filled in before head moves past
+ * it, and first moves past a segment's records before its file is written
+ * over.
+ */
+#define _GNU_SOURCE             /* fallocate() */
+#include "video_archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Returns -1 if the path doesn't fit, rather than open a file by a cut-off name. */
+static int segment_path(const struct video_archive *a, uint64_t segment, char *path, size_t length)
+{
+        int n = snprintf(path, length, "%s/seg-%03u.mjpg", a->dir, (unsigned int)(segment % a->index->segments));
+
+        return n < 0 || (size_t)n >= length ? -1 : 0;
+}
+
+/* Claims the whole file now, so a full disk shows at startup and never mid-stream. */
+static int preallocate(const char *path)
+{
+        int fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+        if (-1 == fd || (-1 == fallocate(fd, 0, 0, ARCHIVE_SEGMENT_BYTES) &&
+                         (EOPNOTSUPP != errno ||
+                          0 != (errno = posix_fallocate(fd, 0, ARCHIVE_SEGMENT_BYTES))))) {
+                fprintf(stderr, "Cannot preallocate '%s': %d, %s\n", path, errno, strerror(errno));
+                if (-1 != fd)
+                        close(fd);
+                return -1;
+        }
+        close(fd);
+        return 0;
+}
+
+static int start_segment(struct video_archive *a, uint64_t segment)
+{
+        struct archive_index_header *h = a->index;
+        char path[PATH_MAX];
+
+        /* the frames about to be written over are gone from the index first */
+        while (h->first < h->head && a->records[h->first % h->capacity].segment + h->segments <= segment)
+                __atomic_store_n(&h->first, h->first + 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&h->segment, segment, __ATOMIC_RELEASE);
+
+        if (-1 != a->fd)
+                close(a->fd);
+        a->fd = -1 == segment_path(a, segment, path, sizeof(path)) ? -1 : open(path, O_WRONLY | O_CLOEXEC);
+        a->offset = 0;
+        if (-1 == a->fd) {
+                fprintf(stderr, "Cannot open '%s', archive stopped: %d, %s\n", path, errno, strerror(errno));
+                return -1;
+        }
+        return 0;
+}
+
+static int pwrite_all(int fd, const unsigned char *p, uint32_t size, off_t offset)
+{
+        while (size > 0) {
+                ssize_t n = pwrite(fd, p, size, offset);
+
+                if (-1 == n) {
+                        if (EINTR == errno)
+                                continue;
+                        return -1;
+                }
+                p += n;
+                size -= n;
+                offset += n;
+        }
+        return 0;
+}
+
+int video_archive_open(struct video_archive *a, const char *dir, unsigned int segments,
+                       unsigned int capacity)
+{
+        char path[PATH_MAX];
+        struct archive_index_header *h;
+        unsigned int i;
+        int fd, resumed;
+
+        memset(a, 0, sizeof(*a));
+        a->fd = -1;
+        /* every path in the archive is dir and a name no longer than the last segment's */
+        if (strlen(dir) + sizeof("/seg-4294967295.mjpg") > sizeof(a->dir)) {
+                fprintf(stderr, "Archive directory '%s' is too long\n", dir);
+                return -1;
+        }
+        snprintf(a->dir, sizeof(a->dir), "%s", dir);
+        if (-1 == mkdir(dir, 0755) && EEXIST != errno) {
+                fprintf(stderr, "Cannot create '%s': %d, %s\n", dir, errno, strerror(errno));
+                return -1;
+        }
+
+        snprintf(path, sizeof(path), "%s/index", dir);
+        a->index_bytes = sizeof(struct archive_index_header) + (size_t)capacity * sizeof(struct archive_record);
+        fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (-1 == fd || -1 == ftruncate(fd, a->index_bytes)) {
+                fprintf(stderr, "Cannot create '%s': %d, %s\n", path, errno, strerror(errno));
+                if (-1 != fd)
+                        close(fd);
+                return -1;
+        }
+        h = mmap(NULL, a->index_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (MAP_FAILED == h) {
+                fprintf(stderr, "Cannot map '%s': %d, %s\n", path, errno, strerror(errno));
+                return -1;
+        }
+        a->index = h;
+        a->records = (struct archive_record *)(h + 1);
+
+        resumed = ARCHIVE_MAGIC == h->magic && ARCHIVE_VERSION == h->version &&
+                  sizeof(struct archive_record) == h->record_size && capacity == h->capacity &&
+                  segments == h->segments && ARCHIVE_SEGMENT_BYTES == h->segment_bytes &&
+                  h->first <= h->head;
+        if (!resumed) {
+                /* a reader sees no records until the header is whole again */
+                h->head = 0;
+                h->first = 0;
+                h->segment = 0;
+                h->magic = ARCHIVE_MAGIC;
+                h->version = ARCHIVE_VERSION;
+                h->record_size = sizeof(struct archive_record);
+                h->capacity = capacity;
+                h->segments = segments;
+                h->segment_bytes = ARCHIVE_SEGMENT_BYTES;
+        }
+        for (i = 0; i < segments; i++) {
+                if (-1 == segment_path(a, i, path, sizeof(path)) || -1 == preallocate(path)) {
+                        video_archive_close(a);
+                        return -1;
+                }
+        }
+        /* a restart goes on in a fresh segment, after whatever the last one holds */
+        if (-1 == start_segment(a, resumed ? h->segment + 1 : 0)) {
+                video_archive_close(a);
+                return -1;
+        }
+        if (resumed)
+                fprintf(stderr, "Archive in %s carries on after %llu frames\n", dir,
+                        (unsigned long long)(h->head - h->first));
+        return 0;
+}
+
+void video_archive_add(struct video_archive *a, const void *jpeg, uint32_t size, int64_t time_ms)
+{
+        struct archive_index_header *h = a->index;
+        struct archive_record *r;
+
+        if (-1 == a->fd || size > h->segment_bytes)
+                return;
+        if (a->offset + size > h->segment_bytes && -1 == start_segment(a, h->segment + 1))
+                return;
+        if (-1 == pwrite_all(a->fd, jpeg, size, a->offset)) {
+                fprintf(stderr, "Cannot write to the archive in %s, archive stopped: %d, %s\n", a->dir,
+                        errno, strerror(errno));
+                close(a->fd);
+                a->fd = -1;
+                return;
+        }
+
+        /* a full index loses its oldest record to the new one */
+        if (h->head - h->first == h->capacity)
+                __atomic_store_n(&h->first, h->first + 1, __ATOMIC_RELEASE);
+        if (h->head > h->first && time_ms < a->records[(h->head - 1) % h->capacity].time_ms)
+                time_ms = a->records[(h->head - 1) % h->capacity].time_ms;
+        r = &a->records[h->head % h->capacity];
+        r->time_ms = time_ms;
+        r->segment = h->segment;
+        r->offset = a->offset;
+        r->size = size;
+        __atomic_store_n(&h->head, h->head + 1, __ATOMIC_RELEASE);
+        a->offset += size;
+}
+
+void video_archive_close(struct video_archive *a)
+{
+        if (-1 != a->fd)
+                close(a->fd);
+        a->fd = -1;
+        if (a->index)
+                munmap(a->index, a->index_bytes);
+        a->index = NULL;
+        a->records = NULL;
+}
@@ -0,0 +1,70 @@
+/*
+ * Rolling archive of a stream's MJPEG frames, to scroll back through the
+ * last days (archiveReader.js serves it). Frames go back to back, as they
+ * are, into fixed-size segment files that are preallocated when the archive
+ * opens and then reused in a ring, so the disk space is claimed once and
+ * dropping old footage is just writing over it. An index file, mapped into
+ * memory, holds a record per frame in a ring of its own: its wall-clock
+ * time, segment and offset. The records are in time order, so any time is
+ * found by binary search, and starting a segment retires the records of the
+ * one it replaces by moving the oldest valid record along, which costs the
+ * same however much is kept.
+ */
+#ifndef VIDEO_ARCHIVE_H
+#define VIDEO_ARCHIVE_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARCHIVE_SEGMENT_BYTES (64u << 20)
+#define ARCHIVE_MAGIC 0x43524146        /* "FARC" */
+#define ARCHIVE_VERSION 1
+
+/*
+ * The start of the index file, followed by capacity records. Little-endian,
+ * as the board is; archiveReader.js reads the same layout.
+ */
+struct archive_index_header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t capacity;
+        uint32_t segments;
+        uint32_t segment_bytes;
+        uint64_t head;          /* records ever written; record n is in slot n % capacity */
+        uint64_t first;         /* the oldest record whose frame is still on disk */
+        uint64_t segment;       /* segments started before the one being written */
+        uint8_t reserved[16];
+};
+
+struct archive_record {
+        int64_t time_ms;        /* CLOCK_REALTIME, never earlier than the record before */
+        uint64_t segment;       /* counted as in the header; the file is segment % segments */
+        uint32_t offset;
+        uint32_t size;
+};
+
+struct video_archive {
+        char dir[PATH_MAX];
+        int fd;                 /* the segment being written, -1 once writing has failed */
+        uint32_t offset;        /* where the next frame goes in it */
+        struct archive_index_header *index;
+        struct archive_record *records;
+        size_t index_bytes;
+};
+
+/*
+ * Creates dir's archive, or carries on with the one there if it has the same
+ * shape: segments files of ARCHIVE_SEGMENT_BYTES, and an index of capacity
+ * frames. Returns -1, having said why, if the files can't be made.
+ */
+int video_archive_open(struct video_archive *a, const char *dir, unsigned int segments,
+                       unsigned int capacity);
+
+/* Appends a frame. A write error stops the archive, which says so once. */
+void video_archive_add(struct video_archive *a, const void *jpeg, uint32_t size, int64_t time_ms);
+
+void video_archive_close(struct video_archive *a);
+
+#endif
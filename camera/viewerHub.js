@@ -0,0 +1,446 @@
+// Shares one ingest among every viewer. The receiver (a UDP socket for either stream mode) is started when the first
+// viewer connects and closed once the last one leaves. Each frame is emitted as the JPEG's own bytes, which socket.io
+// sends as a binary attachment instead of a base64 string a third larger.
+//
+// Every viewer paces itself: the browser acknowledges a frame once it is drawn, and a viewer with MAX_IN_FLIGHT frames
+// unacknowledged gets nothing more until it catches up. Meanwhile only the newest frame of each camera is kept for it,
+// so a slow phone link sees a lower frame rate of current pictures, never a growing queue, and the other viewers
+// are not held back.
+//
+// capture.c -F sends H.264 access units instead, over the same transports. Those go out as 'h264' and can't be skipped
+// freely, since every frame up to the next IDR depends on the ones before: a congested viewer loses frames until the
+// next IDR picture instead.
+//
+// Feeder events (feederClient.js) ride along with the frames: each viewer's events since its last frame go out as one
+// more argument of the next one, so the page's overlays update with the picture and nothing polls. A viewer that gets
+// no frame soon after an event, paused or watching over WebRTC, gets them on their own as 'feeder'.
+//
+// Each frame also carries its timing so far (videoStats.js) and the viewer's own socket delay, and the browser's
+// acknowledgement says how long it took to draw, or that it was dropped; together they are the page's latency overlay
+// and /metrics.
+//
+// With subscriptions on (the fleet gateway, where streamIds are "board/stream" channels), a viewer gets nothing until it
+// sends 'subscribe' with the channels it has open, and then only those. A camera's thumbnail stream (capture.c
+// --thumbnails) is a channel of its own, so a page of many tanks can take every thumbnail and the full frames of one;
+// without subscriptions, thumbnails go to no one.
+//
+// The newest JPEG of each camera is kept, and a viewer gets it the moment it connects (or subscribes), so the page shows
+// a picture one round trip after loading instead of after the next frame, or after capture.c --on-demand has started
+// the camera again. The frame is the receiver's own Buffer, never written again, so every viewer shares it. The ingest
+// also lingers a little after the last viewer leaves, so a reload finds the picture current.
+//
+// A viewer can also be a plain HTTP response (streamMjpeg): multipart/x-mixed-replace, one JPEG per part, which an <img>
+// shows with no script at all. It watches one camera and is paced by its own socket instead of acknowledgements: while
+// a part hasn't drained, only the newest frame is kept for it.
+//
+// Or it polls (poll, for /thumb): asking for a camera's newest JPEG makes it a viewer of that camera for
+// POLL_VIEWER_MS, so a dashboard polling every few seconds keeps the ingest running, and a board's capture.c
+// --on-demand streaming.
+//
+// A page can also take its frames over a plain WebSocket of their own (acceptFrames, see frameSocket.js), each one a
+// binary message of a small header and the frame's bytes, and keep socket.io for the rest: it connects to socket.io
+// with ?frames=raw, which makes that socket a listener that is sent the feeder's events and takes 'subscribe', and then
+// opens the frame socket with ?id= its socket.io id. The frame socket is the viewer, paced by acknowledgements as
+// above; the timing goes to it as a text message every TIMING_INTERVAL_MS rather than with every frame. The two are
+// linked by the id only for subscriptions, so with RELAY_WORKERS, where they may reach different workers and there are
+// none, neither needs the other.
+const { createVideoStats } = require('./videoStats.js');
+const { THUMBNAIL_STREAM_BASE } = require('./frameReceiver.js');
+const { frameHeader, parseAck, FRAME_KIND_JPEG, FRAME_KIND_H264 } = require('./frameSocket.js');
+
+const MAX_IN_FLIGHT = 2;
+const MJPEG_BOUNDARY = 'fishfeederframe';
+// older than this, the newest frame is too stale to show anyone
+const LATEST_MAX_AGE_MS = 60000;
+const INGEST_LINGER_MS = 10000;
+const EVENT_FLUSH_MS = 250;
+const POLL_VIEWER_MS = 15000;
+// an acknowledgement lost to a reconnect must not stall the viewer for good
+const ACK_TIMEOUT_MS = 2000;
+const TIMING_INTERVAL_MS = 1000;
+
+const NAL_SLICE = 1;
+const NAL_IDR = 5;
+
+// Annex-B starts with a start code; a JPEG with FF D8
+function isH264(frame) {
+return frame.length > 4 && frame[0] === 0 && frame[1] === 0 && (frame[2] === 1 || (frame[2] === 0 && frame[3] === 1));
+}
+
+// an access unit's parameter sets come before its slices, so only the first slice needs finding
+function isKeyFrame(frame) {
+for (let i = 0; i + 3 < frame.length; i++) {
+if (frame[i] === 0 && frame[i + 1] === 0 && frame[i + 2] === 1) {
+const type = frame[i + 3] & 0x1f;
+if (type >= NAL_SLICE && type <= NAL_IDR) {
+return type === NAL_IDR;
+}
+i += 2;
+}
+}
+return false;
+}
+
+// 256 or "board/256" and up
+function isThumbnail(streamId) {
+return Number(String(streamId).split('/').pop()) >= THUMBNAIL_STREAM_BASE;
+}
+
+// startIngest(onFrame) starts a receiver and returns something with close(); onViewers(count) hears every change,
+// subscriptions included
+function createViewerHub(io, startIngest, onViewers = () => {}, { subscriptions = false } = {}) {
+let ingest = null;
+const viewers = new Set(); // { socket, inFlight, pending: streamId -> emit arguments, decoding: streamIds sent every frame since an IDR, events, eventTimer, channels: null for all, socketMs, frames: the frame socket, if it is one }
+const listeners = new Map(); // socket.io id -> { socket, events, eventTimer, channels } of the pages that take their frames over a frame socket
+const frameViewers = new Map(); // socket.io id -> the frame socket viewer of the same page
+const mjpegViewers = new Set(); // { res, streamId: as a string, writing, next: the newest frame waiting }
+const latest = new Map(); // streamId -> { args, receivedAt } of its newest JPEG
+const polled = new Map(); // streamId as a string -> the timer that ends its poll
+let lingerTimer = null;
+const stats = createVideoStats();
+
+// the ingest runs while anyone watches, either way, and a while after
+function joined() {
+clearTimeout(lingerTimer);
+lingerTimer = null;
+if (!ingest) {
+ingest = startIngest(emitFrame);
+}
+onViewers(viewerCount());
+}
+
+function viewerCount() {
+return viewers.size + mjpegViewers.size + polled.size;
+}
+
+function left() {
+if (viewerCount() === 0) {
+lingerTimer = setTimeout(() => {
+lingerTimer = null;
+ingest.close();
+ingest = null;
+}, INGEST_LINGER_MS);
+}
+onViewers(viewerCount());
+}
+
+// the newest frame of each camera this viewer watches, of streamIds if given, while it is still fresh enough
+function sendLatest(viewer, streamIds) {
+const now = Date.now();
+for (const [streamId, { args, receivedAt }] of latest) {
+if (now - receivedAt < LATEST_MAX_AGE_MS && wants(viewer, streamId) && (!streamIds || streamIds.has(streamId)) &&
+viewer.inFlight < MAX_IN_FLIGHT) {
+send(viewer, args);
+}
+}
+}
+
+function wants(viewer, streamId) {
+return viewer.channels ? viewer.channels.has(streamId) : !isThumbnail(streamId);
+}
+
+function takeEvents(viewer) {
+const events = viewer.events;
+viewer.events = [];
+clearTimeout(viewer.eventTimer);
+viewer.eventTimer = null;
+return events;
+}
+
+// args are [frame, streamId, sequence, timestampMs]
+function send(viewer, args, event = 'canvas') {
+const sentAt = Date.now();
+viewer.inFlight++;
+const acknowledged = (err, report) => {
+if (!err) {
+const socketMs = stats.acknowledged(Date.now() - sentAt, report);
+if (socketMs !== null) {
+viewer.socketMs = Math.round(socketMs);
+}
+}
+viewer.inFlight--;
+for (const [streamId, newest] of viewer.pending) {
+if (viewer.inFlight >= MAX_IN_FLIGHT) {
+break;
+}
+viewer.pending.delete(streamId);
+send(viewer, newest);
+}
+};
+if (viewer.frames) {
+sendFrame(viewer, args, event, acknowledged);
+return;
+}
+const timing = { ...stats.recent(), socketMs: viewer.socketMs };
+viewer.socket.timeout(ACK_TIMEOUT_MS).emit(event, ...args, timing, takeEvents(viewer), acknowledged);
+}
+
+// over a frame socket: the header, the streamId and the frame's own bytes in one message
+function sendFrame(viewer, [frame, streamId, sequence, timestampMs], event, acknowledged) {
+const now = Date.now();
+if (now - viewer.timingSentAt >= TIMING_INTERVAL_MS) {
+viewer.timingSentAt = now;
+viewer.frames.sendText(JSON.stringify({ ...stats.recent(), socketMs: viewer.socketMs }));
+}
+const ackId = viewer.nextAck;
+viewer.nextAck = (ackId + 1) & 0xffff;
+const timer = setTimeout(() => {
+viewer.acks.delete(ackId);
+acknowledged(new Error('timeout'));
+}, ACK_TIMEOUT_MS);
+viewer.acks.set(ackId, { acknowledged, timer });
+const id = Buffer.from(String(streamId));
+const kind = (event === 'h264') ? FRAME_KIND_H264 : FRAME_KIND_JPEG;
+viewer.frames.send([frameHeader(kind, id.length, ackId, sequence, timestampMs), id, frame]);
+}
+
+function emitFrame(frame, timestampMs, streamId = 0, sequence = 0, timing = null) {
+// streamId tells the cameras apart when capture.c is given several devices; every message is one whole JPEG, and its
+// sequence and capture timestamp let the browser skip a frame that arrives after a newer one
+const args = [frame, streamId, sequence, timestampMs];
+stats.frame(streamId, sequence, timing);
+if (isH264(frame)) {
+emitH264(args, isKeyFrame(frame));
+return;
+}
+latest.set(streamId, { args, receivedAt: Date.now() });
+for (const viewer of mjpegViewers) {
+if (viewer.streamId !== String(streamId)) {
+continue;
+}
+if (viewer.writing) {
+if (viewer.next) {
+stats.drop('relay');
+}
+viewer.next = frame;
+} else {
+writePart(viewer, frame);
+}
+}
+for (const viewer of viewers) {
+if (!wants(viewer, streamId)) {
+continue;
+}
+if (viewer.inFlight < MAX_IN_FLIGHT) {
+send(viewer, args);
+} else {
+if (viewer.pending.has(streamId)) {
+stats.drop('relay');
+}
+viewer.pending.set(streamId, args); // replaces whatever older frame was waiting
+}
+}
+}
+
+function emitH264(args, key) {
+const streamId = args[1];
+for (const viewer of viewers) {
+if (!wants(viewer, streamId) || (!key && !viewer.decoding.has(streamId))) {
+continue;
+}
+if (viewer.inFlight < MAX_IN_FLIGHT) {
+viewer.decoding.add(streamId);
+send(viewer, args, 'h264');
+} else {
+viewer.decoding.delete(streamId); // what follows can't be decoded without this frame
+stats.drop('relay');
+}
+}
+}
+
+// each part ends with the next boundary, so a browser shows a frame as soon as it is in rather than at the next one
+function writePart(viewer, frame) {
+viewer.res.write(`Content-Type: image/jpeg\r\nContent-Length: ${frame.length}\r\n\r\n`);
+viewer.res.write(frame);
+if (!viewer.res.write(`\r\n--${MJPEG_BOUNDARY}\r\n`)) {
+viewer.writing = true;
+}
+}
+
+// GET /stream.mjpg: streamId is the camera, e.g. 0, or "board/0" with subscriptions
+function streamMjpeg(req, res, streamId) {
+res.writeHead(200, {
+'Content-Type': `multipart/x-mixed-replace; boundary=${MJPEG_BOUNDARY}`,
+'Cache-Control': 'no-store',
+});
+res.write(`--${MJPEG_BOUNDARY}\r\n`);
+const viewer = { res, streamId: String(streamId), writing: false, next: null };
+res.on('drain', () => {
+viewer.writing = false;
+if (viewer.next) {
+const frame = viewer.next;
+viewer.next = null;
+writePart(viewer, frame);
+}
+});
+res.on('close', () => {
+mjpegViewers.delete(viewer);
+left();
+});
+mjpegViewers.add(viewer);
+joined();
+for (const [id, { args, receivedAt }] of latest) {
+if (String(id) === viewer.streamId && Date.now() - receivedAt < LATEST_MAX_AGE_MS) {
+writePart(viewer, args[0]);
+}
+}
+}
+
+// { frame, sequence, receivedAt } of streamId's newest JPEG while it is fresh, otherwise null; either way the caller
+// watches streamId for the next POLL_VIEWER_MS
+function poll(streamId) {
+const key = String(streamId);
+const watching = polled.has(key);
+clearTimeout(polled.get(key));
+polled.set(key, setTimeout(() => {
+polled.delete(key);
+left();
+}, POLL_VIEWER_MS));
+if (!watching) {
+joined();
+}
+for (const [id, { args, receivedAt }] of latest) {
+if (String(id) === key && Date.now() - receivedAt < LATEST_MAX_AGE_MS) {
+return { frame: args[0], sequence: args[2], receivedAt };
+}
+}
+return null;
+}
+
+function publish(event) {
+for (const viewer of [...viewers, ...listeners.values()]) {
+if (viewer.frames) {
+continue; // its page hears them as a listener
+}
+viewer.events.push(event);
+if (!viewer.eventTimer) {
+viewer.eventTimer = setTimeout(() => viewer.socket.emit('feeder', takeEvents(viewer)), EVENT_FLUSH_MS);
+}
+}
+}
+
+// a viewer's channels from now on, with the newest frame of each one it hadn't subscribed to yet
+function subscribe(viewer, channels) {
+const opened = new Set([...channels].filter((channel) => !viewer.channels.has(channel)));
+viewer.channels = new Set(channels);
+sendLatest(viewer, opened);
+for (const streamId of viewer.pending.keys()) {
+if (!viewer.channels.has(streamId)) {
+viewer.pending.delete(streamId);
+}
+}
+}
+
+// a socket.io client whose frames come over a frame socket
+function listen(socket) {
+const listener = { socket, events: [], eventTimer: null, channels: new Set() };
+listeners.set(socket.id, listener);
+if (subscriptions) {
+socket.on('subscribe', (channels) => {
+if (!Array.isArray(channels)) {
+return;
+}
+listener.channels = new Set(channels.map(String));
+const viewer = frameViewers.get(socket.id);
+if (viewer) {
+subscribe(viewer, listener.channels);
+onViewers(viewerCount());
+}
+});
+}
+socket.on('disconnect', () => {
+clearTimeout(listener.eventTimer);
+listeners.delete(socket.id);
+});
+}
+
+io.on('connection', (socket) => {
+console.log('a user connected');
+if (socket.handshake.query.frames === 'raw') {
+listen(socket);
+return;
+}
+// a new viewer starts decoding at the next IDR picture
+const viewer = { socket, inFlight: 0, pending: new Map(), decoding: new Set(), events: [], eventTimer: null,
+channels: subscriptions ? new Set() : null, socketMs: null, frames: null };
+viewers.add(viewer);
+joined();
+sendLatest(viewer, null);
+if (subscriptions) {
+socket.on('subscribe', (channels) => {
+if (!Array.isArray(channels)) {
+return;
+}
+subscribe(viewer, channels.map(String));
+onViewers(viewerCount());
+});
+}
+socket.on('disconnect', () => {
+clearTimeout(viewer.eventTimer);
+viewers.delete(viewer);
+left();
+});
+});
+
+// a frame socket (frameSocket.js) opened with ?id= the socket.io id of its page's listener
+function acceptFrames(frames, params) {
+const id = params.get('id') || '';
+const viewer = { socket: null, inFlight: 0, pending: new Map(), decoding: new Set(), events: [], eventTimer: null,
+channels: subscriptions ? new Set() : null, socketMs: null, frames, acks: new Map(), nextAck: 0, timingSentAt: 0 };
+frames.onmessage = (message) => {
+const ack = parseAck(message);
+const waiting = ack && viewer.acks.get(ack.ackId);
+if (waiting) {
+clearTimeout(waiting.timer);
+viewer.acks.delete(ack.ackId);
+waiting.acknowledged(null, ack.report);
+}
+};
+frames.onclose = () => {
+for (const { timer } of viewer.acks.values()) {
+clearTimeout(timer);
+}
+viewer.acks.clear();
+if (frameViewers.get(id) === viewer) {
+frameViewers.delete(id);
+}
+viewers.delete(viewer);
+left();
+};
+if (id) {
+frameViewers.set(id, viewer);
+}
+viewers.add(viewer);
+joined();
+// a page that subscribed before its frame socket was open
+const listener = listeners.get(id);
+if (subscriptions && listener) {
+subscribe(viewer, listener.channels);
+onViewers(viewerCount());
+} else {
+sendLatest(viewer, null);
+}
+}
+// channel -> viewers subscribed to it; empty without subscriptions
+function channelViewers() {
+const counts = new Map();
+for (const viewer of viewers) {
+for (const channel of viewer.channels || []) {
+counts.set(channel, (counts.get(channel) || 0) + 1);
+}
+}
+if (subscriptions) {
+for (const viewer of mjpegViewers) {
+counts.set(viewer.streamId, (counts.get(viewer.streamId) || 0) + 1);
+}
+for (const streamId of polled.keys()) {
+counts.set(streamId, (counts.get(streamId) || 0) + 1);
+}
+}
+return counts;
+}
+
+return { publish, channelViewers, streamMjpeg, poll, acceptFrames, videoMetrics: stats.metrics };
+}
+
+module.exports = { createViewerHub };
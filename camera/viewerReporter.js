@@ -0,0 +1,45 @@
+// Tells capture.c --on-demand how many viewers there are, so it can stop the camera while there are none. The count
+// goes to the port capture.c sends its frames from, on every change and every few seconds besides, so a capture.c
+// started after the relay learns it too.
+const dgram = require('dgram');
+
+const REPORT_INTERVAL_MS = 5000;
+
+function createViewerReporter(host, port) {
+const socket = dgram.createSocket('udp4');
+let viewers = 0;
+function report() {
+socket.send(`viewers ${viewers}\n`, port, host);
+}
+// capture.c not running yet is not an error
+socket.on('error', () => {});
+socket.unref();
+setInterval(report, REPORT_INTERVAL_MS).unref();
+report();
+return (count) => {
+viewers = count;
+report();
+};
+}
+
+// capture.c --adapt's feedback: how the stream is arriving, once a second from the frame receiver, to the same port
+function createLinkReporter(host, port) {
+const socket = dgram.createSocket('udp4');
+socket.on('error', () => {});
+socket.unref();
+return ({ lossPermille, jitterMs, kbps }) => {
+socket.send(`link ${lossPermille} ${jitterMs} ${kbps}\n`, port, host);
+};
+}
+
+// picks one of capture.c --profiles' camera control profiles by name, to the same port
+function createProfileSender(host, port) {
+const socket = dgram.createSocket('udp4');
+socket.on('error', () => {});
+socket.unref();
+return (name) => {
+socket.send(`profile ${name}\n`, port, host);
+};
+}
+
+module.exports = { createViewerReporter, createLinkReporter, createProfileSender };
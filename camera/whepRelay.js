@@ -0,0 +1,35 @@
+// WebRTC viewing (STREAM_MODE=webrtc): capture.c -F --rtp sends RTP/H.264, described by capture.sdp, to a WebRTC
+// gateway that speaks WHEP (mediamtx, or Janus behind a WHEP front end). The gateway does ICE, DTLS-SRTP and congestion
+// control, and forwards the camera's packets without transcoding; this only passes the browser's SDP offer through,
+// so the page needs no address but ours.
+const http = require('http');
+const https = require('https');
+
+const WHEP_TIMEOUT_MS = 5000;
+
+// callback(err, status, answer): answer is the gateway's SDP
+function relayWhepOffer(whepUrl, offer, callback) {
+const url = new URL(whepUrl);
+let done = false;
+function finish(err, status, answer) {
+if (!done) {
+done = true;
+callback(err, status, answer);
+}
+}
+const req = (url.protocol === 'https:' ? https : http).request(url, {
+method: 'POST',
+headers: { 'Content-Type': 'application/sdp', 'Content-Length': Buffer.byteLength(offer) },
+timeout: WHEP_TIMEOUT_MS,
+}, (res) => {
+const chunks = [];
+res.on('data', (data) => chunks.push(data));
+res.on('end', () => finish(null, res.statusCode, Buffer.concat(chunks).toString()));
+res.on('error', finish);
+});
+req.on('timeout', () => req.destroy(new Error('WHEP gateway timed out')));
+req.on('error', finish);
+req.end(offer);
+}
+
+module.exports = { relayWhepOffer };
@@ -0,0 +1,33 @@
+#include "actuator_gate.h"
+
+#include "feeder_probe.h"
+#include "latency_trace.h"
+
+static bool isBusy = false;
+// when the flag was last set and cleared; each written before the flag, so a reader that sees the flag sees them too
+static long long beginUs = 0;
+static long long idleUs = 0;
+
+void actuatorGate_begin(void)
+{
+    __atomic_store_n(&beginUs, latencyTrace_nowUs(), __ATOMIC_RELAXED);
+    __atomic_store_n(&isBusy, true, __ATOMIC_RELEASE);
+    FEEDER_PROBE0(actuator_begin);
+}
+
+void actuatorGate_end(void)
+{
+    __atomic_store_n(&idleUs, latencyTrace_nowUs(), __ATOMIC_RELAXED);
+    __atomic_store_n(&isBusy, false, __ATOMIC_RELEASE);
+    FEEDER_PROBE0(actuator_end);
+}
+
+bool actuatorGate_isBusy(long long startUs, long long endUs)
+{
+    if (__atomic_load_n(&isBusy, __ATOMIC_ACQUIRE)) {
+        // a frame queued before the motion started is still clean
+        return endUs >= __atomic_load_n(&beginUs, __ATOMIC_RELAXED);
+    }
+    const long long idle = __atomic_load_n(&idleUs, __ATOMIC_RELAXED);
+    return idle != 0 && startUs <= idle + (long long) ACTUATOR_GATE_SETTLE_MS * 1000;
+}
@@ -0,0 +1,21 @@
+#ifndef ACTUATOR_GATE_H
+#define ACTUATOR_GATE_H
+
+#include <stdbool.h>
+
+// Busy windows of the feeder's own actuators, so the inference stage can skip frames that hold nothing but the servo
+// and the hopper. The actuator publishes the start and end of its motion with an atomic flag from its own thread; the
+// inference stage asks whether a frame was captured during a window. Neither side ever waits. A window stays busy for
+// ACTUATOR_GATE_SETTLE_MS after the motion ends, while the last of the food is still falling.
+
+#define ACTUATOR_GATE_SETTLE_MS 300
+
+// Safe from any thread, for one actuator at a time.
+void actuatorGate_begin(void);
+void actuatorGate_end(void);
+
+// Whether any of a frame captured between startUs and endUs, on CLOCK_MONOTONIC, fell in a busy window. Safe from any
+// thread.
+bool actuatorGate_isBusy(long long startUs, long long endUs);
+
+#endif
@@ -0,0 +1,234 @@
+#include "adc_stream.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+// scans the kernel buffer holds, and scans taken per read
+#define BUFFER_LENGTH 1024
+#define READ_SCANS 256
+
+typedef struct {
+    int channel;
+    adcStream_samplesFunc samplesFunc;
+    void* userData;
+    // from in_voltageK_type, e.g. "le:u12/16>>0"
+    int bits;
+    int shift;
+} streamChannel;
+
+static int openDevice = -1;
+static char devicePath[96];
+static int deviceFd = -1;
+// in scan order, which is channel order
+static streamChannel channels[ADC_STREAM_MAX_CHANNELS];
+static int channelCount = 0;
+static int holders = 0;
+
+static bool writeAttribute(const char* name, const char* value)
+{
+    char path[160];
+    const int pathLength = snprintf(path, sizeof(path), "%s/%s", devicePath, name);
+    // a cut-off path would write some other attribute
+    if (pathLength < 0 || pathLength >= (int) sizeof(path)) {
+        return false;
+    }
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const size_t length = strlen(value);
+    bool ok = write(fd, value, length) == (ssize_t) length;
+    close(fd);
+    return ok;
+}
+
+// Leaves every channel out of the scan, so it holds only the ones added.
+static void clearScan(void)
+{
+    char path[160];
+    snprintf(path, sizeof(path), "%s/scan_elements", devicePath);
+    DIR* elements = opendir(path);
+    if (elements == NULL) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(elements)) != NULL) {
+        const size_t length = strlen(entry->d_name);
+        if (length > 3 && strcmp(entry->d_name + length - 3, "_en") == 0) {
+            snprintf(path, sizeof(path), "scan_elements/%s", entry->d_name);
+            writeAttribute(path, "0");
+        }
+    }
+    closedir(elements);
+}
+
+static void readFormat(streamChannel* channel)
+{
+    char path[160];
+    char type[32] = "";
+    channel->bits = 12;
+    channel->shift = 0;
+    snprintf(path, sizeof(path), "%s/scan_elements/in_voltage%d_type", devicePath, channel->channel);
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return;
+    }
+    char sign;
+    int storageBits;
+    if (fgets(type, sizeof(type), file) == NULL ||
+        sscanf(type, "le:%c%d/%d>>%d", &sign, &channel->bits, &storageBits, &channel->shift) != 4 ||
+        storageBits != 16) {
+        printf("ADC: Unexpected sample format '%s', reading as 12 bits.\n", type);
+        channel->bits = 12;
+        channel->shift = 0;
+    }
+    fclose(file);
+}
+
+static void drain(void)
+{
+    uint16_t discard[READ_SCANS];
+    while (read(deviceFd, discard, sizeof(discard)) > 0) {}
+}
+
+static void setRunning(bool isRunning)
+{
+    if (!writeAttribute("buffer/enable", isRunning ? "1" : "0")) {
+        asyncLog_log(ASYNC_LOG_ERROR, "ADC: Unable to %s the buffer: %s", isRunning ? "start" : "stop",
+                     strerror(errno));
+    }
+    if (!isRunning) {
+        // what the ADC queued after the last holder was done
+        drain();
+    }
+}
+
+static void onReadable(int fd, void* userData)
+{
+    (void) userData;
+    static uint16_t scans[READ_SCANS * ADC_STREAM_MAX_CHANNELS];
+    static uint16_t samples[READ_SCANS];
+    ssize_t length;
+    while (holders > 0 && channelCount > 0 &&
+           (length = read(fd, scans, (size_t) READ_SCANS * channelCount * sizeof(uint16_t))) > 0) {
+        const int scanCount = (int) (length / (ssize_t) (channelCount * sizeof(uint16_t)));
+        for (int c = 0; c < channelCount; c++) {
+            const streamChannel* channel = &channels[c];
+            const uint16_t mask = (uint16_t) ((1u << channel->bits) - 1);
+            for (int i = 0; i < scanCount; i++) {
+                samples[i] = (scans[i * channelCount + c] >> channel->shift) & mask;
+            }
+            channel->samplesFunc(samples, scanCount, channel->userData);
+        }
+    }
+}
+
+bool adcStream_open(int device)
+{
+    if (openDevice >= 0) {
+        return openDevice == device;
+    }
+    snprintf(devicePath, sizeof(devicePath), ADC_STREAM_IIO_PATH "/iio:device%d", device);
+    char length[16];
+    snprintf(length, sizeof(length), "%d", BUFFER_LENGTH);
+    // a run that was stopped while sampling leaves the buffer on, and the scan can't change while it is
+    writeAttribute("buffer/enable", "0");
+    clearScan();
+    if (!writeAttribute("buffer/length", length)) {
+        perror("ADC: Unable to set up the buffer.");
+        printf(" device: %s\n", devicePath);
+        return false;
+    }
+
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/iio:device%d", device);
+    deviceFd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (deviceFd < 0) {
+        perror("ADC: Unable to open the device.");
+        printf(" device: %s\n", path);
+        return false;
+    }
+    if (!eventLoop_add(deviceFd, EPOLLIN, onReadable, NULL)) {
+        close(deviceFd);
+        deviceFd = -1;
+        return false;
+    }
+    eventLoop_setSubsystem(deviceFd, "sensors");
+    openDevice = device;
+    channelCount = 0;
+    holders = 0;
+    return true;
+}
+
+bool adcStream_addChannel(int channel, adcStream_samplesFunc onSamples, void* userData)
+{
+    if (openDevice < 0 || channelCount == ADC_STREAM_MAX_CHANNELS) {
+        return false;
+    }
+    int at = 0;
+    while (at < channelCount && channels[at].channel < channel) {
+        at++;
+    }
+    if (at < channelCount && channels[at].channel == channel) {
+        return false;
+    }
+
+    char name[40];
+    snprintf(name, sizeof(name), "scan_elements/in_voltage%d_en", channel);
+    if (holders > 0) {
+        setRunning(false);
+    }
+    const bool ok = writeAttribute(name, "1");
+    if (ok) {
+        memmove(&channels[at + 1], &channels[at], (size_t) (channelCount - at) * sizeof(streamChannel));
+        channels[at].channel = channel;
+        channels[at].samplesFunc = onSamples;
+        channels[at].userData = userData;
+        readFormat(&channels[at]);
+        channelCount++;
+    } else {
+        perror("ADC: Unable to add the channel to the scan.");
+        printf(" device: %s, channel: %d\n", devicePath, channel);
+    }
+    if (holders > 0) {
+        setRunning(true);
+    }
+    return ok;
+}
+
+void adcStream_acquire(void)
+{
+    if (openDevice >= 0 && holders++ == 0) {
+        setRunning(true);
+    }
+}
+
+void adcStream_release(void)
+{
+    if (openDevice >= 0 && holders > 0 && --holders == 0) {
+        setRunning(false);
+    }
+}
+
+void adcStream_close(void)
+{
+    if (deviceFd >= 0) {
+        eventLoop_remove(deviceFd);
+        if (holders > 0) {
+            writeAttribute("buffer/enable", "0");
+        }
+        close(deviceFd);
+        deviceFd = -1;
+    }
+    openDevice = -1;
+    channelCount = 0;
+    holders = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The AM335x ADC's IIO buffer, shared by the sensors on its channels. Samples are read from the character device,
+// /dev/iio:deviceN, in blocks on the event loop, which has to be initialised, and handed to each channel's function
+// already split out of the scan and scaled to the raw reading. The buffer only runs while some sensor holds it, so the
+// ADC isn't streaming when nobody is listening.
+
+#define ADC_STREAM_IIO_PATH "/sys/bus/iio/devices"
+#define ADC_STREAM_MAX_CHANNELS 8
+
+// On the event loop thread, with every block read while the buffer runs.
+typedef void (*adcStream_samplesFunc)(const uint16_t* samples, int count, void* userData);
+
+// Opens iio:deviceN. Another device while one is open is an error.
+bool adcStream_open(int device);
+
+// Adds in_voltageK to the scan; onSamples gets its samples from then on. Returns false if the channel is taken.
+bool adcStream_addChannel(int channel, adcStream_samplesFunc onSamples, void* userData);
+
+// The buffer runs from the first acquire to the matching last release.
+void adcStream_acquire(void);
+void adcStream_release(void);
+
+void adcStream_close(void);
+
+#endif
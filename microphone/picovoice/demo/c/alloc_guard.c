@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+
+#include "alloc_guard.h"
+
+#include <stdio.h>
+
+#if defined(PICOVOICE_ALLOC_GUARD)
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// glibc's allocator behind its public names; free needs no wrapper, since these hand out the same chunks
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* pointer, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+
+typedef int (*pthreadCreateFunc)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*);
+
+typedef struct {
+    const char* name;
+    long long allocations;
+    long long threadStarts;
+    // where the first counted call came from
+    void* firstCaller;
+} hotThread;
+
+static hotThread hotThreads[ALLOC_GUARD_MAX_THREADS];
+static int hotThreadCount = 0;
+static bool isArmed = false;
+static bool isTrapping = false;
+// thread starts while armed from threads that aren't hot, which only break the steady state rather than a deadline
+static long long otherThreadStarts = 0;
+
+// NULL unless the calling thread is hot
+static __thread hotThread* current = NULL;
+static __thread bool isExempt = false;
+
+static bool isWatched(void)
+{
+    return current != NULL && !isExempt && __atomic_load_n(&isArmed, __ATOMIC_RELAXED);
+}
+
+static void caught(long long* counter, void* caller)
+{
+    __atomic_add_fetch(counter, 1, __ATOMIC_RELAXED);
+    void* none = NULL;
+    __atomic_compare_exchange_n(&current->firstCaller, &none, caller, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&isTrapping, __ATOMIC_RELAXED)) {
+        raise(SIGTRAP);
+    }
+}
+
+void* malloc(size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size)
+{
+    if (isWatched()) {
+        caught(&current->allocations, __builtin_return_address(0));
+    }
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* allocated = __libc_memalign(alignment, size);
+    if (allocated == NULL) {
+        return ENOMEM;
+    }
+    *pointer = allocated;
+    return 0;
+}
+
+int pthread_create(pthread_t* thread, const pthread_attr_t* attributes, void* (*start)(void*), void* arg)
+{
+    static pthreadCreateFunc create = NULL;
+    if (__atomic_load_n(&create, __ATOMIC_ACQUIRE) == NULL) {
+        __atomic_store_n(&create, (pthreadCreateFunc) dlsym(RTLD_NEXT, "pthread_create"), __ATOMIC_RELEASE);
+    }
+    if (isWatched()) {
+        caught(&current->threadStarts, __builtin_return_address(0));
+    } else if (!isExempt && __atomic_load_n(&isArmed, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&otherThreadStarts, 1, __ATOMIC_RELAXED);
+    }
+    return create(thread, attributes, start, arg);
+}
+
+bool allocGuard_isBuiltIn(void)
+{
+    return true;
+}
+
+void allocGuard_markHot(const char* name)
+{
+    if (current != NULL && current->name == name) {
+        return;
+    }
+    const int index = __atomic_fetch_add(&hotThreadCount, 1, __ATOMIC_RELAXED);
+    if (index >= ALLOC_GUARD_MAX_THREADS) {
+        return;
+    }
+    hotThreads[index].name = name;
+    current = &hotThreads[index];
+}
+
+void allocGuard_exempt(bool exempt)
+{
+    isExempt = exempt;
+}
+
+void allocGuard_arm(bool trapping)
+{
+    __atomic_store_n(&isTrapping, trapping, __ATOMIC_RELAXED);
+    __atomic_store_n(&isArmed, true, __ATOMIC_RELEASE);
+}
+
+void allocGuard_disarm(void)
+{
+    __atomic_store_n(&isArmed, false, __ATOMIC_RELEASE);
+}
+
+void allocGuard_report(void)
+{
+    int count = __atomic_load_n(&hotThreadCount, __ATOMIC_RELAXED);
+    if (count > ALLOC_GUARD_MAX_THREADS) {
+        count = ALLOC_GUARD_MAX_THREADS;
+    }
+    long long allocations = 0;
+    long long threadStarts = __atomic_load_n(&otherThreadStarts, __ATOMIC_RELAXED);
+    for (int i = 0; i < count; i++) {
+        allocations += __atomic_load_n(&hotThreads[i].allocations, __ATOMIC_RELAXED);
+        threadStarts += __atomic_load_n(&hotThreads[i].threadStarts, __ATOMIC_RELAXED);
+    }
+    printf("alloc guard : %lld allocations on %d hot threads, %lld threads started while listening\n", allocations,
+            count, threadStarts);
+    for (int i = 0; i < count; i++) {
+        const hotThread* thread = &hotThreads[i];
+        if (thread->allocations == 0 && thread->threadStarts == 0) {
+            continue;
+        }
+        // a symbol if the caller's is exported, else an offset into its file for addr2line
+        Dl_info info = {0};
+        const char* where = "?";
+        uintptr_t base = 0;
+        if (dladdr(thread->firstCaller, &info) != 0) {
+            where = info.dli_sname != NULL ? info.dli_sname : info.dli_fname;
+            base = (uintptr_t) (info.dli_sname != NULL ? info.dli_saddr : info.dli_fbase);
+        }
+        printf("    %-10s : %lld allocations, %lld thread starts, first from %s+0x%lx\n", thread->name,
+                thread->allocations, thread->threadStarts, where,
+                (unsigned long) ((uintptr_t) thread->firstCaller - base));
+    }
+}
+
+#else
+
+bool allocGuard_isBuiltIn(void)
+{
+    return false;
+}
+
+void allocGuard_markHot(const char* name)
+{
+    (void) name;
+}
+
+void allocGuard_exempt(bool isExempt)
+{
+    (void) isExempt;
+}
+
+void allocGuard_arm(bool isTrapping)
+{
+    (void) isTrapping;
+}
+
+void allocGuard_disarm(void)
+{
+}
+
+void allocGuard_report(void)
+{
+}
+
+#endif
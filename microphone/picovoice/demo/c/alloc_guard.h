@@ -0,0 +1,30 @@
+#ifndef ALLOC_GUARD_H
+#define ALLOC_GUARD_H
+
+#include <stdbool.h>
+
+// Checks that the audio path stays off the heap and starts no threads once it is listening. Built with
+// -DPICOVOICE_ALLOC_GUARD=ON, the demo replaces malloc, calloc, realloc, the aligned allocators and pthread_create
+// with versions that count calls made from threads marked hot, the engines' own included; otherwise every function
+// here does nothing. Trapping raises SIGTRAP at the offending call, so a debugger stops on it.
+
+#define ALLOC_GUARD_MAX_THREADS 16
+
+// False unless built with the guard.
+bool allocGuard_isBuiltIn(void);
+
+// Marks the calling thread as one that must not allocate; cheap enough to call for every frame.
+void allocGuard_markHot(const char* name);
+
+// Lets the calling hot thread allocate until called again with false, around work off the audio path such as a reload.
+void allocGuard_exempt(bool isExempt);
+
+// From here on, allocations and thread starts on hot threads are counted, and trapped if isTrapping.
+void allocGuard_arm(bool isTrapping);
+
+void allocGuard_disarm(void);
+
+// Prints what was counted while armed.
+void allocGuard_report(void);
+
+#endif
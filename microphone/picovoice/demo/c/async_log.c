@@ -0,0 +1,581 @@
+#include "async_log.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "memory_budget.h"
+#include "thread_cpu.h"
+
+// a power of two
+#define RING_LENGTH 256
+#define LINE_LENGTH 1024
+#define BATCH_LENGTH 8192
+// how long the log thread sleeps once the ring is empty; callers never wake it, so a call stays a copy
+#define IDLE_SLEEP_MS 20
+
+typedef union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+} logArg;
+
+typedef struct {
+    // Vyukov's bounded queue: equal to the enqueue position when free, one past it once filled
+    unsigned int sequence;
+    unsigned char level;
+    unsigned char argCount;
+    long long timeUs;
+    const char* format;
+    logArg args[ASYNC_LOG_MAX_ARGS];
+    // %s arguments back to back, each NUL-terminated; their args hold the offsets
+    char strings[ASYNC_LOG_MAX_STRING_BYTES];
+} logRecord;
+
+typedef enum {
+    LENGTH_NONE = 0,
+    LENGTH_HH,
+    LENGTH_H,
+    LENGTH_L,
+    LENGTH_LL,
+    LENGTH_Z,
+    LENGTH_J,
+    LENGTH_T,
+    LENGTH_LONG_DOUBLE
+} lengthModifier;
+
+// One conversion of a format string, from its '%' to its conversion character.
+typedef struct {
+    const char* start;
+    char flags[8];
+    bool hasStarWidth;
+    bool hasStarPrecision;
+    const char* width;
+    int widthLength;
+    const char* precision;
+    int precisionLength;
+    bool hasPrecision;
+    lengthModifier length;
+    char conversion;
+} conversionSpec;
+
+static const char* const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+static logRecord* ring = NULL;
+static unsigned int enqueuePosition = 0;
+// log thread only
+static unsigned int dequeuePosition = 0;
+
+static asyncLog_sink logSink = ASYNC_LOG_SINK_STDOUT;
+static int minimumLevel = ASYNC_LOG_DEBUG;
+static int fileFd = -1;
+
+static pthread_t threadLog;
+static bool isRunning = false;
+static bool stopping = false;
+
+static asyncLog_stats counters;
+
+static long long wallTimeUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static const char* parseDigits(const char* p, const char** start, int* length)
+{
+    *start = p;
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    *length = (int) (p - *start);
+    return p;
+}
+
+// p points at a '%'; returns the conversion character, or the terminating NUL of a truncated spec.
+static const char* parseSpec(const char* p, conversionSpec* spec)
+{
+    memset(spec, 0, sizeof(*spec));
+    spec->start = p++;
+    int flagCount = 0;
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        if (flagCount < (int) sizeof(spec->flags) - 1) {
+            spec->flags[flagCount++] = *p;
+        }
+        p++;
+    }
+    if (*p == '*') {
+        spec->hasStarWidth = true;
+        p++;
+    } else {
+        p = parseDigits(p, &spec->width, &spec->widthLength);
+    }
+    if (*p == '.') {
+        spec->hasPrecision = true;
+        p++;
+        if (*p == '*') {
+            spec->hasStarPrecision = true;
+            p++;
+        } else {
+            p = parseDigits(p, &spec->precision, &spec->precisionLength);
+        }
+    }
+    if (p[0] == 'h' && p[1] == 'h') {
+        spec->length = LENGTH_HH;
+        p += 2;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        spec->length = LENGTH_LL;
+        p += 2;
+    } else if (*p == 'h') {
+        spec->length = LENGTH_H;
+        p++;
+    } else if (*p == 'l') {
+        spec->length = LENGTH_L;
+        p++;
+    } else if (*p == 'z') {
+        spec->length = LENGTH_Z;
+        p++;
+    } else if (*p == 'j') {
+        spec->length = LENGTH_J;
+        p++;
+    } else if (*p == 't') {
+        spec->length = LENGTH_T;
+        p++;
+    } else if (*p == 'L') {
+        spec->length = LENGTH_LONG_DOUBLE;
+        p++;
+    }
+    spec->conversion = *p;
+    return p;
+}
+
+static long long signedArg(lengthModifier length, va_list* args)
+{
+    switch (length) {
+        case LENGTH_HH:
+            return (signed char) va_arg(*args, int);
+        case LENGTH_H:
+            return (short) va_arg(*args, int);
+        case LENGTH_L:
+            return va_arg(*args, long);
+        case LENGTH_LL:
+            return va_arg(*args, long long);
+        case LENGTH_Z:
+            return (long long) va_arg(*args, size_t);
+        case LENGTH_J:
+            return (long long) va_arg(*args, intmax_t);
+        case LENGTH_T:
+            return va_arg(*args, ptrdiff_t);
+        default:
+            return va_arg(*args, int);
+    }
+}
+
+static unsigned long long unsignedArg(lengthModifier length, va_list* args)
+{
+    switch (length) {
+        case LENGTH_HH:
+            return (unsigned char) va_arg(*args, unsigned int);
+        case LENGTH_H:
+            return (unsigned short) va_arg(*args, unsigned int);
+        case LENGTH_L:
+            return va_arg(*args, unsigned long);
+        case LENGTH_LL:
+            return va_arg(*args, unsigned long long);
+        case LENGTH_Z:
+            return va_arg(*args, size_t);
+        case LENGTH_J:
+            return (unsigned long long) va_arg(*args, uintmax_t);
+        case LENGTH_T:
+            return (unsigned long long) va_arg(*args, ptrdiff_t);
+        default:
+            return va_arg(*args, unsigned int);
+    }
+}
+
+// Copies the arguments the format asks for into the record, without formatting any of them.
+static void captureArgs(logRecord* record, const char* format, va_list* args)
+{
+    size_t stringsUsed = 0;
+    record->argCount = 0;
+    for (const char* p = format; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        conversionSpec spec;
+        p = parseSpec(p, &spec);
+        if (spec.conversion == '\0') {
+            break;
+        }
+        if (spec.conversion == '%') {
+            continue;
+        }
+        const int needed = 1 + spec.hasStarWidth + spec.hasStarPrecision;
+        if (record->argCount + needed > ASYNC_LOG_MAX_ARGS) {
+            break;
+        }
+        logArg* arg = &record->args[record->argCount];
+        if (spec.hasStarWidth) {
+            (arg++)->i = va_arg(*args, int);
+        }
+        if (spec.hasStarPrecision) {
+            (arg++)->i = va_arg(*args, int);
+        }
+        switch (spec.conversion) {
+            case 'd':
+            case 'i':
+                arg->i = signedArg(spec.length, args);
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                arg->u = unsignedArg(spec.length, args);
+                break;
+            case 'c':
+                arg->i = va_arg(*args, int);
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                arg->d = (spec.length == LENGTH_LONG_DOUBLE) ? (double) va_arg(*args, long double) :
+                        va_arg(*args, double);
+                break;
+            case 's': {
+                const char* string = va_arg(*args, const char*);
+                if (string == NULL) {
+                    string = "(null)";
+                }
+                arg->u = stringsUsed;
+                if (stringsUsed < sizeof(record->strings)) {
+                    const size_t room = sizeof(record->strings) - stringsUsed - 1;
+                    size_t length = strlen(string);
+                    length = (length < room) ? length : room;
+                    memcpy(record->strings + stringsUsed, string, length);
+                    record->strings[stringsUsed + length] = '\0';
+                    stringsUsed += length + 1;
+                } else {
+                    arg->u = sizeof(record->strings) - 1;
+                    record->strings[sizeof(record->strings) - 1] = '\0';
+                }
+                break;
+            }
+            case 'p':
+                arg->p = va_arg(*args, void*);
+                break;
+            default:
+                // %n and anything unknown; the formatter stops here too
+                return;
+        }
+        record->argCount += needed;
+    }
+}
+
+static size_t appendText(char* out, size_t size, size_t used, const char* text, size_t length)
+{
+    if (used + 1 >= size) {
+        return used;
+    }
+    length = (length < size - used - 1) ? length : size - used - 1;
+    memcpy(out + used, text, length);
+    out[used + length] = '\0';
+    return used + length;
+}
+
+// The message of a record, formatted as printf would have.
+static size_t formatMessage(const logRecord* record, char* out, size_t size)
+{
+    size_t used = 0;
+    int argIndex = 0;
+    out[0] = '\0';
+    const char* literal = record->format;
+    for (const char* p = record->format; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        used = appendText(out, size, used, literal, (size_t) (p - literal));
+        conversionSpec spec;
+        p = parseSpec(p, &spec);
+        if (spec.conversion == '\0') {
+            return used;
+        }
+        literal = p + 1;
+        if (spec.conversion == '%') {
+            used = appendText(out, size, used, "%", 1);
+            continue;
+        }
+        const int needed = 1 + spec.hasStarWidth + spec.hasStarPrecision;
+        if (argIndex + needed > record->argCount) {
+            used = appendText(out, size, used, "...", 3);
+            return used;
+        }
+
+        // the same conversion, with stars resolved and integers widened to what the record holds
+        char mini[64];
+        int miniLength = snprintf(mini, sizeof(mini), "%%%s", spec.flags);
+        if (spec.hasStarWidth) {
+            miniLength += snprintf(mini + miniLength, sizeof(mini) - miniLength, "%d",
+                    (int) record->args[argIndex++].i);
+        } else {
+            miniLength += snprintf(mini + miniLength, sizeof(mini) - miniLength, "%.*s", spec.widthLength,
+                    spec.width);
+        }
+        if (spec.hasPrecision) {
+            if (spec.hasStarPrecision) {
+                miniLength += snprintf(mini + miniLength, sizeof(mini) - miniLength, ".%d",
+                        (int) record->args[argIndex++].i);
+            } else {
+                miniLength += snprintf(mini + miniLength, sizeof(mini) - miniLength, ".%.*s", spec.precisionLength,
+                        spec.precision);
+            }
+        }
+        const bool isInteger = strchr("diuoxX", spec.conversion) != NULL;
+        snprintf(mini + miniLength, sizeof(mini) - miniLength, "%s%c", isInteger ? "ll" : "", spec.conversion);
+
+        const logArg* arg = &record->args[argIndex++];
+        char value[LINE_LENGTH];
+        int length;
+        if (spec.conversion == 'd' || spec.conversion == 'i') {
+            length = snprintf(value, sizeof(value), mini, arg->i);
+        } else if (isInteger) {
+            length = snprintf(value, sizeof(value), mini, arg->u);
+        } else if (spec.conversion == 'c') {
+            length = snprintf(value, sizeof(value), mini, (int) arg->i);
+        } else if (spec.conversion == 's') {
+            length = snprintf(value, sizeof(value), mini, record->strings + arg->u);
+        } else if (spec.conversion == 'p') {
+            length = snprintf(value, sizeof(value), mini, arg->p);
+        } else {
+            length = snprintf(value, sizeof(value), mini, arg->d);
+        }
+        if (length > 0) {
+            used = appendText(out, size, used, value, ((size_t) length < sizeof(value)) ? (size_t) length :
+                    sizeof(value) - 1);
+        }
+    }
+    return appendText(out, size, used, literal, strlen(literal));
+}
+
+// One line per record: local time, level and the message without its trailing newlines.
+static size_t formatLine(const logRecord* record, char* out, size_t size, bool hasPrefix)
+{
+    size_t used = 0;
+    if (hasPrefix) {
+        const time_t seconds = (time_t) (record->timeUs / 1000000);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        used = (size_t) snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d.%03d %-5s ", local.tm_year + 1900,
+                local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec,
+                (int) ((record->timeUs / 1000) % 1000), LEVEL_NAMES[record->level]);
+    }
+    used += formatMessage(record, out + used, size - used - 1);
+    while (used > 0 && out[used - 1] == '\n') {
+        used--;
+    }
+    out[used++] = '\n';
+    out[used] = '\0';
+    return used;
+}
+
+static int syslogPriority(int level)
+{
+    static const int priorities[] = {LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERR};
+    return priorities[level];
+}
+
+static void writeBatch(const char* batch, size_t length)
+{
+    if (length == 0) {
+        return;
+    }
+    if (logSink == ASYNC_LOG_SINK_FILE) {
+        while (length > 0) {
+            const ssize_t written = write(fileFd, batch, length);
+            if (written <= 0) {
+                return;
+            }
+            batch += written;
+            length -= (size_t) written;
+        }
+    } else {
+        fwrite(batch, 1, length, stdout);
+        fflush(stdout);
+    }
+}
+
+static bool takeRecord(char* batch, size_t* batchLength)
+{
+    logRecord* record = &ring[dequeuePosition & (RING_LENGTH - 1)];
+    if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != dequeuePosition + 1) {
+        return false;
+    }
+    if (logSink == ASYNC_LOG_SINK_SYSLOG) {
+        char message[LINE_LENGTH];
+        formatMessage(record, message, sizeof(message));
+        syslog(syslogPriority(record->level), "%s", message);
+    } else {
+        char line[LINE_LENGTH];
+        const size_t length = formatLine(record, line, sizeof(line), true);
+        if (*batchLength + length > BATCH_LENGTH) {
+            writeBatch(batch, *batchLength);
+            *batchLength = 0;
+        }
+        memcpy(batch + *batchLength, line, length);
+        *batchLength += length;
+    }
+    __atomic_store_n(&record->sequence, dequeuePosition + RING_LENGTH, __ATOMIC_RELEASE);
+    dequeuePosition++;
+    return true;
+}
+
+static void* runLog(void* arg)
+{
+    (void) arg;
+    static char batch[BATCH_LENGTH];
+    while (true) {
+        size_t batchLength = 0;
+        bool isEmpty = true;
+        while (takeRecord(batch, &batchLength)) {
+            isEmpty = false;
+        }
+        writeBatch(batch, batchLength);
+        if (isEmpty) {
+            if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            struct timespec idle = {0, IDLE_SLEEP_MS * 1000 * 1000};
+            nanosleep(&idle, NULL);
+        }
+    }
+    return NULL;
+}
+
+bool asyncLog_start(asyncLog_sink sink, const char* path, asyncLog_level minLevel)
+{
+    logSink = sink;
+    minimumLevel = minLevel;
+    enqueuePosition = 0;
+    dequeuePosition = 0;
+    stopping = false;
+    memset(&counters, 0, sizeof(counters));
+
+    if (sink == ASYNC_LOG_SINK_FILE) {
+        fileFd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fileFd < 0) {
+            perror("Async log: Unable to open the log file.");
+            return false;
+        }
+    } else if (sink == ASYNC_LOG_SINK_SYSLOG) {
+        openlog(path, LOG_PID, LOG_DAEMON);
+    }
+    // touched up front, so it is resident before memory is locked
+    logRecord* records = malloc(sizeof(logRecord) * RING_LENGTH);
+    if (!records) {
+        printf("Async log: Unable to allocate the ring.\n");
+        asyncLog_stop();
+        return false;
+    }
+    memset(records, 0, sizeof(logRecord) * RING_LENGTH);
+    for (unsigned int i = 0; i < RING_LENGTH; i++) {
+        records[i].sequence = i;
+    }
+    ring = records;
+    memoryBudget_add("log ring", (long long) sizeof(logRecord) * RING_LENGTH, true);
+    if (pthread_create(&threadLog, NULL, runLog, NULL) != 0) {
+        printf("Async log: Unable to start the log thread.\n");
+        asyncLog_stop();
+        return false;
+    }
+    __atomic_store_n(&isRunning, true, __ATOMIC_RELEASE);
+    threadCpu_setName(threadLog, "log");
+    return true;
+}
+
+void asyncLog_log(asyncLog_level level, const char* format, ...)
+{
+    if ((int) level < minimumLevel) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+
+    if (!__atomic_load_n(&isRunning, __ATOMIC_ACQUIRE)) {
+        logRecord record;
+        record.level = (unsigned char) level;
+        record.timeUs = wallTimeUs();
+        record.format = format;
+        captureArgs(&record, format, &args);
+        va_end(args);
+        char line[LINE_LENGTH];
+        formatLine(&record, line, sizeof(line), false);
+        fputs(line, (level >= ASYNC_LOG_WARN) ? stderr : stdout);
+        return;
+    }
+
+    logRecord* record;
+    unsigned int position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+    while (true) {
+        record = &ring[position & (RING_LENGTH - 1)];
+        const int difference = (int) (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            __atomic_fetch_add(&counters.dropped, 1, __ATOMIC_RELAXED);
+            va_end(args);
+            return;
+        } else {
+            position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+    record->level = (unsigned char) level;
+    record->timeUs = wallTimeUs();
+    record->format = format;
+    captureArgs(record, format, &args);
+    va_end(args);
+    __atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&counters.logged, 1, __ATOMIC_RELAXED);
+}
+
+void asyncLog_stop(void)
+{
+    if (__atomic_load_n(&isRunning, __ATOMIC_ACQUIRE)) {
+        // later calls write synchronously; one still filling in a record would race the free below, so only stop
+        // once the threads that log are done
+        __atomic_store_n(&isRunning, false, __ATOMIC_RELEASE);
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        pthread_join(threadLog, NULL);
+    }
+    if (fileFd >= 0) {
+        close(fileFd);
+        fileFd = -1;
+    }
+    if (logSink == ASYNC_LOG_SINK_SYSLOG) {
+        closelog();
+    }
+    free(ring);
+    ring = NULL;
+}
+
+void asyncLog_getStats(asyncLog_stats* stats)
+{
+    stats->logged = __atomic_load_n(&counters.logged, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&counters.dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,49 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stdbool.h>
+
+// Logging that never waits on the console. A call copies its format pointer and raw arguments, %s strings
+// included, into a fixed-size record in a lock-free ring and returns; nothing is formatted or written on the calling
+// thread. A thread of its own formats the records and writes them to stdout, a file or syslog. When the ring is full,
+// the record is dropped and counted. Before asyncLog_start, and after asyncLog_stop, calls are written synchronously
+// instead, so startup errors still show up.
+
+typedef enum {
+    ASYNC_LOG_DEBUG = 0,
+    ASYNC_LOG_INFO,
+    ASYNC_LOG_WARN,
+    ASYNC_LOG_ERROR
+} asyncLog_level;
+
+typedef enum {
+    ASYNC_LOG_SINK_STDOUT = 0,
+    // appended to, one timestamped line per record
+    ASYNC_LOG_SINK_FILE,
+    ASYNC_LOG_SINK_SYSLOG
+} asyncLog_sink;
+
+typedef struct {
+    long long logged;
+    // the ring was full
+    long long dropped;
+} asyncLog_stats;
+
+// path is the log file for ASYNC_LOG_SINK_FILE and the syslog identity for ASYNC_LOG_SINK_SYSLOG. Records below
+// minLevel are ignored by the call itself.
+bool asyncLog_start(asyncLog_sink sink, const char* path, asyncLog_level minLevel);
+
+// printf-style. format has to outlive the record, e.g. a string literal; %s arguments are copied, up to a combined
+// ASYNC_LOG_MAX_STRING_BYTES, and %n isn't supported. Lock-free and safe from any thread.
+void asyncLog_log(asyncLog_level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+// Writes what is still in the ring, then joins the log thread.
+void asyncLog_stop(void);
+
+// Safe from any thread.
+void asyncLog_getStats(asyncLog_stats* stats);
+
+#define ASYNC_LOG_MAX_ARGS 8
+#define ASYNC_LOG_MAX_STRING_BYTES 240
+
+#endif
@@ -0,0 +1,482 @@
+#if !defined(_GNU_SOURCE)
+// sync_file_range
+#define _GNU_SOURCE
+#endif
+
+#include "audio_archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// a private copy: pv_recorder links in miniaudio's, whose public symbols a second public one would clash with
+#define DRWAV_API static
+#define DRWAV_PRIVATE static
+#define DR_WAV_IMPLEMENTATION
+#define DR_WAV_NO_STDIO
+#define DR_WAV_NO_CONVERSION_API
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "dr_wav.h"
+#pragma GCC diagnostic pop
+
+#include "async_log.h"
+#include "memory_budget.h"
+#include "pv_adpcm.h"
+#include "thread_cpu.h"
+
+// the ring is drained this often; well inside AUDIO_ARCHIVE_RING_MS
+#define DRAIN_INTERVAL_MS 1000
+// a recorder not started yet, or just stopped, is asked again this often
+#define RETRY_MS 20
+#define STAGING_ALIGNMENT 4096
+// ioprio_set: best effort, at its lowest level
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_BEST_EFFORT_LOWEST ((2 << 13) | 7)
+#define ADPCM_BLOCK_SAMPLES (((PV_ADPCM_DEFAULT_BLOCK_ALIGN - 4) * 2) + 1)
+
+static char archiveDirectory[PATH_MAX];
+static int32_t sampleRate = 0;
+static bool isAdpcm = false;
+static int32_t frameLength = 0;
+
+// written by the reader thread only; pushedSamples tells the writer thread how far it may read, writtenSamples tells
+// the reader thread how far it may write
+static int16_t* ring = NULL;
+static long long ringSamples = 0;
+static long long pushedSamples = 0;
+static long long writtenSamples = 0;
+
+// the reader thread holds the lock while it reads, and waits on the condition while there is no reader to read
+static pthread_mutex_t readerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t readerChanged = PTHREAD_COND_INITIALIZER;
+static pv_recorder_reader_t* reader = NULL;
+static bool isDetaching = false;
+static int16_t* frame = NULL;
+// the attached reader's count, which starts over with every recorder
+static long long readerDropped = 0;
+
+// writer thread only
+static drwav wav;
+static bool isFileOpen = false;
+static bool isFileFailed = false;
+static int fileFd = -1;
+static char filePath[PATH_MAX];
+static long long fileSamplesLeft = 0;
+static uint8_t* staging = NULL;
+static size_t stagedBytes = 0;
+// where the staged bytes go in the file, and the chunk written before them
+static long long stagingOffset = 0;
+static long long previousOffset = -1;
+// ADPCM files: the samples of the block being filled, and what the file has so far for its header
+static pv_adpcm_encoder_t encoder;
+static int16_t blockPcm[ADPCM_BLOCK_SAMPLES];
+static int32_t blockFill = 0;
+static long long fileSamples = 0;
+static long long fileDataBytes = 0;
+
+static pthread_t threadReader;
+static pthread_t threadWriter;
+static bool isRunning = false;
+static bool stopping = false;
+
+static audioArchive_stats counters;
+
+static void count(long long* counter, long long amount)
+{
+    __atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+static void sleepMs(long ms)
+{
+    const struct timespec interval = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&interval, NULL);
+}
+
+static void push(const int16_t* pcm)
+{
+    const long long pushed = pushedSamples;
+    if (pushed + frameLength - __atomic_load_n(&writtenSamples, __ATOMIC_ACQUIRE) > ringSamples) {
+        // the disk has fallen a whole ring behind; this frame is lost rather than anyone waiting
+        count(&counters.lostSamples, frameLength);
+        return;
+    }
+    const long long start = pushed % ringSamples;
+    const long long first = (ringSamples - start < frameLength) ? ringSamples - start : frameLength;
+    memcpy(ring + start, pcm, (size_t) first * sizeof(int16_t));
+    memcpy(ring, pcm + first, (size_t) (frameLength - first) * sizeof(int16_t));
+    __atomic_store_n(&pushedSamples, pushed + frameLength, __ATOMIC_RELEASE);
+}
+
+static void* runReader(void* arg)
+{
+    (void) arg;
+    pthread_mutex_lock(&readerLock);
+    while (true) {
+        while ((reader == NULL || __atomic_load_n(&isDetaching, __ATOMIC_ACQUIRE)) &&
+                !__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&readerChanged, &readerLock);
+        }
+        if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        pv_recorder_frame_info_t info;
+        const pv_recorder_status_t status = pv_recorder_reader_read(reader, frame, &info);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            // not started yet, or stopped under the supervisor, which detaches next
+            pthread_mutex_unlock(&readerLock);
+            sleepMs(RETRY_MS);
+            pthread_mutex_lock(&readerLock);
+            continue;
+        }
+        if (info.dropped_samples > readerDropped) {
+            count(&counters.lostSamples, info.dropped_samples - readerDropped);
+            readerDropped = info.dropped_samples;
+        }
+        pthread_mutex_unlock(&readerLock);
+        push(frame);
+        pthread_mutex_lock(&readerLock);
+    }
+    pthread_mutex_unlock(&readerLock);
+    return NULL;
+}
+
+// Writes the staged bytes with one pwrite, starts their writeback, and drops the chunk before them from the page cache,
+// whose writeback has had a chunk's time to finish.
+static bool flushStaging(void)
+{
+    if (stagedBytes == 0) {
+        return true;
+    }
+    if (pwrite(fileFd, staging, stagedBytes, stagingOffset) != (ssize_t) stagedBytes) {
+        return false;
+    }
+    (void) sync_file_range(fileFd, stagingOffset, (off_t) stagedBytes, SYNC_FILE_RANGE_WRITE);
+    if (previousOffset >= 0) {
+        (void) posix_fadvise(fileFd, previousOffset, stagingOffset - previousOffset, POSIX_FADV_DONTNEED);
+    }
+    previousOffset = stagingOffset;
+    stagingOffset += (long long) stagedBytes;
+    stagedBytes = 0;
+    return true;
+}
+
+static size_t onWrite(void* userData, const void* data, size_t bytes)
+{
+    (void) userData;
+    const uint8_t* from = data;
+    size_t left = bytes;
+    while (left > 0) {
+        const size_t room = AUDIO_ARCHIVE_WRITE_BYTES - stagedBytes;
+        const size_t n = (left < room) ? left : room;
+        memcpy(staging + stagedBytes, from, n);
+        stagedBytes += n;
+        from += n;
+        left -= n;
+        if (stagedBytes == AUDIO_ARCHIVE_WRITE_BYTES && !flushStaging()) {
+            return 0;
+        }
+    }
+    return bytes;
+}
+
+// dr_wav only seeks to patch the header's sizes as the file is finished
+static drwav_bool32 onSeek(void* userData, int offset, drwav_seek_origin origin)
+{
+    (void) userData;
+    if (!flushStaging()) {
+        return DRWAV_FALSE;
+    }
+    stagingOffset = (origin == drwav_seek_origin_start) ? offset : stagingOffset + offset;
+    previousOffset = -1;
+    return DRWAV_TRUE;
+}
+
+// Encodes the block being filled, which is short only as a file ends, and stages it.
+static bool writeBlock(void)
+{
+    uint8_t block[PV_ADPCM_DEFAULT_BLOCK_ALIGN];
+    pv_adpcm_encode_block(&encoder, blockPcm, blockFill, block);
+    const size_t length = (size_t) pv_adpcm_block_length(blockFill);
+    fileSamples += blockFill;
+    fileDataBytes += (long long) length;
+    blockFill = 0;
+    return onWrite(NULL, block, length) == length;
+}
+
+static bool writeSamples(const int16_t* pcm, long long n)
+{
+    if (!isAdpcm) {
+        return drwav_write_pcm_frames(&wav, (drwav_uint64) n, pcm) == (drwav_uint64) n;
+    }
+    while (n > 0) {
+        const long long take = (n < ADPCM_BLOCK_SAMPLES - blockFill) ? n : ADPCM_BLOCK_SAMPLES - blockFill;
+        memcpy(blockPcm + blockFill, pcm, (size_t) take * sizeof(int16_t));
+        blockFill += (int32_t) take;
+        pcm += take;
+        n -= take;
+        if (blockFill == ADPCM_BLOCK_SAMPLES && !writeBlock()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool startFile(void)
+{
+    if (!isAdpcm) {
+        const drwav_data_format format = {drwav_container_riff, DR_WAVE_FORMAT_PCM, 1, (drwav_uint32) sampleRate, 16};
+        return drwav_init_write(&wav, &format, onWrite, onSeek, NULL, NULL);
+    }
+    pv_adpcm_encoder_init(&encoder);
+    blockFill = 0;
+    fileSamples = 0;
+    fileDataBytes = 0;
+    // the sizes are filled in as the file is finished
+    uint8_t header[PV_ADPCM_WAV_HEADER_LENGTH];
+    pv_adpcm_wav_header(sampleRate, PV_ADPCM_DEFAULT_BLOCK_ALIGN, 0, 0, header);
+    return onWrite(NULL, header, sizeof(header)) == sizeof(header);
+}
+
+static bool finishFile(void)
+{
+    if (!isAdpcm) {
+        // patches the header's sizes through onSeek, then writes them out
+        return drwav_uninit(&wav) == DRWAV_SUCCESS && !isFileFailed && flushStaging();
+    }
+    if (isFileFailed || (blockFill > 0 && !writeBlock()) || !flushStaging()) {
+        return false;
+    }
+    uint8_t header[PV_ADPCM_WAV_HEADER_LENGTH];
+    pv_adpcm_wav_header(sampleRate, PV_ADPCM_DEFAULT_BLOCK_ALIGN, (uint32_t) fileSamples, (uint32_t) fileDataBytes,
+            header);
+    return pwrite(fileFd, header, sizeof(header), 0) == (ssize_t) sizeof(header);
+}
+
+static void failFile(const char* what)
+{
+    asyncLog_log(ASYNC_LOG_ERROR, "Audio archive: Unable to %s %s: %s", what, filePath, strerror(errno));
+    count(&counters.writeErrors, 1);
+    isFileFailed = true;
+}
+
+// The file the next samples go in, named for when the first of them was captured: waiting samples ago. It ends at the
+// top of the hour, and a file that can't be made still counts its samples away, so a full disk is tried once an hour.
+static void openFile(long long waiting)
+{
+    const time_t first = time(NULL) - (time_t) (waiting / sampleRate);
+    struct tm local;
+    localtime_r(&first, &local);
+    fileSamplesLeft = (long long) (AUDIO_ARCHIVE_FILE_SECONDS - (local.tm_min * 60 + local.tm_sec) %
+            AUDIO_ARCHIVE_FILE_SECONDS) * sampleRate;
+    char name[32];
+    strftime(name, sizeof(name), "tank-%Y%m%d-%H%M%S.wav", &local);
+    const int pathLength = snprintf(filePath, sizeof(filePath), "%s/%s.part", archiveDirectory, name);
+    isFileOpen = true;
+    isFileFailed = false;
+    stagedBytes = 0;
+    stagingOffset = 0;
+    previousOffset = -1;
+
+    // a cut-off path would put the file somewhere else
+    if (pathLength < 0 || pathLength >= (int) sizeof(filePath)) {
+        errno = ENAMETOOLONG;
+        failFile("create");
+        return;
+    }
+    fileFd = open(filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileFd < 0) {
+        failFile("create");
+        return;
+    }
+    if (!startFile()) {
+        failFile("start");
+        close(fileFd);
+        fileFd = -1;
+    }
+}
+
+static void closeFile(void)
+{
+    if (fileFd >= 0) {
+        const bool isFinished = finishFile();
+        if (!isFinished && !isFileFailed) {
+            failFile("finish");
+        }
+        close(fileFd);
+        fileFd = -1;
+        char finished[PATH_MAX];
+        snprintf(finished, sizeof(finished), "%.*s", (int) (strlen(filePath) - strlen(".part")), filePath);
+        if (isFinished && rename(filePath, finished) != 0) {
+            failFile("rename");
+        } else if (isFinished) {
+            count(&counters.files, 1);
+        }
+    }
+    isFileOpen = false;
+}
+
+// Moves the samples waiting in the ring into the files.
+static void drain(void)
+{
+    const long long pushed = __atomic_load_n(&pushedSamples, __ATOMIC_ACQUIRE);
+    long long written = writtenSamples;
+    while (written < pushed) {
+        if (!isFileOpen) {
+            openFile(pushed - written);
+        }
+        const long long start = written % ringSamples;
+        long long n = pushed - written;
+        n = (n < fileSamplesLeft) ? n : fileSamplesLeft;
+        n = (n < ringSamples - start) ? n : ringSamples - start;
+        if (fileFd >= 0 && !isFileFailed) {
+            if (!writeSamples(ring + start, n)) {
+                failFile("write");
+            } else {
+                count(&counters.writtenSamples, n);
+            }
+        }
+        if (fileFd < 0 || isFileFailed) {
+            count(&counters.lostSamples, n);
+        }
+        written += n;
+        fileSamplesLeft -= n;
+        // the ring space is free as soon as the samples are staged
+        __atomic_store_n(&writtenSamples, written, __ATOMIC_RELEASE);
+        if (fileSamplesLeft == 0) {
+            closeFile();
+        }
+    }
+}
+
+static void* runWriter(void* arg)
+{
+    (void) arg;
+    // only the disk's spare time; the ring absorbs however long that takes to come round
+    const pid_t tid = (pid_t) syscall(SYS_gettid);
+    if (setpriority(PRIO_PROCESS, (id_t) tid, 19) != 0 ||
+            syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_BEST_EFFORT_LOWEST) != 0) {
+        asyncLog_log(ASYNC_LOG_DEBUG, "Audio archive: writer priority not lowered: %s", strerror(errno));
+    }
+    while (!__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+        drain();
+        sleepMs(DRAIN_INTERVAL_MS);
+    }
+    // the reader thread has stopped pushing
+    drain();
+    closeFile();
+    return NULL;
+}
+
+bool audioArchive_start(const char* directory, int32_t rate, bool isAdpcmFiles)
+{
+    snprintf(archiveDirectory, sizeof(archiveDirectory), "%s", directory);
+    sampleRate = rate;
+    isAdpcm = isAdpcmFiles;
+    frameLength = rate * AUDIO_ARCHIVE_FRAME_MS / 1000;
+    ringSamples = (long long) rate * AUDIO_ARCHIVE_RING_MS / 1000;
+    pushedSamples = 0;
+    writtenSamples = 0;
+    stopping = false;
+    memset(&counters, 0, sizeof(counters));
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Audio archive: Unable to create '%s': %s\n", directory, strerror(errno));
+        return false;
+    }
+    // allocated and touched up front, so they are resident before memory is locked
+    ring = malloc((size_t) ringSamples * sizeof(int16_t));
+    frame = malloc((size_t) frameLength * sizeof(int16_t));
+    void* aligned = NULL;
+    staging = (posix_memalign(&aligned, STAGING_ALIGNMENT, AUDIO_ARCHIVE_WRITE_BYTES) == 0) ? aligned : NULL;
+    if (!ring || !frame || !staging) {
+        printf("Audio archive: Unable to allocate the ring.\n");
+        audioArchive_stop();
+        return false;
+    }
+    memset(ring, 0, (size_t) ringSamples * sizeof(int16_t));
+    memset(staging, 0, AUDIO_ARCHIVE_WRITE_BYTES);
+    memoryBudget_add("audio archive", (long long) (ringSamples + frameLength) * sizeof(int16_t) +
+            AUDIO_ARCHIVE_WRITE_BYTES, true);
+    if (pthread_create(&threadReader, NULL, runReader, NULL) != 0) {
+        printf("Audio archive: Unable to start the reader thread.\n");
+        audioArchive_stop();
+        return false;
+    }
+    if (pthread_create(&threadWriter, NULL, runWriter, NULL) != 0) {
+        printf("Audio archive: Unable to start the writer thread.\n");
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        pthread_cond_signal(&readerChanged);
+        pthread_join(threadReader, NULL);
+        audioArchive_stop();
+        return false;
+    }
+    isRunning = true;
+    threadCpu_setName(threadReader, "archive-read");
+    threadCpu_setName(threadWriter, "archive-write");
+    return true;
+}
+
+bool audioArchive_attach(pv_recorder_t* recorder)
+{
+    pv_recorder_reader_t* added = NULL;
+    const pv_recorder_status_t status = pv_recorder_add_reader(recorder, frameLength, &added);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Audio archive: Unable to add a reader: %s",
+                pv_recorder_status_to_string(status));
+        return false;
+    }
+    pthread_mutex_lock(&readerLock);
+    reader = added;
+    readerDropped = 0;
+    pthread_cond_signal(&readerChanged);
+    pthread_mutex_unlock(&readerLock);
+    return true;
+}
+
+void audioArchive_detach(void)
+{
+    // the reader thread gives the lock up at the end of its read, and then waits
+    __atomic_store_n(&isDetaching, true, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&readerLock);
+    reader = NULL;
+    __atomic_store_n(&isDetaching, false, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&readerLock);
+}
+
+void audioArchive_stop(void)
+{
+    if (isRunning) {
+        audioArchive_detach();
+        pthread_mutex_lock(&readerLock);
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        pthread_cond_signal(&readerChanged);
+        pthread_mutex_unlock(&readerLock);
+        pthread_join(threadReader, NULL);
+        pthread_join(threadWriter, NULL);
+        isRunning = false;
+    }
+    free(ring);
+    ring = NULL;
+    free(frame);
+    frame = NULL;
+    free(staging);
+    staging = NULL;
+}
+
+void audioArchive_getStats(audioArchive_stats* stats)
+{
+    stats->files = __atomic_load_n(&counters.files, __ATOMIC_RELAXED);
+    stats->writtenSamples = __atomic_load_n(&counters.writtenSamples, __ATOMIC_RELAXED);
+    stats->lostSamples = __atomic_load_n(&counters.lostSamples, __ATOMIC_RELAXED);
+    stats->writeErrors = __atomic_load_n(&counters.writeErrors, __ATOMIC_RELAXED);
+}
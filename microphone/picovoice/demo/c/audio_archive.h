@@ -0,0 +1,51 @@
+#ifndef AUDIO_ARCHIVE_H
+#define AUDIO_ARCHIVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+// Keeps all of the tank room's audio on disk for acoustic research, one WAV file per hour of the clock. It is a reader
+// of its own on the recorder (pv_recorder_add_reader), so it takes the audio straight from the recorder's ring and
+// not from the inference path. With PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST, a reader that falls behind is skipped
+// ahead rather than holding the others up, so nothing here can ever slow inference down. A reader thread only copies
+// each frame into a preallocated ring of AUDIO_ARCHIVE_RING_MS. A writer thread, at the lowest CPU and I/O priority,
+// drains the ring through dr_wav's streaming writer, into an aligned staging buffer that goes to the file
+// AUDIO_ARCHIVE_WRITE_BYTES at a time. The kernel is told to start writing back each chunk at once, and to drop the
+// chunk before it from the page cache, so the disk sees steady large writes and the recording doesn't fill memory. If
+// the disk stalls for longer than the ring holds, the audio it couldn't take is lost and counted. The files can instead
+// be IMA-ADPCM (pv_adpcm.h), about 29 MB an hour at 16 kHz rather than 115 MB, encoded a block at a time on the writer
+// thread; dr_wav, sox and ffmpeg read them as they read the PCM ones.
+
+#define AUDIO_ARCHIVE_FRAME_MS 20
+#define AUDIO_ARCHIVE_RING_MS 60000
+#define AUDIO_ARCHIVE_WRITE_BYTES (256 * 1024)
+#define AUDIO_ARCHIVE_FILE_SECONDS 3600
+
+typedef struct {
+    long long files;
+    long long writtenSamples;
+    // not recorded: dropped by the recorder, or with the ring full
+    long long lostSamples;
+    long long writeErrors;
+} audioArchive_stats;
+
+// Starts the threads; the audio starts once a recorder is attached. Files are written to directory as
+// tank-YYYYmmdd-HHMMSS.wav, named for their first sample, and carry a .part suffix until they are finished.
+bool audioArchive_start(const char* directory, int32_t sampleRate, bool isAdpcm);
+
+// Adds the archive's reader to a recorder that hasn't been started yet.
+bool audioArchive_attach(pv_recorder_t* recorder);
+
+// Before the attached recorder is stopped or deleted. Waits for a read in progress, at most the recorder's read
+// timeout.
+void audioArchive_detach(void);
+
+// Detaches, writes out what is in the ring, finishes the file and joins the threads.
+void audioArchive_stop(void);
+
+// Safe from any thread.
+void audioArchive_getStats(audioArchive_stats* stats);
+
+#endif
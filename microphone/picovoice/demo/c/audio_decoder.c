@@ -0,0 +1,305 @@
+#include "audio_decoder.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DR_WAV_IMPLEMENTATION
+#include "dr_wav.h"
+#define DR_FLAC_IMPLEMENTATION
+#include "dr_flac.h"
+#define DR_MP3_IMPLEMENTATION
+#include "dr_mp3.h"
+
+#define MAX_CHANNELS 8
+// input frames decoded per read from the library
+#define CHUNK_FRAMES 1024
+// the resampler looks this many samples either side of an output, counted at the lower of the two rates, so the
+// transition band is as narrow going down from 48 kHz as going up from 8 kHz
+#define HALF_TAPS 16
+// fractional positions the kernel is tabulated at; an output uses the nearest
+#define PHASES 256
+// a little under the lower rate's Nyquist frequency, so the transition band stays out of what's kept
+#define CUTOFF 0.9
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef enum {
+    FORMAT_WAV,
+    FORMAT_FLAC,
+    FORMAT_MP3,
+} audioFormat;
+
+struct audioDecoder {
+    audioFormat format;
+    drwav wav;
+    drflac* flac;
+    drmp3 mp3;
+    uint32_t channels;
+    bool isEnd;
+    int16_t chunk[CHUNK_FRAMES * MAX_CHANNELS];
+    int16_t mono[CHUNK_FRAMES];
+
+    // only when the file's rate isn't the engine's
+    bool isResampling;
+    int32_t halfTaps;
+    int32_t taps;
+    // one row of taps per phase, PHASES + 1 rows so a position just under the next sample has one too
+    float* kernel;
+    // mono input samples; window[0] is input sample windowStart, before the file starts it's silence
+    float* window;
+    int32_t windowSize;
+    int64_t windowStart;
+    int32_t windowCount;
+    // input samples decoded so far, and where in them the next output falls
+    int64_t inputCount;
+    double position;
+    double step;
+};
+
+static const char* detectFormat(const char* path, audioFormat* format)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return "failed to open audio file";
+    }
+    uint8_t header[12];
+    const size_t length = fread(header, 1, sizeof(header), file);
+    fclose(file);
+    if (length >= 12 && (memcmp(header, "RIFF", 4) == 0 || memcmp(header, "RIFX", 4) == 0 ||
+            memcmp(header, "RF64", 4) == 0 || memcmp(header, "riff", 4) == 0)) {
+        *format = FORMAT_WAV;
+    } else if (length >= 4 && (memcmp(header, "fLaC", 4) == 0 || memcmp(header, "OggS", 4) == 0)) {
+        *format = FORMAT_FLAC;
+    } else if ((length >= 3 && memcmp(header, "ID3", 3) == 0) ||
+            (length >= 2 && header[0] == 0xFF && (header[1] & 0xE0) == 0xE0)) {
+        *format = FORMAT_MP3;
+    } else {
+        return "unsupported audio format";
+    }
+    return NULL;
+}
+
+static double sinc(double x)
+{
+    return (x == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+}
+
+// Blackman-windowed sinc, each row scaled to a gain of one so silence and DC come through unchanged.
+static void buildKernel(audioDecoder* decoder, double inputRate, double outputRate)
+{
+    const int32_t halfTaps = decoder->halfTaps;
+    const int32_t taps = decoder->taps;
+    const double cutoff = CUTOFF * ((outputRate < inputRate) ? outputRate / inputRate : 1.0);
+    for (int32_t phase = 0; phase <= PHASES; phase++) {
+        const double fraction = (double) phase / PHASES;
+        float* row = &decoder->kernel[phase * taps];
+        double sum = 0;
+        for (int32_t k = 0; k < taps; k++) {
+            // distance from the output to input sample floor(position) - halfTaps + 1 + k
+            const double x = (double) (k - halfTaps + 1) - fraction;
+            const double w = (x + halfTaps) / taps;
+            const double blackman = 0.42 - 0.5 * cos(2 * M_PI * w) + 0.08 * cos(4 * M_PI * w);
+            const double value = cutoff * sinc(cutoff * x) * (w > 0.0 && w < 1.0 ? blackman : 0.0);
+            row[k] = (float) value;
+            sum += value;
+        }
+        for (int32_t k = 0; k < taps; k++) {
+            row[k] = (float) (row[k] / sum);
+        }
+    }
+}
+
+// Up to frames interleaved frames into out; fewer only at the end.
+static int32_t decodeFrames(audioDecoder* decoder, int16_t* out, int32_t frames)
+{
+    switch (decoder->format) {
+        case FORMAT_WAV:
+            return (int32_t) drwav_read_pcm_frames_s16(&decoder->wav, (drwav_uint64) frames, out);
+        case FORMAT_FLAC:
+            return (int32_t) drflac_read_pcm_frames_s16(decoder->flac, (drflac_uint64) frames, out);
+        case FORMAT_MP3:
+            return (int32_t) drmp3_read_pcm_frames_s16(&decoder->mp3, (drmp3_uint64) frames, out);
+    }
+    return 0;
+}
+
+// Up to count mono samples at the file's own rate. A mono file is decoded straight into samples.
+static int32_t readMono(audioDecoder* decoder, int16_t* samples, int32_t count)
+{
+    int32_t total = 0;
+    while (total < count && !decoder->isEnd) {
+        const int32_t wanted = (count - total < CHUNK_FRAMES) ? count - total : CHUNK_FRAMES;
+        if (decoder->channels == 1) {
+            const int32_t read = decodeFrames(decoder, samples + total, wanted);
+            decoder->isEnd = (read < wanted);
+            total += read;
+            continue;
+        }
+        const int32_t read = decodeFrames(decoder, decoder->chunk, wanted);
+        decoder->isEnd = (read < wanted);
+        const int32_t channels = (int32_t) decoder->channels;
+        for (int32_t i = 0; i < read; i++) {
+            int32_t sum = 0;
+            for (int32_t c = 0; c < channels; c++) {
+                sum += decoder->chunk[i * channels + c];
+            }
+            samples[total + i] = (int16_t) (sum / channels);
+        }
+        total += read;
+    }
+    return total;
+}
+
+// Drops what the next output no longer needs and tops the window up, with silence past the end of the file.
+static void refill(audioDecoder* decoder, int64_t first)
+{
+    // a step of more than halfTaps samples can land past what's decoded; the skipped samples go on later calls
+    int32_t drop = (int32_t) (first - decoder->windowStart);
+    drop = (drop < decoder->windowCount) ? drop : decoder->windowCount;
+    if (drop > 0) {
+        memmove(decoder->window, decoder->window + drop, (size_t) (decoder->windowCount - drop) * sizeof(float));
+        decoder->windowCount -= drop;
+        decoder->windowStart += drop;
+    }
+    const int32_t room = decoder->windowSize - decoder->windowCount;
+    int16_t* mono = decoder->mono;
+    const int32_t read = readMono(decoder, mono, (room < CHUNK_FRAMES) ? room : CHUNK_FRAMES);
+    for (int32_t i = 0; i < read; i++) {
+        decoder->window[decoder->windowCount++] = mono[i];
+    }
+    decoder->inputCount += read;
+    if (read == 0) {
+        for (int32_t i = 0; i < decoder->halfTaps && decoder->windowCount < decoder->windowSize; i++) {
+            decoder->window[decoder->windowCount++] = 0.f;
+        }
+    }
+}
+
+static int32_t readResampled(audioDecoder* decoder, int16_t* samples, int32_t count)
+{
+    int32_t total = 0;
+    while (total < count) {
+        const int64_t base = (int64_t) floor(decoder->position);
+        const int64_t first = base - decoder->halfTaps + 1;
+        if (decoder->isEnd && decoder->position >= (double) decoder->inputCount) {
+            break;
+        }
+        if (base + decoder->halfTaps >= decoder->windowStart + decoder->windowCount) {
+            refill(decoder, first);
+            continue;
+        }
+        const int32_t phase = (int32_t) ((decoder->position - (double) base) * PHASES + 0.5);
+        const float* row = &decoder->kernel[phase * decoder->taps];
+        const float* input = &decoder->window[first - decoder->windowStart];
+        float value = 0.f;
+        for (int32_t k = 0; k < decoder->taps; k++) {
+            value += row[k] * input[k];
+        }
+        value = (value > 32767.f) ? 32767.f : (value < -32768.f) ? -32768.f : value;
+        samples[total++] = (int16_t) lrintf(value);
+        decoder->position += decoder->step;
+    }
+    return total;
+}
+
+const char* audioDecoder_open(const char* path, int32_t sampleRate, audioDecoder** decoder)
+{
+    *decoder = NULL;
+    audioFormat format;
+    const char* error = detectFormat(path, &format);
+    if (error) {
+        return error;
+    }
+    audioDecoder* self = calloc(1, sizeof(audioDecoder));
+    if (!self) {
+        return "failed to allocate memory for the decoder";
+    }
+    self->format = format;
+    uint32_t inputRate = 0;
+    bool isOpen = false;
+    switch (format) {
+        case FORMAT_WAV:
+            isOpen = drwav_init_file(&self->wav, path, NULL);
+            self->channels = self->wav.channels;
+            inputRate = self->wav.sampleRate;
+            break;
+        case FORMAT_FLAC:
+            self->flac = drflac_open_file(path, NULL);
+            isOpen = (self->flac != NULL);
+            self->channels = isOpen ? self->flac->channels : 0;
+            inputRate = isOpen ? self->flac->sampleRate : 0;
+            break;
+        case FORMAT_MP3:
+            isOpen = drmp3_init_file(&self->mp3, path, NULL);
+            self->channels = self->mp3.channels;
+            inputRate = self->mp3.sampleRate;
+            break;
+    }
+    if (!isOpen) {
+        free(self);
+        return "failed to decode audio file";
+    }
+    *decoder = self;
+    if (self->channels < 1 || self->channels > MAX_CHANNELS) {
+        audioDecoder_close(self);
+        *decoder = NULL;
+        return "unsupported channel count";
+    }
+    if (inputRate == 0) {
+        audioDecoder_close(self);
+        *decoder = NULL;
+        return "unsupported sample rate";
+    }
+    if (inputRate != (uint32_t) sampleRate) {
+        self->isResampling = true;
+        self->step = (double) inputRate / sampleRate;
+        self->halfTaps = (int32_t) ceil(HALF_TAPS * (self->step > 1.0 ? self->step : 1.0));
+        self->taps = 2 * self->halfTaps;
+        self->windowSize = CHUNK_FRAMES + self->taps;
+        self->kernel = malloc((size_t) (PHASES + 1) * (size_t) self->taps * sizeof(float));
+        self->window = malloc((size_t) self->windowSize * sizeof(float));
+        if (!self->kernel || !self->window) {
+            audioDecoder_close(self);
+            *decoder = NULL;
+            return "failed to allocate memory for the resampler";
+        }
+        buildKernel(self, inputRate, sampleRate);
+        // silence before the first sample, for the first outputs' left half
+        for (int32_t i = 0; i < self->halfTaps; i++) {
+            self->window[i] = 0.f;
+        }
+        self->windowStart = -self->halfTaps;
+        self->windowCount = self->halfTaps;
+    }
+    return NULL;
+}
+
+int32_t audioDecoder_read(audioDecoder* decoder, int16_t* samples, int32_t count)
+{
+    return decoder->isResampling ? readResampled(decoder, samples, count) : readMono(decoder, samples, count);
+}
+
+void audioDecoder_close(audioDecoder* decoder)
+{
+    if (!decoder) {
+        return;
+    }
+    switch (decoder->format) {
+        case FORMAT_WAV:
+            drwav_uninit(&decoder->wav);
+            break;
+        case FORMAT_FLAC:
+            drflac_close(decoder->flac);
+            break;
+        case FORMAT_MP3:
+            drmp3_uninit(&decoder->mp3);
+            break;
+    }
+    free(decoder->kernel);
+    free(decoder->window);
+    free(decoder);
+}
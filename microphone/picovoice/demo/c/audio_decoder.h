@@ -0,0 +1,21 @@
+#ifndef AUDIO_DECODER_H
+#define AUDIO_DECODER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// WAV, FLAC or MP3, told apart by the file's first bytes rather than its name, decoded as it's read and turned into
+// mono 16-bit PCM at the engine's sample rate. Channels are averaged; another rate goes through a windowed-sinc
+// resampler. Everything the decoder needs is allocated when it's opened, so reads never allocate.
+
+typedef struct audioDecoder audioDecoder;
+
+// Returns NULL and sets *decoder, or returns why the file can't be decoded.
+const char* audioDecoder_open(const char* path, int32_t sampleRate, audioDecoder** decoder);
+
+// Fills samples with up to count samples and returns how many; fewer than count only at the end of the file.
+int32_t audioDecoder_read(audioDecoder* decoder, int16_t* samples, int32_t count);
+
+void audioDecoder_close(audioDecoder* decoder);
+
+#endif
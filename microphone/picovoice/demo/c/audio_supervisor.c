@@ -0,0 +1,192 @@
+#include "audio_supervisor.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include "async_log.h"
+
+static pthread_mutex_t recorderLock = PTHREAD_MUTEX_INITIALIZER;
+static pv_recorder_t* recorder = NULL;
+static const pv_recorder_config_t* recorderConfig = NULL;
+static pv_recorder_frame_callback_t frameFunc = NULL;
+static void* frameUserData = NULL;
+static pv_recorder_log_callback_t logFunc = NULL;
+static void* logUserData = NULL;
+static audioSupervisor_recorderFunc createdFunc = NULL;
+static audioSupervisor_recorderFunc deletingFunc = NULL;
+
+// main thread only: samples the device had delivered at the last poll, and when that last changed (CLOCK_MONOTONIC)
+static long long lastSamples = 0;
+static long long lastProgressUs = 0;
+static long long nextAttemptUs = 0;
+static long long backoffMs = AUDIO_SUPERVISOR_MIN_BACKOFF_MS;
+// 0 while frames are arriving; read from other threads
+static long long downSinceUs = 0;
+// read from other threads
+static audioSupervisor_stats stats;
+
+static long long nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static bool isWatched(void)
+{
+    // a serial link is quiet between bursts and a replayed file is silent once it ends
+    return recorderConfig != NULL && recorderConfig->backend != PV_RECORDER_BACKEND_SERIAL &&
+           recorderConfig->backend != PV_RECORDER_BACKEND_FILE;
+}
+
+void audioSupervisor_setRecorderFuncs(audioSupervisor_recorderFunc onCreated, audioSupervisor_recorderFunc onDeleting)
+{
+    createdFunc = onCreated;
+    deletingFunc = onDeleting;
+}
+
+void audioSupervisor_watch(pv_recorder_t* started, const pv_recorder_config_t* config,
+        pv_recorder_frame_callback_t onFrame, void* onFrameUserData, pv_recorder_log_callback_t onLog,
+        void* onLogUserData)
+{
+    pthread_mutex_lock(&recorderLock);
+    recorder = started;
+    pthread_mutex_unlock(&recorderLock);
+    recorderConfig = config;
+    frameFunc = onFrame;
+    frameUserData = onFrameUserData;
+    logFunc = onLog;
+    logUserData = onLogUserData;
+    lastSamples = 0;
+    lastProgressUs = nowUs();
+    backoffMs = AUDIO_SUPERVISOR_MIN_BACKOFF_MS;
+    __atomic_store_n(&downSinceUs, 0, __ATOMIC_RELAXED);
+}
+
+static void deleteRecorder(void)
+{
+    pthread_mutex_lock(&recorderLock);
+    pv_recorder_t* stalled = recorder;
+    recorder = NULL;
+    pthread_mutex_unlock(&recorderLock);
+    if (stalled != NULL) {
+        if (deletingFunc != NULL) {
+            deletingFunc(stalled);
+        }
+        // the device may be gone already; the worker still stops within its read timeout
+        pv_recorder_stop(stalled);
+        pv_recorder_delete(stalled);
+    }
+}
+
+static bool createRecorder(void)
+{
+    pv_recorder_t* created = NULL;
+    pv_recorder_status_t status = pv_recorder_init_with_config(recorderConfig, &created);
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_set_log_callback(created, logFunc, logUserData);
+        status = pv_recorder_set_frame_callback(created, frameFunc, frameUserData);
+    }
+    if (status == PV_RECORDER_STATUS_SUCCESS && createdFunc != NULL) {
+        createdFunc(created);
+    }
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        status = pv_recorder_start(created);
+    }
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        if (created != NULL) {
+            if (deletingFunc != NULL) {
+                deletingFunc(created);
+            }
+            pv_recorder_delete(created);
+        }
+        asyncLog_log(ASYNC_LOG_DEBUG, "Audio supervisor: reopening failed with %s.",
+                pv_recorder_status_to_string(status));
+        return false;
+    }
+    pthread_mutex_lock(&recorderLock);
+    recorder = created;
+    pthread_mutex_unlock(&recorderLock);
+    return true;
+}
+
+void audioSupervisor_poll(void)
+{
+    if (!isWatched()) {
+        return;
+    }
+    const long long now = nowUs();
+    const long long down = __atomic_load_n(&downSinceUs, __ATOMIC_RELAXED);
+
+    if (recorder != NULL) {
+        pv_recorder_stats_t recorderStats;
+        if (pv_recorder_get_stats(recorder, &recorderStats) == PV_RECORDER_STATUS_SUCCESS &&
+                recorderStats.total_samples != lastSamples) {
+            lastSamples = recorderStats.total_samples;
+            lastProgressUs = now;
+            if (down != 0) {
+                asyncLog_log(ASYNC_LOG_INFO, "Audio supervisor: audio back after %lld ms.", (now - down) / 1000);
+                __atomic_store_n(&downSinceUs, 0, __ATOMIC_RELAXED);
+                backoffMs = AUDIO_SUPERVISOR_MIN_BACKOFF_MS;
+            }
+            return;
+        }
+        if (now - lastProgressUs < AUDIO_SUPERVISOR_STALL_MS * 1000LL) {
+            return;
+        }
+        asyncLog_log(ASYNC_LOG_WARN, "Audio supervisor: no audio for %d ms, reopening the device.",
+                AUDIO_SUPERVISOR_STALL_MS);
+        if (down == 0) {
+            __atomic_store_n(&downSinceUs, lastProgressUs, __ATOMIC_RELAXED);
+        }
+        deleteRecorder();
+        nextAttemptUs = now;
+    }
+
+    if (now < nextAttemptUs) {
+        return;
+    }
+    if (createRecorder()) {
+        __atomic_add_fetch(&stats.restarts, 1, __ATOMIC_RELAXED);
+        // counted from the new recorder's start, so it gets a full stall period to deliver
+        lastSamples = 0;
+        lastProgressUs = nowUs();
+    } else {
+        __atomic_add_fetch(&stats.failedAttempts, 1, __ATOMIC_RELAXED);
+        nextAttemptUs = now + backoffMs * 1000;
+        backoffMs = (backoffMs * 2 > AUDIO_SUPERVISOR_MAX_BACKOFF_MS) ? AUDIO_SUPERVISOR_MAX_BACKOFF_MS : backoffMs * 2;
+    }
+}
+
+bool audioSupervisor_isHealthy(long long budgetMs)
+{
+    const long long down = __atomic_load_n(&downSinceUs, __ATOMIC_RELAXED);
+    return down == 0 || nowUs() - down < budgetMs * 1000;
+}
+
+pv_recorder_t* audioSupervisor_lock(void)
+{
+    pthread_mutex_lock(&recorderLock);
+    return recorder;
+}
+
+void audioSupervisor_unlock(void)
+{
+    pthread_mutex_unlock(&recorderLock);
+}
+
+pv_recorder_t* audioSupervisor_release(void)
+{
+    pthread_mutex_lock(&recorderLock);
+    pv_recorder_t* released = recorder;
+    recorder = NULL;
+    pthread_mutex_unlock(&recorderLock);
+    recorderConfig = NULL;
+    return released;
+}
+
+void audioSupervisor_getStats(audioSupervisor_stats* out)
+{
+    out->restarts = __atomic_load_n(&stats.restarts, __ATOMIC_RELAXED);
+    out->failedAttempts = __atomic_load_n(&stats.failedAttempts, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,53 @@
+#ifndef AUDIO_SUPERVISOR_H
+#define AUDIO_SUPERVISOR_H
+
+#include <stdbool.h>
+
+#include "pv_recorder.h"
+
+// Keeps the audio device delivering without restarting the daemon. It takes over a started recorder, and the main
+// thread calls audioSupervisor_poll every 100 ms or so. When a local device delivers no frame for a while (unplugged,
+// or an ALSA device that stopped), only the recorder is stopped, deleted and built again from the same config, with
+// backoff between attempts; the models, the pipeline and the hardware carry on, and frames flow again milliseconds
+// after the device is back. A co-processor on the serial backend is silent between bursts, so it isn't watched.
+
+#define AUDIO_SUPERVISOR_STALL_MS 2000
+#define AUDIO_SUPERVISOR_MIN_BACKOFF_MS 100
+#define AUDIO_SUPERVISOR_MAX_BACKOFF_MS 5000
+
+typedef struct {
+    long long restarts;
+    long long failedAttempts;
+} audioSupervisor_stats;
+
+// recorder has to be started, with the frame callback and log callback set from onFrame and onLog; config has to
+// outlive the supervisor, its device names included.
+void audioSupervisor_watch(pv_recorder_t* recorder, const pv_recorder_config_t* config,
+        pv_recorder_frame_callback_t onFrame, void* onFrameUserData, pv_recorder_log_callback_t onLog,
+        void* onLogUserData);
+
+// Called on the polling thread with each recorder the supervisor builds, before it is started, and with each it is
+// about to stop and delete, so a reader added to the first recorder (pv_recorder_add_reader) can be added to the next.
+typedef void (*audioSupervisor_recorderFunc)(pv_recorder_t* recorder);
+
+// Before audioSupervisor_watch; either may be NULL.
+void audioSupervisor_setRecorderFuncs(audioSupervisor_recorderFunc onCreated, audioSupervisor_recorderFunc onDeleting);
+
+// On the thread that called audioSupervisor_watch.
+void audioSupervisor_poll(void);
+
+// Whether frames are arriving, or have stopped for less than budgetMs. Safe from any thread.
+bool audioSupervisor_isHealthy(long long budgetMs);
+
+// The recorder, held until audioSupervisor_unlock so it isn't rebuilt meanwhile; NULL while there is none, e.g. for
+// the metrics thread.
+pv_recorder_t* audioSupervisor_lock(void);
+void audioSupervisor_unlock(void);
+
+// Hands the recorder back, NULL if the last rebuild failed, and stops watching it.
+pv_recorder_t* audioSupervisor_release(void);
+
+// Safe from any thread.
+void audioSupervisor_getStats(audioSupervisor_stats* stats);
+
+#endif
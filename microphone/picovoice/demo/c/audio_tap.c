@@ -0,0 +1,75 @@
+#include "audio_tap.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define RETRY_US 1000000LL
+
+static int socketFd = -1;
+static struct sockaddr_un captureAddress;
+static int32_t frameLength = 0;
+static int32_t sampleRate = 0;
+// while capture isn't listening, nothing is sent before this
+static long long retryUs = 0;
+
+bool audioTap_open(const char* path, int32_t length, int32_t rate)
+{
+    if (strlen(path) >= sizeof(captureAddress.sun_path)) {
+        printf("Audio tap: socket path too long: %s\n", path);
+        return false;
+    }
+    socketFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) {
+        perror("Audio tap: Unable to create socket.");
+        return false;
+    }
+    memset(&captureAddress, 0, sizeof(captureAddress));
+    captureAddress.sun_family = AF_UNIX;
+    strcpy(captureAddress.sun_path, path);
+    frameLength = length;
+    sampleRate = rate;
+    return true;
+}
+
+void audioTap_send(const int16_t* pcm, long long endUs)
+{
+    if (socketFd < 0 || endUs < retryUs) {
+        return;
+    }
+    audioTap_header header = {
+            .magic = AUDIO_TAP_MAGIC,
+            .sampleRate = (uint32_t) sampleRate,
+            .startUs = (uint64_t) (endUs - (long long) frameLength * 1000000 / sampleRate),
+    };
+    struct iovec parts[2] = {
+            {.iov_base = &header, .iov_len = sizeof(header)},
+            {.iov_base = (void*) pcm, .iov_len = (size_t) frameLength * sizeof(int16_t)},
+    };
+    struct msghdr message = {
+            .msg_name = &captureAddress,
+            .msg_namelen = sizeof(captureAddress),
+            .msg_iov = parts,
+            .msg_iovlen = 2,
+    };
+    if (sendmsg(socketFd, &message, 0) < 0) {
+        if (errno == ENOENT || errno == ECONNREFUSED) {
+            retryUs = endUs + RETRY_US;
+        } else if (errno != EAGAIN) {
+            perror("Audio tap: Unable to reach capture.");
+            retryUs = endUs + RETRY_US;
+        }
+    }
+}
+
+void audioTap_close(void)
+{
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef AUDIO_TAP_H
+#define AUDIO_TAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Shares the microphone with the camera's capture program, whose feed clips (capture.c --clips) then carry the sound
+// of the feed too: the spoken command and the fish. Every frame goes out as one datagram on a Unix socket that
+// capture binds, stamped with when its first sample was recorded on CLOCK_MONOTONIC, which both programs share, so
+// capture can line it up with its frames. Nothing waits for capture; frames are simply lost while it isn't running,
+// and while it isn't, the tap only tries again once a second.
+
+#define AUDIO_TAP_DEFAULT_PATH "/tmp/fishfeeder-audio.sock"
+#define AUDIO_TAP_MAGIC 0x31445541u // "AUD1" in memory
+
+// Each datagram: this header, then the frame's 16-bit mono samples, all in the board's own (little-endian) order.
+typedef struct {
+    uint32_t magic;
+    uint32_t sampleRate;
+    uint64_t startUs;
+} audioTap_header;
+
+bool audioTap_open(const char* path, int32_t frameLength, int32_t sampleRate);
+
+// On the inference thread. endUs is when the frame was complete, as inferencePipeline_frameQueuedUs gives it.
+void audioTap_send(const int16_t* pcm, long long endUs);
+
+void audioTap_close(void);
+
+#endif
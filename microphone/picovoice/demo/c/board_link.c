@@ -0,0 +1,103 @@
+#include "board_link.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t parsed = PTHREAD_COND_INITIALIZER;
+static bool isParsed = false;
+static int eventFd = -1;
+static char lines[BOARD_LINK_LINES][BOARD_LINK_LINE_SIZE];
+static int head = 0;
+static int count = 0;
+
+bool boardLink_open(void)
+{
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0) {
+        perror("Board link: Unable to create the eventfd.");
+        return false;
+    }
+    return true;
+}
+
+int boardLink_fd(void)
+{
+    return eventFd;
+}
+
+bool boardLink_send(const char* line)
+{
+    pthread_mutex_lock(&mutex);
+    if (eventFd < 0) {
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
+    if (count == BOARD_LINK_LINES) {
+        head = (head + 1) % BOARD_LINK_LINES;
+        count--;
+    }
+    char* slot = lines[(head + count) % BOARD_LINK_LINES];
+    snprintf(slot, BOARD_LINK_LINE_SIZE, "%s", line);
+    slot[strcspn(slot, "\n")] = '\0';
+    count++;
+    const uint64_t one = 1;
+    // EAGAIN only once the counter is near overflow, when the reader is due anyway
+    if (write(eventFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        perror("Board link: Unable to wake capture.");
+    }
+    pthread_mutex_unlock(&mutex);
+    return true;
+}
+
+bool boardLink_take(char* line, size_t size)
+{
+    pthread_mutex_lock(&mutex);
+    const bool isTaken = count > 0;
+    if (isTaken) {
+        snprintf(line, size, "%s", lines[head]);
+        head = (head + 1) % BOARD_LINK_LINES;
+        count--;
+    } else if (eventFd >= 0) {
+        // under the mutex, so a line sent after this sets it again
+        uint64_t pending;
+        if (read(eventFd, &pending, sizeof(pending)) < 0 && errno != EAGAIN) {
+            perror("Board link: Unable to clear the eventfd.");
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return isTaken;
+}
+
+void boardLink_optionsParsed(void)
+{
+    pthread_mutex_lock(&mutex);
+    isParsed = true;
+    pthread_cond_broadcast(&parsed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void boardLink_waitForOptions(void)
+{
+    pthread_mutex_lock(&mutex);
+    while (!isParsed) {
+        pthread_cond_wait(&parsed, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void boardLink_close(void)
+{
+    pthread_mutex_lock(&mutex);
+    if (eventFd >= 0) {
+        close(eventFd);
+        eventFd = -1;
+    }
+    head = count = 0;
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,35 @@
+#ifndef BOARD_LINK_H
+#define BOARD_LINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// The feeder's notices to the camera's capture program in fishfeeder, which runs both in one process. Apart, they are
+// datagrams: "feed" on feed_notifier.c's Unix socket, "cpu" and "thermal" to capture's UDP port. Together, the same
+// lines go through a ring of BOARD_LINK_LINES under a mutex, with an eventfd that capture watches in its epoll set, so
+// nothing crosses the kernel but the wakeup and nothing is lost to a full socket buffer. A full ring drops its oldest
+// line, a level the newer ones supersede. Until boardLink_open, as in picovoice_demo_mic, boardLink_send does nothing
+// and returns false, and the senders use their sockets.
+
+#define BOARD_LINK_LINES 32
+#define BOARD_LINK_LINE_SIZE 48
+
+bool boardLink_open(void);
+
+// Readable while lines are waiting; -1 if the link isn't open.
+int boardLink_fd(void);
+
+// Safe from any thread. False, having queued nothing, if the link isn't open.
+bool boardLink_send(const char* line);
+
+// For the one reader: the oldest line, its newline dropped, or false once none are left, which also clears the fd.
+bool boardLink_take(char* line, size_t size);
+
+// fishfeeder starts capture on a thread of its own, and the feeder only once capture has parsed its options, since
+// getopt's state is shared.
+void boardLink_optionsParsed(void);
+void boardLink_waitForOptions(void);
+
+void boardLink_close(void);
+
+#endif
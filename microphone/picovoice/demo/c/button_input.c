@@ -0,0 +1,89 @@
+#include "button_input.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "event_loop.h"
+#include "hal_gpio.h"
+#include "pru_link.h"
+
+static int gpio = -1;
+static int valueFd = -1;
+static int debounceFd = -1;
+static int stableValue = -1;
+static long long debounceMs = 50;
+static buttonInput_pressFunc pressFunc = NULL;
+
+static void onEdge(int fd, void* userData)
+{
+    (void) fd;
+    (void) userData;
+    // another edge inside the window restarts it
+    halGpio_ackEdge(gpio);
+    eventLoop_armTimer(debounceFd, debounceMs, 0);
+}
+
+// The line has been quiet for the debounce time.
+static void onSettled(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0) {
+        return;
+    }
+    int value = halGpio_read(gpio);
+    if (value == 1 && stableValue == 0) {
+        pressFunc();
+    }
+    if (value >= 0) {
+        stableValue = value;
+    }
+}
+
+bool buttonInput_start(int gpioNumber, long long debounceInMs, buttonInput_pressFunc onPress)
+{
+    uint32_t events = 0;
+    valueFd = halGpio_openInput(gpioNumber, &events);
+    if (valueFd < 0) {
+        return false;
+    }
+    debounceFd = eventLoop_createTimer();
+
+    gpio = gpioNumber;
+    debounceMs = debounceInMs > 0 ? debounceInMs : 1;
+    pressFunc = onPress;
+    stableValue = halGpio_read(gpio);
+    if (debounceFd < 0 ||
+        !eventLoop_add(valueFd, events, onEdge, NULL) ||
+        !eventLoop_add(debounceFd, EPOLLIN, onSettled, NULL)) {
+        buttonInput_stop();
+        return false;
+    }
+    eventLoop_setSubsystem(valueFd, "sensors");
+    eventLoop_setSubsystem(debounceFd, "sensors");
+    return true;
+}
+
+bool buttonInput_startPru(long long debounceInMs, buttonInput_pressFunc onPress)
+{
+    pruCommand command = {0};
+    command.type = PRU_COMMAND_CONFIGURE_BUTTON;
+    command.debounceMs = (uint32_t) (debounceInMs > 0 ? debounceInMs : 1);
+    pressFunc = onPress;
+    pruLink_setHandler(PRU_EVENT_BUTTON_PRESSED, onPress);
+    return pruLink_send(&command);
+}
+
+void buttonInput_stop(void)
+{
+    pruLink_setHandler(PRU_EVENT_BUTTON_PRESSED, NULL);
+    if (debounceFd >= 0) {
+        eventLoop_remove(debounceFd);
+        close(debounceFd);
+        debounceFd = -1;
+    }
+    if (valueFd >= 0) {
+        eventLoop_remove(valueFd);
+        halGpio_close(gpio);
+        valueFd = -1;
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <stdbool.h>
+
+// Edge-triggered push button on a GPIO input from hal_gpio. The line's descriptor is watched on the event loop, so an
+// idle button costs nothing; after an edge the line has to stay put for the debounce time (a one-shot timerfd) before a
+// change is believed.
+
+typedef void (*buttonInput_pressFunc)(void);
+
+// Exports the GPIO if needed and calls onPress on the event loop thread for every debounced press.
+bool buttonInput_start(int gpioNumber, long long debounceInMs, buttonInput_pressFunc onPress);
+
+// Instead of buttonInput_start, when the PRU0 firmware in pru/ samples the button: it does the debouncing and only
+// sends presses, which arrive through the PRU link. pruLink_start has to have succeeded.
+bool buttonInput_startPru(long long debounceInMs, buttonInput_pressFunc onPress);
+
+void buttonInput_stop(void);
+
+#endif
@@ -0,0 +1,183 @@
+#include "camera_governor.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "board_link.h"
+#include "inference_pipeline.h"
+
+#define WINDOW_MS 1000
+// a change of frame rate or size reopens the camera, so the next window has to show what it did
+#define HOLD_MS 3000
+// well within the budget means under half of it, for this long, before a step back up
+#define CLEAN_MS 15000
+// resent this often, so a capture.c started later hears it too
+#define REPORT_MS 5000
+#define FULL_WEIGHT 100
+
+static cameraGovernor_config governorConfig;
+static int reportFd = -1;
+static struct sockaddr_in camera;
+
+static long long windowStartUs = 0;
+static long long changedUs = 0;
+static long long cleanSinceUs = 0;
+static long long reportedUs = 0;
+static int windowMaxDepth = 0;
+static inferencePipeline_stats windowStart;
+static cameraGovernor_stats counters;
+
+static long long nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void report(long long now)
+{
+    char message[16];
+    const int length = snprintf(message, sizeof(message), "cpu %d\n", __atomic_load_n(&counters.level,
+            __ATOMIC_RELAXED));
+    // capture.c not running is not an error
+    if (!boardLink_send(message)) {
+        (void) sendto(reportFd, message, (size_t) length, 0, (const struct sockaddr*) &camera, sizeof(camera));
+    }
+    reportedUs = now;
+}
+
+static void setWeight(int level)
+{
+    if (!governorConfig.cgroupPath) {
+        return;
+    }
+    char path[256];
+    snprintf(path, sizeof(path), "%s/cpu.weight", governorConfig.cgroupPath);
+    const int fd = open(path, O_WRONLY | O_CLOEXEC);
+    char weight[16];
+    const int length = snprintf(weight, sizeof(weight), "%d\n", FULL_WEIGHT >> level > 0 ? FULL_WEIGHT >> level : 1);
+    if (fd < 0 || write(fd, weight, (size_t) length) != length) {
+        asyncLog_log(ASYNC_LOG_WARN, "Camera governor: Unable to set %s: %s", path, strerror(errno));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+static void setLevel(int level, long long now)
+{
+    const int from = __atomic_load_n(&counters.level, __ATOMIC_RELAXED);
+    __atomic_store_n(&counters.level, level, __ATOMIC_RELAXED);
+    if (level > __atomic_load_n(&counters.maxLevel, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&counters.maxLevel, level, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add((level > from) ? &counters.stepsDown : &counters.stepsUp, 1, __ATOMIC_RELAXED);
+    asyncLog_log(ASYNC_LOG_INFO, "Camera governor: %s to level %d, frames taking %lld ms",
+            (level > from) ? "camera stepped down" : "camera stepped up", level,
+            __atomic_load_n(&counters.latencyUs, __ATOMIC_RELAXED) / 1000);
+    changedUs = now;
+    setWeight(level);
+    report(now);
+}
+
+bool cameraGovernor_start(const cameraGovernor_config* config)
+{
+    if (config->budgetMs <= 0) {
+        printf("Camera governor: the latency budget has to be positive.\n");
+        return false;
+    }
+    governorConfig = *config;
+    memset(&counters, 0, sizeof(counters));
+    reportFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (reportFd < 0) {
+        perror("Camera governor: Unable to create the report socket.");
+        return false;
+    }
+    memset(&camera, 0, sizeof(camera));
+    camera.sin_family = AF_INET;
+    camera.sin_port = htons(CAMERA_GOVERNOR_PORT);
+    camera.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const long long now = nowUs();
+    windowStartUs = changedUs = cleanSinceUs = now;
+    windowMaxDepth = 0;
+    inferencePipeline_getStats(&windowStart);
+    // whatever a previous run left the camera at
+    setWeight(0);
+    report(now);
+    return true;
+}
+
+void cameraGovernor_poll(void)
+{
+    inferencePipeline_stats stats;
+    inferencePipeline_getStats(&stats);
+    if (stats.queueDepth > windowMaxDepth) {
+        windowMaxDepth = stats.queueDepth;
+    }
+    const long long now = nowUs();
+    if (now - windowStartUs < WINDOW_MS * 1000LL) {
+        return;
+    }
+
+    const long long frames = stats.processedFrames - windowStart.processedFrames;
+    const long long dropped = stats.droppedFrames - windowStart.droppedFrames;
+    const int maxDepth = windowMaxDepth;
+    const long long meanProcessUs = (frames > 0) ? (stats.totalProcessUs - windowStart.totalProcessUs) / frames : 0;
+    windowStart = stats;
+    windowStartUs = now;
+    windowMaxDepth = 0;
+    if (frames == 0 && dropped == 0) {
+        // no audio this second, so nothing to judge by
+        return;
+    }
+
+    // the last frame in the deepest queue waited for the ones ahead of it, then took its own turn
+    const long long latencyUs = (maxDepth + 1) * meanProcessUs;
+    __atomic_store_n(&counters.latencyUs, latencyUs, __ATOMIC_RELAXED);
+    const long long budgetUs = governorConfig.budgetMs * 1000LL;
+    const int level = __atomic_load_n(&counters.level, __ATOMIC_RELAXED);
+    if (latencyUs > budgetUs || dropped > 0) {
+        cleanSinceUs = now;
+        if (level < CAMERA_GOVERNOR_MAX_LEVEL && now - changedUs >= HOLD_MS * 1000LL) {
+            setLevel(level + 1, now);
+        }
+    } else if (latencyUs > budgetUs / 2) {
+        cleanSinceUs = now;
+    } else if (level > 0 && now - cleanSinceUs >= CLEAN_MS * 1000LL && now - changedUs >= CLEAN_MS * 1000LL) {
+        cleanSinceUs = now;
+        setLevel(level - 1, now);
+    }
+    if (now - reportedUs >= REPORT_MS * 1000LL) {
+        report(now);
+    }
+}
+
+void cameraGovernor_stop(void)
+{
+    if (reportFd < 0) {
+        return;
+    }
+    __atomic_store_n(&counters.level, 0, __ATOMIC_RELAXED);
+    setWeight(0);
+    report(nowUs());
+    close(reportFd);
+    reportFd = -1;
+}
+
+void cameraGovernor_getStats(cameraGovernor_stats* stats)
+{
+    stats->level = __atomic_load_n(&counters.level, __ATOMIC_RELAXED);
+    stats->maxLevel = __atomic_load_n(&counters.maxLevel, __ATOMIC_RELAXED);
+    stats->stepsDown = __atomic_load_n(&counters.stepsDown, __ATOMIC_RELAXED);
+    stats->stepsUp = __atomic_load_n(&counters.stepsUp, __ATOMIC_RELAXED);
+    stats->latencyUs = __atomic_load_n(&counters.latencyUs, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,45 @@
+#ifndef CAMERA_GOVERNOR_H
+#define CAMERA_GOVERNOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Keeps the voice path within its latency budget on a board it shares with the camera. Once a second it works out
+// what a frame sees between capture and the end of its processing, from the inference stage's queue depth and mean
+// processing time; while that is over the budget, or frames are dropped, the camera is asked to step down one more
+// level of capture.c's --adapt ladder (quality, then frame rate, then size), by a "cpu <level>" datagram to the port
+// capture.c --yield-cpu listens on. With a cgroup given, the camera's cgroup v2 cpu.weight is halved for every level
+// as well, which only holds it back while the two actually compete. After a long enough run well within the budget
+// it steps back up, one level at a time. The main thread polls it.
+
+#define CAMERA_GOVERNOR_PORT 3000
+#define CAMERA_GOVERNOR_MAX_LEVEL 5
+
+typedef struct {
+    // what a frame may take from capture to the end of its processing
+    int32_t budgetMs;
+    // the camera's cgroup v2 directory, or NULL to leave its CPU weight alone
+    const char* cgroupPath;
+} cameraGovernor_config;
+
+typedef struct {
+    int level;
+    int maxLevel;
+    long long stepsDown;
+    long long stepsUp;
+    // the last second's estimate
+    long long latencyUs;
+} cameraGovernor_stats;
+
+bool cameraGovernor_start(const cameraGovernor_config* config);
+
+// From the main thread, every 100 ms or so.
+void cameraGovernor_poll(void);
+
+// Gives the camera back its full quality and weight.
+void cameraGovernor_stop(void);
+
+// Safe from any thread.
+void cameraGovernor_getStats(cameraGovernor_stats* stats);
+
+#endif
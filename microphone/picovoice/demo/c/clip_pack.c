@@ -0,0 +1,278 @@
+#ifndef _POSIX_C_SOURCE
+// posix_madvise under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "clip_pack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+static bool isLittleEndian(void)
+{
+    const uint16_t one = 1;
+    return *(const uint8_t*) &one == 1;
+}
+
+bool clipPack_isPack(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(CLIP_PACK_MAGIC) - 1];
+    const bool isPack = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+            memcmp(magic, CLIP_PACK_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return isPack;
+}
+
+// Bounds only: every clip and string inside the file, so a reader can't run off the end of the mapping.
+static const char* validate(const clipPack* pack, int32_t sampleRate)
+{
+    const clipPackHeader* header = pack->base;
+    if (pack->size < CLIP_PACK_DATA_OFFSET || memcmp(header->magic, CLIP_PACK_MAGIC, sizeof(header->magic)) != 0) {
+        return "not a clip pack";
+    }
+    if (header->version != CLIP_PACK_VERSION) {
+        return "unsupported clip pack version";
+    }
+    if (header->sampleRate != (uint32_t) sampleRate) {
+        return "clip pack is at the wrong sample rate";
+    }
+    const uint64_t indexSize = (uint64_t) header->clipCount * sizeof(clipPackEntry);
+    if (header->fileSize != pack->size || header->indexOffset % 8 != 0 || header->indexOffset > pack->size ||
+            indexSize > pack->size - header->indexOffset || header->stringsOffset > pack->size ||
+            header->stringsSize > pack->size - header->stringsOffset || header->stringsSize == 0 ||
+            ((const char*) pack->base)[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        return "clip pack is truncated or corrupt";
+    }
+    const clipPackEntry* entries = (const clipPackEntry*) ((const uint8_t*) pack->base + header->indexOffset);
+    for (uint32_t i = 0; i < header->clipCount; i++) {
+        const clipPackEntry* entry = &entries[i];
+        if (entry->sampleOffset % CLIP_PACK_CLIP_ALIGNMENT != 0 || entry->sampleOffset > header->indexOffset ||
+                entry->sampleCount > (header->indexOffset - entry->sampleOffset) / sizeof(int16_t) ||
+                entry->pathOffset >= header->stringsSize ||
+                (entry->labelOffset != CLIP_PACK_NO_LABEL && entry->labelOffset >= header->stringsSize)) {
+            return "clip pack is truncated or corrupt";
+        }
+    }
+    return NULL;
+}
+
+const char* clipPack_open(const char* path, int32_t sampleRate, clipPack* pack)
+{
+    memset(pack, 0, sizeof(*pack));
+#if defined(_WIN32) || defined(_WIN64)
+    (void) path;
+    (void) sampleRate;
+    return "clip packs aren't supported on Windows";
+#else
+    if (!isLittleEndian()) {
+        return "clip packs are only read on little-endian hosts";
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return "failed to open clip pack";
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return "failed to open clip pack";
+    }
+    void* base = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return "failed to map clip pack";
+    }
+    pack->base = base;
+    pack->size = (size_t) info.st_size;
+    const char* error = validate(pack, sampleRate);
+    if (error) {
+        clipPack_close(pack);
+        return error;
+    }
+    const clipPackHeader* header = base;
+    pack->count = (int32_t) header->clipCount;
+    pack->entries = (const clipPackEntry*) ((const uint8_t*) base + header->indexOffset);
+    pack->strings = (const char*) base + header->stringsOffset;
+    // evaluation reads the clips front to back
+    posix_madvise(base, pack->size, POSIX_MADV_SEQUENTIAL);
+    return NULL;
+#endif
+}
+
+const int16_t* clipPack_samples(const clipPack* pack, int32_t clip, int64_t* sampleCount)
+{
+    const clipPackEntry* entry = &pack->entries[clip];
+    *sampleCount = (int64_t) entry->sampleCount;
+    return (const int16_t*) ((const uint8_t*) pack->base + entry->sampleOffset);
+}
+
+const char* clipPack_path(const clipPack* pack, int32_t clip)
+{
+    return pack->strings + pack->entries[clip].pathOffset;
+}
+
+const char* clipPack_label(const clipPack* pack, int32_t clip)
+{
+    const uint32_t offset = pack->entries[clip].labelOffset;
+    return (offset == CLIP_PACK_NO_LABEL) ? NULL : pack->strings + offset;
+}
+
+void clipPack_close(clipPack* pack)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (pack->base) {
+        munmap(pack->base, pack->size);
+    }
+#endif
+    memset(pack, 0, sizeof(*pack));
+}
+
+static void writeBytes(clipPackWriter* writer, const void* data, size_t size)
+{
+    if (writer->isOk && size > 0 && fwrite(data, 1, size, writer->file) != size) {
+        writer->isOk = false;
+    }
+    writer->offset += size;
+}
+
+static void writeZeros(clipPackWriter* writer, size_t size)
+{
+    static const uint8_t zeros[CLIP_PACK_CLIP_ALIGNMENT] = {0};
+    while (size > 0) {
+        const size_t chunk = (size < sizeof(zeros)) ? size : sizeof(zeros);
+        writeBytes(writer, zeros, chunk);
+        size -= chunk;
+    }
+}
+
+static void padTo(clipPackWriter* writer, uint64_t alignment)
+{
+    const uint64_t remainder = writer->offset % alignment;
+    if (remainder != 0) {
+        writeZeros(writer, (size_t) (alignment - remainder));
+    }
+}
+
+// Returns the string's offset in the strings section.
+static uint32_t addString(clipPackWriter* writer, const char* text)
+{
+    const size_t length = strlen(text) + 1;
+    if (writer->stringsSize + length > writer->stringsCapacity) {
+        size_t capacity = writer->stringsCapacity ? writer->stringsCapacity : 4096;
+        while (writer->stringsSize + length > capacity) {
+            capacity *= 2;
+        }
+        char* grown = realloc(writer->strings, capacity);
+        if (!grown) {
+            writer->isOk = false;
+            return CLIP_PACK_NO_LABEL;
+        }
+        writer->strings = grown;
+        writer->stringsCapacity = capacity;
+    }
+    const uint32_t offset = (uint32_t) writer->stringsSize;
+    memcpy(writer->strings + writer->stringsSize, text, length);
+    writer->stringsSize += length;
+    return offset;
+}
+
+bool clipPack_create(const char* path, int32_t sampleRate, clipPackWriter* writer)
+{
+    memset(writer, 0, sizeof(*writer));
+    if (!isLittleEndian()) {
+        printf("Clip pack: only written on little-endian hosts.\n");
+        return false;
+    }
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        perror("Clip pack: Unable to create.");
+        return false;
+    }
+    writer->sampleRate = sampleRate;
+    writer->isOk = true;
+    // the header is written over these once the index is in
+    writeZeros(writer, CLIP_PACK_DATA_OFFSET);
+    return writer->isOk;
+}
+
+void clipPack_beginClip(clipPackWriter* writer)
+{
+    padTo(writer, CLIP_PACK_CLIP_ALIGNMENT);
+    writer->clipStart = writer->offset;
+}
+
+bool clipPack_append(clipPackWriter* writer, const int16_t* samples, int32_t count)
+{
+    writeBytes(writer, samples, (size_t) count * sizeof(int16_t));
+    return writer->isOk;
+}
+
+bool clipPack_endClip(clipPackWriter* writer, const char* path, const char* label)
+{
+    if (writer->count == writer->capacity) {
+        const int32_t capacity = writer->capacity ? 2 * writer->capacity : 64;
+        clipPackEntry* grown = realloc(writer->entries, (size_t) capacity * sizeof(clipPackEntry));
+        if (!grown) {
+            writer->isOk = false;
+            return false;
+        }
+        writer->entries = grown;
+        writer->capacity = capacity;
+    }
+    clipPackEntry* entry = &writer->entries[writer->count++];
+    entry->sampleOffset = writer->clipStart;
+    entry->sampleCount = (writer->offset - writer->clipStart) / sizeof(int16_t);
+    entry->pathOffset = addString(writer, path);
+    entry->labelOffset = label ? addString(writer, label) : CLIP_PACK_NO_LABEL;
+    return writer->isOk;
+}
+
+bool clipPack_finish(clipPackWriter* writer)
+{
+    padTo(writer, 8);
+    clipPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CLIP_PACK_MAGIC, sizeof(header.magic));
+    header.version = CLIP_PACK_VERSION;
+    header.sampleRate = (uint32_t) writer->sampleRate;
+    header.clipCount = (uint32_t) writer->count;
+    header.indexOffset = writer->offset;
+    writeBytes(writer, writer->entries, (size_t) writer->count * sizeof(clipPackEntry));
+    if (writer->stringsSize == 0) {
+        // a pack of no clips still has a strings section to end in a NUL
+        addString(writer, "");
+    }
+    header.stringsOffset = writer->offset;
+    header.stringsSize = writer->stringsSize;
+    writeBytes(writer, writer->strings, writer->stringsSize);
+    header.fileSize = writer->offset;
+
+    rewind(writer->file);
+    if (writer->isOk && fwrite(&header, 1, sizeof(header), writer->file) != sizeof(header)) {
+        writer->isOk = false;
+    }
+    if (fclose(writer->file) != 0) {
+        writer->isOk = false;
+    }
+    writer->file = NULL;
+    free(writer->entries);
+    free(writer->strings);
+    writer->entries = NULL;
+    writer->strings = NULL;
+    if (!writer->isOk) {
+        printf("Clip pack: Unable to write.\n");
+    }
+    return writer->isOk;
+}
@@ -0,0 +1,90 @@
+#ifndef CLIP_PACK_H
+#define CLIP_PACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// A corpus decoded once into one file: 16-bit little-endian mono PCM at the engine's sample rate, each clip starting
+// on a cache line, followed by an index of where every clip starts and ends and the path and label it came from.
+// The file is mapped and read in place, so evaluating from a pack neither decodes, resamples nor parses anything.
+//
+// Layout: a 64-byte header, the samples from CLIP_PACK_DATA_OFFSET on, then the index, then the strings.
+
+#define CLIP_PACK_MAGIC "PVCLIPS1"
+#define CLIP_PACK_VERSION 1
+#define CLIP_PACK_DATA_OFFSET 4096
+#define CLIP_PACK_CLIP_ALIGNMENT 64
+// labelOffset of a clip without one
+#define CLIP_PACK_NO_LABEL 0xFFFFFFFFu
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t clipCount;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t fileSize;
+    uint8_t padding[8];
+} clipPackHeader;
+
+typedef struct {
+    // in bytes from the start of the file
+    uint64_t sampleOffset;
+    uint64_t sampleCount;
+    // in bytes from the start of the strings
+    uint32_t pathOffset;
+    uint32_t labelOffset;
+} clipPackEntry;
+
+typedef struct {
+    void* base;
+    size_t size;
+    int32_t count;
+    const clipPackEntry* entries;
+    const char* strings;
+} clipPack;
+
+// True if path starts like a pack; false, quietly, for anything else, audio files and manifests included.
+bool clipPack_isPack(const char* path);
+
+// Returns NULL, or why the pack can't be used.
+const char* clipPack_open(const char* path, int32_t sampleRate, clipPack* pack);
+
+const int16_t* clipPack_samples(const clipPack* pack, int32_t clip, int64_t* sampleCount);
+const char* clipPack_path(const clipPack* pack, int32_t clip);
+// NULL if the clip has no label.
+const char* clipPack_label(const clipPack* pack, int32_t clip);
+
+void clipPack_close(clipPack* pack);
+
+// Writes a pack front to back, a clip at a time; the header goes in last, so a pack cut short won't open.
+typedef struct {
+    FILE* file;
+    int32_t sampleRate;
+    uint64_t offset;
+    uint64_t clipStart;
+    clipPackEntry* entries;
+    int32_t count;
+    int32_t capacity;
+    char* strings;
+    size_t stringsSize;
+    size_t stringsCapacity;
+    bool isOk;
+} clipPackWriter;
+
+bool clipPack_create(const char* path, int32_t sampleRate, clipPackWriter* writer);
+
+void clipPack_beginClip(clipPackWriter* writer);
+bool clipPack_append(clipPackWriter* writer, const int16_t* samples, int32_t count);
+// label may be NULL.
+bool clipPack_endClip(clipPackWriter* writer, const char* path, const char* label);
+
+// Writes the index and the header and closes the file. Returns false if anything along the way failed.
+bool clipPack_finish(clipPackWriter* writer);
+
+#endif
@@ -0,0 +1,462 @@
+#include "command_capture.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "memory_budget.h"
+#include "pv_adpcm.h"
+#include "thread_cpu.h"
+
+#define REQUEST_QUEUE_LENGTH 8
+#define OUTCOME_LENGTH 24
+#define WAV_HEADER_LENGTH 44
+// beyond the pre-roll, so frames of a command still being spoken stay in the ring until the I/O thread copies them
+#define RING_SLACK_MS 2000
+// how often the I/O thread copies frames out while a capture is running; well inside the slack
+#define COPY_INTERVAL_MS 200
+
+static const char* const FILE_PREFIX = "command-";
+static const char* const FILE_SUFFIX = ".wav";
+
+typedef struct {
+    bool isBegin;
+    // begin: first frame of the capture; end: one past its last frame
+    long long frame;
+    struct timespec wallTime;
+    char outcome[OUTCOME_LENGTH];
+} captureRequest;
+
+static int32_t frameLength = 0;
+static int32_t sampleRate = 0;
+static commandCapture_config captureConfig;
+static int preRollFrames = 0;
+static int maxCommandFrames = 0;
+
+// written by the inference thread only; pushedFrames tells the I/O thread how far it may read
+static int16_t* ring = NULL;
+static int ringFrames = 0;
+static long long pushedFrames = 0;
+
+// inference thread only
+static bool isCapturing = false;
+static long long wakeFrame = 0;
+
+// single-producer single-consumer; head is only written by the inference thread, tail by the I/O thread
+static captureRequest requests[REQUEST_QUEUE_LENGTH];
+static unsigned int requestHead = 0;
+static unsigned int requestTail = 0;
+
+// I/O thread only
+static int16_t* captureFrames = NULL;
+// the capture as ADPCM blocks
+static uint8_t* encodedCapture = NULL;
+static int captureCapacity = 0;
+static int capturedFrames = 0;
+static bool isCollecting = false;
+static long long cursor = 0;
+// -1 until the end of the command is known
+static long long endFrame = -1;
+static struct timespec captureWallTime;
+static char captureOutcome[OUTCOME_LENGTH];
+
+static pthread_t threadIo;
+static bool isRunning = false;
+static bool stopping = false;
+// counts requests and the stop request; the I/O thread sleeps on it between captures
+static int wakeFd = -1;
+
+static commandCapture_stats counters;
+
+static void count(long long* counter, long long amount)
+{
+    __atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+static int framesForMs(int32_t ms)
+{
+    const long long samples = ((long long) ms * sampleRate) / 1000;
+    return (int) ((samples + frameLength - 1) / frameLength);
+}
+
+static void wake(void)
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Command capture: Unable to wake: %s", strerror(errno));
+    }
+}
+
+static bool postRequest(bool isBegin, long long frame, const char* outcome)
+{
+    const unsigned int head = requestHead;
+    if (head - __atomic_load_n(&requestTail, __ATOMIC_ACQUIRE) >= REQUEST_QUEUE_LENGTH) {
+        return false;
+    }
+    captureRequest* request = &requests[head % REQUEST_QUEUE_LENGTH];
+    request->isBegin = isBegin;
+    request->frame = frame;
+    clock_gettime(CLOCK_REALTIME, &request->wallTime);
+    snprintf(request->outcome, sizeof(request->outcome), "%s", outcome);
+    __atomic_store_n(&requestHead, head + 1, __ATOMIC_RELEASE);
+    wake();
+    return true;
+}
+
+static int16_t* ringFrame(long long frame)
+{
+    return &ring[(frame % ringFrames) * frameLength];
+}
+
+// Copies what has been pushed since the last call, up to the end of the command, into the capture.
+static void collect(void)
+{
+    const long long pushed = __atomic_load_n(&pushedFrames, __ATOMIC_ACQUIRE);
+    const long long last = (endFrame >= 0 && endFrame < pushed) ? endFrame : pushed;
+    // the slot of the oldest frame is the one being overwritten by the next push
+    const long long oldest = pushed - ringFrames + 1;
+    if (cursor < oldest) {
+        count(&counters.lostFrames, oldest - cursor);
+        cursor = oldest;
+    }
+    while (cursor < last && capturedFrames < captureCapacity) {
+        memcpy(&captureFrames[(size_t) capturedFrames * frameLength], ringFrame(cursor),
+                (size_t) frameLength * sizeof(int16_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&pushedFrames, __ATOMIC_RELAXED) - cursor < ringFrames) {
+            capturedFrames++;
+        } else {
+            count(&counters.lostFrames, 1);
+        }
+        cursor++;
+    }
+}
+
+static void putLe16(uint8_t* bytes, uint16_t value)
+{
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+}
+
+static void putLe32(uint8_t* bytes, uint32_t value)
+{
+    putLe16(bytes, (uint16_t) value);
+    putLe16(bytes + 2, (uint16_t) (value >> 16));
+}
+
+static void wavHeader(uint8_t* header, uint32_t dataBytes)
+{
+    memcpy(header, "RIFF", 4);
+    putLe32(header + 4, 36 + dataBytes);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    putLe32(header + 16, 16);
+    // PCM, mono
+    putLe16(header + 20, 1);
+    putLe16(header + 22, 1);
+    putLe32(header + 24, (uint32_t) sampleRate);
+    putLe32(header + 28, (uint32_t) sampleRate * sizeof(int16_t));
+    putLe16(header + 32, sizeof(int16_t));
+    putLe16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    putLe32(header + 40, dataBytes);
+}
+
+static long long adpcmBytes(long long samples)
+{
+    const int32_t blockSamples = pv_adpcm_samples_per_block(PV_ADPCM_DEFAULT_BLOCK_ALIGN);
+    return ((samples + blockSamples - 1) / blockSamples) * PV_ADPCM_DEFAULT_BLOCK_ALIGN;
+}
+
+// Encodes the capture into encodedCapture and returns how many bytes it takes.
+static uint32_t encodeCapture(int32_t samples)
+{
+    const int32_t blockSamples = pv_adpcm_samples_per_block(PV_ADPCM_DEFAULT_BLOCK_ALIGN);
+    pv_adpcm_encoder_t encoder;
+    pv_adpcm_encoder_init(&encoder);
+    uint32_t bytes = 0;
+    for (int32_t i = 0; i < samples; i += blockSamples) {
+        const int32_t n = (samples - i < blockSamples) ? samples - i : blockSamples;
+        pv_adpcm_encode_block(&encoder, &captureFrames[i], n, encodedCapture + bytes);
+        bytes += (uint32_t) pv_adpcm_block_length(n);
+    }
+    return bytes;
+}
+
+static bool isCaptureFile(const char* name)
+{
+    const size_t length = strlen(name);
+    const size_t prefixLength = strlen(FILE_PREFIX);
+    const size_t suffixLength = strlen(FILE_SUFFIX);
+    return length > prefixLength + suffixLength && strncmp(name, FILE_PREFIX, prefixLength) == 0 &&
+            strcmp(name + length - suffixLength, FILE_SUFFIX) == 0;
+}
+
+// Deletes the oldest captures until bytes more fit in the quota. The names sort by time, so the oldest is the first.
+static bool makeRoom(long long bytes)
+{
+    if (bytes > captureConfig.quotaBytes) {
+        return false;
+    }
+    while (true) {
+        DIR* dir = opendir(captureConfig.directory);
+        if (!dir) {
+            return false;
+        }
+        long long totalBytes = 0;
+        char oldest[NAME_MAX + 1] = "";
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            struct stat info;
+            if (!isCaptureFile(entry->d_name) || fstatat(dirfd(dir), entry->d_name, &info, 0) != 0) {
+                continue;
+            }
+            totalBytes += info.st_size;
+            if (oldest[0] == '\0' || strcmp(entry->d_name, oldest) < 0) {
+                snprintf(oldest, sizeof(oldest), "%s", entry->d_name);
+            }
+        }
+        const bool isRemoved = (totalBytes + bytes > captureConfig.quotaBytes) &&
+                (unlinkat(dirfd(dir), oldest, 0) == 0);
+        closedir(dir);
+        if (totalBytes + bytes <= captureConfig.quotaBytes) {
+            return true;
+        }
+        if (!isRemoved) {
+            return false;
+        }
+        count(&counters.deleted, 1);
+    }
+}
+
+static void writeCapture(void)
+{
+    const int32_t samples = capturedFrames * frameLength;
+    const uint32_t dataBytes = captureConfig.isAdpcm ? encodeCapture(samples) : (uint32_t) samples * sizeof(int16_t);
+    const size_t headerLength = captureConfig.isAdpcm ? PV_ADPCM_WAV_HEADER_LENGTH : WAV_HEADER_LENGTH;
+    isCollecting = false;
+    if (dataBytes == 0 || !makeRoom((long long) (headerLength + dataBytes))) {
+        count(&counters.skipped, 1);
+        return;
+    }
+
+    struct tm startedAt;
+    localtime_r(&captureWallTime.tv_sec, &startedAt);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s%04d%02d%02d-%02d%02d%02d-%03ld-%s%s", captureConfig.directory, FILE_PREFIX,
+            startedAt.tm_year + 1900, startedAt.tm_mon + 1, startedAt.tm_mday, startedAt.tm_hour, startedAt.tm_min,
+            startedAt.tm_sec, captureWallTime.tv_nsec / 1000000, captureOutcome, FILE_SUFFIX);
+
+    uint8_t header[PV_ADPCM_WAV_HEADER_LENGTH];
+    if (captureConfig.isAdpcm) {
+        pv_adpcm_wav_header(sampleRate, PV_ADPCM_DEFAULT_BLOCK_ALIGN, (uint32_t) samples, dataBytes, header);
+    } else {
+        wavHeader(header, dataBytes);
+    }
+    void* data = captureConfig.isAdpcm ? (void*) encodedCapture : (void*) captureFrames;
+    struct iovec parts[2] = {{header, headerLength}, {data, dataBytes}};
+    const int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    const bool isWritten = (fd >= 0) && (writev(fd, parts, 2) == (ssize_t) (headerLength + dataBytes));
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!isWritten) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Command capture: Unable to write '%s': %s", path, strerror(errno));
+        unlink(path);
+        count(&counters.skipped, 1);
+        return;
+    }
+    count(&counters.written, 1);
+}
+
+static void takeRequests(void)
+{
+    unsigned int tail = requestTail;
+    while (tail != __atomic_load_n(&requestHead, __ATOMIC_ACQUIRE)) {
+        const captureRequest* request = &requests[tail % REQUEST_QUEUE_LENGTH];
+        if (request->isBegin) {
+            if (isCollecting) {
+                // its end didn't fit in the queue
+                collect();
+                writeCapture();
+            }
+            isCollecting = true;
+            cursor = request->frame;
+            endFrame = -1;
+            capturedFrames = 0;
+            captureWallTime = request->wallTime;
+            snprintf(captureOutcome, sizeof(captureOutcome), "incomplete");
+        } else if (isCollecting) {
+            endFrame = request->frame;
+            snprintf(captureOutcome, sizeof(captureOutcome), "%s", request->outcome);
+        }
+        __atomic_store_n(&requestTail, ++tail, __ATOMIC_RELEASE);
+
+        if (isCollecting) {
+            collect();
+            if (endFrame >= 0 && cursor >= endFrame) {
+                writeCapture();
+            }
+        }
+    }
+}
+
+static void* runIo(void* arg)
+{
+    (void) arg;
+    while (true) {
+        struct pollfd wakeEvent = {wakeFd, POLLIN, 0};
+        if (poll(&wakeEvent, 1, isCollecting ? COPY_INTERVAL_MS : -1) < 0 && errno != EINTR) {
+            perror("Command capture: Unable to wait for requests.");
+            break;
+        }
+        uint64_t wakes;
+        if (read(wakeFd, &wakes, sizeof(wakes)) < 0 && errno != EAGAIN && errno != EINTR) {
+            perror("Command capture: Unable to wait for requests.");
+            break;
+        }
+
+        takeRequests();
+        if (isCollecting) {
+            collect();
+            if (capturedFrames == captureCapacity) {
+                snprintf(captureOutcome, sizeof(captureOutcome), "timeout");
+                writeCapture();
+            }
+        }
+        if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+            takeRequests();
+            if (isCollecting) {
+                // nothing more is pushed once stopping
+                endFrame = __atomic_load_n(&pushedFrames, __ATOMIC_ACQUIRE);
+                collect();
+                snprintf(captureOutcome, sizeof(captureOutcome), "stopped");
+                writeCapture();
+            }
+            break;
+        }
+    }
+    return NULL;
+}
+
+bool commandCapture_start(int32_t length, int32_t rate, const commandCapture_config* config)
+{
+    frameLength = length;
+    sampleRate = rate;
+    captureConfig = *config;
+    preRollFrames = framesForMs(config->preRollMs);
+    maxCommandFrames = framesForMs(config->maxCommandMs);
+    ringFrames = preRollFrames + framesForMs(RING_SLACK_MS);
+    captureCapacity = preRollFrames + maxCommandFrames;
+    pushedFrames = 0;
+    isCapturing = false;
+    requestHead = 0;
+    requestTail = 0;
+    isCollecting = false;
+    stopping = false;
+    memset(&counters, 0, sizeof(counters));
+
+    if (mkdir(config->directory, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Command capture: Unable to create '%s': %s\n", config->directory, strerror(errno));
+        return false;
+    }
+    // allocated and touched up front, so they are resident before memory is locked
+    ring = malloc((size_t) ringFrames * frameLength * sizeof(int16_t));
+    captureFrames = malloc((size_t) captureCapacity * frameLength * sizeof(int16_t));
+    const long long encodedBytes = config->isAdpcm ? adpcmBytes((long long) captureCapacity * frameLength) : 0;
+    encodedCapture = config->isAdpcm ? malloc((size_t) encodedBytes) : NULL;
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (!ring || !captureFrames || (config->isAdpcm && !encodedCapture) || wakeFd < 0) {
+        printf("Command capture: Unable to allocate the ring.\n");
+        commandCapture_stop();
+        return false;
+    }
+    memset(ring, 0, (size_t) ringFrames * frameLength * sizeof(int16_t));
+    memset(captureFrames, 0, (size_t) captureCapacity * frameLength * sizeof(int16_t));
+    if (encodedCapture) {
+        memset(encodedCapture, 0, (size_t) encodedBytes);
+    }
+    memoryBudget_add("command capture", (long long) (ringFrames + captureCapacity) * frameLength * sizeof(int16_t) +
+            encodedBytes, true);
+    // at normal priority: the disk is its only deadline
+    if (pthread_create(&threadIo, NULL, runIo, NULL) != 0) {
+        printf("Command capture: Unable to start the I/O thread.\n");
+        commandCapture_stop();
+        return false;
+    }
+    isRunning = true;
+    threadCpu_setName(threadIo, "capture-io");
+    return true;
+}
+
+void commandCapture_push(const int16_t* pcm)
+{
+    const long long frame = pushedFrames;
+    memcpy(ringFrame(frame), pcm, (size_t) frameLength * sizeof(int16_t));
+    __atomic_store_n(&pushedFrames, frame + 1, __ATOMIC_RELEASE);
+    if (isCapturing && frame + 1 - wakeFrame >= maxCommandFrames) {
+        commandCapture_end("timeout");
+    }
+}
+
+void commandCapture_begin(void)
+{
+    if (isCapturing) {
+        return;
+    }
+    wakeFrame = pushedFrames;
+    const long long start = (wakeFrame > preRollFrames) ? wakeFrame - preRollFrames : 0;
+    isCapturing = postRequest(true, start, "");
+    if (!isCapturing) {
+        count(&counters.skipped, 1);
+    }
+}
+
+void commandCapture_end(const char* outcome)
+{
+    if (!isCapturing) {
+        return;
+    }
+    isCapturing = false;
+    // if the queue is full, the I/O thread ends the capture when it is full or the next one begins
+    postRequest(false, pushedFrames, outcome);
+}
+
+void commandCapture_stop(void)
+{
+    if (isRunning) {
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        wake();
+        pthread_join(threadIo, NULL);
+        isRunning = false;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    free(ring);
+    ring = NULL;
+    free(captureFrames);
+    captureFrames = NULL;
+    free(encodedCapture);
+    encodedCapture = NULL;
+}
+
+void commandCapture_getStats(commandCapture_stats* stats)
+{
+    stats->written = __atomic_load_n(&counters.written, __ATOMIC_RELAXED);
+    stats->skipped = __atomic_load_n(&counters.skipped, __ATOMIC_RELAXED);
+    stats->deleted = __atomic_load_n(&counters.deleted, __ATOMIC_RELAXED);
+    stats->lostFrames = __atomic_load_n(&counters.lostFrames, __ATOMIC_RELAXED);
+}
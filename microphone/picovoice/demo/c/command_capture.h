@@ -0,0 +1,58 @@
+#ifndef COMMAND_CAPTURE_H
+#define COMMAND_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Keeps the audio of every spoken command for field debugging. The inference thread copies each frame into a
+// preallocated ring holding the last few seconds. A wake word marks a capture's start that far back, and the
+// command's inference marks its end. An I/O thread of its own copies the frames out of the ring as they arrive and
+// writes the whole capture as one WAV file with a single writev. The oldest captures in the directory are deleted to
+// stay within the quota. Nothing on the inference thread waits for the I/O thread or the disk; a capture the I/O
+// thread can't keep up with loses frames instead. Captures can be written as IMA-ADPCM (pv_adpcm.h), encoded by the
+// I/O thread into a buffer set aside for the longest capture, so four times as many fit in the quota.
+
+#define COMMAND_CAPTURE_DEFAULT_PRE_ROLL_MS 5000
+// a command with no inference by then is written out as it is
+#define COMMAND_CAPTURE_DEFAULT_MAX_COMMAND_MS 10000
+#define COMMAND_CAPTURE_DEFAULT_QUOTA_BYTES (64LL * 1024 * 1024)
+
+typedef struct {
+    // written to as command-YYYYmmdd-HHMMSS-mmm-OUTCOME.wav
+    const char* directory;
+    int32_t preRollMs;
+    int32_t maxCommandMs;
+    // the captures in the directory together stay within this
+    long long quotaBytes;
+    bool isAdpcm;
+} commandCapture_config;
+
+typedef struct {
+    long long written;
+    // not started because too many were pending, or not written because of the quota or an I/O error
+    long long skipped;
+    // deleted to make room for newer ones
+    long long deleted;
+    // frames overwritten in the ring before the I/O thread copied them
+    long long lostFrames;
+} commandCapture_stats;
+
+bool commandCapture_start(int32_t frameLength, int32_t sampleRate, const commandCapture_config* config);
+
+// Every frame, in order, on the inference thread. Never blocks.
+void commandCapture_push(const int16_t* pcm);
+
+// On the inference thread, after the frame with the wake word has been pushed. Ignored while a capture is running.
+void commandCapture_begin(void);
+
+// On the inference thread, after the frame that ended the command has been pushed. outcome goes into the file name,
+// e.g. "understood"; ignored if no capture is running.
+void commandCapture_end(const char* outcome);
+
+// Writes out a capture still running, then joins the I/O thread.
+void commandCapture_stop(void);
+
+// Safe from any thread; fields may be from slightly different instants.
+void commandCapture_getStats(commandCapture_stats* stats);
+
+#endif
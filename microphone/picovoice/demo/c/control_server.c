@@ -0,0 +1,515 @@
+#ifndef _GNU_SOURCE
+// accept4
+#define _GNU_SOURCE
+#endif
+
+#include "control_server.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+typedef struct {
+    const char* method;
+    const char* path;
+    // NULL for a stream
+    controlServer_handler handler;
+} route;
+
+typedef struct {
+    int fd;
+    // CLOCK_MONOTONIC, by when the response has to be out
+    long long deadlineMs;
+    size_t received;
+    char request[CONTROL_SERVER_REQUEST_SIZE + 1];
+    // once set, the client is only written to
+    bool isAnswered;
+    // subscribed to controlServer_publish; has no deadline
+    bool isStream;
+    // the epoll mask it is watched with
+    unsigned int watchedEvents;
+    // for a stream, the lines it hasn't taken yet
+    size_t sent;
+    size_t responseLength;
+    char response[CONTROL_SERVER_RESPONSE_SIZE + 160];
+} client;
+
+static route routes[CONTROL_SERVER_MAX_ROUTES];
+static int routeCount = 0;
+static client clients[CONTROL_SERVER_MAX_CLIENTS];
+static bool isOpen = false;
+static int listenFd = -1;
+// drops clients past their deadline; armed while any is waiting on a response
+static int sweepTimerFd = -1;
+static char socketPath[sizeof(((struct sockaddr_un*) NULL)->sun_path)];
+
+static long long nowMs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static const char* reasonOf(int status)
+{
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 503: return "Service Unavailable";
+        default: return "Internal Server Error";
+    }
+}
+
+static int requestCount(void)
+{
+    int count = 0;
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        count += (clients[i].fd >= 0 && !clients[i].isStream);
+    }
+    return count;
+}
+
+static void dropClient(client* peer)
+{
+    eventLoop_remove(peer->fd);
+    close(peer->fd);
+    peer->fd = -1;
+    if (requestCount() == 0) {
+        eventLoop_armTimer(sweepTimerFd, 0, 0);
+    }
+}
+
+static void onClient(int fd, void* userData);
+
+static bool watch(client* peer, unsigned int events)
+{
+    if (peer->watchedEvents == events) {
+        return true;
+    }
+    eventLoop_remove(peer->fd);
+    peer->watchedEvents = events;
+    if (!eventLoop_add(peer->fd, events, onClient, peer)) {
+        close(peer->fd);
+        peer->fd = -1;
+        return false;
+    }
+    eventLoop_setSubsystem(peer->fd, "control");
+    return true;
+}
+
+// Sends what the socket takes now; the rest goes out as epoll reports room for it. A response ends the connection,
+// a stream waits for the next line.
+static void flush(client* peer)
+{
+    while (peer->sent < peer->responseLength) {
+        const ssize_t written = send(peer->fd, peer->response + peer->sent, peer->responseLength - peer->sent,
+                MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                dropClient(peer);
+            } else {
+                watch(peer, EPOLLOUT);
+            }
+            return;
+        }
+        peer->sent += (size_t) written;
+    }
+    if (!peer->isStream) {
+        dropClient(peer);
+        return;
+    }
+    peer->sent = 0;
+    peer->responseLength = 0;
+    // only to hear it hang up
+    watch(peer, EPOLLIN);
+}
+
+static void respond(client* peer, int status, const char* body)
+{
+    const size_t bodyLength = strlen(body);
+    const int length = snprintf(peer->response, sizeof(peer->response),
+            "HTTP/1.0 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n%s",
+            status, reasonOf(status), bodyLength, body);
+    peer->responseLength = (length < (int) sizeof(peer->response)) ? (size_t) length : sizeof(peer->response) - 1;
+    peer->sent = 0;
+    peer->isAnswered = true;
+    flush(peer);
+}
+
+static void startStream(client* peer)
+{
+    static const char headers[] = "HTTP/1.0 200 OK\r\nContent-Type: application/x-ndjson\r\nCache-Control: no-store\r\n\r\n";
+    memcpy(peer->response, headers, sizeof(headers) - 1);
+    peer->responseLength = sizeof(headers) - 1;
+    peer->sent = 0;
+    peer->isAnswered = true;
+    peer->isStream = true;
+    if (requestCount() == 0) {
+        eventLoop_armTimer(sweepTimerFd, 0, 0);
+    }
+    flush(peer);
+}
+
+static void dispatch(client* peer, char* body)
+{
+    // e.g. "POST /feed?mode=0 HTTP/1.0"
+    char* method = peer->request;
+    char* target = strchr(method, ' ');
+    if (target == NULL) {
+        respond(peer, 400, "{\"error\":\"bad request line\"}");
+        return;
+    }
+    *target++ = '\0';
+    char* end = strpbrk(target, " \r\n");
+    if (end != NULL) {
+        *end = '\0';
+    }
+    char* params = strchr(target, '?');
+    if (params != NULL) {
+        *params++ = '\0';
+    }
+    if (params == NULL || *params == '\0') {
+        params = body;
+    }
+
+    bool isPathKnown = false;
+    for (int i = 0; i < routeCount; i++) {
+        if (strcmp(routes[i].path, target) != 0) {
+            continue;
+        }
+        isPathKnown = true;
+        if (strcmp(routes[i].method, method) == 0 && routes[i].handler == NULL) {
+            startStream(peer);
+            return;
+        }
+        if (strcmp(routes[i].method, method) == 0) {
+            char json[CONTROL_SERVER_RESPONSE_SIZE];
+            json[0] = '\0';
+            const int status = routes[i].handler(params, json, sizeof(json));
+            respond(peer, status, json);
+            return;
+        }
+    }
+    respond(peer, isPathKnown ? 405 : 404, isPathKnown ? "{\"error\":\"method not allowed\"}"
+            : "{\"error\":\"no such endpoint\"}");
+}
+
+// Dispatches once the headers, and the body they announce, are in.
+static void receive(client* peer)
+{
+    const ssize_t n = recv(peer->fd, peer->request + peer->received, CONTROL_SERVER_REQUEST_SIZE - peer->received, 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        dropClient(peer);
+        return;
+    }
+    if (n < 0) {
+        return;
+    }
+    peer->received += (size_t) n;
+    peer->request[peer->received] = '\0';
+
+    char* headersEnd = strstr(peer->request, "\r\n\r\n");
+    if (headersEnd == NULL) {
+        if (peer->received == CONTROL_SERVER_REQUEST_SIZE) {
+            respond(peer, 413, "{\"error\":\"request too large\"}");
+        }
+        return;
+    }
+    char* body = headersEnd + 4;
+    size_t contentLength = 0;
+    for (char* line = strstr(peer->request, "\r\n"); line != NULL && line < headersEnd;
+            line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) {
+            contentLength = strtoul(line + 17, NULL, 10);
+        }
+    }
+    if ((size_t) (body - peer->request) + contentLength > CONTROL_SERVER_REQUEST_SIZE) {
+        respond(peer, 413, "{\"error\":\"request too large\"}");
+        return;
+    }
+    if (peer->received < (size_t) (body - peer->request) + contentLength) {
+        return;
+    }
+    body[contentLength] = '\0';
+    dispatch(peer, body);
+}
+
+// A stream client has nothing to say; whatever it sends is thrown away until it hangs up.
+static void discard(client* peer)
+{
+    char ignored[256];
+    const ssize_t n = recv(peer->fd, ignored, sizeof(ignored), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        dropClient(peer);
+    }
+}
+
+static void onClient(int fd, void* userData)
+{
+    (void) fd;
+    client* peer = userData;
+    if (peer->isStream && peer->watchedEvents == EPOLLIN) {
+        discard(peer);
+    } else if (peer->isAnswered) {
+        flush(peer);
+    } else {
+        receive(peer);
+    }
+}
+
+static void onConnect(int fd, void* userData)
+{
+    (void) userData;
+    while (true) {
+        const int clientFd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED) {
+                asyncLog_log(ASYNC_LOG_WARN, "Control server: Unable to accept: %s", strerror(errno));
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+        client* peer = NULL;
+        for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS && peer == NULL; i++) {
+            if (clients[i].fd < 0) {
+                peer = &clients[i];
+            }
+        }
+        if (peer == NULL) {
+            // one try, whatever the socket takes; a busy server doesn't wait on the client it turns away
+            static const char busy[] = "HTTP/1.0 503 Service Unavailable\r\nContent-Length: 0\r\n"
+                    "Connection: close\r\n\r\n";
+            if (send(clientFd, busy, sizeof(busy) - 1, MSG_NOSIGNAL) < 0) {
+                asyncLog_log(ASYNC_LOG_DEBUG, "Control server: Unable to turn a client away: %s", strerror(errno));
+            }
+            close(clientFd);
+            continue;
+        }
+        if (!eventLoop_add(clientFd, EPOLLIN, onClient, peer)) {
+            close(clientFd);
+            continue;
+        }
+        eventLoop_setSubsystem(clientFd, "control");
+        if (requestCount() == 0) {
+            eventLoop_armTimer(sweepTimerFd, CONTROL_SERVER_TIMEOUT_MS / 2, CONTROL_SERVER_TIMEOUT_MS / 2);
+        }
+        peer->fd = clientFd;
+        peer->deadlineMs = nowMs() + CONTROL_SERVER_TIMEOUT_MS;
+        peer->received = 0;
+        peer->isAnswered = false;
+        peer->isStream = false;
+        peer->watchedEvents = EPOLLIN;
+    }
+}
+
+static void onSweep(int fd, void* userData)
+{
+    (void) userData;
+    eventLoop_readTimer(fd);
+    const long long now = nowMs();
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0 && !clients[i].isStream && now > clients[i].deadlineMs) {
+            asyncLog_log(ASYNC_LOG_DEBUG, "Control server: dropped a client that took over %d ms.",
+                    CONTROL_SERVER_TIMEOUT_MS);
+            dropClient(&clients[i]);
+        }
+    }
+}
+
+bool controlServer_addRoute(const char* method, const char* path, controlServer_handler handler)
+{
+    if (routeCount == CONTROL_SERVER_MAX_ROUTES) {
+        return false;
+    }
+    routes[routeCount++] = (route) {method, path, handler};
+    return true;
+}
+
+bool controlServer_addStream(const char* path)
+{
+    return controlServer_addRoute("GET", path, NULL);
+}
+
+void controlServer_publish(const char* line)
+{
+    const size_t length = strlen(line);
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        client* peer = &clients[i];
+        if (peer->fd < 0 || !peer->isStream) {
+            continue;
+        }
+        if (peer->sent > 0) {
+            memmove(peer->response, peer->response + peer->sent, peer->responseLength - peer->sent);
+            peer->responseLength -= peer->sent;
+            peer->sent = 0;
+        }
+        if (peer->responseLength + length + 1 > sizeof(peer->response)) {
+            asyncLog_log(ASYNC_LOG_WARN, "Control server: dropped an event stream client that fell behind.");
+            dropClient(peer);
+            continue;
+        }
+        memcpy(peer->response + peer->responseLength, line, length);
+        peer->response[peer->responseLength + length] = '\n';
+        peer->responseLength += length + 1;
+        flush(peer);
+    }
+}
+
+// Starts serving on listenFd, which listens at path.
+static bool serve(const char* path)
+{
+    sweepTimerFd = eventLoop_createTimer();
+    if (sweepTimerFd < 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Control server: Unable to create the sweep timer: %s", strerror(errno));
+        controlServer_close();
+        return false;
+    }
+    snprintf(socketPath, sizeof(socketPath), "%s", path);
+    if (!eventLoop_add(listenFd, EPOLLIN, onConnect, NULL) || !eventLoop_add(sweepTimerFd, EPOLLIN, onSweep, NULL)) {
+        controlServer_close();
+        return false;
+    }
+    eventLoop_setSubsystem(listenFd, "control");
+    eventLoop_setSubsystem(sweepTimerFd, "control");
+    return true;
+}
+
+bool controlServer_open(const char* path)
+{
+    isOpen = true;
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (snprintf(address.sun_path, sizeof(address.sun_path), "%s", path) >= (int) sizeof(address.sun_path)) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Control server: Unable to bind %s: path too long", path);
+        return false;
+    }
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Control server: Unable to create socket: %s", strerror(errno));
+        controlServer_close();
+        return false;
+    }
+    // left over from an earlier run
+    unlink(address.sun_path);
+    if (bind(listenFd, (struct sockaddr*) &address, sizeof(address)) != 0
+            || listen(listenFd, CONTROL_SERVER_MAX_CLIENTS) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Control server: Unable to listen on %s: %s", path, strerror(errno));
+        controlServer_close();
+        return false;
+    }
+    return serve(address.sun_path);
+}
+
+bool controlServer_adopt(int fd, const char* path)
+{
+    isOpen = true;
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+    // still non-blocking: the flag belongs to the socket, not to the process that set it
+    listenFd = fd;
+    return serve(path);
+}
+
+int controlServer_release(void)
+{
+    if (listenFd < 0) {
+        return -1;
+    }
+    // whoever connects from here on waits in the backlog for the new feeder
+    eventLoop_remove(listenFd);
+    socketPath[0] = '\0';
+    return listenFd;
+}
+
+bool controlServer_getParam(const char* params, const char* name, char* value, size_t size)
+{
+    const size_t nameLength = strlen(name);
+    for (const char* pair = params; pair != NULL && *pair != '\0'; pair = strchr(pair, '&')) {
+        if (*pair == '&') {
+            pair++;
+        }
+        if (strncmp(pair, name, nameLength) != 0 || pair[nameLength] != '=') {
+            continue;
+        }
+        const char* start = pair + nameLength + 1;
+        const size_t length = strcspn(start, "&");
+        if (length >= size) {
+            return false;
+        }
+        memcpy(value, start, length);
+        value[length] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool controlServer_getInt(const char* params, const char* name, long long min, long long max, long long* value)
+{
+    char text[24];
+    if (!controlServer_getParam(params, name, text, sizeof(text))) {
+        return false;
+    }
+    char* end = NULL;
+    errno = 0;
+    const long long parsed = strtoll(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed < min || parsed > max) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+void controlServer_close(void)
+{
+    if (!isOpen) {
+        return;
+    }
+    isOpen = false;
+    for (int i = 0; i < CONTROL_SERVER_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            eventLoop_remove(clients[i].fd);
+            close(clients[i].fd);
+            clients[i].fd = -1;
+        }
+    }
+    if (sweepTimerFd >= 0) {
+        eventLoop_remove(sweepTimerFd);
+        close(sweepTimerFd);
+        sweepTimerFd = -1;
+    }
+    if (listenFd >= 0) {
+        eventLoop_remove(listenFd);
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (socketPath[0] != '\0') {
+        unlink(socketPath);
+        socketPath[0] = '\0';
+    }
+}
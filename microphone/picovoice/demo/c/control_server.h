@@ -0,0 +1,57 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Lets local programs, e.g. the camera's web app, drive the feeder: HTTP/1.0 on a Unix socket, served from the event
+// loop. Sockets are non-blocking and a client is only ever read or written when epoll says it is ready, so a slow or
+// stuck client costs the loop nothing; one that hasn't finished within CONTROL_SERVER_TIMEOUT_MS is dropped. Each
+// route is a handler that writes a JSON body. A request carries its parameters in the query string, or as a form in
+// the body. A stream route instead keeps the connection open and sends every published line down it, one JSON object
+// per line, so a subscriber hears of events as they happen without polling. Access is whatever the socket file's
+// permissions allow.
+
+#define CONTROL_SERVER_DEFAULT_PATH "/tmp/fishfeeder-control.sock"
+#define CONTROL_SERVER_MAX_CLIENTS 4
+#define CONTROL_SERVER_MAX_ROUTES 8
+#define CONTROL_SERVER_REQUEST_SIZE 1024
+#define CONTROL_SERVER_RESPONSE_SIZE 2048
+#define CONTROL_SERVER_TIMEOUT_MS 2000
+
+// Writes at most size bytes of JSON, terminator included, into body and returns the HTTP status, e.g. 200. params is
+// the query string or form, without the '?', possibly empty.
+typedef int (*controlServer_handler)(const char* params, char* body, size_t size);
+
+// Before controlServer_open. method is e.g. "GET"; path is matched exactly.
+bool controlServer_addRoute(const char* method, const char* path, controlServer_handler handler);
+
+// Before controlServer_open. A GET of path is answered with the headers alone, then every line published until either
+// side hangs up.
+bool controlServer_addStream(const char* path);
+
+// On the event loop thread. Queues line, and a newline, for every stream client, and sends what each will take now. A
+// client with more than CONTROL_SERVER_RESPONSE_SIZE bytes still queued is dropped rather than waited for.
+void controlServer_publish(const char* line);
+
+// Binds path, replacing a socket left there by an earlier run, and adds it to the event loop, which has to be
+// initialised.
+bool controlServer_open(const char* path);
+
+// As controlServer_open, with fd already listening at path, e.g. the socket the feeder this one replaced handed over.
+bool controlServer_adopt(int fd, const char* path);
+
+// For a handover (handover.h): stops accepting, and returns the listening socket for the new feeder to carry on with.
+// The socket file is left in place on close. -1 if the server isn't open.
+int controlServer_release(void);
+
+// Finds name=value in params and copies the value, undecoded. Returns false if it isn't there or doesn't fit.
+bool controlServer_getParam(const char* params, const char* name, char* value, size_t size);
+
+// As above, for a whole number in [min, max].
+bool controlServer_getInt(const char* params, const char* name, long long min, long long max, long long* value);
+
+// Drops any client still connected and removes the socket file.
+void controlServer_close(void);
+
+#endif
@@ -0,0 +1,391 @@
+#include "cpu_frequency.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+#include "metrics.h"
+
+typedef struct {
+    int minFd;
+    int maxFd;
+    int curFd;
+    // as found, to put back
+    int savedMinKHz;
+    int savedMaxKHz;
+    int lowestKHz;
+    int highestKHz;
+    int idleKHz;
+} policy;
+
+static policy policies[CPU_FREQUENCY_MAX_POLICIES];
+static int policyCount = 0;
+static int holdMs = CPU_FREQUENCY_DEFAULT_HOLD_MS;
+// the energy one busy CPU-second under the cap saves, worked out once at the start
+static double savedJoulesPerBusySec = 0.0;
+static int timerFd = -1;
+static int settleTimerFd = -1;
+static int statFd = -1;
+static long ticksPerSec = 100;
+
+static bool isBoosted = false;
+static int viewers = 0;
+static long long boostUntilMs = 0;
+static long long switchStartUs = 0;
+static long long lastBusyTicks = -1;
+static long long lastAccountMs = 0;
+static cpuFrequency_stats counters;
+
+static metrics_id boostedMetric = -1;
+static metrics_id boostsMetric = -1;
+static metrics_id switchMetric = -1;
+static metrics_id cappedMetric = -1;
+static metrics_id savedMetric = -1;
+
+static const double SWITCH_BOUNDS[] = {0.0005, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1};
+
+static long long nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// a sysfs attribute's number, or INT_MIN if there isn't one
+static int readNumber(int fd)
+{
+    char text[16];
+    const ssize_t length = pread(fd, text, sizeof(text) - 1, 0);
+    if (length <= 0) {
+        return INT_MIN;
+    }
+    text[length] = '\0';
+    char* end;
+    const long value = strtol(text, &end, 10);
+    return (end == text) ? INT_MIN : (int) value;
+}
+
+static void writeNumber(int fd, int value)
+{
+    char text[16];
+    const int length = snprintf(text, sizeof(text), "%d\n", value);
+    if (pwrite(fd, text, (size_t) length, 0) != length) {
+        asyncLog_log(ASYNC_LOG_WARN, "CPU frequency: can't set %d kHz", value);
+    }
+}
+
+static int openAttribute(const char* dir, const char* name, int flags)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), CPU_FREQUENCY_PATH "/%s/%s", dir, name);
+    return open(path, flags | O_CLOEXEC);
+}
+
+static int readAttribute(const char* dir, const char* name)
+{
+    const int fd = openAttribute(dir, name, O_RDONLY);
+    if (fd < 0) {
+        return INT_MIN;
+    }
+    const int value = readNumber(fd);
+    close(fd);
+    return value;
+}
+
+// Busy time of every CPU together, in clock ticks, from the first line of /proc/stat: user, nice, system, idle,
+// iowait, irq, softirq, steal. -1 if it can't be read.
+static long long readBusyTicks(void)
+{
+    char text[256];
+    const ssize_t length = pread(statFd, text, sizeof(text) - 1, 0);
+    if (length <= 0) {
+        return -1;
+    }
+    text[length] = '\0';
+    long long fields[8] = {0};
+    if (sscanf(text, "cpu %lld %lld %lld %lld %lld %lld %lld %lld", &fields[0], &fields[1], &fields[2], &fields[3],
+               &fields[4], &fields[5], &fields[6], &fields[7]) < 7) {
+        return -1;
+    }
+    return fields[0] + fields[1] + fields[2] + fields[5] + fields[6] + fields[7];
+}
+
+// Charges the time since the last call to the state the CPUs were in: before every switch, and every interval.
+static void account(void)
+{
+    const long long now = eventLoop_nowMs();
+    const long long busyTicks = readBusyTicks();
+    if (!isBoosted) {
+        __atomic_fetch_add(&counters.cappedMs, now - lastAccountMs, __ATOMIC_RELAXED);
+        if (busyTicks >= 0 && lastBusyTicks >= 0) {
+            const long long busyMs = (busyTicks - lastBusyTicks) * 1000 / ticksPerSec;
+            __atomic_fetch_add(&counters.cappedBusyMs, busyMs, __ATOMIC_RELAXED);
+            __atomic_store_n(&counters.savedMilliJoules,
+                             (long long) (__atomic_load_n(&counters.cappedBusyMs, __ATOMIC_RELAXED) *
+                                          savedJoulesPerBusySec),
+                             __ATOMIC_RELAXED);
+        }
+    }
+    lastAccountMs = now;
+    lastBusyTicks = busyTicks;
+    metrics_set(cappedMetric, __atomic_load_n(&counters.cappedMs, __ATOMIC_RELAXED) / 1000.0);
+    metrics_set(savedMetric, __atomic_load_n(&counters.savedMilliJoules, __ATOMIC_RELAXED) / 1000.0);
+}
+
+static bool isSettled(void)
+{
+    for (int i = 0; i < policyCount; i++) {
+        const int curKHz = readNumber(policies[i].curFd);
+        if (curKHz == INT_MIN) {
+            continue;
+        }
+        if (isBoosted ? (curKHz < policies[i].highestKHz) : (curKHz > policies[i].idleKHz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void settled(void)
+{
+    const long long switchUs = nowUs() - switchStartUs;
+    __atomic_store_n(&counters.lastSwitchUs, switchUs, __ATOMIC_RELAXED);
+    if (switchUs > __atomic_load_n(&counters.maxSwitchUs, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&counters.maxSwitchUs, switchUs, __ATOMIC_RELAXED);
+    }
+    metrics_observe(switchMetric, switchUs / 1e6);
+    switchStartUs = 0;
+    eventLoop_armTimer(settleTimerFd, 0, 0);
+}
+
+static void onSettleTimer(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0 || switchStartUs == 0) {
+        return;
+    }
+    if (isSettled()) {
+        settled();
+    } else if (nowUs() - switchStartUs >= CPU_FREQUENCY_SETTLE_TIMEOUT_MS * 1000LL) {
+        __atomic_fetch_add(&counters.unsettledSwitches, 1, __ATOMIC_RELAXED);
+        asyncLog_log(ASYNC_LOG_WARN, "CPU frequency: still not %s after %d ms", isBoosted ? "raised" : "lowered",
+                     CPU_FREQUENCY_SETTLE_TIMEOUT_MS);
+        switchStartUs = 0;
+        eventLoop_armTimer(settleTimerFd, 0, 0);
+    }
+}
+
+// The limits are moved in the order that keeps min below max at every step, which the kernel insists on.
+static void setBoosted(bool boosted)
+{
+    account();
+    isBoosted = boosted;
+    __atomic_store_n(&counters.isBoosted, boosted, __ATOMIC_RELAXED);
+    metrics_set(boostedMetric, boosted ? 1 : 0);
+    switchStartUs = nowUs();
+    for (int i = 0; i < policyCount; i++) {
+        const policy* p = &policies[i];
+        if (boosted) {
+            writeNumber(p->maxFd, p->highestKHz);
+            writeNumber(p->minFd, p->highestKHz);
+        } else {
+            writeNumber(p->minFd, p->lowestKHz);
+            writeNumber(p->maxFd, p->idleKHz);
+        }
+    }
+    if (isSettled()) {
+        settled();
+    } else {
+        eventLoop_armTimer(settleTimerFd, CPU_FREQUENCY_SETTLE_POLL_MS, CPU_FREQUENCY_SETTLE_POLL_MS);
+    }
+}
+
+static void onTimer(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0) {
+        return;
+    }
+    if (isBoosted && viewers == 0 && eventLoop_nowMs() >= boostUntilMs) {
+        setBoosted(false);
+        asyncLog_log(ASYNC_LOG_DEBUG, "CPU frequency: capped");
+    } else {
+        account();
+    }
+}
+
+void cpuFrequency_boost(void)
+{
+    if (timerFd < 0) {
+        return;
+    }
+    boostUntilMs = eventLoop_nowMs() + holdMs;
+    if (!isBoosted) {
+        __atomic_fetch_add(&counters.boosts, 1, __ATOMIC_RELAXED);
+        metrics_add(boostsMetric, 1);
+        setBoosted(true);
+    }
+}
+
+void cpuFrequency_setViewers(int count)
+{
+    if (timerFd < 0) {
+        return;
+    }
+    // the hold starts once the last one has left
+    if (count > 0 || viewers > 0) {
+        cpuFrequency_boost();
+    }
+    viewers = count;
+}
+
+static void addPolicy(const char* dir)
+{
+    policy* p = &policies[policyCount];
+    p->lowestKHz = readAttribute(dir, "cpuinfo_min_freq");
+    p->highestKHz = readAttribute(dir, "cpuinfo_max_freq");
+    p->minFd = openAttribute(dir, "scaling_min_freq", O_RDWR);
+    p->maxFd = openAttribute(dir, "scaling_max_freq", O_RDWR);
+    p->curFd = openAttribute(dir, "scaling_cur_freq", O_RDONLY);
+    if (p->lowestKHz == INT_MIN || p->highestKHz == INT_MIN || p->minFd < 0 || p->maxFd < 0 || p->curFd < 0) {
+        for (int i = 0; i < 3; i++) {
+            const int fd = (i == 0) ? p->minFd : (i == 1) ? p->maxFd : p->curFd;
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        return;
+    }
+    p->savedMinKHz = readNumber(p->minFd);
+    p->savedMaxKHz = readNumber(p->maxFd);
+    policyCount++;
+}
+
+bool cpuFrequency_start(const cpuFrequency_config* config)
+{
+    memset(&counters, 0, sizeof(counters));
+    counters.lastSwitchUs = -1;
+    counters.maxSwitchUs = -1;
+    if (boostedMetric < 0) {
+        boostedMetric = metrics_addGauge("feeder_cpu_boosted", "1 while the CPUs run at full speed, 0 while capped.");
+        boostsMetric = metrics_addCounter("feeder_cpu_boosts_total", "Switches to full speed.");
+        switchMetric = metrics_addHistogram("feeder_cpu_switch_seconds",
+                                            "From the sysfs write until every policy ran at the new frequency.",
+                                            SWITCH_BOUNDS, sizeof(SWITCH_BOUNDS) / sizeof(SWITCH_BOUNDS[0]));
+        cappedMetric = metrics_addGauge("feeder_cpu_capped_seconds", "Time spent at the idle frequency.");
+        savedMetric = metrics_addGauge("feeder_cpu_energy_saved_joules",
+                                       "Estimated energy the idle cap saved on the CPU time spent under it.");
+    }
+
+    DIR* dir = opendir(CPU_FREQUENCY_PATH);
+    if (dir) {
+        const struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL && policyCount < CPU_FREQUENCY_MAX_POLICIES) {
+            if (strncmp(entry->d_name, "policy", 6) == 0) {
+                addPolicy(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    if (policyCount == 0) {
+        printf("CPU frequency: no policies to set in " CPU_FREQUENCY_PATH ".\n");
+        return false;
+    }
+
+    int highestKHz = 0;
+    for (int i = 0; i < policyCount; i++) {
+        policy* p = &policies[i];
+        p->idleKHz = config->idleKHz < p->lowestKHz ? p->lowestKHz :
+                     config->idleKHz > p->highestKHz ? p->highestKHz : config->idleKHz;
+        if (p->highestKHz > highestKHz) {
+            highestKHz = p->highestKHz;
+        }
+    }
+    holdMs = (config->holdMs > 0) ? config->holdMs : CPU_FREQUENCY_DEFAULT_HOLD_MS;
+    // a busy second at ratio r of the top frequency does the work of r seconds at the top, each cycle for r^2 of the
+    // energy
+    const double ratio = (double) policies[0].idleKHz / highestKHz;
+    const float busyWatts = (config->busyWatts > 0.f) ? config->busyWatts : CPU_FREQUENCY_DEFAULT_BUSY_WATTS;
+    savedJoulesPerBusySec = busyWatts * ratio * (1.0 - ratio * ratio);
+    const long ticks = sysconf(_SC_CLK_TCK);
+    ticksPerSec = (ticks > 0) ? ticks : 100;
+
+    statFd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    timerFd = eventLoop_createTimer();
+    settleTimerFd = eventLoop_createTimer();
+    const bool ok = timerFd >= 0 && settleTimerFd >= 0 && eventLoop_add(timerFd, EPOLLIN, onTimer, NULL)
+            && eventLoop_add(settleTimerFd, EPOLLIN, onSettleTimer, NULL)
+            && eventLoop_armTimer(timerFd, CPU_FREQUENCY_INTERVAL_MS, CPU_FREQUENCY_INTERVAL_MS);
+    if (!ok) {
+        perror("CPU frequency: Unable to start.");
+        cpuFrequency_stop();
+        return false;
+    }
+    eventLoop_setSubsystem(timerFd, "sensors");
+    eventLoop_setSubsystem(settleTimerFd, "sensors");
+
+    // charged from here on; the first switch is the cap itself
+    isBoosted = true;
+    lastAccountMs = eventLoop_nowMs();
+    lastBusyTicks = readBusyTicks();
+    setBoosted(false);
+    printf("CPU frequency: %d policies, capped at %d MHz, full speed for %d s after a wake word or viewer\n",
+           policyCount, policies[0].idleKHz / 1000, holdMs / 1000);
+    return true;
+}
+
+void cpuFrequency_getStats(cpuFrequency_stats* stats)
+{
+    stats->isBoosted = __atomic_load_n(&counters.isBoosted, __ATOMIC_RELAXED);
+    stats->boosts = __atomic_load_n(&counters.boosts, __ATOMIC_RELAXED);
+    stats->lastSwitchUs = __atomic_load_n(&counters.lastSwitchUs, __ATOMIC_RELAXED);
+    stats->maxSwitchUs = __atomic_load_n(&counters.maxSwitchUs, __ATOMIC_RELAXED);
+    stats->unsettledSwitches = __atomic_load_n(&counters.unsettledSwitches, __ATOMIC_RELAXED);
+    stats->cappedMs = __atomic_load_n(&counters.cappedMs, __ATOMIC_RELAXED);
+    stats->cappedBusyMs = __atomic_load_n(&counters.cappedBusyMs, __ATOMIC_RELAXED);
+    stats->savedMilliJoules = __atomic_load_n(&counters.savedMilliJoules, __ATOMIC_RELAXED);
+}
+
+void cpuFrequency_stop(void)
+{
+    if (timerFd >= 0) {
+        account();
+        eventLoop_remove(timerFd);
+        close(timerFd);
+        timerFd = -1;
+    }
+    if (settleTimerFd >= 0) {
+        eventLoop_remove(settleTimerFd);
+        close(settleTimerFd);
+        settleTimerFd = -1;
+    }
+    if (statFd >= 0) {
+        close(statFd);
+        statFd = -1;
+    }
+    for (int i = 0; i < policyCount; i++) {
+        policy* p = &policies[i];
+        // min down first, as it may be pinned at the top, then max up, as the saved min may be above the cap
+        writeNumber(p->minFd, p->lowestKHz);
+        if (p->savedMaxKHz != INT_MIN) {
+            writeNumber(p->maxFd, p->savedMaxKHz);
+        }
+        if (p->savedMinKHz != INT_MIN) {
+            writeNumber(p->minFd, p->savedMinKHz);
+        }
+        close(p->minFd);
+        close(p->maxFd);
+        close(p->curFd);
+    }
+    policyCount = 0;
+    viewers = 0;
+    isBoosted = false;
+}
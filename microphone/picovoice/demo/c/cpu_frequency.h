@@ -0,0 +1,66 @@
+#ifndef CPU_FREQUENCY_H
+#define CPU_FREQUENCY_H
+
+#include <stdbool.h>
+
+// Runs the board's CPUs slowly while it only listens, and at full speed while something needs them. At idle every
+// cpufreq policy under CPU_FREQUENCY_PATH has its scaling_max_freq capped at the idle frequency, which is plenty for
+// the voice gate and the wake word engine. A wake word, or a viewer watching the camera, pins scaling_min_freq and
+// scaling_max_freq at the CPU's top frequency, so the command that follows and the frames being streamed never wait
+// for the governor to notice the load. The cap comes back once the hold time has passed with no wake word and no
+// viewer. The governor itself is left as it is, and the original limits are restored on stop.
+//
+// Each switch is timed from the first sysfs write until scaling_cur_freq says every policy has settled at the new
+// frequency, looked at every CPU_FREQUENCY_SETTLE_POLL_MS for up to CPU_FREQUENCY_SETTLE_TIMEOUT_MS. The board has
+// no power meter, so the energy saved is an estimate: CPU time spent under the cap costs less per cycle, by the square
+// of the voltage, taken to scale with the frequency; idle time and static power are left out. Everything runs on the
+// event loop, which has to be initialised.
+
+#define CPU_FREQUENCY_PATH "/sys/devices/system/cpu/cpufreq"
+#define CPU_FREQUENCY_MAX_POLICIES 8
+#define CPU_FREQUENCY_INTERVAL_MS 1000
+#define CPU_FREQUENCY_SETTLE_POLL_MS 1
+#define CPU_FREQUENCY_SETTLE_TIMEOUT_MS 100
+#define CPU_FREQUENCY_DEFAULT_HOLD_MS 30000
+// a Cortex-A8 core busy at 1 GHz
+#define CPU_FREQUENCY_DEFAULT_BUSY_WATTS 0.6f
+
+typedef struct {
+    // the cap at idle; 0 leaves the CPU frequency alone
+    int idleKHz;
+    // how long the CPU stays at full speed after the last wake word or viewer; 0 for CPU_FREQUENCY_DEFAULT_HOLD_MS
+    int holdMs;
+    // a core's power while busy at its top frequency, for the estimate; 0 for CPU_FREQUENCY_DEFAULT_BUSY_WATTS
+    float busyWatts;
+} cpuFrequency_config;
+
+typedef struct {
+    bool isBoosted;
+    long long boosts;
+    // the last switch either way, and the longest; -1 before the first that settled
+    long long lastSwitchUs;
+    long long maxSwitchUs;
+    // switches that hadn't settled within CPU_FREQUENCY_SETTLE_TIMEOUT_MS
+    long long unsettledSwitches;
+    long long cappedMs;
+    // CPU time, all cores together, spent under the cap, and the energy that saved
+    long long cappedBusyMs;
+    long long savedMilliJoules;
+} cpuFrequency_stats;
+
+// Caps the CPUs straight away. False, having said why, if there are no policies to set.
+bool cpuFrequency_start(const cpuFrequency_config* config);
+
+// On the event loop thread: a wake word was heard. Does nothing if the controller isn't running.
+void cpuFrequency_boost(void);
+
+// On the event loop thread: how many are watching the camera, as the relay counts them. Full speed while any are.
+void cpuFrequency_setViewers(int viewers);
+
+// Safe from any thread.
+void cpuFrequency_getStats(cpuFrequency_stats* stats);
+
+// Puts every policy's limits back as they were.
+void cpuFrequency_stop(void);
+
+#endif
@@ -0,0 +1,124 @@
+#define _GNU_SOURCE
+
+#include "embedded_models.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define EMBEDDED_MODELS_COUNT 4
+#define PATH_LENGTH 32
+
+#if defined(PICOVOICE_EMBED_MODELS)
+
+// generated from the model files by resources/scripts/binary_to_c_array.py; page-aligned so each starts its own page
+// of .rodata and none shares a page with anything else
+#define EMBEDDED_MODEL static const unsigned char __attribute__((aligned(4096)))
+
+EMBEDDED_MODEL porcupineModel[] = {
+#include "porcupine_model.inc"
+};
+
+EMBEDDED_MODEL keyword[] = {
+#include "keyword.inc"
+};
+
+EMBEDDED_MODEL rhinoModel[] = {
+#include "rhino_model.inc"
+};
+
+EMBEDDED_MODEL context[] = {
+#include "context.inc"
+};
+
+typedef struct {
+    const char* name;
+    const unsigned char* data;
+    size_t size;
+} embeddedModel;
+
+static const embeddedModel models[EMBEDDED_MODELS_COUNT] = {
+    {"porcupine_params.pv", porcupineModel, sizeof(porcupineModel)},
+    {"keyword.ppn", keyword, sizeof(keyword)},
+    {"rhino_params.pv", rhinoModel, sizeof(rhinoModel)},
+    {"context.rhn", context, sizeof(context)},
+};
+
+#endif
+
+static int fds[EMBEDDED_MODELS_COUNT] = {-1, -1, -1, -1};
+static char paths[EMBEDDED_MODELS_COUNT][PATH_LENGTH];
+
+bool embeddedModels_isBuiltIn(void)
+{
+#if defined(PICOVOICE_EMBED_MODELS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(PICOVOICE_EMBED_MODELS)
+
+static bool openModel(int index)
+{
+    const embeddedModel* model = &models[index];
+    int fd = memfd_create(model->name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        perror("Models: Unable to create a memfd.");
+        return false;
+    }
+    fds[index] = fd;
+    size_t written = 0;
+    while (written < model->size) {
+        ssize_t count = write(fd, model->data + written, model->size - written);
+        if (count <= 0) {
+            perror("Models: Unable to fill a memfd.");
+            printf(" model: %s\n", model->name);
+            return false;
+        }
+        written += (size_t) count;
+    }
+    // the engine gets a file nothing can change under it
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        perror("Models: Unable to seal a memfd.");
+        return false;
+    }
+    snprintf(paths[index], PATH_LENGTH, "/proc/self/fd/%d", fd);
+    return true;
+}
+
+#endif
+
+bool embeddedModels_open(embeddedModels_paths* modelPaths)
+{
+#if defined(PICOVOICE_EMBED_MODELS)
+    for (int i = 0; i < EMBEDDED_MODELS_COUNT; i++) {
+        if (!openModel(i)) {
+            embeddedModels_close();
+            return false;
+        }
+    }
+    modelPaths->porcupineModelPath = paths[0];
+    modelPaths->keywordPath = paths[1];
+    modelPaths->rhinoModelPath = paths[2];
+    modelPaths->contextPath = paths[3];
+    return true;
+#else
+    (void) modelPaths;
+    printf("Models: not built in; configure with -DPICOVOICE_EMBED_MODELS=ON.\n");
+    return false;
+#endif
+}
+
+void embeddedModels_close(void)
+{
+    for (int i = 0; i < EMBEDDED_MODELS_COUNT; i++) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+            fds[i] = -1;
+        }
+        paths[i][0] = '\0';
+    }
+}
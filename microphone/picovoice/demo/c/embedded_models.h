@@ -0,0 +1,27 @@
+#ifndef EMBEDDED_MODELS_H
+#define EMBEDDED_MODELS_H
+
+#include <stdbool.h>
+
+// The Porcupine and Rhino models, keyword and context built into the binary with the PICOVOICE_EMBED_MODELS CMake
+// option, so startup reads nothing from the SD card. They sit in read-only, page-aligned arrays, paged in from the
+// binary as they are read. The engine only takes paths, so each model is copied into a sealed memfd and handed over as
+// /proc/self/fd/N: no lookups, no opens on a filesystem, and the paths stay valid for reloads until
+// embeddedModels_close.
+
+typedef struct {
+    const char* porcupineModelPath;
+    const char* keywordPath;
+    const char* rhinoModelPath;
+    const char* contextPath;
+} embeddedModels_paths;
+
+// False if the binary was built without them.
+bool embeddedModels_isBuiltIn(void);
+
+// Prints what went wrong and returns false if they aren't built in or can't be put in memfds.
+bool embeddedModels_open(embeddedModels_paths* paths);
+
+void embeddedModels_close(void);
+
+#endif
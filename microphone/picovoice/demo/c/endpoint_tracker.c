@@ -0,0 +1,104 @@
+#include "endpoint_tracker.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// quieter than this is treated as this, so digital silence doesn't drag the floor to minus infinity
+#define MIN_ENERGY_DB -90.0f
+// the floor drops to a quieter frame at once but rises slowly, and speech doesn't move it at all
+#define FLOOR_FALL 0.5f
+#define FLOOR_RISE 0.01f
+// floors at or below this take the shortest silence, at or above the other the longest, and in between a share
+#define QUIET_FLOOR_DB -65.0f
+#define NOISY_FLOOR_DB -35.0f
+
+static int32_t frameLength = 0;
+static endpointTracker_config trackerConfig;
+
+static float noiseFloorDb = MIN_ENERGY_DB;
+static long long frames = 0;
+// of the command under way
+static int speechFrames = 0;
+static int silentFrames = 0;
+static bool isEnded = false;
+static endpointTracker_stats counters;
+
+static float energyDb(const int16_t* pcm)
+{
+    double sum = 0;
+    for (int32_t i = 0; i < frameLength; i++) {
+        sum += (double) pcm[i] * pcm[i];
+    }
+    const double meanSquare = sum / frameLength / (32768.0 * 32768.0);
+    const float db = (meanSquare > 0) ? (float) (10.0 * log10(meanSquare)) : MIN_ENERGY_DB;
+    return (db < MIN_ENERGY_DB) ? MIN_ENERGY_DB : db;
+}
+
+static int silenceNeeded(void)
+{
+    float noisiness = (noiseFloorDb - QUIET_FLOOR_DB) / (NOISY_FLOOR_DB - QUIET_FLOOR_DB);
+    noisiness = (noisiness < 0.f) ? 0.f : (noisiness > 1.f) ? 1.f : noisiness;
+    return trackerConfig.minSilenceFrames +
+            (int) (noisiness * (float) (trackerConfig.maxSilenceFrames - trackerConfig.minSilenceFrames) + 0.5f);
+}
+
+bool endpointTracker_init(int32_t length, const endpointTracker_config* config)
+{
+    if (config->minSilenceFrames < 1 || config->maxSilenceFrames < config->minSilenceFrames ||
+            config->minSpeechFrames < 0) {
+        printf("Endpoint tracker: invalid configuration.\n");
+        return false;
+    }
+    frameLength = length;
+    trackerConfig = *config;
+    noiseFloorDb = MIN_ENERGY_DB;
+    frames = 0;
+    speechFrames = 0;
+    silentFrames = 0;
+    isEnded = false;
+    memset(&counters, 0, sizeof(counters));
+    return true;
+}
+
+bool endpointTracker_process(const int16_t* pcm, bool isListening)
+{
+    const float db = energyDb(pcm);
+    if (++frames == 1) {
+        // the room is assumed quiet when listening starts
+        noiseFloorDb = db;
+    }
+    const bool isSpeech = db > noiseFloorDb + trackerConfig.speechDb;
+    if (!isSpeech) {
+        noiseFloorDb += (db - noiseFloorDb) * ((db < noiseFloorDb) ? FLOOR_FALL : FLOOR_RISE);
+    }
+
+    if (!isListening) {
+        speechFrames = 0;
+        silentFrames = 0;
+        isEnded = false;
+        return false;
+    }
+    if (isEnded) {
+        return false;
+    }
+    if (isSpeech) {
+        speechFrames++;
+        silentFrames = 0;
+        return false;
+    }
+    silentFrames++;
+    if (speechFrames < trackerConfig.minSpeechFrames || silentFrames < silenceNeeded()) {
+        return false;
+    }
+    isEnded = true;
+    counters.ends++;
+    counters.silenceFrames += silentFrames;
+    return true;
+}
+
+void endpointTracker_getStats(endpointTracker_stats* stats)
+{
+    *stats = counters;
+    stats->noiseFloorDb = noiseFloorDb;
+}
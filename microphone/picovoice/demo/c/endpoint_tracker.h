@@ -0,0 +1,39 @@
+#ifndef ENDPOINT_TRACKER_H
+#define ENDPOINT_TRACKER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Tells when a command is clearly over, sooner than Rhino's fixed endpoint duration would. Each frame's energy is
+// compared with a noise floor learned from this board's own room; once the command has had some speech and then
+// enough frames near the floor, it is over. How much silence is enough follows the floor: in a quiet room a short
+// pause is trustworthy, next to a loud pump a longer one is needed before low energy means the speaker has stopped.
+// Everything here runs on the inference thread.
+
+typedef struct {
+    // how far above the noise floor a frame has to be to count as speech
+    float speechDb;
+    // the trailing silence that ends a command, in the quietest and the noisiest room
+    int minSilenceFrames;
+    int maxSilenceFrames;
+    // a command with less speech than this is left to Rhino, so a pause after the first word isn't its end
+    int minSpeechFrames;
+} endpointTracker_config;
+
+typedef struct {
+    // commands ended here, before Rhino's own endpoint
+    long long ends;
+    long long silenceFrames;
+    float noiseFloorDb;
+} endpointTracker_stats;
+
+bool endpointTracker_init(int32_t frameLength, const endpointTracker_config* config);
+
+// Every frame, listened to or not, so the floor keeps up with the room. Returns true on the one frame a command under
+// way is judged over.
+bool endpointTracker_process(const int16_t* pcm, bool isListening);
+
+// Only once the inference thread has stopped.
+void endpointTracker_getStats(endpointTracker_stats* stats);
+
+#endif
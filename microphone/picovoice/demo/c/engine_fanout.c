@@ -0,0 +1,169 @@
+#ifndef _GNU_SOURCE
+// pthread_setaffinity_np and the CPU_SET macros
+#define _GNU_SOURCE
+#endif
+
+#include "engine_fanout.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "alloc_guard.h"
+#include "async_log.h"
+#include "thread_cpu.h"
+
+typedef struct {
+    int engine;
+    pthread_t thread;
+    bool isRunning;
+    // one count per frame handed over, plus the stop request
+    int wakeFd;
+} worker;
+
+static int engineCount = 0;
+static engineFanout_processFunc processFunc = NULL;
+static void* processUserData = NULL;
+
+// engine 0 has no worker, it runs on the caller
+static worker workers[ENGINE_FANOUT_MAX_ENGINES];
+static bool stopping = false;
+// the frame being processed, published before the workers are woken
+static const int16_t* sharedPcm = NULL;
+// workers still busy with sharedPcm; the last one to finish signals doneFd
+static int remaining = 0;
+static int doneFd = -1;
+
+static void notify(int fd)
+{
+    uint64_t one = 1;
+    if (write(fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Engine fanout: Unable to wake: %s", strerror(errno));
+    }
+}
+
+static bool await(int fd)
+{
+    uint64_t count;
+    while (read(fd, &count, sizeof(count)) < 0) {
+        if (errno != EINTR) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Engine fanout: Unable to wait: %s", strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+static void* runWorker(void* arg)
+{
+    worker* self = arg;
+    allocGuard_markHot("engine");
+    while (await(self->wakeFd) && !__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+        processFunc(self->engine, __atomic_load_n(&sharedPcm, __ATOMIC_ACQUIRE), processUserData);
+        if (__atomic_sub_fetch(&remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+            notify(doneFd);
+        }
+    }
+    return NULL;
+}
+
+static void setScheduling(pthread_t thread, int32_t realtimePriority, int32_t cpu)
+{
+    if (realtimePriority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = realtimePriority;
+        pthread_setschedparam(thread, SCHED_FIFO, &param);
+    }
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread, sizeof(set), &set);
+    }
+}
+
+bool engineFanout_start(int count, engineFanout_processFunc process, void* userData, int32_t realtimePriority,
+        int32_t firstCpu)
+{
+    if (count < 1 || count > ENGINE_FANOUT_MAX_ENGINES) {
+        printf("Engine fanout: %d engines, 1 to %d supported.\n", count, ENGINE_FANOUT_MAX_ENGINES);
+        return false;
+    }
+    engineCount = count;
+    processFunc = process;
+    processUserData = userData;
+    stopping = false;
+    memset(workers, 0, sizeof(workers));
+    for (int i = 0; i < ENGINE_FANOUT_MAX_ENGINES; i++) {
+        workers[i].wakeFd = -1;
+    }
+    if (count == 1) {
+        return true;
+    }
+
+    doneFd = eventfd(0, EFD_CLOEXEC);
+    if (doneFd < 0) {
+        perror("Engine fanout: Unable to create eventfd.");
+        return false;
+    }
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < count; i++) {
+        worker* entry = &workers[i];
+        entry->engine = i;
+        entry->wakeFd = eventfd(0, EFD_CLOEXEC);
+        if (entry->wakeFd < 0 || pthread_create(&entry->thread, NULL, runWorker, entry) != 0) {
+            printf("Engine fanout: Unable to start the worker for engine %d.\n", i);
+            engineFanout_stop();
+            return false;
+        }
+        entry->isRunning = true;
+        char name[16];
+        snprintf(name, sizeof(name), "engine-%d", i);
+        threadCpu_setName(entry->thread, name);
+        const int32_t cpu = (firstCpu >= 0 && cpus > 0) ? (int32_t) ((firstCpu + i) % cpus) : -1;
+        setScheduling(entry->thread, realtimePriority, cpu);
+    }
+    return true;
+}
+
+void engineFanout_process(const int16_t* pcm)
+{
+    if (engineCount > 1) {
+        __atomic_store_n(&sharedPcm, pcm, __ATOMIC_RELEASE);
+        __atomic_store_n(&remaining, engineCount - 1, __ATOMIC_RELEASE);
+        for (int i = 1; i < engineCount; i++) {
+            notify(workers[i].wakeFd);
+        }
+    }
+    processFunc(0, pcm, processUserData);
+    if (engineCount > 1) {
+        await(doneFd);
+    }
+}
+
+void engineFanout_stop(void)
+{
+    __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+    for (int i = 1; i < ENGINE_FANOUT_MAX_ENGINES; i++) {
+        worker* entry = &workers[i];
+        if (entry->isRunning) {
+            notify(entry->wakeFd);
+            pthread_join(entry->thread, NULL);
+            entry->isRunning = false;
+        }
+        if (entry->wakeFd >= 0) {
+            close(entry->wakeFd);
+            entry->wakeFd = -1;
+        }
+    }
+    if (doneFd >= 0) {
+        close(doneFd);
+        doneFd = -1;
+    }
+    engineCount = 0;
+}
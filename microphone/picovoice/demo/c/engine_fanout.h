@@ -0,0 +1,26 @@
+#ifndef ENGINE_FANOUT_H
+#define ENGINE_FANOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Runs each frame through several engines at once. Engine 0 runs on the thread that calls engineFanout_process, the
+// others on worker threads of their own, each pinned to its own core if asked. They all read the same frame, which
+// stays untouched until engineFanout_process returns, so the capture buffer is shared rather than copied.
+
+#define ENGINE_FANOUT_MAX_ENGINES 4
+
+// Runs on engine's thread, always the same one for a given engine.
+typedef void (*engineFanout_processFunc)(int engine, const int16_t* pcm, void* userData);
+
+// realtimePriority of 0 leaves the workers at normal priority. With firstCpu of -1 they run anywhere; otherwise
+// engine i's worker is pinned to CPU firstCpu + i, wrapping around the online CPUs. Best effort, like the pipeline.
+bool engineFanout_start(int engineCount, engineFanout_processFunc process, void* userData, int32_t realtimePriority,
+        int32_t firstCpu);
+
+// From one thread only. Returns once every engine is done with pcm.
+void engineFanout_process(const int16_t* pcm);
+
+void engineFanout_stop(void);
+
+#endif
@@ -0,0 +1,157 @@
+#include "env_sensor.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+#include "metrics.h"
+
+// what a DS18B20 reports when it was reset before the conversion finished, e.g. by a brown-out
+#define POWER_ON_MILLI_C 85000
+
+static envSensor_config config;
+static int timerFd = -1;
+static int triggerFd = -1;
+static int temperatureFds[ENV_SENSOR_KINDS] = {-1, -1};
+// the timer next expires with the conversion done, rather than for the next one
+static bool isConverting = false;
+static int readings[ENV_SENSOR_KINDS] = {ENV_SENSOR_NO_READING, ENV_SENSOR_NO_READING};
+static metrics_id temperatureMetrics[ENV_SENSOR_KINDS] = {-1, -1};
+static metrics_id errorMetric = -1;
+
+static const char* kindNames[ENV_SENSOR_KINDS] = {"water", "air"};
+
+static int readTemperature(int fd)
+{
+    char text[16];
+    const ssize_t length = pread(fd, text, sizeof(text) - 1, 0);
+    if (length <= 0) {
+        return ENV_SENSOR_NO_READING;
+    }
+    text[length] = '\0';
+    char* end;
+    const long milliC = strtol(text, &end, 10);
+    if (end == text || milliC == POWER_ON_MILLI_C) {
+        return ENV_SENSOR_NO_READING;
+    }
+    return (int) milliC;
+}
+
+static void collect(void)
+{
+    for (int kind = 0; kind < ENV_SENSOR_KINDS; kind++) {
+        if (temperatureFds[kind] < 0) {
+            continue;
+        }
+        const int milliC = readTemperature(temperatureFds[kind]);
+        // a failed read, e.g. a bad CRC, is not kept as the latest reading
+        if (milliC == ENV_SENSOR_NO_READING) {
+            metrics_add(errorMetric, 1);
+        } else {
+            metrics_set(temperatureMetrics[kind], milliC / 1000.0);
+        }
+        __atomic_store_n(&readings[kind], milliC, __ATOMIC_RELEASE);
+    }
+}
+
+static void onTimer(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0) {
+        return;
+    }
+    if (isConverting) {
+        isConverting = false;
+        collect();
+        eventLoop_armTimer(timerFd, ENV_SENSOR_INTERVAL_MS - ENV_SENSOR_CONVERSION_MS, 0);
+        return;
+    }
+
+    // every sensor on the bus converts at once; the write returns straight away
+    if (pwrite(triggerFd, "trigger\n", 8, 0) != 8) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Environment: Unable to start a conversion: %s", strerror(errno));
+        metrics_add(errorMetric, 1);
+        eventLoop_armTimer(timerFd, ENV_SENSOR_INTERVAL_MS, 0);
+        return;
+    }
+    isConverting = true;
+    eventLoop_armTimer(timerFd, ENV_SENSOR_CONVERSION_MS, 0);
+}
+
+static int openAttribute(const char* device, const char* name, int flags)
+{
+    char path[160];
+    snprintf(path, sizeof(path), ENV_SENSOR_W1_PATH "/%s/%s", device, name);
+    int fd = open(path, flags | O_CLOEXEC);
+    if (fd < 0) {
+        perror("Environment: Unable to open attribute.");
+        printf(" attribute: %s\n", path);
+    }
+    return fd;
+}
+
+bool envSensor_start(const envSensor_config* newConfig)
+{
+    config = *newConfig;
+    if (errorMetric < 0) {
+        temperatureMetrics[ENV_SENSOR_WATER] = metrics_addGauge("feeder_water_temperature_celsius",
+                                                                "Water temperature, at the last good reading.");
+        temperatureMetrics[ENV_SENSOR_AIR] = metrics_addGauge("feeder_air_temperature_celsius",
+                                                              "Air temperature, at the last good reading.");
+        errorMetric = metrics_addCounter("feeder_env_sensor_errors_total", "1-wire conversions or reads that failed.");
+    }
+
+    triggerFd = openAttribute(config.master, "therm_bulk_read", O_WRONLY);
+    bool ok = triggerFd >= 0;
+    for (int kind = 0; ok && kind < ENV_SENSOR_KINDS; kind++) {
+        if (config.ids[kind][0] != '\0') {
+            temperatureFds[kind] = openAttribute(config.ids[kind], "temperature", O_RDONLY);
+            ok = temperatureFds[kind] >= 0;
+            if (!ok) {
+                printf(" %s sensor\n", kindNames[kind]);
+            }
+        }
+    }
+    if (ok) {
+        timerFd = eventLoop_createTimer();
+        // the first conversion soon after startup
+        ok = timerFd >= 0 && eventLoop_add(timerFd, EPOLLIN, onTimer, NULL) && eventLoop_armTimer(timerFd, 1000, 0);
+    }
+    if (ok) {
+        eventLoop_setSubsystem(timerFd, "sensors");
+    } else {
+        envSensor_stop();
+    }
+    return ok;
+}
+
+int envSensor_milliC(envSensor_kind kind)
+{
+    return __atomic_load_n(&readings[kind], __ATOMIC_ACQUIRE);
+}
+
+void envSensor_stop(void)
+{
+    if (timerFd >= 0) {
+        eventLoop_remove(timerFd);
+        close(timerFd);
+        timerFd = -1;
+    }
+    if (triggerFd >= 0) {
+        close(triggerFd);
+        triggerFd = -1;
+    }
+    for (int kind = 0; kind < ENV_SENSOR_KINDS; kind++) {
+        if (temperatureFds[kind] >= 0) {
+            close(temperatureFds[kind]);
+            temperatureFds[kind] = -1;
+        }
+    }
+    isConverting = false;
+}
@@ -0,0 +1,40 @@
+#ifndef ENV_SENSOR_H
+#define ENV_SENSOR_H
+
+#include <stdbool.h>
+
+// Water and air temperature from DS18B20s on the 1-wire bus. Reading a sensor's w1_slave file starts a conversion and
+// blocks until it is done, about 750 ms at 12 bits, so this never does: every ENV_SENSOR_INTERVAL_MS every sensor on
+// the bus master is told to convert at once through the master's therm_bulk_read attribute (Linux 5.10 and later),
+// and ENV_SENSOR_CONVERSION_MS later each sensor's temperature file is read, which with the conversion done is only
+// the scratchpad transfer. Both steps are timed by a timerfd on the event loop, which has to be initialised. The
+// latest readings are cached for any thread, and published to the feeder_water_temperature_celsius and
+// feeder_air_temperature_celsius gauges.
+
+#define ENV_SENSOR_W1_PATH "/sys/bus/w1/devices"
+#define ENV_SENSOR_DEFAULT_MASTER "w1_bus_master1"
+#define ENV_SENSOR_INTERVAL_MS 30000
+#define ENV_SENSOR_CONVERSION_MS 800
+// what envSensor_milliC returns with no reading to give
+#define ENV_SENSOR_NO_READING (-1000000)
+
+typedef enum {
+    ENV_SENSOR_WATER,
+    ENV_SENSOR_AIR,
+    ENV_SENSOR_KINDS
+} envSensor_kind;
+
+typedef struct {
+    char master[32];                  // e.g. ENV_SENSOR_DEFAULT_MASTER
+    char ids[ENV_SENSOR_KINDS][24];   // e.g. "28-0316a2794bff"; empty if that sensor isn't fitted
+} envSensor_config;
+
+bool envSensor_start(const envSensor_config* config);
+
+// In thousandths of a degree Celsius, or ENV_SENSOR_NO_READING before the first good reading, or after a failed one.
+// Safe from any thread.
+int envSensor_milliC(envSensor_kind kind);
+
+void envSensor_stop(void);
+
+#endif
@@ -0,0 +1,412 @@
+#include "event_loop.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "memory_budget.h"
+
+#define NS_PER_MS 1000000LL
+
+typedef struct {
+    int fd;
+    eventLoop_handler handler;
+    void* userData;
+    int subsystem; // index into subsystems, -1 if its time isn't charged to one
+} watchedFd;
+
+typedef struct {
+    eventLoop_task task;
+    unsigned char data[EVENT_LOOP_POST_DATA_SIZE];
+} postedTask;
+
+typedef struct {
+    int fd;           // -1 if the slot is free
+    long long dueMs;  // on the virtual clock; -1 while disarmed
+    long long intervalMs;
+} virtualTimer;
+
+typedef struct {
+    const char* name;
+    long long cpuNs;
+} subsystemCpu;
+
+static int epollFd = -1;
+// one eventfd wakes the loop for both posted tasks and stop requests
+static int wakeFd = -1;
+static bool stopLoop = false;
+
+static watchedFd watched[EVENT_LOOP_MAX_FDS];
+static int watchedCount = 0;
+
+// single-producer single-consumer ring; head is only written by the poster, tail by the loop
+static postedTask posted[EVENT_LOOP_POST_QUEUE_LENGTH];
+static unsigned int postHead = 0;
+static unsigned int postTail = 0;
+
+// entries are only added, and by the loop thread or before it runs; cpuNs is read from any thread
+static subsystemCpu subsystems[EVENT_LOOP_MAX_SUBSYSTEMS];
+static int subsystemCount = 0;
+
+static bool isVirtual = false;
+// only touched on the loop thread, or before it runs
+static virtualTimer virtualTimers[EVENT_LOOP_MAX_FDS];
+// where the virtual clock is, read from any thread
+static long long virtualNowMs = 0;
+// guards targetMs and reachedMs: where eventLoop_advanceClock asked the clock to go, and how far the loop has got
+static pthread_mutex_t clockLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clockReached = PTHREAD_COND_INITIALIZER;
+static long long targetMs = 0;
+static long long reachedMs = 0;
+
+static virtualTimer* findVirtualTimer(int fd)
+{
+    if (!isVirtual) {
+        return NULL;
+    }
+    for (int i = 0; i < EVENT_LOOP_MAX_FDS; i++) {
+        if (virtualTimers[i].fd == fd) {
+            return &virtualTimers[i];
+        }
+    }
+    return NULL;
+}
+
+static void wake(void)
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Event loop: Unable to wake: %s", strerror(errno));
+    }
+}
+
+static void runPostedTasks(void)
+{
+    uint64_t count;
+    if (read(wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Event loop: Unable to read wake-up: %s", strerror(errno));
+    }
+    unsigned int tail = postTail;
+    while (tail != __atomic_load_n(&postHead, __ATOMIC_ACQUIRE)) {
+        postedTask* entry = &posted[tail % EVENT_LOOP_POST_QUEUE_LENGTH];
+        entry->task(entry->data);
+        tail++;
+        __atomic_store_n(&postTail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+// look the fd up each time, since an earlier handler may have removed it
+static void dispatch(int fd)
+{
+    for (int j = 0; j < watchedCount; j++) {
+        if (watched[j].fd == fd) {
+            const int subsystem = watched[j].subsystem;
+            if (subsystem < 0) {
+                watched[j].handler(watched[j].fd, watched[j].userData);
+                return;
+            }
+            // the handler may remove its own entry, so the subsystem is looked up first
+            struct timespec start;
+            struct timespec end;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            watched[j].handler(watched[j].fd, watched[j].userData);
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            const long long elapsedNs = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+            __atomic_fetch_add(&subsystems[subsystem].cpuNs, elapsedNs, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+}
+
+// Expires the virtual timers due by the target, earliest first; a handler arming a timer arms it from that deadline.
+static void runVirtualTimers(void)
+{
+    pthread_mutex_lock(&clockLock);
+    const long long toMs = targetMs;
+    pthread_mutex_unlock(&clockLock);
+
+    while (true) {
+        virtualTimer* next = NULL;
+        for (int i = 0; i < EVENT_LOOP_MAX_FDS; i++) {
+            virtualTimer* timer = &virtualTimers[i];
+            if (timer->fd >= 0 && timer->dueMs >= 0 && timer->dueMs <= toMs &&
+                (next == NULL || timer->dueMs < next->dueMs)) {
+                next = timer;
+            }
+        }
+        if (next == NULL) {
+            break;
+        }
+        __atomic_store_n(&virtualNowMs, next->dueMs, __ATOMIC_RELAXED);
+        next->dueMs = next->intervalMs > 0 ? next->dueMs + next->intervalMs : -1;
+        const int fd = next->fd;
+        const uint64_t one = 1;
+        if (write(fd, &one, sizeof(one)) != sizeof(one)) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Event loop: Unable to expire timer: %s", strerror(errno));
+        }
+        dispatch(fd);
+    }
+    __atomic_store_n(&virtualNowMs, toMs, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&clockLock);
+    reachedMs = toMs;
+    pthread_cond_broadcast(&clockReached);
+    pthread_mutex_unlock(&clockLock);
+}
+
+bool eventLoop_init(void)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) {
+        perror("Event loop: Unable to create.");
+        eventLoop_cleanup();
+        return false;
+    }
+    stopLoop = false;
+    watchedCount = 0;
+    postHead = 0;
+    postTail = 0;
+
+    struct epoll_event event = {.events = EPOLLIN, .data.fd = wakeFd};
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0) {
+        perror("Event loop: Unable to watch wake-up fd.");
+        eventLoop_cleanup();
+        return false;
+    }
+    const size_t tables = sizeof(watched) + sizeof(posted) + sizeof(virtualTimers) + sizeof(subsystems);
+    memoryBudget_add("event loop", (long long) tables, false);
+    return true;
+}
+
+bool eventLoop_add(int fd, unsigned int events, eventLoop_handler handler, void* userData)
+{
+    if (watchedCount == EVENT_LOOP_MAX_FDS) {
+        printf("Event loop: too many fds.\n");
+        return false;
+    }
+    watchedFd* entry = &watched[watchedCount];
+    entry->fd = fd;
+    entry->handler = handler;
+    entry->userData = userData;
+    entry->subsystem = -1;
+
+    // a virtual timer is never readable before its handler is called, so epoll doesn't need it
+    struct epoll_event event = {.events = events, .data.fd = fd};
+    if (findVirtualTimer(fd) == NULL && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        perror("Event loop: Unable to watch fd.");
+        return false;
+    }
+    watchedCount++;
+    return true;
+}
+
+void eventLoop_remove(int fd)
+{
+    virtualTimer* timer = findVirtualTimer(fd);
+    if (timer != NULL) {
+        timer->fd = -1;
+    }
+    for (int i = 0; i < watchedCount; i++) {
+        if (watched[i].fd == fd) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+            watched[i] = watched[watchedCount - 1];
+            watchedCount--;
+            return;
+        }
+    }
+}
+
+void eventLoop_setSubsystem(int fd, const char* subsystem)
+{
+    int index = 0;
+    while (index < subsystemCount && strcmp(subsystems[index].name, subsystem) != 0) {
+        index++;
+    }
+    if (index == subsystemCount) {
+        if (subsystemCount == EVENT_LOOP_MAX_SUBSYSTEMS) {
+            asyncLog_log(ASYNC_LOG_WARN, "Event loop: too many subsystems, '%s' not accounted.", subsystem);
+            return;
+        }
+        subsystems[index] = (subsystemCpu) {subsystem, 0};
+        // readers only look at entries below the published count
+        __atomic_store_n(&subsystemCount, index + 1, __ATOMIC_RELEASE);
+    }
+    for (int i = 0; i < watchedCount; i++) {
+        if (watched[i].fd == fd) {
+            watched[i].subsystem = index;
+            return;
+        }
+    }
+}
+
+long long eventLoop_subsystemCpuNs(const char* subsystem)
+{
+    const int count = __atomic_load_n(&subsystemCount, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(subsystems[i].name, subsystem) == 0) {
+            return __atomic_load_n(&subsystems[i].cpuNs, __ATOMIC_RELAXED);
+        }
+    }
+    return 0;
+}
+
+void eventLoop_run(void)
+{
+    struct epoll_event events[EVENT_LOOP_MAX_FDS + 1];
+    while (!__atomic_load_n(&stopLoop, __ATOMIC_ACQUIRE)) {
+        int ready = epoll_wait(epollFd, events, EVENT_LOOP_MAX_FDS + 1, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            asyncLog_log(ASYNC_LOG_ERROR, "Event loop: epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == wakeFd) {
+                runPostedTasks();
+                if (isVirtual) {
+                    runVirtualTimers();
+                }
+                continue;
+            }
+            dispatch(events[i].data.fd);
+        }
+    }
+}
+
+void eventLoop_stop(void)
+{
+    __atomic_store_n(&stopLoop, true, __ATOMIC_RELEASE);
+    wake();
+    pthread_mutex_lock(&clockLock);
+    pthread_cond_broadcast(&clockReached);
+    pthread_mutex_unlock(&clockLock);
+}
+
+bool eventLoop_post(eventLoop_task task, const void* data, size_t size)
+{
+    if (size > EVENT_LOOP_POST_DATA_SIZE) {
+        return false;
+    }
+    unsigned int head = postHead;
+    if (head - __atomic_load_n(&postTail, __ATOMIC_ACQUIRE) >= EVENT_LOOP_POST_QUEUE_LENGTH) {
+        return false;
+    }
+    postedTask* entry = &posted[head % EVENT_LOOP_POST_QUEUE_LENGTH];
+    entry->task = task;
+    if (size > 0) {
+        memcpy(entry->data, data, size);
+    }
+    __atomic_store_n(&postHead, head + 1, __ATOMIC_RELEASE);
+    wake();
+    return true;
+}
+
+void eventLoop_cleanup(void)
+{
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    watchedCount = 0;
+}
+
+int eventLoop_createTimer(void)
+{
+    if (isVirtual) {
+        virtualTimer* timer = findVirtualTimer(-1);
+        int fd = timer != NULL ? eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) : -1;
+        if (fd < 0) {
+            perror("Event loop: Unable to create virtual timer.");
+            return -1;
+        }
+        *timer = (virtualTimer) {fd, -1, 0};
+        return fd;
+    }
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (fd < 0) {
+        perror("Event loop: Unable to create timer.");
+    }
+    return fd;
+}
+
+bool eventLoop_armTimer(int fd, long long firstInMs, long long intervalInMs)
+{
+    virtualTimer* timer = findVirtualTimer(fd);
+    if (timer != NULL) {
+        timer->dueMs = firstInMs > 0 ? __atomic_load_n(&virtualNowMs, __ATOMIC_RELAXED) + firstInMs : -1;
+        timer->intervalMs = intervalInMs;
+        return true;
+    }
+    struct itimerspec spec = {
+        .it_interval = {intervalInMs / 1000, (intervalInMs % 1000) * NS_PER_MS},
+        .it_value = {firstInMs / 1000, (firstInMs % 1000) * NS_PER_MS},
+    };
+    if (timerfd_settime(fd, 0, &spec, NULL) != 0) {
+        perror("Event loop: Unable to arm timer.");
+        return false;
+    }
+    return true;
+}
+
+long long eventLoop_readTimer(int fd)
+{
+    uint64_t expirations = 0;
+    if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return 0;
+    }
+    return (long long) expirations;
+}
+
+void eventLoop_useVirtualClock(void)
+{
+    isVirtual = true;
+    for (int i = 0; i < EVENT_LOOP_MAX_FDS; i++) {
+        virtualTimers[i].fd = -1;
+    }
+    virtualNowMs = 0;
+    targetMs = 0;
+    reachedMs = 0;
+}
+
+bool eventLoop_advanceClock(long long toMs)
+{
+    pthread_mutex_lock(&clockLock);
+    if (toMs > targetMs) {
+        targetMs = toMs;
+    }
+    pthread_mutex_unlock(&clockLock);
+    wake();
+
+    pthread_mutex_lock(&clockLock);
+    while (reachedMs < toMs && !__atomic_load_n(&stopLoop, __ATOMIC_ACQUIRE)) {
+        pthread_cond_wait(&clockReached, &clockLock);
+    }
+    const bool reached = reachedMs >= toMs;
+    pthread_mutex_unlock(&clockLock);
+    return reached;
+}
+
+long long eventLoop_nowMs(void)
+{
+    if (isVirtual) {
+        return __atomic_load_n(&virtualNowMs, __ATOMIC_RELAXED);
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000 + now.tv_nsec / NS_PER_MS;
+}
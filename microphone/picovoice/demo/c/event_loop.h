@@ -0,0 +1,66 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// One epoll reactor for the hardware side of the demo: button edges, timers, the display and the servo all run as
+// handlers on the thread that calls eventLoop_run, so they share state without locks. Other threads talk to it only
+// through eventLoop_post and eventLoop_stop.
+
+#define EVENT_LOOP_MAX_FDS 24
+#define EVENT_LOOP_POST_QUEUE_LENGTH 8
+// room for an inference result, its printout included
+#define EVENT_LOOP_POST_DATA_SIZE 288
+#define EVENT_LOOP_MAX_SUBSYSTEMS 8
+
+typedef void (*eventLoop_handler)(int fd, void* userData);
+typedef void (*eventLoop_task)(const void* data);
+
+bool eventLoop_init(void);
+
+// events is an epoll mask, e.g. EPOLLIN, or EPOLLPRI for a sysfs GPIO value.
+bool eventLoop_add(int fd, unsigned int events, eventLoop_handler handler, void* userData);
+
+void eventLoop_remove(int fd);
+
+// Charges the CPU time of fd's handler to subsystem, e.g. "display" or "servo", so the loop thread's time can be split
+// between the subsystems sharing it. subsystem has to outlive the fd. On the loop thread, or before it runs.
+void eventLoop_setSubsystem(int fd, const char* subsystem);
+
+// CPU time the handlers charged to subsystem have used so far, in nanoseconds. Safe from any thread.
+long long eventLoop_subsystemCpuNs(const char* subsystem);
+
+// Runs handlers until eventLoop_stop is called.
+void eventLoop_run(void);
+
+// Safe from any thread.
+void eventLoop_stop(void);
+
+// Queues task(data) to run on the loop thread; data is copied. Never blocks. Lock-free for exactly one posting
+// thread (the inference thread). Returns false if the queue is full or data is too large.
+bool eventLoop_post(eventLoop_task task, const void* data, size_t size);
+
+void eventLoop_cleanup(void);
+
+// timerfd helpers: a non-blocking CLOCK_MONOTONIC timer, armed relative to now. intervalInMs of 0 is one-shot, and
+// firstInMs of 0 disarms.
+int eventLoop_createTimer(void);
+bool eventLoop_armTimer(int fd, long long firstInMs, long long intervalInMs);
+// Returns the number of expirations since the last read, 0 if none.
+long long eventLoop_readTimer(int fd);
+
+// Replays: timers run on a virtual clock that only moves when eventLoop_advanceClock says so, instead of on
+// CLOCK_MONOTONIC. A timer is then an eventfd the loop expires itself, one deadline at a time and in order, calling its
+// handler straight away, so a run of the same input fires the same timers in the same order however fast the CPU is.
+// Before eventLoop_init. A timer is forgotten once it is removed from the loop.
+void eventLoop_useVirtualClock(void);
+
+// Moves the virtual clock on to toMs and waits until the loop has expired every timer due by then. Not from the loop
+// thread. Returns false once the loop has stopped.
+bool eventLoop_advanceClock(long long toMs);
+
+// Milliseconds on the loop's clock: the virtual clock, from 0, or CLOCK_MONOTONIC.
+long long eventLoop_nowMs(void);
+
+#endif
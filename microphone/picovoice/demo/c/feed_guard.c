@@ -0,0 +1,182 @@
+#include "feed_guard.h"
+
+#include <time.h>
+
+#include "async_log.h"
+#include "feed_journal.h"
+#include "state_snapshot.h"
+
+#define US_PER_SECOND 1000000LL
+#define US_PER_HOUR (3600LL * US_PER_SECOND)
+
+typedef char snapshotHoldsEveryMode[(FEED_GUARD_MAX_MODES <= STATE_SNAPSHOT_MAX_MODES) ? 1 : -1];
+
+typedef struct {
+    feedGuard_limit limit;
+    bool isConfigured;
+    // replayed from the journal yet
+    bool isPrimed;
+    double tokens;
+    // CLOCK_MONOTONIC, when tokens was last brought up to date; and of the last feed let through, 0 if none
+    long long refilledUs;
+    long long lastFeedUs;
+} modeGuard;
+
+static modeGuard guards[FEED_GUARD_MAX_MODES];
+static feedGuard_stats stats;
+
+static long long nowUs(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (long long) now.tv_sec * US_PER_SECOND + now.tv_nsec / 1000;
+}
+
+static void refill(modeGuard* guard, long long atUs)
+{
+    if (atUs > guard->refilledUs) {
+        guard->tokens += (double) (atUs - guard->refilledUs) * guard->limit.feedsPerHour / US_PER_HOUR;
+        if (guard->tokens > guard->limit.burst) {
+            guard->tokens = guard->limit.burst;
+        }
+    }
+    guard->refilledUs = atUs;
+}
+
+static void take(modeGuard* guard, long long atUs)
+{
+    refill(guard, atUs);
+    guard->tokens = (guard->tokens >= 1.0) ? guard->tokens - 1.0 : 0.0;
+    guard->lastFeedUs = atUs;
+}
+
+// The bucket as the state snapshot has it, in wall clock time, for the next start.
+static void save(int mode, const modeGuard* guard)
+{
+    const long long toRealtime = nowUs(CLOCK_REALTIME) - nowUs(CLOCK_MONOTONIC);
+    stateSnapshot_state* state = stateSnapshot_begin();
+    state->guards[mode] = (stateSnapshot_guard) {guard->tokens, guard->refilledUs + toRealtime,
+            (guard->lastFeedUs != 0) ? guard->lastFeedUs + toRealtime : 0, guard->limit.feedsPerHour,
+            guard->limit.burst, 1};
+    stateSnapshot_commit();
+}
+
+// The bucket the last run left, if it was counted under the same limit. A time in the future, after the clock was put
+// back, counts as now.
+static bool restore(int mode, modeGuard* guard)
+{
+    stateSnapshot_state state;
+    stateSnapshot_read(&state);
+    const stateSnapshot_guard* saved = &state.guards[mode];
+    if (!saved->isSet || saved->feedsPerHour != guard->limit.feedsPerHour || saved->burst != guard->limit.burst) {
+        return false;
+    }
+    const long long now = nowUs(CLOCK_MONOTONIC);
+    const long long fromRealtime = now - nowUs(CLOCK_REALTIME);
+    guard->tokens = saved->tokens;
+    guard->refilledUs = (saved->refilledUs + fromRealtime < now) ? saved->refilledUs + fromRealtime : now;
+    guard->lastFeedUs = 0;
+    if (saved->lastFeedUs != 0) {
+        guard->lastFeedUs = (saved->lastFeedUs + fromRealtime < now) ? saved->lastFeedUs + fromRealtime : now;
+    }
+    refill(guard, now);
+    asyncLog_log(ASYNC_LOG_DEBUG, "Feed guard: mode %d carries on with %.2f of %d feeds.", mode, guard->tokens,
+            guard->limit.burst);
+    return true;
+}
+
+// Replays the mode's feeds from the time a full bucket takes to refill, oldest first. The journal is in wall clock
+// time; the bucket is in monotonic time, so a clock change while running can't refill it.
+static void prime(int mode, modeGuard* guard)
+{
+    guard->isPrimed = true;
+    if (restore(mode, guard)) {
+        return;
+    }
+    const long long now = nowUs(CLOCK_MONOTONIC);
+    const long long realNow = nowUs(CLOCK_REALTIME);
+    long long window = (guard->limit.feedsPerHour > 0)
+            ? (long long) (guard->limit.burst * US_PER_HOUR / guard->limit.feedsPerHour) : 0;
+    if (window < guard->limit.dedupMs * 1000LL) {
+        window = guard->limit.dedupMs * 1000LL;
+    }
+
+    long long feedsUs[FEED_GUARD_REPLAY_RECORDS];
+    int count = 0;
+    feedJournal_record record;
+    for (uint64_t back = 0; back < FEED_GUARD_REPLAY_RECORDS && feedJournal_getRecent(back, &record); back++) {
+        long long ageUs = realNow - record.timeUs;
+        if (ageUs > window) {
+            break;
+        }
+        if (record.mode == mode) {
+            feedsUs[count++] = now - ((ageUs > 0) ? ageUs : 0);
+        }
+    }
+
+    guard->tokens = guard->limit.burst;
+    guard->refilledUs = now - window;
+    guard->lastFeedUs = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        take(guard, feedsUs[i]);
+    }
+    refill(guard, now);
+    if (count > 0) {
+        asyncLog_log(ASYNC_LOG_DEBUG, "Feed guard: mode %d starts with %.2f of %d feeds, after %d in the journal.",
+                mode, guard->tokens, guard->limit.burst, count);
+    }
+}
+
+bool feedGuard_configure(int mode, const feedGuard_limit* limit)
+{
+    if (mode < 0 || mode >= FEED_GUARD_MAX_MODES || limit->feedsPerHour < 0 || limit->burst < 1
+            || limit->dedupMs < 0) {
+        return false;
+    }
+    guards[mode].limit = *limit;
+    guards[mode].isConfigured = true;
+    guards[mode].isPrimed = false;
+    return true;
+}
+
+feedGuard_verdict feedGuard_admit(int mode)
+{
+    if (mode < 0 || mode >= FEED_GUARD_MAX_MODES) {
+        return FEED_GUARD_ADMITTED;
+    }
+    modeGuard* guard = &guards[mode];
+    if (!guard->isConfigured) {
+        guard->limit = (feedGuard_limit) {
+                FEED_GUARD_DEFAULT_FEEDS_PER_HOUR, FEED_GUARD_DEFAULT_BURST, FEED_GUARD_DEFAULT_DEDUP_MS};
+        guard->isConfigured = true;
+    }
+    if (!guard->isPrimed) {
+        prime(mode, guard);
+    }
+
+    const long long now = nowUs(CLOCK_MONOTONIC);
+    if (guard->lastFeedUs != 0 && now - guard->lastFeedUs < guard->limit.dedupMs * 1000LL) {
+        stats.merged++;
+        asyncLog_log(ASYNC_LOG_INFO, "Feed guard: mode %d asked for again within %d s, merged with the last feed.",
+                mode, guard->limit.dedupMs / 1000);
+        return FEED_GUARD_MERGED;
+    }
+    if (guard->limit.feedsPerHour > 0) {
+        refill(guard, now);
+        if (guard->tokens < 1.0) {
+            stats.rateLimited++;
+            long long waitS = (long long) ((1.0 - guard->tokens) * 3600.0 / guard->limit.feedsPerHour) + 1;
+            asyncLog_log(ASYNC_LOG_WARN, "Feed guard: mode %d is over %.1f feeds an hour, next feed in %lld s.",
+                    mode, guard->limit.feedsPerHour, waitS);
+            return FEED_GUARD_RATE_LIMITED;
+        }
+    }
+    take(guard, now);
+    save(mode, guard);
+    return FEED_GUARD_ADMITTED;
+}
+
+void feedGuard_getStats(feedGuard_stats* out)
+{
+    *out = stats;
+}
@@ -0,0 +1,52 @@
+#ifndef FEED_GUARD_H
+#define FEED_GUARD_H
+
+#include <stdbool.h>
+
+// Keeps the fish from being overfed however often a feed is asked for. Each mode has a token bucket: a feed takes a
+// token, tokens come back at a steady rate up to a burst, and with none left the feed is refused. A feed asked for
+// again within the mode's dedup window of the last one let through is merged into it instead. Either way a request
+// costs O(1). The first request of a mode takes its bucket from the state snapshot (see state_snapshot.h), or, if the
+// limit has changed since, replays the mode's last feeds from the feed journal into it, so a restart doesn't hand out
+// a fresh burst. Everything but feedGuard_configure runs on the event loop thread.
+
+#define FEED_GUARD_MAX_MODES 8
+#define FEED_GUARD_DEFAULT_FEEDS_PER_HOUR 4.0
+#define FEED_GUARD_DEFAULT_BURST 2
+#define FEED_GUARD_DEFAULT_DEDUP_MS 30000
+// how far back into the journal a mode's bucket is replayed from, at most
+#define FEED_GUARD_REPLAY_RECORDS 256
+
+typedef struct {
+    // tokens regained per hour; 0 turns the rate limit off
+    double feedsPerHour;
+    // the most feeds let through in a row
+    int burst;
+    // 0 turns merging off
+    int dedupMs;
+} feedGuard_limit;
+
+typedef enum {
+    FEED_GUARD_ADMITTED,
+    // within the dedup window of the last feed of the mode
+    FEED_GUARD_MERGED,
+    // out of tokens
+    FEED_GUARD_RATE_LIMITED
+} feedGuard_verdict;
+
+typedef struct {
+    long long merged;
+    long long rateLimited;
+} feedGuard_stats;
+
+// Before the first feed is requested, e.g. while parsing options. Modes not configured get the defaults. Returns false
+// for a mode out of range or a limit that makes no sense.
+bool feedGuard_configure(int mode, const feedGuard_limit* limit);
+
+// Takes a token for a feed of the mode now, unless the verdict is to merge or refuse it.
+feedGuard_verdict feedGuard_admit(int mode);
+
+// Once the event loop has stopped.
+void feedGuard_getStats(feedGuard_stats* stats);
+
+#endif
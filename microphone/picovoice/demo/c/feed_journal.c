@@ -0,0 +1,408 @@
+#include "feed_journal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+#define JOURNAL_MAGIC "FEEDJNL1"
+// records start on a page boundary after the index, so appending never dirties an index page by accident
+#define JOURNAL_PAGE_SIZE 4096
+// the file grows by this many records at a time
+#define JOURNAL_GROWTH_RECORDS 4096
+// the camera reports a feed's consumption minutes after it, so the feed is always among the last few
+#define JOURNAL_CONSUMPTION_SEARCH 64
+
+typedef struct {
+    char magic[8];
+    uint32_t recordSize;
+    uint32_t maxDays;
+    uint64_t recordsOffset;
+    // written after the record it covers
+    uint64_t recordCount;
+    // written after the day entries covering those records
+    uint64_t indexedRecords;
+    uint32_t dayCount;
+    uint32_t reserved[5];
+} journalHeader;
+
+typedef char journalHeaderIs64Bytes[(sizeof(journalHeader) == 64) ? 1 : -1];
+typedef char recordIs16Bytes[(sizeof(feedJournal_record) == 16) ? 1 : -1];
+typedef char dayIs48Bytes[(sizeof(feedJournal_day) == 48) ? 1 : -1];
+
+static int fileFd = -1;
+static int syncTimerFd = -1;
+static unsigned char* base = NULL;
+static size_t mappedSize = 0;
+static bool isDirty = false;
+
+static journalHeader* header(void)
+{
+    return (journalHeader*) base;
+}
+
+static feedJournal_day* days(void)
+{
+    return (feedJournal_day*) (base + sizeof(journalHeader));
+}
+
+static feedJournal_record* records(void)
+{
+    return (feedJournal_record*) (base + header()->recordsOffset);
+}
+
+static uint64_t recordsOffset(void)
+{
+    uint64_t end = sizeof(journalHeader) + (uint64_t) FEED_JOURNAL_MAX_DAYS * sizeof(feedJournal_day);
+    return (end + JOURNAL_PAGE_SIZE - 1) / JOURNAL_PAGE_SIZE * JOURNAL_PAGE_SIZE;
+}
+
+static uint64_t recordCapacity(void)
+{
+    return (mappedSize - header()->recordsOffset) / sizeof(feedJournal_record);
+}
+
+int32_t feedJournal_dateOf(int64_t timeUs)
+{
+    time_t seconds = (time_t) (timeUs / 1000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+}
+
+static void countInDay(feedJournal_day* day, const feedJournal_record* record)
+{
+    day->feeds++;
+    day->durationMs += (uint32_t) record->durationMs;
+    if (record->tank < FEED_JOURNAL_MAX_TANKS) {
+        day->tankFeeds[record->tank]++;
+    }
+    if (record->source < FEED_JOURNAL_SOURCES) {
+        day->sourceFeeds[record->source]++;
+    }
+}
+
+// Adds record i, the first one not yet indexed, to its day. Returns false once the index is full.
+static bool indexRecord(uint64_t i)
+{
+    journalHeader* journal = header();
+    const feedJournal_record* record = &records()[i];
+    int32_t date = feedJournal_dateOf(record->timeUs);
+
+    feedJournal_day* last = (journal->dayCount > 0) ? &days()[journal->dayCount - 1] : NULL;
+    if (last != NULL && last->date == date) {
+        countInDay(last, record);
+    } else {
+        if (journal->dayCount == FEED_JOURNAL_MAX_DAYS) {
+            return false;
+        }
+        // filled in before it is counted, so a crash half way leaves no half-made day
+        feedJournal_day* day = &days()[journal->dayCount];
+        memset(day, 0, sizeof(*day));
+        day->date = date;
+        day->firstRecord = i;
+        countInDay(day, record);
+        __atomic_store_n(&journal->dayCount, journal->dayCount + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&journal->indexedRecords, i + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// After a crash between a record and its index entry, the last day may or may not count the records past
+// indexedRecords. Recounts that day from its records, then indexes the rest.
+static void repairIndex(void)
+{
+    journalHeader* journal = header();
+    if (journal->indexedRecords >= journal->recordCount) {
+        return;
+    }
+    if (journal->dayCount > 0) {
+        feedJournal_day* last = &days()[journal->dayCount - 1];
+        feedJournal_day recounted;
+        memset(&recounted, 0, sizeof(recounted));
+        recounted.date = last->date;
+        recounted.firstRecord = last->firstRecord;
+        for (uint64_t i = last->firstRecord; i < journal->indexedRecords; i++) {
+            countInDay(&recounted, &records()[i]);
+        }
+        *last = recounted;
+    }
+    for (uint64_t i = journal->indexedRecords; i < journal->recordCount; i++) {
+        if (!indexRecord(i)) {
+            break;
+        }
+    }
+    isDirty = true;
+}
+
+static bool mapFile(size_t size)
+{
+    if (base != NULL) {
+        munmap(base, mappedSize);
+        base = NULL;
+    }
+    void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileFd, 0);
+    if (mapped == MAP_FAILED) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: Unable to map the journal: %s", strerror(errno));
+        return false;
+    }
+    base = mapped;
+    mappedSize = size;
+    return true;
+}
+
+static bool grow(void)
+{
+    size_t size = mappedSize + JOURNAL_GROWTH_RECORDS * sizeof(feedJournal_record);
+    if (ftruncate(fileFd, (off_t) size) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: Unable to grow the journal: %s", strerror(errno));
+        return false;
+    }
+    return mapFile(size);
+}
+
+static bool isValid(const journalHeader* journal, size_t size)
+{
+    return memcmp(journal->magic, JOURNAL_MAGIC, sizeof(journal->magic)) == 0
+            && journal->recordSize == sizeof(feedJournal_record)
+            && journal->maxDays == FEED_JOURNAL_MAX_DAYS
+            && journal->recordsOffset == recordsOffset()
+            && journal->recordsOffset <= size
+            && journal->dayCount <= FEED_JOURNAL_MAX_DAYS
+            && journal->indexedRecords <= journal->recordCount
+            && journal->recordCount <= (size - journal->recordsOffset) / sizeof(feedJournal_record);
+}
+
+static void onSyncTimer(int fd, void* userData)
+{
+    (void) userData;
+    eventLoop_readTimer(fd);
+    feedJournal_sync();
+}
+
+// Only the parent of the journal; /var/lib is there already.
+static void makeDirectory(const char* path)
+{
+    char directory[PATH_MAX];
+    snprintf(directory, sizeof(directory), "%s", path);
+    char* slash = strrchr(directory, '/');
+    if (slash == NULL || slash == directory) {
+        return;
+    }
+    *slash = '\0';
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        asyncLog_log(ASYNC_LOG_WARN, "Feed journal: Unable to create %s: %s", directory, strerror(errno));
+    }
+}
+
+bool feedJournal_open(const char* path)
+{
+    makeDirectory(path);
+    fileFd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fileFd < 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: Unable to open %s: %s", path, strerror(errno));
+        return false;
+    }
+    struct stat status;
+    if (fstat(fileFd, &status) != 0) {
+        feedJournal_close();
+        return false;
+    }
+
+    if (status.st_size == 0) {
+        size_t size = recordsOffset() + JOURNAL_GROWTH_RECORDS * sizeof(feedJournal_record);
+        if (ftruncate(fileFd, (off_t) size) != 0 || !mapFile(size)) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: Unable to create %s.", path);
+            feedJournal_close();
+            return false;
+        }
+        journalHeader* journal = header();
+        memcpy(journal->magic, JOURNAL_MAGIC, sizeof(journal->magic));
+        journal->recordSize = sizeof(feedJournal_record);
+        journal->maxDays = FEED_JOURNAL_MAX_DAYS;
+        journal->recordsOffset = recordsOffset();
+        isDirty = true;
+    } else {
+        if (!mapFile((size_t) status.st_size)) {
+            feedJournal_close();
+            return false;
+        }
+        if ((size_t) status.st_size < sizeof(journalHeader) || !isValid(header(), mappedSize)) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: %s is not a feed journal, or from another version.", path);
+            feedJournal_close();
+            return false;
+        }
+        repairIndex();
+    }
+
+    syncTimerFd = eventLoop_createTimer();
+    if (syncTimerFd >= 0 && !eventLoop_add(syncTimerFd, EPOLLIN, onSyncTimer, NULL)) {
+        close(syncTimerFd);
+        syncTimerFd = -1;
+    }
+    if (syncTimerFd >= 0) {
+        eventLoop_setSubsystem(syncTimerFd, "feeds");
+    } else {
+        asyncLog_log(ASYNC_LOG_WARN, "Feed journal: no sync timer, feeds reach the disk at shutdown only.");
+    }
+    return true;
+}
+
+// One sync a while after the first change since the last, rather than one per feed; feeds are seconds long, so it
+// lands long after the gate has closed.
+static void markDirty(void)
+{
+    if (!isDirty && syncTimerFd >= 0) {
+        eventLoop_armTimer(syncTimerFd, FEED_JOURNAL_SYNC_INTERVAL_MS, 0);
+    }
+    isDirty = true;
+}
+
+bool feedJournal_append(const feedJournal_record* record)
+{
+    if (base == NULL) {
+        return false;
+    }
+    uint64_t count = header()->recordCount;
+    if (count == recordCapacity() && !grow()) {
+        return false;
+    }
+    records()[count] = *record;
+    __atomic_store_n(&header()->recordCount, count + 1, __ATOMIC_RELEASE);
+    if (header()->indexedRecords == count) {
+        indexRecord(count);
+    }
+
+    markDirty();
+    return true;
+}
+
+bool feedJournal_setConsumption(int64_t timeUs, uint8_t consumption)
+{
+    if (base == NULL) {
+        return false;
+    }
+    uint64_t count = header()->recordCount;
+    for (uint64_t back = 0; back < count && back < JOURNAL_CONSUMPTION_SEARCH; back++) {
+        feedJournal_record* record = &records()[count - 1 - back];
+        if (record->timeUs == timeUs) {
+            record->consumption = consumption;
+            markDirty();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool feedJournal_getRecent(uint64_t back, feedJournal_record* record)
+{
+    if (base == NULL || back >= header()->recordCount) {
+        return false;
+    }
+    *record = records()[header()->recordCount - 1 - back];
+    return true;
+}
+
+bool feedJournal_getLastDay(feedJournal_day* day)
+{
+    if (base == NULL || header()->dayCount == 0) {
+        return false;
+    }
+    *day = days()[header()->dayCount - 1];
+    return true;
+}
+
+void feedJournal_sync(void)
+{
+    if (base == NULL || !isDirty) {
+        return;
+    }
+    if (msync(base, mappedSize, MS_SYNC) != 0 || fdatasync(fileFd) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Feed journal: Unable to sync: %s", strerror(errno));
+        return;
+    }
+    isDirty = false;
+}
+
+void feedJournal_close(void)
+{
+    if (syncTimerFd >= 0) {
+        eventLoop_remove(syncTimerFd);
+        close(syncTimerFd);
+        syncTimerFd = -1;
+    }
+    feedJournal_sync();
+    if (base != NULL) {
+        munmap(base, mappedSize);
+        base = NULL;
+        mappedSize = 0;
+    }
+    if (fileFd >= 0) {
+        close(fileFd);
+        fileFd = -1;
+    }
+    isDirty = false;
+}
+
+bool feedJournal_openView(const char* path, feedJournal_view* view)
+{
+    memset(view, 0, sizeof(*view));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Feed journal: Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(journalHeader)) {
+        fprintf(stderr, "Feed journal: %s is not a feed journal.\n", path);
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Feed journal: Unable to map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    const journalHeader* journal = mapped;
+    // the writer may be appending; counts are read once, each after what it covers
+    journalHeader snapshot = *journal;
+    snapshot.recordCount = __atomic_load_n(&journal->recordCount, __ATOMIC_ACQUIRE);
+    snapshot.indexedRecords = __atomic_load_n(&journal->indexedRecords, __ATOMIC_ACQUIRE);
+    snapshot.dayCount = __atomic_load_n(&journal->dayCount, __ATOMIC_ACQUIRE);
+    if (snapshot.indexedRecords > snapshot.recordCount) {
+        snapshot.indexedRecords = snapshot.recordCount;
+    }
+    if (!isValid(&snapshot, (size_t) status.st_size)) {
+        fprintf(stderr, "Feed journal: %s is not a feed journal, or from another version.\n", path);
+        munmap(mapped, (size_t) status.st_size);
+        return false;
+    }
+
+    view->base = mapped;
+    view->size = (size_t) status.st_size;
+    view->days = (const feedJournal_day*) ((const unsigned char*) mapped + sizeof(journalHeader));
+    view->dayCount = snapshot.dayCount;
+    view->records = (const feedJournal_record*) ((const unsigned char*) mapped + snapshot.recordsOffset);
+    view->recordCount = snapshot.recordCount;
+    view->indexedRecords = snapshot.indexedRecords;
+    return true;
+}
+
+void feedJournal_closeView(feedJournal_view* view)
+{
+    if (view->base != NULL) {
+        munmap(view->base, view->size);
+    }
+    memset(view, 0, sizeof(*view));
+}
@@ -0,0 +1,101 @@
+#ifndef FEED_JOURNAL_H
+#define FEED_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Every feed, kept across reboots. The journal is one memory-mapped file: a header, an index with one summary per
+// day that had feeds, and then fixed-size feed records in the order they were appended. A record is written before
+// the count that covers it, so a crash of the demo loses at most the feed being written. Dirty pages go to disk a
+// while after a feed rather than on every feed, so a power cut can lose the feeds of the last minute. Readers map
+// the same file and get daily counts from the index alone, without scanning the records. The writer runs on the event
+// loop thread.
+
+#define FEED_JOURNAL_DEFAULT_PATH "/var/lib/fishfeeder/feeds.journal"
+#define FEED_JOURNAL_MAX_TANKS 8
+#define FEED_JOURNAL_MAX_DAYS 4096
+#define FEED_JOURNAL_SYNC_INTERVAL_MS 60000
+// a record's consumption counts in these, and saturates below FEED_JOURNAL_LEFT_OVER
+#define FEED_JOURNAL_CONSUMPTION_UNIT_SEC 2
+// the camera still saw pellets when it stopped watching
+#define FEED_JOURNAL_LEFT_OVER 255
+
+typedef enum {
+    FEED_JOURNAL_SOURCE_VOICE = 0,
+    FEED_JOURNAL_SOURCE_BUTTON,
+    // a repeat of a recurring feed
+    FEED_JOURNAL_SOURCE_SCHEDULE,
+    // asked for over the control socket
+    FEED_JOURNAL_SOURCE_CONTROL,
+    FEED_JOURNAL_SOURCES
+} feedJournal_source;
+
+typedef struct {
+    // CLOCK_REALTIME when the gate started to open, in microseconds
+    int64_t timeUs;
+    // from the start of the feed until the gate closed
+    int32_t durationMs;
+    uint8_t mode;
+    uint8_t tank;
+    // a feedJournal_source
+    uint8_t source;
+    // how long the fish took to eat it, in FEED_JOURNAL_CONSUMPTION_UNIT_SEC, as the camera saw it: 0 if it didn't
+    // report, FEED_JOURNAL_LEFT_OVER if pellets were still there at the end of its watch
+    uint8_t consumption;
+} feedJournal_record;
+
+typedef struct {
+    // local date the feeds started on, e.g. 20260314
+    int32_t date;
+    uint32_t feeds;
+    uint64_t firstRecord;
+    uint32_t durationMs;
+    uint16_t tankFeeds[FEED_JOURNAL_MAX_TANKS];
+    uint16_t sourceFeeds[FEED_JOURNAL_SOURCES];
+    uint16_t reserved[2];
+} feedJournal_day;
+
+// A read-only mapping of a journal, e.g. for feed_journal_query.
+typedef struct {
+    const feedJournal_day* days;
+    uint32_t dayCount;
+    const feedJournal_record* records;
+    uint64_t recordCount;
+    // records past this are in no day of the index, which only happens once it is full
+    uint64_t indexedRecords;
+    void* base;
+    size_t size;
+} feedJournal_view;
+
+// Creates the journal, and its directory, if they don't exist, and adds its sync timer to the event loop, which has
+// to be initialised.
+bool feedJournal_open(const char* path);
+
+// Appends a feed and adds it to the day it started on. Returns false if the journal isn't open or can't grow.
+bool feedJournal_append(const feedJournal_record* record);
+
+// Records the camera's consumption for the feed that started at timeUs, one of the last few. Returns false if there
+// is no such feed, or the journal isn't open.
+bool feedJournal_setConsumption(int64_t timeUs, uint8_t consumption);
+
+// Reads back the feed that many before the newest, 0 being the newest. Returns false past the oldest, or if the journal
+// isn't open.
+bool feedJournal_getRecent(uint64_t back, feedJournal_record* record);
+
+// Reads back the summary of the newest day that had feeds. Returns false if there is none, or the journal isn't open.
+bool feedJournal_getLastDay(feedJournal_day* day);
+
+// Writes the dirty pages out now, e.g. before shutdown.
+void feedJournal_sync(void);
+
+void feedJournal_close(void);
+
+bool feedJournal_openView(const char* path, feedJournal_view* view);
+
+void feedJournal_closeView(feedJournal_view* view);
+
+// The local date of a CLOCK_REALTIME time, as in feedJournal_day.
+int32_t feedJournal_dateOf(int64_t timeUs);
+
+#endif
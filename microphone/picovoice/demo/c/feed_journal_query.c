@@ -0,0 +1,158 @@
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "feed_journal.h"
+
+// Prints the feeds of the last few days from the feed journal's day index: how many, how long the gate was open, and
+// how many per tank and per source. Only the index is read, however long the journal, unless it has filled up; then
+// the records past it are counted too. Safe to run while the demo is appending.
+
+static const char *sourceNames[FEED_JOURNAL_SOURCES] = {"voice", "button", "schedule", "control"};
+
+static struct option long_options[] = {
+        {"journal_path", required_argument, NULL, 'j'},
+        {"days",         required_argument, NULL, 'd'},
+        {"records",      required_argument, NULL, 'r'},
+        {NULL,           0,                 NULL, 0},
+};
+
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage : %s [--journal_path JOURNAL_PATH --days N --records N]\n", program_name);
+}
+
+static int usedTanks(const feedJournal_day *days, uint32_t count) {
+    int tanks = 1;
+    for (uint32_t i = 0; i < count; i++) {
+        for (int tank = tanks; tank < FEED_JOURNAL_MAX_TANKS; tank++) {
+            if (days[i].tankFeeds[tank] > 0) {
+                tanks = tank + 1;
+            }
+        }
+    }
+    return tanks;
+}
+
+static void printDay(const feedJournal_day *day, int tanks) {
+    printf("%04d-%02d-%02d %6u %8.1f", day->date / 10000, day->date / 100 % 100, day->date % 100, day->feeds,
+            day->durationMs / 1000.0);
+    for (int tank = 0; tank < tanks; tank++) {
+        printf(" %6u", day->tankFeeds[tank]);
+    }
+    for (int source = 0; source < FEED_JOURNAL_SOURCES; source++) {
+        printf(" %8u", day->sourceFeeds[source]);
+    }
+    printf("\n");
+}
+
+static void countRecord(feedJournal_day *day, const feedJournal_record *record) {
+    day->feeds++;
+    day->durationMs += (uint32_t) record->durationMs;
+    if (record->tank < FEED_JOURNAL_MAX_TANKS) {
+        day->tankFeeds[record->tank]++;
+    }
+    if (record->source < FEED_JOURNAL_SOURCES) {
+        day->sourceFeeds[record->source]++;
+    }
+}
+
+static void printDays(const feedJournal_view *view, int32_t dayLimit) {
+    uint32_t first = (view->dayCount > (uint32_t) dayLimit) ? view->dayCount - (uint32_t) dayLimit : 0;
+    int tanks = usedTanks(view->days + first, view->dayCount - first);
+
+    printf("date        feeds  open_sec");
+    for (int tank = 0; tank < tanks; tank++) {
+        printf("  tank%d", tank + 1);
+    }
+    for (int source = 0; source < FEED_JOURNAL_SOURCES; source++) {
+        printf(" %8s", sourceNames[source]);
+    }
+    printf("\n");
+
+    for (uint32_t i = first; i < view->dayCount; i++) {
+        printDay(&view->days[i], tanks);
+    }
+
+    // once the index is full, the rest are counted from the records, one day at a time; short of that, records past
+    // it are only the one being appended, and already in its day
+    if (view->dayCount < FEED_JOURNAL_MAX_DAYS) {
+        return;
+    }
+    feedJournal_day tail;
+    memset(&tail, 0, sizeof(tail));
+    for (uint64_t i = view->indexedRecords; i < view->recordCount; i++) {
+        int32_t date = feedJournal_dateOf(view->records[i].timeUs);
+        if (tail.feeds > 0 && tail.date != date) {
+            printDay(&tail, tanks);
+            memset(&tail, 0, sizeof(tail));
+        }
+        tail.date = date;
+        countRecord(&tail, &view->records[i]);
+    }
+    if (tail.feeds > 0) {
+        printDay(&tail, tanks);
+    }
+}
+
+static void printRecords(const feedJournal_view *view, int64_t recordLimit) {
+    uint64_t first = (view->recordCount > (uint64_t) recordLimit) ? view->recordCount - (uint64_t) recordLimit : 0;
+    printf("\nstarted              mode  tank  source    open_sec  eaten_in\n");
+    for (uint64_t i = first; i < view->recordCount; i++) {
+        const feedJournal_record *record = &view->records[i];
+        time_t seconds = (time_t) (record->timeUs / 1000000);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        char started[32];
+        strftime(started, sizeof(started), "%Y-%m-%d %H:%M:%S", &local);
+        char eaten[16] = "-";
+        if (record->consumption == FEED_JOURNAL_LEFT_OVER) {
+            snprintf(eaten, sizeof(eaten), "left");
+        } else if (record->consumption != 0) {
+            snprintf(eaten, sizeof(eaten), "%us", record->consumption * FEED_JOURNAL_CONSUMPTION_UNIT_SEC);
+        }
+        printf("%s  %4u  %4u  %-8s %8.1f  %8s\n", started, record->mode, record->tank + 1,
+                (record->source < FEED_JOURNAL_SOURCES) ? sourceNames[record->source] : "?",
+                record->durationMs / 1000.0, eaten);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *journal_path = FEED_JOURNAL_DEFAULT_PATH;
+    int32_t days = 7;
+    int64_t records = 0;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "j:d:r:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'j':
+                journal_path = optarg;
+                break;
+            case 'd':
+                days = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'r':
+                records = strtoll(optarg, NULL, 10);
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+    if ((days < 0) || (records < 0) || (optind != argc)) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    feedJournal_view view;
+    if (!feedJournal_openView(journal_path, &view)) {
+        exit(1);
+    }
+    printDays(&view, days);
+    if (records > 0) {
+        printRecords(&view, records);
+    }
+    feedJournal_closeView(&view);
+    return 0;
+}
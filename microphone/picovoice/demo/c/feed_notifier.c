@@ -0,0 +1,52 @@
+#include "feed_notifier.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "board_link.h"
+
+static int socketFd = -1;
+static struct sockaddr_un captureAddress;
+
+bool feedNotifier_open(const char* path)
+{
+    if (strlen(path) >= sizeof(captureAddress.sun_path)) {
+        printf("Feed notifier: socket path too long: %s\n", path);
+        return false;
+    }
+    socketFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) {
+        perror("Feed notifier: Unable to create socket.");
+        return false;
+    }
+    memset(&captureAddress, 0, sizeof(captureAddress));
+    captureAddress.sun_family = AF_UNIX;
+    strcpy(captureAddress.sun_path, path);
+    return true;
+}
+
+void feedNotifier_send(int mode, long long timeUs)
+{
+    char message[48];
+    int length = snprintf(message, sizeof(message), "feed %d %lld\n", mode, timeUs);
+    // in fishfeeder, capture is in this process
+    if (boardLink_send(message) || socketFd < 0) {
+        return;
+    }
+    if (sendto(socketFd, message, length, 0, (struct sockaddr*) &captureAddress, sizeof(captureAddress)) < 0
+            && errno != ENOENT && errno != ECONNREFUSED && errno != EAGAIN) {
+        perror("Feed notifier: Unable to reach capture.");
+    }
+}
+
+void feedNotifier_close(void)
+{
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
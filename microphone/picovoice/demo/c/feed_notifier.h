@@ -0,0 +1,19 @@
+#ifndef FEED_NOTIFIER_H
+#define FEED_NOTIFIER_H
+
+#include <stdbool.h>
+
+// Tells the camera's capture program that a feed has started, so it can save a clip around it, stream at full rate and
+// watch the pellets being eaten; it names the feed by its journal time when it reports back. Each notice is one datagram on a Unix socket that capture binds; nothing waits for an answer, and notices are
+// simply lost while capture isn't running.
+
+#define FEED_NOTIFIER_DEFAULT_PATH "/tmp/fishfeeder-feed.sock"
+
+bool feedNotifier_open(const char* path);
+
+// timeUs is the feed's feedJournal_record time.
+void feedNotifier_send(int mode, long long timeUs);
+
+void feedNotifier_close(void);
+
+#endif
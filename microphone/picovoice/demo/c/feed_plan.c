@@ -0,0 +1,154 @@
+#include "feed_plan.h"
+
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "env_sensor.h"
+#include "event_loop.h"
+#include "feed_journal.h"
+#include "feed_scheduler.h"
+
+// after midnight, so the new day's date is certain
+#define MIDNIGHT_MARGIN_MS 1000
+
+static feedPlan_config config;
+static feedPlan_day plan;
+static int timerFd = -1;
+
+// Share of the day's feeds for the coldest band the water is in; all of them without a reading or a band.
+static int percentFor(int waterMilliC)
+{
+    int percent = 100;
+    int bandMilliC = 0;
+    bool inBand = false;
+    for (int i = 0; i < FEED_PLAN_MAX_BANDS; i++) {
+        const feedPlan_band* band = &config.bands[i];
+        if (band->percent >= 0 && waterMilliC != ENV_SENSOR_NO_READING && waterMilliC < band->belowMilliC &&
+            (!inBand || band->belowMilliC < bandMilliC)) {
+            percent = band->percent;
+            bandMilliC = band->belowMilliC;
+            inBand = true;
+        }
+    }
+    return percent;
+}
+
+static long long msUntil(const struct tm* today, int minuteOfDay, const struct timespec* now)
+{
+    struct tm at = *today;
+    at.tm_hour = minuteOfDay / 60;
+    at.tm_min = minuteOfDay % 60;
+    at.tm_sec = 0;
+    at.tm_isdst = -1;
+    return ((long long) mktime(&at) - now->tv_sec) * 1000 - now->tv_nsec / 1000000;
+}
+
+static void makePlan(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    struct tm today;
+    localtime_r(&now.tv_sec, &today);
+
+    // the configured times, sorted
+    feedPlan_entry all[FEED_PLAN_MAX_TIMES];
+    int count = 0;
+    for (int i = 0; i < FEED_PLAN_MAX_TIMES; i++) {
+        const feedPlan_time* time = &config.times[i];
+        if (time->minuteOfDay < 0) {
+            continue;
+        }
+        int at = count++;
+        while (at > 0 && all[at - 1].minuteOfDay > time->minuteOfDay) {
+            all[at] = all[at - 1];
+            at--;
+        }
+        all[at] = (feedPlan_entry) {(int16_t) time->minuteOfDay, (uint8_t) time->mode, (uint8_t) time->tank};
+    }
+
+    plan.date = feedJournal_dateOf((int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000);
+    plan.waterMilliC = envSensor_milliC(ENV_SENSOR_WATER);
+    plan.percent = percentFor(plan.waterMilliC);
+    const int kept = (count * plan.percent + 50) / 100;
+    plan.count = 0;
+    // entry i is kept where the running share of kept feeds steps up, which spreads them over the day
+    for (int i = 0; i < count; i++) {
+        if ((i + 1) * kept / count > i * kept / count) {
+            plan.entries[plan.count++] = all[i];
+        }
+    }
+
+    feedRequest requests[FEED_PLAN_MAX_TIMES];
+    long long delaysInMs[FEED_PLAN_MAX_TIMES];
+    int upcoming = 0;
+    for (int i = 0; i < plan.count; i++) {
+        const long long delayInMs = msUntil(&today, plan.entries[i].minuteOfDay, &now);
+        if (delayInMs > 0) {
+            requests[upcoming] = (feedRequest) {plan.entries[i].mode, plan.entries[i].tank,
+                                                FEED_JOURNAL_SOURCE_SCHEDULE};
+            delaysInMs[upcoming++] = delayInMs;
+        }
+    }
+    feedScheduler_replacePlanned(requests, delaysInMs, upcoming);
+    if (count > 0) {
+        asyncLog_log(ASYNC_LOG_INFO, "Feed plan: %d of %d feeds today, %d still to come.", plan.count, count, upcoming);
+    }
+
+    // the next plan with the next day
+    struct tm midnight = today;
+    midnight.tm_mday++;
+    midnight.tm_hour = 0;
+    midnight.tm_min = 0;
+    midnight.tm_sec = 0;
+    midnight.tm_isdst = -1;
+    const long long untilMidnightMs = ((long long) mktime(&midnight) - now.tv_sec) * 1000 - now.tv_nsec / 1000000;
+    eventLoop_armTimer(timerFd, untilMidnightMs + MIDNIGHT_MARGIN_MS, 0);
+}
+
+static void onTimer(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) > 0) {
+        makePlan();
+    }
+}
+
+bool feedPlan_start(const feedPlan_config* newConfig)
+{
+    config = *newConfig;
+    plan.count = 0;
+    plan.waterMilliC = ENV_SENSOR_NO_READING;
+    plan.percent = 100;
+    timerFd = eventLoop_createTimer();
+    if (timerFd < 0 || !eventLoop_add(timerFd, EPOLLIN, onTimer, NULL) ||
+        !eventLoop_armTimer(timerFd, FEED_PLAN_FIRST_DELAY_MS, 0)) {
+        feedPlan_stop();
+        return false;
+    }
+    eventLoop_setSubsystem(timerFd, "feeds");
+    return true;
+}
+
+void feedPlan_configure(const feedPlan_config* newConfig)
+{
+    config = *newConfig;
+    if (timerFd >= 0) {
+        makePlan();
+    }
+}
+
+const feedPlan_day* feedPlan_today(void)
+{
+    return &plan;
+}
+
+void feedPlan_stop(void)
+{
+    if (timerFd >= 0) {
+        eventLoop_remove(timerFd);
+        close(timerFd);
+        timerFd = -1;
+    }
+}
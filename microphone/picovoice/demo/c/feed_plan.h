@@ -0,0 +1,59 @@
+#ifndef FEED_PLAN_H
+#define FEED_PLAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The day's feeds, worked out once from the configured feed times and the water temperature rather than checked on
+// every tick. Each plan is a short array of entries sorted by time of day, and its feeds still to come are handed to
+// the feed scheduler as one-off events, so they queue for the servo alongside voice, button and control feeds. A plan
+// is made FEED_PLAN_FIRST_DELAY_MS after start, once the water has been read, then just after every local midnight
+// and whenever the config changes. Fish eat less in cold water: the coldest temperature band the water is in sets
+// what share of the day's feeds is kept, spread evenly over the day. Everything here runs on the event loop thread.
+
+#define FEED_PLAN_MAX_TIMES 8
+#define FEED_PLAN_MAX_BANDS 4
+#define FEED_PLAN_FIRST_DELAY_MS 3000
+
+typedef struct {
+    int minuteOfDay; // -1 if not set
+    int mode;
+    int tank;
+} feedPlan_time;
+
+typedef struct {
+    int belowMilliC;
+    int percent; // of the day's feeds kept while the water is below belowMilliC; -1 if not set
+} feedPlan_band;
+
+typedef struct {
+    // in any order, with gaps
+    feedPlan_time times[FEED_PLAN_MAX_TIMES];
+    feedPlan_band bands[FEED_PLAN_MAX_BANDS];
+} feedPlan_config;
+
+typedef struct {
+    int16_t minuteOfDay;
+    uint8_t mode;
+    uint8_t tank;
+} feedPlan_entry;
+
+typedef struct {
+    int32_t date;    // as feedJournal_dateOf
+    int waterMilliC; // the reading the plan was made with, or ENV_SENSOR_NO_READING
+    int percent;     // of the configured feeds kept
+    int count;
+    feedPlan_entry entries[FEED_PLAN_MAX_TIMES]; // by minuteOfDay
+} feedPlan_day;
+
+// feedScheduler_start first. The config is copied.
+bool feedPlan_start(const feedPlan_config* config);
+
+// A reloaded config: the plan is made again, and today's feeds still to come follow it.
+void feedPlan_configure(const feedPlan_config* config);
+
+const feedPlan_day* feedPlan_today(void);
+
+void feedPlan_stop(void);
+
+#endif
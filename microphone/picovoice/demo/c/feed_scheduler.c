@@ -0,0 +1,237 @@
+#include "feed_scheduler.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+#include "feed_journal.h"
+#include "state_snapshot.h"
+
+#define NS_PER_MS 1000000LL
+#define NS_PER_SECOND 1000000000LL
+#define NS_PER_US 1000LL
+
+typedef char snapshotHoldsEveryEvent[(FEED_SCHEDULER_MAX_EVENTS <= STATE_SNAPSHOT_MAX_FEEDS) ? 1 : -1];
+
+typedef struct {
+    long long dueInNs; // CLOCK_MONOTONIC
+    long long intervalInNs;
+    feedRequest request;
+    // from feedScheduler_replacePlanned
+    bool isPlanned;
+} feedEvent;
+
+static int timerFd = -1;
+static feedScheduler_skipFunc skipFunc = NULL;
+
+// sorted by dueInNs, earliest first
+static feedEvent events[FEED_SCHEDULER_MAX_EVENTS];
+static int eventCount = 0;
+
+static long long nowInNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+static long long realtimeNowInNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long) now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+// Keeps every event but the day's plan, which feed_plan.c makes again on start, in the state snapshot, in wall clock
+// time so that it means the same after a reboot.
+static void saveEvents(void)
+{
+    const long long toRealtime = realtimeNowInNs() - nowInNs();
+    stateSnapshot_state* state = stateSnapshot_begin();
+    state->feedCount = 0;
+    for (int i = 0; i < eventCount; i++) {
+        if (!events[i].isPlanned) {
+            const feedRequest* request = &events[i].request;
+            state->feeds[state->feedCount++] = (stateSnapshot_feed) {(events[i].dueInNs + toRealtime) / NS_PER_US,
+                    events[i].intervalInNs / NS_PER_US, request->mode, request->tank, request->source,
+                    request->portion};
+        }
+    }
+    stateSnapshot_commit();
+}
+
+// Points the timer at the earliest event, or disarms it.
+static void armTimer(void)
+{
+    struct itimerspec spec = {{0, 0}, {0, 0}};
+    if (eventCount > 0) {
+        spec.it_value.tv_sec = events[0].dueInNs / NS_PER_SECOND;
+        spec.it_value.tv_nsec = events[0].dueInNs % NS_PER_SECOND;
+    }
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, NULL) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Feed scheduler: Unable to arm timer: %s", strerror(errno));
+    }
+}
+
+static bool insertEvent(feedEvent event)
+{
+    if (eventCount == FEED_SCHEDULER_MAX_EVENTS) {
+        return false;
+    }
+    int i = eventCount;
+    while (i > 0 && events[i - 1].dueInNs > event.dueInNs) {
+        events[i] = events[i - 1];
+        i--;
+    }
+    events[i] = event;
+    eventCount++;
+    return true;
+}
+
+static void onTimer(int fd, void* userData)
+{
+    (void) userData;
+    uint64_t expirations;
+    if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+
+    const long long now = nowInNs();
+    while (eventCount > 0 && events[0].dueInNs <= now) {
+        feedEvent due = events[0];
+        for (int i = 1; i < eventCount; i++) {
+            events[i - 1] = events[i];
+        }
+        eventCount--;
+
+        if (due.intervalInNs == 0 || skipFunc == NULL || !skipFunc(&due.request)) {
+            feedWorker_request(&due.request);
+        }
+        if (due.intervalInNs > 0) {
+            due.request.source = FEED_JOURNAL_SOURCE_SCHEDULE;
+            // next slot after now, so a late wake-up doesn't release a burst of catch-up feeds
+            long long missed = (now - due.dueInNs) / due.intervalInNs;
+            due.dueInNs += (missed + 1) * due.intervalInNs;
+            insertEvent(due);
+        }
+    }
+    armTimer();
+    saveEvents();
+}
+
+// What the last run left pending. A recurring event that fell due while the feeder was down carries on from its next
+// slot; a one-off one goes ahead at once, unless it is more than FEED_SCHEDULER_LATE_LIMIT_MS late, since a feed hours
+// late may well be a feed too many. The feed guard has the last word either way.
+static void restoreEvents(void)
+{
+    stateSnapshot_state state;
+    stateSnapshot_read(&state);
+    const long long now = nowInNs();
+    const long long fromRealtime = now - realtimeNowInNs();
+    int dropped = 0;
+    for (uint32_t i = 0; i < state.feedCount && i < FEED_SCHEDULER_MAX_EVENTS; i++) {
+        const stateSnapshot_feed* feed = &state.feeds[i];
+        feedEvent event = {feed->dueUs * NS_PER_US + fromRealtime, feed->intervalUs * NS_PER_US,
+                {feed->mode, feed->tank, feed->source, feed->portion}, false};
+        if (event.dueInNs < now && event.intervalInNs > 0) {
+            event.dueInNs += ((now - event.dueInNs) / event.intervalInNs + 1) * event.intervalInNs;
+        } else if (event.dueInNs < now - FEED_SCHEDULER_LATE_LIMIT_MS * NS_PER_MS) {
+            dropped++;
+            continue;
+        }
+        insertEvent(event);
+    }
+    if (eventCount > 0 || dropped > 0) {
+        asyncLog_log(ASYNC_LOG_INFO, "Feed scheduler: %d pending feeds carried on, %d dropped as too late.", eventCount,
+                dropped);
+    }
+    armTimer();
+}
+
+bool feedScheduler_start(feedScheduler_skipFunc skipFor)
+{
+    skipFunc = skipFor;
+    timerFd = eventLoop_createTimer();
+    if (timerFd < 0) {
+        return false;
+    }
+    eventCount = 0;
+    if (!eventLoop_add(timerFd, EPOLLIN, onTimer, NULL)) {
+        close(timerFd);
+        timerFd = -1;
+        return false;
+    }
+    eventLoop_setSubsystem(timerFd, "feeds");
+    restoreEvents();
+    return true;
+}
+
+bool feedScheduler_schedule(const feedRequest* request, long long delayInMs, long long intervalInMs)
+{
+    if (timerFd < 0 || delayInMs < 0 || intervalInMs < 0) {
+        return false;
+    }
+    feedEvent event = {nowInNs() + delayInMs * NS_PER_MS, intervalInMs * NS_PER_MS, *request, false};
+
+    bool added = insertEvent(event);
+    if (added && events[0].dueInNs == event.dueInNs) {
+        armTimer();
+    }
+    if (added) {
+        saveEvents();
+    } else {
+        asyncLog_log(ASYNC_LOG_WARN, "Feed scheduler: too many pending feeds.");
+    }
+    return added;
+}
+
+bool feedScheduler_replacePlanned(const feedRequest* requests, const long long* delaysInMs, int count)
+{
+    if (timerFd < 0) {
+        return false;
+    }
+    int kept = 0;
+    for (int i = 0; i < eventCount; i++) {
+        if (!events[i].isPlanned) {
+            events[kept++] = events[i];
+        }
+    }
+    eventCount = kept;
+
+    const long long now = nowInNs();
+    bool added = true;
+    for (int i = 0; i < count && added; i++) {
+        feedEvent event = {now + delaysInMs[i] * NS_PER_MS, 0, requests[i], true};
+        added = insertEvent(event);
+    }
+    if (!added) {
+        asyncLog_log(ASYNC_LOG_WARN, "Feed scheduler: too many pending feeds for the day's plan.");
+    }
+    armTimer();
+    return added;
+}
+
+void feedScheduler_cancelAll(void)
+{
+    eventCount = 0;
+    armTimer();
+    saveEvents();
+}
+
+void feedScheduler_stop(void)
+{
+    if (timerFd < 0) {
+        return;
+    }
+    eventLoop_remove(timerFd);
+    close(timerFd);
+    timerFd = -1;
+    eventCount = 0;
+}
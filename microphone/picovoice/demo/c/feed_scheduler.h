@@ -0,0 +1,37 @@
+#ifndef FEED_SCHEDULER_H
+#define FEED_SCHEDULER_H
+
+#include <stdbool.h>
+
+#include "feed_worker.h"
+
+// Delayed and recurring feeds. Pending events are kept sorted by due time and a timerfd on the event loop is armed for
+// the earliest of them; when an event is due it is handed to the feed worker. Everything here runs on the event loop
+// thread. All but the planned events are kept in the state snapshot (see state_snapshot.h), so a restart carries on
+// with them.
+
+#define FEED_SCHEDULER_MAX_EVENTS 16
+// a one-off event this late by the time the feeder is back is dropped
+#define FEED_SCHEDULER_LATE_LIMIT_MS (10 * 60 * 1000)
+
+// Asked before each feed of a recurring event is handed on; true skips that one feed, and the event carries on.
+typedef bool (*feedScheduler_skipFunc)(const feedRequest* request);
+
+// skipFor may be NULL.
+bool feedScheduler_start(feedScheduler_skipFunc skipFor);
+
+// intervalInMs of 0 makes a one-off event. Every repeat after the first is requested as FEED_JOURNAL_SOURCE_SCHEDULE.
+// Returns false if there is no room for another event.
+bool feedScheduler_schedule(const feedRequest* request, long long delayInMs, long long intervalInMs);
+
+// The day's plan (see feed_plan.h): drops the one-off events an earlier call added and adds one per request, due
+// after the matching delay. Returns false if not all of them fit.
+bool feedScheduler_replacePlanned(const feedRequest* requests, const long long* delaysInMs, int count);
+
+// Drops every pending event, one-off, recurring and planned.
+void feedScheduler_cancelAll(void);
+
+// Leaves the pending events in the state snapshot, for the next start.
+void feedScheduler_stop(void);
+
+#endif
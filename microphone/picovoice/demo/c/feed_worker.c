@@ -0,0 +1,113 @@
+#include "feed_worker.h"
+
+#include <stdio.h>
+
+#include "async_log.h"
+#include "feed_guard.h"
+#include "latency_trace.h"
+
+#define MAX_MODES 8
+
+static feedCoalescePolicy coalescePolicy = FEED_COALESCE_ACTIVE;
+static feedWorker_profileFunc profileFunc = NULL;
+static feedWorker_fedFunc startedFunc = NULL;
+static feedWorker_fedFunc fedFunc = NULL;
+
+static feedRequest queue[FEED_WORKER_QUEUE_LENGTH];
+static int queueStart = 0;
+static int queueCount = 0;
+
+// per mode: requests queued but not started; and the mode being fed, or -1
+static int pendingCount[MAX_MODES];
+static int activeMode = -1;
+static feedRequest activeRequest;
+
+static bool isDuplicate(int mode)
+{
+    switch (coalescePolicy) {
+        case FEED_COALESCE_ACTIVE:
+            if (activeMode == mode) {
+                return true;
+            }
+            // fall through
+        case FEED_COALESCE_PENDING:
+            return pendingCount[mode] > 0;
+        default:
+            return false;
+    }
+}
+
+static void startNext(void);
+
+static void onGateClosed(void)
+{
+    feedRequest fed = activeRequest;
+    activeMode = -1;
+    fedFunc(&fed);
+    startNext();
+}
+
+static void startNext(void)
+{
+    while (activeMode < 0 && queueCount > 0) {
+        activeRequest = queue[queueStart];
+        queueStart = (queueStart + 1) % FEED_WORKER_QUEUE_LENGTH;
+        queueCount--;
+        int mode = activeRequest.mode;
+        pendingCount[mode]--;
+
+        activeMode = mode;
+        if (!servoDriver_startProfile(profileFunc(&activeRequest), onGateClosed)) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Feed worker: unable to start feed in mode %d.", mode);
+            activeMode = -1;
+        } else {
+            startedFunc(&activeRequest);
+        }
+    }
+}
+
+void feedWorker_start(feedCoalescePolicy policy, feedWorker_profileFunc profileFor, feedWorker_fedFunc onStarted,
+        feedWorker_fedFunc onFed)
+{
+    coalescePolicy = policy;
+    profileFunc = profileFor;
+    startedFunc = onStarted;
+    fedFunc = onFed;
+    queueStart = 0;
+    queueCount = 0;
+    activeMode = -1;
+    for (int i = 0; i < MAX_MODES; i++) {
+        pendingCount[i] = 0;
+    }
+}
+
+bool feedWorker_request(const feedRequest* request)
+{
+    int mode = request->mode;
+    if (profileFunc == NULL || mode < 0 || mode >= MAX_MODES || isDuplicate(mode)) {
+        return false;
+    }
+    if (queueCount == FEED_WORKER_QUEUE_LENGTH) {
+        asyncLog_log(ASYNC_LOG_WARN, "Feed worker: queue full, dropping request.");
+        return false;
+    }
+    // only what would otherwise run takes a token
+    if (feedGuard_admit(mode) != FEED_GUARD_ADMITTED) {
+        return false;
+    }
+    queue[(queueStart + queueCount) % FEED_WORKER_QUEUE_LENGTH] = *request;
+    queueCount++;
+    pendingCount[mode]++;
+    latencyTrace_mark(LATENCY_TRACE_FEED_QUEUED);
+    startNext();
+    return true;
+}
+
+void feedWorker_stop(void)
+{
+    queueCount = 0;
+    for (int i = 0; i < MAX_MODES; i++) {
+        pendingCount[i] = 0;
+    }
+    profileFunc = NULL;
+}
@@ -0,0 +1,47 @@
+#ifndef FEED_WORKER_H
+#define FEED_WORKER_H
+
+#include <stdbool.h>
+
+#include "servo_driver.h"
+
+// Runs feed cycles one at a time on the servo. Requests wait in a small queue and are coalesced according to a
+// policy; the next one starts when the servo reports the gate closed. Everything here runs on the event loop thread.
+
+#define FEED_WORKER_QUEUE_LENGTH 4
+
+typedef enum {
+    // every request is queued, until the queue is full
+    FEED_COALESCE_NONE,
+    // a request is dropped if the same mode is already queued and not yet started
+    FEED_COALESCE_PENDING,
+    // as above, and also while a feed of the same mode is running
+    FEED_COALESCE_ACTIVE,
+} feedCoalescePolicy;
+
+typedef struct {
+    int mode;
+    // which tank, e.g. the engine that heard the command
+    int tank;
+    // a feedJournal_source
+    int source;
+    // a servoPortion; SERVO_PORTION_DEFAULT, 0, leaves it to the mode
+    int portion;
+} feedRequest;
+
+// Picks the motion profile for a request, from its mode and portion.
+typedef const servoProfile* (*feedWorker_profileFunc)(const feedRequest* request);
+// Called when a feed starts, and again once it has finished.
+typedef void (*feedWorker_fedFunc)(const feedRequest* request);
+
+void feedWorker_start(feedCoalescePolicy policy, feedWorker_profileFunc profileFor, feedWorker_fedFunc onStarted,
+        feedWorker_fedFunc onFed);
+
+// Returns false if the request was coalesced into an earlier one, the queue is full, or the feed guard merged or
+// refused it. Requests are coalesced by mode alone, whatever their tank or source.
+bool feedWorker_request(const feedRequest* request);
+
+// Drops anything still queued.
+void feedWorker_stop(void);
+
+#endif
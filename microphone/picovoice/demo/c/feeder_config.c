@@ -0,0 +1,447 @@
+#include "feeder_config.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "async_log.h"
+#include "feed_journal.h"
+
+static char configPath[PATH_MAX];
+static feederConfig* startupConfig = NULL;
+static feederConfig* currentConfig = NULL;
+// replaced by a reload, and what the inference thread's frame count was then
+static feederConfig* retiredConfig = NULL;
+static unsigned long long retiredAtFrame = 0;
+static unsigned long long inferenceFrames = 0;
+
+static void setDefaults(feederConfig* config)
+{
+    memset(config, 0, sizeof(*config));
+    snprintf(config->pwmPath, sizeof(config->pwmPath), "%s", SERVO_DRIVER_DEFAULT_PWM);
+    snprintf(config->i2cBus, sizeof(config->i2cBus), "%s", FEEDER_CONFIG_DEFAULT_I2C_BUS);
+    config->i2cAddress = FEEDER_CONFIG_DEFAULT_I2C_ADDRESS;
+    config->displayBrightness = MATRIX_DRIVER_MAX_BRIGHTNESS;
+    config->buttonGpio = FEEDER_CONFIG_DEFAULT_BUTTON_GPIO;
+    snprintf(config->controlSocket, sizeof(config->controlSocket), "%s", CONTROL_SERVER_DEFAULT_PATH);
+    config->profiles[0] = servoProfile_feed;
+    config->profiles[1] = servoProfile_delayedFeed;
+    config->profiles[2] = servoProfile_longFeed;
+    snprintf(config->envSensor.master, sizeof(config->envSensor.master), "%s", ENV_SENSOR_DEFAULT_MASTER);
+    config->vadThresholdDb = -1.f;
+    config->minFeedWaterC = -1.f;
+    for (int i = 0; i < FEED_PLAN_MAX_TIMES; i++) {
+        config->feedPlan.times[i].minuteOfDay = -1;
+    }
+    for (int i = 0; i < FEED_PLAN_MAX_BANDS; i++) {
+        config->feedPlan.bands[i].percent = -1;
+    }
+    config->noiseSuppressionDb = -1.f;
+    config->porcupineSensitivity = -1.f;
+    config->rhinoSensitivity = -1.f;
+}
+
+static char* trim(char* text)
+{
+    while (isspace((unsigned char) *text)) {
+        text++;
+    }
+    char* end = text + strlen(text);
+    while (end > text && isspace((unsigned char) end[-1])) {
+        *--end = '\0';
+    }
+    return text;
+}
+
+static bool copyString(char* to, size_t size, const char* value)
+{
+    return snprintf(to, size, "%s", value) < (int) size;
+}
+
+static bool parseInt(const char* value, int min, int max, int* out)
+{
+    char* end = NULL;
+    errno = 0;
+    long parsed = strtol(value, &end, 0);
+    if (errno != 0 || end == value || *end != '\0' || parsed < min || parsed > max) {
+        return false;
+    }
+    *out = (int) parsed;
+    return true;
+}
+
+static bool parseFloat(const char* value, float min, float max, float* out)
+{
+    char* end = NULL;
+    float parsed = strtof(value, &end);
+    if (end == value || *end != '\0' || parsed < min || parsed > max) {
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+// servo.MODE.FIELD
+static bool parseServo(feederConfig* config, const char* key, const char* value)
+{
+    int mode = -1;
+    char field[16];
+    if (sscanf(key, "servo.%d.%15s", &mode, field) != 2 || mode < 0 || mode >= FEEDER_CONFIG_FEED_MODES) {
+        return false;
+    }
+    servoProfile* profile = &config->profiles[mode];
+    if (strcmp(field, "ramp_ms") == 0) {
+        return parseInt(value, SERVO_DRIVER_TICK_MS, 10000, &profile->rampMs);
+    } else if (strcmp(field, "hold_ms") == 0) {
+        return parseInt(value, 0, 600000, &profile->holdMs);
+    } else if (strcmp(field, "shape") == 0) {
+        if (strcmp(value, "trapezoid") == 0) {
+            profile->shape = SERVO_RAMP_TRAPEZOID;
+        } else if (strcmp(value, "s_curve") == 0) {
+            profile->shape = SERVO_RAMP_S_CURVE;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+// feed_limit.MODE = FEEDS_PER_HOUR:BURST:DEDUP_SEC
+static bool parseFeedLimit(feederConfig* config, const char* key, const char* value)
+{
+    int mode = -1;
+    char rest;
+    if (sscanf(key, "feed_limit.%d%c", &mode, &rest) != 1 || mode < 0 || mode >= FEED_GUARD_MAX_MODES) {
+        return false;
+    }
+    feedGuard_limit limit = {0, 0, 0};
+    int dedupSec = -1;
+    if (sscanf(value, "%lf:%d:%d%c", &limit.feedsPerHour, &limit.burst, &dedupSec, &rest) != 3
+            || limit.feedsPerHour < 0 || limit.burst < 1 || dedupSec < 0) {
+        return false;
+    }
+    limit.dedupMs = dedupSec * 1000;
+    config->feedLimits[mode] = limit;
+    config->hasFeedLimit[mode] = true;
+    return true;
+}
+
+// feed_time.N = HH:MM:MODE[:TANK]
+static bool parseFeedTime(feederConfig* config, const char* key, const char* value)
+{
+    int index = -1;
+    char rest;
+    if (sscanf(key, "feed_time.%d%c", &index, &rest) != 1 || index < 0 || index >= FEED_PLAN_MAX_TIMES) {
+        return false;
+    }
+    int hour;
+    int minute;
+    feedPlan_time time = {-1, 0, 0};
+    const int fields = sscanf(value, "%d:%d:%d:%d%c", &hour, &minute, &time.mode, &time.tank, &rest);
+    if ((fields != 3 && fields != 4) || hour < 0 || hour > 23 || minute < 0 || minute > 59
+            || time.mode < 0 || time.mode >= FEEDER_CONFIG_FEED_MODES || time.tank < 0
+            || time.tank >= FEED_JOURNAL_MAX_TANKS) {
+        return false;
+    }
+    time.minuteOfDay = hour * 60 + minute;
+    config->feedPlan.times[index] = time;
+    return true;
+}
+
+// feed_band.N = BELOW_C:PERCENT
+static bool parseFeedBand(feederConfig* config, const char* key, const char* value)
+{
+    int index = -1;
+    char rest;
+    if (sscanf(key, "feed_band.%d%c", &index, &rest) != 1 || index < 0 || index >= FEED_PLAN_MAX_BANDS) {
+        return false;
+    }
+    float belowC;
+    int percent;
+    if (sscanf(value, "%f:%d%c", &belowC, &percent, &rest) != 2 || belowC < 0.f || belowC > 40.f
+            || percent < 0 || percent > 100) {
+        return false;
+    }
+    config->feedPlan.bands[index] = (feedPlan_band) {(int) (belowC * 1000.f), percent};
+    return true;
+}
+
+// hopper_level = DEVICE:CHANNEL:EMPTY_RAW:FULL_RAW:LOW_PERCENT
+static bool parseHopperLevel(feederConfig* config, const char* value)
+{
+    hopperLevel_config level;
+    char rest;
+    if (sscanf(value, "%d:%d:%d:%d:%d%c", &level.device, &level.channel, &level.emptyRaw, &level.fullRaw,
+               &level.lowPercent, &rest) != 5
+            || level.device < 0 || level.channel < 0 || level.emptyRaw == level.fullRaw
+            || level.lowPercent < 0 || level.lowPercent > 100) {
+        return false;
+    }
+    config->hopperLevel = level;
+    config->hasHopperLevel = true;
+    return true;
+}
+
+// servo_current = DEVICE:CHANNEL:STALL_RAW:STALL_MS
+static bool parseServoCurrent(feederConfig* config, const char* value)
+{
+    servoCurrent_config current;
+    char rest;
+    if (sscanf(value, "%d:%d:%d:%d%c", &current.device, &current.channel, &current.stallRaw, &current.stallMs,
+               &rest) != 4
+            || current.device < 0 || current.channel < 0 || current.stallRaw <= 0 || current.stallMs <= 0) {
+        return false;
+    }
+    config->servoCurrent = current;
+    config->hasServoCurrent = true;
+    return true;
+}
+
+static bool parseSetting(feederConfig* config, const char* key, const char* value)
+{
+    if (strcmp(key, "access_key") == 0) {
+        return copyString(config->accessKey, sizeof(config->accessKey), value);
+    } else if (strcmp(key, "library_path") == 0) {
+        return copyString(config->libraryPath, sizeof(config->libraryPath), value);
+    } else if (strcmp(key, "rhino_library_path") == 0) {
+        return copyString(config->rhinoLibraryPath, sizeof(config->rhinoLibraryPath), value);
+    } else if (strcmp(key, "porcupine_model_path") == 0) {
+        return copyString(config->porcupineModelPath, sizeof(config->porcupineModelPath), value);
+    } else if (strcmp(key, "rhino_model_path") == 0) {
+        return copyString(config->rhinoModelPath, sizeof(config->rhinoModelPath), value);
+    } else if (strcmp(key, "keyword_path") == 0) {
+        return config->keywordCount < ENGINE_FANOUT_MAX_ENGINES
+                && copyString(config->keywordPaths[config->keywordCount++], PATH_MAX, value);
+    } else if (strcmp(key, "context_path") == 0) {
+        return config->contextCount < ENGINE_FANOUT_MAX_ENGINES
+                && copyString(config->contextPaths[config->contextCount++], PATH_MAX, value);
+    } else if (strcmp(key, "pwm_path") == 0) {
+        return copyString(config->pwmPath, sizeof(config->pwmPath), value);
+    } else if (strcmp(key, "i2c_bus") == 0) {
+        return copyString(config->i2cBus, sizeof(config->i2cBus), value);
+    } else if (strcmp(key, "i2c_address") == 0) {
+        return parseInt(value, 0x03, 0x77, &config->i2cAddress);
+    } else if (strcmp(key, "display_brightness") == 0) {
+        return parseInt(value, 0, MATRIX_DRIVER_MAX_BRIGHTNESS, &config->displayBrightness);
+    } else if (strcmp(key, "button_gpio") == 0) {
+        return parseInt(value, 0, 1023, &config->buttonGpio);
+    } else if (strcmp(key, "gpio_registers") == 0) {
+        return parseInt(value, 0, 1, &config->gpioRegisters);
+    } else if (strcmp(key, "hopper_level") == 0) {
+        return parseHopperLevel(config, value);
+    } else if (strcmp(key, "servo_current") == 0) {
+        return parseServoCurrent(config, value);
+    } else if (strcmp(key, "w1_bus_master") == 0) {
+        return copyString(config->envSensor.master, sizeof(config->envSensor.master), value);
+    } else if (strcmp(key, "water_sensor") == 0) {
+        return copyString(config->envSensor.ids[ENV_SENSOR_WATER], sizeof(config->envSensor.ids[0]), value);
+    } else if (strcmp(key, "air_sensor") == 0) {
+        return copyString(config->envSensor.ids[ENV_SENSOR_AIR], sizeof(config->envSensor.ids[0]), value);
+    } else if (strcmp(key, "pru_remoteproc") == 0) {
+        return copyString(config->pruRemoteproc, sizeof(config->pruRemoteproc), value);
+    } else if (strcmp(key, "control_socket") == 0) {
+        return copyString(config->controlSocket, sizeof(config->controlSocket), value);
+    } else if (strcmp(key, "thermal_start_c") == 0) {
+        float startC;
+        if (!parseFloat(value, 30.f, 120.f, &startC)) {
+            return false;
+        }
+        config->thermalMonitor.startMilliC = (int) (startC * 1000.f);
+        return true;
+    } else if (strcmp(key, "cpu_idle_mhz") == 0) {
+        int idleMHz;
+        if (!parseInt(value, 1, 10000, &idleMHz)) {
+            return false;
+        }
+        config->cpuFrequency.idleKHz = idleMHz * 1000;
+        return true;
+    } else if (strcmp(key, "cpu_boost_hold_sec") == 0) {
+        int holdSec;
+        if (!parseInt(value, 1, 3600, &holdSec)) {
+            return false;
+        }
+        config->cpuFrequency.holdMs = holdSec * 1000;
+        return true;
+    } else if (strcmp(key, "cpu_busy_watts") == 0) {
+        return parseFloat(value, 0.01f, 100.f, &config->cpuFrequency.busyWatts);
+    } else if (strcmp(key, "audio_encoding") == 0) {
+        if (strcmp(value, "pcm") == 0) {
+            config->isAdpcmAudio = false;
+        } else if (strcmp(value, "adpcm") == 0) {
+            config->isAdpcmAudio = true;
+        } else {
+            return false;
+        }
+        return true;
+    } else if (strcmp(key, "offload_server") == 0) {
+        return copyString(config->offloadServer, sizeof(config->offloadServer), value);
+    } else if (strcmp(key, "vad_threshold_db") == 0) {
+        return parseFloat(value, 0.f, 60.f, &config->vadThresholdDb);
+    } else if (strcmp(key, "min_feed_water_c") == 0) {
+        return parseFloat(value, 0.f, 40.f, &config->minFeedWaterC);
+    } else if (strcmp(key, "noise_suppression_db") == 0) {
+        return parseFloat(value, 0.f, 40.f, &config->noiseSuppressionDb);
+    } else if (strcmp(key, "agc_target_dbfs") == 0) {
+        return parseFloat(value, -40.f, 0.f, &config->agcTargetDbfs);
+    } else if (strcmp(key, "porcupine_sensitivity") == 0) {
+        return parseFloat(value, 0.f, 1.f, &config->porcupineSensitivity);
+    } else if (strcmp(key, "rhino_sensitivity") == 0) {
+        return parseFloat(value, 0.f, 1.f, &config->rhinoSensitivity);
+    } else if (strncmp(key, "servo.", 6) == 0) {
+        return parseServo(config, key, value);
+    } else if (strncmp(key, "feed_limit.", 11) == 0) {
+        return parseFeedLimit(config, key, value);
+    } else if (strncmp(key, "feed_time.", 10) == 0) {
+        return parseFeedTime(config, key, value);
+    } else if (strncmp(key, "feed_band.", 10) == 0) {
+        return parseFeedBand(config, key, value);
+    }
+    return false;
+}
+
+// Returns NULL, having said which line is wrong, if the file doesn't parse.
+static feederConfig* parseFile(const char* path)
+{
+    feederConfig* config = malloc(sizeof(feederConfig));
+    if (config == NULL) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Config: Unable to allocate memory.");
+        return NULL;
+    }
+    setDefaults(config);
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        if (errno != ENOENT) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Config: Unable to open %s: %s", path, strerror(errno));
+            free(config);
+            return NULL;
+        }
+        return config;
+    }
+    char line[PATH_MAX + 64];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char* key = trim(line);
+        if (*key == '\0') {
+            continue;
+        }
+        char* equals = strchr(key, '=');
+        if (equals != NULL) {
+            *equals = '\0';
+        }
+        if (equals == NULL || !parseSetting(config, trim(key), trim(equals + 1))) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Config: %s:%d: bad setting '%s'", path, lineNumber, trim(key));
+            fclose(file);
+            free(config);
+            return NULL;
+        }
+    }
+    fclose(file);
+    return config;
+}
+
+bool feederConfig_load(const char* path)
+{
+    snprintf(configPath, sizeof(configPath), "%s", path);
+    feederConfig* config = parseFile(configPath);
+    if (config == NULL) {
+        return false;
+    }
+    startupConfig = config;
+    __atomic_store_n(&currentConfig, config, __ATOMIC_RELEASE);
+    return true;
+}
+
+const feederConfig* feederConfig_startup(void)
+{
+    return startupConfig;
+}
+
+const feederConfig* feederConfig_get(void)
+{
+    return __atomic_load_n(&currentConfig, __ATOMIC_SEQ_CST);
+}
+
+bool feederConfig_reload(void)
+{
+    feederConfig_reclaim();
+    if (retiredConfig != NULL) {
+        asyncLog_log(ASYNC_LOG_WARN, "Config: the last reload is still being read, try again.");
+        return false;
+    }
+    feederConfig* config = parseFile(configPath);
+    if (config == NULL) {
+        asyncLog_log(ASYNC_LOG_WARN, "Config: keeping the settings in effect.");
+        return false;
+    }
+    // the paths the demo started with are still in use, whatever the file says now
+    const feederConfig* startup = startupConfig;
+    memcpy(config->accessKey, startup->accessKey, sizeof(config->accessKey));
+    memcpy(config->libraryPath, startup->libraryPath, sizeof(config->libraryPath));
+    memcpy(config->rhinoLibraryPath, startup->rhinoLibraryPath, sizeof(config->rhinoLibraryPath));
+    memcpy(config->porcupineModelPath, startup->porcupineModelPath, sizeof(config->porcupineModelPath));
+    memcpy(config->rhinoModelPath, startup->rhinoModelPath, sizeof(config->rhinoModelPath));
+    memcpy(config->keywordPaths, startup->keywordPaths, sizeof(config->keywordPaths));
+    config->keywordCount = startup->keywordCount;
+    memcpy(config->contextPaths, startup->contextPaths, sizeof(config->contextPaths));
+    config->contextCount = startup->contextCount;
+    memcpy(config->pwmPath, startup->pwmPath, sizeof(config->pwmPath));
+    memcpy(config->i2cBus, startup->i2cBus, sizeof(config->i2cBus));
+    config->i2cAddress = startup->i2cAddress;
+    config->displayBrightness = startup->displayBrightness;
+    config->buttonGpio = startup->buttonGpio;
+    config->gpioRegisters = startup->gpioRegisters;
+    memcpy(config->pruRemoteproc, startup->pruRemoteproc, sizeof(config->pruRemoteproc));
+    config->hopperLevel = startup->hopperLevel;
+    config->hasHopperLevel = startup->hasHopperLevel;
+    config->servoCurrent = startup->servoCurrent;
+    config->hasServoCurrent = startup->hasServoCurrent;
+    config->envSensor = startup->envSensor;
+    config->thermalMonitor = startup->thermalMonitor;
+    config->cpuFrequency = startup->cpuFrequency;
+    memcpy(config->controlSocket, startup->controlSocket, sizeof(config->controlSocket));
+    config->isAdpcmAudio = startup->isAdpcmAudio;
+    memcpy(config->offloadServer, startup->offloadServer, sizeof(config->offloadServer));
+
+    config->generation = currentConfig->generation + 1;
+    feederConfig* replaced = __atomic_exchange_n(&currentConfig, config, __ATOMIC_SEQ_CST);
+    retiredAtFrame = __atomic_load_n(&inferenceFrames, __ATOMIC_SEQ_CST);
+    // the startup config is never freed
+    retiredConfig = (replaced != startupConfig) ? replaced : NULL;
+    asyncLog_log(ASYNC_LOG_INFO, "Config: reloaded %s.", configPath);
+    return true;
+}
+
+void feederConfig_quiescent(void)
+{
+    __atomic_add_fetch(&inferenceFrames, 1, __ATOMIC_SEQ_CST);
+}
+
+void feederConfig_reclaim(void)
+{
+    // only the frame running at the exchange can still hold the old config, and it ends with the next count
+    if (retiredConfig != NULL && __atomic_load_n(&inferenceFrames, __ATOMIC_SEQ_CST) > retiredAtFrame) {
+        free(retiredConfig);
+        retiredConfig = NULL;
+    }
+}
+
+void feederConfig_unload(void)
+{
+    feederConfig* current = __atomic_exchange_n(&currentConfig, NULL, __ATOMIC_ACQ_REL);
+    if (current != startupConfig) {
+        free(current);
+    }
+    free(retiredConfig);
+    retiredConfig = NULL;
+    free(startupConfig);
+    startupConfig = NULL;
+}
@@ -0,0 +1,119 @@
+#ifndef FEEDER_CONFIG_H
+#define FEEDER_CONFIG_H
+
+#include <limits.h>
+#include <stdbool.h>
+
+#include "control_server.h"
+#include "cpu_frequency.h"
+#include "engine_fanout.h"
+#include "env_sensor.h"
+#include "feed_guard.h"
+#include "feed_plan.h"
+#include "hopper_level.h"
+#include "matrix_driver.h"
+#include "servo_current.h"
+#include "servo_driver.h"
+#include "thermal_monitor.h"
+
+// The feeder's settings file: one "key = value" per line, # starts a comment. It is parsed once into a struct that
+// is never written again. SIGHUP parses the file into a new struct and publishes it with one atomic pointer exchange,
+// so a reader sees either the old settings or the new ones, never a mix, and takes no lock. The struct it replaced is
+// freed once the inference thread has finished the frame it was on; until then, a second reload is refused. Command
+// line options win over the file at startup.
+//
+// Keys, with what a reload does to them:
+//   access_key, library_path, rhino_library_path, porcupine_model_path, rhino_model_path, keyword_path, context_path
+//   (the last two once per engine), pwm_path, i2c_bus, i2c_address, display_brightness (0 to 15), button_gpio,
+//   gpio_registers (0 or 1), pru_remoteproc, hopper_level = DEVICE:CHANNEL:EMPTY_RAW:FULL_RAW:LOW_PERCENT,
+//   servo_current = DEVICE:CHANNEL:STALL_RAW:STALL_MS, w1_bus_master, water_sensor, air_sensor (1-wire ids, e.g.
+//   28-0316a2794bff), thermal_start_c, noise_suppression_db, agc_target_dbfs, audio_encoding (pcm or adpcm, for the
+//   audio archive and command captures), offload_server = HOST:PORT (the inference server), cpu_idle_mhz (the CPU
+//   frequency at idle; unset leaves it alone), cpu_boost_hold_sec, cpu_busy_watts: read at startup only
+//   servo.MODE.ramp_ms, servo.MODE.hold_ms, servo.MODE.shape (trapezoid or s_curve): from the next feed
+//   feed_limit.MODE = FEEDS_PER_HOUR:BURST:DEDUP_SEC: at once, with the bucket replayed from the feed journal
+//   feed_time.N = HH:MM:MODE[:TANK], feed_band.N = BELOW_C:PERCENT: at once, by making the day's feed plan again
+//   vad_threshold_db: from the next frame, if the voice gate is on
+//   min_feed_water_c: from the next scheduled feed, which is skipped while the water is colder
+//   porcupine_sensitivity, rhino_sensitivity: once the models reloaded by the same SIGHUP are swapped in
+
+#define FEEDER_CONFIG_DEFAULT_PATH "/etc/fishfeeder/feeder.conf"
+#define FEEDER_CONFIG_DEFAULT_I2C_BUS "/dev/i2c-1"
+#define FEEDER_CONFIG_DEFAULT_I2C_ADDRESS 0x70
+#define FEEDER_CONFIG_DEFAULT_BUTTON_GPIO 27
+#define FEEDER_CONFIG_FEED_MODES 3
+#define FEEDER_CONFIG_MAX_ACCESS_KEY 128
+
+typedef struct {
+    // bumped by every reload, so a reader can tell a new config from an old one at a reused address
+    unsigned int generation;
+
+    // empty, or 0 for the counts, if the file doesn't set them
+    char accessKey[FEEDER_CONFIG_MAX_ACCESS_KEY];
+    char libraryPath[PATH_MAX];
+    char rhinoLibraryPath[PATH_MAX];
+    char porcupineModelPath[PATH_MAX];
+    char rhinoModelPath[PATH_MAX];
+    char keywordPaths[ENGINE_FANOUT_MAX_ENGINES][PATH_MAX];
+    int keywordCount;
+    char contextPaths[ENGINE_FANOUT_MAX_ENGINES][PATH_MAX];
+    int contextCount;
+    char pwmPath[PATH_MAX];
+    char i2cBus[PATH_MAX];
+    int i2cAddress;
+    int displayBrightness;
+    int buttonGpio;
+    // read GPIO values from the mapped bank registers instead of sysfs
+    int gpioRegisters;
+    // the remoteproc sysfs directory of PRU0, e.g. PRU_LINK_DEFAULT_REMOTEPROC; empty to drive the servo and read the
+    // button from the ARM
+    char pruRemoteproc[PATH_MAX];
+    hopperLevel_config hopperLevel;
+    bool hasHopperLevel;
+    servoCurrent_config servoCurrent;
+    bool hasServoCurrent;
+    envSensor_config envSensor;
+    thermalMonitor_config thermalMonitor;
+    cpuFrequency_config cpuFrequency;
+    char controlSocket[PATH_MAX];
+    // recordings as IMA-ADPCM, a quarter the size of 16-bit PCM
+    bool isAdpcmAudio;
+    // listening handed to this server while it answers; empty to listen on the board only
+    char offloadServer[256];
+
+    servoProfile profiles[FEEDER_CONFIG_FEED_MODES];
+    feedGuard_limit feedLimits[FEED_GUARD_MAX_MODES];
+    bool hasFeedLimit[FEED_GUARD_MAX_MODES];
+    feedPlan_config feedPlan;
+    // below 0 if the file doesn't set them
+    float vadThresholdDb;
+    float minFeedWaterC;
+    float noiseSuppressionDb;
+    // 0 if the file doesn't set it, as the target is below 0 dBFS
+    float agcTargetDbfs;
+    float porcupineSensitivity;
+    float rhinoSensitivity;
+} feederConfig;
+
+// Before any thread reads the config. A missing file gives the defaults; a file that doesn't parse is an error.
+bool feederConfig_load(const char* path);
+
+// The config as loaded at startup, kept until feederConfig_unload, so pointers into it stay valid.
+const feederConfig* feederConfig_startup(void);
+
+// The config in effect. Safe from any thread; the inference thread has to be done with it by the end of the frame.
+const feederConfig* feederConfig_get(void);
+
+// On the event loop thread. Parses the file again and swaps the result in; on failure the config in effect stays.
+bool feederConfig_reload(void);
+
+// On the inference thread, at the end of every frame.
+void feederConfig_quiescent(void);
+
+// On the event loop thread, from time to time: frees the config a reload replaced, once nothing can be reading it.
+void feederConfig_reclaim(void);
+
+// After every reader has stopped.
+void feederConfig_unload(void);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef FEEDER_PROBE_H
+#define FEEDER_PROBE_H
+
+// USDT probes on the daemon's hot paths, under the provider "feeder", for bpftrace or perf to attach to a running
+// feeder without a rebuild, e.g. `bpftrace -e 'usdt:/proc/PID/exe:feeder:process_end { @us = hist(arg0); }'`. CMake
+// defines PICOVOICE_USDT where <sys/sdt.h> is found; a probe is then one nop until something attaches, and without it
+// compiles to nothing, arguments included. Arguments are integers or pointers.
+
+#if defined(PICOVOICE_USDT)
+
+#include <sys/sdt.h>
+
+#define FEEDER_PROBE0(name) STAP_PROBE(feeder, name)
+#define FEEDER_PROBE1(name, a) STAP_PROBE1(feeder, name, a)
+#define FEEDER_PROBE2(name, a, b) STAP_PROBE2(feeder, name, a, b)
+#define FEEDER_PROBE3(name, a, b, c) STAP_PROBE3(feeder, name, a, b, c)
+
+#else
+
+#define FEEDER_PROBE0(name) do {} while (0)
+#define FEEDER_PROBE1(name, a) do {} while (0)
+#define FEEDER_PROBE2(name, a, b) do {} while (0)
+#define FEEDER_PROBE3(name, a, b, c) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board_link.h"
+#include "thread_cpu.h"
+
+// The feeder daemon and the camera's capture program, camera/capture.c, as one process: one binary to start and
+// supervise, one /metrics for both, and the feeder's notices to the camera through board_link.c rather than sockets.
+// Capture keeps its own epoll loop on a thread of its own, since V4L2 and the frame sender have nothing to do with
+// the feeder's event loop. Everything before "--" is the feeder's options, everything after it capture's:
+//
+//     fishfeeder -l ... -k ... -c ... -- -d /dev/video0 --yield-cpu --thermal --pellets
+//
+// Capture runs until the feeder stops, or until its frame count is reached; an error it exits on ends both.
+
+// picovoice_demo_mic.c and capture.c, built with FISHFEEDER_UNIFIED
+int feeder_main(int argc, char *argv[]);
+int capture_main(int argc, char **argv);
+
+typedef struct {
+    int argc;
+    char **argv;
+} captureArgs;
+
+static void *runCapture(void *arg) {
+    const captureArgs *args = arg;
+    capture_main(args->argc, args->argv);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    int split = 1;
+    while (split < argc && strcmp(argv[split], "--") != 0) {
+        split++;
+    }
+
+    // the feeder's control signals, blocked before any thread starts so that only its signalfd sees them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    if (!boardLink_open()) {
+        return 1;
+    }
+    const int capture_argc = (split < argc) ? argc - split : 1;
+    char *capture_argv[capture_argc + 1];
+    capture_argv[0] = "capture";
+    for (int i = 1; i < capture_argc; i++) {
+        capture_argv[i] = argv[split + i];
+    }
+    capture_argv[capture_argc] = NULL;
+    captureArgs args = {capture_argc, capture_argv};
+    pthread_t threadCapture;
+    if (pthread_create(&threadCapture, NULL, runCapture, &args) != 0) {
+        perror("Unable to start capture.");
+        return 1;
+    }
+    threadCpu_setName(threadCapture, "capture");
+
+    // getopt keeps its state in globals; 0 has glibc's start over for the feeder's
+    boardLink_waitForOptions();
+    optind = 0;
+    if (split < argc) {
+        argv[split] = NULL;
+    }
+    return feeder_main(split, argv);
+}
@@ -0,0 +1,52 @@
+#include "frame_buffer.h"
+
+#include <pthread.h>
+#include <string.h>
+
+static pthread_mutex_t frameLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned char backBuffer[MATRIX_DRIVER_ROWS];
+static unsigned char frontBuffer[MATRIX_DRIVER_ROWS];
+static bool isFrontBufferValid = false;
+
+// the matrix is wired with its columns rotated by one; precomputed for every row value
+#define WARP(x) ((unsigned char) (((x) >> 1) | ((x) << 7)))
+#define WARP4(x) WARP(x), WARP((x) + 1), WARP((x) + 2), WARP((x) + 3)
+#define WARP16(x) WARP4(x), WARP4((x) + 4), WARP4((x) + 8), WARP4((x) + 12)
+#define WARP64(x) WARP16(x), WARP16((x) + 16), WARP16((x) + 32), WARP16((x) + 48)
+
+static const unsigned char warpFrame[256] = {WARP64(0), WARP64(64), WARP64(128), WARP64(192)};
+
+unsigned char* frameBuffer_beginDraw(void)
+{
+    pthread_mutex_lock(&frameLock);
+    return backBuffer;
+}
+
+void frameBuffer_endDraw(void)
+{
+    // dirty when anything differs from what was last presented
+    if (!isFrontBufferValid || memcmp(backBuffer, frontBuffer, MATRIX_DRIVER_ROWS) != 0) {
+        unsigned char physicalFrameArr[MATRIX_DRIVER_ROWS];
+        for (int i = 0; i < MATRIX_DRIVER_ROWS; i++) {
+            physicalFrameArr[i] = warpFrame[backBuffer[i]];
+        }
+        matrixDriver_writeRows(physicalFrameArr);
+        memcpy(frontBuffer, backBuffer, MATRIX_DRIVER_ROWS);
+        isFrontBufferValid = true;
+    }
+    pthread_mutex_unlock(&frameLock);
+}
+
+void frameBuffer_show(const unsigned char* rows)
+{
+    unsigned char* back = frameBuffer_beginDraw();
+    memcpy(back, rows, MATRIX_DRIVER_ROWS);
+    frameBuffer_endDraw();
+}
+
+void frameBuffer_clear(void)
+{
+    unsigned char* back = frameBuffer_beginDraw();
+    memset(back, 0, MATRIX_DRIVER_ROWS);
+    frameBuffer_endDraw();
+}
@@ -0,0 +1,23 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <stdbool.h>
+
+#include "matrix_driver.h"
+
+// Double-buffered frame for the LED matrix. Drawing happens in the back buffer in logical row order; presenting maps
+// the rows to the physical layout and hands them to the matrix driver only when the frame changed.
+
+// Locks the frame and returns the back buffer, one byte per row with the leftmost column in the high bit.
+// It starts out holding the last presented frame.
+unsigned char* frameBuffer_beginDraw(void);
+
+// Presents the back buffer if it differs from the front buffer, then unlocks.
+void frameBuffer_endDraw(void);
+
+// Replaces the whole frame with the given logical rows and presents it.
+void frameBuffer_show(const unsigned char* rows);
+
+void frameBuffer_clear(void);
+
+#endif
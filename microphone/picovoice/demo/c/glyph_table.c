@@ -0,0 +1,117 @@
+#include "glyph_table.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define EMPTY 0
+
+typedef struct {
+  char digit; // 0-9 or . or empty space
+  char rowBitArr[GLYPH_TABLE_ROWS]; // represents each row of bits of the char
+  char cols; // how wide is this character in terms of columns
+} matrixData;
+
+static const matrixData matrix [] = { // holds all the bit data for each row for every character that may need to be displayed
+  {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 4},
+  {'0', {0x20, 0x50, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00}, 4},
+  {'1', {0x20, 0x30, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00}, 4},
+  {'2', {0x20, 0x50, 0x40, 0x20, 0x20, 0x10, 0x70, 0x00}, 4},
+  {'3', {0x30, 0x40, 0x40, 0x70, 0x40, 0x40, 0x30, 0x00}, 4},
+  {'4', {0x40, 0x60, 0x50, 0x50, 0x70, 0x40, 0x40, 0x00}, 4},
+  {'5', {0x70, 0x10, 0x10, 0x70, 0x40, 0x50, 0x20, 0x00}, 4},
+  {'6', {0x60, 0x10, 0x10, 0x30, 0x50, 0x50, 0x20, 0x00}, 4},
+  {'7', {0x70, 0x40, 0x40, 0x40, 0x20, 0x20, 0x20, 0x00}, 4},
+  {'8', {0x20, 0x50, 0x50, 0x20, 0x50, 0x50, 0x20, 0x00}, 4},
+  {'9', {0x20, 0x50, 0x50, 0x60, 0x40, 0x40, 0x30, 0x00}, 4},
+  {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40}, 1},
+  {':', {0x00, 0x00, 0x40, 0x00, 0x00, 0x40, 0x00, 0x00}, 1},
+  {'-', {0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00}, 4},
+  {'M', {0x50, 0x70, 0x70, 0x50, 0x50, 0x50, 0x50, 0x00}, 4},
+  {'F', {0x70, 0x10, 0x10, 0x30, 0x10, 0x10, 0x10, 0x00}, 4},
+  {'E', {0x70, 0x10, 0x10, 0x30, 0x10, 0x10, 0x70, 0x00}, 4},
+  {'D', {0x30, 0x50, 0x50, 0x50, 0x50, 0x50, 0x30, 0x00}, 4}
+};
+
+#define NUMBER_OF_GLYPHS ((int) (sizeof(matrix) / sizeof(matrix[0])))
+
+typedef struct {
+  int cols;
+  // rows already shifted into place for every starting column, so rendering is just an OR
+  unsigned char rowsAt[GLYPH_TABLE_COLS][GLYPH_TABLE_ROWS];
+  // the glyph transposed: bit i of columnBits[j] is row i of data bit j, which lands `cols - 8 + j` columns after
+  // the glyph's start (the '.' reaches back into the spacing of the glyph before it)
+  unsigned char columnBits[GLYPH_TABLE_COLS];
+} glyph;
+
+static glyph glyphs[NUMBER_OF_GLYPHS];
+// every character maps to a glyph; the ones without their own map to ' ' (index 0)
+static unsigned char glyphIndex[256];
+static pthread_once_t buildOnce = PTHREAD_ONCE_INIT;
+
+static unsigned char shiftLeftOnMatrixBy(int shiftAmountInBytes, char rowValue){ //shiftLeftBy(2,'1')
+  unsigned char bits = (unsigned char) rowValue;
+  if(shiftAmountInBytes >= 0){
+    return bits >> shiftAmountInBytes;
+  }
+  else{
+    return (unsigned char) (bits << -shiftAmountInBytes);
+  }
+}
+
+static void buildTable(void){
+  for(int g = 0; g < NUMBER_OF_GLYPHS; g++){
+    glyphs[g].cols = matrix[g].cols;
+    for(int col = 0; col < GLYPH_TABLE_COLS; col++){
+      int shiftAmountInBytes = GLYPH_TABLE_COLS - matrix[g].cols - col;
+      for(int i = 0; i < GLYPH_TABLE_ROWS; i++){
+        glyphs[g].rowsAt[col][i] = shiftLeftOnMatrixBy(shiftAmountInBytes, matrix[g].rowBitArr[i]);
+      }
+    }
+    for(int j = 0; j < GLYPH_TABLE_COLS; j++){
+      unsigned char column = 0;
+      for(int i = 0; i < GLYPH_TABLE_ROWS; i++){
+        column |= (unsigned char) ((((unsigned char) matrix[g].rowBitArr[i] >> j) & 1) << i);
+      }
+      glyphs[g].columnBits[j] = column;
+    }
+    glyphIndex[(unsigned char) matrix[g].digit] = (unsigned char) g;
+  }
+}
+
+static const glyph* lookup(char c){
+  pthread_once(&buildOnce, buildTable);
+  return &glyphs[glyphIndex[(unsigned char) c]];
+}
+
+void glyphTable_render(const char* text, unsigned char* rows){
+  for(int col = 0; col < GLYPH_TABLE_COLS; ){
+    const glyph* current = lookup((*text != EMPTY) ? *text : ' ');
+    if(*text != EMPTY){
+      ++text;
+    }
+    const unsigned char* rowBits = current->rowsAt[col];
+    for(int i = 0; i < GLYPH_TABLE_ROWS; i++){
+      rows[i] |= rowBits[i];
+    }
+    col += current->cols;
+  }
+}
+
+int glyphTable_renderColumns(const char* text, unsigned char* columns, int maxColumns){
+  memset(columns, 0, maxColumns);
+  int width = 0;
+  for(; *text != EMPTY; text++){
+    const glyph* current = lookup(*text);
+    if(width + current->cols > maxColumns){
+      break;
+    }
+    for(int j = 0; j < GLYPH_TABLE_COLS; j++){
+      int column = width + current->cols - GLYPH_TABLE_COLS + j;
+      if(column >= 0 && column < maxColumns){
+        columns[column] |= current->columnBits[j];
+      }
+    }
+    width += current->cols;
+  }
+  return width;
+}
@@ -0,0 +1,15 @@
+#ifndef GLYPH_TABLE_H
+#define GLYPH_TABLE_H
+
+#define GLYPH_TABLE_ROWS 8
+#define GLYPH_TABLE_COLS 8
+
+// Renders text into an 8x8 logical frame (one byte per row), left to right until the matrix is full.
+// Characters without a glyph render as a blank. The rows are ORed into `rows`, so clear them first.
+void glyphTable_render(const char* text, unsigned char* rows);
+
+// Renders the whole text into a strip of column bitmaps, bit i of each byte being row i.
+// Stops at the last glyph that fits in `maxColumns` and returns the width in columns.
+int glyphTable_renderColumns(const char* text, unsigned char* columns, int maxColumns);
+
+#endif
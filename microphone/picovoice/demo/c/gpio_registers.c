@@ -0,0 +1,73 @@
+#include "gpio_registers.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define BANK_SIZE 0x1000
+#define DATAIN 0x138
+
+// from the AM335x technical reference manual's memory map
+static const off_t bankAddresses[GPIO_REGISTERS_BANKS] = {0x44E07000, 0x4804C000, 0x481AC000, 0x481AE000};
+
+static volatile uint32_t* banks[GPIO_REGISTERS_BANKS];
+
+static volatile uint32_t* registerOf(int gpioNumber, int offset)
+{
+    if (gpioNumber < 0 || gpioNumber >= GPIO_REGISTERS_BANKS * 32 || banks[gpioNumber / 32] == NULL) {
+        return NULL;
+    }
+    return banks[gpioNumber / 32] + offset / sizeof(uint32_t);
+}
+
+bool gpioRegisters_open(void)
+{
+    if (gpioRegisters_isOpen()) {
+        return true;
+    }
+    int fd = open("/dev/mem", O_RDONLY | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        perror("GPIO: Unable to open /dev/mem.");
+        return false;
+    }
+    for (int i = 0; i < GPIO_REGISTERS_BANKS; i++) {
+        void* bank = mmap(NULL, BANK_SIZE, PROT_READ, MAP_SHARED, fd, bankAddresses[i]);
+        if (bank == MAP_FAILED) {
+            perror("GPIO: Unable to map bank.");
+            printf(" bank: %d\n", i);
+            close(fd);
+            gpioRegisters_close();
+            return false;
+        }
+        banks[i] = bank;
+    }
+    // the mappings outlive the descriptor
+    close(fd);
+    return true;
+}
+
+bool gpioRegisters_isOpen(void)
+{
+    return banks[0] != NULL;
+}
+
+int gpioRegisters_read(int gpioNumber)
+{
+    volatile uint32_t* dataIn = registerOf(gpioNumber, DATAIN);
+    if (dataIn == NULL) {
+        return -1;
+    }
+    return (*dataIn >> (gpioNumber % 32)) & 1;
+}
+
+void gpioRegisters_close(void)
+{
+    for (int i = 0; i < GPIO_REGISTERS_BANKS; i++) {
+        if (banks[i] != NULL) {
+            munmap((void*) banks[i], BANK_SIZE);
+            banks[i] = NULL;
+        }
+    }
+}
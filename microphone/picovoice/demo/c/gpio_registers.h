@@ -0,0 +1,23 @@
+#ifndef GPIO_REGISTERS_H
+#define GPIO_REGISTERS_H
+
+#include <stdbool.h>
+
+// The AM335x GPIO banks' registers, mapped from /dev/mem, so reading a pin is one load instead of a sysfs open, read
+// and parse. Optional: it needs root, and everything that uses it falls back to sysfs while it is not open. A pin still
+// has to be exported and given its direction through sysfs first; that also keeps its bank clocked, without which an
+// access faults. Pins are numbered as in sysfs, 32 per bank.
+
+#define GPIO_REGISTERS_BANKS 4
+
+// Maps all four banks. Safe to call again once open.
+bool gpioRegisters_open(void);
+
+bool gpioRegisters_isOpen(void);
+
+// 0 or 1, or -1 if the banks aren't mapped or the pin doesn't exist.
+int gpioRegisters_read(int gpioNumber);
+
+void gpioRegisters_close(void);
+
+#endif
@@ -0,0 +1,13 @@
+#include "hal.h"
+
+static hal_backend currentBackend = HAL_BACKEND_LINUX;
+
+void hal_setBackend(hal_backend backend)
+{
+    currentBackend = backend;
+}
+
+bool hal_isSimulated(void)
+{
+    return currentBackend == HAL_BACKEND_SIM;
+}
@@ -0,0 +1,19 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdbool.h>
+
+// Which backend the hardware abstraction layer drives: hal_pwm, hal_gpio and hal_i2c talk to the BeagleBone's sysfs
+// and device files, or to simulated devices in memory, so the daemon runs on a host without the feeder for tests and
+// benchmarks. Chosen once at startup, before anything is opened; each module follows the backend it was opened with.
+
+typedef enum {
+    HAL_BACKEND_LINUX,
+    HAL_BACKEND_SIM,
+} hal_backend;
+
+void hal_setBackend(hal_backend backend);
+
+bool hal_isSimulated(void);
+
+#endif
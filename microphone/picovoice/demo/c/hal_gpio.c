@@ -0,0 +1,157 @@
+#include "hal_gpio.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "gpio_registers.h"
+#include "hal.h"
+
+#define GPIO_PATH "/sys/class/gpio"
+
+typedef struct {
+    int gpio; // -1 if the slot is free
+    int fd;
+    bool isSimulated;
+    int simValue;
+} gpioLine;
+
+static gpioLine lines[HAL_GPIO_MAX_LINES] = {{-1, -1, false, 0}, {-1, -1, false, 0}, {-1, -1, false, 0},
+                                            {-1, -1, false, 0}};
+
+static gpioLine* findLine(int gpioNumber)
+{
+    for (int i = 0; i < HAL_GPIO_MAX_LINES; i++) {
+        if (lines[i].gpio == gpioNumber) {
+            return &lines[i];
+        }
+    }
+    return NULL;
+}
+
+static bool writeFile(const char* path, const char* value)
+{
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const size_t length = strlen(value);
+    bool ok = write(fd, value, length) == (ssize_t) length;
+    close(fd);
+    return ok;
+}
+
+static int openSysfsInput(int gpioNumber)
+{
+    char path[64];
+    char number[16];
+    snprintf(number, sizeof(number), "%d", gpioNumber);
+    snprintf(path, sizeof(path), GPIO_PATH "/gpio%d", gpioNumber);
+    if (access(path, F_OK) != 0 && !writeFile(GPIO_PATH "/export", number)) {
+        perror("GPIO: Unable to export GPIO.");
+        return -1;
+    }
+
+    snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/edge", gpioNumber);
+    if (!writeFile(path, "both")) {
+        perror("GPIO: Unable to enable edge events.");
+        printf(" gpio: %d\n", gpioNumber);
+        return -1;
+    }
+
+    snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/value", gpioNumber);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("GPIO: Unable to open GPIO value.");
+    }
+    return fd;
+}
+
+int halGpio_openInput(int gpioNumber, uint32_t* events)
+{
+    gpioLine* line = findLine(-1);
+    if (line == NULL || findLine(gpioNumber) != NULL) {
+        printf("GPIO: Unable to open gpio %d, already open or too many lines.\n", gpioNumber);
+        return -1;
+    }
+    line->isSimulated = hal_isSimulated();
+    if (line->isSimulated) {
+        line->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (line->fd < 0) {
+            perror("GPIO: Unable to create a simulated line.");
+            return -1;
+        }
+        __atomic_store_n(&line->simValue, 0, __ATOMIC_RELAXED);
+        *events = EPOLLIN;
+    } else {
+        line->fd = openSysfsInput(gpioNumber);
+        if (line->fd < 0) {
+            return -1;
+        }
+        *events = EPOLLPRI | EPOLLERR;
+    }
+    line->gpio = gpioNumber;
+    return line->fd;
+}
+
+int halGpio_read(int gpioNumber)
+{
+    const gpioLine* line = findLine(gpioNumber);
+    if (line == NULL) {
+        return -1;
+    }
+    if (line->isSimulated) {
+        return __atomic_load_n(&line->simValue, __ATOMIC_RELAXED);
+    }
+    if (gpioRegisters_isOpen()) {
+        return gpioRegisters_read(gpioNumber);
+    }
+    char value[4] = "";
+    if (pread(line->fd, value, sizeof(value) - 1, 0) <= 0) {
+        return -1;
+    }
+    return value[0] == '1';
+}
+
+void halGpio_ackEdge(int gpioNumber)
+{
+    const gpioLine* line = findLine(gpioNumber);
+    if (line == NULL) {
+        return;
+    }
+    if (line->isSimulated) {
+        uint64_t count;
+        (void) read(line->fd, &count, sizeof(count));
+        return;
+    }
+    // reading the sysfs file, not the register, clears the edge
+    char value[4];
+    (void) pread(line->fd, value, sizeof(value), 0);
+}
+
+void halGpio_close(int gpioNumber)
+{
+    gpioLine* line = findLine(gpioNumber);
+    if (line == NULL) {
+        return;
+    }
+    if (line->fd >= 0) {
+        close(line->fd);
+        line->fd = -1;
+    }
+    line->gpio = -1;
+}
+
+void halGpio_simSet(int gpioNumber, int value)
+{
+    gpioLine* line = findLine(gpioNumber);
+    if (line == NULL || !line->isSimulated) {
+        return;
+    }
+    __atomic_store_n(&line->simValue, value != 0, __ATOMIC_RELAXED);
+    const uint64_t edge = 1;
+    (void) write(line->fd, &edge, sizeof(edge));
+}
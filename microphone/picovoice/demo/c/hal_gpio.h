@@ -0,0 +1,28 @@
+#ifndef HAL_GPIO_H
+#define HAL_GPIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// GPIO input lines that signal their edges through a file descriptor, to be watched on the event loop. On Linux the
+// line is exported through sysfs with edges on both directions, its value file is what is watched for EPOLLPRI, and
+// with gpioRegisters open the value is read from the bank's register. Simulated, the line is a value in memory and an
+// eventfd that becomes readable when halGpio_simSet changes it. Lines are numbered as in sysfs.
+
+#define HAL_GPIO_MAX_LINES 4
+
+// Returns the descriptor to watch for *events, or -1. The line's value is ready to read straight away.
+int halGpio_openInput(int gpioNumber, uint32_t* events);
+
+// 0 or 1, or -1 if it can't be read.
+int halGpio_read(int gpioNumber);
+
+// Clears the edge the descriptor signalled, so the next one wakes the loop again.
+void halGpio_ackEdge(int gpioNumber);
+
+void halGpio_close(int gpioNumber);
+
+// Drives a simulated input, e.g. a press from a test. Any thread.
+void halGpio_simSet(int gpioNumber, int value);
+
+#endif
@@ -0,0 +1,130 @@
+#include "hal_i2c.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/i2c-dev.h>
+
+#include "async_log.h"
+#include "hal.h"
+
+typedef struct {
+    int address; // -1 if the slot is free
+    unsigned char registers[HAL_I2C_SIM_REGISTERS];
+} simDevice;
+
+static int busFd = -1;
+static bool isSimulated = false;
+// the address the bus fd is set to
+static int selectedAddress = -1;
+// guards the simulated devices, which tests read from their own threads
+static pthread_mutex_t simLock = PTHREAD_MUTEX_INITIALIZER;
+static simDevice simDevices[HAL_I2C_SIM_DEVICES];
+static long long simWrites = 0;
+
+static simDevice* findSimDevice(int address)
+{
+    for (int i = 0; i < HAL_I2C_SIM_DEVICES; i++) {
+        if (simDevices[i].address == address) {
+            return &simDevices[i];
+        }
+    }
+    return NULL;
+}
+
+bool halI2c_open(const char* path)
+{
+    isSimulated = hal_isSimulated();
+    selectedAddress = -1;
+    if (isSimulated) {
+        pthread_mutex_lock(&simLock);
+        memset(simDevices, 0, sizeof(simDevices));
+        for (int i = 0; i < HAL_I2C_SIM_DEVICES; i++) {
+            simDevices[i].address = -1;
+        }
+        simWrites = 0;
+        pthread_mutex_unlock(&simLock);
+        return true;
+    }
+    busFd = open(path, O_RDWR | O_CLOEXEC);
+    if (busFd < 0) {
+        perror("I2C: Unable to open bus.");
+        return false;
+    }
+    return true;
+}
+
+static bool writeSim(int address, const unsigned char* data, size_t length)
+{
+    pthread_mutex_lock(&simLock);
+    simDevice* device = findSimDevice(address);
+    if (device == NULL) {
+        device = findSimDevice(-1);
+    }
+    if (device == NULL) {
+        pthread_mutex_unlock(&simLock);
+        asyncLog_log(ASYNC_LOG_ERROR, "I2C: Unable to select device 0x%02x: too many simulated devices", address);
+        return false;
+    }
+    device->address = address;
+    // the register address wraps, as it does on the parts simulated
+    for (size_t i = 1; i < length; i++) {
+        device->registers[(data[0] + i - 1) % HAL_I2C_SIM_REGISTERS] = data[i];
+    }
+    simWrites++;
+    pthread_mutex_unlock(&simLock);
+    return true;
+}
+
+bool halI2c_write(int address, const unsigned char* data, size_t length)
+{
+    if (isSimulated) {
+        return length > 0 && writeSim(address, data, length);
+    }
+    if (busFd < 0) {
+        return false;
+    }
+    if (selectedAddress != address) {
+        if (ioctl(busFd, I2C_SLAVE, address) < 0) {
+            asyncLog_log(ASYNC_LOG_ERROR, "I2C: Unable to select device 0x%02x: %s", address, strerror(errno));
+            selectedAddress = -1;
+            return false;
+        }
+        selectedAddress = address;
+    }
+    if (write(busFd, data, length) != (ssize_t) length) {
+        asyncLog_log(ASYNC_LOG_ERROR, "I2C: Unable to write i2c register: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void halI2c_close(void)
+{
+    if (busFd >= 0) {
+        close(busFd);
+        busFd = -1;
+    }
+    selectedAddress = -1;
+}
+
+int halI2c_simRegister(int address, int reg)
+{
+    pthread_mutex_lock(&simLock);
+    const simDevice* device = findSimDevice(address);
+    const int value = (device != NULL && address >= 0) ? device->registers[reg % HAL_I2C_SIM_REGISTERS] : -1;
+    pthread_mutex_unlock(&simLock);
+    return value;
+}
+
+long long halI2c_simWrites(void)
+{
+    pthread_mutex_lock(&simLock);
+    const long long writes = simWrites;
+    pthread_mutex_unlock(&simLock);
+    return writes;
+}
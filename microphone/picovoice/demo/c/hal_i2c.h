@@ -0,0 +1,28 @@
+#ifndef HAL_I2C_H
+#define HAL_I2C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// One I2C bus, written by one thread at a time (the i2c_bus thread). On Linux it is the /dev/i2c-N character device,
+// set to a device's address only when the address changes. Simulated, every device on the bus is a register image in
+// memory: a write's first byte is the register address and the rest go to it and the registers after it, as the
+// HT16K33 display driver and most register-mapped parts take them.
+
+#define HAL_I2C_SIM_DEVICES 8
+#define HAL_I2C_SIM_REGISTERS 256
+
+bool halI2c_open(const char* path);
+
+// Sends length bytes to the device at a 7-bit address. Logs and returns false on failure.
+bool halI2c_write(int address, const unsigned char* data, size_t length);
+
+void halI2c_close(void);
+
+// What a simulated device's register was last set to, or -1 if nothing was ever written to the device. Any thread.
+int halI2c_simRegister(int address, int reg);
+
+// Writes to simulated devices so far. Any thread.
+long long halI2c_simWrites(void);
+
+#endif
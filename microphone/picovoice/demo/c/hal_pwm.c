@@ -0,0 +1,119 @@
+#include "hal_pwm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "hal.h"
+
+#define VALUE_LENGTH 16
+
+typedef struct {
+    int fd;
+    char value[VALUE_LENGTH]; // what the attribute holds, as last read or written
+} pwmAttribute;
+
+static const char* attributeNames[HAL_PWM_ATTRIBUTES] = {"period", "enable", "duty_cycle"};
+
+static bool isOpen = false;
+static bool isSimulated = false;
+static pwmAttribute attributes[HAL_PWM_ATTRIBUTES] = {{-1, ""}, {-1, ""}, {-1, ""}};
+static long simValues[HAL_PWM_ATTRIBUTES];
+static long long simWrites = 0;
+
+static bool openAttribute(pwmAttribute* attribute, const char* pwmPath, const char* name)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", pwmPath, name);
+    attribute->fd = open(path, O_RDWR);
+    if (attribute->fd < 0) {
+        perror("PWM: Unable to open attribute.");
+        printf(" attribute: %s\n", path);
+        return false;
+    }
+
+    // the channel may already be configured from a previous run
+    ssize_t length = pread(attribute->fd, attribute->value, VALUE_LENGTH - 1, 0);
+    if (length < 0) {
+        length = 0;
+    }
+    attribute->value[length] = '\0';
+    attribute->value[strcspn(attribute->value, "\n")] = '\0';
+    return true;
+}
+
+static void closeAttribute(pwmAttribute* attribute)
+{
+    if (attribute->fd >= 0) {
+        close(attribute->fd);
+        attribute->fd = -1;
+    }
+    attribute->value[0] = '\0';
+}
+
+bool halPwm_open(const char* pwmPath)
+{
+    isSimulated = hal_isSimulated();
+    isOpen = true;
+    if (isSimulated) {
+        memset(simValues, 0, sizeof(simValues));
+        simWrites = 0;
+        return true;
+    }
+    for (int i = 0; i < HAL_PWM_ATTRIBUTES; i++) {
+        if (!openAttribute(&attributes[i], pwmPath, attributeNames[i])) {
+            halPwm_close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void halPwm_write(halPwm_attribute attribute, long value)
+{
+    if (!isOpen) {
+        return;
+    }
+    if (isSimulated) {
+        if (simValues[attribute] != value) {
+            simValues[attribute] = value;
+            simWrites++;
+        }
+        return;
+    }
+
+    pwmAttribute* written = &attributes[attribute];
+    char string[VALUE_LENGTH];
+    snprintf(string, VALUE_LENGTH, "%ld", value);
+    if (written->fd < 0 || strcmp(written->value, string) == 0) {
+        return;
+    }
+    const size_t length = strlen(string);
+    if (pwrite(written->fd, string, length, 0) != (ssize_t) length) {
+        asyncLog_log(ASYNC_LOG_ERROR, "PWM: Unable to write attribute: %s", strerror(errno));
+        written->value[0] = '\0';
+        return;
+    }
+    snprintf(written->value, VALUE_LENGTH, "%s", string);
+}
+
+void halPwm_close(void)
+{
+    for (int i = 0; i < HAL_PWM_ATTRIBUTES; i++) {
+        closeAttribute(&attributes[i]);
+    }
+    isOpen = false;
+}
+
+long halPwm_simValue(halPwm_attribute attribute)
+{
+    return simValues[attribute];
+}
+
+long long halPwm_simWrites(void)
+{
+    return simWrites;
+}
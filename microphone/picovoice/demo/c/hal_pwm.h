@@ -0,0 +1,29 @@
+#ifndef HAL_PWM_H
+#define HAL_PWM_H
+
+#include <stdbool.h>
+
+// One PWM channel. On Linux its sysfs period, enable and duty_cycle attributes are opened once and rewritten in
+// place, and values that are already set are not written again. Simulated, the values are only kept, and counted.
+// Not thread safe: the servo driver uses it from the event loop thread.
+
+typedef enum {
+    HAL_PWM_PERIOD,     // ns
+    HAL_PWM_ENABLE,     // 0 or 1
+    HAL_PWM_DUTY_CYCLE, // ns
+    HAL_PWM_ATTRIBUTES,
+} halPwm_attribute;
+
+// pwmPath is the channel's sysfs directory, e.g. /sys/class/pwm/pwmchip3/pwm1; ignored when simulated.
+bool halPwm_open(const char* pwmPath);
+
+void halPwm_write(halPwm_attribute attribute, long value);
+
+void halPwm_close(void);
+
+// The simulated channel: the last value written, or 0, and how many writes changed a value.
+long halPwm_simValue(halPwm_attribute attribute);
+
+long long halPwm_simWrites(void);
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef _GNU_SOURCE
+// accept4, MSG_CMSG_CLOEXEC
+#define _GNU_SOURCE
+#endif
+
+#include "handover.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+static int listenFd = -1;
+// the other feeder: the old one's connection to the new, closed as the old one finishes stopping, or the new one's to
+// the old
+static int peerFd = -1;
+static handover_func requestFunc = NULL;
+static char socketPath[sizeof(((struct sockaddr_un*) NULL)->sun_path)];
+
+static bool addressOf(const char* path, struct sockaddr_un* address)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (snprintf(address->sun_path, sizeof(address->sun_path), "%s", path) >= (int) sizeof(address->sun_path)) {
+        printf("Handover: socket path too long: %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool sendState(int fd, const handover_state* state)
+{
+    char line[32];
+    const int length = snprintf(line, sizeof(line), "mode %d\n", state->mode);
+    struct iovec part = {line, (size_t) length};
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(int))];
+    } control;
+    if (state->controlFd >= 0) {
+        memset(&control, 0, sizeof(control));
+        message.msg_control = control.space;
+        message.msg_controllen = sizeof(control.space);
+        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(header), &state->controlFd, sizeof(int));
+    }
+    return sendmsg(fd, &message, MSG_NOSIGNAL) == length;
+}
+
+static void onConnect(int fd, void* userData)
+{
+    (void) userData;
+    const int peer = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+    if (peer < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            asyncLog_log(ASYNC_LOG_WARN, "Handover: Unable to accept: %s", strerror(errno));
+        }
+        return;
+    }
+    handover_state state = {-1, 0};
+    requestFunc(&state);
+    if (!sendState(peer, &state)) {
+        // it starts cold once this one has gone
+        asyncLog_log(ASYNC_LOG_ERROR, "Handover: Unable to send the state: %s", strerror(errno));
+    }
+    asyncLog_log(ASYNC_LOG_INFO, "Handover: a new feeder is taking over, stopping");
+    // the new feeder listens on its own once it has taken over
+    eventLoop_remove(listenFd);
+    close(listenFd);
+    listenFd = -1;
+    socketPath[0] = '\0';
+    peerFd = peer;
+}
+
+bool handover_listen(const char* path, handover_func onRequest)
+{
+    struct sockaddr_un address;
+    if (!addressOf(path, &address)) {
+        return false;
+    }
+    requestFunc = onRequest;
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        perror("Handover: Unable to create socket.");
+        return false;
+    }
+    // left over from an earlier run
+    unlink(address.sun_path);
+    if (bind(listenFd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listenFd, 1) != 0
+            || !eventLoop_add(listenFd, EPOLLIN, onConnect, NULL)) {
+        perror("Handover: Unable to listen.");
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    eventLoop_setSubsystem(listenFd, "control");
+    snprintf(socketPath, sizeof(socketPath), "%s", address.sun_path);
+    return true;
+}
+
+bool handover_request(const char* path, handover_state* state)
+{
+    struct sockaddr_un address;
+    if (!addressOf(path, &address)) {
+        return false;
+    }
+    peerFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (peerFd < 0 || connect(peerFd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        printf("Handover: No feeder at %s, starting cold.\n", path);
+        handover_close();
+        return false;
+    }
+    struct pollfd answer = {peerFd, POLLIN, 0};
+    char line[32] = "";
+    struct iovec part = {line, sizeof(line) - 1};
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+    ssize_t length = -1;
+    if (poll(&answer, 1, HANDOVER_TIMEOUT_MS) == 1) {
+        length = recvmsg(peerFd, &message, MSG_CMSG_CLOEXEC);
+    }
+    if (length <= 0 || sscanf(line, "mode %d", &state->mode) != 1) {
+        printf("Handover: The feeder at %s didn't answer, starting cold.\n", path);
+        handover_close();
+        return false;
+    }
+    state->controlFd = -1;
+    const struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header != NULL && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+        memcpy(&state->controlFd, CMSG_DATA(header), sizeof(int));
+    }
+    return true;
+}
+
+bool handover_waitForExit(void)
+{
+    struct pollfd hangup = {peerFd, POLLIN, 0};
+    char byte;
+    const bool hasExited = peerFd >= 0 && poll(&hangup, 1, HANDOVER_TIMEOUT_MS) == 1
+            && read(peerFd, &byte, sizeof(byte)) == 0;
+    if (peerFd >= 0) {
+        close(peerFd);
+        peerFd = -1;
+    }
+    return hasExited;
+}
+
+void handover_close(void)
+{
+    if (listenFd >= 0) {
+        eventLoop_remove(listenFd);
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (socketPath[0] != '\0') {
+        unlink(socketPath);
+        socketPath[0] = '\0';
+    }
+    if (peerFd >= 0) {
+        close(peerFd);
+        peerFd = -1;
+    }
+}
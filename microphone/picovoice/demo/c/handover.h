@@ -0,0 +1,41 @@
+#ifndef HANDOVER_H
+#define HANDOVER_H
+
+#include <stdbool.h>
+
+// Upgrades the feeder without the seconds of deafness a restart costs while the engines load. The running feeder
+// listens on HANDOVER_DEFAULT_PATH from its event loop. A new build started with --handover loads its engines first,
+// while the old one goes on listening and feeding, and then connects. The old feeder sends it the control server's
+// listening socket, with SCM_RIGHTS, so the camera's web app queues in its backlog rather than finding the socket gone,
+// and the feed mode; then it stops, as it would on SIGINT. The audio device and the hardware can't be shared, so the
+// new feeder waits for the connection to close, which the kernel does once the old one has exited, before opening
+// them. Nobody listening makes it a cold start.
+
+#define HANDOVER_DEFAULT_PATH "/tmp/fishfeeder-handover.sock"
+#define HANDOVER_TIMEOUT_MS 10000
+
+typedef struct {
+    // the control server's listening socket; -1 for none
+    int controlFd;
+    int mode;
+} handover_state;
+
+// The running feeder's side, on the event loop thread: fills in what to hand over, and starts stopping.
+typedef void (*handover_func)(handover_state* state);
+
+// Binds path, replacing a socket left there by an earlier run, and adds it to the event loop, which has to be
+// initialised. Only the first request is answered.
+bool handover_listen(const char* path, handover_func onRequest);
+
+// The new feeder's side. False, for a cold start, if no feeder answered at path within HANDOVER_TIMEOUT_MS;
+// otherwise state is what it sent.
+bool handover_request(const char* path, handover_state* state);
+
+// After handover_request: waits up to HANDOVER_TIMEOUT_MS for the old feeder to exit. False if it hasn't.
+bool handover_waitForExit(void);
+
+// Removes the socket file unless this feeder has handed over. Closing the connection to a new feeder tells it the
+// audio device and the hardware are free, so this goes last.
+void handover_close(void);
+
+#endif
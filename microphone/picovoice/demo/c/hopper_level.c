@@ -0,0 +1,109 @@
+#include "hopper_level.h"
+
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "adc_stream.h"
+#include "event_loop.h"
+#include "metrics.h"
+
+static hopperLevel_config config;
+static hopperLevel_func levelFunc = NULL;
+static int timerFd = -1;
+static bool isSampling = false;
+static long long sampleSum = 0;
+static int sampleCount = 0;
+static int level = -1;
+static metrics_id levelMetric = -1;
+
+static void finishBurst(void)
+{
+    isSampling = false;
+    adcStream_release();
+
+    const long long mean = sampleSum / sampleCount;
+    const int span = config.fullRaw - config.emptyRaw;
+    int percent = span != 0 ? (int) ((mean - config.emptyRaw) * 100 / span) : 0;
+    percent = percent < 0 ? 0 : (percent > 100 ? 100 : percent);
+    __atomic_store_n(&level, percent, __ATOMIC_RELEASE);
+    metrics_set(levelMetric, percent);
+    if (levelFunc != NULL) {
+        levelFunc(percent);
+    }
+}
+
+static void onSamples(const uint16_t* samples, int count, void* userData)
+{
+    (void) userData;
+    if (!isSampling) {
+        return;
+    }
+    for (int i = 0; i < count && sampleCount < HOPPER_LEVEL_BURST_SAMPLES; i++) {
+        sampleSum += samples[i];
+        sampleCount++;
+    }
+    if (sampleCount == HOPPER_LEVEL_BURST_SAMPLES) {
+        finishBurst();
+    }
+}
+
+static void onInterval(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0 || isSampling) {
+        return;
+    }
+    sampleSum = 0;
+    sampleCount = 0;
+    isSampling = true;
+    adcStream_acquire();
+}
+
+bool hopperLevel_start(const hopperLevel_config* newConfig, hopperLevel_func onLevel)
+{
+    config = *newConfig;
+    levelFunc = onLevel;
+    if (levelMetric < 0) {
+        levelMetric = metrics_addGauge("feeder_hopper_level_percent", "Food left in the hopper, at the last reading.");
+    }
+    if (!adcStream_open(config.device) || !adcStream_addChannel(config.channel, onSamples, NULL)) {
+        printf("Hopper level: Unable to read ADC channel %d of iio:device%d.\n", config.channel, config.device);
+        return false;
+    }
+
+    timerFd = eventLoop_createTimer();
+    // the first reading soon after startup, then one per interval
+    if (timerFd < 0 ||
+        !eventLoop_add(timerFd, EPOLLIN, onInterval, NULL) ||
+        !eventLoop_armTimer(timerFd, 1000, HOPPER_LEVEL_INTERVAL_MS)) {
+        hopperLevel_stop();
+        return false;
+    }
+    eventLoop_setSubsystem(timerFd, "sensors");
+    return true;
+}
+
+int hopperLevel_percent(void)
+{
+    return __atomic_load_n(&level, __ATOMIC_ACQUIRE);
+}
+
+bool hopperLevel_isLow(void)
+{
+    const int percent = hopperLevel_percent();
+    return percent >= 0 && percent <= config.lowPercent;
+}
+
+void hopperLevel_stop(void)
+{
+    if (timerFd >= 0) {
+        eventLoop_remove(timerFd);
+        close(timerFd);
+        timerFd = -1;
+    }
+    if (isSampling) {
+        isSampling = false;
+        adcStream_release();
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef HOPPER_LEVEL_H
+#define HOPPER_LEVEL_H
+
+#include <stdbool.h>
+
+// Food level in the hopper, from an IR or ultrasonic distance sensor on one of the AM335x ADC's channels, read through
+// the shared ADC stream in bursts: every HOPPER_LEVEL_INTERVAL_MS the stream is held for HOPPER_LEVEL_BURST_SAMPLES
+// samples, which are averaged. Runs on the event loop, which has to be initialised; each reading is published to the
+// feeder_hopper_level_percent gauge and passed to the level function.
+
+#define HOPPER_LEVEL_INTERVAL_MS 10000
+#define HOPPER_LEVEL_BURST_SAMPLES 1024
+
+typedef struct {
+    int device;     // N in iio:deviceN
+    int channel;    // K in in_voltageK
+    int emptyRaw;   // the raw reading with the hopper empty
+    int fullRaw;    // and full; either may be the larger
+    int lowPercent; // at or below this the hopper needs refilling
+} hopperLevel_config;
+
+// On the event loop thread, after every reading.
+typedef void (*hopperLevel_func)(int percent);
+
+bool hopperLevel_start(const hopperLevel_config* config, hopperLevel_func onLevel);
+
+// 0 to 100, or -1 before the first reading. Safe from any thread.
+int hopperLevel_percent(void);
+
+// Whether the last reading was at or below the low mark. Safe from any thread.
+bool hopperLevel_isLow(void);
+
+void hopperLevel_stop(void);
+
+#endif
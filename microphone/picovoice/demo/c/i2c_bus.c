@@ -0,0 +1,224 @@
+#include "i2c_bus.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "feeder_probe.h"
+#include "hal_i2c.h"
+#include "metrics.h"
+#include "thread_cpu.h"
+
+typedef struct {
+    int address;
+    i2cBus_priority priority;
+} busDevice;
+
+typedef struct {
+    bool isQueued;
+    i2cBus_device device;
+    int coalesceKey;
+    // order of arrival, for writes of the same priority
+    unsigned long long sequence;
+    unsigned char data[I2C_BUS_MAX_WRITE];
+    size_t length;
+    i2cBus_doneFunc doneFunc;
+    void* userData;
+} busWrite;
+
+typedef struct {
+    bool isDone;
+    bool ok;
+} waitedWrite;
+
+static pthread_t threadBus;
+static bool isRunning = false;
+static bool stopping = false;
+// guards everything below, and the queue; the bus itself is only touched by its thread
+static pthread_mutex_t busLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queueChanged = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t writeDone = PTHREAD_COND_INITIALIZER;
+static busDevice devices[I2C_BUS_MAX_DEVICES];
+static int deviceCount = 0;
+static busWrite queue[I2C_BUS_QUEUE_LENGTH];
+static unsigned long long nextSequence = 0;
+static metrics_id i2cErrors = -1;
+
+// The next write to send: the highest priority, then the oldest. -1 if none is queued.
+static int nextWrite(void)
+{
+    int next = -1;
+    for (int i = 0; i < I2C_BUS_QUEUE_LENGTH; i++) {
+        if (!queue[i].isQueued) {
+            continue;
+        }
+        if (next < 0) {
+            next = i;
+            continue;
+        }
+        const i2cBus_priority priority = devices[queue[i].device].priority;
+        const i2cBus_priority nextPriority = devices[queue[next].device].priority;
+        if (priority > nextPriority || (priority == nextPriority && queue[i].sequence < queue[next].sequence)) {
+            next = i;
+        }
+    }
+    return next;
+}
+
+static void* runBus(void* arg)
+{
+    (void) arg;
+    pthread_mutex_lock(&busLock);
+    while (true) {
+        int next = nextWrite();
+        if (next < 0) {
+            if (stopping) {
+                break;
+            }
+            pthread_cond_wait(&queueChanged, &busLock);
+            continue;
+        }
+        // copied out, so the slot can be reused while the bus is busy
+        const busWrite entry = queue[next];
+        queue[next].isQueued = false;
+        const int address = devices[entry.device].address;
+        pthread_mutex_unlock(&busLock);
+
+        FEEDER_PROBE2(i2c_write_entry, address, entry.length);
+        const bool ok = halI2c_write(address, entry.data, entry.length);
+        FEEDER_PROBE2(i2c_write_return, address, ok);
+        if (!ok) {
+            metrics_add(i2cErrors, 1);
+        }
+        if (entry.doneFunc != NULL) {
+            entry.doneFunc(ok, entry.userData);
+        }
+
+        pthread_mutex_lock(&busLock);
+    }
+    pthread_mutex_unlock(&busLock);
+    return NULL;
+}
+
+bool i2cBus_open(const char* path)
+{
+    if (isRunning) {
+        return true;
+    }
+    if (i2cErrors < 0) {
+        i2cErrors = metrics_addCounter("feeder_i2c_errors_total", "Failed I2C writes.");
+    }
+    if (!halI2c_open(path)) {
+        return false;
+    }
+    deviceCount = 0;
+    stopping = false;
+    memset(queue, 0, sizeof(queue));
+    // at normal priority: nothing on the bus has a deadline shorter than a display refresh
+    if (pthread_create(&threadBus, NULL, runBus, NULL) != 0) {
+        printf("I2C: Unable to start the bus thread.\n");
+        halI2c_close();
+        return false;
+    }
+    isRunning = true;
+    threadCpu_setName(threadBus, "i2c");
+    return true;
+}
+
+i2cBus_device i2cBus_addDevice(int address, i2cBus_priority priority)
+{
+    pthread_mutex_lock(&busLock);
+    if (deviceCount == I2C_BUS_MAX_DEVICES) {
+        pthread_mutex_unlock(&busLock);
+        return -1;
+    }
+    devices[deviceCount].address = address;
+    devices[deviceCount].priority = priority;
+    const i2cBus_device device = deviceCount++;
+    pthread_mutex_unlock(&busLock);
+    return device;
+}
+
+bool i2cBus_write(i2cBus_device device, int coalesceKey, const unsigned char* data, size_t length,
+                  i2cBus_doneFunc onDone, void* userData)
+{
+    if (length == 0 || length > I2C_BUS_MAX_WRITE) {
+        return false;
+    }
+    pthread_mutex_lock(&busLock);
+    if (!isRunning || stopping || device < 0 || device >= deviceCount) {
+        pthread_mutex_unlock(&busLock);
+        return false;
+    }
+
+    int slot = -1;
+    for (int i = 0; i < I2C_BUS_QUEUE_LENGTH && coalesceKey != I2C_BUS_NO_COALESCING; i++) {
+        if (queue[i].isQueued && queue[i].device == device && queue[i].coalesceKey == coalesceKey) {
+            slot = i;
+            break;
+        }
+    }
+    // a replacement keeps the replaced write's place in the order
+    if (slot < 0) {
+        for (int i = 0; i < I2C_BUS_QUEUE_LENGTH && slot < 0; i++) {
+            if (!queue[i].isQueued) {
+                slot = i;
+            }
+        }
+        if (slot < 0) {
+            pthread_mutex_unlock(&busLock);
+            return false;
+        }
+        queue[slot].sequence = nextSequence++;
+    }
+
+    busWrite* entry = &queue[slot];
+    entry->isQueued = true;
+    entry->device = device;
+    entry->coalesceKey = coalesceKey;
+    memcpy(entry->data, data, length);
+    entry->length = length;
+    entry->doneFunc = onDone;
+    entry->userData = userData;
+    pthread_cond_signal(&queueChanged);
+    pthread_mutex_unlock(&busLock);
+    return true;
+}
+
+static void onWaitedWrite(bool ok, void* userData)
+{
+    waitedWrite* waited = userData;
+    pthread_mutex_lock(&busLock);
+    waited->ok = ok;
+    waited->isDone = true;
+    pthread_cond_broadcast(&writeDone);
+    pthread_mutex_unlock(&busLock);
+}
+
+bool i2cBus_writeAndWait(i2cBus_device device, const unsigned char* data, size_t length)
+{
+    waitedWrite waited = {false, false};
+    if (!i2cBus_write(device, I2C_BUS_NO_COALESCING, data, length, onWaitedWrite, &waited)) {
+        return false;
+    }
+    pthread_mutex_lock(&busLock);
+    while (!waited.isDone) {
+        pthread_cond_wait(&writeDone, &busLock);
+    }
+    pthread_mutex_unlock(&busLock);
+    return waited.ok;
+}
+
+void i2cBus_close(void)
+{
+    if (isRunning) {
+        pthread_mutex_lock(&busLock);
+        stopping = true;
+        pthread_cond_signal(&queueChanged);
+        pthread_mutex_unlock(&busLock);
+        pthread_join(threadBus, NULL);
+        isRunning = false;
+    }
+    halI2c_close();
+    deviceCount = 0;
+}
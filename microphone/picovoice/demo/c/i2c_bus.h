@@ -0,0 +1,47 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// One thread that owns the I2C bus and runs every device's writes on it, one at a time, so drivers never share the
+// file descriptor or wait on the bus themselves. Writes are queued: the highest priority device goes first, and writes
+// of the same priority go in the order they came. A write queued under the same key as one still waiting replaces it,
+// so a device that is redrawn faster than the bus can keep up only ever sends its latest state. The callback of a
+// write runs on the bus thread once it has gone out, or failed; keep it short.
+
+#define I2C_BUS_MAX_DEVICES 4
+#define I2C_BUS_QUEUE_LENGTH 16
+// register address and data
+#define I2C_BUS_MAX_WRITE 32
+#define I2C_BUS_NO_COALESCING (-1)
+
+typedef enum {
+    I2C_BUS_PRIORITY_LOW,
+    I2C_BUS_PRIORITY_NORMAL,
+    I2C_BUS_PRIORITY_HIGH,
+} i2cBus_priority;
+
+typedef int i2cBus_device;
+
+typedef void (*i2cBus_doneFunc)(bool ok, void* userData);
+
+// Opens the bus through hal_i2c, so a simulated one when the HAL is, and starts its thread.
+bool i2cBus_open(const char* path);
+
+// Returns a handle for the device at a 7-bit address, or -1 if there are too many.
+i2cBus_device i2cBus_addDevice(int address, i2cBus_priority priority);
+
+// Queues one write of length bytes, usually a register address then data; never blocks. coalesceKey is e.g. the
+// register written, or I2C_BUS_NO_COALESCING; a write it replaces never has its callback called. onDone may be NULL.
+// Returns false if the bus isn't open, the write is too long or the queue is full.
+bool i2cBus_write(i2cBus_device device, int coalesceKey, const unsigned char* data, size_t length,
+                  i2cBus_doneFunc onDone, void* userData);
+
+// Queues a write and waits for it, for setup at startup. Not from a callback.
+bool i2cBus_writeAndWait(i2cBus_device device, const unsigned char* data, size_t length);
+
+// Sends what is queued, then stops the thread and closes the bus. Devices have to be added again after another open.
+void i2cBus_close(void);
+
+#endif
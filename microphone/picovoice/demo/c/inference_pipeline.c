@@ -0,0 +1,251 @@
+#ifndef _GNU_SOURCE
+// pthread_setaffinity_np and the CPU_SET macros
+#define _GNU_SOURCE
+#endif
+
+#include "inference_pipeline.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "alloc_guard.h"
+#include "async_log.h"
+#include "memory_budget.h"
+#include "thread_cpu.h"
+
+static int32_t frameLength = 0;
+static inferencePipeline_processFunc processFunc = NULL;
+static void* processUserData = NULL;
+
+static pthread_t threadInference;
+static bool isRunning = false;
+static bool stopping = false;
+// counts pushes and the stop request; the inference thread blocks on it while the queue is empty
+static int wakeFd = -1;
+
+// single-producer single-consumer ring of whole frames; head is only written by the capture stage, tail by the
+// inference stage
+static int16_t* frames = NULL;
+static long long enqueuedUs[INFERENCE_PIPELINE_QUEUE_LENGTH];
+static unsigned int queueHead = 0;
+static unsigned int queueTail = 0;
+// inference thread only
+static long long processingQueuedUs = 0;
+
+// each counter has a single writer, so plain atomic stores are enough
+static inferencePipeline_stats counters;
+static long long lastCaptureUs = 0;
+static bool lossless = false;
+
+static long long nowInUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void store(long long* counter, long long value)
+{
+    __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+}
+
+static long long load(const long long* counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static void wake(void)
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Inference pipeline: Unable to wake: %s", strerror(errno));
+    }
+}
+
+static void* runInference(void* arg)
+{
+    (void) arg;
+    allocGuard_markHot("inference");
+    while (true) {
+        unsigned int tail = queueTail;
+        if (tail == __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            uint64_t count;
+            if (read(wakeFd, &count, sizeof(count)) < 0 && errno != EINTR) {
+                asyncLog_log(ASYNC_LOG_ERROR, "Inference pipeline: Unable to wait for frames: %s", strerror(errno));
+                break;
+            }
+            continue;
+        }
+
+        const unsigned int slot = tail % INFERENCE_PIPELINE_QUEUE_LENGTH;
+        const long long startUs = nowInUs();
+        const long long waitUs = startUs - enqueuedUs[slot];
+        processingQueuedUs = enqueuedUs[slot];
+        processFunc(&frames[slot * frameLength], processUserData);
+        const long long processUs = nowInUs() - startUs;
+        __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+
+        store(&counters.processedFrames, counters.processedFrames + 1);
+        store(&counters.totalProcessUs, counters.totalProcessUs + processUs);
+        if (processUs > counters.maxProcessUs) {
+            store(&counters.maxProcessUs, processUs);
+        }
+        if (waitUs > counters.maxQueueWaitUs) {
+            store(&counters.maxQueueWaitUs, waitUs);
+        }
+    }
+    return NULL;
+}
+
+// best effort: without the privilege for SCHED_FIFO the thread keeps normal priority
+static void setScheduling(int32_t realtimePriority, int32_t cpu)
+{
+    if (realtimePriority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = realtimePriority;
+        pthread_setschedparam(threadInference, SCHED_FIFO, &param);
+    }
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(threadInference, sizeof(set), &set);
+    }
+}
+
+bool inferencePipeline_start(int32_t length, inferencePipeline_processFunc process, void* userData,
+        int32_t realtimePriority, int32_t cpu)
+{
+    frameLength = length;
+    processFunc = process;
+    processUserData = userData;
+    queueHead = 0;
+    queueTail = 0;
+    stopping = false;
+    lastCaptureUs = 0;
+    memset(&counters, 0, sizeof(counters));
+
+    frames = malloc((size_t) INFERENCE_PIPELINE_QUEUE_LENGTH * length * sizeof(int16_t));
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (!frames || wakeFd < 0) {
+        printf("Inference pipeline: Unable to allocate the frame queue.\n");
+        inferencePipeline_stop();
+        return false;
+    }
+    memoryBudget_add("inference queue", (long long) INFERENCE_PIPELINE_QUEUE_LENGTH * length * sizeof(int16_t), true);
+    if (pthread_create(&threadInference, NULL, runInference, NULL) != 0) {
+        printf("Inference pipeline: Unable to start the inference thread.\n");
+        inferencePipeline_stop();
+        return false;
+    }
+    isRunning = true;
+    threadCpu_setName(threadInference, "inference");
+    setScheduling(realtimePriority, cpu);
+    return true;
+}
+
+bool inferencePipeline_push(const int16_t* pcm)
+{
+    const long long nowUs = nowInUs();
+    if (lastCaptureUs != 0 && nowUs - lastCaptureUs > counters.maxCaptureIntervalUs) {
+        store(&counters.maxCaptureIntervalUs, nowUs - lastCaptureUs);
+    }
+    lastCaptureUs = nowUs;
+    store(&counters.capturedFrames, counters.capturedFrames + 1);
+
+    const unsigned int head = queueHead;
+    unsigned int depth = head - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+    // the inference thread frees a slot with every frame it takes off the queue
+    while (lossless && depth >= INFERENCE_PIPELINE_QUEUE_LENGTH && !__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+        usleep(100);
+        depth = head - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+    }
+    if (depth >= INFERENCE_PIPELINE_QUEUE_LENGTH) {
+        store(&counters.droppedFrames, counters.droppedFrames + 1);
+        return false;
+    }
+    const unsigned int slot = head % INFERENCE_PIPELINE_QUEUE_LENGTH;
+    memcpy(&frames[slot * frameLength], pcm, (size_t) frameLength * sizeof(int16_t));
+    enqueuedUs[slot] = nowUs;
+    __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+    if ((int) depth + 1 > counters.maxQueueDepth) {
+        __atomic_store_n(&counters.maxQueueDepth, (int) depth + 1, __ATOMIC_RELAXED);
+    }
+    wake();
+    return true;
+}
+
+void inferencePipeline_setLossless(bool isLossless)
+{
+    lossless = isLossless;
+}
+
+long long inferencePipeline_frameQueuedUs(void)
+{
+    return processingQueuedUs;
+}
+
+void inferencePipeline_stop(void)
+{
+    if (isRunning) {
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        wake();
+        pthread_join(threadInference, NULL);
+        isRunning = false;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    free(frames);
+    frames = NULL;
+}
+
+void inferencePipeline_getStats(inferencePipeline_stats* stats)
+{
+    stats->capturedFrames = load(&counters.capturedFrames);
+    stats->droppedFrames = load(&counters.droppedFrames);
+    stats->maxCaptureIntervalUs = load(&counters.maxCaptureIntervalUs);
+    stats->queueDepth = (int) (__atomic_load_n(&queueHead, __ATOMIC_ACQUIRE) -
+            __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE));
+    stats->maxQueueDepth = __atomic_load_n(&counters.maxQueueDepth, __ATOMIC_RELAXED);
+    stats->processedFrames = load(&counters.processedFrames);
+    stats->totalProcessUs = load(&counters.totalProcessUs);
+    stats->maxProcessUs = load(&counters.maxProcessUs);
+    stats->maxQueueWaitUs = load(&counters.maxQueueWaitUs);
+}
+
+void inferencePipeline_getScheduling(int32_t* realtimePriority, int32_t* cpu)
+{
+    *realtimePriority = 0;
+    *cpu = -1;
+    if (!isRunning) {
+        return;
+    }
+    int policy = SCHED_OTHER;
+    struct sched_param param;
+    if (pthread_getschedparam(threadInference, &policy, &param) == 0 && policy == SCHED_FIFO) {
+        *realtimePriority = param.sched_priority;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(threadInference, sizeof(set), &set) == 0 && CPU_COUNT(&set) == 1) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                *cpu = i;
+                break;
+            }
+        }
+    }
+}
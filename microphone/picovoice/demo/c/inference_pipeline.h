@@ -0,0 +1,59 @@
+#ifndef INFERENCE_PIPELINE_H
+#define INFERENCE_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Two stages between the microphone and Picovoice. The capture stage is the recorder's frame callback: it copies each
+// frame into a bounded single-producer single-consumer queue and returns, so it never waits on inference. The
+// inference stage is a thread of its own that takes frames off the queue in order and runs them through the process
+// function. When the queue is full the newest frame is dropped and counted, rather than stalling capture.
+
+#define INFERENCE_PIPELINE_QUEUE_LENGTH 16
+
+// Runs on the inference thread for every frame, oldest first.
+typedef void (*inferencePipeline_processFunc)(const int16_t* pcm, void* userData);
+
+typedef struct {
+    // capture stage
+    long long capturedFrames;
+    long long droppedFrames;
+    long long maxCaptureIntervalUs;
+    // frames waiting for the inference stage, now and at most
+    int queueDepth;
+    int maxQueueDepth;
+    // inference stage
+    long long processedFrames;
+    long long totalProcessUs;
+    long long maxProcessUs;
+    // longest time a frame waited in the queue before its processing started
+    long long maxQueueWaitUs;
+} inferencePipeline_stats;
+
+// realtimePriority of 0 leaves the inference thread at normal priority, and cpu of -1 lets it run anywhere; both
+// are best effort, see inferencePipeline_getScheduling.
+bool inferencePipeline_start(int32_t frameLength, inferencePipeline_processFunc process, void* userData,
+        int32_t realtimePriority, int32_t cpu);
+
+// The capture stage. Never blocks unless lossless; lock-free for exactly one calling thread. Returns false if the frame
+// was dropped.
+bool inferencePipeline_push(const int16_t* pcm);
+
+// For replays, where capture can wait: a full queue makes inferencePipeline_push wait for room instead of dropping the
+// frame. Before the first push.
+void inferencePipeline_setLossless(bool isLossless);
+
+// When the capture stage queued the frame being processed, on CLOCK_MONOTONIC in microseconds. Only from the process
+// function, or what it calls.
+long long inferencePipeline_frameQueuedUs(void);
+
+// Processes what is still queued, then joins the inference thread.
+void inferencePipeline_stop(void);
+
+// Safe from any thread; fields may be from slightly different instants.
+void inferencePipeline_getStats(inferencePipeline_stats* stats);
+
+// The SCHED_FIFO priority the inference thread runs at, 0 if normal, and the CPU it is pinned to, -1 if none.
+void inferencePipeline_getScheduling(int32_t* realtimePriority, int32_t* cpu);
+
+#endif
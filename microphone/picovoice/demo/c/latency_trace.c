@@ -0,0 +1,168 @@
+#include "latency_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// an inference whose feed was queued later than this was a delayed feed, not a command to time
+#define MAX_QUEUE_DELAY_US 1000000LL
+
+typedef struct {
+    // 0 while the slot is being written, otherwise the mark's index + 1
+    unsigned int sequence;
+    latencyTrace_event event;
+    long long timeUs;
+} traceEntry;
+
+typedef struct {
+    const char* name;
+    latencyTrace_event from;
+    latencyTrace_event to;
+} spanDefinition;
+
+static const char* eventNames[LATENCY_TRACE_EVENT_COUNT] = {
+    "frame captured", "wake word", "inference", "feed queued", "gate moved"};
+
+static const spanDefinition spans[] = {
+    {"wake word", LATENCY_TRACE_FRAME_CAPTURED, LATENCY_TRACE_WAKE_WORD},
+    {"command", LATENCY_TRACE_WAKE_WORD, LATENCY_TRACE_INFERENCE},
+    {"scheduling", LATENCY_TRACE_INFERENCE, LATENCY_TRACE_FEED_QUEUED},
+    {"actuation", LATENCY_TRACE_FEED_QUEUED, LATENCY_TRACE_GATE_MOVED},
+    {"total", LATENCY_TRACE_FRAME_CAPTURED, LATENCY_TRACE_GATE_MOVED},
+};
+#define SPAN_COUNT ((int) (sizeof(spans) / sizeof(spans[0])))
+
+static traceEntry ring[LATENCY_TRACE_RING_LENGTH];
+static unsigned int nextMark = 0;
+static long long lastUs[LATENCY_TRACE_EVENT_COUNT];
+
+// event loop thread only
+static long long spanSamples[SPAN_COUNT][LATENCY_TRACE_SPAN_SAMPLES];
+static int spanSampleCount = 0;
+static long long lastCommandGateUs = 0;
+
+long long latencyTrace_nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static long long lastMark(latencyTrace_event event)
+{
+    return __atomic_load_n(&lastUs[event], __ATOMIC_ACQUIRE);
+}
+
+// Keeps the spans of a spoken command once its gate has moved.
+static void completeCommand(long long gateUs)
+{
+    const long long inferenceUs = lastMark(LATENCY_TRACE_INFERENCE);
+    const long long queuedUs = lastMark(LATENCY_TRACE_FEED_QUEUED);
+    if (inferenceUs <= lastCommandGateUs || queuedUs < inferenceUs || queuedUs - inferenceUs > MAX_QUEUE_DELAY_US) {
+        return; // a button press, a timer, or a delayed feed
+    }
+    lastCommandGateUs = gateUs;
+    const int slot = spanSampleCount % LATENCY_TRACE_SPAN_SAMPLES;
+    for (int i = 0; i < SPAN_COUNT; i++) {
+        spanSamples[i][slot] = lastMark(spans[i].to) - lastMark(spans[i].from);
+    }
+    spanSampleCount++;
+}
+
+void latencyTrace_mark(latencyTrace_event event)
+{
+    latencyTrace_markAt(event, latencyTrace_nowUs());
+}
+
+void latencyTrace_markAt(latencyTrace_event event, long long timeUs)
+{
+    const unsigned int index = __atomic_fetch_add(&nextMark, 1, __ATOMIC_RELAXED);
+    traceEntry* entry = &ring[index % LATENCY_TRACE_RING_LENGTH];
+    __atomic_store_n(&entry->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    entry->event = event;
+    entry->timeUs = timeUs;
+    __atomic_store_n(&entry->sequence, index + 1, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&lastUs[event], timeUs, __ATOMIC_RELEASE);
+    if (event == LATENCY_TRACE_GATE_MOVED) {
+        completeCommand(timeUs);
+    }
+}
+
+// Copies the ring oldest first, leaving out slots that are being rewritten.
+static int snapshot(traceEntry* entries)
+{
+    const unsigned int end = __atomic_load_n(&nextMark, __ATOMIC_ACQUIRE);
+    const unsigned int start = end > LATENCY_TRACE_RING_LENGTH ? end - LATENCY_TRACE_RING_LENGTH : 0;
+    int count = 0;
+    for (unsigned int index = start; index != end; index++) {
+        const traceEntry* entry = &ring[index % LATENCY_TRACE_RING_LENGTH];
+        const unsigned int sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+        traceEntry copy = *entry;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (sequence == index + 1 && __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) == sequence) {
+            entries[count++] = copy;
+        }
+    }
+    return count;
+}
+
+bool latencyTrace_dump(const char* path)
+{
+    static traceEntry entries[LATENCY_TRACE_RING_LENGTH];
+    const int count = snapshot(entries);
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        perror("Latency trace: Unable to open the dump.");
+        return false;
+    }
+    const size_t length = strlen(path);
+    if (length > 4 && strcmp(path + length - 4, ".csv") == 0) {
+        fprintf(file, "event,time_us\n");
+        for (int i = 0; i < count; i++) {
+            fprintf(file, "%s,%lld\n", eventNames[entries[i].event], entries[i].timeUs);
+        }
+    } else {
+        // one track per stage, each mark an instant event
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (int i = 0; i < count; i++) {
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%lld}",
+                    i > 0 ? ",\n" : "", eventNames[entries[i].event], (int) entries[i].event + 1, entries[i].timeUs);
+        }
+        fprintf(file, "\n]}\n");
+    }
+    const bool ok = fclose(file) == 0;
+    if (ok) {
+        printf("Latency trace: %d marks written to %s\n", count, path);
+    }
+    return ok;
+}
+
+static int compareSamples(const void* a, const void* b)
+{
+    const long long x = *(const long long*) a;
+    const long long y = *(const long long*) b;
+    return (x > y) - (x < y);
+}
+
+void latencyTrace_printPercentiles(void)
+{
+    const int count = spanSampleCount < LATENCY_TRACE_SPAN_SAMPLES ? spanSampleCount : LATENCY_TRACE_SPAN_SAMPLES;
+    if (count == 0) {
+        printf("Latency trace: no spoken commands yet.\n");
+        return;
+    }
+    printf("Latency trace: last %d commands, ms p50 / p90 / p99\n", count);
+    for (int i = 0; i < SPAN_COUNT; i++) {
+        long long sorted[LATENCY_TRACE_SPAN_SAMPLES];
+        memcpy(sorted, spanSamples[i], (size_t) count * sizeof(sorted[0]));
+        qsort(sorted, (size_t) count, sizeof(sorted[0]), compareSamples);
+        printf("    %-10s : %.1f / %.1f / %.1f\n", spans[i].name,
+                sorted[(count - 1) * 50 / 100] / 1000.0,
+                sorted[(count - 1) * 90 / 100] / 1000.0,
+                sorted[(count - 1) * 99 / 100] / 1000.0);
+    }
+}
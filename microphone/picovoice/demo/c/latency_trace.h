@@ -0,0 +1,38 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdbool.h>
+
+// Where the time goes between a voice command and the hopper opening. Every stage marks a CLOCK_MONOTONIC timestamp
+// into a fixed ring that any thread can write to without locks; the ring can be dumped as Chrome trace JSON (for
+// chrome://tracing or Perfetto) or CSV. When the gate moves for a command that was spoken, the spans between its
+// marks are kept for percentiles. Span statistics and dumps belong to the event loop thread.
+
+#define LATENCY_TRACE_RING_LENGTH 256
+#define LATENCY_TRACE_SPAN_SAMPLES 64
+
+typedef enum {
+    // capture stage queued the frame on which the wake word ended
+    LATENCY_TRACE_FRAME_CAPTURED,
+    LATENCY_TRACE_WAKE_WORD,
+    LATENCY_TRACE_INFERENCE,
+    // the feed worker took the request
+    LATENCY_TRACE_FEED_QUEUED,
+    // first duty cycle write of the feed's profile
+    LATENCY_TRACE_GATE_MOVED,
+    LATENCY_TRACE_EVENT_COUNT
+} latencyTrace_event;
+
+long long latencyTrace_nowUs(void);
+
+// Safe from any thread.
+void latencyTrace_mark(latencyTrace_event event);
+void latencyTrace_markAt(latencyTrace_event event, long long timeUs);
+
+// Dumps the ring to path, as CSV if it ends in ".csv" and as Chrome trace JSON otherwise.
+bool latencyTrace_dump(const char* path);
+
+// Prints p50/p90/p99 of each span over the last LATENCY_TRACE_SPAN_SAMPLES spoken commands.
+void latencyTrace_printPercentiles(void);
+
+#endif
@@ -0,0 +1,177 @@
+#include "matrix_driver.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "i2c_bus.h"
+
+#define SYS_SETUP_REG 0X21
+// display on; the blink rate goes in bits 2 and 1
+#define DISPLAY_SETUP_REG 0x81
+// the brightness goes in the low four bits
+#define DIMMING_REG 0xE0
+#define DISPLAY_RAM_START 0x00
+// each row owns an even/odd register pair; the 8x8 matrix only wires the even one
+#define DISPLAY_RAM_SIZE (MATRIX_DRIVER_ROWS * 2)
+
+// what the bus queue coalesces by: the display RAM, and each command by its high nibble
+#define RAM_KEY DISPLAY_RAM_START
+#define DISPLAY_SETUP_KEY (DISPLAY_SETUP_REG & 0xF0)
+#define DIMMING_KEY DIMMING_REG
+
+static i2cBus_device device = -1;
+static pthread_mutex_t matrixLock = PTHREAD_MUTEX_INITIALIZER;
+// what the display will hold once the queued writes are out
+static unsigned char displayedRam[DISPLAY_RAM_SIZE];
+static bool isDisplayedRamValid = false;
+// RAM writes queued, and the last that went out; a queued one can be replaced, so while they differ a new write can't
+// count on the span of the one before
+static unsigned long long ramWritesQueued = 0;
+static unsigned long long ramWritesDone = 0;
+// what the chip is set to, or -1 if unknown
+static int blinkRate = -1;
+static int brightness = -1;
+
+bool matrixDriver_init(int address)
+{
+    pthread_mutex_lock(&matrixLock);
+    if (device >= 0) {
+        pthread_mutex_unlock(&matrixLock);
+        return true;
+    }
+    device = i2cBus_addDevice(address, I2C_BUS_PRIORITY_NORMAL);
+    pthread_mutex_unlock(&matrixLock);
+    if (device < 0) {
+        return false;
+    }
+
+    const unsigned char systemSetup[] = {SYS_SETUP_REG, 0x00}; // turn on the oscillator
+    const unsigned char displaySetup[] = {DISPLAY_SETUP_REG, 0x00}; // turn on the LEDs, no flashing
+    bool ok = i2cBus_writeAndWait(device, systemSetup, sizeof(systemSetup)) &&
+              i2cBus_writeAndWait(device, displaySetup, sizeof(displaySetup));
+
+    pthread_mutex_lock(&matrixLock);
+    isDisplayedRamValid = false;
+    blinkRate = ok ? MATRIX_DRIVER_BLINK_OFF : -1;
+    brightness = -1;
+    pthread_mutex_unlock(&matrixLock);
+    return ok;
+}
+
+// On the bus thread.
+static void onRamWritten(bool ok, void* userData)
+{
+    pthread_mutex_lock(&matrixLock);
+    ramWritesDone = (unsigned long long) (uintptr_t) userData;
+    if (!ok) {
+        // the next write sends all of it
+        isDisplayedRamValid = false;
+    }
+    pthread_mutex_unlock(&matrixLock);
+}
+
+void matrixDriver_writeRows(const unsigned char* rows)
+{
+    unsigned char ram[DISPLAY_RAM_SIZE];
+    memset(ram, 0, DISPLAY_RAM_SIZE);
+    for (int i = 0; i < MATRIX_DRIVER_ROWS; i++) {
+        ram[i * 2] = rows[i];
+    }
+
+    pthread_mutex_lock(&matrixLock);
+    if (device < 0) {
+        pthread_mutex_unlock(&matrixLock);
+        return;
+    }
+
+    // only the span from the first to the last changed byte goes out
+    int first = 0;
+    int last = DISPLAY_RAM_SIZE - 1;
+    if (isDisplayedRamValid) {
+        while (first < DISPLAY_RAM_SIZE && ram[first] == displayedRam[first]) {
+            first++;
+        }
+        if (first == DISPLAY_RAM_SIZE) {
+            pthread_mutex_unlock(&matrixLock);
+            return;
+        }
+        while (ram[last] == displayedRam[last]) {
+            last--;
+        }
+        // a write still queued may be replaced by this one, and its span with it
+        if (ramWritesDone != ramWritesQueued) {
+            first = 0;
+            last = DISPLAY_RAM_SIZE - 1;
+        }
+    }
+
+    // the address pointer auto-increments, so the span goes out in one write
+    unsigned char buff[1 + DISPLAY_RAM_SIZE];
+    const int length = last - first + 1;
+    buff[0] = DISPLAY_RAM_START + first;
+    memcpy(buff + 1, ram + first, length);
+
+    const unsigned long long write = ramWritesQueued + 1;
+    if (i2cBus_write(device, RAM_KEY, buff, 1 + length, onRamWritten, (void*) (uintptr_t) write)) {
+        ramWritesQueued = write;
+        memcpy(displayedRam, ram, DISPLAY_RAM_SIZE);
+        isDisplayedRamValid = true;
+    } else {
+        isDisplayedRamValid = false;
+    }
+    pthread_mutex_unlock(&matrixLock);
+}
+
+void matrixDriver_clear(void)
+{
+    const unsigned char rows[MATRIX_DRIVER_ROWS] = {0};
+    matrixDriver_writeRows(rows);
+}
+
+// On the bus thread: userData is the cached setting, which is no longer known if the command failed.
+static void onCommandWritten(bool ok, void* userData)
+{
+    if (!ok) {
+        pthread_mutex_lock(&matrixLock);
+        *(int*) userData = -1;
+        pthread_mutex_unlock(&matrixLock);
+    }
+}
+
+// One command byte, e.g. the display setup or dimming, queued unless cached already holds value.
+static void writeCommand(int* cached, int value, int key, unsigned char command)
+{
+    pthread_mutex_lock(&matrixLock);
+    if (device >= 0 && *cached != value) {
+        *cached = i2cBus_write(device, key, &command, 1, onCommandWritten, cached) ? value : -1;
+    }
+    pthread_mutex_unlock(&matrixLock);
+}
+
+void matrixDriver_setBlink(matrixDriver_blinkRate rate)
+{
+    writeCommand(&blinkRate, rate, DISPLAY_SETUP_KEY, (unsigned char) (DISPLAY_SETUP_REG | (rate << 1)));
+}
+
+void matrixDriver_setBrightness(int level)
+{
+    if (level < 0) {
+        level = 0;
+    } else if (level > MATRIX_DRIVER_MAX_BRIGHTNESS) {
+        level = MATRIX_DRIVER_MAX_BRIGHTNESS;
+    }
+    writeCommand(&brightness, level, DIMMING_KEY, (unsigned char) (DIMMING_REG | level));
+}
+
+void matrixDriver_cleanup(void)
+{
+    pthread_mutex_lock(&matrixLock);
+    device = -1;
+    isDisplayedRamValid = false;
+    ramWritesQueued = 0;
+    ramWritesDone = 0;
+    blinkRate = -1;
+    brightness = -1;
+    pthread_mutex_unlock(&matrixLock);
+}
@@ -0,0 +1,39 @@
+#ifndef MATRIX_DRIVER_H
+#define MATRIX_DRIVER_H
+
+#include <stdbool.h>
+
+#define MATRIX_DRIVER_ROWS 8
+#define MATRIX_DRIVER_MAX_BRIGHTNESS 15
+
+// Driver for the HT16K33 8x8 LED matrix, a device on the I2C bus manager. Drawing queues the write and returns; a frame
+// drawn before the last one went out replaces it in the queue. Safe from any thread.
+//
+// Blinking and dimming are done by the chip itself: each is one command byte, after which the display keeps it up with
+// nothing more sent, whatever is drawn meanwhile.
+
+typedef enum {
+    MATRIX_DRIVER_BLINK_OFF,
+    MATRIX_DRIVER_BLINK_2HZ,
+    MATRIX_DRIVER_BLINK_1HZ,
+    MATRIX_DRIVER_BLINK_HALF_HZ,
+} matrixDriver_blinkRate;
+
+// Adds the device to the bus, which has to be open, and turns the display on, waiting for it. Returns false if the
+// display doesn't answer.
+bool matrixDriver_init(int address);
+
+// Queues one byte per row for display RAM, as a single auto-increment transaction.
+// Only the rows that differ from what the display will hold are sent; nothing is sent when none do.
+void matrixDriver_writeRows(const unsigned char* rows);
+
+void matrixDriver_clear(void);
+
+// Like writeRows, these send nothing if the display is already set that way.
+void matrixDriver_setBlink(matrixDriver_blinkRate rate);
+// 0 (1/16 duty) to MATRIX_DRIVER_MAX_BRIGHTNESS (full)
+void matrixDriver_setBrightness(int level);
+
+void matrixDriver_cleanup(void);
+
+#endif
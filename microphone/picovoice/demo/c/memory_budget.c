@@ -0,0 +1,84 @@
+#include "memory_budget.h"
+
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    const char* subsystem;
+    long long bytes;
+    bool isHeap;
+} budgetEntry;
+
+static pthread_mutex_t entriesLock = PTHREAD_MUTEX_INITIALIZER;
+static budgetEntry entries[MEMORY_BUDGET_MAX_ENTRIES];
+static int entryCount = 0;
+
+void memoryBudget_add(const char* subsystem, long long bytes, bool isHeap)
+{
+    pthread_mutex_lock(&entriesLock);
+    // a subsystem started more than once, e.g. the voice gate's pre-roll, is counted once
+    for (int i = 0; i < entryCount; i++) {
+        if (strcmp(entries[i].subsystem, subsystem) == 0) {
+            entries[i].bytes = bytes;
+            pthread_mutex_unlock(&entriesLock);
+            return;
+        }
+    }
+    if (entryCount < MEMORY_BUDGET_MAX_ENTRIES) {
+        entries[entryCount++] = (budgetEntry) {subsystem, bytes, isHeap};
+    }
+    pthread_mutex_unlock(&entriesLock);
+}
+
+// Heap in use by the whole process, or -1 where the C library can't tell.
+static long long heapInUse(void)
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (long long) (info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+void memoryBudget_print(void)
+{
+    pthread_mutex_lock(&entriesLock);
+    long long heap = 0;
+    long long total = 0;
+    printf("Memory budget :\n");
+    for (int i = 0; i < entryCount; i++) {
+        printf("    %-20s : %8lld KiB%s\n", entries[i].subsystem, entries[i].bytes / 1024,
+                entries[i].isHeap ? "" : " (static)");
+        total += entries[i].bytes;
+        if (entries[i].isHeap) {
+            heap += entries[i].bytes;
+        }
+    }
+    pthread_mutex_unlock(&entriesLock);
+    printf("    %-20s : %8lld KiB\n", "subsystems", total / 1024);
+    const long long processHeap = heapInUse();
+    if (processHeap >= 0) {
+        printf("    %-20s : %8lld KiB\n", "engines and libraries", (processHeap - heap) / 1024);
+    }
+    const long long resident = memoryBudget_residentBytes();
+    if (resident >= 0) {
+        printf("    %-20s : %8lld KiB\n", "resident", resident / 1024);
+    }
+}
+
+long long memoryBudget_residentBytes(void)
+{
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (file == NULL) {
+        return -1;
+    }
+    long long sizePages = 0;
+    long long residentPages = -1;
+    const bool isRead = fscanf(file, "%lld %lld", &sizePages, &residentPages) == 2;
+    fclose(file);
+    return isRead ? residentPages * sysconf(_SC_PAGESIZE) : -1;
+}
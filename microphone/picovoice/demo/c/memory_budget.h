@@ -0,0 +1,20 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <stdbool.h>
+
+// What each subsystem sets aside at startup, so the steady state never has to ask for more. Subsystems add their rings,
+// queues and buffers as they allocate them, from any thread; the demo prints the table once it is listening, along
+// with the heap the engines and libraries hold beyond the subsystems' share.
+
+#define MEMORY_BUDGET_MAX_ENTRIES 16
+
+// isHeap for malloc'd memory, false for static arrays.
+void memoryBudget_add(const char* subsystem, long long bytes, bool isHeap);
+
+void memoryBudget_print(void);
+
+// The process's resident set, from /proc/self/statm, or -1 if it can't be read. Safe from any thread.
+long long memoryBudget_residentBytes(void);
+
+#endif
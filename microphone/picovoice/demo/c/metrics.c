@@ -0,0 +1,321 @@
+#include "metrics.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "thread_cpu.h"
+
+#define MAX_NAME_LENGTH 64
+#define MAX_HELP_LENGTH 96
+#define MAX_REQUEST_LENGTH 1024
+#define RESPONSE_SIZE 16384
+// a scraper that connects and says nothing doesn't hold the endpoint for long
+#define CLIENT_TIMEOUT_SECONDS 1
+
+typedef enum {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+} metricType;
+
+typedef struct {
+    metricType type;
+    char name[MAX_NAME_LENGTH];
+    char help[MAX_HELP_LENGTH];
+    // counter value, or a gauge's double bit for bit
+    long long value;
+    double bounds[METRICS_MAX_BUCKETS];
+    int boundCount;
+    // per bucket, not cumulative; the last one is +Inf
+    long long buckets[METRICS_MAX_BUCKETS + 1];
+    long long sumBits;
+} metric;
+
+static metric metrics[METRICS_MAX];
+static int metricCount = 0;
+static pthread_mutex_t registerLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int listenFd = -1;
+static pthread_t threadServer;
+static bool isServing = false;
+static metrics_collectFunc collectFunc = NULL;
+static char response[RESPONSE_SIZE];
+
+static long long bitsOf(double value)
+{
+    long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double doubleOf(long long bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static metrics_id addMetric(metricType type, const char* name, const char* help, const double* bounds, int boundCount)
+{
+    if (boundCount < 0 || boundCount > METRICS_MAX_BUCKETS) {
+        return -1;
+    }
+    pthread_mutex_lock(&registerLock);
+    const int id = metricCount;
+    if (id == METRICS_MAX) {
+        pthread_mutex_unlock(&registerLock);
+        printf("Metrics: registry full, '%s' dropped.\n", name);
+        return -1;
+    }
+    metric* entry = &metrics[id];
+    memset(entry, 0, sizeof(*entry));
+    entry->type = type;
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    snprintf(entry->help, sizeof(entry->help), "%s", help);
+    for (int i = 0; i < boundCount; i++) {
+        entry->bounds[i] = bounds[i];
+    }
+    entry->boundCount = boundCount;
+    // the serving thread only reads entries below the published count
+    __atomic_store_n(&metricCount, id + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&registerLock);
+    return id;
+}
+
+metrics_id metrics_addCounter(const char* name, const char* help)
+{
+    return addMetric(METRIC_COUNTER, name, help, NULL, 0);
+}
+
+metrics_id metrics_addGauge(const char* name, const char* help)
+{
+    return addMetric(METRIC_GAUGE, name, help, NULL, 0);
+}
+
+metrics_id metrics_addHistogram(const char* name, const char* help, const double* bounds, int boundCount)
+{
+    return addMetric(METRIC_HISTOGRAM, name, help, bounds, boundCount);
+}
+
+void metrics_add(metrics_id id, long long amount)
+{
+    if (id >= 0) {
+        __atomic_fetch_add(&metrics[id].value, amount, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_store(metrics_id id, long long value)
+{
+    if (id >= 0) {
+        __atomic_store_n(&metrics[id].value, value, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_set(metrics_id id, double value)
+{
+    if (id >= 0) {
+        __atomic_store_n(&metrics[id].value, bitsOf(value), __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_observe(metrics_id id, double value)
+{
+    if (id < 0) {
+        return;
+    }
+    metric* entry = &metrics[id];
+    int bucket = 0;
+    while (bucket < entry->boundCount && value > entry->bounds[bucket]) {
+        bucket++;
+    }
+    __atomic_fetch_add(&entry->buckets[bucket], 1, __ATOMIC_RELAXED);
+    const double sum = doubleOf(__atomic_load_n(&entry->sumBits, __ATOMIC_RELAXED)) + value;
+    __atomic_store_n(&entry->sumBits, bitsOf(sum), __ATOMIC_RELAXED);
+}
+
+// Length of the name before its labels, so labelled series can share a family.
+static size_t familyLength(const char* name)
+{
+    const char* labels = strchr(name, '{');
+    return labels ? (size_t) (labels - name) : strlen(name);
+}
+
+static void append(size_t* length, const char* format, ...)
+{
+    if (*length >= sizeof(response)) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(response + *length, sizeof(response) - *length, format, args);
+    va_end(args);
+    if (written > 0) {
+        *length += (size_t) written;
+        if (*length > sizeof(response)) {
+            *length = sizeof(response);
+        }
+    }
+}
+
+static size_t render(void)
+{
+    static const char* typeNames[] = {"counter", "gauge", "histogram"};
+    size_t length = 0;
+    const int count = __atomic_load_n(&metricCount, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        const metric* entry = &metrics[i];
+        const size_t family = familyLength(entry->name);
+        if (i == 0 || family != familyLength(metrics[i - 1].name) ||
+                strncmp(entry->name, metrics[i - 1].name, family) != 0) {
+            append(&length, "# HELP %.*s %s\n", (int) family, entry->name, entry->help);
+            append(&length, "# TYPE %.*s %s\n", (int) family, entry->name, typeNames[entry->type]);
+        }
+        const long long value = __atomic_load_n(&entry->value, __ATOMIC_RELAXED);
+        if (entry->type == METRIC_COUNTER) {
+            append(&length, "%s %lld\n", entry->name, value);
+        } else if (entry->type == METRIC_GAUGE) {
+            append(&length, "%s %.9g\n", entry->name, doubleOf(value));
+        } else {
+            long long cumulative = 0;
+            for (int j = 0; j <= entry->boundCount; j++) {
+                cumulative += __atomic_load_n(&entry->buckets[j], __ATOMIC_RELAXED);
+                if (j < entry->boundCount) {
+                    append(&length, "%s_bucket{le=\"%g\"} %lld\n", entry->name, entry->bounds[j], cumulative);
+                } else {
+                    append(&length, "%s_bucket{le=\"+Inf\"} %lld\n", entry->name, cumulative);
+                }
+            }
+            append(&length, "%s_sum %.9g\n", entry->name,
+                    doubleOf(__atomic_load_n(&entry->sumBits, __ATOMIC_RELAXED)));
+            append(&length, "%s_count %lld\n", entry->name, cumulative);
+        }
+    }
+
+    struct timespec cpu;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    append(&length, "# HELP process_cpu_seconds_total Total user and system CPU time spent in seconds.\n");
+    append(&length, "# TYPE process_cpu_seconds_total counter\n");
+    append(&length, "process_cpu_seconds_total %.3f\n", cpu.tv_sec + cpu.tv_nsec / 1e9);
+    return length;
+}
+
+static bool writeAll(int fd, const char* data, size_t length)
+{
+    while (length > 0) {
+        // a scraper that hung up must not take the daemon down with SIGPIPE
+        const ssize_t written = send(fd, data, length, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t) written;
+    }
+    return true;
+}
+
+static void answer(int clientFd)
+{
+    const struct timeval timeout = {CLIENT_TIMEOUT_SECONDS, 0};
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // the request itself doesn't matter: every path gets the metrics, once its headers are in
+    char request[MAX_REQUEST_LENGTH + 1];
+    size_t received = 0;
+    while (received < MAX_REQUEST_LENGTH) {
+        const ssize_t n = read(clientFd, request + received, MAX_REQUEST_LENGTH - received);
+        if (n <= 0) {
+            return;
+        }
+        received += (size_t) n;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) {
+            break;
+        }
+    }
+
+    if (collectFunc != NULL) {
+        collectFunc();
+    }
+    const size_t length = render();
+    char header[160];
+    const int headerLength = snprintf(header, sizeof(header),
+            "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n"
+            "Connection: close\r\n\r\n", length);
+    if (writeAll(clientFd, header, (size_t) headerLength)) {
+        writeAll(clientFd, response, length);
+    }
+}
+
+static void* runServer(void* arg)
+{
+    (void) arg;
+    while (true) {
+        const int clientFd = accept(listenFd, NULL, NULL);
+        if (clientFd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break; // metrics_stop shut the socket down
+        }
+        answer(clientFd);
+        close(clientFd);
+    }
+    return NULL;
+}
+
+bool metrics_serve(int port, metrics_collectFunc collect)
+{
+    collectFunc = collect;
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        perror("Metrics: Unable to create socket.");
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((unsigned short) port);
+    if (bind(listenFd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listenFd, 4) != 0) {
+        perror("Metrics: Unable to listen.");
+        metrics_stop();
+        return false;
+    }
+    if (pthread_create(&threadServer, NULL, runServer, NULL) != 0) {
+        printf("Metrics: Unable to start the server thread.\n");
+        metrics_stop();
+        return false;
+    }
+    isServing = true;
+    threadCpu_setName(threadServer, "metrics");
+    return true;
+}
+
+void metrics_stop(void)
+{
+    if (listenFd < 0) {
+        return;
+    }
+    // wakes the accept
+    shutdown(listenFd, SHUT_RDWR);
+    if (isServing) {
+        pthread_join(threadServer, NULL);
+        isServing = false;
+    }
+    close(listenFd);
+    listenFd = -1;
+}
@@ -0,0 +1,39 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+
+// A small registry of counters, gauges and histograms, served in the Prometheus text format over HTTP from a thread
+// of its own, so a scrape never runs on the audio, inference or event loop threads. Updates are single atomic
+// operations and never block. Metrics are registered once, from any thread, and never removed.
+
+#define METRICS_MAX 48
+#define METRICS_MAX_BUCKETS 12
+#define METRICS_DEFAULT_PORT 9469
+
+typedef int metrics_id;
+
+// name may carry labels, e.g. "feeder_feeds_total{mode=\"0\"}"; series with the same name before the labels share
+// one HELP and TYPE, so register them one after another. Returns -1 once the registry is full.
+metrics_id metrics_addCounter(const char* name, const char* help);
+metrics_id metrics_addGauge(const char* name, const char* help);
+// bounds are the buckets' upper edges, ascending; an +Inf bucket is added. No labels.
+metrics_id metrics_addHistogram(const char* name, const char* help, const double* bounds, int boundCount);
+
+// Safe from any thread. An id of -1 is ignored, so a failed registration only loses that metric.
+void metrics_add(metrics_id id, long long amount);
+// For a counter kept elsewhere and copied in, e.g. by the collect function.
+void metrics_store(metrics_id id, long long value);
+void metrics_set(metrics_id id, double value);
+// Safe from one thread per histogram.
+void metrics_observe(metrics_id id, double value);
+
+// Runs on the serving thread before each scrape, to refresh gauges that are read rather than pushed.
+typedef void (*metrics_collectFunc)(void);
+
+// Serves GET /metrics (any path, in fact) on the given TCP port. process_cpu_seconds_total is always included.
+bool metrics_serve(int port, metrics_collectFunc collect);
+
+void metrics_stop(void);
+
+#endif
@@ -0,0 +1,330 @@
+#include "mic_harness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <windows.h>
+
+#elif !defined(__linux__)
+
+#include <time.h>
+
+#else
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "inference_pipeline.h"
+#include "latency_trace.h"
+#include "metrics.h"
+#include "voice_gate.h"
+
+#endif
+
+#include "pv_recorder.h"
+
+static pv_recorder_t* recorder = NULL;
+static micHarness_processFunc processFunc = NULL;
+static void* processUserData = NULL;
+static bool isInterrupted = false;
+
+void micHarness_defaultConfig(micHarness_config* config, int32_t frameLength, int32_t sampleRate)
+{
+    *config = (micHarness_config) {
+            .deviceIndex = -1,
+            .frameLength = frameLength,
+            .sampleRate = sampleRate,
+            .bufferSizeMs = 100,
+            .vadThresholdDb = 0.f,
+            .vadHangoverMs = 600,
+            .vadPreRollMs = 320,
+            .metricsPort = 0,
+            .realtimePriority = 0,
+            .cpu = -1,
+    };
+}
+
+static bool openRecorder(const micHarness_config* config)
+{
+    pv_recorder_status_t status =
+            pv_recorder_init(config->deviceIndex, config->frameLength, config->bufferSizeMs, true, true, &recorder);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(status));
+        return false;
+    }
+    return true;
+}
+
+static bool startRecorder(void)
+{
+    pv_recorder_status_t status = pv_recorder_start(recorder);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to start device with %s.\n", pv_recorder_status_to_string(status));
+        return false;
+    }
+    return true;
+}
+
+static void closeRecorder(void)
+{
+    if (recorder == NULL) {
+        return;
+    }
+    pv_recorder_status_t status = pv_recorder_stop(recorder);
+    if (status != PV_RECORDER_STATUS_SUCCESS && status != PV_RECORDER_STATUS_INVALID_STATE) {
+        fprintf(stderr, "Failed to stop device with %s.\n", pv_recorder_status_to_string(status));
+    }
+    pv_recorder_delete(recorder);
+    recorder = NULL;
+}
+
+const char* micHarness_deviceName(void)
+{
+    return recorder != NULL ? pv_recorder_get_selected_device(recorder) : "";
+}
+
+#if !defined(__linux__)
+
+static int16_t* pcm = NULL;
+static long long frameReadUs = 0;
+
+static long long nowUs(void)
+{
+
+#if defined(_WIN32) || defined(_WIN64)
+
+    return (long long) GetTickCount64() * 1000;
+
+#else
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+#endif
+
+}
+
+bool micHarness_start(const micHarness_config* config, micHarness_processFunc process, void* userData)
+{
+    processFunc = process;
+    processUserData = userData;
+    isInterrupted = false;
+    pcm = malloc((size_t) config->frameLength * sizeof(int16_t));
+    if (pcm == NULL) {
+        fprintf(stderr, "Failed to allocate pcm memory.\n");
+        return false;
+    }
+    if (!openRecorder(config) || !startRecorder()) {
+        micHarness_stop();
+        return false;
+    }
+    return true;
+}
+
+void micHarness_wait(void)
+{
+    while (!isInterrupted) {
+        pv_recorder_status_t status = pv_recorder_read(recorder, pcm);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to read with %s.\n", pv_recorder_status_to_string(status));
+            return;
+        }
+        frameReadUs = nowUs();
+        if (!processFunc(pcm, processUserData)) {
+            return;
+        }
+    }
+}
+
+void micHarness_interrupt(void)
+{
+    isInterrupted = true;
+}
+
+void micHarness_stop(void)
+{
+    closeRecorder();
+    free(pcm);
+    pcm = NULL;
+}
+
+long long micHarness_frameCapturedUs(void)
+{
+    return frameReadUs;
+}
+
+#else
+
+// micHarness_interrupt signals it, and micHarness_wait reads it
+static int stopFd = -1;
+static bool isGated = false;
+static bool isPipelineRunning = false;
+static metrics_id droppedMetric = -1;
+static metrics_id queueDepthMetric = -1;
+static metrics_id frameTimeMetric = -1;
+
+static int framesForMs(int32_t ms, int32_t frameLength, int32_t sampleRate)
+{
+    const long long samples = ((long long) ms * sampleRate) / 1000;
+    return (int) ((samples + frameLength - 1) / frameLength);
+}
+
+// The capture stage, on the recorder's thread.
+static void onFrame(const int16_t* pcm, void* userData)
+{
+    (void) userData;
+    inferencePipeline_push(pcm);
+}
+
+static void pass(const int16_t* pcm, void* userData)
+{
+    (void) userData;
+    if (__atomic_load_n(&isInterrupted, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    if (!processFunc(pcm, processUserData)) {
+        micHarness_interrupt();
+    }
+}
+
+// The process stage, on the pipeline's thread.
+static void processFrame(const int16_t* pcm, void* userData)
+{
+    (void) userData;
+    const long long startUs = latencyTrace_nowUs();
+    if (isGated) {
+        voiceGate_process(pcm, pass, NULL);
+    } else {
+        pass(pcm, NULL);
+    }
+    metrics_observe(frameTimeMetric, (double) (latencyTrace_nowUs() - startUs) / 1e6);
+}
+
+static void collectMetrics(void)
+{
+    inferencePipeline_stats stats;
+    inferencePipeline_getStats(&stats);
+    metrics_store(droppedMetric, stats.droppedFrames);
+    metrics_set(queueDepthMetric, stats.queueDepth);
+}
+
+static void serveMetrics(int port)
+{
+    static const double frameTimeBounds[] = {0.001, 0.002, 0.005, 0.01, 0.015, 0.02, 0.025, 0.032, 0.05, 0.1};
+    droppedMetric =
+            metrics_addCounter("mic_frames_dropped_total", "Frames dropped because the process queue was full.");
+    queueDepthMetric = metrics_addGauge("mic_process_queue_depth", "Frames waiting for the process stage.");
+    frameTimeMetric = metrics_addHistogram("mic_frame_process_seconds", "Time the process stage spends on a frame.",
+            frameTimeBounds, (int) (sizeof(frameTimeBounds) / sizeof(frameTimeBounds[0])));
+    if (metrics_serve(port, collectMetrics)) {
+        fprintf(stdout, "Metrics on port %d\n", port);
+    }
+}
+
+bool micHarness_start(const micHarness_config* config, micHarness_processFunc process, void* userData)
+{
+    processFunc = process;
+    processUserData = userData;
+    isInterrupted = false;
+    stopFd = eventfd(0, EFD_CLOEXEC);
+    if (stopFd < 0) {
+        perror("Mic harness: Unable to create the stop eventfd.");
+        micHarness_stop();
+        return false;
+    }
+    asyncLog_start(ASYNC_LOG_SINK_STDOUT, NULL, ASYNC_LOG_INFO);
+
+    if (config->vadThresholdDb > 0.f) {
+        const voiceGate_config gateConfig = {
+                .thresholdDb = config->vadThresholdDb,
+                .hangoverFrames = framesForMs(config->vadHangoverMs, config->frameLength, config->sampleRate),
+                .preRollFrames = framesForMs(config->vadPreRollMs, config->frameLength, config->sampleRate),
+        };
+        if (!voiceGate_init(config->frameLength, &gateConfig)) {
+            micHarness_stop();
+            return false;
+        }
+        isGated = true;
+    }
+    if (config->metricsPort > 0) {
+        serveMetrics(config->metricsPort);
+    }
+
+    if (!openRecorder(config)) {
+        micHarness_stop();
+        return false;
+    }
+    pv_recorder_status_t status = pv_recorder_set_frame_callback(recorder, onFrame, NULL);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to set the frame callback with %s.\n", pv_recorder_status_to_string(status));
+        micHarness_stop();
+        return false;
+    }
+    isPipelineRunning = inferencePipeline_start(
+            config->frameLength, processFrame, NULL, config->realtimePriority, config->cpu);
+    if (!isPipelineRunning || !startRecorder()) {
+        micHarness_stop();
+        return false;
+    }
+    return true;
+}
+
+void micHarness_wait(void)
+{
+    uint64_t count;
+    while (read(stopFd, &count, sizeof(count)) < 0 && errno == EINTR) {}
+}
+
+void micHarness_interrupt(void)
+{
+    __atomic_store_n(&isInterrupted, true, __ATOMIC_RELEASE);
+    const uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) < 0) {}
+}
+
+void micHarness_stop(void)
+{
+    __atomic_store_n(&isInterrupted, true, __ATOMIC_RELEASE);
+    closeRecorder();
+    metrics_stop();
+    if (isPipelineRunning) {
+        inferencePipeline_stop();
+        isPipelineRunning = false;
+
+        inferencePipeline_stats stats;
+        inferencePipeline_getStats(&stats);
+        fprintf(stdout, "capture : %lld frames, %lld dropped, longest gap %.1f ms, queue up to %d of %d\n",
+                stats.capturedFrames, stats.droppedFrames, stats.maxCaptureIntervalUs / 1000.0, stats.maxQueueDepth,
+                INFERENCE_PIPELINE_QUEUE_LENGTH);
+        fprintf(stdout, "process : %lld frames, %.2f ms average, %.2f ms longest, longest wait %.1f ms\n",
+                stats.processedFrames,
+                (stats.processedFrames > 0) ? (stats.totalProcessUs / 1000.0) / stats.processedFrames : 0.0,
+                stats.maxProcessUs / 1000.0, stats.maxQueueWaitUs / 1000.0);
+    }
+    if (isGated) {
+        voiceGate_stats gateStats;
+        voiceGate_getStats(&gateStats);
+        fprintf(stdout, "voice gate : %lld of %lld frames processed, opened %lld times, noise floor %.1f dBFS\n",
+                gateStats.passedFrames, gateStats.frames, gateStats.openings, gateStats.noiseFloorDb);
+        voiceGate_cleanup();
+        isGated = false;
+    }
+    asyncLog_stop();
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+}
+
+long long micHarness_frameCapturedUs(void)
+{
+    return inferencePipeline_frameQueuedUs();
+}
+
+#endif
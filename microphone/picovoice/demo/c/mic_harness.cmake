@@ -0,0 +1,39 @@
+# The mic harness, mic_harness.h, and the modules it runs on, for the mic demos: this directory's, and Porcupine's and
+# Rhino's under resources/, which include this file. Link $<TARGET_OBJECTS:mic_harness_object> and
+# $<TARGET_OBJECTS:pv_recorder_object>, add MIC_HARNESS_INCLUDE_DIRS and link MIC_HARNESS_LIBS.
+
+if (NOT TARGET pv_recorder_object)
+    add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/pvrecorder ${CMAKE_BINARY_DIR}/pvrecorder EXCLUDE_FROM_ALL)
+endif()
+
+set(MIC_HARNESS_INCLUDE_DIRS ${CMAKE_CURRENT_LIST_DIR} ${CMAKE_CURRENT_LIST_DIR}/pvrecorder/include)
+
+if (NOT CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    # reads and processes on one thread; the pipeline, gate and metrics are Linux only
+    add_library(mic_harness_object OBJECT ${CMAKE_CURRENT_LIST_DIR}/mic_harness.c)
+    if (WIN32)
+        set(MIC_HARNESS_LIBS)
+    else()
+        set(MIC_HARNESS_LIBS pthread m)
+    endif()
+else()
+    add_library(
+            mic_harness_object OBJECT
+            ${CMAKE_CURRENT_LIST_DIR}/mic_harness.c
+            ${CMAKE_CURRENT_LIST_DIR}/inference_pipeline.c
+            ${CMAKE_CURRENT_LIST_DIR}/voice_gate.c
+            ${CMAKE_CURRENT_LIST_DIR}/metrics.c
+            ${CMAKE_CURRENT_LIST_DIR}/latency_trace.c
+            ${CMAKE_CURRENT_LIST_DIR}/async_log.c
+            ${CMAKE_CURRENT_LIST_DIR}/memory_budget.c
+            ${CMAKE_CURRENT_LIST_DIR}/thread_cpu.c
+            ${CMAKE_CURRENT_LIST_DIR}/alloc_guard.c)
+    set(MIC_HARNESS_LIBS pthread m)
+    if (PV_RECORDER_ALSA_MMAP)
+        list(APPEND MIC_HARNESS_LIBS asound)
+    endif()
+    if ((${CMAKE_SYSTEM_PROCESSOR} MATCHES "arm") AND (UNIX AND NOT APPLE))
+        list(APPEND MIC_HARNESS_LIBS atomic)
+    endif()
+endif()
+target_include_directories(mic_harness_object PRIVATE ${MIC_HARNESS_INCLUDE_DIRS})
@@ -0,0 +1,51 @@
+#ifndef MIC_HARNESS_H
+#define MIC_HARNESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The capture-and-process loop shared by the mic demos, so what is done for capture once applies to every engine:
+// pv_recorder pushes each frame from its callback into the inference pipeline's lock-free queue, and the pipeline's
+// thread runs it through an optional voice gate and then the demo's process function. Frame times, drops and queue
+// depth are served as Prometheus metrics when asked for, and printed on stop. Everything engine specific stays in the
+// demo. Elsewhere than Linux the frames are read and processed on the thread that waits, without the gate or the
+// metrics.
+
+typedef struct {
+    int32_t deviceIndex; // -1 for the default device
+    int32_t frameLength; // the engine's
+    int32_t sampleRate;
+    int32_t bufferSizeMs;
+    // how far above the room's noise floor a frame has to be to count as voice; 0 leaves the voice gate out
+    float vadThresholdDb;
+    int32_t vadHangoverMs;
+    int32_t vadPreRollMs;
+    int metricsPort; // 0 for none
+    // SCHED_FIFO priority of the process thread, 0 for normal, and the CPU it is pinned to, -1 for any
+    int32_t realtimePriority;
+    int32_t cpu;
+} micHarness_config;
+
+void micHarness_defaultConfig(micHarness_config* config, int32_t frameLength, int32_t sampleRate);
+
+// On the process thread for every frame that gets through the gate, in order. Returning false ends micHarness_wait.
+typedef bool (*micHarness_processFunc)(const int16_t* pcm, void* userData);
+
+// Opens the device and starts capturing. Prints why and returns false if it can't.
+bool micHarness_start(const micHarness_config* config, micHarness_processFunc process, void* userData);
+
+const char* micHarness_deviceName(void);
+
+// Blocks until the process function returns false or micHarness_interrupt is called.
+void micHarness_wait(void);
+
+// Async-signal-safe, e.g. from a SIGINT handler. Frames after the one being processed are skipped.
+void micHarness_interrupt(void);
+
+// Stops capturing, drains the queue, prints the stats and closes the device.
+void micHarness_stop(void);
+
+// When the frame being processed was captured, on a monotonic clock in microseconds. Only from the process function.
+long long micHarness_frameCapturedUs(void);
+
+#endif
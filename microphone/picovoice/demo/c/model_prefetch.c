@@ -0,0 +1,93 @@
+#define _GNU_SOURCE
+
+#include "model_prefetch.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "latency_trace.h"
+#include "thread_cpu.h"
+
+typedef struct {
+    const char* path;
+    pthread_t thread;
+    bool isRunning;
+    long long bytes;
+    long long doneUs;
+} prefetchedFile;
+
+static prefetchedFile files[MODEL_PREFETCH_MAX_FILES];
+static int fileCount = 0;
+static long long startUs = 0;
+
+static void* prefetch(void* arg)
+{
+    prefetchedFile* file = arg;
+    int fd = open(file->path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        struct stat status;
+        if (fstat(fd, &status) == 0 && status.st_size > 0) {
+            // the advice starts the reads; readahead then waits until the whole file has been asked for
+            posix_fadvise(fd, 0, status.st_size, POSIX_FADV_WILLNEED);
+            if (readahead(fd, 0, (size_t) status.st_size) == 0) {
+                file->bytes = status.st_size;
+            }
+        }
+        close(fd);
+    }
+    file->doneUs = latencyTrace_nowUs();
+    return NULL;
+}
+
+static bool isListed(const char* path)
+{
+    for (int i = 0; i < fileCount; i++) {
+        if (strcmp(files[i].path, path) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void modelPrefetch_start(const char* const* paths, int count)
+{
+    startUs = latencyTrace_nowUs();
+    for (int i = 0; i < count && fileCount < MODEL_PREFETCH_MAX_FILES; i++) {
+        if (paths[i] == NULL || isListed(paths[i])) {
+            continue;
+        }
+        prefetchedFile* file = &files[fileCount++];
+        *file = (prefetchedFile) {paths[i], 0, false, 0, 0};
+        file->isRunning = (pthread_create(&file->thread, NULL, prefetch, file) == 0);
+        if (file->isRunning) {
+            threadCpu_setName(file->thread, "prefetch");
+        } else {
+            prefetch(file);
+        }
+    }
+}
+
+void modelPrefetch_join(modelPrefetch_stats* stats)
+{
+    *stats = (modelPrefetch_stats) {0, 0, 0};
+    long long lastUs = startUs;
+    for (int i = 0; i < fileCount; i++) {
+        prefetchedFile* file = &files[i];
+        if (file->isRunning) {
+            pthread_join(file->thread, NULL);
+            file->isRunning = false;
+        }
+        if (file->bytes > 0) {
+            stats->files++;
+            stats->bytes += file->bytes;
+        }
+        if (file->doneUs > lastUs) {
+            lastUs = file->doneUs;
+        }
+    }
+    stats->elapsedUs = lastUs - startUs;
+}
@@ -0,0 +1,24 @@
+#ifndef MODEL_PREFETCH_H
+#define MODEL_PREFETCH_H
+
+// Pulls the model files into the page cache while the rest of startup runs, so the engine reads them from memory
+// instead of waiting on the SD card file by file. One thread per file asks for the whole file with posix_fadvise and
+// readahead; the files' reads go to the card together rather than one after the other. It only warms the cache: a
+// file that can't be opened is left for the engine to report.
+
+#define MODEL_PREFETCH_MAX_FILES 12
+
+typedef struct {
+    int files;
+    long long bytes;
+    // from modelPrefetch_start until the last file's readahead returned
+    long long elapsedUs;
+} modelPrefetch_stats;
+
+// Starts a thread for each path; NULL paths and repeats are skipped. Call once, as soon as the paths are known.
+void modelPrefetch_start(const char* const* paths, int count);
+
+// Waits for the threads.
+void modelPrefetch_join(modelPrefetch_stats* stats);
+
+#endif
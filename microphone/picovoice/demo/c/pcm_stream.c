@@ -0,0 +1,194 @@
+#ifndef _POSIX_C_SOURCE
+// getaddrinfo under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pcm_stream.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MAX_HOST_LENGTH 256
+
+// Splits "HOST:PORT" or ":PORT"; host comes back empty for the latter. The last colon counts, so "[::1]:9000" works.
+static bool splitAddress(const char* address, char* host, size_t hostSize, const char** port)
+{
+    const char* colon = strrchr(address, ':');
+    if (!colon || colon[1] == '\0') {
+        return false;
+    }
+    size_t length = (size_t) (colon - address);
+    if (length >= 2 && address[0] == '[' && address[length - 1] == ']') {
+        address++;
+        length -= 2;
+    }
+    if (length >= hostSize) {
+        return false;
+    }
+    memcpy(host, address, length);
+    host[length] = '\0';
+    *port = colon + 1;
+    return true;
+}
+
+static int openSocket(const char* address, bool isDatagram)
+{
+    char host[MAX_HOST_LENGTH];
+    const char* port = NULL;
+    if (!splitAddress(address, host, sizeof(host), &port)) {
+        printf("PCM stream: '%s' should be HOST:PORT or :PORT.\n", address);
+        return -1;
+    }
+    const bool isListening = isDatagram || host[0] == '\0';
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = isDatagram ? SOCK_DGRAM : SOCK_STREAM;
+    hints.ai_flags = isListening ? AI_PASSIVE : 0;
+    struct addrinfo* addresses = NULL;
+    const int error = getaddrinfo(host[0] != '\0' ? host : NULL, port, &hints, &addresses);
+    if (error != 0) {
+        printf("PCM stream: Unable to resolve '%s': %s.\n", address, gai_strerror(error));
+        return -1;
+    }
+
+    int fd = -1;
+    for (const struct addrinfo* entry = addresses; entry && fd < 0; entry = entry->ai_next) {
+        fd = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (isListening) {
+            const int reuse = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        const bool isOk = isListening ? bind(fd, entry->ai_addr, entry->ai_addrlen) == 0 :
+                connect(fd, entry->ai_addr, entry->ai_addrlen) == 0;
+        if (!isOk) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        perror("PCM stream: Unable to open socket.");
+        return -1;
+    }
+    if (isDatagram || !isListening) {
+        return fd;
+    }
+
+    // one sender per run, so the listener goes once it has arrived
+    if (listen(fd, 1) != 0) {
+        perror("PCM stream: Unable to listen.");
+        close(fd);
+        return -1;
+    }
+    fprintf(stderr, "waiting for a connection on port %s.\n", port);
+    int clientFd;
+    while ((clientFd = accept(fd, NULL, NULL)) < 0 && errno == EINTR) {
+    }
+    if (clientFd < 0) {
+        perror("PCM stream: Unable to accept.");
+    }
+    close(fd);
+    return clientFd;
+}
+
+// Appends at most one read's worth to the buffer. Returns false at the end of the stream or on an error.
+static bool fill(pcmStream* stream)
+{
+    // what's left is less than a frame, so moving it down is cheap and leaves room for a whole datagram
+    if (stream->begin > 0) {
+        memmove(stream->buffer, stream->buffer + stream->begin, stream->end - stream->begin);
+        stream->end -= stream->begin;
+        stream->begin = 0;
+    }
+    while (true) {
+        const ssize_t count = read(stream->fd, stream->buffer + stream->end, sizeof(stream->buffer) - stream->end);
+        if (count > 0) {
+            stream->end += (size_t) count;
+            return true;
+        }
+        if (count == 0) {
+            return false;
+        }
+        if (errno != EINTR) {
+            perror("PCM stream: Unable to read.");
+            return false;
+        }
+    }
+}
+
+#endif
+
+bool pcmStream_open(const char* spec, pcmStream* stream)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->fd = -1;
+#if defined(_WIN32) || defined(_WIN64)
+    printf("PCM stream: '%s' can't be opened, streams aren't supported on Windows.\n", spec);
+    return false;
+#else
+    if (strcmp(spec, "-") == 0) {
+        stream->fd = STDIN_FILENO;
+    } else if (strncmp(spec, "tcp://", 6) == 0) {
+        stream->fd = openSocket(spec + 6, false);
+    } else if (strncmp(spec, "udp://", 6) == 0) {
+        stream->isDatagram = true;
+        stream->fd = openSocket(spec + 6, true);
+    } else {
+        // a FIFO's open waits for its writer
+        stream->fd = open(spec, O_RDONLY);
+        if (stream->fd < 0) {
+            perror("PCM stream: Unable to open.");
+        }
+    }
+    return stream->fd >= 0;
+#endif
+}
+
+bool pcmStream_read(pcmStream* stream, int16_t* frame, int32_t frameLength)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    (void) stream;
+    (void) frame;
+    (void) frameLength;
+    return false;
+#else
+    const size_t frameBytes = (size_t) frameLength * sizeof(int16_t);
+    if (frameBytes > PCM_STREAM_MAX_FRAME_BYTES) {
+        return false;
+    }
+    while (stream->end - stream->begin < frameBytes) {
+        if (!fill(stream)) {
+            return false;
+        }
+    }
+    // little-endian on the wire, whatever the host
+    const uint8_t* bytes = stream->buffer + stream->begin;
+    for (int32_t i = 0; i < frameLength; i++) {
+        frame[i] = (int16_t) (bytes[2 * i] | (bytes[2 * i + 1] << 8));
+    }
+    stream->begin += frameBytes;
+    return true;
+#endif
+}
+
+void pcmStream_close(pcmStream* stream)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (stream->fd > STDIN_FILENO) {
+        close(stream->fd);
+    }
+#endif
+    stream->fd = -1;
+}
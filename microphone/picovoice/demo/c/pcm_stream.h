@@ -0,0 +1,34 @@
+#ifndef PCM_STREAM_H
+#define PCM_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Raw 16-bit little-endian mono PCM from stdin, a FIFO or a socket, cut into fixed-size frames. Reads land in a
+// buffer that lives in the stream itself, so assembling a frame never allocates, however the bytes arrive.
+
+// Room for the largest UDP datagram on top of what's left of a frame.
+#define PCM_STREAM_BUFFER_SIZE (65536 + 8192)
+#define PCM_STREAM_MAX_FRAME_BYTES 8192
+
+typedef struct {
+    int fd;
+    bool isDatagram;
+    uint8_t buffer[PCM_STREAM_BUFFER_SIZE];
+    size_t begin;
+    size_t end;
+} pcmStream;
+
+// spec is "-" for stdin, "tcp://HOST:PORT" to connect, "tcp://:PORT" to listen for one connection,
+// "udp://[HOST]:PORT" to bind and take datagrams, or a path, e.g. to a FIFO. Prints what went wrong and returns false
+// if it can't be opened.
+bool pcmStream_open(const char* spec, pcmStream* stream);
+
+// Fills frame with the next frameLength samples. Returns false at the end of the stream, which for UDP is an empty
+// datagram; a partial frame at the end is dropped.
+bool pcmStream_read(pcmStream* stream, int16_t* frame, int32_t frameLength);
+
+void pcmStream_close(pcmStream* stream);
+
+#endif
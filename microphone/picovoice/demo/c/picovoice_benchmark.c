@@ -0,0 +1,340 @@
+#ifndef _POSIX_C_SOURCE
+// clock_gettime and CLOCK_MONOTONIC under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "audio_decoder.h"
+#include "pv_engine.h"
+#include "wav_map.h"
+
+// Replays a fixed corpus through pv_picovoice_process and prints one JSON object: per-frame latency percentiles, real
+// time factor, CPU time and peak RSS. Every clip is in memory before the clock starts, so only the engine is timed.
+
+typedef struct {
+    const char *path;
+    const int16_t *samples;
+    int64_t sample_count;
+    int16_t *decoded;
+    wavMap map;
+} clip_t;
+
+// resolved once, shared by the callbacks and the replay loop
+static pvEngine engine;
+
+static int64_t wake_word_count = 0;
+static int64_t inference_count = 0;
+
+static void wake_word_callback(void) {
+    wake_word_count++;
+}
+
+static void inference_callback(pv_inference_t *inference) {
+    inference_count++;
+    engine.inferenceDelete(inference);
+}
+
+static struct option long_options[] = {
+        {"library_path",          required_argument, NULL, 'l'},
+        {"access_key",            required_argument, NULL, 'a'},
+        {"keyword_path",          required_argument, NULL, 'k'},
+        {"context_path",          required_argument, NULL, 'c'},
+        {"porcupine_sensitivity", required_argument, NULL, 's'},
+        {"porcupine_model_path",  required_argument, NULL, 'p'},
+        {"rhino_sensitivity",     required_argument, NULL, 't'},
+        {"rhino_model_path",      required_argument, NULL, 'r'},
+        {"endpoint_duration_sec", required_argument, NULL, 'u'},
+        {"require_endpoint",      required_argument, NULL, 'e'},
+        {"repeat",                required_argument, NULL, 'n'},
+        {"warmup",                required_argument, NULL, 'W'},
+};
+
+void print_usage(const char *program_name) {
+    fprintf(stderr,
+            "Usage : %s -l LIBRARY_PATH -a ACCESS_KEY -k KEYWORD_PATH -c CONTEXT_PATH -p PPN_MODEL_PATH -r RHN_MODEL_PATH "
+            "[--porcupine_sensitivity PPN_SENSITIVITY --rhino_sensitivity RHN_SENSITIVITY --endpoint_duration_sec --require_endpoint \"true\"|\"false\" "
+            "--repeat N --warmup N] WAV_PATH [WAV_PATH ...]\n",
+            program_name);
+}
+
+static bool load_clip(const char *wav_path, clip_t *clip) {
+    clip->path = wav_path;
+    if (wavMap_open(wav_path, engine.sampleRate, &clip->map)) {
+        // touch every page now, so the first pass isn't timing page faults
+        volatile int16_t sink = 0;
+        for (int64_t i = 0; i < clip->map.sampleCount; i += 2048) {
+            sink ^= clip->map.samples[i];
+        }
+        (void) sink;
+        clip->samples = clip->map.samples;
+        clip->sample_count = clip->map.sampleCount;
+        return true;
+    }
+    audioDecoder *decoder = NULL;
+    const char *error = audioDecoder_open(wav_path, engine.sampleRate, &decoder);
+    if (error) {
+        fprintf(stderr, "%s at '%s'.\n", error, wav_path);
+        return false;
+    }
+    // decoded up front, so the replay never waits on a decoder or resampler
+    int64_t capacity = 0;
+    while (true) {
+        if (clip->sample_count == capacity) {
+            capacity = capacity ? 2 * capacity : 16 * engine.sampleRate;
+            int16_t *decoded = realloc(clip->decoded, (size_t) capacity * sizeof(int16_t));
+            if (!decoded) {
+                fprintf(stderr, "failed to allocate memory for '%s'.\n", wav_path);
+                exit(1);
+            }
+            clip->decoded = decoded;
+        }
+        const int64_t room = capacity - clip->sample_count;
+        const int32_t wanted = (room < INT32_MAX) ? (int32_t) room : INT32_MAX;
+        const int32_t read = audioDecoder_read(decoder, clip->decoded + clip->sample_count, wanted);
+        clip->sample_count += read;
+        if (read < wanted) {
+            break;
+        }
+    }
+    audioDecoder_close(decoder);
+    clip->samples = clip->decoded;
+    return true;
+}
+
+static void free_clip(clip_t *clip) {
+    if (clip->decoded) {
+        free(clip->decoded);
+    } else {
+        wavMap_close(&clip->map);
+    }
+}
+
+static int64_t frame_count(const clip_t *clip) {
+    return clip->sample_count / engine.frameLength;
+}
+
+static double now_usec(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (double) now.tv_sec * 1e6 + (double) now.tv_nsec / 1e3;
+}
+
+static double timeval_sec(const struct timeval *value) {
+    return (double) value->tv_sec + (double) value->tv_usec / 1e6;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    const double x = *(const double *) a;
+    const double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank, over values already sorted
+static double percentile(const double *sorted, int64_t count, double fraction) {
+    int64_t rank = (int64_t) (fraction * (double) count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > count ? count : rank) - 1];
+}
+
+// Runs every whole frame of every clip once, in corpus order; latencies may be NULL for a warm-up pass.
+static void replay(pv_picovoice_t *handle, const clip_t *clips, int32_t clip_count, double *latencies) {
+    for (int32_t i = 0; i < clip_count; i++) {
+        const int64_t frames = frame_count(&clips[i]);
+        for (int64_t j = 0; j < frames; j++) {
+            const double before = now_usec(CLOCK_MONOTONIC);
+            const pv_status_t status = engine.process(handle, &clips[i].samples[j * engine.frameLength]);
+            const double after = now_usec(CLOCK_MONOTONIC);
+            if (status != PV_STATUS_SUCCESS) {
+                fprintf(stderr, "'pv_picovoice_process' failed with '%s'\n", engine.statusToString(status));
+                exit(1);
+            }
+            if (latencies) {
+                *latencies++ = after - before;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    const char *library_path = NULL;
+    const char *access_key = NULL;
+    const char *keyword_path = NULL;
+    const char *context_path = NULL;
+    float porcupine_sensitivity = 0.5f;
+    const char *porcupine_model_path = NULL;
+    float rhino_sensitivity = 0.5f;
+    const char *rhino_model_path = NULL;
+    float endpoint_duration_sec = 1.f;
+    bool require_endpoint = true;
+    int32_t repeat = 1;
+    int32_t warmup = 0;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "e:l:a:k:c:s:p:t:r:u:n:W:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'l':
+                library_path = optarg;
+                break;
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'k':
+                keyword_path = optarg;
+                break;
+            case 'c':
+                context_path = optarg;
+                break;
+            case 's':
+                porcupine_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'p':
+                porcupine_model_path = optarg;
+                break;
+            case 't':
+                rhino_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'r':
+                rhino_model_path = optarg;
+                break;
+            case 'u':
+                endpoint_duration_sec = strtof(optarg, NULL);
+                break;
+            case 'e':
+                if (strcmp(optarg, "false") == 0) {
+                    require_endpoint = false;
+                }
+                break;
+            case 'n':
+                repeat = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'W':
+                warmup = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+
+    if (!library_path || !keyword_path || !context_path || !access_key || !porcupine_model_path || !rhino_model_path || (optind == argc) || (repeat < 1) || (warmup < 0)) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    if (!pvEngine_load(library_path, &engine)) {
+        exit(1);
+    }
+
+    const int32_t clip_count = argc - optind;
+    clip_t *clips = calloc((size_t) clip_count, sizeof(clip_t));
+    if (!clips) {
+        fprintf(stderr, "failed to allocate memory for the corpus.\n");
+        exit(1);
+    }
+    int64_t corpus_frames = 0;
+    for (int32_t i = 0; i < clip_count; i++) {
+        if (!load_clip(argv[optind + i], &clips[i])) {
+            exit(1);
+        }
+        corpus_frames += frame_count(&clips[i]);
+    }
+    if (corpus_frames == 0) {
+        fprintf(stderr, "the corpus is shorter than one frame.\n");
+        exit(1);
+    }
+
+    const int64_t timed_frames = corpus_frames * repeat;
+    double *latencies = malloc((size_t) timed_frames * sizeof(double));
+    if (!latencies) {
+        fprintf(stderr, "failed to allocate memory for %lld frame latencies.\n", (long long) timed_frames);
+        exit(1);
+    }
+
+    const double init_start = now_usec(CLOCK_MONOTONIC);
+    pv_picovoice_t *handle = NULL;
+    const pv_status_t status = engine.init(
+            access_key,
+            porcupine_model_path,
+            keyword_path,
+            porcupine_sensitivity,
+            wake_word_callback,
+            rhino_model_path,
+            context_path,
+            rhino_sensitivity,
+            endpoint_duration_sec,
+            require_endpoint,
+            inference_callback,
+            &handle);
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", engine.statusToString(status));
+        exit(1);
+    }
+    const double init_usec = now_usec(CLOCK_MONOTONIC) - init_start;
+
+    for (int32_t i = 0; i < warmup; i++) {
+        replay(handle, clips, clip_count, NULL);
+    }
+    wake_word_count = 0;
+    inference_count = 0;
+
+    struct rusage usage_before;
+    getrusage(RUSAGE_SELF, &usage_before);
+    const double wall_start = now_usec(CLOCK_MONOTONIC);
+    for (int32_t i = 0; i < repeat; i++) {
+        replay(handle, clips, clip_count, &latencies[corpus_frames * i]);
+    }
+    const double wall_usec = now_usec(CLOCK_MONOTONIC) - wall_start;
+    struct rusage usage_after;
+    getrusage(RUSAGE_SELF, &usage_after);
+
+    double process_usec = 0;
+    for (int64_t i = 0; i < timed_frames; i++) {
+        process_usec += latencies[i];
+    }
+    qsort(latencies, (size_t) timed_frames, sizeof(double), compare_doubles);
+
+    const double audio_sec = ((double) timed_frames * engine.frameLength) / engine.sampleRate;
+    const double user_sec = timeval_sec(&usage_after.ru_utime) - timeval_sec(&usage_before.ru_utime);
+    const double system_sec = timeval_sec(&usage_after.ru_stime) - timeval_sec(&usage_before.ru_stime);
+#if defined(__APPLE__)
+    // bytes there, kilobytes elsewhere
+    const long peak_rss_kb = usage_after.ru_maxrss / 1024;
+#else
+    const long peak_rss_kb = usage_after.ru_maxrss;
+#endif
+
+    fprintf(stdout, "{\"version\":\"%s\",\"sample_rate\":%d,\"frame_length\":%d,", engine.version,
+            engine.sampleRate, engine.frameLength);
+    fprintf(stdout, "\"files\":%d,\"repeat\":%d,\"warmup\":%d,\"frames\":%lld,\"audio_sec\":%.3f,", clip_count,
+            repeat, warmup, (long long) timed_frames, audio_sec);
+    fprintf(stdout, "\"init_ms\":%.3f,\"wall_sec\":%.6f,\"real_time_factor\":%.6f,", init_usec / 1e3,
+            wall_usec / 1e6, (process_usec / 1e6) / audio_sec);
+    fprintf(stdout, "\"frame_usec\":{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,"
+                    "\"max\":%.3f},", process_usec / (double) timed_frames,
+            percentile(latencies, timed_frames, 0.5), percentile(latencies, timed_frames, 0.9),
+            percentile(latencies, timed_frames, 0.99), percentile(latencies, timed_frames, 0.999),
+            latencies[timed_frames - 1]);
+    fprintf(stdout, "\"cpu_user_sec\":%.6f,\"cpu_system_sec\":%.6f,\"cpu_per_audio_sec\":%.6f,", user_sec,
+            system_sec, (user_sec + system_sec) / audio_sec);
+    fprintf(stdout, "\"peak_rss_kb\":%ld,\"wake_words\":%lld,\"inferences\":%lld}\n", peak_rss_kb,
+            (long long) wake_word_count, (long long) inference_count);
+
+    free(latencies);
+    engine.destroy(handle);
+    for (int32_t i = 0; i < clip_count; i++) {
+        free_clip(&clips[i]);
+    }
+    free(clips);
+    pvEngine_unload(&engine);
+
+    return 0;
+}
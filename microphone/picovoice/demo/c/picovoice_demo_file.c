@@ -9,91 +9,190 @@
     specific language governing permissions and limitations under the License.
 */
 
+#include <dirent.h>
 #include <getopt.h>
+#include <pthread.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <time.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 
 #include <windows.h>
 
-#else
-
-#include <dlfcn.h>
-
-#endif
-
-#define DR_WAV_IMPLEMENTATION
-
-#include "dr_wav.h"
-
-#include "pv_picovoice.h"
-
-static void *open_dl(const char *dl_path) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    return LoadLibrary(dl_path);
-
-#else
-
-    return dlopen(dl_path, RTLD_NOW);
-
 #endif
 
+#include "audio_decoder.h"
+#include "clip_pack.h"
+#include "pcm_stream.h"
+#include "pv_engine.h"
+#include "wav_map.h"
+
+// A growing string, for the JSON line of a file in batch mode.
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} text_buffer_t;
+
+static void text_append(text_buffer_t *text, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    const size_t room = text->capacity - text->length;
+    const int written = vsnprintf(room > 0 ? text->data + text->length : NULL, room, format, args);
+    va_end(args);
+    if (written < 0) {
+        va_end(retry);
+        return;
+    }
+    if ((size_t) written >= room) {
+        size_t capacity = text->capacity > 0 ? text->capacity : 256;
+        while (capacity - text->length <= (size_t) written) {
+            capacity *= 2;
+        }
+        char *data = realloc(text->data, capacity);
+        if (!data) {
+            fprintf(stderr, "failed to allocate memory for results.\n");
+            exit(1);
+        }
+        text->data = data;
+        text->capacity = capacity;
+        vsnprintf(text->data + text->length, text->capacity - text->length, format, retry);
+    }
+    va_end(retry);
+    text->length += (size_t) written;
 }
 
-static void *load_symbol(void *handle, const char *symbol) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    return GetProcAddress((HMODULE) handle, symbol);
-
-#else
-
-    return dlsym(handle, symbol);
-
-#endif
-
+static void text_append_json_string(text_buffer_t *text, const char *value) {
+    text_append(text, "\"");
+    for (const unsigned char *c = (const unsigned char *) value; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            text_append(text, "\\%c", *c);
+        } else if (*c < 0x20) {
+            text_append(text, "\\u%04x", *c);
+        } else {
+            text_append(text, "%c", *c);
+        }
+    }
+    text_append(text, "\"");
 }
 
-static void close_dl(void *handle) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    FreeLibrary((HMODULE) handle);
-
-#else
-
-    dlclose(handle);
-
-#endif
-
+static void text_clear(text_buffer_t *text) {
+    text->length = 0;
+    if (text->data) {
+        text->data[0] = '\0';
+    }
 }
 
-static void print_dl_error(const char *message) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    fprintf(stderr, "%s with code '%lu'.\n", message, GetLastError());
-
-#else
-
-    fprintf(stderr, "%s with '%s'.\n", message, dlerror());
-
-#endif
+// What the file being evaluated in batch mode has produced so far.
+typedef struct {
+    int32_t frame_index;
+    int wake_word_count;
+    int inference_count;
+    // a wake word whose command hasn't been inferred yet
+    bool is_awaiting_inference;
+    // the first command that was understood, for the sweep
+    bool is_understood;
+    char intent[64];
+    text_buffer_t wake_words;
+    text_buffer_t inferences;
+    // for the soak test: understood commands, and wake words and understood commands per hour of audio, in pairs
+    int understood_count;
+    int32_t *hourly;
+    int32_t hour_count;
+} file_result_t;
+
+// Soak test: every file is background noise, so each wake word and understood command is a false alarm.
+static bool is_soak_test = false;
+
+#define SECONDS_PER_HOUR 3600.0
+
+// The file the calling thread is evaluating in batch mode; NULL outside it, where the callbacks print as they go. Each
+// batch worker has its own instance, and an instance calls back on the thread that processes its frames.
+static __thread file_result_t *batch_result = NULL;
+
+// resolved once, shared by the callbacks and the audio loop
+static pvEngine engine;
+
+static double frame_seconds(int32_t frame_index) {
+    return ((double) frame_index * engine.frameLength) / engine.sampleRate;
+}
 
+// The frame being processed outside batch mode: the audio clock the callbacks print, however fast the replay runs.
+static int32_t replay_frame_index = 0;
+
+// is_intent picks the count: the hour's understood commands, or its wake words.
+static void count_hourly(file_result_t *result, bool is_intent) {
+    const int32_t hour = (int32_t) (frame_seconds(result->frame_index) / SECONDS_PER_HOUR);
+    if (hour >= result->hour_count) {
+        // once an hour of audio at most
+        int32_t *grown = realloc(result->hourly, (size_t) (hour + 1) * 2 * sizeof(int32_t));
+        if (!grown) {
+            fprintf(stderr, "failed to allocate memory for hourly counts.\n");
+            exit(1);
+        }
+        memset(grown + 2 * result->hour_count, 0, (size_t) (hour + 1 - result->hour_count) * 2 * sizeof(int32_t));
+        result->hourly = grown;
+        result->hour_count = hour + 1;
+    }
+    result->hourly[2 * hour + (is_intent ? 1 : 0)]++;
 }
 
 static void wake_word_callback(void) {
-    fprintf(stdout, "[wake word]\n");
+    if (batch_result) {
+        count_hourly(batch_result, false);
+        text_append(&batch_result->wake_words, "%s%.3f", batch_result->wake_word_count > 0 ? "," : "",
+                frame_seconds(batch_result->frame_index));
+        batch_result->wake_word_count++;
+        batch_result->is_awaiting_inference = true;
+        return;
+    }
+    fprintf(stdout, "[wake word] %.3f sec\n", frame_seconds(replay_frame_index));
 }
 
-static void (*pv_inference_delete_func)(pv_inference_t *) = NULL;
+static void record_inference(file_result_t *result, const pv_inference_t *inference) {
+    text_buffer_t *text = &result->inferences;
+    text_append(text, "%s{\"time_sec\":%.3f,\"is_understood\":%s", result->inference_count > 0 ? "," : "",
+            frame_seconds(result->frame_index), inference->is_understood ? "true" : "false");
+    if (inference->is_understood) {
+        text_append(text, ",\"intent\":");
+        text_append_json_string(text, inference->intent);
+        text_append(text, ",\"slots\":{");
+        for (int32_t i = 0; i < inference->num_slots; i++) {
+            text_append(text, i > 0 ? "," : "");
+            text_append_json_string(text, inference->slots[i]);
+            text_append(text, ":");
+            text_append_json_string(text, inference->values[i]);
+        }
+        text_append(text, "}");
+    }
+    text_append(text, "}");
+    if (inference->is_understood) {
+        count_hourly(result, true);
+        result->understood_count++;
+    }
+    if (inference->is_understood && !result->is_understood) {
+        result->is_understood = true;
+        snprintf(result->intent, sizeof(result->intent), "%s", inference->intent);
+    }
+    result->inference_count++;
+    result->is_awaiting_inference = false;
+}
 
 static void inference_callback(pv_inference_t *inference) {
+    if (batch_result) {
+        record_inference(batch_result, inference);
+        engine.inferenceDelete(inference);
+        return;
+    }
     fprintf(stdout, "{\n");
+    fprintf(stdout, "    time_sec : %.3f,\n", frame_seconds(replay_frame_index));
     fprintf(stdout, "    is_understood : '%s',\n", (inference->is_understood ? "true" : "false"));
     if (inference->is_understood) {
         fprintf(stdout, "    intent : '%s',\n", inference->intent);
@@ -107,12 +206,20 @@ static void inference_callback(pv_inference_t *inference) {
     }
     fprintf(stdout, "}\n\n");
 
-    pv_inference_delete_func(inference);
+    engine.inferenceDelete(inference);
 }
 
 static struct option long_options[] = {
         {"library_path",          required_argument, NULL, 'l'},
         {"wav_path",              required_argument, NULL, 'w'},
+        {"input_stream",          required_argument, NULL, 'i'},
+        {"pack",                  required_argument, NULL, 'P'},
+        {"soak",                  no_argument,       NULL, 'N'},
+        {"speed",                 required_argument, NULL, 'x'},
+        {"batch_path",            required_argument, NULL, 'b'},
+        {"jobs",                  required_argument, NULL, 'j'},
+        {"porcupine_sensitivities", required_argument, NULL, 'S'},
+        {"rhino_sensitivities",   required_argument, NULL, 'T'},
         {"access_key",            required_argument, NULL, 'a'},
         {"keyword_path",          required_argument, NULL, 'k'},
         {"context_path",          required_argument, NULL, 'c'},
@@ -126,15 +233,907 @@ static struct option long_options[] = {
 
 void print_usage(const char *program_name) {
     fprintf(stderr,
-            "Usage : %s -l LIBRARY_PATH -a ACCESS_KEY -w WAV_PATH -k KEYWORD_PATH -c CONTEXT_PATH -p PPN_MODEL_PATH -r RHN_MODEL_PATH "
+            "Usage : %s -l LIBRARY_PATH -a ACCESS_KEY -w WAV_PATH|-i -|FIFO_PATH|tcp://[HOST]:PORT|udp://[HOST]:PORT|-b WAV_DIRECTORY|MANIFEST|PACK [--speed N --pack PACK_PATH --soak] [-j JOBS --porcupine_sensitivities S1,S2,... --rhino_sensitivities T1,T2,...] -k KEYWORD_PATH -c CONTEXT_PATH -p PPN_MODEL_PATH -r RHN_MODEL_PATH "
             "[--porcupine_sensitivity PPN_SENSITIVITY --rhino_sensitivity RHN_SENSITIVITY --endpoint_duration_sec --require_endpoint \"true\"|\"false\" ]\n",
             program_name);
 }
 
+// What pv_picovoice_init is given, kept so batch mode can start a file over with a fresh instance.
+typedef struct {
+    const char *access_key;
+    const char *porcupine_model_path;
+    const char *keyword_path;
+    float porcupine_sensitivity;
+    const char *rhino_model_path;
+    const char *context_path;
+    float rhino_sensitivity;
+    float endpoint_duration_sec;
+    bool require_endpoint;
+} picovoice_params_t;
+
+static picovoice_params_t picovoice_params;
+
+typedef struct {
+    float porcupine;
+    float rhino;
+} sensitivities_t;
+
+static pv_status_t create_handle_with(const sensitivities_t *sensitivities, pv_picovoice_t **handle) {
+    return engine.init(
+            picovoice_params.access_key,
+            picovoice_params.porcupine_model_path,
+            picovoice_params.keyword_path,
+            sensitivities->porcupine,
+            wake_word_callback,
+            picovoice_params.rhino_model_path,
+            picovoice_params.context_path,
+            sensitivities->rhino,
+            picovoice_params.endpoint_duration_sec,
+            picovoice_params.require_endpoint,
+            inference_callback,
+            handle);
+}
+
+static pv_status_t create_handle(pv_picovoice_t **handle) {
+    const sensitivities_t sensitivities = {picovoice_params.porcupine_sensitivity, picovoice_params.rhino_sensitivity};
+    return create_handle_with(&sensitivities, handle);
+}
+
+static double elapsed_usec(const struct timeval *before, const struct timeval *after) {
+    return (double) (after->tv_sec - before->tv_sec) * 1e6 + (double) (after->tv_usec - before->tv_usec);
+}
+
+static double monotonic_usec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec * 1e6 + (double) now.tv_nsec / 1e3;
+}
+
+// Holds frame_index back until speed times real time has passed since start_usec would put it on air. Sleeping to a
+// deadline from the start, rather than a frame's length each time, keeps processing time from adding up as drift.
+static void throttle(double start_usec, int32_t frame_index, float speed) {
+    const double due_usec = start_usec + (frame_index * (double) engine.frameLength * 1e6) / (engine.sampleRate * speed);
+    const double wait_usec = due_usec - monotonic_usec();
+    if (wait_usec > 0) {
+        const long long wait_nsec = (long long) (wait_usec * 1e3);
+        const struct timespec wait = {(time_t) (wait_nsec / 1000000000LL), (long) (wait_nsec % 1000000000LL)};
+        nanosleep(&wait, NULL);
+    }
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+static bool has_extension(const char *name, const char *extension) {
+    const size_t length = strlen(name);
+    const size_t extension_length = strlen(extension);
+    if (length <= extension_length || name[length - extension_length - 1] != '.') {
+        return false;
+    }
+    for (size_t i = 0; i < extension_length; i++) {
+        if ((name[length - extension_length + i] | 0x20) != extension[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool has_audio_extension(const char *name) {
+    return has_extension(name, "wav") || has_extension(name, "flac") || has_extension(name, "mp3");
+}
+
+// A corpus: paths, and for a manifest the label after each path, NULL if there is none.
+typedef struct {
+    char **paths;
+    char **labels;
+    int32_t count;
+    int32_t capacity;
+} file_list_t;
+
+static char *copy_text(const char *text) {
+    char *copy = strdup(text);
+    if (!copy) {
+        fprintf(stderr, "failed to allocate memory for the file list.\n");
+        exit(1);
+    }
+    return copy;
+}
+
+static void add_path(file_list_t *list, const char *directory, const char *name, const char *label) {
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity > 0) ? list->capacity * 2 : 64;
+        char **grown_paths = realloc(list->paths, (size_t) list->capacity * sizeof(char *));
+        if (grown_paths) {
+            list->paths = grown_paths;
+        }
+        char **grown_labels = realloc(list->labels, (size_t) list->capacity * sizeof(char *));
+        if (grown_labels) {
+            list->labels = grown_labels;
+        }
+        if (!grown_paths || !grown_labels) {
+            fprintf(stderr, "failed to allocate memory for the file list.\n");
+            exit(1);
+        }
+    }
+    const size_t length = (directory ? strlen(directory) + 1 : 0) + strlen(name) + 1;
+    char *path = malloc(length);
+    if (!path) {
+        fprintf(stderr, "failed to allocate memory for the file list.\n");
+        exit(1);
+    }
+    if (directory) {
+        snprintf(path, length, "%s/%s", directory, name);
+    } else {
+        snprintf(path, length, "%s", name);
+    }
+    list->paths[list->count] = path;
+    list->labels[list->count] = label ? copy_text(label) : NULL;
+    list->count++;
+}
+
+static void free_file_list(file_list_t *list) {
+    for (int32_t i = 0; i < list->count; i++) {
+        free(list->paths[i]);
+        free(list->labels[i]);
+    }
+    free(list->paths);
+    free(list->labels);
+}
+
+// A directory gives its .wav, .flac and .mp3 files in name order, and one such file gives itself; anything else is read as a manifest of one path per line, in order,
+// with blank lines and lines starting with '#' skipped. A manifest path may be followed by a tab and a label: the
+// intent the clip should be understood as, or "none" for a clip with no wake word in it.
+static file_list_t collect_wav_paths(const char *batch_path) {
+    file_list_t list = {NULL, NULL, 0, 0};
+
+    struct stat info;
+    if (stat(batch_path, &info) != 0) {
+        fprintf(stderr, "failed to open '%s'.\n", batch_path);
+        exit(1);
+    }
+    if (S_ISDIR(info.st_mode)) {
+        DIR *directory = opendir(batch_path);
+        if (!directory) {
+            fprintf(stderr, "failed to open directory '%s'.\n", batch_path);
+            exit(1);
+        }
+        struct dirent *entry;
+        while ((entry = readdir(directory)) != NULL) {
+            if (has_audio_extension(entry->d_name)) {
+                add_path(&list, batch_path, entry->d_name, NULL);
+            }
+        }
+        closedir(directory);
+        if (list.count > 0) {
+            // no labels to keep in step
+            qsort(list.paths, (size_t) list.count, sizeof(char *), compare_paths);
+        }
+        return list;
+    }
+
+    // one recording on its own, e.g. a long soak test
+    if (has_audio_extension(batch_path)) {
+        add_path(&list, NULL, batch_path, NULL);
+        return list;
+    }
+
+    FILE *manifest = fopen(batch_path, "r");
+    if (!manifest) {
+        fprintf(stderr, "failed to open manifest '%s'.\n", batch_path);
+        exit(1);
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), manifest)) {
+        size_t length = strcspn(line, "\r\n");
+        line[length] = '\0';
+        if (length > 0 && line[0] != '#') {
+            char *label = strchr(line, '\t');
+            if (label) {
+                *label++ = '\0';
+            }
+            add_path(&list, NULL, line, (label && *label) ? label : NULL);
+        }
+    }
+    fclose(manifest);
+    return list;
+}
+
+// A pack given to -b stands in for the corpus it was made from, its paths and labels making the file list. Returns
+// whether batch_path was a pack; pack is left closed if it wasn't.
+static bool open_corpus(const char *batch_path, clipPack *pack, file_list_t *files) {
+    memset(pack, 0, sizeof(*pack));
+    if (!clipPack_isPack(batch_path)) {
+        *files = collect_wav_paths(batch_path);
+        return false;
+    }
+    const char *error = clipPack_open(batch_path, engine.sampleRate, pack);
+    if (error) {
+        fprintf(stderr, "%s at '%s'.\n", error, batch_path);
+        exit(1);
+    }
+    *files = (file_list_t) {NULL, NULL, 0, 0};
+    for (int32_t i = 0; i < pack->count; i++) {
+        add_path(files, NULL, clipPack_path(pack, i), clipPack_label(pack, i));
+    }
+    return true;
+}
+
+// samples decoded at a time in pack mode
+#define PACK_CHUNK_SAMPLES 65536
+
+// Where a file's frames come from: the decoder, as it goes, a raw PCM stream, or samples already in memory or mapped
+// from the file.
+typedef struct {
+    audioDecoder *decoder;
+    pcmStream *stream;
+    const int16_t *samples;
+    int64_t sample_count;
+    int64_t position;
+} frame_source_t;
+
+// The next whole frame, read into buffer or pointing straight into memory; NULL at the end.
+static const int16_t *next_frame(frame_source_t *source, int16_t *buffer) {
+    if (source->decoder) {
+        const int32_t read = audioDecoder_read(source->decoder, buffer, engine.frameLength);
+        return (read == engine.frameLength) ? buffer : NULL;
+    }
+    if (source->stream) {
+        return pcmStream_read(source->stream, buffer, engine.frameLength) ? buffer : NULL;
+    }
+    if (source->sample_count - source->position < engine.frameLength) {
+        return NULL;
+    }
+    const int16_t *frame = source->samples + source->position;
+    source->position += engine.frameLength;
+    return frame;
+}
+
+// Maps the file if its samples can be read in place, and only falls back to the decoder for files that need decoding
+// or converting. Returns NULL, or why the file can't be read.
+static const char *open_source(const char *wav_path, frame_source_t *source, wavMap *map) {
+    memset(source, 0, sizeof(*source));
+    // a soak recording runs to hours, and mapped pages would stay resident as it's read; decoding reuses one buffer
+    if (!is_soak_test && wavMap_open(wav_path, engine.sampleRate, map)) {
+        source->samples = map->samples;
+        source->sample_count = map->sampleCount;
+        return NULL;
+    }
+    return audioDecoder_open(wav_path, engine.sampleRate, &source->decoder);
+}
+
+static void close_source(frame_source_t *source, wavMap *map) {
+    if (source->decoder) {
+        audioDecoder_close(source->decoder);
+    } else if (source->stream) {
+        pcmStream_close(source->stream);
+    } else {
+        wavMap_close(map);
+    }
+}
+
+// Runs source through handle into result. Afterwards the instance hears enough silence for a pending command to end
+// and the wake word window to clear, so the next file starts fresh. Returns false if processing failed.
+static bool process_source(pv_picovoice_t *handle, frame_source_t *source, int16_t *pcm, int32_t flush_frames,
+        file_result_t *result, int32_t *audio_frames, double *cpu_time_usec) {
+    batch_result = result;
+    bool is_ok = true;
+    *audio_frames = 0;
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    const int16_t *frame;
+    while (is_ok && (frame = next_frame(source, pcm)) != NULL) {
+        is_ok = (engine.process(handle, frame) == PV_STATUS_SUCCESS);
+        result->frame_index++;
+        (*audio_frames)++;
+    }
+    memset(pcm, 0, engine.frameLength * sizeof(int16_t));
+    for (int32_t i = 0; is_ok && i < flush_frames; i++) {
+        is_ok = (engine.process(handle, pcm) == PV_STATUS_SUCCESS);
+        result->frame_index++;
+    }
+    struct timeval after;
+    gettimeofday(&after, NULL);
+    batch_result = NULL;
+    *cpu_time_usec += elapsed_usec(&before, &after);
+    return is_ok;
+}
+
+// A failed instance, or a command still open after the flush, and the next file gets a new instance. Returns false
+// if that can't be created.
+static bool restart_if_needed(pv_picovoice_t **handle, bool is_ok, const file_result_t *result,
+        const sensitivities_t *sensitivities) {
+    if (is_ok && !result->is_awaiting_inference) {
+        return true;
+    }
+    engine.destroy(*handle);
+    *handle = NULL;
+    pv_status_t status = create_handle_with(sensitivities, handle);
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", engine.statusToString(status));
+        return false;
+    }
+    return true;
+}
+
+typedef struct {
+    int64_t wake_words;
+    int64_t intents;
+} soak_totals_t;
+
+static double per_hour(int64_t count, double hours) {
+    return (hours > 0) ? count / hours : 0.0;
+}
+
+// A soak file's false alarms, and their rates for each hour of audio, quiet hours included.
+static void append_soak_stats(text_buffer_t *text, const file_result_t *result, int32_t audio_frames) {
+    const double hours = frame_seconds(audio_frames) / SECONDS_PER_HOUR;
+    text_append(text, ",\"hours\":%.4f,\"false_wake_words\":%d,\"false_intents\":%d,"
+                      "\"false_wake_words_per_hour\":%.3f,\"false_intents_per_hour\":%.3f,\"hourly\":[", hours,
+            result->wake_word_count, result->understood_count, per_hour(result->wake_word_count, hours),
+            per_hour(result->understood_count, hours));
+    int32_t hour_count = (int32_t) hours + ((hours > (int32_t) hours) ? 1 : 0);
+    hour_count = (result->hour_count > hour_count) ? result->hour_count : hour_count;
+    for (int32_t i = 0; i < hour_count; i++) {
+        const bool is_counted = i < result->hour_count;
+        text_append(text, "%s{\"hour\":%d,\"false_wake_words\":%d,\"false_intents\":%d}", i > 0 ? "," : "", i,
+                is_counted ? result->hourly[2 * i] : 0, is_counted ? result->hourly[2 * i + 1] : 0);
+    }
+    text_append(text, "]");
+}
+
+// Runs one file of a batch through *handle and writes its JSON line to text; packed, if not NULL, has its samples
+// already. Returns false if the instance can't go
+// on.
+static bool evaluate_file(pv_picovoice_t **handle, const char *wav_path, const frame_source_t *packed, int16_t *pcm,
+        int32_t flush_frames, text_buffer_t *text, double *cpu_time_usec, double *audio_time_usec,
+        soak_totals_t *soak_totals) {
+    file_result_t result;
+    memset(&result, 0, sizeof(result));
+    text_clear(text);
+    text_append(text, "{\"file\":");
+    text_append_json_string(text, wav_path);
+
+    frame_source_t source;
+    wavMap map;
+    memset(&map, 0, sizeof(map));
+    const char *error = NULL;
+    if (packed) {
+        source = *packed;
+    } else {
+        error = open_source(wav_path, &source, &map);
+    }
+    if (error) {
+        text_append(text, ",\"error\":\"%s\"}\n", error);
+        return true;
+    }
+
+    int32_t audio_frames = 0;
+    const bool is_ok = process_source(*handle, &source, pcm, flush_frames, &result, &audio_frames, cpu_time_usec);
+    close_source(&source, &map);
+    *audio_time_usec += (audio_frames * (double) engine.frameLength * 1e6) / engine.sampleRate;
+
+    text_append(text, ",\"duration_sec\":%.3f,\"wake_words\":[%s],\"inferences\":[%s]", frame_seconds(audio_frames),
+            result.wake_words.data ? result.wake_words.data : "",
+            result.inferences.data ? result.inferences.data : "");
+    if (is_soak_test) {
+        append_soak_stats(text, &result, audio_frames);
+        soak_totals->wake_words += result.wake_word_count;
+        soak_totals->intents += result.understood_count;
+    }
+    if (!is_ok) {
+        text_append(text, ",\"error\":\"'pv_picovoice_process' failed\"");
+    }
+    text_append(text, "}\n");
+    free(result.wake_words.data);
+    free(result.inferences.data);
+    free(result.hourly);
+
+    const sensitivities_t sensitivities = {picovoice_params.porcupine_sensitivity, picovoice_params.rhino_sensitivity};
+    return restart_if_needed(handle, is_ok, &result, &sensitivities);
+}
+
+// Batch mode's shared state. Each worker owns a contiguous range of the files and takes them from the front; a worker
+// whose range is empty steals from the back of another's, so a run of long clips doesn't leave the rest idle.
+typedef struct {
+    pthread_mutex_t lock;
+    int32_t begin;
+    int32_t end;
+} file_range_t;
+
+typedef struct {
+    char **paths;
+    // NULL unless -b named a pack
+    const clipPack *pack;
+    int32_t count;
+    int32_t flush_frames;
+    int32_t worker_count;
+    file_range_t *ranges;
+    // each file's JSON line, stored by index so the output is in file order however the files were shared out
+    char **lines;
+    pthread_mutex_t lock;
+    pthread_cond_t line_done;
+    int32_t running_workers;
+    double cpu_time_usec;
+    double audio_time_usec;
+    soak_totals_t soak_totals;
+} batch_t;
+
+typedef struct {
+    batch_t *batch;
+    int32_t index;
+    pthread_t thread;
+} batch_worker_t;
+
+static bool take_from(file_range_t *range, bool is_owner, int32_t *file) {
+    pthread_mutex_lock(&range->lock);
+    const bool is_taken = range->begin < range->end;
+    if (is_taken) {
+        *file = is_owner ? range->begin++ : --range->end;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return is_taken;
+}
+
+static bool next_file(batch_t *batch, int32_t worker, int32_t *file) {
+    if (take_from(&batch->ranges[worker], true, file)) {
+        return true;
+    }
+    for (int32_t i = 1; i < batch->worker_count; i++) {
+        if (take_from(&batch->ranges[(worker + i) % batch->worker_count], false, file)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// One instance per worker, created on the worker so N instances load in parallel.
+static void *run_batch_worker(void *arg) {
+    batch_worker_t *worker = arg;
+    batch_t *batch = worker->batch;
+    double cpu_time_usec = 0;
+    double audio_time_usec = 0;
+    soak_totals_t soak_totals = {0, 0};
+    text_buffer_t text = {NULL, 0, 0};
+
+    pv_picovoice_t *handle = NULL;
+    int16_t *pcm = calloc(engine.frameLength, sizeof(int16_t));
+    pv_status_t status = pcm ? create_handle(&handle) : PV_STATUS_OUT_OF_MEMORY;
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", engine.statusToString(status));
+    }
+
+    int32_t file = 0;
+    while (handle && next_file(batch, worker->index, &file)) {
+        frame_source_t packed = {NULL, NULL, NULL, 0, 0};
+        if (batch->pack) {
+            packed.samples = clipPack_samples(batch->pack, file, &packed.sample_count);
+        }
+        const bool is_ok = evaluate_file(&handle, batch->paths[file], batch->pack ? &packed : NULL, pcm,
+                batch->flush_frames, &text, &cpu_time_usec, &audio_time_usec, &soak_totals);
+        char *line = strdup(text.data);
+        if (!line) {
+            fprintf(stderr, "failed to allocate memory for results.\n");
+            exit(1);
+        }
+        pthread_mutex_lock(&batch->lock);
+        batch->lines[file] = line;
+        pthread_cond_broadcast(&batch->line_done);
+        pthread_mutex_unlock(&batch->lock);
+        if (!is_ok) {
+            break;
+        }
+    }
+
+    if (handle) {
+        engine.destroy(handle);
+    }
+    free(pcm);
+    free(text.data);
+    pthread_mutex_lock(&batch->lock);
+    batch->cpu_time_usec += cpu_time_usec;
+    batch->audio_time_usec += audio_time_usec;
+    batch->soak_totals.wake_words += soak_totals.wake_words;
+    batch->soak_totals.intents += soak_totals.intents;
+    batch->running_workers--;
+    pthread_cond_broadcast(&batch->line_done);
+    pthread_mutex_unlock(&batch->lock);
+    return NULL;
+}
+
+// One JSON line per file on stdout, in file order whatever the number of workers, and a summary on stderr.
+static int run_batch(const char *batch_path, int32_t worker_count) {
+    batch_t batch;
+    memset(&batch, 0, sizeof(batch));
+    file_list_t files;
+    clipPack pack;
+    batch.pack = open_corpus(batch_path, &pack, &files) ? &pack : NULL;
+    batch.paths = files.paths;
+    batch.count = files.count;
+    // the wake word window is about a second, and a command ends after endpoint_duration_sec of silence
+    const double flush_sec = picovoice_params.endpoint_duration_sec + 1.0;
+    batch.flush_frames = (int32_t) ((flush_sec * engine.sampleRate) / engine.frameLength) + 1;
+    if (worker_count > batch.count && batch.count > 0) {
+        worker_count = batch.count;
+    }
+    batch.worker_count = worker_count;
+    batch.ranges = calloc((size_t) worker_count, sizeof(file_range_t));
+    batch.lines = calloc((size_t) (batch.count > 0 ? batch.count : 1), sizeof(char *));
+    batch_worker_t *workers = calloc((size_t) worker_count, sizeof(batch_worker_t));
+    if (!batch.ranges || !batch.lines || !workers) {
+        fprintf(stderr, "failed to allocate memory for the batch.\n");
+        exit(1);
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.line_done, NULL);
+
+    struct timeval started;
+    gettimeofday(&started, NULL);
+    for (int32_t i = 0; i < worker_count; i++) {
+        file_range_t *range = &batch.ranges[i];
+        pthread_mutex_init(&range->lock, NULL);
+        range->begin = (int32_t) (((int64_t) batch.count * i) / worker_count);
+        range->end = (int32_t) (((int64_t) batch.count * (i + 1)) / worker_count);
+    }
+    for (int32_t i = 0; i < worker_count; i++) {
+        workers[i].batch = &batch;
+        workers[i].index = i;
+        if (pthread_create(&workers[i].thread, NULL, run_batch_worker, &workers[i]) != 0) {
+            fprintf(stderr, "failed to start batch worker %d.\n", i);
+            exit(1);
+        }
+        pthread_mutex_lock(&batch.lock);
+        batch.running_workers++;
+        pthread_mutex_unlock(&batch.lock);
+    }
+
+    // lines go out as soon as every file before them is done
+    int32_t written = 0;
+    pthread_mutex_lock(&batch.lock);
+    while (written < batch.count) {
+        if (batch.lines[written]) {
+            char *line = batch.lines[written];
+            pthread_mutex_unlock(&batch.lock);
+            fputs(line, stdout);
+            pthread_mutex_lock(&batch.lock);
+            written++;
+        } else if (batch.running_workers > 0) {
+            pthread_cond_wait(&batch.line_done, &batch.lock);
+        } else {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&batch.lock);
+    fflush(stdout);
+
+    for (int32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    struct timeval finished;
+    gettimeofday(&finished, NULL);
+    const double wall_time_usec = elapsed_usec(&started, &finished);
+
+    fprintf(stderr, "%d of %d files, %.1f s of audio, %d %s, real time factor : %.3f, %.1fx real time\n", written,
+            batch.count, batch.audio_time_usec / 1e6, worker_count, worker_count > 1 ? "workers" : "worker",
+            (batch.audio_time_usec > 0) ? batch.cpu_time_usec / batch.audio_time_usec : 0.0,
+            (wall_time_usec > 0) ? batch.audio_time_usec / wall_time_usec : 0.0);
+    if (is_soak_test) {
+        const double hours = batch.audio_time_usec / 1e6 / SECONDS_PER_HOUR;
+        fprintf(stderr, "%.2f h of noise, %lld false wake words (%.3f/h), %lld false intents (%.3f/h)\n", hours,
+                (long long) batch.soak_totals.wake_words, per_hour(batch.soak_totals.wake_words, hours),
+                (long long) batch.soak_totals.intents, per_hour(batch.soak_totals.intents, hours));
+    }
+
+    for (int32_t i = 0; i < worker_count; i++) {
+        pthread_mutex_destroy(&batch.ranges[i].lock);
+    }
+    pthread_cond_destroy(&batch.line_done);
+    pthread_mutex_destroy(&batch.lock);
+    for (int32_t i = 0; i < batch.count; i++) {
+        free(batch.lines[i]);
+    }
+    free(batch.lines);
+    free_file_list(&files);
+    clipPack_close(&pack);
+    free(batch.ranges);
+    free(workers);
+    return (written == batch.count) ? 0 : 1;
+}
+
+// Sweep mode: the corpus is decoded into memory once, and every point of the sensitivity grid replays it through an
+// instance of its own, the points shared out over the workers.
+#define MAX_SWEEP_VALUES 32
+
+// A clip's samples are the file's own, mapped, when they can be; otherwise decoded into memory.
+typedef struct {
+    const int16_t *samples;
+    int64_t sample_count;
+    int16_t *decoded;
+    wavMap map;
+    const char *label;
+} clip_t;
+
+typedef struct {
+    sensitivities_t sensitivities;
+    // clips that should have a wake word, how many had one, and how many were understood as their label, or as
+    // anything if they have none
+    int32_t positives;
+    int32_t detected;
+    int32_t understood;
+    // clips labelled "none", and every wake word in them
+    int32_t negatives;
+    double negative_sec;
+    int32_t false_alarms;
+    bool is_failed;
+} sweep_point_t;
+
+typedef struct {
+    const clip_t *clips;
+    int32_t clip_count;
+    sweep_point_t *points;
+    int32_t point_count;
+    int32_t next_point;
+    int32_t flush_frames;
+} sweep_t;
+
+// "0.3,0.5,0.7"; returns the number of values, 0 if one isn't in [0, 1]
+static int32_t parse_sensitivities(const char *list, float *values) {
+    int32_t count = 0;
+    const char *cursor = list;
+    while (*cursor != '\0' && count < MAX_SWEEP_VALUES) {
+        char *end = NULL;
+        const float value = strtof(cursor, &end);
+        if (end == cursor || value < 0.f || value > 1.f) {
+            return 0;
+        }
+        values[count++] = value;
+        cursor = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            return 0;
+        }
+    }
+    return (*cursor == '\0') ? count : 0;
+}
+
+static bool load_clip(const char *wav_path, clip_t *clip) {
+    if (wavMap_open(wav_path, engine.sampleRate, &clip->map)) {
+        clip->samples = clip->map.samples;
+        clip->sample_count = clip->map.sampleCount;
+        return true;
+    }
+    audioDecoder *decoder = NULL;
+    const char *error = audioDecoder_open(wav_path, engine.sampleRate, &decoder);
+    if (error) {
+        fprintf(stderr, "skipping '%s': %s.\n", wav_path, error);
+        return false;
+    }
+    // a compressed file's length isn't known until it's decoded
+    int64_t capacity = 0;
+    while (true) {
+        if (clip->sample_count == capacity) {
+            capacity = capacity ? 2 * capacity : 16 * engine.sampleRate;
+            int16_t *decoded = realloc(clip->decoded, (size_t) capacity * sizeof(int16_t));
+            if (!decoded) {
+                fprintf(stderr, "failed to allocate memory for '%s'.\n", wav_path);
+                exit(1);
+            }
+            clip->decoded = decoded;
+        }
+        const int64_t room = capacity - clip->sample_count;
+        const int32_t wanted = (room < INT32_MAX) ? (int32_t) room : INT32_MAX;
+        const int32_t read = audioDecoder_read(decoder, clip->decoded + clip->sample_count, wanted);
+        clip->sample_count += read;
+        if (read < wanted) {
+            break;
+        }
+    }
+    audioDecoder_close(decoder);
+    clip->samples = clip->decoded;
+    return true;
+}
+
+static void score_clip(sweep_point_t *point, const clip_t *clip, const file_result_t *result, int32_t audio_frames) {
+    if (clip->label && strcmp(clip->label, "none") == 0) {
+        point->negatives++;
+        point->negative_sec += frame_seconds(audio_frames);
+        point->false_alarms += result->wake_word_count;
+        return;
+    }
+    point->positives++;
+    if (result->wake_word_count > 0) {
+        point->detected++;
+    }
+    if (result->is_understood && (!clip->label || strcmp(clip->label, result->intent) == 0)) {
+        point->understood++;
+    }
+}
+
+static void *run_sweep_worker(void *arg) {
+    sweep_t *sweep = arg;
+    int16_t *pcm = calloc(engine.frameLength, sizeof(int16_t));
+    if (!pcm) {
+        fprintf(stderr, "failed to allocate memory for audio frame.\n");
+        exit(1);
+    }
+    int32_t index;
+    while ((index = __atomic_fetch_add(&sweep->next_point, 1, __ATOMIC_RELAXED)) < sweep->point_count) {
+        sweep_point_t *point = &sweep->points[index];
+        pv_picovoice_t *handle = NULL;
+        pv_status_t status = create_handle_with(&point->sensitivities, &handle);
+        if (status != PV_STATUS_SUCCESS) {
+            fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", engine.statusToString(status));
+            point->is_failed = true;
+            continue;
+        }
+        double cpu_time_usec = 0;
+        for (int32_t i = 0; handle && i < sweep->clip_count; i++) {
+            const clip_t *clip = &sweep->clips[i];
+            file_result_t result;
+            memset(&result, 0, sizeof(result));
+            frame_source_t source = {NULL, NULL, clip->samples, clip->sample_count, 0};
+            int32_t audio_frames = 0;
+            const bool is_ok = process_source(handle, &source, pcm, sweep->flush_frames, &result, &audio_frames,
+                    &cpu_time_usec);
+            score_clip(point, clip, &result, audio_frames);
+            free(result.wake_words.data);
+            free(result.inferences.data);
+            free(result.hourly);
+            point->is_failed |= !is_ok;
+            if (!restart_if_needed(&handle, is_ok, &result, &point->sensitivities)) {
+                point->is_failed = true;
+            }
+        }
+        if (handle) {
+            engine.destroy(handle);
+        }
+    }
+    free(pcm);
+    return NULL;
+}
+
+// One JSON line per grid point on stdout, in grid order.
+static int run_sweep(const char *batch_path, const float *porcupine_values, int32_t porcupine_count,
+        const float *rhino_values, int32_t rhino_count, int32_t worker_count) {
+    file_list_t files;
+    clipPack pack;
+    const bool is_packed = open_corpus(batch_path, &pack, &files);
+    clip_t *clips = calloc((size_t) (files.count > 0 ? files.count : 1), sizeof(clip_t));
+    sweep_point_t *points = calloc((size_t) (porcupine_count * rhino_count), sizeof(sweep_point_t));
+    pthread_t *workers = calloc((size_t) worker_count, sizeof(pthread_t));
+    if (!clips || !points || !workers) {
+        fprintf(stderr, "failed to allocate memory for the sweep.\n");
+        exit(1);
+    }
+
+    sweep_t sweep;
+    memset(&sweep, 0, sizeof(sweep));
+    double audio_sec = 0;
+    for (int32_t i = 0; i < files.count; i++) {
+        clip_t *clip = &clips[sweep.clip_count];
+        if (is_packed) {
+            clip->samples = clipPack_samples(&pack, i, &clip->sample_count);
+        }
+        if (is_packed || load_clip(files.paths[i], clip)) {
+            clips[sweep.clip_count].label = files.labels[i];
+            audio_sec += (double) clips[sweep.clip_count].sample_count / engine.sampleRate;
+            sweep.clip_count++;
+        }
+    }
+    for (int32_t p = 0; p < porcupine_count; p++) {
+        for (int32_t r = 0; r < rhino_count; r++) {
+            points[p * rhino_count + r].sensitivities = (sensitivities_t) {porcupine_values[p], rhino_values[r]};
+        }
+    }
+    sweep.clips = clips;
+    sweep.points = points;
+    sweep.point_count = porcupine_count * rhino_count;
+    sweep.flush_frames = (int32_t) (((picovoice_params.endpoint_duration_sec + 1.0) * engine.sampleRate) /
+            engine.frameLength) + 1;
+    if (worker_count > sweep.point_count) {
+        worker_count = sweep.point_count;
+    }
+
+    struct timeval started;
+    gettimeofday(&started, NULL);
+    for (int32_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&workers[i], NULL, run_sweep_worker, &sweep) != 0) {
+            fprintf(stderr, "failed to start sweep worker %d.\n", i);
+            exit(1);
+        }
+    }
+    for (int32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    struct timeval finished;
+    gettimeofday(&finished, NULL);
+
+    bool is_ok = true;
+    for (int32_t i = 0; i < sweep.point_count; i++) {
+        const sweep_point_t *point = &points[i];
+        const double negative_hours = point->negative_sec / 3600.0;
+        fprintf(stdout, "{\"porcupine_sensitivity\":%.3f,\"rhino_sensitivity\":%.3f,\"positives\":%d,\"detected\":%d,"
+                        "\"detection_rate\":%.4f,\"understood\":%d,\"understood_rate\":%.4f,\"negatives\":%d,"
+                        "\"negative_hours\":%.4f,\"false_alarms\":%d,\"false_alarms_per_hour\":%.3f%s}\n",
+                point->sensitivities.porcupine, point->sensitivities.rhino, point->positives, point->detected,
+                (point->positives > 0) ? (double) point->detected / point->positives : 0.0, point->understood,
+                (point->positives > 0) ? (double) point->understood / point->positives : 0.0, point->negatives,
+                negative_hours, point->false_alarms,
+                (negative_hours > 0) ? point->false_alarms / negative_hours : 0.0,
+                point->is_failed ? ",\"error\":\"'pv_picovoice_process' failed\"" : "");
+        is_ok &= !point->is_failed;
+    }
+    fflush(stdout);
+    fprintf(stderr, "%d settings over %d of %d files, %.1f s of audio decoded once, %d %s, %.1f s\n",
+            sweep.point_count, sweep.clip_count, files.count, audio_sec, worker_count,
+            worker_count > 1 ? "workers" : "worker", elapsed_usec(&started, &finished) / 1e6);
+
+    for (int32_t i = 0; i < sweep.clip_count; i++) {
+        free(clips[i].decoded);
+        wavMap_close(&clips[i].map);
+    }
+    free(clips);
+    free(points);
+    free(workers);
+    free_file_list(&files);
+    clipPack_close(&pack);
+    return is_ok ? 0 : 1;
+}
+
+// Pack mode: decodes and resamples the corpus once into a pack, for batch and sweep runs to read in place.
+static int run_pack(const char *batch_path, const char *pack_path) {
+    file_list_t files = collect_wav_paths(batch_path);
+    clipPackWriter writer;
+    if (!clipPack_create(pack_path, engine.sampleRate, &writer)) {
+        exit(1);
+    }
+    int16_t *samples = malloc(PACK_CHUNK_SAMPLES * sizeof(int16_t));
+    if (!samples) {
+        fprintf(stderr, "failed to allocate memory for decoding.\n");
+        exit(1);
+    }
+
+    int32_t packed = 0;
+    int64_t sample_count = 0;
+    bool is_ok = true;
+    for (int32_t i = 0; is_ok && i < files.count; i++) {
+        audioDecoder *decoder = NULL;
+        const char *error = audioDecoder_open(files.paths[i], engine.sampleRate, &decoder);
+        if (error) {
+            fprintf(stderr, "skipping '%s': %s.\n", files.paths[i], error);
+            continue;
+        }
+        clipPack_beginClip(&writer);
+        int32_t read;
+        do {
+            read = audioDecoder_read(decoder, samples, PACK_CHUNK_SAMPLES);
+            is_ok = clipPack_append(&writer, samples, read);
+            sample_count += read;
+        } while (is_ok && read == PACK_CHUNK_SAMPLES);
+        audioDecoder_close(decoder);
+        is_ok = is_ok && clipPack_endClip(&writer, files.paths[i], files.labels[i]);
+        packed++;
+    }
+    is_ok = clipPack_finish(&writer) && is_ok;
+
+    fprintf(stderr, "%d of %d files, %.1f s of audio, packed into '%s'\n", packed, files.count,
+            (double) sample_count / engine.sampleRate, pack_path);
+    free(samples);
+    free_file_list(&files);
+    return is_ok ? 0 : 1;
+}
+
 int picovoice_main(int argc, char *argv[]) {
 
     const char *library_path = NULL;
     const char *wav_path = NULL;
+    const char *input_stream = NULL;
+    const char *batch_path = NULL;
+    const char *pack_path = NULL;
+    int32_t jobs = 1;
+    // 0 replays as fast as the engine goes
+    float speed = 0.f;
+    const char *porcupine_sweep = NULL;
+    const char *rhino_sweep = NULL;
     const char *access_key = NULL;
     const char *keyword_path = NULL;
     const char *context_path = NULL;
@@ -146,7 +1145,7 @@ int picovoice_main(int argc, char *argv[]) {
     bool require_endpoint = true;
 
     int c;
-    while ((c = getopt_long(argc, argv, "e:l:w:a:k:c:s:p:t:r:u:", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "e:l:w:i:x:P:Nb:j:S:T:a:k:c:s:p:t:r:u:", long_options, NULL)) != -1) {
         switch (c) {
             case 'l':
                 library_path = optarg;
@@ -154,6 +1153,30 @@ int picovoice_main(int argc, char *argv[]) {
             case 'w':
                 wav_path = optarg;
                 break;
+            case 'i':
+                input_stream = optarg;
+                break;
+            case 'P':
+                pack_path = optarg;
+                break;
+            case 'N':
+                is_soak_test = true;
+                break;
+            case 'x':
+                speed = strtof(optarg, NULL);
+                break;
+            case 'b':
+                batch_path = optarg;
+                break;
+            case 'j':
+                jobs = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'S':
+                porcupine_sweep = optarg;
+                break;
+            case 'T':
+                rhino_sweep = optarg;
+                break;
             case 'a':
                 access_key = optarg;
                 break;
@@ -189,158 +1212,141 @@ int picovoice_main(int argc, char *argv[]) {
         }
     }
 
-    if (!library_path || !keyword_path || !context_path || !access_key || !wav_path || !porcupine_model_path || !rhino_model_path) {
-        print_usage(argv[0]);
-        exit(1);
-    }
-
-    void *picovoice_library = open_dl(library_path);
-    if (!picovoice_library) {
-        fprintf(stderr, "failed to open library.\n");
-        exit(1);
-    }
-
-    const char *(*pv_status_to_string_func)(pv_status_t) = load_symbol(picovoice_library, "pv_status_to_string");
-    if (!pv_status_to_string_func) {
-        print_dl_error("failed to load 'pv_status_to_string'");
-        exit(1);
-    }
-
-    int32_t (*pv_sample_rate_func)() = load_symbol(picovoice_library, "pv_sample_rate");
-    if (!pv_sample_rate_func) {
-        print_dl_error("failed to load 'pv_sample_rate'");
-        exit(1);
-    }
-
-    pv_status_t (*pv_picovoice_init_func)(
-            const char *,
-            const char *,
-            const char *,
-            float,
-            void (*)(void),
-            const char *,
-            const char *,
-            float,
-            float,
-            bool,
-            void (*)(pv_inference_t *),
-            pv_picovoice_t **) = NULL;
-    pv_picovoice_init_func = load_symbol(picovoice_library, "pv_picovoice_init");
-    if (!pv_picovoice_init_func) {
-        print_dl_error("failed to load 'pv_picovoice_init'");
-        exit(1);
-    }
-
-    void (*pv_picovoice_delete_func)(pv_picovoice_t *) = load_symbol(picovoice_library, "pv_picovoice_delete");
-    if (!pv_picovoice_delete_func) {
-        print_dl_error("failed to load 'pv_picovoice_delete'");
-        exit(1);
-    }
-
-    pv_status_t (*pv_picovoice_process_func)(pv_picovoice_t *, const int16_t *) =
-    load_symbol(picovoice_library, "pv_picovoice_process");
-    if (!pv_picovoice_process_func) {
-        print_dl_error("failed to load 'pv_picovoice_process'");
-        exit(1);
-    }
-
-    int32_t (*pv_picovoice_frame_length_func)() = load_symbol(picovoice_library, "pv_picovoice_frame_length");
-    if (!pv_picovoice_frame_length_func) {
-        print_dl_error("failed to load 'pv_picovoice_frame_length'");
-        exit(1);
+    // packing needs nothing of the engine but its sample rate
+    if (pack_path) {
+        if (!library_path || !batch_path) {
+            print_usage(argv[0]);
+            exit(1);
+        }
+        if (!pvEngine_load(library_path, &engine)) {
+            exit(1);
+        }
+        const int result = run_pack(batch_path, pack_path);
+        pvEngine_unload(&engine);
+        return result;
     }
 
-    const char *(*pv_picovoice_version_func)() = load_symbol(picovoice_library, "pv_picovoice_version");
-    if (!pv_picovoice_version_func) {
-        print_dl_error("failed to load 'pv_picovoice_version'");
+    if (!library_path || !keyword_path || !context_path || !access_key || ((!wav_path + !input_stream + !batch_path) != 2) || (jobs < 1) || (speed < 0.f) || !porcupine_model_path || !rhino_model_path) {
+        print_usage(argv[0]);
         exit(1);
     }
 
-    pv_inference_delete_func = load_symbol(picovoice_library, "pv_inference_delete");
-    if (!pv_inference_delete_func) {
-        print_dl_error("failed to load 'pv_inference_delete'");
+    if (!pvEngine_load(library_path, &engine)) {
         exit(1);
     }
 
-    drwav f;
+    picovoice_params = (picovoice_params_t) {
+            access_key,
+            porcupine_model_path,
+            keyword_path,
+            porcupine_sensitivity,
+            rhino_model_path,
+            context_path,
+            rhino_sensitivity,
+            endpoint_duration_sec,
+            require_endpoint,
+    };
 
-    if (!drwav_init_file(&f, wav_path, NULL)) {
-        fprintf(stderr, "failed to open wav file at '%s'.", wav_path);
+    // a soak test is a batch, reported as false alarms
+    if (is_soak_test && (!batch_path || porcupine_sweep || rhino_sweep)) {
+        print_usage(argv[0]);
         exit(1);
     }
 
-    if (f.sampleRate != (uint32_t) pv_sample_rate_func()) {
-        fprintf(stderr, "audio sample rate should be %d\n.", pv_sample_rate_func());
-        exit(1);
+    if (porcupine_sweep || rhino_sweep) {
+        if (!batch_path) {
+            print_usage(argv[0]);
+            exit(1);
+        }
+        // a list left out sweeps the one value given with -s or -t
+        float porcupine_values[MAX_SWEEP_VALUES] = {porcupine_sensitivity};
+        float rhino_values[MAX_SWEEP_VALUES] = {rhino_sensitivity};
+        const int32_t porcupine_count = porcupine_sweep ? parse_sensitivities(porcupine_sweep, porcupine_values) : 1;
+        const int32_t rhino_count = rhino_sweep ? parse_sensitivities(rhino_sweep, rhino_values) : 1;
+        if (porcupine_count == 0 || rhino_count == 0) {
+            fprintf(stderr, "sensitivities should be comma-separated values in [0, 1], at most %d of them.\n",
+                    MAX_SWEEP_VALUES);
+            exit(1);
+        }
+        const int result = run_sweep(batch_path, porcupine_values, porcupine_count, rhino_values, rhino_count, jobs);
+        pvEngine_unload(&engine);
+        return result;
     }
 
-    if (f.bitsPerSample != 16) {
-        fprintf(stderr, "audio format should be 16-bit\n.");
-        exit(1);
+    if (batch_path) {
+        // one instance per worker for the whole batch
+        const int result = run_batch(batch_path, jobs);
+        pvEngine_unload(&engine);
+        return result;
     }
 
-    if (f.channels != 1) {
-        fprintf(stderr, "audio should be single-channel.\n");
-        exit(1);
+    // a live stream goes through the same frames-to-engine loop as a file
+    frame_source_t source;
+    wavMap map;
+    static pcmStream stream;
+    if (input_stream) {
+        if (!pcmStream_open(input_stream, &stream)) {
+            exit(1);
+        }
+        memset(&source, 0, sizeof(source));
+        source.stream = &stream;
+    } else {
+        const char *error = open_source(wav_path, &source, &map);
+        if (error) {
+            fprintf(stderr, "%s at '%s'.\n", error, wav_path);
+            exit(1);
+        }
     }
 
-    int16_t *pcm = calloc(pv_picovoice_frame_length_func(), sizeof(int16_t));
+    int16_t *pcm = calloc(engine.frameLength, sizeof(int16_t));
     if (!pcm) {
         fprintf(stderr, "failed to allocate memory for audio frame.\n");
         exit(1);
     }
 
     pv_picovoice_t *handle = NULL;
-    pv_status_t status = pv_picovoice_init_func(
-            access_key,
-            porcupine_model_path,
-            keyword_path,
-            porcupine_sensitivity,
-            wake_word_callback,
-            rhino_model_path,
-            context_path,
-            rhino_sensitivity,
-            endpoint_duration_sec,
-            require_endpoint,
-            inference_callback,
-            &handle);
+    pv_status_t status = create_handle(&handle);
     if (status != PV_STATUS_SUCCESS) {
-        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", pv_status_to_string_func(status));
+        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", engine.statusToString(status));
         exit(1);
     }
 
-    fprintf(stdout, "Picovoice End-to-End Platform (%s) :\n\n", pv_picovoice_version_func());
+    fprintf(stdout, "Picovoice End-to-End Platform (%s) :\n\n", engine.version);
 
     double total_cpu_time_usec = 0;
     double total_processed_time_usec = 0;
-    int32_t frame_index = 0;
+    const double start_usec = monotonic_usec();
+
+    const int16_t *frame;
+    while ((frame = next_frame(&source, pcm)) != NULL) {
+        if (speed > 0.f) {
+            throttle(start_usec, replay_frame_index, speed);
+        }
 
-    while ((int32_t) drwav_read_pcm_frames_s16(&f, pv_picovoice_frame_length_func(), pcm) == pv_picovoice_frame_length_func()) {
         struct timeval before;
         gettimeofday(&before, NULL);
 
-        status = pv_picovoice_process_func(handle, pcm);
+        status = engine.process(handle, frame);
         if (status != PV_STATUS_SUCCESS) {
-            fprintf(stderr, "'pv_picovoice_process' failed with '%s'\n", pv_status_to_string_func(status));
+            fprintf(stderr, "'pv_picovoice_process' failed with '%s'\n", engine.statusToString(status));
             exit(1);
         }
 
         struct timeval after;
         gettimeofday(&after, NULL);
 
-        total_cpu_time_usec +=
-                (double) (after.tv_sec - before.tv_sec) * 1e6 + (double) (after.tv_usec - before.tv_usec);
-        total_processed_time_usec += (pv_picovoice_frame_length_func() * 1e6) / pv_sample_rate_func();
-        frame_index++;
+        total_cpu_time_usec += elapsed_usec(&before, &after);
+        total_processed_time_usec += (engine.frameLength * 1e6) / engine.sampleRate;
+        replay_frame_index++;
     }
 
     const double real_time_factor = total_cpu_time_usec / total_processed_time_usec;
     fprintf(stdout, "real time factor : %.3f\n", real_time_factor);
 
     free(pcm);
-    drwav_uninit(&f);
-    pv_picovoice_delete_func(handle);
-    close_dl(picovoice_library);
+    close_source(&source, &map);
+    engine.destroy(handle);
+    pvEngine_unload(&engine);
 
     return 0;
 }
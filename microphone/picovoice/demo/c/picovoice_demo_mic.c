@@ -9,120 +9,163 @@
     specific language governing permissions and limitations under the License.
 */
 
+#include <errno.h>
 #include <getopt.h>
+#include <limits.h>
 #include <signal.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <pthread.h>
 #include <stdbool.h>
-#include <fcntl.h>
-#include <sys/ioctl.h>
-#include <linux/i2c.h>
-#include <linux/i2c-dev.h>
-
-#define yellowButtonPath "/sys/class/gpio/gpio27/value"
-
-#define I2CDRV_LINUX_BUS0 "/dev/i2c-0"
-#define I2CDRV_LINUX_BUS1 "/dev/i2c-1"
-#define I2CDRV_LINUX_BUS2 "/dev/i2c-2"
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include "frame_buffer.h"
+#include "text_scroller.h"
+#include "matrix_driver.h"
+#include "i2c_bus.h"
+#include "servo_driver.h"
+#include "feed_worker.h"
+#include "feed_scheduler.h"
+#include "feed_plan.h"
+#include "feed_notifier.h"
+#include "feed_journal.h"
+#include "feed_guard.h"
+#include "feeder_config.h"
+#include "button_input.h"
+#include "pin_mux.h"
+#include "gpio_registers.h"
+#include "hal.h"
+#include "hal_gpio.h"
+#include "hal_i2c.h"
+#include "hal_pwm.h"
+#include "adc_stream.h"
+#include "hopper_level.h"
+#include "servo_current.h"
+#include "sim_script.h"
+#include "embedded_models.h"
+#include "model_prefetch.h"
+#include "alloc_guard.h"
+#include "memory_budget.h"
+#include "thread_cpu.h"
+#include "feeder_probe.h"
+#include "env_sensor.h"
+#include "thermal_monitor.h"
+#include "cpu_frequency.h"
+#include "pru_link.h"
+#include "event_loop.h"
+#include "engine_fanout.h"
+#include "inference_pipeline.h"
+#include "latency_trace.h"
+#include "metrics.h"
+#include "voice_gate.h"
+#include "command_capture.h"
+#include "audio_archive.h"
+#include "remote_inference.h"
+#include "endpoint_tracker.h"
+#include "rhino_pool.h"
+#include "slot_words.h"
+#include "camera_governor.h"
+#include "audio_tap.h"
+#include "actuator_gate.h"
+#include "async_log.h"
+#include "control_server.h"
+#include "handover.h"
+#include "state_snapshot.h"
+#include "audio_supervisor.h"
+#include "watchdog.h"
+
+#define buttonDebounceInMs 50
+#define displayRefreshInMs 100
+#define smileyInMs 5000
 
 #define numberOfMatrixRows 8
 #define numberOfMatrixCols 8
 
-#define I2C_DEVICE_ADDRESS 0x70
-#define SYS_SETUP_REG 0X21
-#define DISPLAY_SETUP_REG 0x81
 #define EMPTY 0
 
-static unsigned char logicalFrameArr[numberOfMatrixRows];
-static unsigned char physicalFrameArr[numberOfMatrixRows*2];
-static char* charRowByRowBits = 0;
-static int charCurrentColumns = 0;
 
 #if defined(_WIN32) || defined(_WIN64)
 
 #include <windows.h>
 
-#else
-
-#include <dlfcn.h>
-
 #endif
 
-#include "pv_picovoice.h"
+#include "pv_engine.h"
+#include "pv_gain_control.h"
+#include "pv_noise_suppressor.h"
 #include "pv_recorder.h"
 
 
-static pthread_t threadServo;
-static pthread_t threadButton;
-static bool stopServo;
-static bool stopButton = false;
-static bool servoTurnedOn = false;
+// The hardware side (button, display, servo, feed timers) runs on one event loop thread, and this state belongs to it.
+// The inference thread only reaches it through eventLoop_post.
+static pthread_t threadHardware;
+static int displayTimerFd = -1;
+// SIGUSR1 dumps the latency trace to tracePath, SIGHUP reloads the keyword and context
+static int controlSignalFd = -1;
+static const char* tracePath = "/tmp/feeder_trace.json";
+
+// Prometheus metrics, registered by register_metrics before any thread starts
+#define FEED_MODES 3
+static metrics_id wake_words_metric = -1;
+static metrics_id understood_metric = -1;
+static metrics_id not_understood_metric = -1;
+static metrics_id feeds_metric[FEED_MODES] = {-1, -1, -1};
+static metrics_id overflow_metric = -1;
+static metrics_id dropped_metric = -1;
+static metrics_id queue_depth_metric = -1;
+static metrics_id frame_time_metric = -1;
+static metrics_id reloads_metric = -1;
+static metrics_id startup_metric = -1;
+static metrics_id agc_gain_metric = -1;
+static metrics_id actuator_skipped_metric = -1;
+static metrics_id push_to_talk_metric = -1;
+static metrics_id resident_metric = -1;
+// --adaptive_endpoint_ms only
+static metrics_id early_endpoint_metric = -1;
+// --camera_budget_ms only
+static metrics_id camera_level_metric = -1;
+static bool is_camera_governed = false;
+// standby only
+static metrics_id rhino_instances_metric = -1;
+static metrics_id rhino_ready_metric = -1;
+// CPU per subsystem, from the threads' CPU time and the event loop's handlers; "event_loop" is the loop's time no
+// subsystem was charged for, and "other" is the rest of the process
+#define CPU_SUBSYSTEMS 9
+static const char *cpu_subsystems[CPU_SUBSYSTEMS] =
+        {"audio", "inference", "display", "servo", "sensors", "feeds", "control", "event_loop", "other"};
+static metrics_id cpu_metric[CPU_SUBSYSTEMS] = {-1, -1, -1, -1, -1, -1, -1, -1, -1};
+static long long cpu_last_ns[CPU_SUBSYSTEMS];
+static long long cpu_last_us = 0;
+// bumped by every display refresh, so the main thread can tell the event loop is turning
+static long long eventLoopBeats = 0;
+// display refreshes left before the smiley shown after a feed makes way for the mode again
+static long long smileyRefreshesLeft = 0;
+static time_t lastFeedTime = 0;
 static int mode = 0;
 
 static volatile bool is_interrupted = false;
-
-static void *open_dl(const char *dl_path) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    return LoadLibrary(dl_path);
-
-#else
-
-    return dlopen(dl_path, RTLD_NOW);
-
-#endif
-
-}
-
-static void *load_symbol(void *handle, const char *symbol) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    return GetProcAddress((HMODULE) handle, symbol);
-
-#else
-
-    return dlsym(handle, symbol);
-
-#endif
-
-}
-
-static void close_dl(void *handle) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    FreeLibrary((HMODULE) handle);
-
-#else
-
-    dlclose(handle);
-
-#endif
-
-}
-
-static void print_dl_error(const char *message) {
-
-#if defined(_WIN32) || defined(_WIN64)
-
-    fprintf(stderr, "%s with code '%lu'.\n", message, GetLastError());
-
-#else
-
-    fprintf(stderr, "%s with '%s'.\n", message, dlerror());
-
-#endif
-
-}
+// --handover: take over from the feeder already running, once the engines are loaded
+static bool is_taking_over = false;
+// what that feeder handed over, its control socket if it had one
+static handover_state handed = {-1, 0};
+static bool is_handed_over = false;
+// false for a --sim_script replay, which starts from the same state every time rather than the state snapshot's
+static bool is_keeping_state = true;
+// a --sim_script replay, whose feeds are checked against the script
+static bool is_replaying_script = false;
+
+#define HANDOVER_OPTION 256
 
 static struct option long_options[] = {
         {"show_audio_devices",    no_argument,       NULL, 'd'},
         {"library_path",          required_argument, NULL, 'l'},
+        {"rhino_library_path",    required_argument, NULL, 'y'},
         {"access_key",            required_argument, NULL, 'a'},
         {"keyword_path",          required_argument, NULL, 'k'},
         {"context_path",          required_argument, NULL, 'c'},
@@ -132,13 +175,54 @@ static struct option long_options[] = {
         {"rhino_model_path",      required_argument, NULL, 'r'},
         {"endpoint_duration_sec", required_argument, NULL, 'u'},
         {"require_endpoint",      required_argument, NULL, 'e'},
-        {"audio_device_index",    required_argument, NULL, 'i'}
+        {"audio_device_index",    required_argument, NULL, 'i'},
+        {"audio_device",          required_argument, NULL, 'n'},
+        {"alsa_device",           required_argument, NULL, 'A'},
+        {"serial_device",         required_argument, NULL, 'S'},
+        {"serial_baud_rate",      required_argument, NULL, 'B'},
+        {"audio_sample_rate",     required_argument, NULL, 'R'},
+        {"audio_channels",        required_argument, NULL, 'C'},
+        {"audio_priority",        required_argument, NULL, 'P'},
+        {"audio_cpu",             required_argument, NULL, 'U'},
+        {"audio_latency",         required_argument, NULL, 'Y'},
+        {"lock_memory",           no_argument,       NULL, 'M'},
+        {"vad_threshold_db",      required_argument, NULL, 'V'},
+        {"vad_hangover_ms",       required_argument, NULL, 'H'},
+        {"vad_pre_roll_ms",       required_argument, NULL, 'O'},
+        {"noise_suppression_db",  required_argument, NULL, 'N'},
+        {"agc_target_dbfs",       required_argument, NULL, 'L'},
+        {"trace_path",            required_argument, NULL, 'T'},
+        {"metrics_port",          required_argument, NULL, 'm'},
+        {"capture_dir",           required_argument, NULL, 'w'},
+        {"capture_pre_roll_ms",   required_argument, NULL, 'W'},
+        {"capture_quota_mb",      required_argument, NULL, 'Q'},
+        {"log_file",              required_argument, NULL, 'g'},
+        {"syslog",                no_argument,       NULL, 'G'},
+        {"log_level",             required_argument, NULL, 'v'},
+        {"feed_limit",            required_argument, NULL, 'f'},
+        {"config",                required_argument, NULL, 'F'},
+        {"watchdog_device",       required_argument, NULL, 'D'},
+        {"simulate",              no_argument,       NULL, 'X'},
+        {"audio_file",            required_argument, NULL, 'I'},
+        {"audio_speed",           required_argument, NULL, 'E'},
+        {"sim_script",            required_argument, NULL, 'Z'},
+        {"alloc_guard",           required_argument, NULL, 'K'},
+        {"porcupine_library_path", required_argument, NULL, 'j'},
+        {"standby",               no_argument,       NULL, 'o'},
+        {"rhino_warm",            no_argument,       NULL, 'J'},
+        {"rhino_linger_sec",      required_argument, NULL, 'x'},
+        {"adaptive_endpoint_ms",  required_argument, NULL, 'b'},
+        {"camera_budget_ms",      required_argument, NULL, 'q'},
+        {"camera_cgroup",         required_argument, NULL, 'z'},
+        {"audio_archive_dir",     required_argument, NULL, 'h'},
+        // every letter is taken
+        {"handover",              no_argument,       NULL, HANDOVER_OPTION}
 };
 
 void print_usage(const char *program_name) {
     fprintf(stderr,
             "Usage : %s -l LIBRARY_PATH -a ACCESS_KEY -k KEYWORD_PATH -c CONTEXT_PATH -p PPN_MODEL_PATH -r RHN_MODEL_PATH "
-            "[--audio_device_index AUDIO_DEVICE_INDEX --porcupine_sensitivity PPN_SENSITIVITY --rhino_sensitivity RHN_SENSITIVITY --endpoint_duration_sec --require_endpoint \"true\"|\"false\" ]\n"
+            "[--config CONFIG_PATH -k KEYWORD_PATH -c CONTEXT_PATH ... --rhino_library_path RHINO_LIBRARY_PATH --audio_device_index AUDIO_DEVICE_INDEX|--audio_device AUDIO_DEVICE_NAME --alsa_device ALSA_DEVICE --serial_device SERIAL_DEVICE --serial_baud_rate BAUD_RATE --audio_sample_rate 16000|32000|48000 --audio_channels AUDIO_CHANNELS --audio_priority 1..99 --audio_cpu CPU --audio_latency low|balanced|power_save --lock_memory --vad_threshold_db VAD_THRESHOLD_DB --vad_hangover_ms VAD_HANGOVER_MS --vad_pre_roll_ms VAD_PRE_ROLL_MS --noise_suppression_db 1..40 --agc_target_dbfs -40..-3 --trace_path TRACE_JSON|TRACE_CSV --metrics_port PORT --capture_dir CAPTURE_DIR --capture_pre_roll_ms CAPTURE_PRE_ROLL_MS --capture_quota_mb CAPTURE_QUOTA_MB --log_file LOG_FILE|--syslog --log_level debug|info|warn|error --feed_limit MODE:FEEDS_PER_HOUR:BURST:DEDUP_SEC ... --watchdog_device WATCHDOG_DEVICE --simulate --audio_file WAV_PATH --audio_speed SPEED --sim_script SCRIPT_PATH --alloc_guard count|trap --standby --porcupine_library_path PORCUPINE_LIBRARY_PATH --rhino_warm --rhino_linger_sec SECONDS --adaptive_endpoint_ms MIN_SILENCE_MS --camera_budget_ms BUDGET_MS --camera_cgroup CGROUP_DIR --audio_archive_dir AUDIO_ARCHIVE_DIR --handover --porcupine_sensitivity PPN_SENSITIVITY --rhino_sensitivity RHN_SENSITIVITY --endpoint_duration_sec --require_endpoint \"true\"|\"false\" ]\n"
             "       %s --show_audio_devices\n",
             program_name,
             program_name);
@@ -167,33 +251,14 @@ void show_audio_devices(void) {
     pv_recorder_free_device_list(count, devices);
 }
 
-static void wake_word_callback(void) {
-    fprintf(stdout, "[wake word]\n");
-    fflush(stdout);
-}
-
-static void (*pv_inference_delete_func)(pv_inference_t *) = NULL;
-
-void runCommand(char* command)
-{
-    // Execute the shell command (output into pipe)
-    FILE *pipe = popen(command, "r");
-    // Ignore output of the command; but consume it
-    // so we don't get an error when closing the pipe.
-    char buffer[1024];
-    while (!feof(pipe) && !ferror(pipe)) {
-        if (fgets(buffer, sizeof(buffer), pipe) == NULL)
-            break;
-        // printf("--> %s", buffer); // Uncomment for debugging
-        }
-    // Get the exit code from the pipe; non-zero is an error:
-    int exitCode = WEXITSTATUS(pclose(pipe));
-    if (exitCode != 0) {
-        perror("Unable to execute command:");
-        printf(" command: %s\n", command);
-        printf(" exit code: %d\n", exitCode);
-    }
-}
+// resolved once, shared by the callbacks and the audio loop
+static pvEngine engine;
+// not loaded unless --rhino_library_path is given, for push to talk, and for the commands in standby
+static pvRhinoEngine rhino_engine;
+// --standby: Porcupine alone stays resident, and each engine's Rhino comes from the pool after its wake word. engine
+// then only has Porcupine's status strings, sample rate, frame length and version.
+static bool is_standby = false;
+static pvPorcupineEngine porcupine_engine;
 
 void sleepForMs(long long delayInMs){
     const long long NS_PER_MS = 1000 * 1000;
@@ -205,227 +270,174 @@ void sleepForMs(long long delayInMs){
     nanosleep(&reqDelay, (struct timespec *) NULL);
 }
 
-static void writeTo(char* location, char* value)
-{
-    FILE* f = fopen(location, "w");
-    fprintf(f, value);
-    fclose(f);     
-}
-
-void defaultRelease(){
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/period", "20000000");
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/enable", "1");
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/duty_cycle", "2000000");
-    sleepForMs(1000);
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/duty_cycle", "1000000");
-}
-
-void userBasedRelease(int timeToSleep){
-    int sleep;
-    sleep =  timeToSleep * 1000;
-    sleepForMs(sleep);
-    defaultRelease();
-}
-
-void writeI2cReg(int i2cFileDesc, unsigned char regAddr, unsigned char value)
-{
-    unsigned char buff[2];
-    buff[0] = regAddr;
-    buff[1] = value;
-    int res = write(i2cFileDesc, buff, 2);
-    if (res != 2) {
-        perror("I2C: Unable to write i2c register.");
-        exit(1);
-    }
-}
-
-int initI2cBus(char* bus, int address)
-{
-  int i2cFileDesc = open(bus, O_RDWR);
-  int result = ioctl(i2cFileDesc, I2C_SLAVE, address);
-  if (result < 0) {
-    perror("I2C: Unable to set I2C device to slave address.");
-    exit(1);
-  }
-  return i2cFileDesc;
-}
-
 void writeSmileyFace(){
-    int i2cFileDesc = initI2cBus(I2CDRV_LINUX_BUS1, I2C_DEVICE_ADDRESS);
-    writeI2cReg(i2cFileDesc, 0x00, 0x1E);
-    writeI2cReg(i2cFileDesc, 0x02, 0x21);
-    writeI2cReg(i2cFileDesc, 0x04, 0xD2);
-    writeI2cReg(i2cFileDesc, 0x06, 0xD2);
-    writeI2cReg(i2cFileDesc, 0x08, 0xC0);
-    writeI2cReg(i2cFileDesc, 0x0A, 0xD2);
-    writeI2cReg(i2cFileDesc, 0x0C, 0x2D);
-    writeI2cReg(i2cFileDesc, 0x0E, 0x1E);
+    static const unsigned char smileyFace[numberOfMatrixRows] = {0x3C, 0x42, 0xA5, 0xA5, 0x81, 0xA5, 0x5A, 0x3C};
+    frameBuffer_show(smileyFace);
 }
 
 void clearDisplay(){
-    int i2cFileDesc = initI2cBus(I2CDRV_LINUX_BUS1, I2C_DEVICE_ADDRESS);
-    for(int i = 0; i < 16; i+=2){
-        writeI2cReg(i2cFileDesc, i, 0x00);
-    }
+    textScroller_clearText();
+    frameBuffer_clear();
 }
 
-void stop_stopServo(){
-    servoTurnedOn = false;
-    stopServo = true;
-    pthread_join(threadServo, NULL);
-}
-
-void mode2Release(){
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/period", "20000000");
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/enable", "1");
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/duty_cycle", "2000000");
-    sleepForMs(10000);
-    writeTo("/sys/class/pwm/pwmchip3/pwm1/duty_cycle", "1000000");
+// The servo copies the profile as it starts, so a reload can't change a feed half way.
+static const servoProfile* profileForMode(int feedMode){
+    const feederConfig* config = feederConfig_get();
+    if(feedMode == 1){
+        // the delay has already been waited out by the feed scheduler
+        return &config->profiles[1];
+    } else if(feedMode == 2){
+        return &config->profiles[2];
+    }
+    return &config->profiles[0];
 }
 
-static void* turningServoMotor(void* arg){
-    while(!stopServo){
-        if(mode == 0){
-            defaultRelease();
-        } else if (mode == 1){
-            int timeToSleep;
-            printf("Enter a time before releasing food (seconds)\n");
-            scanf("%d",&timeToSleep);
-            userBasedRelease(timeToSleep);
-            sleepForMs(1000);
-        } else if (mode == 2){
-            mode2Release();
-        }
-        clearDisplay();
-        servoTurnedOn = true;
-        sleepForMs(100);
-        stop_stopServo();
+// A portion someone asked for keeps the mode's start delay and takes its ramp and hold from the calibration table.
+static const servoProfile* profileForRequest(const feedRequest* request){
+    const servoProfile* modeProfile = profileForMode(request->mode);
+    if(request->portion <= SERVO_PORTION_DEFAULT || request->portion >= SERVO_PORTIONS){
+        return modeProfile;
     }
-    return NULL;
+    static servoProfile portionProfile;
+    portionProfile = servoProfile_portions[request->portion];
+    portionProfile.startDelayMs = modeProfile->startDelayMs;
+    return &portionProfile;
 }
 
-void start_startServo(){
-    stopServo = false;
-    pthread_create(&threadServo, NULL, turningServoMotor, NULL);
+static long long realtimeUs(){
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
 }
 
-void configureI2C(){
-    runCommand("config-pin P9_18 i2c");
-    runCommand("config-pin P9_17 i2c");
+// One line on the control socket's event stream, e.g. {"event":"mode","time_ms":1760000000000,"mode":2}, for the
+// camera page's overlays. fields is the rest of the object, without braces. On the event loop thread.
+static void publishEvent(const char* name, const char* fields, ...){
+    char line[256];
+    int length = snprintf(line, sizeof(line), "{\"event\":\"%s\",\"time_ms\":%lld", name, realtimeUs() / 1000);
+    if(fields != NULL && length > 0 && length < (int) sizeof(line) - 2){
+        line[length++] = ',';
+        va_list args;
+        va_start(args, fields);
+        int written = vsnprintf(line + length, sizeof(line) - length, fields, args);
+        va_end(args);
+        length = (written > 0) ? length + written : length;
+    }
+    if(length < 0 || length > (int) sizeof(line) - 2){
+        return; // truncated; half an object is no use to anyone
+    }
+    snprintf(line + length, sizeof(line) - length, "}");
+    controlServer_publish(line);
 }
 
-void writeMatrixByBytes(unsigned char* physicalFrameValues){
-  int i2cFileDesc = initI2cBus(I2CDRV_LINUX_BUS1, I2C_DEVICE_ADDRESS);
-  int j = 0;
-  for(int i = 0; i < 16; i += 2){ // for all 8 rows
-      writeI2cReg(i2cFileDesc, i, physicalFrameValues[j]);
-      j++;
+// A temperature for JSON: degrees to a tenth, or null without a reading.
+static void formatCelsius(envSensor_kind kind, char* text, size_t size){
+    const int milliC = envSensor_milliC(kind);
+    if(milliC == ENV_SENSOR_NO_READING){
+        snprintf(text, size, "null");
+    } else {
+        snprintf(text, size, "%.1f", milliC / 1000.0);
     }
 }
 
-void initializeStartRegisters(){
-  int i2cFileDesc = initI2cBus(I2CDRV_LINUX_BUS1, I2C_DEVICE_ADDRESS);
-  writeI2cReg(i2cFileDesc, SYS_SETUP_REG, 0x00); //write to the system setup register to turn on the matrix.
-  writeI2cReg(i2cFileDesc, DISPLAY_SETUP_REG, 0x00); //write to display setup register to turn on LEDs, no flashing.
-}
+static const char* feedSourceNames[FEED_JOURNAL_SOURCES] = {"voice", "button", "schedule", "control"};
 
-void configureAllPins(){
-    runCommand("config-pin p8.15 gpio");
-    runCommand("config-pin -q p8.15");
-    runCommand("config-pin p8.16 gpio");
-    runCommand("config-pin -q p8.16");
-    runCommand("config-pin p8.17 gpio");
-    runCommand("config-pin -q p8.17");
-    runCommand("config-pin p8.18 gpio");
-    runCommand("config-pin -q p8.18");
+static const char* feedSourceName(int source){
+    return (source >= 0 && source < FEED_JOURNAL_SOURCES) ? feedSourceNames[source] : "unknown";
 }
 
-typedef struct {
-  char digit; // 0-9 or . or empty space
-  char rowBitArr[numberOfMatrixRows]; // represents each row of bits of the char
-  char cols; // how wide is this character in terms of columns
-} matrixData;
-
-static matrixData matrix [] = { // holds all the bit data for each row for every character that may need to be displayed
-  {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 4},
-  {'0', {0x20, 0x50, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00}, 4},
-  {'1', {0x20, 0x30, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00}, 4},
-  {'2', {0x20, 0x50, 0x40, 0x20, 0x20, 0x10, 0x70, 0x00}, 4},
-  {'3', {0x30, 0x40, 0x40, 0x70, 0x40, 0x40, 0x30, 0x00}, 4},
-  {'4', {0x40, 0x60, 0x50, 0x50, 0x70, 0x40, 0x40, 0x00}, 4},
-  {'5', {0x70, 0x10, 0x10, 0x70, 0x40, 0x50, 0x20, 0x00}, 4},
-  {'6', {0x60, 0x10, 0x10, 0x30, 0x50, 0x50, 0x20, 0x00}, 4},
-  {'7', {0x70, 0x40, 0x40, 0x40, 0x20, 0x20, 0x20, 0x00}, 4},
-  {'8', {0x20, 0x50, 0x50, 0x20, 0x50, 0x50, 0x20, 0x00}, 4},
-  {'9', {0x20, 0x50, 0x50, 0x60, 0x40, 0x40, 0x30, 0x00}, 4},
-  {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40}, 1},
-  {'M', {0x50, 0x70, 0x70, 0x50, 0x50, 0x50, 0x50, 0x00}, 4}
-};
+// when the feed running now started: the wall clock for the journal, the monotonic clock for its duration
+static long long feedStartedRealtimeUs = 0;
+static long long feedStartedUs = 0;
+static bool isFeeding = false;
 
-static matrixData* searchForHexData(char objectMatrix){ // searches for a char and then returns the address if it is found
-  for(int i = 0; matrix[i].digit != EMPTY; i++){
-    if (matrix[i].digit == objectMatrix){
-      return &matrix[i];
+static void feedStarted(const feedRequest* request){
+    int feedMode = request->mode;
+    if(feedMode >= 0 && feedMode < FEED_MODES){
+        metrics_add(feeds_metric[feedMode], 1);
+        stateSnapshot_count(STATE_SNAPSHOT_FEEDS + feedMode);
     }
-  }
-  return NULL;
-}
-
-static char shiftLeftOnMatrixBy(int shiftAmountInBytes, char rowValue){ //shiftLeftBy(2,'1')
-  if(shiftAmountInBytes >= 0){
-    return rowValue >> shiftAmountInBytes;
-  }
-  else{
-    return rowValue << -shiftAmountInBytes;
-  }
-  return 0;
+    if(is_replaying_script){
+        simScript_feedStarted(feedMode);
+    }
+    feedStartedRealtimeUs = realtimeUs();
+    feedStartedUs = latencyTrace_nowUs();
+    isFeeding = true;
+    // the chip blinks whatever is shown until the feed ends, with nothing more to draw
+    matrixDriver_setBlink(MATRIX_DRIVER_BLINK_2HZ);
+    // the camera keeps a clip of every feed, and reports back how long it took to eat
+    feedNotifier_send(feedMode, feedStartedRealtimeUs);
+    char water[16];
+    formatCelsius(ENV_SENSOR_WATER, water, sizeof(water));
+    publishEvent("feed_start", "\"mode\":%d,\"tank\":%d,\"source\":\"%s\",\"water_c\":%s", feedMode,
+                 request->tank, feedSourceName(request->source), water);
 }
 
-static unsigned char warpFrame(unsigned char logicalFrame){
-  unsigned char physicalRows = ((logicalFrame >> 1) | (logicalFrame << 7));
-  return physicalRows;
+// Fish eat little in cold water, and what they leave fouls it; a feed someone asked for still goes ahead.
+static bool skipScheduledFeed(const feedRequest* request){
+    const float minWaterC = feederConfig_get()->minFeedWaterC;
+    const int milliC = envSensor_milliC(ENV_SENSOR_WATER);
+    if(minWaterC < 0.f || milliC == ENV_SENSOR_NO_READING || milliC >= (int) (minWaterC * 1000.f)){
+        return false;
+    }
+    asyncLog_log(ASYNC_LOG_INFO, "Scheduled feed of mode %d skipped: the water is at %.1f C.", request->mode,
+                 milliC / 1000.0);
+    publishEvent("feed_skipped", "\"mode\":%d,\"tank\":%d,\"reason\":\"cold_water\",\"water_c\":%.1f",
+                 request->mode, request->tank, milliC / 1000.0);
+    return true;
 }
 
-static void logicalFrame(){
-  for(int i = 0; i < numberOfMatrixRows; i++){
-    physicalFrameArr[i] = warpFrame(logicalFrameArr[i]);
-  }
-  writeMatrixByBytes(physicalFrameArr);
+static void fedInMode(const feedRequest* request){
+    feedJournal_record record = {
+        feedStartedRealtimeUs,
+        (int32_t) ((latencyTrace_nowUs() - feedStartedUs) / 1000),
+        (uint8_t) request->mode,
+        (uint8_t) request->tank,
+        (uint8_t) request->source,
+        0
+    };
+    feedJournal_append(&record);
+    isFeeding = false;
+    matrixDriver_setBlink(MATRIX_DRIVER_BLINK_OFF);
+    publishEvent("feed_end", "\"mode\":%d,\"tank\":%d,\"source\":\"%s\",\"duration_ms\":%d", request->mode,
+                 request->tank, feedSourceName(request->source), record.durationMs);
+    clearDisplay();
+    lastFeedTime = time(NULL);
+    writeSmileyFace();
+    smileyRefreshesLeft = smileyInMs / displayRefreshInMs;
 }
 
-static void callMatrixObject(matrixData* currentMatrixData){
-  charRowByRowBits = currentMatrixData->rowBitArr; 
-  charCurrentColumns = currentMatrixData->cols;
+// Straight to the pinmux state files; pins already set up by an earlier run are only read.
+void configureI2C(){
+    pinMux_set("P9_18", "i2c");
+    pinMux_set("P9_17", "i2c");
 }
 
-static void displayMatrix(char* display){
-  //cleaning logicalFrameArr from previous values
-  memset(logicalFrameArr,EMPTY, 8);
-  char current = ' '; // initialize the current char to be empty
-  if(*display != EMPTY){
-    current = *display;
-  }
-  callMatrixObject(searchForHexData(current));
-  for(int col = 0; col < numberOfMatrixCols; col+=charCurrentColumns){ // go through all columns
-    current = ' '; // initialize the current char to be empty
-    if(*display != EMPTY){
-      current = *display;
-      ++display;      
-    }
-    callMatrixObject(searchForHexData(current));
-    for(int i = 0; i < numberOfMatrixRows; i++){ // for every row
-      int shiftAmountInBytes = numberOfMatrixCols - charCurrentColumns - col;
-      char rowBits = shiftLeftOnMatrixBy(shiftAmountInBytes,charRowByRowBits[i]); //shift each digit left on the display with a right bitwise shift (>>)
-      logicalFrameArr[i] = logicalFrameArr[i] | rowBits;
+void configureAllPins(){
+    static const char* gpioPins[] = {"P8_15", "P8_16", "P8_17", "P8_18"};
+    for(int i = 0; i < (int) (sizeof(gpioPins) / sizeof(gpioPins[0])); i++){
+        pinMux_set(gpioPins[i], "gpio");
     }
-  }
-  logicalFrame();
 }
 
 void displayMode(char* c){
-  char buff[10];
-  snprintf(buff, 10, "%s", c);
-  displayMatrix(buff);
+  // once food has gone out, the mode is followed by the time of the last feed, e.g. "M0 FED 12:30", then by the water
+  // temperature in whole degrees, and by LOW while the hopper needs refilling
+  char buff[40];
+  const char* low = hopperLevel_isLow() ? " LOW" : "";
+  char water[12] = "";
+  const int milliC = envSensor_milliC(ENV_SENSOR_WATER);
+  if(milliC != ENV_SENSOR_NO_READING){
+    snprintf(water, sizeof(water), " %dC", (milliC + (milliC < 0 ? -500 : 500)) / 1000);
+  }
+  if(lastFeedTime != 0){
+    struct tm fedAt;
+    localtime_r(&lastFeedTime, &fedAt);
+    snprintf(buff, sizeof(buff), "%s FED %02d:%02d%s%s", c, fedAt.tm_hour, fedAt.tm_min, water, low);
+  } else {
+    snprintf(buff, sizeof(buff), "%s%s%s", c, water, low);
+  }
+  textScroller_setText(buff);
 }
 
 void switchMode(){
@@ -440,328 +452,2498 @@ void switchMode(){
     }
 }
 
-int readButton(char *button)
-{
-    FILE *pFile = fopen(button, "r");
-    if (pFile == NULL) {
-        printf("ERROR: Unable to open file (%s) for read\n", button);
-        exit(-1);
+static void showMode(){
+    if(mode == 0){
+        displayMode("M0");
+    } else if(mode == 1){
+        displayMode("M1");
+    } else if(mode == 2){
+        displayMode("M2");
     }
-    // Read string (line)
-    const int MAX_LENGTH = 1024;
-    char buff[MAX_LENGTH];
-    fgets(buff, MAX_LENGTH, pFile);
-    // Close
-    fclose(pFile);
-    // printf("Read: '%s'\n", buff);
-    return(atoi(buff));
 }
 
-bool yellowButtonPressed(){
-    return (readButton(yellowButtonPath) == 1);
+static void refreshDisplay(int fd, void* userData){
+    (void) userData;
+    long long refreshes = eventLoop_readTimer(fd);
+    __atomic_add_fetch(&eventLoopBeats, 1, __ATOMIC_RELAXED);
+    // the settings a reload replaced, once the inference thread is done with them
+    feederConfig_reclaim();
+    if(smileyRefreshesLeft > 0){
+        smileyRefreshesLeft -= refreshes;
+        return;
+    }
+    showMode();
 }
 
-void writingToGPIO(float value){
-    FILE *pFile = fopen("/sys/class/gpio/export", "w");
-    if (pFile == NULL) {
-        printf("ERROR: Unable to open export file.\n");
-        exit(1);
+static void onServoStall(void){
+    const bool isRetrying = servoDriver_unjam();
+    publishEvent("jam", "\"retrying\":%s", isRetrying ? "true" : "false");
+    if(!isRetrying){
+        asyncLog_log(ASYNC_LOG_ERROR, "Servo: the gate is still jammed; leaving it to finish the feed.");
+    }
+}
+
+static void onHopperLevel(int percent){
+    static bool wasLow = false;
+    const bool isLow = hopperLevel_isLow();
+    if(isLow == wasLow){
+        return;
+    }
+    wasLow = isLow;
+    publishEvent("hopper", "\"percent\":%d,\"low\":%s", percent, isLow ? "true" : "false");
+    if(smileyRefreshesLeft <= 0){
+        showMode();
     }
-    fprintf(pFile, "%f", value);
-    fclose(pFile);
 }
 
-void exportYellowButton(){
-    writingToGPIO(27);
+// so a restart, or a crash, comes back in the same mode
+static void saveMode(){
+    stateSnapshot_begin()->mode = mode;
+    stateSnapshot_commit();
 }
 
-static void* displayButton(void* arg){
-    while(!stopButton){
-        clearDisplay();
-        if(yellowButtonPressed()){
-            //For debounce
-            while(yellowButtonPressed()){};
-            switchMode();
-            sleepForMs(100);
-        }
-        if(servoTurnedOn){
-            writeSmileyFace();
-            sleepForMs(5000);
-        }
-        if(mode == 0){
-            displayMode("M0");
-        } else if(mode == 1){
-            displayMode("M1");
-        } else if(mode == 2){
-            displayMode("M2");
-        }
-        sleepForMs(100);
+static void onModeButton(){
+    switchMode();
+    saveMode();
+    publishEvent("mode", "\"mode\":%d,\"source\":\"button\"", mode);
+    if(smileyRefreshesLeft <= 0){
+        showMode();
     }
-    return NULL;
 }
 
-void display_startButton(){
-    pthread_create(&threadButton, NULL, displayButton, NULL);
-}
+// With a Rhino library to run on its own, the button is push to talk rather than the mode switch; main decides once
+// the options are parsed, which is after the button has been set up. The press is taken by the inference thread.
+static bool isPushToTalk = false;
+static bool isPushToTalkPressed = false;
 
-void display_stopButton(){
-    stopButton = true;
-    pthread_join(threadButton, NULL);
+static void onButton(){
+    if(!__atomic_load_n(&isPushToTalk, __ATOMIC_ACQUIRE)){
+        onModeButton();
+        return;
+    }
+    __atomic_store_n(&isPushToTalkPressed, true, __ATOMIC_RELEASE);
+    publishEvent("push_to_talk", NULL);
 }
 
-static void inference_callback(pv_inference_t *inference) {
-    fprintf(stdout, "{\n");
-    fprintf(stdout, "    is_understood : '%s',\n", (inference->is_understood ? "true" : "false"));
-    if (inference->is_understood) {
-        fprintf(stdout, "    intent : '%s',\n", inference->intent);
-        if (inference->num_slots > 0) {
-            fprintf(stdout, "    slots : {\n");
-            for (int32_t i = 0; i < inference->num_slots; i++) {
-                fprintf(stdout, "        '%s' : '%s',\n", inference->slots[i], inference->values[i]);
-            }
-            fprintf(stdout, "    }\n");
+typedef struct {
+    long long delayInMs;
+    bool hasDelay;
+    bool recurring;
+    // the engine that heard it, unless a tank was named
+    int tank;
+    // a servoPortion
+    int portion;
+} feedCommand;
+
+// Runs on the event loop thread, so it reads the mode the display is showing.
+static void scheduleFeed(const void* data){
+    const feedCommand* command = data;
+    if(mode == 1 && !command->hasDelay){
+        asyncLog_log(ASYNC_LOG_WARN, "mode 1 needs a delay, e.g. \"in five minutes\"");
+        return;
+    }
+    feedRequest request = {mode, command->tank, FEED_JOURNAL_SOURCE_VOICE, command->portion};
+    const char* portion = (command->portion > SERVO_PORTION_DEFAULT && command->portion < SERVO_PORTIONS) ?
+            servoProfile_portions[command->portion].name : "mode's portion";
+    if(!command->hasDelay){
+        // straight onto the servo's queue, with no timer in between
+        if(feedWorker_request(&request)){
+            asyncLog_log(ASYNC_LOG_INFO, "running servo now, %s, tank %d", portion, command->tank + 1);
         }
-	
-        printf("running servo\n");
-        
-        start_startServo();
+        return;
+    }
+    if(feedScheduler_schedule(&request, command->delayInMs, command->recurring ? command->delayInMs : 0)){
+        asyncLog_log(ASYNC_LOG_INFO, "running servo in %lld ms%s, %s, tank %d", command->delayInMs,
+                command->recurring ? ", repeating" : "", portion, command->tank + 1);
     }
-    fprintf(stdout, "}\n\n");
-    fflush(stdout);
-
-    pv_inference_delete_func(inference);
 }
 
-int picovoice_main(int argc, char *argv[]) {
+// Control socket routes; they run on the event loop thread, like the button and the scheduler.
 
-    signal(SIGINT, interrupt_handler);
-    const char *library_path = NULL;
-    const char *access_key = NULL;
-    const char *keyword_path = NULL;
-    const char *context_path = NULL;
-    float porcupine_sensitivity = 0.5f;
-    const char *porcupine_model_path = NULL;
-    float rhino_sensitivity = 0.5f;
-    const char *rhino_model_path = NULL;
-    float endpoint_duration_sec = 1.f;
-    bool require_endpoint = true;
-    int32_t device_index = -1;
+// Fails only for a parameter that is there but out of range; one that isn't there leaves value as it was.
+static bool optionalParam(const char* params, const char* name, long long min, long long max, long long* value){
+    char text[24];
+    return !controlServer_getParam(params, name, text, sizeof(text)) ||
+           controlServer_getInt(params, name, min, max, value);
+}
 
-    int c;
-    while ((c = getopt_long(argc, argv, "de:l:a:k:c:s:p:t:r:i:u:", long_options, NULL)) != -1) {
-        switch (c) {
-            case 'd':
-                show_audio_devices();
-                return 0;
-            case 'l':
-                library_path = optarg;
-                break;
-            case 'a':
-                access_key = optarg;
-                break;
-            case 'k':
-                keyword_path = optarg;
-                break;
-            case 'c':
-                context_path = optarg;
-                break;
-            case 's':
-                porcupine_sensitivity = strtof(optarg, NULL);
-                break;
-            case 'p':
-                porcupine_model_path = optarg;
-                break;
-            case 't':
-                rhino_sensitivity = strtof(optarg, NULL);
-                break;
-            case 'r':
-                rhino_model_path = optarg;
-                break;
-            case 'u':
-                endpoint_duration_sec = strtof(optarg, NULL);
-                break;
-            case 'e':
-                if (strcmp(optarg, "false") == 0) {
-                    require_endpoint = false;
-                }
-                break;
-            case 'i':
-                device_index = (int32_t) strtol(optarg, NULL, 10);
-                break;
-            default:
-                print_usage(argv[0]);
-                exit(1);
-        }
+// GET /status
+static int controlStatus(const char* params, char* body, size_t size){
+    (void) params;
+    char lastFeed[24] = "null";
+    if(lastFeedTime != 0){
+        snprintf(lastFeed, sizeof(lastFeed), "%lld", (long long) lastFeedTime);
     }
-
-    if (!library_path || !keyword_path || !context_path || !access_key || !porcupine_model_path || !rhino_model_path) {
-        print_usage(argv[0]);
-        exit(1);
+    char hopper[16] = "null";
+    if(hopperLevel_percent() >= 0){
+        snprintf(hopper, sizeof(hopper), "%d", hopperLevel_percent());
     }
+    char water[16];
+    char air[16];
+    formatCelsius(ENV_SENSOR_WATER, water, sizeof(water));
+    formatCelsius(ENV_SENSOR_AIR, air, sizeof(air));
+    snprintf(body, size,
+             "{\"mode\":%d,\"feeding\":%s,\"last_feed\":%s,\"audio_ok\":%s,\"config_generation\":%u,"
+             "\"hopper_percent\":%s,\"water_c\":%s,\"air_c\":%s}",
+             mode, isFeeding ? "true" : "false", lastFeed, audioSupervisor_isHealthy(0) ? "true" : "false",
+             feederConfig_get()->generation, hopper, water, air);
+    return 200;
+}
 
-    void *picovoice_library = open_dl(library_path);
-    if (!picovoice_library) {
-        fprintf(stderr, "failed to open library.\n");
-        exit(1);
+// GET /plan: the day's planned feeds, and the water temperature that decided how many
+static int controlPlan(const char* params, char* body, size_t size){
+    (void) params;
+    const feedPlan_day* plan = feedPlan_today();
+    char water[16] = "null";
+    if(plan->waterMilliC != ENV_SENSOR_NO_READING){
+        snprintf(water, sizeof(water), "%.1f", plan->waterMilliC / 1000.0);
     }
-
-    const char *(*pv_status_to_string_func)(pv_status_t) = load_symbol(picovoice_library, "pv_status_to_string");
-    if (!pv_status_to_string_func) {
-        print_dl_error("failed to load 'pv_status_to_string'");
-        exit(1);
+    int length = snprintf(body, size, "{\"date\":%d,\"water_c\":%s,\"percent\":%d,\"feeds\":[", (int) plan->date,
+                          water, plan->percent);
+    for(int i = 0; i < plan->count && length > 0 && length < (int) size; i++){
+        const feedPlan_entry* entry = &plan->entries[i];
+        length += snprintf(body + length, size - length, "%s{\"time\":\"%02d:%02d\",\"mode\":%d,\"tank\":%d}",
+                           i > 0 ? "," : "", entry->minuteOfDay / 60, entry->minuteOfDay % 60, entry->mode,
+                           entry->tank);
     }
-
-    int32_t (*pv_sample_rate_func)() = load_symbol(picovoice_library, "pv_sample_rate");
-    if (!pv_sample_rate_func) {
-        print_dl_error("failed to load 'pv_sample_rate'");
-        exit(1);
+    if(length > 0 && length < (int) size){
+        snprintf(body + length, size - length, "]}");
     }
+    return 200;
+}
 
-    pv_status_t (*pv_picovoice_init_func)(
-            const char *,
-            const char *,
-            const char *,
-            float,
-            void (*)(void),
-            const char *,
-            const char *,
-            float,
-            float,
-            bool,
-            void (*)(pv_inference_t *),
-            pv_picovoice_t **) = NULL;
-    pv_picovoice_init_func = load_symbol(picovoice_library, "pv_picovoice_init");
-    if (!pv_picovoice_init_func) {
-        print_dl_error("failed to load 'pv_picovoice_init'");
-        exit(1);
+// GET /stats: today's feeds from the journal index, and the counters the shutdown summary prints
+static int controlStats(const char* params, char* body, size_t size){
+    (void) params;
+    feedJournal_day today;
+    if(!feedJournal_getLastDay(&today) || today.date != feedJournal_dateOf(realtimeUs())){
+        memset(&today, 0, sizeof(today));
     }
+    feedGuard_stats guard;
+    feedGuard_getStats(&guard);
+    inferencePipeline_stats pipeline;
+    inferencePipeline_getStats(&pipeline);
+    audioSupervisor_stats audio;
+    audioSupervisor_getStats(&audio);
+    snprintf(body, size,
+             "{\"today\":{\"feeds\":%u,\"open_sec\":%.1f,\"voice\":%u,\"button\":%u,\"schedule\":%u,\"control\":%u},"
+             "\"feed_guard\":{\"merged\":%lld,\"rate_limited\":%lld},"
+             "\"inference\":{\"captured_frames\":%lld,\"processed_frames\":%lld,\"dropped_frames\":%lld,\"queue_depth\":%d},"
+             "\"audio\":{\"restarts\":%lld,\"failed_attempts\":%lld}}",
+             today.feeds, today.durationMs / 1000.0, today.sourceFeeds[FEED_JOURNAL_SOURCE_VOICE],
+             today.sourceFeeds[FEED_JOURNAL_SOURCE_BUTTON], today.sourceFeeds[FEED_JOURNAL_SOURCE_SCHEDULE],
+             today.sourceFeeds[FEED_JOURNAL_SOURCE_CONTROL], guard.merged, guard.rateLimited,
+             pipeline.capturedFrames, pipeline.processedFrames, pipeline.droppedFrames, pipeline.queueDepth,
+             audio.restarts, audio.failedAttempts);
+    return 200;
+}
 
-    void (*pv_picovoice_delete_func)(pv_picovoice_t *) = load_symbol(picovoice_library, "pv_picovoice_delete");
-    if (!pv_picovoice_delete_func) {
-        print_dl_error("failed to load 'pv_picovoice_delete'");
-        exit(1);
+// POST /feed [mode=0..2, the one shown by default] [delay_sec=N] [tank=N]
+static int controlFeed(const char* params, char* body, size_t size){
+    long long feedMode = mode;
+    long long delaySec = 0;
+    long long tank = 0;
+    if(!optionalParam(params, "mode", 0, FEED_MODES - 1, &feedMode) ||
+       !optionalParam(params, "delay_sec", 0, 24 * 60 * 60, &delaySec) ||
+       !optionalParam(params, "tank", 0, FEED_JOURNAL_MAX_TANKS - 1, &tank)){
+        snprintf(body, size, "{\"error\":\"mode, delay_sec or tank out of range\"}");
+        return 400;
     }
+    if(feedMode == 1 && delaySec == 0){
+        snprintf(body, size, "{\"error\":\"mode 1 needs a delay_sec\"}");
+        return 400;
+    }
+    feedRequest request = {(int) feedMode, (int) tank, FEED_JOURNAL_SOURCE_CONTROL, SERVO_PORTION_DEFAULT};
+    if(delaySec > 0){
+        if(!feedScheduler_schedule(&request, delaySec * 1000, 0)){
+            snprintf(body, size, "{\"error\":\"too many feeds pending\"}");
+            return 503;
+        }
+        snprintf(body, size, "{\"scheduled\":true,\"mode\":%lld,\"delay_sec\":%lld}", feedMode, delaySec);
+        return 202;
+    }
+    // the worker says why in the log: already queued or running, queue full, or over the feed limit
+    if(!feedWorker_request(&request)){
+        snprintf(body, size, "{\"error\":\"feed refused\"}");
+        return 429;
+    }
+    snprintf(body, size, "{\"queued\":true,\"mode\":%lld}", feedMode);
+    return 202;
+}
 
-    pv_status_t (*pv_picovoice_process_func)(pv_picovoice_t *, const int16_t *) =
-    load_symbol(picovoice_library, "pv_picovoice_process");
-    if (!pv_picovoice_process_func) {
-        print_dl_error("failed to load 'pv_picovoice_process'");
-        exit(1);
+// POST /mode mode=0..2
+static int controlMode(const char* params, char* body, size_t size){
+    long long newMode = 0;
+    if(!controlServer_getInt(params, "mode", 0, FEED_MODES - 1, &newMode)){
+        snprintf(body, size, "{\"error\":\"mode has to be 0 to %d\"}", FEED_MODES - 1);
+        return 400;
     }
+    mode = (int) newMode;
+    saveMode();
+    publishEvent("mode", "\"mode\":%d,\"source\":\"control\"", mode);
+    if(smileyRefreshesLeft <= 0){
+        showMode();
+    }
+    snprintf(body, size, "{\"mode\":%d}", mode);
+    return 200;
+}
 
-    int32_t (*pv_picovoice_frame_length_func)() = load_symbol(picovoice_library, "pv_picovoice_frame_length");
-    if (!pv_picovoice_frame_length_func) {
-        print_dl_error("failed to load 'pv_picovoice_frame_length'");
-        exit(1);
+// POST /consumption feed=<journal time in us>&seconds=n&eaten=0|1, from the camera's capture --pellets
+static int controlConsumption(const char* params, char* body, size_t size){
+    long long feedTimeUs = 0;
+    long long seconds = 0;
+    long long eaten = 0;
+    if(!controlServer_getInt(params, "feed", 1, LLONG_MAX, &feedTimeUs) ||
+       !controlServer_getInt(params, "seconds", 0, 24 * 60 * 60, &seconds) ||
+       !controlServer_getInt(params, "eaten", 0, 1, &eaten)){
+        snprintf(body, size, "{\"error\":\"feed, seconds or eaten out of range\"}");
+        return 400;
+    }
+    uint8_t consumption = FEED_JOURNAL_LEFT_OVER;
+    if(eaten){
+        // never 0, which is a feed the camera didn't report on
+        long long units = (seconds + FEED_JOURNAL_CONSUMPTION_UNIT_SEC - 1) / FEED_JOURNAL_CONSUMPTION_UNIT_SEC;
+        consumption = (uint8_t) (units < 1 ? 1 : units < FEED_JOURNAL_LEFT_OVER ? units : FEED_JOURNAL_LEFT_OVER - 1);
     }
+    if(!feedJournal_setConsumption(feedTimeUs, consumption)){
+        snprintf(body, size, "{\"error\":\"no such feed\"}");
+        return 404;
+    }
+    publishEvent("consumption", "\"feed_time_us\":%lld,\"eaten\":%s,\"seconds\":%lld", feedTimeUs,
+                 eaten ? "true" : "false", seconds);
+    snprintf(body, size, "{\"recorded\":true}");
+    return 200;
+}
 
-    const char *(*pv_picovoice_version_func)() = load_symbol(picovoice_library, "pv_picovoice_version");
-    if (!pv_picovoice_version_func) {
-        print_dl_error("failed to load 'pv_picovoice_version'");
-        exit(1);
+// POST /viewers count=N, from the camera's relay whenever the number watching changes
+static int controlViewers(const char* params, char* body, size_t size){
+    long long count = 0;
+    if(!controlServer_getInt(params, "count", 0, INT_MAX, &count)){
+        snprintf(body, size, "{\"error\":\"count has to be 0 or more\"}");
+        return 400;
     }
+    cpuFrequency_setViewers((int) count);
+    snprintf(body, size, "{\"viewers\":%lld}", count);
+    return 200;
+}
 
-    pv_inference_delete_func = load_symbol(picovoice_library, "pv_inference_delete");
-    if (!pv_inference_delete_func) {
-        print_dl_error("failed to load 'pv_inference_delete'");
-        exit(1);
+// Where the last run, or a crash, left off: the mode, unless a feeder handing over has just sent a newer one, and the
+// counts /metrics goes on from. The scheduler and the feed guard take their part themselves.
+static void restoreState(){
+    stateSnapshot_state state;
+    stateSnapshot_read(&state);
+    if(is_handed_over){
+        saveMode();
+    } else if(state.mode >= 0 && state.mode < FEED_MODES){
+        mode = state.mode;
+    }
+    metrics_add(wake_words_metric, (long long) state.counters[STATE_SNAPSHOT_WAKE_WORDS]);
+    metrics_add(understood_metric, (long long) state.counters[STATE_SNAPSHOT_UNDERSTOOD]);
+    metrics_add(not_understood_metric, (long long) state.counters[STATE_SNAPSHOT_NOT_UNDERSTOOD]);
+    for(int i = 0; i < FEED_MODES; i++){
+        metrics_add(feeds_metric[i], (long long) state.counters[STATE_SNAPSHOT_FEEDS + i]);
     }
+}
 
-    fprintf(stdout, "%s\n", access_key);
-    fprintf(stdout, "%s\n", library_path);
-    fprintf(stdout, "%s\n", keyword_path);
-    fprintf(stdout, "%s\n", context_path);
-    fprintf(stdout, "%s\n", access_key);
+// A new build asked to take over (handover.h): it carries on with the control socket and the mode, and this feeder
+// stops as it would on SIGINT.
+static void onHandover(handover_state* state){
+    state->controlFd = controlServer_release();
+    state->mode = mode;
+    is_interrupted = true;
+}
 
-    pv_picovoice_t *picovoice = NULL;
-    pv_status_t status = pv_picovoice_init_func(
-            access_key,
-            porcupine_model_path,
-            keyword_path,
-            porcupine_sensitivity,
-            wake_word_callback,
-            rhino_model_path,
-            context_path,
-            rhino_sensitivity,
-            endpoint_duration_sec,
-            require_endpoint,
-            inference_callback,
-            &picovoice);
-    if (status != PV_STATUS_SUCCESS) {
-        fprintf(stderr, "'pv_picovoice_init' failed with '%s'\n", pv_status_to_string_func(status));
-        exit(1);
+// POST /button level=0|1, simulated hardware only: drives the button's line, e.g. 1 then 0 after the debounce time for
+// a press
+static int controlButton(const char* params, char* body, size_t size){
+    long long level = 0;
+    if(!controlServer_getInt(params, "level", 0, 1, &level)){
+        snprintf(body, size, "{\"error\":\"level has to be 0 or 1\"}");
+        return 400;
     }
+    halGpio_simSet(feederConfig_startup()->buttonGpio, (int) level);
+    snprintf(body, size, "{\"level\":%lld}", level);
+    return 200;
+}
 
-    fprintf(stdout, "Picovoice End-to-End Platform (%s) :\n\n", pv_picovoice_version_func());
+static void* runHardware(void* arg){
+    (void) arg;
+    // feeds are dispatched from here
+    allocGuard_markHot("event loop");
+    eventLoop_run();
+    return NULL;
+}
 
-    const int32_t frame_length = pv_picovoice_frame_length_func();
-    pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t recorder_status = pv_recorder_init(device_index, frame_length, 100, true, true, &recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
+static void startReload();
+
+static void onControlSignal(int fd, void* userData){
+    (void) userData;
+    struct signalfd_siginfo info;
+    if(read(fd, &info, sizeof(info)) != sizeof(info)){
+        return;
+    }
+    if(info.ssi_signo == SIGHUP){
+        startReload();
+    } else {
+        latencyTrace_dump(tracePath);
+        latencyTrace_printPercentiles();
     }
+    fflush(stdout);
+}
 
-    const char *selected_device = pv_recorder_get_selected_device(recorder);
-    fprintf(stdout, "Selected device: %s\n", selected_device);
+static void controlSignals(sigset_t* signals){
+    sigemptyset(signals);
+    sigaddset(signals, SIGUSR1);
+    sigaddset(signals, SIGHUP);
+}
 
+// The signals have to be blocked in every thread for the signalfd to see them, so this runs before any thread is
+// started. It also keeps the default SIGHUP action from killing the daemon.
+static void blockControlSignals(){
+    sigset_t signals;
+    controlSignals(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+}
 
-    recorder_status = pv_recorder_start(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to start device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
+static bool hardware_start(){
+    displayTimerFd = eventLoop_createTimer();
+    if(displayTimerFd < 0 ||
+       !eventLoop_add(displayTimerFd, EPOLLIN, refreshDisplay, NULL) ||
+       !eventLoop_armTimer(displayTimerFd, displayRefreshInMs, displayRefreshInMs)){
+        return false;
     }
-
-    int16_t *pcm = malloc(frame_length * sizeof(int16_t));
-    if (!pcm) {
-        fprintf(stderr, "Failed to allocate pcm memory.\n");
-        exit(1);
+    eventLoop_setSubsystem(displayTimerFd, "display");
+    sigset_t signals;
+    controlSignals(&signals);
+    controlSignalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if(controlSignalFd < 0 || !eventLoop_add(controlSignalFd, EPOLLIN, onControlSignal, NULL)){
+        return false;
     }
+    if(pthread_create(&threadHardware, NULL, runHardware, NULL) != 0){
+        return false;
+    }
+    threadCpu_setName(threadHardware, "events");
+    return true;
+}
 
-    fprintf(stdout, "Listening...\n\n");
-    fflush(stdout);
-
-    while (!is_interrupted) {
-        recorder_status = pv_recorder_read(recorder, pcm);
-        if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-            fprintf(stderr, "Failed to read with %s.\n", pv_recorder_status_to_string(recorder_status));
-            exit(1);
-        }
+static void hardware_stop(){
+    eventLoop_stop();
+    pthread_join(threadHardware, NULL);
+    eventLoop_remove(displayTimerFd);
+    close(displayTimerFd);
+    eventLoop_remove(controlSignalFd);
+    close(controlSignalFd);
+}
 
-        status = pv_picovoice_process_func(picovoice, pcm);
-        if (status != PV_STATUS_SUCCESS) {
-            fprintf(stderr, "'pv_picovoice_process' failed with '%s'\n",
-                    pv_status_to_string_func(status));
-            exit(1);
+// Reads a command's slots through the slot words: a delay such as "in five minutes" or a period such as "every two
+// hours", a portion such as "a big portion", and a tank such as "tank two". Words in other slots count towards the
+// delay.
+static void commandFromSlots(const pv_inference_t *inference, feedCommand* command){
+    int amount = -1;
+    long long unit = 0;
+    for(int32_t i = 0; i < inference->num_slots; i++){
+        const slotWords_kind slot = slotWords_lookup(inference->slots[i]).kind;
+        char value[128];
+        snprintf(value, sizeof(value), "%s", inference->values[i]);
+        char* savePtr = NULL;
+        for(char* word = strtok_r(value, " ", &savePtr); word != NULL; word = strtok_r(NULL, " ", &savePtr)){
+            const slotWords_meaning meaning = slotWords_lookup(word);
+            if(slot == SLOT_WORD_TANK_SLOT){
+                if(meaning.kind == SLOT_WORD_NUMBER && meaning.value >= 1 && meaning.value <= FEED_JOURNAL_MAX_TANKS){
+                    command->tank = (int) meaning.value - 1;
+                }
+            } else if(meaning.kind == SLOT_WORD_PORTION){
+                command->portion = (int) meaning.value;
+            } else if(slot == SLOT_WORD_PORTION_SLOT){
+                // "the usual amount": only the portion words count here
+            } else if(meaning.kind == SLOT_WORD_NUMBER){
+                // "twenty five"
+                amount = amount > 0 ? amount + (int) meaning.value : (int) meaning.value;
+            } else if(meaning.kind == SLOT_WORD_UNIT){
+                unit = meaning.value;
+            } else if(meaning.kind == SLOT_WORD_EVERY){
+                command->recurring = true;
+            }
         }
     }
+    if(unit == 0){
+        command->recurring = false;
+        return;
+    }
+    // "every hour"
+    command->hasDelay = true;
+    command->delayInMs = (amount >= 0 ? amount : 1) * unit;
+}
 
-    fprintf(stdout, "Stopping...\n");
-    fflush(stdout);
-
-    recorder_status = pv_recorder_stop(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to stop device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
+// What the event loop needs of an inference. The pv_inference_t itself is freed on the inference thread, so the loop
+// never calls into the Picovoice library, which is unloaded before the loop stops.
+typedef struct {
+    bool isUnderstood;
+    feedCommand command;
+    // empty if not understood
+    char intent[32];
+    char text[EVENT_LOOP_POST_DATA_SIZE - 64];
+} inferenceResult;
+
+static void appendText(inferenceResult* result, size_t* length, const char* format, ...){
+    if(*length >= sizeof(result->text)){
+        return; // truncated
     }
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(result->text + *length, sizeof(result->text) - *length, format, args);
+    va_end(args);
+    if(written > 0){
+        *length += (size_t) written;
+    }
+}
 
-    free(pcm);
-    pv_recorder_delete(recorder);
-    pv_picovoice_delete_func(picovoice);
-    close_dl(picovoice_library);
+// One Picovoice instance per keyword and context pair, e.g. one per tank, all listening to the same microphone.
+static int engine_count = 1;
+// The engine whose callbacks are running: each engine always runs on the same thread.
+static __thread int current_engine = 0;
 
-    return 0;
+// What each engine heard in the frame just processed. Its callbacks fill it in on its own thread, and the inference
+// thread hands it to the event loop once every engine is done with the frame, so eventLoop_post keeps one producer.
+typedef struct {
+    // 0 if there was no wake word
+    long long wake_word_us;
+    bool has_inference;
+    long long inference_us;
+    inferenceResult result;
+    // standby: the command was given up on, its Rhino not ready in time or failing
+    bool is_lost;
+} engine_output_t;
+
+static engine_output_t engine_outputs[ENGINE_FANOUT_MAX_ENGINES];
+// engines between their wake word and their inference; the voice gate is held open while there is one. Inference
+// thread only.
+static unsigned int listening_engines = 0;
+// the bit in listening_engines for a push-to-talk command, which goes to Rhino alone
+#define PUSH_TO_TALK_LISTENER (1u << ENGINE_FANOUT_MAX_ENGINES)
+
+// --adaptive_endpoint_ms: once the level meter says the command is over, Rhino is handed the rest of its endpoint
+// duration as digital silence at once, rather than waiting it out in real time. Set by the inference thread for the
+// frame about to go to the engines.
+static bool is_endpoint_adaptive = false;
+static bool is_ending_command = false;
+static int16_t *silence_pcm = NULL;
+// enough to finalize on, whatever Rhino had heard of the silence already
+static int endpoint_flush_frames = 0;
+
+static void publishWakeWord(const void* data){
+    // the command that follows gets the CPUs at full speed
+    cpuFrequency_boost();
+    publishEvent("wake", "\"engine\":%d", *(const int*) data + 1);
 }
 
-int main(int argc, char *argv[]) {
-
-    configureI2C();
-    initializeStartRegisters();
-    configureAllPins();
-    int i2cFileDesc = initI2cBus(I2CDRV_LINUX_BUS1, I2C_DEVICE_ADDRESS);
-    exportYellowButton();
+static void printInference(const void* data){
+    const inferenceResult* result = data;
+    asyncLog_log(ASYNC_LOG_INFO, "%s", result->text);
+    publishEvent("intent", "\"engine\":%d,\"understood\":%s,\"intent\":\"%s\"", result->command.tank + 1,
+                 result->isUnderstood ? "true" : "false", result->intent);
+    if(result->isUnderstood){
+        scheduleFeed(&result->command);
+    }
+}
+
+// Picovoice calls back on the engine's thread; only the log thread ever waits on stdout.
+static void wake_word_callback(void) {
+    engine_outputs[current_engine].wake_word_us = latencyTrace_nowUs();
+    FEEDER_PROBE1(wake_word, current_engine);
+}
+
+// Formatted and parsed on the thread that heard it, printed and scheduled on the event loop.
+static void format_inference(const pv_inference_t *inference, int tank, inferenceResult *result) {
+    metrics_add(inference->is_understood ? understood_metric : not_understood_metric, 1);
+    stateSnapshot_count(inference->is_understood ? STATE_SNAPSHOT_UNDERSTOOD : STATE_SNAPSHOT_NOT_UNDERSTOOD);
+    *result = (inferenceResult) {inference->is_understood, {0, false, false, tank, SERVO_PORTION_DEFAULT}, "", ""};
+    size_t length = 0;
+    appendText(result, &length, "{\n");
+    if (engine_count > 1) {
+        appendText(result, &length, "    engine : %d,\n", tank + 1);
+    }
+    appendText(result, &length, "    is_understood : '%s',\n", (inference->is_understood ? "true" : "false"));
+    if (inference->is_understood) {
+        appendText(result, &length, "    intent : '%s',\n", inference->intent);
+        // context intents are identifiers, so they need no escaping in the event's JSON
+        snprintf(result->intent, sizeof(result->intent), "%s", inference->intent);
+        if (inference->num_slots > 0) {
+            appendText(result, &length, "    slots : {\n");
+            for (int32_t i = 0; i < inference->num_slots; i++) {
+                appendText(result, &length, "        '%s' : '%s',\n", inference->slots[i], inference->values[i]);
+            }
+            appendText(result, &length, "    }\n");
+        }
+        commandFromSlots(inference, &result->command);
+    }
+    appendText(result, &length, "}\n\n");
+}
+
+static void inference_callback(pv_inference_t *inference) {
+    engine_output_t *output = &engine_outputs[current_engine];
+    output->inference_us = latencyTrace_nowUs();
+    FEEDER_PROBE2(inference, current_engine, inference->is_understood);
+    // the post never blocks this thread
+    format_inference(inference, current_engine, &output->result);
+    engine.inferenceDelete(inference);
+    output->has_inference = true;
+}
+
+static bool is_capturing_commands = false;
+static bool is_archiving_audio = false;
+
+// The gate is held open, and the command's audio captured, from the first wake word until no engine is listening.
+// outcome names the capture that ends, if one does.
+static void set_listening(unsigned int listening, const char *outcome) {
+    if ((listening != 0) != (listening_engines != 0)) {
+        voiceGate_hold(listening != 0);
+        if (is_capturing_commands) {
+            if (listening != 0) {
+                commandCapture_begin();
+            } else {
+                commandCapture_end(outcome);
+            }
+        }
+    }
+    listening_engines = listening;
+}
+
+// standby commands given up on; inference thread only
+static long long commands_lost = 0;
+
+// On the inference thread, once every engine is done with the frame.
+static void publish_engine_outputs(void) {
+    unsigned int listening = listening_engines;
+    const char *outcome = NULL;
+    for (int i = 0; i < engine_count; i++) {
+        engine_output_t *output = &engine_outputs[i];
+        if (output->wake_word_us != 0) {
+            latencyTrace_markAt(LATENCY_TRACE_FRAME_CAPTURED, inferencePipeline_frameQueuedUs());
+            latencyTrace_markAt(LATENCY_TRACE_WAKE_WORD, output->wake_word_us);
+            metrics_add(wake_words_metric, 1);
+            stateSnapshot_count(STATE_SNAPSHOT_WAKE_WORDS);
+            listening |= 1u << i;
+            if (engine_count > 1) {
+                asyncLog_log(ASYNC_LOG_INFO, "[wake word, engine %d]", i + 1);
+            } else {
+                asyncLog_log(ASYNC_LOG_INFO, "[wake word]");
+            }
+            // only an overlay misses it if the loop is backed up
+            eventLoop_post(publishWakeWord, &i, sizeof(i));
+            output->wake_word_us = 0;
+        }
+        if (output->has_inference) {
+            latencyTrace_markAt(LATENCY_TRACE_INFERENCE, output->inference_us);
+            listening &= ~(1u << i);
+            outcome = output->result.isUnderstood ? "understood" : "not-understood";
+            if (!eventLoop_post(printInference, &output->result, sizeof(output->result))) {
+                asyncLog_log(ASYNC_LOG_WARN, "inference dropped, too many pending events");
+            }
+            output->has_inference = false;
+        }
+        if (output->is_lost) {
+            listening &= ~(1u << i);
+            outcome = "lost";
+            commands_lost++;
+            output->is_lost = false;
+        }
+    }
+    set_listening(listening, outcome);
+}
+
+// Overflow and silence warnings, raised on the recorder's worker thread.
+static void log_recorder_warning(const char *message, void *user_data) {
+    (void) user_data;
+    asyncLog_log(ASYNC_LOG_WARN, "Recorder: %s", message);
+}
+
+// the audio archive reads every recorder the supervisor builds
+static void attach_audio_archive(pv_recorder_t *rebuilt) {
+    audioArchive_attach(rebuilt);
+}
+
+static void detach_audio_archive(pv_recorder_t *stopping) {
+    (void) stopping;
+    audioArchive_detach();
+}
+
+// The capture stage, on the recorder's worker thread: hand the frame over and get back to the microphone.
+static void frame_callback(const int16_t *pcm, void *user_data) {
+    (void) user_data;
+    // the recorder's thread can change when the supervisor reopens the device
+    allocGuard_markHot("capture");
+    inferencePipeline_push(pcm);
+}
+
+// What pv_picovoice_init is given, kept so a reload builds the new instances from the same paths once the files
+// behind them have been replaced. Engine i gets keyword_paths[i] and context_paths[i].
+typedef struct {
+    const char *access_key;
+    const char *porcupine_model_path;
+    const char *keyword_paths[ENGINE_FANOUT_MAX_ENGINES];
+    float porcupine_sensitivity;
+    const char *rhino_model_path;
+    const char *context_paths[ENGINE_FANOUT_MAX_ENGINES];
+    float rhino_sensitivity;
+    float endpoint_duration_sec;
+    bool require_endpoint;
+} picovoice_params_t;
+
+static picovoice_params_t picovoice_params;
+
+typedef struct {
+    pv_picovoice_t *instances[ENGINE_FANOUT_MAX_ENGINES];
+    // in standby, in place of instances
+    pv_porcupine_t *wake_words[ENGINE_FANOUT_MAX_ENGINES];
+    // Rhino alone, with the first engine's context, for push to talk; in standby it comes from the pool instead
+    pv_rhino_t *push_to_talk;
+} picovoice_set_t;
+
+// The instances frames go through. Once the pipeline runs, only the inference thread changes it, between frames.
+static picovoice_set_t *active_set = NULL;
+// A reload hands its new set to the inference thread here, and gets the one it replaced back.
+static picovoice_set_t *pending_set = NULL;
+static picovoice_set_t *retired_set = NULL;
+// at most one reload at a time, and none before the pipeline has started or after it has stopped
+static bool is_reloading = false;
+static bool is_reload_open = false;
+
+#define reloadPollInMs 10
+
+static void destroy_picovoice_set(picovoice_set_t *set) {
+    for (int i = 0; i < ENGINE_FANOUT_MAX_ENGINES; i++) {
+        if (set->instances[i] != NULL) {
+            engine.destroy(set->instances[i]);
+        }
+        if (set->wake_words[i] != NULL) {
+            porcupine_engine.destroy(set->wake_words[i]);
+        }
+    }
+    if (set->push_to_talk != NULL) {
+        rhino_engine.destroy(set->push_to_talk);
+    }
+    free(set);
+}
+
+static pv_status_t create_picovoice_set(picovoice_set_t **set) {
+    picovoice_set_t *created = calloc(1, sizeof(*created));
+    if (created == NULL) {
+        return PV_STATUS_OUT_OF_MEMORY;
+    }
+    for (int i = 0; i < engine_count && is_standby; i++) {
+        pv_status_t status = porcupine_engine.init(
+                picovoice_params.access_key,
+                picovoice_params.porcupine_model_path,
+                1,
+                &picovoice_params.keyword_paths[i],
+                &picovoice_params.porcupine_sensitivity,
+                &created->wake_words[i]);
+        if (status != PV_STATUS_SUCCESS) {
+            destroy_picovoice_set(created);
+            return status;
+        }
+    }
+    for (int i = 0; i < engine_count && !is_standby; i++) {
+        pv_status_t status = engine.init(
+                picovoice_params.access_key,
+                picovoice_params.porcupine_model_path,
+                picovoice_params.keyword_paths[i],
+                picovoice_params.porcupine_sensitivity,
+                wake_word_callback,
+                picovoice_params.rhino_model_path,
+                picovoice_params.context_paths[i],
+                picovoice_params.rhino_sensitivity,
+                picovoice_params.endpoint_duration_sec,
+                picovoice_params.require_endpoint,
+                inference_callback,
+                &created->instances[i]);
+        if (status != PV_STATUS_SUCCESS) {
+            destroy_picovoice_set(created);
+            return status;
+        }
+    }
+    if (rhino_engine.library != NULL && !is_standby) {
+        pv_status_t status = rhino_engine.init(
+                picovoice_params.access_key,
+                picovoice_params.rhino_model_path,
+                picovoice_params.context_paths[0],
+                picovoice_params.rhino_sensitivity,
+                picovoice_params.endpoint_duration_sec,
+                picovoice_params.require_endpoint,
+                &created->push_to_talk);
+        if (status != PV_STATUS_SUCCESS) {
+            destroy_picovoice_set(created);
+            return status;
+        }
+    }
+    *set = created;
+    return PV_STATUS_SUCCESS;
+}
+
+// Builds the new instances at normal priority while the old ones keep listening, then waits for the inference thread
+// to swap them in between two frames and destroys the old ones.
+static void *reload_picovoice(void *arg) {
+    (void) arg;
+    const long long start_us = latencyTrace_nowUs();
+    picovoice_set_t *fresh = NULL;
+    pv_status_t status = create_picovoice_set(&fresh);
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Reload failed with '%s', keeping the current models",
+                engine.statusToString(status));
+    } else {
+        if (is_standby) {
+            // the Rhinos are rebuilt from the same files as the pool next needs them
+            rhinoPool_reload(picovoice_params.rhino_sensitivity);
+        }
+        __atomic_store_n(&pending_set, fresh, __ATOMIC_SEQ_CST);
+        picovoice_set_t *retired = NULL;
+        while ((retired = __atomic_exchange_n(&retired_set, NULL, __ATOMIC_ACQ_REL)) == NULL) {
+            // no frame is coming to take it once the pipeline has stopped
+            picovoice_set_t *expected = fresh;
+            if (!__atomic_load_n(&is_reload_open, __ATOMIC_SEQ_CST) &&
+                    __atomic_compare_exchange_n(&pending_set, &expected, NULL, false, __ATOMIC_SEQ_CST,
+                            __ATOMIC_SEQ_CST)) {
+                retired = fresh;
+                break;
+            }
+            sleepForMs(reloadPollInMs);
+        }
+        if (retired != fresh) {
+            metrics_add(reloads_metric, 1);
+            asyncLog_log(ASYNC_LOG_INFO, "Reloaded %d keyword and context %s in %lld ms", engine_count,
+                    engine_count > 1 ? "pairs" : "pair", (latencyTrace_nowUs() - start_us) / 1000);
+        }
+        destroy_picovoice_set(retired);
+    }
+    __atomic_store_n(&is_reloading, false, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+// Feed limits and the day's plan apply at once; servo profiles from the next feed, and the voice gate from the next
+// frame, since those read the config themselves. The sensitivities go into the instances about to be built.
+static void reload_settings(void) {
+    if (!feederConfig_reload()) {
+        return;
+    }
+    const feederConfig *config = feederConfig_get();
+    for (int mode = 0; mode < FEED_GUARD_MAX_MODES; mode++) {
+        if (config->hasFeedLimit[mode]) {
+            feedGuard_configure(mode, &config->feedLimits[mode]);
+        }
+    }
+    feedPlan_configure(&config->feedPlan);
+    if (config->porcupineSensitivity >= 0.f) {
+        picovoice_params.porcupine_sensitivity = config->porcupineSensitivity;
+    }
+    if (config->rhinoSensitivity >= 0.f) {
+        picovoice_params.rhino_sensitivity = config->rhinoSensitivity;
+    }
+}
+
+// On the event loop thread, for SIGHUP: the settings file, then the keyword and context.
+static void startReload() {
+    if (__atomic_exchange_n(&is_reloading, true, __ATOMIC_SEQ_CST)) {
+        asyncLog_log(ASYNC_LOG_WARN, "Reload already in progress");
+        return;
+    }
+    if (!__atomic_load_n(&is_reload_open, __ATOMIC_SEQ_CST)) {
+        asyncLog_log(ASYNC_LOG_WARN, "Not listening, reload ignored");
+        __atomic_store_n(&is_reloading, false, __ATOMIC_SEQ_CST);
+        return;
+    }
+    // reloading is off the audio path: it reads files and starts a thread
+    allocGuard_exempt(true);
+    reload_settings();
+    for (int i = 0; i < engine_count; i++) {
+        asyncLog_log(ASYNC_LOG_INFO, "Reloading %s and %s", picovoice_params.keyword_paths[i],
+                picovoice_params.context_paths[i]);
+    }
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    if (pthread_create(&thread, &attributes, reload_picovoice, NULL) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Unable to start the reload thread");
+        __atomic_store_n(&is_reloading, false, __ATOMIC_SEQ_CST);
+    } else {
+        threadCpu_setName(thread, "reload");
+    }
+    pthread_attr_destroy(&attributes);
+    allocGuard_exempt(false);
+}
+
+// Rhino's answer once it has finalized, as an inferenceResult for tank. Returns false, having said why, if it
+// couldn't be read.
+static bool take_rhino_inference(pv_rhino_t *rhino, int tank, inferenceResult *result) {
+    pv_inference_t inference = {false, "", 0, NULL, NULL};
+    pv_status_t status = rhino_engine.isUnderstood(rhino, &inference.is_understood);
+    if (status == PV_STATUS_SUCCESS && inference.is_understood) {
+        status = rhino_engine.getIntent(rhino, &inference.intent, &inference.num_slots, &inference.slots,
+                &inference.values);
+    }
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "'pv_rhino_get_intent' failed with '%s'", engine.statusToString(status));
+        return false;
+    }
+    format_inference(&inference, tank, result);
+    if (inference.is_understood) {
+        rhino_engine.freeSlotsAndValues(rhino, inference.slots, inference.values);
+    }
+    return true;
+}
+
+// What a standby engine heard after its wake word while its Rhino was being built, at most this much
+#define standbyBacklogInMs 3000
+
+// Each engine's standby state, on the engine's own thread, or the inference thread between frames.
+typedef struct {
+    // a wake word was heard and the pool asked for a Rhino, which hasn't been taken yet
+    bool is_waiting;
+    long long waiting_since_us;
+    // taken from the pool, until the command is over
+    pv_rhino_t *rhino;
+    int16_t *backlog;
+    int backlog_frames;
+} standby_engine_t;
+
+static standby_engine_t standby_engines[ENGINE_FANOUT_MAX_ENGINES];
+static int standby_backlog_capacity = 0;
+
+static void request_standby_rhino(int index) {
+    standby_engine_t *standby = &standby_engines[index];
+    standby->is_waiting = true;
+    standby->waiting_since_us = latencyTrace_nowUs();
+    standby->backlog_frames = 0;
+    rhinoPool_request(index);
+}
+
+// Drops the command under way, if any: a Rhino taken goes back to the pool, and one still coming lingers there.
+static void drop_standby_command(int index) {
+    standby_engine_t *standby = &standby_engines[index];
+    if (standby->rhino != NULL) {
+        rhinoPool_give(index, standby->rhino);
+        standby->rhino = NULL;
+    }
+    if (standby->is_waiting) {
+        rhinoPool_cancel(index);
+        standby->is_waiting = false;
+    }
+    standby->backlog_frames = 0;
+}
+
+// Returns whether the command is over: finalized, or given up on.
+static bool feed_standby_rhino(int index, const int16_t *pcm) {
+    standby_engine_t *standby = &standby_engines[index];
+    engine_output_t *output = &engine_outputs[index];
+    bool is_finalized = false;
+    pv_status_t status = rhino_engine.process(standby->rhino, pcm, &is_finalized);
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "'pv_rhino_process' failed with '%s'", engine.statusToString(status));
+        is_interrupted = true;
+        return false;
+    }
+    if (!is_finalized) {
+        return false;
+    }
+    output->inference_us = latencyTrace_nowUs();
+    if (take_rhino_inference(standby->rhino, index, &output->result)) {
+        FEEDER_PROBE2(inference, index, output->result.isUnderstood);
+        output->has_inference = true;
+    } else {
+        output->is_lost = true;
+    }
+    drop_standby_command(index);
+    return true;
+}
+
+// Takes the engine's Rhino if the pool has it ready, and catches it up on the backlog. Returns whether the frame
+// should go to it; a frame that comes before it is ready is kept in the backlog until there's no room left.
+static bool catch_up_standby_rhino(int index, const int16_t *pcm) {
+    standby_engine_t *standby = &standby_engines[index];
+    standby->rhino = rhinoPool_take(index);
+    if (standby->rhino == NULL) {
+        if (standby->backlog_frames == standby_backlog_capacity) {
+            asyncLog_log(ASYNC_LOG_WARN, "Rhino not ready after %d ms, command dropped", standbyBacklogInMs);
+            drop_standby_command(index);
+            engine_outputs[index].is_lost = true;
+        } else {
+            memcpy(standby->backlog + ((size_t) standby->backlog_frames * engine.frameLength), pcm,
+                    (size_t) engine.frameLength * sizeof(int16_t));
+            standby->backlog_frames++;
+        }
+        return false;
+    }
+    standby->is_waiting = false;
+    metrics_observe(rhino_ready_metric, (double) (latencyTrace_nowUs() - standby->waiting_since_us) / 1e6);
+    for (int i = 0; i < standby->backlog_frames; i++) {
+        // what's left after the endpoint would only have gone to Porcupine, and is dropped
+        if (feed_standby_rhino(index, standby->backlog + ((size_t) i * engine.frameLength))) {
+            return false;
+        }
+    }
+    standby->backlog_frames = 0;
+    return true;
+}
+
+// On engine index's thread: Porcupine until the wake word, then the Rhino the pool builds for it.
+static void run_standby_engine(int index, const int16_t *pcm) {
+    standby_engine_t *standby = &standby_engines[index];
+    if (standby->rhino == NULL && !standby->is_waiting) {
+        int32_t keyword_index = -1;
+        pv_status_t status = porcupine_engine.process(active_set->wake_words[index], pcm, &keyword_index);
+        if (status != PV_STATUS_SUCCESS) {
+            asyncLog_log(ASYNC_LOG_ERROR, "'pv_porcupine_process' failed with '%s'", engine.statusToString(status));
+            is_interrupted = true;
+        } else if (keyword_index >= 0) {
+            wake_word_callback();
+            request_standby_rhino(index);
+        }
+        return;
+    }
+    if (standby->is_waiting && !catch_up_standby_rhino(index, pcm)) {
+        return;
+    }
+    if (!feed_standby_rhino(index, pcm) && is_ending_command) {
+        for (int i = 0; i < endpoint_flush_frames && !is_interrupted && standby->rhino != NULL; i++) {
+            feed_standby_rhino(index, silence_pcm);
+        }
+    }
+}
+
+// In standby, the button starts a command for the first engine's tank as its wake word would, unless one is under
+// way already.
+static void start_standby_push_to_talk(void) {
+    if (standby_engines[0].is_waiting || standby_engines[0].rhino != NULL) {
+        return;
+    }
+    request_standby_rhino(0);
+    metrics_add(push_to_talk_metric, 1);
+    asyncLog_log(ASYNC_LOG_INFO, "[push to talk]");
+    set_listening(listening_engines | 1u, NULL);
+}
+
+// Between two frames, so no frame is split across instances and none is lost.
+static void swap_in_reloaded(void) {
+    picovoice_set_t *fresh = __atomic_exchange_n(&pending_set, NULL, __ATOMIC_ACQ_REL);
+    if (fresh == NULL) {
+        return;
+    }
+    picovoice_set_t *replaced = active_set;
+    active_set = fresh;
+    for (int i = 0; i < engine_count && is_standby; i++) {
+        drop_standby_command(i);
+    }
+    // a wake word the old instances heard has no command coming in the new ones
+    set_listening(0, "reloaded");
+    __atomic_store_n(&retired_set, replaced, __ATOMIC_RELEASE);
+}
+
+// On engine index's thread.
+static void run_engine(int index, const int16_t *pcm, void *user_data) {
+    (void) user_data;
+    current_engine = index;
+    if (is_standby) {
+        run_standby_engine(index, pcm);
+        return;
+    }
+
+    pv_status_t status = engine.process(active_set->instances[index], pcm);
+    const bool is_ending = is_ending_command && (listening_engines & (1u << index));
+    for (int i = 0; status == PV_STATUS_SUCCESS && is_ending && !engine_outputs[index].has_inference &&
+            i < endpoint_flush_frames; i++) {
+        status = engine.process(active_set->instances[index], silence_pcm);
+    }
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "'pv_picovoice_process' failed with '%s'", engine.statusToString(status));
+        is_interrupted = true;
+    }
+}
+
+static void run_picovoice(const int16_t *pcm, void *user_data) {
+    (void) user_data;
+    engineFanout_process(pcm);
+    publish_engine_outputs();
+}
+
+// a press nobody speaks after is given up on
+#define pushToTalkTimeoutInMs 8000
+
+static long long push_to_talk_started_us = 0;
+
+// The button was pressed: the next frames go straight to Rhino, with no wake word and no voice gate. A command an
+// engine was already listening for is dropped.
+static void start_push_to_talk(void) {
+    set_listening(0, "push-to-talk");
+    pv_status_t status = rhino_engine.reset(active_set->push_to_talk);
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "'pv_rhino_reset' failed with '%s'", engine.statusToString(status));
+        return;
+    }
+    push_to_talk_started_us = latencyTrace_nowUs();
+    metrics_add(push_to_talk_metric, 1);
+    asyncLog_log(ASYNC_LOG_INFO, "[push to talk]");
+    set_listening(PUSH_TO_TALK_LISTENER, NULL);
+}
+
+static void run_push_to_talk(const int16_t *pcm) {
+    pv_rhino_t *rhino = active_set->push_to_talk;
+    bool is_finalized = false;
+    pv_status_t status = rhino_engine.process(rhino, pcm, &is_finalized);
+    for (int i = 0; status == PV_STATUS_SUCCESS && is_ending_command && !is_finalized && i < endpoint_flush_frames;
+            i++) {
+        status = rhino_engine.process(rhino, silence_pcm, &is_finalized);
+    }
+    if (status != PV_STATUS_SUCCESS) {
+        asyncLog_log(ASYNC_LOG_ERROR, "'pv_rhino_process' failed with '%s'", engine.statusToString(status));
+        is_interrupted = true;
+        return;
+    }
+    if (!is_finalized) {
+        if (latencyTrace_nowUs() - push_to_talk_started_us > pushToTalkTimeoutInMs * 1000LL) {
+            asyncLog_log(ASYNC_LOG_INFO, "[push to talk timed out]");
+            set_listening(0, "timed-out");
+        }
+        return;
+    }
+
+    // for the first engine's tank, whose context it has
+    inferenceResult result;
+    if (!take_rhino_inference(rhino, 0, &result)) {
+        set_listening(0, "failed");
+        return;
+    }
+    if (!eventLoop_post(printInference, &result, sizeof(result))) {
+        asyncLog_log(ASYNC_LOG_WARN, "inference dropped, too many pending events");
+    }
+    set_listening(0, result.isUnderstood ? "understood" : "not-understood");
+}
+
+static bool is_voice_gated = false;
+// NULL unless --noise_suppression_db is set: the pump's hum and the filter's hiss come out before anything listens,
+// for half a frame of delay
+static pv_noise_suppressor_t *noise_suppressor = NULL;
+static int16_t *suppressed_pcm = NULL;
+// NULL unless --agc_target_dbfs is set: a board far from the speaker is turned up and one that nearly clips turned
+// down, so the engines hear every tank at about the same level
+static pv_gain_control_t *gain_control = NULL;
+// past this, a quiet board only brings up the pump
+#define AGC_MAX_GAIN_DB 24.f
+static int16_t *leveled_pcm = NULL;
+// the config the voice gate threshold was last taken from
+static unsigned int gate_config_generation = 0;
+
+// offload_server: the frames go to the server while it answers, and to the engines while it doesn't. Inference thread
+// only.
+static bool is_offloading = false;
+static bool is_offloaded = false;
+// the frame being processed, counting from 0
+static long long current_frame = -1;
+
+// Follows the link, and turns what the server heard into engine outputs, as if the engines had heard it. Returns
+// whether there is anything to publish.
+static bool take_remote_events(void) {
+    const bool is_link_up = remoteInference_poll(latencyTrace_nowUs());
+    bool is_changed = false;
+    if (is_offloaded && !is_link_up) {
+        // the server's half of a command is lost; the engines listen from the next frame
+        for (int i = 0; i < engine_count; i++) {
+            if (listening_engines & (1u << i)) {
+                engine_outputs[i].is_lost = true;
+                is_changed = true;
+            }
+        }
+        is_offloaded = false;
+    } else if (!is_offloaded && is_link_up && listening_engines == 0) {
+        // a command the engines are listening for is heard out first
+        is_offloaded = true;
+    }
+
+    remoteInference_event event;
+    while (remoteInference_nextEvent(&event)) {
+        if (!is_offloaded) {
+            // answers to frames sent before falling back
+            continue;
+        }
+        engine_output_t *output = &engine_outputs[event.engine];
+        if (event.kind == REMOTE_INFERENCE_WAKE) {
+            output->wake_word_us = latencyTrace_nowUs();
+        } else {
+            const char *slots[REMOTE_INFERENCE_MAX_SLOTS];
+            const char *values[REMOTE_INFERENCE_MAX_SLOTS];
+            for (int i = 0; i < event.slotCount; i++) {
+                slots[i] = event.slots[i];
+                values[i] = event.values[i];
+            }
+            pv_inference_t inference = {event.isUnderstood, event.intent, event.slotCount, slots, values};
+            output->inference_us = latencyTrace_nowUs();
+            format_inference(&inference, event.engine, &output->result);
+            output->has_inference = true;
+        }
+        is_changed = true;
+    }
+    return is_changed;
+}
+
+static void queue_remote_frame(const int16_t *pcm, void *user_data) {
+    (void) user_data;
+    remoteInference_queue(pcm);
+}
+
+// What the voice gate lets through goes to the server, numbered and timed from the frame being processed.
+static void offload_frame(const int16_t *pcm) {
+    if (is_voice_gated) {
+        voiceGate_process(pcm, queue_remote_frame, NULL);
+    } else {
+        remoteInference_queue(pcm);
+    }
+    remoteInference_send(current_frame, inferencePipeline_frameQueuedUs());
+}
+
+// Everything the frame goes through on its way to the engines.
+static void listen_to_frame(const int16_t *pcm, void *user_data) {
+    if (noise_suppressor) {
+        pv_noise_suppressor_process(noise_suppressor, pcm, suppressed_pcm);
+        pcm = suppressed_pcm;
+    }
+    if (gain_control) {
+        pv_gain_control_process(gain_control, pcm, engine.frameLength, leveled_pcm);
+        pcm = leveled_pcm;
+        metrics_set(agc_gain_metric, pv_gain_control_get_gain_db(gain_control));
+    }
+    if (is_capturing_commands) {
+        // every frame, so the pre-roll is there whether or not the voice gate lets it through
+        commandCapture_push(pcm);
+    }
+    if (is_endpoint_adaptive) {
+        is_ending_command = endpointTracker_process(pcm, listening_engines != 0);
+        if (is_ending_command) {
+            metrics_add(early_endpoint_metric, 1);
+        }
+    }
+    if (listening_engines & PUSH_TO_TALK_LISTENER) {
+        run_push_to_talk(pcm);
+    } else if (is_offloaded) {
+        offload_frame(pcm);
+    } else if (is_voice_gated) {
+        voiceGate_process(pcm, run_picovoice, user_data);
+    } else {
+        run_picovoice(pcm, user_data);
+    }
+}
+
+// The inference stage, on the pipeline's own thread.
+static void process_frame(const int16_t *pcm, void *user_data) {
+    const long long start_us = latencyTrace_nowUs();
+    FEEDER_PROBE1(process_begin, start_us);
+    swap_in_reloaded();
+    if (__atomic_exchange_n(&isPushToTalkPressed, false, __ATOMIC_ACQ_REL)) {
+        if (is_standby) {
+            start_standby_push_to_talk();
+        } else if (active_set->push_to_talk != NULL) {
+            start_push_to_talk();
+        }
+    }
+    const feederConfig *config = feederConfig_get();
+    if (is_voice_gated && config->generation != gate_config_generation) {
+        gate_config_generation = config->generation;
+        if (config->vadThresholdDb > 0.f) {
+            voiceGate_setThresholdDb(config->vadThresholdDb);
+        }
+    }
+    current_frame++;
+    // every frame, so the link is followed while the actuators run too
+    if (is_offloading && take_remote_events()) {
+        publish_engine_outputs();
+    }
+    // for the camera's feed clips, whether or not anyone is speaking, and as the room sounds
+    const long long queued_us = inferencePipeline_frameQueuedUs();
+    audioTap_send(pcm, queued_us);
+    // the servo and the hopper would only ever wake Porcupine falsely, so while they move the frame is dropped here,
+    // the recorder still being drained; a command already under way is heard out
+    const long long frame_us = (long long) engine.frameLength * 1000000 / engine.sampleRate;
+    if (listening_engines == 0 && actuatorGate_isBusy(queued_us - frame_us, queued_us)) {
+        metrics_add(actuator_skipped_metric, 1);
+    } else {
+        listen_to_frame(pcm, user_data);
+    }
+    const long long elapsed_us = latencyTrace_nowUs() - start_us;
+    metrics_observe(frame_time_metric, (double) elapsed_us / 1e6);
+    // config is not used past here
+    feederConfig_quiescent();
+    FEEDER_PROBE1(process_end, elapsed_us);
+}
+
+// Startup runs as three strands joined once before listening: the hardware (pins, I2C, display, servo, button, feed
+// timers) on a thread of its own, the models on another, and the audio device on the main thread.
+static long long startup_us = 0;
+
+typedef struct {
+    pv_status_t status;
+    long long done_us;
+} model_load_t;
+
+static void *load_models(void *arg) {
+    model_load_t *load = arg;
+    load->status = create_picovoice_set(&active_set);
+    load->done_us = latencyTrace_nowUs();
+    return NULL;
+}
+
+static void hardware_startSetup(void);
+static bool hardware_join(long long *done_us);
+
+static void register_metrics(void) {
+    static const double frame_time_bounds[] = {0.001, 0.002, 0.005, 0.01, 0.015, 0.02, 0.025, 0.032, 0.05, 0.1};
+    wake_words_metric = metrics_addCounter("feeder_wake_words_total", "Wake words detected.");
+    understood_metric = metrics_addCounter("feeder_inferences_total{understood=\"true\"}",
+            "Commands after a wake word, by whether Rhino understood them.");
+    not_understood_metric = metrics_addCounter("feeder_inferences_total{understood=\"false\"}", "");
+    for (int i = 0; i < FEED_MODES; i++) {
+        char name[48];
+        snprintf(name, sizeof(name), "feeder_feeds_total{mode=\"%d\"}", i);
+        feeds_metric[i] = metrics_addCounter(name, "Feeds started, by mode.");
+    }
+    overflow_metric = metrics_addCounter("feeder_audio_overflow_samples_total",
+            "Samples lost because the recorder's ring overflowed.");
+    dropped_metric = metrics_addCounter("feeder_frames_dropped_total",
+            "Frames dropped because the inference queue was full.");
+    queue_depth_metric = metrics_addGauge("feeder_inference_queue_depth", "Frames waiting for the inference stage.");
+    frame_time_metric = metrics_addHistogram("feeder_frame_process_seconds",
+            "Time the inference stage spends on a frame.", frame_time_bounds,
+            (int) (sizeof(frame_time_bounds) / sizeof(frame_time_bounds[0])));
+    actuator_skipped_metric = metrics_addCounter("feeder_actuator_frames_skipped_total",
+            "Frames not listened to because the servo or hopper was moving.");
+    push_to_talk_metric = metrics_addCounter("feeder_push_to_talk_total",
+            "Button presses that sent the next command straight to Rhino.");
+    reloads_metric = metrics_addCounter("feeder_model_reloads_total", "Keyword and context reloads swapped in.");
+    resident_metric = metrics_addGauge("feeder_resident_bytes", "Resident memory of the whole process.");
+    startup_metric = metrics_addGauge("feeder_time_to_listening_seconds",
+            "Time from the start of main to the first frame being listened for.");
+    for (int i = 0; i < CPU_SUBSYSTEMS; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "feeder_cpu_percent{subsystem=\"%s\"}", cpu_subsystems[i]);
+        cpu_metric[i] = metrics_addGauge(name, "CPU used since the previous scrape, in percent of one core.");
+    }
+}
+
+// On the metrics thread, or before it starts; the first call only takes the baseline.
+static void collect_cpu(void) {
+    threadCpu_sample();
+    long long ns[CPU_SUBSYSTEMS];
+    ns[0] = threadCpu_ns("pvrec-");
+    // in standby, building and destroying Rhino is part of inference
+    ns[1] = threadCpu_ns("inference") + threadCpu_ns("engine-") + threadCpu_ns("rhino-pool");
+    ns[3] = eventLoop_subsystemCpuNs("servo");
+    ns[4] = eventLoop_subsystemCpuNs("sensors");
+    ns[5] = eventLoop_subsystemCpuNs("feeds");
+    ns[6] = eventLoop_subsystemCpuNs("control");
+    const long long display_ns = eventLoop_subsystemCpuNs("display");
+    ns[7] = threadCpu_ns("events") - display_ns - ns[3] - ns[4] - ns[5] - ns[6];
+    // the matrix's writes go out on the bus thread
+    ns[2] = display_ns + threadCpu_ns("i2c");
+    struct timespec process;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &process);
+    ns[8] = process.tv_sec * 1000000000LL + process.tv_nsec;
+    for (int i = 0; i < CPU_SUBSYSTEMS - 1; i++) {
+        ns[8] -= ns[i];
+    }
+
+    const long long now_us = latencyTrace_nowUs();
+    for (int i = 0; i < CPU_SUBSYSTEMS; i++) {
+        if (cpu_last_us > 0 && now_us > cpu_last_us) {
+            // the thread times move in clock ticks, and an exited thread takes its time away, so a share can dip
+            const long long used_ns = ns[i] > cpu_last_ns[i] ? ns[i] - cpu_last_ns[i] : 0;
+            metrics_set(cpu_metric[i], 100. * (double) used_ns / ((double) (now_us - cpu_last_us) * 1000.));
+        }
+        cpu_last_ns[i] = ns[i];
+    }
+    cpu_last_us = now_us;
+}
+
+static void collect_metrics(void) {
+    pv_recorder_stats_t recorder_stats;
+    // NULL, and no stats, while the supervisor is reopening the device
+    pv_recorder_t *recorder = audioSupervisor_lock();
+    if (pv_recorder_get_stats(recorder, &recorder_stats) == PV_RECORDER_STATUS_SUCCESS) {
+        metrics_store(overflow_metric, (long long) recorder_stats.overflow_samples);
+    }
+    audioSupervisor_unlock();
+    inferencePipeline_stats pipeline_stats;
+    inferencePipeline_getStats(&pipeline_stats);
+    metrics_store(dropped_metric, pipeline_stats.droppedFrames);
+    metrics_set(queue_depth_metric, pipeline_stats.queueDepth);
+    metrics_set(resident_metric, (double) memoryBudget_residentBytes());
+    if (is_camera_governed) {
+        cameraGovernor_stats governor_stats;
+        cameraGovernor_getStats(&governor_stats);
+        metrics_set(camera_level_metric, governor_stats.level);
+    }
+    if (is_standby) {
+        rhinoPool_stats pool_stats;
+        rhinoPool_getStats(&pool_stats);
+        metrics_set(rhino_instances_metric, pool_stats.resident);
+    }
+    collect_cpu();
+}
+
+// The watchdog is only petted while the audio comes back within a minute, the event loop turns, and frames either get
+// through the inference stage or aren't waiting for it.
+typedef struct {
+    long long eventLoopBeats;
+    long long eventLoopBeatUs;
+    long long processedFrames;
+    long long processedUs;
+} daemon_progress;
+
+static bool is_daemon_healthy(daemon_progress *progress, long long now_us) {
+    const long long beats = __atomic_load_n(&eventLoopBeats, __ATOMIC_RELAXED);
+    if (beats != progress->eventLoopBeats) {
+        progress->eventLoopBeats = beats;
+        progress->eventLoopBeatUs = now_us;
+    }
+    inferencePipeline_stats stats;
+    inferencePipeline_getStats(&stats);
+    if (stats.processedFrames != progress->processedFrames || stats.queueDepth == 0) {
+        progress->processedFrames = stats.processedFrames;
+        progress->processedUs = now_us;
+    }
+    return audioSupervisor_isHealthy(60 * 1000) && now_us - progress->eventLoopBeatUs < 5 * 1000 * 1000 &&
+            now_us - progress->processedUs < 5 * 1000 * 1000;
+}
+
+static void set_sim_button(int level) {
+    halGpio_simSet(feederConfig_startup()->buttonGpio, level);
+}
+
+// A --sim_script replay. The event loop's virtual clock follows the audio the pipeline has processed, so timers, presses
+// and feeds land at the same point in the recording however fast the host is. Runs until the file has been processed,
+// then lets the clock run on for the script's settle time. Returns whether the feeds were the ones expected.
+static bool run_script(pv_recorder_t *recorder, int32_t frame_length, int32_t sample_rate) {
+    const long long started_us = latencyTrace_nowUs();
+    long long audio_ms = 0;
+    long long last_captured = -1;
+    long long unchanged_since_us = started_us;
+    while (!is_interrupted) {
+        inferencePipeline_stats stats;
+        inferencePipeline_getStats(&stats);
+        audio_ms = stats.processedFrames * frame_length * 1000 / sample_rate;
+        if (!simScript_runTo(audio_ms, set_sim_button)) {
+            return false;
+        }
+        // the recorder's worker may still hold the last frames for a moment after the file has been read
+        const long long now_us = latencyTrace_nowUs();
+        if (stats.capturedFrames != last_captured || stats.processedFrames != stats.capturedFrames) {
+            last_captured = stats.capturedFrames;
+            unchanged_since_us = now_us;
+        } else if (pv_recorder_is_at_end(recorder) && now_us - unchanged_since_us > 100 * 1000) {
+            break;
+        }
+        sleepForMs(1);
+    }
+    if (!simScript_runTo(audio_ms + simScript_settleMs(), set_sim_button)) {
+        return false;
+    }
+    const double run_sec = (double) (latencyTrace_nowUs() - started_us) / 1e6;
+    fprintf(stdout, "sim : %.1f s of audio in %.2f s, %.1fx real time\n", audio_ms / 1000.0, run_sec,
+            (run_sec > 0.0) ? (audio_ms / 1000.0) / run_sec : 0.0);
+    return simScript_check();
+}
+
+// whole frames, rounded up
+static int frames_for_ms(int32_t ms, int32_t frame_length, int32_t sample_rate) {
+    const long long samples = ((long long) ms * sample_rate) / 1000;
+    return (int) ((samples + frame_length - 1) / frame_length);
+}
+
+// Prints e.g. "Inference thread: SCHED_FIFO priority 50, CPU 1". Returns false if that isn't what was asked for.
+static bool report_scheduling(const char *thread, int32_t priority, int32_t cpu, int32_t requested_priority,
+        int32_t requested_cpu) {
+    if (priority > 0) {
+        fprintf(stdout, "%s thread: SCHED_FIFO priority %d", thread, priority);
+    } else {
+        fprintf(stdout, "%s thread: normal priority", thread);
+    }
+    if (cpu >= 0) {
+        fprintf(stdout, ", CPU %d\n", cpu);
+    } else {
+        fprintf(stdout, ", any CPU\n");
+    }
+    return (priority == requested_priority) && (cpu == requested_cpu);
+}
+
+int picovoice_main(int argc, char *argv[]) {
+
+    signal(SIGINT, interrupt_handler);
+    // the settings file gives the defaults, and the options override them
+    const feederConfig *config = feederConfig_startup();
+    const char *library_path = config->libraryPath[0] ? config->libraryPath : NULL;
+#if defined(PICOVOICE_FEEDER_LIBRARY_PATH)
+    // picovoice_feeder has the library's install path built in
+    if (!library_path) {
+        library_path = PICOVOICE_FEEDER_LIBRARY_PATH;
+    }
+#endif
+    // the button is the mode switch unless this is given, and push to talk if it is
+    const char *rhino_library_path = config->rhinoLibraryPath[0] ? config->rhinoLibraryPath : NULL;
+    // --standby listens with this alone, and builds Rhino from rhino_library_path after the wake word
+    const char *porcupine_library_path = NULL;
+    // a Rhino handed back is kept this long for the next command, or for good with --rhino_warm
+    bool is_rhino_warm = false;
+    float rhino_linger_sec = 10.f;
+    // 0 leaves the endpoint to Rhino alone
+    int32_t adaptive_endpoint_ms = 0;
+    int32_t camera_budget_ms = 0;
+    const char *camera_cgroup = NULL;
+    const char *access_key = config->accessKey[0] ? config->accessKey : NULL;
+    // one engine per -k and -c pair; any -k or -c replaces the file's list
+    const char *keyword_paths[ENGINE_FANOUT_MAX_ENGINES] = {NULL};
+    const char *context_paths[ENGINE_FANOUT_MAX_ENGINES] = {NULL};
+    int keyword_count = config->keywordCount;
+    int context_count = config->contextCount;
+    for (int i = 0; i < ENGINE_FANOUT_MAX_ENGINES; i++) {
+        keyword_paths[i] = (i < keyword_count) ? config->keywordPaths[i] : NULL;
+        context_paths[i] = (i < context_count) ? config->contextPaths[i] : NULL;
+    }
+    bool is_keyword_list_from_config = true;
+    bool is_context_list_from_config = true;
+    float porcupine_sensitivity = (config->porcupineSensitivity >= 0.f) ? config->porcupineSensitivity : 0.5f;
+    const char *porcupine_model_path = config->porcupineModelPath[0] ? config->porcupineModelPath : NULL;
+    float rhino_sensitivity = (config->rhinoSensitivity >= 0.f) ? config->rhinoSensitivity : 0.5f;
+    const char *rhino_model_path = config->rhinoModelPath[0] ? config->rhinoModelPath : NULL;
+    float endpoint_duration_sec = 1.f;
+    bool require_endpoint = true;
+    int32_t device_index = -1;
+    const char *device_name = NULL;
+    const char *alsa_device = NULL;
+    const char *serial_device = NULL;
+    int32_t serial_baud_rate = 921600;
+    const char *audio_file = NULL;
+    float audio_speed = 1.f;
+    const char *sim_script = NULL;
+    // -1 unless --alloc_guard is given, else whether it traps
+    int alloc_guard_trapping = -1;
+    int32_t sample_rate = 16000;
+    int32_t channels = 1;
+    int32_t audio_priority = 0;
+    int32_t audio_cpu = -1;
+    pv_recorder_latency_profile_t audio_latency = PV_RECORDER_LATENCY_PROFILE_DEFAULT;
+    bool lock_memory = false;
+    // 0 dB leaves the voice gate out and every frame goes through pv_picovoice_process
+    float vad_threshold_db = (config->vadThresholdDb >= 0.f) ? config->vadThresholdDb : 0.f;
+    int32_t vad_hangover_ms = 600;
+    int32_t vad_pre_roll_ms = 320;
+    // 0 leaves the noise suppressor out
+    float noise_suppression_db = (config->noiseSuppressionDb >= 0.f) ? config->noiseSuppressionDb : 0.f;
+    // 0 leaves the gain control out
+    float agc_target_dbfs = config->agcTargetDbfs;
+    // 0 turns the metrics endpoint off
+    int metrics_port = METRICS_DEFAULT_PORT;
+    // no directory, no command captures
+    const char *capture_dir = NULL;
+    // no directory, no continuous recording
+    const char *audio_archive_dir = NULL;
+    asyncLog_sink log_sink = ASYNC_LOG_SINK_STDOUT;
+    const char *log_file = NULL;
+    asyncLog_level log_level = ASYNC_LOG_INFO;
+    int32_t capture_pre_roll_ms = COMMAND_CAPTURE_DEFAULT_PRE_ROLL_MS;
+    long long capture_quota_mb = COMMAND_CAPTURE_DEFAULT_QUOTA_BYTES / (1024 * 1024);
+    // no device, no watchdog
+    const char *watchdog_device = NULL;
+    for (int mode = 0; mode < FEED_GUARD_MAX_MODES; mode++) {
+        if (config->hasFeedLimit[mode]) {
+            feedGuard_configure(mode, &config->feedLimits[mode]);
+        }
+    }
+
+    int c;
+    while ((c = getopt_long(argc, argv, "de:l:y:a:k:c:s:p:t:r:i:n:u:A:S:B:R:C:P:U:Y:MV:H:O:N:L:T:m:w:W:Q:g:Gv:f:F:D:XI:E:Z:K:j:oJx:b:q:z:h:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'd':
+                show_audio_devices();
+                return 0;
+            case 'l':
+                library_path = optarg;
+                break;
+            case 'y':
+                rhino_library_path = optarg;
+                break;
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'k':
+                if (is_keyword_list_from_config) {
+                    is_keyword_list_from_config = false;
+                    keyword_count = 0;
+                }
+                if (keyword_count == ENGINE_FANOUT_MAX_ENGINES) {
+                    fprintf(stderr, "At most %d keyword paths\n", ENGINE_FANOUT_MAX_ENGINES);
+                    exit(1);
+                }
+                keyword_paths[keyword_count++] = optarg;
+                break;
+            case 'c':
+                if (is_context_list_from_config) {
+                    is_context_list_from_config = false;
+                    context_count = 0;
+                }
+                if (context_count == ENGINE_FANOUT_MAX_ENGINES) {
+                    fprintf(stderr, "At most %d context paths\n", ENGINE_FANOUT_MAX_ENGINES);
+                    exit(1);
+                }
+                context_paths[context_count++] = optarg;
+                break;
+            case 's':
+                porcupine_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'p':
+                porcupine_model_path = optarg;
+                break;
+            case 't':
+                rhino_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'r':
+                rhino_model_path = optarg;
+                break;
+            case 'u':
+                endpoint_duration_sec = strtof(optarg, NULL);
+                break;
+            case 'e':
+                if (strcmp(optarg, "false") == 0) {
+                    require_endpoint = false;
+                }
+                break;
+            case 'i':
+                device_index = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'n':
+                device_name = optarg;
+                break;
+            case 'A':
+                alsa_device = optarg;
+                break;
+            case 'S':
+                serial_device = optarg;
+                break;
+            case 'B':
+                serial_baud_rate = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'R':
+                sample_rate = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'C':
+                channels = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'P':
+                audio_priority = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'U':
+                audio_cpu = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'Y':
+                if (strcmp(optarg, "low") == 0) {
+                    audio_latency = PV_RECORDER_LATENCY_PROFILE_LOW_LATENCY;
+                } else if (strcmp(optarg, "balanced") == 0) {
+                    audio_latency = PV_RECORDER_LATENCY_PROFILE_BALANCED;
+                } else if (strcmp(optarg, "power_save") == 0) {
+                    audio_latency = PV_RECORDER_LATENCY_PROFILE_POWER_SAVE;
+                } else {
+                    print_usage(argv[0]);
+                    exit(1);
+                }
+                break;
+            case 'M':
+                lock_memory = true;
+                break;
+            case 'V':
+                vad_threshold_db = strtof(optarg, NULL);
+                break;
+            case 'H':
+                vad_hangover_ms = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'O':
+                vad_pre_roll_ms = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'N':
+                noise_suppression_db = strtof(optarg, NULL);
+                break;
+            case 'L':
+                agc_target_dbfs = strtof(optarg, NULL);
+                break;
+            case 'T':
+                tracePath = optarg;
+                break;
+            case 'm':
+                metrics_port = (int) strtol(optarg, NULL, 10);
+                break;
+            case 'w':
+                capture_dir = optarg;
+                break;
+            case 'W':
+                capture_pre_roll_ms = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'Q':
+                capture_quota_mb = strtoll(optarg, NULL, 10);
+                break;
+            case 'g':
+                log_sink = ASYNC_LOG_SINK_FILE;
+                log_file = optarg;
+                break;
+            case 'G':
+                log_sink = ASYNC_LOG_SINK_SYSLOG;
+                break;
+            case 'v':
+                if (strcmp(optarg, "debug") == 0) {
+                    log_level = ASYNC_LOG_DEBUG;
+                } else if (strcmp(optarg, "warn") == 0) {
+                    log_level = ASYNC_LOG_WARN;
+                } else if (strcmp(optarg, "error") == 0) {
+                    log_level = ASYNC_LOG_ERROR;
+                } else {
+                    log_level = ASYNC_LOG_INFO;
+                }
+                break;
+            case 'f': {
+                // e.g. "2:1:1:60", at most one long feed an hour and none within a minute of the last
+                int feed_mode = -1;
+                feedGuard_limit limit = {0, 0, 0};
+                int dedup_sec = -1;
+                if (sscanf(optarg, "%d:%lf:%d:%d", &feed_mode, &limit.feedsPerHour, &limit.burst, &dedup_sec) != 4) {
+                    dedup_sec = -1;
+                }
+                limit.dedupMs = dedup_sec * 1000;
+                if (!feedGuard_configure(feed_mode, &limit)) {
+                    fprintf(stderr, "Invalid feed limit '%s', expected MODE:FEEDS_PER_HOUR:BURST:DEDUP_SEC\n", optarg);
+                    exit(1);
+                }
+                break;
+            }
+            case 'F':
+                // loaded by main, before the hardware strand started
+                break;
+            case 'D':
+                watchdog_device = optarg;
+                break;
+            case 'X':
+                // set by main, before the hardware strand started
+                break;
+            case 'I':
+                audio_file = optarg;
+                break;
+            case 'E':
+                audio_speed = strtof(optarg, NULL);
+                if (audio_speed < 0.f) {
+                    fprintf(stderr, "Invalid audio speed '%s', expected a multiple of real time, or 0\n", optarg);
+                    exit(1);
+                }
+                break;
+            case 'Z':
+                sim_script = optarg;
+                break;
+            case 'K':
+                if (!allocGuard_isBuiltIn()) {
+                    fprintf(stderr, "--alloc_guard needs a build configured with -DPICOVOICE_ALLOC_GUARD=ON\n");
+                    exit(1);
+                }
+                if (strcmp(optarg, "count") == 0) {
+                    alloc_guard_trapping = 0;
+                } else if (strcmp(optarg, "trap") == 0) {
+                    alloc_guard_trapping = 1;
+                } else {
+                    fprintf(stderr, "Invalid alloc guard '%s', expected count or trap\n", optarg);
+                    exit(1);
+                }
+                break;
+            case 'j':
+                porcupine_library_path = optarg;
+                break;
+            case 'o':
+                is_standby = true;
+                break;
+            case 'J':
+                is_rhino_warm = true;
+                break;
+            case 'x':
+                rhino_linger_sec = strtof(optarg, NULL);
+                break;
+            case 'b':
+                adaptive_endpoint_ms = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'q':
+                camera_budget_ms = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'z':
+                camera_cgroup = optarg;
+                break;
+            case 'h':
+                audio_archive_dir = optarg;
+                break;
+            case HANDOVER_OPTION:
+                // main looked for it
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+
+    // built-in models stand in for any not given, so a daemon built with them needs only the library and key
+    if (embeddedModels_isBuiltIn() && (keyword_count == 0 || context_count == 0 || !porcupine_model_path ||
+            !rhino_model_path)) {
+        embeddedModels_paths embedded;
+        if (!embeddedModels_open(&embedded)) {
+            exit(1);
+        }
+        if (keyword_count == 0 && context_count == 0) {
+            keyword_paths[keyword_count++] = embedded.keywordPath;
+            context_paths[context_count++] = embedded.contextPath;
+        }
+        porcupine_model_path = porcupine_model_path ? porcupine_model_path : embedded.porcupineModelPath;
+        rhino_model_path = rhino_model_path ? rhino_model_path : embedded.rhinoModelPath;
+    }
+    if ((!library_path && !is_standby) || keyword_count == 0 || context_count == 0 || !access_key ||
+            !porcupine_model_path || !rhino_model_path) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+    if (is_standby && (!porcupine_library_path || !rhino_library_path)) {
+        fprintf(stderr, "--standby runs Porcupine and Rhino on their own, and needs --porcupine_library_path and "
+                "--rhino_library_path\n");
+        exit(1);
+    }
+    if (sim_script) {
+        if (!audio_file) {
+            fprintf(stderr, "A sim script replays --audio_file, and none was given\n");
+            exit(1);
+        }
+        if (!simScript_load(sim_script)) {
+            exit(1);
+        }
+        // as fast as the pipeline goes, and nothing lost when it falls behind: the clock waits for it instead
+        is_replaying_script = true;
+        audio_speed = 0.f;
+        inferencePipeline_setLossless(true);
+    }
+    if (keyword_count != context_count) {
+        fprintf(stderr, "Each keyword path needs a context path, got %d and %d\n", keyword_count, context_count);
+        exit(1);
+    }
+    engine_count = keyword_count;
+    // the libraries and models are read from the card while the log, the device and the engine's library come up
+    const char *prefetch_paths[5 + (2 * ENGINE_FANOUT_MAX_ENGINES)] = {
+            porcupine_model_path, rhino_model_path, is_standby ? NULL : library_path, rhino_library_path,
+            is_standby ? porcupine_library_path : NULL};
+    for (int i = 0; i < engine_count; i++) {
+        prefetch_paths[5 + (2 * i)] = keyword_paths[i];
+        prefetch_paths[6 + (2 * i)] = context_paths[i];
+    }
+    modelPrefetch_start(prefetch_paths, 5 + (2 * engine_count));
+    // from here on the audio, inference and hardware threads log through a ring, and only the log thread writes
+    if (!asyncLog_start(log_sink, (log_sink == ASYNC_LOG_SINK_SYSLOG) ? "feeder" : log_file, log_level)) {
+        exit(1);
+    }
+
+    if (is_standby) {
+        if (!pvEngine_loadPorcupine(porcupine_library_path, &porcupine_engine)) {
+            exit(1);
+        }
+        engine.statusToString = porcupine_engine.statusToString;
+        engine.sampleRate = porcupine_engine.sampleRate;
+        engine.frameLength = porcupine_engine.frameLength;
+        engine.version = porcupine_engine.version;
+    } else if (!pvEngine_load(library_path, &engine)) {
+        exit(1);
+    }
+    if (rhino_library_path) {
+        if (!pvEngine_loadRhino(rhino_library_path, &rhino_engine)) {
+            exit(1);
+        }
+        if (rhino_engine.frameLength != engine.frameLength) {
+            fprintf(stderr, "Rhino takes %d-sample frames and %s %d; push to talk and standby need them the same.\n",
+                    rhino_engine.frameLength, is_standby ? "Porcupine" : "Picovoice", engine.frameLength);
+            exit(1);
+        }
+    }
+
+    fprintf(stdout, "%s\n", access_key);
+    fprintf(stdout, "%s\n", is_standby ? porcupine_library_path : library_path);
+    for (int i = 0; i < engine_count; i++) {
+        fprintf(stdout, "%s\n", keyword_paths[i]);
+        fprintf(stdout, "%s\n", context_paths[i]);
+    }
+    fprintf(stdout, "%s\n", access_key);
+
+    picovoice_params.access_key = access_key;
+    picovoice_params.porcupine_model_path = porcupine_model_path;
+    picovoice_params.porcupine_sensitivity = porcupine_sensitivity;
+    picovoice_params.rhino_model_path = rhino_model_path;
+    picovoice_params.rhino_sensitivity = rhino_sensitivity;
+    picovoice_params.endpoint_duration_sec = endpoint_duration_sec;
+    picovoice_params.require_endpoint = require_endpoint;
+    for (int i = 0; i < engine_count; i++) {
+        picovoice_params.keyword_paths[i] = keyword_paths[i];
+        picovoice_params.context_paths[i] = context_paths[i];
+    }
+    // the frame length is known from the library alone, so the device opens while the models load; taking over, the
+    // old feeder keeps the device until they have
+    model_load_t model_load = {PV_STATUS_SUCCESS, 0};
+    pthread_t model_thread;
+    const bool is_loading_in_background = !is_taking_over &&
+            (pthread_create(&model_thread, NULL, load_models, &model_load) == 0);
+    if (is_loading_in_background) {
+        threadCpu_setName(model_thread, "model-load");
+    } else {
+        load_models(&model_load);
+    }
+
+    // the old feeder listens and feeds until now, and is gone once the wait is over
+    long long handover_us = 0;
+    if (is_taking_over) {
+        handover_us = latencyTrace_nowUs();
+        if (handover_request(HANDOVER_DEFAULT_PATH, &handed)) {
+            mode = handed.mode;
+            is_handed_over = true;
+            if (!handover_waitForExit()) {
+                fprintf(stderr, "Handover: the old feeder hasn't exited, going on regardless\n");
+            }
+        }
+        hardware_startSetup();
+    }
+
+    const int32_t frame_length = engine.frameLength;
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_config_t recorder_config = pv_recorder_default_config(frame_length);
+    recorder_config.device_index = device_index;
+    // a name from --show_audio_devices still finds the USB microphone after it moves ports, and follows it through a
+    // replug
+    recorder_config.device_name = device_name;
+    recorder_config.sample_rate = sample_rate;
+    // the microphone arrays sit next to the tanks, so average all channels rather than trusting one capsule
+    recorder_config.channels = channels;
+    recorder_config.channel_mode = PV_RECORDER_CHANNEL_MODE_AVERAGE;
+    // a command is only worth hearing while it's fresh, so after a stall skip ahead rather than catch up
+    recorder_config.overflow_policy = PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST;
+    // the default leaves the period to the backend; a short one answers sooner, a long one saves wakeups
+    recorder_config.latency_profile = audio_latency;
+    if (alsa_device) {
+        // capture straight from the ALSA mmap area, e.g. "hw:1,0" for the USB microphone on the BeagleBone
+        recorder_config.backend = PV_RECORDER_BACKEND_ALSA_MMAP;
+        recorder_config.alsa_device_name = alsa_device;
+    }
+    if (serial_device) {
+        // a wake word co-processor only sends the audio around each wake word, pre-roll included, so Porcupine here
+        // fires on the same wake word and Rhino gets the command; the rest of the time nothing is processed
+        recorder_config.backend = PV_RECORDER_BACKEND_SERIAL;
+        recorder_config.serial_device_name = serial_device;
+        recorder_config.serial_baud_rate = serial_baud_rate;
+        recorder_config.sample_rate = 16000;
+        recorder_config.channels = 1;
+    }
+    if (audio_file) {
+        // recorded audio in place of the microphone, e.g. a night of commands replayed at 100 times real time to
+        // benchmark the pipeline on a host; 0 replays as fast as the frames are taken
+        recorder_config.backend = PV_RECORDER_BACKEND_FILE;
+        recorder_config.file_name = audio_file;
+        recorder_config.file_speed = audio_speed;
+        recorder_config.sample_rate = 16000;
+        recorder_config.channels = 1;
+        if (is_replaying_script) {
+            recorder_config.overflow_policy = PV_RECORDER_OVERFLOW_POLICY_BLOCK;
+        }
+    }
+    // capture runs on the recorder's worker and pv_picovoice_process on the pipeline's thread; both get this, so
+    // display refreshes can't preempt them
+    recorder_config.realtime_priority = audio_priority;
+    recorder_config.cpu = audio_cpu;
+    pv_recorder_status_t recorder_status = pv_recorder_init_with_config(&recorder_config, &recorder);
+    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(recorder_status));
+        exit(1);
+    }
+
+    const long long audio_done_us = latencyTrace_nowUs();
+
+    if (is_loading_in_background) {
+        pthread_join(model_thread, NULL);
+    }
+    if (model_load.status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "'%s' failed with '%s'\n", is_standby ? "pv_porcupine_init" : "pv_picovoice_init",
+                engine.statusToString(model_load.status));
+        exit(1);
+    }
+    long long hardware_done_us = 0;
+    if (!hardware_join(&hardware_done_us)) {
+        exit(1);
+    }
+    if (rhino_engine.library != NULL) {
+        // the button was set up as the mode switch before the options were known
+        __atomic_store_n(&isPushToTalk, true, __ATOMIC_RELEASE);
+        fprintf(stdout, "Push to talk: the button sends the next command straight to Rhino.\n");
+    }
+
+    if (is_standby) {
+        fprintf(stdout, "Porcupine (%s) in standby, Rhino built after the wake word%s :\n\n", engine.version,
+                is_rhino_warm ? " and kept warm" : "");
+    } else {
+        fprintf(stdout, "Picovoice End-to-End Platform (%s) :\n\n", engine.version);
+    }
+
+    const char *selected_device = pv_recorder_get_selected_device(recorder);
+    fprintf(stdout, "Selected device: %s\n", selected_device);
+    pv_recorder_latency_t latency;
+    if (pv_recorder_get_latency(recorder, &latency) == PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stdout, "Capture period: %d frames (%.1f ms), %d periods buffered (%.1f ms)\n", latency.period_frames,
+                (double) latency.period_usec / 1000.0, latency.periods, (double) latency.buffer_usec / 1000.0);
+    }
+
+    if (noise_suppression_db > 0.f) {
+        const pv_noise_suppressor_status_t suppressor_status =
+                pv_noise_suppressor_init(frame_length, noise_suppression_db, &noise_suppressor);
+        if (suppressor_status != PV_NOISE_SUPPRESSOR_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to set up noise suppression of %.1f dB for %d-sample frames.\n",
+                    noise_suppression_db, frame_length);
+            exit(1);
+        }
+        suppressed_pcm = malloc((size_t) frame_length * sizeof(int16_t));
+        if (!suppressed_pcm) {
+            fprintf(stderr, "Failed to allocate memory for noise suppression.\n");
+            exit(1);
+        }
+        memoryBudget_add("noise suppression", (long long) frame_length * sizeof(int16_t), true);
+    }
+    if (agc_target_dbfs != 0.f) {
+        const pv_gain_control_status_t gain_control_status =
+                pv_gain_control_init(engine.sampleRate, agc_target_dbfs, AGC_MAX_GAIN_DB, &gain_control);
+        if (gain_control_status != PV_GAIN_CONTROL_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to set up gain control to %.1f dBFS.\n", agc_target_dbfs);
+            exit(1);
+        }
+        leveled_pcm = malloc((size_t) frame_length * sizeof(int16_t));
+        if (!leveled_pcm) {
+            fprintf(stderr, "Failed to allocate memory for gain control.\n");
+            exit(1);
+        }
+        memoryBudget_add("gain control", (long long) frame_length * sizeof(int16_t), true);
+        // only there while the gain control is
+        agc_gain_metric = metrics_addGauge("feeder_agc_gain_db", "Gain the automatic gain control last applied.");
+    }
+    if (vad_threshold_db > 0.f) {
+        const voiceGate_config gate_config = {
+                .thresholdDb = vad_threshold_db,
+                .hangoverFrames = frames_for_ms(vad_hangover_ms, frame_length, engine.sampleRate),
+                .preRollFrames = frames_for_ms(vad_pre_roll_ms, frame_length, engine.sampleRate),
+        };
+        if (!voiceGate_init(frame_length, &gate_config)) {
+            exit(1);
+        }
+        is_voice_gated = true;
+    }
+    if (adaptive_endpoint_ms > 0) {
+        // Rhino's own endpoint is the longest wait, for the noisiest room
+        const int32_t endpoint_ms = (int32_t) (endpoint_duration_sec * 1000.f);
+        const endpointTracker_config tracker_config = {
+                .speechDb = (vad_threshold_db > 0.f) ? vad_threshold_db : 10.f,
+                .minSilenceFrames = frames_for_ms(adaptive_endpoint_ms, frame_length, engine.sampleRate),
+                .maxSilenceFrames = frames_for_ms(endpoint_ms > adaptive_endpoint_ms ? endpoint_ms :
+                        adaptive_endpoint_ms, frame_length, engine.sampleRate),
+                .minSpeechFrames = frames_for_ms(300, frame_length, engine.sampleRate),
+        };
+        if (!endpointTracker_init(frame_length, &tracker_config)) {
+            exit(1);
+        }
+        silence_pcm = calloc((size_t) frame_length, sizeof(int16_t));
+        if (!silence_pcm) {
+            fprintf(stderr, "Failed to allocate memory for the adaptive endpoint.\n");
+            exit(1);
+        }
+        memoryBudget_add("adaptive endpoint", (long long) frame_length * sizeof(int16_t), true);
+        endpoint_flush_frames = frames_for_ms(endpoint_ms, frame_length, engine.sampleRate) + 1;
+        early_endpoint_metric = metrics_addCounter("feeder_early_endpoints_total",
+                "Commands ended by the level meter before Rhino's own endpoint.");
+        is_endpoint_adaptive = true;
+    }
+    if (camera_budget_ms > 0) {
+        const cameraGovernor_config governor_config = {
+                .budgetMs = camera_budget_ms,
+                .cgroupPath = camera_cgroup,
+        };
+        if (!cameraGovernor_start(&governor_config)) {
+            exit(1);
+        }
+        camera_level_metric = metrics_addGauge("feeder_camera_level",
+                "Steps the camera has been asked to take down its --adapt ladder to spare the CPU.");
+        is_camera_governed = true;
+    }
+    if (capture_dir) {
+        const commandCapture_config capture_config = {
+                .directory = capture_dir,
+                .preRollMs = capture_pre_roll_ms,
+                .maxCommandMs = COMMAND_CAPTURE_DEFAULT_MAX_COMMAND_MS,
+                .quotaBytes = capture_quota_mb * 1024 * 1024,
+                .isAdpcm = config->isAdpcmAudio,
+        };
+        if (!commandCapture_start(frame_length, engine.sampleRate, &capture_config)) {
+            exit(1);
+        }
+        is_capturing_commands = true;
+    }
+    if (audio_archive_dir) {
+        // a reader of its own on the recorder, so it never holds up the frames inference gets
+        if (!audioArchive_start(audio_archive_dir, engine.sampleRate, config->isAdpcmAudio) ||
+                !audioArchive_attach(recorder)) {
+            exit(1);
+        }
+        audioSupervisor_setRecorderFuncs(attach_audio_archive, detach_audio_archive);
+        is_archiving_audio = true;
+    }
+    if (config->offloadServer[0] != '\0') {
+        // the engines are still loaded, to listen while the server doesn't answer
+        if (!remoteInference_start(config->offloadServer, frame_length, engine.sampleRate, engine_count)) {
+            exit(1);
+        }
+        is_offloading = true;
+    }
+    // the camera's clips are silent without it, nothing more
+    audioTap_open(AUDIO_TAP_DEFAULT_PATH, frame_length, engine.sampleRate);
+    if (is_standby) {
+        // Rhino goes through the pool's build in the time it would otherwise have listened, so the frames wait for it
+        standby_backlog_capacity = frames_for_ms(standbyBacklogInMs, frame_length, engine.sampleRate);
+        const size_t backlog_bytes = (size_t) standby_backlog_capacity * frame_length * sizeof(int16_t);
+        for (int i = 0; i < engine_count; i++) {
+            standby_engines[i].backlog = malloc(backlog_bytes);
+            if (!standby_engines[i].backlog) {
+                fprintf(stderr, "Failed to allocate memory for the standby backlog.\n");
+                exit(1);
+            }
+            memoryBudget_add("standby backlog", (long long) backlog_bytes, true);
+        }
+        rhinoPool_config pool_config = {
+                .engine = &rhino_engine,
+                .accessKey = access_key,
+                .modelPath = rhino_model_path,
+                .contextCount = engine_count,
+                .sensitivity = rhino_sensitivity,
+                .endpointDurationSec = endpoint_duration_sec,
+                .requireEndpoint = require_endpoint,
+                .keepWarm = is_rhino_warm,
+                .lingerMs = (int32_t) (rhino_linger_sec * 1000.f),
+        };
+        for (int i = 0; i < engine_count; i++) {
+            pool_config.contextPaths[i] = context_paths[i];
+        }
+        static const double ready_bounds[] = {0.01, 0.025, 0.05, 0.1, 0.2, 0.3, 0.5, 1., 2.};
+        rhino_instances_metric = metrics_addGauge("feeder_rhino_instances", "Rhino instances built, in standby.");
+        rhino_ready_metric = metrics_addHistogram("feeder_rhino_ready_seconds",
+                "Time from a wake word to its Rhino being ready, in standby.", ready_bounds,
+                (int) (sizeof(ready_bounds) / sizeof(ready_bounds[0])));
+        if (!rhinoPool_start(&pool_config)) {
+            exit(1);
+        }
+    }
+    // engine 0 runs on the inference thread, the others on workers of their own, on the next cores along
+    if (!engineFanout_start(engine_count, run_engine, NULL, audio_priority, audio_cpu)) {
+        exit(1);
+    }
+    if (!inferencePipeline_start(frame_length, process_frame, NULL, audio_priority, audio_cpu)) {
+        exit(1);
+    }
+    // SIGHUP builds a new instance from the same paths and swaps it in between two frames
+    __atomic_store_n(&is_reload_open, true, __ATOMIC_SEQ_CST);
+    if (metrics_port > 0) {
+        collect_cpu();
+    }
+    if (metrics_port > 0 && metrics_serve(metrics_port, collect_metrics)) {
+        fprintf(stdout, "Metrics on port %d\n", metrics_port);
+    }
+    pv_recorder_set_log_callback(recorder, log_recorder_warning, NULL);
+    recorder_status = pv_recorder_set_frame_callback(recorder, frame_callback, NULL);
+    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to set frame callback with %s.\n", pv_recorder_status_to_string(recorder_status));
+        exit(1);
+    }
+
+    // the models, the ring and every thread stack stay resident, so a frame never waits on a page fault
+    bool is_memory_locked = false;
+    if (lock_memory) {
+        is_memory_locked = (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+        if (!is_memory_locked) {
+            fprintf(stderr, "mlockall failed: %s\n", strerror(errno));
+        }
+    }
+
+    recorder_status = pv_recorder_start(recorder);
+    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to start device with %s.\n", pv_recorder_status_to_string(recorder_status));
+        exit(1);
+    }
+    if (handover_us > 0) {
+        // the most the feeder was deaf for
+        fprintf(stdout, "Handover: listening %.1f ms after asking the old feeder to stop\n",
+                (latencyTrace_nowUs() - handover_us) / 1000.0);
+    }
+    // from here a device that stops delivering is reopened in place, with the same callbacks
+    audioSupervisor_watch(recorder, &recorder_config, frame_callback, NULL, log_recorder_warning, NULL);
+
+    int32_t thread_priority = 0;
+    int32_t thread_cpu = -1;
+    pv_recorder_get_scheduling(recorder, &thread_priority, &thread_cpu);
+    bool is_scheduled = report_scheduling("Capture", thread_priority, thread_cpu, audio_priority, audio_cpu);
+    inferencePipeline_getScheduling(&thread_priority, &thread_cpu);
+    is_scheduled &= report_scheduling("Inference", thread_priority, thread_cpu, audio_priority, audio_cpu);
+    fprintf(stdout, "Memory %s\n", is_memory_locked ? "locked" : "not locked");
+    if (!is_scheduled) {
+        fprintf(stderr, "Audio thread scheduling is not as requested; SCHED_FIFO needs CAP_SYS_NICE or an RLIMIT_RTPRIO allowance\n");
+    }
+
+    const long long listening_us = latencyTrace_nowUs();
+    metrics_set(startup_metric, (double) (listening_us - startup_us) / 1e6);
+    modelPrefetch_stats prefetch_stats;
+    modelPrefetch_join(&prefetch_stats);
+    fprintf(stdout, "Startup : %d files (%lld KiB) prefetched in %lld ms, models %lld ms, audio device %lld ms, "
+            "hardware %lld ms, listening after %lld ms\n",
+            prefetch_stats.files, prefetch_stats.bytes / 1024, prefetch_stats.elapsedUs / 1000,
+            (model_load.done_us - startup_us) / 1000, (audio_done_us - startup_us) / 1000,
+            (hardware_done_us - startup_us) / 1000, (listening_us - startup_us) / 1000);
+    memoryBudget_print();
+    fprintf(stdout, "Listening...\n\n");
+    fflush(stdout);
+    // everything the audio path needs is in place; from here it shouldn't ask for more
+    if (alloc_guard_trapping >= 0) {
+        allocGuard_arm(alloc_guard_trapping == 1);
+    }
+
+    // armed only once listening, so loading the models can't run into the timeout
+    bool is_watchdog_open = false;
+    if (watchdog_device) {
+        is_watchdog_open = watchdog_open(watchdog_device, WATCHDOG_DEFAULT_TIMEOUT_SEC);
+        if (!is_watchdog_open) {
+            exit(1);
+        }
+    }
+    daemon_progress progress = {0, listening_us, 0, listening_us};
+
+    const bool is_script_met = !is_replaying_script || run_script(recorder, frame_length, engine.sampleRate);
+    // frames are captured on the recorder's worker thread and processed on the pipeline's
+    while (!is_interrupted && !is_replaying_script) {
+        sleepForMs(100);
+        // a replayed file ends the run once it has all been handed on
+        if (audio_file && recorder && pv_recorder_is_at_end(recorder)) {
+            break;
+        }
+        audioSupervisor_poll();
+        if (is_camera_governed) {
+            cameraGovernor_poll();
+        }
+        if (is_watchdog_open && is_daemon_healthy(&progress, latencyTrace_nowUs())) {
+            watchdog_pet();
+        }
+    }
+
+    allocGuard_disarm();
+    fprintf(stdout, "Stopping...\n");
+    fflush(stdout);
+
+    // its reader has to be gone before the recorder stops
+    if (is_archiving_audio) {
+        audioArchive_stop();
+    }
+    // none if the device went away and hasn't come back
+    recorder = audioSupervisor_release();
+    if (recorder) {
+        recorder_status = pv_recorder_stop(recorder);
+        if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to stop device with %s.\n", pv_recorder_status_to_string(recorder_status));
+            exit(1);
+        }
+    }
+    inferencePipeline_stop();
+    engineFanout_stop();
+    if (is_capturing_commands) {
+        commandCapture_stop();
+    }
+    if (is_offloading) {
+        remoteInference_stop();
+    }
+    audioTap_close();
+    pv_noise_suppressor_delete(noise_suppressor);
+    free(suppressed_pcm);
+    pv_gain_control_delete(gain_control);
+    free(leveled_pcm);
+    free(silence_pcm);
+    // a reload still building finishes and cleans up after itself, with nothing left to swap into
+    __atomic_store_n(&is_reload_open, false, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&is_reloading, __ATOMIC_SEQ_CST)) {
+        sleepForMs(reloadPollInMs);
+    }
+    metrics_stop();
+    if (is_standby) {
+        for (int i = 0; i < engine_count; i++) {
+            drop_standby_command(i);
+            free(standby_engines[i].backlog);
+        }
+        rhinoPool_stop();
+    }
+
+    inferencePipeline_stats stats;
+    inferencePipeline_getStats(&stats);
+    fprintf(stdout, "capture : %lld frames, %lld dropped, longest gap %.1f ms, queue up to %d of %d\n",
+            stats.capturedFrames, stats.droppedFrames, stats.maxCaptureIntervalUs / 1000.0, stats.maxQueueDepth,
+            INFERENCE_PIPELINE_QUEUE_LENGTH);
+    fprintf(stdout, "inference : %lld frames, %.2f ms average, %.2f ms longest, longest wait %.1f ms\n",
+            stats.processedFrames,
+            (stats.processedFrames > 0) ? (stats.totalProcessUs / 1000.0) / stats.processedFrames : 0.0,
+            stats.maxProcessUs / 1000.0, stats.maxQueueWaitUs / 1000.0);
+    if (is_voice_gated) {
+        voiceGate_stats gate_stats;
+        voiceGate_getStats(&gate_stats);
+        fprintf(stdout, "voice gate : %lld of %lld frames processed, opened %lld times, noise floor %.1f dBFS\n",
+                gate_stats.passedFrames, gate_stats.frames, gate_stats.openings, gate_stats.noiseFloorDb);
+        voiceGate_cleanup();
+    }
+    if (is_standby) {
+        rhinoPool_stats pool_stats;
+        rhinoPool_getStats(&pool_stats);
+        const long long builds_waited = pool_stats.requests - pool_stats.warmHits;
+        fprintf(stdout, "standby : %lld commands, %lld on a warm Rhino, %lld waited %.1f ms average (%.1f ms longest), "
+                "%lld lost, %lld built, up to %d resident\n",
+                pool_stats.requests, pool_stats.warmHits, builds_waited,
+                (builds_waited > 0) ? (pool_stats.totalReadyUs / 1000.0) / builds_waited : 0.0,
+                pool_stats.maxReadyUs / 1000.0, commands_lost, pool_stats.built, pool_stats.maxResident);
+    }
+    if (is_camera_governed) {
+        cameraGovernor_stats governor_stats;
+        cameraGovernor_getStats(&governor_stats);
+        cameraGovernor_stop();
+        fprintf(stdout, "camera governor : %lld steps down, %lld up, level %d at most, frames took %.1f ms last\n",
+                governor_stats.stepsDown, governor_stats.stepsUp, governor_stats.maxLevel,
+                governor_stats.latencyUs / 1000.0);
+    }
+    if (is_endpoint_adaptive) {
+        endpointTracker_stats tracker_stats;
+        endpointTracker_getStats(&tracker_stats);
+        fprintf(stdout, "adaptive endpoint : %lld commands ended after %.0f ms of silence on average, of %.0f ms, "
+                "noise floor %.1f dBFS\n", tracker_stats.ends,
+                (tracker_stats.ends > 0) ? (double) tracker_stats.silenceFrames * frame_length * 1000.0 /
+                        engine.sampleRate / tracker_stats.ends : 0.0,
+                endpoint_duration_sec * 1000.0, tracker_stats.noiseFloorDb);
+    }
+    if (is_capturing_commands) {
+        commandCapture_stats capture_stats;
+        commandCapture_getStats(&capture_stats);
+        fprintf(stdout, "command capture : %lld written, %lld skipped, %lld deleted for quota, %lld frames lost\n",
+                capture_stats.written, capture_stats.skipped, capture_stats.deleted, capture_stats.lostFrames);
+    }
+    if (is_archiving_audio) {
+        audioArchive_stats archive_stats;
+        audioArchive_getStats(&archive_stats);
+        fprintf(stdout, "audio archive : %lld files, %.2f h recorded, %.1f s lost, %lld write errors\n",
+                archive_stats.files, (double) archive_stats.writtenSamples / engine.sampleRate / 3600.0,
+                (double) archive_stats.lostSamples / engine.sampleRate, archive_stats.writeErrors);
+    }
+    if (is_offloading) {
+        remoteInference_stats remote_stats;
+        remoteInference_getStats(&remote_stats);
+        fprintf(stdout, "remote inference : %lld frames offloaded (%lld KB), %lld events, link lost %lld times, "
+                        "%lld bad datagrams, %lld send errors, last round trip %.1f ms\n",
+                remote_stats.sentFrames, remote_stats.sentBytes / 1024, remote_stats.events, remote_stats.linkDrops,
+                remote_stats.badDatagrams, remote_stats.sendErrors,
+                (remote_stats.roundTripUs >= 0) ? (double) remote_stats.roundTripUs / 1000.0 : 0.0);
+    }
+
+    audioSupervisor_stats supervisor_stats;
+    audioSupervisor_getStats(&supervisor_stats);
+    if (supervisor_stats.restarts > 0 || supervisor_stats.failedAttempts > 0) {
+        fprintf(stdout, "audio supervisor : device reopened %lld times, %lld failed attempts\n",
+                supervisor_stats.restarts, supervisor_stats.failedAttempts);
+    }
+    if (alloc_guard_trapping >= 0) {
+        allocGuard_report();
+    }
+    if (is_watchdog_open) {
+        watchdog_close();
+    }
+
+    pv_recorder_delete(recorder);
+    destroy_picovoice_set(active_set);
+    pvEngine_unloadRhino(&rhino_engine);
+    pvEngine_unloadPorcupine(&porcupine_engine);
+    pvEngine_unload(&engine);
+    embeddedModels_close();
+
+    return is_script_met ? 0 : 1;
+}
+
+static bool isThermalMonitored = false;
+static bool isCpuFrequencyControlled = false;
+
+static bool hardware_setup(){
+    const feederConfig* config = feederConfig_startup();
+    // simulated, there are no pins to mux, and the servo and button stay off the PRU
+    const bool is_simulated = hal_isSimulated();
+    if (!is_simulated) {
+        configureI2C();
+    }
+    if (!eventLoop_init()) {
+        return false;
+    }
+    if (!i2cBus_open(config->i2cBus) || !matrixDriver_init(config->i2cAddress)) {
+        return false;
+    }
+    matrixDriver_setBrightness(config->displayBrightness);
+    if (!is_simulated) {
+        configureAllPins();
+    }
+    if (config->pruRemoteproc[0] != '\0' && !is_simulated) {
+        // the PRU generates the pulse and debounces the button; the loop only hears about moves and presses
+        pinMux_set(PRU_PROTOCOL_SERVO_PIN, "pruout");
+        pinMux_set(PRU_PROTOCOL_BUTTON_PIN, "pruin");
+        if (!pruLink_start(config->pruRemoteproc) || !servoDriver_initPru() ||
+            !buttonInput_startPru(buttonDebounceInMs, onButton)) {
+            return false;
+        }
+    } else {
+        // sysfs still works if the banks can't be mapped, only slower
+        if (config->gpioRegisters && !is_simulated) {
+            gpioRegisters_open();
+        }
+        if (!servoDriver_init(config->pwmPath)) {
+            return false;
+        }
+        // mode switches, or push to talk, happen as soon as a press has settled
+        if (!buttonInput_start(config->buttonGpio, buttonDebounceInMs, onButton)) {
+            return false;
+        }
+    }
+    // the feeder works without it, it just can't tell when to refill
+    if (config->hasHopperLevel) {
+        hopperLevel_start(&config->hopperLevel, onHopperLevel);
+    }
+    // without them the display and /status leave the temperatures out, and scheduled feeds are never skipped
+    if (config->envSensor.ids[ENV_SENSOR_WATER][0] != '\0' || config->envSensor.ids[ENV_SENSOR_AIR][0] != '\0') {
+        envSensor_start(&config->envSensor);
+    }
+    // without it the camera keeps all its work however hot the board gets, until the SoC throttles itself
+    if (!is_simulated) {
+        isThermalMonitored = thermalMonitor_start(&config->thermalMonitor);
+    }
+    // without it the governor picks the frequency by itself, around the clock
+    if (!is_simulated && config->cpuFrequency.idleKHz > 0) {
+        isCpuFrequencyControlled = cpuFrequency_start(&config->cpuFrequency);
+    }
+    // without it a jammed gate just finishes its profile
+    if (config->hasServoCurrent && servoCurrent_start(&config->servoCurrent, onServoStall)) {
+        servoDriver_setMotionFunc(servoCurrent_watch);
+    }
+    // a feed still goes ahead if the camera can't be told about it, or it can't be journaled
+    feedNotifier_open(FEED_NOTIFIER_DEFAULT_PATH);
+    feedJournal_open(FEED_JOURNAL_DEFAULT_PATH);
+    // without it the feeder starts from scratch, as it did the first time
+    if (is_keeping_state) {
+        stateSnapshot_open(STATE_SNAPSHOT_DEFAULT_PATH);
+    }
+    restoreState();
+    feedWorker_start(FEED_COALESCE_ACTIVE, profileForRequest, feedStarted, fedInMode);
+    if (!feedScheduler_start(skipScheduledFeed) || !feedPlan_start(&config->feedPlan)) {
+        return false;
+    }
+    // voice and the button still work without it
+    if (config->controlSocket[0] != '\0') {
+        controlServer_addRoute("GET", "/status", controlStatus);
+        controlServer_addRoute("GET", "/stats", controlStats);
+        controlServer_addRoute("GET", "/plan", controlPlan);
+        controlServer_addRoute("POST", "/feed", controlFeed);
+        controlServer_addRoute("POST", "/mode", controlMode);
+        controlServer_addRoute("POST", "/consumption", controlConsumption);
+        controlServer_addRoute("POST", "/viewers", controlViewers);
+        if (is_simulated) {
+            controlServer_addRoute("POST", "/button", controlButton);
+        }
+        controlServer_addStream("/events");
+        if (handed.controlFd >= 0) {
+            controlServer_adopt(handed.controlFd, config->controlSocket);
+        } else {
+            controlServer_open(config->controlSocket);
+        }
+    } else if (handed.controlFd >= 0) {
+        close(handed.controlFd);
+    }
+    // without it the next build can only be started cold
+    handover_listen(HANDOVER_DEFAULT_PATH, onHandover);
+
+    textScroller_start(150);
+    return hardware_start();
+}
+
+static pthread_t threadHardwareSetup;
+static bool isHardwareSetupRunning = false;
+static bool isHardwareReady = false;
+static long long hardwareReadyUs = 0;
+
+static void* runHardwareSetup(void* arg){
+    (void) arg;
+    isHardwareReady = hardware_setup();
+    hardwareReadyUs = latencyTrace_nowUs();
+    return NULL;
+}
+
+// picovoice_main joins it once the models and the audio device are ready too
+static void hardware_startSetup(void){
+    isHardwareSetupRunning = (pthread_create(&threadHardwareSetup, NULL, runHardwareSetup, NULL) == 0);
+    if(isHardwareSetupRunning){
+        threadCpu_setName(threadHardwareSetup, "hw-setup");
+    } else {
+        runHardwareSetup(NULL);
+    }
+}
+
+// Waits for the hardware strand; safe to call more than once.
+static bool hardware_join(long long *done_us){
+    if(isHardwareSetupRunning){
+        pthread_join(threadHardwareSetup, NULL);
+        isHardwareSetupRunning = false;
+    }
+    *done_us = hardwareReadyUs;
+    return isHardwareReady;
+}
 
-    display_startButton();
+#ifdef FISHFEEDER_UNIFIED
+// fishfeeder.c's main runs this once the camera's capture has started
+int feeder_main(int argc, char *argv[]) {
+#else
+int main(int argc, char *argv[]) {
+#endif
+
+    startup_us = latencyTrace_nowUs();
+    blockControlSignals();
+    register_metrics();
+    // the inference threads look slot words up from the first command
+    slotWords_init();
+    // the hardware strand needs the settings, the HAL backend and the clock before the options are parsed, so --config,
+    // --simulate and --sim_script are looked for here
+    const char *config_path = FEEDER_CONFIG_DEFAULT_PATH;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--simulate") == 0 || strcmp(argv[i], "-X") == 0) {
+            hal_setBackend(HAL_BACKEND_SIM);
+        } else if (strncmp(argv[i], "--sim_script", 12) == 0 || strcmp(argv[i], "-Z") == 0) {
+            // a scripted replay runs the simulated hardware on the virtual clock
+            hal_setBackend(HAL_BACKEND_SIM);
+            eventLoop_useVirtualClock();
+            is_keeping_state = false;
+        } else if (strcmp(argv[i], "--handover") == 0) {
+            is_taking_over = true;
+        } else if (strncmp(argv[i], "--config=", 9) == 0) {
+            config_path = argv[i] + 9;
+        } else if ((strcmp(argv[i], "--config") == 0 || strcmp(argv[i], "-F") == 0) && i + 1 < argc) {
+            config_path = argv[++i];
+        }
+    }
+    if (!feederConfig_load(config_path)) {
+        exit(1);
+    }
+    // taking over, the old feeder has the hardware until the models are loaded
+    if (!is_taking_over) {
+        hardware_startSetup();
+    }
 #if defined(_WIN32) || defined(_WIN64)
 
 #define UTF8_COMPOSITION_FLAG (0)
@@ -791,6 +2973,11 @@ int main(int argc, char *argv[]) {
 #endif
 
     int result = picovoice_main(argc, argv);
+    // --show_audio_devices returns before the join
+    long long hardware_done_us = 0;
+    if (!hardware_join(&hardware_done_us)) {
+        exit(1);
+    }
 
 #if defined(_WIN32) || defined(_WIN64)
 
@@ -799,6 +2986,63 @@ int main(int argc, char *argv[]) {
     }
 
 #endif
-    display_stopButton();
+    hardware_stop();
+    latencyTrace_printPercentiles();
+    feedPlan_stop();
+    feedScheduler_stop();
+    feedWorker_stop();
+    feedGuard_stats guard_stats;
+    feedGuard_getStats(&guard_stats);
+    if (guard_stats.merged > 0 || guard_stats.rateLimited > 0) {
+        fprintf(stdout, "feed guard : %lld merged, %lld refused over the rate limit\n", guard_stats.merged,
+                guard_stats.rateLimited);
+    }
+    controlServer_close();
+    feedJournal_close();
+    stateSnapshot_close();
+    feedNotifier_close();
+    buttonInput_stop();
+    gpioRegisters_close();
+    hopperLevel_stop();
+    envSensor_stop();
+    if (isThermalMonitored) {
+        thermalMonitor_stats thermal_stats;
+        thermalMonitor_getStats(&thermal_stats);
+        thermalMonitor_stop();
+        fprintf(stdout, "thermal monitor : %lld steps up, %lld down, level %d at most, %.1f C at the hottest\n",
+                thermal_stats.stepsUp, thermal_stats.stepsDown, thermal_stats.maxLevel,
+                thermal_stats.maxMilliC / 1000.0);
+    }
+    if (isCpuFrequencyControlled) {
+        cpuFrequency_stats cpu_stats;
+        cpuFrequency_getStats(&cpu_stats);
+        cpuFrequency_stop();
+        fprintf(stdout, "cpu frequency : %lld boosts, %.0f s capped, switches %.2f ms at most (%lld unsettled), "
+                "%.1f J saved (estimated)\n", cpu_stats.boosts, cpu_stats.cappedMs / 1000.0,
+                cpu_stats.maxSwitchUs / 1000.0, cpu_stats.unsettledSwitches, cpu_stats.savedMilliJoules / 1000.0);
+    }
+    textScroller_stop();
+    servoDriver_cleanup();
+    servoDriver_setMotionFunc(NULL);
+    servoCurrent_stop();
+    adcStream_close();
+    pruLink_stop();
+    matrixDriver_cleanup();
+    i2cBus_close();
+    if (hal_isSimulated()) {
+        fprintf(stdout, "simulated hardware : %lld PWM writes, %lld I2C writes\n", halPwm_simWrites(),
+                halI2c_simWrites());
+    }
+    // a feeder taking over opens the device and the hardware once this is closed
+    handover_close();
+    eventLoop_cleanup();
+    feederConfig_unload();
+    asyncLog_stats log_stats;
+    asyncLog_getStats(&log_stats);
+    // every thread that logs has stopped
+    asyncLog_stop();
+    if (log_stats.dropped > 0) {
+        fprintf(stdout, "log : %lld records dropped, ring full\n", log_stats.dropped);
+    }
     return result;
 }
@@ -0,0 +1,1007 @@
+#ifndef _GNU_SOURCE
+// recvmmsg, and getaddrinfo and nanosleep with it
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <getopt.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engine_fanout.h"
+#include "pv_adpcm.h"
+#include "pv_engine.h"
+#include "remote_inference.h"
+#include "thread_cpu.h"
+
+// Listens for many feeders at once, for boards started with offload_server; remote_inference.h has the protocol. Each
+// board gets Picovoice instances of its own, one per keyword and context pair, made on the worker that first runs it,
+// and gives them back after --idle_sec without a datagram. One thread takes every datagram from every socket through
+// epoll; a pool of workers runs the engines. A board with frames waiting sits on one worker's queue, its home's, and
+// a worker whose queue is empty steals from the back of another's, so a few talkative boards don't leave cores idle. A
+// board is on one queue at most and run by one worker at a time, so its frames are processed in the order captured.
+
+#define MAX_SOCKETS 4
+// about a second of 512-sample frames at 16 kHz; a board further behind than that has its oldest frames dropped
+#define BOARD_QUEUE_FRAMES 32
+// frames a worker runs for a board before the next board on its queue has a turn
+#define BOARD_TURN_FRAMES 4
+#define MAX_DATAGRAM_LENGTH 2048
+#define MAX_BLOCK_LENGTH (MAX_DATAGRAM_LENGTH - REMOTE_INFERENCE_HEADER_LENGTH)
+// datagrams taken from a socket in one call
+#define RECEIVE_BATCH 32
+// the board reads one line a datagram, of up to 512 bytes
+#define MAX_LINE_LENGTH 512
+#define KIND_FRAME 1
+#define KIND_PING 2
+// a quarter of an octave each, from 1 µs to about half an hour
+#define LATENCY_BUCKETS 128
+#define HOUSEKEEPING_MS 1000
+
+typedef struct {
+    long long frame;
+    // CLOCK_MONOTONIC, as the datagram was taken
+    long long received_us;
+    // the server's receive time less the board's capture time, both since the epoch, so as good as the two clocks
+    long long transit_us;
+    int32_t block_length;
+    uint8_t block[MAX_BLOCK_LENGTH];
+} queued_frame_t;
+
+typedef struct {
+    long long frames;
+    // the queue was full, or the board's engines couldn't be made
+    long long dropped;
+    // arrived after a later frame
+    long long late;
+    long long processed;
+    long long wake_words;
+    long long inferences;
+    long long process_failures;
+    // from the datagram being taken to the frame's engines being done
+    long long latency_sum_us;
+    long long latency_max_us;
+    long long transit_sum_us;
+    uint32_t latency_buckets[LATENCY_BUCKETS];
+} board_stats_t;
+
+typedef struct {
+    // receiving thread only
+    bool is_used;
+    int socket_fd;
+    struct sockaddr_storage address;
+    socklen_t address_length;
+    char name[64];
+    long long joined_us;
+    long long last_heard_us;
+    long long last_queued_frame;
+
+    // whichever worker runs the board; set before it is first queued, and read once it can't be queued again
+    int engine_count;
+    pv_picovoice_t *handles[ENGINE_FANOUT_MAX_ENGINES];
+    bool is_created;
+
+    pthread_mutex_t lock;
+    // under lock
+    queued_frame_t frames[BOARD_QUEUE_FRAMES];
+    int32_t first_frame;
+    int32_t frame_count;
+    // on a queue, or being run
+    bool is_scheduled;
+    bool is_failed;
+    board_stats_t stats;
+} board_t;
+
+// A worker's boards, in the order they became ready. The owner takes from the front, a thief from the back.
+typedef struct {
+    pthread_mutex_t lock;
+    int32_t *boards;
+    int32_t first;
+    int32_t count;
+} board_queue_t;
+
+typedef struct {
+    int32_t index;
+    pthread_t thread;
+    board_queue_t queue;
+    queued_frame_t frame;
+    int16_t *pcm;
+} worker_t;
+
+// what pv_picovoice_init is given for each board
+typedef struct {
+    const char *access_key;
+    const char *porcupine_model_path;
+    const char *keyword_paths[ENGINE_FANOUT_MAX_ENGINES];
+    float porcupine_sensitivity;
+    const char *rhino_model_path;
+    const char *context_paths[ENGINE_FANOUT_MAX_ENGINES];
+    float rhino_sensitivity;
+    float endpoint_duration_sec;
+    bool require_endpoint;
+    int engine_count;
+} picovoice_params_t;
+
+// The frame a worker's engines are on, for the callbacks, which Picovoice makes on the thread that processes.
+typedef struct {
+    board_t *board;
+    int engine;
+    long long frame;
+    int wake_words;
+    int inferences;
+    bool is_failed;
+} heard_t;
+
+static __thread heard_t *heard = NULL;
+
+// resolved once, shared by every worker
+static pvEngine engine;
+static picovoice_params_t picovoice_params;
+
+static volatile bool is_interrupted = false;
+
+static board_t *boards = NULL;
+static int32_t max_boards = 0;
+// board index + 1 by address, 0 for a free slot; rebuilt whenever a board leaves
+static int32_t *board_index = NULL;
+static int32_t board_index_size = 0;
+
+static worker_t *workers = NULL;
+static int32_t worker_count = 0;
+// boards on the queues, and not yet taken by a worker
+static pthread_mutex_t ready_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t board_ready = PTHREAD_COND_INITIALIZER;
+static int32_t ready_boards = 0;
+static bool is_stopping = false;
+
+// datagrams from boards that couldn't join: the server is full, or they don't match the engines
+static long long refused_datagrams = 0;
+static long long bad_datagrams = 0;
+
+static void interrupt_handler(int _) {
+    (void) _;
+    is_interrupted = true;
+}
+
+static long long now_us(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static uint32_t get_le16(const uint8_t *bytes) {
+    return bytes[0] | ((uint32_t) bytes[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *bytes) {
+    return get_le16(bytes) | (get_le16(bytes + 2) << 16);
+}
+
+static uint64_t get_le64(const uint8_t *bytes) {
+    return get_le32(bytes) | ((uint64_t) get_le32(bytes + 4) << 32);
+}
+
+static int32_t latency_bucket(long long us) {
+    if (us < 4) {
+        return (us < 0) ? 0 : (int32_t) us;
+    }
+    const int32_t top = 63 - __builtin_clzll((unsigned long long) us);
+    const int32_t bucket = top * 4 + (int32_t) ((us >> (top - 2)) & 3);
+    return (bucket < LATENCY_BUCKETS) ? bucket : (LATENCY_BUCKETS - 1);
+}
+
+// the least latency a bucket holds
+static long long bucket_us(int32_t bucket) {
+    if (bucket < 8) {
+        return bucket;
+    }
+    return (long long) (4 + (bucket % 4)) << (bucket / 4 - 2);
+}
+
+static long long latency_percentile(const board_stats_t *stats, double fraction) {
+    const long long rank = (long long) (fraction * (double) stats->processed + 0.999999);
+    long long seen = 0;
+    for (int32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += stats->latency_buckets[i];
+        if (seen >= rank && seen > 0) {
+            return bucket_us(i);
+        }
+    }
+    return 0;
+}
+
+static bool same_address(const board_t *board, int socket_fd, const struct sockaddr_storage *address) {
+    if (board->socket_fd != socket_fd || board->address.ss_family != address->ss_family) {
+        return false;
+    }
+    if (address->ss_family == AF_INET) {
+        const struct sockaddr_in *a = (const struct sockaddr_in *) &board->address;
+        const struct sockaddr_in *b = (const struct sockaddr_in *) address;
+        return a->sin_port == b->sin_port && a->sin_addr.s_addr == b->sin_addr.s_addr;
+    }
+    const struct sockaddr_in6 *a = (const struct sockaddr_in6 *) &board->address;
+    const struct sockaddr_in6 *b = (const struct sockaddr_in6 *) address;
+    return a->sin6_port == b->sin6_port && memcmp(&a->sin6_addr, &b->sin6_addr, sizeof(a->sin6_addr)) == 0;
+}
+
+// FNV-1a over the socket, port and address
+static uint32_t hash_address(int socket_fd, const struct sockaddr_storage *address) {
+    const uint8_t *bytes;
+    size_t length;
+    uint16_t port;
+    if (address->ss_family == AF_INET) {
+        const struct sockaddr_in *in = (const struct sockaddr_in *) address;
+        bytes = (const uint8_t *) &in->sin_addr;
+        length = sizeof(in->sin_addr);
+        port = in->sin_port;
+    } else {
+        const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *) address;
+        bytes = (const uint8_t *) &in6->sin6_addr;
+        length = sizeof(in6->sin6_addr);
+        port = in6->sin6_port;
+    }
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t) socket_fd) * 16777619u;
+    hash = (hash ^ port) * 16777619u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void index_board(int32_t board) {
+    uint32_t slot = hash_address(boards[board].socket_fd, &boards[board].address) & (board_index_size - 1);
+    while (board_index[slot] != 0) {
+        slot = (slot + 1) & (board_index_size - 1);
+    }
+    board_index[slot] = board + 1;
+}
+
+static board_t *find_board(int socket_fd, const struct sockaddr_storage *address) {
+    uint32_t slot = hash_address(socket_fd, address) & (board_index_size - 1);
+    while (board_index[slot] != 0) {
+        board_t *board = &boards[board_index[slot] - 1];
+        if (same_address(board, socket_fd, address)) {
+            return board;
+        }
+        slot = (slot + 1) & (board_index_size - 1);
+    }
+    return NULL;
+}
+
+static board_t *add_board(
+        int socket_fd,
+        const struct sockaddr_storage *address,
+        socklen_t address_length,
+        int engines,
+        long long now) {
+    for (int32_t i = 0; i < max_boards; i++) {
+        board_t *board = &boards[i];
+        if (board->is_used) {
+            continue;
+        }
+        board->is_used = true;
+        board->socket_fd = socket_fd;
+        memcpy(&board->address, address, address_length);
+        board->address_length = address_length;
+        char host[NI_MAXHOST];
+        char port[NI_MAXSERV];
+        // an address that doesn't fit the name, e.g. one with a long IPv6 scope, is numbered like one without a name
+        if ((getnameinfo((const struct sockaddr *) address, address_length, host, sizeof(host), port, sizeof(port),
+                NI_NUMERICHOST | NI_NUMERICSERV) != 0) ||
+                (snprintf(board->name, sizeof(board->name), "%s:%s", host, port) >= (int) sizeof(board->name))) {
+            snprintf(board->name, sizeof(board->name), "board %d", i + 1);
+        }
+        board->joined_us = now;
+        board->last_queued_frame = -1;
+        // a board with more tanks than the server has engines for has the rest heard by nobody
+        board->engine_count = (engines < picovoice_params.engine_count) ? engines : picovoice_params.engine_count;
+        index_board(i);
+        fprintf(stdout, "%s joined with %d engine%s\n", board->name, engines, (engines == 1) ? "" : "s");
+        if (engines > picovoice_params.engine_count) {
+            fprintf(stdout, "%s: only its first %d engines are served\n", board->name, picovoice_params.engine_count);
+        }
+        return board;
+    }
+    return NULL;
+}
+
+static void send_line(const board_t *board, const char *line, size_t length) {
+    // a full socket buffer costs the board this answer, not the other boards a wait
+    sendto(board->socket_fd, line, length, MSG_DONTWAIT, (const struct sockaddr *) &board->address,
+            board->address_length);
+}
+
+static void wake_word_callback(void) {
+    char line[MAX_LINE_LENGTH];
+    const int length = snprintf(line, sizeof(line), "wake %d %lld", heard->engine + 1, heard->frame);
+    send_line(heard->board, line, (size_t) length);
+    heard->wake_words++;
+}
+
+// One word of the line; the board splits on spaces, so a multi-word slot value goes with underscores.
+static bool append_word(char *line, size_t *length, const char *prefix, const char *word) {
+    const size_t prefix_length = strlen(prefix);
+    const size_t word_length = strlen(word);
+    if (*length + prefix_length + word_length >= MAX_LINE_LENGTH) {
+        return false;
+    }
+    memcpy(line + *length, prefix, prefix_length);
+    *length += prefix_length;
+    for (size_t i = 0; i < word_length; i++) {
+        line[(*length)++] = (word[i] == ' ' || word[i] == '\t') ? '_' : word[i];
+    }
+    line[*length] = '\0';
+    return true;
+}
+
+static void inference_callback(pv_inference_t *inference) {
+    char line[MAX_LINE_LENGTH];
+    const int prefix = snprintf(line, sizeof(line), "intent %d %lld", heard->engine + 1, heard->frame);
+    size_t length = (size_t) prefix;
+    bool is_written = false;
+    if (inference->is_understood) {
+        is_written = append_word(line, &length, " understood ", inference->intent);
+        for (int32_t i = 0; is_written && i < inference->num_slots; i++) {
+            is_written = append_word(line, &length, " ", inference->slots[i]) &&
+                    append_word(line, &length, "=", inference->values[i]);
+        }
+        if (!is_written) {
+            fprintf(stderr, "%s: the intent '%s' doesn't fit in a datagram, sent as not understood\n",
+                    heard->board->name, inference->intent);
+        }
+    }
+    if (!is_written) {
+        length = (size_t) prefix;
+        append_word(line, &length, " ", "not-understood");
+    }
+    send_line(heard->board, line, length);
+    heard->inferences++;
+    engine.inferenceDelete(inference);
+}
+
+static void schedule_board(board_t *board) {
+    const int32_t index = (int32_t) (board - boards);
+    board_queue_t *queue = &workers[index % worker_count].queue;
+    pthread_mutex_lock(&queue->lock);
+    queue->boards[(queue->first + queue->count) % max_boards] = index;
+    queue->count++;
+    pthread_mutex_unlock(&queue->lock);
+
+    pthread_mutex_lock(&ready_lock);
+    ready_boards++;
+    pthread_cond_signal(&board_ready);
+    pthread_mutex_unlock(&ready_lock);
+}
+
+static bool take_from(board_queue_t *queue, bool is_owner, int32_t *board) {
+    pthread_mutex_lock(&queue->lock);
+    const bool is_taken = queue->count > 0;
+    if (is_taken) {
+        if (is_owner) {
+            *board = queue->boards[queue->first];
+            queue->first = (queue->first + 1) % max_boards;
+        } else {
+            *board = queue->boards[(queue->first + queue->count - 1) % max_boards];
+        }
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return is_taken;
+}
+
+// Waits for a board to be ready; false once the server is stopping.
+static bool next_board(const worker_t *worker, int32_t *board) {
+    pthread_mutex_lock(&ready_lock);
+    while (ready_boards == 0 && !is_stopping) {
+        pthread_cond_wait(&board_ready, &ready_lock);
+    }
+    if (ready_boards == 0) {
+        pthread_mutex_unlock(&ready_lock);
+        return false;
+    }
+    // claimed, so one of the queues holds a board for this worker, though another worker may have to be stolen from
+    ready_boards--;
+    pthread_mutex_unlock(&ready_lock);
+    while (true) {
+        if (take_from(&workers[worker->index].queue, true, board)) {
+            return true;
+        }
+        for (int32_t i = 1; i < worker_count; i++) {
+            if (take_from(&workers[(worker->index + i) % worker_count].queue, false, board)) {
+                return true;
+            }
+        }
+    }
+}
+
+static void destroy_handles(board_t *board) {
+    for (int i = 0; i < board->engine_count; i++) {
+        if (board->handles[i]) {
+            engine.destroy(board->handles[i]);
+            board->handles[i] = NULL;
+        }
+    }
+    board->is_created = false;
+}
+
+// On the worker, so a board that joins while others talk holds up only its own frames.
+static bool create_handles(board_t *board) {
+    const long long started = now_us(CLOCK_MONOTONIC);
+    for (int i = 0; i < board->engine_count; i++) {
+        const pv_status_t status = engine.init(
+                picovoice_params.access_key,
+                picovoice_params.porcupine_model_path,
+                picovoice_params.keyword_paths[i],
+                picovoice_params.porcupine_sensitivity,
+                wake_word_callback,
+                picovoice_params.rhino_model_path,
+                picovoice_params.context_paths[i],
+                picovoice_params.rhino_sensitivity,
+                picovoice_params.endpoint_duration_sec,
+                picovoice_params.require_endpoint,
+                inference_callback,
+                &board->handles[i]);
+        if (status != PV_STATUS_SUCCESS) {
+            fprintf(stderr, "%s: 'pv_picovoice_init' failed with '%s'; not serving it\n", board->name,
+                    engine.statusToString(status));
+            destroy_handles(board);
+            return false;
+        }
+    }
+    board->is_created = true;
+    fprintf(stdout, "%s: engines ready in %.1f ms\n", board->name,
+            (double) (now_us(CLOCK_MONOTONIC) - started) / 1000.0);
+    return true;
+}
+
+static void process_frame(worker_t *worker, board_t *board, heard_t *now_heard) {
+    const queued_frame_t *frame = &worker->frame;
+    now_heard->board = board;
+    now_heard->frame = frame->frame;
+    if (pv_adpcm_decode_block(frame->block, frame->block_length, worker->pcm) != PV_RECORDER_STATUS_SUCCESS) {
+        // checked on the way in
+        now_heard->is_failed = true;
+        return;
+    }
+    heard = now_heard;
+    for (int i = 0; i < board->engine_count; i++) {
+        now_heard->engine = i;
+        if (engine.process(board->handles[i], worker->pcm) != PV_STATUS_SUCCESS) {
+            now_heard->is_failed = true;
+        }
+    }
+    heard = NULL;
+}
+
+static void record_frame(board_stats_t *stats, const queued_frame_t *frame, const heard_t *now_heard, long long now) {
+    const long long latency = now - frame->received_us;
+    stats->processed++;
+    stats->wake_words += now_heard->wake_words;
+    stats->inferences += now_heard->inferences;
+    if (now_heard->is_failed) {
+        stats->process_failures++;
+    }
+    stats->latency_sum_us += latency;
+    if (latency > stats->latency_max_us) {
+        stats->latency_max_us = latency;
+    }
+    stats->transit_sum_us += frame->transit_us;
+    stats->latency_buckets[latency_bucket(latency)]++;
+}
+
+// Up to BOARD_TURN_FRAMES of the board's frames, oldest first; a board with more waiting goes to the back of its home
+// worker's queue, still scheduled, so no other worker can run it meanwhile.
+static void run_board(worker_t *worker, board_t *board) {
+    if (!board->is_created && !create_handles(board)) {
+        pthread_mutex_lock(&board->lock);
+        board->is_failed = true;
+        board->stats.dropped += board->frame_count;
+        board->frame_count = 0;
+        board->is_scheduled = false;
+        pthread_mutex_unlock(&board->lock);
+        return;
+    }
+
+    heard_t now_heard;
+    bool has_processed = false;
+    for (int32_t turn = 0; ; turn++) {
+        pthread_mutex_lock(&board->lock);
+        if (has_processed) {
+            record_frame(&board->stats, &worker->frame, &now_heard, now_us(CLOCK_MONOTONIC));
+        }
+        if (board->frame_count == 0) {
+            board->is_scheduled = false;
+            pthread_mutex_unlock(&board->lock);
+            return;
+        }
+        if (turn == BOARD_TURN_FRAMES) {
+            pthread_mutex_unlock(&board->lock);
+            schedule_board(board);
+            return;
+        }
+        const queued_frame_t *queued = &board->frames[board->first_frame];
+        memcpy(&worker->frame, queued, offsetof(queued_frame_t, block) + (size_t) queued->block_length);
+        board->first_frame = (board->first_frame + 1) % BOARD_QUEUE_FRAMES;
+        board->frame_count--;
+        pthread_mutex_unlock(&board->lock);
+
+        memset(&now_heard, 0, sizeof(now_heard));
+        process_frame(worker, board, &now_heard);
+        has_processed = true;
+    }
+}
+
+static void *run_worker(void *arg) {
+    worker_t *worker = arg;
+    int32_t board = 0;
+    while (next_board(worker, &board)) {
+        run_board(worker, &boards[board]);
+    }
+    return NULL;
+}
+
+static void queue_frame(board_t *board, const uint8_t *datagram, size_t length, long long now) {
+    const long long frame = (long long) get_le64(datagram + 16);
+    const long long captured_epoch_us = (long long) get_le64(datagram + 24);
+    bool is_ready = false;
+    pthread_mutex_lock(&board->lock);
+    board->stats.frames++;
+    if (board->is_failed) {
+        board->stats.dropped++;
+    } else if (frame <= board->last_queued_frame) {
+        // the network reordered it; the engines have heard past it
+        board->stats.late++;
+    } else {
+        if (board->frame_count == BOARD_QUEUE_FRAMES) {
+            board->first_frame = (board->first_frame + 1) % BOARD_QUEUE_FRAMES;
+            board->frame_count--;
+            board->stats.dropped++;
+        }
+        queued_frame_t *queued = &board->frames[(board->first_frame + board->frame_count) % BOARD_QUEUE_FRAMES];
+        queued->frame = frame;
+        queued->received_us = now;
+        queued->transit_us = now_us(CLOCK_REALTIME) - captured_epoch_us;
+        queued->block_length = (int32_t) (length - REMOTE_INFERENCE_HEADER_LENGTH);
+        memcpy(queued->block, datagram + REMOTE_INFERENCE_HEADER_LENGTH, (size_t) queued->block_length);
+        board->frame_count++;
+        board->last_queued_frame = frame;
+        is_ready = !board->is_scheduled;
+        board->is_scheduled = true;
+    }
+    pthread_mutex_unlock(&board->lock);
+    if (is_ready) {
+        schedule_board(board);
+    }
+}
+
+static void take_datagram(
+        int socket_fd,
+        const uint8_t *datagram,
+        size_t length,
+        const struct sockaddr_storage *from,
+        socklen_t from_length,
+        long long now) {
+    if (length < REMOTE_INFERENCE_HEADER_LENGTH || memcmp(datagram, "FFRI", 4) != 0 ||
+            (from->ss_family != AF_INET && from->ss_family != AF_INET6)) {
+        bad_datagrams++;
+        return;
+    }
+    const int kind = datagram[4];
+    const int engines = datagram[5];
+    const int32_t samples = (int32_t) get_le16(datagram + 6);
+    const int32_t sample_rate = (int32_t) get_le32(datagram + 8);
+
+    board_t *board = find_board(socket_fd, from);
+    if (!board) {
+        // a board that isn't served gets no answer to its pings, so it keeps listening on its own
+        if (sample_rate != engine.sampleRate || engines < 1 ||
+                !(board = add_board(socket_fd, from, from_length, engines, now))) {
+            refused_datagrams++;
+            return;
+        }
+    }
+    board->last_heard_us = now;
+
+    if (kind == KIND_PING) {
+        pthread_mutex_lock(&board->lock);
+        const bool is_failed = board->is_failed;
+        pthread_mutex_unlock(&board->lock);
+        if (!is_failed) {
+            char line[32];
+            const int line_length = snprintf(line, sizeof(line), "pong %u", (unsigned int) get_le32(datagram + 12));
+            send_line(board, line, (size_t) line_length);
+        }
+        return;
+    }
+    if (kind != KIND_FRAME || samples != engine.frameLength || sample_rate != engine.sampleRate ||
+            (int32_t) (length - REMOTE_INFERENCE_HEADER_LENGTH) != pv_adpcm_block_length(samples) ||
+            datagram[REMOTE_INFERENCE_HEADER_LENGTH + 2] > 88) {
+        bad_datagrams++;
+        return;
+    }
+    queue_frame(board, datagram, length, now);
+}
+
+// Every datagram waiting on the socket, a batch a call.
+static void receive(int socket_fd) {
+    static uint8_t datagrams[RECEIVE_BATCH][MAX_DATAGRAM_LENGTH];
+    static struct sockaddr_storage addresses[RECEIVE_BATCH];
+    static struct iovec vectors[RECEIVE_BATCH];
+    static struct mmsghdr messages[RECEIVE_BATCH];
+
+    while (true) {
+        for (int i = 0; i < RECEIVE_BATCH; i++) {
+            vectors[i].iov_base = datagrams[i];
+            vectors[i].iov_len = MAX_DATAGRAM_LENGTH;
+            memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int received = recvmmsg(socket_fd, messages, RECEIVE_BATCH, MSG_DONTWAIT, NULL);
+        if (received <= 0) {
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("recvmmsg");
+            }
+            return;
+        }
+        const long long now = now_us(CLOCK_MONOTONIC);
+        for (int i = 0; i < received; i++) {
+            take_datagram(socket_fd, datagrams[i], messages[i].msg_len, &addresses[i], messages[i].msg_hdr.msg_namelen,
+                    now);
+        }
+        if (received < RECEIVE_BATCH) {
+            return;
+        }
+    }
+}
+
+static void print_board(board_t *board, long long now) {
+    pthread_mutex_lock(&board->lock);
+    const board_stats_t stats = board->stats;
+    pthread_mutex_unlock(&board->lock);
+    const long long processed = (stats.processed > 0) ? stats.processed : 1;
+    fprintf(stdout, "%s: %.0f s, %lld frames (%lld dropped, %lld late, %lld failed), %lld wake words, %lld intents, "
+                    "latency mean %.2f p50 %.2f p99 %.2f max %.2f ms, transit %.2f ms\n",
+            board->name, (double) (now - board->joined_us) / 1e6, stats.frames, stats.dropped, stats.late,
+            stats.process_failures, stats.wake_words, stats.inferences,
+            (double) stats.latency_sum_us / (double) processed / 1000.0,
+            (double) latency_percentile(&stats, 0.5) / 1000.0, (double) latency_percentile(&stats, 0.99) / 1000.0,
+            (double) stats.latency_max_us / 1000.0, (double) stats.transit_sum_us / (double) processed / 1000.0);
+}
+
+static void print_report(long long now) {
+    int32_t board_count = 0;
+    for (int32_t i = 0; i < max_boards; i++) {
+        if (boards[i].is_used) {
+            print_board(&boards[i], now);
+            board_count++;
+        }
+    }
+    fprintf(stdout, "%d board%s served by %d workers, %lld datagrams refused, %lld bad\n", board_count,
+            (board_count == 1) ? "" : "s", worker_count, refused_datagrams, bad_datagrams);
+    fflush(stdout);
+}
+
+// Boards quiet for idle_us give their engines back, once no worker holds them. A board whose engines couldn't be made
+// is let go as often, so it can try again.
+static void drop_idle_boards(long long now, long long idle_us) {
+    bool is_dropped = false;
+    for (int32_t i = 0; i < max_boards; i++) {
+        board_t *board = &boards[i];
+        if (!board->is_used || (now - board->last_heard_us < idle_us && now - board->joined_us < idle_us)) {
+            continue;
+        }
+        pthread_mutex_lock(&board->lock);
+        const bool is_idle = !board->is_scheduled && board->frame_count == 0 &&
+                (board->is_failed || now - board->last_heard_us >= idle_us);
+        pthread_mutex_unlock(&board->lock);
+        if (!is_idle) {
+            continue;
+        }
+        print_board(board, now);
+        fprintf(stdout, "%s left\n", board->name);
+        destroy_handles(board);
+        board->is_used = false;
+        board->is_failed = false;
+        board->first_frame = 0;
+        memset(&board->stats, 0, sizeof(board->stats));
+        is_dropped = true;
+    }
+    if (is_dropped) {
+        memset(board_index, 0, (size_t) board_index_size * sizeof(int32_t));
+        for (int32_t i = 0; i < max_boards; i++) {
+            if (boards[i].is_used) {
+                index_board(i);
+            }
+        }
+    }
+}
+
+// Every address the host and port resolve to, IPv4 and IPv6 alike when no host is given.
+static int open_sockets(const char *host, const char *port, int *sockets) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo *addresses = NULL;
+    const int error = getaddrinfo(host, port, &hints, &addresses);
+    if (error != 0) {
+        fprintf(stderr, "failed to resolve '%s:%s': %s.\n", host ? host : "", port, gai_strerror(error));
+        return 0;
+    }
+    int count = 0;
+    for (const struct addrinfo *entry = addresses; entry && count < MAX_SOCKETS; entry = entry->ai_next) {
+        const int fd = socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        const int yes = 1;
+        if (entry->ai_family == AF_INET6) {
+            setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &yes, sizeof(yes));
+        }
+        // a second of audio from a few hundred boards, so a slow wakeup doesn't cost frames
+        const int buffer = 8 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+        if (bind(fd, entry->ai_addr, entry->ai_addrlen) != 0) {
+            perror("bind");
+            close(fd);
+            continue;
+        }
+        sockets[count++] = fd;
+    }
+    freeaddrinfo(addresses);
+    return count;
+}
+
+static struct option long_options[] = {
+        {"library_path",          required_argument, NULL, 'l'},
+        {"access_key",            required_argument, NULL, 'a'},
+        {"keyword_path",          required_argument, NULL, 'k'},
+        {"context_path",          required_argument, NULL, 'c'},
+        {"porcupine_sensitivity", required_argument, NULL, 's'},
+        {"porcupine_model_path",  required_argument, NULL, 'p'},
+        {"rhino_sensitivity",     required_argument, NULL, 't'},
+        {"rhino_model_path",      required_argument, NULL, 'r'},
+        {"endpoint_duration_sec", required_argument, NULL, 'u'},
+        {"require_endpoint",      required_argument, NULL, 'e'},
+        {"host",                  required_argument, NULL, 'H'},
+        {"port",                  required_argument, NULL, 'P'},
+        {"jobs",                  required_argument, NULL, 'j'},
+        {"max_boards",            required_argument, NULL, 'm'},
+        {"idle_sec",              required_argument, NULL, 'i'},
+        {"report_sec",            required_argument, NULL, 'R'},
+        {NULL, 0,                                    NULL, 0},
+};
+
+void print_usage(const char *program_name) {
+    fprintf(stderr,
+            "Usage : %s -l LIBRARY_PATH -a ACCESS_KEY -k KEYWORD_PATH [-k ...] -c CONTEXT_PATH [-c ...] -p PPN_MODEL_PATH "
+            "-r RHN_MODEL_PATH [--porcupine_sensitivity PPN_SENSITIVITY --rhino_sensitivity RHN_SENSITIVITY "
+            "--endpoint_duration_sec --require_endpoint \"true\"|\"false\" --host HOST --port PORT -j JOBS "
+            "--max_boards N --idle_sec N --report_sec N]\n",
+            program_name);
+}
+
+int main(int argc, char *argv[]) {
+    const char *library_path = NULL;
+    const char *host = NULL;
+    const char *port = "9000";
+    int keyword_count = 0;
+    int context_count = 0;
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    int32_t jobs = (processors > 0) ? (int32_t) processors : 1;
+    int32_t idle_sec = 60;
+    int32_t report_sec = 60;
+    max_boards = 256;
+    picovoice_params.porcupine_sensitivity = 0.5f;
+    picovoice_params.rhino_sensitivity = 0.5f;
+    picovoice_params.endpoint_duration_sec = 1.f;
+    picovoice_params.require_endpoint = true;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "e:l:a:k:c:s:p:t:r:u:H:P:j:m:i:R:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'l':
+                library_path = optarg;
+                break;
+            case 'a':
+                picovoice_params.access_key = optarg;
+                break;
+            case 'k':
+                if (keyword_count == ENGINE_FANOUT_MAX_ENGINES) {
+                    fprintf(stderr, "at most %d keywords.\n", ENGINE_FANOUT_MAX_ENGINES);
+                    exit(1);
+                }
+                picovoice_params.keyword_paths[keyword_count++] = optarg;
+                break;
+            case 'c':
+                if (context_count == ENGINE_FANOUT_MAX_ENGINES) {
+                    fprintf(stderr, "at most %d contexts.\n", ENGINE_FANOUT_MAX_ENGINES);
+                    exit(1);
+                }
+                picovoice_params.context_paths[context_count++] = optarg;
+                break;
+            case 's':
+                picovoice_params.porcupine_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'p':
+                picovoice_params.porcupine_model_path = optarg;
+                break;
+            case 't':
+                picovoice_params.rhino_sensitivity = strtof(optarg, NULL);
+                break;
+            case 'r':
+                picovoice_params.rhino_model_path = optarg;
+                break;
+            case 'u':
+                picovoice_params.endpoint_duration_sec = strtof(optarg, NULL);
+                break;
+            case 'e':
+                if (strcmp(optarg, "false") == 0) {
+                    picovoice_params.require_endpoint = false;
+                }
+                break;
+            case 'H':
+                host = optarg;
+                break;
+            case 'P':
+                port = optarg;
+                break;
+            case 'j':
+                jobs = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'm':
+                max_boards = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'i':
+                idle_sec = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            case 'R':
+                report_sec = (int32_t) strtol(optarg, NULL, 10);
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+
+    if (!library_path || !picovoice_params.access_key || !picovoice_params.porcupine_model_path ||
+            !picovoice_params.rhino_model_path || keyword_count == 0 || keyword_count != context_count || jobs < 1 ||
+            max_boards < 1 || idle_sec < 1 || report_sec < 0) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+    picovoice_params.engine_count = keyword_count;
+
+    if (!pvEngine_load(library_path, &engine)) {
+        exit(1);
+    }
+
+    int sockets[MAX_SOCKETS];
+    const int socket_count = open_sockets(host, port, sockets);
+    if (socket_count == 0) {
+        fprintf(stderr, "failed to listen on port %s.\n", port);
+        exit(1);
+    }
+    const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        exit(1);
+    }
+    for (int i = 0; i < socket_count; i++) {
+        struct epoll_event event = {.events = EPOLLIN, .data = {.fd = sockets[i]}};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sockets[i], &event) != 0) {
+            perror("epoll_ctl");
+            exit(1);
+        }
+    }
+
+    boards = calloc((size_t) max_boards, sizeof(board_t));
+    board_index_size = 1;
+    while (board_index_size < 2 * max_boards) {
+        board_index_size *= 2;
+    }
+    board_index = calloc((size_t) board_index_size, sizeof(int32_t));
+    worker_count = jobs;
+    workers = calloc((size_t) worker_count, sizeof(worker_t));
+    if (!boards || !board_index || !workers) {
+        fprintf(stderr, "failed to allocate memory for %d boards.\n", max_boards);
+        exit(1);
+    }
+    for (int32_t i = 0; i < max_boards; i++) {
+        pthread_mutex_init(&boards[i].lock, NULL);
+    }
+    for (int32_t i = 0; i < worker_count; i++) {
+        worker_t *worker = &workers[i];
+        worker->index = i;
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        worker->queue.boards = calloc((size_t) max_boards, sizeof(int32_t));
+        // a block decodes to a whole number of 4-byte groups, up to 7 samples past the frame
+        worker->pcm = calloc((size_t) engine.frameLength + 8, sizeof(int16_t));
+        if (!worker->queue.boards || !worker->pcm) {
+            fprintf(stderr, "failed to allocate memory for worker %d.\n", i);
+            exit(1);
+        }
+        if (pthread_create(&worker->thread, NULL, run_worker, worker) != 0) {
+            fprintf(stderr, "failed to start worker %d.\n", i);
+            exit(1);
+        }
+        // thread names are cut at 15 characters, so a worker whose number doesn't fit keeps the process's name
+        char name[16];
+        if (snprintf(name, sizeof(name), "offload-%d", i) < (int) sizeof(name)) {
+            threadCpu_setName(worker->thread, name);
+        }
+    }
+
+    signal(SIGINT, interrupt_handler);
+    signal(SIGTERM, interrupt_handler);
+    fprintf(stdout, "Picovoice %s: serving up to %d boards of %d engine%s on port %s with %d workers\n",
+            engine.version, max_boards, picovoice_params.engine_count, (picovoice_params.engine_count == 1) ? "" : "s",
+            port, worker_count);
+    fflush(stdout);
+
+    long long next_housekeeping = now_us(CLOCK_MONOTONIC) + HOUSEKEEPING_MS * 1000LL;
+    long long next_report = (report_sec > 0) ? now_us(CLOCK_MONOTONIC) + report_sec * 1000000LL : -1;
+    struct epoll_event events[MAX_SOCKETS];
+    while (!is_interrupted) {
+        const long long wait_us = next_housekeeping - now_us(CLOCK_MONOTONIC);
+        const int ready = epoll_wait(epoll_fd, events, MAX_SOCKETS, (wait_us > 0) ? (int) (wait_us / 1000) + 1 : 0);
+        if (ready < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            receive(events[i].data.fd);
+        }
+        const long long now = now_us(CLOCK_MONOTONIC);
+        if (now >= next_housekeeping) {
+            drop_idle_boards(now, idle_sec * 1000000LL);
+            next_housekeeping = now + HOUSEKEEPING_MS * 1000LL;
+        }
+        if (next_report >= 0 && now >= next_report) {
+            print_report(now);
+            next_report = now + report_sec * 1000000LL;
+        }
+    }
+
+    pthread_mutex_lock(&ready_lock);
+    is_stopping = true;
+    pthread_cond_broadcast(&board_ready);
+    pthread_mutex_unlock(&ready_lock);
+    for (int32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    print_report(now_us(CLOCK_MONOTONIC));
+
+    for (int32_t i = 0; i < max_boards; i++) {
+        destroy_handles(&boards[i]);
+        pthread_mutex_destroy(&boards[i].lock);
+    }
+    for (int32_t i = 0; i < worker_count; i++) {
+        free(workers[i].queue.boards);
+        free(workers[i].pcm);
+        pthread_mutex_destroy(&workers[i].queue.lock);
+    }
+    free(workers);
+    free(board_index);
+    free(boards);
+    close(epoll_fd);
+    for (int i = 0; i < socket_count; i++) {
+        close(sockets[i]);
+    }
+    pvEngine_unload(&engine);
+    return 0;
+}
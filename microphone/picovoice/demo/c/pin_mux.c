@@ -0,0 +1,82 @@
+#include "pin_mux.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_PIN_LENGTH 8
+
+// "p8.15" -> "P8_15"
+static bool normalize(const char* pin, char* name)
+{
+    size_t length = strlen(pin);
+    if (length == 0 || length >= MAX_PIN_LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i <= length; i++) {
+        name[i] = (pin[i] == '.') ? '_' : (char) toupper((unsigned char) pin[i]);
+    }
+    return true;
+}
+
+static bool statePath(const char* pin, char* path, size_t size)
+{
+    char name[MAX_PIN_LENGTH];
+    if (!normalize(pin, name)) {
+        printf("Pin mux: '%s' is not a header pin.\n", pin);
+        return false;
+    }
+    snprintf(path, size, PIN_MUX_OCP_PATH "/ocp:%s_pinmux/state", name);
+    return true;
+}
+
+bool pinMux_get(const char* pin, char* state, size_t size)
+{
+    char path[96];
+    if (size == 0 || !statePath(pin, path, sizeof(path))) {
+        return false;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t length = read(fd, state, size - 1);
+    close(fd);
+    if (length < 0) {
+        return false;
+    }
+    // drop the newline
+    while (length > 0 && isspace((unsigned char) state[length - 1])) {
+        length--;
+    }
+    state[length] = '\0';
+    return true;
+}
+
+bool pinMux_set(const char* pin, const char* state)
+{
+    char current[32];
+    if (pinMux_get(pin, current, sizeof(current)) && strcmp(current, state) == 0) {
+        return true;
+    }
+    char path[96];
+    if (!statePath(pin, path, sizeof(path))) {
+        return false;
+    }
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) {
+        perror("Pin mux: Unable to open pin state.");
+        printf(" pin: %s\n", pin);
+        return false;
+    }
+    const size_t length = strlen(state);
+    bool ok = write(fd, state, length) == (ssize_t) length;
+    close(fd);
+    if (!ok) {
+        perror("Pin mux: Unable to set pin state.");
+        printf(" pin: %s, state: %s\n", pin, state);
+    }
+    return ok;
+}
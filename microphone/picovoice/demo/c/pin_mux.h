@@ -0,0 +1,19 @@
+#ifndef PIN_MUX_H
+#define PIN_MUX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Header pin modes through the bone-pinmux-helper state files that config-pin itself writes to, minus the shell and
+// the script. A pin already in the wanted mode is left alone, so a restart only reads a few sysfs files.
+// Pins are named as on the header, "P9_18"; config-pin's "p9.18" works too.
+
+#define PIN_MUX_OCP_PATH "/sys/devices/platform/ocp"
+
+// Fills state with the pin's current mode, e.g. "gpio" or "default".
+bool pinMux_get(const char* pin, char* state, size_t size);
+
+// Puts the pin in state, e.g. "i2c" or "gpio", unless it already is.
+bool pinMux_set(const char* pin, const char* state);
+
+#endif
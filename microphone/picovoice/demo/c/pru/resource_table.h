@@ -0,0 +1,79 @@
+#ifndef RESOURCE_TABLE_H
+#define RESOURCE_TABLE_H
+
+#include <stddef.h>
+#include <rsc_types.h>
+#include "pru_virtio_ids.h"
+
+// The resource table remoteproc reads from the firmware image: one rpmsg vdev with two vrings, and the interrupt
+// mapping for PRU0. System event 16 goes to the ARM through channel 2 and host 2; system event 17, the ARM's kick,
+// comes in through channel 0 to host 0, which is bit 30 of R31.
+
+// buffers per vring, a power of two
+#define PRU_RPMSG_VQ0_SIZE 16
+#define PRU_RPMSG_VQ1_SIZE 16
+
+// name service announcements, so the rpmsg_pru driver creates /dev/rpmsg_pru30
+#define VIRTIO_RPMSG_F_NS 0
+#define RPMSG_PRU_C0_FEATURES (1 << VIRTIO_RPMSG_F_NS)
+
+#define HOST_UNUSED 255
+
+struct ch_map pru_intc_map[] = {
+    {16, 2},
+    {17, 0},
+};
+
+struct my_resource_table {
+    struct resource_table base;
+
+    uint32_t offset[2];
+
+    struct fw_rsc_vdev rpmsg_vdev;
+    struct fw_rsc_vdev_vring rpmsg_vring0;
+    struct fw_rsc_vdev_vring rpmsg_vring1;
+
+    struct fw_rsc_custom pru_ints;
+};
+
+#pragma DATA_SECTION(resourceTable, ".resource_table")
+#pragma RETAIN(resourceTable)
+struct my_resource_table resourceTable = {
+    1, // version
+    2, // entries
+    0, 0,
+    {
+        offsetof(struct my_resource_table, rpmsg_vdev),
+        offsetof(struct my_resource_table, pru_ints),
+    },
+
+    {
+        (uint32_t) TYPE_VDEV,
+        (uint32_t) VIRTIO_ID_RPMSG,
+        (uint32_t) 0,
+        (uint32_t) RPMSG_PRU_C0_FEATURES,
+        (uint32_t) 0,
+        (uint32_t) 0,
+        (uint8_t) 0,
+        (uint8_t) 2,
+        {(uint8_t) 0, (uint8_t) 0},
+    },
+    // the device addresses and notify IDs are filled in by the host
+    {0, 16, PRU_RPMSG_VQ0_SIZE, 0, 0},
+    {0, 16, PRU_RPMSG_VQ1_SIZE, 0, 0},
+
+    {
+        TYPE_CUSTOM, TYPE_PRU_INTS,
+        sizeof(struct fw_rsc_custom_ints),
+        {
+            0x0000,
+            // channel to host, for channels 0 to 9
+            0, HOST_UNUSED, 2, HOST_UNUSED, HOST_UNUSED,
+            HOST_UNUSED, HOST_UNUSED, HOST_UNUSED, HOST_UNUSED, HOST_UNUSED,
+            (sizeof(pru_intc_map) / sizeof(struct ch_map)),
+            pru_intc_map,
+        },
+    },
+};
+
+#endif
@@ -0,0 +1,286 @@
+// PRU0 firmware: generates the servo pulse, runs the gate's motion profiles and debounces the button, taking commands
+// from the daemon over rpmsg and sending events back (see pru_protocol.h).
+//
+// There are no interrupts on the PRU, so everything happens in one polling loop timed by the IEP counter, which runs
+// at 200 MHz. The pulse itself is a busy wait from the rising edge, so its width is exact to a few cycles whatever else
+// the loop was doing; only the start of a period can be late, by the length of one loop iteration, and a servo does not
+// care about that. The profile maths is the same as servo_driver.c's, in fixed point since the PRU has no FPU.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pru_cfg.h>
+#include <pru_iep.h>
+#include <pru_intc.h>
+#include <pru_rpmsg.h>
+#include <pru_virtqueue.h>
+
+#include "pru_protocol.h"
+#include "resource_table.h"
+
+volatile register uint32_t __R30;
+volatile register uint32_t __R31;
+
+// R31 bit 30 is host interrupt 0, where the ARM's kick arrives
+#define HOST_INT ((uint32_t) 1 << 30)
+#define TO_ARM_HOST 16
+#define FROM_ARM_HOST 17
+
+#define CHANNEL_DESCRIPTION "Channel 30"
+
+#define SERVO_BIT ((uint32_t) 1 << 0)
+#define BUTTON_BIT ((uint32_t) 1 << 1)
+
+#define CYCLES_PER_US 200
+#define PERIOD_CYCLES (PRU_PROTOCOL_PERIOD_US * CYCLES_PER_US)
+#define CLOSED_PULSE_CYCLES (PRU_PROTOCOL_CLOSED_PULSE_US * CYCLES_PER_US)
+#define OPEN_PULSE_CYCLES (PRU_PROTOCOL_OPEN_PULSE_US * CYCLES_PER_US)
+#define SAMPLE_CYCLES (1000 * CYCLES_PER_US)
+#define TICK_MS (PRU_PROTOCOL_PERIOD_US / 1000)
+
+// Q16 fixed point
+#define ONE ((int64_t) 1 << 16)
+
+typedef enum {
+    PHASE_IDLE,
+    PHASE_DELAY,
+    PHASE_OPENING,
+    PHASE_HOLDING,
+    PHASE_CLOSING,
+} profilePhase;
+
+static struct pru_rpmsg_transport transport;
+static uint16_t hostAddress = 0;
+static bool hasHost = false;
+
+static bool isPulsing = false;
+static uint32_t pulseCycles = CLOSED_PULSE_CYCLES;
+static uint32_t periodStart = 0;
+
+static profilePhase phase = PHASE_IDLE;
+static pruCommand profile;
+static uint32_t step = 0;
+static uint32_t ticksLeft = 0;
+static bool hasMoved = false;
+
+static uint32_t buttonDebounceCycles = 50 * 1000 * CYCLES_PER_US;
+static bool isButtonConfigured = false;
+static uint32_t buttonStable = 0;
+static uint32_t buttonCandidate = 0;
+static uint32_t buttonCandidateSince = 0;
+static uint32_t lastSample = 0;
+
+static inline uint32_t now(void)
+{
+    return CT_IEP.TMR_CNT;
+}
+
+// Dropped if the daemon is not reading and the vring is full; every event is also reflected in later ones.
+static void sendEvent(pruEventType type)
+{
+    if (!hasHost) {
+        return;
+    }
+    pruEvent event;
+    event.type = type;
+    pru_rpmsg_send(&transport, PRU_PROTOCOL_CHANNEL_PORT, hostAddress, &event, sizeof(event));
+}
+
+// position along the ramp, 0 (start) to ONE (end), at normalised time t in [0, ONE]
+static int64_t rampPosition(uint32_t shape, int64_t t)
+{
+    if (shape == PRU_RAMP_S_CURVE) {
+        const int64_t t3 = (((t * t) >> 16) * t) >> 16;
+        // t^3 (6t^2 - 15t + 10), arranged to keep every shift on a positive number
+        return (t3 * (10 * ONE - (((15 * ONE - 6 * t) * t) >> 16))) >> 16;
+    }
+
+    // accelerating for the first quarter and decelerating for the last, at a peak velocity of 4/3
+    if (t < ONE / 4) {
+        return (8 * t * t) / (3 * ONE);
+    }
+    if (t > ONE - ONE / 4) {
+        const int64_t u = ONE - t;
+        return ONE - (8 * u * u) / (3 * ONE);
+    }
+    return (4 * (t - ONE / 8)) / 3;
+}
+
+static uint32_t rampSteps(uint32_t rampMs)
+{
+    return rampMs > TICK_MS ? rampMs / TICK_MS : 1;
+}
+
+static void startProfile(const pruCommand* command)
+{
+    if (phase != PHASE_IDLE) {
+        sendEvent(PRU_EVENT_PROFILE_REJECTED);
+        return;
+    }
+    profile = *command;
+    // a start delay rounds up to whole periods; none still waits one, like the daemon's timer
+    ticksLeft = profile.startDelayMs > 0 ? (profile.startDelayMs + TICK_MS - 1) / TICK_MS : 1;
+    phase = PHASE_DELAY;
+    hasMoved = false;
+    if (!isPulsing) {
+        pulseCycles = CLOSED_PULSE_CYCLES;
+        isPulsing = true;
+    }
+}
+
+// Called once per period, after the pulse, to set the width of the next one.
+static void advanceProfile(void)
+{
+    if (phase == PHASE_IDLE) {
+        return;
+    }
+    if (phase == PHASE_DELAY || phase == PHASE_HOLDING) {
+        if (--ticksLeft > 0) {
+            return;
+        }
+        phase = phase == PHASE_DELAY ? PHASE_OPENING : PHASE_CLOSING;
+        step = 0;
+        if (phase == PHASE_CLOSING) {
+            return;
+        }
+    }
+
+    const uint32_t steps = rampSteps(profile.rampMs);
+    step++;
+    int64_t position = rampPosition(profile.shape, ((int64_t) step * ONE) / steps);
+    if (phase == PHASE_CLOSING) {
+        position = ONE - position;
+    }
+    pulseCycles = CLOSED_PULSE_CYCLES + (uint32_t) (((OPEN_PULSE_CYCLES - CLOSED_PULSE_CYCLES) * position) >> 16);
+    if (!hasMoved) {
+        hasMoved = true;
+        sendEvent(PRU_EVENT_GATE_MOVED);
+    }
+
+    if (step < steps) {
+        return;
+    }
+    if (phase == PHASE_OPENING) {
+        phase = PHASE_HOLDING;
+        ticksLeft = profile.holdMs / TICK_MS;
+        if (ticksLeft == 0) {
+            phase = PHASE_CLOSING;
+            step = 0;
+        }
+    } else {
+        phase = PHASE_IDLE;
+        sendEvent(PRU_EVENT_PROFILE_DONE);
+    }
+}
+
+static void pulse(void)
+{
+    const uint32_t rise = now();
+    __R30 |= SERVO_BIT;
+    while (now() - rise < pulseCycles) {}
+    __R30 &= ~SERVO_BIT;
+}
+
+// The line has to read the same for the whole debounce time before a change is believed.
+static void sampleButton(uint32_t time)
+{
+    const uint32_t value = (__R31 & BUTTON_BIT) ? 1 : 0;
+    if (value == buttonStable) {
+        buttonCandidate = value;
+        return;
+    }
+    if (value != buttonCandidate) {
+        buttonCandidate = value;
+        buttonCandidateSince = time;
+        return;
+    }
+    if (time - buttonCandidateSince < buttonDebounceCycles) {
+        return;
+    }
+    buttonStable = value;
+    if (value == 1) {
+        sendEvent(PRU_EVENT_BUTTON_PRESSED);
+    }
+}
+
+static void handleCommand(const pruCommand* command)
+{
+    switch (command->type) {
+        case PRU_COMMAND_CONFIGURE_BUTTON:
+            buttonDebounceCycles = (command->debounceMs > 0 ? command->debounceMs : 1) * 1000 * CYCLES_PER_US;
+            buttonStable = (__R31 & BUTTON_BIT) ? 1 : 0;
+            buttonCandidate = buttonStable;
+            isButtonConfigured = true;
+            break;
+        case PRU_COMMAND_START_PROFILE:
+            startProfile(command);
+            break;
+        case PRU_COMMAND_STOP:
+            // never leave the gate open
+            phase = PHASE_IDLE;
+            pulseCycles = CLOSED_PULSE_CYCLES;
+            break;
+        default:
+            break;
+    }
+}
+
+static void receiveCommands(void)
+{
+    uint8_t payload[RPMSG_BUF_SIZE];
+    uint16_t source;
+    uint16_t destination;
+    uint16_t length;
+
+    CT_INTC.SICR_bit.STS_CLR_IDX = FROM_ARM_HOST;
+    // one kick can carry several messages
+    while (pru_rpmsg_receive(&transport, &source, &destination, payload, &length) == PRU_RPMSG_SUCCESS) {
+        hostAddress = source;
+        hasHost = true;
+        if (length == sizeof(pruCommand)) {
+            handleCommand((const pruCommand*) payload);
+        }
+    }
+}
+
+void main(void)
+{
+    // let the PRU reach the vrings in DDR
+    CT_CFG.SYSCFG_bit.STANDBY_INIT = 0;
+
+    CT_IEP.TMR_GLB_CFG_bit.DEFAULT_INC = 1;
+    CT_IEP.TMR_GLB_CFG_bit.CNT_EN = 1;
+
+    __R30 &= ~SERVO_BIT;
+
+    CT_INTC.SICR_bit.STS_CLR_IDX = FROM_ARM_HOST;
+    volatile uint8_t* status = &resourceTable.rpmsg_vdev.status;
+    while (!(*status & VIRTIO_CONFIG_S_DRIVER_OK)) {}
+    pru_rpmsg_init(&transport, &resourceTable.rpmsg_vring0, &resourceTable.rpmsg_vring1, TO_ARM_HOST, FROM_ARM_HOST);
+    while (pru_rpmsg_channel(RPMSG_NS_CREATE, &transport, PRU_PROTOCOL_CHANNEL_NAME, CHANNEL_DESCRIPTION,
+                             PRU_PROTOCOL_CHANNEL_PORT) != PRU_RPMSG_SUCCESS) {}
+
+    periodStart = now();
+    lastSample = periodStart;
+    while (true) {
+        const uint32_t time = now();
+        if (time - periodStart >= PERIOD_CYCLES) {
+            periodStart += PERIOD_CYCLES;
+            if (time - periodStart >= PERIOD_CYCLES) {
+                // more than a period behind; start again from now rather than pulse twice
+                periodStart = time;
+            }
+            if (isPulsing) {
+                pulse();
+            }
+            advanceProfile();
+        }
+        // the sampling pauses during a pulse, which only makes the debounce a little longer
+        if (isButtonConfigured && now() - lastSample >= SAMPLE_CYCLES) {
+            lastSample = now();
+            sampleButton(lastSample);
+        }
+        if (__R31 & HOST_INT) {
+            receiveCommands();
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#include "pru_link.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+#define POLL_INTERVAL_MS 50
+#define MAX_EVENT_TYPE PRU_EVENT_BUTTON_PRESSED
+
+static int deviceFd = -1;
+static pruLink_eventFunc handlers[MAX_EVENT_TYPE + 1];
+
+static bool writeAttribute(const char* remoteprocPath, const char* name, const char* value)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", remoteprocPath, name);
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const size_t length = strlen(value);
+    bool ok = write(fd, value, length) == (ssize_t) length;
+    close(fd);
+    return ok;
+}
+
+static bool isRunning(const char* remoteprocPath)
+{
+    char path[256];
+    char state[32] = "";
+    snprintf(path, sizeof(path), "%s/state", remoteprocPath);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t length = read(fd, state, sizeof(state) - 1);
+    close(fd);
+    return length > 0 && strncmp(state, "running", strlen("running")) == 0;
+}
+
+static void sleepMs(long ms)
+{
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+// Every read of the device is one message.
+static void onReadable(int fd, void* userData)
+{
+    (void) userData;
+    pruEvent event;
+    ssize_t length;
+    while ((length = read(fd, &event, sizeof(event))) > 0) {
+        if (length != sizeof(event) || event.type == 0 || event.type > MAX_EVENT_TYPE) {
+            continue;
+        }
+        if (handlers[event.type] != NULL) {
+            handlers[event.type]();
+        }
+    }
+    if (length < 0 && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "PRU: Unable to read event: %s", strerror(errno));
+    }
+}
+
+bool pruLink_start(const char* remoteprocPath)
+{
+    if (isRunning(remoteprocPath) && !writeAttribute(remoteprocPath, "state", "stop")) {
+        perror("PRU: Unable to stop the running firmware.");
+        return false;
+    }
+    if (!writeAttribute(remoteprocPath, "firmware", PRU_PROTOCOL_FIRMWARE) ||
+        !writeAttribute(remoteprocPath, "state", "start")) {
+        perror("PRU: Unable to start the firmware.");
+        printf(" remoteproc: %s, firmware: /lib/firmware/%s\n", remoteprocPath, PRU_PROTOCOL_FIRMWARE);
+        return false;
+    }
+
+    for (int waitedMs = 0; deviceFd < 0; waitedMs += POLL_INTERVAL_MS) {
+        deviceFd = open(PRU_LINK_DEVICE, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (deviceFd >= 0) {
+            break;
+        }
+        if (errno != ENOENT || waitedMs >= PRU_LINK_DEVICE_TIMEOUT_MS) {
+            perror("PRU: Unable to open the rpmsg channel.");
+            printf(" device: %s\n", PRU_LINK_DEVICE);
+            return false;
+        }
+        sleepMs(POLL_INTERVAL_MS);
+    }
+
+    if (!eventLoop_add(deviceFd, EPOLLIN, onReadable, NULL)) {
+        pruLink_stop();
+        return false;
+    }
+    return true;
+}
+
+void pruLink_setHandler(pruEventType type, pruLink_eventFunc onEvent)
+{
+    if (type > 0 && type <= MAX_EVENT_TYPE) {
+        handlers[type] = onEvent;
+    }
+}
+
+bool pruLink_send(const pruCommand* command)
+{
+    if (deviceFd < 0) {
+        return false;
+    }
+    if (write(deviceFd, command, sizeof(*command)) != (ssize_t) sizeof(*command)) {
+        asyncLog_log(ASYNC_LOG_ERROR, "PRU: Unable to send command %u: %s", (unsigned int) command->type,
+                     strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool pruLink_isRunning(void)
+{
+    return deviceFd >= 0;
+}
+
+void pruLink_stop(void)
+{
+    if (deviceFd >= 0) {
+        eventLoop_remove(deviceFd);
+        close(deviceFd);
+        deviceFd = -1;
+    }
+}
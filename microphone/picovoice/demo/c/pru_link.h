@@ -0,0 +1,34 @@
+#ifndef PRU_LINK_H
+#define PRU_LINK_H
+
+#include <stdbool.h>
+
+#include "pru_protocol.h"
+
+// The daemon's end of the rpmsg channel to the PRU0 firmware in pru/. pruLink_start boots the firmware through the
+// remoteproc sysfs interface and adds the character device the rpmsg_pru driver creates for its channel to the event
+// loop, which has to be initialised; events are handed out on the loop thread to one handler per type.
+
+#define PRU_LINK_DEFAULT_REMOTEPROC "/sys/class/remoteproc/remoteproc1"
+#define PRU_LINK_DEVICE "/dev/rpmsg_pru30"
+// the driver creates the device a little after the firmware announces its channel
+#define PRU_LINK_DEVICE_TIMEOUT_MS 2000
+
+typedef void (*pruLink_eventFunc)(void);
+
+// Loads PRU_PROTOCOL_FIRMWARE into the PRU behind remoteprocPath, restarting it if it was running, and opens its
+// channel.
+bool pruLink_start(const char* remoteprocPath);
+
+// Before or after pruLink_start; NULL removes the handler.
+void pruLink_setHandler(pruEventType type, pruLink_eventFunc onEvent);
+
+// Never blocks: the firmware takes commands as fast as they come.
+bool pruLink_send(const pruCommand* command);
+
+bool pruLink_isRunning(void);
+
+// Closes the channel and leaves the PRU running, so the pulse holds the gate where the last command put it.
+void pruLink_stop(void);
+
+#endif
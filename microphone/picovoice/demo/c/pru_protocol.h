@@ -0,0 +1,59 @@
+#ifndef PRU_PROTOCOL_H
+#define PRU_PROTOCOL_H
+
+#include <stdint.h>
+
+// Messages between the daemon and the PRU0 firmware in pru/, over the rpmsg channel the firmware announces. Both sides
+// are little-endian and every field is 32 bits, so the structs have the same layout under gcc and clpru.
+//
+// The daemon sends commands; the firmware generates the servo pulses and runs motion profiles, debounces the button,
+// and sends events back. Nothing on the ARM side is timing critical any more.
+
+#define PRU_PROTOCOL_CHANNEL_NAME "rpmsg-pru"
+#define PRU_PROTOCOL_CHANNEL_PORT 30
+#define PRU_PROTOCOL_FIRMWARE "fishfeeder-pru0-fw"
+
+// header pins: the servo signal on pr1_pru0_pru_r30_0, the button on pr1_pru0_pru_r31_1
+#define PRU_PROTOCOL_SERVO_PIN "P9_31"
+#define PRU_PROTOCOL_BUTTON_PIN "P9_29"
+
+// same as the sysfs PWM path: 50 Hz, 1 ms closed, 2 ms open, and a profile advanced once per period
+#define PRU_PROTOCOL_PERIOD_US 20000
+#define PRU_PROTOCOL_CLOSED_PULSE_US 1000
+#define PRU_PROTOCOL_OPEN_PULSE_US 2000
+
+typedef enum {
+    PRU_COMMAND_CONFIGURE_BUTTON = 1, // the first command; until it, the firmware has no one to send events to
+    PRU_COMMAND_START_PROFILE,
+    PRU_COMMAND_STOP, // close the gate now and drop the running profile
+} pruCommandType;
+
+// in the order of servoRampShape
+typedef enum {
+    PRU_RAMP_TRAPEZOID = 0,
+    PRU_RAMP_S_CURVE,
+} pruRampShape;
+
+typedef struct {
+    uint32_t type;
+    // PRU_COMMAND_START_PROFILE
+    uint32_t shape;
+    uint32_t startDelayMs;
+    uint32_t rampMs;
+    uint32_t holdMs;
+    // PRU_COMMAND_CONFIGURE_BUTTON
+    uint32_t debounceMs;
+} pruCommand;
+
+typedef enum {
+    PRU_EVENT_GATE_MOVED = 1, // the first pulse of a profile away from closed
+    PRU_EVENT_PROFILE_DONE,   // the gate is closed again
+    PRU_EVENT_PROFILE_REJECTED, // a profile was already running
+    PRU_EVENT_BUTTON_PRESSED, // a debounced press
+} pruEventType;
+
+typedef struct {
+    uint32_t type;
+} pruEvent;
+
+#endif
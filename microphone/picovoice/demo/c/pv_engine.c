@@ -0,0 +1,156 @@
+#include "pv_engine.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <windows.h>
+
+#else
+
+#include <dlfcn.h>
+
+#endif
+
+static void* openLibrary(const char* path)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return LoadLibrary(path);
+#else
+    return dlopen(path, RTLD_NOW);
+#endif
+}
+
+static void* loadSymbol(void* library, const char* symbol)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    void* address = (void*) GetProcAddress((HMODULE) library, symbol);
+    if (!address) {
+        fprintf(stderr, "failed to load '%s' with code '%lu'.\n", symbol, GetLastError());
+    }
+#else
+    void* address = dlsym(library, symbol);
+    if (!address) {
+        fprintf(stderr, "failed to load '%s' with '%s'.\n", symbol, dlerror());
+    }
+#endif
+    return address;
+}
+
+static void closeLibrary(void* library)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    FreeLibrary((HMODULE) library);
+#else
+    dlclose(library);
+#endif
+}
+
+bool pvEngine_load(const char* libraryPath, pvEngine* engine)
+{
+    memset(engine, 0, sizeof(*engine));
+    engine->library = openLibrary(libraryPath);
+    if (!engine->library) {
+        fprintf(stderr, "failed to open library.\n");
+        return false;
+    }
+
+    int32_t (*sampleRate)(void) = loadSymbol(engine->library, "pv_sample_rate");
+    int32_t (*frameLength)(void) = loadSymbol(engine->library, "pv_picovoice_frame_length");
+    const char* (*version)(void) = loadSymbol(engine->library, "pv_picovoice_version");
+    engine->statusToString = loadSymbol(engine->library, "pv_status_to_string");
+    engine->init = loadSymbol(engine->library, "pv_picovoice_init");
+    engine->destroy = loadSymbol(engine->library, "pv_picovoice_delete");
+    engine->process = loadSymbol(engine->library, "pv_picovoice_process");
+    engine->inferenceDelete = loadSymbol(engine->library, "pv_inference_delete");
+    if (!sampleRate || !frameLength || !version || !engine->statusToString || !engine->init || !engine->destroy
+            || !engine->process || !engine->inferenceDelete) {
+        pvEngine_unload(engine);
+        return false;
+    }
+
+    engine->sampleRate = sampleRate();
+    engine->frameLength = frameLength();
+    engine->version = version();
+    return true;
+}
+
+void pvEngine_unload(pvEngine* engine)
+{
+    if (engine->library) {
+        closeLibrary(engine->library);
+    }
+    memset(engine, 0, sizeof(*engine));
+}
+
+bool pvEngine_loadRhino(const char* libraryPath, pvRhinoEngine* rhino)
+{
+    memset(rhino, 0, sizeof(*rhino));
+    rhino->library = openLibrary(libraryPath);
+    if (!rhino->library) {
+        fprintf(stderr, "failed to open library.\n");
+        return false;
+    }
+
+    int32_t (*frameLength)(void) = loadSymbol(rhino->library, "pv_rhino_frame_length");
+    rhino->init = loadSymbol(rhino->library, "pv_rhino_init");
+    rhino->destroy = loadSymbol(rhino->library, "pv_rhino_delete");
+    rhino->process = loadSymbol(rhino->library, "pv_rhino_process");
+    rhino->isUnderstood = loadSymbol(rhino->library, "pv_rhino_is_understood");
+    rhino->getIntent = loadSymbol(rhino->library, "pv_rhino_get_intent");
+    rhino->freeSlotsAndValues = loadSymbol(rhino->library, "pv_rhino_free_slots_and_values");
+    rhino->reset = loadSymbol(rhino->library, "pv_rhino_reset");
+    if (!frameLength || !rhino->init || !rhino->destroy || !rhino->process || !rhino->isUnderstood
+            || !rhino->getIntent || !rhino->freeSlotsAndValues || !rhino->reset) {
+        pvEngine_unloadRhino(rhino);
+        return false;
+    }
+
+    rhino->frameLength = frameLength();
+    return true;
+}
+
+void pvEngine_unloadRhino(pvRhinoEngine* rhino)
+{
+    if (rhino->library) {
+        closeLibrary(rhino->library);
+    }
+    memset(rhino, 0, sizeof(*rhino));
+}
+
+bool pvEngine_loadPorcupine(const char* libraryPath, pvPorcupineEngine* porcupine)
+{
+    memset(porcupine, 0, sizeof(*porcupine));
+    porcupine->library = openLibrary(libraryPath);
+    if (!porcupine->library) {
+        fprintf(stderr, "failed to open library.\n");
+        return false;
+    }
+
+    int32_t (*sampleRate)(void) = loadSymbol(porcupine->library, "pv_sample_rate");
+    int32_t (*frameLength)(void) = loadSymbol(porcupine->library, "pv_porcupine_frame_length");
+    const char* (*version)(void) = loadSymbol(porcupine->library, "pv_porcupine_version");
+    porcupine->statusToString = loadSymbol(porcupine->library, "pv_status_to_string");
+    porcupine->init = loadSymbol(porcupine->library, "pv_porcupine_init");
+    porcupine->destroy = loadSymbol(porcupine->library, "pv_porcupine_delete");
+    porcupine->process = loadSymbol(porcupine->library, "pv_porcupine_process");
+    if (!sampleRate || !frameLength || !version || !porcupine->statusToString || !porcupine->init
+            || !porcupine->destroy || !porcupine->process) {
+        pvEngine_unloadPorcupine(porcupine);
+        return false;
+    }
+
+    porcupine->sampleRate = sampleRate();
+    porcupine->frameLength = frameLength();
+    porcupine->version = version();
+    return true;
+}
+
+void pvEngine_unloadPorcupine(pvPorcupineEngine* porcupine)
+{
+    if (porcupine->library) {
+        closeLibrary(porcupine->library);
+    }
+    memset(porcupine, 0, sizeof(*porcupine));
+}
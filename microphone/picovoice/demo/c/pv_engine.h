@@ -0,0 +1,98 @@
+#ifndef PV_ENGINE_H
+#define PV_ENGINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pv_picovoice.h"
+
+// The Picovoice library, opened at run time and resolved once: every function the demos call, plus the constants that
+// never change once it is loaded, so the audio loop neither looks symbols up nor calls through them for a frame length.
+
+typedef pv_status_t (*pvEngine_initFunc)(
+        const char* accessKey,
+        const char* porcupineModelPath,
+        const char* keywordPath,
+        float porcupineSensitivity,
+        void (*wakeWordCallback)(void),
+        const char* rhinoModelPath,
+        const char* contextPath,
+        float rhinoSensitivity,
+        float endpointDurationSec,
+        bool requireEndpoint,
+        void (*inferenceCallback)(pv_inference_t*),
+        pv_picovoice_t** picovoice);
+
+typedef struct {
+    void* library;
+    const char* (*statusToString)(pv_status_t status);
+    pvEngine_initFunc init;
+    void (*destroy)(pv_picovoice_t* picovoice);
+    pv_status_t (*process)(pv_picovoice_t* picovoice, const int16_t* pcm);
+    void (*inferenceDelete)(pv_inference_t* inference);
+    int32_t sampleRate;
+    int32_t frameLength;
+    const char* version;
+} pvEngine;
+
+// Prints what went wrong and returns false if the library or one of its functions can't be loaded.
+bool pvEngine_load(const char* libraryPath, pvEngine* engine);
+
+void pvEngine_unload(pvEngine* engine);
+
+// Rhino on its own, from its library, for commands that come without a wake word. It shares pv_status_t with
+// Picovoice, and reads the same .rhn contexts.
+typedef struct pv_rhino pv_rhino_t;
+
+typedef struct {
+    void* library;
+    pv_status_t (*init)(
+            const char* accessKey,
+            const char* modelPath,
+            const char* contextPath,
+            float sensitivity,
+            float endpointDurationSec,
+            bool requireEndpoint,
+            pv_rhino_t** rhino);
+    void (*destroy)(pv_rhino_t* rhino);
+    pv_status_t (*process)(pv_rhino_t* rhino, const int16_t* pcm, bool* isFinalized);
+    pv_status_t (*isUnderstood)(const pv_rhino_t* rhino, bool* isUnderstood);
+    pv_status_t (*getIntent)(const pv_rhino_t* rhino, const char** intent, int32_t* numSlots, const char*** slots,
+            const char*** values);
+    pv_status_t (*freeSlotsAndValues)(const pv_rhino_t* rhino, const char** slots, const char** values);
+    pv_status_t (*reset)(pv_rhino_t* rhino);
+    int32_t frameLength;
+} pvRhinoEngine;
+
+// As pvEngine_load.
+bool pvEngine_loadRhino(const char* libraryPath, pvRhinoEngine* rhino);
+
+void pvEngine_unloadRhino(pvRhinoEngine* rhino);
+
+// Porcupine on its own, from its library, for standby: the wake word alone stays resident and Rhino is built after it.
+// It shares pv_status_t with Picovoice, and reads the same .ppn keywords.
+typedef struct pv_porcupine pv_porcupine_t;
+
+typedef struct {
+    void* library;
+    const char* (*statusToString)(pv_status_t status);
+    pv_status_t (*init)(
+            const char* accessKey,
+            const char* modelPath,
+            int32_t numKeywords,
+            const char* const* keywordPaths,
+            const float* sensitivities,
+            pv_porcupine_t** porcupine);
+    void (*destroy)(pv_porcupine_t* porcupine);
+    pv_status_t (*process)(pv_porcupine_t* porcupine, const int16_t* pcm, int32_t* keywordIndex);
+    int32_t sampleRate;
+    int32_t frameLength;
+    const char* version;
+} pvPorcupineEngine;
+
+// As pvEngine_load.
+bool pvEngine_loadPorcupine(const char* libraryPath, pvPorcupineEngine* porcupine);
+
+void pvEngine_unloadPorcupine(pvPorcupineEngine* porcupine);
+
+#endif
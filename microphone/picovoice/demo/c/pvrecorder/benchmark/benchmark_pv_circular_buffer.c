@@ -0,0 +1,494 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef _POSIX_C_SOURCE
+// clock_gettime, CLOCK_MONOTONIC and uname under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pv_circular_buffer.h"
+#include "pv_circular_buffer_typed.h"
+
+// Times pv_circular_buffer_write and pv_circular_buffer_read for every buffer variant and prints one JSON object.
+//
+// Variants: "mutex" is the default buffer behind a pthread mutex, the way the recorder used it before the SPSC
+// buffer; "spsc" and "mirrored" are the lock-free constructors; "typed" is the SPSC buffer specialized for the element
+// type with PV_CIRCULAR_BUFFER_TYPED. Single-threaded cases write and read one frame at a
+// time and report throughput plus per-call latency percentiles. The "aligned" pattern never splits a copy across the
+// end of the storage; "wrap" starts half a frame in, so every second copy of the non-mirrored variants is split.
+// Threaded cases run a producer and a consumer on separate threads and report throughput and the time from a frame's
+// write to its read.
+
+typedef enum {
+    VARIANT_MUTEX = 0,
+    VARIANT_SPSC,
+    VARIANT_MIRRORED,
+    VARIANT_TYPED,
+    NUM_VARIANTS
+} variant_t;
+
+static const char *VARIANT_NAMES[] = {"mutex", "spsc", "mirrored", "typed"};
+
+PV_CIRCULAR_BUFFER_TYPED(bench_ring16, int16_t)
+PV_CIRCULAR_BUFFER_TYPED(bench_ring32, int32_t)
+
+static const int32_t ELEMENT_SIZES[] = {2, 4};
+static const int32_t FRAME_LENGTHS[] = {256, 512, 1024};
+
+static const int32_t SPINS_BEFORE_YIELD = 64;
+
+typedef struct {
+    pv_circular_buffer_t *buffer;
+    bench_ring16_t *ring16;
+    bench_ring32_t *ring32;
+    variant_t variant;
+    pthread_mutex_t lock;
+} bench_buffer_t;
+
+static struct option long_options[] = {
+        {"board", required_argument, NULL, 'b'},
+        {"quick", no_argument,       NULL, 'q'},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage : %s [--board BOARD_NAME] [--quick]\n", program_name);
+}
+
+static double now_nsec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec * 1e9 + (double) now.tv_nsec;
+}
+
+static int64_t now_nsec_int(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t) now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    const double x = *(const double *) a;
+    const double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank, over values already sorted
+static double percentile(const double *sorted, int64_t count, double fraction) {
+    int64_t rank = (int64_t) (fraction * (double) count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > count ? count : rank) - 1];
+}
+
+static void print_percentiles(const char *name, double *values, int64_t count) {
+    qsort(values, (size_t) count, sizeof(double), compare_doubles);
+    fprintf(stdout, "\"%s\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f}", name, percentile(values, count, 0.5),
+            percentile(values, count, 0.99), values[count - 1]);
+}
+
+static pv_circular_buffer_status_t bench_buffer_init(
+        variant_t variant,
+        int32_t capacity,
+        int32_t element_size,
+        bench_buffer_t *object) {
+    memset(object, 0, sizeof(*object));
+    object->variant = variant;
+    if (variant == VARIANT_MUTEX) {
+        pthread_mutex_init(&object->lock, NULL);
+        return pv_circular_buffer_init(
+                capacity,
+                element_size,
+                PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST,
+                &object->buffer);
+    } else if (variant == VARIANT_SPSC) {
+        return pv_circular_buffer_init_spsc(capacity, element_size, &object->buffer);
+    } else if (variant == VARIANT_TYPED) {
+        if (element_size == sizeof(int16_t)) {
+            return bench_ring16_init(capacity, &object->ring16);
+        } else if (element_size == sizeof(int32_t)) {
+            return bench_ring32_init(capacity, &object->ring32);
+        }
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    } else {
+        return pv_circular_buffer_init_mirrored(capacity, element_size, &object->buffer);
+    }
+}
+
+static void bench_buffer_delete(bench_buffer_t *object) {
+    if (object->variant == VARIANT_MUTEX) {
+        pthread_mutex_destroy(&object->lock);
+    }
+    pv_circular_buffer_delete(object->buffer);
+    bench_ring16_delete(object->ring16);
+    bench_ring32_delete(object->ring32);
+}
+
+static void bench_buffer_write(bench_buffer_t *object, const void *buffer, int32_t length) {
+    if (object->variant == VARIANT_MUTEX) {
+        pthread_mutex_lock(&object->lock);
+        pv_circular_buffer_write(object->buffer, buffer, length);
+        pthread_mutex_unlock(&object->lock);
+    } else if (object->ring16) {
+        bench_ring16_write(object->ring16, (const int16_t *) buffer, length);
+    } else if (object->ring32) {
+        bench_ring32_write(object->ring32, (const int32_t *) buffer, length);
+    } else {
+        pv_circular_buffer_write(object->buffer, buffer, length);
+    }
+}
+
+static int32_t bench_buffer_read(bench_buffer_t *object, void *buffer, int32_t length) {
+    if (object->variant == VARIANT_MUTEX) {
+        pthread_mutex_lock(&object->lock);
+        const int32_t read = pv_circular_buffer_read(object->buffer, buffer, length);
+        pthread_mutex_unlock(&object->lock);
+        return read;
+    } else if (object->ring16) {
+        return bench_ring16_read(object->ring16, (int16_t *) buffer, length);
+    } else if (object->ring32) {
+        return bench_ring32_read(object->ring32, (int32_t *) buffer, length);
+    }
+    return pv_circular_buffer_read(object->buffer, buffer, length);
+}
+
+static int32_t bench_buffer_get_count(bench_buffer_t *object) {
+    if (object->variant == VARIANT_MUTEX) {
+        pthread_mutex_lock(&object->lock);
+        const int32_t count = pv_circular_buffer_get_count(object->buffer);
+        pthread_mutex_unlock(&object->lock);
+        return count;
+    } else if (object->ring16) {
+        return bench_ring16_get_count(object->ring16);
+    } else if (object->ring32) {
+        return bench_ring32_get_count(object->ring32);
+    }
+    return pv_circular_buffer_get_count(object->buffer);
+}
+
+static int32_t bench_buffer_get_capacity(const bench_buffer_t *object) {
+    if (object->ring16) {
+        return bench_ring16_get_capacity(object->ring16);
+    } else if (object->ring32) {
+        return bench_ring32_get_capacity(object->ring32);
+    }
+    return pv_circular_buffer_get_capacity(object->buffer);
+}
+
+static uint64_t bench_buffer_get_overflow_count(const bench_buffer_t *object) {
+    if (object->ring16) {
+        return bench_ring16_get_overflow_count(object->ring16);
+    } else if (object->ring32) {
+        return bench_ring32_get_overflow_count(object->ring32);
+    }
+    return pv_circular_buffer_get_overflow_count(object->buffer);
+}
+
+static bool is_supported(variant_t variant) {
+    bench_buffer_t object;
+    if (bench_buffer_init(variant, 1024, sizeof(int16_t), &object) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        return false;
+    }
+    bench_buffer_delete(&object);
+    return true;
+}
+
+// Writes and reads one frame per iteration on the calling thread.
+static bool run_single_thread(
+        variant_t variant,
+        int32_t element_size,
+        int32_t frame_length,
+        bool is_wrap,
+        int64_t iterations,
+        int64_t timed_iterations,
+        bool is_first) {
+    bench_buffer_t object;
+    if (bench_buffer_init(variant, 2 * frame_length, element_size, &object) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        return false;
+    }
+
+    uint8_t *frame = calloc((size_t) frame_length, (size_t) element_size);
+    double *write_nsec = malloc((size_t) timed_iterations * sizeof(double));
+    double *read_nsec = malloc((size_t) timed_iterations * sizeof(double));
+    if (!frame || !write_nsec || !read_nsec) {
+        free(frame);
+        free(write_nsec);
+        free(read_nsec);
+        bench_buffer_delete(&object);
+        return false;
+    }
+    for (int32_t i = 0; i < (frame_length * element_size); i++) {
+        frame[i] = (uint8_t) i;
+    }
+
+    if (is_wrap) {
+        // both indices sit half a frame in from here on
+        bench_buffer_write(&object, frame, frame_length / 2);
+        bench_buffer_read(&object, frame, frame_length / 2);
+    }
+
+    const double start_nsec = now_nsec();
+    for (int64_t i = 0; i < iterations; i++) {
+        bench_buffer_write(&object, frame, frame_length);
+        bench_buffer_read(&object, frame, frame_length);
+    }
+    const double elapsed_nsec = now_nsec() - start_nsec;
+
+    for (int64_t i = 0; i < timed_iterations; i++) {
+        const double write_start_nsec = now_nsec();
+        bench_buffer_write(&object, frame, frame_length);
+        const double read_start_nsec = now_nsec();
+        bench_buffer_read(&object, frame, frame_length);
+        const double end_nsec = now_nsec();
+        write_nsec[i] = read_start_nsec - write_start_nsec;
+        read_nsec[i] = end_nsec - read_start_nsec;
+    }
+
+    // bytes copied in and out again
+    const double bytes = 2.0 * (double) iterations * (double) frame_length * (double) element_size;
+    fprintf(stdout, "%s{\"variant\":\"%s\",\"element_size\":%d,\"frame_length\":%d,\"pattern\":\"%s\",",
+            is_first ? "" : ",", VARIANT_NAMES[variant], element_size, frame_length, is_wrap ? "wrap" : "aligned");
+    fprintf(stdout, "\"capacity\":%d,\"iterations\":%lld,\"ns_per_frame\":%.1f,\"mb_per_sec\":%.1f,",
+            bench_buffer_get_capacity(&object), (long long) iterations,
+            elapsed_nsec / (double) iterations, (bytes / (1024.0 * 1024.0)) / (elapsed_nsec / 1e9));
+    print_percentiles("write_ns", write_nsec, timed_iterations);
+    fprintf(stdout, ",");
+    print_percentiles("read_ns", read_nsec, timed_iterations);
+    fprintf(stdout, "}");
+
+    free(frame);
+    free(write_nsec);
+    free(read_nsec);
+    bench_buffer_delete(&object);
+    return true;
+}
+
+typedef struct {
+    bench_buffer_t *object;
+    int32_t element_size;
+    int32_t frame_length;
+    int64_t frames;
+    int64_t *write_nsec;
+} producer_t;
+
+// Frame i starts with i, so the consumer can tell whether frames arrive whole and in order.
+static void stamp_frame(uint8_t *frame, int32_t element_size, int64_t index) {
+    if (element_size == sizeof(uint16_t)) {
+        const uint16_t value = (uint16_t) index;
+        memcpy(frame, &value, sizeof(value));
+    } else {
+        const uint32_t value = (uint32_t) index;
+        memcpy(frame, &value, sizeof(value));
+    }
+}
+
+static void wait_a_little(int32_t *spins) {
+    if (++(*spins) >= SPINS_BEFORE_YIELD) {
+        sched_yield();
+        *spins = 0;
+    }
+}
+
+static void *producer_entry(void *arg) {
+    producer_t *producer = (producer_t *) arg;
+    bench_buffer_t *object = producer->object;
+    const int32_t capacity = bench_buffer_get_capacity(object);
+
+    uint8_t *frame = calloc((size_t) producer->frame_length, (size_t) producer->element_size);
+    if (!frame) {
+        return NULL;
+    }
+    for (int64_t i = 0; i < producer->frames; i++) {
+        stamp_frame(frame, producer->element_size, i);
+        // never overflow: the default buffer would overwrite and the SPSC buffers drop, neither of which is measured
+        int32_t spins = 0;
+        while ((capacity - bench_buffer_get_count(object)) < producer->frame_length) {
+            wait_a_little(&spins);
+        }
+        __atomic_store_n(&producer->write_nsec[i], now_nsec_int(), __ATOMIC_RELAXED);
+        bench_buffer_write(object, frame, producer->frame_length);
+    }
+    free(frame);
+    return NULL;
+}
+
+// Runs a producer and a consumer thread against one buffer of eight frames.
+static bool run_threaded(variant_t variant, int32_t element_size, int32_t frame_length, int64_t frames, bool is_first) {
+    bench_buffer_t object;
+    if (bench_buffer_init(variant, 8 * frame_length, element_size, &object) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        return false;
+    }
+
+    uint8_t *frame = calloc((size_t) frame_length, (size_t) element_size);
+    uint8_t *expected = calloc((size_t) frame_length, (size_t) element_size);
+    int64_t *write_nsec = calloc((size_t) frames, sizeof(int64_t));
+    double *handoff_usec = malloc((size_t) frames * sizeof(double));
+    if (!frame || !expected || !write_nsec || !handoff_usec) {
+        free(frame);
+        free(expected);
+        free(write_nsec);
+        free(handoff_usec);
+        bench_buffer_delete(&object);
+        return false;
+    }
+
+    producer_t producer = {
+            .object = &object,
+            .element_size = element_size,
+            .frame_length = frame_length,
+            .frames = frames,
+            .write_nsec = write_nsec,
+    };
+
+    const double start_nsec = now_nsec();
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, producer_entry, &producer) != 0) {
+        free(frame);
+        free(expected);
+        free(write_nsec);
+        free(handoff_usec);
+        bench_buffer_delete(&object);
+        return false;
+    }
+
+    int64_t errors = 0;
+    for (int64_t i = 0; i < frames; i++) {
+        int32_t spins = 0;
+        while (bench_buffer_get_count(&object) < frame_length) {
+            wait_a_little(&spins);
+        }
+        bench_buffer_read(&object, frame, frame_length);
+        handoff_usec[i] = (double) (now_nsec_int() - __atomic_load_n(&write_nsec[i], __ATOMIC_RELAXED)) / 1e3;
+        stamp_frame(expected, element_size, i);
+        if (memcmp(frame, expected, (size_t) element_size) != 0) {
+            errors++;
+        }
+    }
+    const double elapsed_nsec = now_nsec() - start_nsec;
+    pthread_join(thread, NULL);
+
+    const double bytes = (double) frames * (double) frame_length * (double) element_size;
+    fprintf(stdout, "%s{\"variant\":\"%s\",\"element_size\":%d,\"frame_length\":%d,\"capacity\":%d,",
+            is_first ? "" : ",", VARIANT_NAMES[variant], element_size, frame_length,
+            bench_buffer_get_capacity(&object));
+    fprintf(stdout, "\"frames\":%lld,\"mb_per_sec\":%.1f,\"errors\":%lld,\"overflow\":%llu,", (long long) frames,
+            (bytes / (1024.0 * 1024.0)) / (elapsed_nsec / 1e9), (long long) errors,
+            (unsigned long long) bench_buffer_get_overflow_count(&object));
+    print_percentiles("handoff_usec", handoff_usec, frames);
+    fprintf(stdout, "}");
+
+    free(frame);
+    free(expected);
+    free(write_nsec);
+    free(handoff_usec);
+    bench_buffer_delete(&object);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *board = "";
+    bool is_quick = false;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "b:q", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'b':
+                board = optarg;
+                break;
+            case 'q':
+                is_quick = true;
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+
+    // the same amount of data passes through every single-threaded case, whatever the frame length
+    const int64_t elements = is_quick ? (4 * 1024 * 1024) : (64 * 1024 * 1024);
+    const int64_t timed_iterations = is_quick ? 2000 : 20000;
+    const int64_t threaded_frames = is_quick ? 5000 : 50000;
+
+    struct utsname name;
+    if (uname(&name) != 0) {
+        memset(&name, 0, sizeof(name));
+    }
+
+    fprintf(stdout, "{\"board\":\"%s\",\"system\":\"%s\",\"machine\":\"%s\",\"cpus\":%ld,\"quick\":%s,", board,
+            name.sysname, name.machine, sysconf(_SC_NPROCESSORS_ONLN), is_quick ? "true" : "false");
+
+    bool supported[NUM_VARIANTS];
+    fprintf(stdout, "\"variants\":[");
+    bool is_first = true;
+    for (int32_t v = 0; v < NUM_VARIANTS; v++) {
+        supported[v] = is_supported((variant_t) v);
+        if (supported[v]) {
+            fprintf(stdout, "%s\"%s\"", is_first ? "" : ",", VARIANT_NAMES[v]);
+            is_first = false;
+        }
+    }
+    fprintf(stdout, "],");
+
+    const int32_t num_element_sizes = (int32_t) (sizeof(ELEMENT_SIZES) / sizeof(ELEMENT_SIZES[0]));
+    const int32_t num_frame_lengths = (int32_t) (sizeof(FRAME_LENGTHS) / sizeof(FRAME_LENGTHS[0]));
+
+    fprintf(stdout, "\"single_thread\":[");
+    is_first = true;
+    for (int32_t v = 0; v < NUM_VARIANTS; v++) {
+        for (int32_t e = 0; (e < num_element_sizes) && supported[v]; e++) {
+            for (int32_t f = 0; f < num_frame_lengths; f++) {
+                for (int32_t w = 0; w < 2; w++) {
+                    if (!run_single_thread(
+                            (variant_t) v,
+                            ELEMENT_SIZES[e],
+                            FRAME_LENGTHS[f],
+                            w == 1,
+                            elements / FRAME_LENGTHS[f],
+                            timed_iterations,
+                            is_first)) {
+                        fprintf(stderr, "failed to run the %s single thread case.\n", VARIANT_NAMES[v]);
+                        exit(1);
+                    }
+                    is_first = false;
+                }
+            }
+        }
+    }
+    fprintf(stdout, "],");
+
+    fprintf(stdout, "\"threaded\":[");
+    is_first = true;
+    for (int32_t v = 0; v < NUM_VARIANTS; v++) {
+        for (int32_t e = 0; (e < num_element_sizes) && supported[v]; e++) {
+            for (int32_t f = 0; f < num_frame_lengths; f++) {
+                if (!run_threaded((variant_t) v, ELEMENT_SIZES[e], FRAME_LENGTHS[f], threaded_frames, is_first)) {
+                    fprintf(stderr, "failed to run the %s threaded case.\n", VARIANT_NAMES[v]);
+                    exit(1);
+                }
+                is_first = false;
+            }
+        }
+    }
+    fprintf(stdout, "]}\n");
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef _POSIX_C_SOURCE
+// clock_gettime, CLOCK_MONOTONIC and uname under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+
+#include "pv_channel_reducer.h"
+#include "pv_decimator.h"
+#include "pv_gain_control.h"
+#include "pv_level_meter.h"
+#include "pv_neon.h"
+#include "pv_noise_suppressor.h"
+
+// Times the per-frame sample work of pv_recorder with the generic kernels and with the NEON ones, on the same board,
+// and prints one JSON object. A frame is 512 samples at 16 kHz, as the demos read them. Each case reports nanoseconds
+// per frame for both paths, the saving, and whether both paths produced the same samples.
+//
+// "level" measures RMS, peak and clipping of a frame, as pv_recorder does for every frame it returns. "downmix_stereo" and "downmix_quad" average 2 and 4 interleaved channels. "decimate_32k" and
+// "decimate_48k" filter 1024 and 1536 device samples down to one frame. "noise_suppress" runs a frame through
+// pv_noise_suppressor, which has to stay well under a millisecond on the BeagleBone's AM335x to sit in front of
+// pv_picovoice_process. "gain_control" levels a frame with pv_gain_control.
+
+#define FRAME_LENGTH (512)
+#define MAX_CHANNELS (4)
+#define MAX_FACTOR (3)
+
+static struct option long_options[] = {
+        {"board", required_argument, NULL, 'b'},
+        {"quick", no_argument,       NULL, 'q'},
+        {NULL, 0,                    NULL, 0},
+};
+
+typedef enum {
+    CASE_LEVEL = 0,
+    CASE_DOWNMIX_STEREO,
+    CASE_DOWNMIX_QUAD,
+    CASE_DECIMATE_32K,
+    CASE_DECIMATE_48K,
+    CASE_NOISE_SUPPRESS,
+    CASE_GAIN_CONTROL,
+    NUM_CASES
+} case_t;
+
+static const char *CASE_NAMES[] = {"level", "downmix_stereo", "downmix_quad", "decimate_32k", "decimate_48k",
+                                    "noise_suppress", "gain_control"};
+
+static int16_t input[FRAME_LENGTH * MAX_FACTOR * MAX_CHANNELS];
+static int16_t output[FRAME_LENGTH * MAX_FACTOR];
+static volatile int32_t sink = 0;
+
+static void print_usage(const char *program_name) {
+    fprintf(stderr, "Usage : %s [--board BOARD_NAME] [--quick]\n", program_name);
+}
+
+static double now_nsec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec * 1e9 + (double) now.tv_nsec;
+}
+
+static void fill_input(void) {
+    const int32_t length = (int32_t) (sizeof(input) / sizeof(input[0]));
+    for (int32_t i = 0; i < length; i++) {
+        input[i] = (int16_t) (8000.0 * sin(0.01 * (double) i) + (double) ((i * 7) % 97));
+    }
+}
+
+// Runs `frames` frames of one case and leaves the last frame in `output`. Returns nanoseconds per frame, or a negative
+// value if the objects couldn't be created.
+static double run_case(case_t c, bool is_neon, int64_t frames) {
+    pv_neon_set_enabled(is_neon);
+
+    pv_channel_reducer_t *reducer = NULL;
+    pv_decimator_t *decimator = NULL;
+    pv_noise_suppressor_t *suppressor = NULL;
+    pv_gain_control_t *gain_control = NULL;
+    if ((c == CASE_DOWNMIX_STEREO) || (c == CASE_DOWNMIX_QUAD)) {
+        const int32_t channels = (c == CASE_DOWNMIX_STEREO) ? 2 : 4;
+        if (pv_channel_reducer_init(channels, PV_CHANNEL_REDUCER_MODE_AVERAGE, 0, NULL, &reducer) !=
+            PV_CHANNEL_REDUCER_STATUS_SUCCESS) {
+            return -1.0;
+        }
+    } else if ((c == CASE_DECIMATE_32K) || (c == CASE_DECIMATE_48K)) {
+        // the decimator picks its kernel here, after pv_neon_set_enabled
+        if (pv_decimator_init((c == CASE_DECIMATE_32K) ? 2 : 3, &decimator) != PV_DECIMATOR_STATUS_SUCCESS) {
+            return -1.0;
+        }
+    } else if (c == CASE_NOISE_SUPPRESS) {
+        // likewise
+        if (pv_noise_suppressor_init(FRAME_LENGTH, 12.0f, &suppressor) != PV_NOISE_SUPPRESSOR_STATUS_SUCCESS) {
+            return -1.0;
+        }
+    } else if (c == CASE_GAIN_CONTROL) {
+        if (pv_gain_control_init(16000, -20.0f, 24.0f, &gain_control) != PV_GAIN_CONTROL_STATUS_SUCCESS) {
+            return -1.0;
+        }
+    }
+
+    pv_level_t level;
+    memset(&level, 0, sizeof(level));
+
+    const double start_nsec = now_nsec();
+    for (int64_t i = 0; i < frames; i++) {
+        switch (c) {
+            case CASE_LEVEL:
+                pv_level_meter_measure(input, FRAME_LENGTH, &level);
+                sink += level.peak;
+                break;
+            case CASE_DOWNMIX_STEREO:
+            case CASE_DOWNMIX_QUAD:
+                pv_channel_reducer_process(reducer, input, FRAME_LENGTH, output);
+                break;
+            case CASE_DECIMATE_32K:
+                sink += pv_decimator_process(decimator, input, 2 * FRAME_LENGTH, output);
+                break;
+            case CASE_DECIMATE_48K:
+                sink += pv_decimator_process(decimator, input, 3 * FRAME_LENGTH, output);
+                break;
+            case CASE_NOISE_SUPPRESS:
+                // a different frame each time, so the noise estimate keeps moving
+                pv_noise_suppressor_process(suppressor, input + ((i % 8) * FRAME_LENGTH), output);
+                break;
+            case CASE_GAIN_CONTROL:
+                pv_gain_control_process(gain_control, input + ((i % 8) * FRAME_LENGTH), FRAME_LENGTH, output);
+                break;
+            default:
+                break;
+        }
+    }
+    const double elapsed_nsec = now_nsec() - start_nsec;
+
+    if (c == CASE_LEVEL) {
+        // the integer parts must match exactly; the RMS only differs if the sums do
+        memcpy(output, &level, sizeof(level));
+    }
+
+    pv_channel_reducer_delete(reducer);
+    pv_decimator_delete(decimator);
+    pv_noise_suppressor_delete(suppressor);
+    pv_gain_control_delete(gain_control);
+    return elapsed_nsec / (double) frames;
+}
+
+int main(int argc, char *argv[]) {
+    const char *board = "";
+    bool is_quick = false;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "b:q", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'b':
+                board = optarg;
+                break;
+            case 'q':
+                is_quick = true;
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+
+    const int64_t frames = is_quick ? 2000 : 50000;
+    const bool has_neon = pv_neon_is_available();
+
+    struct utsname name;
+    if (uname(&name) != 0) {
+        memset(&name, 0, sizeof(name));
+    }
+
+    fprintf(stdout, "{\"board\":\"%s\",\"system\":\"%s\",\"machine\":\"%s\",\"neon\":%s,\"frame_length\":%d,", board,
+            name.sysname, name.machine, has_neon ? "true" : "false", FRAME_LENGTH);
+    fprintf(stdout, "\"frames\":%lld,\"cases\":[", (long long) frames);
+
+    static int16_t generic_output[FRAME_LENGTH * MAX_FACTOR];
+    fill_input();
+    for (int32_t i = 0; i < NUM_CASES; i++) {
+
+        memset(output, 0, sizeof(output));
+        const double generic_nsec = run_case((case_t) i, false, frames);
+        memcpy(generic_output, output, sizeof(output));
+        if (generic_nsec < 0) {
+            fprintf(stderr, "failed to set up the %s case.\n", CASE_NAMES[i]);
+            exit(1);
+        }
+
+        fprintf(stdout, "%s{\"name\":\"%s\",\"generic_ns_per_frame\":%.1f", (i == 0) ? "" : ",", CASE_NAMES[i],
+                generic_nsec);
+        if (has_neon) {
+            memset(output, 0, sizeof(output));
+            const double neon_nsec = run_case((case_t) i, true, frames);
+            if (neon_nsec < 0) {
+                fprintf(stderr, "failed to set up the %s case.\n", CASE_NAMES[i]);
+                exit(1);
+            }
+            const bool is_match = memcmp(generic_output, output, sizeof(output)) == 0;
+            fprintf(stdout, ",\"neon_ns_per_frame\":%.1f,\"saved_ns_per_frame\":%.1f,\"speedup\":%.2f,\"match\":%s",
+                    neon_nsec, generic_nsec - neon_nsec, generic_nsec / neon_nsec, is_match ? "true" : "false");
+        }
+        fprintf(stdout, "}");
+    }
+    fprintf(stdout, "]}\n");
+
+    pv_neon_set_enabled(true);
+    return 0;
+}
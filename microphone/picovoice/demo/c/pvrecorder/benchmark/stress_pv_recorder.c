@@ -0,0 +1,816 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#if !defined(_GNU_SOURCE)
+// posix_openpt, clock_nanosleep and mkstemp under plain C99
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+
+#include <linux/i2c-dev.h>
+
+#endif
+
+#include "pv_recorder.h"
+#include "pv_recorder_serial.h"
+
+// Runs pv_recorder against a synthetic source while other threads load the CPU, the disk and an I2C bus, then prints
+// one JSON object.
+//
+// The source plays the wake word co-processor: it writes 16 kHz AUDIO packets, paced by the monotonic clock, into the
+// master side of a pseudo-terminal, and the recorder reads them with PV_RECORDER_BACKEND_SERIAL from the slave side.
+// That is the same capture path, ring buffer, wakeup and worker the other backends use, with no audio hardware. The
+// consumer reads in pull mode, or in push mode with --push, and can spend a fixed time on every frame the way the
+// engine does. --reader_frame_lengths adds readers of other frame lengths over the same ring, each on a thread of its
+// own, the way a VAD or a recording would run beside the engine. Reported: the overflow rate, how long each read blocked, the age of each frame when it was delivered,
+// how far the spacing of deliveries strays from one frame period and the recorder's own capture callback stats.
+
+#define MAX_LOAD_THREADS (16)
+
+static const int32_t SAMPLE_RATE = 16000;
+static const int32_t IO_CHUNK_BYTES = 256 * 1024;
+static const int64_t IO_FILE_LIMIT_BYTES = 64 * 1024 * 1024;
+
+typedef struct {
+    const char *board;
+    int32_t seconds;
+    int32_t frame_length;
+    int32_t buffer_size_msec;
+    pv_recorder_overflow_policy_t overflow_policy;
+    int32_t read_timeout_msec;
+    int32_t packet_samples;
+    int32_t consumer_work_usec;
+    int32_t realtime_priority;
+    int32_t cpu;
+    int32_t source_priority;
+    int32_t cpu_load;
+    int32_t io_load;
+    const char *io_dir;
+    const char *i2c_device;
+    int32_t i2c_address;
+    bool is_push;
+    int32_t reader_count;
+    int32_t reader_frame_lengths[PV_RECORDER_MAX_READERS];
+} stress_config_t;
+
+typedef struct {
+    int64_t *values;
+    int64_t count;
+    int64_t capacity;
+} samples_t;
+
+typedef struct {
+    const stress_config_t *config;
+    samples_t read_usec;
+    samples_t age_usec;
+    samples_t interval_usec;
+    int64_t last_delivery_usec;
+    int64_t frames;
+    int64_t dropped_samples;
+    int64_t timeouts;
+} consumer_t;
+
+typedef struct {
+    pv_recorder_reader_t *reader;
+    int64_t end_usec;
+    int64_t frames;
+    int64_t dropped_samples;
+    int64_t timeouts;
+} extra_reader_t;
+
+typedef struct {
+    int fd;
+    int32_t packet_samples;
+    int64_t packets;
+    int64_t late_packets;
+} source_t;
+
+typedef struct {
+    const stress_config_t *config;
+    int64_t operations;
+    int64_t errors;
+} load_t;
+
+static volatile bool is_stopping = false;
+
+static struct option long_options[] = {
+        {"board",                required_argument, NULL, 'b'},
+        {"seconds",              required_argument, NULL, 's'},
+        {"frame_length",         required_argument, NULL, 'f'},
+        {"buffer_size_msec",     required_argument, NULL, 'B'},
+        {"overflow_policy",      required_argument, NULL, 'o'},
+        {"read_timeout_msec",    required_argument, NULL, 't'},
+        {"packet_samples",       required_argument, NULL, 'p'},
+        {"consumer_work_usec",   required_argument, NULL, 'w'},
+        {"realtime_priority",    required_argument, NULL, 'r'},
+        {"cpu",                  required_argument, NULL, 'c'},
+        {"source_priority",      required_argument, NULL, 'R'},
+        {"cpu_load",             required_argument, NULL, 'C'},
+        {"io_load",              required_argument, NULL, 'I'},
+        {"io_dir",               required_argument, NULL, 'd'},
+        {"i2c_device",           required_argument, NULL, 'i'},
+        {"i2c_address",          required_argument, NULL, 'a'},
+        {"push",                 no_argument,       NULL, 'P'},
+        {"reader_frame_lengths", required_argument, NULL, 'L'},
+        {NULL, 0,                                   NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stderr,
+            "Usage : %s [--board BOARD_NAME] [--seconds N] [--frame_length N] [--buffer_size_msec N]\n"
+            "       [--overflow_policy drop_newest|drop_oldest|block] [--read_timeout_msec N] [--packet_samples N] [--consumer_work_usec N] [--push]\n"
+            "       [--reader_frame_lengths N,N,...]\n"
+            "       [--realtime_priority N] [--cpu N] [--source_priority N]\n"
+            "       [--cpu_load THREADS] [--io_load THREADS] [--io_dir DIR] [--i2c_device PATH --i2c_address ADDR]\n",
+            program_name);
+}
+
+// same clock as the recorder's frame timestamps
+static int64_t now_usec(void) {
+    struct timespec now;
+#if defined(__APPLE__)
+    clock_gettime(CLOCK_REALTIME, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return ((int64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+static bool samples_init(samples_t *samples, int64_t capacity) {
+    samples->values = malloc((size_t) capacity * sizeof(int64_t));
+    samples->count = 0;
+    samples->capacity = capacity;
+    return samples->values != NULL;
+}
+
+static void samples_add(samples_t *samples, int64_t value) {
+    if (samples->count < samples->capacity) {
+        samples->values[samples->count++] = value;
+    }
+}
+
+static int compare_int64(const void *a, const void *b) {
+    const int64_t x = *(const int64_t *) a;
+    const int64_t y = *(const int64_t *) b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank, over values already sorted
+static int64_t percentile(const int64_t *sorted, int64_t count, double fraction) {
+    int64_t rank = (int64_t) ceil(fraction * (double) count);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > count ? count : rank) - 1];
+}
+
+static void print_distribution(const char *name, samples_t *samples) {
+    if (samples->count == 0) {
+        fprintf(stdout, "\"%s\":null", name);
+        return;
+    }
+    qsort(samples->values, (size_t) samples->count, sizeof(int64_t), compare_int64);
+    const int64_t *v = samples->values;
+    const int64_t n = samples->count;
+    fprintf(stdout, "\"%s\":{\"count\":%lld,\"p50\":%lld,\"p90\":%lld,\"p99\":%lld,\"p999\":%lld,\"max\":%lld}", name,
+            (long long) n, (long long) percentile(v, n, 0.5), (long long) percentile(v, n, 0.9),
+            (long long) percentile(v, n, 0.99), (long long) percentile(v, n, 0.999), (long long) v[n - 1]);
+}
+
+static void spin_usec(int32_t usec) {
+    const int64_t end_usec = now_usec() + usec;
+    while (now_usec() < end_usec) {
+    }
+}
+
+static void consumer_deliver(consumer_t *consumer, int64_t delivered_usec) {
+    const int64_t frame_usec = ((int64_t) consumer->config->frame_length * 1000000) / SAMPLE_RATE;
+    if (consumer->last_delivery_usec > 0) {
+        // zero when frames arrive exactly one frame period apart
+        samples_add(&consumer->interval_usec, llabs((delivered_usec - consumer->last_delivery_usec) - frame_usec));
+    }
+    consumer->last_delivery_usec = delivered_usec;
+    consumer->frames++;
+
+    if (consumer->config->consumer_work_usec > 0) {
+        spin_usec(consumer->config->consumer_work_usec);
+    }
+}
+
+static void on_frame(const int16_t *pcm, void *user_data) {
+    (void) pcm;
+    consumer_deliver((consumer_t *) user_data, now_usec());
+}
+
+static void write_u16(uint8_t *bytes, uint16_t value) {
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+}
+
+static int32_t make_packet(uint8_t *packet, uint8_t type, uint16_t sequence_number, const uint8_t *payload, int32_t length) {
+    packet[0] = PV_RECORDER_SERIAL_SYNC_0;
+    packet[1] = PV_RECORDER_SERIAL_SYNC_1;
+    packet[2] = type;
+    write_u16(&packet[3], sequence_number);
+    write_u16(&packet[5], (uint16_t) length);
+    if (length > 0) {
+        memcpy(&packet[7], payload, (size_t) length);
+    }
+    write_u16(&packet[7 + length], pv_recorder_serial_crc(&packet[2], 5 + length));
+    return 9 + length;
+}
+
+static bool write_all(int fd, const uint8_t *bytes, int32_t length) {
+    while (length > 0) {
+        const ssize_t written = write(fd, bytes, (size_t) length);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        length -= (int32_t) written;
+    }
+    return true;
+}
+
+// One burst that never ends: a TRIGGER, then AUDIO packets on a fixed schedule. A packet that is due while the source
+// was descheduled is sent late instead of skipped, the way a UART FIFO would drain after a stall.
+static void *source_entry(void *arg) {
+    source_t *source = (source_t *) arg;
+    const int32_t payload_length = 2 * source->packet_samples;
+
+    uint8_t *payload = malloc((size_t) payload_length);
+    uint8_t *packet = malloc((size_t) payload_length + 16);
+    if (!payload || !packet) {
+        free(payload);
+        free(packet);
+        return NULL;
+    }
+
+    uint16_t sequence_number = 0;
+    const uint8_t keyword_index = 0;
+    int32_t length = make_packet(packet, PV_RECORDER_SERIAL_PACKET_TRIGGER, sequence_number++, &keyword_index, 1);
+    write_all(source->fd, packet, length);
+
+    const int64_t period_nsec = ((int64_t) source->packet_samples * 1000000000) / SAMPLE_RATE;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    int64_t phase = 0;
+    while (!is_stopping) {
+        // a quiet 440 Hz tone, so nothing looks like a muted microphone
+        for (int32_t i = 0; i < source->packet_samples; i++) {
+            const double t = (double) (phase++) / (double) SAMPLE_RATE;
+            write_u16(&payload[2 * i], (uint16_t) (int16_t) (1000.0 * sin(2.0 * M_PI * 440.0 * t)));
+        }
+        length = make_packet(packet, PV_RECORDER_SERIAL_PACKET_AUDIO, sequence_number++, payload, payload_length);
+
+        next.tv_nsec += (long) period_nsec;
+        while (next.tv_nsec >= 1000000000) {
+            next.tv_nsec -= 1000000000;
+            next.tv_sec++;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec > next.tv_sec) || ((now.tv_sec == next.tv_sec) && (now.tv_nsec > next.tv_nsec))) {
+            source->late_packets++;
+        } else {
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        }
+
+        if (!write_all(source->fd, packet, length)) {
+            break;
+        }
+        source->packets++;
+    }
+
+    free(payload);
+    free(packet);
+    return NULL;
+}
+
+static void *cpu_load_entry(void *arg) {
+    load_t *load = (load_t *) arg;
+    volatile double x = 1.0;
+    while (!is_stopping) {
+        for (int32_t i = 0; i < 10000; i++) {
+            x = (x * 1.000001) + 0.000001;
+        }
+        load->operations++;
+    }
+    return NULL;
+}
+
+// Writes and syncs a scratch file, like the camera saving stills, truncating it whenever it grows past the limit.
+static void *io_load_entry(void *arg) {
+    load_t *load = (load_t *) arg;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/stress_pv_recorder_XXXXXX", load->config->io_dir);
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        load->errors++;
+        return NULL;
+    }
+    unlink(path);
+
+    uint8_t *chunk = malloc((size_t) IO_CHUNK_BYTES);
+    if (!chunk) {
+        close(fd);
+        load->errors++;
+        return NULL;
+    }
+    memset(chunk, 0x5A, (size_t) IO_CHUNK_BYTES);
+
+    int64_t size = 0;
+    while (!is_stopping) {
+        if (write(fd, chunk, (size_t) IO_CHUNK_BYTES) != IO_CHUNK_BYTES) {
+            load->errors++;
+        }
+        fsync(fd);
+        size += IO_CHUNK_BYTES;
+        if (size >= IO_FILE_LIMIT_BYTES) {
+            if ((ftruncate(fd, 0) != 0) || (lseek(fd, 0, SEEK_SET) != 0)) {
+                load->errors++;
+            }
+            size = 0;
+        }
+        load->operations++;
+    }
+
+    free(chunk);
+    close(fd);
+    return NULL;
+}
+
+// Reads two bytes from one device back to back, like polling the servo controller. A missing device NAKs and counts
+// as an error, which still keeps the bus and its driver busy.
+static void *i2c_load_entry(void *arg) {
+    load_t *load = (load_t *) arg;
+#if defined(__linux__)
+    const int fd = open(load->config->i2c_device, O_RDWR);
+    if ((fd < 0) || (ioctl(fd, I2C_SLAVE, load->config->i2c_address) < 0)) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        load->errors++;
+        return NULL;
+    }
+
+    uint8_t bytes[2];
+    while (!is_stopping) {
+        if (read(fd, bytes, sizeof(bytes)) != sizeof(bytes)) {
+            load->errors++;
+        }
+        load->operations++;
+    }
+    close(fd);
+#else
+    load->errors++;
+#endif
+    return NULL;
+}
+
+static void run_pull(pv_recorder_t *recorder, consumer_t *consumer, int64_t end_usec) {
+    int16_t *pcm = malloc((size_t) consumer->config->frame_length * sizeof(int16_t));
+    if (!pcm) {
+        return;
+    }
+
+    while (now_usec() < end_usec) {
+        pv_recorder_frame_info_t info;
+        const int64_t start_usec = now_usec();
+        const pv_recorder_status_t status = pv_recorder_read_ex(recorder, pcm, &info);
+        const int64_t delivered_usec = now_usec();
+        if (status == PV_RECORDER_STATUS_IO_ERROR) {
+            consumer->timeouts++;
+            continue;
+        } else if (status != PV_RECORDER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to read with %s.\n", pv_recorder_status_to_string(status));
+            break;
+        }
+        samples_add(&consumer->read_usec, delivered_usec - start_usec);
+        samples_add(&consumer->age_usec, delivered_usec - info.timestamp_usec);
+        consumer->dropped_samples = info.dropped_samples;
+        consumer_deliver(consumer, delivered_usec);
+    }
+
+    free(pcm);
+}
+
+// Reads as fast as frames come, beside the main consumer.
+static void *extra_reader_entry(void *arg) {
+    extra_reader_t *extra = (extra_reader_t *) arg;
+    int16_t *pcm = malloc((size_t) pv_recorder_reader_get_frame_length(extra->reader) * sizeof(int16_t));
+    if (!pcm) {
+        return NULL;
+    }
+
+    while (now_usec() < extra->end_usec) {
+        pv_recorder_frame_info_t info;
+        const pv_recorder_status_t status = pv_recorder_reader_read(extra->reader, pcm, &info);
+        if (status == PV_RECORDER_STATUS_IO_ERROR) {
+            extra->timeouts++;
+            continue;
+        } else if (status != PV_RECORDER_STATUS_SUCCESS) {
+            break;
+        }
+        extra->frames++;
+        extra->dropped_samples = info.dropped_samples;
+    }
+
+    free(pcm);
+    return NULL;
+}
+
+static int32_t parse_int(const char *value, const char *program_name) {
+    char *end = NULL;
+    const long parsed = strtol(value, &end, 0);
+    if ((end == value) || (*end != '\0')) {
+        print_usage(program_name);
+        exit(1);
+    }
+    return (int32_t) parsed;
+}
+
+static int32_t parse_int_list(const char *value, int32_t max_count, int32_t *values, const char *program_name) {
+    char copy[256];
+    snprintf(copy, sizeof(copy), "%s", value);
+
+    int32_t count = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        if (count == max_count) {
+            print_usage(program_name);
+            exit(1);
+        }
+        values[count++] = parse_int(token, program_name);
+    }
+    return count;
+}
+
+static const char *const OVERFLOW_POLICY_NAMES[] = {"drop_newest", "drop_oldest", "block"};
+
+static pv_recorder_overflow_policy_t parse_overflow_policy(const char *value, const char *program_name) {
+    for (int32_t i = 0; i < (int32_t) (sizeof(OVERFLOW_POLICY_NAMES) / sizeof(OVERFLOW_POLICY_NAMES[0])); i++) {
+        if (strcmp(value, OVERFLOW_POLICY_NAMES[i]) == 0) {
+            return (pv_recorder_overflow_policy_t) i;
+        }
+    }
+    print_usage(program_name);
+    exit(1);
+}
+
+static int32_t start_loads(
+        void *(*entry)(void *),
+        int32_t count,
+        const stress_config_t *config,
+        load_t *loads,
+        pthread_t *threads) {
+    int32_t started = 0;
+    for (int32_t i = 0; i < count; i++) {
+        loads[i].config = config;
+        if (pthread_create(&threads[i], NULL, entry, &loads[i]) != 0) {
+            break;
+        }
+        started++;
+    }
+    return started;
+}
+
+static void join_loads(int32_t count, pthread_t *threads) {
+    for (int32_t i = 0; i < count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static void print_loads(const char *name, int32_t count, const load_t *loads) {
+    int64_t operations = 0;
+    int64_t errors = 0;
+    for (int32_t i = 0; i < count; i++) {
+        operations += loads[i].operations;
+        errors += loads[i].errors;
+    }
+    fprintf(stdout, "\"%s\":{\"threads\":%d,\"operations\":%lld,\"errors\":%lld}", name, count,
+            (long long) operations, (long long) errors);
+}
+
+int main(int argc, char *argv[]) {
+    stress_config_t config = {
+            .board = "",
+            .seconds = 30,
+            .frame_length = 512,
+            .buffer_size_msec = 100,
+            .overflow_policy = PV_RECORDER_OVERFLOW_POLICY_DROP_NEWEST,
+            .read_timeout_msec = 1000,
+            .packet_samples = 256,
+            .consumer_work_usec = 0,
+            .realtime_priority = 0,
+            .cpu = -1,
+            .source_priority = 0,
+            .cpu_load = 0,
+            .io_load = 0,
+            .io_dir = "/tmp",
+            .i2c_device = NULL,
+            .i2c_address = 0x40,
+            .is_push = false,
+            .reader_count = 0,
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "b:s:f:B:o:t:p:w:r:c:R:C:I:d:i:a:PL:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'b':
+                config.board = optarg;
+                break;
+            case 's':
+                config.seconds = parse_int(optarg, argv[0]);
+                break;
+            case 'f':
+                config.frame_length = parse_int(optarg, argv[0]);
+                break;
+            case 'B':
+                config.buffer_size_msec = parse_int(optarg, argv[0]);
+                break;
+            case 'o':
+                config.overflow_policy = parse_overflow_policy(optarg, argv[0]);
+                break;
+            case 't':
+                config.read_timeout_msec = parse_int(optarg, argv[0]);
+                break;
+            case 'p':
+                config.packet_samples = parse_int(optarg, argv[0]);
+                break;
+            case 'w':
+                config.consumer_work_usec = parse_int(optarg, argv[0]);
+                break;
+            case 'r':
+                config.realtime_priority = parse_int(optarg, argv[0]);
+                break;
+            case 'c':
+                config.cpu = parse_int(optarg, argv[0]);
+                break;
+            case 'R':
+                config.source_priority = parse_int(optarg, argv[0]);
+                break;
+            case 'C':
+                config.cpu_load = parse_int(optarg, argv[0]);
+                break;
+            case 'I':
+                config.io_load = parse_int(optarg, argv[0]);
+                break;
+            case 'd':
+                config.io_dir = optarg;
+                break;
+            case 'i':
+                config.i2c_device = optarg;
+                break;
+            case 'a':
+                config.i2c_address = parse_int(optarg, argv[0]);
+                break;
+            case 'P':
+                config.is_push = true;
+                break;
+            case 'L':
+                config.reader_count = parse_int_list(
+                        optarg,
+                        PV_RECORDER_MAX_READERS,
+                        config.reader_frame_lengths,
+                        argv[0]);
+                break;
+            default:
+                print_usage(argv[0]);
+                exit(1);
+        }
+    }
+    if ((config.seconds <= 0) ||
+        (config.packet_samples <= 0) ||
+        ((2 * config.packet_samples) > PV_RECORDER_SERIAL_MAX_PAYLOAD_LENGTH) ||
+        (config.consumer_work_usec < 0) ||
+        (config.cpu_load < 0) || (config.cpu_load > MAX_LOAD_THREADS) ||
+        (config.io_load < 0) || (config.io_load > MAX_LOAD_THREADS)) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    // the pseudo-terminal stands in for the co-processor's UART
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) {
+        fprintf(stderr, "Failed to open a pseudo-terminal.\n");
+        exit(1);
+    }
+
+    pv_recorder_config_t recorder_config = pv_recorder_default_config(config.frame_length);
+    recorder_config.backend = PV_RECORDER_BACKEND_SERIAL;
+    recorder_config.serial_device_name = ptsname(master);
+    recorder_config.buffer_size_msec = config.buffer_size_msec;
+    recorder_config.overflow_policy = config.overflow_policy;
+    recorder_config.realtime_priority = config.realtime_priority;
+    recorder_config.cpu = config.cpu;
+    // stdout is for the results
+    recorder_config.log_overflow = false;
+    recorder_config.log_silence = false;
+
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status = pv_recorder_init_with_config(&recorder_config, &recorder);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to initialize pv_recorder with %s.\n", pv_recorder_status_to_string(status));
+        exit(1);
+    }
+    status = pv_recorder_set_read_timeout(recorder, config.read_timeout_msec);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to set the read timeout with %s.\n", pv_recorder_status_to_string(status));
+        exit(1);
+    }
+
+    // twice the frames the run should produce, for a consumer that falls behind and catches up
+    const int64_t max_frames = 2 * (((int64_t) config.seconds * SAMPLE_RATE) / config.frame_length) + 16;
+    consumer_t consumer;
+    memset(&consumer, 0, sizeof(consumer));
+    consumer.config = &config;
+    if (!samples_init(&consumer.read_usec, max_frames) ||
+        !samples_init(&consumer.age_usec, max_frames) ||
+        !samples_init(&consumer.interval_usec, max_frames)) {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        exit(1);
+    }
+
+    if (config.is_push) {
+        status = pv_recorder_set_frame_callback(recorder, on_frame, &consumer);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to set the frame callback with %s.\n", pv_recorder_status_to_string(status));
+            exit(1);
+        }
+    }
+
+    extra_reader_t extra_readers[PV_RECORDER_MAX_READERS];
+    pthread_t extra_reader_threads[PV_RECORDER_MAX_READERS];
+    memset(extra_readers, 0, sizeof(extra_readers));
+    for (int32_t i = 0; i < config.reader_count; i++) {
+        status = pv_recorder_add_reader(recorder, config.reader_frame_lengths[i], &(extra_readers[i].reader));
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to add a reader with %s.\n", pv_recorder_status_to_string(status));
+            exit(1);
+        }
+    }
+
+    load_t cpu_loads[MAX_LOAD_THREADS];
+    load_t io_loads[MAX_LOAD_THREADS];
+    load_t i2c_load;
+    pthread_t cpu_threads[MAX_LOAD_THREADS];
+    pthread_t io_threads[MAX_LOAD_THREADS];
+    pthread_t i2c_thread;
+    memset(cpu_loads, 0, sizeof(cpu_loads));
+    memset(io_loads, 0, sizeof(io_loads));
+    memset(&i2c_load, 0, sizeof(i2c_load));
+
+    const int32_t cpu_threads_started = start_loads(cpu_load_entry, config.cpu_load, &config, cpu_loads, cpu_threads);
+    const int32_t io_threads_started = start_loads(io_load_entry, config.io_load, &config, io_loads, io_threads);
+    const int32_t i2c_threads_started = config.i2c_device ?
+                                        start_loads(i2c_load_entry, 1, &config, &i2c_load, &i2c_thread) :
+                                        0;
+
+    status = pv_recorder_start(recorder);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to start pv_recorder with %s.\n", pv_recorder_status_to_string(status));
+        exit(1);
+    }
+
+    // started after the recorder, which flushes whatever is already queued on the line
+    source_t source = {
+            .fd = master,
+            .packet_samples = config.packet_samples,
+    };
+    pthread_t source_thread;
+    if (pthread_create(&source_thread, NULL, source_entry, &source) != 0) {
+        fprintf(stderr, "Failed to start the source.\n");
+        exit(1);
+    }
+    if (config.source_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = config.source_priority;
+        pthread_setschedparam(source_thread, SCHED_FIFO, &param);
+    }
+
+    const int64_t end_usec = now_usec() + ((int64_t) config.seconds * 1000000);
+    int32_t extra_readers_started = 0;
+    for (int32_t i = 0; i < config.reader_count; i++) {
+        extra_readers[i].end_usec = end_usec;
+        if (pthread_create(&extra_reader_threads[i], NULL, extra_reader_entry, &extra_readers[i]) != 0) {
+            break;
+        }
+        extra_readers_started++;
+    }
+    if (config.is_push) {
+        while (now_usec() < end_usec) {
+            usleep(100 * 1000);
+        }
+    } else {
+        run_pull(recorder, &consumer, end_usec);
+    }
+
+    pv_recorder_stats_t stats;
+    pv_recorder_get_stats(recorder, &stats);
+
+    int32_t worker_priority = 0;
+    int32_t worker_cpu = -1;
+    pv_recorder_get_scheduling(recorder, &worker_priority, &worker_cpu);
+
+    is_stopping = true;
+    pthread_join(source_thread, NULL);
+    pv_recorder_stop(recorder);
+    for (int32_t i = 0; i < extra_readers_started; i++) {
+        pthread_join(extra_reader_threads[i], NULL);
+    }
+    join_loads(cpu_threads_started, cpu_threads);
+    join_loads(io_threads_started, io_threads);
+    join_loads(i2c_threads_started, &i2c_thread);
+
+    if (config.is_push) {
+        consumer.dropped_samples = stats.overflow_samples;
+    }
+
+    struct utsname name;
+    if (uname(&name) != 0) {
+        memset(&name, 0, sizeof(name));
+    }
+
+    fprintf(stdout, "{\"board\":\"%s\",\"system\":\"%s\",\"machine\":\"%s\",\"cpus\":%ld,", config.board,
+            name.sysname, name.machine, sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(stdout, "\"config\":{\"seconds\":%d,\"mode\":\"%s\",\"frame_length\":%d,\"buffer_size_msec\":%d,",
+            config.seconds, config.is_push ? "push" : "pull", config.frame_length, config.buffer_size_msec);
+    fprintf(stdout, "\"overflow_policy\":\"%s\",", OVERFLOW_POLICY_NAMES[config.overflow_policy]);
+    fprintf(stdout, "\"read_timeout_msec\":%d,\"packet_samples\":%d,\"consumer_work_usec\":%d,",
+            config.read_timeout_msec, config.packet_samples, config.consumer_work_usec);
+    fprintf(stdout, "\"realtime_priority\":%d,\"cpu\":%d,\"source_priority\":%d},", config.realtime_priority,
+            config.cpu, config.source_priority);
+    fprintf(stdout, "\"load\":{");
+    print_loads("cpu", cpu_threads_started, cpu_loads);
+    fprintf(stdout, ",");
+    print_loads("io", io_threads_started, io_loads);
+    fprintf(stdout, ",");
+    print_loads("i2c", i2c_threads_started, &i2c_load);
+    fprintf(stdout, "},");
+
+    const double overflow_rate = (stats.total_samples > 0) ?
+                                 ((double) stats.overflow_samples / (double) stats.total_samples) :
+                                 0.0;
+    fprintf(stdout, "\"source\":{\"packets\":%lld,\"late_packets\":%lld},", (long long) source.packets,
+            (long long) source.late_packets);
+    fprintf(stdout, "\"frames\":%lld,\"timeouts\":%lld,\"dropped_samples\":%lld,\"overflow_rate\":%.6f,",
+            (long long) consumer.frames, (long long) consumer.timeouts, (long long) consumer.dropped_samples,
+            overflow_rate);
+    print_distribution("read_usec", &consumer.read_usec);
+    fprintf(stdout, ",");
+    print_distribution("frame_age_usec", &consumer.age_usec);
+    fprintf(stdout, ",");
+    print_distribution("delivery_jitter_usec", &consumer.interval_usec);
+    fprintf(stdout, ",\"readers\":[");
+    for (int32_t i = 0; i < extra_readers_started; i++) {
+        fprintf(stdout, "%s{\"frame_length\":%d,\"frames\":%lld,\"timeouts\":%lld,\"dropped_samples\":%lld}",
+                (i > 0) ? "," : "", config.reader_frame_lengths[i], (long long) extra_readers[i].frames,
+                (long long) extra_readers[i].timeouts, (long long) extra_readers[i].dropped_samples);
+    }
+    fprintf(stdout, "]");
+    fprintf(stdout, ",\"recorder\":{\"total_samples\":%lld,\"overflow_samples\":%lld,\"max_buffered_samples\":%lld,",
+            (long long) stats.total_samples, (long long) stats.overflow_samples,
+            (long long) stats.max_buffered_samples);
+    fprintf(stdout, "\"callback_count\":%lld,\"min_callback_interval_usec\":%lld,\"max_callback_interval_usec\":%lld,",
+            (long long) stats.callback_count, (long long) stats.min_callback_interval_usec,
+            (long long) stats.max_callback_interval_usec);
+    fprintf(stdout, "\"avg_callback_interval_usec\":%lld,\"max_read_wait_usec\":%lld,",
+            (long long) stats.avg_callback_interval_usec, (long long) stats.max_read_wait_usec);
+    fprintf(stdout, "\"worker_priority\":%d,\"worker_cpu\":%d}}\n", config.is_push ? worker_priority : 0,
+            config.is_push ? worker_cpu : -1);
+
+    pv_recorder_delete(recorder);
+    close(master);
+    free(consumer.read_usec.values);
+    free(consumer.age_usec.values);
+    free(consumer.interval_usec.values);
+
+    return 0;
+}
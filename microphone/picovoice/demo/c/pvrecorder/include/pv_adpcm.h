@@ -0,0 +1,109 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_ADPCM_H
+#define PV_ADPCM_H
+
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Mono IMA-ADPCM in the block layout of WAV format 0x11, which dr_wav, sox and ffmpeg decode: 4 bits a sample, about
+ * a quarter of 16-bit PCM. A block starts with a 4-byte header holding its first sample as it is and the step index,
+ * so every block decodes on its own; the rest of the block holds two samples a byte, the earlier in the low nibble.
+ * Nothing here allocates.
+ */
+
+/** Bytes in a block, as ffmpeg and sox use for 16 kHz mono: 505 samples, 31.6 ms. */
+#define PV_ADPCM_DEFAULT_BLOCK_ALIGN (256)
+
+/** Bytes in the WAV header pv_adpcm_wav_header() makes, up to the start of the first block. */
+#define PV_ADPCM_WAV_HEADER_LENGTH (60)
+
+/**
+ * State an encoder carries from one block to the next, so the step size doesn't have to adapt again at every block.
+ */
+typedef struct {
+    /** Index into the step table, 0 to 88. */
+    int32_t step_index;
+} pv_adpcm_encoder_t;
+
+/**
+ * Samples in a block of param ${block_align} bytes.
+ *
+ * @param block_align Bytes in a block, a multiple of 4 greater than 4.
+ * @return Samples in a block.
+ */
+int32_t pv_adpcm_samples_per_block(int32_t block_align);
+
+/**
+ * Bytes a block of param ${length} samples takes. A stream's last block may be short. It is padded to a whole number
+ * of 4-byte groups, as dr_wav reads them, so a decoder that goes by its size makes up to 7 samples too many; the
+ * "fact" chunk has the real count.
+ *
+ * @param length Samples in the block, at least 1.
+ * @return Bytes in the block.
+ */
+int32_t pv_adpcm_block_length(int32_t length);
+
+/**
+ * Starts an encoder on the smallest step, as a stream begins.
+ *
+ * @param encoder Encoder.
+ */
+void pv_adpcm_encoder_init(pv_adpcm_encoder_t *encoder);
+
+/**
+ * Encodes one block.
+ *
+ * @param encoder Encoder.
+ * @param pcm Samples.
+ * @param length Samples in the block: pv_adpcm_samples_per_block() of the stream's block size, or fewer for its last.
+ * @param block[out] Block of pv_adpcm_block_length() bytes.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT if param ${length} isn't positive.
+ */
+pv_recorder_status_t pv_adpcm_encode_block(
+        pv_adpcm_encoder_t *encoder,
+        const int16_t *pcm,
+        int32_t length,
+        uint8_t *block);
+
+/**
+ * Decodes one block.
+ *
+ * @param block Block.
+ * @param block_length Bytes in the block, at least 4.
+ * @param pcm[out] (block_length - 4) * 2 + 1 samples.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT if param ${block_length} is too short or the
+ * header's step index is out of range.
+ */
+pv_recorder_status_t pv_adpcm_decode_block(const uint8_t *block, int32_t block_length, int16_t *pcm);
+
+/**
+ * Makes the header of a mono IMA-ADPCM WAV file: the RIFF header, a "fmt " chunk with the samples per block, a
+ * "fact" chunk with param ${samples}, and the "data" chunk's header. It is written with zero sizes as a stream
+ * starts, and again with the real ones once it is finished.
+ *
+ * @param sample_rate Sample rate.
+ * @param block_align Bytes in a full block.
+ * @param samples Samples in the stream; 0 while it is being written.
+ * @param data_length Bytes of blocks in the stream; 0 while it is being written.
+ * @param header[out] Header of PV_ADPCM_WAV_HEADER_LENGTH bytes.
+ */
+void pv_adpcm_wav_header(
+        int32_t sample_rate,
+        int32_t block_align,
+        uint32_t samples,
+        uint32_t data_length,
+        uint8_t *header);
+
+#endif // PV_ADPCM_H
@@ -0,0 +1,95 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_CHANNEL_REDUCER_H
+#define PV_CHANNEL_REDUCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PV_CHANNEL_REDUCER_MAX_CHANNELS (8)
+#define PV_CHANNEL_REDUCER_MAX_DELAY (64)
+
+/**
+ * Forward declaration of PV_channel_reducer object. It turns interleaved multi-channel audio into a single channel in
+ * one pass over the input.
+ */
+typedef struct pv_channel_reducer pv_channel_reducer_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_CHANNEL_REDUCER_STATUS_SUCCESS = 0,
+    PV_CHANNEL_REDUCER_STATUS_OUT_OF_MEMORY,
+    PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT,
+} pv_channel_reducer_status_t;
+
+/**
+ * Reduction modes.
+ */
+typedef enum {
+    /** Keep one channel. */
+    PV_CHANNEL_REDUCER_MODE_SELECT = 0,
+    /** Average all channels. */
+    PV_CHANNEL_REDUCER_MODE_AVERAGE,
+    /** Delay each channel by its steering delay, then average. */
+    PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM,
+} pv_channel_reducer_mode_t;
+
+/**
+ * Constructor for PV_channel_reducer object.
+ *
+ * @param channels Number of interleaved input channels, 1 to PV_CHANNEL_REDUCER_MAX_CHANNELS.
+ * @param mode Reduction mode.
+ * @param selected_channel Channel kept by PV_CHANNEL_REDUCER_MODE_SELECT.
+ * @param delays Per-channel delays in samples, 0 to PV_CHANNEL_REDUCER_MAX_DELAY, for
+ * PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM. May be NULL for the other modes.
+ * @param object[out] Channel reducer object.
+ * @return Status Code. Returns PV_CHANNEL_REDUCER_STATUS_OUT_OF_MEMORY or PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT
+ * on failure.
+ */
+pv_channel_reducer_status_t pv_channel_reducer_init(
+        int32_t channels,
+        pv_channel_reducer_mode_t mode,
+        int32_t selected_channel,
+        const int32_t *delays,
+        pv_channel_reducer_t **object);
+
+/**
+ * Destructor for PV_channel_reducer object.
+ *
+ * @param object Channel reducer object.
+ */
+void pv_channel_reducer_delete(pv_channel_reducer_t *object);
+
+/**
+ * Reduces `frame_count` interleaved frames to `frame_count` mono samples.
+ *
+ * @param object Channel reducer object.
+ * @param input Interleaved input of `frame_count * channels` samples.
+ * @param frame_count Number of frames.
+ * @param output[out] Mono output of `frame_count` samples.
+ */
+void pv_channel_reducer_process(
+        pv_channel_reducer_t *object,
+        const int16_t *input,
+        int32_t frame_count,
+        int16_t *output);
+
+/**
+ * Clears the delay line.
+ *
+ * @param object Channel reducer object.
+ */
+void pv_channel_reducer_reset(pv_channel_reducer_t *object);
+
+#endif // PV_CHANNEL_REDUCER_H
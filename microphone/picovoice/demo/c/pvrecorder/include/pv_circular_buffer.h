@@ -28,18 +28,71 @@ typedef enum {
     PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY,
     PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT,
     PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW,
+    PV_CIRCULAR_BUFFER_STATUS_NOT_SUPPORTED,
+    PV_CIRCULAR_BUFFER_STATUS_WOULD_BLOCK,
 } pv_circular_buffer_status_t;
 
+/**
+ * What a write does when there isn't room for all of its elements.
+ */
+typedef enum {
+    /** Overwrite the oldest elements, so the reader resumes at the oldest element that is still stored. */
+    PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST = 0,
+    /** Keep the stored elements and store only the first elements of the write that fit. */
+    PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST,
+    /**
+     * Store nothing and return PV_CIRCULAR_BUFFER_STATUS_WOULD_BLOCK, so the writer can wait until the reader has made
+     * room and write again. Nothing is lost or counted as overflow.
+     */
+    PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK
+} pv_circular_buffer_overflow_policy_t;
+
 /**
  * Constructor for PV_circular_buffer object.
  *
  * @param capacity Capacity of the buffer to read and write.
  * @param element_size Size of each element in the buffer.
+ * @param overflow_policy What a write does when the buffer is full.
  * @param object[out] Circular buffer object.
  * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT
  * on failure.
  */
 pv_circular_buffer_status_t pv_circular_buffer_init(
+        int32_t capacity,
+        int32_t element_size,
+        pv_circular_buffer_overflow_policy_t overflow_policy,
+        pv_circular_buffer_t **object);
+
+/**
+ * Constructor for a single-producer/single-consumer PV_circular_buffer object. Reads and writes use atomic indices and
+ * never block, so exactly one thread may write and exactly one thread may read concurrently without a lock. The
+ * capacity is rounded up to the next power of two. A full SPSC buffer always follows
+ * PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST, as the writer can't take elements away from a reader that may be
+ * copying them.
+ *
+ * @param capacity Minimum capacity of the buffer to read and write.
+ * @param element_size Size of each element in the buffer.
+ * @param object[out] Circular buffer object.
+ * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT
+ * on failure.
+ */
+pv_circular_buffer_status_t pv_circular_buffer_init_spsc(
+        int32_t capacity,
+        int32_t element_size,
+        pv_circular_buffer_t **object);
+
+/**
+ * Constructor for a mirrored single-producer/single-consumer PV_circular_buffer object. The storage is mapped twice
+ * back to back in virtual memory, so every read, write and peek is a single contiguous region and never wraps. The
+ * capacity is rounded up to a power of two of at least one page. Otherwise it behaves like pv_circular_buffer_init_spsc.
+ *
+ * @param capacity Minimum capacity of the buffer to read and write.
+ * @param element_size Size of each element in the buffer. Must be a power of two.
+ * @param object[out] Circular buffer object.
+ * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_NOT_SUPPORTED on platforms without memfd support,
+ * PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT on failure.
+ */
+pv_circular_buffer_status_t pv_circular_buffer_init_mirrored(
         int32_t capacity,
         int32_t element_size,
         pv_circular_buffer_t **object);
@@ -63,8 +116,41 @@ void pv_circular_buffer_delete(pv_circular_buffer_t *object);
 int32_t pv_circular_buffer_read(pv_circular_buffer_t *object, void *buffer, int32_t length);
 
 /**
- * Writes and copies the elements of param ${buffer} to the object's buffer. Overwrites existing frames if the buffer
- * is full and returns PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW which is not a failure.
+ * Returns pointers to up to param ${length} readable elements without copying or consuming them. The elements are
+ * described by two contiguous regions; the second one is only non-empty when the data wraps around the end of the
+ * buffer. The regions stay valid until they are released with pv_circular_buffer_consume. For SPSC buffers the writer
+ * never overwrites unconsumed elements; for the default buffer the caller is responsible for excluding the writer.
+ *
+ * @param object Circular buffer object.
+ * @param length Maximum amount of elements to peek.
+ * @param first[out] Start of the first region.
+ * @param first_length[out] Amount of elements in the first region.
+ * @param second[out] Start of the second region, or NULL when the data doesn't wrap.
+ * @param second_length[out] Amount of elements in the second region.
+ * @return Returns the total amount of elements in both regions or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT.
+ */
+int32_t pv_circular_buffer_peek(
+        pv_circular_buffer_t *object,
+        int32_t length,
+        const void **first,
+        int32_t *first_length,
+        const void **second,
+        int32_t *second_length);
+
+/**
+ * Marks param ${length} elements previously returned by pv_circular_buffer_peek as read.
+ *
+ * @param object Circular buffer object.
+ * @param length The amount of elements to consume. Must not exceed the amount of readable elements.
+ * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT on failure.
+ */
+pv_circular_buffer_status_t pv_circular_buffer_consume(pv_circular_buffer_t *object, int32_t length);
+
+/**
+ * Writes and copies the elements of param ${buffer} to the object's buffer. If they don't all fit, the buffer's
+ * overflow policy decides which elements are lost, and PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, which is not a
+ * failure, is returned. Under PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK nothing is written and
+ * PV_CIRCULAR_BUFFER_STATUS_WOULD_BLOCK is returned instead.
  *
  * @param object Circular buffer object.
  * @param buffer A pointer to copy its elements to the object's buffer.
@@ -74,7 +160,33 @@ int32_t pv_circular_buffer_read(pv_circular_buffer_t *object, void *buffer, int3
 pv_circular_buffer_status_t pv_circular_buffer_write(pv_circular_buffer_t *object, const void *buffer, int32_t length);
 
 /**
- * Reset the buffer pointers to start.
+ * Getter for the capacity of the buffer. For SPSC buffers this is the capacity after rounding up to a power of two.
+ *
+ * @param object Circular buffer object.
+ * @return Capacity in elements.
+ */
+int32_t pv_circular_buffer_get_capacity(const pv_circular_buffer_t *object);
+
+/**
+ * Getter for the number of elements available to read. For SPSC buffers this may be called from either thread.
+ *
+ * @param object Circular buffer object.
+ * @return Number of elements available to read.
+ */
+int32_t pv_circular_buffer_get_count(const pv_circular_buffer_t *object);
+
+/**
+ * Getter for the exact number of elements lost to overflow since the last reset: overwritten elements under
+ * PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, elements not stored under PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST
+ * and none under PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK. For SPSC buffers this may be called from either thread.
+ *
+ * @param object Circular buffer object.
+ * @return Number of elements lost to overflow.
+ */
+uint64_t pv_circular_buffer_get_overflow_count(const pv_circular_buffer_t *object);
+
+/**
+ * Reset the buffer pointers to start. For SPSC buffers neither the producer nor the consumer may be active.
  *
  * @param object Circular buffer object.
  */
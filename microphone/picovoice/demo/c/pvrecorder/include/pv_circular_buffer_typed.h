@@ -0,0 +1,216 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_CIRCULAR_BUFFER_TYPED_H
+#define PV_CIRCULAR_BUFFER_TYPED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pv_circular_buffer.h"
+
+/**
+ * Defines a single-producer/single-consumer circular buffer specialized for one element type at compile time. It
+ * behaves like the buffer from pv_circular_buffer_init_spsc: the capacity is rounded up to the next power of two, reads
+ * and writes use atomic positions, and a full buffer drops the newest elements. As the element size is a constant and
+ * positions are wrapped with a mask, every copy is a memcpy of a known element type with no run-time multiply or
+ * modulo, and all functions are `static inline` so they can be folded into the caller.
+ *
+ * `PV_CIRCULAR_BUFFER_TYPED(pv_pcm_ring, int16_t)` defines `pv_pcm_ring_t` and these functions, which take and return
+ * the same arguments and status codes as their pv_circular_buffer counterparts, with lengths in elements of `type`:
+ *
+ *     pv_pcm_ring_init(capacity, object)
+ *     pv_pcm_ring_delete(object)
+ *     pv_pcm_ring_write(object, buffer, length)
+ *     pv_pcm_ring_read(object, buffer, length)
+ *     pv_pcm_ring_peek(object, length, first, first_length, second, second_length)
+ *     pv_pcm_ring_consume(object, length)
+ *     pv_pcm_ring_get_capacity(object)
+ *     pv_pcm_ring_get_count(object)
+ *     pv_pcm_ring_get_overflow_count(object)
+ *     pv_pcm_ring_reset(object)
+ *
+ * @param name Prefix of the type and its functions.
+ * @param type Element type.
+ */
+#define PV_CIRCULAR_BUFFER_TYPED(name, type) \
+\
+typedef struct { \
+    type *buffer; \
+    int32_t capacity; \
+    uint32_t mask; \
+    uint32_t read_position; \
+    uint32_t write_position; \
+    uint64_t overflow_count; \
+} name##_t; \
+\
+static inline pv_circular_buffer_status_t name##_init(int32_t capacity, name##_t **object) { \
+    if ((capacity <= 0) || (capacity > (INT32_MAX / 2) + 1)) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+    if (!object) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+\
+    *object = NULL; \
+\
+    uint32_t rounded_capacity = 1; \
+    while (rounded_capacity < (uint32_t) capacity) { \
+        rounded_capacity <<= 1; \
+    } \
+\
+    name##_t *o = calloc(1, sizeof(name##_t)); \
+    if (!o) { \
+        return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY; \
+    } \
+\
+    o->buffer = malloc((size_t) rounded_capacity * sizeof(type)); \
+    if (!(o->buffer)) { \
+        free(o); \
+        return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY; \
+    } \
+\
+    o->capacity = (int32_t) rounded_capacity; \
+    o->mask = rounded_capacity - 1; \
+\
+    *object = o; \
+\
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS; \
+} \
+\
+static inline void name##_delete(name##_t *object) { \
+    if (object) { \
+        free(object->buffer); \
+        free(object); \
+    } \
+} \
+\
+static inline pv_circular_buffer_status_t name##_write(name##_t *object, const type *buffer, int32_t length) { \
+    if (!object || !buffer) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+    if ((length <= 0) || (length > object->capacity)) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+\
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_RELAXED); \
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_ACQUIRE); \
+\
+    const int32_t free_space = object->capacity - (int32_t) (write_position - read_position); \
+    const int32_t to_copy = (free_space < length) ? free_space : length; \
+\
+    const int32_t index = (int32_t) (write_position & object->mask); \
+    const int32_t first = ((object->capacity - index) < to_copy) ? (object->capacity - index) : to_copy; \
+    memcpy(object->buffer + index, buffer, (size_t) first * sizeof(type)); \
+    memcpy(object->buffer, buffer + first, (size_t) (to_copy - first) * sizeof(type)); \
+\
+    __atomic_store_n(&object->write_position, write_position + (uint32_t) to_copy, __ATOMIC_RELEASE); \
+\
+    if (to_copy < length) { \
+        const uint64_t overflow_count = __atomic_load_n(&object->overflow_count, __ATOMIC_RELAXED); \
+        __atomic_store_n(&object->overflow_count, overflow_count + (uint64_t) (length - to_copy), __ATOMIC_RELAXED); \
+        return PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW; \
+    } \
+\
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS; \
+} \
+\
+static inline int32_t name##_read(name##_t *object, type *buffer, int32_t length) { \
+    if (!object || !buffer) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+    if ((length <= 0) || (length > object->capacity)) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+\
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED); \
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE); \
+\
+    const int32_t count = (int32_t) (write_position - read_position); \
+    const int32_t to_copy = (count < length) ? count : length; \
+\
+    const int32_t index = (int32_t) (read_position & object->mask); \
+    const int32_t first = ((object->capacity - index) < to_copy) ? (object->capacity - index) : to_copy; \
+    memcpy(buffer, object->buffer + index, (size_t) first * sizeof(type)); \
+    memcpy(buffer + first, object->buffer, (size_t) (to_copy - first) * sizeof(type)); \
+\
+    __atomic_store_n(&object->read_position, read_position + (uint32_t) to_copy, __ATOMIC_RELEASE); \
+\
+    return to_copy; \
+} \
+\
+static inline int32_t name##_peek( \
+        name##_t *object, \
+        int32_t length, \
+        const type **first, \
+        int32_t *first_length, \
+        const type **second, \
+        int32_t *second_length) { \
+    if (!object || !first || !first_length || !second || !second_length) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+    if ((length <= 0) || (length > object->capacity)) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+\
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED); \
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE); \
+\
+    const int32_t count = (int32_t) (write_position - read_position); \
+    const int32_t total = (count < length) ? count : length; \
+    const int32_t index = (int32_t) (read_position & object->mask); \
+    const int32_t available = object->capacity - index; \
+\
+    *first = object->buffer + index; \
+    *first_length = (total < available) ? total : available; \
+    *second_length = total - *first_length; \
+    *second = (*second_length > 0) ? object->buffer : NULL; \
+\
+    return total; \
+} \
+\
+static inline int32_t name##_get_count(const name##_t *object) { \
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE); \
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_ACQUIRE); \
+    return (int32_t) (write_position - read_position); \
+} \
+\
+static inline pv_circular_buffer_status_t name##_consume(name##_t *object, int32_t length) { \
+    if (!object) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+    if ((length <= 0) || (length > name##_get_count(object))) { \
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT; \
+    } \
+\
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED); \
+    __atomic_store_n(&object->read_position, read_position + (uint32_t) length, __ATOMIC_RELEASE); \
+\
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS; \
+} \
+\
+static inline int32_t name##_get_capacity(const name##_t *object) { \
+    return object->capacity; \
+} \
+\
+static inline uint64_t name##_get_overflow_count(const name##_t *object) { \
+    return __atomic_load_n(&object->overflow_count, __ATOMIC_RELAXED); \
+} \
+\
+static inline void name##_reset(name##_t *object) { \
+    __atomic_store_n(&object->read_position, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&object->write_position, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&object->overflow_count, 0, __ATOMIC_RELAXED); \
+}
+
+#endif // PV_CIRCULAR_BUFFER_TYPED_H
@@ -0,0 +1,78 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_DECIMATOR_H
+#define PV_DECIMATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Forward declaration of PV_decimator object. It low-pass filters and downsamples 16-bit audio by a fixed integer
+ * factor, keeping filter state across calls.
+ */
+typedef struct pv_decimator pv_decimator_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_DECIMATOR_STATUS_SUCCESS = 0,
+    PV_DECIMATOR_STATUS_OUT_OF_MEMORY,
+    PV_DECIMATOR_STATUS_INVALID_ARGUMENT,
+} pv_decimator_status_t;
+
+/**
+ * Constructor for PV_decimator object. The anti-aliasing filter is a windowed-sinc FIR with Q15 coefficients and unity
+ * gain at DC, evaluated only at the kept output positions.
+ *
+ * @param factor Decimation factor. Must be 2 or 3.
+ * @param object[out] Decimator object.
+ * @return Status Code. Returns PV_DECIMATOR_STATUS_OUT_OF_MEMORY or PV_DECIMATOR_STATUS_INVALID_ARGUMENT on failure.
+ */
+pv_decimator_status_t pv_decimator_init(int32_t factor, pv_decimator_t **object);
+
+/**
+ * Destructor for PV_decimator object.
+ *
+ * @param object Decimator object.
+ */
+void pv_decimator_delete(pv_decimator_t *object);
+
+/**
+ * Filters and downsamples `input_length` samples. Input that doesn't complete an output sample is kept for the next
+ * call.
+ *
+ * @param object Decimator object.
+ * @param input Input samples at the original rate.
+ * @param input_length Number of input samples.
+ * @param output[out] Output samples. Must hold pv_decimator_get_max_output_length(object, input_length) samples.
+ * @return Number of output samples written.
+ */
+int32_t pv_decimator_process(pv_decimator_t *object, const int16_t *input, int32_t input_length, int16_t *output);
+
+/**
+ * Getter for the largest number of samples a single pv_decimator_process call can produce.
+ *
+ * @param object Decimator object.
+ * @param input_length Number of input samples.
+ * @return Maximum output length.
+ */
+int32_t pv_decimator_get_max_output_length(const pv_decimator_t *object, int32_t input_length);
+
+/**
+ * Clears the filter state.
+ *
+ * @param object Decimator object.
+ */
+void pv_decimator_reset(pv_decimator_t *object);
+
+#endif // PV_DECIMATOR_H
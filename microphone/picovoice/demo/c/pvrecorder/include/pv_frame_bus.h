@@ -0,0 +1,63 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_FRAME_BUS_H
+#define PV_FRAME_BUS_H
+
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Forward declaration of PV_frame_bus object, the publishing end of a frame bus: a ring of frames in POSIX shared
+ * memory that any number of pv_recorder_bus_reader_t objects in other processes read without taking part in it.
+ *
+ * Every slot is a seqlock. The single writer marks a slot as being written, fills it and stamps it with the frame's
+ * bus sequence number; a reader copies the slot out and keeps the copy only if the stamp is the one it wanted before
+ * and after. A reader that falls a whole ring behind skips to the oldest frame still in it and counts what it missed,
+ * so no reader can hold up the writer or another reader. Readers sleep on a futex word bumped by every frame on Linux,
+ * and poll elsewhere.
+ */
+typedef struct pv_frame_bus pv_frame_bus_t;
+
+/**
+ * Constructor. Creates, or takes over, the shared-memory object `name`.
+ *
+ * @param name Name of the bus. A leading '/' is added if it's missing.
+ * @param frame_length Samples per frame.
+ * @param slot_count Frames the ring holds.
+ * @param object[out] Frame bus object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_OUT_OF_MEMORY, or
+ * PV_RECORDER_STATUS_BACKEND_ERROR if the shared memory can't be set up or the platform has none.
+ */
+pv_recorder_status_t pv_frame_bus_init(
+        const char *name,
+        int32_t frame_length,
+        int32_t slot_count,
+        pv_frame_bus_t **object);
+
+/**
+ * Destructor. Tells the readers the bus is closed, then unmaps and unlinks the shared memory.
+ *
+ * @param object Frame bus object.
+ */
+void pv_frame_bus_delete(pv_frame_bus_t *object);
+
+/**
+ * Publishes one frame and wakes the readers waiting for it. Never blocks.
+ *
+ * @param object Frame bus object.
+ * @param pcm Frame of `frame_length` samples.
+ * @param info Metadata of the frame, passed through to the readers.
+ */
+void pv_frame_bus_publish(pv_frame_bus_t *object, const int16_t *pcm, const pv_recorder_frame_info_t *info);
+
+#endif // PV_FRAME_BUS_H
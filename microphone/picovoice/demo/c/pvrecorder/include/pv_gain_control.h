@@ -0,0 +1,86 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+
+#ifndef PV_GAIN_CONTROL_H
+#define PV_GAIN_CONTROL_H
+
+#include <stdint.h>
+
+/**
+ * Forward declaration of PV_gain_control object. It brings 16-bit mono audio to a steady level, so a quiet microphone
+ * and a loud one sound alike to the engines. Audio is taken in blocks of 64 samples. An envelope follows each block's
+ * RMS, rising within about 10 ms (attack) and falling over about a second (release), and the gain is the target level
+ * over the envelope, between -20 dB and the maximum gain. It is also held down so the block's peak can't clip. Blocks
+ * quieter than -55 dBFS leave the envelope where it was, so silence and hiss aren't turned up to the maximum. Within a
+ * block the gain ramps from its last value to the new one, and the samples are scaled in Q11 with saturation.
+ */
+typedef struct pv_gain_control pv_gain_control_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_GAIN_CONTROL_STATUS_SUCCESS = 0,
+    PV_GAIN_CONTROL_STATUS_OUT_OF_MEMORY,
+    PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT,
+} pv_gain_control_status_t;
+
+/**
+ * Constructor for PV_gain_control object. The NEON kernel is used if pv_recorder was built with it and the CPU has
+ * NEON at this point; the choice is kept for the object's lifetime.
+ *
+ * @param sample_rate Sample rate of the audio in Hz.
+ * @param target_dbfs RMS level to bring the audio to, from -40 to -3 dBFS.
+ * @param max_gain_db Most the audio is turned up, from 0 to 24 dB.
+ * @param object[out] Gain control object.
+ * @return Status Code. Returns PV_GAIN_CONTROL_STATUS_OUT_OF_MEMORY or PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT on
+ * failure.
+ */
+pv_gain_control_status_t pv_gain_control_init(
+        int32_t sample_rate,
+        float target_dbfs,
+        float max_gain_db,
+        pv_gain_control_t **object);
+
+/**
+ * Destructor for PV_gain_control object.
+ *
+ * @param object Gain control object.
+ */
+void pv_gain_control_delete(pv_gain_control_t *object);
+
+/**
+ * Scales samples by the gain. Adds no delay.
+ *
+ * @param object Gain control object.
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param output[out] Scaled samples. May be the same as `input`.
+ */
+void pv_gain_control_process(pv_gain_control_t *object, const int16_t *input, int32_t length, int16_t *output);
+
+/**
+ * Getter for the gain at the end of the last block processed.
+ *
+ * @param object Gain control object.
+ * @return Gain in dB.
+ */
+float pv_gain_control_get_gain_db(const pv_gain_control_t *object);
+
+/**
+ * Forgets the level of the audio so far and goes back to unity gain.
+ *
+ * @param object Gain control object.
+ */
+void pv_gain_control_reset(pv_gain_control_t *object);
+
+#endif // PV_GAIN_CONTROL_H
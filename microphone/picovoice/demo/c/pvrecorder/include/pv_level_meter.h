@@ -0,0 +1,38 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_LEVEL_METER_H
+#define PV_LEVEL_METER_H
+
+#include <stdint.h>
+
+/**
+ * Level of a block of 16-bit samples.
+ */
+typedef struct {
+    /** Root mean square of the samples, 0 to 32768. */
+    float rms;
+    /** Largest magnitude, 0 to 32767; INT16_MIN counts as 32767. */
+    int32_t peak;
+    /** Samples at full scale, i.e. INT16_MIN or INT16_MAX. */
+    int32_t clipped_samples;
+} pv_level_t;
+
+/**
+ * Measures RMS, peak and clipping of param ${length} samples in a single pass, with NEON or SSE2 where available.
+ *
+ * @param pcm Samples.
+ * @param length Number of samples.
+ * @param level[out] Level of the samples; all zero if param ${length} isn't positive.
+ */
+void pv_level_meter_measure(const int16_t *pcm, int32_t length, pv_level_t *level);
+
+#endif // PV_LEVEL_METER_H
@@ -0,0 +1,84 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_NOISE_SUPPRESSOR_H
+#define PV_NOISE_SUPPRESSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Forward declaration of PV_noise_suppressor object. It removes steady noise, such as the hum of a pump and its
+ * harmonics or the hiss of a filter, from 16-bit mono audio by spectral subtraction. Each frame is analysed as two
+ * half-overlapping windows; their spectra come from a single fixed-point FFT, the two real windows being packed into
+ * one complex signal. Each bin's noise power follows its quietest recent level, falling quickly and rising slowly, so
+ * speech doesn't become the noise, and the bin is scaled by the Wiener gain `1 - 2 * noise / power`, never below the
+ * floor set by `attenuation_db`. Output is delayed by half a frame.
+ */
+typedef struct pv_noise_suppressor pv_noise_suppressor_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_NOISE_SUPPRESSOR_STATUS_SUCCESS = 0,
+    PV_NOISE_SUPPRESSOR_STATUS_OUT_OF_MEMORY,
+    PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT,
+} pv_noise_suppressor_status_t;
+
+/**
+ * Constructor for PV_noise_suppressor object. The NEON kernels are used if pv_recorder was built with them and the CPU
+ * has NEON at this point; the choice is kept for the object's lifetime.
+ *
+ * @param frame_length Samples per frame, which is also the FFT length. Must be a power of two from 64 to 2048.
+ * @param attenuation_db How far a bin of pure noise is turned down, from 1 to 40 dB.
+ * @param object[out] Noise suppressor object.
+ * @return Status Code. Returns PV_NOISE_SUPPRESSOR_STATUS_OUT_OF_MEMORY or PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT
+ * on failure.
+ */
+pv_noise_suppressor_status_t pv_noise_suppressor_init(
+        int32_t frame_length,
+        float attenuation_db,
+        pv_noise_suppressor_t **object);
+
+/**
+ * Destructor for PV_noise_suppressor object.
+ *
+ * @param object Noise suppressor object.
+ */
+void pv_noise_suppressor_delete(pv_noise_suppressor_t *object);
+
+/**
+ * Suppresses the noise in one frame. The output is the input of `pv_noise_suppressor_get_delay` samples earlier.
+ *
+ * @param object Noise suppressor object.
+ * @param input Frame of `frame_length` samples.
+ * @param output[out] Frame of `frame_length` samples. May be the same as `input`.
+ */
+void pv_noise_suppressor_process(pv_noise_suppressor_t *object, const int16_t *input, int16_t *output);
+
+/**
+ * Getter for the delay the suppressor adds.
+ *
+ * @param object Noise suppressor object.
+ * @return Delay in samples, half a frame.
+ */
+int32_t pv_noise_suppressor_get_delay(const pv_noise_suppressor_t *object);
+
+/**
+ * Forgets the audio and the noise learned from it. The next frame is taken as noise to start from, as the room is
+ * assumed quiet when listening starts.
+ *
+ * @param object Noise suppressor object.
+ */
+void pv_noise_suppressor_reset(pv_noise_suppressor_t *object);
+
+#endif // PV_NOISE_SUPPRESSOR_H
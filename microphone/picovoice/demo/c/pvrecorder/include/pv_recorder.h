@@ -19,12 +19,223 @@
 
 #define PV_RECORDER_DEFAULT_DEVICE_INDEX (-1)
 
+#define PV_RECORDER_MAX_CHANNELS (8)
+
+#define PV_RECORDER_MAX_READERS (8)
+
 /**
  * Forward declaration of PV_Recorder object. It contains everything related to recording
  * audio, and audio frame information.
  */
 typedef struct pv_recorder pv_recorder_t;
 
+/**
+ * Metadata describing a frame returned by pv_recorder_read_ex or pv_recorder_reader_read.
+ */
+typedef struct {
+    /** Monotonic capture time of the first sample of the frame in microseconds. */
+    int64_t timestamp_usec;
+    /** Index of the frame since the recorder was last started. */
+    int64_t sequence_number;
+    /** Total samples this reader lost to buffer overflow since the recorder was last started. */
+    int64_t dropped_samples;
+    /** Root mean square of the frame's samples, 0 to 32768. */
+    float rms;
+    /** Largest sample magnitude in the frame, 0 to 32767. */
+    int32_t peak;
+    /** Samples in the frame at full scale, i.e. INT16_MIN or INT16_MAX. */
+    int32_t clipped_samples;
+} pv_recorder_frame_info_t;
+
+/**
+ * Recorder statistics since the recorder was last started. See pv_recorder_get_stats.
+ */
+typedef struct {
+    /** Samples delivered by the audio device, counted at 16 kHz. */
+    int64_t total_samples;
+    /** Samples dropped because the ring buffer was full, plus those any reader skipped to drop the oldest. */
+    int64_t overflow_samples;
+    /** Highest ring buffer occupancy in samples. */
+    int64_t max_buffered_samples;
+    /** Number of measured intervals between capture callbacks. */
+    int64_t callback_count;
+    /** Shortest interval between capture callbacks in microseconds. */
+    int64_t min_callback_interval_usec;
+    /** Longest interval between capture callbacks in microseconds. */
+    int64_t max_callback_interval_usec;
+    /** Mean interval between capture callbacks in microseconds. */
+    int64_t avg_callback_interval_usec;
+    /** Total time readers spent waiting for audio in microseconds. */
+    int64_t total_read_wait_usec;
+    /** Longest single wait for audio in microseconds. */
+    int64_t max_read_wait_usec;
+} pv_recorder_stats_t;
+
+/**
+ * Callback receiving one complete audio frame.
+ *
+ * @param pcm Frame of `frame_length` samples. Only valid for the duration of the call.
+ * @param user_data Pointer passed to pv_recorder_set_frame_callback.
+ */
+typedef void (*pv_recorder_frame_callback_t)(const int16_t *pcm, void *user_data);
+
+/**
+ * Callback receiving a warning, e.g. about an overflow, instead of it being printed to stdout.
+ *
+ * @param message Warning without a trailing newline. Only valid for the duration of the call.
+ * @param user_data Pointer passed to pv_recorder_set_log_callback.
+ */
+typedef void (*pv_recorder_log_callback_t)(const char *message, void *user_data);
+
+/**
+ * Capture backends.
+ */
+typedef enum {
+    /** miniaudio, picking the platform's default audio API. */
+    PV_RECORDER_BACKEND_DEFAULT = 0,
+    /** Direct ALSA mmap capture on Linux. Only available when built with PV_RECORDER_ALSA_MMAP. */
+    PV_RECORDER_BACKEND_ALSA_MMAP,
+    /** 16 kHz mono audio streamed over a serial line by a wake word co-processor. Not available on Windows. */
+    PV_RECORDER_BACKEND_SERIAL,
+    /** 16 kHz mono audio replayed from a WAV or raw PCM file, for tests and benchmarks. Linux only. */
+    PV_RECORDER_BACKEND_FILE
+} pv_recorder_backend_t;
+
+/**
+ * How multi-channel capture is reduced to the mono frame.
+ */
+typedef enum {
+    /** Keep only `selected_channel`. */
+    PV_RECORDER_CHANNEL_MODE_SELECT = 0,
+    /** Average all channels. */
+    PV_RECORDER_CHANNEL_MODE_AVERAGE,
+    /** Delay each channel by `channel_delays[c]` samples, then average. Steers a microphone array towards a source. */
+    PV_RECORDER_CHANNEL_MODE_DELAY_AND_SUM
+} pv_recorder_channel_mode_t;
+
+/**
+ * What happens to audio when the reader falls so far behind that the ring buffer is full. With readers added by
+ * pv_recorder_add_reader the ring is full once the slowest of them is a buffer behind, and the policy applies to that
+ * reader. Dropped samples are counted exactly in `dropped_samples` and `overflow_samples` whichever policy is used.
+ */
+typedef enum {
+    /** Keep the buffered audio and drop what arrives while the ring is full. The default, and the zero value. */
+    PV_RECORDER_OVERFLOW_POLICY_DROP_NEWEST = 0,
+    /**
+     * Skip the oldest audio, so the reader always gets the latest `buffer_size_msec`. Suits live inference, where late
+     * audio is worth less than fresh audio. When the ring fills, the capture thread skips the readers ahead before
+     * writing, so however long a reader stalls it resumes on the latest audio. The ring holds twice the buffer, so that
+     * happens at most once per buffer. A reader is only ever skipped between frames, and never while it views one, so
+     * every frame is continuous. Any reader skips the ones that have fallen behind ahead too, so a stalled reader doesn't
+     * hold the others up.
+     */
+    PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST,
+    /**
+     * Hold up the capture thread until the slowest reader has made room, so the audio device's own buffer takes up the
+     * backlog. Suits recording, where a gap is worse than latency. The capture thread waits at most
+     * `buffer_size_msec` at a time and then drops the newest samples, so a reader that stops reading can't stall it
+     * for good.
+     */
+    PV_RECORDER_OVERFLOW_POLICY_BLOCK
+} pv_recorder_overflow_policy_t;
+
+/**
+ * How the capture device's period, the audio it hands over per wakeup, is sized against `frame_length`. A shorter
+ * period gets a frame to the reader sooner after its last sample; a longer one wakes the CPU less often. See
+ * pv_recorder_get_latency for what the device actually chose.
+ */
+typedef enum {
+    /** Leave the period to the backend: miniaudio's default, and one frame with PV_RECORDER_BACKEND_ALSA_MMAP. */
+    PV_RECORDER_LATENCY_PROFILE_DEFAULT = 0,
+    /** Half a frame per period, so a frame is complete at most half a frame after its last sample. */
+    PV_RECORDER_LATENCY_PROFILE_LOW_LATENCY,
+    /** One frame per period, so each wakeup hands the reader exactly what it waits for. */
+    PV_RECORDER_LATENCY_PROFILE_BALANCED,
+    /** Four frames per period, for a quarter of the wakeups of PV_RECORDER_LATENCY_PROFILE_BALANCED. */
+    PV_RECORDER_LATENCY_PROFILE_POWER_SAVE
+} pv_recorder_latency_profile_t;
+
+/**
+ * Capture buffering negotiated with the device. See pv_recorder_get_latency.
+ */
+typedef struct {
+    /** Device frames per period, at `sample_rate`. */
+    int32_t period_frames;
+    /** Periods in the device buffer. */
+    int32_t periods;
+    /** Length of a period in microseconds, the longest a captured sample waits before the recorder sees it. */
+    int64_t period_usec;
+    /** Length of the device buffer in microseconds, how long a stalled capture can go before the device overruns. */
+    int64_t buffer_usec;
+} pv_recorder_latency_t;
+
+/**
+ * Recorder configuration. See pv_recorder_default_config and pv_recorder_init_with_config.
+ */
+typedef struct {
+    /** Capture backend. */
+    pv_recorder_backend_t backend;
+    /** Index of the audio device for PV_RECORDER_BACKEND_DEFAULT; (-1) selects the default device. */
+    int32_t device_index;
+    /**
+     * Name of the audio device for PV_RECORDER_BACKEND_DEFAULT, as listed by pv_recorder_get_audio_devices; takes the
+     * place of `device_index`, which shifts as devices come and go. On Linux the recorder follows the device: when it
+     * is unplugged capture pauses, and when it is plugged back in it is reopened and capture resumes without a new
+     * recorder. NULL selects by `device_index`.
+     */
+    const char *device_name;
+    /** ALSA PCM name for PV_RECORDER_BACKEND_ALSA_MMAP, e.g. "hw:1,0"; NULL selects "default". */
+    const char *alsa_device_name;
+    /** Serial device path for PV_RECORDER_BACKEND_SERIAL, e.g. "/dev/ttyS4". */
+    const char *serial_device_name;
+    /** Line rate in baud for PV_RECORDER_BACKEND_SERIAL. */
+    int32_t serial_baud_rate;
+    /** Path of the recording for PV_RECORDER_BACKEND_FILE. */
+    const char *file_name;
+    /**
+     * Replay pace for PV_RECORDER_BACKEND_FILE as a multiple of real time, 1 by default; 0 replays as fast as the
+     * recorder takes the audio, which with PV_RECORDER_OVERFLOW_POLICY_BLOCK drops none of it. Under that policy a file
+     * waits for the readers without the `buffer_size_msec` limit, however slow they are.
+     */
+    float file_speed;
+    /** The length of audio frame to get for each read call. */
+    int32_t frame_length;
+    /**
+     * Capture rate in Hz: 16000, 32000 or 48000. Audio is always delivered at 16000 Hz; higher rates are decimated
+     * inside the recorder so devices can run at their native rate.
+     */
+    int32_t sample_rate;
+    /** Interleaved channels to capture, 1 to PV_RECORDER_MAX_CHANNELS. Frames are always mono. */
+    int32_t channels;
+    /** Reduction applied when `channels` is greater than one. */
+    pv_recorder_channel_mode_t channel_mode;
+    /** Channel kept by PV_RECORDER_CHANNEL_MODE_SELECT. */
+    int32_t selected_channel;
+    /** Steering delays in samples at `sample_rate`, 0 to 64, for PV_RECORDER_CHANNEL_MODE_DELAY_AND_SUM. */
+    int32_t channel_delays[PV_RECORDER_MAX_CHANNELS];
+    /** Time in milliseconds to store audio frames to a temporary buffer. */
+    int32_t buffer_size_msec;
+    /** What happens to audio when the buffer is full. */
+    pv_recorder_overflow_policy_t overflow_policy;
+    /**
+     * Capture period of the device, against latency and wakeups. Ignored by PV_RECORDER_BACKEND_SERIAL and
+     * PV_RECORDER_BACKEND_FILE.
+     */
+    pv_recorder_latency_profile_t latency_profile;
+    /** Enables warning logs when buffer overflow occurs. */
+    bool log_overflow;
+    /** Enables logs when continuous audio buffers are detected as silent. */
+    bool log_silence;
+    /**
+     * SCHED_FIFO priority, 1 to 99, for the recorder's own threads: the push mode worker, the ALSA mmap capture
+     * thread and the serial reader thread. 0 leaves them at normal priority. Needs CAP_SYS_NICE or an RLIMIT_RTPRIO allowance; without it the
+     * threads keep normal priority, see pv_recorder_get_scheduling.
+     */
+    int32_t realtime_priority;
+    /** CPU the recorder's threads are pinned to (Linux only); (-1) lets the scheduler place them. */
+    int32_t cpu;
+} pv_recorder_config_t;
+
 /**
  * Status codes.
  */
@@ -47,6 +258,7 @@ typedef enum {
  * @param frame_length The length of audio frame to get for each read call.
  * @param buffer_size_msec Time in milliseconds to store audio frames to a temporary buffer.
  * @param log_overflow Boolean variable to enable overflow logs. This will enable warning logs when buffer overflow occurs.
+ * The warning is printed by the reading thread, never by the audio callback.
  * @param log_silence Boolean variable to enable silence logs. This will log when continuous audio buffers are detected as silent.
  * @param[out] object Audio Recorder object to initialize.
  * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR,
@@ -60,6 +272,35 @@ PV_API pv_recorder_status_t pv_recorder_init(
         bool log_silence,
         pv_recorder_t **object);
 
+/**
+ * Returns a configuration matching the defaults of pv_recorder_init: default backend and device, 16 kHz mono capture,
+ * a 100 ms buffer that drops the newest audio when full, the backend's own capture period, all logs enabled and threads at normal priority on any CPU.
+ *
+ * @param frame_length The length of audio frame to get for each read call.
+ * @return Recorder configuration.
+ */
+PV_API pv_recorder_config_t pv_recorder_default_config(int32_t frame_length);
+
+/**
+ * Constructor taking a full configuration, including the capture backend.
+ *
+ * With PV_RECORDER_BACKEND_ALSA_MMAP the period size follows `latency_profile`, one frame by default, and captured
+ * periods are copied from the ALSA mmap area straight into the ring buffer, without miniaudio's intermediate buffers.
+ *
+ * With PV_RECORDER_BACKEND_SERIAL `sample_rate` must be 16000 and `channels` 1. The co-processor only sends audio
+ * after it detects a wake word, so reads time out with PV_RECORDER_STATUS_IO_ERROR between bursts.
+ *
+ * With PV_RECORDER_BACKEND_FILE `sample_rate` must be 16000 and `channels` 1 as well. Once the whole file has been
+ * delivered, reads time out and pv_recorder_is_at_end returns true.
+ *
+ * @param config Recorder configuration.
+ * @param[out] object Audio Recorder object to initialize.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR,
+ * PV_RECORDER_STATUS_DEVICE_INITIALIZED or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure. Returns
+ * PV_RECORDER_STATUS_BACKEND_ERROR if the requested backend was not built in.
+ */
+PV_API pv_recorder_status_t pv_recorder_init_with_config(const pv_recorder_config_t *config, pv_recorder_t **object);
+
 /**
  * Destructor.
  *
@@ -87,6 +328,8 @@ PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object);
 
 /**
  * Synchronous call to read frames. Copies param ${length} amount of frames to param ${pcm} array provided to input.
+ * Blocks until the capture callback has provided a full frame, or until the read timeout set by
+ * pv_recorder_set_read_timeout expires.
  *
  * @param object PV_Recorder object.
  * @param pcm[out] An array for the frames to be copied to.
@@ -96,6 +339,317 @@ PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object);
  */
 PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *pcm);
 
+/**
+ * Reads param ${num_frames} consecutive frames into param ${pcm} in one call, waiting for each as pv_recorder_read
+ * does; frames already buffered are taken together, as by pv_recorder_read_available. Lets bindings whose calls are
+ * costly, e.g. ones that give up an interpreter lock around every call, take several frames per crossing.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] An array of `num_frames * frame_length` samples for the frames to be copied to.
+ * @param num_frames Number of frames to read.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_INVALID_STATE or PV_RECORDER_IO_ERROR
+ * on failure, in which case the frames already copied are lost.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_frames(pv_recorder_t *object, int16_t *pcm, int32_t num_frames);
+
+/**
+ * Waits for a frame as pv_recorder_read does, then takes it along with every whole frame that is already buffered
+ * after it, up to param ${max_frames}, under one lock and in one copy. Catching up on a backlog, e.g. after a stall
+ * or from a binding whose calls are costly, then takes one call rather than one per frame.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] An array of `max_frames * frame_length` samples for the frames to be copied to.
+ * @param max_frames Most frames to read.
+ * @param frames_read[out] Frames copied to param ${pcm}, at least one on success.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_INVALID_STATE or PV_RECORDER_IO_ERROR
+ * on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_available(
+        pv_recorder_t *object,
+        int16_t *pcm,
+        int32_t max_frames,
+        int32_t *frames_read);
+
+/**
+ * Same as pv_recorder_read, but also fills param ${info} with the frame's capture timestamp, sequence number and the
+ * running count of samples dropped to overflow. The timestamp is derived from the time of the latest capture period
+ * and the frame's offset from it in the ring buffer; a change in `dropped_samples` between two frames marks a gap.
+ * The level of the frame, i.e. its RMS, peak and clipped samples, comes from the same pass as the silence warning.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] An array for the frames to be copied to.
+ * @param info[out] Frame metadata.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_INVALID_STATE or PV_RECORDER_IO_ERROR on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_ex(pv_recorder_t *object, int16_t *pcm, pv_recorder_frame_info_t *info);
+
+/**
+ * Zero-copy variant of pv_recorder_read. Waits for a full frame and points param ${pcm} at it. The pointer refers
+ * directly to the recorder's ring buffer unless the frame wraps around its end, in which case the frame is assembled
+ * in a recorder-owned scratch buffer. The frame stays valid until pv_recorder_release_view is called, which must
+ * happen before the next read.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] Pointer to the frame of `frame_length` samples.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_view(pv_recorder_t *object, const int16_t **pcm);
+
+/**
+ * Releases the frame returned by pv_recorder_read_view so its space in the ring buffer can be reused.
+ *
+ * @param object PV_Recorder object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_release_view(pv_recorder_t *object);
+
+/**
+ * Same as pv_recorder_read, but the frame comes as float samples in [-1, 1), i.e. divided by 32768. The samples are
+ * converted as they leave the ring buffer, in one vectorized pass, so there is no 16-bit copy to convert afterwards.
+ * With param ${is_dc_blocked} the DC is taken out in the same pass, by a one-pole high-pass at 10 Hz that carries on
+ * from frame to frame, shared with pv_recorder_read_dc_blocked, and starts afresh with pv_recorder_start. The frame is
+ * metered, for the silence warning, before either.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] An array of `frame_length` floats for the frame.
+ * @param is_dc_blocked True to take the DC out as well.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_float(pv_recorder_t *object, float *pcm, bool is_dc_blocked);
+
+/**
+ * Same as pv_recorder_read, but with the DC taken out as the frame leaves the ring buffer, by the filter of
+ * pv_recorder_read_float, and the result rounded and saturated back to 16 bits.
+ *
+ * @param object PV_Recorder object.
+ * @param pcm[out] An array for the frame to be copied to.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_dc_blocked(pv_recorder_t *object, int16_t *pcm);
+
+/**
+ * Copies the recorder statistics. The counters are updated lock-free by the capture callback and the reader, so this
+ * can be called from any thread at any time; fields may be from slightly different instants.
+ *
+ * @param object PV_Recorder object.
+ * @param stats[out] Statistics.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_stats(pv_recorder_t *object, pv_recorder_stats_t *stats);
+
+/**
+ * Reads back the capture buffering the device negotiated for `latency_profile`. Drivers round the period to what the
+ * hardware supports, so it may differ from the profile's.
+ *
+ * @param object PV_Recorder object.
+ * @param latency[out] Negotiated period and buffer.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_RUNTIME_ERROR if the backend
+ * reported no period, or PV_RECORDER_STATUS_INVALID_STATE with PV_RECORDER_BACKEND_SERIAL, where the co-processor and
+ * not a device period decides when audio arrives.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_latency(pv_recorder_t *object, pv_recorder_latency_t *latency);
+
+/**
+ * Reads back the scheduling the push mode worker actually got from `realtime_priority` and `cpu`, so it can be
+ * reported once the recorder is started.
+ *
+ * @param object PV_Recorder object.
+ * @param realtime_priority[out] SCHED_FIFO priority of the worker, or 0 if it runs at normal priority.
+ * @param cpu[out] CPU the worker is pinned to, or (-1) if it may run on more than one.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, or PV_RECORDER_STATUS_INVALID_STATE if no worker
+ * is running.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_scheduling(pv_recorder_t *object, int32_t *realtime_priority, int32_t *cpu);
+
+/**
+ * Switches the recorder to push mode. Once started, a worker thread owned by the recorder assembles each complete
+ * frame and passes it to param ${callback}; pv_recorder_read and pv_recorder_read_view then fail with
+ * PV_RECORDER_STATUS_INVALID_STATE. The worker is joined by pv_recorder_stop. A callback of NULL restores pull mode.
+ *
+ * @param object PV_Recorder object.
+ * @param callback Frame callback, or NULL.
+ * @param user_data Pointer passed to every invocation of the callback.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, or PV_RECORDER_STATUS_INVALID_STATE if the
+ * recorder is started.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_frame_callback(
+        pv_recorder_t *object,
+        pv_recorder_frame_callback_t callback,
+        void *user_data);
+
+/**
+ * Sends the overflow, silence and timeout warnings enabled in the config to param ${callback} rather than stdout.
+ * The callback runs on whichever thread raised the warning, often the capture worker, so it shouldn't block either.
+ *
+ * @param object PV_Recorder object.
+ * @param callback Log callback, or NULL to print to stdout again.
+ * @param user_data Pointer passed to every invocation of the callback.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, or PV_RECORDER_STATUS_INVALID_STATE if the
+ * recorder is started.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_log_callback(
+        pv_recorder_t *object,
+        pv_recorder_log_callback_t callback,
+        void *user_data);
+
+/**
+ * Publishes every frame on a frame bus: a ring of frames in POSIX shared memory named param ${name}, which other
+ * processes read with pv_recorder_bus_reader_init, so one device serves them all. Like a frame callback it puts the
+ * recorder in push mode, and the two can be combined: the worker publishes each frame, then passes it to the
+ * callback. The bus is created here and removed by pv_recorder_set_publisher with a NULL name or by
+ * pv_recorder_delete. A bus left under the same name is closed and replaced. Not available on Windows.
+ *
+ * @param object PV_Recorder object.
+ * @param name Name of the bus, e.g. "pvrecorder", or NULL to stop publishing.
+ * @param slot_count Frames the ring holds; a reader further behind than this loses frames.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_OUT_OF_MEMORY,
+ * PV_RECORDER_STATUS_BACKEND_ERROR if the shared memory can't be set up, or PV_RECORDER_STATUS_INVALID_STATE if the
+ * recorder is started.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_publisher(pv_recorder_t *object, const char *name, int32_t slot_count);
+
+/**
+ * Forward declaration of the reading end of a frame bus published by pv_recorder_set_publisher, in this process or any
+ * other. Readers don't open the device and don't slow the publisher or each other down.
+ */
+typedef struct pv_recorder_bus_reader pv_recorder_bus_reader_t;
+
+/**
+ * Constructor. Attaches to the bus param ${name}; the first frame read is the next one published.
+ *
+ * @param name Name of the bus, as given to pv_recorder_set_publisher.
+ * @param[out] object Bus reader object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_OUT_OF_MEMORY,
+ * PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED if no bus by that name is published, or PV_RECORDER_STATUS_BACKEND_ERROR.
+ */
+PV_API pv_recorder_status_t pv_recorder_bus_reader_init(const char *name, pv_recorder_bus_reader_t **object);
+
+/**
+ * Destructor.
+ *
+ * @param object Bus reader object.
+ */
+PV_API void pv_recorder_bus_reader_delete(pv_recorder_bus_reader_t *object);
+
+/**
+ * Getter for the length of the frames on the bus.
+ *
+ * @param object Bus reader object.
+ * @return Samples per frame.
+ */
+PV_API int32_t pv_recorder_bus_reader_get_frame_length(const pv_recorder_bus_reader_t *object);
+
+/**
+ * Getter for how many frames the reader has missed because it fell a whole ring behind the publisher.
+ *
+ * @param object Bus reader object.
+ * @return Frames lost since the reader was created.
+ */
+PV_API int64_t pv_recorder_bus_reader_get_lost_frames(const pv_recorder_bus_reader_t *object);
+
+/**
+ * Reads the next frame off the bus, waiting up to param ${timeout_msec} for it to be published.
+ *
+ * @param object Bus reader object.
+ * @param pcm[out] An array of `frame_length` samples for the frame to be copied to.
+ * @param info[out] Metadata the publisher read the frame with; may be NULL.
+ * @param timeout_msec Timeout in milliseconds. Must be positive.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_IO_ERROR on timeout, or
+ * PV_RECORDER_STATUS_INVALID_STATE once the publisher has closed the bus and every frame on it has been read.
+ */
+PV_API pv_recorder_status_t pv_recorder_bus_reader_read(
+        pv_recorder_bus_reader_t *object,
+        int16_t *pcm,
+        pv_recorder_frame_info_t *info,
+        int32_t timeout_msec);
+
+/**
+ * Forward declaration of another reader of the recorder's audio, added by pv_recorder_add_reader. Each reader has its
+ * own position in the recorder's ring buffer and its own frame length, so consumers wanting different frames share one
+ * device and one copy of the audio. Every reader gets every sample, unless the overflow policy drops it.
+ */
+typedef struct pv_recorder_reader pv_recorder_reader_t;
+
+/**
+ * Adds a reader of param ${frame_length} samples per frame. Its first frame starts with the first sample captured
+ * after pv_recorder_start. Readers count towards the overflow policy from then on, so one that is never read holds
+ * the others up unless the policy is PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST. pv_recorder_read and its variants stay
+ * a reader of their own, which only counts once it has read a frame or, in push mode, from the start.
+ *
+ * @param object PV_Recorder object.
+ * @param frame_length Samples per frame, at most the samples in `buffer_size_msec`.
+ * @param[out] reader Reader object, owned by the recorder.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_OUT_OF_MEMORY, or
+ * PV_RECORDER_STATUS_INVALID_STATE if the recorder is started or already has PV_RECORDER_MAX_READERS readers.
+ */
+PV_API pv_recorder_status_t pv_recorder_add_reader(
+        pv_recorder_t *object,
+        int32_t frame_length,
+        pv_recorder_reader_t **reader);
+
+/**
+ * Removes and frees a reader added by pv_recorder_add_reader. Readers left are freed by pv_recorder_delete.
+ *
+ * @param object PV_Recorder object.
+ * @param reader Reader object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, or PV_RECORDER_STATUS_INVALID_STATE if the
+ * recorder is started.
+ */
+PV_API pv_recorder_status_t pv_recorder_remove_reader(pv_recorder_t *object, pv_recorder_reader_t *reader);
+
+/**
+ * Getter for the length of the reader's frames.
+ *
+ * @param reader Reader object.
+ * @return Samples per frame.
+ */
+PV_API int32_t pv_recorder_reader_get_frame_length(const pv_recorder_reader_t *reader);
+
+/**
+ * Reads the reader's next frame, waiting for it as pv_recorder_read does. A reader may be read on a thread of its own,
+ * but only from one thread at a time.
+ *
+ * @param reader Reader object.
+ * @param pcm[out] An array of `frame_length` samples for the frame to be copied to.
+ * @param info[out] Frame metadata as from pv_recorder_read_ex; may be NULL.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_INVALID_STATE or PV_RECORDER_IO_ERROR
+ * on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_reader_read(
+        pv_recorder_reader_t *reader,
+        int16_t *pcm,
+        pv_recorder_frame_info_t *info);
+
+/**
+ * Sets how long pv_recorder_read waits for a full frame before failing with PV_RECORDER_STATUS_IO_ERROR. The default
+ * is 1000 milliseconds.
+ *
+ * @param object PV_Recorder object.
+ * @param timeout_msec Timeout in milliseconds. Must be positive.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_read_timeout(pv_recorder_t *object, int32_t timeout_msec);
+
+/**
+ * Has the recorder signal a file descriptor, an eventfd or the write end of a non-blocking pipe, whenever the frames
+ * waiting for pv_recorder_read_available reach param ${batch_frames}, so an event loop can wait on it alongside its
+ * other descriptors. It is signaled from the thread that captures the audio, by writing an 8-byte count of 1, at most
+ * once between two reads; a read that leaves a batch behind signals it again straight away. Stopping the recorder
+ * signals it too. Only for reading with pv_recorder_read, pv_recorder_read_frames and pv_recorder_read_available, not
+ * with a frame callback or a frame bus. The caller keeps the descriptor open until the recorder is deleted or it is
+ * set to -1.
+ *
+ * @param object PV_Recorder object.
+ * @param fd File descriptor, or -1 to stop signaling.
+ * @param batch_frames Frames in a batch, between 1 and what the ring holds for a reader.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure, and
+ * PV_RECORDER_STATUS_BACKEND_ERROR on Windows, which has no such descriptors.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_ready_fd(pv_recorder_t *object, int fd, int32_t batch_frames);
+
 /**
  * Getter to get the current selected audio device name.
  *
@@ -104,11 +658,22 @@ PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *pcm
  */
 PV_API const char *pv_recorder_get_selected_device(pv_recorder_t *object);
 
+/**
+ * Whether a PV_RECORDER_BACKEND_FILE recorder has delivered all of its file. Always false for the other backends.
+ *
+ * @param object PV_Recorder object.
+ * @return True at the end of the file.
+ */
+PV_API bool pv_recorder_is_at_end(pv_recorder_t *object);
+
 /**
  * Gets the input audio devices currently available. Each device name has a separate pointer, so the
  * caller must free each item in the output array individually and free the output array itself.
  * The utility function pv_recorder_free_device_list is provided to free the device list.
  *
+ * Devices are enumerated on one audio context kept for the life of the process. On Linux the list is cached and only
+ * enumerated again after a device is plugged in or out, so calling this often is cheap.
+ *
  * @param[out] count The number of audio devices.
  * @param[out] devices The output array containing the list of audio devices.
  * @return Status Code. Returns PV_RECORDER_STATUS_OUT_OF_MEMORY, PV_RECORDER_STATUS_BACKEND_ERROR or
@@ -0,0 +1,75 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_SAMPLE_FORMAT_H
+#define PV_SAMPLE_FORMAT_H
+
+#include <stdint.h>
+
+/**
+ * State of a one-pole DC blocker, `y[n] = x[n] - x[n-1] + pole * y[n-1]`, in units of 16-bit samples. Blocks of 4
+ * samples are worked out at once from the block's differences and the output before it, so the filter runs on NEON or
+ * SSE2 where available despite the feedback; the result matches the sample-by-sample filter to float rounding.
+ */
+typedef struct {
+    float pole;
+    float previous_input;
+    float previous_output;
+} pv_dc_blocker_t;
+
+/**
+ * Sets up a DC blocker with nothing before its first sample.
+ *
+ * @param sample_rate Sample rate of the audio in Hz.
+ * @param cutoff_hz Corner of the high-pass, well below the sample rate, e.g. 10 Hz.
+ * @param blocker[out] DC blocker.
+ */
+void pv_sample_format_init_dc_blocker(int32_t sample_rate, float cutoff_hz, pv_dc_blocker_t *blocker);
+
+/**
+ * Converts samples to float in [-1, 1), i.e. divided by 32768.
+ *
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param output[out] Float samples.
+ */
+void pv_sample_format_to_float(const int16_t *input, int32_t length, float *output);
+
+/**
+ * Removes the DC from samples and converts them to float in [-1, 1) in the same pass.
+ *
+ * @param blocker DC blocker, carried on from the previous call.
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param output[out] Float samples. Their magnitude can go just past 1 where the input jumps from one full scale to
+ * the other.
+ */
+void pv_sample_format_to_float_dc_blocked(
+        pv_dc_blocker_t *blocker,
+        const int16_t *input,
+        int32_t length,
+        float *output);
+
+/**
+ * Removes the DC from samples, rounded and saturated back to 16 bits.
+ *
+ * @param blocker DC blocker, carried on from the previous call.
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param output[out] Samples without DC. May be the same as `input`.
+ */
+void pv_sample_format_to_int16_dc_blocked(
+        pv_dc_blocker_t *blocker,
+        const int16_t *input,
+        int32_t length,
+        int16_t *output);
+
+#endif // PV_SAMPLE_FORMAT_H
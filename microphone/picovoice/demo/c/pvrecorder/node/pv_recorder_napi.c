@@ -1,4 +1,6 @@
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 #include <node_api.h>
 
 #include "pv_recorder.h"
@@ -298,6 +300,743 @@ napi_value napi_pv_recorder_read(napi_env env, napi_callback_info info) {
     return result;
 }
 
+// One `read_async` or `bus_reader_read_async` call in flight. `frame` is referenced until the promise settles so the
+// caller's Int16Array, usually one of a pool it allocated up front, can't be collected while the worker thread writes
+// into it.
+typedef struct {
+    napi_async_work work;
+    napi_deferred deferred;
+    napi_ref frame;
+    pv_recorder_t *object;
+    // reads the bus instead of the recorder if set
+    pv_recorder_bus_reader_t *reader;
+    int32_t timeout_msec;
+    int16_t *pcm;
+    pv_recorder_status_t status;
+} read_async_context_t;
+
+static void read_async_execute(napi_env env, void *data) {
+    (void)(env);
+
+    read_async_context_t *context = (read_async_context_t *) data;
+    if (context->reader) {
+        context->status = pv_recorder_bus_reader_read(context->reader, context->pcm, NULL, context->timeout_msec);
+    } else {
+        context->status = pv_recorder_read(context->object, context->pcm);
+    }
+}
+
+static void read_async_complete(napi_env env, napi_status work_status, void *data) {
+    read_async_context_t *context = (read_async_context_t *) data;
+
+    napi_value result = NULL;
+    if (work_status != napi_ok) {
+        context->status = PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+    if (napi_create_int32(env, context->status, &result) == napi_ok) {
+        napi_resolve_deferred(env, context->deferred, result);
+    } else {
+        napi_value message = NULL;
+        napi_create_string_utf8(env, "Unable to allocate memory for the read result", NAPI_AUTO_LENGTH, &message);
+        napi_value error = NULL;
+        napi_create_error(env, NULL, message, &error);
+        napi_reject_deferred(env, context->deferred, error);
+    }
+
+    napi_delete_reference(env, context->frame);
+    napi_delete_async_work(env, context->work);
+    free(context);
+}
+
+// Checks `value` is a frame `read_async` can fill and returns its samples, or throws and returns NULL.
+static int16_t *get_async_frame(napi_env env, napi_value value, size_t *length) {
+    napi_typedarray_type arr_type = -1;
+    void *data = NULL;
+    napi_value arr_value = NULL;
+    size_t offset = 0;
+    napi_status status = napi_get_typedarray_info(env, value, &arr_type, length, &data, &arr_value, &offset);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the input frame");
+        return NULL;
+    }
+    if (arr_type != napi_int16_array) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid type of input pcm buffer. The input frame has to be 'Int16Array'");
+        return NULL;
+    }
+    if (*length == 0) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid frame length");
+        return NULL;
+    }
+    if (offset != 0) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid shape of input frame");
+        return NULL;
+    }
+
+    return (int16_t *) data;
+}
+
+// Queues `context` on a libuv worker and returns the promise it settles. Takes ownership of `context`.
+static napi_value queue_read_async(napi_env env, napi_value frame, read_async_context_t *context) {
+    const char *ERROR_MSG = "Unable to allocate memory for the asynchronous read";
+
+    napi_value promise = NULL;
+    napi_status status = napi_create_promise(env, &context->deferred, &promise);
+    if (status != napi_ok) {
+        free(context);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    napi_value resource_name = NULL;
+    status = napi_create_string_utf8(env, "PvRecorderRead", NAPI_AUTO_LENGTH, &resource_name);
+    if (status == napi_ok) {
+        status = napi_create_reference(env, frame, 1, &context->frame);
+    }
+    if (status == napi_ok) {
+        status = napi_create_async_work(
+                env,
+                NULL,
+                resource_name,
+                read_async_execute,
+                read_async_complete,
+                context,
+                &context->work);
+    }
+    if (status == napi_ok) {
+        status = napi_queue_async_work(env, context->work);
+    }
+    if (status != napi_ok) {
+        if (context->work) {
+            napi_delete_async_work(env, context->work);
+        }
+        if (context->frame) {
+            napi_delete_reference(env, context->frame);
+        }
+        napi_value message = NULL;
+        napi_create_string_utf8(env, ERROR_MSG, NAPI_AUTO_LENGTH, &message);
+        napi_value error = NULL;
+        napi_create_error(env, NULL, message, &error);
+        napi_reject_deferred(env, context->deferred, error);
+        free(context);
+    }
+
+    return promise;
+}
+
+// Same arguments as `read`, but pv_recorder_read runs on a libuv worker thread and the returned promise resolves with
+// its status once the frame is filled, so the event loop keeps running while the recorder waits for audio. Only one
+// read may be in flight per recorder, and the recorder must not be deleted until it has settled.
+napi_value napi_pv_recorder_read_async(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorder properly");
+        return NULL;
+    }
+
+    size_t length = 0;
+    int16_t *pcm = get_async_frame(env, args[1], &length);
+    if (!pcm) {
+        return NULL;
+    }
+
+    read_async_context_t *context = calloc(1, sizeof(read_async_context_t));
+    if (!context) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_OUT_OF_MEMORY),
+                "Unable to allocate memory for the asynchronous read");
+        return NULL;
+    }
+    context->object = (pv_recorder_t *)(uintptr_t) object_id;
+    context->pcm = pcm;
+
+    return queue_read_async(env, args[1], context);
+}
+
+// A `subscribe` call. The recorder's push mode worker copies each frame into the next slot of `samples`, a ring of
+// `batch_count` batches of `frames_per_batch` frames that lives in an ArrayBuffer shared with JS, and hands a full
+// slot to the main thread through `callback`. The worker only ever writes a slot JS has finished with; when all of
+// them are still queued it drops frames rather than overwrite one, and counts them.
+typedef struct {
+    pv_recorder_t *object;
+    napi_threadsafe_function callback;
+    napi_ref ring;
+    int16_t *samples;
+    int32_t frame_length;
+    int32_t frames_per_batch;
+    int32_t batch_count;
+    int32_t frame_in_batch;
+    // batches handed to JS and batches JS has returned from; the worker writes the first, the main thread the second
+    int64_t produced;
+    int64_t consumed;
+    int64_t dropped_frames;
+} subscription_t;
+
+static void subscription_on_frame(const int16_t *pcm, void *user_data) {
+    subscription_t *subscription = (subscription_t *) user_data;
+
+    const int64_t produced = subscription->produced;
+    if (subscription->frame_in_batch == 0 &&
+            produced - __atomic_load_n(&subscription->consumed, __ATOMIC_ACQUIRE) >= subscription->batch_count) {
+        __atomic_store_n(&subscription->dropped_frames, subscription->dropped_frames + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    const int32_t slot = (int32_t) (produced % subscription->batch_count);
+    const size_t frame_offset = (size_t) slot * subscription->frames_per_batch + subscription->frame_in_batch;
+    memcpy(
+            &subscription->samples[frame_offset * subscription->frame_length],
+            pcm,
+            (size_t) subscription->frame_length * sizeof(int16_t));
+
+    if (++subscription->frame_in_batch == subscription->frames_per_batch) {
+        subscription->frame_in_batch = 0;
+        subscription->produced = produced + 1;
+        // never blocks: at most batch_count slots are out at once and the queue holds that many
+        napi_call_threadsafe_function(subscription->callback, (void *)(intptr_t) slot, napi_tsfn_nonblocking);
+    }
+}
+
+static void subscription_call_js(napi_env env, napi_value js_callback, void *context, void *data) {
+    subscription_t *subscription = (subscription_t *) context;
+
+    if (env && js_callback) {
+        napi_value args[2] = {NULL, NULL};
+        napi_value undefined = NULL;
+        napi_get_undefined(env, &undefined);
+        napi_create_int32(env, (int32_t)(intptr_t) data, &args[0]);
+        napi_create_int64(env, __atomic_load_n(&subscription->dropped_frames, __ATOMIC_RELAXED), &args[1]);
+        napi_call_function(env, undefined, js_callback, 2, args, NULL);
+    }
+
+    // the slot is the worker's again once the callback returns
+    __atomic_store_n(&subscription->consumed, subscription->consumed + 1, __ATOMIC_RELEASE);
+}
+
+static void subscription_finalize(napi_env env, void *data, void *hint) {
+    (void)(hint);
+
+    subscription_t *subscription = (subscription_t *) data;
+    napi_delete_reference(env, subscription->ring);
+    free(subscription);
+}
+
+// subscribe(handle, frame_length, frames_per_batch, batch_count, callback) puts a stopped recorder in push mode and
+// returns {subscription, buffer}. After `start`, callback(slot, dropped_frames) runs on the main thread once per
+// `frames_per_batch` frames; the batch is the `slot`-th run of frames_per_batch * frame_length samples in `buffer`,
+// and is only valid until the callback returns. `dropped_frames` is the running count of frames lost because JS fell
+// `batch_count` batches behind.
+napi_value napi_pv_recorder_subscribe(napi_env env, napi_callback_info info) {
+    size_t argc = 5;
+    napi_value args[5];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorder properly");
+        return NULL;
+    }
+
+    int32_t frame_length;
+    status = napi_get_value_int32(env, args[1], &frame_length);
+    if ((status != napi_ok) || (frame_length <= 0)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid frame length");
+        return NULL;
+    }
+
+    int32_t frames_per_batch;
+    status = napi_get_value_int32(env, args[2], &frames_per_batch);
+    if ((status != napi_ok) || (frames_per_batch <= 0)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid number of frames per batch");
+        return NULL;
+    }
+
+    int32_t batch_count;
+    status = napi_get_value_int32(env, args[3], &batch_count);
+    if ((status != napi_ok) || (batch_count <= 0)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid number of batches");
+        return NULL;
+    }
+
+    napi_valuetype callback_type = napi_undefined;
+    status = napi_typeof(env, args[4], &callback_type);
+    if ((status != napi_ok) || (callback_type != napi_function)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid callback. The callback has to be a function");
+        return NULL;
+    }
+
+    const char *ERROR_MSG = "Unable to allocate memory for the subscription";
+
+    subscription_t *subscription = calloc(1, sizeof(subscription_t));
+    if (!subscription) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_OUT_OF_MEMORY),
+                ERROR_MSG);
+        return NULL;
+    }
+    subscription->object = (pv_recorder_t *)(uintptr_t) object_id;
+    subscription->frame_length = frame_length;
+    subscription->frames_per_batch = frames_per_batch;
+    subscription->batch_count = batch_count;
+
+    napi_value buffer_js = NULL;
+    void *samples = NULL;
+    const size_t buffer_size = (size_t) batch_count * frames_per_batch * frame_length * sizeof(int16_t);
+    status = napi_create_arraybuffer(env, buffer_size, &samples, &buffer_js);
+    if (status == napi_ok) {
+        subscription->samples = (int16_t *) samples;
+        status = napi_create_reference(env, buffer_js, 1, &subscription->ring);
+    }
+    if (status != napi_ok) {
+        free(subscription);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_OUT_OF_MEMORY),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    napi_value resource_name = NULL;
+    status = napi_create_string_utf8(env, "PvRecorderSubscription", NAPI_AUTO_LENGTH, &resource_name);
+    if (status == napi_ok) {
+        status = napi_create_threadsafe_function(
+                env,
+                args[4],
+                NULL,
+                resource_name,
+                (size_t) batch_count,
+                1,
+                subscription,
+                subscription_finalize,
+                subscription,
+                subscription_call_js,
+                &subscription->callback);
+    }
+    if (status != napi_ok) {
+        napi_delete_reference(env, subscription->ring);
+        free(subscription);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    pv_recorder_status_t pv_recorder_status = pv_recorder_set_frame_callback(
+            subscription->object,
+            subscription_on_frame,
+            subscription);
+    if (pv_recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        // the finalizer frees the subscription
+        napi_release_threadsafe_function(subscription->callback, napi_tsfn_abort);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(pv_recorder_status),
+                "Unable to subscribe. The recorder has to be stopped");
+        return NULL;
+    }
+
+    napi_value object_js = NULL;
+    napi_value subscription_js = NULL;
+    status = napi_create_object(env, &object_js);
+    if (status == napi_ok) {
+        status = napi_create_bigint_uint64(env, ((uint64_t)(uintptr_t) subscription), &subscription_js);
+    }
+    if (status == napi_ok) {
+        status = napi_set_named_property(env, object_js, "subscription", subscription_js);
+    }
+    if (status == napi_ok) {
+        status = napi_set_named_property(env, object_js, "buffer", buffer_js);
+    }
+    if (status != napi_ok) {
+        // nothing has been recorded yet, so the finalizer frees the subscription as above
+        pv_recorder_set_frame_callback(subscription->object, NULL, NULL);
+        napi_release_threadsafe_function(subscription->callback, napi_tsfn_abort);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    return object_js;
+}
+
+// unsubscribe(subscription) returns the recorder to pull mode. The recorder has to be stopped first; batches already
+// queued are still delivered, and the subscription is freed after the last one.
+napi_value napi_pv_recorder_unsubscribe(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t subscription_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &subscription_id, &lossless);
+    if ((status != napi_ok) || !lossless || (subscription_id == 0)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the subscription properly");
+        return NULL;
+    }
+
+    subscription_t *subscription = (subscription_t *)(uintptr_t) subscription_id;
+    pv_recorder_status_t pv_recorder_status = pv_recorder_set_frame_callback(subscription->object, NULL, NULL);
+    if (pv_recorder_status == PV_RECORDER_STATUS_SUCCESS) {
+        napi_release_threadsafe_function(subscription->callback, napi_tsfn_release);
+    }
+
+    napi_value result;
+    status = napi_create_int32(env, pv_recorder_status, &result);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to allocate memory for the unsubscribe result");
+        return NULL;
+    }
+
+    return result;
+}
+
+// set_publisher(handle, name, slot_count) publishes every frame on the frame bus `name`, or stops publishing if name
+// is null. Returns the status.
+napi_value napi_pv_recorder_set_publisher(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorder properly");
+        return NULL;
+    }
+
+    napi_valuetype name_type = napi_undefined;
+    status = napi_typeof(env, args[1], &name_type);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the bus name");
+        return NULL;
+    }
+
+    char name[256] = {0};
+    const bool is_publishing = (name_type != napi_null) && (name_type != napi_undefined);
+    if (is_publishing) {
+        size_t name_length = 0;
+        status = napi_get_value_string_utf8(env, args[1], name, sizeof(name), &name_length);
+        if ((status != napi_ok) || (name_length == 0) || (name_length >= sizeof(name) - 1)) {
+            napi_throw_error(
+                    env,
+                    pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                    "Invalid bus name");
+            return NULL;
+        }
+    }
+
+    int32_t slot_count;
+    status = napi_get_value_int32(env, args[2], &slot_count);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the slot count");
+        return NULL;
+    }
+
+    pv_recorder_status_t pv_recorder_status = pv_recorder_set_publisher(
+            (pv_recorder_t *)(uintptr_t) object_id,
+            is_publishing ? name : NULL,
+            slot_count);
+
+    napi_value result;
+    status = napi_create_int32(env, pv_recorder_status, &result);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to allocate memory for the publisher result");
+        return NULL;
+    }
+
+    return result;
+}
+
+// bus_reader_init(name) attaches to a frame bus and returns {handle, status, frame_length}, like `init`.
+napi_value napi_pv_recorder_bus_reader_init(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    char name[256] = {0};
+    size_t name_length = 0;
+    status = napi_get_value_string_utf8(env, args[0], name, sizeof(name), &name_length);
+    if ((status != napi_ok) || (name_length == 0) || (name_length >= sizeof(name) - 1)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid bus name");
+        return NULL;
+    }
+
+    pv_recorder_bus_reader_t *handle = NULL;
+    pv_recorder_status_t pv_recorder_status = pv_recorder_bus_reader_init(name, &handle);
+    if (pv_recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        handle = NULL;
+    }
+
+    napi_value object_js = NULL;
+    napi_value handle_js = NULL;
+    napi_value status_js = NULL;
+    napi_value frame_length_js = NULL;
+    const char *ERROR_MSG = "Unable to allocate memory for the constructed instance of PvRecorderBusReader";
+
+    status = napi_create_object(env, &object_js);
+    if (status == napi_ok) {
+        status = napi_create_bigint_uint64(env, ((uint64_t)(uintptr_t) handle), &handle_js);
+    }
+    if (status == napi_ok) {
+        status = napi_set_named_property(env, object_js, "handle", handle_js);
+    }
+    if (status == napi_ok) {
+        status = napi_create_int32(env, pv_recorder_status, &status_js);
+    }
+    if (status == napi_ok) {
+        status = napi_set_named_property(env, object_js, "status", status_js);
+    }
+    if (status == napi_ok) {
+        status = napi_create_int32(env, pv_recorder_bus_reader_get_frame_length(handle), &frame_length_js);
+    }
+    if (status == napi_ok) {
+        status = napi_set_named_property(env, object_js, "frame_length", frame_length_js);
+    }
+    if (status != napi_ok) {
+        pv_recorder_bus_reader_delete(handle);
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    return object_js;
+}
+
+napi_value napi_pv_recorder_bus_reader_delete(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorderBusReader properly");
+        return NULL;
+    }
+
+    pv_recorder_bus_reader_delete((pv_recorder_bus_reader_t *)(uintptr_t) object_id);
+    return NULL;
+}
+
+napi_value napi_pv_recorder_bus_reader_get_lost_frames(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorderBusReader properly");
+        return NULL;
+    }
+
+    napi_value result;
+    status = napi_create_int64(
+            env,
+            pv_recorder_bus_reader_get_lost_frames((pv_recorder_bus_reader_t *)(uintptr_t) object_id),
+            &result);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to allocate memory for the lost frames result");
+        return NULL;
+    }
+
+    return result;
+}
+
+// bus_reader_read_async(handle, frame, timeout_msec) is `read_async` for a bus reader: the promise resolves with the
+// status of pv_recorder_bus_reader_read. Only one read may be in flight per reader.
+napi_value napi_pv_recorder_bus_reader_read_async(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorderBusReader properly");
+        return NULL;
+    }
+
+    pv_recorder_bus_reader_t *reader = (pv_recorder_bus_reader_t *)(uintptr_t) object_id;
+
+    size_t length = 0;
+    int16_t *pcm = get_async_frame(env, args[1], &length);
+    if (!pcm) {
+        return NULL;
+    }
+    if (length < (size_t) pv_recorder_bus_reader_get_frame_length(reader)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid frame length");
+        return NULL;
+    }
+
+    int32_t timeout_msec;
+    status = napi_get_value_int32(env, args[2], &timeout_msec);
+    if ((status != napi_ok) || (timeout_msec <= 0)) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid timeout");
+        return NULL;
+    }
+
+    read_async_context_t *context = calloc(1, sizeof(read_async_context_t));
+    if (!context) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_OUT_OF_MEMORY),
+                "Unable to allocate memory for the asynchronous read");
+        return NULL;
+    }
+    context->reader = reader;
+    context->timeout_msec = timeout_msec;
+    context->pcm = pcm;
+
+    return queue_read_async(env, args[1], context);
+}
+
 napi_value napi_pv_recorder_get_selected_device(napi_env env, napi_callback_info info) {
     size_t argc = 1;
     napi_value args[1];
@@ -427,6 +1166,38 @@ napi_value Init(napi_env env, napi_value exports) {
     status = napi_define_properties(env, exports, 1, &desc);
     assert(status == napi_ok);
 
+    desc = DECLARE_NAPI_METHOD("read_async", napi_pv_recorder_read_async);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("subscribe", napi_pv_recorder_subscribe);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("unsubscribe", napi_pv_recorder_unsubscribe);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("set_publisher", napi_pv_recorder_set_publisher);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("bus_reader_init", napi_pv_recorder_bus_reader_init);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("bus_reader_delete", napi_pv_recorder_bus_reader_delete);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("bus_reader_get_lost_frames", napi_pv_recorder_bus_reader_get_lost_frames);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("bus_reader_read_async", napi_pv_recorder_bus_reader_read_async);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
     desc = DECLARE_NAPI_METHOD("get_selected_device", napi_pv_recorder_get_selected_device);
     status = napi_define_properties(env, exports, 1, &desc);
     assert(status == napi_ok);
@@ -70,22 +70,22 @@ class PvRecorder {
     }
 
     /**
-     * Asynchronous call to read pcm frames.
+     * Asynchronous call to read pcm frames. The recorder waits for audio on a worker thread, so the event loop keeps
+     * running meanwhile. Only one read may be pending at a time.
      *
+     * @param pcm Optional Int16Array of `frameLength` samples to fill, e.g. one of a pool allocated up front.
+     * A new one is allocated if it's not given.
      * @returns {Promise<Int16Array>} Pcm frames.
      */
-    async read() {
-        const that = this;
-        return new Promise(function (resolve, reject) {
-            setTimeout(function () {
-                let pcm = new Int16Array(that.frameLength);
-                const status = pvRecorder.read(that.handle, pcm);
-                if (status !== PvRecorderStatus.SUCCESS) {
-                    reject(PvRecorderStatusToException(status, "PvRecorder failed to read pcm frames."));
-                }
-                resolve(pcm);
-            })
-        });
+    async read(pcm = new Int16Array(this.frameLength)) {
+        if (!(pcm instanceof Int16Array) || pcm.length !== this.frameLength) {
+            throw new RangeError(`The pcm buffer has to be an Int16Array of ${this.frameLength} samples.`);
+        }
+        const status = await pvRecorder.read_async(this.handle, pcm);
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorder failed to read pcm frames.");
+        }
+        return pcm;
     }
 
     /**
@@ -102,6 +102,73 @@ class PvRecorder {
         return pcm;
     }
 
+    /**
+     * Delivers audio in batches instead of per read call. Has to be called before `start`. Once started, the recorder
+     * captures on its own thread and calls `callback(batch, droppedFrames)` on the main thread every `framesPerBatch`
+     * frames. `batch` is an Int16Array of `framesPerBatch * frameLength` samples into a ring of `batchCount` batches
+     * shared with the native side, so it is only valid until the callback returns; copy what has to outlive it.
+     * `droppedFrames` counts the frames lost so far because the callbacks fell the whole ring behind. Reads fail
+     * while subscribed.
+     *
+     * @param framesPerBatch Frames per callback.
+     * @param batchCount Batches the ring holds.
+     * @param callback Function receiving each batch.
+     */
+    subscribe(framesPerBatch, batchCount, callback) {
+        if (this.subscription !== undefined) {
+            throw new Error("PvRecorder is already subscribed.");
+        }
+        const batchSamples = framesPerBatch * this.frameLength;
+        let views = [];
+        const subscriptionAndBuffer = pvRecorder.subscribe(this.handle, this.frameLength, framesPerBatch, batchCount,
+            function (slot, droppedFrames) {
+                callback(views[slot], droppedFrames);
+            });
+        for (let slot = 0; slot < batchCount; slot++) {
+            views.push(new Int16Array(subscriptionAndBuffer.buffer, slot * batchSamples * 2, batchSamples));
+        }
+        this.subscription = subscriptionAndBuffer.subscription;
+    }
+
+    /**
+     * Returns the recorder to per-call reads. Has to be called after `stop`.
+     */
+    unsubscribe() {
+        if (this.subscription === undefined) {
+            return;
+        }
+        const status = pvRecorder.unsubscribe(this.subscription);
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorder failed to unsubscribe.");
+        }
+        this.subscription = undefined;
+    }
+
+    /**
+     * Publishes every frame on a frame bus in shared memory, which other processes read with PvRecorderBusReader
+     * without opening the device. Has to be called before `start`; puts the recorder in push mode, so reads fail while
+     * publishing, but it can be combined with `subscribe`. Not available on Windows.
+     *
+     * @param name Name of the bus.
+     * @param slotCount Frames the bus holds; a reader further behind loses frames.
+     */
+    publish(name, slotCount = 64) {
+        const status = pvRecorder.set_publisher(this.handle, name, slotCount);
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorder failed to publish.");
+        }
+    }
+
+    /**
+     * Stops publishing and removes the bus. Has to be called after `stop`.
+     */
+    unpublish() {
+        const status = pvRecorder.set_publisher(this.handle, null, 0);
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorder failed to unpublish.");
+        }
+    }
+
     /**
      * Returns the name of the selected device used to capture audio.
      *
@@ -119,6 +186,11 @@ class PvRecorder {
      * Destructor. Releases any resources used by PvRecorder.
      */
     release() {
+        if (this.subscription !== undefined) {
+            // the subscription's thread-safe function would otherwise keep the event loop alive
+            pvRecorder.stop(this.handle);
+            this.unsubscribe();
+        }
         pvRecorder.delete(this.handle);
     }
 
@@ -136,6 +208,62 @@ class PvRecorder {
     }
 }
 
+/**
+ * Reads the frames a PvRecorder in another process, or this one, publishes with `publish`.
+ */
+class PvRecorderBusReader {
+
+    /**
+     * PvRecorderBusReader constructor. The first frame read is the next one published.
+     *
+     * @param name Name of the bus.
+     */
+    constructor(name) {
+        const readerHandleAndStatus = pvRecorder.bus_reader_init(name);
+        const status = readerHandleAndStatus.status;
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorderBusReader failed to initialize.");
+        }
+        this.handle = readerHandleAndStatus.handle;
+        this.frameLength = readerHandleAndStatus.frame_length;
+    }
+
+    /**
+     * Asynchronous call to read the next frame off the bus, waiting on a worker thread. Only one read may be pending
+     * at a time.
+     *
+     * @param pcm Optional Int16Array of `frameLength` samples to fill. A new one is allocated if it's not given.
+     * @param timeoutMSec Time in milliseconds to wait for the frame.
+     * @returns {Promise<Int16Array>} Pcm frames.
+     */
+    async read(pcm = new Int16Array(this.frameLength), timeoutMSec = 1000) {
+        if (!(pcm instanceof Int16Array) || pcm.length !== this.frameLength) {
+            throw new RangeError(`The pcm buffer has to be an Int16Array of ${this.frameLength} samples.`);
+        }
+        const status = await pvRecorder.bus_reader_read_async(this.handle, pcm, timeoutMSec);
+        if (status !== PvRecorderStatus.SUCCESS) {
+            throw PvRecorderStatusToException(status, "PvRecorderBusReader failed to read pcm frames.");
+        }
+        return pcm;
+    }
+
+    /**
+     * Frames missed because the reader fell more than the bus holds behind the publisher.
+     *
+     * @returns {number} Lost frames.
+     */
+    getLostFrames() {
+        return pvRecorder.bus_reader_get_lost_frames(this.handle);
+    }
+
+    /**
+     * Destructor. Releases any resources used by PvRecorderBusReader.
+     */
+    release() {
+        pvRecorder.bus_reader_delete(this.handle);
+    }
+}
+
 function getLibraryPath() {
     let scriptPath;
     if (os.platform() === "win32") {
@@ -151,3 +279,4 @@ function getLibraryPath() {
 }
 
 module.exports = PvRecorder;
+module.exports.PvRecorderBusReader = PvRecorderBusReader;
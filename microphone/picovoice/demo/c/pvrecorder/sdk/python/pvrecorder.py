@@ -8,6 +8,9 @@
 # an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
 # specific language governing permissions and limitations under the License.
 #
+import array
+import asyncio
+import collections
 import os
 import platform
 import subprocess
@@ -75,6 +78,9 @@ class PvRecorder(object):
 
         self._handle = POINTER(self.CPvRecorder)()
         self._frame_length = frame_length
+        self._pcm = (c_int16 * frame_length)()
+        self._array = None
+        self._is_started = False
 
         status = init_func(device_index, frame_length, buffer_size_msec, log_overflow, log_silence, byref(self._handle))
         if status is not self.PvRecorderStatuses.SUCCESS:
@@ -96,6 +102,18 @@ class PvRecorder(object):
         self._read_func.argtypes = [POINTER(self.CPvRecorder), POINTER(c_int16)]
         self._read_func.restype = self.PvRecorderStatuses
 
+        self._read_frames_func = self._LIBRARY.pv_recorder_read_frames
+        self._read_frames_func.argtypes = [POINTER(self.CPvRecorder), POINTER(c_int16), c_int32]
+        self._read_frames_func.restype = self.PvRecorderStatuses
+
+        self._read_available_func = self._LIBRARY.pv_recorder_read_available
+        self._read_available_func.argtypes = [POINTER(self.CPvRecorder), POINTER(c_int16), c_int32, POINTER(c_int32)]
+        self._read_available_func.restype = self.PvRecorderStatuses
+
+        self._set_publisher_func = self._LIBRARY.pv_recorder_set_publisher
+        self._set_publisher_func.argtypes = [POINTER(self.CPvRecorder), c_char_p, c_int32]
+        self._set_publisher_func.restype = self.PvRecorderStatuses
+
         self._get_selected_device_func = self._LIBRARY.pv_recorder_get_selected_device
         self._get_selected_device_func.argtypes = [POINTER(self.CPvRecorder)]
         self._get_selected_device_func.restype = c_char_p
@@ -115,10 +133,13 @@ class PvRecorder(object):
         status = self._start_func(self._handle)
         if status is not self.PvRecorderStatuses.SUCCESS:
             raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to start device.")
+        self._is_started = True
 
     def stop(self):
         """Stops recording audio."""
 
+        # before the native stop, so a frames() loop on another thread sees its read fail as the end
+        self._is_started = False
         status = self._stop_func(self._handle)
         if status is not self.PvRecorderStatuses.SUCCESS:
             raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to stop device.")
@@ -126,11 +147,108 @@ class PvRecorder(object):
     def read(self):
         """Reads audio frames and returns a list containing the audio frames."""
 
-        pcm = (c_int16 * self._frame_length)()
+        status = self._read_func(self._handle, self._pcm)
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
+        return self._pcm[0:self._frame_length]
+
+    def read_into(self, buffer):
+        """
+        Reads audio frames straight into a caller-supplied buffer, without allocating anything.
+
+        :param buffer: Writable, contiguous object supporting the buffer protocol with room for `frame_length` 16-bit
+        samples, e.g. a NumPy int16 array, an `array.array('h')` or a bytearray of `2 * frame_length` bytes.
+        :return: The buffer.
+        """
+
+        pcm = self._pcm_from_buffer(buffer, self._frame_length)
         status = self._read_func(self._handle, pcm)
+        del pcm
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
+        return buffer
+
+    def read_array(self):
+        """
+        Reads audio frames into a NumPy int16 array that is reused by every call, so it is only valid until the next
+        one; copy it to keep it. Needs NumPy, which is otherwise not a dependency.
+
+        :return: NumPy array of `frame_length` samples.
+        """
+
+        if self._array is None:
+            import numpy
+            self._array = numpy.empty(self._frame_length, dtype=numpy.int16)
+        return self.read_into(self._array)
+
+    def frames(self, batch=1, buffer=None):
+        """
+        Generator over batches of `batch` frames, each read in a single native call. Like every call into the
+        library, the wait for audio happens with the GIL released, so other Python threads run meanwhile. The loop
+        ends when another thread calls `stop`; a batch cut short by it is dropped.
+
+        :param batch: Frames per batch.
+        :param buffer: Optional writable, contiguous buffer of `batch * frame_length` 16-bit samples to fill, e.g. a
+        NumPy int16 array. An `array.array('h')` is used if it's not given.
+        :return: The buffer, refilled on every iteration, so it is only valid until the next one.
+        """
+
+        if batch < 1:
+            raise ValueError("The batch has to hold at least one frame.")
+        samples = batch * self._frame_length
+        if buffer is None:
+            buffer = array.array('h', bytes(samples * sizeof(c_int16)))
+
+        pcm = self._pcm_from_buffer(buffer, samples)
+
+        while True:
+            status = self._read_frames_func(self._handle, pcm, batch)
+            if status is self.PvRecorderStatuses.INVALID_STATE and not self._is_started:
+                return
+            if status is not self.PvRecorderStatuses.SUCCESS:
+                raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
+            yield buffer
+
+    def read_available(self, buffer, max_frames):
+        """
+        Waits for a frame, then reads it and every whole frame already buffered after it, up to `max_frames`, in a
+        single native call. Catches up on a backlog without a call per frame.
+
+        :param buffer: Writable, contiguous buffer with room for `max_frames * frame_length` 16-bit samples.
+        :param max_frames: Most frames to read.
+        :return: Number of frames read into the start of the buffer, at least one.
+        """
+
+        if max_frames < 1:
+            raise ValueError("At least one frame has to be read.")
+        pcm = self._pcm_from_buffer(buffer, max_frames * self._frame_length)
+        frames_read = c_int32()
+        status = self._read_available_func(self._handle, pcm, max_frames, byref(frames_read))
+        del pcm
         if status is not self.PvRecorderStatuses.SUCCESS:
             raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
-        return pcm[0:self._frame_length]
+        return frames_read.value
+
+    def publish(self, name, slot_count=64):
+        """
+        Publishes every frame on a frame bus in shared memory, which other processes read with PvRecorderBusReader
+        without opening the device. Has to be called before `start`; reads fail while publishing. Not available on
+        Windows.
+
+        :param name: Name of the bus.
+        :param slot_count: Frames the bus holds; a reader further behind loses frames.
+        """
+
+        status = self._set_publisher_func(self._handle, name.encode('utf-8'), slot_count)
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to publish.")
+
+    def unpublish(self):
+        """Stops publishing and removes the bus. Has to be called after `stop`."""
+
+        status = self._set_publisher_func(self._handle, None, 0)
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to unpublish.")
 
     @property
     def selected_device(self):
@@ -176,6 +294,19 @@ class PvRecorder(object):
 
         return device_list
 
+    @staticmethod
+    def _pcm_from_buffer(buffer, samples):
+        """A helper function to view a caller's buffer as a ctypes array of `samples` 16-bit samples."""
+
+        with memoryview(buffer) as view:
+            if view.readonly or not view.c_contiguous:
+                raise ValueError("The buffer has to be writable and contiguous.")
+            if view.format not in ('h', '<h', '=h', 'B', 'b', 'c'):
+                raise ValueError("The buffer has to hold 16-bit samples or bytes.")
+            if view.nbytes < samples * sizeof(c_int16):
+                raise ValueError("The buffer has to hold at least %d samples." % samples)
+            return (c_int16 * samples).from_buffer(view.cast('B'))
+
     @staticmethod
     def _lib_path():
         """A helper function to get the library path."""
@@ -200,4 +331,223 @@ class PvRecorder(object):
 
         return os.path.join(os.path.dirname(__file__), "lib", os_name, cpu, "libpv_recorder.%s" % extension)
 
+    # cdll rather than pydll: ctypes releases the GIL for the duration of every call, reads included
     _LIBRARY = cdll.LoadLibrary(_lib_path.__func__())
+
+
+class AsyncPvRecorder(PvRecorder):
+    """
+    A PvRecorder read from an asyncio event loop with `async for frame in recorder`. The thread capturing the audio
+    signals an eventfd, or a pipe where there is none, once a batch of frames is waiting, and the loop reads the whole
+    batch in one call when it sees the descriptor ready: no thread of its own and no polling. Not available on Windows.
+    """
+
+    def __init__(
+            self,
+            device_index,
+            frame_length,
+            buffer_size_msec=1000,
+            log_overflow=True,
+            log_silence=True,
+            batch_frames=4):
+        """
+        Constructor
+
+        :param device_index: The device index of the audio device to use. A (-1) will choose default audio device.
+        :param frame_length: The length of the frame to receive at each iteration.
+        :param buffer_size_msec: Time in milliseconds indicating the total amount of time to store audio frames.
+        :param log_overflow: Boolean variable to indicate to log overflow warnings.
+        :param log_silence: Boolean variable to enable silence logs.
+        :param batch_frames: Frames waiting before the loop is woken. More frames mean fewer wakeups and more latency.
+        """
+
+        super().__init__(device_index, frame_length, buffer_size_msec, log_overflow, log_silence)
+
+        self._set_ready_fd_func = self._LIBRARY.pv_recorder_set_ready_fd
+        self._set_ready_fd_func.argtypes = [POINTER(self.CPvRecorder), c_int, c_int32]
+        self._set_ready_fd_func.restype = self.PvRecorderStatuses
+
+        if hasattr(os, 'eventfd'):
+            self._read_fd = os.eventfd(0, os.EFD_NONBLOCK | os.EFD_CLOEXEC)
+            self._write_fd = self._read_fd
+        else:
+            self._read_fd, self._write_fd = os.pipe()
+            os.set_blocking(self._read_fd, False)
+            os.set_blocking(self._write_fd, False)
+
+        status = self._set_ready_fd_func(self._handle, self._write_fd, batch_frames)
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            self._close_fds()
+            super().delete()
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to set the ready descriptor.")
+
+        # whatever has piled up since the last batch is read too, up to the whole buffer
+        self._max_frames = max(batch_frames, (buffer_size_msec * 16) // frame_length)
+        self._batch = array.array('h', bytes(self._max_frames * frame_length * sizeof(c_int16)))
+        self._pending = collections.deque()
+        self._loop = None
+        self._ready = None
+
+    def delete(self):
+        """Releases any resources used by PV_Recorder, and the descriptor. Call it on the loop's thread."""
+
+        self._detach()
+        super().delete()
+        self._close_fds()
+
+    def start(self):
+        """Starts recording audio."""
+
+        # a wakeup left from the last stop
+        self._drain()
+        self._pending.clear()
+        super().start()
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        """
+        The next frame, as a list of `frame_length` samples like `read` returns. Iteration ends once `stop` is called,
+        from the loop or another thread, after the frames already read.
+        """
+
+        while not self._pending:
+            if not self._is_started:
+                self._detach()
+                raise StopAsyncIteration
+            if self._loop is None:
+                self._loop = asyncio.get_event_loop()
+                self._ready = asyncio.Event()
+                self._loop.add_reader(self._read_fd, self._on_ready)
+            await self._ready.wait()
+            self._ready.clear()
+            if not self._is_started:
+                continue
+
+            # the batch is waiting, so this returns without blocking the loop
+            frames = self.read_available(self._batch, self._max_frames)
+            for i in range(frames):
+                self._pending.append(self._batch[i * self._frame_length:(i + 1) * self._frame_length].tolist())
+
+        return self._pending.popleft()
+
+    def _on_ready(self):
+        self._drain()
+        self._ready.set()
+
+    def _drain(self):
+        """A helper function to empty the descriptor: one read resets an eventfd, a pipe may take a few."""
+
+        try:
+            while os.read(self._read_fd, 4096):
+                pass
+        except BlockingIOError:
+            pass
+
+    def _detach(self):
+        if self._loop is not None:
+            self._loop.remove_reader(self._read_fd)
+            self._loop = None
+            self._ready = None
+
+    def _close_fds(self):
+        os.close(self._read_fd)
+        if self._write_fd != self._read_fd:
+            os.close(self._write_fd)
+
+
+class PvRecorderBusReader(object):
+    """
+    Reads the frames a PvRecorder in another process, or this one, publishes with `publish`. Reads wait with the GIL
+    released.
+    """
+
+    class CPvRecorderBusReader(Structure):
+        pass
+
+    def __init__(self, name):
+        """
+        Constructor. The first frame read is the next one published.
+
+        :param name: Name of the bus.
+        """
+
+        library = PvRecorder._LIBRARY
+        statuses = PvRecorder.PvRecorderStatuses
+
+        init_func = library.pv_recorder_bus_reader_init
+        init_func.argtypes = [c_char_p, POINTER(POINTER(self.CPvRecorderBusReader))]
+        init_func.restype = statuses
+
+        self._handle = POINTER(self.CPvRecorderBusReader)()
+        status = init_func(name.encode('utf-8'), byref(self._handle))
+        if status is not statuses.SUCCESS:
+            raise PvRecorder._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to initialize the bus reader.")
+
+        self._delete_func = library.pv_recorder_bus_reader_delete
+        self._delete_func.argtypes = [POINTER(self.CPvRecorderBusReader)]
+        self._delete_func.restype = None
+
+        get_frame_length_func = library.pv_recorder_bus_reader_get_frame_length
+        get_frame_length_func.argtypes = [POINTER(self.CPvRecorderBusReader)]
+        get_frame_length_func.restype = c_int32
+        self._frame_length = get_frame_length_func(self._handle)
+
+        self._get_lost_frames_func = library.pv_recorder_bus_reader_get_lost_frames
+        self._get_lost_frames_func.argtypes = [POINTER(self.CPvRecorderBusReader)]
+        self._get_lost_frames_func.restype = c_int64
+
+        self._read_func = library.pv_recorder_bus_reader_read
+        self._read_func.argtypes = [POINTER(self.CPvRecorderBusReader), POINTER(c_int16), c_void_p, c_int32]
+        self._read_func.restype = statuses
+
+        self._pcm = (c_int16 * self._frame_length)()
+
+    def delete(self):
+        """Releases any resources used by the bus reader."""
+
+        self._delete_func(self._handle)
+
+    def read(self, timeout_msec=1000):
+        """
+        Reads the next frame off the bus.
+
+        :param timeout_msec: Time in milliseconds to wait for the frame. An IOError is raised when it passes, and a
+        ValueError once the publisher has removed the bus.
+        :return: A list of `frame_length` samples.
+        """
+
+        self._read(self._pcm, timeout_msec)
+        return self._pcm[0:self._frame_length]
+
+    def read_into(self, buffer, timeout_msec=1000):
+        """
+        Reads the next frame off the bus straight into a caller-supplied buffer, as PvRecorder.read_into does.
+
+        :param buffer: Writable, contiguous buffer with room for `frame_length` 16-bit samples.
+        :param timeout_msec: Time in milliseconds to wait for the frame.
+        :return: The buffer.
+        """
+
+        pcm = PvRecorder._pcm_from_buffer(buffer, self._frame_length)
+        self._read(pcm, timeout_msec)
+        del pcm
+        return buffer
+
+    def _read(self, pcm, timeout_msec):
+        status = self._read_func(self._handle, pcm, None, timeout_msec)
+        if status is not PvRecorder.PvRecorderStatuses.SUCCESS:
+            raise PvRecorder._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from the bus.")
+
+    @property
+    def frame_length(self):
+        """Gets the length of the frames on the bus."""
+
+        return self._frame_length
+
+    @property
+    def lost_frames(self):
+        """Gets how many frames were missed because the reader fell more than the bus holds behind."""
+
+        return self._get_lost_frames_func(self._handle)
@@ -0,0 +1,174 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <string.h>
+
+#include "pv_adpcm.h"
+
+#define HEADER_LENGTH (4)
+#define MAX_STEP_INDEX (88)
+
+static const int16_t STEP_TABLE[MAX_STEP_INDEX + 1] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+        5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+        27086, 29794, 32767};
+
+static const int8_t INDEX_TABLE[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static inline int32_t clamp(int32_t x, int32_t min, int32_t max) {
+    return (x < min) ? min : ((x > max) ? max : x);
+}
+
+// One sample, with the decoder's arithmetic, so the predictor never drifts from what a decoder reconstructs. Each
+// sample depends on the one before through the predictor and step index, so there are no lanes to fill; the three
+// magnitude bits are masks rather than branches, which a mispredicted branch on every bit of noisy audio would cost
+// more than the arithmetic.
+static inline uint8_t encode_sample(int32_t sample, int32_t *predictor, int32_t *step_index) {
+    int32_t step = STEP_TABLE[*step_index];
+    int32_t difference = sample - *predictor;
+    const int32_t negative = -(int32_t) (difference < 0);
+    difference = (difference ^ negative) - negative;
+
+    int32_t nibble = 8 & negative;
+    int32_t delta = step >> 3;
+    for (int32_t bit = 4; bit > 0; bit >>= 1) {
+        const int32_t mask = -(int32_t) (difference >= step);
+        nibble |= bit & mask;
+        difference -= step & mask;
+        delta += step & mask;
+        step >>= 1;
+    }
+
+    *predictor = clamp(*predictor + ((delta ^ negative) - negative), INT16_MIN, INT16_MAX);
+    *step_index = clamp(*step_index + INDEX_TABLE[nibble], 0, MAX_STEP_INDEX);
+    return (uint8_t) nibble;
+}
+
+static inline int16_t decode_sample(uint8_t nibble, int32_t *predictor, int32_t *step_index) {
+    const int32_t step = STEP_TABLE[*step_index];
+    int32_t delta = step >> 3;
+    if (nibble & 4) {
+        delta += step;
+    }
+    if (nibble & 2) {
+        delta += step >> 1;
+    }
+    if (nibble & 1) {
+        delta += step >> 2;
+    }
+    *predictor = clamp(*predictor + ((nibble & 8) ? -delta : delta), INT16_MIN, INT16_MAX);
+    *step_index = clamp(*step_index + INDEX_TABLE[nibble], 0, MAX_STEP_INDEX);
+    return (int16_t) *predictor;
+}
+
+static void put_le16(uint8_t *bytes, uint32_t value) {
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+}
+
+static void put_le32(uint8_t *bytes, uint32_t value) {
+    put_le16(bytes, value);
+    put_le16(bytes + 2, value >> 16);
+}
+
+int32_t pv_adpcm_samples_per_block(int32_t block_align) {
+    return ((block_align - HEADER_LENGTH) * 2) + 1;
+}
+
+int32_t pv_adpcm_block_length(int32_t length) {
+    return HEADER_LENGTH + ((((length - 1) + 7) / 8) * 4);
+}
+
+void pv_adpcm_encoder_init(pv_adpcm_encoder_t *encoder) {
+    if (encoder) {
+        encoder->step_index = 0;
+    }
+}
+
+pv_recorder_status_t pv_adpcm_encode_block(
+        pv_adpcm_encoder_t *encoder,
+        const int16_t *pcm,
+        int32_t length,
+        uint8_t *block) {
+    if (!encoder || !pcm || (length <= 0) || !block) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    int32_t predictor = pcm[0];
+    int32_t step_index = clamp(encoder->step_index, 0, MAX_STEP_INDEX);
+    put_le16(block, (uint16_t) pcm[0]);
+    block[2] = (uint8_t) step_index;
+    block[3] = 0;
+
+    uint8_t *out = block + HEADER_LENGTH;
+    int32_t i = 1;
+    for (; (i + 2) <= length; i += 2) {
+        const uint8_t low = encode_sample(pcm[i], &predictor, &step_index);
+        const uint8_t high = encode_sample(pcm[i + 1], &predictor, &step_index);
+        *out++ = (uint8_t) (low | (high << 4));
+    }
+    // a short last block is filled out with its last sample, so what a decoder makes of the padding stays near it
+    const uint8_t *end = block + pv_adpcm_block_length(length);
+    for (; out < end; i += 2) {
+        const uint8_t low = encode_sample(pcm[(i < length) ? i : (length - 1)], &predictor, &step_index);
+        const uint8_t high = encode_sample(pcm[length - 1], &predictor, &step_index);
+        *out++ = (uint8_t) (low | (high << 4));
+    }
+
+    encoder->step_index = step_index;
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_adpcm_decode_block(const uint8_t *block, int32_t block_length, int16_t *pcm) {
+    if (!block || (block_length < HEADER_LENGTH) || !pcm || (block[2] > MAX_STEP_INDEX)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    int32_t predictor = (int16_t) (block[0] | (block[1] << 8));
+    int32_t step_index = block[2];
+    *pcm++ = (int16_t) predictor;
+    for (int32_t i = HEADER_LENGTH; i < block_length; i++) {
+        *pcm++ = decode_sample(block[i] & 0x0f, &predictor, &step_index);
+        *pcm++ = decode_sample(block[i] >> 4, &predictor, &step_index);
+    }
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+void pv_adpcm_wav_header(
+        int32_t sample_rate,
+        int32_t block_align,
+        uint32_t samples,
+        uint32_t data_length,
+        uint8_t *header) {
+    const int32_t samples_per_block = pv_adpcm_samples_per_block(block_align);
+
+    memcpy(header, "RIFF", 4);
+    put_le32(header + 4, (PV_ADPCM_WAV_HEADER_LENGTH - 8) + data_length);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put_le32(header + 16, 20);
+    // IMA-ADPCM, mono
+    put_le16(header + 20, 0x11);
+    put_le16(header + 22, 1);
+    put_le32(header + 24, (uint32_t) sample_rate);
+    put_le32(header + 28, (uint32_t) (((int64_t) sample_rate * block_align) / samples_per_block));
+    put_le16(header + 32, (uint32_t) block_align);
+    put_le16(header + 34, 4);
+    // the extra format bytes: just the samples per block
+    put_le16(header + 36, 2);
+    put_le16(header + 38, (uint32_t) samples_per_block);
+    memcpy(header + 40, "fact", 4);
+    put_le32(header + 44, 4);
+    put_le32(header + 48, samples);
+    memcpy(header + 52, "data", 4);
+    put_le32(header + 56, data_length);
+}
@@ -0,0 +1,271 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_CHANNEL_REDUCER_NEON
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PV_CHANNEL_REDUCER_SSE2
+
+#endif
+
+#include "pv_channel_reducer.h"
+
+struct pv_channel_reducer {
+    int32_t channels;
+    pv_channel_reducer_mode_t mode;
+    int32_t selected_channel;
+    int32_t delays[PV_CHANNEL_REDUCER_MAX_CHANNELS];
+    int32_t max_delay;
+    int16_t *history;
+};
+
+pv_channel_reducer_status_t pv_channel_reducer_init(
+        int32_t channels,
+        pv_channel_reducer_mode_t mode,
+        int32_t selected_channel,
+        const int32_t *delays,
+        pv_channel_reducer_t **object) {
+    if ((channels < 1) || (channels > PV_CHANNEL_REDUCER_MAX_CHANNELS)) {
+        return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((mode != PV_CHANNEL_REDUCER_MODE_SELECT) &&
+        (mode != PV_CHANNEL_REDUCER_MODE_AVERAGE) &&
+        (mode != PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM)) {
+        return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((mode == PV_CHANNEL_REDUCER_MODE_SELECT) && ((selected_channel < 0) || (selected_channel >= channels))) {
+        return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((mode == PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM) && !delays) {
+        return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_channel_reducer_t *o = calloc(1, sizeof(pv_channel_reducer_t));
+    if (!o) {
+        return PV_CHANNEL_REDUCER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->channels = channels;
+    o->mode = mode;
+    o->selected_channel = selected_channel;
+
+    if (mode == PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM) {
+        for (int32_t c = 0; c < channels; c++) {
+            if ((delays[c] < 0) || (delays[c] > PV_CHANNEL_REDUCER_MAX_DELAY)) {
+                pv_channel_reducer_delete(o);
+                return PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT;
+            }
+            o->delays[c] = delays[c];
+            if (delays[c] > o->max_delay) {
+                o->max_delay = delays[c];
+            }
+        }
+
+        if (o->max_delay > 0) {
+            o->history = calloc(o->max_delay * channels, sizeof(int16_t));
+            if (!(o->history)) {
+                pv_channel_reducer_delete(o);
+                return PV_CHANNEL_REDUCER_STATUS_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    *object = o;
+
+    return PV_CHANNEL_REDUCER_STATUS_SUCCESS;
+}
+
+void pv_channel_reducer_delete(pv_channel_reducer_t *object) {
+    if (object) {
+        free(object->history);
+        free(object);
+    }
+}
+
+// Rounded mean. Power-of-two counts use a shift so the scalar tail matches the SIMD kernels bit for bit.
+static int16_t mean(int32_t sum, int32_t channels) {
+    switch (channels) {
+        case 1:
+            return (int16_t) sum;
+        case 2:
+            return (int16_t) ((sum + 1) >> 1);
+        case 4:
+            return (int16_t) ((sum + 2) >> 2);
+        case 8:
+            return (int16_t) ((sum + 4) >> 3);
+        default:
+            return (int16_t) ((sum >= 0) ? ((sum + (channels / 2)) / channels) : ((sum - (channels / 2)) / channels));
+    }
+}
+
+static void select_channel(const pv_channel_reducer_t *object, const int16_t *input, int32_t frame_count, int16_t *output) {
+    const int32_t channels = object->channels;
+    const int16_t *source = input + object->selected_channel;
+    for (int32_t i = 0; i < frame_count; i++) {
+        output[i] = source[i * channels];
+    }
+}
+
+static int32_t average_stereo(const int16_t *input, int32_t frame_count, int16_t *output) {
+    int32_t i = 0;
+#if defined(PV_CHANNEL_REDUCER_NEON)
+    if (pv_neon_is_available()) {
+        i = pv_neon_average_stereo(input, frame_count, output);
+    }
+#elif defined(PV_CHANNEL_REDUCER_SSE2)
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i rounding = _mm_set1_epi32(1);
+    for (; (i + 8) <= frame_count; i += 8) {
+        // madd against ones sums each left/right pair into one 32-bit lane
+        const __m128i a = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (input + (2 * i))), ones);
+        const __m128i b = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (input + (2 * i) + 8)), ones);
+        const __m128i mean_a = _mm_srai_epi32(_mm_add_epi32(a, rounding), 1);
+        const __m128i mean_b = _mm_srai_epi32(_mm_add_epi32(b, rounding), 1);
+        _mm_storeu_si128((__m128i *) (output + i), _mm_packs_epi32(mean_a, mean_b));
+    }
+#else
+    (void) input;
+    (void) output;
+    (void) frame_count;
+#endif
+    return i;
+}
+
+static int32_t average_quad(const int16_t *input, int32_t frame_count, int16_t *output) {
+    int32_t i = 0;
+#if defined(PV_CHANNEL_REDUCER_NEON)
+    if (pv_neon_is_available()) {
+        i = pv_neon_average_quad(input, frame_count, output);
+    }
+#elif defined(PV_CHANNEL_REDUCER_SSE2)
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i rounding = _mm_set1_epi32(2);
+    for (; (i + 4) <= frame_count; i += 4) {
+        // pairwise sums of frames 0-1 and 2-3, then the even/odd lanes are the two halves of each frame
+        const __m128i a = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (input + (4 * i))), ones);
+        const __m128i b = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (input + (4 * i) + 8)), ones);
+        const __m128 a_ps = _mm_castsi128_ps(a);
+        const __m128 b_ps = _mm_castsi128_ps(b);
+        const __m128i even = _mm_castps_si128(_mm_shuffle_ps(a_ps, b_ps, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(a_ps, b_ps, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m128i sum = _mm_add_epi32(_mm_add_epi32(even, odd), rounding);
+        const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(sum, 2), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i *) (output + i), packed);
+    }
+#else
+    (void) input;
+    (void) output;
+    (void) frame_count;
+#endif
+    return i;
+}
+
+static void average_channels(const pv_channel_reducer_t *object, const int16_t *input, int32_t frame_count, int16_t *output) {
+    const int32_t channels = object->channels;
+
+    int32_t i = 0;
+    if (channels == 2) {
+        i = average_stereo(input, frame_count, output);
+    } else if (channels == 4) {
+        i = average_quad(input, frame_count, output);
+    }
+
+    for (; i < frame_count; i++) {
+        const int16_t *frame = input + (i * channels);
+        int32_t sum = 0;
+        for (int32_t c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        output[i] = mean(sum, channels);
+    }
+}
+
+static void delay_and_sum(pv_channel_reducer_t *object, const int16_t *input, int32_t frame_count, int16_t *output) {
+    const int32_t channels = object->channels;
+    const int32_t max_delay = object->max_delay;
+
+    // frames that reach back before this call read from the delay line holding the last `max_delay` frames
+    const int32_t boundary = (frame_count < max_delay) ? frame_count : max_delay;
+    for (int32_t i = 0; i < boundary; i++) {
+        int32_t sum = 0;
+        for (int32_t c = 0; c < channels; c++) {
+            const int32_t source = i - object->delays[c];
+            sum += (source >= 0) ?
+                   input[(source * channels) + c] :
+                   object->history[((max_delay + source) * channels) + c];
+        }
+        output[i] = mean(sum, channels);
+    }
+    for (int32_t i = boundary; i < frame_count; i++) {
+        int32_t sum = 0;
+        for (int32_t c = 0; c < channels; c++) {
+            sum += input[((i - object->delays[c]) * channels) + c];
+        }
+        output[i] = mean(sum, channels);
+    }
+
+    if (max_delay == 0) {
+        return;
+    }
+    if (frame_count >= max_delay) {
+        memcpy(
+                object->history,
+                input + ((frame_count - max_delay) * channels),
+                max_delay * channels * sizeof(int16_t));
+    } else {
+        const int32_t kept = max_delay - frame_count;
+        memmove(object->history, object->history + (frame_count * channels), kept * channels * sizeof(int16_t));
+        memcpy(object->history + (kept * channels), input, frame_count * channels * sizeof(int16_t));
+    }
+}
+
+void pv_channel_reducer_process(
+        pv_channel_reducer_t *object,
+        const int16_t *input,
+        int32_t frame_count,
+        int16_t *output) {
+    if (!object || !input || !output || (frame_count <= 0)) {
+        return;
+    }
+
+    switch (object->mode) {
+        case PV_CHANNEL_REDUCER_MODE_SELECT:
+            select_channel(object, input, frame_count, output);
+            break;
+        case PV_CHANNEL_REDUCER_MODE_AVERAGE:
+            average_channels(object, input, frame_count, output);
+            break;
+        case PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM:
+            delay_and_sum(object, input, frame_count, output);
+            break;
+    }
+}
+
+void pv_channel_reducer_reset(pv_channel_reducer_t *object) {
+    if (object && object->history) {
+        memset(object->history, 0, object->max_delay * object->channels * sizeof(int16_t));
+    }
+}
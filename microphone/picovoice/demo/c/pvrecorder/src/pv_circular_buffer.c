@@ -12,7 +12,20 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
 #include "pv_circular_buffer.h"
+#include "pv_recorder_probe.h"
+
+#if defined(__linux__) && defined(__NR_memfd_create)
+#define PV_CIRCULAR_BUFFER_MIRRORING_SUPPORTED
+#endif
 
 struct pv_circular_buffer {
     void *buffer;
@@ -21,11 +34,29 @@ struct pv_circular_buffer {
     int32_t element_size;
     int32_t read_index;
     int32_t write_index;
+    pv_circular_buffer_overflow_policy_t overflow_policy;
+    bool is_spsc;
+    bool is_mirrored;
+    uint32_t mask;
+    uint32_t read_position;
+    uint32_t write_position;
+    uint64_t overflow_count;
 };
 
+static uint32_t next_power_of_two(uint32_t x) {
+    x--;
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+    return x + 1;
+}
+
 pv_circular_buffer_status_t pv_circular_buffer_init(
         int32_t capacity,
         int32_t element_size,
+        pv_circular_buffer_overflow_policy_t overflow_policy,
         pv_circular_buffer_t **object) {
     if (capacity <= 0) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
@@ -33,6 +64,11 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
     if (element_size <= 0) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
+    if ((overflow_policy != PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST) &&
+        (overflow_policy != PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST) &&
+        (overflow_policy != PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
     if (!object) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
@@ -52,19 +88,211 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
 
     o->capacity = capacity;
     o->element_size = element_size;
+    o->overflow_policy = overflow_policy;
 
     *object = o;
 
     return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
 }
 
+pv_circular_buffer_status_t pv_circular_buffer_init_spsc(
+        int32_t capacity,
+        int32_t element_size,
+        pv_circular_buffer_t **object) {
+    if ((capacity <= 0) || (capacity > (INT32_MAX / 2) + 1)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const int32_t spsc_capacity = (int32_t) next_power_of_two((uint32_t) capacity);
+
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(
+            spsc_capacity,
+            element_size,
+            PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST,
+            object);
+    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    (*object)->is_spsc = true;
+    (*object)->mask = (uint32_t) spsc_capacity - 1;
+
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+}
+
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING_SUPPORTED)
+
+// Maps the same `size` bytes twice back to back so that any access of up to `size` bytes is contiguous.
+static void *map_mirrored(size_t size) {
+    const int fd = (int) syscall(__NR_memfd_create, "pv_circular_buffer", 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    char *base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    void *lower = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void *upper = mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+
+    if ((lower != base) || (upper != (base + size))) {
+        munmap(base, 2 * size);
+        return NULL;
+    }
+
+    return base;
+}
+
+#endif
+
+pv_circular_buffer_status_t pv_circular_buffer_init_mirrored(
+        int32_t capacity,
+        int32_t element_size,
+        pv_circular_buffer_t **object) {
+    if ((capacity <= 0) || (capacity > (INT32_MAX / 4) + 1)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((element_size <= 0) || ((element_size & (element_size - 1)) != 0)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING_SUPPORTED)
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if ((page_size <= 0) || ((page_size & (page_size - 1)) != 0) || (page_size < element_size)) {
+        return PV_CIRCULAR_BUFFER_STATUS_NOT_SUPPORTED;
+    }
+
+    // both are powers of two, so a capacity of at least one page is also a whole number of pages
+    const int32_t page_elements = (int32_t) (page_size / element_size);
+    const int32_t mirrored_capacity = (int32_t) next_power_of_two(
+            (uint32_t) ((capacity < page_elements) ? page_elements : capacity));
+    if (mirrored_capacity > (INT32_MAX / 2 / element_size)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_circular_buffer_t *o = calloc(1, sizeof(pv_circular_buffer_t));
+    if (!o) {
+        return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->buffer = map_mirrored((size_t) mirrored_capacity * element_size);
+    if (!(o->buffer)) {
+        free(o);
+        return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->capacity = mirrored_capacity;
+    o->element_size = element_size;
+    o->overflow_policy = PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST;
+    o->is_spsc = true;
+    o->is_mirrored = true;
+    o->mask = (uint32_t) mirrored_capacity - 1;
+
+    *object = o;
+
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+
+#else
+
+    return PV_CIRCULAR_BUFFER_STATUS_NOT_SUPPORTED;
+
+#endif
+}
+
 void pv_circular_buffer_delete(pv_circular_buffer_t *object) {
     if (object) {
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING_SUPPORTED)
+        if (object->is_mirrored) {
+            munmap(object->buffer, 2 * (size_t) object->capacity * object->element_size);
+            free(object);
+            return;
+        }
+#endif
         free(object->buffer);
         free(object);
     }
 }
 
+static void spsc_copy_out(const pv_circular_buffer_t *object, uint32_t position, void *buffer, int32_t length) {
+    const int32_t index = (int32_t) (position & object->mask);
+    if (object->is_mirrored) {
+        memcpy(buffer, (char *) object->buffer + (index * object->element_size), length * object->element_size);
+        return;
+    }
+
+    const int32_t first = ((object->capacity - index) < length) ? (object->capacity - index) : length;
+
+    memcpy(buffer, (char *) object->buffer + (index * object->element_size), first * object->element_size);
+    if (first < length) {
+        memcpy((char *) buffer + (first * object->element_size), object->buffer, (length - first) * object->element_size);
+    }
+}
+
+static void spsc_copy_in(pv_circular_buffer_t *object, uint32_t position, const void *buffer, int32_t length) {
+    const int32_t index = (int32_t) (position & object->mask);
+    if (object->is_mirrored) {
+        memcpy((char *) object->buffer + (index * object->element_size), buffer, length * object->element_size);
+        return;
+    }
+
+    const int32_t first = ((object->capacity - index) < length) ? (object->capacity - index) : length;
+
+    memcpy((char *) object->buffer + (index * object->element_size), buffer, first * object->element_size);
+    if (first < length) {
+        memcpy(object->buffer, (const char *) buffer + (first * object->element_size), (length - first) * object->element_size);
+    }
+}
+
+static int32_t spsc_read(pv_circular_buffer_t *object, void *buffer, int32_t length) {
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED);
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE);
+
+    const int32_t count = (int32_t) (write_position - read_position);
+    const int32_t to_copy = (count < length) ? count : length;
+
+    spsc_copy_out(object, read_position, buffer, to_copy);
+
+    __atomic_store_n(&object->read_position, read_position + (uint32_t) to_copy, __ATOMIC_RELEASE);
+    PV_RECORDER_PROBE3(ring_read, object, to_copy, count - to_copy);
+
+    return to_copy;
+}
+
+static pv_circular_buffer_status_t spsc_write(pv_circular_buffer_t *object, const void *buffer, int32_t length) {
+    const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_RELAXED);
+    const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_ACQUIRE);
+
+    const int32_t free_space = object->capacity - (int32_t) (write_position - read_position);
+    const int32_t to_copy = (free_space < length) ? free_space : length;
+
+    spsc_copy_in(object, write_position, buffer, to_copy);
+
+    __atomic_store_n(&object->write_position, write_position + (uint32_t) to_copy, __ATOMIC_RELEASE);
+    PV_RECORDER_PROBE3(ring_write, object, to_copy, object->capacity - free_space + to_copy);
+
+    if (to_copy < length) {
+        PV_RECORDER_PROBE2(ring_overflow, object, length - to_copy);
+        const uint64_t overflow_count = __atomic_load_n(&object->overflow_count, __ATOMIC_RELAXED);
+        __atomic_store_n(&object->overflow_count, overflow_count + (uint64_t) (length - to_copy), __ATOMIC_RELAXED);
+    }
+
+    return (to_copy < length) ? PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW : PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+}
+
 int32_t pv_circular_buffer_read(pv_circular_buffer_t *object, void *buffer, int32_t length) {
     if (!object) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
@@ -79,6 +307,10 @@ int32_t pv_circular_buffer_read(pv_circular_buffer_t *object, void *buffer, int3
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
 
+    if (object->is_spsc) {
+        return spsc_read(object, buffer, length);
+    }
+
     void *dst_ptr = buffer;
     const void *src_ptr = (char *) object->buffer + (object->read_index * object->element_size);
 
@@ -101,10 +333,70 @@ int32_t pv_circular_buffer_read(pv_circular_buffer_t *object, void *buffer, int3
     }
 
     object->count -= max_copy;
+    PV_RECORDER_PROBE3(ring_read, object, max_copy, object->count);
 
     return max_copy;
 }
 
+int32_t pv_circular_buffer_peek(
+        pv_circular_buffer_t *object,
+        int32_t length,
+        const void **first,
+        int32_t *first_length,
+        const void **second,
+        int32_t *second_length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!first || !first_length || !second || !second_length) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((length <= 0) || (length > object->capacity)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    int32_t index;
+    int32_t count;
+    if (object->is_spsc) {
+        const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED);
+        const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE);
+        index = (int32_t) (read_position & object->mask);
+        count = (int32_t) (write_position - read_position);
+    } else {
+        index = object->read_index;
+        count = object->count;
+    }
+
+    const int32_t total = (count < length) ? count : length;
+    const int32_t available = object->is_mirrored ? object->capacity : (object->capacity - index);
+
+    *first = (const char *) object->buffer + (index * object->element_size);
+    *first_length = (total < available) ? total : available;
+    *second_length = total - *first_length;
+    *second = (*second_length > 0) ? object->buffer : NULL;
+
+    return total;
+}
+
+pv_circular_buffer_status_t pv_circular_buffer_consume(pv_circular_buffer_t *object, int32_t length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((length <= 0) || (length > pv_circular_buffer_get_count(object))) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (object->is_spsc) {
+        const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_RELAXED);
+        __atomic_store_n(&object->read_position, read_position + (uint32_t) length, __ATOMIC_RELEASE);
+    } else {
+        object->read_index = (object->read_index + length) % object->capacity;
+        object->count -= length;
+    }
+
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+}
+
 pv_circular_buffer_status_t pv_circular_buffer_write(pv_circular_buffer_t *object, const void *buffer, int32_t length) {
     if (!object) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
@@ -116,8 +408,25 @@ pv_circular_buffer_status_t pv_circular_buffer_write(pv_circular_buffer_t *objec
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
 
+    if (object->is_spsc) {
+        return spsc_write(object, buffer, length);
+    }
+
     pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
 
+    const int32_t free_space = object->capacity - object->count;
+    if (length > free_space) {
+        if (object->overflow_policy == PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK) {
+            return PV_CIRCULAR_BUFFER_STATUS_WOULD_BLOCK;
+        }
+        status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+        object->overflow_count += (uint64_t) (length - free_space);
+        PV_RECORDER_PROBE2(ring_overflow, object, length - free_space);
+        if (object->overflow_policy == PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST) {
+            length = free_space;
+        }
+    }
+
     void *dst_ptr = (char *) object->buffer + (object->write_index * object->element_size);
     const void *src_ptr = buffer;
 
@@ -140,19 +449,40 @@ pv_circular_buffer_status_t pv_circular_buffer_write(pv_circular_buffer_t *objec
         object->count += remaining;
     }
 
-    if(object->count > object->capacity) {
-        status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+    if (object->count > object->capacity) {
+        // the oldest element still stored is the one the next write would overwrite
         object->count = object->capacity;
-        object->read_index = (object->write_index + 1) % object->capacity;
+        object->read_index = object->write_index;
     }
+    PV_RECORDER_PROBE3(ring_write, object, length, object->count);
 
     return status;
 }
 
+int32_t pv_circular_buffer_get_capacity(const pv_circular_buffer_t *object) {
+    return object->capacity;
+}
+
+int32_t pv_circular_buffer_get_count(const pv_circular_buffer_t *object) {
+    if (object->is_spsc) {
+        const uint32_t write_position = __atomic_load_n(&object->write_position, __ATOMIC_ACQUIRE);
+        const uint32_t read_position = __atomic_load_n(&object->read_position, __ATOMIC_ACQUIRE);
+        return (int32_t) (write_position - read_position);
+    }
+    return object->count;
+}
+
+uint64_t pv_circular_buffer_get_overflow_count(const pv_circular_buffer_t *object) {
+    return __atomic_load_n(&object->overflow_count, __ATOMIC_RELAXED);
+}
+
 void pv_circular_buffer_reset(pv_circular_buffer_t *object) {
     object->count = 0;
     object->read_index = 0;
     object->write_index = 0;
+    __atomic_store_n(&object->read_position, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->write_position, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->overflow_count, 0, __ATOMIC_RELAXED);
 }
 
 const char *pv_circular_buffer_status_to_string(pv_circular_buffer_status_t status) {
@@ -160,7 +490,9 @@ const char *pv_circular_buffer_status_to_string(pv_circular_buffer_status_t stat
             "SUCCESS",
             "OUT_OF_MEMORY",
             "INVALID_ARGUMENT",
-            "WRITE_OVERFLOW"};
+            "WRITE_OVERFLOW",
+            "NOT_SUPPORTED",
+            "WOULD_BLOCK"};
 
     int32_t size = sizeof(STRINGS) / sizeof(STRINGS[0]);
     if (status < PV_CIRCULAR_BUFFER_STATUS_SUCCESS || status >= (PV_CIRCULAR_BUFFER_STATUS_SUCCESS + size)) {
@@ -0,0 +1,208 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_DECIMATOR_NEON
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PV_DECIMATOR_SSE2
+
+#endif
+
+#include "pv_decimator.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// taps per polyphase branch; a multiple of 8 keeps every dot product a whole number of SIMD lanes
+static const int32_t TAPS_PER_PHASE = 16;
+// passband edge relative to the output Nyquist frequency
+static const double CUTOFF_RATIO = 0.9;
+// output samples computed per pass over the history buffer
+static const int32_t BLOCK_LENGTH = 256;
+
+typedef int32_t (*dot_product_t)(const int16_t *x, const int16_t *taps, int32_t length);
+
+struct pv_decimator {
+    dot_product_t dot_product;
+    int32_t factor;
+    int32_t num_taps;
+    int16_t *taps;
+    int16_t *history;
+    int32_t history_length;
+    int32_t history_capacity;
+};
+
+static void design_filter(pv_decimator_t *object) {
+    const int32_t num_taps = object->num_taps;
+    const double cutoff = (CUTOFF_RATIO * 0.5) / object->factor;
+    const double center = (num_taps - 1) / 2.0;
+
+    double *h = malloc(num_taps * sizeof(double));
+    double sum = 0.0;
+    for (int32_t i = 0; i < num_taps; i++) {
+        const double x = i - center;
+        const double sinc = (x == 0.0) ? (2.0 * cutoff) : (sin(2.0 * M_PI * cutoff * x) / (M_PI * x));
+        const double window = 0.42 - (0.5 * cos((2.0 * M_PI * i) / (num_taps - 1))) +
+                              (0.08 * cos((4.0 * M_PI * i) / (num_taps - 1)));
+        h[i] = sinc * window;
+        sum += h[i];
+    }
+
+    // coefficients are stored reversed so each output is a forward dot product over contiguous history
+    int32_t q15_sum = 0;
+    for (int32_t i = 0; i < num_taps; i++) {
+        const int16_t tap = (int16_t) lround((h[i] / sum) * 32768.0);
+        object->taps[num_taps - 1 - i] = tap;
+        q15_sum += tap;
+    }
+    // absorb the rounding error in the centre tap so DC passes through unchanged
+    object->taps[num_taps / 2] = (int16_t) (object->taps[num_taps / 2] + (32768 - q15_sum));
+
+    free(h);
+}
+
+static int32_t dot_product(const int16_t *x, const int16_t *taps, int32_t length) {
+#if defined(PV_DECIMATOR_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (int32_t i = 0; i < length; i += 8) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) (x + i));
+        const __m128i b = _mm_loadu_si128((const __m128i *) (taps + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    int32_t acc = 0;
+    for (int32_t i = 0; i < length; i++) {
+        acc += (int32_t) x[i] * (int32_t) taps[i];
+    }
+    return acc;
+#endif
+}
+
+pv_decimator_status_t pv_decimator_init(int32_t factor, pv_decimator_t **object) {
+    if ((factor != 2) && (factor != 3)) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_decimator_t *o = calloc(1, sizeof(pv_decimator_t));
+    if (!o) {
+        return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->dot_product = dot_product;
+#if defined(PV_DECIMATOR_NEON)
+    // checked once here rather than for every output sample
+    if (pv_neon_is_available()) {
+        o->dot_product = pv_neon_dot_product;
+    }
+#endif
+    o->factor = factor;
+    o->num_taps = TAPS_PER_PHASE * factor;
+    o->history_capacity = (o->num_taps - 1) + (factor * BLOCK_LENGTH);
+
+    o->taps = calloc(o->num_taps, sizeof(int16_t));
+    o->history = calloc(o->history_capacity, sizeof(int16_t));
+    if (!(o->taps) || !(o->history)) {
+        pv_decimator_delete(o);
+        return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+    }
+
+    design_filter(o);
+    pv_decimator_reset(o);
+
+    *object = o;
+
+    return PV_DECIMATOR_STATUS_SUCCESS;
+}
+
+void pv_decimator_delete(pv_decimator_t *object) {
+    if (object) {
+        free(object->taps);
+        free(object->history);
+        free(object);
+    }
+}
+
+static int16_t q15_to_sample(int32_t acc) {
+    const int32_t value = (acc + (1 << 14)) >> 15;
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t) value;
+}
+
+int32_t pv_decimator_process(pv_decimator_t *object, const int16_t *input, int32_t input_length, int16_t *output) {
+    if (!object || !input || !output || (input_length <= 0)) {
+        return 0;
+    }
+
+    int32_t processed = 0;
+    while (input_length > 0) {
+        int32_t length = object->history_capacity - object->history_length;
+        if (length > input_length) {
+            length = input_length;
+        }
+        memcpy(object->history + object->history_length, input, length * sizeof(int16_t));
+        object->history_length += length;
+        input += length;
+        input_length -= length;
+
+        // only every `factor`-th filter position is evaluated, which is the polyphase decomposition in direct form
+        int32_t position = 0;
+        while ((position + object->num_taps) <= object->history_length) {
+            const int32_t acc = object->dot_product(object->history + position, object->taps, object->num_taps);
+            output[processed++] = q15_to_sample(acc);
+            position += object->factor;
+        }
+
+        object->history_length -= position;
+        memmove(object->history, object->history + position, object->history_length * sizeof(int16_t));
+    }
+
+    return processed;
+}
+
+int32_t pv_decimator_get_max_output_length(const pv_decimator_t *object, int32_t input_length) {
+    if (!object || (input_length <= 0)) {
+        return 0;
+    }
+    return ((object->num_taps - 1) + input_length) / object->factor + 1;
+}
+
+void pv_decimator_reset(pv_decimator_t *object) {
+    if (object) {
+        // start from silence so every `factor` input samples produce exactly one output from the first call
+        memset(object->history, 0, object->history_capacity * sizeof(int16_t));
+        object->history_length = object->num_taps - 1;
+    }
+}
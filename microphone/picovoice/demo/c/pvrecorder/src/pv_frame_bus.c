@@ -0,0 +1,420 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// syscall
+#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#endif
+
+#if defined(__linux__)
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#endif
+
+#include "pv_frame_bus.h"
+
+#define PV_FRAME_BUS_MAGIC "PVFBUS2"
+#define PV_FRAME_BUS_MAX_NAME_LENGTH (255)
+#define PV_FRAME_BUS_ALIGNMENT (64)
+// marks a slot the writer is in the middle of
+#define PV_FRAME_BUS_WRITING (-1)
+
+typedef struct {
+    char magic[8];
+    int32_t frame_length;
+    int32_t slot_count;
+    int32_t slot_size;
+    uint32_t is_closed;
+    // bumped after every frame; the word readers sleep on
+    uint32_t futex;
+    uint32_t waiters;
+    // frames published, i.e. the bus sequence number of the next one
+    int64_t head;
+    uint8_t padding[24];
+} pv_frame_bus_header_t;
+
+typedef struct {
+    int64_t sequence;
+    int64_t timestamp_usec;
+    int64_t frame_sequence;
+    int64_t dropped_samples;
+    float rms;
+    int32_t peak;
+    int32_t clipped_samples;
+    int32_t padding;
+} pv_frame_bus_slot_t;
+
+struct pv_frame_bus {
+    void *base;
+    size_t size;
+    char name[PV_FRAME_BUS_MAX_NAME_LENGTH + 2];
+};
+
+struct pv_recorder_bus_reader {
+    void *base;
+    size_t size;
+    int64_t cursor;
+    int64_t lost_frames;
+};
+
+static int32_t pv_frame_bus_slot_size(int32_t frame_length) {
+    const int32_t size = (int32_t) (sizeof(pv_frame_bus_slot_t) + frame_length * sizeof(int16_t));
+    return ((size + PV_FRAME_BUS_ALIGNMENT - 1) / PV_FRAME_BUS_ALIGNMENT) * PV_FRAME_BUS_ALIGNMENT;
+}
+
+static pv_frame_bus_slot_t *pv_frame_bus_slot(void *base, int64_t sequence) {
+    const pv_frame_bus_header_t *header = (const pv_frame_bus_header_t *) base;
+    const int64_t index = sequence % header->slot_count;
+    return (pv_frame_bus_slot_t *) ((uint8_t *) base + sizeof(pv_frame_bus_header_t) + index * header->slot_size);
+}
+
+static bool pv_frame_bus_shm_name(const char *name, char *shm_name) {
+    const size_t length = strlen(name);
+    if ((length == 0) || (length > PV_FRAME_BUS_MAX_NAME_LENGTH)) {
+        return false;
+    }
+    shm_name[0] = '/';
+    strcpy(shm_name + ((name[0] == '/') ? 0 : 1), name);
+    return true;
+}
+
+#if !defined(_WIN32)
+
+static int64_t pv_frame_bus_now_usec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+// Sleeps until the futex word moves on from `value` or `timeout_usec` passes, whichever is first.
+static void pv_frame_bus_wait(pv_frame_bus_header_t *header, uint32_t value, int64_t timeout_usec) {
+#if defined(__linux__)
+    struct timespec timeout = {
+            .tv_sec = (time_t) (timeout_usec / 1000000),
+            .tv_nsec = (long) ((timeout_usec % 1000000) * 1000),
+    };
+    __atomic_fetch_add(&header->waiters, 1, __ATOMIC_SEQ_CST);
+    syscall(SYS_futex, &header->futex, FUTEX_WAIT, value, &timeout, NULL, 0);
+    __atomic_fetch_sub(&header->waiters, 1, __ATOMIC_SEQ_CST);
+#else
+    (void)(header);
+    (void)(value);
+    static const int64_t POLL_INTERVAL_USEC = 1000;
+    const int64_t sleep_usec = (timeout_usec < POLL_INTERVAL_USEC) ? timeout_usec : POLL_INTERVAL_USEC;
+    struct timespec interval = {.tv_sec = 0, .tv_nsec = (long) (sleep_usec * 1000)};
+    nanosleep(&interval, NULL);
+#endif
+}
+
+static void pv_frame_bus_wake(pv_frame_bus_header_t *header) {
+    __atomic_fetch_add(&header->futex, 1, __ATOMIC_SEQ_CST);
+#if defined(__linux__)
+    if (__atomic_load_n(&header->waiters, __ATOMIC_SEQ_CST) > 0) {
+        syscall(SYS_futex, &header->futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+#endif
+}
+
+// Closes a bus left under `shm_name`, so its readers stop waiting on it, and unlinks it.
+static void pv_frame_bus_take_over(const char *shm_name) {
+    const int fd = shm_open(shm_name, O_RDWR, 0);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if ((fstat(fd, &info) == 0) && (info.st_size >= (off_t) sizeof(pv_frame_bus_header_t))) {
+        void *base = mmap(NULL, sizeof(pv_frame_bus_header_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            pv_frame_bus_header_t *header = (pv_frame_bus_header_t *) base;
+            __atomic_store_n(&header->is_closed, 1, __ATOMIC_RELEASE);
+            pv_frame_bus_wake(header);
+            munmap(base, sizeof(pv_frame_bus_header_t));
+        }
+    }
+    close(fd);
+    shm_unlink(shm_name);
+}
+
+#endif
+
+pv_recorder_status_t pv_frame_bus_init(
+        const char *name,
+        int32_t frame_length,
+        int32_t slot_count,
+        pv_frame_bus_t **object) {
+    if (!name || (frame_length <= 0) || (slot_count <= 0) || !object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+#if defined(_WIN32)
+    return PV_RECORDER_STATUS_BACKEND_ERROR;
+#else
+    pv_frame_bus_t *o = calloc(1, sizeof(pv_frame_bus_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    if (!pv_frame_bus_shm_name(name, o->name)) {
+        free(o);
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const int32_t slot_size = pv_frame_bus_slot_size(frame_length);
+    o->size = sizeof(pv_frame_bus_header_t) + ((size_t) slot_count * slot_size);
+
+    // readers still mapping an old bus of the same name, e.g. one left by a publisher that didn't shut down, keep it
+    // until they see it closed; new readers get a fresh one
+    pv_frame_bus_take_over(o->name);
+
+    const int fd = shm_open(o->name, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        free(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+    if (ftruncate(fd, (off_t) o->size) != 0) {
+        close(fd);
+        shm_unlink(o->name);
+        free(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+    o->base = mmap(NULL, o->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (o->base == MAP_FAILED) {
+        shm_unlink(o->name);
+        free(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    pv_frame_bus_header_t *header = (pv_frame_bus_header_t *) o->base;
+    header->frame_length = frame_length;
+    header->slot_count = slot_count;
+    header->slot_size = slot_size;
+    for (int32_t i = 0; i < slot_count; i++) {
+        pv_frame_bus_slot(o->base, i)->sequence = PV_FRAME_BUS_WRITING;
+    }
+    // readers check the magic last, so they never see a half-initialized header
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(header->magic, PV_FRAME_BUS_MAGIC, sizeof(header->magic));
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+#endif
+}
+
+void pv_frame_bus_delete(pv_frame_bus_t *object) {
+    if (object) {
+#if !defined(_WIN32)
+        pv_frame_bus_header_t *header = (pv_frame_bus_header_t *) object->base;
+        __atomic_store_n(&header->is_closed, 1, __ATOMIC_RELEASE);
+        pv_frame_bus_wake(header);
+        munmap(object->base, object->size);
+        shm_unlink(object->name);
+#endif
+        free(object);
+    }
+}
+
+void pv_frame_bus_publish(pv_frame_bus_t *object, const int16_t *pcm, const pv_recorder_frame_info_t *info) {
+#if defined(_WIN32)
+    (void)(object);
+    (void)(pcm);
+    (void)(info);
+#else
+    pv_frame_bus_header_t *header = (pv_frame_bus_header_t *) object->base;
+    const int64_t sequence = header->head;
+    pv_frame_bus_slot_t *slot = pv_frame_bus_slot(object->base, sequence);
+
+    __atomic_store_n(&slot->sequence, PV_FRAME_BUS_WRITING, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->timestamp_usec = info->timestamp_usec;
+    slot->frame_sequence = info->sequence_number;
+    slot->dropped_samples = info->dropped_samples;
+    slot->rms = info->rms;
+    slot->peak = info->peak;
+    slot->clipped_samples = info->clipped_samples;
+    memcpy(slot + 1, pcm, header->frame_length * sizeof(int16_t));
+    __atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&header->head, sequence + 1, __ATOMIC_RELEASE);
+    pv_frame_bus_wake(header);
+#endif
+}
+
+PV_API pv_recorder_status_t pv_recorder_bus_reader_init(const char *name, pv_recorder_bus_reader_t **object) {
+    if (!name || !object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+#if defined(_WIN32)
+    return PV_RECORDER_STATUS_BACKEND_ERROR;
+#else
+    char shm_name[PV_FRAME_BUS_MAX_NAME_LENGTH + 2];
+    if (!pv_frame_bus_shm_name(name, shm_name)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    // writable, for the count of waiters on the futex word
+    const int fd = shm_open(shm_name, O_RDWR, 0);
+    if (fd < 0) {
+        return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
+    }
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(pv_frame_bus_header_t))) {
+        close(fd);
+        return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
+    }
+    void *base = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    const pv_frame_bus_header_t *header = (const pv_frame_bus_header_t *) base;
+    const bool is_valid = (memcmp(header->magic, PV_FRAME_BUS_MAGIC, sizeof(header->magic)) == 0);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (!is_valid || (header->frame_length <= 0) || (header->slot_count <= 0) ||
+            (header->slot_size != pv_frame_bus_slot_size(header->frame_length)) ||
+            ((size_t) info.st_size <
+                    sizeof(pv_frame_bus_header_t) + ((size_t) header->slot_count * header->slot_size))) {
+        munmap(base, (size_t) info.st_size);
+        return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
+    }
+
+    pv_recorder_bus_reader_t *o = calloc(1, sizeof(pv_recorder_bus_reader_t));
+    if (!o) {
+        munmap(base, (size_t) info.st_size);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->base = base;
+    o->size = (size_t) info.st_size;
+    // a new reader starts with the next frame published
+    o->cursor = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+#endif
+}
+
+PV_API void pv_recorder_bus_reader_delete(pv_recorder_bus_reader_t *object) {
+    if (object) {
+#if !defined(_WIN32)
+        munmap(object->base, object->size);
+#endif
+        free(object);
+    }
+}
+
+PV_API int32_t pv_recorder_bus_reader_get_frame_length(const pv_recorder_bus_reader_t *object) {
+    if (!object) {
+        return 0;
+    }
+
+    return ((const pv_frame_bus_header_t *) object->base)->frame_length;
+}
+
+PV_API int64_t pv_recorder_bus_reader_get_lost_frames(const pv_recorder_bus_reader_t *object) {
+    if (!object) {
+        return 0;
+    }
+
+    return object->lost_frames;
+}
+
+PV_API pv_recorder_status_t pv_recorder_bus_reader_read(
+        pv_recorder_bus_reader_t *object,
+        int16_t *pcm,
+        pv_recorder_frame_info_t *info,
+        int32_t timeout_msec) {
+    if (!object || !pcm || (timeout_msec <= 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+#if defined(_WIN32)
+    (void)(info);
+    return PV_RECORDER_STATUS_BACKEND_ERROR;
+#else
+    pv_frame_bus_header_t *header = (pv_frame_bus_header_t *) object->base;
+    const int64_t deadline_usec = pv_frame_bus_now_usec() + ((int64_t) timeout_msec * 1000);
+
+    while (true) {
+        // taken before head, so a frame published in between makes the wait return at once
+        const uint32_t futex = __atomic_load_n(&header->futex, __ATOMIC_SEQ_CST);
+        const int64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+        if (object->cursor >= head) {
+            if (__atomic_load_n(&header->is_closed, __ATOMIC_ACQUIRE)) {
+                return PV_RECORDER_STATUS_INVALID_STATE;
+            }
+            const int64_t remaining_usec = deadline_usec - pv_frame_bus_now_usec();
+            if (remaining_usec <= 0) {
+                return PV_RECORDER_STATUS_IO_ERROR;
+            }
+            pv_frame_bus_wait(header, futex, remaining_usec);
+            continue;
+        }
+
+        if (head - object->cursor > header->slot_count) {
+            object->lost_frames += head - header->slot_count - object->cursor;
+            object->cursor = head - header->slot_count;
+        }
+
+        const pv_frame_bus_slot_t *slot = pv_frame_bus_slot(object->base, object->cursor);
+        const int64_t before = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (before == object->cursor) {
+            const int64_t timestamp_usec = slot->timestamp_usec;
+            const int64_t frame_sequence = slot->frame_sequence;
+            const int64_t dropped_samples = slot->dropped_samples;
+            const float rms = slot->rms;
+            const int32_t peak = slot->peak;
+            const int32_t clipped_samples = slot->clipped_samples;
+            memcpy(pcm, slot + 1, header->frame_length * sizeof(int16_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == before) {
+                object->cursor++;
+                if (info) {
+                    info->timestamp_usec = timestamp_usec;
+                    info->sequence_number = frame_sequence;
+                    info->dropped_samples = dropped_samples;
+                    info->rms = rms;
+                    info->peak = peak;
+                    info->clipped_samples = clipped_samples;
+                }
+                return PV_RECORDER_STATUS_SUCCESS;
+            }
+        }
+
+        // overwritten before or while it was copied
+        object->lost_frames++;
+        object->cursor++;
+    }
+#endif
+}
@@ -0,0 +1,233 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_GAIN_CONTROL_NEON
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PV_GAIN_CONTROL_SSE2
+
+#endif
+
+#include "pv_gain_control.h"
+#include "pv_level_meter.h"
+
+// 4 ms at 16 kHz: short enough for the attack to catch a shout, long enough for the block's level to mean something
+#define BLOCK_LENGTH (64)
+
+static const float MIN_TARGET_DBFS = -40.0f;
+static const float MAX_TARGET_DBFS = -3.0f;
+static const float MAX_GAIN_DB = 24.0f;
+static const float MIN_GAIN_DB = -20.0f;
+static const float ATTACK_SEC = 0.01f;
+static const float RELEASE_SEC = 1.0f;
+// below this a block is taken as silence, or the hiss between words, and doesn't move the envelope
+static const float GATE_DBFS = -55.0f;
+static const float FULL_SCALE = 32768.0f;
+
+// Q11, so 24 dB, a gain of 15.85, still fits 16 bits
+static const int32_t GAIN_BITS = 11;
+
+struct pv_gain_control {
+    bool is_neon;
+    int32_t sample_rate;
+    float target_rms;
+    float gate_rms;
+    float min_gain;
+    float max_gain;
+    // per whole block
+    float attack;
+    float release;
+    float envelope;
+    int32_t gain_q11;
+    int16_t gains[BLOCK_LENGTH];
+};
+
+static float from_db(float db) {
+    return powf(10.0f, db / 20.0f);
+}
+
+// Share of the way the envelope moves towards a block of `length` samples.
+static float coefficient(const pv_gain_control_t *object, float time_constant_sec, int32_t length) {
+    return 1.0f - expf(-(float) length / (time_constant_sec * (float) object->sample_rate));
+}
+
+// Scales whole blocks of 8 samples by their Q11 gains and returns how many samples it covered; the caller does the
+// rest.
+static int32_t apply_blocks(
+        const pv_gain_control_t *object,
+        const int16_t *input,
+        const int16_t *gains,
+        int32_t length,
+        int16_t *output) {
+    int32_t i = 0;
+#if defined(PV_GAIN_CONTROL_NEON)
+    if (object->is_neon) {
+        i = pv_neon_apply_gain(input, gains, length, output);
+    }
+#elif defined(PV_GAIN_CONTROL_SSE2)
+    (void) object;
+    const __m128i rounding = _mm_set1_epi32(1 << (GAIN_BITS - 1));
+    for (; (i + 8) <= length; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (input + i));
+        const __m128i g = _mm_loadu_si128((const __m128i *) (gains + i));
+        const __m128i low = _mm_mullo_epi16(x, g);
+        const __m128i high = _mm_mulhi_epi16(x, g);
+        const __m128i first = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(low, high), rounding), GAIN_BITS);
+        const __m128i second = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(low, high), rounding), GAIN_BITS);
+        // saturating, as the scalar path clamps
+        _mm_storeu_si128((__m128i *) (output + i), _mm_packs_epi32(first, second));
+    }
+#else
+    (void) object;
+    (void) input;
+    (void) gains;
+    (void) length;
+    (void) output;
+#endif
+    return i;
+}
+
+static void apply(
+        const pv_gain_control_t *object,
+        const int16_t *input,
+        const int16_t *gains,
+        int32_t length,
+        int16_t *output) {
+    int32_t i = apply_blocks(object, input, gains, length, output);
+    for (; i < length; i++) {
+        const int32_t y = (((int32_t) input[i] * gains[i]) + (1 << (GAIN_BITS - 1))) >> GAIN_BITS;
+        output[i] = (int16_t) ((y > INT16_MAX) ? INT16_MAX : ((y < INT16_MIN) ? INT16_MIN : y));
+    }
+}
+
+// Moves the envelope with one block and returns the block's new Q11 gain. Sets `ceiling` to the most gain the block's
+// peak allows without clipping.
+static int32_t next_gain(pv_gain_control_t *object, const int16_t *input, int32_t length, int32_t *ceiling) {
+    pv_level_t level;
+    pv_level_meter_measure(input, length, &level);
+    if (level.rms >= object->gate_rms) {
+        const bool is_rising = level.rms > object->envelope;
+        float share;
+        if (length == BLOCK_LENGTH) {
+            share = is_rising ? object->attack : object->release;
+        } else {
+            share = coefficient(object, is_rising ? ATTACK_SEC : RELEASE_SEC, length);
+        }
+        object->envelope += (level.rms - object->envelope) * share;
+    }
+
+    float gain = object->target_rms / object->envelope;
+    if (gain > object->max_gain) {
+        gain = object->max_gain;
+    } else if (gain < object->min_gain) {
+        gain = object->min_gain;
+    }
+    int32_t gain_q11 = (int32_t) lroundf(gain * (float) (1 << GAIN_BITS));
+
+    *ceiling = (level.peak > 0) ? ((INT16_MAX << GAIN_BITS) / level.peak) : INT16_MAX;
+    if (*ceiling > INT16_MAX) {
+        *ceiling = INT16_MAX;
+    }
+    return (gain_q11 > *ceiling) ? *ceiling : gain_q11;
+}
+
+pv_gain_control_status_t pv_gain_control_init(
+        int32_t sample_rate,
+        float target_dbfs,
+        float max_gain_db,
+        pv_gain_control_t **object) {
+    if (sample_rate <= 0) {
+        return PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT;
+    }
+    if (!((target_dbfs >= MIN_TARGET_DBFS) && (target_dbfs <= MAX_TARGET_DBFS))) {
+        return PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT;
+    }
+    if (!((max_gain_db >= 0.0f) && (max_gain_db <= MAX_GAIN_DB))) {
+        return PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_gain_control_t *o = calloc(1, sizeof(pv_gain_control_t));
+    if (!o) {
+        return PV_GAIN_CONTROL_STATUS_OUT_OF_MEMORY;
+    }
+
+#if defined(PV_GAIN_CONTROL_NEON)
+    // checked once here rather than for every block
+    o->is_neon = pv_neon_is_available();
+#endif
+    o->sample_rate = sample_rate;
+    o->target_rms = FULL_SCALE * from_db(target_dbfs);
+    o->gate_rms = FULL_SCALE * from_db(GATE_DBFS);
+    o->min_gain = from_db(MIN_GAIN_DB);
+    o->max_gain = from_db(max_gain_db);
+    o->attack = coefficient(o, ATTACK_SEC, BLOCK_LENGTH);
+    o->release = coefficient(o, RELEASE_SEC, BLOCK_LENGTH);
+    pv_gain_control_reset(o);
+
+    *object = o;
+
+    return PV_GAIN_CONTROL_STATUS_SUCCESS;
+}
+
+void pv_gain_control_delete(pv_gain_control_t *object) {
+    free(object);
+}
+
+void pv_gain_control_process(pv_gain_control_t *object, const int16_t *input, int32_t length, int16_t *output) {
+    if (!object || !input || !output || (length <= 0)) {
+        return;
+    }
+
+    for (int32_t start = 0; start < length; start += BLOCK_LENGTH) {
+        const int32_t n = ((length - start) < BLOCK_LENGTH) ? (length - start) : BLOCK_LENGTH;
+        int32_t ceiling = INT16_MAX;
+        const int32_t gain_q11 = next_gain(object, input + start, n, &ceiling);
+        // a ramp rather than a step, which would click, but one that starts low enough for the block not to clip
+        const int32_t from = (object->gain_q11 > ceiling) ? ceiling : object->gain_q11;
+        for (int32_t i = 0; i < n; i++) {
+            object->gains[i] = (int16_t) (from + (((gain_q11 - from) * (i + 1)) / n));
+        }
+        apply(object, input + start, object->gains, n, output + start);
+        object->gain_q11 = gain_q11;
+    }
+}
+
+float pv_gain_control_get_gain_db(const pv_gain_control_t *object) {
+    if (!object) {
+        return 0.0f;
+    }
+    return 20.0f * log10f((float) object->gain_q11 / (float) (1 << GAIN_BITS));
+}
+
+void pv_gain_control_reset(pv_gain_control_t *object) {
+    if (object) {
+        // as if the audio were already at the target, so it starts at unity gain
+        object->envelope = object->target_rms;
+        object->gain_q11 = 1 << GAIN_BITS;
+    }
+}
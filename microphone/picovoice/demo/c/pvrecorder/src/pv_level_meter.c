@@ -0,0 +1,115 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_LEVEL_METER_NEON
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PV_LEVEL_METER_SSE2
+
+#endif
+
+#include "pv_level_meter.h"
+
+// Accumulates whole blocks of 8 samples and returns how many samples it covered; the caller does the rest.
+static int32_t measure_blocks(
+        const int16_t *pcm,
+        int32_t length,
+        uint64_t *sum_squares,
+        int32_t *peak,
+        int32_t *clipped_samples) {
+    int32_t i = 0;
+#if defined(PV_LEVEL_METER_NEON)
+    if (pv_neon_is_available()) {
+        i = pv_neon_measure_level(pcm, length, sum_squares, peak, clipped_samples);
+    }
+#elif defined(PV_LEVEL_METER_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i full_scale = _mm_set1_epi16(INT16_MAX);
+    const __m128i negative_full_scale = _mm_set1_epi16(INT16_MIN);
+    __m128i sum = zero;
+    __m128i max = zero;
+    __m128i clipped = zero;
+    for (; (i + 8) <= length; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (pcm + i));
+        // a pair of squares is at most 2^31, so it fits the 32-bit lanes when they are read as unsigned
+        const __m128i squares = _mm_madd_epi16(x, x);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(squares, zero));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(squares, zero));
+        // saturating negation, so INT16_MIN becomes INT16_MAX as in the scalar path
+        max = _mm_max_epi16(max, _mm_max_epi16(x, _mm_subs_epi16(zero, x)));
+        const __m128i is_clipped = _mm_or_si128(_mm_cmpeq_epi16(x, full_scale), _mm_cmpeq_epi16(x, negative_full_scale));
+        clipped = _mm_sub_epi32(clipped, _mm_madd_epi16(is_clipped, ones));
+    }
+
+    uint64_t sum_lanes[2];
+    int16_t max_lanes[8];
+    int32_t clipped_lanes[4];
+    _mm_storeu_si128((__m128i *) sum_lanes, sum);
+    _mm_storeu_si128((__m128i *) max_lanes, max);
+    _mm_storeu_si128((__m128i *) clipped_lanes, clipped);
+    *sum_squares += sum_lanes[0] + sum_lanes[1];
+    for (int32_t j = 0; j < 8; j++) {
+        if (max_lanes[j] > *peak) {
+            *peak = max_lanes[j];
+        }
+    }
+    *clipped_samples += clipped_lanes[0] + clipped_lanes[1] + clipped_lanes[2] + clipped_lanes[3];
+#else
+    (void) pcm;
+    (void) length;
+    (void) sum_squares;
+    (void) peak;
+    (void) clipped_samples;
+#endif
+    return i;
+}
+
+void pv_level_meter_measure(const int16_t *pcm, int32_t length, pv_level_t *level) {
+    if (!level) {
+        return;
+    }
+    memset(level, 0, sizeof(*level));
+    if (!pcm || (length <= 0)) {
+        return;
+    }
+
+    uint64_t sum_squares = 0;
+    int32_t peak = 0;
+    int32_t clipped_samples = 0;
+
+    int32_t i = measure_blocks(pcm, length, &sum_squares, &peak, &clipped_samples);
+    for (; i < length; i++) {
+        const int32_t x = pcm[i];
+        sum_squares += (uint64_t) (x * x);
+        const int32_t magnitude = (x == INT16_MIN) ? INT16_MAX : ((x < 0) ? -x : x);
+        if (magnitude > peak) {
+            peak = magnitude;
+        }
+        if ((x == INT16_MAX) || (x == INT16_MIN)) {
+            clipped_samples++;
+        }
+    }
+
+    level->rms = (float) sqrt((double) sum_squares / (double) length);
+    level->peak = peak;
+    level->clipped_samples = clipped_samples;
+}
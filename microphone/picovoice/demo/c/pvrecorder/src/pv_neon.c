@@ -0,0 +1,274 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && defined(__linux__)
+
+#include <sys/auxv.h>
+
+// from asm/hwcap.h, which not every toolchain ships for 32-bit ARM
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+
+#endif
+
+#include "pv_neon.h"
+
+static bool is_neon_enabled = true;
+
+static bool has_neon(void) {
+#if defined(__aarch64__)
+    return true;
+#elif defined(__linux__)
+    // the file is built for NEON either way; only the CPU can tell whether it may run
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+    return false;
+#endif
+}
+
+bool pv_neon_is_available(void) {
+    // 0 until checked, then 1 or 2; racing first calls compute the same answer
+    static int32_t state = 0;
+    int32_t value = __atomic_load_n(&state, __ATOMIC_RELAXED);
+    if (value == 0) {
+        value = has_neon() ? 1 : 2;
+        __atomic_store_n(&state, value, __ATOMIC_RELAXED);
+    }
+    return (value == 1) && __atomic_load_n(&is_neon_enabled, __ATOMIC_RELAXED);
+}
+
+void pv_neon_set_enabled(bool is_enabled) {
+    __atomic_store_n(&is_neon_enabled, is_enabled, __ATOMIC_RELAXED);
+}
+
+int32_t pv_neon_measure_level(
+        const int16_t *pcm,
+        int32_t length,
+        uint64_t *sum_squares,
+        int32_t *peak,
+        int32_t *clipped_samples) {
+    const int16x8_t full_scale = vdupq_n_s16(INT16_MAX);
+    const int16x8_t negative_full_scale = vdupq_n_s16(INT16_MIN);
+    uint64x2_t sum = vdupq_n_u64(0);
+    int16x8_t max = vdupq_n_s16(0);
+    uint32x4_t clipped = vdupq_n_u32(0);
+
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int16x8_t x = vld1q_s16(pcm + i);
+        // a pair of squares is at most 2^31, which wraps as signed but is exact once read as unsigned
+        int32x4_t squares = vmull_s16(vget_low_s16(x), vget_low_s16(x));
+        squares = vmlal_s16(squares, vget_high_s16(x), vget_high_s16(x));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(squares));
+        // saturating, so INT16_MIN becomes INT16_MAX as in the scalar path
+        max = vmaxq_s16(max, vqabsq_s16(x));
+        const uint16x8_t is_clipped = vorrq_u16(vceqq_s16(x, full_scale), vceqq_s16(x, negative_full_scale));
+        clipped = vpadalq_u16(clipped, vshrq_n_u16(is_clipped, 15));
+    }
+
+    *sum_squares += vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1);
+
+    // across-lane reductions without the AArch64-only instructions
+    int16x4_t max_pair = vmax_s16(vget_low_s16(max), vget_high_s16(max));
+    max_pair = vpmax_s16(max_pair, max_pair);
+    max_pair = vpmax_s16(max_pair, max_pair);
+    if (vget_lane_s16(max_pair, 0) > *peak) {
+        *peak = vget_lane_s16(max_pair, 0);
+    }
+
+    const uint64x2_t clipped_pair = vpaddlq_u32(clipped);
+    *clipped_samples += (int32_t) (vgetq_lane_u64(clipped_pair, 0) + vgetq_lane_u64(clipped_pair, 1));
+
+    return i;
+}
+
+int32_t pv_neon_dot_product(const int16_t *x, const int16_t *taps, int32_t length) {
+    int32x4_t acc = vdupq_n_s32(0);
+    for (int32_t i = 0; i < length; i += 8) {
+        const int16x8_t a = vld1q_s16(x + i);
+        const int16x8_t b = vld1q_s16(taps + i);
+        acc = vmlal_s16(acc, vget_low_s16(a), vget_low_s16(b));
+        acc = vmlal_s16(acc, vget_high_s16(a), vget_high_s16(b));
+    }
+    const int32x2_t pair = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(pair, pair), 0);
+}
+
+int32_t pv_neon_average_stereo(const int16_t *input, int32_t frame_count, int16_t *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= frame_count; i += 8) {
+        const int16x8x2_t x = vld2q_s16(input + (2 * i));
+        const int32x4_t low = vaddl_s16(vget_low_s16(x.val[0]), vget_low_s16(x.val[1]));
+        const int32x4_t high = vaddl_s16(vget_high_s16(x.val[0]), vget_high_s16(x.val[1]));
+        vst1q_s16(output + i, vcombine_s16(vrshrn_n_s32(low, 1), vrshrn_n_s32(high, 1)));
+    }
+    return i;
+}
+
+int32_t pv_neon_average_quad(const int16_t *input, int32_t frame_count, int16_t *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= frame_count; i += 8) {
+        const int16x8x4_t x = vld4q_s16(input + (4 * i));
+        int32x4_t low = vaddl_s16(vget_low_s16(x.val[0]), vget_low_s16(x.val[1]));
+        low = vaddq_s32(low, vaddl_s16(vget_low_s16(x.val[2]), vget_low_s16(x.val[3])));
+        int32x4_t high = vaddl_s16(vget_high_s16(x.val[0]), vget_high_s16(x.val[1]));
+        high = vaddq_s32(high, vaddl_s16(vget_high_s16(x.val[2]), vget_high_s16(x.val[3])));
+        vst1q_s16(output + i, vcombine_s16(vrshrn_n_s32(low, 2), vrshrn_n_s32(high, 2)));
+    }
+    return i;
+}
+
+int32_t pv_neon_window_pair(const int16_t *a, const int16_t *b, const int16_t *window, int32_t length, int32_t *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int16x8_t w = vld1q_s16(window + i);
+        const int16x8_t x = vld1q_s16(a + i);
+        const int16x8_t y = vld1q_s16(b + i);
+        int32x4x2_t low;
+        low.val[0] = vrshrq_n_s32(vmull_s16(vget_low_s16(x), vget_low_s16(w)), 11);
+        low.val[1] = vrshrq_n_s32(vmull_s16(vget_low_s16(y), vget_low_s16(w)), 11);
+        vst2q_s32(output + (2 * i), low);
+        int32x4x2_t high;
+        high.val[0] = vrshrq_n_s32(vmull_s16(vget_high_s16(x), vget_high_s16(w)), 11);
+        high.val[1] = vrshrq_n_s32(vmull_s16(vget_high_s16(y), vget_high_s16(w)), 11);
+        vst2q_s32(output + (2 * i) + 8, high);
+    }
+    return i;
+}
+
+void pv_neon_fft_butterflies(
+        int32_t *data,
+        int32_t length,
+        int32_t half,
+        const int32_t *twiddle_re,
+        const int32_t *twiddle_im,
+        bool is_halving) {
+    for (int32_t k = 0; k < length; k += 2 * half) {
+        int32_t *top = data + (2 * k);
+        int32_t *bottom = data + (2 * (k + half));
+        for (int32_t j = 0; j < half; j += 4) {
+            const int32x4x2_t a = vld2q_s32(top + (2 * j));
+            const int32x4x2_t b = vld2q_s32(bottom + (2 * j));
+            const int32x4_t w_re = vld1q_s32(twiddle_re + j);
+            const int32x4_t w_im = vld1q_s32(twiddle_im + j);
+            const int32x4_t t_re = vsubq_s32(vqrdmulhq_s32(b.val[0], w_re), vqrdmulhq_s32(b.val[1], w_im));
+            const int32x4_t t_im = vaddq_s32(vqrdmulhq_s32(b.val[0], w_im), vqrdmulhq_s32(b.val[1], w_re));
+            int32x4x2_t sum;
+            int32x4x2_t difference;
+            if (is_halving) {
+                sum.val[0] = vhaddq_s32(a.val[0], t_re);
+                sum.val[1] = vhaddq_s32(a.val[1], t_im);
+                difference.val[0] = vhsubq_s32(a.val[0], t_re);
+                difference.val[1] = vhsubq_s32(a.val[1], t_im);
+            } else {
+                sum.val[0] = vaddq_s32(a.val[0], t_re);
+                sum.val[1] = vaddq_s32(a.val[1], t_im);
+                difference.val[0] = vsubq_s32(a.val[0], t_re);
+                difference.val[1] = vsubq_s32(a.val[1], t_im);
+            }
+            vst2q_s32(top + (2 * j), sum);
+            vst2q_s32(bottom + (2 * j), difference);
+        }
+    }
+}
+
+int32_t pv_neon_unwindow_pair(const int32_t *data, const int32_t *window, int32_t length, int32_t *a, int32_t *b) {
+    int32_t i = 0;
+    for (; (i + 4) <= length; i += 4) {
+        const int32x4x2_t x = vld2q_s32(data + (2 * i));
+        const int32x4_t w = vld1q_s32(window + i);
+        vst1q_s32(a + i, vqrdmulhq_s32(x.val[0], w));
+        vst1q_s32(b + i, vqrdmulhq_s32(vnegq_s32(x.val[1]), w));
+    }
+    return i;
+}
+
+int32_t pv_neon_overlap_add(const int32_t *x, const int32_t *y, int32_t length, int16_t *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int32x4_t low = vaddq_s32(vld1q_s32(x + i), vld1q_s32(y + i));
+        const int32x4_t high = vaddq_s32(vld1q_s32(x + i + 4), vld1q_s32(y + i + 4));
+        vst1q_s16(output + i, vcombine_s16(vqrshrn_n_s32(low, 4), vqrshrn_n_s32(high, 4)));
+    }
+    return i;
+}
+
+int32_t pv_neon_apply_gain(const int16_t *input, const int16_t *gains, int32_t length, int16_t *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int16x8_t x = vld1q_s16(input + i);
+        const int16x8_t g = vld1q_s16(gains + i);
+        const int32x4_t low = vmull_s16(vget_low_s16(x), vget_low_s16(g));
+        const int32x4_t high = vmull_s16(vget_high_s16(x), vget_high_s16(g));
+        vst1q_s16(output + i, vcombine_s16(vqrshrn_n_s32(low, 11), vqrshrn_n_s32(high, 11)));
+    }
+    return i;
+}
+
+int32_t pv_neon_to_float(const int16_t *input, int32_t length, float scale, float *output) {
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int16x8_t x = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), scale));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), scale));
+    }
+    return i;
+}
+
+// Four outputs of the DC blocker from the block's differences `d` and the output before the block, lane 3 of
+// `previous`.
+static float32x4_t remove_dc_block(float32x4_t d, float32x4_t previous, const float32x4_t *coefficients) {
+    float32x4_t y = vmulq_lane_f32(coefficients[4], vget_high_f32(previous), 1);
+    y = vmlaq_lane_f32(y, coefficients[0], vget_low_f32(d), 0);
+    y = vmlaq_lane_f32(y, coefficients[1], vget_low_f32(d), 1);
+    y = vmlaq_lane_f32(y, coefficients[2], vget_high_f32(d), 0);
+    return vmlaq_lane_f32(y, coefficients[3], vget_high_f32(d), 1);
+}
+
+int32_t pv_neon_remove_dc(
+        const int16_t *input,
+        int32_t length,
+        const float *coefficients,
+        float scale,
+        float *previous_input,
+        float *previous_output,
+        float *output) {
+    const float32x4_t c[5] = {
+            vld1q_f32(coefficients),
+            vld1q_f32(coefficients + 4),
+            vld1q_f32(coefficients + 8),
+            vld1q_f32(coefficients + 12),
+            vld1q_f32(coefficients + 16)};
+    float32x4_t last_x = vdupq_n_f32(*previous_input);
+    float32x4_t last_y = vdupq_n_f32(*previous_output);
+
+    int32_t i = 0;
+    for (; (i + 8) <= length; i += 8) {
+        const int16x8_t x = vld1q_s16(input + i);
+        const float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        const float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        // each sample less the one before it, the last of the previous block for the first
+        const float32x4_t d_low = vsubq_f32(low, vextq_f32(last_x, low, 3));
+        const float32x4_t d_high = vsubq_f32(high, vextq_f32(low, high, 3));
+        last_x = high;
+        const float32x4_t y_low = remove_dc_block(d_low, last_y, c);
+        last_y = remove_dc_block(d_high, y_low, c);
+        vst1q_f32(output + i, vmulq_n_f32(y_low, scale));
+        vst1q_f32(output + i + 4, vmulq_n_f32(last_y, scale));
+    }
+
+    *previous_input = vgetq_lane_f32(last_x, 3);
+    *previous_output = vgetq_lane_f32(last_y, 3);
+    return i;
+}
@@ -0,0 +1,189 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_NEON_H
+#define PV_NEON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * NEON kernels for the sample-level work in pv_recorder. Internal to pv_recorder and only built on ARM, where CMake
+ * defines PV_RECORDER_NEON. On 32-bit ARM this file alone is compiled with `-mfpu=neon`, so one armhf library runs on
+ * CPUs with and without NEON; callers check pv_neon_is_available before using any kernel.
+ */
+
+/**
+ * Reports whether the NEON kernels may be called. Always true where the whole build targets NEON, e.g. AArch64;
+ * otherwise decided once from the CPU's hardware capabilities.
+ *
+ * @return True if the CPU has NEON and it hasn't been disabled with pv_neon_set_enabled.
+ */
+bool pv_neon_is_available(void);
+
+/**
+ * Turns the NEON kernels off, or back on, so the generic path can be measured or tested on the same board. Never
+ * enables them on a CPU without NEON. Objects that pick their kernels at construction keep the choice they made.
+ *
+ * @param is_enabled False to make pv_neon_is_available return false.
+ */
+void pv_neon_set_enabled(bool is_enabled);
+
+/**
+ * Adds the sum of squares, peak magnitude and number of full-scale samples of whole blocks of 8 samples to the values
+ * passed in.
+ *
+ * @param pcm Samples.
+ * @param length Number of samples.
+ * @param sum_squares[in, out] Running sum of squared samples.
+ * @param peak[in, out] Running peak magnitude; INT16_MIN counts as 32767.
+ * @param clipped_samples[in, out] Running count of INT16_MIN and INT16_MAX samples.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_measure_level(
+        const int16_t *pcm,
+        int32_t length,
+        uint64_t *sum_squares,
+        int32_t *peak,
+        int32_t *clipped_samples);
+
+/**
+ * Q15 dot product of a history window and the reversed filter taps.
+ *
+ * @param x History samples.
+ * @param taps Filter taps.
+ * @param length Number of taps. Must be a multiple of 8.
+ * @return Accumulated products.
+ */
+int32_t pv_neon_dot_product(const int16_t *x, const int16_t *taps, int32_t length);
+
+/**
+ * Rounded mean of interleaved stereo frames, 8 frames at a time.
+ *
+ * @param input Interleaved input of `2 * frame_count` samples.
+ * @param frame_count Number of frames.
+ * @param output[out] Mono output.
+ * @return Number of frames processed; the caller handles the rest.
+ */
+int32_t pv_neon_average_stereo(const int16_t *input, int32_t frame_count, int16_t *output);
+
+/**
+ * Rounded mean of interleaved 4-channel frames, 8 frames at a time.
+ *
+ * @param input Interleaved input of `4 * frame_count` samples.
+ * @param frame_count Number of frames.
+ * @param output[out] Mono output.
+ * @return Number of frames processed; the caller handles the rest.
+ */
+int32_t pv_neon_average_quad(const int16_t *input, int32_t frame_count, int16_t *output);
+
+/**
+ * Windows two real signals into one complex signal for pv_noise_suppressor's FFT, 8 samples at a time: the real part
+ * from `a`, the imaginary part from `b`, each sample scaled up by 16 and by the Q15 window, rounded.
+ *
+ * @param a Samples of the real part.
+ * @param b Samples of the imaginary part.
+ * @param window Q15 window.
+ * @param length Number of samples.
+ * @param output[out] Interleaved real and imaginary parts, `2 * length` values.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_window_pair(const int16_t *a, const int16_t *b, const int16_t *window, int32_t length, int32_t *output);
+
+/**
+ * One radix-2 decimation-in-time stage of pv_noise_suppressor's FFT over interleaved complex values. Each twiddle
+ * product is rounded from Q31 on its own, as vqrdmulh does.
+ *
+ * @param data[in, out] Interleaved complex values.
+ * @param length Number of complex values.
+ * @param half Distance between the two inputs of a butterfly. Must be a multiple of 4.
+ * @param twiddle_re Real parts of the stage's `half` Q31 twiddles.
+ * @param twiddle_im Imaginary parts of the stage's twiddles.
+ * @param is_halving True to halve every output, rounding down, so the values never grow.
+ */
+void pv_neon_fft_butterflies(
+        int32_t *data,
+        int32_t length,
+        int32_t half,
+        const int32_t *twiddle_re,
+        const int32_t *twiddle_im,
+        bool is_halving);
+
+/**
+ * Takes the two real signals back out of an inverse transform, 4 samples at a time, each multiplied by the Q31 window:
+ * `a` from the real parts and `b` from the negated imaginary parts.
+ *
+ * @param data Interleaved complex values.
+ * @param window Q31 window.
+ * @param length Number of complex values.
+ * @param a[out] Windowed real parts.
+ * @param b[out] Windowed, negated imaginary parts.
+ * @return Number of values processed; the caller handles the rest.
+ */
+int32_t pv_neon_unwindow_pair(const int32_t *data, const int32_t *window, int32_t length, int32_t *a, int32_t *b);
+
+/**
+ * Adds two windowed signals and scales the sum back down by 16 to samples, rounded and saturated, 8 at a time.
+ *
+ * @param x First signal.
+ * @param y Second signal.
+ * @param length Number of samples.
+ * @param output[out] Samples.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_overlap_add(const int32_t *x, const int32_t *y, int32_t length, int16_t *output);
+
+/**
+ * Scales samples by pv_gain_control's per-sample Q11 gains, rounded and saturated, 8 at a time.
+ *
+ * @param input Samples.
+ * @param gains Q11 gains, one per sample.
+ * @param length Number of samples.
+ * @param output[out] Scaled samples. May be the same as `input`.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_apply_gain(const int16_t *input, const int16_t *gains, int32_t length, int16_t *output);
+
+/**
+ * Converts samples to float, multiplied by `scale`, 8 at a time.
+ *
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param scale Factor for each sample, e.g. 1 / 32768.
+ * @param output[out] Float samples.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_to_float(const int16_t *input, int32_t length, float scale, float *output);
+
+/**
+ * pv_sample_format's one-pole DC blocker, 8 samples at a time as two blocks of 4, each worked out from its differences
+ * and the output before it.
+ *
+ * @param input Samples.
+ * @param length Number of samples.
+ * @param coefficients The block's 4 columns of pole powers, then the feedback of the output before the block; 20
+ * values.
+ * @param scale Factor for each output, e.g. 1 / 32768.
+ * @param previous_input[in, out] Sample before the first one.
+ * @param previous_output[in, out] Output before the first one, unscaled.
+ * @param output[out] Float samples.
+ * @return Number of samples processed; the caller handles the rest.
+ */
+int32_t pv_neon_remove_dc(
+        const int16_t *input,
+        int32_t length,
+        const float *coefficients,
+        float scale,
+        float *previous_input,
+        float *previous_output,
+        float *output);
+
+#endif // PV_NEON_H
@@ -0,0 +1,373 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_NOISE_SUPPRESSOR_NEON
+
+#endif
+
+#include "pv_noise_suppressor.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Samples go into the FFT scaled up by 16 (the NEON kernels have the shifts built in). The transform of a frame of
+// 2048 full-scale samples then still fits in 32 bits, and the inverse halves at every stage, so it never grows.
+static const int32_t MIN_FRAME_LENGTH = 64;
+static const int32_t MAX_FRAME_LENGTH = 2048;
+static const int32_t SCALE_BITS = 4;
+
+// over-subtraction: a bin needs twice the noise power before any of it is kept
+static const float OVER_SUBTRACTION = 2.0f;
+// per window, i.e. every half frame: the noise drops to a quieter bin quickly but rises slowly, over seconds, so a
+// word doesn't become the noise while steady hum does
+static const float NOISE_FALL = 0.1f;
+static const float NOISE_RISE = 0.002f;
+
+struct pv_noise_suppressor {
+    bool is_neon;
+    int32_t frame_length;
+    int32_t hop;
+    float gain_floor;
+    // the periodic square root of a Hann window, used on both sides, so the overlapping halves add up to one
+    int16_t *window_q15;
+    int32_t *window_q31;
+    // stage `half` uses the `half` entries from index `half - 1`
+    int32_t *twiddle_re;
+    int32_t *twiddle_im;
+    int32_t *bit_reverse;
+    // the second half of the last frame, which starts this frame's first window
+    int16_t *history;
+    // interleaved real and imaginary parts
+    int32_t *spectrum;
+    int32_t *a;
+    int32_t *b;
+    // the last frame's second window past its middle, still to be added to
+    int32_t *tail;
+    float *noise;
+    bool is_noise_known;
+};
+
+static int32_t to_q31(double value) {
+    return (int32_t) lround(value * 2147483647.0);
+}
+
+static int32_t multiply_q31(int32_t a, int32_t b) {
+    return (int32_t) ((((int64_t) a * b) + (1 << 30)) >> 31);
+}
+
+static int32_t multiply_q15(int32_t a, int32_t b) {
+    return (int32_t) (((int64_t) a * b) >> 15);
+}
+
+static int32_t half_sum(int32_t a, int32_t b) {
+    return (int32_t) (((int64_t) a + b) >> 1);
+}
+
+static int32_t half_difference(int32_t a, int32_t b) {
+    return (int32_t) (((int64_t) a - b) >> 1);
+}
+
+static int16_t to_sample(int32_t value) {
+    value = (value + (1 << (SCALE_BITS - 1))) >> SCALE_BITS;
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t) value;
+}
+
+static void window_pair(
+        const pv_noise_suppressor_t *object,
+        const int16_t *a,
+        const int16_t *b,
+        const int16_t *window,
+        int32_t length,
+        int32_t *output) {
+    int32_t i = 0;
+#if defined(PV_NOISE_SUPPRESSOR_NEON)
+    if (object->is_neon) {
+        i = pv_neon_window_pair(a, b, window, length, output);
+    }
+#else
+    (void) object;
+#endif
+    const int32_t shift = 15 - SCALE_BITS;
+    for (; i < length; i++) {
+        output[2 * i] = (((int32_t) a[i] * window[i]) + (1 << (shift - 1))) >> shift;
+        output[(2 * i) + 1] = (((int32_t) b[i] * window[i]) + (1 << (shift - 1))) >> shift;
+    }
+}
+
+static void butterflies(const pv_noise_suppressor_t *object, int32_t half, bool is_halving) {
+    int32_t *data = object->spectrum;
+    const int32_t *twiddle_re = object->twiddle_re + (half - 1);
+    const int32_t *twiddle_im = object->twiddle_im + (half - 1);
+#if defined(PV_NOISE_SUPPRESSOR_NEON)
+    if (object->is_neon && ((half % 4) == 0)) {
+        pv_neon_fft_butterflies(data, object->frame_length, half, twiddle_re, twiddle_im, is_halving);
+        return;
+    }
+#endif
+    for (int32_t k = 0; k < object->frame_length; k += 2 * half) {
+        int32_t *top = data + (2 * k);
+        int32_t *bottom = data + (2 * (k + half));
+        for (int32_t j = 0; j < half; j++) {
+            const int32_t a_re = top[2 * j];
+            const int32_t a_im = top[(2 * j) + 1];
+            const int32_t b_re = bottom[2 * j];
+            const int32_t b_im = bottom[(2 * j) + 1];
+            const int32_t t_re = multiply_q31(b_re, twiddle_re[j]) - multiply_q31(b_im, twiddle_im[j]);
+            const int32_t t_im = multiply_q31(b_re, twiddle_im[j]) + multiply_q31(b_im, twiddle_re[j]);
+            if (is_halving) {
+                top[2 * j] = half_sum(a_re, t_re);
+                top[(2 * j) + 1] = half_sum(a_im, t_im);
+                bottom[2 * j] = half_difference(a_re, t_re);
+                bottom[(2 * j) + 1] = half_difference(a_im, t_im);
+            } else {
+                top[2 * j] = a_re + t_re;
+                top[(2 * j) + 1] = a_im + t_im;
+                bottom[2 * j] = a_re - t_re;
+                bottom[(2 * j) + 1] = a_im - t_im;
+            }
+        }
+    }
+}
+
+// In place; halving, it is the inverse transform of the conjugate, conjugated.
+static void fft(const pv_noise_suppressor_t *object, bool is_halving) {
+    int32_t *data = object->spectrum;
+    for (int32_t i = 0; i < object->frame_length; i++) {
+        const int32_t j = object->bit_reverse[i];
+        if (i < j) {
+            const int32_t re = data[2 * i];
+            const int32_t im = data[(2 * i) + 1];
+            data[2 * i] = data[2 * j];
+            data[(2 * i) + 1] = data[(2 * j) + 1];
+            data[2 * j] = re;
+            data[(2 * j) + 1] = im;
+        }
+    }
+    for (int32_t half = 1; half < object->frame_length; half *= 2) {
+        butterflies(object, half, is_halving);
+    }
+}
+
+static void unwindow_pair(const pv_noise_suppressor_t *object) {
+    int32_t i = 0;
+#if defined(PV_NOISE_SUPPRESSOR_NEON)
+    if (object->is_neon) {
+        i = pv_neon_unwindow_pair(object->spectrum, object->window_q31, object->frame_length, object->a, object->b);
+    }
+#endif
+    for (; i < object->frame_length; i++) {
+        object->a[i] = multiply_q31(object->spectrum[2 * i], object->window_q31[i]);
+        object->b[i] = multiply_q31(-object->spectrum[(2 * i) + 1], object->window_q31[i]);
+    }
+}
+
+static void overlap_add(const pv_noise_suppressor_t *object, const int32_t *x, const int32_t *y, int16_t *output) {
+    int32_t i = 0;
+#if defined(PV_NOISE_SUPPRESSOR_NEON)
+    if (object->is_neon) {
+        i = pv_neon_overlap_add(x, y, object->hop, output);
+    }
+#endif
+    for (; i < object->hop; i++) {
+        output[i] = to_sample(x[i] + y[i]);
+    }
+}
+
+// Follows the bin's noise with its power and returns the Q15 gain for it.
+static int32_t bin_gain(pv_noise_suppressor_t *object, int32_t k, float power) {
+    float *noise = &object->noise[k];
+    *noise += (power - *noise) * ((power < *noise) ? NOISE_FALL : NOISE_RISE);
+    float gain = (power > 0.0f) ? (1.0f - ((OVER_SUBTRACTION * *noise) / power)) : 0.0f;
+    if (gain < object->gain_floor) {
+        gain = object->gain_floor;
+    }
+    return (int32_t) ((gain * 32767.0f) + 0.5f);
+}
+
+static float power(int32_t re, int32_t im) {
+    return ((float) re * (float) re) + ((float) im * (float) im);
+}
+
+// Splits the packed transform into the two windows' spectra, scales each bin of each by its gain, and packs them
+// again, conjugated for the inverse transform.
+static void suppress(pv_noise_suppressor_t *object) {
+    int32_t *z = object->spectrum;
+    for (int32_t k = 0; k <= object->hop; k++) {
+        const int32_t m = (object->frame_length - k) & (object->frame_length - 1);
+        // the transform of a real signal is conjugate-symmetric, of an imaginary one anti-symmetric
+        const int32_t a_re = half_sum(z[2 * k], z[2 * m]);
+        const int32_t a_im = half_difference(z[(2 * k) + 1], z[(2 * m) + 1]);
+        const int32_t b_re = half_sum(z[(2 * k) + 1], z[(2 * m) + 1]);
+        const int32_t b_im = half_difference(z[2 * m], z[2 * k]);
+
+        const float b_power = power(b_re, b_im);
+        if (!object->is_noise_known) {
+            object->noise[k] = b_power;
+        }
+        // the first window is the earlier one
+        const int32_t a_gain = bin_gain(object, k, power(a_re, a_im));
+        const int32_t b_gain = bin_gain(object, k, b_power);
+
+        const int32_t ga_re = multiply_q15(a_re, a_gain);
+        const int32_t ga_im = multiply_q15(a_im, a_gain);
+        const int32_t gb_re = multiply_q15(b_re, b_gain);
+        const int32_t gb_im = multiply_q15(b_im, b_gain);
+        z[2 * k] = ga_re - gb_im;
+        z[(2 * k) + 1] = -(ga_im + gb_re);
+        z[2 * m] = ga_re + gb_im;
+        z[(2 * m) + 1] = ga_im - gb_re;
+    }
+    object->is_noise_known = true;
+}
+
+pv_noise_suppressor_status_t pv_noise_suppressor_init(
+        int32_t frame_length,
+        float attenuation_db,
+        pv_noise_suppressor_t **object) {
+    if ((frame_length < MIN_FRAME_LENGTH) || (frame_length > MAX_FRAME_LENGTH) ||
+        ((frame_length & (frame_length - 1)) != 0)) {
+        return PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT;
+    }
+    if (!((attenuation_db >= 1.0f) && (attenuation_db <= 40.0f))) {
+        return PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_noise_suppressor_t *o = calloc(1, sizeof(pv_noise_suppressor_t));
+    if (!o) {
+        return PV_NOISE_SUPPRESSOR_STATUS_OUT_OF_MEMORY;
+    }
+
+#if defined(PV_NOISE_SUPPRESSOR_NEON)
+    // checked once here rather than for every frame
+    o->is_neon = pv_neon_is_available();
+#endif
+    o->frame_length = frame_length;
+    o->hop = frame_length / 2;
+    o->gain_floor = powf(10.0f, -attenuation_db / 20.0f);
+
+    o->window_q15 = calloc(frame_length, sizeof(int16_t));
+    o->window_q31 = calloc(frame_length, sizeof(int32_t));
+    o->twiddle_re = calloc(frame_length, sizeof(int32_t));
+    o->twiddle_im = calloc(frame_length, sizeof(int32_t));
+    o->bit_reverse = calloc(frame_length, sizeof(int32_t));
+    o->history = calloc(o->hop, sizeof(int16_t));
+    o->spectrum = calloc(2 * frame_length, sizeof(int32_t));
+    o->a = calloc(frame_length, sizeof(int32_t));
+    o->b = calloc(frame_length, sizeof(int32_t));
+    o->tail = calloc(o->hop, sizeof(int32_t));
+    o->noise = calloc(o->hop + 1, sizeof(float));
+    if (!(o->window_q15) || !(o->window_q31) || !(o->twiddle_re) || !(o->twiddle_im) || !(o->bit_reverse) ||
+        !(o->history) || !(o->spectrum) || !(o->a) || !(o->b) || !(o->tail) || !(o->noise)) {
+        pv_noise_suppressor_delete(o);
+        return PV_NOISE_SUPPRESSOR_STATUS_OUT_OF_MEMORY;
+    }
+
+    for (int32_t i = 0; i < frame_length; i++) {
+        const double w = sin((M_PI * i) / frame_length);
+        o->window_q15[i] = (int16_t) lround(w * 32767.0);
+        o->window_q31[i] = to_q31(w);
+    }
+    for (int32_t half = 1; half < frame_length; half *= 2) {
+        for (int32_t j = 0; j < half; j++) {
+            o->twiddle_re[(half - 1) + j] = to_q31(cos((M_PI * j) / half));
+            o->twiddle_im[(half - 1) + j] = to_q31(-sin((M_PI * j) / half));
+        }
+    }
+    int32_t bits = 0;
+    while ((1 << bits) < frame_length) {
+        bits++;
+    }
+    for (int32_t i = 0; i < frame_length; i++) {
+        int32_t reversed = 0;
+        for (int32_t bit = 0; bit < bits; bit++) {
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        }
+        o->bit_reverse[i] = reversed;
+    }
+
+    *object = o;
+
+    return PV_NOISE_SUPPRESSOR_STATUS_SUCCESS;
+}
+
+void pv_noise_suppressor_delete(pv_noise_suppressor_t *object) {
+    if (object) {
+        free(object->window_q15);
+        free(object->window_q31);
+        free(object->twiddle_re);
+        free(object->twiddle_im);
+        free(object->bit_reverse);
+        free(object->history);
+        free(object->spectrum);
+        free(object->a);
+        free(object->b);
+        free(object->tail);
+        free(object->noise);
+        free(object);
+    }
+}
+
+void pv_noise_suppressor_process(pv_noise_suppressor_t *object, const int16_t *input, int16_t *output) {
+    if (!object || !input || !output) {
+        return;
+    }
+
+    const int32_t hop = object->hop;
+
+    // the first window runs from the middle of the last frame to the middle of this one, the second is this frame
+    window_pair(object, object->history, input, object->window_q15, hop, object->spectrum);
+    window_pair(object, input, input + hop, object->window_q15 + hop, hop, object->spectrum + (2 * hop));
+    memcpy(object->history, input + hop, hop * sizeof(int16_t));
+
+    fft(object, false);
+    suppress(object);
+    fft(object, true);
+    unwindow_pair(object);
+
+    overlap_add(object, object->tail, object->a, output);
+    overlap_add(object, object->a + hop, object->b, output + hop);
+    memcpy(object->tail, object->b + hop, hop * sizeof(int32_t));
+}
+
+int32_t pv_noise_suppressor_get_delay(const pv_noise_suppressor_t *object) {
+    if (!object) {
+        return 0;
+    }
+    return object->hop;
+}
+
+void pv_noise_suppressor_reset(pv_noise_suppressor_t *object) {
+    if (object) {
+        memset(object->history, 0, object->hop * sizeof(int16_t));
+        memset(object->tail, 0, object->hop * sizeof(int32_t));
+        object->is_noise_known = false;
+    }
+}
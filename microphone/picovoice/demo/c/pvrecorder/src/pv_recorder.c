@@ -9,6 +9,11 @@
     specific language governing permissions and limitations under the License.
 */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// pthread_setaffinity_np and the CPU_SET macros
+#define _GNU_SOURCE
+#endif
+
 #pragma GCC diagnostic push
 
 #pragma GCC diagnostic ignored "-Wunused-result"
@@ -19,76 +24,686 @@
 
 #pragma GCC diagnostic pop
 
+#include <stdarg.h>
+
+#include "pv_channel_reducer.h"
 #include "pv_circular_buffer.h"
+#include "pv_decimator.h"
+#include "pv_frame_bus.h"
+#include "pv_level_meter.h"
 #include "pv_recorder.h"
+#include "pv_recorder_probe.h"
+#include "pv_sample_format.h"
+
+#if defined(PV_RECORDER_ALSA_MMAP)
+
+#include "pv_recorder_alsa.h"
+
+#endif
+
+#if defined(PV_RECORDER_SERIAL)
+
+#include "pv_recorder_serial.h"
+
+#endif
+
+#if defined(PV_RECORDER_FILE)
+
+#include "pv_recorder_file.h"
+
+#endif
+
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+
+#include "pv_recorder_devices.h"
+
+#endif
+
+#if !defined(MA_WIN32)
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
 
-static const int32_t READ_RETRY_COUNT = 500;
-static const int32_t READ_SLEEP_MILLI_SECONDS = 2;
+#endif
+
+static const int32_t DEFAULT_READ_TIMEOUT_MILLI_SECONDS = 1000;
 static const int32_t MAX_SILENCE_BUFFER_SIZE = 2 * 16000;
 static const int32_t ABSOLUTE_SILENCE_THRESHOLD = 1;
+static const int32_t OUTPUT_SAMPLE_RATE = 16000;
+// below the lowest voice and any pump hum worth hearing, above a microphone's offset drifting with temperature
+static const float DC_CUTOFF_HZ = 10.0f;
+static const int32_t MAX_REALTIME_PRIORITY = 99;
+// device frames reduced and decimated per pass; divisible by every supported factor
+static const int32_t DECIMATION_CHUNK_LENGTH = 960;
+// miniaudio's own default; one late callback is absorbed without the device buffer becoming the latency
+static const int32_t LATENCY_PROFILE_PERIODS = 3;
+
+typedef struct {
+#if defined(MA_WIN32)
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE cond;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+} pv_recorder_wait_t;
+
+#if defined(MA_WIN32)
+typedef HANDLE pv_recorder_thread_t;
+#else
+typedef pthread_t pv_recorder_thread_t;
+#endif
+
+// One reader's place in the ring. Positions count samples accepted since start; all but the counters read by
+// pv_recorder_get_stats are guarded by the wait lock.
+struct pv_recorder_reader {
+    pv_recorder_t *recorder;
+    int32_t frame_length;
+    int64_t position;
+    int64_t wait_position;
+    int32_t view_length;
+    bool is_active;
+    int64_t frame_count;
+    int64_t discarded_samples;
+    int64_t logged_overflow_samples;
+    pv_level_t level;
+};
 
 struct pv_recorder {
+    pv_recorder_backend_t backend;
     ma_context context;
     ma_device device;
+    ma_device_config device_config;
+    ma_device_id device_id;
+    char *device_name;
+    // guards the miniaudio device against the registry's thread reopening it
+    ma_mutex device_lock;
+    bool is_device_lock_initialized;
+    bool is_capturing;
+    bool is_device_lost;
+    bool is_following_device;
+#if defined(PV_RECORDER_ALSA_MMAP)
+    pv_recorder_alsa_t *alsa;
+#endif
+#if defined(PV_RECORDER_SERIAL)
+    pv_recorder_serial_t *serial;
+#endif
+#if defined(PV_RECORDER_FILE)
+    pv_recorder_file_t *file;
+#endif
     pv_circular_buffer_t *buffer;
+    pv_channel_reducer_t *channel_reducer;
+    int16_t *reduced_samples;
+    pv_decimator_t *decimator;
+    int16_t *decimated_samples;
     int32_t frame_length;
+    int32_t sample_rate;
+    int32_t channels;
+    int32_t realtime_priority;
+    int32_t cpu;
     int32_t current_silent_samples;
+    int32_t read_timeout_msec;
+    pv_recorder_overflow_policy_t overflow_policy;
+    int32_t keep_samples;
+    int32_t block_timeout_msec;
+    bool is_writer_waiting;
+    int16_t *view_frame;
+    // for pv_recorder_read_float and pv_recorder_read_dc_blocked, one filter across both
+    pv_dc_blocker_t dc_blocker;
+    pv_recorder_reader_t primary;
+    pv_recorder_reader_t *readers[1 + PV_RECORDER_MAX_READERS];
+    int32_t reader_count;
+    int64_t tail_samples;
+    int64_t wait_position;
+    int ready_fd;
+    int32_t ready_frames;
+    int64_t ready_position;
+    pv_recorder_frame_callback_t frame_callback;
+    void *frame_callback_user_data;
+    pv_recorder_log_callback_t log_callback;
+    void *log_callback_user_data;
+    pv_frame_bus_t *frame_bus;
+    pv_recorder_thread_t worker;
+    uint32_t anchor_sequence;
+    int64_t anchor_usec;
+    int64_t anchor_samples;
+    int64_t captured_samples;
+    pv_recorder_stats_t stats;
+    int64_t last_callback_usec;
+    int64_t callback_interval_sum_usec;
     bool is_started;
+    bool is_wait_initialized;
+    bool is_worker_running;
     bool log_overflow;
     bool log_silence;
-    ma_mutex mutex;
+    pv_recorder_wait_t wait;
 };
 
-static void pv_recorder_ma_callback(ma_device *device, void *output, const void *input, ma_uint32 frame_count) {
-    (void) output;
+static bool pv_recorder_wait_init(pv_recorder_wait_t *wait) {
+#if defined(MA_WIN32)
+    InitializeCriticalSection(&(wait->lock));
+    InitializeConditionVariable(&(wait->cond));
+    return true;
+#else
+    if (pthread_mutex_init(&(wait->lock), NULL) != 0) {
+        return false;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+#if !defined(__APPLE__)
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    const int rc = pthread_cond_init(&(wait->cond), &attr);
+    pthread_condattr_destroy(&attr);
+    if (rc != 0) {
+        pthread_mutex_destroy(&(wait->lock));
+        return false;
+    }
+    return true;
+#endif
+}
+
+static void pv_recorder_wait_uninit(pv_recorder_wait_t *wait) {
+#if defined(MA_WIN32)
+    DeleteCriticalSection(&(wait->lock));
+#else
+    pthread_cond_destroy(&(wait->cond));
+    pthread_mutex_destroy(&(wait->lock));
+#endif
+}
+
+static void pv_recorder_wait_lock(pv_recorder_wait_t *wait) {
+#if defined(MA_WIN32)
+    EnterCriticalSection(&(wait->lock));
+#else
+    pthread_mutex_lock(&(wait->lock));
+#endif
+}
+
+static void pv_recorder_wait_unlock(pv_recorder_wait_t *wait) {
+#if defined(MA_WIN32)
+    LeaveCriticalSection(&(wait->lock));
+#else
+    pthread_mutex_unlock(&(wait->lock));
+#endif
+}
+
+static void pv_recorder_wait_signal(pv_recorder_wait_t *wait) {
+#if defined(MA_WIN32)
+    WakeAllConditionVariable(&(wait->cond));
+#else
+    pthread_cond_broadcast(&(wait->cond));
+#endif
+}
+
+static int64_t pv_recorder_now_usec(void) {
+#if defined(MA_WIN32)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (int64_t) ((counter.QuadPart / frequency.QuadPart) * 1000000) +
+           (int64_t) (((counter.QuadPart % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+#else
+    struct timespec now;
+#if defined(__APPLE__)
+    clock_gettime(CLOCK_REALTIME, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return ((int64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+#endif
+}
 
-    pv_recorder_t *object = (pv_recorder_t *) device->pUserData;
+static int64_t pv_recorder_now_msec(void) {
+    return pv_recorder_now_usec() / 1000;
+}
 
-    ma_mutex_lock(&object->mutex);
-    pv_circular_buffer_status_t status = pv_circular_buffer_write(object->buffer, input, (int32_t) frame_count);
-    if ((status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW) && (object->log_overflow)) {
-        fprintf(stdout, "[WARN] Overflow - reader is not reading fast enough.\n");
+// Waits on the condition with the lock held. Returns false once `deadline_msec` has passed.
+static bool pv_recorder_wait_until(pv_recorder_wait_t *wait, int64_t deadline_msec) {
+    const int64_t remaining_msec = deadline_msec - pv_recorder_now_msec();
+    if (remaining_msec <= 0) {
+        return false;
     }
+#if defined(MA_WIN32)
+    SleepConditionVariableCS(&(wait->cond), &(wait->lock), (DWORD) remaining_msec);
+#else
+    struct timespec deadline;
+    deadline.tv_sec = (time_t) (deadline_msec / 1000);
+    deadline.tv_nsec = (long) ((deadline_msec % 1000) * 1000000);
+    pthread_cond_timedwait(&(wait->cond), &(wait->lock), &deadline);
+#endif
+    return true;
+}
+
+#if defined(MA_WIN32)
+static DWORD WINAPI pv_recorder_worker_entry(LPVOID arg);
+#else
+static void *pv_recorder_worker_entry(void *arg);
+#endif
 
-    ma_mutex_unlock(&object->mutex);
+static bool pv_recorder_thread_create(pv_recorder_thread_t *thread, void *arg) {
+#if defined(MA_WIN32)
+    *thread = CreateThread(NULL, 0, pv_recorder_worker_entry, arg, 0, NULL);
+    return (*thread != NULL);
+#else
+    return (pthread_create(thread, NULL, pv_recorder_worker_entry, arg) == 0);
+#endif
 }
 
-PV_API pv_recorder_status_t pv_recorder_init(
-        int32_t device_index,
-        int32_t frame_length,
-        int32_t buffer_size_msec,
-        bool log_overflow,
-        bool log_silence,
-        pv_recorder_t **object) {
-    if (device_index < PV_RECORDER_DEFAULT_DEVICE_INDEX) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+// best effort: without the privilege for SCHED_FIFO, or on a CPU that isn't online, the thread is left as it was
+static void pv_recorder_thread_set_scheduling(pv_recorder_thread_t thread, int32_t realtime_priority, int32_t cpu) {
+#if defined(MA_WIN32)
+    (void) thread;
+    (void) realtime_priority;
+    (void) cpu;
+#else
+    if (realtime_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = realtime_priority;
+        pthread_setschedparam(thread, SCHED_FIFO, &param);
     }
-    if (frame_length <= 0) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+#if defined(__linux__)
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread, sizeof(set), &set);
     }
-    if (buffer_size_msec <= 0) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+#else
+    (void) cpu;
+#endif
+#endif
+}
+
+// so the thread can be told apart in top and /proc; Linux allows 15 characters
+static void pv_recorder_thread_set_name(pv_recorder_thread_t thread, const char *name) {
+#if defined(__linux__)
+    pthread_setname_np(thread, name);
+#else
+    (void) thread;
+    (void) name;
+#endif
+}
+
+static void pv_recorder_thread_join(pv_recorder_thread_t thread) {
+#if defined(MA_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Seqlock writer; only the audio callback publishes anchors.
+static void pv_recorder_publish_anchor(pv_recorder_t *object, int64_t usec, int64_t samples) {
+    const uint32_t sequence = __atomic_load_n(&object->anchor_sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->anchor_sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&object->anchor_usec, usec, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->anchor_samples, samples, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->anchor_sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+static void pv_recorder_load_anchor(pv_recorder_t *object, int64_t *usec, int64_t *samples) {
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = __atomic_load_n(&object->anchor_sequence, __ATOMIC_ACQUIRE);
+        *usec = __atomic_load_n(&object->anchor_usec, __ATOMIC_RELAXED);
+        *samples = __atomic_load_n(&object->anchor_samples, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&object->anchor_sequence, __ATOMIC_RELAXED);
+    } while ((before != after) || (before & 1));
+}
+
+// Stats are written by one thread each and read with relaxed atomics, so a snapshot is not mutually consistent.
+static void pv_recorder_stats_store(int64_t *field, int64_t value) {
+    __atomic_store_n(field, value, __ATOMIC_RELAXED);
+}
+
+static int64_t pv_recorder_stats_load(const int64_t *field) {
+    return __atomic_load_n(field, __ATOMIC_RELAXED);
+}
+
+static void pv_recorder_update_callback_stats(
+        pv_recorder_t *object,
+        int64_t now_usec,
+        int64_t frame_count,
+        int64_t overflow_samples) {
+    pv_recorder_stats_t *stats = &(object->stats);
+
+    pv_recorder_stats_store(&stats->total_samples, stats->total_samples + frame_count);
+    pv_recorder_stats_store(&stats->overflow_samples, overflow_samples);
+
+    const int64_t buffered = pv_circular_buffer_get_count(object->buffer);
+    if (buffered > stats->max_buffered_samples) {
+        pv_recorder_stats_store(&stats->max_buffered_samples, buffered);
     }
-    if (!object) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+
+    if (object->last_callback_usec > 0) {
+        const int64_t interval_usec = now_usec - object->last_callback_usec;
+        if ((stats->callback_count == 0) || (interval_usec < stats->min_callback_interval_usec)) {
+            pv_recorder_stats_store(&stats->min_callback_interval_usec, interval_usec);
+        }
+        if (interval_usec > stats->max_callback_interval_usec) {
+            pv_recorder_stats_store(&stats->max_callback_interval_usec, interval_usec);
+        }
+        object->callback_interval_sum_usec += interval_usec;
+        pv_recorder_stats_store(&stats->callback_count, stats->callback_count + 1);
+        pv_recorder_stats_store(
+                &stats->avg_callback_interval_usec,
+                object->callback_interval_sum_usec / stats->callback_count);
     }
+    object->last_callback_usec = now_usec;
+}
 
-    // capacity = 16kHz * seconds
-    const int32_t capacity = (int32_t) ((16000 * buffer_size_msec) / 1000);
-    if (capacity < frame_length) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+// Writes to the file descriptor from `pv_recorder_set_ready_fd`. Eight bytes, as an eventfd takes, which a pipe takes
+// just as well; a full pipe already has a wakeup in it, so a failed write loses nothing.
+static void pv_recorder_write_ready(pv_recorder_t *object) {
+#if !defined(MA_WIN32)
+    const uint64_t one = 1;
+    ssize_t rc = write(object->ready_fd, &one, sizeof(one));
+    (void) rc;
+#else
+    (void) object;
+#endif
+}
+
+// Signals the ready file descriptor once the primary reader has its batch waiting. Whoever clears `ready_position`
+// writes, so it is written once for each time the reader arms it, from either the capture thread or the reader.
+static void pv_recorder_signal_ready(pv_recorder_t *object) {
+    int64_t ready_position = __atomic_load_n(&object->ready_position, __ATOMIC_RELAXED);
+    if ((ready_position > 0) &&
+        (__atomic_load_n(&object->captured_samples, __ATOMIC_RELAXED) >= ready_position) &&
+        __atomic_compare_exchange_n(
+                &object->ready_position,
+                &ready_position,
+                0,
+                false,
+                __ATOMIC_RELAXED,
+                __ATOMIC_RELAXED)) {
+        pv_recorder_write_ready(object);
+    }
+}
+
+static void pv_recorder_notify_reader(pv_recorder_t *object) {
+    // pairs with the fence in `pv_recorder_wait_for_frame` so either a reader sees the new samples or we see it waiting
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    const int64_t wait_position = __atomic_load_n(&object->wait_position, __ATOMIC_RELAXED);
+    if ((wait_position > 0) && (__atomic_load_n(&object->captured_samples, __ATOMIC_RELAXED) >= wait_position)) {
+        pv_recorder_wait_lock(&object->wait);
+        pv_recorder_wait_signal(&object->wait);
+        pv_recorder_wait_unlock(&object->wait);
     }
+    pv_recorder_signal_ready(object);
+}
 
-    *object = NULL;
+// Asks for the ready file descriptor to be signaled once the primary reader, now at `position`, has a batch waiting.
+// The fence pairs with the one in `pv_recorder_notify_reader`, and if the batch is already there the reader signals
+// it itself.
+static void pv_recorder_arm_ready(pv_recorder_t *object, int64_t position) {
+    if (object->ready_fd < 0) {
+        return;
+    }
+    __atomic_store_n(
+            &object->ready_position,
+            position + ((int64_t) object->ready_frames * object->frame_length),
+            __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    pv_recorder_signal_ready(object);
+}
 
-    pv_recorder_t *o = calloc(1, sizeof(pv_recorder_t));
-    if (!o) {
-        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+// Wakes the capture thread if it's waiting for room under PV_RECORDER_OVERFLOW_POLICY_BLOCK.
+static void pv_recorder_notify_writer(pv_recorder_t *object) {
+    if (object->overflow_policy != PV_RECORDER_OVERFLOW_POLICY_BLOCK) {
+        return;
+    }
+    // pairs with the fence in `pv_recorder_wait_for_room`
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&object->is_writer_waiting, __ATOMIC_RELAXED)) {
+        pv_recorder_wait_lock(&object->wait);
+        pv_recorder_wait_signal(&object->wait);
+        pv_recorder_wait_unlock(&object->wait);
+    }
+}
+
+// Waits for the slowest reader to free some of the ring. Returns false once `deadline_msec` has passed or the recorder
+// stops.
+static bool pv_recorder_wait_for_room(pv_recorder_t *object, int64_t deadline_msec) {
+    const int32_t capacity = pv_circular_buffer_get_capacity(object->buffer);
+    bool has_room = true;
+
+    pv_recorder_wait_lock(&object->wait);
+    __atomic_store_n(&object->is_writer_waiting, true, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (pv_circular_buffer_get_count(object->buffer) >= capacity) {
+        if (!(object->is_started) || !pv_recorder_wait_until(&object->wait, deadline_msec)) {
+            has_room = false;
+            break;
+        }
+    }
+    __atomic_store_n(&object->is_writer_waiting, false, __ATOMIC_RELAXED);
+    pv_recorder_wait_unlock(&object->wait);
+
+    return has_room;
+}
+
+// Writes at most the ring's capacity, then makes what was accepted available to the readers.
+static void pv_recorder_write_once(pv_recorder_t *object, const int16_t *samples, int32_t length) {
+    const uint64_t overflow_before = pv_circular_buffer_get_overflow_count(object->buffer);
+    pv_circular_buffer_write(object->buffer, samples, length);
+    const uint64_t overflow_after = pv_circular_buffer_get_overflow_count(object->buffer);
+
+    const int64_t accepted = (int64_t) length - (int64_t) (overflow_after - overflow_before);
+    __atomic_store_n(&object->captured_samples, object->captured_samples + accepted, __ATOMIC_RELEASE);
+}
+
+static void pv_recorder_skip_to(pv_recorder_t *object, int64_t position);
+
+// Makes room for `length` more samples under PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST, so the ring takes the newest
+// audio however long a reader stalls. The readers are skipped to the latest `keep_samples` there will be, which frees
+// half the ring at a time, so the capture thread only takes the lock about once per buffer while a reader is stuck.
+// A frame being viewed keeps its place; if that still leaves too little room, the newest samples are dropped.
+static void pv_recorder_make_room(pv_recorder_t *object, int32_t length) {
+    // only this thread adds samples
+    const int64_t captured_samples = object->captured_samples;
+    const int64_t position = captured_samples + length - object->keep_samples;
+
+    pv_recorder_wait_lock(&object->wait);
+    pv_recorder_skip_to(object, (position < captured_samples) ? position : captured_samples);
+    pv_recorder_wait_unlock(&object->wait);
+}
+
+// Stores 16 kHz samples under the overflow policy. The ring itself only ever drops the newest samples, so blocking
+// waits for room before writing, and dropping the oldest skips the readers ahead before writing.
+static void pv_recorder_write_ring(pv_recorder_t *object, const int16_t *samples, int32_t length) {
+    const int32_t capacity = pv_circular_buffer_get_capacity(object->buffer);
+
+    if (object->overflow_policy == PV_RECORDER_OVERFLOW_POLICY_BLOCK) {
+        const int64_t deadline_msec = pv_recorder_now_msec() + object->block_timeout_msec;
+        while (true) {
+            // only this thread adds samples, so the room can only grow until the write
+            const int32_t room = capacity - pv_circular_buffer_get_count(object->buffer);
+            const int32_t to_write = (room < length) ? room : length;
+            if (to_write > 0) {
+                pv_recorder_write_once(object, samples, to_write);
+                samples += to_write;
+                length -= to_write;
+            }
+            if (length == 0) {
+                return;
+            }
+            // the reader may be waiting for the very samples that filled the ring
+            pv_recorder_notify_reader(object);
+            if (!pv_recorder_wait_for_room(object, deadline_msec)) {
+                break;
+            }
+        }
+    }
+
+    // a device period may be longer than the ring, and what doesn't fit still has to be counted
+    while (length > 0) {
+        const int32_t to_write = (length < capacity) ? length : capacity;
+        if ((object->overflow_policy == PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST) &&
+            ((capacity - pv_circular_buffer_get_count(object->buffer)) < to_write)) {
+            pv_recorder_make_room(object, to_write);
+        }
+        pv_recorder_write_once(object, samples, to_write);
+        samples += to_write;
+        length -= to_write;
+    }
+}
+
+// Writes mono device-rate samples, decimating them to 16 kHz first if needed. Returns the number of 16 kHz samples
+// offered to the ring buffer.
+static int32_t pv_recorder_write_mono(pv_recorder_t *object, const int16_t *input, int32_t length) {
+    if (!(object->decimator)) {
+        pv_recorder_write_ring(object, input, length);
+        return length;
+    }
+
+    const int32_t decimated = pv_decimator_process(object->decimator, input, length, object->decimated_samples);
+    if (decimated > 0) {
+        pv_recorder_write_ring(object, object->decimated_samples, decimated);
+    }
+    return decimated;
+}
+
+// Works through the device buffer in fixed chunks, so the scratch buffers never have to grow on the audio thread.
+// Each chunk is reduced to mono in one pass over the interleaved input and stays in cache for decimation.
+static int32_t pv_recorder_write_chunked(pv_recorder_t *object, const int16_t *input, int32_t frame_count) {
+    const int32_t channels = object->channels;
+
+    int32_t written = 0;
+    while (frame_count > 0) {
+        const int32_t chunk_length = (frame_count < DECIMATION_CHUNK_LENGTH) ? frame_count : DECIMATION_CHUNK_LENGTH;
+        const int16_t *mono = input;
+        if (object->channel_reducer) {
+            pv_channel_reducer_process(object->channel_reducer, input, chunk_length, object->reduced_samples);
+            mono = object->reduced_samples;
+        }
+        written += pv_recorder_write_mono(object, mono, chunk_length);
+        input += chunk_length * channels;
+        frame_count -= chunk_length;
+    }
+    return written;
+}
+
+// Runs on the capture thread of whichever backend is active.
+static void pv_recorder_on_capture(pv_recorder_t *object, const void *input, ma_uint32 device_frame_count) {
+    PV_RECORDER_PROBE2(callback_entry, object, device_frame_count);
+    const int64_t now_usec = pv_recorder_now_usec();
+
+    // the buffer is single-producer/single-consumer, so the audio thread only waits on the reader when told to block.
+    // Overflow is only counted here and reported from the reader side, as I/O doesn't belong on the real-time thread.
+    int32_t frame_count = (int32_t) device_frame_count;
+    if (object->decimator || object->channel_reducer) {
+        frame_count = pv_recorder_write_chunked(object, (const int16_t *) input, frame_count);
+    } else {
+        pv_recorder_write_ring(object, (const int16_t *) input, frame_count);
     }
 
+    // the last accepted sample arrived at the end of this period; publish that pair for frame timestamps
+    pv_recorder_publish_anchor(object, now_usec, object->captured_samples);
+
+    pv_recorder_update_callback_stats(
+            object,
+            now_usec,
+            (int64_t) frame_count,
+            (int64_t) pv_circular_buffer_get_overflow_count(object->buffer));
+
+    pv_recorder_notify_reader(object);
+    PV_RECORDER_PROBE2(callback_return, object, object->captured_samples);
+}
+
+static void pv_recorder_ma_callback(ma_device *device, void *output, const void *input, ma_uint32 frame_count) {
+    (void) output;
+
+#if defined(__linux__)
+    // miniaudio starts the device's thread itself, so it is named from its first callback
+    static __thread bool is_thread_named = false;
+    if (!is_thread_named) {
+        pv_recorder_thread_set_name(pthread_self(), "pvrec-device");
+        is_thread_named = true;
+    }
+#endif
+
+    pv_recorder_on_capture((pv_recorder_t *) device->pUserData, input, frame_count);
+}
+
+#if defined(PV_RECORDER_ALSA_MMAP)
+
+static void pv_recorder_alsa_callback(const int16_t *pcm, int32_t length, void *user_data) {
+    pv_recorder_on_capture((pv_recorder_t *) user_data, pcm, (ma_uint32) length);
+}
+
+#endif
+
+#if defined(PV_RECORDER_SERIAL)
+
+static void pv_recorder_serial_callback(const int16_t *pcm, int32_t length, void *user_data) {
+    pv_recorder_on_capture((pv_recorder_t *) user_data, pcm, (ma_uint32) length);
+}
+
+#endif
+
+#if defined(PV_RECORDER_FILE)
+
+static void pv_recorder_file_callback(const int16_t *pcm, int32_t length, void *user_data) {
+    pv_recorder_on_capture((pv_recorder_t *) user_data, pcm, (ma_uint32) length);
+}
+
+#endif
+
+// Device frames per capture period for a latency profile, or 0 to leave the period to the backend.
+static int32_t pv_recorder_profile_period_length(
+        pv_recorder_latency_profile_t profile,
+        int32_t frame_length,
+        int32_t decimation_factor) {
+    const int32_t device_frame_length = frame_length * decimation_factor;
+    switch (profile) {
+        case PV_RECORDER_LATENCY_PROFILE_LOW_LATENCY:
+            return (device_frame_length > 1) ? (device_frame_length / 2) : 1;
+        case PV_RECORDER_LATENCY_PROFILE_BALANCED:
+            return device_frame_length;
+        case PV_RECORDER_LATENCY_PROFILE_POWER_SAVE:
+            return 4 * device_frame_length;
+        default:
+            return 0;
+    }
+}
+
+// Looks the device up by name on the recorder's context, which enumerates afresh, and keeps its current ID.
+static bool pv_recorder_find_ma_device(pv_recorder_t *o) {
+    ma_device_info *capture_info = NULL;
+    ma_uint32 count = 0;
+    if (ma_context_get_devices(&(o->context), NULL, NULL, &capture_info, &count) != MA_SUCCESS) {
+        return false;
+    }
+    for (ma_uint32 i = 0; i < count; i++) {
+        if (strcmp(capture_info[i].name, o->device_name) == 0) {
+            o->device_id = capture_info[i].id;
+            return true;
+        }
+    }
+    return false;
+}
+
+static pv_recorder_status_t pv_recorder_init_ma_device(
+        pv_recorder_t *o,
+        int32_t device_index,
+        const char *device_name,
+        int32_t sample_rate,
+        int32_t channels,
+        pv_recorder_latency_profile_t latency_profile,
+        int32_t period_length) {
     ma_result result = ma_context_init(NULL, 0, NULL, &(o->context));
     if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
         if ((result == MA_NO_BACKEND) || (result == MA_FAILED_TO_INIT_BACKEND)) {
             return PV_RECORDER_STATUS_BACKEND_ERROR;
         } else if (result == MA_OUT_OF_MEMORY) {
@@ -98,20 +713,43 @@ PV_API pv_recorder_status_t pv_recorder_init(
         }
     }
 
+    if (ma_mutex_init(&(o->device_lock)) != MA_SUCCESS) {
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+    o->is_device_lock_initialized = true;
+
     ma_device_config device_config;
     device_config = ma_device_config_init(ma_device_type_capture);
     device_config.capture.format = ma_format_s16;
-    device_config.capture.channels = 1;
-    device_config.sampleRate = ma_standard_sample_rate_16000;
+    // capture every channel as is; miniaudio would otherwise downmix before the reduction stage sees them
+    device_config.capture.channels = (ma_uint32) channels;
+    // capture at the requested rate so miniaudio doesn't insert its own resampler; decimation to 16 kHz is ours
+    device_config.sampleRate = (ma_uint32) sample_rate;
     device_config.dataCallback = pv_recorder_ma_callback;
     device_config.pUserData = o;
+    if (period_length > 0) {
+        device_config.periodSizeInFrames = (ma_uint32) period_length;
+        device_config.periods = (ma_uint32) LATENCY_PROFILE_PERIODS;
+        // only consulted where a backend sizes its own buffers, e.g. shared-mode WASAPI or AAudio
+        device_config.performanceProfile = (latency_profile == PV_RECORDER_LATENCY_PROFILE_POWER_SAVE) ?
+                                           ma_performance_profile_conservative :
+                                           ma_performance_profile_low_latency;
+    }
 
-    if (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX) {
+    if (device_name) {
+        o->device_name = strdup(device_name);
+        if (!(o->device_name)) {
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+        if (!pv_recorder_find_ma_device(o)) {
+            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
+        device_config.capture.pDeviceID = &(o->device_id);
+    } else if (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX) {
         ma_device_info *capture_info = NULL;
         ma_uint32 count = 0;
         result = ma_context_get_devices(&(o->context), NULL, NULL, &capture_info, &count);
         if (result != MA_SUCCESS) {
-            pv_recorder_delete(o);
             if (result == MA_OUT_OF_MEMORY) {
                 return PV_RECORDER_STATUS_OUT_OF_MEMORY;
             } else {
@@ -119,15 +757,15 @@ PV_API pv_recorder_status_t pv_recorder_init(
             }
         }
         if (device_index >= count) {
-            pv_recorder_delete(o);
             return PV_RECORDER_STATUS_INVALID_ARGUMENT;
         }
-        device_config.capture.pDeviceID = &capture_info[device_index].id;
+        o->device_id = capture_info[device_index].id;
+        device_config.capture.pDeviceID = &(o->device_id);
     }
+    o->device_config = device_config;
 
-    result = ma_device_init(&(o->context), &device_config, &(o->device));
+    result = ma_device_init(&(o->context), &(o->device_config), &(o->device));
     if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
         if (result == MA_DEVICE_ALREADY_INITIALIZED) {
             return PV_RECORDER_STATUS_DEVICE_ALREADY_INITIALIZED;
         } else if (result == MA_OUT_OF_MEMORY) {
@@ -137,143 +775,1459 @@ PV_API pv_recorder_status_t pv_recorder_init(
         }
     }
 
-    result = ma_mutex_init(&(o->mutex));
-    if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
-        if (result == MA_OUT_OF_MEMORY) {
-            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
-        } else {
-            return PV_RECORDER_STATUS_RUNTIME_ERROR;
-        }
-    }
-
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(
-            capacity,
-            sizeof(int16_t),
-            &(o->buffer));
-
-    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
-        pv_recorder_delete(o);
-        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
-    }
-
-    o->frame_length = frame_length;
-    o->log_overflow = log_overflow;
-    o->log_silence = log_silence;
-
-    *object = o;
-
     return PV_RECORDER_STATUS_SUCCESS;
 }
 
-PV_API void pv_recorder_delete(pv_recorder_t *object) {
-    if (object) {
-        ma_device_uninit(&(object->device));
-        ma_context_uninit(&(object->context));
-        ma_mutex_uninit(&(object->mutex));
-        pv_circular_buffer_delete(object->buffer);
-        free(object);
-    }
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+static void pv_recorder_on_devices_changed(void *user_data);
+#endif
+
+PV_API pv_recorder_config_t pv_recorder_default_config(int32_t frame_length) {
+    pv_recorder_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.backend = PV_RECORDER_BACKEND_DEFAULT;
+    config.device_index = PV_RECORDER_DEFAULT_DEVICE_INDEX;
+    config.device_name = NULL;
+    config.alsa_device_name = NULL;
+    config.serial_device_name = NULL;
+    config.serial_baud_rate = 921600;
+    config.file_name = NULL;
+    config.file_speed = 1.f;
+    config.frame_length = frame_length;
+    config.sample_rate = OUTPUT_SAMPLE_RATE;
+    config.channels = 1;
+    config.channel_mode = PV_RECORDER_CHANNEL_MODE_SELECT;
+    config.selected_channel = 0;
+    config.buffer_size_msec = 100;
+    config.overflow_policy = PV_RECORDER_OVERFLOW_POLICY_DROP_NEWEST;
+    config.latency_profile = PV_RECORDER_LATENCY_PROFILE_DEFAULT;
+    config.log_overflow = true;
+    config.log_silence = true;
+    config.realtime_priority = 0;
+    config.cpu = -1;
+    return config;
 }
 
-PV_API pv_recorder_status_t pv_recorder_start(pv_recorder_t *object) {
-    if (!object) {
+PV_API pv_recorder_status_t pv_recorder_init_with_config(const pv_recorder_config_t *config, pv_recorder_t **object) {
+    if (!config) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    ma_result result = ma_device_start(&(object->device));
-    if (result != MA_SUCCESS) {
-        if (result == MA_DEVICE_NOT_INITIALIZED) {
-            return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
-        } else {
-            // device already started
-            return PV_RECORDER_STATUS_INVALID_STATE;
-        }
+    if ((config->backend != PV_RECORDER_BACKEND_DEFAULT) &&
+        (config->backend != PV_RECORDER_BACKEND_ALSA_MMAP) &&
+        (config->backend != PV_RECORDER_BACKEND_SERIAL) &&
+        (config->backend != PV_RECORDER_BACKEND_FILE)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    object->is_started = true;
-
-    return PV_RECORDER_STATUS_SUCCESS;
-}
-
-PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object) {
-    if (!object) {
+    if (config->device_index < PV_RECORDER_DEFAULT_DEVICE_INDEX) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    ma_result result = ma_device_stop(&(object->device));
-    if (result != MA_SUCCESS) {
-        if (result == MA_DEVICE_NOT_INITIALIZED) {
-            return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
-        } else {
-            // device already stopped
-            return PV_RECORDER_STATUS_INVALID_STATE;
-        }
+    if (config->frame_length <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    pv_circular_buffer_reset(object->buffer);
-    object->is_started = false;
-
-    return PV_RECORDER_STATUS_SUCCESS;
-}
-
-PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *pcm) {
-    if (!object) {
+    if ((config->sample_rate != OUTPUT_SAMPLE_RATE) &&
+        (config->sample_rate != (2 * OUTPUT_SAMPLE_RATE)) &&
+        (config->sample_rate != (3 * OUTPUT_SAMPLE_RATE))) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (!pcm) {
+    if ((config->channels < 1) || (config->channels > PV_RECORDER_MAX_CHANNELS)) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (!(object->is_started)) {
-        return PV_RECORDER_STATUS_INVALID_STATE;
+    if (((config->backend == PV_RECORDER_BACKEND_SERIAL) || (config->backend == PV_RECORDER_BACKEND_FILE)) &&
+        ((config->sample_rate != OUTPUT_SAMPLE_RATE) || (config->channels != 1))) {
+        // the co-processor already sends what the reader gets, and a recording is already what it was recorded as
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (config->buffer_size_msec <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((config->overflow_policy != PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST) &&
+        (config->overflow_policy != PV_RECORDER_OVERFLOW_POLICY_DROP_NEWEST) &&
+        (config->overflow_policy != PV_RECORDER_OVERFLOW_POLICY_BLOCK)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((config->latency_profile != PV_RECORDER_LATENCY_PROFILE_DEFAULT) &&
+        (config->latency_profile != PV_RECORDER_LATENCY_PROFILE_LOW_LATENCY) &&
+        (config->latency_profile != PV_RECORDER_LATENCY_PROFILE_BALANCED) &&
+        (config->latency_profile != PV_RECORDER_LATENCY_PROFILE_POWER_SAVE)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((config->realtime_priority < 0) || (config->realtime_priority > MAX_REALTIME_PRIORITY)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (config->cpu < -1) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
 
-    int16_t *read_ptr = pcm;
-    int32_t processed = 0;
-    int32_t remaining = object->frame_length;
-
-    for (int32_t i = 0; i < READ_RETRY_COUNT; i++) {
-        ma_mutex_lock(&object->mutex);
-
-        const int32_t length = pv_circular_buffer_read(object->buffer, read_ptr, remaining);
-        processed += length;
-
-        if (processed == object->frame_length) {
-            ma_mutex_unlock(&object->mutex);
+    const int32_t frame_length = config->frame_length;
+    const int32_t decimation_factor = config->sample_rate / OUTPUT_SAMPLE_RATE;
+    const int32_t period_length = pv_recorder_profile_period_length(
+            config->latency_profile,
+            frame_length,
+            decimation_factor);
 
-            if (object->log_silence) {
-                for (int32_t j = 0; j < object->frame_length; j++) {
-                    if ((pcm[j] > ABSOLUTE_SILENCE_THRESHOLD) || (pcm[j] < -ABSOLUTE_SILENCE_THRESHOLD)) {
-                        object->current_silent_samples = 0;
-                        return PV_RECORDER_STATUS_SUCCESS;
-                    }
-                }
-                object->current_silent_samples += object->frame_length;
+    // capacity = 16kHz * seconds
+    const int32_t capacity = (int32_t) ((OUTPUT_SAMPLE_RATE * config->buffer_size_msec) / 1000);
+    if (capacity < frame_length) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    // dropping the oldest audio is the readers' job, so the ring has room for a second buffer they then skip
+    const bool is_drop_oldest = (config->overflow_policy == PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST);
+    const int32_t ring_capacity = is_drop_oldest ? (2 * capacity) : capacity;
+
+#if !defined(PV_RECORDER_ALSA_MMAP)
+    if (config->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+#endif
+#if !defined(PV_RECORDER_SERIAL)
+    if (config->backend == PV_RECORDER_BACKEND_SERIAL) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+#endif
+#if !defined(PV_RECORDER_FILE)
+    if (config->backend == PV_RECORDER_BACKEND_FILE) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+#endif
+
+    *object = NULL;
+
+    pv_recorder_t *o = calloc(1, sizeof(pv_recorder_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->backend = config->backend;
+    o->sample_rate = config->sample_rate;
+    o->channels = config->channels;
+    o->realtime_priority = config->realtime_priority;
+    o->cpu = config->cpu;
+
+    pv_recorder_status_t recorder_status = PV_RECORDER_STATUS_SUCCESS;
+    if (o->backend == PV_RECORDER_BACKEND_DEFAULT) {
+        recorder_status = pv_recorder_init_ma_device(
+                o,
+                config->device_index,
+                config->device_name,
+                config->sample_rate,
+                config->channels,
+                config->latency_profile,
+                period_length);
+    }
+#if defined(PV_RECORDER_ALSA_MMAP)
+    else if (o->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        // by default one ALSA period per frame, so each wakeup hands the reader exactly what it waits for
+        recorder_status = pv_recorder_alsa_init(
+                config->alsa_device_name,
+                config->sample_rate,
+                config->channels,
+                (period_length > 0) ? period_length : (frame_length * decimation_factor),
+                pv_recorder_alsa_callback,
+                o,
+                &(o->alsa));
+    }
+#endif
+#if defined(PV_RECORDER_SERIAL)
+    else if (o->backend == PV_RECORDER_BACKEND_SERIAL) {
+        recorder_status = pv_recorder_serial_init(
+                config->serial_device_name,
+                config->serial_baud_rate,
+                pv_recorder_serial_callback,
+                o,
+                &(o->serial));
+    }
+#endif
+#if defined(PV_RECORDER_FILE)
+    else if (o->backend == PV_RECORDER_BACKEND_FILE) {
+        recorder_status = pv_recorder_file_init(
+                config->file_name,
+                config->file_speed,
+                pv_recorder_file_callback,
+                o,
+                &(o->file));
+    }
+#endif
+    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_delete(o);
+        return recorder_status;
+    }
+
+    if (!pv_recorder_wait_init(&(o->wait))) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+    o->is_wait_initialized = true;
+
+    // a mirrored ring makes every frame contiguous for pv_recorder_read_view; fall back where it isn't available
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_mirrored(
+            ring_capacity,
+            sizeof(int16_t),
+            &(o->buffer));
+    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        status = pv_circular_buffer_init_spsc(
+                ring_capacity,
+                sizeof(int16_t),
+                &(o->buffer));
+    }
+
+    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->view_frame = malloc(frame_length * sizeof(int16_t));
+    if (!(o->view_frame)) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    if (config->channels > 1) {
+        pv_channel_reducer_mode_t mode = PV_CHANNEL_REDUCER_MODE_SELECT;
+        if (config->channel_mode == PV_RECORDER_CHANNEL_MODE_AVERAGE) {
+            mode = PV_CHANNEL_REDUCER_MODE_AVERAGE;
+        } else if (config->channel_mode == PV_RECORDER_CHANNEL_MODE_DELAY_AND_SUM) {
+            mode = PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM;
+        } else if (config->channel_mode != PV_RECORDER_CHANNEL_MODE_SELECT) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
+
+        pv_channel_reducer_status_t reducer_status = pv_channel_reducer_init(
+                config->channels,
+                mode,
+                config->selected_channel,
+                config->channel_delays,
+                &(o->channel_reducer));
+        if (reducer_status != PV_CHANNEL_REDUCER_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return (reducer_status == PV_CHANNEL_REDUCER_STATUS_OUT_OF_MEMORY) ?
+                   PV_RECORDER_STATUS_OUT_OF_MEMORY :
+                   PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
+        o->reduced_samples = malloc(DECIMATION_CHUNK_LENGTH * sizeof(int16_t));
+        if (!(o->reduced_samples)) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    if (decimation_factor > 1) {
+        if (pv_decimator_init(decimation_factor, &(o->decimator)) != PV_DECIMATOR_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+        const int32_t max_length = pv_decimator_get_max_output_length(o->decimator, DECIMATION_CHUNK_LENGTH);
+        o->decimated_samples = malloc(max_length * sizeof(int16_t));
+        if (!(o->decimated_samples)) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    o->frame_length = frame_length;
+    o->primary.recorder = o;
+    o->primary.frame_length = frame_length;
+    o->readers[0] = &(o->primary);
+    o->reader_count = 1;
+    o->read_timeout_msec = DEFAULT_READ_TIMEOUT_MILLI_SECONDS;
+    o->ready_fd = -1;
+    o->overflow_policy = config->overflow_policy;
+    // the ring may have been rounded up; each reader keeps what fits in half of it
+    o->keep_samples = is_drop_oldest ?
+                      (pv_circular_buffer_get_capacity(o->buffer) / 2) :
+                      pv_circular_buffer_get_capacity(o->buffer);
+    // a recording has no device buffer to overrun, so under PV_RECORDER_OVERFLOW_POLICY_BLOCK it waits for the readers
+    // however long they take, and a replay loses nothing to a slow consumer
+    o->block_timeout_msec = (config->backend == PV_RECORDER_BACKEND_FILE) ? INT32_MAX : config->buffer_size_msec;
+    o->log_overflow = config->log_overflow;
+    o->log_silence = config->log_silence;
+
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+    if (o->device_name) {
+        recorder_status = pv_recorder_devices_add_listener(pv_recorder_on_devices_changed, o);
+        if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return recorder_status;
+        }
+        o->is_following_device = true;
+    }
+#endif
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_init(
+        int32_t device_index,
+        int32_t frame_length,
+        int32_t buffer_size_msec,
+        bool log_overflow,
+        bool log_silence,
+        pv_recorder_t **object) {
+    pv_recorder_config_t config = pv_recorder_default_config(frame_length);
+    config.device_index = device_index;
+    config.buffer_size_msec = buffer_size_msec;
+    config.log_overflow = log_overflow;
+    config.log_silence = log_silence;
+
+    return pv_recorder_init_with_config(&config, object);
+}
+
+static pv_recorder_status_t pv_recorder_start_device(pv_recorder_t *object) {
+#if defined(PV_RECORDER_ALSA_MMAP)
+    if (object->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        const pv_recorder_status_t status = pv_recorder_alsa_start(object->alsa);
+        if (status == PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_thread_set_name(pv_recorder_alsa_get_thread(object->alsa), "pvrec-alsa");
+            // the capture thread has to keep up with the hardware ring as much as the worker with ours
+            pv_recorder_thread_set_scheduling(
+                    pv_recorder_alsa_get_thread(object->alsa),
+                    object->realtime_priority,
+                    object->cpu);
+        }
+        return status;
+    }
+#endif
+#if defined(PV_RECORDER_SERIAL)
+    if (object->backend == PV_RECORDER_BACKEND_SERIAL) {
+        const pv_recorder_status_t status = pv_recorder_serial_start(object->serial);
+        if (status == PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_thread_set_name(pv_recorder_serial_get_thread(object->serial), "pvrec-serial");
+            pv_recorder_thread_set_scheduling(
+                    pv_recorder_serial_get_thread(object->serial),
+                    object->realtime_priority,
+                    object->cpu);
+        }
+        return status;
+    }
+#endif
+#if defined(PV_RECORDER_FILE)
+    if (object->backend == PV_RECORDER_BACKEND_FILE) {
+        const pv_recorder_status_t status = pv_recorder_file_start(object->file);
+        if (status == PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_thread_set_name(pv_recorder_file_get_thread(object->file), "pvrec-file");
+            pv_recorder_thread_set_scheduling(
+                    pv_recorder_file_get_thread(object->file),
+                    object->realtime_priority,
+                    object->cpu);
+        }
+        return status;
+    }
+#endif
+
+    ma_mutex_lock(&(object->device_lock));
+    // a device that is unplugged starts capturing once it is back
+    ma_result result = object->is_device_lost ? MA_SUCCESS : ma_device_start(&(object->device));
+    object->is_capturing = (result == MA_SUCCESS);
+    ma_mutex_unlock(&(object->device_lock));
+    if (result != MA_SUCCESS) {
+        if (result == MA_DEVICE_NOT_INITIALIZED) {
+            return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
+        } else {
+            // device already started
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+static pv_recorder_status_t pv_recorder_stop_device(pv_recorder_t *object) {
+#if defined(PV_RECORDER_ALSA_MMAP)
+    if (object->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        return pv_recorder_alsa_stop(object->alsa);
+    }
+#endif
+#if defined(PV_RECORDER_SERIAL)
+    if (object->backend == PV_RECORDER_BACKEND_SERIAL) {
+        return pv_recorder_serial_stop(object->serial);
+    }
+#endif
+#if defined(PV_RECORDER_FILE)
+    if (object->backend == PV_RECORDER_BACKEND_FILE) {
+        return pv_recorder_file_stop(object->file);
+    }
+#endif
+
+    ma_mutex_lock(&(object->device_lock));
+    ma_result result = object->is_device_lost ? MA_SUCCESS : ma_device_stop(&(object->device));
+    if (result == MA_SUCCESS) {
+        object->is_capturing = false;
+    }
+    ma_mutex_unlock(&(object->device_lock));
+    if (result != MA_SUCCESS) {
+        if (result == MA_DEVICE_NOT_INITIALIZED) {
+            return PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED;
+        } else {
+            // device already stopped
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+static void pv_recorder_stop_worker(pv_recorder_t *object) {
+    pv_recorder_wait_lock(&object->wait);
+    object->is_started = false;
+    pv_recorder_wait_signal(&object->wait);
+    pv_recorder_wait_unlock(&object->wait);
+
+    if (object->is_worker_running) {
+        pv_recorder_thread_join(object->worker);
+        object->is_worker_running = false;
+    }
+}
+
+PV_API void pv_recorder_delete(pv_recorder_t *object) {
+    if (object) {
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+        if (object->is_following_device) {
+            pv_recorder_devices_remove_listener(pv_recorder_on_devices_changed, object);
+        }
+#endif
+        if (object->is_worker_running) {
+            pv_recorder_stop_device(object);
+            pv_recorder_stop_worker(object);
+        }
+        if (object->backend == PV_RECORDER_BACKEND_DEFAULT) {
+            ma_device_uninit(&(object->device));
+            ma_context_uninit(&(object->context));
+        }
+        if (object->is_device_lock_initialized) {
+            ma_mutex_uninit(&(object->device_lock));
+        }
+        free(object->device_name);
+#if defined(PV_RECORDER_ALSA_MMAP)
+        pv_recorder_alsa_delete(object->alsa);
+#endif
+#if defined(PV_RECORDER_SERIAL)
+        pv_recorder_serial_delete(object->serial);
+#endif
+#if defined(PV_RECORDER_FILE)
+        pv_recorder_file_delete(object->file);
+#endif
+        if (object->is_wait_initialized) {
+            pv_recorder_wait_uninit(&(object->wait));
+        }
+        pv_circular_buffer_delete(object->buffer);
+        pv_channel_reducer_delete(object->channel_reducer);
+        free(object->reduced_samples);
+        pv_decimator_delete(object->decimator);
+        free(object->decimated_samples);
+        free(object->view_frame);
+        for (int32_t i = 1; i < object->reader_count; i++) {
+            free(object->readers[i]);
+        }
+        pv_frame_bus_delete(object->frame_bus);
+        free(object);
+    }
+}
+
+static bool pv_recorder_is_push_mode(const pv_recorder_t *object) {
+    return (object->frame_callback != NULL) || (object->frame_bus != NULL);
+}
+
+static void pv_recorder_reset_counters(pv_recorder_t *object) {
+    object->captured_samples = 0;
+    object->tail_samples = 0;
+    object->wait_position = 0;
+    object->ready_position = 0;
+    for (int32_t i = 0; i < object->reader_count; i++) {
+        pv_recorder_reader_t *reader = object->readers[i];
+        reader->position = 0;
+        reader->wait_position = 0;
+        reader->view_length = 0;
+        reader->is_active = true;
+        reader->frame_count = 0;
+        reader->discarded_samples = 0;
+        reader->logged_overflow_samples = 0;
+        memset(&(reader->level), 0, sizeof(reader->level));
+    }
+    // in pull mode the primary reader might never be read, so it only holds the ring once it is
+    object->primary.is_active = pv_recorder_is_push_mode(object);
+    object->last_callback_usec = 0;
+    object->callback_interval_sum_usec = 0;
+    memset(&(object->stats), 0, sizeof(object->stats));
+    pv_recorder_publish_anchor(object, 0, 0);
+    pv_channel_reducer_reset(object->channel_reducer);
+    pv_decimator_reset(object->decimator);
+}
+
+PV_API pv_recorder_status_t pv_recorder_start(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    // nothing writes the counters while the device is stopped
+    pv_recorder_reset_counters(object);
+    pv_sample_format_init_dc_blocker(OUTPUT_SAMPLE_RATE, DC_CUTOFF_HZ, &(object->dc_blocker));
+
+    pv_recorder_status_t status = pv_recorder_start_device(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    object->is_started = true;
+
+    if (!pv_recorder_is_push_mode(object)) {
+        pv_recorder_arm_ready(object, 0);
+    }
+
+    if (pv_recorder_is_push_mode(object)) {
+        if (!pv_recorder_thread_create(&(object->worker), object)) {
+            pv_recorder_stop_device(object);
+            object->is_started = false;
+            pv_circular_buffer_reset(object->buffer);
+            return PV_RECORDER_STATUS_RUNTIME_ERROR;
+        }
+        object->is_worker_running = true;
+        pv_recorder_thread_set_name(object->worker, "pvrec-worker");
+        pv_recorder_thread_set_scheduling(object->worker, object->realtime_priority, object->cpu);
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_status_t status = pv_recorder_stop_device(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_recorder_stop_worker(object);
+
+    // a reader waiting on the ready file descriptor wakes to find the recorder stopped
+    if (object->ready_fd >= 0) {
+        __atomic_store_n(&object->ready_position, 0, __ATOMIC_RELAXED);
+        pv_recorder_write_ready(object);
+    }
+
+    pv_circular_buffer_reset(object->buffer);
+    object->primary.view_length = 0;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+// Warnings go to the log callback if there is one, so a slow stdout never holds up the thread that raised them.
+static void pv_recorder_log_warning(pv_recorder_t *object, const char *format, ...) {
+    char message[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (object->log_callback) {
+        object->log_callback(message, object->log_callback_user_data);
+    } else {
+        fprintf(stdout, "[WARN] %s\n", message);
+    }
+}
+
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+
+// Opens the device again under the same name, which may now have another ID, and resumes capture if it was running.
+static bool pv_recorder_reopen_ma_device(pv_recorder_t *object) {
+    ma_device_uninit(&(object->device));
+    if (!pv_recorder_find_ma_device(object)) {
+        return false;
+    }
+    if (ma_device_init(&(object->context), &(object->device_config), &(object->device)) != MA_SUCCESS) {
+        return false;
+    }
+    // no callback runs until the device is started, so the filters can start over from here
+    pv_channel_reducer_reset(object->channel_reducer);
+    pv_decimator_reset(object->decimator);
+    return !(object->is_capturing) || (ma_device_start(&(object->device)) == MA_SUCCESS);
+}
+
+// Called from the registry's thread after devices came or went. While the device is unplugged it stays closed, rather
+// than a sound server quietly moving the stream to another microphone, and once it is back it is opened again. The
+// ring and the readers carry on across the gap, which shows as a jump in frame timestamps.
+static void pv_recorder_on_devices_changed(void *user_data) {
+    pv_recorder_t *object = (pv_recorder_t *) user_data;
+
+    ma_mutex_lock(&(object->device_lock));
+    if (!pv_recorder_find_ma_device(object)) {
+        if (!(object->is_device_lost)) {
+            ma_device_uninit(&(object->device));
+            object->is_device_lost = true;
+            pv_recorder_log_warning(object, "Audio device '%s' was removed.", object->device_name);
+        }
+    } else if (object->is_device_lost ||
+               (object->is_capturing && (ma_device_get_state(&(object->device)) != ma_device_state_started))) {
+        // a device replugged between two notifications is present both times but its old handle is dead
+        object->is_device_lost = !pv_recorder_reopen_ma_device(object);
+        if (!(object->is_device_lost)) {
+            pv_recorder_log_warning(object, "Audio device '%s' was reattached.", object->device_name);
+        }
+    }
+    ma_mutex_unlock(&(object->device_lock));
+}
+
+#endif
+
+// Samples a reader never gets: those the ring had no room for and those skipped to drop the oldest.
+static int64_t pv_recorder_get_dropped_samples(pv_recorder_t *object, const pv_recorder_reader_t *reader) {
+    return (int64_t) pv_circular_buffer_get_overflow_count(object->buffer) +
+           __atomic_load_n(&reader->discarded_samples, __ATOMIC_RELAXED);
+}
+
+// The capture thread wakes the readers once it reaches the nearest position one of them waits for. Called with the
+// wait lock held, as are the other functions that touch reader positions.
+static void pv_recorder_update_wait_position(pv_recorder_t *object) {
+    int64_t wait_position = 0;
+    for (int32_t i = 0; i < object->reader_count; i++) {
+        const int64_t position = object->readers[i]->wait_position;
+        if ((position > 0) && ((wait_position == 0) || (position < wait_position))) {
+            wait_position = position;
+        }
+    }
+    __atomic_store_n(&object->wait_position, wait_position, __ATOMIC_RELAXED);
+}
+
+// Hands the ring up to the slowest active reader back to the capture thread.
+static void pv_recorder_release_tail(pv_recorder_t *object) {
+    int64_t tail = -1;
+    for (int32_t i = 0; i < object->reader_count; i++) {
+        const pv_recorder_reader_t *reader = object->readers[i];
+        if (reader->is_active && ((tail < 0) || (reader->position < tail))) {
+            tail = reader->position;
+        }
+    }
+
+    if (tail > object->tail_samples) {
+        pv_circular_buffer_consume(object->buffer, (int32_t) (tail - object->tail_samples));
+        object->tail_samples = tail;
+    }
+}
+
+// Skips every active reader that isn't viewing a frame and is behind `position` up to it, and the tail with them. With
+// no active reader the tail alone moves, so the primary reader joins at the audio that was kept.
+static void pv_recorder_skip_to(pv_recorder_t *object, int64_t position) {
+    bool is_any_active = false;
+    for (int32_t i = 0; i < object->reader_count; i++) {
+        pv_recorder_reader_t *reader = object->readers[i];
+        if (!(reader->is_active)) {
+            continue;
+        }
+        is_any_active = true;
+        const int64_t excess = position - reader->position;
+        if ((reader->view_length == 0) && (excess > 0)) {
+            reader->position += excess;
+            __atomic_store_n(&reader->discarded_samples, reader->discarded_samples + excess, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (is_any_active) {
+        pv_recorder_release_tail(object);
+    } else if (position > object->tail_samples) {
+        pv_circular_buffer_consume(object->buffer, (int32_t) (position - object->tail_samples));
+        object->tail_samples = position;
+    }
+}
+
+// Under PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST, skips every reader that has fallen behind to the latest
+// `keep_samples`. Readers only take whole frames and a viewed frame is never skipped, so a frame never spans a gap.
+static void pv_recorder_drop_oldest(pv_recorder_t *object) {
+    if (object->overflow_policy != PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST) {
+        return;
+    }
+
+    const int64_t captured_samples = __atomic_load_n(&object->captured_samples, __ATOMIC_ACQUIRE);
+    pv_recorder_skip_to(object, captured_samples - object->keep_samples);
+}
+
+// Points at `length` samples starting `offset` samples past the tail of the ring. They are only assembled in
+// `scratch` if they straddle the end of a ring that isn't mirrored.
+static const int16_t *pv_recorder_locate(pv_recorder_t *object, int32_t offset, int32_t length, int16_t *scratch) {
+    const void *first = NULL;
+    const void *second = NULL;
+    int32_t first_length = 0;
+    int32_t second_length = 0;
+    pv_circular_buffer_peek(object->buffer, offset + length, &first, &first_length, &second, &second_length);
+
+    if ((offset + length) <= first_length) {
+        return (const int16_t *) first + offset;
+    }
+    if (offset >= first_length) {
+        return (const int16_t *) second + (offset - first_length);
+    }
+
+    const int32_t head_length = first_length - offset;
+    memcpy(scratch, (const int16_t *) first + offset, head_length * sizeof(int16_t));
+    memcpy(scratch + head_length, second, (length - head_length) * sizeof(int16_t));
+    return scratch;
+}
+
+static void pv_recorder_complete_frame(pv_recorder_t *object, pv_recorder_reader_t *reader) {
+    reader->frame_count++;
+
+    const int64_t overflow_samples = pv_recorder_get_dropped_samples(object, reader);
+    if (overflow_samples != reader->logged_overflow_samples) {
+        if (object->log_overflow) {
+            pv_recorder_log_warning(object, "Overflow - reader is not reading fast enough.");
+        }
+        reader->logged_overflow_samples = overflow_samples;
+    }
+}
+
+static pv_recorder_status_t pv_recorder_wait_for_frame(
+        pv_recorder_t *object,
+        pv_recorder_reader_t *reader,
+        int64_t deadline_msec) {
+    bool is_timed_out = false;
+    const int64_t wait_start_usec = pv_recorder_now_usec();
+    PV_RECORDER_PROBE2(read_wait_entry, object, reader->position + reader->frame_length);
+
+    while (object->is_started) {
+        // another reader may skip this one ahead while it waits, so the target is worked out afresh each time
+        reader->wait_position = reader->position + reader->frame_length;
+        pv_recorder_update_wait_position(object);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&object->captured_samples, __ATOMIC_ACQUIRE) >= reader->wait_position) {
+            break;
+        }
+        if (!pv_recorder_wait_until(&object->wait, deadline_msec)) {
+            is_timed_out = true;
+            break;
+        }
+    }
+    reader->wait_position = 0;
+    pv_recorder_update_wait_position(object);
+
+    const int64_t wait_usec = pv_recorder_now_usec() - wait_start_usec;
+    pv_recorder_stats_store(&object->stats.total_read_wait_usec, object->stats.total_read_wait_usec + wait_usec);
+    if (wait_usec > object->stats.max_read_wait_usec) {
+        pv_recorder_stats_store(&object->stats.max_read_wait_usec, wait_usec);
+    }
+    PV_RECORDER_PROBE3(read_wait_return, object, wait_usec, is_timed_out);
+
+    if (!(object->is_started)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (is_timed_out) {
+        return PV_RECORDER_STATUS_IO_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+// Takes the reader's next frame, waiting for it first, and returns the position of its first sample. With `pcm` the
+// frame is copied out along with as many of the whole frames after it as are already there, up to `max_frames`, and
+// the reader moves past them; otherwise `view` points at the one frame, which stays in the ring until
+// `pv_recorder_finish_view`.
+static pv_recorder_status_t pv_recorder_take_frames(
+        pv_recorder_t *object,
+        pv_recorder_reader_t *reader,
+        int16_t *pcm,
+        int32_t max_frames,
+        const int16_t **view,
+        int64_t *first_sample,
+        int32_t *frames) {
+    const int64_t deadline_msec = pv_recorder_now_msec() + object->read_timeout_msec;
+
+    pv_recorder_wait_lock(&object->wait);
+    if (!(reader->is_active)) {
+        // the primary reader joins on its first read, at the oldest audio still held for the others
+        reader->position = object->tail_samples;
+        reader->is_active = true;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object, reader, deadline_msec);
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_drop_oldest(object);
+
+        const int32_t offset = (int32_t) (reader->position - object->tail_samples);
+        *first_sample = reader->position;
+        if (pcm) {
+            const int64_t available = __atomic_load_n(&object->captured_samples, __ATOMIC_ACQUIRE) - reader->position;
+            *frames = (int32_t) (available / reader->frame_length);
+            if (*frames > max_frames) {
+                *frames = max_frames;
+            }
+            const int32_t length = *frames * reader->frame_length;
+            const int16_t *samples = pv_recorder_locate(object, offset, length, pcm);
+            if (samples != pcm) {
+                memcpy(pcm, samples, length * sizeof(int16_t));
+            }
+            reader->position += length;
+            pv_recorder_release_tail(object);
+        } else {
+            *view = pv_recorder_locate(object, offset, reader->frame_length, object->view_frame);
+            reader->view_length = reader->frame_length;
+            *frames = 1;
+        }
+    }
+    pv_recorder_wait_unlock(&object->wait);
+
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_notify_writer(object);
+    }
+
+    return status;
+}
+
+// Meters every frame once, for the frame info and the muted-microphone warning alike.
+static void pv_recorder_measure_frame(pv_recorder_t *object, pv_recorder_reader_t *reader, const int16_t *pcm) {
+    pv_level_meter_measure(pcm, reader->frame_length, &(reader->level));
+
+    // the other readers get the same audio, so only the primary one warns
+    if (!(object->log_silence) || (reader != &(object->primary))) {
+        return;
+    }
+
+    if (reader->level.peak > ABSOLUTE_SILENCE_THRESHOLD) {
+        object->current_silent_samples = 0;
+        return;
+    }
+    object->current_silent_samples += reader->frame_length;
+
+    if (object->current_silent_samples >= MAX_SILENCE_BUFFER_SIZE) {
+        pv_recorder_log_warning(object, "Input device might be muted or volume level is set to 0.");
+        object->current_silent_samples = 0;
+    }
+}
+
+static pv_recorder_status_t pv_recorder_read_frames_from(
+        pv_recorder_t *object,
+        pv_recorder_reader_t *reader,
+        int16_t *pcm,
+        int32_t max_frames,
+        int64_t *first_sample,
+        int32_t *frames) {
+    pv_recorder_status_t status = pv_recorder_take_frames(object, reader, pcm, max_frames, NULL, first_sample, frames);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    for (int32_t i = 0; i < *frames; i++) {
+        pv_recorder_complete_frame(object, reader);
+        pv_recorder_measure_frame(object, reader, pcm + ((size_t) i * reader->frame_length));
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+static pv_recorder_status_t pv_recorder_read_primary(
+        pv_recorder_t *object,
+        int16_t *pcm,
+        int32_t max_frames,
+        int64_t *first_sample,
+        int32_t *frames) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_started)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if ((object->primary.view_length > 0) || pv_recorder_is_push_mode(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_read_frames_from(
+            object,
+            &(object->primary),
+            pcm,
+            max_frames,
+            first_sample,
+            frames);
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_arm_ready(object, *first_sample + ((int64_t) *frames * object->frame_length));
+    }
+    return status;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *pcm) {
+    int64_t first_sample = 0;
+    int32_t frames = 0;
+    return pv_recorder_read_primary(object, pcm, 1, &first_sample, &frames);
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_frames(pv_recorder_t *object, int16_t *pcm, int32_t num_frames) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm || (num_frames <= 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    // whatever is already buffered comes in one go, so only the frames still to arrive cost a wait each
+    int32_t frames_done = 0;
+    while (frames_done < num_frames) {
+        int64_t first_sample = 0;
+        int32_t frames = 0;
+        pv_recorder_status_t status = pv_recorder_read_primary(
+                object,
+                pcm + ((size_t) frames_done * object->frame_length),
+                num_frames - frames_done,
+                &first_sample,
+                &frames);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            return status;
+        }
+        frames_done += frames;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_available(
+        pv_recorder_t *object,
+        int16_t *pcm,
+        int32_t max_frames,
+        int32_t *frames_read) {
+    if (!frames_read || (max_frames <= 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *frames_read = 0;
+    int64_t first_sample = 0;
+    return pv_recorder_read_primary(object, pcm, max_frames, &first_sample, frames_read);
+}
+
+static pv_recorder_status_t pv_recorder_acquire_view(
+        pv_recorder_t *object,
+        const int16_t **pcm,
+        int64_t *first_sample) {
+    int32_t frames = 0;
+    pv_recorder_status_t status = pv_recorder_take_frames(
+            object,
+            &(object->primary),
+            NULL,
+            1,
+            pcm,
+            first_sample,
+            &frames);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_recorder_measure_frame(object, &(object->primary), *pcm);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+// Moves the primary reader past the frame it viewed, so its room in the ring can be reused.
+static void pv_recorder_finish_view(pv_recorder_t *object) {
+    pv_recorder_reader_t *primary = &(object->primary);
+
+    pv_recorder_wait_lock(&object->wait);
+    primary->position += primary->view_length;
+    primary->view_length = 0;
+    pv_recorder_release_tail(object);
+    pv_recorder_wait_unlock(&object->wait);
+
+    pv_recorder_notify_writer(object);
+    pv_recorder_complete_frame(object, primary);
+}
+
+// Metadata of the reader's frame whose first sample is `first_sample`.
+static void pv_recorder_get_frame_info(
+        pv_recorder_t *object,
+        const pv_recorder_reader_t *reader,
+        int64_t first_sample,
+        int64_t sequence_number,
+        pv_recorder_frame_info_t *info) {
+    // the first sample is as much older than the newest anchor as there are samples between them
+    int64_t anchor_usec;
+    int64_t anchor_samples;
+    pv_recorder_load_anchor(object, &anchor_usec, &anchor_samples);
+
+    info->timestamp_usec = anchor_usec - (((anchor_samples - first_sample) * 1000000) / OUTPUT_SAMPLE_RATE);
+    info->sequence_number = sequence_number;
+    info->dropped_samples = pv_recorder_get_dropped_samples(object, reader);
+    info->rms = reader->level.rms;
+    info->peak = reader->level.peak;
+    info->clipped_samples = reader->level.clipped_samples;
+}
 
-                if (object->current_silent_samples >= MAX_SILENCE_BUFFER_SIZE) {
-                    fprintf(stdout, "[WARN] Input device might be muted or volume level is set to 0.\n");
-                    object->current_silent_samples = 0;
-                }
+#if defined(MA_WIN32)
+static DWORD WINAPI pv_recorder_worker_entry(LPVOID arg) {
+#else
+static void *pv_recorder_worker_entry(void *arg) {
+#endif
+    pv_recorder_t *object = (pv_recorder_t *) arg;
+
+    while (object->is_started) {
+        const int16_t *pcm = NULL;
+        int64_t first_sample = 0;
+        pv_recorder_status_t status = pv_recorder_acquire_view(object, &pcm, &first_sample);
+        if (status == PV_RECORDER_STATUS_SUCCESS) {
+            if (object->frame_bus) {
+                // the frame isn't completed yet, so it's the one after the last completed
+                pv_recorder_frame_info_t info;
+                pv_recorder_get_frame_info(
+                        object,
+                        &(object->primary),
+                        first_sample,
+                        object->primary.frame_count,
+                        &info);
+                pv_frame_bus_publish(object->frame_bus, pcm, &info);
+            }
+            if (object->frame_callback) {
+                object->frame_callback(pcm, object->frame_callback_user_data);
             }
+            pv_recorder_finish_view(object);
+        } else if ((status == PV_RECORDER_STATUS_IO_ERROR) &&
+                   (object->log_overflow) &&
+                   (object->backend != PV_RECORDER_BACKEND_SERIAL) &&
+                   (object->backend != PV_RECORDER_BACKEND_FILE)) {
+            // a co-processor is silent between bursts, and a recording once it ends; only a local device is expected
+            // to keep delivering
+            pv_recorder_log_warning(object, "No audio received within %d ms.", object->read_timeout_msec);
+        }
+    }
+
+#if defined(MA_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_ex(pv_recorder_t *object, int16_t *pcm, pv_recorder_frame_info_t *info) {
+    if (!info) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    int64_t first_sample = 0;
+    int32_t frames = 0;
+    pv_recorder_status_t status = pv_recorder_read_primary(object, pcm, 1, &first_sample, &frames);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_recorder_get_frame_info(object, &(object->primary), first_sample, object->primary.frame_count - 1, info);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_add_reader(
+        pv_recorder_t *object,
+        int32_t frame_length,
+        pv_recorder_reader_t **reader) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((frame_length <= 0) || (frame_length > object->keep_samples)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!reader) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    // the primary reader takes the first slot
+    if (object->is_started || (object->reader_count > PV_RECORDER_MAX_READERS)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_reader_t *r = calloc(1, sizeof(pv_recorder_reader_t));
+    if (!r) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    r->recorder = object;
+    r->frame_length = frame_length;
+
+    object->readers[object->reader_count] = r;
+    object->reader_count++;
+
+    *reader = r;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_remove_reader(pv_recorder_t *object, pv_recorder_reader_t *reader) {
+    if (!object || !reader || (reader == &(object->primary))) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
 
+    for (int32_t i = 1; i < object->reader_count; i++) {
+        if (object->readers[i] == reader) {
+            memmove(
+                    &(object->readers[i]),
+                    &(object->readers[i + 1]),
+                    (object->reader_count - i - 1) * sizeof(pv_recorder_reader_t *));
+            object->reader_count--;
+            free(reader);
             return PV_RECORDER_STATUS_SUCCESS;
         }
+    }
+
+    return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+}
+
+PV_API int32_t pv_recorder_reader_get_frame_length(const pv_recorder_reader_t *reader) {
+    if (!reader) {
+        return 0;
+    }
+
+    return reader->frame_length;
+}
+
+PV_API pv_recorder_status_t pv_recorder_reader_read(
+        pv_recorder_reader_t *reader,
+        int16_t *pcm,
+        pv_recorder_frame_info_t *info) {
+    if (!reader || !pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_t *object = reader->recorder;
+    if (!(object->is_started)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    int64_t first_sample = 0;
+    int32_t frames = 0;
+    pv_recorder_status_t status = pv_recorder_read_frames_from(object, reader, pcm, 1, &first_sample, &frames);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    if (info) {
+        pv_recorder_get_frame_info(object, reader, first_sample, reader->frame_count - 1, info);
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_view(pv_recorder_t *object, const int16_t **pcm) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_started)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if ((object->primary.view_length > 0) || pv_recorder_is_push_mode(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    int64_t first_sample = 0;
+    return pv_recorder_acquire_view(object, pcm, &first_sample);
+}
+
+PV_API pv_recorder_status_t pv_recorder_release_view(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (pv_recorder_is_push_mode(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->primary.view_length == 0) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    if (object->is_started) {
+        pv_recorder_finish_view(object);
+    }
+    object->primary.view_length = 0;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+// How pv_recorder_read_converted turns the frame into the caller's samples.
+typedef enum {
+    PV_RECORDER_CONVERSION_FLOAT,
+    PV_RECORDER_CONVERSION_FLOAT_DC_BLOCKED,
+    PV_RECORDER_CONVERSION_INT16_DC_BLOCKED
+} pv_recorder_conversion_t;
+
+// Reads the primary reader's next frame where pv_recorder_read_view finds it, in the ring unless it wraps, and converts
+// it into `pcm` on the way out, so the converted copy is the only one.
+static pv_recorder_status_t pv_recorder_read_converted(
+        pv_recorder_t *object,
+        pv_recorder_conversion_t conversion,
+        void *pcm) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_started)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if ((object->primary.view_length > 0) || pv_recorder_is_push_mode(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    const int16_t *frame = NULL;
+    int64_t first_sample = 0;
+    pv_recorder_status_t status = pv_recorder_acquire_view(object, &frame, &first_sample);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    switch (conversion) {
+        case PV_RECORDER_CONVERSION_FLOAT:
+            pv_sample_format_to_float(frame, object->frame_length, pcm);
+            break;
+        case PV_RECORDER_CONVERSION_FLOAT_DC_BLOCKED:
+            pv_sample_format_to_float_dc_blocked(&(object->dc_blocker), frame, object->frame_length, pcm);
+            break;
+        case PV_RECORDER_CONVERSION_INT16_DC_BLOCKED:
+            pv_sample_format_to_int16_dc_blocked(&(object->dc_blocker), frame, object->frame_length, pcm);
+            break;
+    }
+
+    // the frame's room in the ring is held until it has been converted
+    if (object->is_started) {
+        pv_recorder_finish_view(object);
+    }
+    object->primary.view_length = 0;
+    pv_recorder_arm_ready(object, first_sample + object->frame_length);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_float(pv_recorder_t *object, float *pcm, bool is_dc_blocked) {
+    return pv_recorder_read_converted(
+            object,
+            is_dc_blocked ? PV_RECORDER_CONVERSION_FLOAT_DC_BLOCKED : PV_RECORDER_CONVERSION_FLOAT,
+            pcm);
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_dc_blocked(pv_recorder_t *object, int16_t *pcm) {
+    return pv_recorder_read_converted(object, PV_RECORDER_CONVERSION_INT16_DC_BLOCKED, pcm);
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_stats(pv_recorder_t *object, pv_recorder_stats_t *stats) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!stats) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const pv_recorder_stats_t *source = &(object->stats);
+    stats->total_samples = pv_recorder_stats_load(&source->total_samples);
+    // the capture thread counts what the ring had no room for; each reader counts what it skipped
+    stats->overflow_samples = pv_recorder_stats_load(&source->overflow_samples);
+    for (int32_t i = 0; i < object->reader_count; i++) {
+        stats->overflow_samples += __atomic_load_n(&object->readers[i]->discarded_samples, __ATOMIC_RELAXED);
+    }
+    stats->max_buffered_samples = pv_recorder_stats_load(&source->max_buffered_samples);
+    stats->callback_count = pv_recorder_stats_load(&source->callback_count);
+    stats->min_callback_interval_usec = pv_recorder_stats_load(&source->min_callback_interval_usec);
+    stats->max_callback_interval_usec = pv_recorder_stats_load(&source->max_callback_interval_usec);
+    stats->avg_callback_interval_usec = pv_recorder_stats_load(&source->avg_callback_interval_usec);
+    stats->total_read_wait_usec = pv_recorder_stats_load(&source->total_read_wait_usec);
+    stats->max_read_wait_usec = pv_recorder_stats_load(&source->max_read_wait_usec);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_latency(pv_recorder_t *object, pv_recorder_latency_t *latency) {
+    if (!object || !latency) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((object->backend == PV_RECORDER_BACKEND_SERIAL) || (object->backend == PV_RECORDER_BACKEND_FILE)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    int32_t period_frames = 0;
+    int32_t buffer_frames = 0;
+    int32_t sample_rate = object->sample_rate;
+#if defined(PV_RECORDER_ALSA_MMAP)
+    if (object->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        pv_recorder_alsa_get_buffering(object->alsa, &period_frames, &buffer_frames);
+    }
+#endif
+    if (object->backend == PV_RECORDER_BACKEND_DEFAULT) {
+        period_frames = (int32_t) object->device.capture.internalPeriodSizeInFrames;
+        buffer_frames = period_frames * (int32_t) object->device.capture.internalPeriods;
+        sample_rate = (int32_t) object->device.capture.internalSampleRate;
+    }
+    if ((period_frames <= 0) || (sample_rate <= 0)) {
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+
+    latency->period_frames = period_frames;
+    latency->periods = buffer_frames / period_frames;
+    latency->period_usec = ((int64_t) period_frames * 1000000) / sample_rate;
+    latency->buffer_usec = ((int64_t) buffer_frames * 1000000) / sample_rate;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_scheduling(pv_recorder_t *object, int32_t *realtime_priority, int32_t *cpu) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!realtime_priority || !cpu) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_worker_running)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    *realtime_priority = 0;
+    *cpu = -1;
+#if !defined(MA_WIN32)
+    int policy = SCHED_OTHER;
+    struct sched_param param;
+    if ((pthread_getschedparam(object->worker, &policy, &param) == 0) && (policy == SCHED_FIFO)) {
+        *realtime_priority = param.sched_priority;
+    }
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if ((pthread_getaffinity_np(object->worker, sizeof(set), &set) == 0) && (CPU_COUNT(&set) == 1)) {
+        for (int32_t i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                *cpu = i;
+                break;
+            }
+        }
+    }
+#endif
+#endif
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_frame_callback(
+        pv_recorder_t *object,
+        pv_recorder_frame_callback_t callback,
+        void *user_data) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    object->frame_callback = callback;
+    object->frame_callback_user_data = user_data;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_log_callback(
+        pv_recorder_t *object,
+        pv_recorder_log_callback_t callback,
+        void *user_data) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    object->log_callback = callback;
+    object->log_callback_user_data = user_data;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_publisher(pv_recorder_t *object, const char *name, int32_t slot_count) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (name && (slot_count <= 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_frame_bus_delete(object->frame_bus);
+    object->frame_bus = NULL;
+
+    if (name) {
+        return pv_frame_bus_init(name, object->frame_length, slot_count, &(object->frame_bus));
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_read_timeout(pv_recorder_t *object, int32_t timeout_msec) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (timeout_msec <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    object->read_timeout_msec = timeout_msec;
 
-        ma_mutex_unlock(&object->mutex);
-        ma_sleep(READ_SLEEP_MILLI_SECONDS);
+    return PV_RECORDER_STATUS_SUCCESS;
+}
 
-        read_ptr += length;
-        remaining = object->frame_length - processed;
+PV_API pv_recorder_status_t pv_recorder_set_ready_fd(pv_recorder_t *object, int fd, int32_t batch_frames) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    // a batch the ring can't hold would never be signaled
+    if ((fd >= 0) && ((batch_frames <= 0) || (batch_frames > (object->keep_samples / object->frame_length)))) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
+    if (object->is_started) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+#if defined(MA_WIN32)
+    if (fd >= 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+#endif
+
+    object->ready_fd = (fd >= 0) ? fd : -1;
+    object->ready_frames = batch_frames;
 
-    return PV_RECORDER_STATUS_IO_ERROR;
+    return PV_RECORDER_STATUS_SUCCESS;
 }
 
 PV_API const char *pv_recorder_get_selected_device(pv_recorder_t *object) {
     if (!object) {
         return NULL;
     }
-    return object->device.capture.name;
+#if defined(PV_RECORDER_ALSA_MMAP)
+    if (object->backend == PV_RECORDER_BACKEND_ALSA_MMAP) {
+        return pv_recorder_alsa_get_device_name(object->alsa);
+    }
+#endif
+#if defined(PV_RECORDER_SERIAL)
+    if (object->backend == PV_RECORDER_BACKEND_SERIAL) {
+        return pv_recorder_serial_get_device_name(object->serial);
+    }
+#endif
+#if defined(PV_RECORDER_FILE)
+    if (object->backend == PV_RECORDER_BACKEND_FILE) {
+        return pv_recorder_file_get_file_name(object->file);
+    }
+#endif
+    // the device's own copy is gone while it is unplugged
+    return object->device_name ? object->device_name : object->device.capture.name;
+}
+
+PV_API bool pv_recorder_is_at_end(pv_recorder_t *object) {
+#if defined(PV_RECORDER_FILE)
+    if (object && (object->backend == PV_RECORDER_BACKEND_FILE)) {
+        return pv_recorder_file_is_at_end(object->file);
+    }
+#endif
+    (void) object;
+    return false;
 }
 
 PV_API pv_recorder_status_t pv_recorder_get_audio_devices(int32_t *count, char ***devices) {
@@ -284,6 +2238,10 @@ PV_API pv_recorder_status_t pv_recorder_get_audio_devices(int32_t *count, char *
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
 
+#if defined(PV_RECORDER_DEVICE_REGISTRY)
+    return pv_recorder_devices_get_names(count, devices);
+#else
+
     ma_context context;
     ma_result result = ma_context_init(NULL, 0, NULL, &context);
     if (result != MA_SUCCESS) {
@@ -332,6 +2290,7 @@ PV_API pv_recorder_status_t pv_recorder_get_audio_devices(int32_t *count, char *
     *devices = d;
 
     return PV_RECORDER_STATUS_SUCCESS;
+#endif
 }
 
 PV_API void pv_recorder_free_device_list(int32_t count, char **devices) {
@@ -0,0 +1,279 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <alsa/asoundlib.h>
+
+#include "pv_recorder_alsa.h"
+
+static const char *DEFAULT_DEVICE_NAME = "default";
+static const snd_pcm_uframes_t PERIODS_PER_BUFFER = 4;
+static const int WAIT_TIMEOUT_MILLI_SECONDS = 100;
+
+struct pv_recorder_alsa {
+    snd_pcm_t *pcm;
+    char *device_name;
+    unsigned int sample_rate;
+    unsigned int channels;
+    snd_pcm_uframes_t period_length;
+    snd_pcm_uframes_t buffer_length;
+    pv_recorder_alsa_callback_t callback;
+    void *user_data;
+    pthread_t thread;
+    bool is_running;
+};
+
+static pv_recorder_status_t pv_recorder_alsa_configure(pv_recorder_alsa_t *object) {
+    snd_pcm_hw_params_t *hw_params = NULL;
+    if (snd_pcm_hw_params_malloc(&hw_params) < 0) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    snd_pcm_uframes_t period = object->period_length;
+    snd_pcm_uframes_t buffer = object->period_length * PERIODS_PER_BUFFER;
+
+    // no plughw conversion is requested, so the hardware has to support the format natively
+    int rc = snd_pcm_hw_params_any(object->pcm, hw_params);
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_access(object->pcm, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_format(object->pcm, hw_params, SND_PCM_FORMAT_S16_LE);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_channels(object->pcm, hw_params, object->channels);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_rate(object->pcm, hw_params, object->sample_rate, 0);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_period_size_near(object->pcm, hw_params, &period, NULL);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params_set_buffer_size_near(object->pcm, hw_params, &buffer);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_hw_params(object->pcm, hw_params);
+    }
+    snd_pcm_hw_params_free(hw_params);
+    if (rc < 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    // the driver may round the period; wake up once per period it actually chose
+    object->period_length = period;
+    object->buffer_length = buffer;
+
+    snd_pcm_sw_params_t *sw_params = NULL;
+    if (snd_pcm_sw_params_malloc(&sw_params) < 0) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    rc = snd_pcm_sw_params_current(object->pcm, sw_params);
+    if (rc >= 0) {
+        rc = snd_pcm_sw_params_set_avail_min(object->pcm, sw_params, period);
+    }
+    if (rc >= 0) {
+        rc = snd_pcm_sw_params(object->pcm, sw_params);
+    }
+    snd_pcm_sw_params_free(sw_params);
+    if (rc < 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_alsa_init(
+        const char *device_name,
+        int32_t sample_rate,
+        int32_t channels,
+        int32_t period_length,
+        pv_recorder_alsa_callback_t callback,
+        void *user_data,
+        pv_recorder_alsa_t **object) {
+    if (sample_rate <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (channels <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (period_length <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!callback) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_recorder_alsa_t *o = calloc(1, sizeof(pv_recorder_alsa_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->device_name = strdup(device_name ? device_name : DEFAULT_DEVICE_NAME);
+    if (!(o->device_name)) {
+        pv_recorder_alsa_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->sample_rate = (unsigned int) sample_rate;
+    o->channels = (unsigned int) channels;
+    o->period_length = (snd_pcm_uframes_t) period_length;
+    o->callback = callback;
+    o->user_data = user_data;
+
+    if (snd_pcm_open(&(o->pcm), o->device_name, SND_PCM_STREAM_CAPTURE, 0) < 0) {
+        o->pcm = NULL;
+        pv_recorder_alsa_delete(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    pv_recorder_status_t status = pv_recorder_alsa_configure(o);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_alsa_delete(o);
+        return status;
+    }
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+void pv_recorder_alsa_delete(pv_recorder_alsa_t *object) {
+    if (object) {
+        if (object->is_running) {
+            pv_recorder_alsa_stop(object);
+        }
+        if (object->pcm) {
+            snd_pcm_close(object->pcm);
+        }
+        free(object->device_name);
+        free(object);
+    }
+}
+
+// Capture streams need an explicit start after being re-prepared.
+static bool pv_recorder_alsa_recover(pv_recorder_alsa_t *object, int error) {
+    if (snd_pcm_recover(object->pcm, error, 1) < 0) {
+        return false;
+    }
+    return (snd_pcm_start(object->pcm) >= 0);
+}
+
+static void *pv_recorder_alsa_thread_entry(void *arg) {
+    pv_recorder_alsa_t *object = (pv_recorder_alsa_t *) arg;
+
+    while (__atomic_load_n(&object->is_running, __ATOMIC_ACQUIRE)) {
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(object->pcm);
+        if (avail < 0) {
+            if (!pv_recorder_alsa_recover(object, (int) avail)) {
+                break;
+            }
+            continue;
+        }
+
+        if ((snd_pcm_uframes_t) avail < object->period_length) {
+            // bounded so that a stop request is noticed even if the device stalls
+            const int rc = snd_pcm_wait(object->pcm, WAIT_TIMEOUT_MILLI_SECONDS);
+            if ((rc < 0) && !pv_recorder_alsa_recover(object, rc)) {
+                break;
+            }
+            continue;
+        }
+
+        const snd_pcm_channel_area_t *areas = NULL;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t frames = (snd_pcm_uframes_t) avail;
+        int rc = snd_pcm_mmap_begin(object->pcm, &areas, &offset, &frames);
+        if (rc < 0) {
+            if (!pv_recorder_alsa_recover(object, rc)) {
+                break;
+            }
+            continue;
+        }
+
+        // interleaved, so the frames of the region are contiguous starting at channel 0
+        const int16_t *pcm = (const int16_t *) ((const uint8_t *) areas[0].addr +
+                                                (areas[0].first / 8) +
+                                                (offset * (areas[0].step / 8)));
+        object->callback(pcm, (int32_t) frames, object->user_data);
+
+        const snd_pcm_sframes_t committed = snd_pcm_mmap_commit(object->pcm, offset, frames);
+        if ((committed < 0) || ((snd_pcm_uframes_t) committed != frames)) {
+            if (!pv_recorder_alsa_recover(object, (committed < 0) ? (int) committed : -EPIPE)) {
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+pv_recorder_status_t pv_recorder_alsa_start(pv_recorder_alsa_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_running) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    if ((snd_pcm_prepare(object->pcm) < 0) || (snd_pcm_start(object->pcm) < 0)) {
+        return PV_RECORDER_STATUS_IO_ERROR;
+    }
+
+    __atomic_store_n(&object->is_running, true, __ATOMIC_RELEASE);
+    if (pthread_create(&(object->thread), NULL, pv_recorder_alsa_thread_entry, object) != 0) {
+        __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+        snd_pcm_drop(object->pcm);
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_alsa_stop(pv_recorder_alsa_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_running)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+    pthread_join(object->thread, NULL);
+    snd_pcm_drop(object->pcm);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pthread_t pv_recorder_alsa_get_thread(pv_recorder_alsa_t *object) {
+    return object->thread;
+}
+
+void pv_recorder_alsa_get_buffering(pv_recorder_alsa_t *object, int32_t *period_length, int32_t *buffer_length) {
+    *period_length = (int32_t) object->period_length;
+    *buffer_length = (int32_t) object->buffer_length;
+}
+
+const char *pv_recorder_alsa_get_device_name(pv_recorder_alsa_t *object) {
+    if (!object) {
+        return NULL;
+    }
+    return object->device_name;
+}
@@ -0,0 +1,105 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RECORDER_ALSA_H
+#define PV_RECORDER_ALSA_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Direct ALSA mmap capture, signed 16-bit interleaved. Internal to pv_recorder.
+ */
+typedef struct pv_recorder_alsa pv_recorder_alsa_t;
+
+/**
+ * Called from the capture thread with samples that live in the ALSA mmap area.
+ *
+ * @param pcm Captured interleaved frames. Only valid for the duration of the call.
+ * @param length Number of frames.
+ * @param user_data Pointer passed to pv_recorder_alsa_init.
+ */
+typedef void (*pv_recorder_alsa_callback_t)(const int16_t *pcm, int32_t length, void *user_data);
+
+/**
+ * Opens an ALSA capture PCM with a period of `period_length` frames.
+ *
+ * @param device_name ALSA PCM name. NULL selects "default".
+ * @param sample_rate Capture rate in Hz. The hardware must support it without conversion.
+ * @param channels Number of interleaved channels.
+ * @param period_length Period size in frames.
+ * @param callback Function receiving captured periods.
+ * @param user_data Pointer passed to `callback`.
+ * @param[out] object Capture object to initialize.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+pv_recorder_status_t pv_recorder_alsa_init(
+        const char *device_name,
+        int32_t sample_rate,
+        int32_t channels,
+        int32_t period_length,
+        pv_recorder_alsa_callback_t callback,
+        void *user_data,
+        pv_recorder_alsa_t **object);
+
+/**
+ * Destructor. Stops capture if it is running.
+ *
+ * @param object Capture object.
+ */
+void pv_recorder_alsa_delete(pv_recorder_alsa_t *object);
+
+/**
+ * Starts the PCM and the capture thread.
+ *
+ * @param object Capture object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE, PV_RECORDER_STATUS_IO_ERROR or
+ * PV_RECORDER_STATUS_RUNTIME_ERROR on failure.
+ */
+pv_recorder_status_t pv_recorder_alsa_start(pv_recorder_alsa_t *object);
+
+/**
+ * Stops the capture thread and drops any pending samples.
+ *
+ * @param object Capture object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+pv_recorder_status_t pv_recorder_alsa_stop(pv_recorder_alsa_t *object);
+
+/**
+ * Getter for the capture thread. Only valid while capture is running.
+ *
+ * @param object Capture object.
+ * @return Capture thread.
+ */
+pthread_t pv_recorder_alsa_get_thread(pv_recorder_alsa_t *object);
+
+/**
+ * Getter for the period and buffer sizes the driver chose, which may differ from what was asked for.
+ *
+ * @param object Capture object.
+ * @param period_length[out] Period size in frames.
+ * @param buffer_length[out] Buffer size in frames.
+ */
+void pv_recorder_alsa_get_buffering(pv_recorder_alsa_t *object, int32_t *period_length, int32_t *buffer_length);
+
+/**
+ * Getter for the ALSA PCM name.
+ *
+ * @param object Capture object.
+ * @return PCM name.
+ */
+const char *pv_recorder_alsa_get_device_name(pv_recorder_alsa_t *object);
+
+#endif // PV_RECORDER_ALSA_H
@@ -0,0 +1,249 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#endif
+
+#include "miniaudio.h"
+
+#include "pv_recorder_devices.h"
+
+#if defined(__linux__)
+
+static const char *SOUND_DEVICE_DIRECTORY = "/dev/snd";
+// a card adds or removes several nodes at once; wait for them all before enumerating
+static const int SETTLE_MILLI_SECONDS = 1000;
+// sound servers publish a new card a little after its nodes appear, so listeners hear about it once more later
+static const int RECHECK_MILLI_SECONDS = 2000;
+
+#endif
+
+typedef struct {
+    pv_recorder_devices_callback_t callback;
+    void *user_data;
+} pv_recorder_devices_listener_t;
+
+static struct {
+    pthread_mutex_t lock;
+    ma_context context;
+    ma_result context_result;
+    char **names;
+    int32_t count;
+    bool is_stale;
+    bool is_watching;
+    pthread_mutex_t listener_lock;
+    pv_recorder_devices_listener_t *listeners;
+    int32_t listener_count;
+    int inotify_fd;
+    pthread_t watcher;
+} registry;
+
+static pthread_once_t registry_once = PTHREAD_ONCE_INIT;
+
+static void pv_recorder_devices_free_names(int32_t count, char **names) {
+    for (int32_t i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+}
+
+static void pv_recorder_devices_notify(void) {
+    pthread_mutex_lock(&registry.lock);
+    registry.is_stale = true;
+    pthread_mutex_unlock(&registry.lock);
+
+    pthread_mutex_lock(&registry.listener_lock);
+    for (int32_t i = 0; i < registry.listener_count; i++) {
+        registry.listeners[i].callback(registry.listeners[i].user_data);
+    }
+    pthread_mutex_unlock(&registry.listener_lock);
+}
+
+#if defined(__linux__)
+
+// Waits up to `timeout_msec` for changes under /dev/snd and reads them all. Returns true if there were any.
+static bool pv_recorder_devices_wait_for_change(int timeout_msec) {
+    struct pollfd fd = {.fd = registry.inotify_fd, .events = POLLIN, .revents = 0};
+    if (poll(&fd, 1, timeout_msec) <= 0) {
+        return false;
+    }
+    char events[4096];
+    return read(registry.inotify_fd, events, sizeof(events)) > 0;
+}
+
+static void *pv_recorder_devices_watch(void *arg) {
+    (void) arg;
+
+    while (true) {
+        if (!pv_recorder_devices_wait_for_change(-1)) {
+            continue;
+        }
+        while (pv_recorder_devices_wait_for_change(SETTLE_MILLI_SECONDS)) {}
+        pv_recorder_devices_notify();
+
+        if (!pv_recorder_devices_wait_for_change(RECHECK_MILLI_SECONDS)) {
+            pv_recorder_devices_notify();
+        } else {
+            // another change came first; settle on it and notify for both
+            while (pv_recorder_devices_wait_for_change(SETTLE_MILLI_SECONDS)) {}
+            pv_recorder_devices_notify();
+        }
+    }
+
+    return NULL;
+}
+
+static void pv_recorder_devices_start_watcher(void) {
+    registry.inotify_fd = inotify_init1(IN_CLOEXEC);
+    if (registry.inotify_fd < 0) {
+        return;
+    }
+    if ((inotify_add_watch(registry.inotify_fd, SOUND_DEVICE_DIRECTORY, IN_CREATE | IN_DELETE) < 0) ||
+        (pthread_create(&registry.watcher, NULL, pv_recorder_devices_watch, NULL) != 0)) {
+        close(registry.inotify_fd);
+        registry.inotify_fd = -1;
+        return;
+    }
+    pthread_detach(registry.watcher);
+    registry.is_watching = true;
+}
+
+#endif
+
+// The registry lives until the process exits, like the sound server connection it holds.
+static void pv_recorder_devices_init(void) {
+    pthread_mutex_init(&registry.lock, NULL);
+    pthread_mutex_init(&registry.listener_lock, NULL);
+    registry.inotify_fd = -1;
+    registry.is_stale = true;
+    registry.context_result = ma_context_init(NULL, 0, NULL, &registry.context);
+#if defined(__linux__)
+    if (registry.context_result == MA_SUCCESS) {
+        pv_recorder_devices_start_watcher();
+    }
+#endif
+}
+
+static pv_recorder_status_t pv_recorder_devices_enumerate(void) {
+    ma_device_info *capture_info = NULL;
+    ma_uint32 capture_count = 0;
+    ma_result result = ma_context_get_devices(&registry.context, NULL, NULL, &capture_info, &capture_count);
+    if (result != MA_SUCCESS) {
+        return (result == MA_OUT_OF_MEMORY) ? PV_RECORDER_STATUS_OUT_OF_MEMORY : PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    char **names = calloc(capture_count, sizeof(char *));
+    if (!names && (capture_count > 0)) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    for (int32_t i = 0; i < (int32_t) capture_count; i++) {
+        names[i] = strdup(capture_info[i].name);
+        if (!names[i]) {
+            pv_recorder_devices_free_names(i, names);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    pv_recorder_devices_free_names(registry.count, registry.names);
+    registry.names = names;
+    registry.count = (int32_t) capture_count;
+    // without a watcher nothing would tell the cache it is out of date
+    registry.is_stale = !registry.is_watching;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_devices_get_names(int32_t *count, char ***names) {
+    pthread_once(&registry_once, pv_recorder_devices_init);
+    if (registry.context_result != MA_SUCCESS) {
+        if ((registry.context_result == MA_NO_BACKEND) || (registry.context_result == MA_FAILED_TO_INIT_BACKEND)) {
+            return PV_RECORDER_STATUS_BACKEND_ERROR;
+        } else if (registry.context_result == MA_OUT_OF_MEMORY) {
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        } else {
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+    }
+
+    pthread_mutex_lock(&registry.lock);
+    if (registry.is_stale) {
+        const pv_recorder_status_t status = pv_recorder_devices_enumerate();
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            pthread_mutex_unlock(&registry.lock);
+            return status;
+        }
+    }
+
+    char **d = calloc(registry.count, sizeof(char *));
+    if (!d && (registry.count > 0)) {
+        pthread_mutex_unlock(&registry.lock);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    for (int32_t i = 0; i < registry.count; i++) {
+        d[i] = strdup(registry.names[i]);
+        if (!d[i]) {
+            pthread_mutex_unlock(&registry.lock);
+            pv_recorder_devices_free_names(i, d);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+    *count = registry.count;
+    pthread_mutex_unlock(&registry.lock);
+
+    *names = d;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_devices_add_listener(pv_recorder_devices_callback_t callback, void *user_data) {
+    pthread_once(&registry_once, pv_recorder_devices_init);
+
+    pthread_mutex_lock(&registry.listener_lock);
+    pv_recorder_devices_listener_t *listeners = realloc(
+            registry.listeners,
+            (size_t) (registry.listener_count + 1) * sizeof(pv_recorder_devices_listener_t));
+    if (!listeners) {
+        pthread_mutex_unlock(&registry.listener_lock);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    listeners[registry.listener_count].callback = callback;
+    listeners[registry.listener_count].user_data = user_data;
+    registry.listeners = listeners;
+    registry.listener_count++;
+    pthread_mutex_unlock(&registry.listener_lock);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+void pv_recorder_devices_remove_listener(pv_recorder_devices_callback_t callback, void *user_data) {
+    pthread_once(&registry_once, pv_recorder_devices_init);
+
+    // the watcher holds this lock while it calls listeners, so none is running once it is taken
+    pthread_mutex_lock(&registry.listener_lock);
+    for (int32_t i = 0; i < registry.listener_count; i++) {
+        if ((registry.listeners[i].callback == callback) && (registry.listeners[i].user_data == user_data)) {
+            registry.listeners[i] = registry.listeners[registry.listener_count - 1];
+            registry.listener_count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&registry.listener_lock);
+}
@@ -0,0 +1,64 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RECORDER_DEVICES_H
+#define PV_RECORDER_DEVICES_H
+
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Process-wide registry of capture devices. Internal to pv_recorder.
+ *
+ * The registry keeps one miniaudio context for the life of the process and caches the names of its capture devices.
+ * On Linux a thread watches /dev/snd, where ALSA adds and removes the device nodes of a card as it is plugged in and
+ * out, and the cache is only enumerated again after such a change. Elsewhere every listing enumerates again, on the
+ * same context.
+ */
+
+/**
+ * Called from the registry's thread after capture devices came or went.
+ *
+ * @param user_data Pointer passed to pv_recorder_devices_add_listener.
+ */
+typedef void (*pv_recorder_devices_callback_t)(void *user_data);
+
+/**
+ * Copies the cached device names, enumerating first if they may have changed.
+ *
+ * @param[out] count Number of devices.
+ * @param[out] names Device names, freed with pv_recorder_free_device_list.
+ * @return Status Code. PV_RECORDER_STATUS_BACKEND_ERROR, PV_RECORDER_STATUS_OUT_OF_MEMORY or
+ * PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+pv_recorder_status_t pv_recorder_devices_get_names(int32_t *count, char ***names);
+
+/**
+ * Registers a function to call after every hotplug change. Without a watcher, on systems other than Linux, it is
+ * never called.
+ *
+ * @param callback Function to call.
+ * @param user_data Pointer passed to `callback`.
+ * @return Status Code. PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+pv_recorder_status_t pv_recorder_devices_add_listener(pv_recorder_devices_callback_t callback, void *user_data);
+
+/**
+ * Unregisters a function added with pv_recorder_devices_add_listener. When this returns the function is not running
+ * and won't be called again, so `user_data` may be freed.
+ *
+ * @param callback Function to remove.
+ * @param user_data Pointer it was added with.
+ */
+void pv_recorder_devices_remove_listener(pv_recorder_devices_callback_t callback, void *user_data);
+
+#endif // PV_RECORDER_DEVICES_H
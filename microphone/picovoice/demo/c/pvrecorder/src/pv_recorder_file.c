@@ -0,0 +1,262 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pv_recorder_file.h"
+
+static const int32_t SAMPLE_RATE = 16000;
+static const int64_t NSEC_PER_SEC = 1000000000LL;
+
+struct pv_recorder_file {
+    int fd;
+    char *file_name;
+    float speed;
+    pv_recorder_file_callback_t callback;
+    void *user_data;
+    pthread_t thread;
+    bool is_running;
+    // where the samples are, in bytes from the start of the file
+    int64_t data_offset;
+    int64_t data_length;
+    int64_t samples_read;
+    bool is_at_end;
+    uint8_t bytes[PV_RECORDER_FILE_BLOCK_LENGTH * 2];
+    int16_t samples[PV_RECORDER_FILE_BLOCK_LENGTH];
+};
+
+static uint32_t pv_recorder_file_read_u32(const uint8_t *bytes) {
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+static uint16_t pv_recorder_file_read_u16(const uint8_t *bytes) {
+    return (uint16_t) (bytes[0] | (bytes[1] << 8));
+}
+
+// Finds the data chunk of a WAV file, or takes the whole file as raw PCM if it has no RIFF header.
+static pv_recorder_status_t pv_recorder_file_find_samples(pv_recorder_file_t *object) {
+    const off_t file_length = lseek(object->fd, 0, SEEK_END);
+    if (file_length < 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+    uint8_t header[12];
+    if ((file_length < (off_t) sizeof(header)) ||
+        (pread(object->fd, header, sizeof(header), 0) != (ssize_t) sizeof(header)) ||
+        (memcmp(header, "RIFF", 4) != 0) ||
+        (memcmp(&header[8], "WAVE", 4) != 0)) {
+        object->data_offset = 0;
+        object->data_length = file_length;
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    bool is_format_checked = false;
+    off_t offset = sizeof(header);
+    uint8_t chunk[24];
+    while (pread(object->fd, chunk, 8, offset) == 8) {
+        const uint32_t chunk_length = pv_recorder_file_read_u32(&chunk[4]);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if ((chunk_length < 16) || (pread(object->fd, &chunk[8], 16, offset + 8) != 16)) {
+                return PV_RECORDER_STATUS_BACKEND_ERROR;
+            }
+            const uint16_t format = pv_recorder_file_read_u16(&chunk[8]);
+            const uint16_t channels = pv_recorder_file_read_u16(&chunk[10]);
+            const uint32_t sample_rate = pv_recorder_file_read_u32(&chunk[12]);
+            const uint16_t bits_per_sample = pv_recorder_file_read_u16(&chunk[22]);
+            if ((format != 1) ||
+                (channels != 1) ||
+                (sample_rate != (uint32_t) SAMPLE_RATE) ||
+                (bits_per_sample != 16)) {
+                return PV_RECORDER_STATUS_BACKEND_ERROR;
+            }
+            is_format_checked = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!is_format_checked) {
+                return PV_RECORDER_STATUS_BACKEND_ERROR;
+            }
+            object->data_offset = offset + 8;
+            // a recording cut short leaves a length past the end of the file
+            const int64_t available = file_length - object->data_offset;
+            object->data_length = (chunk_length < available) ? chunk_length : available;
+            return PV_RECORDER_STATUS_SUCCESS;
+        }
+        // chunks are padded to an even length
+        offset += 8 + chunk_length + (chunk_length & 1);
+    }
+    return PV_RECORDER_STATUS_BACKEND_ERROR;
+}
+
+pv_recorder_status_t pv_recorder_file_init(
+        const char *file_name,
+        float speed,
+        pv_recorder_file_callback_t callback,
+        void *user_data,
+        pv_recorder_file_t **object) {
+    if (!file_name) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (speed < 0.f) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!callback) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_recorder_file_t *o = calloc(1, sizeof(pv_recorder_file_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->fd = -1;
+
+    o->file_name = strdup(file_name);
+    if (!(o->file_name)) {
+        pv_recorder_file_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->speed = speed;
+    o->callback = callback;
+    o->user_data = user_data;
+
+    o->fd = open(o->file_name, O_RDONLY | O_CLOEXEC);
+    if (o->fd < 0) {
+        pv_recorder_file_delete(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    pv_recorder_status_t status = pv_recorder_file_find_samples(o);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_file_delete(o);
+        return status;
+    }
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+void pv_recorder_file_delete(pv_recorder_file_t *object) {
+    if (object) {
+        if (object->is_running) {
+            pv_recorder_file_stop(object);
+        }
+        if (object->fd >= 0) {
+            close(object->fd);
+        }
+        free(object->file_name);
+        free(object);
+    }
+}
+
+static void *pv_recorder_file_thread_entry(void *arg) {
+    pv_recorder_file_t *object = (pv_recorder_file_t *) arg;
+
+    // paced from where this run started, so a slow callback is caught up on rather than drifting
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const int64_t first_sample = object->samples_read;
+    const int64_t sample_count = object->data_length / 2;
+
+    while (__atomic_load_n(&object->is_running, __ATOMIC_ACQUIRE) && (object->samples_read < sample_count)) {
+        const int64_t left = sample_count - object->samples_read;
+        const int32_t length = (left < PV_RECORDER_FILE_BLOCK_LENGTH) ? (int32_t) left : PV_RECORDER_FILE_BLOCK_LENGTH;
+        const ssize_t count = pread(
+                object->fd,
+                object->bytes,
+                (size_t) length * 2,
+                object->data_offset + (object->samples_read * 2));
+        if (count != (ssize_t) length * 2) {
+            break;
+        }
+        for (int32_t i = 0; i < length; i++) {
+            object->samples[i] = (int16_t) pv_recorder_file_read_u16(&object->bytes[2 * i]);
+        }
+        object->samples_read += length;
+
+        if (object->speed > 0.f) {
+            const int64_t due_nsec = (int64_t) ((double) (object->samples_read - first_sample) * NSEC_PER_SEC /
+                                                ((double) SAMPLE_RATE * object->speed));
+            struct timespec due = start;
+            due.tv_sec += due_nsec / NSEC_PER_SEC;
+            due.tv_nsec += due_nsec % NSEC_PER_SEC;
+            if (due.tv_nsec >= NSEC_PER_SEC) {
+                due.tv_sec++;
+                due.tv_nsec -= NSEC_PER_SEC;
+            }
+            // the block is handed on once its last sample would have been captured
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) != 0) {}
+        }
+        object->callback(object->samples, length, object->user_data);
+    }
+
+    if (object->samples_read >= sample_count) {
+        __atomic_store_n(&object->is_at_end, true, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+pv_recorder_status_t pv_recorder_file_start(pv_recorder_file_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_running) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    __atomic_store_n(&object->is_running, true, __ATOMIC_RELEASE);
+    if (pthread_create(&(object->thread), NULL, pv_recorder_file_thread_entry, object) != 0) {
+        __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_file_stop(pv_recorder_file_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_running)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+    pthread_join(object->thread, NULL);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pthread_t pv_recorder_file_get_thread(pv_recorder_file_t *object) {
+    return object->thread;
+}
+
+const char *pv_recorder_file_get_file_name(pv_recorder_file_t *object) {
+    if (!object) {
+        return NULL;
+    }
+    return object->file_name;
+}
+
+bool pv_recorder_file_is_at_end(pv_recorder_file_t *object) {
+    if (!object) {
+        return false;
+    }
+    return __atomic_load_n(&object->is_at_end, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,108 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RECORDER_FILE_H
+#define PV_RECORDER_FILE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Recorded audio replayed from a file, in place of a device, for tests and benchmarks on a host without the
+ * microphone. Internal to pv_recorder.
+ *
+ * The file is a WAV file holding 16 kHz mono signed 16-bit PCM, or that PCM raw and little-endian with no header. A
+ * reader thread hands it on in blocks of PV_RECORDER_FILE_BLOCK_LENGTH samples, paced at `speed` times real time, and
+ * stops at the end of the file.
+ */
+typedef struct pv_recorder_file pv_recorder_file_t;
+
+#define PV_RECORDER_FILE_BLOCK_LENGTH (512)
+
+/**
+ * Called from the reader thread with each block of samples.
+ *
+ * @param pcm Samples in host byte order. Only valid for the duration of the call.
+ * @param length Number of samples.
+ * @param user_data Pointer passed to pv_recorder_file_init.
+ */
+typedef void (*pv_recorder_file_callback_t)(const int16_t *pcm, int32_t length, void *user_data);
+
+/**
+ * Opens a file and finds its samples.
+ *
+ * @param file_name Path of the file.
+ * @param speed Pace as a multiple of real time, e.g. 100 for a hundred times faster; 0 hands blocks on as fast as the
+ * callback returns.
+ * @param callback Function receiving audio samples.
+ * @param user_data Pointer passed to `callback`.
+ * @param[out] object File object to initialize.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR if the file can't be
+ * opened or is a WAV file in another format, or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+pv_recorder_status_t pv_recorder_file_init(
+        const char *file_name,
+        float speed,
+        pv_recorder_file_callback_t callback,
+        void *user_data,
+        pv_recorder_file_t **object);
+
+/**
+ * Destructor. Stops the reader thread if it is running.
+ *
+ * @param object File object.
+ */
+void pv_recorder_file_delete(pv_recorder_file_t *object);
+
+/**
+ * Starts the reader thread, from where the last one stopped.
+ *
+ * @param object File object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE or PV_RECORDER_STATUS_RUNTIME_ERROR on failure.
+ */
+pv_recorder_status_t pv_recorder_file_start(pv_recorder_file_t *object);
+
+/**
+ * Stops the reader thread.
+ *
+ * @param object File object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+pv_recorder_status_t pv_recorder_file_stop(pv_recorder_file_t *object);
+
+/**
+ * Getter for the reader thread. Only valid while the reader is running.
+ *
+ * @param object File object.
+ * @return Reader thread.
+ */
+pthread_t pv_recorder_file_get_thread(pv_recorder_file_t *object);
+
+/**
+ * Getter for the file path.
+ *
+ * @param object File object.
+ * @return File path.
+ */
+const char *pv_recorder_file_get_file_name(pv_recorder_file_t *object);
+
+/**
+ * Whether every sample of the file has been handed to the callback.
+ *
+ * @param object File object.
+ * @return True at the end of the file.
+ */
+bool pv_recorder_file_is_at_end(pv_recorder_file_t *object);
+
+#endif // PV_RECORDER_FILE_H
@@ -0,0 +1,37 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RECORDER_PROBE_H
+#define PV_RECORDER_PROBE_H
+
+/**
+ * USDT probes on the hot paths of pv_recorder, under the provider `pv_recorder`, for bpftrace or perf to attach to a
+ * running process without a rebuild, e.g.
+ * `bpftrace -e 'usdt:/proc/PID/exe:pv_recorder:read_wait_return { @wait_usec = hist(arg1); }'`. Internal to
+ * pv_recorder. CMake defines PV_RECORDER_USDT where <sys/sdt.h> is found; a probe is then one nop until something
+ * attaches, and without it compiles to nothing, arguments included. Arguments are integers or pointers.
+ */
+
+#if defined(PV_RECORDER_USDT)
+
+#include <sys/sdt.h>
+
+#define PV_RECORDER_PROBE2(name, a, b) STAP_PROBE2(pv_recorder, name, a, b)
+#define PV_RECORDER_PROBE3(name, a, b, c) STAP_PROBE3(pv_recorder, name, a, b, c)
+
+#else
+
+#define PV_RECORDER_PROBE2(name, a, b) do {} while (0)
+#define PV_RECORDER_PROBE3(name, a, b, c) do {} while (0)
+
+#endif
+
+#endif
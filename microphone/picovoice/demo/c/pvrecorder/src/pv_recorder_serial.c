@@ -0,0 +1,339 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "pv_recorder_serial.h"
+
+// sync (2), type (1), sequence number (2), payload length (2)
+static const int32_t HEADER_LENGTH = 7;
+static const int32_t CRC_LENGTH = 2;
+
+struct pv_recorder_serial {
+    int fd;
+    char *device_name;
+    pv_recorder_serial_callback_t callback;
+    void *user_data;
+    pthread_t thread;
+    bool is_running;
+    uint8_t packet[7 + PV_RECORDER_SERIAL_MAX_PAYLOAD_LENGTH + 2];
+    int32_t packet_length;
+    int16_t samples[PV_RECORDER_SERIAL_MAX_PAYLOAD_LENGTH / 2];
+    bool is_in_burst;
+    uint16_t next_sequence_number;
+    int64_t corrupt_packets;
+    int64_t lost_packets;
+};
+
+uint16_t pv_recorder_serial_crc(const uint8_t *data, int32_t length) {
+    uint16_t crc = 0xFFFF;
+    for (int32_t i = 0; i < length; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+        for (int32_t j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool pv_recorder_serial_get_speed(int32_t baud_rate, speed_t *speed) {
+    switch (baud_rate) {
+        case 9600:
+            *speed = B9600;
+            return true;
+        case 19200:
+            *speed = B19200;
+            return true;
+        case 38400:
+            *speed = B38400;
+            return true;
+        case 57600:
+            *speed = B57600;
+            return true;
+        case 115200:
+            *speed = B115200;
+            return true;
+        case 230400:
+            *speed = B230400;
+            return true;
+#if defined(B460800)
+        case 460800:
+            *speed = B460800;
+            return true;
+#endif
+#if defined(B921600)
+        case 921600:
+            *speed = B921600;
+            return true;
+#endif
+#if defined(B1000000)
+        case 1000000:
+            *speed = B1000000;
+            return true;
+#endif
+#if defined(B2000000)
+        case 2000000:
+            *speed = B2000000;
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+static pv_recorder_status_t pv_recorder_serial_configure(pv_recorder_serial_t *object, speed_t speed) {
+    struct termios attributes;
+    if (tcgetattr(object->fd, &attributes) != 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    cfmakeraw(&attributes);
+    attributes.c_cflag |= (CLOCAL | CREAD);
+    attributes.c_cflag &= ~(CSTOPB | PARENB);
+    // reads return after 100 ms of silence so that a stop request is noticed between bursts
+    attributes.c_cc[VMIN] = 0;
+    attributes.c_cc[VTIME] = 1;
+    if ((cfsetispeed(&attributes, speed) != 0) || (cfsetospeed(&attributes, speed) != 0)) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+    if (tcsetattr(object->fd, TCSANOW, &attributes) != 0) {
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_serial_init(
+        const char *device_name,
+        int32_t baud_rate,
+        pv_recorder_serial_callback_t callback,
+        void *user_data,
+        pv_recorder_serial_t **object) {
+    if (!device_name) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    speed_t speed;
+    if (!pv_recorder_serial_get_speed(baud_rate, &speed)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!callback) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_recorder_serial_t *o = calloc(1, sizeof(pv_recorder_serial_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->fd = -1;
+
+    o->device_name = strdup(device_name);
+    if (!(o->device_name)) {
+        pv_recorder_serial_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    o->callback = callback;
+    o->user_data = user_data;
+
+    o->fd = open(o->device_name, O_RDWR | O_NOCTTY);
+    if (o->fd < 0) {
+        pv_recorder_serial_delete(o);
+        return PV_RECORDER_STATUS_BACKEND_ERROR;
+    }
+
+    pv_recorder_status_t status = pv_recorder_serial_configure(o, speed);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_serial_delete(o);
+        return status;
+    }
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+void pv_recorder_serial_delete(pv_recorder_serial_t *object) {
+    if (object) {
+        if (object->is_running) {
+            pv_recorder_serial_stop(object);
+        }
+        if (object->fd >= 0) {
+            close(object->fd);
+        }
+        free(object->device_name);
+        free(object);
+    }
+}
+
+static uint16_t pv_recorder_serial_read_u16(const uint8_t *bytes) {
+    return (uint16_t) (bytes[0] | (bytes[1] << 8));
+}
+
+static void pv_recorder_serial_dispatch(pv_recorder_serial_t *object) {
+    const uint8_t type = object->packet[2];
+    const uint16_t sequence_number = pv_recorder_serial_read_u16(&object->packet[3]);
+    const int32_t payload_length = pv_recorder_serial_read_u16(&object->packet[5]);
+    const uint8_t *payload = &object->packet[HEADER_LENGTH];
+
+    if (type == PV_RECORDER_SERIAL_PACKET_TRIGGER) {
+        object->is_in_burst = true;
+    } else if (type == PV_RECORDER_SERIAL_PACKET_AUDIO) {
+        // a burst whose TRIGGER was lost still carries usable audio; gaps are only counted once a sequence is known
+        if (object->is_in_burst && (sequence_number != object->next_sequence_number)) {
+            __atomic_add_fetch(
+                    &object->lost_packets,
+                    (uint16_t) (sequence_number - object->next_sequence_number),
+                    __ATOMIC_RELAXED);
+        }
+        object->is_in_burst = true;
+
+        const int32_t length = payload_length / 2;
+        for (int32_t i = 0; i < length; i++) {
+            object->samples[i] = (int16_t) pv_recorder_serial_read_u16(&payload[2 * i]);
+        }
+        if (length > 0) {
+            object->callback(object->samples, length, object->user_data);
+        }
+    } else if (type == PV_RECORDER_SERIAL_PACKET_END) {
+        object->is_in_burst = false;
+    }
+    object->next_sequence_number = (uint16_t) (sequence_number + 1);
+}
+
+static void pv_recorder_serial_parse(pv_recorder_serial_t *object, uint8_t byte) {
+    if (object->packet_length == 0) {
+        if (byte == PV_RECORDER_SERIAL_SYNC_0) {
+            object->packet[object->packet_length++] = byte;
+        }
+        return;
+    }
+    if (object->packet_length == 1) {
+        if (byte == PV_RECORDER_SERIAL_SYNC_1) {
+            object->packet[object->packet_length++] = byte;
+        } else if (byte != PV_RECORDER_SERIAL_SYNC_0) {
+            object->packet_length = 0;
+        }
+        return;
+    }
+
+    object->packet[object->packet_length++] = byte;
+
+    if (object->packet_length < HEADER_LENGTH) {
+        return;
+    }
+    const int32_t payload_length = pv_recorder_serial_read_u16(&object->packet[5]);
+    const bool is_odd_audio = (object->packet[2] == PV_RECORDER_SERIAL_PACKET_AUDIO) && ((payload_length % 2) != 0);
+    if ((payload_length > PV_RECORDER_SERIAL_MAX_PAYLOAD_LENGTH) || is_odd_audio) {
+        __atomic_add_fetch(&object->corrupt_packets, 1, __ATOMIC_RELAXED);
+        object->packet_length = 0;
+        return;
+    }
+    if (object->packet_length < (HEADER_LENGTH + payload_length + CRC_LENGTH)) {
+        return;
+    }
+
+    const uint16_t crc = pv_recorder_serial_read_u16(&object->packet[HEADER_LENGTH + payload_length]);
+    if (crc == pv_recorder_serial_crc(&object->packet[2], HEADER_LENGTH - 2 + payload_length)) {
+        pv_recorder_serial_dispatch(object);
+    } else {
+        __atomic_add_fetch(&object->corrupt_packets, 1, __ATOMIC_RELAXED);
+    }
+    object->packet_length = 0;
+}
+
+static void *pv_recorder_serial_thread_entry(void *arg) {
+    pv_recorder_serial_t *object = (pv_recorder_serial_t *) arg;
+
+    uint8_t chunk[256];
+    while (__atomic_load_n(&object->is_running, __ATOMIC_ACQUIRE)) {
+        const ssize_t count = read(object->fd, chunk, sizeof(chunk));
+        if (count < 0) {
+            // the device is gone; the reader sees the same timeouts as between bursts
+            break;
+        }
+        for (ssize_t i = 0; i < count; i++) {
+            pv_recorder_serial_parse(object, chunk[i]);
+        }
+    }
+
+    return NULL;
+}
+
+pv_recorder_status_t pv_recorder_serial_start(pv_recorder_serial_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->is_running) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    // audio that queued up while stopped is stale by now
+    tcflush(object->fd, TCIFLUSH);
+    object->packet_length = 0;
+    object->is_in_burst = false;
+
+    __atomic_store_n(&object->is_running, true, __ATOMIC_RELEASE);
+    if (pthread_create(&(object->thread), NULL, pv_recorder_serial_thread_entry, object) != 0) {
+        __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pv_recorder_status_t pv_recorder_serial_stop(pv_recorder_serial_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(object->is_running)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    __atomic_store_n(&object->is_running, false, __ATOMIC_RELEASE);
+    pthread_join(object->thread, NULL);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+pthread_t pv_recorder_serial_get_thread(pv_recorder_serial_t *object) {
+    return object->thread;
+}
+
+const char *pv_recorder_serial_get_device_name(pv_recorder_serial_t *object) {
+    if (!object) {
+        return NULL;
+    }
+    return object->device_name;
+}
+
+int64_t pv_recorder_serial_get_corrupt_packets(pv_recorder_serial_t *object) {
+    if (!object) {
+        return 0;
+    }
+    return __atomic_load_n(&object->corrupt_packets, __ATOMIC_RELAXED);
+}
+
+int64_t pv_recorder_serial_get_lost_packets(pv_recorder_serial_t *object) {
+    if (!object) {
+        return 0;
+    }
+    return __atomic_load_n(&object->lost_packets, __ATOMIC_RELAXED);
+}
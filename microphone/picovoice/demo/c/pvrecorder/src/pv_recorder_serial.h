@@ -0,0 +1,131 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RECORDER_SERIAL_H
+#define PV_RECORDER_SERIAL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "pv_recorder.h"
+
+/**
+ * Audio received over a serial line from a wake word co-processor. Internal to pv_recorder.
+ *
+ * The line carries packets of `0xA5 0x5A`, type (u8), sequence number (u16), payload length (u16), payload and a
+ * CRC-16/CCITT-FALSE (u16) over type to the end of the payload. Multi-byte fields are little-endian. A TRIGGER packet
+ * (payload: keyword index, u8) starts a burst of AUDIO packets (payload: 16 kHz mono signed 16-bit PCM) that an END
+ * packet closes. Packets with a bad length or CRC are dropped and the parser resynchronizes on the next sync bytes.
+ */
+typedef struct pv_recorder_serial pv_recorder_serial_t;
+
+/**
+ * Sync bytes, packet types and limits of the wire format.
+ */
+#define PV_RECORDER_SERIAL_SYNC_0 (0xA5)
+#define PV_RECORDER_SERIAL_SYNC_1 (0x5A)
+#define PV_RECORDER_SERIAL_PACKET_TRIGGER (0x01)
+#define PV_RECORDER_SERIAL_PACKET_AUDIO (0x02)
+#define PV_RECORDER_SERIAL_PACKET_END (0x03)
+#define PV_RECORDER_SERIAL_MAX_PAYLOAD_LENGTH (4096)
+
+/**
+ * Called from the reader thread with the samples of each valid AUDIO packet.
+ *
+ * @param pcm Received samples in host byte order. Only valid for the duration of the call.
+ * @param length Number of samples.
+ * @param user_data Pointer passed to pv_recorder_serial_init.
+ */
+typedef void (*pv_recorder_serial_callback_t)(const int16_t *pcm, int32_t length, void *user_data);
+
+/**
+ * Computes the CRC-16/CCITT-FALSE used by the wire format.
+ *
+ * @param data Bytes to check.
+ * @param length Number of bytes.
+ * @return CRC.
+ */
+uint16_t pv_recorder_serial_crc(const uint8_t *data, int32_t length);
+
+/**
+ * Opens a serial device in raw 8N1 mode.
+ *
+ * @param device_name Path of the serial device, e.g. "/dev/ttyS4".
+ * @param baud_rate Line rate in baud. Must be one of the standard termios rates.
+ * @param callback Function receiving audio samples.
+ * @param user_data Pointer passed to `callback`.
+ * @param[out] object Serial object to initialize.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+pv_recorder_status_t pv_recorder_serial_init(
+        const char *device_name,
+        int32_t baud_rate,
+        pv_recorder_serial_callback_t callback,
+        void *user_data,
+        pv_recorder_serial_t **object);
+
+/**
+ * Destructor. Stops the reader thread if it is running.
+ *
+ * @param object Serial object.
+ */
+void pv_recorder_serial_delete(pv_recorder_serial_t *object);
+
+/**
+ * Drops whatever is pending on the line and starts the reader thread.
+ *
+ * @param object Serial object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE or PV_RECORDER_STATUS_RUNTIME_ERROR on failure.
+ */
+pv_recorder_status_t pv_recorder_serial_start(pv_recorder_serial_t *object);
+
+/**
+ * Stops the reader thread and discards any partially received packet.
+ *
+ * @param object Serial object.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+pv_recorder_status_t pv_recorder_serial_stop(pv_recorder_serial_t *object);
+
+/**
+ * Getter for the reader thread. Only valid while the reader is running.
+ *
+ * @param object Serial object.
+ * @return Reader thread.
+ */
+pthread_t pv_recorder_serial_get_thread(pv_recorder_serial_t *object);
+
+/**
+ * Getter for the serial device path.
+ *
+ * @param object Serial object.
+ * @return Device path.
+ */
+const char *pv_recorder_serial_get_device_name(pv_recorder_serial_t *object);
+
+/**
+ * Getter for the number of packets dropped because of a bad length or CRC.
+ *
+ * @param object Serial object.
+ * @return Number of corrupt packets.
+ */
+int64_t pv_recorder_serial_get_corrupt_packets(pv_recorder_serial_t *object);
+
+/**
+ * Getter for the number of packets missing from a burst, counted from gaps in the sequence numbers.
+ *
+ * @param object Serial object.
+ * @return Number of lost packets.
+ */
+int64_t pv_recorder_serial_get_lost_packets(pv_recorder_serial_t *object);
+
+#endif // PV_RECORDER_SERIAL_H
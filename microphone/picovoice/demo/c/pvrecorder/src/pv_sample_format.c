@@ -0,0 +1,238 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+
+#if defined(PV_RECORDER_NEON)
+
+#include "pv_neon.h"
+
+#define PV_SAMPLE_FORMAT_NEON
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PV_SAMPLE_FORMAT_SSE2
+
+#endif
+
+#include "pv_sample_format.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// the float output of the 16-bit DC blocker goes through a buffer this long on the stack, so it stays in L1
+#define CHUNK_LENGTH (64)
+
+static const float FULL_SCALE = 32768.0f;
+// a long stretch of digital silence would otherwise leave the feedback decaying through denormals, which are slow on
+// x86 and on the cores that don't flush them
+static const float DENORMAL_FLOOR = 1e-20f;
+
+#if defined(PV_SAMPLE_FORMAT_NEON) || defined(PV_SAMPLE_FORMAT_SSE2)
+
+// The 4 columns of a block, each the powers of the pole from the diagonal down, then the feedback of the output
+// before the block: lane j of column k is pole^(j - k) for j >= k, and lane j of the feedback is pole^(j + 1).
+static void compute_coefficients(float pole, float *coefficients) {
+    float powers[5] = {1.0f, pole, pole * pole, pole * pole * pole, pole * pole * pole * pole};
+    for (int32_t k = 0; k < 4; k++) {
+        for (int32_t j = 0; j < 4; j++) {
+            coefficients[(4 * k) + j] = (j >= k) ? powers[j - k] : 0.0f;
+        }
+    }
+    for (int32_t j = 0; j < 4; j++) {
+        coefficients[16 + j] = powers[j + 1];
+    }
+}
+
+#endif
+
+#if defined(PV_SAMPLE_FORMAT_SSE2)
+
+static __m128 to_float_low(__m128i x) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+}
+
+static __m128 to_float_high(__m128i x) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+}
+
+// Lanes 0 to 2 of `x` moved up one, under lane 3 of `previous`.
+static __m128 shift_in(__m128 previous, __m128 x) {
+    return _mm_castsi128_ps(_mm_or_si128(
+            _mm_slli_si128(_mm_castps_si128(x), 4),
+            _mm_srli_si128(_mm_castps_si128(previous), 12)));
+}
+
+static __m128 remove_dc_block(__m128 d, __m128 previous, const __m128 *c) {
+    __m128 y = _mm_mul_ps(c[4], _mm_shuffle_ps(previous, previous, _MM_SHUFFLE(3, 3, 3, 3)));
+    y = _mm_add_ps(y, _mm_mul_ps(c[0], _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 0, 0, 0))));
+    y = _mm_add_ps(y, _mm_mul_ps(c[1], _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1))));
+    y = _mm_add_ps(y, _mm_mul_ps(c[2], _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 2, 2, 2))));
+    return _mm_add_ps(y, _mm_mul_ps(c[3], _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+
+#endif
+
+// Converts whole blocks of 8 samples and returns how many samples it covered; the caller does the rest.
+static int32_t to_float_blocks(const int16_t *input, int32_t length, float scale, float *output) {
+    int32_t i = 0;
+#if defined(PV_SAMPLE_FORMAT_NEON)
+    if (pv_neon_is_available()) {
+        i = pv_neon_to_float(input, length, scale, output);
+    }
+#elif defined(PV_SAMPLE_FORMAT_SSE2)
+    const __m128 factor = _mm_set1_ps(scale);
+    for (; (i + 8) <= length; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(to_float_low(x), factor));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(to_float_high(x), factor));
+    }
+#else
+    (void) input;
+    (void) length;
+    (void) scale;
+    (void) output;
+#endif
+    return i;
+}
+
+// Filters whole blocks of 8 samples, carrying the blocker on, and returns how many samples it covered; the caller
+// does the rest.
+static int32_t remove_dc_blocks(
+        pv_dc_blocker_t *blocker,
+        const int16_t *input,
+        int32_t length,
+        float scale,
+        float *output) {
+    int32_t i = 0;
+    if (length < 8) {
+        return i;
+    }
+#if defined(PV_SAMPLE_FORMAT_NEON)
+    if (pv_neon_is_available()) {
+        float coefficients[20];
+        compute_coefficients(blocker->pole, coefficients);
+        i = pv_neon_remove_dc(
+                input,
+                length,
+                coefficients,
+                scale,
+                &(blocker->previous_input),
+                &(blocker->previous_output),
+                output);
+    }
+#elif defined(PV_SAMPLE_FORMAT_SSE2)
+    float coefficients[20];
+    compute_coefficients(blocker->pole, coefficients);
+    const __m128 c[5] = {
+            _mm_loadu_ps(coefficients),
+            _mm_loadu_ps(coefficients + 4),
+            _mm_loadu_ps(coefficients + 8),
+            _mm_loadu_ps(coefficients + 12),
+            _mm_loadu_ps(coefficients + 16)};
+    const __m128 factor = _mm_set1_ps(scale);
+    __m128 last_x = _mm_set1_ps(blocker->previous_input);
+    __m128 last_y = _mm_set1_ps(blocker->previous_output);
+    for (; (i + 8) <= length; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (input + i));
+        const __m128 low = to_float_low(x);
+        const __m128 high = to_float_high(x);
+        const __m128 y_low = remove_dc_block(_mm_sub_ps(low, shift_in(last_x, low)), last_y, c);
+        last_y = remove_dc_block(_mm_sub_ps(high, shift_in(low, high)), y_low, c);
+        last_x = high;
+        _mm_storeu_ps(output + i, _mm_mul_ps(y_low, factor));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(last_y, factor));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, last_x);
+    blocker->previous_input = lanes[3];
+    _mm_storeu_ps(lanes, last_y);
+    blocker->previous_output = lanes[3];
+#else
+    (void) blocker;
+    (void) input;
+    (void) scale;
+    (void) output;
+#endif
+    return i;
+}
+
+static void remove_dc(pv_dc_blocker_t *blocker, const int16_t *input, int32_t length, float scale, float *output) {
+    int32_t i = remove_dc_blocks(blocker, input, length, scale, output);
+
+    float previous_input = blocker->previous_input;
+    float previous_output = blocker->previous_output;
+    for (; i < length; i++) {
+        const float x = (float) input[i];
+        previous_output = (x - previous_input) + (blocker->pole * previous_output);
+        previous_input = x;
+        output[i] = previous_output * scale;
+    }
+
+    blocker->previous_input = previous_input;
+    blocker->previous_output = (fabsf(previous_output) < DENORMAL_FLOOR) ? 0.0f : previous_output;
+}
+
+void pv_sample_format_init_dc_blocker(int32_t sample_rate, float cutoff_hz, pv_dc_blocker_t *blocker) {
+    if (!blocker) {
+        return;
+    }
+    const float pole = 1.0f - ((2.0f * (float) M_PI * cutoff_hz) / (float) sample_rate);
+    blocker->pole = (pole < 0.0f) ? 0.0f : pole;
+    blocker->previous_input = 0.0f;
+    blocker->previous_output = 0.0f;
+}
+
+void pv_sample_format_to_float(const int16_t *input, int32_t length, float *output) {
+    if (!input || !output) {
+        return;
+    }
+
+    int32_t i = to_float_blocks(input, length, 1.0f / FULL_SCALE, output);
+    for (; i < length; i++) {
+        output[i] = (float) input[i] * (1.0f / FULL_SCALE);
+    }
+}
+
+void pv_sample_format_to_float_dc_blocked(
+        pv_dc_blocker_t *blocker,
+        const int16_t *input,
+        int32_t length,
+        float *output) {
+    if (!blocker || !input || !output) {
+        return;
+    }
+
+    remove_dc(blocker, input, length, 1.0f / FULL_SCALE, output);
+}
+
+void pv_sample_format_to_int16_dc_blocked(
+        pv_dc_blocker_t *blocker,
+        const int16_t *input,
+        int32_t length,
+        int16_t *output) {
+    if (!blocker || !input || !output) {
+        return;
+    }
+
+    float filtered[CHUNK_LENGTH];
+    for (int32_t start = 0; start < length; start += CHUNK_LENGTH) {
+        const int32_t chunk_length = ((length - start) < CHUNK_LENGTH) ? (length - start) : CHUNK_LENGTH;
+        remove_dc(blocker, input + start, chunk_length, 1.0f, filtered);
+        for (int32_t i = 0; i < chunk_length; i++) {
+            const float y = filtered[i] + ((filtered[i] < 0.0f) ? -0.5f : 0.5f);
+            output[start + i] = (int16_t) ((y >= 32767.0f) ? INT16_MAX : ((y <= -32768.0f) ? INT16_MIN : y));
+        }
+    }
+}
@@ -0,0 +1,262 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pv_adpcm.h"
+
+#define BLOCK_ALIGN (PV_ADPCM_DEFAULT_BLOCK_ALIGN)
+#define SAMPLES_PER_BLOCK (((BLOCK_ALIGN - 4) * 2) + 1)
+#define BLOCK_COUNT (32)
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static const int32_t STEPS[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+        5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+        27086, 29794, 32767};
+
+static const int32_t INDEX_CHANGES[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// the textbook encoder, with a branch for everything, that the block encoder has to match bit for bit
+static uint8_t encode_reference(int32_t sample, int32_t *predictor, int32_t *step_index) {
+    int32_t step = STEPS[*step_index];
+    int32_t difference = sample - *predictor;
+    uint8_t nibble = 0;
+    if (difference < 0) {
+        nibble = 8;
+        difference = -difference;
+    }
+    int32_t delta = step >> 3;
+    if (difference >= step) {
+        nibble |= 4;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 2;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 1;
+        delta += step;
+    }
+    *predictor += (nibble & 8) ? -delta : delta;
+    if (*predictor > INT16_MAX) {
+        *predictor = INT16_MAX;
+    } else if (*predictor < INT16_MIN) {
+        *predictor = INT16_MIN;
+    }
+    *step_index += INDEX_CHANGES[nibble & 7];
+    if (*step_index < 0) {
+        *step_index = 0;
+    } else if (*step_index > 88) {
+        *step_index = 88;
+    }
+    return nibble;
+}
+
+// a short block padded with its last sample to whole groups of 4 bytes
+static void encode_block_reference(int32_t *step_index, const int16_t *pcm, int32_t length, uint8_t *block) {
+    const int32_t padded_length = 1 + ((((length - 1) + 7) / 8) * 8);
+    int32_t predictor = pcm[0];
+    memset(block, 0, (size_t) (4 + ((padded_length - 1) / 2)));
+    block[0] = (uint8_t) pcm[0];
+    block[1] = (uint8_t) ((uint16_t) pcm[0] >> 8);
+    block[2] = (uint8_t) *step_index;
+    for (int32_t i = 1; i < padded_length; i++) {
+        const uint8_t nibble = encode_reference(pcm[(i < length) ? i : (length - 1)], &predictor, step_index);
+        block[4 + ((i - 1) / 2)] |= (uint8_t) (((i - 1) % 2) ? (nibble << 4) : nibble);
+    }
+}
+
+static void check_stream(const int16_t *pcm, int32_t length, double min_snr_db, const char *function, int32_t line) {
+    static uint8_t block[BLOCK_ALIGN];
+    static uint8_t expected[BLOCK_ALIGN];
+    static int16_t decoded[SAMPLES_PER_BLOCK];
+
+    pv_adpcm_encoder_t encoder;
+    pv_adpcm_encoder_init(&encoder);
+    int32_t reference_step_index = 0;
+    double signal = 0.;
+    double noise = 0.;
+    for (int32_t start = 0; start < length; start += SAMPLES_PER_BLOCK) {
+        const int32_t n = ((length - start) < SAMPLES_PER_BLOCK) ? (length - start) : SAMPLES_PER_BLOCK;
+        const int32_t block_length = pv_adpcm_block_length(n);
+        check_condition(
+                pv_adpcm_encode_block(&encoder, &pcm[start], n, block) == PV_RECORDER_STATUS_SUCCESS,
+                function,
+                line,
+                "Failed to encode %d samples at %d",
+                n,
+                start);
+        encode_block_reference(&reference_step_index, &pcm[start], n, expected);
+        check_condition(
+                memcmp(block, expected, (size_t) block_length) == 0,
+                function,
+                line,
+                "Block at %d differs from the reference encoder",
+                start);
+
+        check_condition(
+                pv_adpcm_decode_block(block, block_length, decoded) == PV_RECORDER_STATUS_SUCCESS,
+                function,
+                line,
+                "Failed to decode the block at %d",
+                start);
+        check_condition(decoded[0] == pcm[start], function, line, "First sample of the block at %d not kept", start);
+        for (int32_t i = 0; i < n; i++) {
+            signal += (double) pcm[start + i] * pcm[start + i];
+            noise += (double) (pcm[start + i] - decoded[i]) * (pcm[start + i] - decoded[i]);
+        }
+    }
+    if (min_snr_db > 0) {
+        const double snr_db = 10. * log10(signal / ((noise > 0) ? noise : 1.));
+        check_condition(snr_db >= min_snr_db, function, line, "SNR of %.1f dB is below %.1f dB", snr_db, min_snr_db);
+    }
+}
+
+static void test_pv_adpcm_tone(void) {
+    static int16_t pcm[SAMPLES_PER_BLOCK * BLOCK_COUNT];
+    const int32_t length = SAMPLES_PER_BLOCK * BLOCK_COUNT;
+    for (int32_t i = 0; i < length; i++) {
+        // a 440 Hz tone at 16 kHz, fading in, as speech at a few metres would
+        pcm[i] = (int16_t) (((float) i / (float) length) * 12000.f * sinf(2.f * (float) M_PI * 440.f * i / 16000.f));
+    }
+    check_stream(pcm, length, 20., __FUNCTION__, __LINE__);
+}
+
+static void test_pv_adpcm_random(void) {
+    static int16_t pcm[SAMPLES_PER_BLOCK * BLOCK_COUNT];
+    const int32_t length = SAMPLES_PER_BLOCK * BLOCK_COUNT;
+    for (int32_t i = 0; i < length; i++) {
+        pcm[i] = (int16_t) ((rand() % 65536) - 32768);
+    }
+    // noise can't be predicted, but the steps, clamps and packing must still match the reference
+    check_stream(pcm, length, 0., __FUNCTION__, __LINE__);
+
+    for (int32_t i = 0; i < length; i++) {
+        pcm[i] = (i % 64 < 32) ? INT16_MAX : INT16_MIN;
+    }
+    check_stream(pcm, length, 0., __FUNCTION__, __LINE__);
+}
+
+static void test_pv_adpcm_short_block(void) {
+    static int16_t pcm[SAMPLES_PER_BLOCK + 10];
+    for (int32_t i = 0; i < SAMPLES_PER_BLOCK + 10; i++) {
+        pcm[i] = (int16_t) (8000.f * sinf(2.f * (float) M_PI * 1000.f * i / 16000.f));
+    }
+    for (int32_t extra = 1; extra <= 10; extra++) {
+        check_condition(
+                pv_adpcm_block_length(extra) == ((extra == 1) ? 4 : ((extra <= 9) ? 8 : 12)),
+                __FUNCTION__,
+                __LINE__,
+                "Wrong length for a block of %d samples",
+                extra);
+        check_stream(pcm, SAMPLES_PER_BLOCK + extra, 0., __FUNCTION__, __LINE__);
+    }
+    check_condition(
+            pv_adpcm_block_length(SAMPLES_PER_BLOCK) == BLOCK_ALIGN,
+            __FUNCTION__,
+            __LINE__,
+            "A full block isn't %d bytes",
+            BLOCK_ALIGN);
+}
+
+static void test_pv_adpcm_invalid(void) {
+    pv_adpcm_encoder_t encoder;
+    pv_adpcm_encoder_init(&encoder);
+    int16_t pcm[8] = {0};
+    uint8_t block[8] = {0};
+    check_condition(
+            pv_adpcm_encode_block(&encoder, pcm, 0, block) == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Encoded an empty block");
+    check_condition(
+            pv_adpcm_decode_block(block, 3, pcm) == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Decoded a block shorter than its header");
+    block[2] = 89;
+    check_condition(
+            pv_adpcm_decode_block(block, sizeof(block), pcm) == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Decoded a block with a step index out of range");
+}
+
+static uint32_t get_le32(const uint8_t *bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+static void test_pv_adpcm_wav_header(void) {
+    uint8_t header[PV_ADPCM_WAV_HEADER_LENGTH];
+    pv_adpcm_wav_header(16000, BLOCK_ALIGN, 48000, 24064, header);
+
+    check_condition(memcmp(header, "RIFF", 4) == 0, __FUNCTION__, __LINE__, "No RIFF header");
+    check_condition(
+            get_le32(header + 4) == PV_ADPCM_WAV_HEADER_LENGTH - 8 + 24064,
+            __FUNCTION__,
+            __LINE__,
+            "Wrong RIFF size");
+    check_condition(memcmp(header + 8, "WAVEfmt ", 8) == 0, __FUNCTION__, __LINE__, "No fmt chunk");
+    check_condition((header[20] | (header[21] << 8)) == 0x11, __FUNCTION__, __LINE__, "Not IMA-ADPCM");
+    check_condition(get_le32(header + 24) == 16000, __FUNCTION__, __LINE__, "Wrong sample rate");
+    check_condition((header[32] | (header[33] << 8)) == BLOCK_ALIGN, __FUNCTION__, __LINE__, "Wrong block align");
+    check_condition(
+            (header[38] | (header[39] << 8)) == SAMPLES_PER_BLOCK,
+            __FUNCTION__,
+            __LINE__,
+            "Wrong samples per block");
+    check_condition(memcmp(header + 40, "fact", 4) == 0, __FUNCTION__, __LINE__, "No fact chunk");
+    check_condition(get_le32(header + 48) == 48000, __FUNCTION__, __LINE__, "Wrong sample count");
+    check_condition(memcmp(header + 52, "data", 4) == 0, __FUNCTION__, __LINE__, "No data chunk");
+    check_condition(get_le32(header + 56) == 24064, __FUNCTION__, __LINE__, "Wrong data size");
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_adpcm_tone();
+    test_pv_adpcm_random();
+    test_pv_adpcm_short_block();
+    test_pv_adpcm_invalid();
+    test_pv_adpcm_wav_header();
+
+    return 0;
+}
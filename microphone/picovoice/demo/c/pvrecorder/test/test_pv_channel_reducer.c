@@ -0,0 +1,184 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pv_channel_reducer.h"
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void fill_random(int16_t *samples, int32_t length) {
+    for (int32_t i = 0; i < length; i++) {
+        samples[i] = (int16_t) ((rand() % 65536) - 32768);
+    }
+}
+
+static void test_pv_channel_reducer_invalid_arguments(void) {
+    pv_channel_reducer_t *reducer = NULL;
+    pv_channel_reducer_status_t status = pv_channel_reducer_init(0, PV_CHANNEL_REDUCER_MODE_AVERAGE, 0, NULL, &reducer);
+    check_condition(status == PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected invalid argument.");
+
+    status = pv_channel_reducer_init(2, PV_CHANNEL_REDUCER_MODE_SELECT, 2, NULL, &reducer);
+    check_condition(status == PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected invalid argument.");
+
+    const int32_t delays[] = {0, PV_CHANNEL_REDUCER_MAX_DELAY + 1};
+    status = pv_channel_reducer_init(2, PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM, 0, delays, &reducer);
+    check_condition(status == PV_CHANNEL_REDUCER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected invalid argument.");
+    check_condition(reducer == NULL, __FUNCTION__, __LINE__, "Expected no reducer.");
+}
+
+static void test_pv_channel_reducer_select(void) {
+    const int32_t channels = 4;
+    const int32_t frame_count = 37;
+    int16_t input[4 * 37];
+    int16_t output[37];
+    fill_random(input, channels * frame_count);
+
+    pv_channel_reducer_t *reducer = NULL;
+    pv_channel_reducer_status_t status = pv_channel_reducer_init(channels, PV_CHANNEL_REDUCER_MODE_SELECT, 2, NULL, &reducer);
+    check_condition(status == PV_CHANNEL_REDUCER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize reducer.");
+
+    pv_channel_reducer_process(reducer, input, frame_count, output);
+    for (int32_t i = 0; i < frame_count; i++) {
+        check_condition(output[i] == input[(i * channels) + 2], __FUNCTION__, __LINE__, "Wrong sample at %d.", i);
+    }
+
+    pv_channel_reducer_delete(reducer);
+}
+
+static void test_pv_channel_reducer_average(void) {
+    const int32_t frame_count = 101;
+    int16_t input[PV_CHANNEL_REDUCER_MAX_CHANNELS * 101];
+    int16_t output[101];
+
+    // odd frame counts exercise the scalar tail behind the SIMD kernels
+    for (int32_t channels = 1; channels <= PV_CHANNEL_REDUCER_MAX_CHANNELS; channels++) {
+        fill_random(input, channels * frame_count);
+
+        pv_channel_reducer_t *reducer = NULL;
+        pv_channel_reducer_status_t status = pv_channel_reducer_init(
+                channels,
+                PV_CHANNEL_REDUCER_MODE_AVERAGE,
+                0,
+                NULL,
+                &reducer);
+        check_condition(status == PV_CHANNEL_REDUCER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize reducer.");
+
+        pv_channel_reducer_process(reducer, input, frame_count, output);
+        for (int32_t i = 0; i < frame_count; i++) {
+            int32_t sum = 0;
+            for (int32_t c = 0; c < channels; c++) {
+                sum += input[(i * channels) + c];
+            }
+            const double expected = (double) sum / channels;
+            const double error = output[i] - expected;
+            check_condition(
+                    (error <= 0.5) && (error >= -0.5),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Channels %d frame %d: expected %f, got %d.",
+                    channels,
+                    i,
+                    expected,
+                    output[i]);
+        }
+
+        pv_channel_reducer_delete(reducer);
+    }
+}
+
+static void test_pv_channel_reducer_delay_and_sum(void) {
+    const int32_t channels = 4;
+    const int32_t frame_count = 400;
+    const int32_t delays[] = {9, 6, 3, 0};
+    int16_t *input = calloc(channels * frame_count, sizeof(int16_t));
+    int16_t *expected = malloc(frame_count * sizeof(int16_t));
+    int16_t *actual = malloc(frame_count * sizeof(int16_t));
+    check_condition(input && expected && actual, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+
+    // an impulse reaching each channel `delays[c]` frames early lines up at frame 109 after steering
+    for (int32_t c = 0; c < channels; c++) {
+        input[((109 - delays[c]) * channels) + c] = 4000;
+    }
+
+    pv_channel_reducer_t *reducer = NULL;
+    pv_channel_reducer_status_t status = pv_channel_reducer_init(
+            channels,
+            PV_CHANNEL_REDUCER_MODE_DELAY_AND_SUM,
+            0,
+            delays,
+            &reducer);
+    check_condition(status == PV_CHANNEL_REDUCER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize reducer.");
+
+    pv_channel_reducer_process(reducer, input, frame_count, expected);
+    check_condition(expected[109] == 4000, __FUNCTION__, __LINE__, "Steered impulse is %d.", expected[109]);
+
+    // splitting the input must give the same output as the delay line carries frames across calls
+    fill_random(input, channels * frame_count);
+    pv_channel_reducer_reset(reducer);
+    pv_channel_reducer_process(reducer, input, frame_count, expected);
+
+    pv_channel_reducer_reset(reducer);
+    int32_t position = 0;
+    while (position < frame_count) {
+        int32_t length = 1 + (rand() % 23);
+        if (length > (frame_count - position)) {
+            length = frame_count - position;
+        }
+        pv_channel_reducer_process(reducer, input + (position * channels), length, actual + position);
+        position += length;
+    }
+
+    for (int32_t i = 0; i < frame_count; i++) {
+        check_condition(
+                actual[i] == expected[i],
+                __FUNCTION__,
+                __LINE__,
+                "Chunked output differs at index %d: %d vs %d",
+                i,
+                actual[i],
+                expected[i]);
+    }
+
+    pv_channel_reducer_delete(reducer);
+    free(input);
+    free(expected);
+    free(actual);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_channel_reducer_invalid_arguments();
+    test_pv_channel_reducer_select();
+    test_pv_channel_reducer_average();
+    test_pv_channel_reducer_delay_and_sum();
+
+    return 0;
+}
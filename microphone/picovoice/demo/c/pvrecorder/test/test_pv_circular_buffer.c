@@ -15,6 +15,9 @@
 #include <time.h>
 
 #include "pv_circular_buffer.h"
+#include "pv_circular_buffer_typed.h"
+
+PV_CIRCULAR_BUFFER_TYPED(test_ring, int16_t)
 
 static char error_message[256] = {0};
 
@@ -35,7 +38,7 @@ static void check_condition(bool condition, const char *function, int32_t line,
 
 static void test_pv_circular_buffer_once(void) {
     pv_circular_buffer_t *cb;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(128, sizeof(int16_t), &cb);
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(128, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
     int16_t in_buffer[] = {5, 7, -20, 35, 70};
@@ -67,7 +70,7 @@ static void test_pv_circular_buffer_once(void) {
 
 static void test_pv_circular_buffer_read_incomplete(void) {
     pv_circular_buffer_t *cb;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(128, sizeof(int16_t), &cb);
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(128, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
     int32_t out_size = 5;
@@ -86,6 +89,7 @@ static void test_pv_circular_buffer_write_overflow(void) {
     pv_circular_buffer_status_t status = pv_circular_buffer_init(
             10,
             sizeof(int16_t),
+            PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST,
             &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
@@ -98,12 +102,97 @@ static void test_pv_circular_buffer_write_overflow(void) {
     status = pv_circular_buffer_write(cb, in_buffer, in_size);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, __FUNCTION__ , __LINE__, "Expected write overflow.");
 
+    uint64_t overflow_count = pv_circular_buffer_get_overflow_count(cb);
+    check_condition(overflow_count == 8, __FUNCTION__ , __LINE__, "Expected 8 overwritten elements but got %d.", (int32_t) overflow_count);
+
+    // exactly the 8 oldest are gone, so the reader gets the newest 10 in order
+    int16_t out_buffer[10];
+    int32_t length = pv_circular_buffer_read(cb, out_buffer, 10);
+    check_condition(length == 10, __FUNCTION__ , __LINE__, "Expected buffer size to be 10 but got %d.", length);
+
+    const int16_t expected[] = {-100, 5, 7, -20, 35, 70, 100, 0, 1, -100};
+    for (int32_t i = 0; i < 10; i++) {
+        check_condition(out_buffer[i] == expected[i], __FUNCTION__ , __LINE__, "Buffer have incorrect values at %d.", i);
+    }
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_write_overflow_drop_newest(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(
+            10,
+            sizeof(int16_t),
+            PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_NEWEST,
+            &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[] = {1, 2, 3, 4, 5, 6, 7};
+    int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, __FUNCTION__ , __LINE__, "Expected write overflow.");
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, __FUNCTION__ , __LINE__, "Expected write overflow.");
+
+    uint64_t overflow_count = pv_circular_buffer_get_overflow_count(cb);
+    check_condition(overflow_count == 11, __FUNCTION__ , __LINE__, "Expected 11 dropped elements but got %d.", (int32_t) overflow_count);
+
+    int16_t out_buffer[10];
+    int32_t length = pv_circular_buffer_read(cb, out_buffer, 10);
+    check_condition(length == 10, __FUNCTION__ , __LINE__, "Expected buffer size to be 10 but got %d.", length);
+
+    const int16_t expected[] = {1, 2, 3, 4, 5, 6, 7, 1, 2, 3};
+    for (int32_t i = 0; i < 10; i++) {
+        check_condition(out_buffer[i] == expected[i], __FUNCTION__ , __LINE__, "Buffer have incorrect values at %d.", i);
+    }
+
     pv_circular_buffer_delete(cb);
 }
 
+static void test_pv_circular_buffer_write_overflow_block(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(
+            10,
+            sizeof(int16_t),
+            PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_BLOCK,
+            &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[] = {1, 2, 3, 4, 5, 6, 7};
+    int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WOULD_BLOCK, __FUNCTION__ , __LINE__, "Expected the write to block.");
+    check_condition(pv_circular_buffer_get_count(cb) == in_size, __FUNCTION__ , __LINE__, "Expected nothing to be written.");
+
+    // once the reader has made room the same write goes through
+    int16_t out_buffer[7];
+    int32_t length = pv_circular_buffer_read(cb, out_buffer, 4);
+    check_condition(length == 4, __FUNCTION__ , __LINE__, "Expected buffer size to be 4 but got %d.", length);
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+    uint64_t overflow_count = pv_circular_buffer_get_overflow_count(cb);
+    check_condition(overflow_count == 0, __FUNCTION__ , __LINE__, "Expected no lost elements but got %d.", (int32_t) overflow_count);
+
+    pv_circular_buffer_delete(cb);
+
+    status = pv_circular_buffer_init(10, sizeof(int16_t), (pv_circular_buffer_overflow_policy_t) 3, &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT, __FUNCTION__ , __LINE__, "Expected invalid argument.");
+}
+
 static void test_pv_circular_buffer_read_write(void) {
     pv_circular_buffer_t *cb;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(2048, sizeof(int16_t), &cb);
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(2048, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
     int32_t in_size = 512;
@@ -137,7 +226,7 @@ static void test_pv_circular_buffer_read_write(void) {
 
 static void test_pv_circular_buffer_read_write_one_by_one(void) {
     pv_circular_buffer_t *cb;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(12, sizeof(int16_t), &cb);
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(12, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
     int32_t in_size = 64;
@@ -166,7 +255,7 @@ static void test_pv_circular_buffer_read_write_one_by_one(void) {
 
 static void test_pv_circular_buffer_zeros(void) {
     pv_circular_buffer_t *cb;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(100, sizeof(int16_t), &cb);
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(100, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cb);
     check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
 
     int32_t in_size = 100;
@@ -207,15 +296,286 @@ static void test_pv_circular_buffer_zeros(void) {
     pv_circular_buffer_delete(cb);
 }
 
+static void test_pv_circular_buffer_spsc_capacity(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_spsc(1600, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int32_t capacity = pv_circular_buffer_get_capacity(cb);
+    check_condition(capacity == 2048, __FUNCTION__ , __LINE__, "Expected capacity 2048 but got %d.", capacity);
+
+    pv_circular_buffer_delete(cb);
+
+    status = pv_circular_buffer_init_spsc(64, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    capacity = pv_circular_buffer_get_capacity(cb);
+    check_condition(capacity == 64, __FUNCTION__ , __LINE__, "Expected capacity 64 but got %d.", capacity);
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_spsc_read_write_wrap(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_spsc(16, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[7];
+    int16_t out_buffer[7];
+    int16_t value = 0;
+
+    for (int32_t i = 0; i < 100; i++) {
+        for (int32_t j = 0; j < 7; j++) {
+            in_buffer[j] = value++;
+        }
+
+        status = pv_circular_buffer_write(cb, in_buffer, 7);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+        int32_t length = pv_circular_buffer_read(cb, out_buffer, 7);
+        check_condition(length == 7, __FUNCTION__ , __LINE__, "Buffer read received incorrect output length.");
+
+        for (int32_t j = 0; j < 7; j++) {
+            check_condition(in_buffer[j] == out_buffer[j],
+                            __FUNCTION__ ,
+                            __LINE__,
+                            "Read and write buffers have different values at index %d with values: in_buffer: %d, out_buffer: %d",
+                            j,
+                            in_buffer[j],
+                            out_buffer[j]);
+        }
+    }
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_spsc_write_overflow(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_spsc(8, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[] = {1, 2, 3, 4, 5, 6};
+    int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, __FUNCTION__ , __LINE__, "Expected write overflow.");
+
+    uint64_t overflow_count = pv_circular_buffer_get_overflow_count(cb);
+    check_condition(overflow_count == 4, __FUNCTION__ , __LINE__, "Expected 4 dropped elements but got %d.", (int32_t) overflow_count);
+
+    int16_t out_buffer[8];
+    int32_t length = pv_circular_buffer_read(cb, out_buffer, 8);
+    check_condition(length == 8, __FUNCTION__ , __LINE__, "Expected buffer size to be 8 but got %d.", length);
+
+    const int16_t expected[] = {1, 2, 3, 4, 5, 6, 1, 2};
+    for (int32_t i = 0; i < 8; i++) {
+        check_condition(out_buffer[i] == expected[i], __FUNCTION__ , __LINE__, "Buffer have incorrect values at %d.", i);
+    }
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_peek_consume(void) {
+    pv_circular_buffer_t *cbs[2];
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(10, sizeof(int16_t), PV_CIRCULAR_BUFFER_OVERFLOW_POLICY_DROP_OLDEST, &cbs[0]);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+    status = pv_circular_buffer_init_spsc(8, sizeof(int16_t), &cbs[1]);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    for (int32_t k = 0; k < 2; k++) {
+        pv_circular_buffer_t *cb = cbs[k];
+        const int32_t capacity = pv_circular_buffer_get_capacity(cb);
+
+        int16_t in_buffer[] = {1, 2, 3, 4, 5, 6};
+        int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+        int16_t out_buffer[6];
+
+        status = pv_circular_buffer_write(cb, in_buffer, in_size);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+        int32_t length = pv_circular_buffer_read(cb, out_buffer, in_size);
+        check_condition(length == in_size, __FUNCTION__ , __LINE__, "Buffer read received incorrect output length.");
+
+        // the next write wraps around the end of the buffer
+        status = pv_circular_buffer_write(cb, in_buffer, in_size);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+        const void *first = NULL;
+        const void *second = NULL;
+        int32_t first_length = 0;
+        int32_t second_length = 0;
+        length = pv_circular_buffer_peek(cb, in_size, &first, &first_length, &second, &second_length);
+        check_condition(length == in_size, __FUNCTION__ , __LINE__, "Expected peek length %d but got %d.", in_size, length);
+        check_condition(first_length == (capacity - in_size), __FUNCTION__ , __LINE__, "Incorrect first region length %d.", first_length);
+        check_condition(second_length == (in_size - first_length), __FUNCTION__ , __LINE__, "Incorrect second region length %d.", second_length);
+        check_condition(second != NULL, __FUNCTION__ , __LINE__, "Expected a second region.");
+
+        for (int32_t i = 0; i < in_size; i++) {
+            const int16_t value = (i < first_length) ?
+                    ((const int16_t *) first)[i] :
+                    ((const int16_t *) second)[i - first_length];
+            check_condition(value == in_buffer[i], __FUNCTION__ , __LINE__, "Peeked buffer has incorrect value at %d.", i);
+        }
+
+        status = pv_circular_buffer_consume(cb, in_size + 1);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT, __FUNCTION__ , __LINE__, "Expected invalid argument.");
+
+        status = pv_circular_buffer_consume(cb, first_length);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to consume buffer.");
+
+        length = pv_circular_buffer_peek(cb, in_size, &first, &first_length, &second, &second_length);
+        check_condition(length == second_length + first_length, __FUNCTION__ , __LINE__, "Inconsistent peek lengths.");
+        check_condition(second == NULL, __FUNCTION__ , __LINE__, "Expected a single region after consuming.");
+        check_condition(((const int16_t *) first)[0] == in_buffer[in_size - length], __FUNCTION__ , __LINE__, "Incorrect value after consuming.");
+
+        status = pv_circular_buffer_consume(cb, length);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to consume buffer.");
+        check_condition(pv_circular_buffer_get_count(cb) == 0, __FUNCTION__ , __LINE__, "Expected an empty buffer.");
+
+        pv_circular_buffer_delete(cb);
+    }
+}
+
+static void test_pv_circular_buffer_mirrored(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_mirrored(100, sizeof(int16_t), &cb);
+    if (status == PV_CIRCULAR_BUFFER_STATUS_NOT_SUPPORTED) {
+        return;
+    }
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    const int32_t capacity = pv_circular_buffer_get_capacity(cb);
+    check_condition((capacity >= 100) && ((capacity & (capacity - 1)) == 0),
+                    __FUNCTION__ ,
+                    __LINE__,
+                    "Expected a power of two capacity but got %d.",
+                    capacity);
+
+    int32_t in_size = (capacity / 3) + 1;
+    int16_t *in_buffer = malloc(in_size * sizeof(int16_t));
+    int16_t *out_buffer = malloc(in_size * sizeof(int16_t));
+    check_condition((in_buffer != NULL) && (out_buffer != NULL), __FUNCTION__, __LINE__, "Failed to allocate memory.");
+
+    int16_t value = 0;
+    for (int32_t i = 0; i < 10; i++) {
+        for (int32_t j = 0; j < in_size; j++) {
+            in_buffer[j] = value++;
+        }
+
+        status = pv_circular_buffer_write(cb, in_buffer, in_size);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+        const void *first = NULL;
+        const void *second = NULL;
+        int32_t first_length = 0;
+        int32_t second_length = 0;
+        int32_t length = pv_circular_buffer_peek(cb, in_size, &first, &first_length, &second, &second_length);
+        check_condition(length == in_size, __FUNCTION__ , __LINE__, "Expected peek length %d but got %d.", in_size, length);
+        check_condition((first_length == in_size) && (second == NULL), __FUNCTION__ , __LINE__, "Expected a single region.");
+
+        for (int32_t j = 0; j < in_size; j++) {
+            check_condition(((const int16_t *) first)[j] == in_buffer[j], __FUNCTION__ , __LINE__, "Peeked buffer has incorrect value at %d.", j);
+        }
+
+        if (i % 2) {
+            status = pv_circular_buffer_consume(cb, in_size);
+            check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to consume buffer.");
+        } else {
+            length = pv_circular_buffer_read(cb, out_buffer, in_size);
+            check_condition(length == in_size, __FUNCTION__ , __LINE__, "Buffer read received incorrect output length.");
+            for (int32_t j = 0; j < in_size; j++) {
+                check_condition(out_buffer[j] == in_buffer[j], __FUNCTION__ , __LINE__, "Buffer have incorrect values at %d.", j);
+            }
+        }
+    }
+
+    free(in_buffer);
+    free(out_buffer);
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_typed(void) {
+    test_ring_t *ring;
+    pv_circular_buffer_status_t status = test_ring_init(12, &ring);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    const int32_t capacity = test_ring_get_capacity(ring);
+    check_condition(capacity == 16, __FUNCTION__ , __LINE__, "Expected capacity 16 but got %d.", capacity);
+
+    // every write after the first few wraps somewhere else around the end
+    int16_t in_buffer[7];
+    int16_t out_buffer[7];
+    int16_t value = 0;
+    for (int32_t i = 0; i < 100; i++) {
+        for (int32_t j = 0; j < 7; j++) {
+            in_buffer[j] = value++;
+        }
+
+        status = test_ring_write(ring, in_buffer, 7);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+        const int32_t length = test_ring_read(ring, out_buffer, 7);
+        check_condition(length == 7, __FUNCTION__ , __LINE__, "Buffer read received incorrect output length.");
+        for (int32_t j = 0; j < 7; j++) {
+            check_condition(out_buffer[j] == in_buffer[j], __FUNCTION__ , __LINE__, "Buffer have incorrect values at %d.", j);
+        }
+    }
+
+    // a full buffer keeps what it has and counts what it dropped, like the SPSC buffer
+    status = test_ring_write(ring, in_buffer, 7);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+    status = test_ring_write(ring, in_buffer, 7);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+    status = test_ring_write(ring, in_buffer, 7);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW, __FUNCTION__ , __LINE__, "Expected write overflow.");
+
+    const uint64_t overflow_count = test_ring_get_overflow_count(ring);
+    check_condition(overflow_count == 5, __FUNCTION__ , __LINE__, "Expected 5 dropped elements but got %d.", (int32_t) overflow_count);
+    check_condition(test_ring_get_count(ring) == 16, __FUNCTION__ , __LINE__, "Expected a full buffer.");
+
+    const int16_t *first = NULL;
+    const int16_t *second = NULL;
+    int32_t first_length = 0;
+    int32_t second_length = 0;
+    const int32_t length = test_ring_peek(ring, 16, &first, &first_length, &second, &second_length);
+    check_condition(length == 16, __FUNCTION__ , __LINE__, "Expected peek length 16 but got %d.", length);
+    check_condition((first_length + second_length) == 16, __FUNCTION__ , __LINE__, "Inconsistent peek lengths.");
+    for (int32_t i = 0; i < 16; i++) {
+        const int16_t peeked = (i < first_length) ? first[i] : second[i - first_length];
+        check_condition(peeked == in_buffer[i % 7], __FUNCTION__ , __LINE__, "Peeked buffer has incorrect value at %d.", i);
+    }
+
+    status = test_ring_consume(ring, 17);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT, __FUNCTION__ , __LINE__, "Expected invalid argument.");
+    status = test_ring_consume(ring, 16);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to consume buffer.");
+    check_condition(test_ring_get_count(ring) == 0, __FUNCTION__ , __LINE__, "Expected an empty buffer.");
+
+    test_ring_reset(ring);
+    check_condition(test_ring_get_overflow_count(ring) == 0, __FUNCTION__ , __LINE__, "Expected no overflow after a reset.");
+
+    test_ring_delete(ring);
+}
+
 int main() {
     srand(time(NULL));
 
     test_pv_circular_buffer_once();
     test_pv_circular_buffer_read_incomplete();
     test_pv_circular_buffer_write_overflow();
+    test_pv_circular_buffer_write_overflow_drop_newest();
+    test_pv_circular_buffer_write_overflow_block();
     test_pv_circular_buffer_read_write();
     test_pv_circular_buffer_read_write_one_by_one();
     test_pv_circular_buffer_zeros();
+    test_pv_circular_buffer_spsc_capacity();
+    test_pv_circular_buffer_spsc_read_write_wrap();
+    test_pv_circular_buffer_spsc_write_overflow();
+    test_pv_circular_buffer_peek_consume();
+    test_pv_circular_buffer_mirrored();
+    test_pv_circular_buffer_typed();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,182 @@
+/*
+    Copyright 2021-2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pv_decimator.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static double rms(const int16_t *samples, int32_t length) {
+    double sum = 0.0;
+    for (int32_t i = 0; i < length; i++) {
+        sum += (double) samples[i] * samples[i];
+    }
+    return sqrt(sum / length);
+}
+
+static void test_pv_decimator_invalid_factor(void) {
+    pv_decimator_t *decimator = NULL;
+    pv_decimator_status_t status = pv_decimator_init(4, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected invalid argument.");
+    check_condition(decimator == NULL, __FUNCTION__, __LINE__, "Expected no decimator.");
+}
+
+static void test_pv_decimator_dc(void) {
+    for (int32_t factor = 2; factor <= 3; factor++) {
+        pv_decimator_t *decimator = NULL;
+        pv_decimator_status_t status = pv_decimator_init(factor, &decimator);
+        check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+        const int32_t input_length = 960;
+        int16_t input[960];
+        for (int32_t i = 0; i < input_length; i++) {
+            input[i] = 1000;
+        }
+        int16_t output[512];
+        const int32_t length = pv_decimator_process(decimator, input, input_length, output);
+        check_condition(
+                length == (input_length / factor),
+                __FUNCTION__,
+                __LINE__,
+                "Expected %d output samples, got %d.",
+                input_length / factor,
+                length);
+
+        // past the filter's settling time DC must pass through unchanged
+        for (int32_t i = length / 2; i < length; i++) {
+            check_condition(abs(output[i] - 1000) <= 1, __FUNCTION__, __LINE__, "Unexpected DC value %d at %d.", output[i], i);
+        }
+
+        pv_decimator_delete(decimator);
+    }
+}
+
+static void test_pv_decimator_chunked(void) {
+    const int32_t input_length = 4800;
+    int16_t *input = malloc(input_length * sizeof(int16_t));
+    int16_t *expected = malloc(input_length * sizeof(int16_t));
+    int16_t *actual = malloc(input_length * sizeof(int16_t));
+    check_condition(input && expected && actual, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+
+    for (int32_t i = 0; i < input_length; i++) {
+        input[i] = (int16_t) ((rand() % 20000) - 10000);
+    }
+
+    pv_decimator_t *decimator = NULL;
+    pv_decimator_status_t status = pv_decimator_init(3, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+    const int32_t expected_length = pv_decimator_process(decimator, input, input_length, expected);
+
+    // odd chunk sizes leave partial output phases behind between calls
+    pv_decimator_reset(decimator);
+    int32_t actual_length = 0;
+    int32_t position = 0;
+    while (position < input_length) {
+        int32_t length = 1 + (rand() % 97);
+        if (length > (input_length - position)) {
+            length = input_length - position;
+        }
+        actual_length += pv_decimator_process(decimator, input + position, length, actual + actual_length);
+        position += length;
+    }
+
+    check_condition(actual_length == expected_length, __FUNCTION__, __LINE__, "Chunked output has a different length.");
+    for (int32_t i = 0; i < expected_length; i++) {
+        check_condition(
+                actual[i] == expected[i],
+                __FUNCTION__,
+                __LINE__,
+                "Chunked output differs at index %d: %d vs %d",
+                i,
+                actual[i],
+                expected[i]);
+    }
+
+    pv_decimator_delete(decimator);
+    free(input);
+    free(expected);
+    free(actual);
+}
+
+static void test_pv_decimator_stopband(void) {
+    const int32_t input_length = 4800;
+    int16_t input[4800];
+    int16_t output[4800];
+
+    struct {
+        int32_t factor;
+        double pass_hz;
+        double stop_hz;
+        int32_t rate;
+    } cases[] = {
+            {3, 1000.0, 14000.0, 48000},
+            {2, 1000.0, 12000.0, 32000},
+    };
+
+    for (int32_t c = 0; c < (int32_t) (sizeof(cases) / sizeof(cases[0])); c++) {
+        pv_decimator_t *decimator = NULL;
+        pv_decimator_status_t status = pv_decimator_init(cases[c].factor, &decimator);
+        check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+        double levels[2];
+        const double frequencies[2] = {cases[c].pass_hz, cases[c].stop_hz};
+        for (int32_t f = 0; f < 2; f++) {
+            for (int32_t i = 0; i < input_length; i++) {
+                input[i] = (int16_t) (10000.0 * sin((2.0 * M_PI * frequencies[f] * i) / cases[c].rate));
+            }
+            pv_decimator_reset(decimator);
+            const int32_t length = pv_decimator_process(decimator, input, input_length, output);
+            levels[f] = rms(output + (length / 2), length / 2);
+        }
+
+        // a passband tone keeps its level; a tone above the new Nyquist frequency would alias and must be suppressed
+        check_condition(levels[0] > 6500.0, __FUNCTION__, __LINE__, "Passband attenuated to %f.", levels[0]);
+        check_condition(levels[1] < 100.0, __FUNCTION__, __LINE__, "Stopband only attenuated to %f.", levels[1]);
+
+        pv_decimator_delete(decimator);
+    }
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_decimator_invalid_factor();
+    test_pv_decimator_dc();
+    test_pv_decimator_chunked();
+    test_pv_decimator_stopband();
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "pv_frame_bus.h"
+
+static const int32_t FRAME_LENGTH = 512;
+static const int32_t FRAMES = 20000;
+
+static char error_message[256] = {0};
+static char bus_name[64] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void fill_frame(int16_t *pcm, int64_t sequence) {
+    for (int32_t i = 0; i < FRAME_LENGTH; i++) {
+        pcm[i] = (int16_t) (sequence + i);
+    }
+}
+
+static bool is_frame(const int16_t *pcm, int64_t sequence) {
+    for (int32_t i = 0; i < FRAME_LENGTH; i++) {
+        if (pcm[i] != (int16_t) (sequence + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void publish(pv_frame_bus_t *bus, int16_t *pcm, int64_t sequence) {
+    pv_recorder_frame_info_t info = {.timestamp_usec = 1000 * sequence, .sequence_number = sequence, .dropped_samples = 0};
+    fill_frame(pcm, sequence);
+    pv_frame_bus_publish(bus, pcm, &info);
+}
+
+static void test_pv_frame_bus_no_bus(void) {
+    pv_recorder_bus_reader_t *reader = NULL;
+    pv_recorder_status_t status = pv_recorder_bus_reader_init(bus_name, &reader);
+    check_condition(status == PV_RECORDER_STATUS_DEVICE_NOT_INITIALIZED, __FUNCTION__, __LINE__, "Expected no bus.");
+    check_condition(reader == NULL, __FUNCTION__, __LINE__, "Expected no reader.");
+}
+
+static void test_pv_frame_bus_read(void) {
+    pv_frame_bus_t *bus = NULL;
+    pv_recorder_status_t status = pv_frame_bus_init(bus_name, FRAME_LENGTH, 8, &bus);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize bus.");
+
+    int16_t pcm[512];
+    // published before the reader attached, so never seen by it
+    publish(bus, pcm, 100);
+
+    pv_recorder_bus_reader_t *reader = NULL;
+    status = pv_recorder_bus_reader_init(bus_name, &reader);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize reader.");
+    check_condition(
+            pv_recorder_bus_reader_get_frame_length(reader) == FRAME_LENGTH,
+            __FUNCTION__,
+            __LINE__,
+            "Unexpected frame length.");
+
+    status = pv_recorder_bus_reader_read(reader, pcm, NULL, 10);
+    check_condition(status == PV_RECORDER_STATUS_IO_ERROR, __FUNCTION__, __LINE__, "Expected a timeout.");
+
+    for (int64_t i = 0; i < 3; i++) {
+        publish(bus, pcm, i);
+    }
+    for (int64_t i = 0; i < 3; i++) {
+        pv_recorder_frame_info_t info;
+        status = pv_recorder_bus_reader_read(reader, pcm, &info, 10);
+        check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to read frame %d.", (int) i);
+        check_condition(is_frame(pcm, i), __FUNCTION__, __LINE__, "Frame %d has incorrect values.", (int) i);
+        check_condition(
+                (info.sequence_number == i) && (info.timestamp_usec == 1000 * i),
+                __FUNCTION__,
+                __LINE__,
+                "Frame %d has incorrect metadata.",
+                (int) i);
+    }
+
+    // twice the ring's worth: the reader skips to the oldest frame still in it
+    for (int64_t i = 3; i < 19; i++) {
+        publish(bus, pcm, i);
+    }
+    status = pv_recorder_bus_reader_read(reader, pcm, NULL, 10);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to read after overrun.");
+    check_condition(is_frame(pcm, 11), __FUNCTION__, __LINE__, "Expected the oldest frame in the ring.");
+    check_condition(
+            pv_recorder_bus_reader_get_lost_frames(reader) == 8,
+            __FUNCTION__,
+            __LINE__,
+            "Expected 8 lost frames, got %d.",
+            (int) pv_recorder_bus_reader_get_lost_frames(reader));
+
+    pv_frame_bus_delete(bus);
+    for (int64_t i = 12; i < 19; i++) {
+        status = pv_recorder_bus_reader_read(reader, pcm, NULL, 10);
+        check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Expected frames left on a closed bus.");
+        check_condition(is_frame(pcm, i), __FUNCTION__, __LINE__, "Frame %d has incorrect values.", (int) i);
+    }
+    status = pv_recorder_bus_reader_read(reader, pcm, NULL, 1000);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_STATE, __FUNCTION__, __LINE__, "Expected a closed bus.");
+
+    pv_recorder_bus_reader_delete(reader);
+}
+
+typedef struct {
+    pv_recorder_bus_reader_t *reader;
+    int64_t frames;
+    int64_t torn_frames;
+    int64_t out_of_order_frames;
+} reader_thread_t;
+
+static void *reader_thread(void *arg) {
+    reader_thread_t *thread = (reader_thread_t *) arg;
+    int16_t pcm[512];
+    int64_t last = -1;
+    while (true) {
+        pv_recorder_frame_info_t info;
+        if (pv_recorder_bus_reader_read(thread->reader, pcm, &info, 1000) != PV_RECORDER_STATUS_SUCCESS) {
+            break;
+        }
+        thread->frames++;
+        if (!is_frame(pcm, info.sequence_number)) {
+            thread->torn_frames++;
+        }
+        if (info.sequence_number <= last) {
+            thread->out_of_order_frames++;
+        }
+        last = info.sequence_number;
+    }
+    return NULL;
+}
+
+static void test_pv_frame_bus_concurrent_readers(void) {
+    pv_frame_bus_t *bus = NULL;
+    pv_recorder_status_t status = pv_frame_bus_init(bus_name, FRAME_LENGTH, 4, &bus);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize bus.");
+
+    reader_thread_t threads[3] = {{0}};
+    pthread_t ids[3];
+    for (int32_t i = 0; i < 3; i++) {
+        status = pv_recorder_bus_reader_init(bus_name, &threads[i].reader);
+        check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize reader.");
+        pthread_create(&ids[i], NULL, reader_thread, &threads[i]);
+    }
+
+    // a small ring and no pacing, so readers are overrun and slots rewritten while they're copied
+    int16_t pcm[512];
+    for (int64_t i = 0; i < FRAMES; i++) {
+        publish(bus, pcm, i);
+    }
+    pv_frame_bus_delete(bus);
+
+    for (int32_t i = 0; i < 3; i++) {
+        pthread_join(ids[i], NULL);
+        check_condition(threads[i].torn_frames == 0, __FUNCTION__, __LINE__, "Reader %d got torn frames.", i);
+        check_condition(threads[i].out_of_order_frames == 0, __FUNCTION__, __LINE__, "Reader %d went backwards.", i);
+        check_condition(
+                threads[i].frames + pv_recorder_bus_reader_get_lost_frames(threads[i].reader) <= FRAMES,
+                __FUNCTION__,
+                __LINE__,
+                "Reader %d counted more frames than were published.",
+                i);
+        pv_recorder_bus_reader_delete(threads[i].reader);
+    }
+}
+
+int main() {
+    snprintf(bus_name, sizeof(bus_name), "pv_frame_bus_test_%d", (int) getpid());
+
+    test_pv_frame_bus_no_bus();
+    test_pv_frame_bus_read();
+    test_pv_frame_bus_concurrent_readers();
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pv_gain_control.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FRAME_LENGTH (512)
+#define SAMPLE_RATE (16000)
+#define WORD_LENGTH ((4 * SAMPLE_RATE) / 10)
+#define WORD_PERIOD ((6 * SAMPLE_RATE) / 10)
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+
+static double rms(const int16_t *samples, int32_t length) {
+    double sum = 0.0;
+    for (int32_t i = 0; i < length; i++) {
+        sum += (double) samples[i] * samples[i];
+    }
+    return sqrt(sum / length);
+}
+
+static double dbfs(double level) {
+    return 20.0 * log10(level / 32768.0);
+}
+
+static double noise(double amplitude) {
+    return amplitude * (((double) rand() / RAND_MAX) - 0.5);
+}
+
+// Words of 0.4 s with 0.2 s between them: two tones, of `amplitude` each, over a little hiss.
+static int16_t *words(int32_t length, double amplitude) {
+    int16_t *samples = malloc(length * sizeof(int16_t));
+    check_condition(samples != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        double x = noise(20.0);
+        if ((i % WORD_PERIOD) < WORD_LENGTH) {
+            x += amplitude * sin((2.0 * M_PI * 300.0 * i) / SAMPLE_RATE);
+            x += amplitude * sin((2.0 * M_PI * 1100.0 * i) / SAMPLE_RATE);
+        }
+        samples[i] = (int16_t) x;
+    }
+    return samples;
+}
+
+static int16_t *process_all(pv_gain_control_t *gain_control, const int16_t *input, int32_t length) {
+    int16_t *output = malloc(length * sizeof(int16_t));
+    check_condition(output != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i += FRAME_LENGTH) {
+        const int32_t n = ((length - i) < FRAME_LENGTH) ? (length - i) : FRAME_LENGTH;
+        pv_gain_control_process(gain_control, input + i, n, output + i);
+    }
+    return output;
+}
+
+static int32_t full_scale_samples(const int16_t *samples, int32_t length) {
+    int32_t count = 0;
+    for (int32_t i = 0; i < length; i++) {
+        if ((samples[i] == INT16_MAX) || (samples[i] == INT16_MIN)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void test_pv_gain_control_invalid_arguments(void) {
+    pv_gain_control_t *gain_control = NULL;
+    pv_gain_control_status_t status = pv_gain_control_init(0, -20.0f, 12.0f, &gain_control);
+    check_condition(status == PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__,
+            "Expected invalid argument for sample rate 0.");
+    check_condition(gain_control == NULL, __FUNCTION__, __LINE__, "Expected no gain control.");
+
+    const float targets[] = {-41.0f, -2.0f, NAN};
+    for (int32_t i = 0; i < (int32_t) (sizeof(targets) / sizeof(targets[0])); i++) {
+        status = pv_gain_control_init(SAMPLE_RATE, targets[i], 12.0f, &gain_control);
+        check_condition(
+                status == PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Expected invalid argument for target %f.",
+                targets[i]);
+    }
+
+    const float max_gains[] = {-1.0f, 25.0f, NAN};
+    for (int32_t i = 0; i < (int32_t) (sizeof(max_gains) / sizeof(max_gains[0])); i++) {
+        status = pv_gain_control_init(SAMPLE_RATE, -20.0f, max_gains[i], &gain_control);
+        check_condition(
+                status == PV_GAIN_CONTROL_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Expected invalid argument for maximum gain %f.",
+                max_gains[i]);
+    }
+}
+
+static void test_pv_gain_control_levels(void) {
+    // a board far from the speaker, one about right, and one that nearly clips all end up near the target
+    const double amplitudes[] = {250.0, 1500.0, 12000.0};
+    const int32_t length = 6 * SAMPLE_RATE;
+    for (int32_t i = 0; i < (int32_t) (sizeof(amplitudes) / sizeof(amplitudes[0])); i++) {
+        int16_t *input = words(length, amplitudes[i]);
+        pv_gain_control_t *gain_control = NULL;
+        pv_gain_control_status_t status = pv_gain_control_init(SAMPLE_RATE, -20.0f, 24.0f, &gain_control);
+        check_condition(status == PV_GAIN_CONTROL_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+        int16_t *output = process_all(gain_control, input, length);
+
+        // the tenth word, once settled
+        const int32_t from = (9 * WORD_PERIOD) + (SAMPLE_RATE / 20);
+        const int32_t word_length = WORD_LENGTH - (SAMPLE_RATE / 10);
+        const double level_in = dbfs(rms(input + from, word_length));
+        const double level_out = dbfs(rms(output + from, word_length));
+        check_condition(fabs(level_out + 20.0) < 3.0, __FUNCTION__, __LINE__,
+                "Word at %.1f dBFS came out at %.1f dBFS.", level_in, level_out);
+        check_condition(full_scale_samples(output, length) == 0, __FUNCTION__, __LINE__,
+                "Word at %.1f dBFS clipped.", level_in);
+
+        pv_gain_control_delete(gain_control);
+        free(input);
+        free(output);
+    }
+}
+
+static void test_pv_gain_control_holds_in_silence(void) {
+    const int32_t length = 5 * SAMPLE_RATE;
+    int16_t *input = malloc(length * sizeof(int16_t));
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        input[i] = (int16_t) noise(40.0);
+    }
+
+    pv_gain_control_t *gain_control = NULL;
+    pv_gain_control_status_t status = pv_gain_control_init(SAMPLE_RATE, -20.0f, 24.0f, &gain_control);
+    check_condition(status == PV_GAIN_CONTROL_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    int16_t *output = process_all(gain_control, input, length);
+
+    // hiss alone isn't turned up to the maximum gain
+    const float gain_db = pv_gain_control_get_gain_db(gain_control);
+    check_condition(fabsf(gain_db) < 0.1f, __FUNCTION__, __LINE__, "Gain moved to %f dB in silence.", gain_db);
+
+    pv_gain_control_delete(gain_control);
+    free(input);
+    free(output);
+}
+
+static void test_pv_gain_control_sudden_shout(void) {
+    const int32_t length = 4 * SAMPLE_RATE;
+    const int32_t shout_start = 3 * SAMPLE_RATE;
+    int16_t *input = malloc(length * sizeof(int16_t));
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        const double amplitude = (i < shout_start) ? 300.0 : 20000.0;
+        input[i] = (int16_t) (amplitude * sin((2.0 * M_PI * 440.0 * i) / SAMPLE_RATE));
+    }
+
+    pv_gain_control_t *gain_control = NULL;
+    pv_gain_control_status_t status = pv_gain_control_init(SAMPLE_RATE, -20.0f, 24.0f, &gain_control);
+    check_condition(status == PV_GAIN_CONTROL_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    int16_t *output = process_all(gain_control, input, length);
+
+    // turned well up for the quiet tone, yet the shout doesn't clip on its first block
+    const int32_t quiet_length = SAMPLE_RATE / 10;
+    const double quiet_gain = rms(output + shout_start - quiet_length, quiet_length) /
+                              rms(input + shout_start - quiet_length, quiet_length);
+    check_condition(quiet_gain > 6.0, __FUNCTION__, __LINE__, "Quiet tone only turned up by %f.", quiet_gain);
+    const int32_t clipped = full_scale_samples(output + shout_start, length - shout_start);
+    check_condition(clipped == 0, __FUNCTION__, __LINE__, "Shout clipped %d samples.", clipped);
+
+    pv_gain_control_delete(gain_control);
+    free(input);
+    free(output);
+}
+
+static void test_pv_gain_control_in_place_and_reset(void) {
+    const int32_t length = 2 * SAMPLE_RATE + 100;
+    int16_t *input = words(length, 400.0);
+
+    pv_gain_control_t *gain_control = NULL;
+    pv_gain_control_status_t status = pv_gain_control_init(SAMPLE_RATE, -18.0f, 20.0f, &gain_control);
+    check_condition(status == PV_GAIN_CONTROL_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    int16_t *expected = process_all(gain_control, input, length);
+
+    // after a reset it starts over exactly, and it may write over its input
+    pv_gain_control_reset(gain_control);
+    for (int32_t i = 0; i < length; i += FRAME_LENGTH) {
+        const int32_t n = ((length - i) < FRAME_LENGTH) ? (length - i) : FRAME_LENGTH;
+        pv_gain_control_process(gain_control, input + i, n, input + i);
+    }
+    check_condition(memcmp(input, expected, length * sizeof(int16_t)) == 0, __FUNCTION__, __LINE__,
+            "Output after a reset differs.");
+
+    pv_gain_control_delete(gain_control);
+    free(input);
+    free(expected);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_gain_control_invalid_arguments();
+    test_pv_gain_control_levels();
+    test_pv_gain_control_holds_in_silence();
+    test_pv_gain_control_sudden_shout();
+    test_pv_gain_control_in_place_and_reset();
+
+    return 0;
+}
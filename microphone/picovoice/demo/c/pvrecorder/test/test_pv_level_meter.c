@@ -0,0 +1,146 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pv_level_meter.h"
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void fill_random(int16_t *samples, int32_t length) {
+    for (int32_t i = 0; i < length; i++) {
+        samples[i] = (int16_t) ((rand() % 65536) - 32768);
+    }
+}
+
+static void measure_reference(const int16_t *pcm, int32_t length, pv_level_t *level) {
+    double sum_squares = 0;
+    int32_t peak = 0;
+    int32_t clipped_samples = 0;
+    for (int32_t i = 0; i < length; i++) {
+        sum_squares += (double) pcm[i] * (double) pcm[i];
+        const int32_t magnitude = abs((int32_t) pcm[i]);
+        if (magnitude > peak) {
+            peak = (magnitude > INT16_MAX) ? INT16_MAX : magnitude;
+        }
+        if ((pcm[i] == INT16_MIN) || (pcm[i] == INT16_MAX)) {
+            clipped_samples++;
+        }
+    }
+    level->rms = (length > 0) ? (float) sqrt(sum_squares / (double) length) : 0.f;
+    level->peak = peak;
+    level->clipped_samples = clipped_samples;
+}
+
+static void check_level(const int16_t *pcm, int32_t length, const char *function, int32_t line) {
+    pv_level_t expected;
+    measure_reference(pcm, length, &expected);
+    pv_level_t actual;
+    pv_level_meter_measure(pcm, length, &actual);
+
+    check_condition(
+            fabsf(actual.rms - expected.rms) <= (1e-4f * expected.rms) + 1e-3f,
+            function,
+            line,
+            "Wrong RMS for %d samples: %f vs %f",
+            length,
+            actual.rms,
+            expected.rms);
+    check_condition(
+            actual.peak == expected.peak,
+            function,
+            line,
+            "Wrong peak for %d samples: %d vs %d",
+            length,
+            actual.peak,
+            expected.peak);
+    check_condition(
+            actual.clipped_samples == expected.clipped_samples,
+            function,
+            line,
+            "Wrong clipped samples for %d samples: %d vs %d",
+            length,
+            actual.clipped_samples,
+            expected.clipped_samples);
+}
+
+static void test_pv_level_meter_random(void) {
+    int16_t pcm[1031];
+    // lengths that aren't multiples of 8 exercise the scalar tail behind the SIMD kernels
+    for (int32_t length = 1; length <= 1031; length += 17) {
+        fill_random(pcm, length);
+        check_level(pcm, length, __FUNCTION__, __LINE__);
+    }
+}
+
+static void test_pv_level_meter_full_scale(void) {
+    int16_t pcm[61];
+    for (int32_t i = 0; i < 61; i++) {
+        pcm[i] = (i % 3 == 0) ? INT16_MIN : ((i % 3 == 1) ? INT16_MAX : (int16_t) (i - 30));
+    }
+    check_level(pcm, 61, __FUNCTION__, __LINE__);
+
+    for (int32_t i = 0; i < 61; i++) {
+        pcm[i] = INT16_MIN;
+    }
+    pv_level_t level;
+    pv_level_meter_measure(pcm, 61, &level);
+    check_condition(level.peak == INT16_MAX, __FUNCTION__, __LINE__, "Expected INT16_MIN to count as 32767.");
+    check_condition(level.clipped_samples == 61, __FUNCTION__, __LINE__, "Expected every sample to be clipped.");
+    check_condition(fabsf(level.rms - 32768.f) < 1e-2f, __FUNCTION__, __LINE__, "Expected an RMS of 32768.");
+}
+
+static void test_pv_level_meter_silence(void) {
+    int16_t pcm[512] = {0};
+    pv_level_t level;
+    pv_level_meter_measure(pcm, 512, &level);
+    check_condition(level.rms == 0.f, __FUNCTION__, __LINE__, "Expected no energy.");
+    check_condition(level.peak == 0, __FUNCTION__, __LINE__, "Expected no peak.");
+    check_condition(level.clipped_samples == 0, __FUNCTION__, __LINE__, "Expected no clipping.");
+
+    pcm[511] = -1;
+    pv_level_meter_measure(pcm, 512, &level);
+    check_condition(level.peak == 1, __FUNCTION__, __LINE__, "Expected a peak of 1 from the last sample.");
+
+    level.peak = 7;
+    pv_level_meter_measure(pcm, 0, &level);
+    check_condition(level.peak == 0, __FUNCTION__, __LINE__, "Expected an empty block to measure zero.");
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_level_meter_random();
+    test_pv_level_meter_full_scale();
+    test_pv_level_meter_silence();
+
+    return 0;
+}
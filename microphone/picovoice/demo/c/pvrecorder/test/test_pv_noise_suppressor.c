@@ -0,0 +1,229 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pv_noise_suppressor.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FRAME_LENGTH (512)
+#define SAMPLE_RATE (16000)
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static double rms(const int16_t *samples, int32_t length) {
+    double sum = 0.0;
+    for (int32_t i = 0; i < length; i++) {
+        sum += (double) samples[i] * samples[i];
+    }
+    return sqrt(sum / length);
+}
+
+// Amplitude of one frequency, by correlating with a sine and a cosine.
+static double tone_level(const int16_t *samples, int32_t length, double hz) {
+    double re = 0.0;
+    double im = 0.0;
+    for (int32_t i = 0; i < length; i++) {
+        re += samples[i] * cos((2.0 * M_PI * hz * i) / SAMPLE_RATE);
+        im += samples[i] * sin((2.0 * M_PI * hz * i) / SAMPLE_RATE);
+    }
+    return (2.0 * sqrt((re * re) + (im * im))) / length;
+}
+
+static double noise(double amplitude) {
+    return amplitude * (((double) rand() / RAND_MAX) - 0.5);
+}
+
+// A pump: 100 Hz hum and its harmonics, and some hiss.
+static int16_t pump(int32_t i) {
+    double x = noise(400.0);
+    for (int32_t harmonic = 1; harmonic <= 4; harmonic++) {
+        x += (1600.0 / harmonic) * sin((2.0 * M_PI * 100.0 * harmonic * i) / SAMPLE_RATE);
+    }
+    return (int16_t) x;
+}
+
+static int16_t *process_all(pv_noise_suppressor_t *suppressor, const int16_t *input, int32_t length) {
+    int16_t *output = malloc(length * sizeof(int16_t));
+    check_condition(output != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; (i + FRAME_LENGTH) <= length; i += FRAME_LENGTH) {
+        pv_noise_suppressor_process(suppressor, input + i, output + i);
+    }
+    return output;
+}
+
+static void test_pv_noise_suppressor_invalid_arguments(void) {
+    const int32_t frame_lengths[] = {0, 32, 500, 4096};
+    for (int32_t i = 0; i < (int32_t) (sizeof(frame_lengths) / sizeof(frame_lengths[0])); i++) {
+        pv_noise_suppressor_t *suppressor = NULL;
+        pv_noise_suppressor_status_t status = pv_noise_suppressor_init(frame_lengths[i], 12.0f, &suppressor);
+        check_condition(
+                status == PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Expected invalid argument for frame length %d.",
+                frame_lengths[i]);
+        check_condition(suppressor == NULL, __FUNCTION__, __LINE__, "Expected no suppressor.");
+    }
+
+    const float attenuations[] = {0.0f, 41.0f, NAN};
+    for (int32_t i = 0; i < (int32_t) (sizeof(attenuations) / sizeof(attenuations[0])); i++) {
+        pv_noise_suppressor_t *suppressor = NULL;
+        pv_noise_suppressor_status_t status = pv_noise_suppressor_init(FRAME_LENGTH, attenuations[i], &suppressor);
+        check_condition(
+                status == PV_NOISE_SUPPRESSOR_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Expected invalid argument for attenuation %f.",
+                attenuations[i]);
+    }
+}
+
+static void test_pv_noise_suppressor_passes_loud_signal(void) {
+    const int32_t length = 3 * SAMPLE_RATE;
+    const int32_t loud_start = 2 * SAMPLE_RATE;
+    const int32_t loud_length = (3 * SAMPLE_RATE) / 10;
+    int16_t *input = malloc(length * sizeof(int16_t));
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        double x = noise(60.0);
+        if ((i >= loud_start) && (i < (loud_start + loud_length))) {
+            x += (8000.0 * sin((2.0 * M_PI * 440.0 * i) / SAMPLE_RATE)) +
+                 (4000.0 * sin((2.0 * M_PI * 1250.0 * i) / SAMPLE_RATE));
+        }
+        input[i] = (int16_t) x;
+    }
+
+    pv_noise_suppressor_t *suppressor = NULL;
+    pv_noise_suppressor_status_t status = pv_noise_suppressor_init(FRAME_LENGTH, 12.0f, &suppressor);
+    check_condition(status == PV_NOISE_SUPPRESSOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    const int32_t delay = pv_noise_suppressor_get_delay(suppressor);
+    check_condition(delay == (FRAME_LENGTH / 2), __FUNCTION__, __LINE__, "Unexpected delay %d.", delay);
+
+    int16_t *output = process_all(suppressor, input, length);
+
+    // far above the noise, a word comes out much as it went in, only later
+    const int32_t from = loud_start + FRAME_LENGTH;
+    const int32_t to = loud_start + loud_length;
+    double error = 0.0;
+    for (int32_t i = from; i < to; i++) {
+        const double difference = output[i + delay] - input[i];
+        error += difference * difference;
+    }
+    error = sqrt(error / (to - from));
+    const double level = rms(input + from, to - from);
+    check_condition(error < (0.1 * level), __FUNCTION__, __LINE__, "Loud signal of %f RMS changed by %f.", level,
+            error);
+
+    pv_noise_suppressor_delete(suppressor);
+    free(input);
+    free(output);
+}
+
+static void test_pv_noise_suppressor_pump(void) {
+    const int32_t length = 4 * SAMPLE_RATE;
+    const int32_t speech_start = 3 * SAMPLE_RATE;
+    const int32_t speech_length = SAMPLE_RATE / 4;
+    int16_t *input = malloc(length * sizeof(int16_t));
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        double x = pump(i);
+        if ((i >= speech_start) && (i < (speech_start + speech_length))) {
+            x += 3000.0 * sin((2.0 * M_PI * 850.0 * i) / SAMPLE_RATE);
+        }
+        input[i] = (int16_t) x;
+    }
+
+    pv_noise_suppressor_t *suppressor = NULL;
+    pv_noise_suppressor_status_t status = pv_noise_suppressor_init(FRAME_LENGTH, 12.0f, &suppressor);
+    check_condition(status == PV_NOISE_SUPPRESSOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    const int32_t delay = pv_noise_suppressor_get_delay(suppressor);
+    int16_t *output = process_all(suppressor, input, length);
+
+    // once learned, the pump is turned down by about the attenuation
+    const int32_t pump_from = 2 * SAMPLE_RATE;
+    const double pump_in = rms(input + pump_from - delay, SAMPLE_RATE / 2);
+    const double pump_out = rms(output + pump_from, SAMPLE_RATE / 2);
+    check_condition(pump_out < (pump_in / 3.0), __FUNCTION__, __LINE__, "Pump only went from %f to %f.", pump_in,
+            pump_out);
+
+    // while a voice over it keeps its level
+    const int32_t voice_from = speech_start + delay + (FRAME_LENGTH / 2);
+    const int32_t voice_length = speech_length - FRAME_LENGTH;
+    const double voice_in = tone_level(input + voice_from - delay, voice_length, 850.0);
+    const double voice_out = tone_level(output + voice_from, voice_length, 850.0);
+    check_condition(voice_out > (0.85 * voice_in), __FUNCTION__, __LINE__, "Voice went from %f to %f.", voice_in,
+            voice_out);
+
+    pv_noise_suppressor_delete(suppressor);
+    free(input);
+    free(output);
+}
+
+static void test_pv_noise_suppressor_in_place_and_reset(void) {
+    const int32_t length = 32 * FRAME_LENGTH;
+    int16_t *input = malloc(length * sizeof(int16_t));
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    for (int32_t i = 0; i < length; i++) {
+        input[i] = pump(i);
+    }
+
+    pv_noise_suppressor_t *suppressor = NULL;
+    pv_noise_suppressor_status_t status = pv_noise_suppressor_init(FRAME_LENGTH, 20.0f, &suppressor);
+    check_condition(status == PV_NOISE_SUPPRESSOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize.");
+    int16_t *expected = process_all(suppressor, input, length);
+
+    // after a reset it starts over exactly, and it may write over its input
+    pv_noise_suppressor_reset(suppressor);
+    for (int32_t i = 0; (i + FRAME_LENGTH) <= length; i += FRAME_LENGTH) {
+        pv_noise_suppressor_process(suppressor, input + i, input + i);
+    }
+    check_condition(memcmp(input, expected, length * sizeof(int16_t)) == 0, __FUNCTION__, __LINE__,
+            "Output after a reset differs.");
+
+    pv_noise_suppressor_delete(suppressor);
+    free(input);
+    free(expected);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_noise_suppressor_invalid_arguments();
+    test_pv_noise_suppressor_passes_loud_signal();
+    test_pv_noise_suppressor_pump();
+    test_pv_noise_suppressor_in_place_and_reset();
+
+    return 0;
+}
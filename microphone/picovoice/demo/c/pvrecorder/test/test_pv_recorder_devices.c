@@ -0,0 +1,121 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pv_recorder.h"
+#include "pv_recorder_devices.h"
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void count_call(void *user_data) {
+    (*(int32_t *) user_data)++;
+}
+
+static void test_pv_recorder_devices_list(void) {
+    int32_t count = 0;
+    char **devices = NULL;
+    pv_recorder_status_t status = pv_recorder_get_audio_devices(&count, &devices);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to list devices.");
+    // miniaudio's null backend always has a device
+    check_condition(count > 0, __FUNCTION__, __LINE__, "Expected at least one device.");
+
+    // a second listing comes from the same context, cached or not, and is an independent copy
+    int32_t again_count = 0;
+    char **again = NULL;
+    status = pv_recorder_get_audio_devices(&again_count, &again);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to list devices again.");
+    check_condition(again_count == count, __FUNCTION__, __LINE__, "Expected %d devices, got %d.", count, again_count);
+    for (int32_t i = 0; i < count; i++) {
+        check_condition(strcmp(devices[i], again[i]) == 0, __FUNCTION__, __LINE__, "Device %d changed name.", i);
+        check_condition(devices[i] != again[i], __FUNCTION__, __LINE__, "Device %d name is shared.", i);
+    }
+
+    pv_recorder_free_device_list(count, devices);
+    pv_recorder_free_device_list(again_count, again);
+}
+
+static void test_pv_recorder_devices_listeners(void) {
+    int32_t first = 0;
+    int32_t second = 0;
+    pv_recorder_status_t status = pv_recorder_devices_add_listener(count_call, &first);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to add a listener.");
+    status = pv_recorder_devices_add_listener(count_call, &second);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to add a listener.");
+
+    // only the listener with the same user data goes, and removing one twice is harmless
+    pv_recorder_devices_remove_listener(count_call, &first);
+    pv_recorder_devices_remove_listener(count_call, &first);
+    pv_recorder_devices_remove_listener(count_call, &second);
+
+    // without a hotplug change nothing is called
+    check_condition((first == 0) && (second == 0), __FUNCTION__, __LINE__, "Listeners were called.");
+}
+
+static void test_pv_recorder_devices_select_by_name(void) {
+    int32_t count = 0;
+    char **devices = NULL;
+    pv_recorder_status_t status = pv_recorder_get_audio_devices(&count, &devices);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to list devices.");
+
+    pv_recorder_config_t config = pv_recorder_default_config(512);
+    config.device_name = devices[count - 1];
+    pv_recorder_t *recorder = NULL;
+    status = pv_recorder_init_with_config(&config, &recorder);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to open '%s'.",
+            devices[count - 1]);
+    const char *selected = pv_recorder_get_selected_device(recorder);
+    check_condition(strcmp(selected, devices[count - 1]) == 0, __FUNCTION__, __LINE__, "Selected '%s' instead.",
+            selected);
+
+    status = pv_recorder_start(recorder);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to start.");
+    status = pv_recorder_stop(recorder);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to stop.");
+    pv_recorder_delete(recorder);
+
+    // the name takes the place of the index, so an unknown one is an error rather than the default device
+    config.device_name = "no such device";
+    recorder = NULL;
+    status = pv_recorder_init_with_config(&config, &recorder);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__,
+            "Expected invalid argument for an unknown device.");
+    check_condition(recorder == NULL, __FUNCTION__, __LINE__, "Expected no recorder.");
+
+    pv_recorder_free_device_list(count, devices);
+}
+
+int main() {
+    test_pv_recorder_devices_list();
+    test_pv_recorder_devices_listeners();
+    test_pv_recorder_devices_select_by_name();
+
+    return 0;
+}
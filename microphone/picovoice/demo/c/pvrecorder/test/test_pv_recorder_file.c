@@ -0,0 +1,216 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pv_recorder_file.h"
+
+#define SAMPLE_COUNT (16000 + 100)
+
+static char error_message[256] = {0};
+
+static pthread_mutex_t received_lock = PTHREAD_MUTEX_INITIALIZER;
+static int16_t received[SAMPLE_COUNT];
+static int32_t received_length = 0;
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void on_audio(const int16_t *pcm, int32_t length, void *user_data) {
+    (void) user_data;
+    pthread_mutex_lock(&received_lock);
+    if ((received_length + length) <= SAMPLE_COUNT) {
+        memcpy(&received[received_length], pcm, length * sizeof(int16_t));
+        received_length += length;
+    }
+    pthread_mutex_unlock(&received_lock);
+}
+
+static void reset_received(void) {
+    pthread_mutex_lock(&received_lock);
+    received_length = 0;
+    pthread_mutex_unlock(&received_lock);
+}
+
+static int16_t sample_at(int32_t i) {
+    return (int16_t) ((i * 7) - 30000);
+}
+
+static void put_u16(FILE *file, uint16_t value) {
+    fputc(value & 0xFF, file);
+    fputc(value >> 8, file);
+}
+
+static void put_u32(FILE *file, uint32_t value) {
+    put_u16(file, (uint16_t) value);
+    put_u16(file, (uint16_t) (value >> 16));
+}
+
+// A WAV file with a chunk before the format, an odd-length one between format and data, as some recorders write.
+static void write_wav(const char *path, uint16_t channels) {
+    FILE *file = fopen(path, "wb");
+    check_condition(file != NULL, __FUNCTION__, __LINE__, "Failed to create %s.", path);
+    fwrite("RIFF", 1, 4, file);
+    put_u32(file, 0);
+    fwrite("WAVE", 1, 4, file);
+    fwrite("JUNK", 1, 4, file);
+    put_u32(file, 4);
+    put_u32(file, 0);
+    fwrite("fmt ", 1, 4, file);
+    put_u32(file, 16);
+    put_u16(file, 1);
+    put_u16(file, channels);
+    put_u32(file, 16000);
+    put_u32(file, 16000 * 2 * channels);
+    put_u16(file, (uint16_t) (2 * channels));
+    put_u16(file, 16);
+    fwrite("LIST", 1, 4, file);
+    put_u32(file, 3);
+    fwrite("abc", 1, 3, file);
+    fputc(0, file);
+    fwrite("data", 1, 4, file);
+    put_u32(file, SAMPLE_COUNT * 2);
+    for (int32_t i = 0; i < SAMPLE_COUNT; i++) {
+        put_u16(file, (uint16_t) sample_at(i));
+    }
+    fclose(file);
+}
+
+static void write_raw(const char *path) {
+    FILE *file = fopen(path, "wb");
+    check_condition(file != NULL, __FUNCTION__, __LINE__, "Failed to create %s.", path);
+    for (int32_t i = 0; i < SAMPLE_COUNT; i++) {
+        put_u16(file, (uint16_t) sample_at(i));
+    }
+    fclose(file);
+}
+
+static double now_sec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + ((double) now.tv_nsec / 1e9);
+}
+
+static void replay(const char *path, float speed, double *elapsed_sec) {
+    reset_received();
+    pv_recorder_file_t *file = NULL;
+    pv_recorder_status_t status = pv_recorder_file_init(path, speed, on_audio, NULL, &file);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to open %s.", path);
+    check_condition(!pv_recorder_file_is_at_end(file), __FUNCTION__, __LINE__, "Expected a file not yet replayed.");
+
+    const double start = now_sec();
+    status = pv_recorder_file_start(file);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to start the reader.");
+    for (int32_t i = 0; (i < 500) && !pv_recorder_file_is_at_end(file); i++) {
+        usleep(10 * 1000);
+    }
+    *elapsed_sec = now_sec() - start;
+    check_condition(pv_recorder_file_is_at_end(file), __FUNCTION__, __LINE__, "Expected the end of %s.", path);
+    pv_recorder_file_delete(file);
+
+    check_condition(
+            received_length == SAMPLE_COUNT,
+            __FUNCTION__,
+            __LINE__,
+            "Expected %d samples, got %d.",
+            SAMPLE_COUNT,
+            received_length);
+    for (int32_t i = 0; i < SAMPLE_COUNT; i++) {
+        check_condition(received[i] == sample_at(i), __FUNCTION__, __LINE__, "Sample %d is incorrect.", (int) i);
+    }
+}
+
+static void test_pv_recorder_file_init(const char *wav_path, const char *stereo_path) {
+    pv_recorder_file_t *file = NULL;
+    pv_recorder_status_t status = pv_recorder_file_init(NULL, 1.f, on_audio, NULL, &file);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a missing file.");
+    status = pv_recorder_file_init(wav_path, -1.f, on_audio, NULL, &file);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a bad speed.");
+    status = pv_recorder_file_init(wav_path, 1.f, NULL, NULL, &file);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a missing callback.");
+    status = pv_recorder_file_init("/nonexistent/audio.wav", 1.f, on_audio, NULL, &file);
+    check_condition(status == PV_RECORDER_STATUS_BACKEND_ERROR, __FUNCTION__, __LINE__, "Expected a missing file.");
+    status = pv_recorder_file_init(stereo_path, 1.f, on_audio, NULL, &file);
+    check_condition(
+            status == PV_RECORDER_STATUS_BACKEND_ERROR, __FUNCTION__, __LINE__, "Expected a stereo file to fail.");
+
+    status = pv_recorder_file_init(wav_path, 1.f, on_audio, NULL, &file);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to open %s.", wav_path);
+    status = pv_recorder_file_stop(file);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_STATE, __FUNCTION__, __LINE__, "Expected a stopped reader.");
+    pv_recorder_file_delete(file);
+}
+
+static void test_pv_recorder_file_replay(const char *wav_path, const char *raw_path) {
+    double elapsed_sec = 0.;
+    replay(wav_path, 0.f, &elapsed_sec);
+    replay(raw_path, 0.f, &elapsed_sec);
+
+    // a second of audio at 10x takes a tenth of a second, give or take the polling
+    replay(wav_path, 10.f, &elapsed_sec);
+    check_condition(
+            (elapsed_sec > 0.09) && (elapsed_sec < 1.),
+            __FUNCTION__,
+            __LINE__,
+            "Expected about 0.1 s at 10x, took %.3f s.",
+            elapsed_sec);
+}
+
+int main() {
+    char wav_path[] = "/tmp/test_pv_recorder_file_XXXXXX";
+    char stereo_path[] = "/tmp/test_pv_recorder_file_XXXXXX";
+    char raw_path[] = "/tmp/test_pv_recorder_file_XXXXXX";
+    const int wav_fd = mkstemp(wav_path);
+    const int stereo_fd = mkstemp(stereo_path);
+    const int raw_fd = mkstemp(raw_path);
+    check_condition(
+            (wav_fd >= 0) && (stereo_fd >= 0) && (raw_fd >= 0),
+            __FUNCTION__,
+            __LINE__,
+            "Failed to make temporary files.");
+    close(wav_fd);
+    close(stereo_fd);
+    close(raw_fd);
+    write_wav(wav_path, 1);
+    write_wav(stereo_path, 2);
+    write_raw(raw_path);
+
+    test_pv_recorder_file_init(wav_path, stereo_path);
+    test_pv_recorder_file_replay(wav_path, raw_path);
+
+    unlink(wav_path);
+    unlink(stereo_path);
+    unlink(raw_path);
+
+    return 0;
+}
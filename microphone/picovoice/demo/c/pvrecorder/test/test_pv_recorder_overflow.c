@@ -0,0 +1,160 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pv_recorder.h"
+
+#define SAMPLE_RATE (16000)
+#define SAMPLE_COUNT (2 * SAMPLE_RATE)
+#define FRAME_LENGTH (256)
+// 1024 samples, so the ring holds 2048 under PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST
+#define BUFFER_SIZE_MSEC (64)
+#define KEEP_SAMPLES (1024)
+#define STALL_MSEC (500)
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+// Each sample holds its own index in the recording, so a frame tells where in it it came from.
+static int16_t sample_at(int32_t i) {
+    return (int16_t) (i - (SAMPLE_COUNT / 2));
+}
+
+static int32_t index_of(int16_t sample) {
+    return (int32_t) sample + (SAMPLE_COUNT / 2);
+}
+
+static void write_raw(const char *path) {
+    FILE *file = fopen(path, "wb");
+    check_condition(file != NULL, __FUNCTION__, __LINE__, "Failed to create %s.", path);
+    for (int32_t i = 0; i < SAMPLE_COUNT; i++) {
+        const uint16_t value = (uint16_t) sample_at(i);
+        fputc(value & 0xFF, file);
+        fputc(value >> 8, file);
+    }
+    fclose(file);
+}
+
+static int64_t now_usec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+static int32_t check_frame(const int16_t *pcm, const char *function, int32_t line) {
+    const int32_t first = index_of(pcm[0]);
+    for (int32_t i = 1; i < FRAME_LENGTH; i++) {
+        check_condition(index_of(pcm[i]) == (first + i), function, line, "Frame has a gap at sample %d.", i);
+    }
+    return first;
+}
+
+// A reader stalled for longer than the ring resumes on the latest audio, with the skipped samples counted and a
+// timestamp that matches where the frame was in the recording.
+static void test_pv_recorder_overflow_drop_oldest(const char *path) {
+    pv_recorder_config_t config = pv_recorder_default_config(FRAME_LENGTH);
+    config.backend = PV_RECORDER_BACKEND_FILE;
+    config.file_name = path;
+    config.file_speed = 1.f;
+    config.buffer_size_msec = BUFFER_SIZE_MSEC;
+    config.overflow_policy = PV_RECORDER_OVERFLOW_POLICY_DROP_OLDEST;
+    config.log_overflow = false;
+    config.log_silence = false;
+
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status = pv_recorder_init_with_config(&config, &recorder);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to init the recorder.");
+
+    // the replay is paced from its start, so sample i was captured about i / 16000 s after this
+    const int64_t start_usec = now_usec();
+    status = pv_recorder_start(recorder);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to start the recorder.");
+
+    int16_t pcm[FRAME_LENGTH];
+    pv_recorder_frame_info_t info;
+    status = pv_recorder_read_ex(recorder, pcm, &info);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to read the first frame.");
+    check_condition(check_frame(pcm, __FUNCTION__, __LINE__) == 0, __FUNCTION__, __LINE__, "Expected sample 0 first.");
+
+    usleep(STALL_MSEC * 1000);
+
+    status = pv_recorder_read_ex(recorder, pcm, &info);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to read after the stall.");
+    pv_recorder_stats_t stats;
+    status = pv_recorder_get_stats(recorder, &stats);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to get the stats.");
+    const int32_t first = check_frame(pcm, __FUNCTION__, __LINE__);
+
+    // the frame starts a buffer behind the newest audio, give or take the blocks that arrived since
+    const int64_t behind = stats.total_samples - first;
+    check_condition(
+            (behind >= KEEP_SAMPLES) && (behind <= (KEEP_SAMPLES + 1024)),
+            __FUNCTION__,
+            __LINE__,
+            "Expected the latest audio, frame starts at %d of %d captured.",
+            first,
+            (int32_t) stats.total_samples);
+    check_condition(
+            info.dropped_samples == (first - FRAME_LENGTH),
+            __FUNCTION__,
+            __LINE__,
+            "Expected %d dropped samples, got %d.",
+            first - FRAME_LENGTH,
+            (int32_t) info.dropped_samples);
+
+    const int64_t expected_usec = start_usec + (((int64_t) first * 1000000) / SAMPLE_RATE);
+    const int64_t error_usec = info.timestamp_usec - expected_usec;
+    check_condition(
+            (error_usec > -50000) && (error_usec < 50000),
+            __FUNCTION__,
+            __LINE__,
+            "Timestamp is off by %d us.",
+            (int32_t) error_usec);
+
+    pv_recorder_stop(recorder);
+    pv_recorder_delete(recorder);
+}
+
+int main() {
+    char path[] = "/tmp/test_pv_recorder_overflow_XXXXXX";
+    const int fd = mkstemp(path);
+    check_condition(fd >= 0, __FUNCTION__, __LINE__, "Failed to make a temporary file.");
+    close(fd);
+    write_raw(path);
+
+    test_pv_recorder_overflow_drop_oldest(path);
+
+    unlink(path);
+
+    return 0;
+}
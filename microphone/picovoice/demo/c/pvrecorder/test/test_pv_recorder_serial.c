@@ -0,0 +1,233 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pv_recorder_serial.h"
+
+#define SAMPLES_PER_PACKET (512)
+#define MAX_RECEIVED_SAMPLES (16 * SAMPLES_PER_PACKET)
+
+static char error_message[256] = {0};
+
+static pthread_mutex_t received_lock = PTHREAD_MUTEX_INITIALIZER;
+static int16_t received[MAX_RECEIVED_SAMPLES];
+static int32_t received_length = 0;
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void on_audio(const int16_t *pcm, int32_t length, void *user_data) {
+    (void) user_data;
+    pthread_mutex_lock(&received_lock);
+    if ((received_length + length) <= MAX_RECEIVED_SAMPLES) {
+        memcpy(&received[received_length], pcm, length * sizeof(int16_t));
+        received_length += length;
+    }
+    pthread_mutex_unlock(&received_lock);
+}
+
+static int32_t get_received_length(void) {
+    pthread_mutex_lock(&received_lock);
+    const int32_t length = received_length;
+    pthread_mutex_unlock(&received_lock);
+    return length;
+}
+
+static void write_all(int fd, const uint8_t *bytes, int32_t length) {
+    while (length > 0) {
+        const ssize_t written = write(fd, bytes, length);
+        check_condition(written > 0, __FUNCTION__, __LINE__, "Failed to write to the pty.");
+        bytes += written;
+        length -= (int32_t) written;
+    }
+}
+
+static int32_t make_packet(uint8_t *packet, uint8_t type, uint16_t sequence_number, const uint8_t *payload, uint16_t length) {
+    packet[0] = PV_RECORDER_SERIAL_SYNC_0;
+    packet[1] = PV_RECORDER_SERIAL_SYNC_1;
+    packet[2] = type;
+    packet[3] = (uint8_t) sequence_number;
+    packet[4] = (uint8_t) (sequence_number >> 8);
+    packet[5] = (uint8_t) length;
+    packet[6] = (uint8_t) (length >> 8);
+    if (length > 0) {
+        memcpy(&packet[7], payload, length);
+    }
+    const uint16_t crc = pv_recorder_serial_crc(&packet[2], 5 + length);
+    packet[7 + length] = (uint8_t) crc;
+    packet[8 + length] = (uint8_t) (crc >> 8);
+    return 9 + length;
+}
+
+static int32_t make_audio_packet(uint8_t *packet, uint16_t sequence_number) {
+    uint8_t payload[2 * SAMPLES_PER_PACKET];
+    for (int32_t i = 0; i < SAMPLES_PER_PACKET; i++) {
+        const uint16_t sample = (uint16_t) ((sequence_number * 1000) + i);
+        payload[2 * i] = (uint8_t) sample;
+        payload[(2 * i) + 1] = (uint8_t) (sample >> 8);
+    }
+    return make_packet(packet, PV_RECORDER_SERIAL_PACKET_AUDIO, sequence_number, payload, sizeof(payload));
+}
+
+static bool is_audio_packet(const int16_t *pcm, uint16_t sequence_number) {
+    for (int32_t i = 0; i < SAMPLES_PER_PACKET; i++) {
+        if (pcm[i] != (int16_t) ((sequence_number * 1000) + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_pv_recorder_serial_crc(void) {
+    const char *check = "123456789";
+    const uint16_t crc = pv_recorder_serial_crc((const uint8_t *) check, (int32_t) strlen(check));
+    check_condition(crc == 0x29B1, __FUNCTION__, __LINE__, "Expected CRC 0x29B1, got 0x%04X.", crc);
+}
+
+static void test_pv_recorder_serial_init(const char *device_name) {
+    pv_recorder_serial_t *serial = NULL;
+    pv_recorder_status_t status = pv_recorder_serial_init(NULL, 921600, on_audio, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a missing device.");
+    status = pv_recorder_serial_init(device_name, 12345, on_audio, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a bad baud rate.");
+    status = pv_recorder_serial_init(device_name, 115200, NULL, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Expected a missing callback.");
+    status = pv_recorder_serial_init("/nonexistent/tty", 115200, on_audio, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_BACKEND_ERROR, __FUNCTION__, __LINE__, "Expected a missing device.");
+
+    status = pv_recorder_serial_init(device_name, 115200, on_audio, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to open %s.", device_name);
+    status = pv_recorder_serial_stop(serial);
+    check_condition(status == PV_RECORDER_STATUS_INVALID_STATE, __FUNCTION__, __LINE__, "Expected a stopped reader.");
+    pv_recorder_serial_delete(serial);
+}
+
+static void test_pv_recorder_serial_burst(int master, const char *device_name) {
+    pv_recorder_serial_t *serial = NULL;
+    pv_recorder_status_t status = pv_recorder_serial_init(device_name, 921600, on_audio, NULL, &serial);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to open %s.", device_name);
+    status = pv_recorder_serial_start(serial);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to start the reader.");
+
+    uint8_t packet[16 + (2 * SAMPLES_PER_PACKET)];
+    int32_t length = 0;
+
+    // line noise before the burst, including a stray sync byte
+    const uint8_t noise[] = {0x00, 0xFF, PV_RECORDER_SERIAL_SYNC_0, 0x12, 0x5A, PV_RECORDER_SERIAL_SYNC_0};
+    write_all(master, noise, sizeof(noise));
+
+    const uint8_t keyword_index = 2;
+    length = make_packet(packet, PV_RECORDER_SERIAL_PACKET_TRIGGER, 0, &keyword_index, sizeof(keyword_index));
+    write_all(master, packet, length);
+
+    for (uint16_t i = 1; i <= 3; i++) {
+        length = make_audio_packet(packet, i);
+        write_all(master, packet, length);
+    }
+
+    // a flipped payload bit fails the CRC and the packet is dropped
+    length = make_audio_packet(packet, 4);
+    packet[100] ^= 0x01;
+    write_all(master, packet, length);
+
+    length = make_audio_packet(packet, 5);
+    write_all(master, packet, length);
+
+    // an impossible length is rejected as soon as the header is in, and the rest is skipped as noise
+    length = make_audio_packet(packet, 6);
+    packet[5] = 0xFF;
+    packet[6] = 0xFF;
+    write_all(master, packet, length);
+
+    length = make_audio_packet(packet, 7);
+    write_all(master, packet, length);
+
+    length = make_packet(packet, PV_RECORDER_SERIAL_PACKET_END, 8, NULL, 0);
+    write_all(master, packet, length);
+
+    for (int32_t i = 0; (i < 200) && (get_received_length() < (5 * SAMPLES_PER_PACKET)); i++) {
+        usleep(10 * 1000);
+    }
+
+    status = pv_recorder_serial_stop(serial);
+    check_condition(status == PV_RECORDER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to stop the reader.");
+
+    check_condition(
+            received_length == (5 * SAMPLES_PER_PACKET),
+            __FUNCTION__,
+            __LINE__,
+            "Expected %d samples, got %d.",
+            5 * SAMPLES_PER_PACKET,
+            received_length);
+    const uint16_t expected[] = {1, 2, 3, 5, 7};
+    for (int32_t i = 0; i < 5; i++) {
+        check_condition(
+                is_audio_packet(&received[i * SAMPLES_PER_PACKET], expected[i]),
+                __FUNCTION__,
+                __LINE__,
+                "Packet %d has incorrect samples.",
+                (int) i);
+    }
+    check_condition(
+            pv_recorder_serial_get_corrupt_packets(serial) == 2,
+            __FUNCTION__,
+            __LINE__,
+            "Expected 2 corrupt packets, got %d.",
+            (int) pv_recorder_serial_get_corrupt_packets(serial));
+    check_condition(
+            pv_recorder_serial_get_lost_packets(serial) == 2,
+            __FUNCTION__,
+            __LINE__,
+            "Expected 2 lost packets, got %d.",
+            (int) pv_recorder_serial_get_lost_packets(serial));
+
+    pv_recorder_serial_delete(serial);
+}
+
+int main() {
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) {
+        // no pty support in this environment; nothing to loop the line back through
+        fprintf(stderr, "Skipping: no pseudo-terminal available.\n");
+        return 0;
+    }
+    const char *device_name = ptsname(master);
+
+    test_pv_recorder_serial_crc();
+    test_pv_recorder_serial_init(device_name);
+    test_pv_recorder_serial_burst(master, device_name);
+
+    close(master);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pv_sample_format.h"
+
+#define SAMPLE_RATE (16000)
+#define CUTOFF_HZ (10.0f)
+
+static char error_message[256] = {0};
+
+static const char *test_error_message(const char *message, va_list args) {
+    vsnprintf(error_message, sizeof(error_message) / sizeof (error_message[0]), message, args);
+    return error_message;
+}
+
+static void check_condition(bool condition, const char *function, int32_t line, const char *message, ...) {
+    if (condition == 0) {
+        va_list args;
+        va_start(args, message);
+        fprintf(stderr, "%s:%s():at_line %d: %s", __FILE__, function, line, test_error_message(message, args));
+        va_end(args);
+        exit(1);
+    }
+}
+
+static void fill_random(int16_t *samples, int32_t length) {
+    for (int32_t i = 0; i < length; i++) {
+        samples[i] = (int16_t) ((rand() % 65536) - 32768);
+    }
+}
+
+// The filter one sample at a time, in double, as the SIMD blocks have to match.
+static void remove_dc_reference(
+        double pole,
+        const int16_t *input,
+        int32_t length,
+        double *previous_input,
+        double *previous_output,
+        double *output) {
+    for (int32_t i = 0; i < length; i++) {
+        *previous_output = ((double) input[i] - *previous_input) + (pole * *previous_output);
+        *previous_input = input[i];
+        output[i] = *previous_output;
+    }
+}
+
+static void test_pv_sample_format_to_float(void) {
+    int16_t pcm[1031];
+    float output[1031];
+    // lengths that aren't multiples of 8 exercise the scalar tail behind the SIMD kernels
+    for (int32_t length = 1; length <= 1031; length += 17) {
+        fill_random(pcm, length);
+        pcm[0] = INT16_MIN;
+        pv_sample_format_to_float(pcm, length, output);
+        for (int32_t i = 0; i < length; i++) {
+            check_condition(
+                    output[i] == ((float) pcm[i] / 32768.0f),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Wrong sample %d of %d: %f for %d",
+                    i,
+                    length,
+                    output[i],
+                    pcm[i]);
+        }
+    }
+}
+
+static void test_pv_sample_format_dc_blocked(void) {
+    pv_dc_blocker_t blocker;
+    pv_sample_format_init_dc_blocker(SAMPLE_RATE, CUTOFF_HZ, &blocker);
+    double previous_input = 0.0;
+    double previous_output = 0.0;
+
+    int16_t pcm[1031];
+    float output[1031];
+    double expected[1031];
+    // one filter across calls of every length, as frames of any length would carry it on
+    for (int32_t length = 1; length <= 1031; length += 17) {
+        fill_random(pcm, length);
+        pv_sample_format_to_float_dc_blocked(&blocker, pcm, length, output);
+        remove_dc_reference(blocker.pole, pcm, length, &previous_input, &previous_output, expected);
+        for (int32_t i = 0; i < length; i++) {
+            check_condition(
+                    fabs((double) output[i] - (expected[i] / 32768.0)) < 1e-4,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Wrong sample %d of %d: %f vs %f",
+                    i,
+                    length,
+                    output[i],
+                    expected[i] / 32768.0);
+        }
+    }
+}
+
+static void test_pv_sample_format_int16_dc_blocked(void) {
+    pv_dc_blocker_t blocker;
+    pv_sample_format_init_dc_blocker(SAMPLE_RATE, CUTOFF_HZ, &blocker);
+    double previous_input = 0.0;
+    double previous_output = 0.0;
+
+    int16_t pcm[1031];
+    int16_t output[1031];
+    double expected[1031];
+    for (int32_t length = 1; length <= 1031; length += 17) {
+        fill_random(pcm, length);
+        pv_sample_format_to_int16_dc_blocked(&blocker, pcm, length, output);
+        remove_dc_reference(blocker.pole, pcm, length, &previous_input, &previous_output, expected);
+        for (int32_t i = 0; i < length; i++) {
+            const double clamped =
+                    (expected[i] > 32767.0) ? 32767.0 : ((expected[i] < -32768.0) ? -32768.0 : expected[i]);
+            check_condition(
+                    fabs((double) output[i] - clamped) <= 1.0,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Wrong sample %d of %d: %d vs %f",
+                    i,
+                    length,
+                    output[i],
+                    expected[i]);
+        }
+    }
+
+    // in place, as the header allows
+    pv_sample_format_init_dc_blocker(SAMPLE_RATE, CUTOFF_HZ, &blocker);
+    fill_random(pcm, 512);
+    int16_t copy[512];
+    pv_dc_blocker_t twin = blocker;
+    pv_sample_format_to_int16_dc_blocked(&twin, pcm, 512, copy);
+    pv_sample_format_to_int16_dc_blocked(&blocker, pcm, 512, pcm);
+    for (int32_t i = 0; i < 512; i++) {
+        check_condition(pcm[i] == copy[i], __FUNCTION__, __LINE__, "Sample %d differs in place.", i);
+    }
+}
+
+static void test_pv_sample_format_removes_offset(void) {
+    pv_dc_blocker_t blocker;
+    pv_sample_format_init_dc_blocker(SAMPLE_RATE, CUTOFF_HZ, &blocker);
+
+    // a 1 kHz tone on an offset of 4000, for two seconds
+    int16_t pcm[512];
+    float output[512];
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (int32_t frame = 0; frame < 62; frame++) {
+        for (int32_t i = 0; i < 512; i++) {
+            const int32_t n = (frame * 512) + i;
+            pcm[i] = (int16_t) (4000.0 + (8000.0 * sin((2.0 * M_PI * 1000.0 * n) / SAMPLE_RATE)));
+        }
+        pv_sample_format_to_float_dc_blocked(&blocker, pcm, 512, output);
+    }
+    for (int32_t i = 0; i < 512; i++) {
+        sum += output[i];
+        sum_squares += (double) output[i] * output[i];
+    }
+    const double mean = sum / 512.0;
+    const double rms = sqrt(sum_squares / 512.0);
+    check_condition(fabs(mean) < 1e-3, __FUNCTION__, __LINE__, "Expected the offset gone, mean is %f", mean);
+    check_condition(
+            fabs(rms - ((8000.0 / 32768.0) / sqrt(2.0))) < 2e-3,
+            __FUNCTION__,
+            __LINE__,
+            "Expected the tone kept, RMS is %f",
+            rms);
+
+    // digital silence decays to exactly zero rather than through denormals
+    for (int32_t i = 0; i < 512; i++) {
+        pcm[i] = 0;
+    }
+    for (int32_t frame = 0; frame < 2000; frame++) {
+        pv_sample_format_to_float_dc_blocked(&blocker, pcm, 512, output);
+    }
+    check_condition(blocker.previous_output == 0.0f, __FUNCTION__, __LINE__, "Expected the filter to settle at 0.");
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_sample_format_to_float();
+    test_pv_sample_format_dc_blocked();
+    test_pv_sample_format_int16_dc_blocked();
+    test_pv_sample_format_removes_offset();
+
+    return 0;
+}
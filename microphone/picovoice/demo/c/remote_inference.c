@@ -0,0 +1,398 @@
+#ifndef _POSIX_C_SOURCE
+// getaddrinfo and strtok_r under plain C99
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "remote_inference.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "memory_budget.h"
+#include "metrics.h"
+#include "pv_adpcm.h"
+#include "voice_gate.h"
+
+#define MAX_HOST_LENGTH 256
+// the pre-roll the voice gate replays as it opens, and the frame that opened it
+#define MAX_QUEUED_FRAMES (VOICE_GATE_MAX_PRE_ROLL_FRAMES + 1)
+#define KIND_FRAME 1
+#define KIND_PING 2
+// the server only ever sends a line
+#define MAX_DATAGRAM_LENGTH 512
+#define SEPARATORS " \t\r\n"
+
+static int socketFd = -1;
+static int32_t frameLength = 0;
+static int32_t sampleRate = 0;
+static int engineCount = 0;
+
+// inference thread only
+static pv_adpcm_encoder_t encoder;
+static uint8_t* packets = NULL;
+static size_t packetLength = 0;
+static int queuedFrames = 0;
+static uint32_t sequence = 0;
+// 0 until the server first answers
+static long long lastHeardUs = 0;
+static long long nextPingUs = 0;
+static uint32_t pingSequence = 0;
+static long long pingSentUs = 0;
+static bool isLinkUp = false;
+static remoteInference_event events[REMOTE_INFERENCE_MAX_EVENTS];
+static int firstEvent = 0;
+static int eventCount = 0;
+
+static remoteInference_stats counters;
+static metrics_id linkMetric = -1;
+static metrics_id roundTripMetric = -1;
+
+static void count(long long* counter, long long amount)
+{
+    __atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+static void putLe16(uint8_t* bytes, uint16_t value)
+{
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+}
+
+static void putLe32(uint8_t* bytes, uint32_t value)
+{
+    putLe16(bytes, (uint16_t) value);
+    putLe16(bytes + 2, (uint16_t) (value >> 16));
+}
+
+static void putLe64(uint8_t* bytes, uint64_t value)
+{
+    putLe32(bytes, (uint32_t) value);
+    putLe32(bytes + 4, (uint32_t) (value >> 32));
+}
+
+// Splits "HOST:PORT". The last colon counts, so "[::1]:9000" works.
+static bool splitAddress(const char* address, char* host, size_t hostSize, const char** port)
+{
+    const char* colon = strrchr(address, ':');
+    if (!colon || colon == address || colon[1] == '\0') {
+        return false;
+    }
+    size_t length = (size_t) (colon - address);
+    if (length >= 2 && address[0] == '[' && address[length - 1] == ']') {
+        address++;
+        length -= 2;
+    }
+    if (length >= hostSize) {
+        return false;
+    }
+    memcpy(host, address, length);
+    host[length] = '\0';
+    *port = colon + 1;
+    return true;
+}
+
+// A connected datagram socket, so only the server's datagrams arrive on it.
+static int openSocket(const char* server)
+{
+    char host[MAX_HOST_LENGTH];
+    const char* port = NULL;
+    if (!splitAddress(server, host, sizeof(host), &port)) {
+        printf("Remote inference: '%s' should be HOST:PORT.\n", server);
+        return -1;
+    }
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo* addresses = NULL;
+    const int error = getaddrinfo(host, port, &hints, &addresses);
+    if (error != 0) {
+        printf("Remote inference: Unable to resolve '%s': %s.\n", server, gai_strerror(error));
+        return -1;
+    }
+    int fd = -1;
+    for (const struct addrinfo* entry = addresses; entry && fd < 0; entry = entry->ai_next) {
+        fd = socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+        if (fd >= 0 && connect(fd, entry->ai_addr, entry->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        perror("Remote inference: Unable to open socket.");
+    }
+    return fd;
+}
+
+// CLOCK_MONOTONIC to microseconds since the epoch, which the server can line up with other boards
+static long long epochUs(long long monotonicUs)
+{
+    struct timespec wall;
+    struct timespec monotonic;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    clock_gettime(CLOCK_MONOTONIC, &monotonic);
+    const long long wallUs = (long long) wall.tv_sec * 1000000 + wall.tv_nsec / 1000;
+    const long long nowUs = (long long) monotonic.tv_sec * 1000000 + monotonic.tv_nsec / 1000;
+    return wallUs - (nowUs - monotonicUs);
+}
+
+static void putHeader(uint8_t* packet, int kind, int samples, long long frame, long long timeUs)
+{
+    memcpy(packet, "FFRI", 4);
+    packet[4] = (uint8_t) kind;
+    packet[5] = (uint8_t) engineCount;
+    putLe16(packet + 6, (uint16_t) samples);
+    putLe32(packet + 8, (uint32_t) sampleRate);
+    putLe32(packet + 12, sequence++);
+    putLe64(packet + 16, (uint64_t) frame);
+    putLe64(packet + 24, (uint64_t) timeUs);
+}
+
+static bool sendPacket(const uint8_t* packet, size_t length)
+{
+    // refused while the server is down; the link times out for want of answers, so that's all it costs
+    if (send(socketFd, packet, length, MSG_DONTWAIT) != (ssize_t) length) {
+        count(&counters.sendErrors, 1);
+        return false;
+    }
+    return true;
+}
+
+static bool parseNumber(const char* word, long long min, long long max, long long* value)
+{
+    if (!word) {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    *value = strtoll(word, &end, 10);
+    return end != word && *end == '\0' && errno == 0 && *value >= min && *value <= max;
+}
+
+static bool copyWord(char* to, const char* word)
+{
+    if (!word || strlen(word) >= REMOTE_INFERENCE_MAX_WORD) {
+        return false;
+    }
+    memcpy(to, word, strlen(word) + 1);
+    return true;
+}
+
+static bool parseIntent(remoteInference_event* event, char** save)
+{
+    const char* outcome = strtok_r(NULL, SEPARATORS, save);
+    if (!outcome) {
+        return false;
+    }
+    if (strcmp(outcome, "not-understood") == 0) {
+        return true;
+    }
+    if (strcmp(outcome, "understood") != 0 || !copyWord(event->intent, strtok_r(NULL, SEPARATORS, save))) {
+        return false;
+    }
+    event->isUnderstood = true;
+    char* slot;
+    while ((slot = strtok_r(NULL, SEPARATORS, save)) != NULL) {
+        char* equals = strchr(slot, '=');
+        if (!equals || event->slotCount == REMOTE_INFERENCE_MAX_SLOTS) {
+            return false;
+        }
+        *equals = '\0';
+        if (!copyWord(event->slots[event->slotCount], slot) ||
+                !copyWord(event->values[event->slotCount], equals + 1)) {
+            return false;
+        }
+        event->slotCount++;
+    }
+    return true;
+}
+
+// One line from the server. False if it isn't understood, or there's no room left for its event.
+static bool parseDatagram(char* text, long long nowUs)
+{
+    char* save = NULL;
+    const char* word = strtok_r(text, SEPARATORS, &save);
+    if (!word) {
+        return false;
+    }
+    long long value;
+    if (strcmp(word, "pong") == 0) {
+        if (!parseNumber(strtok_r(NULL, SEPARATORS, &save), 0, UINT32_MAX, &value)) {
+            return false;
+        }
+        if ((uint32_t) value == pingSequence && pingSentUs != 0) {
+            __atomic_store_n(&counters.roundTripUs, nowUs - pingSentUs, __ATOMIC_RELAXED);
+            metrics_set(roundTripMetric, (double) (nowUs - pingSentUs) / 1e6);
+            pingSentUs = 0;
+        }
+        return true;
+    }
+    if (eventCount == REMOTE_INFERENCE_MAX_EVENTS) {
+        return false;
+    }
+    remoteInference_event* event = &events[(firstEvent + eventCount) % REMOTE_INFERENCE_MAX_EVENTS];
+    memset(event, 0, sizeof(*event));
+    if (strcmp(word, "wake") == 0) {
+        event->kind = REMOTE_INFERENCE_WAKE;
+    } else if (strcmp(word, "intent") == 0) {
+        event->kind = REMOTE_INFERENCE_INTENT;
+    } else {
+        return false;
+    }
+    if (!parseNumber(strtok_r(NULL, SEPARATORS, &save), 1, engineCount, &value)) {
+        return false;
+    }
+    event->engine = (int) value - 1;
+    if (!parseNumber(strtok_r(NULL, SEPARATORS, &save), 0, LLONG_MAX, &event->frame)) {
+        return false;
+    }
+    if (event->kind == REMOTE_INFERENCE_INTENT && !parseIntent(event, &save)) {
+        return false;
+    }
+    eventCount++;
+    count(&counters.events, 1);
+    return true;
+}
+
+bool remoteInference_start(const char* server, int32_t length, int32_t rate, int engines)
+{
+    frameLength = length;
+    sampleRate = rate;
+    engineCount = engines;
+    queuedFrames = 0;
+    sequence = 0;
+    lastHeardUs = 0;
+    nextPingUs = 0;
+    pingSentUs = 0;
+    isLinkUp = false;
+    firstEvent = 0;
+    eventCount = 0;
+    memset(&counters, 0, sizeof(counters));
+    counters.roundTripUs = -1;
+    pv_adpcm_encoder_init(&encoder);
+    if (linkMetric < 0) {
+        linkMetric = metrics_addGauge("feeder_offload_link",
+                                      "1 while the inference server answers and the frames go to it, 0 while local.");
+        roundTripMetric = metrics_addGauge("feeder_offload_round_trip_seconds",
+                                           "The last ping's round trip to the inference server.");
+    }
+
+    socketFd = openSocket(server);
+    if (socketFd < 0) {
+        return false;
+    }
+    packetLength = REMOTE_INFERENCE_HEADER_LENGTH + (size_t) pv_adpcm_block_length(frameLength);
+    // allocated and touched up front, so they are resident before memory is locked
+    packets = malloc(MAX_QUEUED_FRAMES * packetLength);
+    if (!packets) {
+        printf("Remote inference: Unable to allocate the frames.\n");
+        remoteInference_stop();
+        return false;
+    }
+    memset(packets, 0, MAX_QUEUED_FRAMES * packetLength);
+    memoryBudget_add("remote inference", (long long) (MAX_QUEUED_FRAMES * packetLength), true);
+    printf("Remote inference: offloading to %s while it answers, %zu bytes a frame\n", server, packetLength);
+    return true;
+}
+
+bool remoteInference_poll(long long nowUs)
+{
+    char datagram[MAX_DATAGRAM_LENGTH + 1];
+    ssize_t length;
+    while ((length = recv(socketFd, datagram, MAX_DATAGRAM_LENGTH, MSG_DONTWAIT)) >= 0) {
+        // whatever it says, the server is there
+        lastHeardUs = nowUs;
+        datagram[length] = '\0';
+        if (!parseDatagram(datagram, nowUs)) {
+            count(&counters.badDatagrams, 1);
+        }
+    }
+    if (nowUs >= nextPingUs) {
+        uint8_t ping[REMOTE_INFERENCE_HEADER_LENGTH];
+        pingSequence = sequence;
+        putHeader(ping, KIND_PING, 0, 0, epochUs(nowUs));
+        pingSentUs = sendPacket(ping, sizeof(ping)) ? nowUs : 0;
+        nextPingUs = nowUs + REMOTE_INFERENCE_PING_MS * 1000LL;
+    }
+
+    const bool isUp = lastHeardUs != 0 && nowUs - lastHeardUs < REMOTE_INFERENCE_LINK_TIMEOUT_MS * 1000LL;
+    if (isUp != isLinkUp) {
+        isLinkUp = isUp;
+        metrics_set(linkMetric, isUp ? 1 : 0);
+        if (isUp) {
+            asyncLog_log(ASYNC_LOG_INFO, "Remote inference: the server answers; offloading");
+        } else {
+            count(&counters.linkDrops, 1);
+            asyncLog_log(ASYNC_LOG_WARN, "Remote inference: no answer for %d ms; listening locally",
+                    REMOTE_INFERENCE_LINK_TIMEOUT_MS);
+        }
+    }
+    return isUp;
+}
+
+bool remoteInference_nextEvent(remoteInference_event* event)
+{
+    if (eventCount == 0) {
+        return false;
+    }
+    *event = events[firstEvent];
+    firstEvent = (firstEvent + 1) % REMOTE_INFERENCE_MAX_EVENTS;
+    eventCount--;
+    return true;
+}
+
+void remoteInference_queue(const int16_t* pcm)
+{
+    if (queuedFrames == MAX_QUEUED_FRAMES) {
+        return;
+    }
+    uint8_t* packet = packets + (size_t) queuedFrames * packetLength;
+    pv_adpcm_encode_block(&encoder, pcm, frameLength, packet + REMOTE_INFERENCE_HEADER_LENGTH);
+    queuedFrames++;
+}
+
+void remoteInference_send(long long frame, long long capturedUs)
+{
+    const long long frameUs = (long long) frameLength * 1000000 / sampleRate;
+    const long long capturedEpochUs = epochUs(capturedUs);
+    for (int i = 0; i < queuedFrames; i++) {
+        const int back = queuedFrames - 1 - i;
+        uint8_t* packet = packets + (size_t) i * packetLength;
+        putHeader(packet, KIND_FRAME, frameLength, frame - back, capturedEpochUs - back * frameUs);
+        if (sendPacket(packet, packetLength)) {
+            count(&counters.sentFrames, 1);
+            count(&counters.sentBytes, (long long) packetLength);
+        }
+    }
+    queuedFrames = 0;
+}
+
+void remoteInference_stop(void)
+{
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+    free(packets);
+    packets = NULL;
+}
+
+void remoteInference_getStats(remoteInference_stats* stats)
+{
+    stats->sentFrames = __atomic_load_n(&counters.sentFrames, __ATOMIC_RELAXED);
+    stats->sentBytes = __atomic_load_n(&counters.sentBytes, __ATOMIC_RELAXED);
+    stats->events = __atomic_load_n(&counters.events, __ATOMIC_RELAXED);
+    stats->linkDrops = __atomic_load_n(&counters.linkDrops, __ATOMIC_RELAXED);
+    stats->badDatagrams = __atomic_load_n(&counters.badDatagrams, __ATOMIC_RELAXED);
+    stats->sendErrors = __atomic_load_n(&counters.sendErrors, __ATOMIC_RELAXED);
+    stats->roundTripUs = __atomic_load_n(&counters.roundTripUs, __ATOMIC_RELAXED);
+}
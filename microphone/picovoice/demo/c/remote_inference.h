@@ -0,0 +1,91 @@
+#ifndef REMOTE_INFERENCE_H
+#define REMOTE_INFERENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hands a board's listening to a central server, for boards too busy with the camera to run Picovoice themselves.
+// Everything here runs on the inference thread and nothing waits: the frames the voice gate lets through go to the
+// server as UDP datagrams, and what the server heard comes back the same way, to be taken between frames. UDP rather
+// than TCP, so a lost datagram costs its frame and never holds up the frames behind it. The board pings the server
+// every REMOTE_INFERENCE_PING_MS; the link is up from the first answer until REMOTE_INFERENCE_LINK_TIMEOUT_MS pass
+// without one, and the caller listens locally while it is down.
+//
+// Board to server, little-endian, one datagram each:
+//   0  "FFRI"
+//   4  kind: 1 for a frame, 2 for a ping
+//   5  engines on the board, i.e. keyword and context pairs
+//   6  samples in the frame; 0 in a ping
+//   8  sample rate
+//   12 sequence number, counting every datagram sent, pings included
+//   16 frame: its number among all the frames captured, from 0, so a gap is audio the voice gate held back; 0 in a ping
+//   24 when the frame was captured, or the ping sent, in microseconds since the epoch
+//   32 a frame's samples as one mono IMA-ADPCM block (pv_adpcm.h), so each datagram decodes on its own
+//
+// Server to board, one line of text a datagram; ENGINE counts from 1 and FRAME is the frame it was heard in:
+//   pong SEQUENCE
+//   wake ENGINE FRAME
+//   intent ENGINE FRAME understood INTENT [SLOT=VALUE ...]
+//   intent ENGINE FRAME not-understood
+
+#define REMOTE_INFERENCE_PING_MS 1000
+#define REMOTE_INFERENCE_LINK_TIMEOUT_MS 3000
+#define REMOTE_INFERENCE_HEADER_LENGTH 32
+// events kept between two calls to remoteInference_poll; more are dropped and counted as bad
+#define REMOTE_INFERENCE_MAX_EVENTS 8
+#define REMOTE_INFERENCE_MAX_SLOTS 8
+#define REMOTE_INFERENCE_MAX_WORD 32
+
+typedef enum {
+    REMOTE_INFERENCE_WAKE,
+    REMOTE_INFERENCE_INTENT,
+} remoteInference_eventKind;
+
+typedef struct {
+    remoteInference_eventKind kind;
+    // from 0
+    int engine;
+    long long frame;
+    bool isUnderstood;
+    char intent[REMOTE_INFERENCE_MAX_WORD];
+    int slotCount;
+    char slots[REMOTE_INFERENCE_MAX_SLOTS][REMOTE_INFERENCE_MAX_WORD];
+    char values[REMOTE_INFERENCE_MAX_SLOTS][REMOTE_INFERENCE_MAX_WORD];
+} remoteInference_event;
+
+typedef struct {
+    long long sentFrames;
+    long long sentBytes;
+    long long events;
+    // up, then down for want of an answer
+    long long linkDrops;
+    // not understood, or more in one go than REMOTE_INFERENCE_MAX_EVENTS
+    long long badDatagrams;
+    long long sendErrors;
+    // the last ping's round trip, -1 before the first answer
+    long long roundTripUs;
+} remoteInference_stats;
+
+// server is HOST:PORT. Prints what went wrong and returns false if it can't be resolved.
+bool remoteInference_start(const char* server, int32_t frameLength, int32_t sampleRate, int engineCount);
+
+// Every frame: takes what the server has sent, pings it when a ping is due, and says whether the link is up.
+bool remoteInference_poll(long long nowUs);
+
+// The next event remoteInference_poll took, oldest first; false once there are none.
+bool remoteInference_nextEvent(remoteInference_event* event);
+
+// Encodes a frame for the server. The frames queued since the last remoteInference_send are the last ones heard, up
+// to and including the current one, in order; at most VOICE_GATE_MAX_PRE_ROLL_FRAMES + 1 of them.
+void remoteInference_queue(const int16_t* pcm);
+
+// Sends what is queued. frame and capturedUs, on CLOCK_MONOTONIC, are the current frame's; the frames queued before it
+// are numbered and timed back from it.
+void remoteInference_send(long long frame, long long capturedUs);
+
+void remoteInference_stop(void);
+
+// Safe from any thread.
+void remoteInference_getStats(remoteInference_stats* stats);
+
+#endif
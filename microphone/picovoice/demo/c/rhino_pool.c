@@ -0,0 +1,306 @@
+#include "rhino_pool.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "thread_cpu.h"
+
+typedef struct {
+    // engine to pool
+    bool isRequested;
+    bool isCancelled;
+    long long requestedUs;
+    pv_rhino_t* returned;
+    // pool to engine: freshly built, or reset after being handed back
+    pv_rhino_t* ready;
+    // pool thread only: an instance was put in ready, and is still there unless the engine has taken it
+    bool isPublished;
+    unsigned int publishedGeneration;
+    // 0 while the instance is waited for, in use or kept warm
+    long long lingerUntilUs;
+} rhinoSlot;
+
+static rhinoPool_config poolConfig;
+static rhinoSlot slots[RHINO_POOL_MAX_CONTEXTS];
+// bumped by rhinoPool_reload; the pool thread catches up with it
+static unsigned int generation = 0;
+static float reloadedSensitivity = 0.f;
+
+static pthread_t threadPool;
+static bool isRunning = false;
+static bool stopping = false;
+// counts requests, hand-backs and the stop request; the pool thread sleeps on it between them
+static int wakeFd = -1;
+
+static rhinoPool_stats counters;
+
+static long long nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void count(long long* counter, long long amount)
+{
+    __atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+static void wake(void)
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Rhino pool: Unable to wake: %s", strerror(errno));
+    }
+}
+
+static pv_rhino_t* build(int context)
+{
+    pv_rhino_t* rhino = NULL;
+    const pv_status_t status = poolConfig.engine->init(poolConfig.accessKey, poolConfig.modelPath,
+            poolConfig.contextPaths[context], poolConfig.sensitivity, poolConfig.endpointDurationSec,
+            poolConfig.requireEndpoint, &rhino);
+    if (status != PV_STATUS_SUCCESS) {
+        count(&counters.failures, 1);
+        asyncLog_log(ASYNC_LOG_ERROR, "Rhino pool: Unable to build an instance of %s, status %d",
+                poolConfig.contextPaths[context], (int) status);
+        return NULL;
+    }
+    count(&counters.built, 1);
+    const int resident = __atomic_add_fetch(&counters.resident, 1, __ATOMIC_RELAXED);
+    if (resident > __atomic_load_n(&counters.maxResident, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&counters.maxResident, resident, __ATOMIC_RELAXED);
+    }
+    return rhino;
+}
+
+static void destroy(pv_rhino_t* rhino)
+{
+    if (rhino == NULL) {
+        return;
+    }
+    poolConfig.engine->destroy(rhino);
+    count(&counters.destroyed, 1);
+    __atomic_sub_fetch(&counters.resident, 1, __ATOMIC_RELAXED);
+}
+
+static void publish(rhinoSlot* slot, pv_rhino_t* rhino, long long lingerUntilUs)
+{
+    slot->isPublished = true;
+    slot->publishedGeneration = generation;
+    slot->lingerUntilUs = lingerUntilUs;
+    __atomic_store_n(&slot->ready, rhino, __ATOMIC_RELEASE);
+}
+
+// Destroys the published instance unless the engine has taken it.
+static void withdraw(rhinoSlot* slot)
+{
+    slot->lingerUntilUs = 0;
+    pv_rhino_t* rhino = __atomic_exchange_n(&slot->ready, NULL, __ATOMIC_ACQ_REL);
+    if (rhino != NULL) {
+        destroy(rhino);
+        slot->isPublished = false;
+    }
+}
+
+static long long lingerUntil(long long now)
+{
+    return poolConfig.keepWarm ? 0 : now + (long long) poolConfig.lingerMs * 1000;
+}
+
+static void serve(int context, long long now)
+{
+    rhinoSlot* slot = &slots[context];
+
+    pv_rhino_t* returned = __atomic_exchange_n(&slot->returned, NULL, __ATOMIC_ACQ_REL);
+    if (returned != NULL) {
+        slot->isPublished = false;
+        if (slot->publishedGeneration != generation || poolConfig.engine->reset(returned) != PV_STATUS_SUCCESS) {
+            destroy(returned);
+        } else {
+            publish(slot, returned, lingerUntil(now));
+        }
+    }
+
+    if (__atomic_exchange_n(&slot->isCancelled, false, __ATOMIC_ACQ_REL) && slot->isPublished &&
+            __atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE) != NULL) {
+        slot->lingerUntilUs = lingerUntil(now);
+    }
+
+    if (__atomic_exchange_n(&slot->isRequested, false, __ATOMIC_ACQ_REL)) {
+        count(&counters.requests, 1);
+        if (slot->isPublished) {
+            // waiting in ready, or taken and about to be handed back
+            count(&counters.warmHits, 1);
+            slot->lingerUntilUs = 0;
+        } else {
+            pv_rhino_t* rhino = build(context);
+            if (rhino != NULL) {
+                publish(slot, rhino, 0);
+                const long long readyUs = nowUs() - __atomic_load_n(&slot->requestedUs, __ATOMIC_ACQUIRE);
+                count(&counters.totalReadyUs, readyUs);
+                if (readyUs > __atomic_load_n(&counters.maxReadyUs, __ATOMIC_RELAXED)) {
+                    __atomic_store_n(&counters.maxReadyUs, readyUs, __ATOMIC_RELAXED);
+                }
+            }
+        }
+    }
+
+    if (poolConfig.keepWarm && !slot->isPublished) {
+        pv_rhino_t* rhino = build(context);
+        if (rhino != NULL) {
+            publish(slot, rhino, 0);
+        }
+    }
+
+    if (slot->lingerUntilUs > 0 && now >= slot->lingerUntilUs) {
+        withdraw(slot);
+    }
+}
+
+static void* runPool(void* arg)
+{
+    (void) arg;
+    unsigned int servedGeneration = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+    int timeoutMs = -1;
+    while (true) {
+        struct pollfd wakeEvent = {wakeFd, POLLIN, 0};
+        if (poll(&wakeEvent, 1, timeoutMs) < 0 && errno != EINTR) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Rhino pool: Unable to wait for requests: %s", strerror(errno));
+            break;
+        }
+        uint64_t wakes;
+        if (read(wakeFd, &wakes, sizeof(wakes)) < 0 && errno != EAGAIN && errno != EINTR) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Rhino pool: Unable to wait for requests: %s", strerror(errno));
+            break;
+        }
+        if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        const unsigned int current = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+        if (current != servedGeneration) {
+            servedGeneration = current;
+            __atomic_load(&reloadedSensitivity, &poolConfig.sensitivity, __ATOMIC_RELAXED);
+            for (int i = 0; i < poolConfig.contextCount; i++) {
+                withdraw(&slots[i]);
+            }
+        }
+
+        const long long now = nowUs();
+        long long nextUs = 0;
+        for (int i = 0; i < poolConfig.contextCount; i++) {
+            serve(i, now);
+            const long long until = slots[i].lingerUntilUs;
+            if (until > 0 && (nextUs == 0 || until < nextUs)) {
+                nextUs = until;
+            }
+        }
+        timeoutMs = (nextUs > 0) ? (int) ((nextUs - nowUs() + 999) / 1000) : -1;
+        timeoutMs = (nextUs > 0 && timeoutMs < 0) ? 0 : timeoutMs;
+    }
+    return NULL;
+}
+
+bool rhinoPool_start(const rhinoPool_config* config)
+{
+    poolConfig = *config;
+    memset(slots, 0, sizeof(slots));
+    memset(&counters, 0, sizeof(counters));
+    generation = 0;
+    stopping = false;
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0) {
+        perror("Rhino pool: Unable to create the wake eventfd.");
+        return false;
+    }
+    // at normal priority, and off the inference thread's core if it has one: a build takes a while
+    if (pthread_create(&threadPool, NULL, runPool, NULL) != 0) {
+        printf("Rhino pool: Unable to start the pool thread.\n");
+        rhinoPool_stop();
+        return false;
+    }
+    isRunning = true;
+    threadCpu_setName(threadPool, "rhino-pool");
+    if (poolConfig.keepWarm) {
+        wake();
+    }
+    return true;
+}
+
+void rhinoPool_request(int context)
+{
+    __atomic_store_n(&slots[context].requestedUs, nowUs(), __ATOMIC_RELEASE);
+    __atomic_store_n(&slots[context].isRequested, true, __ATOMIC_RELEASE);
+    wake();
+}
+
+pv_rhino_t* rhinoPool_take(int context)
+{
+    if (__atomic_load_n(&slots[context].ready, __ATOMIC_ACQUIRE) == NULL) {
+        return NULL;
+    }
+    return __atomic_exchange_n(&slots[context].ready, NULL, __ATOMIC_ACQ_REL);
+}
+
+void rhinoPool_cancel(int context)
+{
+    // not seen by the pool yet, so nothing is built for it
+    if (__atomic_exchange_n(&slots[context].isRequested, false, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+    __atomic_store_n(&slots[context].isCancelled, true, __ATOMIC_RELEASE);
+    wake();
+}
+
+void rhinoPool_give(int context, pv_rhino_t* rhino)
+{
+    __atomic_store_n(&slots[context].returned, rhino, __ATOMIC_RELEASE);
+    wake();
+}
+
+void rhinoPool_reload(float sensitivity)
+{
+    __atomic_store(&reloadedSensitivity, &sensitivity, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&generation, 1, __ATOMIC_RELEASE);
+    wake();
+}
+
+void rhinoPool_stop(void)
+{
+    if (isRunning) {
+        __atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+        wake();
+        pthread_join(threadPool, NULL);
+        isRunning = false;
+        for (int i = 0; i < poolConfig.contextCount; i++) {
+            destroy(__atomic_exchange_n(&slots[i].ready, NULL, __ATOMIC_ACQ_REL));
+            destroy(__atomic_exchange_n(&slots[i].returned, NULL, __ATOMIC_ACQ_REL));
+        }
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
+
+void rhinoPool_getStats(rhinoPool_stats* stats)
+{
+    stats->requests = __atomic_load_n(&counters.requests, __ATOMIC_RELAXED);
+    stats->warmHits = __atomic_load_n(&counters.warmHits, __ATOMIC_RELAXED);
+    stats->built = __atomic_load_n(&counters.built, __ATOMIC_RELAXED);
+    stats->destroyed = __atomic_load_n(&counters.destroyed, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&counters.failures, __ATOMIC_RELAXED);
+    stats->resident = __atomic_load_n(&counters.resident, __ATOMIC_RELAXED);
+    stats->maxResident = __atomic_load_n(&counters.maxResident, __ATOMIC_RELAXED);
+    stats->totalReadyUs = __atomic_load_n(&counters.totalReadyUs, __ATOMIC_RELAXED);
+    stats->maxReadyUs = __atomic_load_n(&counters.maxReadyUs, __ATOMIC_RELAXED);
+}
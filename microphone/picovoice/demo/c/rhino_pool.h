@@ -0,0 +1,70 @@
+#ifndef RHINO_POOL_H
+#define RHINO_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pv_engine.h"
+
+// Rhino instances for standby, built and destroyed on a thread of their own so neither happens on the audio path. In
+// standby only Porcupine stays resident; a wake word asks the pool for its context's Rhino, and the engine holds its
+// frames back until the instance is ready. One handed back stays warm for a while for a follow-on command, and is
+// then destroyed, unless the pool was asked to keep one warm for good. Instances pass between the engines and the pool
+// through atomic slots, so an engine never waits on the pool.
+
+#define RHINO_POOL_MAX_CONTEXTS 4
+
+typedef struct {
+    const pvRhinoEngine* engine;
+    const char* accessKey;
+    const char* modelPath;
+    const char* contextPaths[RHINO_POOL_MAX_CONTEXTS];
+    int contextCount;
+    float sensitivity;
+    float endpointDurationSec;
+    bool requireEndpoint;
+    // an instance of every context is built at start and kept; without it, only while lingering
+    bool keepWarm;
+    // how long an instance handed back is kept for the next command
+    int32_t lingerMs;
+} rhinoPool_config;
+
+typedef struct {
+    long long requests;
+    // requests an instance was already built for
+    long long warmHits;
+    long long built;
+    long long destroyed;
+    long long failures;
+    int resident;
+    int maxResident;
+    // from request to ready, for the requests that had to wait for a build
+    long long totalReadyUs;
+    long long maxReadyUs;
+} rhinoPool_stats;
+
+bool rhinoPool_start(const rhinoPool_config* config);
+
+// On the engine's thread, after a wake word. Never blocks.
+void rhinoPool_request(int context);
+
+// The context's instance, reset and ready for a command, or NULL if it isn't built yet. Only after rhinoPool_request.
+pv_rhino_t* rhinoPool_take(int context);
+
+// A request no longer waited for; the instance, if it still comes, lingers as if handed back.
+void rhinoPool_cancel(int context);
+
+// Hands a taken instance back once its command is over.
+void rhinoPool_give(int context, pv_rhino_t* rhino);
+
+// For a reload: instances not in use are destroyed, and later ones are built from the files as they are now, with
+// this sensitivity. Instances in use are destroyed when they are handed back.
+void rhinoPool_reload(float sensitivity);
+
+// Destroys every instance not handed out, then joins the pool's thread.
+void rhinoPool_stop(void);
+
+// Safe from any thread; fields may be from slightly different instants.
+void rhinoPool_getStats(rhinoPool_stats* stats);
+
+#endif
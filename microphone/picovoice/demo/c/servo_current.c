@@ -0,0 +1,107 @@
+#include "servo_current.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "adc_stream.h"
+#include "latency_trace.h"
+#include "metrics.h"
+
+static servoCurrent_config config;
+static servoCurrent_stallFunc stallFunc = NULL;
+static bool isStarted = false;
+static bool isWatching = false;
+static bool hasStalled = false;
+static long long moveStartedUs = 0;
+// since when the window has been at the stall level, or -1
+static long long overSinceUs = -1;
+static uint16_t window[SERVO_CURRENT_WINDOW_SAMPLES];
+static int windowNext = 0;
+static int windowFilled = 0;
+static long windowSum = 0;
+static metrics_id stallMetric = -1;
+
+static void resetWindow(void)
+{
+    windowNext = 0;
+    windowFilled = 0;
+    windowSum = 0;
+    overSinceUs = -1;
+}
+
+static void onSamples(const uint16_t* samples, int count, void* userData)
+{
+    (void) userData;
+    if (!isWatching || hasStalled) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (windowFilled == SERVO_CURRENT_WINDOW_SAMPLES) {
+            windowSum -= window[windowNext];
+        } else {
+            windowFilled++;
+        }
+        window[windowNext] = samples[i];
+        windowSum += samples[i];
+        windowNext = (windowNext + 1) % SERVO_CURRENT_WINDOW_SAMPLES;
+    }
+
+    // the block's samples are a few milliseconds at most, so it is timed as a whole
+    const long long nowUs = latencyTrace_nowUs();
+    if (nowUs - moveStartedUs < SERVO_CURRENT_INRUSH_MS * 1000LL || windowFilled < SERVO_CURRENT_WINDOW_SAMPLES) {
+        return;
+    }
+    if (windowSum < (long) config.stallRaw * SERVO_CURRENT_WINDOW_SAMPLES) {
+        overSinceUs = -1;
+        return;
+    }
+    if (overSinceUs < 0) {
+        overSinceUs = nowUs;
+    }
+    if (nowUs - overSinceUs >= config.stallMs * 1000LL) {
+        hasStalled = true;
+        metrics_add(stallMetric, 1);
+        stallFunc();
+    }
+}
+
+bool servoCurrent_start(const servoCurrent_config* newConfig, servoCurrent_stallFunc onStall)
+{
+    config = *newConfig;
+    stallFunc = onStall;
+    if (stallMetric < 0) {
+        stallMetric = metrics_addCounter("feeder_servo_stalls_total", "Moves of the gate the servo current showed stalled.");
+    }
+    if (!adcStream_open(config.device) || !adcStream_addChannel(config.channel, onSamples, NULL)) {
+        printf("Servo current: Unable to read ADC channel %d of iio:device%d.\n", config.channel, config.device);
+        return false;
+    }
+    isStarted = true;
+    return true;
+}
+
+void servoCurrent_watch(bool isMoving)
+{
+    if (!isStarted) {
+        return;
+    }
+    if (isMoving) {
+        // a new direction starts with its own inrush, and may stall again
+        moveStartedUs = latencyTrace_nowUs();
+        hasStalled = false;
+        resetWindow();
+        if (!isWatching) {
+            isWatching = true;
+            adcStream_acquire();
+        }
+    } else if (isWatching) {
+        isWatching = false;
+        adcStream_release();
+    }
+}
+
+void servoCurrent_stop(void)
+{
+    servoCurrent_watch(false);
+    isStarted = false;
+}
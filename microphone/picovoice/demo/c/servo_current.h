@@ -0,0 +1,32 @@
+#ifndef SERVO_CURRENT_H
+#define SERVO_CURRENT_H
+
+#include <stdbool.h>
+
+// Servo stall detection from the servo's supply current, measured by a current sense amplifier on one of the AM335x
+// ADC's channels. The shared ADC stream is held only while the gate moves, and every block it delivers goes through a
+// running window of the last SERVO_CURRENT_WINDOW_SAMPLES samples. A stall is a window mean at or above the stall
+// level for the stall time, which a pellet jam holds and a normal move does not. The start of each move is skipped,
+// since a servo draws its highest current as it accelerates. Runs on the event loop, which has to be initialised.
+
+#define SERVO_CURRENT_WINDOW_SAMPLES 64
+#define SERVO_CURRENT_INRUSH_MS 100
+
+typedef struct {
+    int device;   // N in iio:deviceN
+    int channel;  // K in in_voltageK
+    int stallRaw; // the raw reading a stalled servo draws
+    int stallMs;  // for at least this long
+} servoCurrent_config;
+
+// On the event loop thread, once per move at most.
+typedef void (*servoCurrent_stallFunc)(void);
+
+bool servoCurrent_start(const servoCurrent_config* config, servoCurrent_stallFunc onStall);
+
+// The gate started, or started again in another direction, or stopped moving. Fits servoDriver_motionFunc.
+void servoCurrent_watch(bool isMoving);
+
+void servoCurrent_stop(void);
+
+#endif
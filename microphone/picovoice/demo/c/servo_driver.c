@@ -0,0 +1,332 @@
+#include "servo_driver.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "actuator_gate.h"
+#include "async_log.h"
+#include "event_loop.h"
+#include "hal_pwm.h"
+#include "latency_trace.h"
+#include "pru_link.h"
+
+#define PERIOD_IN_NS 20000000L
+#define OPEN_DUTY_CYCLE_IN_NS 2000000L
+#define CLOSED_DUTY_CYCLE_IN_NS 1000000L
+
+// fraction of a trapezoidal ramp spent accelerating (and, symmetrically, decelerating)
+#define TRAPEZOID_ACCELERATION_FRACTION 0.25
+// how long a gate that jammed while closing is held open again, to let the pellets through
+#define UNJAM_HOLD_MS 500
+
+const servoProfile servoProfile_feed = {"feed", SERVO_RAMP_S_CURVE, 0, 200, 1000};
+const servoProfile servoProfile_delayedFeed = {"delayed feed", SERVO_RAMP_S_CURVE, 0, 200, 1000};
+const servoProfile servoProfile_longFeed = {"long feed", SERVO_RAMP_TRAPEZOID, 0, 300, 10000};
+const servoProfile servoProfile_portions[SERVO_PORTIONS] = {
+    {NULL, SERVO_RAMP_S_CURVE, 0, 0, 0},
+    {"small portion", SERVO_RAMP_S_CURVE, 0, 150, 400},
+    {"normal portion", SERVO_RAMP_S_CURVE, 0, 200, 1000},
+    {"large portion", SERVO_RAMP_S_CURVE, 0, 250, 2200},
+    {"double portion", SERVO_RAMP_TRAPEZOID, 0, 300, 4500},
+};
+
+typedef enum {
+    SERVO_IDLE,
+    SERVO_OPENING,
+    SERVO_HOLDING,
+    SERVO_CLOSING,
+} servoPhase;
+
+static int tickFd = -1;
+
+// the running profile; only touched on the event loop thread
+static servoProfile profile;
+static servoDriver_doneFunc doneFunc = NULL;
+static servoPhase phase = SERVO_IDLE;
+static long step = 0;
+static long long holdTicksLeft = 0;
+// the first duty cycle write of a profile is when the gate starts to move
+static bool hasMoved = false;
+// the PRU runs the profile and the pulse; tickFd and the PWM channel are unused
+static bool usePru = false;
+static servoDriver_motionFunc motionFunc = NULL;
+static int unjamsLeft = 0;
+// once the gate is closed, open it again: an unjam backed it off mid-profile
+static bool retryOpen = false;
+static int nextHoldMs = 0;
+
+// position along the ramp, 0 (start) to 1 (end), at normalised time t in [0, 1]
+static double rampPosition(servoRampShape shape, double t)
+{
+    if (shape == SERVO_RAMP_S_CURVE) {
+        return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+    }
+
+    const double a = TRAPEZOID_ACCELERATION_FRACTION;
+    const double peakVelocity = 1.0 / (1.0 - a);
+    if (t < a) {
+        return peakVelocity * t * t / (2.0 * a);
+    }
+    if (t > 1.0 - a) {
+        return 1.0 - peakVelocity * (1.0 - t) * (1.0 - t) / (2.0 * a);
+    }
+    return peakVelocity * (t - a / 2.0);
+}
+
+static void writeDutyCycle(long dutyCycleInNs)
+{
+    halPwm_write(HAL_PWM_DUTY_CYCLE, dutyCycleInNs);
+}
+
+static long rampSteps(int rampMs)
+{
+    return rampMs > SERVO_DRIVER_TICK_MS ? rampMs / SERVO_DRIVER_TICK_MS : 1;
+}
+
+static void setMoving(bool isMoving)
+{
+    if (motionFunc != NULL) {
+        motionFunc(isMoving);
+    }
+}
+
+static void finishProfile(void)
+{
+    if (tickFd >= 0) {
+        eventLoop_armTimer(tickFd, 0, 0);
+    }
+    phase = SERVO_IDLE;
+    retryOpen = false;
+    setMoving(false);
+    actuatorGate_end();
+    if (doneFunc != NULL) {
+        doneFunc();
+    }
+}
+
+static void markMoved(void)
+{
+    hasMoved = true;
+    latencyTrace_mark(LATENCY_TRACE_GATE_MOVED);
+    // not before: a delayed feed can wait minutes without a sound
+    actuatorGate_begin();
+    setMoving(true);
+}
+
+static void onPruGateMoved(void)
+{
+    if (phase != SERVO_IDLE && !hasMoved) {
+        markMoved();
+    }
+}
+
+static void onPruProfileDone(void)
+{
+    if (phase != SERVO_IDLE) {
+        finishProfile();
+    }
+}
+
+// Only if the PRU and the daemon disagree about a running profile, e.g. after a restart of one of them.
+static void onPruProfileRejected(void)
+{
+    asyncLog_log(ASYNC_LOG_ERROR, "Servo: the PRU is still running a profile; '%s' was dropped.", profile.name);
+    if (phase != SERVO_IDLE) {
+        finishProfile();
+    }
+}
+
+// Advances the running profile by however many ticks have passed (more than one if the loop fell behind).
+static void onTick(int fd, void* userData)
+{
+    (void) userData;
+    long long ticks = eventLoop_readTimer(fd);
+    if (ticks == 0 || phase == SERVO_IDLE) {
+        return;
+    }
+
+    if (phase == SERVO_HOLDING) {
+        holdTicksLeft -= ticks;
+        if (holdTicksLeft <= 0) {
+            phase = SERVO_CLOSING;
+            step = 0;
+        }
+        return;
+    }
+
+    const long steps = rampSteps(profile.rampMs);
+    step = step + ticks < steps ? step + ticks : steps;
+    double position = rampPosition(profile.shape, (double) step / (double) steps);
+    if (phase == SERVO_CLOSING) {
+        position = 1.0 - position;
+    }
+    writeDutyCycle(CLOSED_DUTY_CYCLE_IN_NS + (long) ((double) (OPEN_DUTY_CYCLE_IN_NS - CLOSED_DUTY_CYCLE_IN_NS) * position));
+    if (!hasMoved) {
+        markMoved();
+    }
+
+    if (step < steps) {
+        return;
+    }
+    if (phase == SERVO_OPENING) {
+        phase = SERVO_HOLDING;
+        holdTicksLeft = nextHoldMs / SERVO_DRIVER_TICK_MS;
+        nextHoldMs = profile.holdMs;
+    } else if (retryOpen) {
+        retryOpen = false;
+        phase = SERVO_OPENING;
+        step = 0;
+        setMoving(true);
+    } else {
+        finishProfile();
+    }
+}
+
+bool servoDriver_init(const char* pwmPath)
+{
+    bool ok = halPwm_open(pwmPath);
+    if (ok) {
+        tickFd = eventLoop_createTimer();
+        ok = tickFd >= 0 && eventLoop_add(tickFd, EPOLLIN, onTick, NULL);
+    }
+    if (ok) {
+        eventLoop_setSubsystem(tickFd, "servo");
+    } else {
+        servoDriver_cleanup();
+    }
+    return ok;
+}
+
+bool servoDriver_initPru(void)
+{
+    if (!pruLink_isRunning()) {
+        return false;
+    }
+    pruLink_setHandler(PRU_EVENT_GATE_MOVED, onPruGateMoved);
+    pruLink_setHandler(PRU_EVENT_PROFILE_DONE, onPruProfileDone);
+    pruLink_setHandler(PRU_EVENT_PROFILE_REJECTED, onPruProfileRejected);
+    usePru = true;
+    return true;
+}
+
+static bool startPruProfile(void)
+{
+    pruCommand command = {0};
+    command.type = PRU_COMMAND_START_PROFILE;
+    command.shape = profile.shape == SERVO_RAMP_S_CURVE ? PRU_RAMP_S_CURVE : PRU_RAMP_TRAPEZOID;
+    command.startDelayMs = (uint32_t) profile.startDelayMs;
+    command.rampMs = (uint32_t) profile.rampMs;
+    command.holdMs = (uint32_t) profile.holdMs;
+    return pruLink_send(&command);
+}
+
+bool servoDriver_startProfile(const servoProfile* newProfile, servoDriver_doneFunc onDone)
+{
+    if ((!usePru && tickFd < 0) || phase != SERVO_IDLE) {
+        return false;
+    }
+    if (usePru) {
+        profile = *newProfile;
+        doneFunc = onDone;
+        hasMoved = false;
+        unjamsLeft = SERVO_DRIVER_MAX_UNJAMS;
+        if (!startPruProfile()) {
+            asyncLog_log(ASYNC_LOG_ERROR, "Servo: profile '%s' did not start.", profile.name);
+            return false;
+        }
+        // the PRU's events move it on from here
+        phase = SERVO_OPENING;
+        return true;
+    }
+    halPwm_write(HAL_PWM_PERIOD, PERIOD_IN_NS);
+    halPwm_write(HAL_PWM_ENABLE, 1);
+
+    profile = *newProfile;
+    doneFunc = onDone;
+    phase = SERVO_OPENING;
+    step = 0;
+    hasMoved = false;
+    unjamsLeft = SERVO_DRIVER_MAX_UNJAMS;
+    retryOpen = false;
+    nextHoldMs = profile.holdMs;
+    // the first tick comes after the start delay; a first expiry of 0 would disarm, so no delay still waits one tick
+    long long firstMs = profile.startDelayMs > 0 ? profile.startDelayMs : SERVO_DRIVER_TICK_MS;
+    if (!eventLoop_armTimer(tickFd, firstMs, SERVO_DRIVER_TICK_MS)) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Servo: profile '%s' did not start.", profile.name);
+        phase = SERVO_IDLE;
+        return false;
+    }
+    return true;
+}
+
+void servoDriver_setMotionFunc(servoDriver_motionFunc onMotion)
+{
+    motionFunc = onMotion;
+}
+
+bool servoDriver_unjam(void)
+{
+    if (phase == SERVO_IDLE || !hasMoved || unjamsLeft == 0) {
+        return false;
+    }
+    unjamsLeft--;
+    if (usePru) {
+        // the PRU has no reverse: snap the gate shut and run the profile again from the top
+        const pruCommand stop = {.type = PRU_COMMAND_STOP};
+        profile.startDelayMs = 0;
+        if (!pruLink_send(&stop) || !startPruProfile()) {
+            return false;
+        }
+        setMoving(true);
+        return true;
+    }
+
+    // the ramps are symmetric, so steps - step is the same position travelled the other way
+    const long steps = rampSteps(profile.rampMs);
+    if (phase == SERVO_OPENING) {
+        phase = SERVO_CLOSING;
+        step = steps - step;
+        retryOpen = true;
+    } else if (phase == SERVO_CLOSING) {
+        phase = SERVO_OPENING;
+        step = steps - step;
+        nextHoldMs = UNJAM_HOLD_MS;
+    } else {
+        // jammed against the pellets it held open: close and open again
+        phase = SERVO_CLOSING;
+        step = 0;
+        retryOpen = true;
+    }
+    setMoving(true);
+    return true;
+}
+
+bool servoDriver_isBusy(void)
+{
+    return phase != SERVO_IDLE;
+}
+
+void servoDriver_cleanup(void)
+{
+    if (usePru) {
+        const pruCommand stop = {.type = PRU_COMMAND_STOP};
+        pruLink_send(&stop);
+        pruLink_setHandler(PRU_EVENT_GATE_MOVED, NULL);
+        pruLink_setHandler(PRU_EVENT_PROFILE_DONE, NULL);
+        pruLink_setHandler(PRU_EVENT_PROFILE_REJECTED, NULL);
+        usePru = false;
+    }
+    if (phase != SERVO_IDLE) {
+        // never leave the gate open
+        writeDutyCycle(CLOSED_DUTY_CYCLE_IN_NS);
+        phase = SERVO_IDLE;
+        setMoving(false);
+        actuatorGate_end();
+    }
+    halPwm_close();
+    if (tickFd >= 0) {
+        eventLoop_remove(tickFd);
+        close(tickFd);
+        tickFd = -1;
+    }
+}
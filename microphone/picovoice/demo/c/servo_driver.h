@@ -0,0 +1,77 @@
+#ifndef SERVO_DRIVER_H
+#define SERVO_DRIVER_H
+
+#include <stdbool.h>
+
+// Servo on a PWM channel, driven through hal_pwm: a sysfs channel, or a simulated one when the HAL is.
+//
+// The gate is moved by motion profiles: the duty cycle is ramped between closed and open one PWM period (20 ms) at a
+// time, paced by a timerfd on the event loop, instead of jumping between the two positions. Everything here runs on the
+// event loop thread; servoDriver_init registers the timer, so the loop must be initialised first. From the first move
+// of a profile until the gate is closed again, the actuator gate is held busy.
+
+#define SERVO_DRIVER_DEFAULT_PWM "/sys/class/pwm/pwmchip3/pwm1"
+#define SERVO_DRIVER_TICK_MS 20
+#define SERVO_DRIVER_MAX_UNJAMS 2
+
+typedef enum {
+    SERVO_RAMP_TRAPEZOID, // constant acceleration, cruise, constant deceleration
+    SERVO_RAMP_S_CURVE,   // minimum-jerk: acceleration also ramps up and down
+} servoRampShape;
+
+typedef struct {
+    const char* name;
+    servoRampShape shape;
+    int startDelayMs; // wait before the gate starts opening
+    int rampMs;       // time to travel between closed and open, each way
+    int holdMs;       // time the gate stays fully open
+} servoProfile;
+
+// mode 0: release straight away
+extern const servoProfile servoProfile_feed;
+// mode 1: release after a user-entered delay; copy it and set startDelayMs
+extern const servoProfile servoProfile_delayedFeed;
+// mode 2: keep the gate open for ten seconds
+extern const servoProfile servoProfile_longFeed;
+
+// Portions a command can ask for, e.g. "a small portion". Each is the time the gate takes to let that much of the 3 mm
+// pellets through, as calibrated on the feeder's hopper; the mode still decides the start delay.
+typedef enum {
+    SERVO_PORTION_DEFAULT, // the mode's own profile
+    SERVO_PORTION_SMALL,
+    SERVO_PORTION_NORMAL,
+    SERVO_PORTION_LARGE,
+    SERVO_PORTION_DOUBLE,
+    SERVO_PORTIONS
+} servoPortion;
+
+// indexed by servoPortion; SERVO_PORTION_DEFAULT has no entry of its own
+extern const servoProfile servoProfile_portions[SERVO_PORTIONS];
+
+bool servoDriver_init(const char* pwmPath);
+
+// Instead of servoDriver_init, on a BeagleBone whose PRU0 runs the firmware in pru/: profiles are handed to the PRU,
+// which generates the pulse itself, and only its events come back to the loop. pruLink_start has to have succeeded.
+bool servoDriver_initPru(void);
+
+typedef void (*servoDriver_doneFunc)(void);
+
+// Starts one open/hold/close cycle and returns straight away; onDone runs once the gate is closed again. Returns false
+// if a profile is already running.
+bool servoDriver_startProfile(const servoProfile* profile, servoDriver_doneFunc onDone);
+
+// Told when the gate starts moving, starts again after an unjam, and stops with the profile done.
+typedef void (*servoDriver_motionFunc)(bool isMoving);
+
+void servoDriver_setMotionFunc(servoDriver_motionFunc onMotion);
+
+// The gate is stuck on something. Backs it off and tries the move again: a gate jammed opening closes and reopens, one
+// jammed closing opens for a moment to let the pellets through. Returns false once the running profile has had
+// SERVO_DRIVER_MAX_UNJAMS tries, or if nothing is moving.
+bool servoDriver_unjam(void);
+
+bool servoDriver_isBusy(void);
+
+void servoDriver_cleanup(void);
+
+#endif
@@ -0,0 +1,214 @@
+#include "sim_script.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "event_loop.h"
+
+typedef struct {
+    long long atMs;
+    int level;
+} buttonStep;
+
+typedef struct {
+    bool isCount;   // expect_feeds rather than expect_feed
+    long long fromMs;
+    long long toMs;
+    int count;
+    int mode;       // -1 for any
+} expectation;
+
+typedef struct {
+    long long atMs;
+    int mode;
+} startedFeed;
+
+// in time order
+static buttonStep buttons[SIM_SCRIPT_MAX_STEPS];
+static int buttonCount = 0;
+static int nextButton = 0;
+static expectation expectations[SIM_SCRIPT_MAX_STEPS];
+static int expectationCount = 0;
+static long long settleMs = SIM_SCRIPT_DEFAULT_SETTLE_MS;
+
+// written on the loop thread, read by the replay's once the loop has caught up
+static pthread_mutex_t feedsLock = PTHREAD_MUTEX_INITIALIZER;
+static startedFeed feeds[SIM_SCRIPT_MAX_FEEDS];
+static int feedCount = 0;
+static int lostFeeds = 0;
+
+// presses may be written in any order
+static bool addButton(long long atMs, int level)
+{
+    if (buttonCount == SIM_SCRIPT_MAX_STEPS) {
+        return false;
+    }
+    int at = buttonCount++;
+    while (at > 0 && buttons[at - 1].atMs > atMs) {
+        buttons[at] = buttons[at - 1];
+        at--;
+    }
+    buttons[at] = (buttonStep) {atMs, level};
+    return true;
+}
+
+static bool addExpectation(expectation expected)
+{
+    if (expectationCount == SIM_SCRIPT_MAX_STEPS) {
+        return false;
+    }
+    expectations[expectationCount++] = expected;
+    return true;
+}
+
+static bool parseStep(const char* line)
+{
+    long long atMs = 0;
+    long long toMs = 0;
+    int count = 0;
+    int mode = -1;
+    char rest;
+    int fields = 0;
+    if ((fields = sscanf(line, "press %lld %lld %c", &atMs, &toMs, &rest)) >= 1 && fields <= 2) {
+        const long long holdMs = fields == 2 ? toMs : SIM_SCRIPT_DEFAULT_HOLD_MS;
+        return atMs >= 0 && holdMs > 0 && addButton(atMs, 1) && addButton(atMs + holdMs, 0);
+    }
+    if ((fields = sscanf(line, "expect_feed %lld %lld %d %c", &atMs, &toMs, &mode, &rest)) >= 2 && fields <= 3) {
+        return atMs >= 0 && toMs >= atMs && mode >= -1 &&
+               addExpectation((expectation) {false, atMs, toMs, 1, fields == 3 ? mode : -1});
+    }
+    if ((fields = sscanf(line, "expect_feeds %d %d %c", &count, &mode, &rest)) >= 1 && fields <= 2) {
+        return count >= 0 && mode >= -1 && addExpectation((expectation) {true, 0, 0, count, fields == 2 ? mode : -1});
+    }
+    if (sscanf(line, "settle %lld %c", &atMs, &rest) == 1) {
+        settleMs = atMs;
+        return settleMs >= 0;
+    }
+    return false;
+}
+
+static const char* modeName(int mode, char* name, size_t size)
+{
+    if (mode < 0) {
+        return "any mode";
+    }
+    snprintf(name, size, "mode %d", mode);
+    return name;
+}
+
+bool simScript_load(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        perror("Sim: Unable to open the script.");
+        printf(" script: %s\n", path);
+        return false;
+    }
+    buttonCount = 0;
+    nextButton = 0;
+    expectationCount = 0;
+    settleMs = SIM_SCRIPT_DEFAULT_SETTLE_MS;
+    feedCount = 0;
+    lostFeeds = 0;
+
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char* step = line;
+        while (isspace((unsigned char) *step)) {
+            step++;
+        }
+        char* end = step + strlen(step);
+        while (end > step && isspace((unsigned char) end[-1])) {
+            *--end = '\0';
+        }
+        if (*step != '\0' && !parseStep(step)) {
+            printf("Sim: %s:%d: bad step '%s'\n", path, lineNumber, step);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+long long simScript_settleMs(void)
+{
+    return settleMs;
+}
+
+bool simScript_runTo(long long toMs, simScript_buttonFunc setButton)
+{
+    while (nextButton < buttonCount && buttons[nextButton].atMs <= toMs) {
+        const buttonStep* step = &buttons[nextButton++];
+        if (!eventLoop_advanceClock(step->atMs)) {
+            return false;
+        }
+        setButton(step->level);
+    }
+    return eventLoop_advanceClock(toMs);
+}
+
+void simScript_feedStarted(int mode)
+{
+    pthread_mutex_lock(&feedsLock);
+    if (feedCount < SIM_SCRIPT_MAX_FEEDS) {
+        feeds[feedCount++] = (startedFeed) {eventLoop_nowMs(), mode};
+    } else {
+        lostFeeds++;
+    }
+    pthread_mutex_unlock(&feedsLock);
+}
+
+bool simScript_check(void)
+{
+    pthread_mutex_lock(&feedsLock);
+    bool matched[SIM_SCRIPT_MAX_FEEDS] = {false};
+    bool ok = true;
+    char name[16];
+    for (int i = 0; i < feedCount; i++) {
+        printf("sim feed : mode %d at %lld ms\n", feeds[i].mode, feeds[i].atMs);
+    }
+    if (lostFeeds > 0) {
+        printf("sim : %d feeds past the first %d not kept\n", lostFeeds, SIM_SCRIPT_MAX_FEEDS);
+    }
+    for (int i = 0; i < expectationCount; i++) {
+        const expectation* expected = &expectations[i];
+        if (expected->isCount) {
+            int count = expected->mode < 0 ? lostFeeds : 0;
+            for (int j = 0; j < feedCount; j++) {
+                count += expected->mode < 0 || feeds[j].mode == expected->mode;
+            }
+            if (count != expected->count) {
+                printf("sim FAILED : expected %d feeds of %s, got %d\n", expected->count,
+                       modeName(expected->mode, name, sizeof(name)), count);
+                ok = false;
+            }
+            continue;
+        }
+        int found = -1;
+        for (int j = 0; j < feedCount && found < 0; j++) {
+            if (!matched[j] && feeds[j].atMs >= expected->fromMs && feeds[j].atMs <= expected->toMs &&
+                (expected->mode < 0 || feeds[j].mode == expected->mode)) {
+                found = j;
+            }
+        }
+        if (found < 0) {
+            printf("sim FAILED : no feed of %s between %lld and %lld ms\n",
+                   modeName(expected->mode, name, sizeof(name)), expected->fromMs, expected->toMs);
+            ok = false;
+            continue;
+        }
+        matched[found] = true;
+        printf("sim expected feed : started %lld ms into its window\n", feeds[found].atMs - expected->fromMs);
+    }
+    pthread_mutex_unlock(&feedsLock);
+    return ok;
+}
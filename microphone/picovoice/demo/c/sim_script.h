@@ -0,0 +1,41 @@
+#ifndef SIM_SCRIPT_H
+#define SIM_SCRIPT_H
+
+#include <stdbool.h>
+
+// The script of a replay run: button presses to make, and the feeds the run is expected to end up with, all on the
+// event loop's virtual clock, which follows the audio the pipeline has processed. One step per line, '#' comments:
+//
+//   press AT_MS [HOLD_MS]            the button goes down at AT_MS and comes up HOLD_MS later, 200 by default
+//   expect_feed FROM_MS TO_MS [MODE] a feed, of MODE or any, starts between the two
+//   expect_feeds COUNT [MODE]        the run ends with COUNT feeds, of MODE or of any mode
+//   settle MS                        how long the clock runs on after the audio ends, SIM_SCRIPT_DEFAULT_SETTLE_MS by
+//                                    default, so the last feed finishes
+//
+// Each expected feed is matched to the earliest feed in its window not yet matched to another.
+
+#define SIM_SCRIPT_MAX_STEPS 64
+#define SIM_SCRIPT_MAX_FEEDS 64
+#define SIM_SCRIPT_DEFAULT_HOLD_MS 200
+// a long feed holds the gate open for ten seconds
+#define SIM_SCRIPT_DEFAULT_SETTLE_MS 15000
+
+// Sets the simulated button's line, 1 while pressed.
+typedef void (*simScript_buttonFunc)(int level);
+
+// Prints what is wrong with the file and returns false if it can't be used.
+bool simScript_load(const char* path);
+
+long long simScript_settleMs(void);
+
+// Makes the presses due by toMs, moving the virtual clock to each one first, then moves it on to toMs. The thread
+// driving the replay, not the loop's. Returns false once the loop has stopped.
+bool simScript_runTo(long long toMs, simScript_buttonFunc setButton);
+
+// A feed started now, on the loop thread.
+void simScript_feedStarted(int mode);
+
+// Prints every feed of the run and every expectation not met. Returns true if they all were.
+bool simScript_check(void);
+
+#endif
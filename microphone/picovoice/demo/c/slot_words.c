@@ -0,0 +1,81 @@
+#include "slot_words.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "servo_driver.h"
+
+// a power of two, at least twice the words below, so probes stay short
+#define TABLE_SIZE 128
+
+typedef struct {
+    const char* word;
+    slotWords_kind kind;
+    long long value;
+} slotWord;
+
+static const slotWord words[] = {
+    {"zero", SLOT_WORD_NUMBER, 0}, {"one", SLOT_WORD_NUMBER, 1}, {"two", SLOT_WORD_NUMBER, 2},
+    {"three", SLOT_WORD_NUMBER, 3}, {"four", SLOT_WORD_NUMBER, 4}, {"five", SLOT_WORD_NUMBER, 5},
+    {"six", SLOT_WORD_NUMBER, 6}, {"seven", SLOT_WORD_NUMBER, 7}, {"eight", SLOT_WORD_NUMBER, 8},
+    {"nine", SLOT_WORD_NUMBER, 9}, {"ten", SLOT_WORD_NUMBER, 10}, {"eleven", SLOT_WORD_NUMBER, 11},
+    {"twelve", SLOT_WORD_NUMBER, 12}, {"thirteen", SLOT_WORD_NUMBER, 13}, {"fourteen", SLOT_WORD_NUMBER, 14},
+    {"fifteen", SLOT_WORD_NUMBER, 15}, {"sixteen", SLOT_WORD_NUMBER, 16}, {"seventeen", SLOT_WORD_NUMBER, 17},
+    {"eighteen", SLOT_WORD_NUMBER, 18}, {"nineteen", SLOT_WORD_NUMBER, 19}, {"twenty", SLOT_WORD_NUMBER, 20},
+    {"thirty", SLOT_WORD_NUMBER, 30}, {"forty", SLOT_WORD_NUMBER, 40}, {"fifty", SLOT_WORD_NUMBER, 50},
+    {"sixty", SLOT_WORD_NUMBER, 60},
+    {"second", SLOT_WORD_UNIT, 1000}, {"seconds", SLOT_WORD_UNIT, 1000},
+    {"minute", SLOT_WORD_UNIT, 60 * 1000}, {"minutes", SLOT_WORD_UNIT, 60 * 1000},
+    {"hour", SLOT_WORD_UNIT, 60 * 60 * 1000}, {"hours", SLOT_WORD_UNIT, 60 * 60 * 1000},
+    {"every", SLOT_WORD_EVERY, 0},
+    {"small", SLOT_WORD_PORTION, SERVO_PORTION_SMALL}, {"little", SLOT_WORD_PORTION, SERVO_PORTION_SMALL},
+    {"snack", SLOT_WORD_PORTION, SERVO_PORTION_SMALL},
+    {"normal", SLOT_WORD_PORTION, SERVO_PORTION_NORMAL}, {"regular", SLOT_WORD_PORTION, SERVO_PORTION_NORMAL},
+    {"usual", SLOT_WORD_PORTION, SERVO_PORTION_NORMAL},
+    {"large", SLOT_WORD_PORTION, SERVO_PORTION_LARGE}, {"big", SLOT_WORD_PORTION, SERVO_PORTION_LARGE},
+    {"double", SLOT_WORD_PORTION, SERVO_PORTION_DOUBLE},
+    {"tank", SLOT_WORD_TANK_SLOT, 0}, {"portion", SLOT_WORD_PORTION_SLOT, 0},
+};
+
+// the hash of table[i].word, which is NULL in an empty slot
+static uint32_t hashes[TABLE_SIZE];
+static const slotWord* table[TABLE_SIZE];
+
+// FNV-1a
+static uint32_t hashOf(const char* word)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*) word; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+void slotWords_init(void)
+{
+    memset(table, 0, sizeof(table));
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        const uint32_t hash = hashOf(words[i].word);
+        uint32_t slot = hash & (TABLE_SIZE - 1);
+        while (table[slot] != NULL) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        hashes[slot] = hash;
+        table[slot] = &words[i];
+    }
+}
+
+slotWords_meaning slotWords_lookup(const char* word)
+{
+    if (word[0] >= '0' && word[0] <= '9') {
+        return (slotWords_meaning) {SLOT_WORD_NUMBER, atoll(word)};
+    }
+    const uint32_t hash = hashOf(word);
+    for (uint32_t slot = hash & (TABLE_SIZE - 1); table[slot] != NULL; slot = (slot + 1) & (TABLE_SIZE - 1)) {
+        if (hashes[slot] == hash && strcmp(table[slot]->word, word) == 0) {
+            return (slotWords_meaning) {table[slot]->kind, table[slot]->value};
+        }
+    }
+    return (slotWords_meaning) {SLOT_WORD_UNKNOWN, 0};
+}
@@ -0,0 +1,34 @@
+#ifndef SLOT_WORDS_H
+#define SLOT_WORDS_H
+
+// The words the feeder understands in Rhino's slots, and the slot names that change how a value is read, e.g. "tank"
+// and "portion". They are hashed into a table once at startup, so an inference looks each word up by its hash, with
+// one string compare to rule out a collision, instead of comparing it against every word it could be.
+
+typedef enum {
+    SLOT_WORD_UNKNOWN,
+    // value is the number, e.g. 5 for "five" or "5"
+    SLOT_WORD_NUMBER,
+    // value is the unit in ms, e.g. 60000 for "minutes"
+    SLOT_WORD_UNIT,
+    // "every", which makes a delay a period
+    SLOT_WORD_EVERY,
+    // value is a servoPortion
+    SLOT_WORD_PORTION,
+    // slot names: the value is a tank's number, or a portion
+    SLOT_WORD_TANK_SLOT,
+    SLOT_WORD_PORTION_SLOT,
+} slotWords_kind;
+
+typedef struct {
+    slotWords_kind kind;
+    long long value;
+} slotWords_meaning;
+
+// Before the first lookup.
+void slotWords_init(void);
+
+// Safe from any thread once slotWords_init has returned.
+slotWords_meaning slotWords_lookup(const char* word);
+
+#endif
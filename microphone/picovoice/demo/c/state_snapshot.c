@@ -0,0 +1,265 @@
+#include "state_snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "event_loop.h"
+
+#define SNAPSHOT_MAGIC "FEEDSTA1"
+// each copy on a page of its own, so a page torn by a power cut only ever holds one of them
+#define SNAPSHOT_PAGE_SIZE 4096
+#define SNAPSHOT_SLOTS 2
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t stateSize;
+    uint32_t slotSize;
+    uint32_t reserved[11];
+} snapshotHeader;
+
+typedef struct {
+    // written last; 0 while the copy is being written
+    uint64_t generation;
+    // of generation and state
+    uint32_t checksum;
+    uint32_t reserved;
+    stateSnapshot_state state;
+} snapshotSlot;
+
+typedef struct {
+    snapshotHeader header;
+    unsigned char headerPage[SNAPSHOT_PAGE_SIZE - sizeof(snapshotHeader)];
+    union {
+        snapshotSlot slot;
+        unsigned char page[SNAPSHOT_PAGE_SIZE];
+    } slots[SNAPSHOT_SLOTS];
+} snapshotFile;
+
+typedef char snapshotHeaderIs64Bytes[(sizeof(snapshotHeader) == 64) ? 1 : -1];
+typedef char feedIs32Bytes[(sizeof(stateSnapshot_feed) == 32) ? 1 : -1];
+typedef char guardIs40Bytes[(sizeof(stateSnapshot_guard) == 40) ? 1 : -1];
+typedef char stateIs968Bytes[(sizeof(stateSnapshot_state) == 968) ? 1 : -1];
+typedef char countersFit[(STATE_SNAPSHOT_FEEDS + STATE_SNAPSHOT_MAX_MODES <= STATE_SNAPSHOT_COUNTERS) ? 1 : -1];
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+// stands in for the file until it is open, or if it can't be
+static snapshotFile unmapped;
+static snapshotFile* file = &unmapped;
+static int fileFd = -1;
+static int syncTimerFd = -1;
+static bool isDirty = false;
+// the slot holding the newest state
+static int current = 0;
+
+// FNV-1a, of the state and the generation it has or is about to have; it only has to catch a copy torn by a crash
+static uint32_t checksumOf(const snapshotSlot* slot, uint64_t generation)
+{
+    uint32_t hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*) &slot->state;
+    for (size_t i = 0; i < sizeof(slot->state); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    for (int shift = 0; shift < 64; shift += 8) {
+        hash = (hash ^ (unsigned char) (generation >> shift)) * 16777619u;
+    }
+    return hash;
+}
+
+static bool isWhole(const snapshotSlot* slot)
+{
+    return slot->generation != 0 && slot->checksum == checksumOf(slot, slot->generation);
+}
+
+// Only the parent of the file; /var/lib is there already.
+static void makeDirectory(const char* path)
+{
+    char directory[PATH_MAX];
+    snprintf(directory, sizeof(directory), "%s", path);
+    char* slash = strrchr(directory, '/');
+    if (slash == NULL || slash == directory) {
+        return;
+    }
+    *slash = '\0';
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        asyncLog_log(ASYNC_LOG_WARN, "State snapshot: Unable to create %s: %s", directory, strerror(errno));
+    }
+}
+
+static void onSyncTimer(int fd, void* userData)
+{
+    (void) userData;
+    eventLoop_readTimer(fd);
+    stateSnapshot_sync();
+}
+
+// Picks up the newest whole copy of a file of this version, or starts the file over.
+static void load(const char* path)
+{
+    snapshotHeader* header = &file->header;
+    const bool isOurs = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0
+            && header->version == STATE_SNAPSHOT_VERSION && header->stateSize == sizeof(stateSnapshot_state)
+            && header->slotSize == SNAPSHOT_PAGE_SIZE;
+    int newest = -1;
+    for (int i = 0; isOurs && i < SNAPSHOT_SLOTS; i++) {
+        const snapshotSlot* slot = &file->slots[i].slot;
+        if (isWhole(slot) && (newest < 0 || slot->generation > file->slots[newest].slot.generation)) {
+            newest = i;
+        }
+    }
+    if (newest >= 0) {
+        current = newest;
+        asyncLog_log(ASYNC_LOG_INFO, "State snapshot: carrying on from %s, update %llu.", path,
+                (unsigned long long) file->slots[newest].slot.generation);
+        return;
+    }
+    if (header->magic[0] != '\0') {
+        asyncLog_log(ASYNC_LOG_WARN, "State snapshot: %s is from another version, or torn, starting over.", path);
+    }
+    memset(file, 0, sizeof(*file));
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = STATE_SNAPSHOT_VERSION;
+    header->stateSize = sizeof(stateSnapshot_state);
+    header->slotSize = SNAPSHOT_PAGE_SIZE;
+    current = 0;
+    snapshotSlot* first = &file->slots[0].slot;
+    first->generation = 1;
+    first->checksum = checksumOf(first, first->generation);
+    isDirty = true;
+}
+
+bool stateSnapshot_open(const char* path)
+{
+    makeDirectory(path);
+    const int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "State snapshot: Unable to open %s: %s", path, strerror(errno));
+        return false;
+    }
+    // two writers would each take the other's copy for the spare one
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "State snapshot: %s is in use by another feeder.", path);
+        close(fd);
+        return false;
+    }
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, sizeof(snapshotFile)) == 0) {
+        mapped = mmap(NULL, sizeof(snapshotFile), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapped == MAP_FAILED) {
+        asyncLog_log(ASYNC_LOG_ERROR, "State snapshot: Unable to map %s: %s", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    pthread_mutex_lock(&mutex);
+    fileFd = fd;
+    file = mapped;
+    load(path);
+    pthread_mutex_unlock(&mutex);
+
+    syncTimerFd = eventLoop_createTimer();
+    if (syncTimerFd >= 0 && !eventLoop_add(syncTimerFd, EPOLLIN, onSyncTimer, NULL)) {
+        close(syncTimerFd);
+        syncTimerFd = -1;
+    }
+    if (syncTimerFd >= 0) {
+        eventLoop_setSubsystem(syncTimerFd, "feeds");
+        // a file just made, or started over
+        if (isDirty) {
+            eventLoop_armTimer(syncTimerFd, STATE_SNAPSHOT_SYNC_INTERVAL_MS, 0);
+        }
+    } else {
+        asyncLog_log(ASYNC_LOG_WARN, "State snapshot: no sync timer, the state reaches the disk at shutdown only.");
+    }
+    return true;
+}
+
+void stateSnapshot_read(stateSnapshot_state* state)
+{
+    pthread_mutex_lock(&mutex);
+    *state = file->slots[current].slot.state;
+    pthread_mutex_unlock(&mutex);
+}
+
+stateSnapshot_state* stateSnapshot_begin(void)
+{
+    pthread_mutex_lock(&mutex);
+    snapshotSlot* spare = &file->slots[1 - current].slot;
+    // a crash from here until commit leaves this copy torn, and the newest one whole
+    __atomic_store_n(&spare->generation, 0, __ATOMIC_RELEASE);
+    spare->state = file->slots[current].slot.state;
+    return &spare->state;
+}
+
+void stateSnapshot_commit(void)
+{
+    snapshotSlot* spare = &file->slots[1 - current].slot;
+    const uint64_t generation = file->slots[current].slot.generation + 1;
+    spare->checksum = checksumOf(spare, generation);
+    __atomic_store_n(&spare->generation, generation, __ATOMIC_RELEASE);
+    current = 1 - current;
+    // one sync a while after the first change since the last, rather than one per update
+    if (!isDirty && syncTimerFd >= 0) {
+        eventLoop_armTimer(syncTimerFd, STATE_SNAPSHOT_SYNC_INTERVAL_MS, 0);
+    }
+    isDirty = true;
+    pthread_mutex_unlock(&mutex);
+}
+
+void stateSnapshot_count(int counter)
+{
+    if (counter < 0 || counter >= STATE_SNAPSHOT_COUNTERS) {
+        return;
+    }
+    stateSnapshot_begin()->counters[counter]++;
+    stateSnapshot_commit();
+}
+
+void stateSnapshot_sync(void)
+{
+    pthread_mutex_lock(&mutex);
+    const bool isDue = isDirty && fileFd >= 0;
+    isDirty = false;
+    pthread_mutex_unlock(&mutex);
+    // outside the mutex, so an update never waits on the disk
+    if (isDue && msync(file, sizeof(*file), MS_SYNC) != 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "State snapshot: Unable to sync: %s", strerror(errno));
+        pthread_mutex_lock(&mutex);
+        isDirty = true;
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+void stateSnapshot_close(void)
+{
+    if (syncTimerFd >= 0) {
+        eventLoop_remove(syncTimerFd);
+        close(syncTimerFd);
+        syncTimerFd = -1;
+    }
+    stateSnapshot_sync();
+    pthread_mutex_lock(&mutex);
+    if (fileFd >= 0) {
+        // the state carries on in memory until the feeder has stopped
+        unmapped.slots[0].slot = file->slots[current].slot;
+        current = 0;
+        munmap(file, sizeof(*file));
+        file = &unmapped;
+        // closing drops the lock
+        close(fileFd);
+        fileFd = -1;
+    }
+    isDirty = false;
+    pthread_mutex_unlock(&mutex);
+}
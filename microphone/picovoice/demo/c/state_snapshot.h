@@ -0,0 +1,87 @@
+#ifndef STATE_SNAPSHOT_H
+#define STATE_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The little the feeder has to remember to carry on where it stopped: the mode, the feeds still to come, each mode's
+// rate limit and the counters /metrics serves. It lives in one small memory-mapped file of fixed layout, so a start
+// maps it and reads it as it is, with nothing to parse or replay. The file holds two copies of the state, a page
+// apart: an update is written into the older copy, its checksum next and its generation last, so a crash, or a power
+// cut half way through a page, leaves the newer copy whole, and the next start takes the newest whole one. Updates
+// reach the page cache at once, which a crash of the feeder doesn't lose; dirty pages go to disk within
+// STATE_SNAPSHOT_SYNC_INTERVAL_MS. Until stateSnapshot_open, or if it fails, the state is kept in memory only.
+
+#define STATE_SNAPSHOT_DEFAULT_PATH "/var/lib/fishfeeder/state.snapshot"
+// bumped whenever stateSnapshot_state changes; a file of another version is started over
+#define STATE_SNAPSHOT_VERSION 1
+#define STATE_SNAPSHOT_SYNC_INTERVAL_MS 5000
+#define STATE_SNAPSHOT_MAX_FEEDS 16
+#define STATE_SNAPSHOT_MAX_MODES 8
+
+typedef enum {
+    STATE_SNAPSHOT_WAKE_WORDS = 0,
+    STATE_SNAPSHOT_UNDERSTOOD,
+    STATE_SNAPSHOT_NOT_UNDERSTOOD,
+    // feeds started, one counter per mode from here
+    STATE_SNAPSHOT_FEEDS,
+    // with room for a few more before the layout has to change
+    STATE_SNAPSHOT_COUNTERS = 16
+} stateSnapshot_counter;
+
+// A pending one-off or recurring feed, from feed_scheduler.c.
+typedef struct {
+    // CLOCK_REALTIME, in microseconds, so it means the same after a reboot
+    int64_t dueUs;
+    // 0 for a one-off
+    int64_t intervalUs;
+    int32_t mode;
+    int32_t tank;
+    int32_t source;
+    int32_t portion;
+} stateSnapshot_feed;
+
+// A mode's token bucket, from feed_guard.c.
+typedef struct {
+    double tokens;
+    // CLOCK_REALTIME, in microseconds: when tokens was last brought up to date, and of the last feed let through, 0 if
+    // none
+    int64_t refilledUs;
+    int64_t lastFeedUs;
+    // the limit they were counted under; under another one the bucket is replayed from the feed journal instead
+    double feedsPerHour;
+    int32_t burst;
+    // 0 until the mode's first feed
+    int32_t isSet;
+} stateSnapshot_guard;
+
+typedef struct {
+    int32_t mode;
+    uint32_t feedCount;
+    stateSnapshot_feed feeds[STATE_SNAPSHOT_MAX_FEEDS];
+    stateSnapshot_guard guards[STATE_SNAPSHOT_MAX_MODES];
+    uint64_t counters[STATE_SNAPSHOT_COUNTERS];
+} stateSnapshot_state;
+
+// Creates the file, and its directory, if they don't exist, and adds its sync timer to the event loop, which has to
+// be initialised. A file another feeder has open, of another version, or with neither copy whole is not used, and the
+// state starts from zero. Returns false if the state is kept in memory only.
+bool stateSnapshot_open(const char* path);
+
+// Copies out the newest state. Safe from any thread.
+void stateSnapshot_read(stateSnapshot_state* state);
+
+// An update: begin returns the spare copy, already holding the newest state, for the caller to change, and commit
+// makes it the newest. Safe from any thread; others wait in between, so keep it short.
+stateSnapshot_state* stateSnapshot_begin(void);
+void stateSnapshot_commit(void);
+
+// Adds one to a counter, e.g. STATE_SNAPSHOT_FEEDS + mode.
+void stateSnapshot_count(int counter);
+
+// Writes the dirty pages out now, e.g. before shutdown.
+void stateSnapshot_sync(void);
+
+void stateSnapshot_close(void);
+
+#endif
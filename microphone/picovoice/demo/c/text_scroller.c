@@ -0,0 +1,91 @@
+#include "text_scroller.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "event_loop.h"
+#include "frame_buffer.h"
+#include "glyph_table.h"
+
+#define MAX_TEXT_LENGTH 64
+#define MAX_TEXT_COLUMNS 256
+// blank columns between the end of the text and its start coming round again
+#define SCROLL_GAP_COLUMNS GLYPH_TABLE_COLS
+
+static int stepFd = -1;
+
+static char currentText[MAX_TEXT_LENGTH];
+static bool hasText = false;
+static unsigned char textColumns[MAX_TEXT_COLUMNS + SCROLL_GAP_COLUMNS];
+static int textWidth = 0;
+static int scrollOffset = 0;
+
+// Transposes the 8 visible columns into rows.
+static void drawWindow(void){
+  unsigned char* rows = frameBuffer_beginDraw();
+  memset(rows, 0, GLYPH_TABLE_ROWS);
+  if(textWidth <= GLYPH_TABLE_COLS){
+    glyphTable_render(currentText, rows);
+  } else {
+    const int stripWidth = textWidth + SCROLL_GAP_COLUMNS;
+    for(int col = 0; col < GLYPH_TABLE_COLS; col++){
+      unsigned char column = textColumns[(scrollOffset + col) % stripWidth];
+      for(int i = 0; i < GLYPH_TABLE_ROWS; i++){
+        rows[i] |= (unsigned char) (((column >> i) & 1) << col);
+      }
+    }
+  }
+  frameBuffer_endDraw();
+}
+
+static void onStep(int fd, void* userData){
+  (void) userData;
+  // a periodic timerfd keeps the scroll rate steady however long a draw takes
+  if(eventLoop_readTimer(fd) == 0){
+    return;
+  }
+  if(hasText && textWidth > GLYPH_TABLE_COLS){
+    scrollOffset = (scrollOffset + 1) % (textWidth + SCROLL_GAP_COLUMNS);
+    drawWindow();
+  }
+}
+
+void textScroller_start(long long stepInMs){
+  stepFd = eventLoop_createTimer();
+  if(stepFd < 0){
+    return;
+  }
+  long long step = stepInMs > 0 ? stepInMs : 100;
+  if(!eventLoop_add(stepFd, EPOLLIN, onStep, NULL) || !eventLoop_armTimer(stepFd, step, step)){
+    textScroller_stop();
+    return;
+  }
+  eventLoop_setSubsystem(stepFd, "display");
+}
+
+void textScroller_stop(void){
+  if(stepFd >= 0){
+    eventLoop_remove(stepFd);
+    close(stepFd);
+    stepFd = -1;
+  }
+}
+
+void textScroller_setText(const char* text){
+  if(hasText && strncmp(currentText, text, MAX_TEXT_LENGTH - 1) == 0){
+    return;
+  }
+  strncpy(currentText, text, MAX_TEXT_LENGTH - 1);
+  currentText[MAX_TEXT_LENGTH - 1] = '\0';
+  memset(textColumns, 0, sizeof(textColumns));
+  textWidth = glyphTable_renderColumns(currentText, textColumns, MAX_TEXT_COLUMNS);
+  scrollOffset = 0;
+  hasText = true;
+  drawWindow();
+}
+
+void textScroller_clearText(void){
+  hasText = false;
+}
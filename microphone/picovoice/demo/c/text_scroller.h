@@ -0,0 +1,17 @@
+#ifndef TEXT_SCROLLER_H
+#define TEXT_SCROLLER_H
+
+// Shows text on the LED matrix. Text that fits is drawn once; longer text is rendered into a column strip once and
+// scrolled one column per step by a timerfd on the event loop. Call everything from the event loop thread.
+
+void textScroller_start(long long stepInMs);
+
+void textScroller_stop(void);
+
+// Setting the text that is already showing keeps the current scroll position.
+void textScroller_setText(const char* text);
+
+// Stops drawing so something else can use the display; the next textScroller_setText starts over.
+void textScroller_clearText(void);
+
+#endif
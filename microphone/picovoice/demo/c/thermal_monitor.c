@@ -0,0 +1,232 @@
+#include "thermal_monitor.h"
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "async_log.h"
+#include "board_link.h"
+#include "event_loop.h"
+#include "metrics.h"
+
+#define MAX_ZONES 16
+#define MAX_TRIP_POINTS 16
+
+static int startMilliC = 0;
+static int timerFd = -1;
+static int reportFd = -1;
+static struct sockaddr_in camera;
+static int zoneFds[MAX_ZONES];
+static int zoneCount = 0;
+static thermalMonitor_stats counters;
+static metrics_id levelMetric = -1;
+static metrics_id temperatureMetric = -1;
+
+// a sysfs attribute's number, or INT_MIN if there isn't one
+static int readNumber(int fd)
+{
+    char text[16];
+    const ssize_t length = pread(fd, text, sizeof(text) - 1, 0);
+    if (length <= 0) {
+        return INT_MIN;
+    }
+    text[length] = '\0';
+    char* end;
+    const long value = strtol(text, &end, 10);
+    return (end == text) ? INT_MIN : (int) value;
+}
+
+static int readZoneAttribute(const char* zone, const char* name)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), THERMAL_MONITOR_PATH "/%s/%s", zone, name);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return INT_MIN;
+    }
+    const int value = readNumber(fd);
+    close(fd);
+    return value;
+}
+
+// the lowest passive trip point of a zone, or INT_MAX if it has none
+static int passiveTripMilliC(const char* zone)
+{
+    int lowest = INT_MAX;
+    for (int i = 0; i < MAX_TRIP_POINTS; i++) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), THERMAL_MONITOR_PATH "/%s/trip_point_%d_type", zone, i);
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            break;
+        }
+        char type[16] = "";
+        const ssize_t length = read(fd, type, sizeof(type) - 1);
+        close(fd);
+        if (length > 0 && strncmp(type, "passive", 7) == 0) {
+            char name[32];
+            snprintf(name, sizeof(name), "trip_point_%d_temp", i);
+            const int milliC = readZoneAttribute(zone, name);
+            if (milliC != INT_MIN && milliC > 0 && milliC < lowest) {
+                lowest = milliC;
+            }
+        }
+    }
+    return lowest;
+}
+
+static void report(int level)
+{
+    char message[16];
+    const int length = snprintf(message, sizeof(message), "thermal %d\n", level);
+    // capture.c not running is not an error
+    if (!boardLink_send(message)) {
+        (void) sendto(reportFd, message, (size_t) length, 0, (const struct sockaddr*) &camera, sizeof(camera));
+    }
+}
+
+// the level milliC is in, counting up from level and leaving it only past the hysteresis
+static int levelFor(int milliC, int level)
+{
+    while (level < THERMAL_MONITOR_MAX_LEVEL && milliC >= startMilliC + level * THERMAL_MONITOR_STEP_MILLI_C) {
+        level++;
+    }
+    while (level > 0 && milliC < startMilliC + (level - 1) * THERMAL_MONITOR_STEP_MILLI_C -
+            THERMAL_MONITOR_HYSTERESIS_MILLI_C) {
+        level--;
+    }
+    return level;
+}
+
+static void onTimer(int fd, void* userData)
+{
+    (void) userData;
+    if (eventLoop_readTimer(fd) == 0) {
+        return;
+    }
+    int hottest = INT_MIN;
+    for (int i = 0; i < zoneCount; i++) {
+        const int milliC = readNumber(zoneFds[i]);
+        if (milliC > hottest) {
+            hottest = milliC;
+        }
+    }
+    const int level = __atomic_load_n(&counters.level, __ATOMIC_RELAXED);
+    // a zone that can't be read this time leaves the level where it was
+    const int next = (hottest == INT_MIN) ? level : levelFor(hottest, level);
+    if (hottest != INT_MIN) {
+        metrics_set(temperatureMetric, hottest / 1000.0);
+        if (hottest > __atomic_load_n(&counters.maxMilliC, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&counters.maxMilliC, hottest, __ATOMIC_RELAXED);
+        }
+    }
+    if (next != level) {
+        __atomic_store_n(&counters.level, next, __ATOMIC_RELAXED);
+        if (next > __atomic_load_n(&counters.maxLevel, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&counters.maxLevel, next, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add((next > level) ? &counters.stepsUp : &counters.stepsDown, 1, __ATOMIC_RELAXED);
+        metrics_set(levelMetric, next);
+        asyncLog_log((next > level) ? ASYNC_LOG_WARN : ASYNC_LOG_INFO, "Thermal: level %d at %.1f C", next,
+                hottest / 1000.0);
+    }
+    // every time, so a capture.c started later hears it too
+    report(next);
+}
+
+bool thermalMonitor_start(const thermalMonitor_config* config)
+{
+    memset(&counters, 0, sizeof(counters));
+    if (levelMetric < 0) {
+        levelMetric = metrics_addGauge("feeder_thermal_level",
+                                       "Optional camera workloads shed to keep the SoC from throttling itself.");
+        temperatureMetric = metrics_addGauge("feeder_soc_temperature_celsius",
+                                             "The hottest thermal zone, at the last reading.");
+    }
+
+    int lowestTrip = INT_MAX;
+    DIR* dir = opendir(THERMAL_MONITOR_PATH);
+    if (dir) {
+        const struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL && zoneCount < MAX_ZONES) {
+            if (strncmp(entry->d_name, "thermal_zone", 12) != 0) {
+                continue;
+            }
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), THERMAL_MONITOR_PATH "/%s/temp", entry->d_name);
+            const int fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                continue;
+            }
+            zoneFds[zoneCount++] = fd;
+            const int tripMilliC = passiveTripMilliC(entry->d_name);
+            if (tripMilliC < lowestTrip) {
+                lowestTrip = tripMilliC;
+            }
+        }
+        closedir(dir);
+    }
+    if (zoneCount == 0) {
+        printf("Thermal: no zones to read in " THERMAL_MONITOR_PATH ".\n");
+        return false;
+    }
+    if (config->startMilliC > 0) {
+        startMilliC = config->startMilliC;
+    } else if (lowestTrip != INT_MAX) {
+        startMilliC = lowestTrip - THERMAL_MONITOR_MAX_LEVEL * THERMAL_MONITOR_STEP_MILLI_C;
+    } else {
+        startMilliC = THERMAL_MONITOR_DEFAULT_START_MILLI_C;
+    }
+
+    reportFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    memset(&camera, 0, sizeof(camera));
+    camera.sin_family = AF_INET;
+    camera.sin_port = htons(THERMAL_MONITOR_PORT);
+    camera.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    timerFd = eventLoop_createTimer();
+    const bool ok = reportFd >= 0 && timerFd >= 0 && eventLoop_add(timerFd, EPOLLIN, onTimer, NULL)
+            && eventLoop_armTimer(timerFd, THERMAL_MONITOR_INTERVAL_MS, THERMAL_MONITOR_INTERVAL_MS);
+    if (!ok) {
+        perror("Thermal: Unable to start.");
+        thermalMonitor_stop();
+        return false;
+    }
+    eventLoop_setSubsystem(timerFd, "sensors");
+    printf("Thermal: %d zones, shedding from %.1f C\n", zoneCount, startMilliC / 1000.0);
+    return true;
+}
+
+void thermalMonitor_getStats(thermalMonitor_stats* stats)
+{
+    stats->level = __atomic_load_n(&counters.level, __ATOMIC_RELAXED);
+    stats->maxLevel = __atomic_load_n(&counters.maxLevel, __ATOMIC_RELAXED);
+    stats->stepsUp = __atomic_load_n(&counters.stepsUp, __ATOMIC_RELAXED);
+    stats->stepsDown = __atomic_load_n(&counters.stepsDown, __ATOMIC_RELAXED);
+    stats->maxMilliC = __atomic_load_n(&counters.maxMilliC, __ATOMIC_RELAXED);
+}
+
+void thermalMonitor_stop(void)
+{
+    if (timerFd >= 0) {
+        eventLoop_remove(timerFd);
+        close(timerFd);
+        timerFd = -1;
+    }
+    if (reportFd >= 0) {
+        report(0);
+        close(reportFd);
+        reportFd = -1;
+    }
+    for (int i = 0; i < zoneCount; i++) {
+        close(zoneFds[i]);
+    }
+    zoneCount = 0;
+}
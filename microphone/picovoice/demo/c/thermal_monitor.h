@@ -0,0 +1,47 @@
+#ifndef THERMAL_MONITOR_H
+#define THERMAL_MONITOR_H
+
+#include <stdbool.h>
+
+// Keeps a board in a warm enclosure from reaching the point where the SoC throttles itself, which slows everything at
+// once and unpredictably. Every THERMAL_MONITOR_INTERVAL_MS the hottest of the zones under /sys/class/thermal is read
+// by a timerfd on the event loop, which has to be initialised, and turned into a level: 1 at the start temperature and
+// one more every THERMAL_MONITOR_STEP_MILLI_C above it, up to THERMAL_MONITOR_MAX_LEVEL. Without a start temperature,
+// the last level is reached a step before the lowest passive trip point, where the kernel would start throttling. A
+// level is only left once the temperature is THERMAL_MONITOR_HYSTERESIS_MILLI_C below where it began. The level goes
+// to capture.c --thermal on this board as "thermal <level>" after every reading, so the camera sheds its optional
+// work in order (time-lapse, analytics, thumbnails, then frame rate), and to the feeder_thermal_level gauge.
+
+#define THERMAL_MONITOR_PATH "/sys/class/thermal"
+#define THERMAL_MONITOR_PORT 3000
+#define THERMAL_MONITOR_INTERVAL_MS 2000
+#define THERMAL_MONITOR_MAX_LEVEL 4
+#define THERMAL_MONITOR_STEP_MILLI_C 3000
+#define THERMAL_MONITOR_HYSTERESIS_MILLI_C 2000
+// with no start temperature and no passive trip point to work back from
+#define THERMAL_MONITOR_DEFAULT_START_MILLI_C 70000
+
+typedef struct {
+    // level 1 from this temperature; 0 to work it out from the trip points
+    int startMilliC;
+} thermalMonitor_config;
+
+typedef struct {
+    int level;
+    int maxLevel;
+    long long stepsUp;
+    long long stepsDown;
+    // the hottest reading since the start
+    int maxMilliC;
+} thermalMonitor_stats;
+
+// False, having said why, if there are no zones to read.
+bool thermalMonitor_start(const thermalMonitor_config* config);
+
+// Safe from any thread.
+void thermalMonitor_getStats(thermalMonitor_stats* stats);
+
+// Tells the camera to shed nothing.
+void thermalMonitor_stop(void);
+
+#endif
@@ -0,0 +1,85 @@
+#define _GNU_SOURCE
+
+#include "thread_cpu.h"
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// the kernel's TASK_COMM_LEN
+#define NAME_LENGTH 16
+
+typedef struct {
+    char name[NAME_LENGTH];
+    long long cpuNs;
+} threadSample;
+
+static threadSample threads[THREAD_CPU_MAX_THREADS];
+static int threadCount = 0;
+
+void threadCpu_setName(pthread_t thread, const char* name)
+{
+    char truncated[NAME_LENGTH];
+    snprintf(truncated, sizeof(truncated), "%s", name);
+    pthread_setname_np(thread, truncated);
+}
+
+// Reads one task's name and user plus system time from its stat line; the name may hold spaces and parentheses, so
+// the fields are counted from the last ')'.
+static bool readTask(const char* tid, threadSample* sample, long long nsPerTick)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%s/stat", tid);
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return false; // the thread exited since the directory was read
+    }
+    char line[512];
+    const bool isRead = fgets(line, sizeof(line), file) != NULL;
+    fclose(file);
+    const char* open = strchr(line, '(');
+    const char* close = strrchr(line, ')');
+    if (!isRead || open == NULL || close == NULL || close < open) {
+        return false;
+    }
+    snprintf(sample->name, sizeof(sample->name), "%.*s", (int) (close - open - 1), open + 1);
+    unsigned long long userTicks = 0;
+    unsigned long long systemTicks = 0;
+    // state, ppid, pgrp, session, tty_nr, tpgid, flags, minflt, cminflt, majflt, cmajflt, then utime and stime
+    if (sscanf(close + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &userTicks, &systemTicks) != 2) {
+        return false;
+    }
+    sample->cpuNs = (long long) (userTicks + systemTicks) * nsPerTick;
+    return true;
+}
+
+void threadCpu_sample(void)
+{
+    const long long nsPerTick = 1000000000LL / sysconf(_SC_CLK_TCK);
+    threadCount = 0;
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == NULL) {
+        return;
+    }
+    struct dirent* entry;
+    while (threadCount < THREAD_CPU_MAX_THREADS && (entry = readdir(tasks)) != NULL) {
+        if (entry->d_name[0] != '.' && readTask(entry->d_name, &threads[threadCount], nsPerTick)) {
+            threadCount++;
+        }
+    }
+    closedir(tasks);
+}
+
+long long threadCpu_ns(const char* prefix)
+{
+    const size_t length = strlen(prefix);
+    long long ns = 0;
+    for (int i = 0; i < threadCount; i++) {
+        if (strncmp(threads[i].name, prefix, length) == 0) {
+            ns += threads[i].cpuNs;
+        }
+    }
+    return ns;
+}
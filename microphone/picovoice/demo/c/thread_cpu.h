@@ -0,0 +1,22 @@
+#ifndef THREAD_CPU_H
+#define THREAD_CPU_H
+
+#include <pthread.h>
+
+// How much CPU each of the daemon's threads has used, read from /proc/self/task, so the metrics can say which subsystem
+// the one core goes to. Threads are told apart by name: the demo names every thread it starts after its subsystem, the
+// recorder names its own pvrec-*, and any other thread carries the process name.
+
+#define THREAD_CPU_MAX_THREADS 32
+
+// pthread_setname_np; Linux keeps the first 15 characters.
+void threadCpu_setName(pthread_t thread, const char* name);
+
+// Rereads every thread's CPU time. From one thread at a time.
+void threadCpu_sample(void);
+
+// CPU time, in nanoseconds, of the threads in the last sample whose name starts with prefix. A thread that has exited
+// takes its time with it.
+long long threadCpu_ns(const char* prefix);
+
+#endif
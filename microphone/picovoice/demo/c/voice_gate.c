@@ -0,0 +1,167 @@
+#include "voice_gate.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_budget.h"
+
+// quieter than this is treated as this, so digital silence doesn't drag the floor to minus infinity
+#define MIN_ENERGY_DB -90.0f
+// the floor drops to a quieter frame at once but rises slowly, so a long word doesn't become the floor
+#define FLOOR_FALL 0.5f
+#define FLOOR_RISE 0.01f
+// hiss and splashing cross zero far more often than voiced speech
+#define MAX_VOICE_ZERO_CROSSING_RATE 0.35f
+
+static int32_t frameLength = 0;
+static voiceGate_config gateConfig;
+
+static int16_t* preRoll = NULL;
+static int preRollStart = 0;
+static int preRollCount = 0;
+
+static float noiseFloorDb = MIN_ENERGY_DB;
+static bool isOpen = false;
+static bool isHeld = false;
+static int framesSinceVoice = 0;
+static voiceGate_stats counters;
+
+static float energyDb(const int16_t* pcm)
+{
+    double sum = 0;
+    for (int32_t i = 0; i < frameLength; i++) {
+        sum += (double) pcm[i] * pcm[i];
+    }
+    const double meanSquare = sum / frameLength / (32768.0 * 32768.0);
+    const float db = (meanSquare > 0) ? (float) (10.0 * log10(meanSquare)) : MIN_ENERGY_DB;
+    return (db < MIN_ENERGY_DB) ? MIN_ENERGY_DB : db;
+}
+
+static float zeroCrossingRate(const int16_t* pcm)
+{
+    int crossings = 0;
+    for (int32_t i = 1; i < frameLength; i++) {
+        crossings += (pcm[i - 1] < 0) != (pcm[i] < 0);
+    }
+    return (float) crossings / (frameLength - 1);
+}
+
+static bool isVoice(const int16_t* pcm)
+{
+    const float db = energyDb(pcm);
+    if (counters.frames == 1) {
+        // the room is assumed quiet when listening starts
+        noiseFloorDb = db;
+    }
+    const bool voice = (db > noiseFloorDb + gateConfig.thresholdDb) &&
+            (zeroCrossingRate(pcm) < MAX_VOICE_ZERO_CROSSING_RATE);
+    // voice frames count too, or steady noise louder than the first frames would hold the gate open for good
+    noiseFloorDb += (db - noiseFloorDb) * ((db < noiseFloorDb) ? FLOOR_FALL : FLOOR_RISE);
+    return voice;
+}
+
+static void keepForPreRoll(const int16_t* pcm)
+{
+    if (gateConfig.preRollFrames == 0) {
+        return;
+    }
+    const int slot = (preRollStart + preRollCount) % gateConfig.preRollFrames;
+    memcpy(&preRoll[slot * frameLength], pcm, (size_t) frameLength * sizeof(int16_t));
+    if (preRollCount < gateConfig.preRollFrames) {
+        preRollCount++;
+    } else {
+        preRollStart = (preRollStart + 1) % gateConfig.preRollFrames;
+    }
+}
+
+static void pass(const int16_t* pcm, voiceGate_passFunc passFunc, void* userData)
+{
+    counters.passedFrames++;
+    passFunc(pcm, userData);
+}
+
+bool voiceGate_init(int32_t length, const voiceGate_config* config)
+{
+    if (config->preRollFrames < 0 || config->preRollFrames > VOICE_GATE_MAX_PRE_ROLL_FRAMES ||
+            config->hangoverFrames < 0) {
+        printf("Voice gate: invalid configuration.\n");
+        return false;
+    }
+    frameLength = length;
+    gateConfig = *config;
+    preRollStart = 0;
+    preRollCount = 0;
+    noiseFloorDb = MIN_ENERGY_DB;
+    isOpen = false;
+    isHeld = false;
+    framesSinceVoice = 0;
+    memset(&counters, 0, sizeof(counters));
+
+    if (config->preRollFrames > 0) {
+        preRoll = malloc((size_t) config->preRollFrames * length * sizeof(int16_t));
+        if (!preRoll) {
+            printf("Voice gate: Unable to allocate the pre-roll.\n");
+            return false;
+        }
+        memoryBudget_add("voice gate pre-roll", (long long) config->preRollFrames * length * sizeof(int16_t), true);
+    }
+    return true;
+}
+
+void voiceGate_process(const int16_t* pcm, voiceGate_passFunc passFunc, void* userData)
+{
+    counters.frames++;
+    // the floor keeps learning while the gate is held, so it hasn't gone stale once the command is over
+    const bool voice = isVoice(pcm);
+    if (voice) {
+        framesSinceVoice = 0;
+    } else if (framesSinceVoice <= gateConfig.hangoverFrames) {
+        framesSinceVoice++;
+    }
+
+    if (!isOpen && (voice || isHeld)) {
+        isOpen = true;
+        counters.openings++;
+        for (int i = 0; i < preRollCount; i++) {
+            pass(&preRoll[((preRollStart + i) % gateConfig.preRollFrames) * frameLength], passFunc, userData);
+        }
+        preRollStart = 0;
+        preRollCount = 0;
+    } else if (isOpen && !isHeld && framesSinceVoice > gateConfig.hangoverFrames) {
+        isOpen = false;
+    }
+
+    if (isOpen) {
+        pass(pcm, passFunc, userData);
+    } else {
+        keepForPreRoll(pcm);
+    }
+}
+
+void voiceGate_setThresholdDb(float thresholdDb)
+{
+    gateConfig.thresholdDb = thresholdDb;
+}
+
+void voiceGate_hold(bool open)
+{
+    isHeld = open;
+    if (!open) {
+        // the hangover runs from the end of the command
+        framesSinceVoice = 0;
+    }
+}
+
+void voiceGate_getStats(voiceGate_stats* stats)
+{
+    *stats = counters;
+    stats->noiseFloorDb = noiseFloorDb;
+}
+
+void voiceGate_cleanup(void)
+{
+    free(preRoll);
+    preRoll = NULL;
+}
@@ -0,0 +1,49 @@
+#ifndef VOICE_GATE_H
+#define VOICE_GATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Keeps silence and steady pump noise away from pv_picovoice_process. Each frame's energy is compared with a noise
+// floor that follows the room; the gate opens when the energy stands out from it and the zero-crossing rate isn't
+// that of hiss or splashing, and closes again once the hangover has passed without voice. While closed, the last
+// frames are kept, and replayed ahead of the frame that opens the gate so the start of the wake word isn't lost.
+// Everything here runs on the inference thread.
+
+#define VOICE_GATE_MAX_PRE_ROLL_FRAMES 32
+
+typedef struct {
+    // how far above the noise floor a frame has to be to count as voice
+    float thresholdDb;
+    int hangoverFrames;
+    int preRollFrames;
+} voiceGate_config;
+
+typedef struct {
+    long long frames;
+    // frames that reached the pass function, the replayed pre-roll included
+    long long passedFrames;
+    long long openings;
+    float noiseFloorDb;
+} voiceGate_stats;
+
+typedef void (*voiceGate_passFunc)(const int16_t* pcm, void* userData);
+
+bool voiceGate_init(int32_t frameLength, const voiceGate_config* config);
+
+// Calls pass for every frame that should be processed, in order: on opening, the pre-roll and then this frame.
+void voiceGate_process(const int16_t* pcm, voiceGate_passFunc pass, void* userData);
+
+// Between frames, e.g. after the settings have been reloaded; the noise floor learned so far is kept.
+void voiceGate_setThresholdDb(float thresholdDb);
+
+// Holds the gate open regardless of the audio, e.g. from the wake word until the command has been understood, since
+// Rhino needs the silence that ends the command too.
+void voiceGate_hold(bool open);
+
+// Only once the inference thread has stopped.
+void voiceGate_getStats(voiceGate_stats* stats);
+
+void voiceGate_cleanup(void);
+
+#endif
@@ -0,0 +1,49 @@
+#include "watchdog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/watchdog.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "async_log.h"
+
+static int watchdogFd = -1;
+
+bool watchdog_open(const char* path, int timeoutSec)
+{
+    watchdogFd = open(path, O_WRONLY | O_CLOEXEC);
+    if (watchdogFd < 0) {
+        asyncLog_log(ASYNC_LOG_ERROR, "Watchdog: Unable to open %s: %s", path, strerror(errno));
+        return false;
+    }
+    int timeout = timeoutSec;
+    if (ioctl(watchdogFd, WDIOC_SETTIMEOUT, &timeout) != 0) {
+        timeout = 0;
+        ioctl(watchdogFd, WDIOC_GETTIMEOUT, &timeout);
+        asyncLog_log(ASYNC_LOG_WARN, "Watchdog: Unable to set a %d s timeout, the driver's is %d s.", timeoutSec,
+                timeout);
+    }
+    return true;
+}
+
+void watchdog_pet(void)
+{
+    if (watchdogFd >= 0) {
+        ioctl(watchdogFd, WDIOC_KEEPALIVE, 0);
+    }
+}
+
+void watchdog_close(void)
+{
+    if (watchdogFd < 0) {
+        return;
+    }
+    // the magic close; a driver built with nowayout ignores it and the board resets after the timeout
+    if (write(watchdogFd, "V", 1) != 1) {
+        asyncLog_log(ASYNC_LOG_WARN, "Watchdog: Unable to disarm: %s", strerror(errno));
+    }
+    close(watchdogFd);
+    watchdogFd = -1;
+}
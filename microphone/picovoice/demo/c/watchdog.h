@@ -0,0 +1,20 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdbool.h>
+
+// The board's hardware watchdog. Once the device is open, the board resets unless watchdog_pet is called within the
+// timeout, so a daemon that hangs, or can't get its audio back, ends in a reboot rather than a feeder that doesn't
+// listen. watchdog_close disarms it on a clean exit.
+
+#define WATCHDOG_DEFAULT_TIMEOUT_SEC 15
+
+// timeoutSec is best effort; the driver may round it or keep its own.
+bool watchdog_open(const char* path, int timeoutSec);
+
+void watchdog_pet(void);
+
+// Disarms the watchdog where the driver allows it, then closes the device.
+void watchdog_close(void);
+
+#endif
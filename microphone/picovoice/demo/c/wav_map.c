@@ -0,0 +1,118 @@
+#include "wav_map.h"
+
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint32_t readU32(const uint8_t* data)
+{
+    return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+static uint16_t readU16(const uint8_t* data)
+{
+    return (uint16_t) (data[0] | (data[1] << 8));
+}
+
+static bool isLittleEndian(void)
+{
+    const uint16_t one = 1;
+    return *(const uint8_t*) &one == 1;
+}
+
+// Walks the RIFF chunks for fmt and data; the data has to be in the file and 2-byte aligned to be read in place.
+static bool findSamples(const uint8_t* file, size_t size, int32_t sampleRate, wavMap* map)
+{
+    if (size < 12 || memcmp(file, "RIFF", 4) != 0 || memcmp(file + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool isFormatOk = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t* chunk = file + offset;
+        const uint32_t chunkSize = readU32(chunk + 4);
+        const size_t body = offset + 8;
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || body + 16 > size) {
+                return false;
+            }
+            const uint16_t format = readU16(file + body);
+            isFormatOk = (format == WAVE_FORMAT_PCM || format == WAVE_FORMAT_EXTENSIBLE) &&
+                    readU16(file + body + 2) == 1 &&
+                    readU32(file + body + 4) == (uint32_t) sampleRate &&
+                    readU16(file + body + 14) == 16;
+            if (!isFormatOk) {
+                return false;
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!isFormatOk || (body % 2) != 0) {
+                return false;
+            }
+            // a truncated recording keeps what made it to disk
+            const size_t available = (chunkSize <= size - body) ? chunkSize : size - body;
+            map->samples = (const int16_t*) (file + body);
+            map->sampleCount = (int64_t) (available / sizeof(int16_t));
+            return true;
+        }
+        // chunks are padded to an even size
+        offset = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+bool wavMap_open(const char* path, int32_t sampleRate, wavMap* map)
+{
+    memset(map, 0, sizeof(*map));
+#if defined(_WIN32) || defined(_WIN64)
+    (void) path;
+    (void) sampleRate;
+    return false;
+#else
+    if (!isLittleEndian()) {
+        return false;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    map->base = base;
+    map->size = (size_t) info.st_size;
+    if (!findSamples(base, map->size, sampleRate, map)) {
+        wavMap_close(map);
+        return false;
+    }
+    // read front to back, once
+    posix_madvise(base, map->size, POSIX_MADV_SEQUENTIAL);
+    return true;
+#endif
+}
+
+void wavMap_close(wavMap* map)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (map->base) {
+        munmap(map->base, map->size);
+    }
+#endif
+    memset(map, 0, sizeof(*map));
+}
@@ -0,0 +1,24 @@
+#ifndef WAV_MAP_H
+#define WAV_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// A WAV file whose data chunk is already what Picovoice takes: 16-bit little-endian mono PCM at the engine's sample
+// rate. The file is mapped and the samples are read in place, so frames go to pv_picovoice_process without a read,
+// a conversion or a copy. Anything else is left to drwav.
+
+typedef struct {
+    void* base;
+    size_t size;
+    const int16_t* samples;
+    int64_t sampleCount;
+} wavMap;
+
+// Returns false, quietly, if the file can't be opened or isn't in that format.
+bool wavMap_open(const char* path, int32_t sampleRate, wavMap* map);
+
+void wavMap_close(wavMap* map);
+
+#endif
@@ -25,10 +25,16 @@
 
 #endif
 
+#include "mic_harness.h"
 #include "pv_porcupine.h"
 #include "pv_recorder.h"
 
-static volatile bool is_interrupted = false;
+typedef struct {
+    pv_porcupine_t *porcupine;
+    pv_status_t (*process_func)(pv_porcupine_t *, const int16_t *, int32_t *);
+    const char *(*status_to_string_func)(pv_status_t);
+    bool has_failed;
+} porcupine_frame_context;
 
 static void *open_dl(const char *dl_path) {
 
@@ -93,17 +99,20 @@ static struct option long_options[] = {
         {"keyword_path",       required_argument, NULL, 'k'},
         {"sensitivity",        required_argument, NULL, 't'},
         {"access_key",         required_argument, NULL, 'a'},
-        {"audio_device_index", required_argument, NULL, 'd'}
+        {"audio_device_index", required_argument, NULL, 'd'},
+        {"vad_threshold_db",   required_argument, NULL, 'v'},
+        {"metrics_port",       required_argument, NULL, 'p'}
 };
 
 static void print_usage(const char *program_name) {
     fprintf(stderr, "Usage : %s -l LIBRARY_PATH -m MODEL_PATH -k KEYWORD_PATH -t SENSITIVITY -a ACCESS_KEY -d AUDIO_DEVICE_INDEX\n"
+                    "        [-v VAD_THRESHOLD_DB] [-p METRICS_PORT]\n"
                     "        %s [-s, --show_audio_devices]\n", program_name, program_name);
 }
 
 void interrupt_handler(int _) {
     (void) _;
-    is_interrupted = true;
+    micHarness_interrupt();
 }
 
 void show_audio_devices(void) {
@@ -124,6 +133,24 @@ void show_audio_devices(void) {
     pv_recorder_free_device_list(count, devices);
 }
 
+static bool process_frame(const int16_t *pcm, void *user_data) {
+    porcupine_frame_context *context = user_data;
+
+    int32_t keyword_index = -1;
+    pv_status_t status = context->process_func(context->porcupine, pcm, &keyword_index);
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "'pv_porcupine_process' failed with '%s'\n", context->status_to_string_func(status));
+        context->has_failed = true;
+        return false;
+    }
+
+    if (keyword_index != -1) {
+        fprintf(stdout, "keyword detected\n");
+        fflush(stdout);
+    }
+    return true;
+}
+
 int picovoice_main(int argc, char *argv[]) {
     signal(SIGINT, interrupt_handler);
 
@@ -133,9 +160,11 @@ int picovoice_main(int argc, char *argv[]) {
     float sensitivity = 0.5f;
     const char *access_key = NULL;
     int32_t device_index = -1;
+    float vad_threshold_db = 0.f;
+    int metrics_port = 0;
 
     int c;
-    while ((c = getopt_long(argc, argv, "sl:m:k:t:a:d:", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "sl:m:k:t:a:d:v:p:", long_options, NULL)) != -1) {
         switch (c) {
             case 's':
                 show_audio_devices();
@@ -158,6 +187,12 @@ int picovoice_main(int argc, char *argv[]) {
             case 'd':
                 device_index = (int32_t) strtol(optarg, NULL, 10);
                 break;
+            case 'v':
+                vad_threshold_db = strtof(optarg, NULL);
+                break;
+            case 'p':
+                metrics_port = (int) strtol(optarg, NULL, 10);
+                break;
             default:
                 exit(1);
         }
@@ -227,63 +262,33 @@ int picovoice_main(int argc, char *argv[]) {
 
     fprintf(stdout, "V%s\n\n", pv_porcupine_version_func());
 
-    const int32_t frame_length = pv_porcupine_frame_length_func();
-    pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t recorder_status = pv_recorder_init(device_index, frame_length, 100, true, true, &recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(recorder_status));
+    micHarness_config harness_config;
+    micHarness_defaultConfig(&harness_config, pv_porcupine_frame_length_func(), pv_sample_rate_func());
+    harness_config.deviceIndex = device_index;
+    harness_config.vadThresholdDb = vad_threshold_db;
+    harness_config.metricsPort = metrics_port;
+
+    porcupine_frame_context context = {
+            .porcupine = porcupine,
+            .process_func = pv_porcupine_process_func,
+            .status_to_string_func = pv_status_to_string_func,
+            .has_failed = false,
+    };
+    if (!micHarness_start(&harness_config, process_frame, &context)) {
         exit(1);
     }
 
-    const char *selected_device = pv_recorder_get_selected_device(recorder);
-    fprintf(stdout, "Selected device: %s.\n", selected_device);
-
+    fprintf(stdout, "Selected device: %s.\n", micHarness_deviceName());
     fprintf(stdout, "Start recording...\n");
-    recorder_status = pv_recorder_start(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to start device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
-    }
 
-    int16_t *pcm = malloc(frame_length * sizeof(int16_t));
-    if (!pcm) {
-        fprintf(stderr, "Failed to allocate pcm memory.\n");
-        exit(1);
-    }
-
-    while (!is_interrupted) {
-        recorder_status = pv_recorder_read(recorder, pcm);
-        if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-            fprintf(stderr, "Failed to read with %s.\n", pv_recorder_status_to_string(recorder_status));
-            exit(1);
-        }
-
-        int32_t keyword_index = -1;
-        porcupine_status = pv_porcupine_process_func(porcupine, pcm, &keyword_index);
-        if (porcupine_status != PV_STATUS_SUCCESS) {
-            fprintf(stderr, "'pv_porcupine_process' failed with '%s'\n", pv_status_to_string_func(porcupine_status));
-            exit(1);
-        }
-
-        if (keyword_index != -1) {
-            fprintf(stdout, "keyword detected\n");
-            fflush(stdout);
-        }
-    }
+    micHarness_wait();
     fprintf(stdout, "\n");
+    micHarness_stop();
 
-    recorder_status = pv_recorder_stop(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to stop device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
-    }
-
-    free(pcm);
-    pv_recorder_delete(recorder);
     pv_porcupine_delete_func(porcupine);
     close_dl(porcupine_library);
 
-    return 0;
+    return context.has_failed ? 1 : 0;
 }
 
 int main(int argc, char *argv[]) {
@@ -1,3 +0,0 @@
-module github.com/Picovoice/pvrecorder/sdk/go
-
-go 1.16
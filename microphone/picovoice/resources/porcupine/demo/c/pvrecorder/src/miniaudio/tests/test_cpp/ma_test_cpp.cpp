@@ -1 +0,0 @@
-#include "../test_deviceio/ma_test_deviceio.c"
@@ -1,170 +0,0 @@
-ma_result loshelf_init_decoder_and_encoder(const char* pInputFilePath, const char* pOutputFilePath, ma_format format, ma_decoder* pDecoder, ma_encoder* pEncoder)
-{
-    return filtering_init_decoder_and_encoder(pInputFilePath, pOutputFilePath, format, 0, 0, pDecoder, pEncoder);
-}
-
-
-ma_result test_loshelf2__by_format(const char* pInputFilePath, const char* pOutputFilePath, ma_format format)
-{
-    ma_result result;
-    ma_decoder decoder;
-    ma_encoder encoder;
-    ma_loshelf2_config loshelfConfig;
-    ma_loshelf2 loshelf;
-
-    printf("    %s\n", pOutputFilePath);
-
-    result = loshelf_init_decoder_and_encoder(pInputFilePath, pOutputFilePath, format, &decoder, &encoder);
-    if (result != MA_SUCCESS) {
-        return result;
-    }
-
-    loshelfConfig = ma_loshelf2_config_init(decoder.outputFormat, decoder.outputChannels, decoder.outputSampleRate, 6, 1, 200);
-    result = ma_loshelf2_init(&loshelfConfig, &loshelf);
-    if (result != MA_SUCCESS) {
-        ma_decoder_uninit(&decoder);
-        ma_encoder_uninit(&encoder);
-        return result;
-    }
-
-    for (;;) {
-        ma_uint8 tempIn[4096];
-        ma_uint8 tempOut[4096];
-        ma_uint64 tempCapIn  = sizeof(tempIn)  / ma_get_bytes_per_frame(decoder.outputFormat, decoder.outputChannels);
-        ma_uint64 tempCapOut = sizeof(tempOut) / ma_get_bytes_per_frame(decoder.outputFormat, decoder.outputChannels);
-        ma_uint64 framesToRead;
-        ma_uint64 framesJustRead;
-
-        framesToRead = ma_min(tempCapIn, tempCapOut);
-        framesJustRead = ma_decoder_read_pcm_frames(&decoder, tempIn, framesToRead);
-
-        /* Filter */
-        ma_loshelf2_process_pcm_frames(&loshelf, tempOut, tempIn, framesJustRead);
-
-        /* Write to the WAV file. */
-        ma_encoder_write_pcm_frames(&encoder, tempOut, framesJustRead);
-
-        if (framesJustRead < framesToRead) {
-            break;
-        }
-    }
-
-    ma_decoder_uninit(&decoder);
-    ma_encoder_uninit(&encoder);
-    return MA_SUCCESS;
-}
-
-ma_result test_loshelf2__f32(const char* pInputFilePath)
-{
-    return test_loshelf2__by_format(pInputFilePath, TEST_OUTPUT_DIR"/loshelf2_f32.wav", ma_format_f32);
-}
-
-ma_result test_loshelf2__s16(const char* pInputFilePath)
-{
-    return test_loshelf2__by_format(pInputFilePath, TEST_OUTPUT_DIR"/loshelf2_s16.wav", ma_format_s16);
-}
-
-#if 0
-ma_result test_loshelf4__by_format(const char* pInputFilePath, const char* pOutputFilePath, ma_format format)
-{
-    ma_result result;
-    ma_decoder decoder;
-    ma_encoder encoder;
-    ma_loshelf_config loshelfConfig;
-    ma_loshelf loshelf;
-
-    printf("    %s\n", pOutputFilePath);
-
-    result = loshelf_init_decoder_and_encoder(pInputFilePath, pOutputFilePath, format, &decoder, &encoder);
-    if (result != MA_SUCCESS) {
-        return result;
-    }
-
-    loshelfConfig = ma_loshelf_config_init(decoder.outputFormat, decoder.outputChannels, decoder.outputSampleRate, 2000, 4);
-    result = ma_loshelf_init(&loshelfConfig, &loshelf);
-    if (result != MA_SUCCESS) {
-        ma_decoder_uninit(&decoder);
-        ma_encoder_uninit(&encoder);
-        return result;
-    }
-
-    for (;;) {
-        ma_uint8 tempIn[4096];
-        ma_uint8 tempOut[4096];
-        ma_uint64 tempCapIn  = sizeof(tempIn)  / ma_get_bytes_per_frame(decoder.outputFormat, decoder.outputChannels);
-        ma_uint64 tempCapOut = sizeof(tempOut) / ma_get_bytes_per_frame(decoder.outputFormat, decoder.outputChannels);
-        ma_uint64 framesToRead;
-        ma_uint64 framesJustRead;
-
-        framesToRead = ma_min(tempCapIn, tempCapOut);
-        framesJustRead = ma_decoder_read_pcm_frames(&decoder, tempIn, framesToRead);
-
-        /* Filter */
-        ma_loshelf_process_pcm_frames(&loshelf, tempOut, tempIn, framesJustRead);
-
-        /* Write to the WAV file. */
-        ma_encoder_write_pcm_frames(&encoder, tempOut, framesJustRead);
-
-        if (framesJustRead < framesToRead) {
-            break;
-        }
-    }
-
-    ma_decoder_uninit(&decoder);
-    ma_encoder_uninit(&encoder);
-    return MA_SUCCESS;
-}
-
-ma_result test_loshelf4__f32(const char* pInputFilePath)
-{
-    return test_loshelf4__by_format(pInputFilePath, TEST_OUTPUT_DIR"/loshelf4_f32.wav", ma_format_f32);
-}
-
-ma_result test_loshelf4__s16(const char* pInputFilePath)
-{
-    return test_loshelf4__by_format(pInputFilePath, TEST_OUTPUT_DIR"/loshelf4_s16.wav", ma_format_s16);
-}
-#endif
-
-int test_entry__loshelf(int argc, char** argv)
-{
-    ma_result result;
-    ma_bool32 hasError = MA_FALSE;
-    const char* pInputFilePath;
-
-    if (argc < 2) {
-        printf("No input file.\n");
-        return -1;
-    }
-
-    pInputFilePath = argv[1];
-    
-
-    result = test_loshelf2__f32(pInputFilePath);
-    if (result != MA_SUCCESS) {
-        hasError = MA_TRUE;
-    }
-
-    result = test_loshelf2__s16(pInputFilePath);
-    if (result != MA_SUCCESS) {
-        hasError = MA_TRUE;
-    }
-
-#if 0
-    result = test_loshelf4__f32(pInputFilePath);
-    if (result != MA_SUCCESS) {
-        hasError = MA_TRUE;
-    }
-
-    result = test_loshelf4__s16(pInputFilePath);
-    if (result != MA_SUCCESS) {
-        hasError = MA_TRUE;
-    }
-#endif
-
-    if (hasError) {
-        return -1;
-    } else {
-        return 0;
-    }
-}
@@ -17,6 +17,8 @@
 
 #include "picovoice.h"
 
+#include "pv_benchmark.h"
+
 #define PV_AUDIO_REC_AUDIO_FREQUENCY (16000U)
 #define PV_AUDIO_REC_CHANNEL_NUMBER (1)
 #define PV_AUDIO_REC_RECORD_BUFFER_SIZE (512)
@@ -25,20 +27,45 @@
 #define AUDIO_IN_PCM_BUFFER_SIZE    ((uint32_t)(PV_AUDIO_REC_AUDIO_FREQUENCY / 1000 * PV_AUDIO_REC_CHANNEL_NUMBER))
 #define AUDIO_IN_PDM_BUFFER_SIZE    ((uint32_t)(128 * PV_AUDIO_REC_AUDIO_FREQUENCY / 16000 * PV_AUDIO_REC_CHANNEL_NUMBER))
 
-static uint16_t record_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE];
-static uint16_t record_pcm_buffer[2 * AUDIO_IN_PCM_BUFFER_SIZE];
-static int16_t ping_pong_buffer[2][PV_AUDIO_REC_RECORD_BUFFER_SIZE];
+#ifndef PV_AUDIO_REC_FRAME_QUEUE_DEPTH
+#define PV_AUDIO_REC_FRAME_QUEUE_DEPTH (4)
+#endif
+
+#if (PV_AUDIO_REC_FRAME_QUEUE_DEPTH < 2) || ((PV_AUDIO_REC_FRAME_QUEUE_DEPTH & (PV_AUDIO_REC_FRAME_QUEUE_DEPTH - 1)) != 0)
+#error "PV_AUDIO_REC_FRAME_QUEUE_DEPTH must be a power of two and at least 2"
+#endif
+
+static __ALIGNED(4) uint16_t record_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE];
+static __ALIGNED(4) uint16_t swapped_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE / 2];
+
+/*
+ * The BSP's filter is set up to write stereo (the one microphone duplicated into both channels), which the ISR then
+ * had to copy back out every other sample. This one is mono, so it writes straight into the queued frame.
+ */
+static PDM_Filter_Handler_t pdm_filter_handler;
+static PDM_Filter_Config_t pdm_filter_config;
 
-static int32_t last_read_index = -1;
-static int32_t read_index = 1;
-static int32_t write_index = 0;
+/*
+ * Single-producer single-consumer frame queue. The ISR fills the slot at `frame_head` and publishes it by bumping
+ * `frame_head`; the main loop holds the slot at `frame_tail` until its next call to `pv_audio_rec_get_new_buffer`.
+ * When every slot is taken the ISR decodes into `overrun_frame` instead and counts the frame as an overrun, so a frame
+ * that is still being processed is never written to.
+ */
+static int16_t frame_queue[PV_AUDIO_REC_FRAME_QUEUE_DEPTH][PV_AUDIO_REC_RECORD_BUFFER_SIZE];
+static int16_t overrun_frame[PV_AUDIO_REC_RECORD_BUFFER_SIZE];
+
+static volatile uint32_t frame_head = 0;
+static volatile uint32_t frame_tail = 0;
+static volatile uint32_t overrun_count = 0;
+static bool is_holding_frame = false;
+
+static int16_t *write_frame = NULL;
 static int32_t buffer_index = 0;
 
 struct {
     uint32_t channel_number;
     uint32_t audio_frequency;
     uint32_t record_buffer_size;
-    uint16_t *record_pcm_buffer;
     bool is_recording;
 } pv_audio_rec;
 
@@ -46,11 +73,28 @@ pv_status_t pv_audio_rec_init(void) {
     pv_audio_rec.channel_number = PV_AUDIO_REC_CHANNEL_NUMBER;
     pv_audio_rec.audio_frequency = PV_AUDIO_REC_AUDIO_FREQUENCY;
     pv_audio_rec.record_buffer_size = PV_AUDIO_REC_RECORD_BUFFER_SIZE;
-    pv_audio_rec.record_pcm_buffer = record_pcm_buffer;
 
     if (BSP_AUDIO_IN_Init(PV_AUDIO_REC_AUDIO_FREQUENCY, DEFAULT_AUDIO_IN_BIT_RESOLUTION, PV_AUDIO_REC_CHANNEL_NUMBER) != AUDIO_OK) {
         return PV_STATUS_INVALID_STATE;
     }
+
+    // same settings as the BSP's filter, which has already enabled the CRC clock the library needs
+    pdm_filter_handler.bit_order = PDM_FILTER_BIT_ORDER_LSB;
+    pdm_filter_handler.endianness = PDM_FILTER_ENDIANNESS_LE;
+    pdm_filter_handler.high_pass_tap = 2122358088;
+    pdm_filter_handler.in_ptr_channels = PV_AUDIO_REC_CHANNEL_NUMBER;
+    pdm_filter_handler.out_ptr_channels = PV_AUDIO_REC_CHANNEL_NUMBER;
+    if (PDM_Filter_Init(&pdm_filter_handler) != 0) {
+        return PV_STATUS_INVALID_STATE;
+    }
+
+    pdm_filter_config.output_samples_number = AUDIO_IN_PCM_BUFFER_SIZE;
+    pdm_filter_config.mic_gain = 24;
+    pdm_filter_config.decimation_factor = PDM_FILTER_DEC_FACTOR_64;
+    if (PDM_Filter_setConfig(&pdm_filter_handler, &pdm_filter_config) != 0) {
+        return PV_STATUS_INVALID_STATE;
+    }
+
     if (BSP_AUDIO_IN_SetVolume(PV_AUDIO_REC_VOLUME_LEVEL) != AUDIO_OK) {
         return PV_STATUS_INVALID_STATE;
     }
@@ -66,43 +110,85 @@ pv_status_t pv_audio_rec_start(void) {
 }
 
 const int16_t *pv_audio_rec_get_new_buffer(void) {
-    if (read_index == -1) {
-        return NULL;
+    if (is_holding_frame) {
+        // all reads of the held frame complete before its slot is handed back to the ISR
+        __DMB();
+        frame_tail = frame_tail + 1;
+        is_holding_frame = false;
     }
 
-    if (last_read_index == read_index) {
+    if (frame_head == frame_tail) {
         return NULL;
     }
 
-    last_read_index = read_index;
+    // pairs with the barrier in `pv_audio_rec_publish_frame`
+    __DMB();
+    is_holding_frame = true;
 
-    return ping_pong_buffer[read_index];
+    return frame_queue[frame_tail & (PV_AUDIO_REC_FRAME_QUEUE_DEPTH - 1)];
 }
 
-void BSP_AUDIO_IN_TransferComplete_CallBack(void) {
-    BSP_AUDIO_IN_PDMToPCM((uint16_t*) &record_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE / 2],
-            record_pcm_buffer);
-    for (uint32_t i = 0; i < AUDIO_IN_PCM_BUFFER_SIZE; i++) {
-        ping_pong_buffer[write_index][buffer_index++] = record_pcm_buffer[i * 2];
+void pv_audio_rec_wait_for_frame(void) {
+    // WFI still wakes on an interrupt that is pending while masked, so a frame published between the check and the
+    // WFI isn't slept through
+    __disable_irq();
+    if (frame_head == frame_tail) {
+        __WFI();
     }
-    if (buffer_index >= PV_AUDIO_REC_RECORD_BUFFER_SIZE) {
-        read_index = write_index;
-        write_index = 1 - write_index;
-        buffer_index = 0;
+    __enable_irq();
+}
+
+uint32_t pv_audio_rec_get_overrun_count(void) {
+    return overrun_count;
+}
+
+static int16_t *pv_audio_rec_claim_frame(void) {
+    if ((frame_head - frame_tail) >= PV_AUDIO_REC_FRAME_QUEUE_DEPTH) {
+        return overrun_frame;
     }
+    return frame_queue[frame_head & (PV_AUDIO_REC_FRAME_QUEUE_DEPTH - 1)];
 }
 
-void BSP_AUDIO_IN_HalfTransfer_CallBack(void) {
-    BSP_AUDIO_IN_PDMToPCM((uint16_t*) &record_pdm_buffer[0],
-            record_pcm_buffer);
-    for (uint32_t i = 0; i < AUDIO_IN_PCM_BUFFER_SIZE; i++) {
-        ping_pong_buffer[write_index][buffer_index++] = record_pcm_buffer[i * 2];
+static void pv_audio_rec_publish_frame(void) {
+    if (write_frame == overrun_frame) {
+        overrun_count = overrun_count + 1;
+    } else {
+        // the frame's samples are written before the main loop can see it
+        __DMB();
+        frame_head = frame_head + 1;
     }
+    buffer_index = 0;
+}
+
+static void pv_audio_rec_process(const uint16_t *pdm) {
+    pv_benchmark_isr_begin();
+
+    // the microphone's bits arrive byte-swapped in each half-word; REV16 swaps two half-words per instruction
+    const uint32_t *in = (const uint32_t *) pdm;
+    uint32_t *out = (uint32_t *) swapped_pdm_buffer;
+    for (uint32_t i = 0; i < AUDIO_IN_PDM_BUFFER_SIZE / 4; i++) {
+        out[i] = __REV16(in[i]);
+    }
+
+    if (buffer_index == 0) {
+        write_frame = pv_audio_rec_claim_frame();
+    }
+    PDM_Filter(swapped_pdm_buffer, &write_frame[buffer_index], &pdm_filter_handler);
+    // a frame is exactly 32 transfers' worth, so the filter's output never straddles two frames
+    buffer_index += AUDIO_IN_PCM_BUFFER_SIZE;
     if (buffer_index >= PV_AUDIO_REC_RECORD_BUFFER_SIZE) {
-        read_index = write_index;
-        write_index = 1 - write_index;
-        buffer_index = 0;
+        pv_audio_rec_publish_frame();
     }
+
+    pv_benchmark_isr_end();
+}
+
+void BSP_AUDIO_IN_TransferComplete_CallBack(void) {
+    pv_audio_rec_process(&record_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE / 2]);
+}
+
+void BSP_AUDIO_IN_HalfTransfer_CallBack(void) {
+    pv_audio_rec_process(&record_pdm_buffer[0]);
 }
 
 void pv_audio_rec_deinit(void) {
@@ -74,6 +74,11 @@ pv_status_t pv_board_init() {
     BSP_LED_Init(LED6);
 
     memcpy(uuid, (uint8_t *) UUID_ADDRESS, UUID_SIZE);
+    // DWT cycle counter, used to time keyword processing
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     return PV_STATUS_SUCCESS;
 }
 
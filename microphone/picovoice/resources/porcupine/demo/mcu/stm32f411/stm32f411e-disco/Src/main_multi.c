@@ -18,9 +18,12 @@
 #include "pv_porcupine_mcu.h"
 
 #include "pv_audio_rec.h"
+#include "pv_benchmark.h"
 #include "pv_params.h"
 #include "pv_st_f411.h"
 
+#define DUTY_CYCLE_REPORT_MSEC (10000)
+
 #define MEMORY_BUFFER_SIZE (50 * 1024)
 
 static const char* ACCESS_KEY = ... //AccessKey string obtained from Picovoice Console (https://picovoice.ai/console/)
@@ -70,6 +73,8 @@ int main(void) {
      error_handler();
     }
 
+    pv_benchmark_init(pv_porcupine_frame_length(), pv_sample_rate());
+
     const uint8_t *board_uuid = pv_get_uuid();
     printf("UUID: ");
     for (uint32_t i = 0; i < pv_get_uuid_size(); i++) {
@@ -107,11 +112,22 @@ int main(void) {
     }
 
     uint32_t frame_number = 0;
+    uint32_t overrun_count = 0;
+    uint32_t busy_cycles = 0;
+    uint32_t report_start_msec = HAL_GetTick();
     while (true) {
         const int16_t *buffer = pv_audio_rec_get_new_buffer();
         if (buffer) {
+            if (pv_audio_rec_get_overrun_count() != overrun_count) {
+                overrun_count = pv_audio_rec_get_overrun_count();
+                printf("Audio overrun: %lu frames dropped so far\r\n", (unsigned long) overrun_count);
+            }
             int32_t keyword_index;
+            const uint32_t process_start = DWT->CYCCNT;
+            pv_benchmark_process_begin();
             const pv_status_t status = pv_porcupine_process(handle, buffer, &keyword_index);
+            busy_cycles += DWT->CYCCNT - process_start;
+            pv_benchmark_process_end();
             if (status != PV_STATUS_SUCCESS) {
                 printf("Porcupine process failed with '%s'", pv_status_to_string(status));
                 error_handler();
@@ -127,6 +143,18 @@ int main(void) {
                 BSP_LED_Off(LED6);
                 frame_number = 0;
             }
+        } else {
+            pv_audio_rec_wait_for_frame();
+        }
+
+        // the share of wall time spent in pv_porcupine_process; the core sleeps for the rest
+        const uint32_t elapsed_msec = HAL_GetTick() - report_start_msec;
+        if (elapsed_msec >= DUTY_CYCLE_REPORT_MSEC) {
+            const uint64_t elapsed_cycles = (uint64_t) elapsed_msec * (SystemCoreClock / 1000);
+            const uint32_t permille = (uint32_t) (((uint64_t) busy_cycles * 1000) / elapsed_cycles);
+            printf("Duty cycle: %lu.%lu%%\r\n", (unsigned long) (permille / 10), (unsigned long) (permille % 10));
+            busy_cycles = 0;
+            report_start_msec = HAL_GetTick();
         }
 
     }
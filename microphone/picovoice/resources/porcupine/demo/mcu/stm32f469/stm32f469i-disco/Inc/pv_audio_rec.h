@@ -16,7 +16,12 @@
 
 pv_status_t pv_audio_rec_init(void);
 pv_status_t pv_audio_rec_start(void);
+// the frame returned stays untouched by the recorder until the next call, which hands it back
 const int16_t *pv_audio_rec_get_new_buffer(void);
+// sleeps until an interrupt once no frame is waiting
+void pv_audio_rec_wait_for_frame(void);
+// frames dropped because every queue slot was still waiting to be processed
+uint32_t pv_audio_rec_get_overrun_count(void);
 void pv_audio_rec_deinit(void);
 
 #endif // PV_AUDIO_REC_H
@@ -0,0 +1,231 @@
+/*
+    Copyright 2020-2021 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+// Wake word co-processor: Porcupine runs here and, once it fires, the audio around the wake word is streamed over the
+// UART to a host that only has to run the rest of the pipeline. The UART carries nothing but packets, so there is no
+// printf in this build. See the "Co-processor mode" section of the README for the wire format.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32469i_discovery.h"
+
+#include "pv_porcupine_mcu.h"
+
+#include "pv_audio_rec.h"
+#include "pv_params.h"
+#include "pv_stm32f469.h"
+
+#define MEMORY_BUFFER_SIZE (50 * 1024)
+
+#define COPROCESSOR_BAUD_RATE (921600)
+
+#define FRAME_LENGTH (512)
+// ~1 s of audio before the detection, so the host also hears the wake word itself
+#define PRE_ROLL_FRAMES (32)
+// ~3 s of audio after the detection, for the command
+#define POST_TRIGGER_FRAMES (94)
+// room for the pre-roll plus the frames that arrive while it is sent; a frame takes ~11 ms on the line, 32 ms to record
+#define HISTORY_FRAMES (48)
+
+#define PACKET_SYNC_0 (0xA5)
+#define PACKET_SYNC_1 (0x5A)
+#define PACKET_TRIGGER (0x01)
+#define PACKET_AUDIO (0x02)
+#define PACKET_END (0x03)
+#define PACKET_HEADER_LENGTH (7)
+#define PACKET_CRC_LENGTH (2)
+
+#define UART_TIMEOUT_MSEC (100)
+
+extern UART_HandleTypeDef huart;
+
+static const char* ACCESS_KEY = ... //AccessKey string obtained from Picovoice Console (https://picovoice.ai/console/)
+
+static int8_t memory_buffer[MEMORY_BUFFER_SIZE] __attribute__((aligned(16)));
+
+static const int32_t NUM_KEYWORDS = 4;
+static const int32_t KEYWORD_MODEL_SIZES[] = {
+        sizeof(DEFAULT_KEYWORD_ARRAY),
+        sizeof(PICOVOICE_KEYWORD_ARRAY),
+        sizeof(BUMBLEBEE_KEYWORD_ARRAY),
+        sizeof(ALEXA_KEYWORD_ARRAY)
+};
+static const void *KEYWORD_MODELS[] = {
+        DEFAULT_KEYWORD_ARRAY,
+        PICOVOICE_KEYWORD_ARRAY,
+        BUMBLEBEE_KEYWORD_ARRAY,
+        ALEXA_KEYWORD_ARRAY
+};
+static const float SENSITIVITIES[] = {
+        0.75f,
+        0.75f,
+        0.75f,
+        0.75f
+};
+
+static int16_t history[HISTORY_FRAMES][FRAME_LENGTH];
+static uint8_t packet[PACKET_HEADER_LENGTH + (FRAME_LENGTH * sizeof(int16_t)) + PACKET_CRC_LENGTH];
+static uint16_t sequence_number = 0;
+
+static void error_handler(void) {
+    while(true);
+}
+
+// CRC-16/CCITT-FALSE
+static uint16_t packet_crc(const uint8_t *data, uint32_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+        for (uint32_t j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void send_packet(uint8_t type, const uint8_t *payload, uint16_t length) {
+    packet[0] = PACKET_SYNC_0;
+    packet[1] = PACKET_SYNC_1;
+    packet[2] = type;
+    packet[3] = (uint8_t) sequence_number;
+    packet[4] = (uint8_t) (sequence_number >> 8);
+    packet[5] = (uint8_t) length;
+    packet[6] = (uint8_t) (length >> 8);
+    if (length > 0) {
+        memcpy(&packet[PACKET_HEADER_LENGTH], payload, length);
+    }
+    const uint16_t crc = packet_crc(&packet[2], (PACKET_HEADER_LENGTH - 2) + length);
+    packet[PACKET_HEADER_LENGTH + length] = (uint8_t) crc;
+    packet[PACKET_HEADER_LENGTH + length + 1] = (uint8_t) (crc >> 8);
+    sequence_number++;
+
+    // blocking is fine: new frames keep landing in the recorder's queue while this runs
+    HAL_UART_Transmit(&huart, packet, PACKET_HEADER_LENGTH + length + PACKET_CRC_LENGTH, UART_TIMEOUT_MSEC);
+}
+
+static pv_status_t coprocessor_uart_init(void) {
+    // from the 45 MHz APB1 clock this comes out at 918367 baud, well within what the host's UART tolerates
+    huart.Init.BaudRate = COPROCESSOR_BAUD_RATE;
+    if (HAL_UART_Init(&huart) != HAL_OK) {
+        return PV_STATUS_INVALID_STATE;
+    }
+    return PV_STATUS_SUCCESS;
+}
+
+int main(void) {
+
+    pv_status_t status = pv_board_init();
+    if (status != PV_STATUS_SUCCESS) {
+     error_handler();
+    }
+
+    status = pv_message_init();
+    if (status != PV_STATUS_SUCCESS) {
+     error_handler();
+    }
+
+    status = coprocessor_uart_init();
+    if (status != PV_STATUS_SUCCESS) {
+     error_handler();
+    }
+
+    status = pv_audio_rec_init();
+    if (status != PV_STATUS_SUCCESS) {
+     error_handler();
+    }
+
+    status = pv_audio_rec_start();
+    if (status != PV_STATUS_SUCCESS) {
+        error_handler();
+    }
+
+    pv_porcupine_t *handle = NULL;
+
+    status = pv_porcupine_init(
+            ACCESS_KEY,
+            MEMORY_BUFFER_SIZE,
+            memory_buffer,
+            NUM_KEYWORDS,
+            KEYWORD_MODEL_SIZES,
+            KEYWORD_MODELS,
+            SENSITIVITIES,
+            &handle);
+
+    if (status != PV_STATUS_SUCCESS) {
+        error_handler();
+    }
+
+    if (pv_porcupine_frame_length() != FRAME_LENGTH) {
+        error_handler();
+    }
+
+    // frames are counted from start-up; the history keeps the last HISTORY_FRAMES of them
+    uint32_t recorded_frames = 0;
+    uint32_t sent_frames = 0;
+    uint32_t stream_end_frame = 0;
+    bool is_streaming = false;
+    while (true) {
+        const int16_t *buffer = pv_audio_rec_get_new_buffer();
+        if (buffer) {
+            memcpy(history[recorded_frames % HISTORY_FRAMES], buffer, FRAME_LENGTH * sizeof(int16_t));
+            recorded_frames++;
+
+            if (!is_streaming) {
+                int32_t keyword_index;
+                const pv_status_t status = pv_porcupine_process(handle, buffer, &keyword_index);
+                if (status != PV_STATUS_SUCCESS) {
+                    error_handler();
+                }
+                if (keyword_index != -1) {
+                    const uint8_t index = (uint8_t) keyword_index;
+                    send_packet(PACKET_TRIGGER, &index, sizeof(index));
+                    BSP_LED_On(keyword_index);
+
+                    sent_frames = (recorded_frames > PRE_ROLL_FRAMES) ? (recorded_frames - PRE_ROLL_FRAMES) : 0;
+                    stream_end_frame = recorded_frames + POST_TRIGGER_FRAMES;
+                    is_streaming = true;
+                }
+            }
+        }
+
+        if (is_streaming) {
+            if ((recorded_frames - sent_frames) > HISTORY_FRAMES) {
+                // overwritten before it could be sent; the host sees the gap in the sequence numbers
+                sequence_number += (uint16_t) ((recorded_frames - sent_frames) - HISTORY_FRAMES);
+                sent_frames = recorded_frames - HISTORY_FRAMES;
+            }
+            if (sent_frames < recorded_frames) {
+                send_packet(
+                        PACKET_AUDIO,
+                        (const uint8_t *) history[sent_frames % HISTORY_FRAMES],
+                        FRAME_LENGTH * sizeof(int16_t));
+                sent_frames++;
+            }
+            if (sent_frames == stream_end_frame) {
+                send_packet(PACKET_END, NULL, 0);
+                BSP_LED_Off(LED1);
+                BSP_LED_Off(LED2);
+                BSP_LED_Off(LED3);
+                BSP_LED_Off(LED4);
+                is_streaming = false;
+            }
+        }
+
+        if (!buffer && !(is_streaming && (sent_frames < recorded_frames))) {
+            pv_audio_rec_wait_for_frame();
+        }
+    }
+    pv_board_deinit();
+    pv_audio_rec_deinit();
+    pv_porcupine_delete(handle);
+}
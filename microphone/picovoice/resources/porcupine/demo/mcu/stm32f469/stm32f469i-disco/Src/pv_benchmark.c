@@ -0,0 +1,149 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include "pv_benchmark.h"
+
+#ifdef PV_BENCHMARK
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "stm32f4xx_hal.h"
+
+#include "pv_stm32f469.h"
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} pv_benchmark_stats_t;
+
+static pv_benchmark_stats_t process_stats;
+static pv_benchmark_stats_t isr_stats;
+
+static uint32_t frame_cycles = 0;
+
+static uint32_t isr_depth = 0;
+static uint32_t isr_start = 0;
+// every cycle spent in an instrumented ISR so far, so ISRs that preempt processing aren't billed to it
+static volatile uint32_t isr_cycles = 0;
+
+static uint32_t process_start = 0;
+static uint32_t process_isr_cycles = 0;
+
+static void pv_benchmark_stats_reset(pv_benchmark_stats_t *stats) {
+    stats->count = 0;
+    stats->min = UINT32_MAX;
+    stats->max = 0;
+    stats->total = 0;
+}
+
+static void pv_benchmark_stats_add(pv_benchmark_stats_t *stats, uint32_t cycles) {
+    stats->count++;
+    if (cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->total += cycles;
+}
+
+static uint32_t pv_benchmark_stats_avg(const pv_benchmark_stats_t *stats) {
+    return (stats->count > 0) ? (uint32_t) (stats->total / stats->count) : 0;
+}
+
+static void pv_benchmark_print_margin(const char *label, uint32_t used_cycles) {
+    const int32_t permille = (int32_t) (1000 - (((int64_t) used_cycles * 1000) / frame_cycles));
+    const uint32_t magnitude = (uint32_t) ((permille < 0) ? -permille : permille);
+    printf(
+            "[benchmark] real-time margin %s %s%lu.%lu%%\r\n",
+            label,
+            (permille < 0) ? "-" : "",
+            (unsigned long) (magnitude / 10),
+            (unsigned long) (magnitude % 10));
+}
+
+static void pv_benchmark_report(void) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const pv_benchmark_stats_t isr = isr_stats;
+    pv_benchmark_stats_reset(&isr_stats);
+    __set_PRIMASK(primask);
+
+    const uint32_t frames = process_stats.count;
+    const uint32_t isr_cycles_per_frame = (uint32_t) (isr.total / frames);
+
+    printf(
+            "[benchmark] %s @ %lu MHz, %lu frames of %lu cycles\r\n",
+            PV_BOARD_NAME,
+            (unsigned long) (SystemCoreClock / 1000000),
+            (unsigned long) frames,
+            (unsigned long) frame_cycles);
+    printf(
+            "[benchmark] process cycles min %lu avg %lu max %lu\r\n",
+            (unsigned long) process_stats.min,
+            (unsigned long) pv_benchmark_stats_avg(&process_stats),
+            (unsigned long) process_stats.max);
+    printf(
+            "[benchmark] isr cycles min %lu avg %lu max %lu, %lu per frame\r\n",
+            (unsigned long) ((isr.count > 0) ? isr.min : 0),
+            (unsigned long) pv_benchmark_stats_avg(&isr),
+            (unsigned long) isr.max,
+            (unsigned long) isr_cycles_per_frame);
+    pv_benchmark_print_margin("avg", pv_benchmark_stats_avg(&process_stats) + isr_cycles_per_frame);
+    pv_benchmark_print_margin("worst", process_stats.max + isr_cycles_per_frame);
+
+    pv_benchmark_stats_reset(&process_stats);
+}
+
+void pv_benchmark_init(int32_t frame_length, int32_t sample_rate) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    frame_cycles = (uint32_t) (((uint64_t) SystemCoreClock * (uint32_t) frame_length) / (uint32_t) sample_rate);
+
+    pv_benchmark_stats_reset(&process_stats);
+    pv_benchmark_stats_reset(&isr_stats);
+}
+
+void pv_benchmark_isr_begin(void) {
+    // only the outermost of nested instrumented ISRs is timed
+    if (isr_depth++ == 0) {
+        isr_start = DWT->CYCCNT;
+    }
+}
+
+void pv_benchmark_isr_end(void) {
+    if (--isr_depth == 0) {
+        const uint32_t cycles = DWT->CYCCNT - isr_start;
+        pv_benchmark_stats_add(&isr_stats, cycles);
+        isr_cycles = isr_cycles + cycles;
+    }
+}
+
+void pv_benchmark_process_begin(void) {
+    process_isr_cycles = isr_cycles;
+    process_start = DWT->CYCCNT;
+}
+
+void pv_benchmark_process_end(void) {
+    const uint32_t elapsed = DWT->CYCCNT - process_start;
+    pv_benchmark_stats_add(&process_stats, elapsed - (isr_cycles - process_isr_cycles));
+
+    if (process_stats.count >= PV_BENCHMARK_REPORT_FRAMES) {
+        pv_benchmark_report();
+    }
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include "pv_porcupine_mcu.h"
 
 #include "pv_audio_rec.h"
+#include "pv_benchmark.h"
 #include "pv_params.h"
 #include "pv_st_f769.h"
 
@@ -48,6 +49,8 @@ int main(void) {
      error_handler();
     }
 
+    pv_benchmark_init(pv_porcupine_frame_length(), pv_sample_rate());
+
     status = pv_message_init();
     if (status != PV_STATUS_SUCCESS) {
      error_handler();
@@ -94,7 +97,9 @@ int main(void) {
          const int16_t *buffer = pv_audio_rec_get_new_buffer();
          if (buffer) {
          int32_t keyword_index;
+         pv_benchmark_process_begin();
          const pv_status_t status = pv_porcupine_process(handle, buffer, &keyword_index);
+         pv_benchmark_process_end();
             if (status != PV_STATUS_SUCCESS) {
                 printf("Porcupine process failed with '%s'", pv_status_to_string(status));
                 error_handler();
@@ -17,6 +17,8 @@
 
 #include "picovoice.h"
 
+#include "pv_benchmark.h"
+
 #define PV_INT16_MAX (32767)
 #define PV_INT16_MIN (-32767 - 1)
 
@@ -103,6 +105,7 @@ static inline int16_t pv_hpf(int16_t s_int16, int16_t s_old_int16) {
 }
 
 void BSP_AUDIO_IN_TransferComplete_CallBack(void) {
+    pv_benchmark_isr_begin();
     for (uint32_t i = 0; i < AUDIO_IN_PCM_BUFFER_SIZE / 4; i++) {
         ping_pong_buffer[write_index][buffer_index++] = pv_hpf(
                 record_pcm_buffer[(AUDIO_IN_PCM_BUFFER_SIZE / 2) + i * 2],
@@ -114,9 +117,11 @@ void BSP_AUDIO_IN_TransferComplete_CallBack(void) {
         write_index = 1 - write_index;
         buffer_index = 0;
     }
+    pv_benchmark_isr_end();
 }
 
 void BSP_AUDIO_IN_HalfTransfer_CallBack(void) {
+    pv_benchmark_isr_begin();
     ping_pong_buffer[write_index][buffer_index++] = pv_hpf(record_pcm_buffer[0], record_pcm_buffer[AUDIO_IN_PCM_BUFFER_SIZE-2]);
     for (uint32_t i = 1; i < AUDIO_IN_PCM_BUFFER_SIZE / 4; i++) {
         ping_pong_buffer[write_index][buffer_index++] = pv_hpf(
@@ -128,6 +133,7 @@ void BSP_AUDIO_IN_HalfTransfer_CallBack(void) {
         write_index = 1 - write_index;
         buffer_index = 0;
     }
+    pv_benchmark_isr_end();
 }
 
 void BSP_AUDIO_IN_Error_CallBack(void) {
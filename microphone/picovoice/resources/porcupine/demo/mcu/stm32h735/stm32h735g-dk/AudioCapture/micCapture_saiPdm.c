@@ -9,6 +9,7 @@
 #include "micCapture_saiPdm.h"
 #include "pdm2pcm.h"
 #include "micCapture_task.h"
+#include "pv_benchmark.h"
 #include "stdio.h"
 #define MIC_CAPTURE_PDM_BUFF_SIZE_BYTES          (MIC_CAPTURE_IT_MS * 2 * 2048 / 8) /* 256 kHz frequency expected on SAI ; 2x for pingPong */
 #define MIC_CAPTURE_PCM_BUFF_SIZE_SAMPLES        (MIC_CAPTURE_IT_MS * 16)           /* ms @16kHz */
@@ -49,20 +50,24 @@ int mic_capture_start(void)
 
 void HAL_SAI_RxHalfCpltCallback(SAI_HandleTypeDef *hsai)
 {
+  pv_benchmark_isr_begin();
   /* Call the record update function to get the second half */
   /* Invalidate Data Cache to get the updated content of the SRAM*/
   SCB_InvalidateDCache_by_Addr(PDM_Buffer, MIC_CAPTURE_PDM_BUFF_SIZE_BYTES / 2);
   MX_PDM2PCM_Process((uint16_t *)PDM_Buffer, (uint16_t *)PCM_Buffer);
+  pv_benchmark_isr_end();
   mic_capture_processTask();
 }
 
 
 void HAL_SAI_RxCpltCallback(SAI_HandleTypeDef *hsai)
 {
+  pv_benchmark_isr_begin();
   /* Call the record update function to get the second half */
   /* Invalidate Data Cache to get the updated content of the SRAM*/
   SCB_InvalidateDCache_by_Addr(&PDM_Buffer[MIC_CAPTURE_PDM_BUFF_SIZE_BYTES / 2], MIC_CAPTURE_PDM_BUFF_SIZE_BYTES / 2);
   MX_PDM2PCM_Process((uint16_t *)(&PDM_Buffer[MIC_CAPTURE_PDM_BUFF_SIZE_BYTES / 2]), (uint16_t *)PCM_Buffer);
+  pv_benchmark_isr_end();
   mic_capture_processTask();
 }
 
@@ -17,6 +17,8 @@
 
 #include "picovoice.h"
 
+#include "pv_benchmark.h"
+
 #include "main.h"
 
 #define PV_AUDIO_REC_AUDIO_FREQUENCY (16000U)
@@ -154,6 +156,7 @@ const int16_t *pv_audio_rec_get_new_buffer(void) {
 }
 
 void pv_pcm_process(int16_t *record_pcm_buffer) {
+    pv_benchmark_isr_begin();
 
     int32_t temp_buffer_size = PV_AUDIO_REC_RECORD_BUFFER_SIZE - buffer_index;
     if (temp_buffer_size < AUDIO_IN_PCM_BUFFER_SIZE)  {
@@ -177,4 +180,6 @@ void pv_pcm_process(int16_t *record_pcm_buffer) {
         write_index = 1 - write_index;
         buffer_index = 0;
     }
+
+    pv_benchmark_isr_end();
 }
@@ -0,0 +1,45 @@
+/*
+    Copyright 2022 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_BENCHMARK_H
+#define PV_BENCHMARK_H
+
+#include <stdint.h>
+
+/*
+ * Cycle counts of keyword processing and of the audio ISRs, taken with the DWT cycle counter. Built in only when
+ * PV_BENCHMARK is defined; otherwise every call below compiles to nothing. Every PV_BENCHMARK_REPORT_FRAMES frames the
+ * min/avg/max of both and the real-time margin left in a frame are printed.
+ */
+
+#ifndef PV_BENCHMARK_REPORT_FRAMES
+#define PV_BENCHMARK_REPORT_FRAMES (312)
+#endif
+
+#ifdef PV_BENCHMARK
+
+void pv_benchmark_init(int32_t frame_length, int32_t sample_rate);
+void pv_benchmark_isr_begin(void);
+void pv_benchmark_isr_end(void);
+void pv_benchmark_process_begin(void);
+void pv_benchmark_process_end(void);
+
+#else
+
+#define pv_benchmark_init(frame_length, sample_rate)
+#define pv_benchmark_isr_begin()
+#define pv_benchmark_isr_end()
+#define pv_benchmark_process_begin()
+#define pv_benchmark_process_end()
+
+#endif
+
+#endif // PV_BENCHMARK_H
@@ -17,6 +17,8 @@
 
 #include "picovoice.h"
 
+#include "pv_benchmark.h"
+
 #define PV_AUDIO_REC_AUDIO_FREQUENCY (16000U)
 #define PV_AUDIO_REC_CHANNEL_NUMBER (2)
 #define PV_AUDIO_REC_RECORD_BUFFER_SIZE (512)
@@ -84,6 +86,7 @@ const int16_t *pv_audio_rec_get_new_buffer(void) {
 }
 
 void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance) {
+    pv_benchmark_isr_begin();
     if (Instance == 1U) {
         SCB_InvalidateDCache_by_Addr(
                 (uint32_t*) &record_pdm_buffer[AUDIO_IN_PDM_BUFFER_SIZE / 2],
@@ -103,9 +106,11 @@ void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance) {
             buffer_index = 0;
         }
     }
+    pv_benchmark_isr_end();
 }
 
 void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance) {
+    pv_benchmark_isr_begin();
     if (Instance == 1U) {
         SCB_InvalidateDCache_by_Addr((uint32_t*) &record_pdm_buffer[0],
         AUDIO_IN_PDM_BUFFER_SIZE * 2);
@@ -123,6 +128,7 @@ void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance) {
             buffer_index = 0;
         }
     }
+    pv_benchmark_isr_end();
 }
 
 void pv_audio_rec_deinit(void) {
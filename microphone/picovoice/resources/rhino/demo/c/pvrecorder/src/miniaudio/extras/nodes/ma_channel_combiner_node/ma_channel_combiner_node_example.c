@@ -1,2 +0,0 @@
-/* The channel separtor example also demonstrates how to use the combiner. */
-#include "../ma_channel_separator_node/ma_channel_separator_node_example.c"
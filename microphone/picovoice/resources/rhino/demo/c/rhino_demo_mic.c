@@ -25,10 +25,20 @@
 
 #endif
 
+#include "mic_harness.h"
 #include "pv_recorder.h"
 #include "pv_rhino.h"
 
-static volatile bool is_interrupted = false;
+typedef struct {
+    pv_rhino_t *rhino;
+    const char *(*status_to_string_func)(pv_status_t);
+    pv_status_t (*process_func)(pv_rhino_t *, const int16_t *, bool *);
+    pv_status_t (*is_understood_func)(const pv_rhino_t *, bool *);
+    pv_status_t (*get_intent_func)(const pv_rhino_t *, const char **, int32_t *, const char ***, const char ***);
+    pv_status_t (*free_slots_and_values_func)(const pv_rhino_t *, const char **, const char **);
+    pv_status_t (*reset_func)(pv_rhino_t *);
+    bool has_failed;
+} rhino_frame_context;
 
 static void *open_dl(const char *dl_path) {
 
@@ -96,12 +106,15 @@ static struct option long_options[] = {
         {"endpoint_duration_sec", required_argument, NULL, 'u'},
         {"require_endpoint",      required_argument, NULL, 'e'},
         {"show_audio_devices",    no_argument,       NULL, 's'},
+        {"vad_threshold_db",      required_argument, NULL, 'v'},
+        {"metrics_port",          required_argument, NULL, 'p'},
 };
 
 static void print_usage(const char *program_name) {
     fprintf(stderr,
             "Usage : %s -a ACCESS_KEY -l LIBRARY_PATH -m MODEL_PATH -c CONTEXT_PATH [-d AUDIO_DEVICE_INDEX] "
             "[-t SENSITIVITY]  [-u, --endpoint_duration_sec] [-e, --require_endpoint (true,false)]\n"
+            "        [-v VAD_THRESHOLD_DB] [-p METRICS_PORT]\n"
             "        %s [-s, --show_audio_devices]\n",
             program_name,
             program_name);
@@ -109,7 +122,7 @@ static void print_usage(const char *program_name) {
 
 void interrupt_handler(int _) {
     (void) _;
-    is_interrupted = true;
+    micHarness_interrupt();
 }
 
 void show_audio_devices(void) {
@@ -130,6 +143,71 @@ void show_audio_devices(void) {
     pv_recorder_free_device_list(count, devices);
 }
 
+static bool fail(rhino_frame_context *context, const char *function, pv_status_t status) {
+    fprintf(stderr, "'%s' failed with '%s'\n", function, context->status_to_string_func(status));
+    context->has_failed = true;
+    return false;
+}
+
+static bool process_frame(const int16_t *pcm, void *user_data) {
+    rhino_frame_context *context = user_data;
+
+    bool is_finalized = false;
+    pv_status_t status = context->process_func(context->rhino, pcm, &is_finalized);
+    if (status != PV_STATUS_SUCCESS) {
+        return fail(context, "pv_rhino_process", status);
+    }
+    if (!is_finalized) {
+        return true;
+    }
+
+    bool is_understood = false;
+    status = context->is_understood_func(context->rhino, &is_understood);
+    if (status != PV_STATUS_SUCCESS) {
+        return fail(context, "pv_rhino_is_understood", status);
+    }
+
+    const char *intent = NULL;
+    int32_t num_slots = 0;
+    const char **slots = NULL;
+    const char **values = NULL;
+
+    if (is_understood) {
+        status = context->get_intent_func(context->rhino, &intent, &num_slots, &slots, &values);
+        if (status != PV_STATUS_SUCCESS) {
+            return fail(context, "pv_rhino_get_intent", status);
+        }
+    }
+
+    fprintf(stdout, "{\n");
+    fprintf(stdout, "    'is_understood' : '%s',\n", is_understood ? "true" : "false");
+    if (is_understood) {
+        fprintf(stdout, "    'intent' : '%s',\n", intent);
+        if (num_slots > 0) {
+            fprintf(stdout, "    'slots' : {\n");
+            for (int32_t i = 0; i < num_slots; i++) {
+                fprintf(stdout, "        '%s' : '%s',\n", slots[i], values[i]);
+            }
+            fprintf(stdout, "    }\n");
+        }
+    }
+    fprintf(stdout, "}\n");
+    fflush(stdout);
+
+    if (is_understood) {
+        status = context->free_slots_and_values_func(context->rhino, slots, values);
+        if (status != PV_STATUS_SUCCESS) {
+            return fail(context, "pv_rhino_free_slots_and_values", status);
+        }
+    }
+
+    status = context->reset_func(context->rhino);
+    if (status != PV_STATUS_SUCCESS) {
+        return fail(context, "pv_rhino_reset", status);
+    }
+    return true;
+}
+
 int picovoice_main(int argc, char *argv[]) {
     signal(SIGINT, interrupt_handler);
 
@@ -141,9 +219,11 @@ int picovoice_main(int argc, char *argv[]) {
     float sensitivity = 0.5f;
     float endpoint_duration_sec = 1.f;
     bool require_endpoint = false;
+    float vad_threshold_db = 0.f;
+    int metrics_port = 0;
 
     int c;
-    while ((c = getopt_long(argc, argv, "a:l:m:c:d:t:u:e:s", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "a:l:m:c:d:t:u:e:sv:p:", long_options, NULL)) != -1) {
         switch (c) {
             case 'a':
                 access_key = optarg;
@@ -172,6 +252,12 @@ int picovoice_main(int argc, char *argv[]) {
             case 's':
                 show_audio_devices();
                 return 0;
+            case 'v':
+                vad_threshold_db = strtof(optarg, NULL);
+                break;
+            case 'p':
+                metrics_port = (int) strtol(optarg, NULL, 10);
+                break;
             default:
                 exit(1);
         }
@@ -291,14 +377,6 @@ int picovoice_main(int argc, char *argv[]) {
 
     fprintf(stdout, "Picovoice Rhino Speech-to-Intent (%s)\n\n", pv_rhino_version_func());
 
-    const int32_t frame_length = pv_rhino_frame_length_func();
-    pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t recorder_status = pv_recorder_init(device_index, frame_length, 100, true, true, &recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
-    }
-
     const char *context_info = NULL;
     status = pv_rhino_context_info_func(rhino, &context_info);
     if (status != PV_STATUS_SUCCESS) {
@@ -307,115 +385,42 @@ int picovoice_main(int argc, char *argv[]) {
     }
     fprintf(stdout, "%s\n\n", context_info);
 
-    const char *selected_device = pv_recorder_get_selected_device(recorder);
-    fprintf(stdout, "Selected device: %s.\n", selected_device);
-    fprintf(stdout, "Listening...\n\n");
-
-    recorder_status = pv_recorder_start(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to start device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
+    micHarness_config harness_config;
+    micHarness_defaultConfig(&harness_config, pv_rhino_frame_length_func(), pv_sample_rate_func());
+    harness_config.deviceIndex = device_index;
+    harness_config.vadThresholdDb = vad_threshold_db;
+    // Rhino needs the silence after a command to endpoint it, so the gate holds open for longer than that
+    const int32_t endpoint_hangover_ms = (int32_t) (endpoint_duration_sec * 1000.f) + 200;
+    if (harness_config.vadHangoverMs < endpoint_hangover_ms) {
+        harness_config.vadHangoverMs = endpoint_hangover_ms;
     }
-
-    int16_t *pcm = malloc(frame_length * sizeof(int16_t));
-    if (!pcm) {
-        fprintf(stderr, "Failed to allocate pcm memory.\n");
+    harness_config.metricsPort = metrics_port;
+
+    rhino_frame_context context = {
+            .rhino = rhino,
+            .status_to_string_func = pv_status_to_string_func,
+            .process_func = pv_rhino_process_func,
+            .is_understood_func = pv_rhino_is_understood_func,
+            .get_intent_func = pv_rhino_get_intent_func,
+            .free_slots_and_values_func = pv_rhino_free_slots_and_values_func,
+            .reset_func = pv_rhino_reset_func,
+            .has_failed = false,
+    };
+    if (!micHarness_start(&harness_config, process_frame, &context)) {
         exit(1);
     }
 
-    while (!is_interrupted) {
-
-        recorder_status = pv_recorder_read(recorder, pcm);
-        if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-            fprintf(stderr, "Failed to read with %s.\n", pv_recorder_status_to_string(recorder_status));
-            exit(1);
-        }
-
-        bool is_finalized = false;
-        status = pv_rhino_process_func(
-                rhino,
-                pcm,
-                &is_finalized);
-
-        if (status != PV_STATUS_SUCCESS) {
-            fprintf(stderr, "'pv_rhino_process' failed with '%s'\n", pv_status_to_string_func(status));
-            exit(1);
-        }
-
-        if (is_finalized) {
-            bool is_understood = false;
-            status = pv_rhino_is_understood_func(rhino, &is_understood);
-            if (status != PV_STATUS_SUCCESS) {
-                fprintf(stderr, "'pv_rhino_is_understood' failed with '%s'\n",
-                        pv_status_to_string_func(status));
-                exit(1);
-            }
-
-            const char *intent = NULL;
-            int32_t num_slots = 0;
-            const char **slots = NULL;
-            const char **values = NULL;
-
-            if (is_understood) {
-                status = pv_rhino_get_intent_func(
-                        rhino,
-                        &intent,
-                        &num_slots,
-                        &slots,
-                        &values);
-                if (status != PV_STATUS_SUCCESS) {
-                    fprintf(stderr, "'pv_rhino_get_intent' failed with '%s'\n",
-                            pv_status_to_string_func(status));
-                    exit(1);
-                }
-            }
-
-            fprintf(stdout, "{\n");
-            fprintf(stdout, "    'is_understood' : '%s',\n", is_understood ? "true" : "false");
-            if (is_understood) {
-                fprintf(stdout, "    'intent' : '%s',\n", intent);
-                if (num_slots > 0) {
-                    fprintf(stdout, "    'slots' : {\n");
-                    for (int32_t i = 0; i < num_slots; i++) {
-                        fprintf(stdout, "        '%s' : '%s',\n", slots[i], values[i]);
-                    }
-                    fprintf(stdout, "    }\n");
-                }
-            }
-            fprintf(stdout, "}\n");
-            fflush(stdout);
-
-            if (is_understood) {
-                status = pv_rhino_free_slots_and_values_func(rhino, slots, values);
-                if (status != PV_STATUS_SUCCESS) {
-                    fprintf(stderr, "'pv_rhino_free_slots_and_values' failed with '%s'\n",
-                            pv_status_to_string_func(status));
-                    exit(1);
-                }
-            }
+    fprintf(stdout, "Selected device: %s.\n", micHarness_deviceName());
+    fprintf(stdout, "Listening...\n\n");
 
-            status = pv_rhino_reset_func(rhino);
-            if (status != PV_STATUS_SUCCESS) {
-                fprintf(stderr, "'pv_rhino_reset' failed with '%s'\n",
-                        pv_status_to_string_func(status));
-                exit(1);
-            }
-        }
-    }
+    micHarness_wait();
     fprintf(stdout, "\n");
+    micHarness_stop();
 
-    recorder_status = pv_recorder_stop(recorder);
-    if (recorder_status != PV_RECORDER_STATUS_SUCCESS) {
-        fprintf(stderr, "Failed to stop device with %s.\n", pv_recorder_status_to_string(recorder_status));
-        exit(1);
-    }
-
-    free(pcm);
-    pv_recorder_delete(recorder);
     pv_rhino_delete_func(rhino);
     close_dl(rhino_library);
 
-    return 0;
+    return context.has_failed ? 1 : 0;
 }
 
 int main(int argc, char *argv[]) {